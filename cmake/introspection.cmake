@@ -178,6 +178,20 @@ if(NOT MSVC)
     CXXFLAGS ${AVX2_CXXFLAGS}
   )
 
+  # Check for AVX-512 intrinsics.
+  set(AVX512_CXXFLAGS -mavx512f)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_set1_epi32(1);
+      return _mm512_reduce_add_epi32(_mm512_add_epi32(l, l));
+    }
+    " HAVE_AVX512
+    CXXFLAGS ${AVX512_CXXFLAGS}
+  )
+
   # Check for x86 SHA-NI intrinsics.
   set(X86_SHANI_CXXFLAGS -msse4 -msha)
   check_cxx_source_compiles_with_flags("
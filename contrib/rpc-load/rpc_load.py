@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Load generator for the JSON-RPC and REST interfaces of a running node.
+
+Clients, each on its own connection, send requests picked at random from a
+weighted mix for a given duration, and the throughput and the latency
+percentiles of each kind of request are reported. This exercises the queue
+of the HTTP server (-rpcthreads, -rpcworkqueue) and the handlers of the
+requests:
+
+$ rpc_load.py --datadir ~/.bitcoin --concurrency 16 --mix getblock=4,rest_block=1
+
+Requests are made on blocks and transactions of the last blocks of the chain,
+so that results are comparable between runs. getrawtransaction is given the
+block of the transaction and does not need -txindex. rest_block requests
+binary blocks and needs -rest. Requests are single requests unless --batch is
+given, in which case that many JSON-RPC requests are sent in each HTTP
+request and the latency is that of the whole batch.
+
+The client is written in Python and uses a thread per connection, so check
+that it is not the bottleneck, e.g. by comparing with a lower concurrency.
+"""
+import argparse
+import base64
+import http.client
+import json
+import os
+import random
+import sys
+import threading
+import time
+
+CHAIN_DIRS = {
+    "main": "",
+    "test": "testnet3",
+    "testnet4": "testnet4",
+    "signet": "signet",
+    "regtest": "regtest",
+}
+DEFAULT_PORTS = {
+    "main": 8332,
+    "test": 18332,
+    "testnet4": 48332,
+    "signet": 38332,
+    "regtest": 18443,
+}
+REQUEST_KINDS = ["getblock", "getrawtransaction", "gettxout", "getrawmempool", "rest_block"]
+DEFAULT_MIX = "getblock=1,getrawtransaction=1,gettxout=1,getrawmempool=1"
+
+
+def parse_mix(mix):
+    weights = {}
+    for item in mix.split(","):
+        kind, _, weight = item.partition("=")
+        if kind not in REQUEST_KINDS:
+            raise ValueError(f"unknown request {kind}, expected one of {', '.join(REQUEST_KINDS)}")
+        weights[kind] = int(weight or 1)
+    return weights
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0
+    return sorted_values[min(len(sorted_values) - 1, int(len(sorted_values) * p / 100))]
+
+
+class Client:
+    """A connection to the node, reopened for every request without keep-alive."""
+
+    def __init__(self, args, auth):
+        self.args = args
+        self.headers = {"Authorization": auth, "Content-Type": "application/json"}
+        if not args.keepalive:
+            self.headers["Connection"] = "close"
+        self.conn = None
+
+    def request(self, method, path, body=None):
+        if self.conn is None:
+            self.conn = http.client.HTTPConnection(self.args.rpcconnect, self.args.rpcport, timeout=self.args.timeout)
+        try:
+            self.conn.request(method, path, body, self.headers)
+            resp = self.conn.getresponse()
+            data = resp.read()
+        except (OSError, http.client.HTTPException):
+            self.conn.close()
+            self.conn = None
+            raise
+        if not self.args.keepalive or resp.will_close:
+            self.conn.close()
+            self.conn = None
+        return resp.status, data
+
+    def rpc(self, method, *params):
+        status, data = self.request("POST", "/", json.dumps({"jsonrpc": "2.0", "id": 0, "method": method, "params": params}))
+        reply = json.loads(data)
+        if status != 200 or reply.get("error"):
+            raise RuntimeError(f"{method} failed: {reply.get('error')}")
+        return reply["result"]
+
+
+def get_samples(client, num_blocks):
+    """Hashes of the last blocks, their transactions and outputs."""
+    height = client.rpc("getblockcount")
+    samples = {"blocks": [], "txs": [], "outpoints": []}
+    for h in range(max(0, height - num_blocks + 1), height + 1):
+        block_hash = client.rpc("getblockhash", h)
+        samples["blocks"].append(block_hash)
+        for tx in client.rpc("getblock", block_hash, 2)["tx"]:
+            samples["txs"].append((tx["txid"], block_hash))
+            samples["outpoints"].extend((tx["txid"], n) for n in range(len(tx["vout"])))
+    return samples
+
+
+def make_request(kind, samples, rng):
+    """The JSON-RPC request, or the REST path, of a request of the given kind."""
+    if kind == "getblock":
+        return "getblock", [rng.choice(samples["blocks"]), 1]
+    if kind == "getrawtransaction":
+        txid, block_hash = rng.choice(samples["txs"])
+        return "getrawtransaction", [txid, 1, block_hash]
+    if kind == "gettxout":
+        txid, n = rng.choice(samples["outpoints"])
+        return "gettxout", [txid, n]
+    if kind == "getrawmempool":
+        return "getrawmempool", []
+    assert kind == "rest_block"
+    return f"/rest/block/{rng.choice(samples['blocks'])}.bin", None
+
+
+def run_client(args, auth, samples, weights, deadline, seed, results):
+    client = Client(args, auth)
+    rng = random.Random(seed)
+    kinds = list(weights)
+    latencies = {kind: [] for kind in kinds}
+    errors = {kind: 0 for kind in kinds}
+    while time.monotonic() < deadline:
+        kind = rng.choices(kinds, [weights[k] for k in kinds])[0]
+        method, params = make_request(kind, samples, rng)
+        start = time.perf_counter()
+        try:
+            if params is None:
+                status, _ = client.request("GET", method)
+                ok = status == 200
+            else:
+                calls = [{"jsonrpc": "2.0", "id": i, "method": method, "params": params} for i in range(args.batch)]
+                status, data = client.request("POST", "/", json.dumps(calls if args.batch > 1 else calls[0]))
+                replies = json.loads(data)
+                ok = status == 200 and not any(reply.get("error") for reply in (replies if args.batch > 1 else [replies]))
+        except (OSError, http.client.HTTPException, ValueError):
+            ok = False
+        if ok:
+            latencies[kind].append(time.perf_counter() - start)
+        else:
+            errors[kind] += 1
+    results.append((latencies, errors))
+
+
+def summarize(results, weights, elapsed):
+    summary = {}
+    for kind in list(weights) + ["total"]:
+        values = sorted(v for latencies, _ in results for k, l in latencies.items() if kind in (k, "total") for v in l)
+        num_errors = sum(n for _, errors in results for k, n in errors.items() if kind in (k, "total"))
+        summary[kind] = {
+            "requests": len(values),
+            "errors": num_errors,
+            "requests_per_second": len(values) / elapsed,
+            "latency_ms": {f"p{p}": percentile(values, p) * 1000 for p in (50, 90, 99)} | {"max": values[-1] * 1000 if values else 0},
+        }
+    return summary
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--chain", choices=CHAIN_DIRS, default="main", help="chain of the node (default: %(default)s)")
+    parser.add_argument("--datadir", help="data directory of the node, to read its cookie file")
+    parser.add_argument("--rpcconnect", default="127.0.0.1", help="address of the node (default: %(default)s)")
+    parser.add_argument("--rpcport", type=int, help="RPC port of the node (default: port of the chain)")
+    parser.add_argument("--rpcuser", help="RPC user, instead of the cookie file")
+    parser.add_argument("--rpcpassword", help="RPC password, instead of the cookie file")
+    parser.add_argument("--concurrency", type=int, default=4, help="number of clients sending requests at the same time (default: %(default)s)")
+    parser.add_argument("--duration", type=float, default=10, help="duration of the run, in seconds (default: %(default)s)")
+    parser.add_argument("--mix", default=DEFAULT_MIX, help=f"weights of the requests sent, among {', '.join(REQUEST_KINDS)} (default: %(default)s)")
+    parser.add_argument("--batch", type=int, default=1, help="number of JSON-RPC requests per HTTP request (default: %(default)s)")
+    parser.add_argument("--no-keepalive", dest="keepalive", action="store_false", help="open a new connection for every request")
+    parser.add_argument("--blocks", type=int, default=10, help="number of blocks at the tip to make requests on (default: %(default)s)")
+    parser.add_argument("--timeout", type=float, default=30, help="timeout of requests, in seconds (default: %(default)s)")
+    parser.add_argument("--json", action="store_true", help="print the results as JSON")
+    args = parser.parse_args()
+
+    try:
+        weights = parse_mix(args.mix)
+    except ValueError as e:
+        parser.error(f"invalid --mix: {e}")
+    if args.concurrency < 1 or args.batch < 1:
+        parser.error("--concurrency and --batch must be at least 1")
+    if args.rpcport is None:
+        args.rpcport = DEFAULT_PORTS[args.chain]
+    if args.rpcuser is not None:
+        authpair = f"{args.rpcuser}:{args.rpcpassword or ''}"
+    else:
+        datadir = args.datadir or os.path.expanduser("~/.bitcoin")
+        with open(os.path.join(datadir, CHAIN_DIRS[args.chain], ".cookie"), encoding="utf8") as f:
+            authpair = f.read().strip()
+    auth = "Basic " + base64.b64encode(authpair.encode("utf8")).decode("ascii")
+
+    samples = get_samples(Client(args, auth), args.blocks)
+    if "rest_block" in weights and Client(args, auth).request("GET", "/rest/chaininfo.json")[0] != 200:
+        sys.exit("The node does not serve REST requests, start it with -rest")
+
+    results = []
+    start = time.monotonic()
+    deadline = start + args.duration
+    threads = [threading.Thread(target=run_client, args=(args, auth, samples, weights, deadline, seed, results)) for seed in range(args.concurrency)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    summary = summarize(results, weights, time.monotonic() - start)
+
+    if args.json:
+        print(json.dumps(summary, indent=2))
+        return
+    print(f"{'request':<20}{'count':>10}{'errors':>8}{'req/s':>10}{'p50 ms':>10}{'p90 ms':>10}{'p99 ms':>10}{'max ms':>10}")
+    for kind, stats in summary.items():
+        latency = stats["latency_ms"]
+        print(f"{kind:<20}{stats['requests']:>10}{stats['errors']:>8}{stats['requests_per_second']:>10.1f}"
+              f"{latency['p50']:>10.2f}{latency['p90']:>10.2f}{latency['p99']:>10.2f}{latency['max']:>10.2f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -9,6 +9,9 @@ $ bitcoin-cli dumptxoutset ~/utxos.dat latest
 
 The created database contains a table `utxos` with the following schema:
 (txid TEXT, vout INT, value INT, coinbase INT, height INT, scriptpubkey TEXT)
+
+`bitcoin-util utxotosqlite` creates the same database natively and considerably
+faster, and also converts chunked snapshots (`dumptxoutset ... chunked=true`).
 """
 import argparse
 import os
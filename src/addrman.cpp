@@ -11,6 +11,7 @@
 #include <hash.h>
 #include <logging.h>
 #include <logging/timer.h>
+#include <memusage.h>
 #include <netaddress.h>
 #include <protocol.h>
 #include <random.h>
@@ -21,6 +22,7 @@
 #include <util/check.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <cmath>
 #include <optional>
 
@@ -156,6 +158,9 @@ void AddrManImpl::Serialize(Stream& s_) const
      * * for each new bucket:
      *   * number of elements
      *   * for each element: index in the serialized "all new addresses"
+     *   Since format 5, a non-empty bucket lists all its positions in order, with -1 for
+     *   the empty ones, so that entries can be put back in place without hashing their
+     *   position. Older versions skip the -1 indexes.
      * * asmap checksum
      *
      * 2**30 is xorred with the number of buckets to make addrman deserializer v0 detect it
@@ -209,17 +214,12 @@ void AddrManImpl::Serialize(Stream& s_) const
         }
     }
     for (int bucket = 0; bucket < ADDRMAN_NEW_BUCKET_COUNT; bucket++) {
-        int nSize = 0;
+        const bool empty{std::all_of(std::begin(vvNew[bucket]), std::end(vvNew[bucket]), [](nid_type id) { return id == -1; })};
+        s << (empty ? 0 : ADDRMAN_BUCKET_SIZE);
+        if (empty) continue;
         for (int i = 0; i < ADDRMAN_BUCKET_SIZE; i++) {
-            if (vvNew[bucket][i] != -1)
-                nSize++;
-        }
-        s << nSize;
-        for (int i = 0; i < ADDRMAN_BUCKET_SIZE; i++) {
-            if (vvNew[bucket][i] != -1) {
-                int nIndex = mapUnkIds[vvNew[bucket][i]];
-                s << nIndex;
-            }
+            const int nIndex{vvNew[bucket][i] != -1 ? mapUnkIds[vvNew[bucket][i]] : -1};
+            s << nIndex;
         }
     }
     // Store asmap checksum after bucket entries so that it
@@ -315,17 +315,24 @@ void AddrManImpl::Unserialize(Stream& s_)
 
     // Store positions in the new table buckets to apply later (if possible).
     // An entry may appear in up to ADDRMAN_NEW_BUCKETS_PER_ADDRESS buckets,
-    // so we store all bucket-entry_index pairs to iterate through later.
-    std::vector<std::pair<int, int>> bucket_entries;
+    // so we store all bucket-position-entry_index triples to iterate through
+    // later. The position is -1 unless the bucket lists all its positions.
+    struct BucketEntry {
+        int bucket;
+        int position;
+        int entry_index;
+    };
+    std::vector<BucketEntry> bucket_entries;
 
     for (int bucket = 0; bucket < nUBuckets; ++bucket) {
         int num_entries{0};
         s >> num_entries;
+        const bool positional{format >= Format::V5_BUCKET_POSITIONS && num_entries == ADDRMAN_BUCKET_SIZE};
         for (int n = 0; n < num_entries; ++n) {
             int entry_index{0};
             s >> entry_index;
             if (entry_index >= 0 && entry_index < nNew) {
-                bucket_entries.emplace_back(bucket, entry_index);
+                bucket_entries.push_back({bucket, positional ? n : -1, entry_index});
             }
         }
     }
@@ -345,9 +352,9 @@ void AddrManImpl::Unserialize(Stream& s_)
         LogDebug(BCLog::ADDRMAN, "Bucketing method was updated, re-bucketing addrman entries from disk\n");
     }
 
-    for (auto bucket_entry : bucket_entries) {
-        int bucket{bucket_entry.first};
-        const int entry_index{bucket_entry.second};
+    for (const auto& bucket_entry : bucket_entries) {
+        int bucket{bucket_entry.bucket};
+        const int entry_index{bucket_entry.entry_index};
         AddrInfo& info = mapInfo[entry_index];
 
         // Don't store the entry in the new bucket if it's not a valid address for our addrman
@@ -358,7 +365,8 @@ void AddrManImpl::Unserialize(Stream& s_)
         // this bucket_entry.
         if (info.nRefCount >= ADDRMAN_NEW_BUCKETS_PER_ADDRESS) continue;
 
-        int bucket_position = info.GetBucketPosition(nKey, true, bucket);
+        // The position only depends on the key, the bucket and the address, which are unchanged.
+        int bucket_position = bucket_entry.position >= 0 ? bucket_entry.position : info.GetBucketPosition(nKey, true, bucket);
         if (restore_bucketing && vvNew[bucket][bucket_position] == -1) {
             // Bucketing has not changed, using existing bucket positions for the new table
             vvNew[bucket][bucket_position] = entry_index;
@@ -1174,6 +1182,25 @@ size_t AddrManImpl::Size(std::optional<Network> net, std::optional<bool> in_new)
     return ret;
 }
 
+size_t AddrManImpl::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    // The tables of buckets are part of this object.
+    size_t usage{memusage::MallocUsage(sizeof(*this)) +
+                 memusage::DynamicUsage(mapInfo) +
+                 memusage::DynamicUsage(mapAddr) +
+                 memusage::DynamicUsage(vRandom) +
+                 memusage::DynamicUsage(m_tried_collisions) +
+                 memusage::DynamicUsage(m_network_counts)};
+    for (const auto& [_, info] : mapInfo) {
+        usage += info.DynamicMemoryUsage() + info.source.DynamicMemoryUsage();
+    }
+    for (const auto& [service, _] : mapAddr) {
+        usage += service.DynamicMemoryUsage();
+    }
+    return usage;
+}
+
 bool AddrManImpl::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
 {
     LOCK(cs);
@@ -1299,6 +1326,11 @@ size_t AddrMan::Size(std::optional<Network> net, std::optional<bool> in_new) con
     return m_impl->Size(net, in_new);
 }
 
+size_t AddrMan::DynamicMemoryUsage() const
+{
+    return m_impl->DynamicMemoryUsage();
+}
+
 bool AddrMan::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
 {
     return m_impl->Add(vAddr, source, time_penalty);
@@ -119,6 +119,8 @@ public:
 
     size_t Size(std::optional<Network> net, std::optional<bool> in_new) const EXCLUSIVE_LOCKS_REQUIRED(!cs);
 
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
     bool Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
         EXCLUSIVE_LOCKS_REQUIRED(!cs);
 
@@ -169,6 +171,7 @@ private:
         V2_ASMAP = 2,         //!< for files including asmap version
         V3_BIP155 = 3,        //!< same as V2_ASMAP plus addresses are in BIP155 format
         V4_MULTIPORT = 4,     //!< adds support for multiple ports per IP
+        V5_BUCKET_POSITIONS = 5, //!< same as V4_MULTIPORT, but non-empty new buckets list all their positions
     };
 
     //! The maximum format this software knows it can unserialize. Also, we always serialize
@@ -176,7 +179,7 @@ private:
     //! The format (first byte in the serialized stream) can be higher than this and
     //! still this software may be able to unserialize the file - if the second byte
     //! (see `lowest_compatible` in `Unserialize()`) is less or equal to this.
-    static constexpr Format FILE_FORMAT = Format::V4_MULTIPORT;
+    static constexpr Format FILE_FORMAT = Format::V5_BUCKET_POSITIONS;
 
     //! The initial value of a field that is incremented every time an incompatible format
     //! change is made (such that old software versions would not be able to parse and
@@ -9,9 +9,9 @@
 #include <util/strencodings.h>
 #include <util/string.h>
 
-#include <cassert>
+#include <algorithm>
+#include <bit>
 #include <cstring>
-
 #include <limits>
 
 using util::ContainsNoNUL;
@@ -37,6 +37,10 @@ static const int8_t mapBase58[256] = {
     -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
 };
 
+/** Base58 numbers are processed in limbs of BASE58_LIMB_DIGITS digits, the largest power of 58 that fits in 32 bits. */
+static constexpr int BASE58_LIMB_DIGITS{5};
+static constexpr uint32_t BASE58_LIMB{58 * 58 * 58 * 58 * 58};
+
 [[nodiscard]] static bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch, int max_ret_len)
 {
     // Skip leading spaces.
@@ -44,45 +48,51 @@ static const int8_t mapBase58[256] = {
         psz++;
     // Skip and count leading '1's.
     int zeroes = 0;
-    int length = 0;
     while (*psz == '1') {
         zeroes++;
         if (zeroes > max_ret_len) return false;
         psz++;
     }
-    // Allocate enough space in big-endian base256 representation.
-    int size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
+    // The number in limbs of 32 bits, least significant first.
+    std::vector<uint32_t> limbs;
+    limbs.reserve(strlen(psz) * 733 / 1000 / 4 + 1); // log(58) / log(256), rounded up.
+    // Process the characters, up to BASE58_LIMB_DIGITS at a time.
     static_assert(std::size(mapBase58) == 256, "mapBase58.size() should be 256"); // guarantee not out of range
     while (*psz && !IsSpace(*psz)) {
-        // Decode base58 character
-        int carry = mapBase58[(uint8_t)*psz];
-        if (carry == -1)  // Invalid b58 character
-            return false;
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
+        // Decode base58 characters into "carry", and apply "limbs = limbs * mul + carry".
+        uint64_t carry = 0;
+        uint64_t mul = 1;
+        for (int n = 0; n < BASE58_LIMB_DIGITS && *psz && !IsSpace(*psz); ++n, ++psz) {
+            const int digit = mapBase58[(uint8_t)*psz];
+            if (digit == -1)  // Invalid b58 character
+                return false;
+            carry = carry * 58 + digit;
+            mul *= 58;
+        }
+        for (uint32_t& limb : limbs) {
+            carry += mul * limb;
+            limb = static_cast<uint32_t>(carry);
+            carry >>= 32;
         }
-        assert(carry == 0);
-        length = i;
+        if (carry != 0) limbs.push_back(static_cast<uint32_t>(carry));
+        // The number only grows, so bound its size as it is decoded.
+        const int length = limbs.empty() ? 0 : static_cast<int>(limbs.size() * 4 - std::countl_zero(limbs.back()) / 8);
         if (length + zeroes > max_ret_len) return false;
-        psz++;
     }
     // Skip trailing spaces.
     while (IsSpace(*psz))
         psz++;
     if (*psz != 0)
         return false;
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
-    // Copy result into output vector.
-    vch.reserve(zeroes + (b256.end() - it));
+    // Copy result into output vector, big-endian and without leading zeroes.
+    vch.reserve(zeroes + limbs.size() * 4);
     vch.assign(zeroes, 0x00);
-    while (it != b256.end())
-        vch.push_back(*(it++));
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            if (it == limbs.rbegin() && (*it >> shift) == 0) continue;
+            vch.push_back(static_cast<unsigned char>(*it >> shift));
+        }
+    }
     return true;
 }
 
@@ -90,39 +100,49 @@ std::string EncodeBase58(std::span<const unsigned char> input)
 {
     // Skip & count leading zeroes.
     int zeroes = 0;
-    int length = 0;
     while (input.size() > 0 && input[0] == 0) {
         input = input.subspan(1);
         zeroes++;
     }
-    // Allocate enough space in big-endian base58 representation.
-    int size = input.size() * 138 / 100 + 1; // log(256) / log(58), rounded up.
-    std::vector<unsigned char> b58(size);
-    // Process the bytes.
+    // The number in limbs of BASE58_LIMB_DIGITS base58 digits, least significant first.
+    std::vector<uint32_t> limbs;
+    limbs.reserve((input.size() * 138 / 100 + 1) / BASE58_LIMB_DIGITS + 1); // log(256) / log(58), rounded up.
+    // Process the bytes, up to 4 at a time.
     while (input.size() > 0) {
-        int carry = input[0];
-        int i = 0;
-        // Apply "b58 = b58 * 256 + ch".
-        for (std::vector<unsigned char>::reverse_iterator it = b58.rbegin(); (carry != 0 || i < length) && (it != b58.rend()); it++, i++) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
+        const size_t n = std::min<size_t>(input.size(), 4);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) carry = (carry << 8) | input[i];
+        // Apply "limbs = limbs * 256^n + carry".
+        const uint64_t mul = uint64_t{1} << (8 * n);
+        for (uint32_t& limb : limbs) {
+            carry += mul * limb;
+            limb = carry % BASE58_LIMB;
+            carry /= BASE58_LIMB;
         }
-
-        assert(carry == 0);
-        length = i;
-        input = input.subspan(1);
+        while (carry != 0) {
+            limbs.push_back(carry % BASE58_LIMB);
+            carry /= BASE58_LIMB;
+        }
+        input = input.subspan(n);
     }
-    // Skip leading zeroes in base58 result.
-    std::vector<unsigned char>::iterator it = b58.begin() + (size - length);
-    while (it != b58.end() && *it == 0)
-        it++;
-    // Translate the result into a string.
+    // Translate the result into a string, without the leading zeroes of the
+    // most significant limb.
     std::string str;
-    str.reserve(zeroes + (b58.end() - it));
+    str.reserve(zeroes + limbs.size() * BASE58_LIMB_DIGITS);
     str.assign(zeroes, '1');
-    while (it != b58.end())
-        str += pszBase58[*(it++)];
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        char digits[BASE58_LIMB_DIGITS];
+        uint32_t limb = *it;
+        for (int i = BASE58_LIMB_DIGITS - 1; i >= 0; --i) {
+            digits[i] = pszBase58[limb % 58];
+            limb /= 58;
+        }
+        int skip = 0;
+        if (it == limbs.rbegin()) {
+            while (digits[skip] == '1') skip++;
+        }
+        str.append(digits + skip, BASE58_LIMB_DIGITS - skip);
+    }
     return str;
 }
 
@@ -11,10 +11,12 @@
 #include <protocol.h>
 #include <random.h>
 #include <span.h>
+#include <streams.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/time.h>
 
+#include <cassert>
 #include <cstring>
 #include <optional>
 #include <vector>
@@ -175,9 +177,39 @@ static void AddrManAddThenGood(benchmark::Bench& bench)
     });
 }
 
+static void AddrManSerialize(benchmark::Bench& bench)
+{
+    AddrMan addrman{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+    FillAddrMan(addrman);
+
+    DataStream stream;
+    bench.run([&] {
+        stream.clear();
+        stream << addrman;
+    });
+}
+
+static void AddrManDeserialize(benchmark::Bench& bench)
+{
+    AddrMan addrman{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+    FillAddrMan(addrman);
+    DataStream serialized;
+    serialized << addrman;
+
+    bench.run([&] {
+        // Deserializing requires an empty addrman.
+        AddrMan loaded{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+        DataStream stream{serialized};
+        stream >> loaded;
+        assert(loaded.Size() == addrman.Size());
+    });
+}
+
 BENCHMARK(AddrManAdd, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManSelect, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManSelectFromAlmostEmpty, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManSelectByNetwork, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManGetAddr, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManAddThenGood, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddrManSerialize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddrManDeserialize, benchmark::PriorityLevel::HIGH);
@@ -6,10 +6,14 @@
 
 #include <test/util/setup_common.h> // IWYU pragma: keep
 #include <tinyformat.h>
+#include <univalue.h>
 #include <util/fs.h>
+#include <util/readwritefile.h>
 #include <util/string.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <compare>
 #include <fstream>
 #include <functional>
@@ -65,6 +69,112 @@ void GenerateTemplateResults(const std::vector<ankerl::nanobench::Result>& bench
     }
 }
 
+using Measure = ankerl::nanobench::Result::Measure;
+
+//! Performance counters of nanobench, by the key used in the summary. They are
+//! only measured on Linux, when perf_event_open is permitted.
+const std::vector<std::pair<std::string, Measure>> COUNTERS{
+    {"cpu_cycles", Measure::cpucycles},
+    {"instructions", Measure::instructions},
+    {"branches", Measure::branchinstructions},
+    {"branch_misses", Measure::branchmisses},
+    {"page_faults", Measure::pagefaults},
+    {"context_switches", Measure::contextswitches},
+};
+
+//! Nearest-rank percentile of sorted values.
+double Percentile(const std::vector<double>& sorted, double percent)
+{
+    const auto rank{static_cast<size_t>(std::ceil(percent / 100 * sorted.size()))};
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/**
+ * Per-benchmark summary of the results, identified by the name the benchmark
+ * is registered with, which unlike the name of the result does not change
+ * when a benchmark names its runs. The summary includes the
+ * percentiles over the epochs of the time per unit, in nanoseconds, and the
+ * medians of the performance counters per unit.
+ */
+UniValue SummarizeResults(const std::vector<std::pair<std::string, ankerl::nanobench::Result>>& results)
+{
+    UniValue benchmarks(UniValue::VARR);
+    for (const auto& [id, result] : results) {
+        const double batch{result.config().mBatch};
+        std::vector<double> ns_per_unit(result.size());
+        for (size_t i{0}; i < result.size(); ++i) {
+            ns_per_unit[i] = result.get(i, Measure::elapsed) * 1e9 / batch;
+        }
+        std::sort(ns_per_unit.begin(), ns_per_unit.end());
+        UniValue times(UniValue::VOBJ);
+        times.pushKV("min", ns_per_unit.front());
+        for (const int percent : {5, 25, 50, 75, 95}) {
+            times.pushKV(strprintf("p%d", percent), Percentile(ns_per_unit, percent));
+        }
+        times.pushKV("max", ns_per_unit.back());
+        times.pushKV("mean", result.average(Measure::elapsed) * 1e9 / batch);
+        UniValue counters(UniValue::VOBJ);
+        for (const auto& [key, measure] : COUNTERS) {
+            if (result.has(measure)) counters.pushKV(key, result.median(measure) / batch);
+        }
+        UniValue benchmark(UniValue::VOBJ);
+        benchmark.pushKV("id", id);
+        benchmark.pushKV("unit", result.config().mUnit);
+        benchmark.pushKV("batch", batch);
+        benchmark.pushKV("epochs", uint64_t(result.size()));
+        benchmark.pushKV("iterations", uint64_t(result.sum(Measure::iterations)));
+        benchmark.pushKV("median_abs_percent_error", result.medianAbsolutePercentError(Measure::elapsed) * 100);
+        benchmark.pushKV("ns_per_unit", std::move(times));
+        benchmark.pushKV("counters_per_unit", std::move(counters));
+        benchmarks.push_back(std::move(benchmark));
+    }
+    UniValue summary(UniValue::VOBJ);
+    summary.pushKV("benchmarks", std::move(benchmarks));
+    return summary;
+}
+
+//! Median time per unit of each benchmark of a summary, by id.
+std::map<std::string, double> MedianTimes(const UniValue& summary)
+{
+    std::map<std::string, double> ret;
+    for (const UniValue& benchmark : summary.find_value("benchmarks").getValues()) {
+        ret.emplace(benchmark.find_value("id").get_str(), benchmark.find_value("ns_per_unit").find_value("p50").get_real());
+    }
+    return ret;
+}
+
+/**
+ * Compare the median times with those of a summary written earlier and print
+ * the differences.
+ *
+ * @returns false if a benchmark is slower than in the baseline by more than
+ *          threshold percent. Benchmarks missing from either are not failures.
+ */
+bool CompareWithBaseline(const UniValue& summary, const fs::path& file, double threshold)
+{
+    const auto [read, contents]{ReadBinaryFile(file)};
+    UniValue baseline;
+    if (!read || !baseline.read(contents)) {
+        throw std::runtime_error(strprintf("Could not read baseline %s", fs::PathToString(file)));
+    }
+    const auto baseline_times{MedianTimes(baseline)};
+    bool ok{true};
+    std::cout << "Comparison with " << file << ", median ns per unit:" << std::endl;
+    for (const auto& [id, time] : MedianTimes(summary)) {
+        const auto it{baseline_times.find(id)};
+        if (it == baseline_times.end()) {
+            std::cout << strprintf("  %s: %.2f (not in baseline)", id, time) << std::endl;
+            continue;
+        }
+        const double change{(time / it->second - 1) * 100};
+        const bool regressed{change > threshold};
+        std::cout << strprintf("  %s: %.2f -> %.2f (%+.1f%%)%s", id, it->second, time, change, regressed ? " REGRESSION" : "") << std::endl;
+        ok &= !regressed;
+    }
+    if (!ok) std::cout << strprintf("Benchmarks are slower than the baseline by more than %g%%", threshold) << std::endl;
+    return ok;
+}
+
 } // namespace
 
 namespace benchmark {
@@ -102,7 +212,7 @@ BenchRunner::BenchRunner(std::string name, BenchFunction func, PriorityLevel lev
     benchmarks().insert(std::make_pair(name, std::make_pair(func, level)));
 }
 
-void BenchRunner::RunAll(const Args& args)
+bool BenchRunner::RunAll(const Args& args)
 {
     std::regex reFilter(args.regex_filter);
     std::smatch baseMatch;
@@ -120,6 +230,7 @@ void BenchRunner::RunAll(const Args& args)
     };
 
     std::vector<ankerl::nanobench::Result> benchmarkResults;
+    std::vector<std::pair<std::string, ankerl::nanobench::Result>> summary_results;
     for (const auto& [name, bench_func] : benchmarks()) {
         const auto& [func, priority_level] = bench_func;
 
@@ -161,6 +272,7 @@ void BenchRunner::RunAll(const Args& args)
 
         if (!bench.results().empty()) {
             benchmarkResults.push_back(bench.results().back());
+            summary_results.emplace_back(name, bench.results().back());
         }
     }
 
@@ -168,6 +280,19 @@ void BenchRunner::RunAll(const Args& args)
                                                                "{{#result}}{{name}}, {{epochs}}, {{average(iterations)}}, {{sumProduct(iterations, elapsed)}}, {{minimum(elapsed)}}, {{maximum(elapsed)}}, {{median(elapsed)}}\n"
                                                                "{{/result}}");
     GenerateTemplateResults(benchmarkResults, args.output_json, ankerl::nanobench::templates::json());
+
+    if (benchmarkResults.empty() || (args.output_summary.empty() && args.compare.empty())) return true;
+    const UniValue summary{SummarizeResults(summary_results)};
+    if (!args.output_summary.empty()) {
+        std::ofstream fout{args.output_summary};
+        if (fout.is_open()) {
+            fout << summary.write(/*prettyIndent=*/2) << std::endl;
+            std::cout << "Created " << args.output_summary << std::endl;
+        } else {
+            std::cout << "Could not write to file " << args.output_summary << std::endl;
+        }
+    }
+    return args.compare.empty() || CompareWithBaseline(summary, args.compare, args.regression_threshold);
 }
 
 } // namespace benchmark
@@ -59,6 +59,9 @@ struct Args {
     std::vector<double> asymptote;
     fs::path output_csv;
     fs::path output_json;
+    fs::path output_summary;
+    fs::path compare;
+    double regression_threshold;
     std::string regex_filter;
     uint8_t priority;
     std::vector<std::string> setup_args;
@@ -73,7 +76,8 @@ class BenchRunner
 public:
     BenchRunner(std::string name, BenchFunction func, PriorityLevel level);
 
-    static void RunAll(const Args& args);
+    //! @returns false if a benchmark regressed compared to args.compare.
+    static bool RunAll(const Args& args);
 };
 } // namespace benchmark
 
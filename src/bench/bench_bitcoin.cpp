@@ -4,9 +4,11 @@
 
 #include <bench/bench.h>
 #include <common/args.h>
+#include <crypto/chacha20.h>
 #include <crypto/sha256.h>
 #include <tinyformat.h>
 #include <util/fs.h>
+#include <util/strencodings.h>
 #include <util/string.h>
 #include <test/util/setup_common.h>
 
@@ -16,6 +18,7 @@
 #include <exception>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 using util::SplitString;
@@ -24,6 +27,8 @@ static const char* DEFAULT_BENCH_FILTER = ".*";
 static constexpr int64_t DEFAULT_MIN_TIME_MS{10};
 /** Priority level default value, run "all" priority levels */
 static const std::string DEFAULT_PRIORITY{"all"};
+/** Slowdown of the median time of a benchmark over -compare, in percent, counted as a regression */
+static constexpr double DEFAULT_REGRESSION_THRESHOLD{10};
 
 static void SetupBenchArgs(ArgsManager& argsman)
 {
@@ -31,11 +36,14 @@ static void SetupBenchArgs(ArgsManager& argsman)
     SetupCommonTestArgs(argsman);
 
     argsman.AddArg("-asymptote=<n1,n2,n3,...>", "Test asymptotic growth of the runtime of an algorithm, if supported by the benchmark", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-compare=<summary.json>", "Compare the median times with a file written by -output-summary and exit with an error if a benchmark is slower by more than -regression-threshold", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-filter=<regex>", strprintf("Regular expression filter to select benchmark by name (default: %s)", DEFAULT_BENCH_FILTER), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-list", "List benchmarks without executing them", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-min-time=<milliseconds>", strprintf("Minimum runtime per benchmark, in milliseconds (default: %d)", DEFAULT_MIN_TIME_MS), ArgsManager::ALLOW_ANY | ArgsManager::DISALLOW_NEGATION, OptionsCategory::OPTIONS);
     argsman.AddArg("-output-csv=<output.csv>", "Generate CSV file with the most important benchmark results", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-output-json=<output.json>", "Generate JSON file with all benchmark results", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-output-summary=<summary.json>", "Generate JSON file with the percentiles of the time and the performance counters (on Linux) of each benchmark, by benchmark name", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-regression-threshold=<percent>", strprintf("Slowdown over -compare counted as a regression (default: %g)", DEFAULT_REGRESSION_THRESHOLD), ArgsManager::ALLOW_ANY | ArgsManager::DISALLOW_NEGATION, OptionsCategory::OPTIONS);
     argsman.AddArg("-sanity-check", "Run benchmarks for only one iteration with no output", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-priority-level=<l1,l2,l3>", strprintf("Run benchmarks of one or multiple priority level(s) (%s), default: '%s'",
                                                            benchmark::ListPriorities(), DEFAULT_PRIORITY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -79,6 +87,7 @@ int main(int argc, char** argv)
     ArgsManager argsman;
     SetupBenchArgs(argsman);
     SHA256AutoDetect();
+    ChaCha20AutoDetect();
     std::string error;
     if (!argsman.ParseParameters(argc, argv, error)) {
         tfm::format(std::cerr, "Error parsing command line arguments: %s\n", error);
@@ -142,14 +151,20 @@ int main(int argc, char** argv)
         args.min_time = std::chrono::milliseconds(argsman.GetIntArg("-min-time", DEFAULT_MIN_TIME_MS));
         args.output_csv = argsman.GetPathArg("-output-csv");
         args.output_json = argsman.GetPathArg("-output-json");
+        args.output_summary = argsman.GetPathArg("-output-summary");
+        args.compare = argsman.GetPathArg("-compare");
+        args.regression_threshold = DEFAULT_REGRESSION_THRESHOLD;
+        if (const auto threshold{argsman.GetArg("-regression-threshold")}) {
+            const auto parsed{ToIntegral<int64_t>(*threshold)};
+            if (!parsed || *parsed < 0) throw std::runtime_error(strprintf("Invalid -regression-threshold: %s", *threshold));
+            args.regression_threshold = *parsed;
+        }
         args.regex_filter = argsman.GetArg("-filter", DEFAULT_BENCH_FILTER);
         args.sanity_check = argsman.GetBoolArg("-sanity-check", false);
         args.priority = parsePriorityLevel(argsman.GetArg("-priority-level", DEFAULT_PRIORITY));
         args.setup_args = parseTestSetupArgs(argsman);
 
-        benchmark::BenchRunner::RunAll(args);
-
-        return EXIT_SUCCESS;
+        return benchmark::BenchRunner::RunAll(args) ? EXIT_SUCCESS : EXIT_FAILURE;
     } catch (const std::exception& e) {
         tfm::format(std::cerr, "Error: %s\n", e.what());
         return EXIT_FAILURE;
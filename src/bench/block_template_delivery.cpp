@@ -0,0 +1,82 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data/block413567.raw.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <streams.h>
+#include <util/shm.h>
+
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Latency of making a full block template available to a process such as a
+// Stratum v2 template provider, from the serialization of the block to the
+// bytes being readable by the receiver. This leaves out the capnp framing, so
+// it is a lower bound of what delivering getBlock() over -ipcbind costs.
+
+static CBlock CreateTemplateBlock()
+{
+    DataStream stream{benchmark::data::block413567};
+    CBlock block;
+    stream >> TX_WITH_WITNESS(block);
+    return block;
+}
+
+//! Bytes copied through a Unix socket, as getBlock() results are.
+static void BlockTemplateDeliverySocket(benchmark::Bench& bench)
+{
+    const CBlock block{CreateTemplateBlock()};
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    std::vector<std::byte> received;
+    bench.unit("block").run([&] {
+        DataStream serialized;
+        serialized << TX_WITH_WITNESS(block);
+        std::thread sender{[&] {
+            for (size_t sent{0}; sent < serialized.size();) {
+                const ssize_t n{write(fds[0], serialized.data() + sent, serialized.size() - sent)};
+                assert(n > 0);
+                sent += n;
+            }
+        }};
+        received.resize(serialized.size());
+        for (size_t read_bytes{0}; read_bytes < received.size();) {
+            const ssize_t n{read(fds[1], received.data() + read_bytes, received.size() - read_bytes)};
+            assert(n > 0);
+            read_bytes += n;
+        }
+        sender.join();
+    });
+    close(fds[0]);
+    close(fds[1]);
+}
+
+//! Bytes placed in a segment once, whose name is all the receiver needs.
+static void BlockTemplateDeliverySharedMemory(benchmark::Bench& bench)
+{
+    const CBlock block{CreateTemplateBlock()};
+    bench.unit("block").run([&] {
+        DataStream serialized;
+        serialized << TX_WITH_WITNESS(block);
+        const auto segment{SharedMemory::Create(serialized)};
+        assert(segment);
+        const auto mapped{SharedMemory::Open(segment->Name(), segment->Data().size())};
+        assert(mapped && mapped->Data().size() == serialized.size());
+        ankerl::nanobench::doNotOptimizeAway(mapped->Data().back());
+    });
+}
+
+BENCHMARK(BlockTemplateDeliverySocket, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockTemplateDeliverySharedMemory, benchmark::PriorityLevel::HIGH);
+
+#endif // WIN32
@@ -0,0 +1,69 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! Reconstruct a block of BLOCK_TXS transactions, all of which are in a mempool of
+//! MEMPOOL_TXS transactions, from a compact block.
+static void BlockEncodingInitData(benchmark::Bench& bench)
+{
+    constexpr size_t MEMPOOL_TXS{50000};
+    constexpr size_t BLOCK_TXS{3000};
+
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    CTxMemPool& pool{*Assert(testing_setup->m_node.mempool)};
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    TestMemPoolEntryHelper entry;
+
+    CBlock block;
+    block.nVersion = 42;
+    block.hashPrevBlock = det_rand.rand256();
+    block.nBits = 0x207fffff;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    {
+        LOCK2(cs_main, pool.cs);
+        for (size_t i = 0; i < MEMPOOL_TXS; ++i) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint{Txid::FromUint256(det_rand.rand256()), 0};
+            tx.vin[0].scriptWitness.stack.push_back({1});
+            tx.vout.resize(1);
+            tx.vout[0].scriptPubKey = CScript() << OP_1;
+            tx.vout[0].nValue = COIN;
+            const CTransactionRef tx_ref{MakeTransactionRef(tx)};
+            AddToMempool(pool, entry.Fee(1000).FromTx(tx_ref));
+            if (i % (MEMPOOL_TXS / BLOCK_TXS) == 0 && block.vtx.size() <= BLOCK_TXS) block.vtx.push_back(tx_ref);
+        }
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, det_rand.rand64()};
+    const std::vector<CTransactionRef> extra_txn;
+
+    bench.unit("block").run([&] {
+        PartiallyDownloadedBlock partial_block{&pool};
+        const auto status{partial_block.InitData(cmpctblock, extra_txn)};
+        assert(status == READ_STATUS_OK);
+        assert(partial_block.IsTxAvailable(BLOCK_TXS));
+    });
+}
+
+BENCHMARK(BlockEncodingInitData, benchmark::PriorityLevel::HIGH);
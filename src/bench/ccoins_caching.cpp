@@ -4,15 +4,20 @@
 
 #include <bench/bench.h>
 #include <coins.h>
+#include <coinsflatmap.h>
 #include <consensus/amount.h>
 #include <key.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <test/util/transaction_utils.h>
+#include <tinyformat.h>
 
 #include <cassert>
+#include <cstddef>
+#include <ostream>
 #include <vector>
 
 // Microbenchmark for simple accesses to a CCoinsViewCache database. Note from
@@ -54,4 +59,93 @@ static void CCoinsCaching(benchmark::Bench& bench)
     });
 }
 
+//! Number of coins in the maps of the lookup benchmarks, large enough not to fit in the CPU caches.
+static constexpr size_t LOOKUP_MAP_COINS{1'000'000};
+
+static std::vector<COutPoint> LookupOutpoints(size_t count)
+{
+    auto rng{ankerl::nanobench::Rng(1234)};
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(count);
+    for (size_t i{0}; i < count; ++i) {
+        uint256 hash;
+        for (auto& byte : hash) byte = static_cast<unsigned char>(rng());
+        outpoints.emplace_back(Txid::FromUint256(hash), static_cast<uint32_t>(rng.bounded(4)));
+    }
+    return outpoints;
+}
+
+//! A P2WPKH-sized coin, whose script is stored inline.
+static Coin LookupCoin()
+{
+    return Coin{CTxOut{COIN, CScript() << OP_0 << std::vector<unsigned char>(20, 0)}, 800'000, false};
+}
+
+static void ReportEntriesPerMiB(benchmark::Bench& bench, const char* name, size_t entries, size_t bytes)
+{
+    if (std::ostream* out{bench.output()}) {
+        *out << strprintf("%s: %u coins in %.1f MiB, %.0f coins/MiB\n", name, entries, bytes / double(1 << 20), entries / (bytes / double(1 << 20)));
+    }
+}
+
+// Lookups of cached coins in the map used by CCoinsViewCache, half of them hits.
+static void CoinsMapLookup(benchmark::Bench& bench, bool huge_pages)
+{
+    const auto outpoints{LookupOutpoints(LOOKUP_MAP_COINS * 2)};
+    CCoinsMapMemoryResource resource{huge_pages ? HUGE_PAGES_COINS_CHUNK_BYTES : CCoinsMapMemoryResource::DEFAULT_CHUNK_SIZE_BYTES, huge_pages};
+    CCoinsMap map{0, SaltedOutpointHasher{/*deterministic=*/true}, CCoinsMap::key_equal{}, &resource};
+    CoinsCachePair sentinel;
+    sentinel.second.SelfRef(sentinel);
+    for (size_t i{0}; i < LOOKUP_MAP_COINS; ++i) {
+        auto [it, inserted]{map.try_emplace(outpoints[i * 2], LookupCoin())};
+        CCoinsCacheEntry::SetDirty(*it, sentinel);
+    }
+    ReportEntriesPerMiB(bench, "CCoinsMap", map.size(), memusage::DynamicUsage(map));
+
+    size_t i{0};
+    size_t hits{0};
+    bench.unit("lookup").run([&] {
+        hits += map.count(outpoints[i]);
+        if (++i == outpoints.size()) i = 0;
+    });
+    assert(hits > 0);
+    // Unlink the entries before the sentinel they point to goes away.
+    map.clear();
+}
+
+static void CCoinsMapLookup(benchmark::Bench& bench)
+{
+    CoinsMapLookup(bench, /*huge_pages=*/false);
+}
+
+// Same lookups with the entries on transparent huge pages, where the kernel supports them.
+static void CCoinsMapLookupHugePages(benchmark::Bench& bench)
+{
+    CoinsMapLookup(bench, /*huge_pages=*/true);
+}
+
+// Same lookups in the open-addressing table with inline coins.
+static void CoinsFlatMapLookup(benchmark::Bench& bench)
+{
+    const auto outpoints{LookupOutpoints(LOOKUP_MAP_COINS * 2)};
+    CoinsFlatMap map{/*deterministic=*/true};
+    for (size_t i{0}; i < LOOKUP_MAP_COINS; ++i) {
+        const size_t slot{map.TryEmplace(outpoints[i * 2]).first};
+        map.Value(slot) = LookupCoin();
+        map.AddFlags(slot, CCoinsCacheEntry::DIRTY);
+    }
+    ReportEntriesPerMiB(bench, "CoinsFlatMap", map.size(), map.DynamicMemoryUsage());
+
+    size_t i{0};
+    size_t hits{0};
+    bench.unit("lookup").run([&] {
+        hits += map.Find(outpoints[i]) != CoinsFlatMap::npos;
+        if (++i == outpoints.size()) i = 0;
+    });
+    assert(hits > 0);
+}
+
 BENCHMARK(CCoinsCaching, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapLookup, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapLookupHugePages, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinsFlatMapLookup, benchmark::PriorityLevel::HIGH);
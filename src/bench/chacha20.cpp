@@ -7,6 +7,7 @@
 #include <crypto/chacha20.h>
 #include <crypto/chacha20poly1305.h>
 #include <span.h>
+#include <tinyformat.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -15,6 +16,7 @@
 /* Number of bytes to process per iteration */
 static const uint64_t BUFFER_SIZE_TINY  = 64;
 static const uint64_t BUFFER_SIZE_SMALL = 256;
+static const uint64_t BUFFER_SIZE_MEDIUM = 4096;
 static const uint64_t BUFFER_SIZE_LARGE = 1024*1024;
 
 static void CHACHA20(benchmark::Bench& bench, size_t buffersize)
@@ -51,11 +53,37 @@ static void CHACHA20_256BYTES(benchmark::Bench& bench)
     CHACHA20(bench, BUFFER_SIZE_SMALL);
 }
 
+static void CHACHA20_4KB(benchmark::Bench& bench)
+{
+    CHACHA20(bench, BUFFER_SIZE_MEDIUM);
+}
+
 static void CHACHA20_1MB(benchmark::Bench& bench)
 {
     CHACHA20(bench, BUFFER_SIZE_LARGE);
 }
 
+static void CHACHA20_1MB_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::STANDARD)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_VEC128(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_VEC128)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_AVX2)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
 static void FSCHACHA20POLY1305_64BYTES(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_TINY);
@@ -66,6 +94,11 @@ static void FSCHACHA20POLY1305_256BYTES(benchmark::Bench& bench)
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_SMALL);
 }
 
+static void FSCHACHA20POLY1305_4KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305(bench, BUFFER_SIZE_MEDIUM);
+}
+
 static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_LARGE);
@@ -73,7 +106,12 @@ static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 
 BENCHMARK(CHACHA20_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_256BYTES, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_4KB, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_1MB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_VEC128, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_256BYTES, benchmark::PriorityLevel::HIGH);
+BENCHMARK(FSCHACHA20POLY1305_4KB, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_1MB, benchmark::PriorityLevel::HIGH);
@@ -8,6 +8,7 @@
 #include <common/args.h>
 #include <consensus/validation.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <span.h>
@@ -39,6 +40,23 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+// What scanning a block for its txids and output scripts costs when reading
+// them from a view of the raw block instead of deserializing it.
+static void ParseBlockViewTest(benchmark::Bench& bench)
+{
+    const std::span<const std::byte> data{benchmark::data::block413567};
+
+    bench.unit("block").run([&] {
+        const BlockView block{data};
+        size_t script_bytes{0};
+        for (const TxView& tx : block.Transactions()) {
+            ankerl::nanobench::doNotOptimizeAway(tx.GetHash());
+            tx.ForEachOutput([&](CAmount, std::span<const unsigned char> script_pubkey) { script_bytes += script_pubkey.size(); });
+        }
+        assert(script_bytes > 0);
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::block413567);
@@ -61,4 +79,5 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 }
 
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ParseBlockViewTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
@@ -5,9 +5,11 @@
 #include <bench/bench.h>
 #include <checkqueue.h>
 #include <common/system.h>
+#include <crypto/sha256.h>
 #include <key.h>
 #include <prevector.h>
 #include <random.h>
+#include <tinyformat.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -66,3 +68,35 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     });
 }
 BENCHMARK(CCheckQueueSpeedPrevectorJob, benchmark::PriorityLevel::HIGH);
+
+// Scaling of the CheckQueue with the number of threads (including the master),
+// for jobs costing about as much as a signature check.
+static void CCheckQueueScaling(benchmark::Bench& bench)
+{
+    struct HashJob {
+        unsigned char data[64]{};
+        std::optional<int> operator()()
+        {
+            unsigned char out[CSHA256::OUTPUT_SIZE];
+            for (int i = 0; i < 64; ++i) {
+                CSHA256().Write(data, sizeof(data)).Finalize(out);
+                data[0] = out[0];
+            }
+            return std::nullopt;
+        }
+    };
+
+    // A block's worth of checks, added a few at a time as ConnectBlock does.
+    std::vector<std::vector<HashJob>> batches(BATCHES * 10, std::vector<HashJob>(3));
+    for (const int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        CCheckQueue<HashJob> queue{QUEUE_BATCH_SIZE, threads - 1};
+        bench.batch(batches.size() * 3).unit("job").run(strprintf("%d threads", threads), [&] {
+            CCheckQueueControl<HashJob> control(queue);
+            for (auto checks : batches) {
+                control.Add(std::move(checks));
+            }
+            control.Complete();
+        });
+    }
+}
+BENCHMARK(CCheckQueueScaling, benchmark::PriorityLevel::LOW);
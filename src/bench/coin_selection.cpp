@@ -56,7 +56,7 @@ static void addCoin(const CAmount& nValue, const CWallet& wallet, std::vector<st
 // same one over and over isn't too useful. Generating random isn't useful
 // either for measurements."
 // (https://github.com/bitcoin/bitcoin/issues/7883#issuecomment-224807484)
-static void CoinSelection(benchmark::Bench& bench)
+static void CoinSelection(benchmark::Bench& bench, bool parallel)
 {
     NodeContext node;
     auto chain = interfaces::MakeChain(node);
@@ -79,7 +79,7 @@ static void CoinSelection(benchmark::Bench& bench)
 
     const CoinEligibilityFilter filter_standard(1, 6, 0);
     FastRandomContext rand{};
-    const CoinSelectionParams coin_selection_params{
+    CoinSelectionParams coin_selection_params{
         rand,
         /*change_output_size=*/ 34,
         /*change_spend_size=*/ 148,
@@ -90,6 +90,7 @@ static void CoinSelection(benchmark::Bench& bench)
         /*tx_noinputs_size=*/ 0,
         /*avoid_partial=*/ false,
     };
+    coin_selection_params.m_parallel_selection = parallel;
     auto group = wallet::GroupOutputs(wallet, available_coins, coin_selection_params, {{filter_standard}})[filter_standard];
     bench.run([&] {
         auto result = AttemptSelection(wallet.chain(), 1002.99 * COIN, group, coin_selection_params, /*allow_mixed_output_types=*/true);
@@ -137,5 +138,9 @@ static void BnBExhaustion(benchmark::Bench& bench)
     });
 }
 
-BENCHMARK(CoinSelection, benchmark::PriorityLevel::HIGH);
+static void CoinSelectionParallel(benchmark::Bench& bench) { CoinSelection(bench, /*parallel=*/true); }
+static void CoinSelectionSequential(benchmark::Bench& bench) { CoinSelection(bench, /*parallel=*/false); }
+
+BENCHMARK(CoinSelectionParallel, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinSelectionSequential, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BnBExhaustion, benchmark::PriorityLevel::HIGH);
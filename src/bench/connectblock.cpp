@@ -89,18 +89,27 @@ std::pair<std::vector<CKey>, std::vector<CTxOut>> CreateKeysAndOutputs(const CKe
     return {keys, outputs};
 }
 
-void BenchmarkConnectBlock(benchmark::Bench& bench, std::vector<CKey>& keys, std::vector<CTxOut>& outputs, TestChain100Setup& test_setup)
+/*
+ * Connects the test block to a new view each time, or, with reuse_view, to
+ * the same view, which is reset in between like in ConnectTip().
+ */
+void BenchmarkConnectBlock(benchmark::Bench& bench, std::vector<CKey>& keys, std::vector<CTxOut>& outputs, TestChain100Setup& test_setup, bool reuse_view = false)
 {
     const auto& test_block{CreateTestBlock(test_setup, keys, outputs)};
+    auto& chainman{test_setup.m_node.chainman};
+    auto& chainstate{chainman->ActiveChainstate()};
+    CCoinsViewCache reused_view{&WITH_LOCK(cs_main, return chainstate.CoinsTip())};
     bench.unit("block").run([&] {
         LOCK(cs_main);
-        auto& chainman{test_setup.m_node.chainman};
-        auto& chainstate{chainman->ActiveChainstate()};
         BlockValidationState test_block_state;
         auto* pindex{chainman->m_blockman.AddToBlockIndex(test_block, chainman->m_best_header)}; // Doing this here doesn't impact the benchmark
-        CCoinsViewCache viewNew{&chainstate.CoinsTip()};
-
-        assert(chainstate.ConnectBlock(test_block, test_block_state, pindex, viewNew));
+        if (reuse_view) {
+            reused_view.Reset();
+            assert(chainstate.ConnectBlock(test_block, test_block_state, pindex, reused_view));
+        } else {
+            CCoinsViewCache viewNew{&chainstate.CoinsTip()};
+            assert(chainstate.ConnectBlock(test_block, test_block_state, pindex, viewNew));
+        }
     });
 }
 
@@ -126,6 +135,14 @@ static void ConnectBlockAllEcdsa(benchmark::Bench& bench)
     BenchmarkConnectBlock(bench, keys, outputs, *test_setup);
 }
 
+static void ConnectBlockAllSchnorrReusedView(benchmark::Bench& bench)
+{
+    const auto test_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    auto [keys, outputs]{CreateKeysAndOutputs(test_setup->coinbaseKey, /*num_schnorr=*/5, /*num_ecdsa=*/0)};
+    BenchmarkConnectBlock(bench, keys, outputs, *test_setup, /*reuse_view=*/true);
+}
+
 BENCHMARK(ConnectBlockAllSchnorr, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnectBlockAllSchnorrReusedView, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ConnectBlockMixedEcdsaSchnorr, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ConnectBlockAllEcdsa, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,323 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addrman.h>
+#include <bench/bench.h>
+#include <bench/data/block413567.raw.h>
+#include <chainparams.h>
+#include <compat/compat.h>
+#include <net.h>
+#include <net_processing.h>
+#include <netaddress.h>
+#include <netbase.h>
+#include <netgroup.h>
+#include <netmessagemaker.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <protocol.h>
+#include <scheduler.h>
+#include <serialize.h>
+#include <streams.h>
+#include <sync.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+#include <util/sock.h>
+#include <util/time.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+
+//! Number of peers flooding the node, a typical number of full outbound and
+//! inbound peers sending at the same time.
+constexpr size_t NUM_PEERS{8};
+//! Entries of each inv message, as announced by a peer relaying transactions.
+constexpr size_t INV_ENTRIES{20};
+
+/**
+ * Message processor counting the messages the node receives and answering
+ * pings, so that the benchmarks measure the network stack of CConnman only
+ * and not the processing of the messages by PeerManager.
+ */
+class CountingMsgProc final : public NetEventsInterface
+{
+public:
+    explicit CountingMsgProc(CConnman& connman) : m_connman{connman} {}
+
+    void InitializeNode(const CNode&, ServiceFlags) override {}
+    void FinalizeNode(const CNode&) override {}
+    bool HasAllDesirableServiceFlags(ServiceFlags) const override { return true; }
+    bool ProcessPeerLocalMessage(CNode*) override { return false; }
+    bool SendMessages(CNode*) override EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) { return false; }
+
+    bool ProcessMessages(CNode* node, std::atomic<bool>&) override EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex)
+    {
+        auto poll{node->PollMessage()};
+        if (!poll) return false;
+        auto& [msg, more]{*poll};
+        if (msg.m_type == NetMsgType::PING) {
+            uint64_t nonce;
+            msg.m_recv >> nonce;
+            m_connman.PushMessage(node, NetMsg::Make(NetMsgType::PONG, nonce));
+        }
+        return more;
+    }
+
+private:
+    CConnman& m_connman;
+};
+
+//! Two ends of a TCP connection over the loopback interface.
+std::pair<std::unique_ptr<Sock>, std::unique_ptr<Sock>> LoopbackPair()
+{
+    sockaddr_storage storage;
+    socklen_t len{sizeof(storage)};
+    assert(LookupNumeric("127.0.0.1").GetSockAddr(reinterpret_cast<sockaddr*>(&storage), &len));
+    const auto listener{CreateSock(AF_INET, SOCK_STREAM, IPPROTO_TCP)};
+    assert(listener);
+    assert(listener->Bind(reinterpret_cast<sockaddr*>(&storage), len) == 0);
+    assert(listener->Listen(1) == 0);
+    assert(listener->GetSockName(reinterpret_cast<sockaddr*>(&storage), &len) == 0);
+
+    auto remote{CreateSock(AF_INET, SOCK_STREAM, IPPROTO_TCP)};
+    assert(remote);
+    // The socket is non-blocking, so the connection completes once accepted.
+    remote->Connect(reinterpret_cast<sockaddr*>(&storage), len);
+    assert(listener->Wait(std::chrono::seconds{10}, Sock::RECV));
+    auto local{listener->Accept(nullptr, nullptr)};
+    assert(local && local->SetNonBlocking());
+
+    const int on{1};
+    local->SetSockOpt(IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    remote->SetSockOpt(IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return {std::move(local), std::move(remote)};
+}
+
+/** Remote end of a connection, sending messages to the node. */
+class RemotePeer
+{
+public:
+    RemotePeer(NodeId id, std::unique_ptr<Sock> sock, bool v2)
+        : m_sock{std::move(sock)}
+    {
+        if (v2) {
+            m_transport = std::make_unique<V2Transport>(id, /*initiating=*/true);
+        } else {
+            m_transport = std::make_unique<V1Transport>(id);
+        }
+    }
+
+    //! Queue a message, sending and receiving until the transport accepts it.
+    void Send(CSerializedNetMsg msg)
+    {
+        while (!m_transport->SetMessageToSend(msg)) Pump();
+    }
+
+    //! Send and receive until all queued bytes are sent and the node answered
+    //! the pings sent so far.
+    void Flush()
+    {
+        while (HasBytesToSend() || m_pongs < m_pings) Pump();
+    }
+
+    void Ping()
+    {
+        Send(NetMsg::Make(NetMsgType::PING, uint64_t{m_pings}));
+        ++m_pings;
+    }
+
+    //! Complete the handshake of the transport, which v2 connections need
+    //! before sending messages.
+    void Connect()
+    {
+        Ping();
+        Flush();
+    }
+
+private:
+    bool HasBytesToSend() const
+    {
+        return !std::get<0>(m_transport->GetBytesToSend(/*have_next_message=*/false)).empty();
+    }
+
+    void Pump()
+    {
+        const auto& [to_send, more, msg_type]{m_transport->GetBytesToSend(/*have_next_message=*/false)};
+        Sock::Event occurred{0};
+        const Sock::Event requested{static_cast<Sock::Event>(Sock::RECV | (to_send.empty() ? 0 : Sock::SEND))};
+        if (!m_sock->Wait(std::chrono::milliseconds{100}, requested, &occurred)) return;
+        if ((occurred & Sock::SEND) && !to_send.empty()) {
+            const auto sent{m_sock->Send(to_send.data(), to_send.size(), MSG_NOSIGNAL | MSG_DONTWAIT)};
+            if (sent > 0) m_transport->MarkBytesSent(sent);
+        }
+        if (occurred & Sock::RECV) {
+            uint8_t buf[0x10000];
+            const auto received{m_sock->Recv(buf, sizeof(buf), MSG_DONTWAIT)};
+            if (received <= 0) return;
+            std::span<const uint8_t> bytes{buf, size_t(received)};
+            while (!bytes.empty()) {
+                assert(m_transport->ReceivedBytes(bytes));
+                if (!m_transport->ReceivedMessageComplete()) continue;
+                bool reject{false};
+                const CNetMessage msg{m_transport->GetReceivedMessage(GetTime<std::chrono::microseconds>(), reject)};
+                if (!reject && msg.m_type == NetMsgType::PONG) ++m_pongs;
+            }
+        }
+    }
+
+    std::unique_ptr<Sock> m_sock;
+    std::unique_ptr<Transport> m_transport;
+    uint64_t m_pings{0};
+    uint64_t m_pongs{0};
+};
+
+/**
+ * Node whose CConnman runs its socket and message handler threads, with peers
+ * connected to it over the loopback interface.
+ */
+class LoopbackNode
+{
+public:
+    LoopbackNode(size_t num_peers, bool v2)
+        : m_connman{/*seed0=*/0x1337, /*seed1=*/0x1337, m_addrman, m_netgroupman, Params()}
+    {
+        CConnman::Options options;
+        options.m_local_services = ServiceFlags(NODE_NETWORK | NODE_WITNESS | NODE_P2P_V2);
+        options.m_max_automatic_connections = DEFAULT_MAX_PEER_CONNECTIONS;
+        options.m_msgproc = &m_msgproc;
+        options.nSendBufferMaxSize = DEFAULT_MAXSENDBUFFER * 1000;
+        options.nReceiveFloodSize = DEFAULT_MAXRECEIVEBUFFER * 1000;
+        // Peers never send a version message, so they must not be
+        // disconnected for not completing the version handshake.
+        options.m_peer_connect_timeout = std::chrono::seconds{std::chrono::hours{24}}.count();
+        options.bind_on_any = false;
+        options.m_use_addrman_outgoing = false;
+        options.m_i2p_accept_incoming = false;
+        assert(m_connman.Start(m_scheduler, options));
+
+        const CAddress addr{LookupNumeric("127.0.0.1"), NODE_NONE};
+        for (size_t i{0}; i < num_peers; ++i) {
+            auto [local, remote]{LoopbackPair()};
+            const NodeId id{NodeId(i)};
+            m_connman.AddTestNode(*new CNode{id, std::move(local), addr, /*nKeyedNetGroupIn=*/0, /*nLocalHostNonceIn=*/0,
+                                             CService{}, /*addrNameIn=*/"", ConnectionType::INBOUND, /*inbound_onion=*/false,
+                                             CNodeOptions{.use_v2transport = v2}});
+            m_peers.emplace_back(id, std::move(remote), v2);
+        }
+        for (auto& peer : m_peers) peer.Connect();
+    }
+
+    ~LoopbackNode()
+    {
+        // Disconnects and deletes the nodes.
+        m_connman.Stop();
+    }
+
+    std::vector<RemotePeer>& Peers() { return m_peers; }
+
+private:
+    const NetGroupManager m_netgroupman{{}};
+    AddrMan m_addrman{m_netgroupman, /*deterministic=*/true, /*consistency_check_ratio=*/0};
+    ConnmanTestMsg m_connman;
+    CountingMsgProc m_msgproc{m_connman};
+    //! Never started, so the tasks CConnman schedules never run.
+    CScheduler m_scheduler;
+    std::vector<RemotePeer> m_peers;
+};
+
+/**
+ * Measure the number of messages the node receives and hands to the message
+ * processor per second when all peers send it the same message. The bytes
+ * received per second are those times the size of the message.
+ *
+ * Each peer pings the node after its messages and waits for the pong, which
+ * the node sends once it processed all the messages of the peer.
+ */
+void Flood(benchmark::Bench& bench, const CSerializedNetMsg& msg, size_t messages_per_peer, bool v2)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::REGTEST, {.extra_args = {"-dnsseed=0"}})};
+    LoopbackNode node{NUM_PEERS, v2};
+    bench.batch(NUM_PEERS * messages_per_peer).unit("message").run([&] {
+        for (size_t i{0}; i < messages_per_peer; ++i) {
+            for (auto& peer : node.Peers()) peer.Send(msg.Copy());
+        }
+        for (auto& peer : node.Peers()) peer.Ping();
+        for (auto& peer : node.Peers()) peer.Flush();
+    });
+}
+
+CSerializedNetMsg InvMessage()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CInv> inv;
+    for (size_t i{0}; i < INV_ENTRIES; ++i) inv.emplace_back(MSG_WTX, rng.rand256());
+    return NetMsg::Make(NetMsgType::INV, inv);
+}
+
+CBlock GetBlock()
+{
+    CBlock block;
+    DataStream{benchmark::data::block413567} >> TX_WITH_WITNESS(block);
+    return block;
+}
+
+CSerializedNetMsg TxMessage()
+{
+    return NetMsg::Make(NetMsgType::TX, TX_WITH_WITNESS(*GetBlock().vtx.at(1)));
+}
+
+CSerializedNetMsg HeadersMessage()
+{
+    // A full headers message, as during headers sync.
+    const std::vector<CBlock> headers(MAX_HEADERS_RESULTS, CBlock{GetBlock().GetBlockHeader()});
+    return NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(headers));
+}
+
+CSerializedNetMsg BlockMessage()
+{
+    return NetMsg::Make(NetMsgType::BLOCK, TX_WITH_WITNESS(GetBlock()));
+}
+
+/** Measure the round trip of a ping to a node busy with no other peer. */
+void PingPong(benchmark::Bench& bench, bool v2)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::REGTEST, {.extra_args = {"-dnsseed=0"}})};
+    LoopbackNode node{/*num_peers=*/1, v2};
+    auto& peer{node.Peers().front()};
+    bench.unit("roundtrip").run([&] {
+        peer.Ping();
+        peer.Flush();
+    });
+}
+
+} // namespace
+
+static void ConnmanFloodInvV1(benchmark::Bench& bench) { Flood(bench, InvMessage(), /*messages_per_peer=*/100, /*v2=*/false); }
+static void ConnmanFloodInvV2(benchmark::Bench& bench) { Flood(bench, InvMessage(), /*messages_per_peer=*/100, /*v2=*/true); }
+static void ConnmanFloodTxV1(benchmark::Bench& bench) { Flood(bench, TxMessage(), /*messages_per_peer=*/100, /*v2=*/false); }
+static void ConnmanFloodTxV2(benchmark::Bench& bench) { Flood(bench, TxMessage(), /*messages_per_peer=*/100, /*v2=*/true); }
+static void ConnmanFloodHeadersV1(benchmark::Bench& bench) { Flood(bench, HeadersMessage(), /*messages_per_peer=*/10, /*v2=*/false); }
+static void ConnmanFloodHeadersV2(benchmark::Bench& bench) { Flood(bench, HeadersMessage(), /*messages_per_peer=*/10, /*v2=*/true); }
+static void ConnmanFloodBlockV1(benchmark::Bench& bench) { Flood(bench, BlockMessage(), /*messages_per_peer=*/2, /*v2=*/false); }
+static void ConnmanFloodBlockV2(benchmark::Bench& bench) { Flood(bench, BlockMessage(), /*messages_per_peer=*/2, /*v2=*/true); }
+static void ConnmanPingPongV1(benchmark::Bench& bench) { PingPong(bench, /*v2=*/false); }
+static void ConnmanPingPongV2(benchmark::Bench& bench) { PingPong(bench, /*v2=*/true); }
+
+BENCHMARK(ConnmanFloodInvV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodInvV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodTxV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodTxV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodHeadersV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodHeadersV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanFloodBlockV1, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnmanFloodBlockV2, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnmanPingPongV1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnmanPingPongV2, benchmark::PriorityLevel::HIGH);
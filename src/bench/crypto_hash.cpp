@@ -4,6 +4,7 @@
 
 
 #include <bench/bench.h>
+#include <common/system.h>
 #include <crypto/muhash.h>
 #include <crypto/ripemd160.h>
 #include <crypto/sha1.h>
@@ -11,12 +12,15 @@
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <hash.h>
 #include <random.h>
 #include <span.h>
 #include <tinyformat.h>
 #include <uint256.h>
+#include <util/threadpool.h>
 
 #include <cstdint>
+#include <future>
 #include <vector>
 
 /* Number of bytes to hash per iteration */
@@ -31,6 +35,49 @@ static void BenchRIPEMD160(benchmark::Bench& bench)
     });
 }
 
+static void RIPEMD160_32b(benchmark::Bench& bench)
+{
+    uint8_t hash[CRIPEMD160::OUTPUT_SIZE];
+    std::vector<uint8_t> in(32, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        CRIPEMD160().Write(in.data(), in.size()).Finalize(hash);
+        std::copy(hash, hash + 20, in.begin());
+    });
+}
+
+static void RIPEMD160_32b_Multi(benchmark::Bench& bench)
+{
+    static constexpr size_t BATCH_SIZE{64};
+    std::vector<uint8_t> in(32 * BATCH_SIZE, 0);
+    std::vector<uint8_t> out(20 * BATCH_SIZE);
+    bench.batch(BATCH_SIZE).unit("hash").run([&] {
+        RIPEMD160_32(out.data(), in.data(), BATCH_SIZE);
+        std::copy(out.begin(), out.begin() + 20, in.begin());
+    });
+}
+
+static void Hash160_33b(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(33, 0);
+    bench.batch(1).unit("hash").run([&] {
+        const uint160 hash{Hash160(in)};
+        std::copy(hash.begin(), hash.end(), in.begin());
+    });
+}
+
+static void Hash160_33b_Multi(benchmark::Bench& bench)
+{
+    static constexpr size_t BATCH_SIZE{64};
+    std::vector<uint8_t> in(33 * BATCH_SIZE, 0);
+    std::vector<std::span<const unsigned char>> inputs;
+    for (size_t i = 0; i < BATCH_SIZE; ++i) inputs.emplace_back(in.data() + 33 * i, 33);
+    std::vector<uint160> out(BATCH_SIZE);
+    bench.batch(BATCH_SIZE).unit("hash").run([&] {
+        Hash160Multi(out, inputs);
+        std::copy(out[0].begin(), out[0].end(), in.begin());
+    });
+}
+
 static void SHA1(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA1::OUTPUT_SIZE];
@@ -190,6 +237,26 @@ static void SHA512(benchmark::Bench& bench)
     });
 }
 
+static void SipHash_32b_Batch(benchmark::Bench& bench)
+{
+    static constexpr size_t BATCH_SIZE{64};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    auto k0{rng.rand64()}, k1{rng.rand64()};
+    std::vector<uint256> vals(BATCH_SIZE);
+    std::vector<const uint256*> ptrs;
+    for (uint256& val : vals) {
+        val = rng.rand256();
+        ptrs.push_back(&val);
+    }
+    std::vector<uint64_t> out(BATCH_SIZE);
+    bench.batch(BATCH_SIZE).unit("hash").run([&] {
+        SipHashUint256Batch(k0, k1, ptrs, out);
+        ankerl::nanobench::doNotOptimizeAway(out);
+        ++k0;
+        ++k1;
+    });
+}
+
 static void SipHash_32b(benchmark::Bench& bench)
 {
     FastRandomContext rng{/*fDeterministic=*/true};
@@ -262,7 +329,52 @@ static void MuHashFinalize(benchmark::Bench& bench)
     });
 }
 
+//! Serialized size of a typical coin, as hashed by the coinstatsindex.
+static constexpr size_t COIN_BYTES{70};
+
+static void MuHashInsertCoins(benchmark::Bench& bench)
+{
+    MuHash3072 acc;
+    FastRandomContext rng(true);
+    std::vector<unsigned char> coin{rng.randbytes(COIN_BYTES)};
+    uint32_t i = 0;
+    bench.unit("coin").run([&] {
+        coin[0] = ++i & 0xFF;
+        acc.Insert(coin);
+    });
+}
+
+// Hash the coins into an accumulator per block on all cores and combine the
+// blocks, like the coinstatsindex does during its initial sync.
+static void MuHashInsertCoinsParallel(benchmark::Bench& bench)
+{
+    static constexpr size_t COINS_PER_BLOCK{256};
+    static constexpr size_t BLOCKS{16};
+    FastRandomContext rng(true);
+    std::vector<std::vector<unsigned char>> coins;
+    for (size_t i{0}; i < COINS_PER_BLOCK * BLOCKS; ++i) coins.push_back(rng.randbytes(COIN_BYTES));
+
+    ThreadPool pool{"bench"};
+    pool.Start(GetNumCores());
+    MuHash3072 acc;
+    bench.batch(coins.size()).unit("coin").run([&] {
+        std::vector<std::future<MuHash3072>> blocks;
+        for (size_t start{0}; start < coins.size(); start += COINS_PER_BLOCK) {
+            blocks.push_back(pool.Submit([&coins, start] {
+                MuHash3072 block;
+                for (size_t i{start}; i < start + COINS_PER_BLOCK; ++i) block.Insert(coins[i]);
+                return block;
+            }));
+        }
+        for (auto& block : blocks) acc *= block.get();
+    });
+}
+
 BENCHMARK(BenchRIPEMD160, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RIPEMD160_32b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RIPEMD160_32b_Multi, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160_33b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160_33b_Multi, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA1, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_SSE4, benchmark::PriorityLevel::HIGH);
@@ -276,6 +388,7 @@ BENCHMARK(SHA256_32b_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_SHANI, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SipHash_32b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SipHash_32b_Batch, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
@@ -286,3 +399,5 @@ BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashDiv, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashPrecompute, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashFinalize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashInsertCoins, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashInsertCoinsParallel, benchmark::PriorityLevel::HIGH);
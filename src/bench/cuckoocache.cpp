@@ -0,0 +1,51 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <cuckoocache.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Like a default sized script execution cache, too large for the CPU caches.
+static constexpr size_t CACHE_BYTES{16 << 20};
+// About the number of transactions of a full block.
+static constexpr size_t LOOKUPS{3000};
+
+static void CuckooCacheLookup(benchmark::Bench& bench, bool batch)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CuckooCache::cache<uint256, SignatureCacheHasher> cache{};
+    const auto [num_elems, _] = cache.setup_bytes(CACHE_BYTES);
+    // Fill the cache halfway and look up as many present as missing elements.
+    std::vector<uint256> keys;
+    for (uint32_t i{0}; i < num_elems / 2; ++i) {
+        keys.push_back(rng.rand256());
+        cache.insert(keys.back());
+    }
+    std::vector<uint256> lookups;
+    for (size_t i{0}; i < LOOKUPS; ++i) {
+        lookups.push_back(rng.randbool() ? keys[rng.randrange(keys.size())] : rng.rand256());
+    }
+
+    bench.batch(LOOKUPS).unit("lookup").run([&] {
+        size_t found{0};
+        if (batch) {
+            for (const bool f : cache.contains(lookups, /*erase=*/false)) found += f;
+        } else {
+            for (const uint256& key : lookups) found += cache.contains(key, /*erase=*/false);
+        }
+        ankerl::nanobench::doNotOptimizeAway(found);
+    });
+}
+
+static void CuckooCacheContains(benchmark::Bench& bench) { CuckooCacheLookup(bench, /*batch=*/false); }
+static void CuckooCacheContainsBatch(benchmark::Bench& bench) { CuckooCacheLookup(bench, /*batch=*/true); }
+
+BENCHMARK(CuckooCacheContains, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CuckooCacheContainsBatch, benchmark::PriorityLevel::HIGH);
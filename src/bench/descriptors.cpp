@@ -6,7 +6,11 @@
 #include <key.h>
 #include <script/descriptor.h>
 #include <script/script.h>
+#include <script/sign.h>
 #include <script/signingprovider.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+#include <util/string.h>
 
 #include <cassert>
 #include <cstdint>
@@ -34,4 +38,59 @@ static void ExpandDescriptor(benchmark::Bench& bench)
     });
 }
 
+/** A thresh() policy of `n` distinct keys, `k` of which must sign. */
+static std::string MiniscriptThreshPolicy(int k, int n, bool xonly)
+{
+    std::string policy{"thresh(" + util::ToString(k)};
+    for (int i{0}; i < n; ++i) {
+        const uint256 secret{static_cast<uint8_t>(i + 1)};
+        CKey key;
+        key.Set(secret.begin(), secret.end(), /*fCompressedIn=*/true);
+        const CPubKey pubkey{key.GetPubKey()};
+        const std::string key_str{xonly ? HexStr(XOnlyPubKey{pubkey}) : HexStr(pubkey)};
+        policy += (i == 0 ? ",pk(" : ",s:pk(") + key_str + ")";
+    }
+    return policy + ")";
+}
+
+static void ParseMiniscriptDescriptor(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    // A tapscript leaf with a large policy, with an unspendable internal key.
+    const auto desc_str{"tr(50929b74c1a04954b78b4b6035e97a5e078a5a0f28ec96d547bfee9ace803ac0," + MiniscriptThreshPolicy(100, 200, /*xonly=*/true) + ")"};
+
+    bench.run([&] {
+        FlatSigningProvider provider;
+        std::string error;
+        const auto descs{Parse(desc_str, provider, error)};
+        assert(descs.size() == 1);
+    });
+}
+
+static void SatisfyMiniscriptDescriptor(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    // The largest thresh() of keys within the P2WSH resource limits, satisfied
+    // with dummy signatures as done to estimate the size of inputs.
+    const auto desc_str{"wsh(" + MiniscriptThreshPolicy(30, 60, /*xonly=*/false) + ")"};
+    FlatSigningProvider keys;
+    std::string error;
+    const auto descs{Parse(desc_str, keys, error)};
+    assert(descs.size() == 1);
+    std::vector<CScript> scripts;
+    FlatSigningProvider provider;
+    const bool expanded{descs[0]->Expand(0, keys, scripts, provider)};
+    assert(expanded);
+
+    bench.run([&] {
+        SignatureData sigdata;
+        const bool success{ProduceSignature(provider, DUMMY_MAXIMUM_SIGNATURE_CREATOR, scripts[0], sigdata)};
+        assert(success);
+    });
+}
+
 BENCHMARK(ExpandDescriptor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ParseMiniscriptDescriptor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SatisfyMiniscriptDescriptor, benchmark::PriorityLevel::HIGH);
@@ -10,7 +10,7 @@
 #include <utility>
 #include <vector>
 
-static GCSFilter::ElementSet GenerateGCSTestElements()
+static GCSFilter::ElementSet GenerateGCSTestElements(int num_elements = 100000)
 {
     GCSFilter::ElementSet elements;
 
@@ -18,7 +18,7 @@ static GCSFilter::ElementSet GenerateGCSTestElements()
     // with at least 100,000 elements results in benchmarks that have the same
     // ns/op. This makes it easy to reason about how long (in nanoseconds) a single
     // filter element takes to process.
-    for (int i = 0; i < 100000; ++i) {
+    for (int i = 0; i < num_elements; ++i) {
         GCSFilter::Element element(32);
         element[0] = static_cast<unsigned char>(i);
         element[1] = static_cast<unsigned char>(i >> 8);
@@ -52,6 +52,19 @@ static void GCSFilterConstruct(benchmark::Bench& bench)
     });
 }
 
+static void GCSFilterConstructBlockSize(benchmark::Bench& bench)
+{
+    // About as many elements as in the filter of a full block.
+    auto elements = GenerateGCSTestElements(5000);
+
+    uint64_t siphash_k0 = 0;
+    bench.run([&]{
+        GCSFilter filter({siphash_k0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+
+        siphash_k0++;
+    });
+}
+
 static void GCSFilterDecode(benchmark::Bench& bench)
 {
     auto elements = GenerateGCSTestElements();
@@ -88,6 +101,7 @@ static void GCSFilterMatch(benchmark::Bench& bench)
 }
 BENCHMARK(GCSBlockFilterGetHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterConstruct, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterConstructBlockSize, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecode, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecodeSkipCheck, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,211 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <chain.h>
+#include <coins.h>
+#include <consensus/amount.h>
+#include <key.h>
+#include <kernel/cs_main.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <random.h>
+#include <script/script.h>
+#include <script/sign.h>
+#include <script/signingprovider.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <uint256.h>
+#include <util/translation.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+//! Blocks with transactions, built on top of the blocks of TestChain100Setup
+//! and as many blocks maturing their coinbases.
+constexpr int NUM_BLOCKS{2000};
+constexpr CAmount FEE_PER_INPUT{1000};
+constexpr CAmount MIN_OUTPUT_VALUE{10000};
+
+struct Utxo {
+    COutPoint outpoint;
+    CTxOut txout;
+};
+
+CScript RandomScript(const std::vector<CKey>& keys, FastRandomContext& rng)
+{
+    // Roughly the share of the output types of recent mainnet blocks
+    const CPubKey pubkey{keys[rng.randrange(keys.size())].GetPubKey()};
+    const auto type{rng.randrange(100)};
+    if (type < 55) return GetScriptForDestination(WitnessV0KeyHash{pubkey});
+    if (type < 85) return GetScriptForDestination(WitnessV1Taproot{XOnlyPubKey{pubkey}});
+    return GetScriptForDestination(PKHash{pubkey});
+}
+
+//! Number of inputs or outputs, mostly small, with a tail of larger ones.
+size_t RandomCount(FastRandomContext& rng, size_t one, size_t two, size_t max)
+{
+    const size_t n{rng.randrange<size_t>(100)};
+    if (n < one) return 1;
+    if (n < one + two) return 2;
+    return 3 + rng.randrange(max - 2);
+}
+
+/**
+ * Pick an unspent output to spend. As on mainnet, many outputs are spent
+ * within a few blocks of their creation, which the coins cache serves, while
+ * the others are spread over the whole chain and come from the database once
+ * the cache has been flushed.
+ *
+ * @param[in] utxos  Unspent outputs by creation order.
+ */
+Utxo TakeUtxo(std::map<uint64_t, Utxo>& utxos, FastRandomContext& rng)
+{
+    auto it{std::prev(utxos.end())};
+    if (rng.randrange(100) < 60) {
+        for (auto steps{rng.randrange(std::min<uint64_t>(utxos.size(), 200))}; steps > 0; --steps) --it;
+    } else {
+        const uint64_t first{utxos.begin()->first};
+        it = utxos.lower_bound(first + rng.randrange(it->first - first + 1));
+    }
+    Utxo utxo{std::move(it->second)};
+    utxos.erase(it);
+    return utxo;
+}
+
+/**
+ * Generate a chain of blocks with transactions of mainnet-like shapes and
+ * output types, and return all its blocks but the genesis block. The chain is
+ * only generated once as signing its transactions takes a while.
+ */
+const std::vector<std::shared_ptr<const CBlock>>& GetChain()
+{
+    static const auto chain{[] {
+        const auto test_setup{MakeNoLogFileContext<TestChain100Setup>()};
+        auto& chainman{*test_setup->m_node.chainman};
+        FastRandomContext rng{/*fDeterministic=*/true};
+
+        std::vector<CKey> keys(64);
+        FillableSigningProvider keystore;
+        for (CKey& key : keys) {
+            const uint256 secret{rng.rand256()};
+            key.Set(secret.begin(), secret.end(), /*fCompressedIn=*/true);
+            if (!key.IsValid()) key = GenerateRandomKey();
+            keystore.AddKey(key);
+        }
+        keystore.AddKey(test_setup->coinbaseKey);
+
+        uint64_t next_index{0};
+        std::map<uint64_t, Utxo> utxos;
+        std::map<COutPoint, Coin> coins;
+        for (const auto& coinbase : test_setup->m_coinbase_txns) {
+            const COutPoint outpoint{coinbase->GetHash(), 0};
+            utxos.emplace(next_index++, Utxo{outpoint, coinbase->vout[0]});
+            coins.emplace(outpoint, Coin{coinbase->vout[0], /*nHeightIn=*/1, /*fCoinBaseIn=*/true});
+        }
+        test_setup->mineBlocks(COINBASE_MATURITY);
+
+        const CScript coinbase_script{GetScriptForDestination(WitnessV0KeyHash{test_setup->coinbaseKey.GetPubKey()})};
+        for (int height{0}; height < NUM_BLOCKS; ++height) {
+            // The first block fans out the coinbases of TestChain100Setup.
+            const size_t num_txs{height == 0 ? utxos.size() : 1 + rng.randrange(15)};
+            std::vector<CMutableTransaction> txs;
+            std::vector<Utxo> created;
+            for (size_t i{0}; i < num_txs && !utxos.empty(); ++i) {
+                CMutableTransaction tx;
+                std::map<COutPoint, Coin> spent;
+                CAmount in_value{0};
+                for (size_t num_inputs{height == 0 ? 1 : RandomCount(rng, 60, 25, 6)}; num_inputs > 0 && !utxos.empty(); --num_inputs) {
+                    const Utxo utxo{TakeUtxo(utxos, rng)};
+                    tx.vin.emplace_back(utxo.outpoint);
+                    in_value += utxo.txout.nValue;
+                    spent.insert(coins.extract(utxo.outpoint));
+                }
+                const CAmount out_value{in_value - FEE_PER_INPUT * CAmount(tx.vin.size())};
+                const size_t num_outputs{height == 0 ? 40 : std::clamp<size_t>(RandomCount(rng, 15, 70, 20), 1, std::max<CAmount>(1, out_value / MIN_OUTPUT_VALUE))};
+                for (size_t j{0}; j < num_outputs; ++j) {
+                    // The last output takes the change.
+                    const CAmount value{j + 1 < num_outputs ? out_value / CAmount(num_outputs) : out_value - out_value / CAmount(num_outputs) * CAmount(num_outputs - 1)};
+                    tx.vout.emplace_back(value, RandomScript(keys, rng));
+                }
+                std::map<int, bilingual_str> errors;
+                assert(SignTransaction(tx, &keystore, spent, SIGHASH_ALL, errors));
+                const Txid txid{tx.GetHash()};
+                for (uint32_t j{0}; j < tx.vout.size(); ++j) created.push_back({COutPoint{txid, j}, tx.vout[j]});
+                txs.push_back(std::move(tx));
+            }
+            const auto block{std::make_shared<const CBlock>(test_setup->CreateBlock(txs, coinbase_script, chainman.ActiveChainstate()))};
+            assert(chainman.ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr));
+            // Outputs are spent from the next block on, so transactions are in
+            // order. Outputs too small to pay for being spent are left unspent.
+            for (auto& utxo : created) {
+                if (utxo.txout.nValue < MIN_OUTPUT_VALUE) continue;
+                coins.emplace(utxo.outpoint, Coin{utxo.txout, height, /*fCoinBaseIn=*/false});
+                utxos.emplace(next_index++, std::move(utxo));
+            }
+        }
+
+        LOCK(::cs_main);
+        const CChain& active_chain{chainman.ActiveChain()};
+        assert(active_chain.Height() == 2 * COINBASE_MATURITY + NUM_BLOCKS);
+        std::vector<std::shared_ptr<const CBlock>> blocks;
+        for (int height{1}; height <= active_chain.Height(); ++height) {
+            auto block{std::make_shared<CBlock>()};
+            assert(chainman.m_blockman.ReadBlock(*block, *active_chain[height]));
+            blocks.push_back(std::move(block));
+        }
+        return blocks;
+    }()};
+    return chain;
+}
+
+/**
+ * Measure the throughput of ProcessNewBlock connecting a whole chain to a new
+ * node, as during IBD, with the coins and block databases on disk.
+ *
+ * Each run creates the node, which costs little compared to connecting the
+ * blocks. Runs are limited to three as each one connects thousands of blocks.
+ */
+void ProcessChain(benchmark::Bench& bench, int64_t dbcache_mib, int par)
+{
+    const auto& blocks{GetChain()};
+    const std::string dbcache_arg{strprintf("-dbcache=%d", dbcache_mib)};
+    bench.epochs(std::min<size_t>(bench.epochs(), 3)).epochIterations(1).batch(blocks.size()).unit("block").run([&] {
+        const auto test_setup{MakeNoLogFileContext<TestingSetup>(ChainType::REGTEST, {
+            .extra_args = {dbcache_arg.c_str()},
+            .coins_db_in_memory = false,
+            .block_tree_db_in_memory = false,
+            .worker_threads_num = par - 1,
+            .check_block_index = false,
+        })};
+        auto& chainman{*test_setup->m_node.chainman};
+        for (const auto& block : blocks) {
+            assert(chainman.ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr));
+        }
+        assert(WITH_LOCK(::cs_main, return chainman.ActiveHeight()) == int(blocks.size()));
+    });
+}
+
+} // namespace
+
+static void ProcessChainDefault(benchmark::Bench& bench) { ProcessChain(bench, /*dbcache_mib=*/450, /*par=*/3); }
+// The coins cache does not fit the UTXO set and is flushed as the chain is connected.
+static void ProcessChainSmallCache(benchmark::Bench& bench) { ProcessChain(bench, /*dbcache_mib=*/4, /*par=*/3); }
+static void ProcessChainSingleThread(benchmark::Bench& bench) { ProcessChain(bench, /*dbcache_mib=*/450, /*par=*/1); }
+
+BENCHMARK(ProcessChainDefault, benchmark::PriorityLevel::LOW);
+BENCHMARK(ProcessChainSmallCache, benchmark::PriorityLevel::LOW);
+BENCHMARK(ProcessChainSingleThread, benchmark::PriorityLevel::LOW);
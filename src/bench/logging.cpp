@@ -14,6 +14,9 @@
 // LogWithoutDebug should be ~3 orders of magnitude faster, as nothing is logged.
 //
 // LogWithoutWriteToFile should be ~2 orders of magnitude faster, as it avoids disk writes.
+//
+// LogWithDebugAsync measures the latency seen by the logging thread when the
+// background writer formats and writes the messages.
 
 static void Logging(benchmark::Bench& bench, const std::vector<const char*>& extra_args, const std::function<void()>& log)
 {
@@ -33,6 +36,19 @@ static void LogWithDebug(benchmark::Bench& bench)
     Logging(bench, {"-logthreadnames=0", "-debug=net"}, [] { LogDebug(BCLog::NET, "%s\n", "test"); });
 }
 
+static void LogWithDebugAsync(benchmark::Bench& bench)
+{
+    LogInstance().DisableCategory(BCLog::LogFlags::ALL);
+    TestingSetup test_setup{
+        ChainType::REGTEST,
+        {.extra_args = {"-logthreadnames=0", "-debug=net"}},
+    };
+    // Use a queue large enough for no message to be dropped.
+    LogInstance().StartAsyncWriter(/*max_queue_memusage=*/1'000'000'000);
+    bench.run([] { LogDebug(BCLog::NET, "%s\n", "test"); });
+    LogInstance().StopAsyncWriter();
+}
+
 static void LogWithoutDebug(benchmark::Bench& bench)
 {
     Logging(bench, {"-logthreadnames=0", "-debug=0"}, [] { LogDebug(BCLog::NET, "%s\n", "test"); });
@@ -58,6 +74,7 @@ static void LogWithoutWriteToFile(benchmark::Bench& bench)
 }
 
 BENCHMARK(LogWithDebug, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LogWithDebugAsync, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithoutDebug, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithThreadNames, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithoutThreadNames, benchmark::PriorityLevel::HIGH);
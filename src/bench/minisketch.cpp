@@ -0,0 +1,80 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <node/minisketchwrapper.h>
+#include <random.h>
+
+#include <minisketch.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+/** Capacity of the sketches, roughly the set difference Erlay reconciles at once. */
+constexpr size_t CAPACITY{32};
+/** Number of transactions announced in a reconciliation round. */
+constexpr size_t NUM_ELEMENTS{184};
+
+std::vector<uint64_t> RandomElements(FastRandomContext& rng, size_t count)
+{
+    std::vector<uint64_t> elements;
+    // Minisketch elements are non-zero and fit in the field size.
+    for (size_t i{0}; i < count; ++i) elements.push_back(1 + rng.randbits(31));
+    return elements;
+}
+
+Minisketch MakeSketch(const std::vector<uint64_t>& elements)
+{
+    Minisketch sketch{node::MakeMinisketch32(CAPACITY)};
+    for (const uint64_t element : elements) sketch.Add(element);
+    return sketch;
+}
+} // namespace
+
+static void MinisketchAdd(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto elements{RandomElements(rng, NUM_ELEMENTS)};
+    bench.batch(elements.size()).unit("element").run([&] {
+        auto sketch{MakeSketch(elements)};
+        ankerl::nanobench::doNotOptimizeAway(sketch.Serialize());
+    });
+}
+
+static void MinisketchMerge(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    auto sketch{MakeSketch(RandomElements(rng, NUM_ELEMENTS))};
+    const auto other{MakeSketch(RandomElements(rng, NUM_ELEMENTS))};
+    bench.run([&] {
+        sketch.Merge(other);
+    });
+    ankerl::nanobench::doNotOptimizeAway(sketch.Serialize());
+}
+
+static void MinisketchDecode(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    // The difference of two sets, filling the capacity of their sketches.
+    const auto shared{RandomElements(rng, NUM_ELEMENTS - CAPACITY / 2)};
+    auto ours{shared};
+    auto theirs{shared};
+    for (const uint64_t element : RandomElements(rng, CAPACITY / 2)) ours.push_back(element);
+    for (const uint64_t element : RandomElements(rng, CAPACITY / 2)) theirs.push_back(element);
+    auto sketch{MakeSketch(ours)};
+    sketch.Merge(MakeSketch(theirs));
+    bench.run([&] {
+        const auto difference{sketch.Decode(CAPACITY)};
+        assert(difference && difference->size() == CAPACITY);
+        ankerl::nanobench::doNotOptimizeAway(difference);
+    });
+}
+
+BENCHMARK(MinisketchAdd, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MinisketchMerge, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MinisketchDecode, benchmark::PriorityLevel::HIGH);
@@ -8,6 +8,7 @@
 #include <random.h>
 #include <test/util/net.h>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <vector>
@@ -134,6 +135,43 @@ static void EvictionProtection3Networks250Candidates(benchmark::Bench& bench)
         });
 }
 
+// Selection of a peer to evict among 1000 random candidates, as on every inbound connection
+// once the inbound slots are full, either from scratch or with incrementally maintained
+// rankings. Each iteration replaces the selected peer with a new one, as an inbound
+// connection flood does.
+static void EvictionSelect1000Candidates(benchmark::Bench& bench)
+{
+    FastRandomContext random_context{true};
+    std::vector<NodeEvictionCandidate> candidates{GetRandomNodeEvictionCandidates(1000, random_context)};
+    NodeId next_id{int64_t(candidates.size())};
+
+    bench.run([&] {
+        const auto evicted{SelectNodeToEvict(std::vector{candidates})};
+        if (!evicted) return;
+        auto it{std::find_if(candidates.begin(), candidates.end(), [&](const auto& c) { return c.id == *evicted; })};
+        *it = GetRandomNodeEvictionCandidates(1, random_context).front();
+        it->id = next_id++;
+    });
+}
+
+static void EvictionSelect1000CandidatesIncremental(benchmark::Bench& bench)
+{
+    FastRandomContext random_context{true};
+    std::vector<NodeEvictionCandidate> candidates{GetRandomNodeEvictionCandidates(1000, random_context)};
+    NodeId next_id{int64_t(candidates.size())};
+    EvictionCandidates eviction_candidates;
+    for (const auto& c : candidates) eviction_candidates.AddOrUpdate(c);
+
+    bench.run([&] {
+        const auto evicted{eviction_candidates.SelectNodeToEvict()};
+        if (!evicted) return;
+        eviction_candidates.Remove(*evicted);
+        NodeEvictionCandidate replacement{GetRandomNodeEvictionCandidates(1, random_context).front()};
+        replacement.id = next_id++;
+        eviction_candidates.AddOrUpdate(replacement);
+    });
+}
+
 // Candidate numbers used for the benchmarks:
 // -  50 candidates simulates a possible use of -maxconnections
 // - 100 candidates approximates an average node with default settings
@@ -152,3 +190,7 @@ BENCHMARK(EvictionProtection2Networks250Candidates, benchmark::PriorityLevel::HI
 BENCHMARK(EvictionProtection3Networks050Candidates, benchmark::PriorityLevel::HIGH);
 BENCHMARK(EvictionProtection3Networks100Candidates, benchmark::PriorityLevel::HIGH);
 BENCHMARK(EvictionProtection3Networks250Candidates, benchmark::PriorityLevel::HIGH);
+
+// Selection of the peer to evict among 1000 candidates.
+BENCHMARK(EvictionSelect1000Candidates, benchmark::PriorityLevel::HIGH);
+BENCHMARK(EvictionSelect1000CandidatesIncremental, benchmark::PriorityLevel::HIGH);
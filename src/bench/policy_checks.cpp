@@ -0,0 +1,65 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <consensus/amount.h>
+#include <policy/feerate.h>
+#include <policy/policy.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+CScript WitnessV0KeyHashScript() { return CScript() << OP_0 << std::vector<unsigned char>(20, 1); }
+CScript TaprootScript() { return CScript() << OP_1 << std::vector<unsigned char>(32, 2); }
+CScript KeyHashScript() { return CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 3) << OP_EQUALVERIFY << OP_CHECKSIG; }
+CScript ScriptHashScript() { return CScript() << OP_HASH160 << std::vector<unsigned char>(20, 4) << OP_EQUAL; }
+
+} // namespace
+
+// The policy checks of mempool acceptance on the inputs and outputs of a
+// transaction of the usual output types: IsStandardTx, AreInputsStandard and
+// IsWitnessStandard, as in MemPoolAccept::PreChecks.
+static void PolicyChecks(benchmark::Bench& bench)
+{
+    CCoinsView coins_dummy;
+    CCoinsViewCache coins{&coins_dummy};
+    CMutableTransaction mtx;
+    const std::vector<CScript> scripts{WitnessV0KeyHashScript(), TaprootScript(), KeyHashScript(), ScriptHashScript()};
+    for (uint32_t i{0}; i < 8; ++i) {
+        const COutPoint prevout{Txid::FromUint256(uint256{uint8_t(i + 1)}), i};
+        const CScript& script{scripts[i % scripts.size()]};
+        coins.AddCoin(prevout, Coin{CTxOut{COIN, script}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+        CTxIn& txin{mtx.vin.emplace_back(prevout)};
+        if (script == KeyHashScript()) {
+            txin.scriptSig << std::vector<unsigned char>(72, 0) << std::vector<unsigned char>(33, 2);
+        } else if (script == ScriptHashScript()) {
+            // A wrapped P2WPKH spend.
+            txin.scriptSig << std::vector<unsigned char>(WitnessV0KeyHashScript().begin(), WitnessV0KeyHashScript().end());
+            txin.scriptWitness.stack = {std::vector<unsigned char>(72, 0), std::vector<unsigned char>(33, 2)};
+        } else if (script == TaprootScript()) {
+            txin.scriptWitness.stack = {std::vector<unsigned char>(64, 0)};
+        } else {
+            txin.scriptWitness.stack = {std::vector<unsigned char>(72, 0), std::vector<unsigned char>(33, 2)};
+        }
+    }
+    for (const CScript& script : scripts) mtx.vout.emplace_back(COIN, script);
+    const CTransaction tx{mtx};
+
+    bench.unit("tx").run([&] {
+        std::string reason;
+        const bool standard{IsStandardTx(tx, MAX_OP_RETURN_RELAY, DEFAULT_PERMIT_BAREMULTISIG, CFeeRate{DUST_RELAY_TX_FEE}, reason) &&
+                            AreInputsStandard(tx, coins) && IsWitnessStandard(tx, coins)};
+        assert(standard);
+    });
+}
+
+BENCHMARK(PolicyChecks, benchmark::PriorityLevel::HIGH);
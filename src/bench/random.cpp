@@ -6,6 +6,7 @@
 #include <random.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <iterator>
 #include <numeric>
@@ -46,6 +47,16 @@ void BenchRandom_randbits(benchmark::Bench& bench, RNG&& rng) noexcept
     });
 }
 
+template<typename RNG>
+void BenchRandom_fillrand(benchmark::Bench& bench, RNG&& rng) noexcept
+{
+    // Smaller than a ChaCha20 block, like the salts and nonces drawn in practice.
+    std::array<std::byte, 24> buf;
+    bench.batch(buf.size()).unit("byte").run([&] {
+        rng.fillrand(buf);
+    });
+}
+
 template<int RANGE, typename RNG>
 void BenchRandom_randrange(benchmark::Bench& bench, RNG&& rng) noexcept
 {
@@ -70,6 +81,7 @@ void FastRandom_rand64(benchmark::Bench& bench) { BenchRandom_rand64(bench, Fast
 void FastRandom_rand32(benchmark::Bench& bench) { BenchRandom_rand32(bench, FastRandomContext(true)); }
 void FastRandom_randbool(benchmark::Bench& bench) { BenchRandom_randbool(bench, FastRandomContext(true)); }
 void FastRandom_randbits(benchmark::Bench& bench) { BenchRandom_randbits(bench, FastRandomContext(true)); }
+void FastRandom_fillrand(benchmark::Bench& bench) { BenchRandom_fillrand(bench, FastRandomContext(true)); }
 void FastRandom_randrange100(benchmark::Bench& bench) { BenchRandom_randrange<100>(bench, FastRandomContext(true)); }
 void FastRandom_randrange1000(benchmark::Bench& bench) { BenchRandom_randrange<1000>(bench, FastRandomContext(true)); }
 void FastRandom_randrange1000000(benchmark::Bench& bench) { BenchRandom_randrange<1000000>(bench, FastRandomContext(true)); }
@@ -79,6 +91,7 @@ void InsecureRandom_rand64(benchmark::Bench& bench) { BenchRandom_rand64(bench,
 void InsecureRandom_rand32(benchmark::Bench& bench) { BenchRandom_rand32(bench, InsecureRandomContext(251438)); }
 void InsecureRandom_randbool(benchmark::Bench& bench) { BenchRandom_randbool(bench, InsecureRandomContext(251438)); }
 void InsecureRandom_randbits(benchmark::Bench& bench) { BenchRandom_randbits(bench, InsecureRandomContext(251438)); }
+void InsecureRandom_fillrand(benchmark::Bench& bench) { BenchRandom_fillrand(bench, InsecureRandomContext(251438)); }
 void InsecureRandom_randrange100(benchmark::Bench& bench) { BenchRandom_randrange<100>(bench, InsecureRandomContext(251438)); }
 void InsecureRandom_randrange1000(benchmark::Bench& bench) { BenchRandom_randrange<1000>(bench, InsecureRandomContext(251438)); }
 void InsecureRandom_randrange1000000(benchmark::Bench& bench) { BenchRandom_randrange<1000000>(bench, InsecureRandomContext(251438)); }
@@ -90,6 +103,7 @@ BENCHMARK(FastRandom_rand64, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_rand32, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_randbool, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_randbits, benchmark::PriorityLevel::HIGH);
+BENCHMARK(FastRandom_fillrand, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_randrange100, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_randrange1000, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_randrange1000000, benchmark::PriorityLevel::HIGH);
@@ -99,6 +113,7 @@ BENCHMARK(InsecureRandom_rand64, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_rand32, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_randbool, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_randbits, benchmark::PriorityLevel::HIGH);
+BENCHMARK(InsecureRandom_fillrand, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_randrange100, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_randrange1000, benchmark::PriorityLevel::HIGH);
 BENCHMARK(InsecureRandom_randrange1000000, benchmark::PriorityLevel::HIGH);
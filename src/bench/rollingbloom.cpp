@@ -34,5 +34,30 @@ static void RollingBloomReset(benchmark::Bench& bench)
     });
 }
 
+static void BlockedRollingBloom(benchmark::Bench& bench)
+{
+    CBlockedRollingBloomFilter filter(120000, 0.000001);
+    std::vector<unsigned char> data(32);
+    uint32_t count = 0;
+    bench.run([&] {
+        count++;
+        WriteLE32(data.data(), count);
+        filter.insert(data);
+
+        WriteBE32(data.data(), count);
+        filter.contains(data);
+    });
+}
+
+static void BlockedRollingBloomReset(benchmark::Bench& bench)
+{
+    CBlockedRollingBloomFilter filter(120000, 0.000001);
+    bench.run([&] {
+        filter.reset();
+    });
+}
+
 BENCHMARK(RollingBloom, benchmark::PriorityLevel::HIGH);
 BENCHMARK(RollingBloomReset, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockedRollingBloom, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockedRollingBloomReset, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,102 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+//! Hashes of a large getheaders locator or merkle branch set, e.g. of a merkleblock.
+constexpr size_t NUM_HASHES{2000};
+
+std::vector<uint256> RandomHashes()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint256> hashes(NUM_HASHES);
+    for (auto& hash : hashes) hash = rng.rand256();
+    return hashes;
+}
+
+/**
+ * Serialize and deserialize a vector of hashes, either as vectors of types
+ * serialized as their bytes are, with one write or read, or element by
+ * element, as they were before.
+ */
+template <bool BULK>
+void SerializeHashes(benchmark::Bench& bench)
+{
+    const auto hashes{RandomHashes()};
+    DataStream stream;
+    std::vector<uint256> read;
+    bench.batch(hashes.size()).unit("hash").run([&] {
+        stream.clear();
+        if constexpr (BULK) {
+            stream << hashes;
+            stream >> read;
+        } else {
+            stream << Using<VectorFormatter<DefaultFormatter>>(hashes);
+            stream >> Using<VectorFormatter<DefaultFormatter>>(read);
+        }
+        assert(read.size() == hashes.size());
+    });
+}
+
+template <bool BULK>
+void SerializeSizeHashes(benchmark::Bench& bench)
+{
+    const auto hashes{RandomHashes()};
+    bench.batch(hashes.size()).unit("hash").run([&] {
+        size_t size;
+        if constexpr (BULK) {
+            size = GetSerializeSize(hashes);
+        } else {
+            size = GetSerializeSize(Using<VectorFormatter<DefaultFormatter>>(hashes));
+        }
+        ankerl::nanobench::doNotOptimizeAway(size);
+    });
+}
+
+template <bool BULK>
+void SerializeIntegers(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint32_t> ints(NUM_HASHES);
+    for (auto& i : ints) i = rng.rand32();
+    DataStream stream;
+    std::vector<uint32_t> read;
+    bench.batch(ints.size()).unit("integer").run([&] {
+        stream.clear();
+        if constexpr (BULK) {
+            stream << ints;
+            stream >> read;
+        } else {
+            stream << Using<VectorFormatter<DefaultFormatter>>(ints);
+            stream >> Using<VectorFormatter<DefaultFormatter>>(read);
+        }
+        assert(read.size() == ints.size());
+    });
+}
+
+} // namespace
+
+static void SerializeHashVectorBulk(benchmark::Bench& bench) { SerializeHashes<true>(bench); }
+static void SerializeHashVectorElements(benchmark::Bench& bench) { SerializeHashes<false>(bench); }
+static void SerializeSizeHashVectorBulk(benchmark::Bench& bench) { SerializeSizeHashes<true>(bench); }
+static void SerializeSizeHashVectorElements(benchmark::Bench& bench) { SerializeSizeHashes<false>(bench); }
+static void SerializeIntVectorBulk(benchmark::Bench& bench) { SerializeIntegers<true>(bench); }
+static void SerializeIntVectorElements(benchmark::Bench& bench) { SerializeIntegers<false>(bench); }
+
+BENCHMARK(SerializeHashVectorBulk, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SerializeHashVectorElements, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SerializeSizeHashVectorBulk, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SerializeSizeHashVectorElements, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SerializeIntVectorBulk, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SerializeIntVectorElements, benchmark::PriorityLevel::HIGH);
@@ -7,6 +7,7 @@
 #include <coins.h>
 #include <key.h>
 #include <primitives/transaction.h>
+#include <psbt.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
@@ -18,7 +19,9 @@
 #include <util/translation.h>
 
 #include <cassert>
+#include <cstdint>
 #include <map>
+#include <optional>
 #include <vector>
 
 enum class InputType {
@@ -73,6 +76,53 @@ static void SignTransactionSingleInput(benchmark::Bench& bench, InputType input_
 static void SignTransactionECDSA(benchmark::Bench& bench)   { SignTransactionSingleInput(bench, InputType::P2WPKH); }
 static void SignTransactionSchnorr(benchmark::Bench& bench) { SignTransactionSingleInput(bench, InputType::P2TR);   }
 
+static void SignPSBTManyInputs(benchmark::Bench& bench, InputType input_type)
+{
+    ECC_Context ecc_context{};
+    constexpr int NUM_INPUTS{2000};
+
+    // Sweep of many UTXOs, each locked to its own key, into a single output
+    FlatSigningProvider keystore;
+    CMutableTransaction unsigned_tx;
+    std::vector<CTxOut> spent_outputs;
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        CKey privkey = GenerateRandomKey();
+        CPubKey pubkey = privkey.GetPubKey();
+        CKeyID key_id = pubkey.GetID();
+        keystore.keys.emplace(key_id, privkey);
+        keystore.pubkeys.emplace(key_id, pubkey);
+
+        CScript prev_spk;
+        switch (input_type) {
+        case InputType::P2WPKH: prev_spk = GetScriptForDestination(WitnessV0KeyHash(pubkey)); break;
+        case InputType::P2TR:   prev_spk = GetScriptForDestination(WitnessV1Taproot(XOnlyPubKey{pubkey})); break;
+        default: assert(false);
+        }
+        unsigned_tx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+        spent_outputs.emplace_back(10000, prev_spk);
+    }
+    unsigned_tx.vout.emplace_back(NUM_INPUTS * 9000, spent_outputs[0].scriptPubKey);
+    PartiallySignedTransaction unsigned_psbt{unsigned_tx};
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        unsigned_psbt.inputs[i].witness_utxo = spent_outputs[i];
+    }
+
+    // Benchmark signing every input and finalizing, the way a wallet fills a PSBT.
+    bench.unit("input").batch(NUM_INPUTS).run([&] {
+        PartiallySignedTransaction psbt{unsigned_psbt};
+        const PrecomputedTransactionData txdata{PrecomputePSBTData(psbt)};
+        ForEachPSBTInput(psbt, [&](unsigned int i) {
+            const auto res{SignPSBTInput(keystore, psbt, i, &txdata, std::nullopt, nullptr, /*finalize=*/false)};
+            assert(res == common::PSBTError::OK);
+        });
+        bool complete = FinalizePSBT(psbt);
+        assert(complete);
+    });
+}
+
+static void SignPSBTManyInputsECDSA(benchmark::Bench& bench)   { SignPSBTManyInputs(bench, InputType::P2WPKH); }
+static void SignPSBTManyInputsSchnorr(benchmark::Bench& bench) { SignPSBTManyInputs(bench, InputType::P2TR);   }
+
 static void SignSchnorrTapTweakBenchmark(benchmark::Bench& bench, bool use_null_merkle_root)
 {
     FastRandomContext rng;
@@ -102,5 +152,7 @@ static void SignSchnorrWithNullMerkleRoot(benchmark::Bench& bench)
 
 BENCHMARK(SignTransactionECDSA, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignTransactionSchnorr, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SignPSBTManyInputsECDSA, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SignPSBTManyInputsSchnorr, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignSchnorrWithMerkleRoot, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignSchnorrWithNullMerkleRoot, benchmark::PriorityLevel::HIGH);
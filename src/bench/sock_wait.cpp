@@ -0,0 +1,79 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <util/sock.h>
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifdef USE_EPOLL
+
+#include <sys/socket.h>
+
+namespace {
+
+//! Number of connections, all idle but one, as on a node with many quiet peers.
+constexpr size_t NUM_PEERS{250};
+
+struct SockPairs {
+    //! The ends a node would wait on.
+    std::vector<std::shared_ptr<const Sock>> local;
+    //! The peers' ends.
+    std::vector<std::unique_ptr<Sock>> remote;
+
+    SockPairs()
+    {
+        for (size_t i{0}; i < NUM_PEERS; ++i) {
+            int fds[2];
+            assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+            local.push_back(std::make_shared<const Sock>(fds[0]));
+            remote.push_back(std::make_unique<Sock>(fds[1]));
+        }
+        // Leave one byte unread so that a single peer is always ready.
+        assert(remote.back()->Send("x", 1, 0) == 1);
+    }
+};
+
+} // namespace
+
+static void SockWaitManyIdlePeers(benchmark::Bench& bench)
+{
+    SockPairs pairs;
+    bench.run([&] {
+        // Rebuilt on every loop, as CConnman::GenerateWaitSockets() does.
+        Sock::EventsPerSock events_per_sock;
+        for (const auto& sock : pairs.local) {
+            events_per_sock.emplace(sock, Sock::Events{Sock::RECV});
+        }
+        const bool ok{pairs.local.front()->WaitMany(std::chrono::milliseconds{0}, events_per_sock)};
+        assert(ok);
+        assert(events_per_sock.at(pairs.local.back()).occurred & Sock::RECV);
+    });
+}
+
+static void SockPollerIdlePeers(benchmark::Bench& bench)
+{
+    SockPairs pairs;
+    SockPoller poller;
+    bench.run([&] {
+        // Interest is still set on every loop, as CConnman::UpdateSockPoller() does.
+        for (const auto& sock : pairs.local) {
+            poller.SetInterest(sock, Sock::RECV);
+        }
+        poller.RemoveStale();
+        Sock::EventsPerSock ready;
+        const bool ok{poller.Wait(std::chrono::milliseconds{0}, ready)};
+        assert(ok);
+        assert(ready.size() == 1);
+    });
+}
+
+BENCHMARK(SockWaitManyIdlePeers, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockPollerIdlePeers, benchmark::PriorityLevel::HIGH);
+
+#endif // USE_EPOLL
@@ -18,4 +18,14 @@ static void HexStrBench(benchmark::Bench& bench)
     });
 }
 
+static void ParseHexBench(benchmark::Bench& bench)
+{
+    auto const hex = HexStr(benchmark::data::block413567);
+    bench.batch(hex.size()).unit("byte").run([&] {
+        auto data = ParseHex(hex);
+        ankerl::nanobench::doNotOptimizeAway(data);
+    });
+}
+
 BENCHMARK(HexStrBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ParseHexBench, benchmark::PriorityLevel::HIGH);
@@ -3,12 +3,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <common/system.h>
 #include <random.h>
 #include <txgraph.h>
 #include <util/feefrac.h>
+#include <util/threadpool.h>
 
 #include <cassert>
 #include <cstdint>
+#include <vector>
 
 namespace {
 
@@ -116,8 +119,49 @@ void BenchTxGraphTrim(benchmark::Bench& bench)
     assert(graph->GetTransactionCount() >= (NUM_TOP_CHAINS * NUM_TX_PER_TOP_CHAIN * 99) / 100);
 }
 
+void BenchTxGraphRelinearize(benchmark::Bench& bench, int workers)
+{
+    // Many clusters of randomly dependent transactions, as left after a new block or a flood of
+    // replacements, whose linearizations all need to be improved at once.
+    static constexpr int MAX_CLUSTER_COUNT = 64;
+    static constexpr int NUM_CLUSTERS = 500;
+    static constexpr int NUM_TX_PER_CLUSTER = 48;
+    static constexpr int32_t MAX_CLUSTER_SIZE = 100'000 * 100;
+
+    InsecureRandomContext rng(11);
+    auto graph = MakeTxGraph(MAX_CLUSTER_COUNT, MAX_CLUSTER_SIZE);
+    std::vector<TxGraph::Ref> refs;
+    refs.reserve(NUM_CLUSTERS * NUM_TX_PER_CLUSTER);
+    for (int cluster = 0; cluster < NUM_CLUSTERS; ++cluster) {
+        for (int tx = 0; tx < NUM_TX_PER_CLUSTER; ++tx) {
+            refs.push_back(graph->AddTransaction({int64_t(rng.randbits<27>()) + 100, int32_t(rng.randrange(1000) + 100)}));
+            // Depend on the previous transaction and on random earlier ones of the cluster.
+            if (tx > 0) graph->AddDependency(refs[refs.size() - 2], refs.back());
+            for (int dep = 0; tx > 1 && dep < 2; ++dep) {
+                graph->AddDependency(refs[refs.size() - 2 - rng.randrange(tx - 1)], refs.back());
+            }
+        }
+    }
+    graph->DoWork();
+
+    GetSharedThreadPool().Start(workers);
+    bench.run([&] {
+        // Change a fee in every cluster, so that all of them need relinearizing.
+        for (int cluster = 0; cluster < NUM_CLUSTERS; ++cluster) {
+            graph->SetTransactionFee(refs[cluster * NUM_TX_PER_CLUSTER + rng.randrange(NUM_TX_PER_CLUSTER)], rng.randbits<27>() + 100);
+        }
+        graph->DoWork();
+    });
+    GetSharedThreadPool().Stop();
+    assert(!graph->IsOversized());
+}
+
 } // namespace
 
+static void TxGraphRelinearize(benchmark::Bench& bench) { BenchTxGraphRelinearize(bench, /*workers=*/0); }
+static void TxGraphRelinearizeParallel(benchmark::Bench& bench) { BenchTxGraphRelinearize(bench, GetNumCores()); }
 static void TxGraphTrim(benchmark::Bench& bench) { BenchTxGraphTrim(bench); }
 
+BENCHMARK(TxGraphRelinearize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxGraphRelinearizeParallel, benchmark::PriorityLevel::HIGH);
 BENCHMARK(TxGraphTrim, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,75 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txrequest.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static constexpr int NUM_PEERS{125};
+static constexpr int NUM_TXHASHES{12500};
+//! Every txhash is announced by this many peers, for 100k announcements in total.
+static constexpr int ANNOUNCERS_PER_TXHASH{8};
+
+/** Announce txhashes from many peers, then request, answer and expire them until nothing is left. */
+static void TxRequestAnnounceRequest(benchmark::Bench& bench)
+{
+    FastRandomContext rng{true};
+    std::vector<GenTxid> txhashes;
+    std::vector<std::vector<NodeId>> announcers(NUM_TXHASHES);
+    for (int i = 0; i < NUM_TXHASHES; ++i) {
+        txhashes.push_back(i % 2 ? GenTxid{Wtxid::FromUint256(rng.rand256())} : GenTxid{Txid::FromUint256(rng.rand256())});
+        for (int j = 0; j < ANNOUNCERS_PER_TXHASH; ++j) announcers[i].push_back(rng.randrange(NUM_PEERS));
+    }
+
+    bench.batch(NUM_TXHASHES * ANNOUNCERS_PER_TXHASH).unit("announcement").run([&] {
+        TxRequestTracker tracker{/*deterministic=*/true};
+        std::chrono::microseconds now{1s};
+        for (int i = 0; i < NUM_TXHASHES; ++i) {
+            for (NodeId peer : announcers[i]) {
+                tracker.ReceivedInv(peer, txhashes[i], /*preferred=*/peer % 4 == 0, now + std::chrono::microseconds{peer * 1000});
+            }
+        }
+        // Request everything that becomes requestable, and let a third of the requests time out.
+        while (tracker.Size() > 0) {
+            now += 100ms;
+            for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+                for (const GenTxid& gtxid : tracker.GetRequestable(peer, now)) {
+                    tracker.RequestedTx(peer, gtxid.ToUint256(), now + 1s);
+                    if (gtxid.ToUint256().GetUint64(0) % 3) tracker.ReceivedResponse(peer, gtxid.ToUint256());
+                }
+            }
+        }
+    });
+}
+
+/** Announce txhashes from many peers, then disconnect all of them. */
+static void TxRequestDisconnect(benchmark::Bench& bench)
+{
+    FastRandomContext rng{true};
+    std::vector<GenTxid> txhashes;
+    for (int i = 0; i < NUM_TXHASHES; ++i) txhashes.push_back(GenTxid{Wtxid::FromUint256(rng.rand256())});
+
+    bench.batch(NUM_TXHASHES * ANNOUNCERS_PER_TXHASH).unit("announcement").run([&] {
+        TxRequestTracker tracker{/*deterministic=*/true};
+        for (int i = 0; i < NUM_TXHASHES; ++i) {
+            for (int j = 0; j < ANNOUNCERS_PER_TXHASH; ++j) {
+                tracker.ReceivedInv((i + j * 16) % NUM_PEERS, txhashes[i], /*preferred=*/false, 1s);
+            }
+        }
+        tracker.GetRequestable(0, 2s);
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) tracker.DisconnectedPeer(peer);
+        assert(tracker.Size() == 0);
+    });
+}
+
+BENCHMARK(TxRequestAnnounceRequest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRequestDisconnect, benchmark::PriorityLevel::HIGH);
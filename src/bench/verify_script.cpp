@@ -87,5 +87,26 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
     });
 }
 
+// Stack manipulation and hashing, as found in tapscripts, which are not bound by
+// the limit on the number of opcodes.
+static void VerifyStackOpsScript(benchmark::Bench& bench)
+{
+    std::vector<std::vector<unsigned char>> stack;
+    CScript script;
+    script << std::vector<unsigned char>(32, 0x42);
+    for (int i = 0; i < 100; ++i) {
+        script << OP_DUP << OP_2DUP << OP_3DUP << OP_2DROP << OP_2DROP << OP_2DROP;
+        script << OP_DUP << OP_TOALTSTACK << OP_SHA256 << OP_FROMALTSTACK << OP_SWAP << OP_DROP;
+        script << OP_DUP << OP_DUP << OP_EQUALVERIFY;
+    }
+    bench.run([&] {
+        auto stack_copy = stack;
+        ScriptError error;
+        bool ret = EvalScript(stack_copy, script, 0, BaseSignatureChecker(), SigVersion::TAPSCRIPT, &error);
+        assert(ret);
+    });
+}
+
 BENCHMARK(VerifyScriptBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(VerifyNestedIfScript, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyStackOpsScript, benchmark::PriorityLevel::HIGH);
@@ -8,9 +8,11 @@
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <util/fs.h>
+#include <util/string.h>
 #include <util/translation.h>
 #include <wallet/context.h>
 #include <wallet/db.h>
+#include <wallet/scriptpubkeyman.h>
 #include <wallet/wallet.h>
 #include <wallet/walletutil.h>
 
@@ -22,9 +24,10 @@
 #include <vector>
 
 namespace wallet {
-static void WalletCreate(benchmark::Bench& bench, bool encrypted)
+static void WalletCreate(benchmark::Bench& bench, bool encrypted, int64_t keypool_size = DEFAULT_KEYPOOL_SIZE)
 {
     auto test_setup = MakeNoLogFileContext<TestingSetup>();
+    test_setup->m_args.ForceSetArg("-keypool", util::ToString(keypool_size));
     FastRandomContext random;
 
     WalletContext context;
@@ -59,8 +62,10 @@ static void WalletCreate(benchmark::Bench& bench, bool encrypted)
 
 static void WalletCreatePlain(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/false); }
 static void WalletCreateEncrypted(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/true); }
+static void WalletCreatePlainBigKeypool(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/false, /*keypool_size=*/10000); }
 
 BENCHMARK(WalletCreatePlain, benchmark::PriorityLevel::LOW);
 BENCHMARK(WalletCreateEncrypted, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletCreatePlainBigKeypool, benchmark::PriorityLevel::LOW);
 
 } // namespace wallet
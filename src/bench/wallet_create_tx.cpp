@@ -97,6 +97,7 @@ void generateFakeBlock(const CChainParams& params,
         CBlockIndex* pindex{context.chainman->m_blockman.AddToBlockIndex(block, context.chainman->m_best_header)};
         // add it to the chain
         context.chainman->ActiveChain().SetTip(*pindex);
+        context.chainman->UpdateActiveChainView();
     }
 
     // notify wallet
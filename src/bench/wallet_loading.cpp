@@ -8,6 +8,7 @@
 #include <outputtype.h>
 #include <primitives/transaction.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
 #include <util/check.h>
 #include <wallet/context.h>
 #include <wallet/db.h>
@@ -22,13 +23,15 @@
 #include <vector>
 
 namespace wallet{
-static void AddTx(CWallet& wallet)
+static COutPoint AddTx(CWallet& wallet, const COutPoint& prevout)
 {
     CMutableTransaction mtx;
     mtx.vout.emplace_back(COIN, GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32, ""))));
-    mtx.vin.emplace_back();
+    mtx.vin.emplace_back(prevout);
 
-    wallet.AddToWallet(MakeTransactionRef(mtx), TxStateInactive{});
+    const CTransactionRef tx{MakeTransactionRef(mtx)};
+    wallet.AddToWallet(tx, TxStateInactive{});
+    return COutPoint{tx->GetHash(), 0};
 }
 
 static void WalletLoadingDescriptors(benchmark::Bench& bench)
@@ -46,8 +49,10 @@ static void WalletLoadingDescriptors(benchmark::Bench& bench)
     auto wallet = TestLoadWallet(std::move(database), context, create_flags);
 
     // Generate a bunch of transactions and addresses to put into the wallet
+    // Each transaction spends the previous one, so loading also has to link the spends
+    COutPoint prevout{Txid::FromUint256(uint256::ONE), 0};
     for (int i = 0; i < 1000; ++i) {
-        AddTx(*wallet);
+        prevout = AddTx(*wallet, prevout);
     }
 
     database = DuplicateMockDatabase(wallet->GetDatabase());
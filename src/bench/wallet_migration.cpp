@@ -18,7 +18,7 @@
 
 namespace wallet{
 
-static void WalletMigration(benchmark::Bench& bench)
+static void BenchWalletMigration(benchmark::Bench& bench, int num_keys, int num_txs)
 {
     const auto test_setup{MakeNoLogFileContext<TestingSetup>()};
     const auto loader{MakeWalletLoader(*test_setup->m_node.chain, test_setup->m_args)};
@@ -47,21 +47,22 @@ static void WalletMigration(benchmark::Bench& bench)
         batch.WriteWatchOnly(script, CKeyMetadata());
     }
 
-    // Generate transactions and local addresses
-    for (int j = 0; j < 500; ++j) {
+    // Generate local addresses, and transactions to the first of them
+    for (int j = 0; j < num_keys; ++j) {
         CKey key = GenerateRandomKey();
         CPubKey pubkey = key.GetPubKey();
         // Load key, scripts and create address book record
         Assert(legacy_spkm->LoadKey(key, pubkey));
         CTxDestination dest{PKHash(pubkey)};
         Assert(wallet->SetAddressBook(dest, strprintf("legacy_%d", j), /*purpose=*/std::nullopt));
+        batch.WriteKey(pubkey, key.GetPrivKey(), CKeyMetadata());
+        if (j >= num_txs) continue;
 
         CMutableTransaction mtx;
         mtx.vout.emplace_back(COIN, GetScriptForDestination(dest));
         mtx.vout.emplace_back(COIN, scripts_watch_only.at(j % NUM_WATCH_ONLY_ADDR));
         mtx.vin.resize(2);
         wallet->AddToWallet(MakeTransactionRef(mtx), TxStateInactive{}, /*update_wtx=*/nullptr, /*rescanning_old_block=*/true);
-        batch.WriteKey(pubkey, key.GetPrivKey(), CKeyMetadata());
     }
 
     bench.epochs(/*numEpochs=*/1).epochIterations(/*numIters=*/1) // run the migration exactly once
@@ -73,6 +74,11 @@ static void WalletMigration(benchmark::Bench& bench)
          });
 }
 
+static void WalletMigration(benchmark::Bench& bench) { BenchWalletMigration(bench, /*num_keys=*/500, /*num_txs=*/500); }
+//! A wallet with many more keys than transactions, where migration time is dominated by the keys.
+static void WalletMigrationManyKeys(benchmark::Bench& bench) { BenchWalletMigration(bench, /*num_keys=*/5'000, /*num_txs=*/500); }
+
 BENCHMARK(WalletMigration, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletMigrationManyKeys, benchmark::PriorityLevel::LOW);
 
 } // namespace wallet
@@ -21,4 +21,22 @@ static void Xor(benchmark::Bench& bench)
     });
 }
 
+static void XorObfuscation(benchmark::Bench& bench, size_t size)
+{
+    FastRandomContext frc{/*fDeterministic=*/true};
+    auto data{frc.randbytes<std::byte>(size)};
+    auto key{frc.randbytes<std::byte>(8)};
+
+    bench.batch(data.size()).unit("byte").run([&] {
+        util::Xor(data, key, /*key_offset=*/3);
+    });
+}
+
+static void XorObfuscation1KiB(benchmark::Bench& bench) { XorObfuscation(bench, 1 << 10); }
+static void XorObfuscation64KiB(benchmark::Bench& bench) { XorObfuscation(bench, 64 << 10); }
+static void XorObfuscation4MiB(benchmark::Bench& bench) { XorObfuscation(bench, 4 << 20); }
+
 BENCHMARK(Xor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(XorObfuscation1KiB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(XorObfuscation64KiB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(XorObfuscation4MiB, benchmark::PriorityLevel::HIGH);
@@ -17,6 +17,7 @@
 #include <kernel/context.h>
 #include <kernel/warning.h>
 
+#include <chain.h>
 #include <consensus/validation.h>
 #include <core_io.h>
 #include <kernel/caches.h>
@@ -25,20 +26,137 @@
 #include <node/chainstate.h>
 #include <random.h>
 #include <script/sigcache.h>
+#include <streams.h>
+#include <tinyformat.h>
+#include <uint256.h>
 #include <util/chaintype.h>
 #include <util/fs.h>
 #include <util/signalinterrupt.h>
+#include <util/strencodings.h>
 #include <util/task_runner.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <ios>
 #include <iosfwd>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//! Block connected while replaying, with the time ProcessNewBlock took for it.
+struct ReplayedBlock {
+    int height;
+    uint256 hash;
+    size_t tx_count;
+    size_t size;
+    int64_t time_us;
+};
+
+/**
+ * Connect the blocks stored in the blk files of source_datadir that extend the
+ * active chain, until its tip reaches stop_height, timing each of them. Blocks
+ * found before their parent are remembered by position and connected once the
+ * parent is.
+ */
+static std::vector<ReplayedBlock> ReplayBlocks(ChainstateManager& chainman, const fs::path& source_datadir, int stop_height)
+{
+    const fs::path blocks_dir{source_datadir / "blocks"};
+    std::vector<std::byte> xor_key;
+    if (fs::exists(blocks_dir / "xor.dat")) {
+        xor_key.resize(8);
+        AutoFile{fsbridge::fopen(blocks_dir / "xor.dat", "rb")}.read(xor_key);
+    }
+    const auto block_path{[&](int file) { return blocks_dir / fs::u8path(strprintf("blk%05u.dat", file)); }};
+    const auto read_block{[&](int file, int64_t pos) {
+        auto block{std::make_shared<CBlock>()};
+        AutoFile in{fsbridge::fopen(block_path(file), "rb"), xor_key};
+        in.seek(pos, SEEK_SET);
+        in >> TX_WITH_WITNESS(*block);
+        return block;
+    }};
+    const auto tip_height{[&] { return WITH_LOCK(::cs_main, return chainman.ActiveHeight()); }};
+
+    std::vector<ReplayedBlock> replayed;
+    // Positions of blocks whose parent was not connected yet, by parent hash
+    std::multimap<uint256, std::pair<int, int64_t>> pending;
+    const auto connect{[&](std::shared_ptr<CBlock> first) {
+        std::vector<std::shared_ptr<CBlock>> queue{std::move(first)};
+        while (!queue.empty() && tip_height() < stop_height) {
+            const std::shared_ptr<CBlock> block{std::move(queue.back())};
+            queue.pop_back();
+            const uint256 hash{block->GetHash()};
+            {
+                LOCK(cs_main);
+                const CBlockIndex* pindex = chainman.m_blockman.LookupBlockIndex(block->hashPrevBlock);
+                if (pindex) {
+                    chainman.UpdateUncommittedBlockStructures(*block, pindex);
+                }
+            }
+            bool new_block{false};
+            const auto start{SteadyClock::now()};
+            chainman.ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/&new_block);
+            const auto elapsed{SteadyClock::now() - start};
+            {
+                LOCK(cs_main);
+                const CBlockIndex* tip = chainman.ActiveTip();
+                if (new_block && tip && tip->GetBlockHash() == hash) {
+                    replayed.push_back({tip->nHeight, hash, block->vtx.size(), GetSerializeSize(TX_WITH_WITNESS(*block)), Ticks<std::chrono::microseconds>(elapsed)});
+                }
+            }
+            const auto [begin, end]{pending.equal_range(hash)};
+            for (auto it{begin}; it != end; ++it) {
+                queue.push_back(read_block(it->second.first, it->second.second));
+            }
+            pending.erase(begin, end);
+        }
+    }};
+
+    for (int file{0}; tip_height() < stop_height && fs::exists(block_path(file)); ++file) {
+        AutoFile in{fsbridge::fopen(block_path(file), "rb"), xor_key};
+        while (tip_height() < stop_height) {
+            MessageStartChars magic;
+            uint32_t size;
+            int64_t pos;
+            CBlockHeader header;
+            try {
+                in >> magic;
+                // Past the last block, into space preallocated for the file
+                if (magic != chainman.GetParams().MessageStart()) break;
+                in >> size;
+                pos = in.tell();
+                in >> header;
+                in.seek(pos + size, SEEK_SET);
+            } catch (const std::ios_base::failure&) {
+                break;
+            }
+            bool known, parent_connectable;
+            {
+                LOCK(cs_main);
+                const CBlockIndex* index = chainman.m_blockman.LookupBlockIndex(header.GetHash());
+                known = index && (index->nStatus & BLOCK_HAVE_DATA);
+                const CBlockIndex* parent = chainman.m_blockman.LookupBlockIndex(header.hashPrevBlock);
+                parent_connectable = parent && (parent->nStatus & BLOCK_HAVE_DATA);
+            }
+            if (known) continue;
+            if (!parent_connectable) {
+                pending.emplace(header.hashPrevBlock, std::pair{file, pos});
+                continue;
+            }
+            connect(read_block(file, pos));
+        }
+    }
+    return replayed;
+}
 
 int main(int argc, char* argv[])
 {
@@ -49,17 +167,67 @@ int main(int argc, char* argv[])
     LogInstance().DisableLogging();
 
     // SETUP: Argument parsing and handling
-    if (argc != 2) {
+    std::optional<std::string> datadir_arg;
+    std::map<std::string, std::string> options_arg;
+    bool usage_error{false};
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg.starts_with('-')) {
+            const auto eq{arg.find('=')};
+            const std::string name{arg.substr(0, eq)};
+            if (name != "-dbcache" && name != "-par" && name != "-assumevalid" && name != "-replay" && name != "-stopheight") usage_error = true;
+            options_arg[name] = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        } else if (!datadir_arg) {
+            datadir_arg = arg;
+        } else {
+            usage_error = true;
+        }
+    }
+    const auto int_option{[&](const std::string& name) -> std::optional<int> {
+        const auto it{options_arg.find(name)};
+        if (it == options_arg.end()) return std::nullopt;
+        const auto value{ToIntegral<int>(it->second)};
+        if (!value) usage_error = true;
+        return value;
+    }};
+    const std::optional<int> dbcache_mib{int_option("-dbcache")};
+    const std::optional<int> par{int_option("-par")};
+    const std::optional<int> stop_height{int_option("-stopheight")};
+    std::optional<uint256> assumevalid;
+    if (options_arg.contains("-assumevalid")) {
+        const std::string& value{options_arg["-assumevalid"]};
+        assumevalid = value == "0" ? uint256{} : uint256::FromHex(value);
+        if (!assumevalid) usage_error = true;
+    }
+    const bool replay{options_arg.contains("-replay")};
+    if (replay && (options_arg["-replay"].empty() || !stop_height)) usage_error = true;
+    if (dbcache_mib && *dbcache_mib < 4) usage_error = true;
+    if (!datadir_arg || usage_error) {
         std::cerr
-            << "Usage: " << argv[0] << " DATADIR" << std::endl
+            << "Usage: " << argv[0] << " [options] DATADIR" << std::endl
             << "Display DATADIR information, and process hex-encoded blocks on standard input." << std::endl
             << std::endl
+            << "  -dbcache=<n>         Database cache size in MiB (default: " << DEFAULT_KERNEL_CACHE / 1_MiB << ")" << std::endl
+            << "  -par=<n>             Script verification threads, <= 0 leaves that many cores free (default: single threaded)" << std::endl
+            << "  -assumevalid=<hash>  Assume the ancestors of this block have valid scripts, 0 to verify all (default: chain default)" << std::endl
+            << "  -replay=<srcdir>     Instead of reading standard input, connect the blocks stored in the blk files of" << std::endl
+            << "                       <srcdir> on top of the chainstate in DATADIR, and print per-block timings as JSON" << std::endl
+            << "  -stopheight=<n>      Stop replaying once the tip reaches this height (required with -replay)" << std::endl
+            << std::endl
+            << "For a reproducible replay of the block range after height h, DATADIR should be a copy of a datadir" << std::endl
+            << "whose tip is at height h, or an empty directory to replay from genesis." << std::endl
+            << std::endl
             << "IMPORTANT: THIS EXECUTABLE IS EXPERIMENTAL, FOR TESTING ONLY, AND EXPECTED TO" << std::endl
             << "           BREAK IN FUTURE VERSIONS. DO NOT USE ON YOUR ACTUAL DATADIR." << std::endl;
         return 1;
     }
-    fs::path abs_datadir{fs::absolute(argv[1])};
+    fs::path abs_datadir{fs::absolute(fs::PathFromString(*datadir_arg))};
     fs::create_directories(abs_datadir);
+    const fs::path source_datadir{replay ? fs::absolute(fs::PathFromString(options_arg["-replay"])) : fs::path{}};
+    if (replay && fs::equivalent(source_datadir, abs_datadir)) {
+        std::cerr << "The -replay source must not be DATADIR." << std::endl;
+        return 1;
+    }
 
 
     // SETUP: Context
@@ -74,26 +242,29 @@ int main(int argc, char* argv[])
     class KernelNotifications : public kernel::Notifications
     {
     public:
+        //! Keep standard output for the replay report.
+        bool m_quiet{false};
+
         kernel::InterruptResult blockTip(SynchronizationState, CBlockIndex&, double) override
         {
-            std::cout << "Block tip changed" << std::endl;
+            if (!m_quiet) std::cout << "Block tip changed" << std::endl;
             return {};
         }
         void headerTip(SynchronizationState, int64_t height, int64_t timestamp, bool presync) override
         {
-            std::cout << "Header tip changed: " << height << ", " << timestamp << ", " << presync << std::endl;
+            if (!m_quiet) std::cout << "Header tip changed: " << height << ", " << timestamp << ", " << presync << std::endl;
         }
         void progress(const bilingual_str& title, int progress_percent, bool resume_possible) override
         {
-            std::cout << "Progress: " << title.original << ", " << progress_percent << ", " << resume_possible << std::endl;
+            if (!m_quiet) std::cout << "Progress: " << title.original << ", " << progress_percent << ", " << resume_possible << std::endl;
         }
         void warningSet(kernel::Warning id, const bilingual_str& message) override
         {
-            std::cout << "Warning " << static_cast<int>(id) << " set: " << message.original << std::endl;
+            if (!m_quiet) std::cout << "Warning " << static_cast<int>(id) << " set: " << message.original << std::endl;
         }
         void warningUnset(kernel::Warning id) override
         {
-            std::cout << "Warning " << static_cast<int>(id) << " unset" << std::endl;
+            if (!m_quiet) std::cout << "Warning " << static_cast<int>(id) << " unset" << std::endl;
         }
         void flushError(const bilingual_str& message) override
         {
@@ -105,17 +276,25 @@ int main(int argc, char* argv[])
         }
     };
     auto notifications = std::make_unique<KernelNotifications>();
+    notifications->m_quiet = replay;
 
-    kernel::CacheSizes cache_sizes{DEFAULT_KERNEL_CACHE};
+    kernel::CacheSizes cache_sizes{dbcache_mib ? *dbcache_mib * 1_MiB : DEFAULT_KERNEL_CACHE};
 
     // SETUP: Chainstate
     auto chainparams = CChainParams::Main();
-    const ChainstateManager::Options chainman_opts{
+    ChainstateManager::Options chainman_opts{
         .chainparams = *chainparams,
         .datadir = abs_datadir,
         .notifications = *notifications,
         .signals = &validation_signals,
     };
+    if (assumevalid) chainman_opts.assumed_valid_block = *assumevalid;
+    if (par) {
+        // -par semantics: <= 0 leaves that many cores free, and the validation
+        // thread counts towards the total.
+        const int script_threads{*par > 0 ? *par : *par + static_cast<int>(std::thread::hardware_concurrency())};
+        chainman_opts.worker_threads_num = std::clamp(script_threads - 1, 0, MAX_SCRIPTCHECK_THREADS);
+    }
     const node::BlockManager::Options blockman_opts{
         .chainparams = chainman_opts.chainparams,
         .blocks_dir = abs_datadir / "blocks",
@@ -123,6 +302,7 @@ int main(int argc, char* argv[])
         .block_tree_db_params = DBParams{
             .path = abs_datadir / "blocks" / "index",
             .cache_bytes = cache_sizes.block_tree_db,
+            .tuning = DB_TUNING_APPEND,
         },
     };
     util::SignalInterrupt interrupt;
@@ -149,6 +329,30 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (replay) {
+        const int start_height{WITH_LOCK(::cs_main, return chainman.ActiveHeight())};
+        const auto start{SteadyClock::now()};
+        const std::vector<ReplayedBlock> replayed{ReplayBlocks(chainman, source_datadir, *stop_height)};
+        const auto elapsed{SteadyClock::now() - start};
+        const int end_height{WITH_LOCK(::cs_main, return chainman.ActiveHeight())};
+
+        tfm::format(std::cout, "{\n");
+        tfm::format(std::cout, "  \"settings\": {\"dbcache_mib\": %d, \"script_threads\": %d, \"assumevalid\": \"%s\"},\n",
+                    (cache_sizes.block_tree_db + cache_sizes.coins_db + cache_sizes.coins) / 1_MiB,
+                    chainman_opts.worker_threads_num + 1,
+                    chainman.AssumedValidBlock().GetHex());
+        tfm::format(std::cout, "  \"start_height\": %d,\n  \"end_height\": %d,\n  \"blocks_connected\": %d,\n  \"total_time_us\": %d,\n",
+                    start_height, end_height, replayed.size(), Ticks<std::chrono::microseconds>(elapsed));
+        tfm::format(std::cout, "  \"blocks\": [");
+        for (size_t i = 0; i < replayed.size(); ++i) {
+            const ReplayedBlock& b{replayed[i]};
+            tfm::format(std::cout, "%s\n    {\"height\": %d, \"hash\": \"%s\", \"txs\": %d, \"size\": %d, \"time_us\": %d}",
+                        i ? "," : "", b.height, b.hash.GetHex(), b.tx_count, b.size, b.time_us);
+        }
+        tfm::format(std::cout, "\n  ]\n}\n");
+        goto epilogue;
+    }
+
     // Main program logic starts here
     std::cout
         << "Hello! I'm going to print out some information about your datadir." << std::endl
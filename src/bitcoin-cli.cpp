@@ -21,6 +21,7 @@
 #include <util/chaintype.h>
 #include <util/exception.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/time.h>
 #include <util/translation.h>
 
@@ -43,6 +44,7 @@
 #include <support/events.h>
 
 using util::Join;
+using util::SplitString;
 using util::ToString;
 
 // The server returns time values from a mockable system clock, but it is not
@@ -56,6 +58,7 @@ static const char DEFAULT_RPCCONNECT[] = "127.0.0.1";
 static const int DEFAULT_HTTP_CLIENT_TIMEOUT=900;
 static constexpr int DEFAULT_WAIT_CLIENT_TIMEOUT = 0;
 static const bool DEFAULT_NAMED=false;
+static constexpr int DEFAULT_BATCH_SIZE{1000};
 static const int CONTINUE_EXECUTION=-1;
 static constexpr uint8_t NETINFO_MAX_LEVEL{4};
 static constexpr int8_t UNKNOWN_NETWORK{-1};
@@ -89,11 +92,13 @@ static void SetupCliArgs(ArgsManager& argsman)
                              "RPC generatetoaddress nblocks and maxtries arguments. Example: bitcoin-cli -generate 4 1000",
                              DEFAULT_NBLOCKS, DEFAULT_MAX_TRIES),
                    ArgsManager::ALLOW_ANY, OptionsCategory::CLI_COMMANDS);
+    argsman.AddArg("-batch", "Read commands from standard input, one per line with the method and its arguments separated by whitespace, and send them over a single connection as JSON-RPC batches. The result of each command is printed on its own line, as soon as its batch is done; errors are printed to standard error, leaving an empty line. Can be combined with -named and -rpcwallet.", ArgsManager::ALLOW_ANY, OptionsCategory::CLI_COMMANDS);
     argsman.AddArg("-addrinfo", "Get the number of addresses known to the node, per network and total, after filtering for quality and recency. The total number of addresses known to the node may be higher.", ArgsManager::ALLOW_ANY, OptionsCategory::CLI_COMMANDS);
     argsman.AddArg("-getinfo", "Get general information from the remote server. Note that unlike server-side RPC calls, the output of -getinfo is the result of multiple non-atomic requests. Some entries in the output may represent results from different states (e.g. wallet balance may be as of a different block from the chain state reported)", ArgsManager::ALLOW_ANY, OptionsCategory::CLI_COMMANDS);
     argsman.AddArg("-netinfo", strprintf("Get network peer connection information from the remote server. An optional argument from 0 to %d can be passed for different peers listings (default: 0). If a non-zero value is passed, an additional \"outonly\" (or \"o\") argument can be passed to see outbound peers only. Pass \"help\" (or \"h\") for detailed help documentation.", NETINFO_MAX_LEVEL), ArgsManager::ALLOW_ANY, OptionsCategory::CLI_COMMANDS);
 
     SetupChainParamsBaseOptions(argsman);
+    argsman.AddArg("-batchsize=<n>", strprintf("Number of commands sent together in -batch mode (default: %d)", DEFAULT_BATCH_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-color=<when>", strprintf("Color setting for CLI output (default: %s). Valid values: always, auto (add color codes when standard output is connected to a terminal and OS is not WIN32), never. Only applies to the output of -getinfo.", DEFAULT_COLOR_SETTING), ArgsManager::ALLOW_ANY | ArgsManager::DISALLOW_NEGATION, OptionsCategory::OPTIONS);
     argsman.AddArg("-named", strprintf("Pass named instead of positional arguments (default: %s)", DEFAULT_NAMED), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-rpcclienttimeout=<n>", strprintf("Timeout in seconds during HTTP requests, or 0 for no timeout. (default: %d)", DEFAULT_HTTP_CLIENT_TIMEOUT), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -202,6 +207,8 @@ struct HTTPReply
     int status{0};
     int error{-1};
     std::string body;
+    //! Set once the request is over, successfully or not.
+    bool done{false};
 };
 
 static std::string http_errorstring(int code)
@@ -227,6 +234,7 @@ static std::string http_errorstring(int code)
 static void http_request_done(struct evhttp_request *req, void *ctx)
 {
     HTTPReply *reply = static_cast<HTTPReply*>(ctx);
+    reply->done = true;
 
     if (req == nullptr) {
         /* If req is nullptr, it means an error occurred while connecting: the
@@ -776,7 +784,26 @@ struct DefaultRequestHandler : BaseRequestHandler {
     }
 };
 
-static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, const std::vector<std::string>& args, const std::optional<std::string>& rpcwallet = {})
+/** Connection to the RPC server, which can be kept open for several requests. */
+class RPCConnection
+{
+public:
+    explicit RPCConnection(bool keep_alive);
+
+    /** Send a JSON-RPC request or batch of requests and return the parsed reply. */
+    UniValue Post(const UniValue& request, const std::optional<std::string>& rpcwallet);
+
+private:
+    const bool m_keep_alive;
+    std::string m_host;
+    uint16_t m_port{0};
+    std::string m_user_colon_pass;
+    bool m_failed_to_get_auth_cookie{false};
+    raii_event_base m_base;
+    raii_evhttp_connection m_evcon;
+};
+
+RPCConnection::RPCConnection(bool keep_alive) : m_keep_alive{keep_alive}
 {
     std::string host;
     // In preference order, we choose the following for the port:
@@ -820,26 +847,45 @@ static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, co
         }
     }
 
+    m_host = host;
+    m_port = port;
+
     // Obtain event base
-    raii_event_base base = obtain_event_base();
+    m_base = obtain_event_base();
 
     // Synchronously look up hostname
-    raii_evhttp_connection evcon = obtain_evhttp_connection_base(base.get(), host, port);
+    m_evcon = obtain_evhttp_connection_base(m_base.get(), host, port);
 
     // Set connection timeout
     {
         const int timeout = gArgs.GetIntArg("-rpcclienttimeout", DEFAULT_HTTP_CLIENT_TIMEOUT);
         if (timeout > 0) {
-            evhttp_connection_set_timeout(evcon.get(), timeout);
+            evhttp_connection_set_timeout(m_evcon.get(), timeout);
         } else {
             // Indefinite request timeouts are not possible in libevent-http, so we
             // set the timeout to a very long time period instead.
 
             constexpr int YEAR_IN_SECONDS = 31556952; // Average length of year in Gregorian calendar
-            evhttp_connection_set_timeout(evcon.get(), 5 * YEAR_IN_SECONDS);
+            evhttp_connection_set_timeout(m_evcon.get(), 5 * YEAR_IN_SECONDS);
         }
     }
 
+    // Get credentials
+    if (gArgs.GetArg("-rpcpassword", "") == "") {
+        // Try fall back to cookie-based authentication if no password is provided
+        if (!GetAuthCookie(&m_user_colon_pass)) {
+            m_failed_to_get_auth_cookie = true;
+        }
+    } else {
+        m_user_colon_pass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
+    }
+}
+
+UniValue RPCConnection::Post(const UniValue& request, const std::optional<std::string>& rpcwallet)
+{
+    const std::string& host{m_host};
+    const uint16_t port{m_port};
+
     HTTPReply response;
     raii_evhttp_request req = obtain_evhttp_request(http_request_done, (void*)&response);
     if (req == nullptr) {
@@ -848,27 +894,15 @@ static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, co
 
     evhttp_request_set_error_cb(req.get(), http_error_cb);
 
-    // Get credentials
-    std::string strRPCUserColonPass;
-    bool failedToGetAuthCookie = false;
-    if (gArgs.GetArg("-rpcpassword", "") == "") {
-        // Try fall back to cookie-based authentication if no password is provided
-        if (!GetAuthCookie(&strRPCUserColonPass)) {
-            failedToGetAuthCookie = true;
-        }
-    } else {
-        strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
-    }
-
     struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
     assert(output_headers);
     evhttp_add_header(output_headers, "Host", host.c_str());
-    evhttp_add_header(output_headers, "Connection", "close");
+    evhttp_add_header(output_headers, "Connection", m_keep_alive ? "keep-alive" : "close");
     evhttp_add_header(output_headers, "Content-Type", "application/json");
-    evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
+    evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(m_user_colon_pass)).c_str());
 
     // Attach request data
-    std::string strRequest = rh->PrepareRequest(strMethod, args).write() + "\n";
+    std::string strRequest = request.write() + "\n";
     struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
     assert(output_buffer);
     evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
@@ -884,13 +918,17 @@ static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, co
             throw CConnectionFailed("uri-encode failed");
         }
     }
-    int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, endpoint.c_str());
+    int r = evhttp_make_request(m_evcon.get(), req.get(), EVHTTP_REQ_POST, endpoint.c_str());
     req.release(); // ownership moved to evcon in above call
     if (r != 0) {
         throw CConnectionFailed("send http request failed");
     }
 
-    event_base_dispatch(base.get());
+    // A kept alive connection stays registered with the event base once the
+    // request is done, so only run the loop until then.
+    while (!response.done) {
+        if (event_base_loop(m_base.get(), EVLOOP_ONCE) != 0) break;
+    }
 
     if (response.status == 0) {
         std::string responseErrorMessage;
@@ -902,7 +940,7 @@ static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, co
                     "Use \"bitcoin-cli -help\" for more info.",
                     host, port, responseErrorMessage));
     } else if (response.status == HTTP_UNAUTHORIZED) {
-        if (failedToGetAuthCookie) {
+        if (m_failed_to_get_auth_cookie) {
             throw std::runtime_error(strprintf(
                 "Could not locate RPC credentials. No authentication cookie could be found, and RPC password is not set.  See -rpcpassword and -stdinrpcpass.  Configuration file: (%s)",
                 fs::PathToString(gArgs.GetConfigFilePath())));
@@ -920,7 +958,13 @@ static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, co
     UniValue valReply(UniValue::VSTR);
     if (!valReply.read(response.body))
         throw std::runtime_error("couldn't parse reply from server");
-    UniValue reply = rh->ProcessReply(valReply);
+    return valReply;
+}
+
+static UniValue CallRPC(BaseRequestHandler* rh, const std::string& strMethod, const std::vector<std::string>& args, const std::optional<std::string>& rpcwallet = {})
+{
+    RPCConnection connection{/*keep_alive=*/false};
+    UniValue reply = rh->ProcessReply(connection.Post(rh->PrepareRequest(strMethod, args), rpcwallet));
     if (reply.empty())
         throw std::runtime_error("expected reply to have result, error and id properties");
 
@@ -994,6 +1038,81 @@ static void ParseError(const UniValue& error, std::string& strPrint, int& nRet)
     nRet = abs(error["code"].getInt<int>());
 }
 
+/**
+ * BatchRPC reads commands from standard input, one per line, and sends them
+ * over a single connection as JSON-RPC batches of up to -batchsize commands,
+ * printing the result of each command on its own line once its batch is done.
+ *
+ * @returns the code of the first error, or 0 if all commands succeeded.
+ */
+static int BatchRPC()
+{
+    const int batch_size{std::max<int>(gArgs.GetIntArg("-batchsize", DEFAULT_BATCH_SIZE), 1)};
+    const std::optional<std::string> wallet_name{RpcWalletName(gArgs)};
+    if (gArgs.GetBoolArg("-rpcwait", false)) {
+        // Wait for the server, as a single command would, before connecting.
+        DefaultRequestHandler rh;
+        ConnectAndCallRPC(&rh, "uptime", /*args=*/{});
+    }
+    RPCConnection connection{/*keep_alive=*/true};
+    DefaultRequestHandler rh;
+    int ret{0};
+    int line_number{0};
+    std::string line;
+    bool eof{false};
+    while (!eof) {
+        UniValue batch(UniValue::VARR);
+        std::vector<int> line_numbers;
+        while (batch.size() < size_t(batch_size)) {
+            if (!std::getline(std::cin, line)) {
+                eof = true;
+                break;
+            }
+            ++line_number;
+            std::vector<std::string> args{SplitString(line, " \t\r")};
+            std::erase(args, "");
+            if (args.empty()) continue;
+            const std::string method{args.front()};
+            args.erase(args.begin());
+            UniValue request{rh.PrepareRequest(method, args)};
+            request.pushKV("id", int(batch.size()));
+            batch.push_back(std::move(request));
+            line_numbers.push_back(line_number);
+        }
+        if (batch.empty()) break;
+
+        const UniValue replies{connection.Post(batch, wallet_name)};
+        if (!replies.isArray()) {
+            int error_ret{EXIT_FAILURE};
+            std::string error;
+            ParseError(replies.find_value("error"), error, error_ret);
+            throw std::runtime_error(error);
+        }
+        std::vector<const UniValue*> by_id(batch.size(), nullptr);
+        for (const UniValue& reply : replies.getValues()) {
+            const UniValue& id{reply.find_value("id")};
+            if (id.isNum() && id.getInt<int>() >= 0 && size_t(id.getInt<int>()) < by_id.size()) by_id[id.getInt<int>()] = &reply;
+        }
+        for (size_t i{0}; i < by_id.size(); ++i) {
+            if (!by_id[i]) throw std::runtime_error(strprintf("no reply from server for line %d", line_numbers[i]));
+            const UniValue& error{by_id[i]->find_value("error")};
+            if (error.isNull()) {
+                const UniValue& result{by_id[i]->find_value("result")};
+                tfm::format(std::cout, "%s\n", result.isStr() ? result.get_str() : result.write());
+            } else {
+                int error_ret{0};
+                std::string error_str;
+                ParseError(error, error_str, error_ret);
+                if (ret == 0) ret = error_ret;
+                tfm::format(std::cerr, "line %d: %s\n", line_numbers[i], error_str);
+                tfm::format(std::cout, "\n");
+            }
+        }
+        std::cout.flush();
+    }
+    return ret;
+}
+
 /**
  * GetWalletBalances calls listwallets; if more than one wallet is loaded, it then
  * fetches mine.trusted balances for each loaded wallet and pushes them to `result`.
@@ -1236,6 +1355,11 @@ static int CommandLineRPC(int argc, char *argv[])
             }
             args.insert(args.begin() + 1, walletPass);
         }
+        if (gArgs.GetBoolArg("-batch", false)) {
+            if (!args.empty()) throw std::runtime_error("-batch reads the commands from standard input and takes no arguments");
+            if (gArgs.GetBoolArg("-stdin", false)) throw std::runtime_error("-batch and -stdin cannot be used together");
+            return BatchRPC();
+        }
         if (gArgs.GetBoolArg("-stdin", false)) {
             // Read one arg per line from stdin and append
             std::string line;
@@ -18,9 +18,21 @@
 #include <util/strencodings.h>
 #include <util/translation.h>
 
+#ifdef ENABLE_WALLET
+#include <coins.h>
+#include <hash.h>
+#include <node/utxo_snapshot.h>
+#include <util/fs.h>
+#include <util/threadpool.h>
+
+#include <sqlite3.h>
+#endif // ENABLE_WALLET
+
 #include <atomic>
 #include <cstdio>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -35,6 +47,9 @@ static void SetupBitcoinUtilArgs(ArgsManager &argsman)
     argsman.AddArg("-version", "Print version and exit", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 
     argsman.AddCommand("grind", "Perform proof of work on hex header string");
+#ifdef ENABLE_WALLET
+    argsman.AddCommand("utxotosqlite", "Convert a UTXO set snapshot written by dumptxoutset to a SQLite database");
+#endif // ENABLE_WALLET
 
     SetupChainParamsBaseOptions(argsman);
 }
@@ -61,7 +76,11 @@ static int AppInitUtil(ArgsManager& args, int argc, char* argv[])
                 "The bitcoin-util tool provides bitcoin related functionality that does not rely on the ability to access a running node. Available [commands] are listed below.\n"
                 "\n"
                 "Usage:  bitcoin-util [options] [command]\n"
-                "or:     bitcoin-util [options] grind <hex-block-header>\n";
+                "or:     bitcoin-util [options] grind <hex-block-header>\n"
+#ifdef ENABLE_WALLET
+                "or:     bitcoin-util [options] utxotosqlite <snapshot> <database>\n"
+#endif // ENABLE_WALLET
+                ;
             strUsage += "\n" + args.GetHelpMessage();
         }
 
@@ -149,6 +168,204 @@ static int Grind(const std::vector<std::string>& args, std::string& strPrint)
     return EXIT_SUCCESS;
 }
 
+#ifdef ENABLE_WALLET
+namespace {
+//! Number of coins decoded by one task and inserted in one database transaction.
+constexpr size_t UTXO_SQLITE_BATCH{64 * 1024};
+
+//! A coin of the utxos table, in the format of contrib/utxo-tools/utxo_to_sqlite.py.
+struct UTXORow {
+    std::string txid;
+    uint32_t vout;
+    CAmount value;
+    bool coinbase;
+    uint32_t height;
+    std::string script_pubkey;
+};
+
+std::vector<UTXORow> EncodeRows(const std::vector<std::pair<COutPoint, Coin>>& coins)
+{
+    std::vector<UTXORow> rows;
+    rows.reserve(coins.size());
+    for (const auto& [outpoint, coin] : coins) {
+        rows.push_back({outpoint.hash.GetHex(), outpoint.n, coin.out.nValue, bool(coin.fCoinBase), coin.nHeight, HexStr(coin.out.scriptPubKey)});
+    }
+    return rows;
+}
+
+//! Read the coins of one txid, as serialized in snapshots.
+template <typename Stream>
+void ReadSnapshotCoins(Stream& s, std::vector<std::pair<COutPoint, Coin>>& coins)
+{
+    Txid txid;
+    s >> txid;
+    const uint64_t count{ReadCompactSize(s)};
+    for (uint64_t i{0}; i < count; ++i) {
+        const uint32_t n{static_cast<uint32_t>(ReadCompactSize(s))};
+        Coin coin;
+        s >> coin;
+        coins.emplace_back(COutPoint{txid, n}, std::move(coin));
+    }
+}
+
+std::vector<UTXORow> DecodeChunk(const node::SnapshotChunk& chunk)
+{
+    if (Hash(chunk.payload) != chunk.payload_hash) throw std::runtime_error("snapshot chunk does not match its hash");
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    coins.reserve(chunk.coins_count);
+    SpanReader reader{chunk.payload};
+    while (!reader.empty()) ReadSnapshotCoins(reader, coins);
+    if (coins.size() != chunk.coins_count) throw std::runtime_error("snapshot chunk does not hold the number of coins it claims");
+    return EncodeRows(coins);
+}
+
+//! Database the coins are inserted into, one transaction per batch.
+class UTXODatabase
+{
+    sqlite3* m_db{nullptr};
+    sqlite3_stmt* m_insert{nullptr};
+
+    void Exec(const char* sql)
+    {
+        if (sqlite3_exec(m_db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(strprintf("%s: %s", sql, sqlite3_errmsg(m_db)));
+        }
+    }
+
+public:
+    explicit UTXODatabase(const fs::path& path)
+    {
+        if (sqlite3_open_v2(fs::PathToString(path).c_str(), &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+            const std::string error{m_db ? sqlite3_errmsg(m_db) : "out of memory"};
+            sqlite3_close(m_db);
+            throw std::runtime_error(strprintf("cannot open %s: %s", fs::PathToString(path), error));
+        }
+        // The database is new and removed if the conversion fails, so it does
+        // not need to survive crashes while being written.
+        Exec("PRAGMA journal_mode = OFF");
+        Exec("PRAGMA synchronous = OFF");
+        Exec("CREATE TABLE utxos(txid TEXT, vout INT, value INT, coinbase INT, height INT, scriptpubkey TEXT)");
+        if (sqlite3_prepare_v2(m_db, "INSERT INTO utxos VALUES(?, ?, ?, ?, ?, ?)", -1, &m_insert, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(strprintf("cannot prepare insert statement: %s", sqlite3_errmsg(m_db)));
+        }
+    }
+
+    ~UTXODatabase()
+    {
+        sqlite3_finalize(m_insert);
+        sqlite3_close(m_db);
+    }
+
+    UTXODatabase(const UTXODatabase&) = delete;
+    UTXODatabase& operator=(const UTXODatabase&) = delete;
+
+    void Insert(const std::vector<UTXORow>& rows)
+    {
+        Exec("BEGIN");
+        for (const UTXORow& row : rows) {
+            sqlite3_bind_text(m_insert, 1, row.txid.data(), static_cast<int>(row.txid.size()), SQLITE_STATIC);
+            sqlite3_bind_int64(m_insert, 2, row.vout);
+            sqlite3_bind_int64(m_insert, 3, row.value);
+            sqlite3_bind_int(m_insert, 4, row.coinbase);
+            sqlite3_bind_int64(m_insert, 5, row.height);
+            sqlite3_bind_text(m_insert, 6, row.script_pubkey.data(), static_cast<int>(row.script_pubkey.size()), SQLITE_STATIC);
+            const int ret{sqlite3_step(m_insert)};
+            sqlite3_reset(m_insert);
+            if (ret != SQLITE_DONE) throw std::runtime_error(strprintf("cannot insert coin: %s", sqlite3_errmsg(m_db)));
+        }
+        Exec("COMMIT");
+    }
+};
+
+/**
+ * Stream the coins of snapshot into database. Coins are decoded and encoded
+ * into rows on `threads` threads, at most one batch more than there are
+ * threads ahead of the batch being inserted, which bounds the memory used.
+ * Chunked snapshots are decoded in parallel as a whole; the coins of other
+ * snapshots have to be read in order, so only their encoding is parallel.
+ */
+uint64_t ConvertUTXOSnapshot(AutoFile& snapshot, const node::SnapshotMetadata& metadata, UTXODatabase& database, int threads)
+{
+    ThreadPool pool{"utxoconvert"};
+    pool.Start(threads);
+    std::deque<std::future<std::vector<UTXORow>>> pending;
+    uint64_t coins_read{0};
+    uint64_t coins_written{0};
+    const auto insert_front{[&] {
+        const auto rows{pending.front().get()};
+        pending.pop_front();
+        database.Insert(rows);
+        coins_written += rows.size();
+    }};
+
+    while (coins_read < metadata.m_coins_count) {
+        if (metadata.IsChunked()) {
+            auto chunk{std::make_shared<node::SnapshotChunk>()};
+            snapshot >> *chunk;
+            if (chunk->coins_count == 0 || chunk->coins_count > metadata.m_coins_count - coins_read) {
+                throw std::runtime_error("snapshot chunk holds more coins than the snapshot");
+            }
+            coins_read += chunk->coins_count;
+            pending.push_back(pool.Submit([chunk] { return DecodeChunk(*chunk); }));
+        } else {
+            std::vector<std::pair<COutPoint, Coin>> coins;
+            while (coins.size() < UTXO_SQLITE_BATCH && coins_read + coins.size() < metadata.m_coins_count) {
+                ReadSnapshotCoins(snapshot, coins);
+            }
+            coins_read += coins.size();
+            pending.push_back(pool.Submit([coins = std::move(coins)] { return EncodeRows(coins); }));
+        }
+        if (pending.size() > static_cast<size_t>(threads)) insert_front();
+    }
+    while (!pending.empty()) insert_front();
+
+    if (coins_written != metadata.m_coins_count) {
+        throw std::runtime_error(strprintf("snapshot holds %d coins instead of %d", coins_written, metadata.m_coins_count));
+    }
+    return coins_written;
+}
+} // namespace
+
+static int UTXOToSQLite(const std::vector<std::string>& args, std::string& strPrint)
+{
+    if (args.size() != 2) {
+        strPrint = "Must specify a snapshot file and a database file";
+        return EXIT_FAILURE;
+    }
+    const fs::path snapshot_path{fs::u8path(args[0])};
+    const fs::path database_path{fs::u8path(args[1])};
+    if (fs::exists(database_path)) {
+        strPrint = strprintf("%s already exists", args[1]);
+        return EXIT_FAILURE;
+    }
+    AutoFile snapshot{fsbridge::fopen(snapshot_path, "rb")};
+    if (snapshot.IsNull()) {
+        strPrint = strprintf("Cannot open %s", args[0]);
+        return EXIT_FAILURE;
+    }
+
+    node::SnapshotMetadata metadata{Params().MessageStart()};
+    uint64_t coins_written;
+    try {
+        snapshot >> metadata;
+        UTXODatabase database{database_path};
+        coins_written = ConvertUTXOSnapshot(snapshot, metadata, database, std::max(1u, std::thread::hardware_concurrency()));
+    } catch (const std::exception& e) {
+        fs::remove(database_path);
+        strPrint = strprintf("Cannot convert %s: %s", args[0], e.what());
+        return EXIT_FAILURE;
+    }
+    // Nothing should follow the coins.
+    if (std::byte extra; snapshot.detail_fread({&extra, 1}) != 0) {
+        fs::remove(database_path);
+        strPrint = strprintf("%s holds data after its coins", args[0]);
+        return EXIT_FAILURE;
+    }
+    strPrint = strprintf("%d coins of the snapshot at block %s written to %s", coins_written, metadata.m_base_blockhash.ToString(), args[1]);
+    return EXIT_SUCCESS;
+}
+#endif // ENABLE_WALLET
+
 MAIN_FUNCTION
 {
     ArgsManager& args = gArgs;
@@ -178,6 +395,10 @@ MAIN_FUNCTION
     try {
         if (cmd->command == "grind") {
             ret = Grind(cmd->args, strPrint);
+#ifdef ENABLE_WALLET
+        } else if (cmd->command == "utxotosqlite") {
+            ret = UTXOToSQLite(cmd->args, strPrint);
+#endif // ENABLE_WALLET
         } else {
             assert(false); // unknown command should be caught earlier
         }
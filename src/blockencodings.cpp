@@ -15,18 +15,21 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <unordered_map>
 
+//! Number of short ids computed at once, bounding the time spent on those not needed after an early exit.
+static constexpr size_t SHORTID_BATCH_SIZE{64};
+
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
         nonce(nonce),
         shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
     FillShortTxIDSelector();
     //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
     prefilledtxn[0] = {0, block.vtx[0]};
-    for (size_t i = 1; i < block.vtx.size(); i++) {
-        const CTransaction& tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(tx.GetWitnessHash());
-    }
+    GetShortIDs(std::span{block.vtx}.subspan(1), shorttxids);
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
@@ -45,6 +48,22 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const Wtxid& wtxid) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, wtxid) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(std::span<const CTransactionRef> txs, std::span<uint64_t> shortids) const {
+    assert(txs.size() == shortids.size());
+    std::array<const uint256*, SHORTID_BATCH_SIZE> wtxids;
+    for (size_t start = 0; start < txs.size(); start += wtxids.size()) {
+        const size_t count{std::min(wtxids.size(), txs.size() - start)};
+        for (size_t i = 0; i < count; i++) {
+            const CTransactionRef& tx{txs[start + i]};
+            wtxids[i] = tx ? &tx->GetWitnessHash().ToUint256() : &uint256::ZERO;
+        }
+        SipHashUint256Batch(shorttxidk0, shorttxidk1, std::span{wtxids}.first(count), shortids.subspan(start, count));
+    }
+    for (uint64_t& shortid : shortids) {
+        shortid &= 0xffffffffffffL;
+    }
+}
+
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<CTransactionRef>& extra_txn) {
     LogDebug(BCLog::CMPCTBLOCK, "Initializing PartiallyDownloadedBlock for block %s using a cmpctblock of %u bytes\n", cmpctblock.header.GetHash().ToString(), GetSerializeSize(cmpctblock));
     if (cmpctblock.header.IsNull() || (cmpctblock.shorttxids.empty() && cmpctblock.prefilledtxn.empty()))
@@ -103,40 +122,60 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     if (shorttxids.size() != cmpctblock.shorttxids.size())
         return READ_STATUS_FAILED; // Short ID collision
 
+    // Nearly all mempool transactions are usually not in the block. Rule most of them out
+    // without a map lookup, through a bitmap indexed by the low bits of the (uniformly
+    // distributed) short ids, with about 16 bits per short id.
+    const size_t filter_mask{std::bit_ceil(std::max<size_t>(shorttxids.size(), 1) * 16) - 1};
+    std::vector<bool> shortid_filter(filter_mask + 1);
+    for (const uint64_t shortid : cmpctblock.shorttxids) {
+        shortid_filter[shortid & filter_mask] = true;
+    }
+
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& tx : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(tx->GetWitnessHash());
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = tx;
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
+    // The short ids are computed in batches, which is much faster than one by one.
+    std::array<uint64_t, SHORTID_BATCH_SIZE> batch_shortids;
+    const std::span<const CTransactionRef> txns{pool->txns_randomized};
+    for (size_t start = 0; start < txns.size() && mempool_count != shorttxids.size(); start += batch_shortids.size()) {
+        const auto batch{txns.subspan(start, std::min(batch_shortids.size(), txns.size() - start))};
+        cmpctblock.GetShortIDs(batch, std::span{batch_shortids}.first(batch.size()));
+        for (size_t j = 0; j < batch.size(); j++) {
+            const CTransactionRef& tx = batch[j];
+            uint64_t shortid = batch_shortids[j];
+            if (!shortid_filter[shortid & filter_mask]) continue;
+            std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
+            if (idit != shorttxids.end()) {
+                if (!have_txn[idit->second]) {
+                    txn_available[idit->second] = tx;
+                    have_txn[idit->second]  = true;
+                    mempool_count++;
+                } else {
+                    // If we find two mempool txn that match the short id, just request it.
+                    // This should be rare enough that the extra bandwidth doesn't matter,
+                    // but eating a round-trip due to FillBlock failure would be annoying
+                    if (txn_available[idit->second]) {
+                        txn_available[idit->second].reset();
+                        mempool_count--;
+                    }
                 }
             }
+            // Though ideally we'd continue scanning for the two-txn-match-shortid case,
+            // the performance win of an early exit here is too good to pass up and worth
+            // the extra risk.
+            if (mempool_count == shorttxids.size())
+                break;
         }
-        // Though ideally we'd continue scanning for the two-txn-match-shortid case,
-        // the performance win of an early exit here is too good to pass up and worth
-        // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
     }
     }
 
+    std::vector<uint64_t> extra_shortids(extra_txn.size());
+    cmpctblock.GetShortIDs(extra_txn, extra_shortids);
     for (size_t i = 0; i < extra_txn.size(); i++) {
         if (extra_txn[i] == nullptr) {
             continue;
         }
-        uint64_t shortid = cmpctblock.GetShortID(extra_txn[i]->GetWitnessHash());
+        uint64_t shortid = extra_shortids[i];
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
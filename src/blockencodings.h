@@ -8,6 +8,7 @@
 #include <primitives/block.h>
 
 #include <functional>
+#include <span>
 
 class CTxMemPool;
 class BlockValidationState;
@@ -115,6 +116,9 @@ public:
     CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce);
 
     uint64_t GetShortID(const Wtxid& wtxid) const;
+    /** Compute the short ids of many transactions at once, into shortids (of the same size).
+     *  The short ids of null entries are unspecified. */
+    void GetShortIDs(std::span<const CTransactionRef> txs, std::span<uint64_t> shortids) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
 
@@ -2,6 +2,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <mutex>
 #include <set>
 
@@ -30,6 +33,29 @@ uint64_t GCSFilter::HashToRange(const Element& element) const
     return FastRange64(hash, m_F);
 }
 
+/** Number of bits of the values sorted by each pass of RadixSort(). */
+static constexpr int RADIX_BITS{11};
+/** Minimum number of values for RadixSort() to be faster than std::sort. */
+static constexpr size_t MIN_RADIX_SORT_SIZE{256};
+
+/**
+ * Sort values below `range` with a least significant digit radix sort, which
+ * takes as many passes over them as `range` has digits, e.g. 3 for the filter
+ * of a block with 2000 elements.
+ */
+static void RadixSort(std::vector<uint64_t>& values, uint64_t range)
+{
+    std::vector<uint64_t> sorted(values.size());
+    const int bits{static_cast<int>(std::bit_width(range))};
+    for (int shift{0}; shift < bits; shift += RADIX_BITS) {
+        std::array<size_t, (1 << RADIX_BITS) + 1> offsets{};
+        for (const uint64_t value : values) ++offsets[((value >> shift) & ((1 << RADIX_BITS) - 1)) + 1];
+        for (size_t i{1}; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+        for (const uint64_t value : values) sorted[offsets[(value >> shift) & ((1 << RADIX_BITS) - 1)]++] = value;
+        values.swap(sorted);
+    }
+}
+
 std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) const
 {
     std::vector<uint64_t> hashed_elements;
@@ -37,7 +63,11 @@ std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) cons
     for (const Element& element : elements) {
         hashed_elements.push_back(HashToRange(element));
     }
-    std::sort(hashed_elements.begin(), hashed_elements.end());
+    if (hashed_elements.size() >= MIN_RADIX_SORT_SIZE) {
+        RadixSort(hashed_elements, m_F);
+    } else {
+        std::sort(hashed_elements.begin(), hashed_elements.end());
+    }
     return hashed_elements;
 }
 
@@ -186,6 +216,11 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
                                                  const CBlockUndo& block_undo)
 {
     GCSFilter::ElementSet elements;
+    // Reserve for every script, so that the set is not rehashed as it grows.
+    size_t num_scripts{0};
+    for (const CTransactionRef& tx : block.vtx) num_scripts += tx->vout.size();
+    for (const CTxUndo& tx_undo : block_undo.vtxundo) num_scripts += tx_undo.vprevout.size();
+    elements.reserve(num_scripts);
 
     for (const CTransactionRef& tx : block.vtx) {
         for (const CTxOut& txout : tx->vout) {
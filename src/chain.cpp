@@ -68,6 +68,34 @@ const CBlockIndex *CChain::FindFork(const CBlockIndex *pindex) const {
     return pindex;
 }
 
+CChainView::CChainView(const CChain& chain, const CChainView& prev) : m_height{chain.Height()}
+{
+    m_chunks.reserve((m_height + CHUNK_SIZE) / CHUNK_SIZE);
+    for (int begin{0}; begin <= m_height; begin += CHUNK_SIZE) {
+        const int end{std::min(begin + CHUNK_SIZE, m_height + 1)};
+        // A chunk is unchanged if it spans the same heights and its last entry
+        // is the same, as all the entries below it are its ancestors.
+        const size_t index{m_chunks.size()};
+        if (index < prev.m_chunks.size() && prev.m_chunks[index]->size() == size_t(end - begin) &&
+            prev.m_chunks[index]->back() == chain[end - 1]) {
+            m_chunks.push_back(prev.m_chunks[index]);
+            continue;
+        }
+        auto chunk{std::make_shared<Chunk>()};
+        chunk->reserve(end - begin);
+        for (int height{begin}; height < end; ++height) chunk->push_back(chain[height]);
+        m_chunks.push_back(std::move(chunk));
+    }
+}
+
+const CBlockIndex* CChainView::FindFork(const CBlockIndex* pindex) const
+{
+    if (pindex == nullptr) return nullptr;
+    if (pindex->nHeight > Height()) pindex = pindex->GetAncestor(Height());
+    while (pindex && !Contains(pindex)) pindex = pindex->pprev;
+    return pindex;
+}
+
 CBlockIndex* CChain::FindEarliestAtLeast(int64_t nTime, int height) const
 {
     std::pair<int64_t, int> blockparams = std::make_pair(nTime, height);
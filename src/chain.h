@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -477,6 +478,47 @@ public:
     CBlockIndex* FindEarliestAtLeast(int64_t nTime, int height) const;
 };
 
+/**
+ * An immutable copy of a CChain, which can be read without holding cs_main:
+ * the block index entries it points to are never freed, and the fields used
+ * to look up heights, hashes and ancestors do not change once they are in
+ * the chain.
+ *
+ * Copies of a chain as its tip changes share most of their storage: the
+ * entries are held in chunks of CHUNK_SIZE heights, and a copy made from a
+ * previous one only allocates the chunks that changed, usually just the last.
+ */
+class CChainView
+{
+public:
+    static constexpr int CHUNK_SIZE{2048};
+
+    //! An empty chain.
+    CChainView() = default;
+    //! A copy of `chain`, with the chunks that did not change since `prev` shared with it.
+    CChainView(const CChain& chain, const CChainView& prev);
+
+    const CBlockIndex* Tip() const { return (*this)[m_height]; }
+    int Height() const { return m_height; }
+
+    /** Returns the index entry at a particular height in this chain, or nullptr if no such height exists. */
+    const CBlockIndex* operator[](int height) const
+    {
+        if (height < 0 || height > m_height) return nullptr;
+        return (*m_chunks[height / CHUNK_SIZE])[height % CHUNK_SIZE];
+    }
+
+    bool Contains(const CBlockIndex* pindex) const { return (*this)[pindex->nHeight] == pindex; }
+
+    /** Find the last common block between this chain and a block index entry. */
+    const CBlockIndex* FindFork(const CBlockIndex* pindex) const;
+
+private:
+    using Chunk = std::vector<const CBlockIndex*>;
+    std::vector<std::shared_ptr<const Chunk>> m_chunks;
+    int m_height{-1};
+};
+
 /** Get a locator for a block index entry. */
 CBlockLocator GetLocator(const CBlockIndex* index);
 
@@ -9,12 +9,19 @@
 #include <sync.h>
 #include <tinyformat.h>
 #include <util/threadnames.h>
+#include <util/trace.h>
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <vector>
 
+// Defined in validation.cpp, the main user of the queue.
+TRACEPOINT_SEMAPHORE_EXTERN(checkqueue, batch_taken);
+
 /**
  * Queue for verifications that have to be performed.
   * The verifications are represented by a type T, which must provide an
@@ -28,11 +35,25 @@
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
   *
+  * Every thread, including the master, owns a deque of pending
+  * verifications. The master distributes added batches over the deques
+  * round-robin, which only takes the lock of the receiving deque. Threads
+  * take work from the back of their own deque and, once it is empty, steal
+  * from the front of the other deques, so no thread goes idle while work is
+  * left anywhere. The queue-wide mutex is only taken to sleep, wake up, and
+  * report results.
+  *
   */
 template <typename T, typename R = std::remove_cvref_t<decltype(std::declval<T>()().value())>>
 class CCheckQueue
 {
 private:
+    //! Pending verifications owned by one thread.
+    struct WorkQueue {
+        Mutex m_mutex;
+        std::deque<T> m_checks GUARDED_BY(m_mutex);
+    };
+
     //! Mutex to protect the inner state
     Mutex m_mutex;
 
@@ -42,25 +63,31 @@ private:
     //! Master thread blocks on this when out of work
     std::condition_variable m_master_cv;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue GUARDED_BY(m_mutex);
+    //! One deque per worker thread, followed by the master's.
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
 
-    //! The number of workers (including the master) that are idle.
-    int nIdle GUARDED_BY(m_mutex){0};
+    //! Deque receiving the next added batch. Only used by the master.
+    size_t m_next_queue{0};
 
-    //! The total number of workers (including the master).
-    int nTotal GUARDED_BY(m_mutex){0};
+    //! Number of verifications in the deques. It is raised before pushing and
+    //! lowered after taking, so it never underestimates queued work.
+    std::atomic<size_t> m_queued{0};
+
+    //! The number of worker threads waiting for work.
+    std::atomic<int> m_idle{0};
 
     //! The temporary evaluation result.
     std::optional<R> m_result GUARDED_BY(m_mutex);
 
+    //! Whether m_result is set, readable without the mutex to skip remaining work.
+    std::atomic<bool> m_failed{false};
+
     /**
      * Number of verifications that haven't completed yet.
-     * This includes elements that are no longer queued, but still in the
-     * worker's own batches.
+     * This includes elements that are no longer queued, but still in a
+     * thread's own batch or being destructed.
      */
-    unsigned int nTodo GUARDED_BY(m_mutex){0};
+    std::atomic<size_t> nTodo{0};
 
     //! The maximum number of elements to be processed in one batch
     const unsigned int nBatchSize;
@@ -68,72 +95,93 @@ private:
     std::vector<std::thread> m_worker_threads;
     bool m_request_stop GUARDED_BY(m_mutex){false};
 
+    /**
+     * Move a batch of verifications into `checks`: from the back of the
+     * thread's own deque if possible, stolen from the front of another
+     * deque otherwise. Batches shrink with the deque, so all threads finish
+     * at about the same time. Returns false if no work was found.
+     */
+    bool TakeWork(size_t own, std::vector<T>& checks)
+    {
+        for (size_t i = 0; i < m_queues.size() && m_queued.load() > 0; ++i) {
+            WorkQueue& queue{*m_queues[(own + i) % m_queues.size()]};
+            LOCK(queue.m_mutex);
+            if (queue.m_checks.empty()) continue;
+            const size_t count{std::max<size_t>(1, std::min<size_t>(nBatchSize, (queue.m_checks.size() + 1) / 2))};
+            if (i == 0) {
+                const auto start_it{queue.m_checks.end() - count};
+                checks.assign(std::make_move_iterator(start_it), std::make_move_iterator(queue.m_checks.end()));
+                queue.m_checks.erase(start_it, queue.m_checks.end());
+            } else {
+                const auto end_it{queue.m_checks.begin() + count};
+                checks.assign(std::make_move_iterator(queue.m_checks.begin()), std::make_move_iterator(end_it));
+                queue.m_checks.erase(queue.m_checks.begin(), end_it);
+            }
+            m_queued -= count;
+            TRACEPOINT(checkqueue, batch_taken,
+                (uint32_t)own,
+                (uint32_t)count,
+                i != 0,
+                (uint64_t)m_queued.load());
+            return true;
+        }
+        return false;
+    }
+
     /** Internal function that does bulk of the verification work. If fMaster, return the final result. */
-    std::optional<R> Loop(bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    std::optional<R> Loop(size_t own, bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        std::condition_variable& cond = fMaster ? m_master_cv : m_worker_cv;
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        std::optional<R> local_result;
-        bool do_work;
-        do {
-            {
+        while (true) {
+            if (!TakeWork(own, vChecks)) {
                 WAIT_LOCK(m_mutex, lock);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    if (local_result.has_value() && !m_result.has_value()) {
-                        std::swap(local_result, m_result);
-                    }
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster) {
-                        // We processed the last element; inform the master it can exit and return the result
-                        m_master_cv.notify_one();
-                    }
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty() && !m_request_stop) {
-                    if (fMaster && nTodo == 0) {
-                        nTotal--;
-                        std::optional<R> to_return = std::move(m_result);
-                        // reset the status for new work later
-                        m_result = std::nullopt;
-                        // return the current status
-                        return to_return;
-                    }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
+                if (fMaster) {
+                    // Nothing is queued and the master is the only thread
+                    // adding work, so wait for the other threads' batches.
+                    m_master_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return nTodo.load() == 0; });
+                    std::optional<R> to_return = std::move(m_result);
+                    // reset the status for new work later
+                    m_result = std::nullopt;
+                    m_failed = false;
+                    // return the current status
+                    return to_return;
                 }
+                // Announce being idle before checking for work, so that a
+                // concurrent Add() either sees us idle or we see its work.
+                ++m_idle;
+                m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_request_stop || m_queued.load() > 0; });
+                --m_idle;
                 if (m_request_stop) {
                     // return value does not matter, because m_request_stop is only set in the destructor.
                     return std::nullopt;
                 }
-
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                auto start_it = queue.end() - nNow;
-                vChecks.assign(std::make_move_iterator(start_it), std::make_move_iterator(queue.end()));
-                queue.erase(start_it, queue.end());
-                // Check whether we need to do work at all
-                do_work = !m_result.has_value();
+                continue;
             }
-            // execute work
-            if (do_work) {
+            // execute work, unless a result is already known
+            std::optional<R> local_result;
+            if (!m_failed.load(std::memory_order_relaxed)) {
                 for (T& check : vChecks) {
                     local_result = check();
                     if (local_result.has_value()) break;
                 }
             }
+            if (local_result.has_value()) {
+                LOCK(m_mutex);
+                if (!m_result.has_value()) {
+                    m_result = std::move(local_result);
+                    m_failed = true;
+                }
+            }
+            // Destruct the checks before marking them as done.
+            const size_t nNow{vChecks.size()};
             vChecks.clear();
-        } while (true);
+            if (nTodo.fetch_sub(nNow) == nNow) {
+                // We processed the last element; inform the master it can exit and return the result
+                LOCK(m_mutex);
+                m_master_cv.notify_one();
+            }
+        }
     }
 
 public:
@@ -145,11 +193,15 @@ public:
         : nBatchSize(batch_size)
     {
         LogInfo("Script verification uses %d additional threads", worker_threads_num);
+        m_queues.reserve(worker_threads_num + 1);
+        for (int n = 0; n <= worker_threads_num; ++n) {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
         m_worker_threads.reserve(worker_threads_num);
         for (int n = 0; n < worker_threads_num; ++n) {
             m_worker_threads.emplace_back([this, n]() {
                 util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+                Loop(n, false /* worker thread */);
             });
         }
     }
@@ -165,7 +217,7 @@ public:
     //! its error.
     std::optional<R> Complete() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        return Loop(true /* master thread */);
+        return Loop(m_worker_threads.size(), true /* master thread */);
     }
 
     //! Add a batch of checks to the queue
@@ -175,12 +227,18 @@ public:
             return;
         }
 
+        nTodo += vChecks.size();
+        m_queued += vChecks.size();
         {
-            LOCK(m_mutex);
-            queue.insert(queue.end(), std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end()));
-            nTodo += vChecks.size();
+            WorkQueue& queue{*m_queues[m_next_queue]};
+            m_next_queue = (m_next_queue + 1) % m_queues.size();
+            LOCK(queue.m_mutex);
+            queue.m_checks.insert(queue.m_checks.end(), std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end()));
         }
 
+        if (m_idle.load() == 0) return;
+        // Taking the mutex orders this notification after an idle worker's check for work.
+        LOCK(m_mutex);
         if (vChecks.size() == 1) {
             m_worker_cv.notify_one();
         } else {
@@ -9,15 +9,30 @@
 #include <random.h>
 #include <util/trace.h>
 
+#include <algorithm>
+
 TRACEPOINT_SEMAPHORE(utxocache, add);
 TRACEPOINT_SEMAPHORE(utxocache, spent);
 TRACEPOINT_SEMAPHORE(utxocache, uncache);
 
 std::optional<Coin> CCoinsView::GetCoin(const COutPoint& outpoint) const { return std::nullopt; }
+std::vector<std::optional<Coin>> CCoinsView::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    std::vector<std::optional<Coin>> coins;
+    coins.reserve(outpoints.size());
+    for (const COutPoint& outpoint : outpoints) coins.push_back(GetCoin(outpoint));
+    return coins;
+}
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
 bool CCoinsView::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) { return false; }
 std::unique_ptr<CCoinsViewCursor> CCoinsView::Cursor() const { return nullptr; }
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsView::Cursors(size_t count) const
+{
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    if (auto cursor{Cursor()}) cursors.push_back(std::move(cursor));
+    return cursors;
+}
 
 bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
 {
@@ -26,16 +41,19 @@ bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
 
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 std::optional<Coin> CCoinsViewBacked::GetCoin(const COutPoint& outpoint) const { return base->GetCoin(outpoint); }
+std::vector<std::optional<Coin>> CCoinsViewBacked::GetCoins(std::span<const COutPoint> outpoints) const { return base->GetCoins(outpoints); }
 bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->HaveCoin(outpoint); }
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
 void CCoinsViewBacked::SetBackend(CCoinsView &viewIn) { base = &viewIn; }
 bool CCoinsViewBacked::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) { return base->BatchWrite(cursor, hashBlock); }
 std::unique_ptr<CCoinsViewCursor> CCoinsViewBacked::Cursor() const { return base->Cursor(); }
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewBacked::Cursors(size_t count) const { return base->Cursors(count); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic) :
-    CCoinsViewBacked(baseIn), m_deterministic(deterministic),
+CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic, bool huge_pages) :
+    CCoinsViewBacked(baseIn), m_deterministic(deterministic), m_huge_pages(huge_pages),
+    m_cache_coins_memory_resource{huge_pages ? HUGE_PAGES_COINS_CHUNK_BYTES : CCoinsMapMemoryResource::DEFAULT_CHUNK_SIZE_BYTES, huge_pages},
     cacheCoins(0, SaltedOutpointHasher(/*deterministic=*/deterministic), CCoinsMap::key_equal{}, &m_cache_coins_memory_resource)
 {
     m_sentinel.second.SelfRef(m_sentinel);
@@ -47,7 +65,10 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     const auto [ret, inserted] = cacheCoins.try_emplace(outpoint);
-    if (inserted) {
+    if (!inserted) {
+        ++m_fetch_hits;
+    } else {
+        ++m_fetch_misses;
         if (auto coin{base->GetCoin(outpoint)}) {
             ret->second.coin = std::move(*coin);
             cachedCoinsUsage += ret->second.coin.DynamicMemoryUsage();
@@ -69,6 +90,27 @@ std::optional<Coin> CCoinsViewCache::GetCoin(const COutPoint& outpoint) const
     return std::nullopt;
 }
 
+std::vector<std::optional<Coin>> CCoinsViewCache::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    std::vector<std::optional<Coin>> coins(outpoints.size());
+    std::vector<size_t> missing;
+    for (size_t i{0}; i < outpoints.size(); ++i) {
+        if (auto it{cacheCoins.find(outpoints[i])}; it != cacheCoins.end()) {
+            if (!it->second.coin.IsSpent()) coins[i] = it->second.coin;
+        } else {
+            missing.push_back(i);
+        }
+    }
+    if (missing.empty()) return coins;
+    std::sort(missing.begin(), missing.end(), [&](size_t a, size_t b) { return outpoints[a] < outpoints[b]; });
+    std::vector<COutPoint> lookups;
+    lookups.reserve(missing.size());
+    for (size_t i : missing) lookups.push_back(outpoints[i]);
+    auto found{base->GetCoins(lookups)};
+    for (size_t j{0}; j < missing.size(); ++j) coins[missing[j]] = std::move(found[j]);
+    return coins;
+}
+
 void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possible_overwrite) {
     assert(!coin.IsSpent());
     if (coin.out.scriptPubKey.IsUnspendable()) return;
@@ -116,6 +158,16 @@ void CCoinsViewCache::EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coi
     if (inserted) CCoinsCacheEntry::SetDirty(*it, m_sentinel);
 }
 
+bool CCoinsViewCache::AddFetchedCoin(const COutPoint& outpoint, Coin&& coin)
+{
+    Assume(!coin.IsSpent());
+    const auto [it, inserted] = cacheCoins.try_emplace(outpoint, std::move(coin));
+    if (!inserted) return false;
+    cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+    ++m_prefetched;
+    return true;
+}
+
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
     bool fCoinbase = tx.IsCoinBase();
     const Txid& txid = tx.GetHash();
@@ -170,6 +222,12 @@ bool CCoinsViewCache::HaveCoinInCache(const COutPoint &outpoint) const {
     return (it != cacheCoins.end() && !it->second.coin.IsSpent());
 }
 
+const Coin* CCoinsViewCache::PeekCoin(const COutPoint& outpoint) const
+{
+    const auto it{cacheCoins.find(outpoint)};
+    return it == cacheCoins.end() ? nullptr : &it->second.coin;
+}
+
 uint256 CCoinsViewCache::GetBestBlock() const {
     if (hashBlock.IsNull())
         hashBlock = base->GetBestBlock();
@@ -247,17 +305,26 @@ bool CCoinsViewCache::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &ha
     return true;
 }
 
-bool CCoinsViewCache::Flush() {
+bool CCoinsViewCache::Flush(bool reallocate_cache) {
     auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, m_sentinel, cacheCoins, /*will_erase=*/true)};
     bool fOk = base->BatchWrite(cursor, hashBlock);
     if (fOk) {
         cacheCoins.clear();
-        ReallocateCache();
+        if (reallocate_cache) ReallocateCache();
     }
     cachedCoinsUsage = 0;
     return fOk;
 }
 
+void CCoinsViewCache::Reset() noexcept
+{
+    // Clearing an empty map still zeroes its buckets, which is skipped after a Flush().
+    if (!cacheCoins.empty()) cacheCoins.clear();
+    cachedCoinsUsage = 0;
+    hashBlock.SetNull();
+    m_sentinel.second.SelfRef(m_sentinel);
+}
+
 bool CCoinsViewCache::Sync()
 {
     auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, m_sentinel, cacheCoins, /*will_erase=*/false)};
@@ -271,6 +338,15 @@ bool CCoinsViewCache::Sync()
     return fOk;
 }
 
+bool CCoinsViewCache::SyncChunk(size_t max_entries, size_t& written)
+{
+    Assume(max_entries > 0);
+    auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, m_sentinel, cacheCoins, /*will_erase=*/false, max_entries)};
+    bool fOk = base->BatchWrite(cursor, hashBlock);
+    written = cursor.Visited();
+    return fOk;
+}
+
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
@@ -290,6 +366,16 @@ unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
 
+std::vector<COutPoint> CCoinsViewCache::GetCachedOutpoints() const
+{
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(cacheCoins.size());
+    for (const auto& [outpoint, entry] : cacheCoins) {
+        if (!entry.coin.IsSpent()) outpoints.push_back(outpoint);
+    }
+    return outpoints;
+}
+
 bool CCoinsViewCache::HaveInputs(const CTransaction& tx) const
 {
     if (!tx.IsCoinBase()) {
@@ -308,7 +394,7 @@ void CCoinsViewCache::ReallocateCache()
     assert(cacheCoins.size() == 0);
     cacheCoins.~CCoinsMap();
     m_cache_coins_memory_resource.~CCoinsMapMemoryResource();
-    ::new (&m_cache_coins_memory_resource) CCoinsMapMemoryResource{};
+    ::new (&m_cache_coins_memory_resource) CCoinsMapMemoryResource{m_huge_pages ? HUGE_PAGES_COINS_CHUNK_BYTES : CCoinsMapMemoryResource::DEFAULT_CHUNK_SIZE_BYTES, m_huge_pages};
     ::new (&cacheCoins) CCoinsMap{0, SaltedOutpointHasher{/*deterministic=*/m_deterministic}, CCoinsMap::key_equal{}, &m_cache_coins_memory_resource};
 }
 
@@ -382,6 +468,11 @@ std::optional<Coin> CCoinsViewErrorCatcher::GetCoin(const COutPoint& outpoint) c
     return ExecuteBackedWrapper<std::optional<Coin>>([&]() { return CCoinsViewBacked::GetCoin(outpoint); }, m_err_callbacks);
 }
 
+std::vector<std::optional<Coin>> CCoinsViewErrorCatcher::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    return ExecuteBackedWrapper<std::vector<std::optional<Coin>>>([&]() { return CCoinsViewBacked::GetCoins(outpoints); }, m_err_callbacks);
+}
+
 bool CCoinsViewErrorCatcher::HaveCoin(const COutPoint& outpoint) const
 {
     return ExecuteBackedWrapper<bool>([&]() { return CCoinsViewBacked::HaveCoin(outpoint); }, m_err_callbacks);
@@ -12,6 +12,7 @@
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <support/allocators/pool.h>
+#include <support/hugepages.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/hasher.h>
@@ -20,7 +21,10 @@
 #include <cstdint>
 
 #include <functional>
+#include <limits>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 /**
  * A UTXO entry.
@@ -230,6 +234,9 @@ using CCoinsMap = std::unordered_map<COutPoint,
 
 using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
 
+/** Size of the chunks of a coins cache memory resource backed by huge pages. */
+static constexpr size_t HUGE_PAGES_COINS_CHUNK_BYTES{4 * HUGE_PAGE_SIZE};
+
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
 {
@@ -271,13 +278,20 @@ struct CoinsViewCacheCursor
     //! This is an optimization compared to erasing all entries as the cursor iterates them when will_erase is set.
     //! Calling CCoinsMap::clear() afterwards is faster because a CoinsCachePair cannot be coerced back into a
     //! CCoinsMap::iterator to be erased, and must therefore be looked up again by key in the CCoinsMap before being erased.
+    //! If max_entries is set, iteration ends after that many flagged entries even
+    //! if more remain in the linked list (see IsPartial()). This is only valid
+    //! when will_erase is not set, as the remaining entries must stay flagged.
     CoinsViewCacheCursor(size_t& usage LIFETIMEBOUND,
                         CoinsCachePair& sentinel LIFETIMEBOUND,
                         CCoinsMap& map LIFETIMEBOUND,
-                        bool will_erase) noexcept
-        : m_usage(usage), m_sentinel(sentinel), m_map(map), m_will_erase(will_erase) {}
+                        bool will_erase,
+                        size_t max_entries = std::numeric_limits<size_t>::max()) noexcept
+        : m_usage(usage), m_sentinel(sentinel), m_map(map), m_will_erase(will_erase), m_remaining(max_entries)
+    {
+        Assume(!m_will_erase || m_remaining == std::numeric_limits<size_t>::max());
+    }
 
-    inline CoinsCachePair* Begin() const noexcept { return m_sentinel.second.Next(); }
+    inline CoinsCachePair* Begin() const noexcept { return m_remaining > 0 ? m_sentinel.second.Next() : End(); }
     inline CoinsCachePair* End() const noexcept { return &m_sentinel; }
 
     //! Return the next entry after current, possibly erasing current
@@ -294,15 +308,29 @@ struct CoinsViewCacheCursor
                 current.second.SetClean();
             }
         }
+        ++m_visited;
+        if (--m_remaining == 0 && next_entry != End()) {
+            m_partial = true;
+            return End();
+        }
         return next_entry;
     }
 
     inline bool WillErase(CoinsCachePair& current) const noexcept { return m_will_erase || current.second.coin.IsSpent(); }
+
+    //! Whether iteration stopped at max_entries while flagged entries remain.
+    //! The receiver must then not consider itself consistent with the given best block.
+    inline bool IsPartial() const noexcept { return m_partial || (m_remaining == 0 && m_sentinel.second.Next() != End()); }
+    //! Number of flagged entries iterated so far.
+    inline size_t Visited() const noexcept { return m_visited; }
 private:
     size_t& m_usage;
     CoinsCachePair& m_sentinel;
     CCoinsMap& m_map;
     bool m_will_erase;
+    size_t m_remaining;
+    size_t m_visited{0};
+    bool m_partial{false};
 };
 
 /** Abstract view on the open txout dataset. */
@@ -312,6 +340,10 @@ public:
     //! Retrieve the Coin (unspent transaction output) for a given outpoint.
     virtual std::optional<Coin> GetCoin(const COutPoint& outpoint) const;
 
+    //! Retrieve the Coins for many outpoints at once, in the order given. Views may
+    //! resolve them in another order, e.g. that of their database keys.
+    virtual std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const;
+
     //! Just check whether a given outpoint is unspent.
     virtual bool HaveCoin(const COutPoint &outpoint) const;
 
@@ -331,6 +363,12 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get up to `count` cursors over consecutive, disjoint ranges of the
+    //! state that see the same state and together visit every coin once, so
+    //! the ranges can be scanned concurrently. The outputs of a transaction
+    //! are never split across cursors. Empty if there is no Cursor().
+    virtual std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t count) const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() = default;
 
@@ -348,12 +386,14 @@ protected:
 public:
     CCoinsViewBacked(CCoinsView *viewIn);
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t count) const override;
     size_t EstimateSize() const override;
 };
 
@@ -363,6 +403,7 @@ class CCoinsViewCache : public CCoinsViewBacked
 {
 private:
     const bool m_deterministic;
+    const bool m_huge_pages;
 
 protected:
     /**
@@ -370,7 +411,7 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
-    mutable CCoinsMapMemoryResource m_cache_coins_memory_resource{};
+    mutable CCoinsMapMemoryResource m_cache_coins_memory_resource;
     /* The starting sentinel of the flagged entry circular doubly linked list. */
     mutable CoinsCachePair m_sentinel;
     mutable CCoinsMap cacheCoins;
@@ -378,8 +419,17 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage{0};
 
+    /* Lookup counters, see GetFetchStats(). */
+    mutable uint64_t m_fetch_hits{0};
+    mutable uint64_t m_fetch_misses{0};
+    uint64_t m_prefetched{0};
+
 public:
-    CCoinsViewCache(CCoinsView *baseIn, bool deterministic = false);
+    /**
+     * With huge_pages, the memory of the cached coins is advised to be backed
+     * by huge pages, which is worth it for a large long-lived cache only.
+     */
+    CCoinsViewCache(CCoinsView *baseIn, bool deterministic = false, bool huge_pages = false);
 
     /**
      * By deleting the copy constructor, we prevent accidentally using it when one intends to create a cache on top of a base cache.
@@ -388,6 +438,12 @@ public:
 
     // Standard CCoinsView methods
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    /**
+     * Coins that are cached are served from the cache, the others are looked up
+     * in the base view in one batch, sorted by outpoint. Unlike GetCoin, the latter
+     * are not added to the cache, so that bulk lookups do not evict useful entries.
+     */
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
@@ -395,6 +451,9 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t count) const override {
+        throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
+    }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
@@ -403,6 +462,14 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Return the entry of outpoint in this cache, which is spent if its coin
+     * was spent since it was cached, or nullptr if it is not cached, in which
+     * case the coin is as in the backing CCoinsView. Like HaveCoinInCache(), no
+     * calls to the backing CCoinsView are made.
+     */
+    const Coin* PeekCoin(const COutPoint& outpoint) const;
+
     /**
      * Return a reference to Coin in the cache, or coinEmpty if not found. This is
      * more efficient than GetCoin.
@@ -430,6 +497,18 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Insert a coin that was retrieved from the backing view ahead of time,
+     * as if FetchCoin had looked it up (i.e. it is neither DIRTY nor FRESH).
+     * Outpoints that are already present in the cache are left untouched.
+     *
+     * The caller must guarantee that the coin is the backing view's current
+     * version of the outpoint.
+     *
+     * @returns whether the coin was inserted.
+     */
+    bool AddFetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -441,9 +520,12 @@ public:
      * Push the modifications applied to this cache to its base and wipe local state.
      * Failure to call this method or Sync() before destruction will cause the changes
      * to be forgotten.
+     * Unless reallocate_cache is set, the memory of the emptied cache is kept, so
+     * that a cache used for one batch of changes after another does not allocate it
+     * again for each of them.
      * If false is returned, the state of this cache (and its backing view) will be undefined.
      */
-    bool Flush();
+    bool Flush(bool reallocate_cache = true);
 
     /**
      * Push the modifications applied to this cache to its base while retaining
@@ -454,6 +536,25 @@ public:
      */
     bool Sync();
 
+    /**
+     * Like Sync(), but push at most max_entries modified entries to the base,
+     * oldest modification first. The base is only told that it is consistent
+     * with this cache's best block once no modified entries remain, so a large
+     * dirty set can be written out in bounded steps.
+     * The number of entries pushed is returned in `written`.
+     * If false is returned, the state of this cache (and its backing view) will be undefined.
+     */
+    bool SyncChunk(size_t max_entries, size_t& written);
+
+    //! Whether there are entries which still have to be pushed to the base.
+    bool HasFlaggedEntries() const { return m_sentinel.second.Next() != &m_sentinel; }
+
+    /**
+     * Discard all entries and modifications of this cache, and forget its best
+     * block, as if it was just created on top of its base, but keep its memory.
+     */
+    void Reset() noexcept;
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -463,9 +564,24 @@ public:
     //! Calculate the size of the cache (in number of transaction outputs)
     unsigned int GetCacheSize() const;
 
+    //! The outpoints of the unspent coins in the cache, in no particular order.
+    std::vector<COutPoint> GetCachedOutpoints() const;
+
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    struct FetchStats {
+        //! Lookups served from this cache.
+        uint64_t hits{0};
+        //! Lookups that had to be forwarded to the backing view.
+        uint64_t misses{0};
+        //! Coins inserted through AddFetchedCoin.
+        uint64_t prefetched{0};
+    };
+
+    //! Counters of cache lookups since this cache was created.
+    FetchStats GetFetchStats() const { return {m_fetch_hits, m_fetch_misses, m_prefetched}; }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
@@ -518,6 +634,7 @@ public:
     }
 
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
 
 private:
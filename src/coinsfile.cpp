@@ -0,0 +1,308 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coinsfile.h>
+
+#include <logging.h>
+#include <serialize.h>
+#include <util/fs_helpers.h>
+#include <util/vector.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+//! A coin, preceded by its outpoint.
+constexpr uint8_t RECORD_COIN{'c'};
+//! Erasure of a spent coin, followed by its outpoint.
+constexpr uint8_t RECORD_ERASE{'e'};
+//! End of a BatchWrite, followed by the head blocks.
+constexpr uint8_t RECORD_STATE{'s'};
+
+//! Records of a BatchWrite are handed to the file in chunks of this size.
+constexpr size_t WRITE_CHUNK_BYTES{16 << 20};
+} // namespace
+
+/** Cursor over a sorted copy of the outpoints; values are read when asked for. */
+class CoinsFileCursor final : public CCoinsViewCursor
+{
+public:
+    CoinsFileCursor(const CCoinsViewFile& view, std::vector<COutPoint> outpoints, const uint256& best_block)
+        : CCoinsViewCursor{best_block}, m_view{view}, m_outpoints{std::move(outpoints)} {}
+
+    bool GetKey(COutPoint& key) const override
+    {
+        if (!Valid()) return false;
+        key = m_outpoints[m_pos];
+        return true;
+    }
+    bool GetValue(Coin& coin) const override
+    {
+        if (!Valid()) return false;
+        auto value{m_view.GetCoin(m_outpoints[m_pos])};
+        if (!value) return false;
+        coin = std::move(*value);
+        return true;
+    }
+    bool Valid() const override { return m_pos < m_outpoints.size(); }
+    void Next() override { ++m_pos; }
+
+private:
+    const CCoinsViewFile& m_view;
+    const std::vector<COutPoint> m_outpoints;
+    size_t m_pos{0};
+};
+
+CCoinsViewFile::CCoinsViewFile(CoinsFileOptions options)
+    : m_options{std::move(options)}
+{
+    TryCreateDirectories(m_options.path);
+    LOCK(m_mutex);
+    Load();
+}
+
+CCoinsViewFile::~CCoinsViewFile()
+{
+    LOCK(m_mutex);
+    if (m_file && m_file->fclose() != 0) {
+        LogError("Failed to close coins file %s", fs::PathToString(FilePath()));
+    }
+}
+
+void CCoinsViewFile::Load()
+{
+    m_index.clear();
+    m_heads.clear();
+    m_live_bytes = 0;
+    m_size = 0;
+
+    // Changes only take effect at the state record ending their BatchWrite,
+    // so an interrupted write is dropped as a whole.
+    std::vector<std::pair<COutPoint, std::optional<Location>>> pending;
+    if (AutoFile file{fsbridge::fopen(FilePath(), "rb")}; !file.IsNull()) {
+        try {
+            while (true) {
+                const uint64_t record_start = file.tell();
+                uint8_t type;
+                file >> type;
+                COutPoint outpoint;
+                if (type == RECORD_COIN) {
+                    file >> outpoint;
+                    const uint64_t coin_offset = file.tell();
+                    Coin coin;
+                    file >> coin;
+                    pending.emplace_back(outpoint, Location{coin_offset, uint32_t(file.tell() - record_start)});
+                } else if (type == RECORD_ERASE) {
+                    file >> outpoint;
+                    pending.emplace_back(outpoint, std::nullopt);
+                } else if (type == RECORD_STATE) {
+                    file >> m_heads;
+                    ApplyChanges(pending);
+                    pending.clear();
+                    m_size = file.tell();
+                } else {
+                    LogWarning("Unknown record type %u at offset %u of coins file %s", type, record_start, fs::PathToString(FilePath()));
+                    break;
+                }
+            }
+        } catch (const std::ios_base::failure&) {
+            // End of the file, possibly in the middle of an interrupted write.
+        }
+    }
+
+    std::error_code ec;
+    const auto file_size{fs::file_size(FilePath(), ec)};
+    if (!ec && file_size > m_size) {
+        LogWarning("Truncating coins file %s from %u to %u bytes, dropping an interrupted write", fs::PathToString(FilePath()), file_size, m_size);
+        fs::resize_file(FilePath(), m_size);
+    }
+    m_file = std::make_unique<AutoFile>(fsbridge::fopen(FilePath(), ec ? "w+b" : "r+b"));
+    if (m_file->IsNull()) {
+        throw std::runtime_error(strprintf("Unable to open coins file %s", fs::PathToString(FilePath())));
+    }
+    LogDebug(BCLog::COINDB, "Loaded %u coins from %u byte coins file\n", m_index.size(), m_size);
+}
+
+void CCoinsViewFile::ApplyChanges(std::span<const std::pair<COutPoint, std::optional<Location>>> changes)
+{
+    for (const auto& [outpoint, location] : changes) {
+        const auto it{m_index.find(outpoint)};
+        if (it != m_index.end()) {
+            m_live_bytes -= it->second.record_size;
+            if (location) {
+                it->second = *location;
+            } else {
+                m_index.erase(it);
+            }
+        } else if (location) {
+            m_index.emplace(outpoint, *location);
+        }
+        if (location) m_live_bytes += location->record_size;
+    }
+}
+
+Coin CCoinsViewFile::ReadCoin(const Location& location) const
+{
+    Coin coin;
+    m_file->seek(location.coin_offset, SEEK_SET);
+    *m_file >> coin;
+    return coin;
+}
+
+void CCoinsViewFile::Append(std::span<const std::byte> records)
+{
+    m_file->seek(m_size, SEEK_SET);
+    m_file->write(records);
+    m_size += records.size();
+}
+
+std::optional<Coin> CCoinsViewFile::GetCoin(const COutPoint& outpoint) const
+{
+    LOCK(m_mutex);
+    const auto it{m_index.find(outpoint)};
+    if (it == m_index.end()) return std::nullopt;
+    return ReadCoin(it->second);
+}
+
+bool CCoinsViewFile::HaveCoin(const COutPoint& outpoint) const
+{
+    return WITH_LOCK(m_mutex, return m_index.contains(outpoint));
+}
+
+uint256 CCoinsViewFile::GetBestBlock() const
+{
+    LOCK(m_mutex);
+    return m_heads.size() == 1 ? m_heads[0] : uint256{};
+}
+
+std::vector<uint256> CCoinsViewFile::GetHeadBlocks() const
+{
+    LOCK(m_mutex);
+    return m_heads.size() == 2 ? m_heads : std::vector<uint256>{};
+}
+
+bool CCoinsViewFile::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock)
+{
+    assert(!hashBlock.IsNull());
+    LOCK(m_mutex);
+    // As in CCoinsViewDB, a partial write leaves the store between the old
+    // tip and hashBlock until the rest is written.
+    const uint256 old_tip{m_heads.empty() ? uint256{} : m_heads.back()};
+
+    DataStream records;
+    std::vector<std::pair<COutPoint, std::optional<Location>>> changes;
+    size_t changed{0};
+    for (auto it{cursor.Begin()}; it != cursor.End();) {
+        if (it->second.IsDirty()) {
+            const uint64_t record_start{m_size + records.size()};
+            if (it->second.coin.IsSpent()) {
+                if (m_index.contains(it->first)) {
+                    records << RECORD_ERASE << it->first;
+                    changes.emplace_back(it->first, std::nullopt);
+                }
+            } else {
+                records << RECORD_COIN << it->first;
+                const uint64_t coin_offset{m_size + records.size()};
+                records << it->second.coin;
+                changes.emplace_back(it->first, Location{coin_offset, uint32_t(m_size + records.size() - record_start)});
+            }
+            ++changed;
+        }
+        it = cursor.NextAndMaybeErase(*it);
+        if (records.size() > WRITE_CHUNK_BYTES) {
+            // Records without a state record after them are dropped on
+            // startup, so the index can already point at them.
+            Append(records);
+            records.clear();
+            ApplyChanges(changes);
+            changes.clear();
+        }
+    }
+
+    m_heads = cursor.IsPartial() ? Vector(hashBlock, old_tip) : Vector(hashBlock);
+    records << RECORD_STATE << m_heads;
+    Append(records);
+    ApplyChanges(changes);
+    if (!m_file->Commit()) {
+        LogError("Failed to sync coins file %s", fs::PathToString(FilePath()));
+        return false;
+    }
+    LogDebug(BCLog::COINDB, "Committed %u changed transaction outputs to coins file...\n", changed);
+
+    if (m_size >= m_options.compact_min_bytes && m_size > 2 * m_live_bytes) Compact();
+    return true;
+}
+
+void CCoinsViewFile::Compact()
+{
+    const fs::path new_path{m_options.path / "coins.dat.new"};
+    AutoFile out{fsbridge::fopen(new_path, "wb")};
+    if (out.IsNull()) {
+        throw std::runtime_error(strprintf("Unable to create coins file %s", fs::PathToString(new_path)));
+    }
+
+    // The index is pointed at the new file as the coins are copied. Errors
+    // are fatal, so it does not matter that it is of no use for either file
+    // if this throws.
+    DataStream records;
+    uint64_t size{0};
+    for (auto& [outpoint, location] : m_index) {
+        const uint64_t record_start{size + records.size()};
+        records << RECORD_COIN << outpoint;
+        const uint64_t coin_offset{size + records.size()};
+        records << ReadCoin(location);
+        location = Location{coin_offset, uint32_t(size + records.size() - record_start)};
+        if (records.size() > WRITE_CHUNK_BYTES) {
+            out.write(records);
+            size += records.size();
+            records.clear();
+        }
+    }
+    const uint64_t live_bytes{size + records.size()};
+    records << RECORD_STATE << m_heads;
+    out.write(records);
+    size += records.size();
+    if (!out.Commit() || out.fclose() != 0) {
+        throw std::runtime_error(strprintf("Failed to write coins file %s", fs::PathToString(new_path)));
+    }
+
+    LogDebug(BCLog::COINDB, "Compacted coins file from %u to %u bytes\n", m_size, size);
+    if (m_file->fclose() != 0 || !RenameOver(new_path, FilePath())) {
+        throw std::runtime_error(strprintf("Failed to replace coins file %s", fs::PathToString(FilePath())));
+    }
+    DirectoryCommit(m_options.path);
+    m_file = std::make_unique<AutoFile>(fsbridge::fopen(FilePath(), "r+b"));
+    if (m_file->IsNull()) {
+        throw std::runtime_error(strprintf("Unable to open coins file %s", fs::PathToString(FilePath())));
+    }
+    m_size = size;
+    m_live_bytes = live_bytes;
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewFile::Cursor() const
+{
+    LOCK(m_mutex);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(m_index.size());
+    for (const auto& [outpoint, location] : m_index) outpoints.push_back(outpoint);
+    std::sort(outpoints.begin(), outpoints.end());
+    return std::make_unique<CoinsFileCursor>(*this, std::move(outpoints), m_heads.size() == 1 ? m_heads[0] : uint256{});
+}
+
+size_t CCoinsViewFile::EstimateSize() const
+{
+    return WITH_LOCK(m_mutex, return m_size);
+}
+
+uint64_t CCoinsViewFile::FileSize() const
+{
+    return WITH_LOCK(m_mutex, return m_size);
+}
+
+size_t CCoinsViewFile::CoinCount() const
+{
+    return WITH_LOCK(m_mutex, return m_index.size());
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COINSFILE_H
+#define BITCOIN_COINSFILE_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Options for CCoinsViewFile.
+struct CoinsFileOptions {
+    //! Directory holding the store. Created if it does not exist.
+    fs::path path;
+    //! Rewrite the file once it is at least this large and mostly made of
+    //! overwritten or erased coins.
+    uint64_t compact_min_bytes{64 << 20};
+};
+
+/**
+ * Experimental CCoinsView backend storing coins in a single append-only file
+ * instead of LevelDB.
+ *
+ * Every BatchWrite appends the changed coins, erasures of spent ones and a
+ * state record with the best block (or, for a partial write, the pair of
+ * head blocks like CCoinsViewDB), then syncs the file. An in-memory hash
+ * index maps each unspent outpoint to the position of its coin, so a lookup
+ * is one read at a known offset and there is no multi-level search or
+ * background compaction.
+ *
+ * The index is rebuilt by replaying the file on startup; anything after the
+ * last state record is an interrupted write and is truncated. Once the file
+ * reaches CoinsFileOptions::compact_min_bytes and more than half of it is
+ * stale, the end of a BatchWrite rewrites the live coins into a new file.
+ *
+ * The index keeps the key and position of every coin in memory, so this is
+ * meant for experiments and benchmarks, e.g. against CCoinsViewDB.
+ */
+class CCoinsViewFile final : public CCoinsView
+{
+public:
+    explicit CCoinsViewFile(CoinsFileOptions options);
+    ~CCoinsViewFile() override;
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    uint256 GetBestBlock() const override;
+    std::vector<uint256> GetHeadBlocks() const override;
+    bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override;
+    //! Iterates over the coins in outpoint order, like CCoinsViewDB.
+    std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    size_t EstimateSize() const override;
+
+    //! Size of the file in bytes.
+    uint64_t FileSize() const;
+    //! Number of unspent coins.
+    size_t CoinCount() const;
+
+private:
+    friend class CoinsFileCursor;
+
+    struct Location {
+        //! Position of the serialized coin.
+        uint64_t coin_offset;
+        //! Size of the whole record, including the outpoint.
+        uint32_t record_size;
+    };
+
+    const CoinsFileOptions m_options;
+    mutable Mutex m_mutex;
+    //! Open for reading and appending.
+    std::unique_ptr<AutoFile> m_file GUARDED_BY(m_mutex);
+    std::unordered_map<COutPoint, Location, SaltedOutpointHasher> m_index GUARDED_BY(m_mutex);
+    std::vector<uint256> m_heads GUARDED_BY(m_mutex);
+    uint64_t m_size GUARDED_BY(m_mutex){0};
+    //! Bytes of the file taken by the records of the coins in m_index.
+    uint64_t m_live_bytes GUARDED_BY(m_mutex){0};
+
+    fs::path FilePath() const { return m_options.path / "coins.dat"; }
+    //! Rebuild the index from the file, truncating an interrupted write.
+    void Load() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Point the index at the coins of records that were appended, or drop erased ones.
+    void ApplyChanges(std::span<const std::pair<COutPoint, std::optional<Location>>> changes) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    Coin ReadCoin(const Location& location) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Append serialized records at the end of the file.
+    void Append(std::span<const std::byte> records) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Compact() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+#endif // BITCOIN_COINSFILE_H
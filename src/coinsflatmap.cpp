@@ -0,0 +1,131 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coinsflatmap.h>
+
+#include <memusage.h>
+
+#include <algorithm>
+#include <bit>
+
+void CoinsFlatMap::reserve(size_t count)
+{
+    // Smallest power of two keeping the load factor at or below the maximum.
+    const size_t wanted{std::bit_ceil(std::max(MIN_CAPACITY, (count * 8 + MAX_LOAD_EIGHTHS - 1) / MAX_LOAD_EIGHTHS))};
+    if (wanted > capacity()) Rehash(wanted);
+}
+
+size_t CoinsFlatMap::Find(const COutPoint& outpoint) const
+{
+    if (m_size == 0) return npos;
+    const size_t hash{m_hasher(outpoint)};
+    const uint8_t tag{Tag(hash)};
+    for (size_t slot{hash & Mask()};; slot = (slot + 1) & Mask()) {
+        if (m_ctrl[slot] == CTRL_EMPTY) return npos;
+        if (m_ctrl[slot] == tag && m_slots[slot].outpoint == outpoint) return slot;
+    }
+}
+
+std::pair<size_t, bool> CoinsFlatMap::TryEmplace(const COutPoint& outpoint)
+{
+    if ((m_size + 1) * 8 > capacity() * MAX_LOAD_EIGHTHS) {
+        Rehash(std::max(MIN_CAPACITY, capacity() * 2));
+    }
+    const size_t hash{m_hasher(outpoint)};
+    const uint8_t tag{Tag(hash)};
+    size_t slot{hash & Mask()};
+    for (; m_ctrl[slot] != CTRL_EMPTY; slot = (slot + 1) & Mask()) {
+        if (m_ctrl[slot] == tag && m_slots[slot].outpoint == outpoint) return {slot, false};
+    }
+    m_ctrl[slot] = tag;
+    m_slots[slot].outpoint = outpoint;
+    ++m_size;
+    return {slot, true};
+}
+
+void CoinsFlatMap::Erase(size_t hole)
+{
+    Assume(IsUsed(hole));
+    ClearFlags(hole);
+    // Backward-shift deletion: move later entries of the probe sequence into
+    // the hole when that does not put them before their home slot, so lookups
+    // never need tombstones.
+    for (size_t slot{(hole + 1) & Mask()}; m_ctrl[slot] != CTRL_EMPTY; slot = (slot + 1) & Mask()) {
+        const size_t home{m_hasher(m_slots[slot].outpoint) & Mask()};
+        // Distance from the home slot to the hole and to the current slot, wrapping around.
+        if (((hole - home) & Mask()) < ((slot - home) & Mask())) {
+            m_slots[hole] = std::move(m_slots[slot]);
+            m_ctrl[hole] = m_ctrl[slot];
+            SetFlagBits(hole, GetFlags(slot));
+            SetFlagBits(slot, 0);
+            hole = slot;
+        }
+    }
+    m_slots[hole].coin.Clear();
+    m_ctrl[hole] = CTRL_EMPTY;
+    --m_size;
+}
+
+bool CoinsFlatMap::Erase(const COutPoint& outpoint)
+{
+    const size_t slot{Find(outpoint)};
+    if (slot == npos) return false;
+    Erase(slot);
+    return true;
+}
+
+void CoinsFlatMap::clear()
+{
+    m_slots = {};
+    m_ctrl = {};
+    m_flags = {};
+    m_size = 0;
+    m_flagged = 0;
+}
+
+void CoinsFlatMap::AddFlags(size_t slot, uint8_t flags)
+{
+    Assume(IsUsed(slot) && (flags & FLAG_MASK) == flags);
+    const uint8_t old_flags{GetFlags(slot)};
+    if (!old_flags && flags) ++m_flagged;
+    SetFlagBits(slot, old_flags | flags);
+}
+
+void CoinsFlatMap::ClearFlags(size_t slot)
+{
+    if (GetFlags(slot)) --m_flagged;
+    SetFlagBits(slot, 0);
+}
+
+void CoinsFlatMap::SetFlagBits(size_t slot, uint8_t flags)
+{
+    const unsigned shift{static_cast<unsigned>(slot % 4 * 2)};
+    m_flags[slot / 4] = (m_flags[slot / 4] & ~(FLAG_MASK << shift)) | (flags << shift);
+}
+
+void CoinsFlatMap::Rehash(size_t new_capacity)
+{
+    Assume(std::has_single_bit(new_capacity) && new_capacity % 4 == 0);
+    std::vector<Slot> old_slots(new_capacity);
+    std::vector<uint8_t> old_ctrl(new_capacity, CTRL_EMPTY);
+    std::vector<uint8_t> old_flags(new_capacity / 4, 0);
+    // Swap in the empty, larger arrays and reinsert from the old ones.
+    old_slots.swap(m_slots);
+    old_ctrl.swap(m_ctrl);
+    old_flags.swap(m_flags);
+
+    for (size_t old_slot{0}; old_slot < old_slots.size(); ++old_slot) {
+        if (old_ctrl[old_slot] == CTRL_EMPTY) continue;
+        size_t slot{m_hasher(old_slots[old_slot].outpoint) & Mask()};
+        while (m_ctrl[slot] != CTRL_EMPTY) slot = (slot + 1) & Mask();
+        m_slots[slot] = std::move(old_slots[old_slot]);
+        m_ctrl[slot] = old_ctrl[old_slot];
+        SetFlagBits(slot, (old_flags[old_slot / 4] >> (old_slot % 4 * 2)) & FLAG_MASK);
+    }
+}
+
+size_t CoinsFlatMap::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_slots) + memusage::DynamicUsage(m_ctrl) + memusage::DynamicUsage(m_flags);
+}
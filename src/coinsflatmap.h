@@ -0,0 +1,133 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COINSFLATMAP_H
+#define BITCOIN_COINSFLATMAP_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <util/check.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * Open-addressing hash table from outpoints to coins, as a cache-friendlier
+ * alternative to CCoinsMap.
+ *
+ * Coins are stored inline in a single slot array, probed linearly. A parallel
+ * array of control bytes holds 7 bits of each occupied slot's hash, so most
+ * probes of a lookup do not touch the slots at all. The DIRTY and FRESH flags
+ * (see CCoinsCacheEntry) live in a separate bitmap of two bits per slot
+ * instead of the linked list of flagged entries CCoinsMap needs, which saves
+ * the list's two pointers per coin. The number of flagged entries is tracked,
+ * and ForEachFlagged() scans the bitmap.
+ *
+ * Slots are addressed by index. Any insertion may rehash and any erasure may
+ * move other coins, so slot indices are only valid until the next call to
+ * TryEmplace(), Erase() or clear().
+ */
+class CoinsFlatMap
+{
+public:
+    static constexpr size_t npos{std::numeric_limits<size_t>::max()};
+
+    explicit CoinsFlatMap(bool deterministic = false) : m_hasher{deterministic} {}
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    //! Number of slots in the table.
+    size_t capacity() const { return m_slots.size(); }
+    //! Number of entries that are DIRTY, FRESH or both.
+    size_t FlaggedCount() const { return m_flagged; }
+
+    //! Make room for at least `count` entries without rehashing.
+    void reserve(size_t count);
+
+    //! Return the slot holding `outpoint`, or npos.
+    size_t Find(const COutPoint& outpoint) const;
+
+    /**
+     * Return the slot holding `outpoint`, inserting an unflagged, spent coin
+     * first if there is none. The bool is true if the entry was inserted.
+     */
+    std::pair<size_t, bool> TryEmplace(const COutPoint& outpoint);
+
+    //! Remove the entry in `slot`.
+    void Erase(size_t slot);
+    //! Remove the entry for `outpoint`. Returns whether there was one.
+    bool Erase(const COutPoint& outpoint);
+
+    //! Remove all entries and release the table's memory.
+    void clear();
+
+    const COutPoint& Key(size_t slot) const
+    {
+        Assume(IsUsed(slot));
+        return m_slots[slot].outpoint;
+    }
+    Coin& Value(size_t slot)
+    {
+        Assume(IsUsed(slot));
+        return m_slots[slot].coin;
+    }
+    const Coin& Value(size_t slot) const
+    {
+        Assume(IsUsed(slot));
+        return m_slots[slot].coin;
+    }
+
+    //! CCoinsCacheEntry::DIRTY and CCoinsCacheEntry::FRESH bits of the entry in `slot`.
+    uint8_t GetFlags(size_t slot) const { return (m_flags[slot / 4] >> (slot % 4 * 2)) & FLAG_MASK; }
+    void AddFlags(size_t slot, uint8_t flags);
+    void ClearFlags(size_t slot);
+
+    //! Call fn(slot) for every flagged entry. fn must not insert or erase.
+    template <typename F>
+    void ForEachFlagged(F&& fn) const
+    {
+        for (size_t byte{0}; byte < m_flags.size(); ++byte) {
+            if (!m_flags[byte]) continue;
+            for (size_t slot{byte * 4}; slot < byte * 4 + 4; ++slot) {
+                if (GetFlags(slot)) fn(slot);
+            }
+        }
+    }
+
+    //! Heap memory used by the table (excluding memory owned by the coins' scripts).
+    size_t DynamicMemoryUsage() const;
+
+private:
+    struct Slot {
+        COutPoint outpoint;
+        Coin coin;
+    };
+
+    static constexpr uint8_t FLAG_MASK{CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH};
+    //! Control byte of an empty slot. Occupied slots have the high bit set.
+    static constexpr uint8_t CTRL_EMPTY{0};
+    static constexpr size_t MIN_CAPACITY{16};
+    //! Maximum load factor, as numerator over 8.
+    static constexpr size_t MAX_LOAD_EIGHTHS{7};
+
+    const SaltedOutpointHasher m_hasher;
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_ctrl;
+    //! Two flag bits per slot.
+    std::vector<uint8_t> m_flags;
+    size_t m_size{0};
+    size_t m_flagged{0};
+
+    static uint8_t Tag(size_t hash) { return 0x80 | (hash >> (std::numeric_limits<size_t>::digits - 7)); }
+    size_t Mask() const { return m_slots.size() - 1; }
+    bool IsUsed(size_t slot) const { return slot < m_ctrl.size() && m_ctrl[slot] != CTRL_EMPTY; }
+    void SetFlagBits(size_t slot, uint8_t flags);
+    void Rehash(size_t new_capacity);
+};
+
+#endif // BITCOIN_COINSFLATMAP_H
@@ -4,6 +4,7 @@
 
 #include <common/bloom.h>
 
+#include <crypto/siphash.h>
 #include <hash.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -244,3 +245,91 @@ void CRollingBloomFilter::reset()
     nGeneration = 1;
     std::fill(data.begin(), data.end(), 0);
 }
+
+/** Factor by which CBlockedRollingBloomFilter is larger than CRollingBloomFilter, which keeps its
+ *  false positive rate about as low despite the uneven load of its blocks. */
+static constexpr double BLOCKED_FILTER_SIZE_FACTOR{1.75};
+
+CBlockedRollingBloomFilter::CBlockedRollingBloomFilter(const unsigned int nElements, const double fpRate)
+{
+    // The same number of hash functions, generations and filter bits as CRollingBloomFilter.
+    double logFpRate = log(fpRate);
+    m_hash_funcs = std::max(1, std::min((int)round(logFpRate / log(0.5)), 50));
+    m_entries_per_generation = (nElements + 1) / 2;
+    uint32_t nMaxElements = m_entries_per_generation * 3;
+    double nFilterBits = -1.0 * m_hash_funcs * nMaxElements / log(1.0 - exp(logFpRate / m_hash_funcs));
+    m_blocks.resize(std::max<size_t>(1, ceil(nFilterBits * BLOCKED_FILTER_SIZE_FACTOR / BLOCK_POSITIONS)));
+    reset();
+}
+
+template <typename F>
+void CBlockedRollingBloomFilter::ForEachPosition(std::span<const unsigned char> vKey, F fn) const
+{
+    const uint64_t h{CSipHasher(m_k0, m_k1).Write(vKey).Finalize()};
+    const uint32_t block_index{FastRange32(h >> 32, m_blocks.size())};
+    // Each 64 bits of a SplitMix64 sequence seeded with the hash give 8 positions of 8 bits.
+    uint64_t state{h};
+    uint64_t bits{0};
+    for (int n = 0; n < m_hash_funcs; n++) {
+        if (n % 8 == 0) {
+            state += 0x9e3779b97f4a7c15;
+            bits = state;
+            bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9;
+            bits = (bits ^ (bits >> 27)) * 0x94d049bb133111eb;
+            bits ^= bits >> 31;
+        }
+        const uint32_t pos = bits & 0xFF;
+        bits >>= 8;
+        fn(block_index, (pos >> 6) << 1, pos & 0x3F);
+    }
+}
+
+void CBlockedRollingBloomFilter::insert(std::span<const unsigned char> vKey)
+{
+    if (m_entries_this_generation == m_entries_per_generation) {
+        m_entries_this_generation = 0;
+        m_generation++;
+        if (m_generation == 4) {
+            m_generation = 1;
+        }
+        uint64_t nGenerationMask1 = 0 - (uint64_t)(m_generation & 1);
+        uint64_t nGenerationMask2 = 0 - (uint64_t)(m_generation >> 1);
+        /* Wipe old entries that used this generation number. */
+        for (Block& block : m_blocks) {
+            for (uint32_t p = 0; p < block.data.size(); p += 2) {
+                uint64_t p1 = block.data[p], p2 = block.data[p + 1];
+                uint64_t mask = (p1 ^ nGenerationMask1) | (p2 ^ nGenerationMask2);
+                block.data[p] = p1 & mask;
+                block.data[p + 1] = p2 & mask;
+            }
+        }
+    }
+    m_entries_this_generation++;
+
+    ForEachPosition(vKey, [&](uint32_t block_index, uint32_t word, int bit) {
+        auto& data{m_blocks[block_index].data};
+        data[word] = (data[word] & ~(uint64_t{1} << bit)) | (uint64_t(m_generation & 1)) << bit;
+        data[word + 1] = (data[word + 1] & ~(uint64_t{1} << bit)) | (uint64_t(m_generation >> 1)) << bit;
+    });
+}
+
+bool CBlockedRollingBloomFilter::contains(std::span<const unsigned char> vKey) const
+{
+    // All positions are looked up, without branching on each, as they are in one cache line.
+    bool found{true};
+    ForEachPosition(vKey, [&](uint32_t block_index, uint32_t word, int bit) {
+        const auto& data{m_blocks[block_index].data};
+        found &= ((data[word] | data[word + 1]) >> bit) & 1;
+    });
+    return found;
+}
+
+void CBlockedRollingBloomFilter::reset()
+{
+    FastRandomContext rng;
+    m_k0 = rng.rand64();
+    m_k1 = rng.rand64();
+    m_entries_this_generation = 0;
+    m_generation = 1;
+    std::fill(m_blocks.begin(), m_blocks.end(), Block{});
+}
@@ -8,6 +8,8 @@
 #include <serialize.h>
 #include <span.h>
 
+#include <array>
+#include <cstdint>
 #include <vector>
 
 class COutPoint;
@@ -124,4 +126,44 @@ private:
     int nHashFuncs;
 };
 
+/**
+ * A variant of CRollingBloomFilter, with the same interface and generations,
+ * in which all the positions of an item are in one block of 64 bytes, so that
+ * inserting or looking it up touches a single cache line. The block and the
+ * positions in it are derived from one 64-bit SipHash of the item, instead of
+ * one MurmurHash3 per hash function.
+ *
+ * The positions of items are less evenly spread than in CRollingBloomFilter,
+ * so it uses more memory for the same false positive rate.
+ */
+class CBlockedRollingBloomFilter
+{
+public:
+    CBlockedRollingBloomFilter(unsigned int nElements, double nFPRate);
+
+    void insert(std::span<const unsigned char> vKey);
+    bool contains(std::span<const unsigned char> vKey) const;
+
+    void reset();
+
+private:
+    /** 256 positions of 2 bits, stored as in CRollingBloomFilter: position P corresponds to bit
+     *  (P & 63) of the integers data[(P >> 6) * 2] and data[(P >> 6) * 2 + 1]. */
+    struct alignas(64) Block {
+        std::array<uint64_t, 8> data;
+    };
+    static constexpr uint32_t BLOCK_POSITIONS{256};
+
+    /** Call fn(word, bit) for each of the positions of an item, in the data of its block. */
+    template <typename F>
+    void ForEachPosition(std::span<const unsigned char> vKey, F fn) const;
+
+    int m_entries_per_generation;
+    int m_entries_this_generation;
+    int m_generation;
+    std::vector<Block> m_blocks;
+    uint64_t m_k0, m_k1;
+    int m_hash_funcs;
+};
+
 #endif // BITCOIN_COMMON_BLOOM_H
@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/blockmetadata.h>
+
+#include <consensus/tx_verify.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+
+bool BlockMetadata::Matches(const CBlock& block) const
+{
+    if (txs.size() != block.vtx.size()) return false;
+    for (size_t i{0}; i < txs.size(); ++i) {
+        if (txs[i].wtxid != block.vtx[i]->GetWitnessHash()) return false;
+    }
+    return true;
+}
+
+BlockMetadata ComputeBlockMetadata(const CBlock& block)
+{
+    BlockMetadata metadata;
+    metadata.txs.reserve(block.vtx.size());
+    // The header and the transaction count are serialized the same way with and without witness data.
+    const uint64_t prefix_size{::GetSerializeSize(static_cast<const CBlockHeader&>(block)) + GetSizeOfCompactSize(block.vtx.size())};
+    metadata.stripped_size = prefix_size;
+    metadata.total_size = prefix_size;
+    for (const auto& tx : block.vtx) {
+        const auto stripped_size{static_cast<uint32_t>(::GetSerializeSize(TX_NO_WITNESS(*tx)))};
+        const auto total_size{tx->HasWitness() ? static_cast<uint32_t>(::GetSerializeSize(TX_WITH_WITNESS(*tx))) : stripped_size};
+        const uint32_t legacy_sigops{GetLegacySigOpCount(*tx)};
+        metadata.txs.push_back({tx->GetWitnessHash(), stripped_size, total_size, legacy_sigops});
+        metadata.stripped_size += stripped_size;
+        metadata.total_size += total_size;
+        metadata.legacy_sigops += legacy_sigops;
+    }
+    return metadata;
+}
+
+std::shared_ptr<const BlockMetadata> GetBlockMetadata(const CBlock& block)
+{
+    if (!block.m_metadata || !block.m_metadata->Matches(block)) {
+        block.m_metadata = std::make_shared<const BlockMetadata>(ComputeBlockMetadata(block));
+    }
+    return block.m_metadata;
+}
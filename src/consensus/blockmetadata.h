@@ -0,0 +1,61 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CONSENSUS_BLOCKMETADATA_H
+#define BITCOIN_CONSENSUS_BLOCKMETADATA_H
+
+#include <consensus/consensus.h>
+#include <util/transaction_identifier.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CBlock;
+
+/** Serialized sizes and legacy sigop count of one transaction of a block. */
+struct TxMetadata {
+    //! The transaction the entry was computed for. Equal wtxids imply equal
+    //! serializations, so this is enough to tell whether the entry still applies.
+    Wtxid wtxid;
+    uint32_t stripped_size;
+    uint32_t total_size;
+    //! GetLegacySigOpCount() of the transaction.
+    uint32_t legacy_sigops;
+
+    int64_t Weight() const { return int64_t{stripped_size} * (WITNESS_SCALE_FACTOR - 1) + total_size; }
+};
+
+/**
+ * Data derived from the transactions of a block that several checks need.
+ *
+ * CheckBlock(), ContextualCheckBlock(), IsBlockMutated() and ConnectBlock()
+ * would otherwise each serialize the block or rescan its scripts; the
+ * metadata is computed once and cached on the block instead. The
+ * transaction hashes themselves are already cached by CTransaction.
+ */
+struct BlockMetadata {
+    std::vector<TxMetadata> txs;
+    //! Serialized size of the block without witness data.
+    uint64_t stripped_size{0};
+    //! Serialized size of the block including witness data.
+    uint64_t total_size{0};
+    uint64_t legacy_sigops{0};
+
+    int64_t Weight() const { return int64_t(stripped_size) * (WITNESS_SCALE_FACTOR - 1) + int64_t(total_size); }
+    //! Whether this was computed for the current transactions of `block`.
+    bool Matches(const CBlock& block) const;
+};
+
+BlockMetadata ComputeBlockMetadata(const CBlock& block);
+
+/**
+ * Return the metadata of `block`, computing and caching it on the block if
+ * it is missing or stale. Like CBlock::fChecked, the cache is not
+ * synchronized, so a block must not be passed to this from several threads
+ * at once.
+ */
+std::shared_ptr<const BlockMetadata> GetBlockMetadata(const CBlock& block);
+
+#endif // BITCOIN_CONSENSUS_BLOCKMETADATA_H
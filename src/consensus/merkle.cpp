@@ -189,3 +189,13 @@ std::vector<uint256> TransactionMerklePath(const CBlock& block, uint32_t positio
     }
     return ComputeMerklePath(leaves, position);
 }
+
+uint256 ComputeMerkleRootFromPath(const uint256& leaf, std::span<const uint256> path, uint32_t position)
+{
+    uint256 hash = leaf;
+    for (const uint256& sibling : path) {
+        hash = (position & 1) ? Hash(sibling, hash) : Hash(hash, sibling);
+        position >>= 1;
+    }
+    return hash;
+}
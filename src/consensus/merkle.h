@@ -5,6 +5,7 @@
 #ifndef BITCOIN_CONSENSUS_MERKLE_H
 #define BITCOIN_CONSENSUS_MERKLE_H
 
+#include <span>
 #include <vector>
 
 #include <primitives/block.h>
@@ -34,4 +35,14 @@ uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr);
  */
 std::vector<uint256> TransactionMerklePath(const CBlock& block, uint32_t position);
 
+/**
+ * Compute the merkle root from a leaf and its merkle path, which takes one
+ * hash per level of the tree instead of hashing all the leaves.
+ *
+ * @param[in] leaf the hash of the transaction
+ * @param[in] path merkle path to the transaction, as returned by TransactionMerklePath()
+ * @param[in] position position of the transaction in the block (0 is the coinbase)
+ */
+uint256 ComputeMerkleRootFromPath(const uint256& leaf, std::span<const uint256> path, uint32_t position);
+
 #endif // BITCOIN_CONSENSUS_MERKLE_H
@@ -8,6 +8,7 @@
 #include <consensus/amount.h>
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 class CBlockIndex;
@@ -50,9 +51,10 @@ unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& ma
  * @param[in] tx     Transaction for which we are computing the cost
  * @param[in] inputs Map of previous transactions that have outputs we're spending
  * @param[in] flags Script verification flags
+ * @param[in] legacy_sigops GetLegacySigOpCount(tx), if the caller already computed it
  * @return Total signature operation cost of tx
  */
-int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& inputs, uint32_t flags);
+int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& inputs, uint32_t flags, std::optional<unsigned int> legacy_sigops = std::nullopt);
 
 /**
  * Check if transaction is final and can be included in a block with the
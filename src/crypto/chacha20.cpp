@@ -10,9 +10,32 @@
 #include <support/cleanse.h>
 #include <span.h>
 
+#include <compat/cpuid.h>
+
 #include <algorithm>
 #include <bit>
+#include <cassert>
 #include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+namespace chacha20_vec128 {
+size_t Crypt_4way(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept;
+} // namespace chacha20_vec128
+#define HAVE_CHACHA20_VEC128
+#endif
+
+#ifdef ENABLE_AVX2
+namespace chacha20_avx2 {
+size_t Crypt_8way(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept;
+} // namespace chacha20_avx2
+#endif
+
+#ifdef ENABLE_AVX512
+namespace chacha20_avx512 {
+size_t Crypt_16way(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept;
+} // namespace chacha20_avx512
+#endif
 
 #define QUARTERROUND(a,b,c,d) \
   a += b; d = std::rotl(d ^ a, 16); \
@@ -22,6 +45,24 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+namespace {
+
+typedef size_t (*CryptVecFn)(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept;
+
+/** Multi-block implementation picked by ChaCha20AutoDetect, used for the leading whole groups
+ *  of blocks of every Keystream/Crypt call. Until then only the scalar code is used. */
+CryptVecFn CryptVec{nullptr};
+
+/** Move the block counter in input[8] forward by n blocks, carrying into input[9]. */
+void AdvanceBlocks(uint32_t input[12], size_t n)
+{
+    const uint64_t counter{(input[8] | uint64_t{input[9]} << 32) + n};
+    input[8] = uint32_t(counter);
+    input[9] = uint32_t(counter >> 32);
+}
+
+} // namespace
+
 void ChaCha20Aligned::SetKey(std::span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -63,6 +104,13 @@ inline void ChaCha20Aligned::Keystream(std::span<std::byte> output) noexcept
     size_t blocks = output.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == output.size());
 
+    if (CryptVec) {
+        const size_t done{CryptVec(input, nullptr, c, blocks)};
+        AdvanceBlocks(input, done);
+        blocks -= done;
+        c += done * BLOCKLEN;
+    }
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -166,6 +214,14 @@ inline void ChaCha20Aligned::Crypt(std::span<const std::byte> in_bytes, std::spa
     size_t blocks = out_bytes.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == out_bytes.size());
 
+    if (CryptVec) {
+        const size_t done{CryptVec(input, m, c, blocks)};
+        AdvanceBlocks(input, done);
+        blocks -= done;
+        m += done * BLOCKLEN;
+        c += done * BLOCKLEN;
+    }
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -370,3 +426,98 @@ void FSChaCha20::Crypt(std::span<const std::byte> input, std::span<std::byte> ou
         m_chunk_counter = 0;
     }
 }
+
+namespace {
+/** Check the selected multi-block implementation against the scalar code. */
+bool SelfTest()
+{
+    if (!CryptVec) return true;
+
+    // Enough blocks for a whole group of every implementation plus a scalar tail, starting
+    // just below a block counter overflow so the carry into the nonce is exercised too.
+    constexpr size_t BLOCKS{35};
+    std::vector<std::byte> key(ChaCha20Aligned::KEYLEN);
+    for (size_t i{0}; i < key.size(); ++i) key[i] = std::byte(i * 7 + 1);
+    std::vector<std::byte> message(BLOCKS * ChaCha20Aligned::BLOCKLEN);
+    for (size_t i{0}; i < message.size(); ++i) message[i] = std::byte(i * 13 + 5);
+    const ChaCha20Aligned::Nonce96 nonce{0x01020304, 0x05060708090a0b0c};
+    const uint32_t block_counter{0xfffffff5};
+
+    std::vector<std::byte> expected_stream(message.size()), expected_crypt(message.size());
+    std::vector<std::byte> stream(message.size()), crypt(message);
+    const CryptVecFn selected{CryptVec};
+    CryptVec = nullptr;
+    ChaCha20Aligned expected{key};
+    expected.Seek(nonce, block_counter);
+    expected.Keystream(expected_stream);
+    expected.Crypt(message, expected_crypt);
+    CryptVec = selected;
+
+    // Decrypt in place to cover aliasing in- and output.
+    ChaCha20Aligned actual{key};
+    actual.Seek(nonce, block_counter);
+    actual.Keystream(stream);
+    actual.Crypt(crypt, crypt);
+    return stream == expected_stream && crypt == expected_crypt;
+}
+
+#if defined(HAVE_GETCPUID)
+/** Return the XCR0 register, which tells whether the OS saves the AVX and AVX-512 registers. */
+uint32_t XCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+} // namespace
+
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    CryptVec = nullptr;
+
+#if defined(HAVE_CHACHA20_VEC128)
+    if (use_implementation & chacha20_implementation::USE_VEC128) {
+        CryptVec = chacha20_vec128::Crypt_4way;
+        ret = "vec128(4way)";
+    }
+#endif
+
+#if defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        const uint32_t xcr0{XCR0()};
+        GetCPUID(0, 0, eax, ebx, ecx, edx);
+        if (eax >= 7) {
+            GetCPUID(7, 0, eax, ebx, ecx, edx);
+            // AVX2 needs the OS to save the XMM and YMM registers, AVX-512 additionally the
+            // opmask and ZMM registers.
+            have_avx2 = (use_implementation & chacha20_implementation::USE_AVX2) && ((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06;
+            have_avx512 = (use_implementation & chacha20_implementation::USE_AVX512) && ((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6;
+        }
+    }
+
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        CryptVec = chacha20_avx2::Crypt_8way;
+        ret = "avx2(8way)";
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        CryptVec = chacha20_avx512::Crypt_16way;
+        ret = "avx512(16way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    assert(SelfTest());
+    return ret;
+}
@@ -11,6 +11,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
 #include <utility>
 
 // classes for ChaCha20 256-bit stream cipher developed by Daniel J. Bernstein
@@ -21,6 +22,22 @@
 // the first 32-bit part of the nonce is automatically incremented, making it
 // conceptually compatible with variants that use a 64/64 split instead.
 
+namespace chacha20_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_VEC128 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_AVX512 = 1 << 2,
+    USE_ALL = USE_VEC128 | USE_AVX2 | USE_AVX512,
+};
+} // namespace chacha20_implementation
+
+/** Autodetect the best available multi-block ChaCha20 implementation.
+ *  Returns the name of the implementation used. Until it is called, only the
+ *  portable one-block-at-a-time code is used.
+ */
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation = chacha20_implementation::USE_ALL);
+
 /** ChaCha20 cipher that only operates on multiples of 64 bytes. */
 class ChaCha20Aligned
 {
@@ -0,0 +1,20 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <crypto/chacha20_vec.ipp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chacha20_avx512 {
+size_t Crypt_16way(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept
+{
+    typedef uint32_t vec512 __attribute__((vector_size(64)));
+    return ChaCha20CryptVec<vec512, 16>(input, in, out, blocks);
+}
+} // namespace chacha20_avx512
+
+#endif
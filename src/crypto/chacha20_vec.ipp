@@ -0,0 +1,123 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Multi-block ChaCha20, written with GCC/Clang vector extensions so that the
+// including translation unit determines the instruction set used, through the
+// vector width it picks and the flags it is compiled with.
+//
+// Lane i of the vector holding state word k belongs to block i, so that the
+// rounds are computed for all blocks at once with plain vector arithmetic.
+
+#ifndef BITCOIN_CRYPTO_CHACHA20_VEC_IPP
+#define BITCOIN_CRYPTO_CHACHA20_VEC_IPP
+
+#include <attributes.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Own helpers rather than those of crypto/common.h, so that no inline function
+// compiled with the including file's flags is shared with other translation units.
+ALWAYS_INLINE uint32_t VecReadLE32(const std::byte* p)
+{
+    uint32_t x;
+    std::memcpy(&x, p, 4);
+    if constexpr (std::endian::native == std::endian::big) x = __builtin_bswap32(x);
+    return x;
+}
+
+ALWAYS_INLINE void VecWriteLE32(std::byte* p, uint32_t x)
+{
+    if constexpr (std::endian::native == std::endian::big) x = __builtin_bswap32(x);
+    std::memcpy(p, &x, 4);
+}
+
+template <typename Vec, int N>
+ALWAYS_INLINE Vec VecRotL(Vec v)
+{
+    return (v << N) | (v >> (32 - N));
+}
+
+template <typename Vec>
+ALWAYS_INLINE void VecQuarterRound(Vec& a, Vec& b, Vec& c, Vec& d)
+{
+    a += b; d = VecRotL<Vec, 16>(d ^ a);
+    c += d; b = VecRotL<Vec, 12>(b ^ c);
+    a += b; d = VecRotL<Vec, 8>(d ^ a);
+    c += d; b = VecRotL<Vec, 7>(b ^ c);
+}
+
+/** Encrypt (or, if in is nullptr, output the keystream of) as many whole groups of LANES
+ *  blocks as fit in `blocks`, starting at the position in input[8..9] (which is not updated).
+ *  In- and output may be the same buffer.
+ *
+ * @return the number of blocks processed
+ */
+template <typename Vec, size_t LANES>
+size_t ChaCha20CryptVec(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept
+{
+    static_assert(sizeof(Vec) == LANES * sizeof(uint32_t));
+    constexpr size_t BLOCKLEN{64};
+    const size_t groups{blocks / LANES};
+
+    Vec lane_index;
+    for (size_t i{0}; i < LANES; ++i) lane_index[i] = i;
+
+    uint32_t counter_lo{input[8]};
+    uint32_t counter_hi{input[9]};
+    for (size_t group{0}; group < groups; ++group) {
+        const Vec j0 = Vec{} + 0x61707865U, j1 = Vec{} + 0x3320646eU, j2 = Vec{} + 0x79622d32U, j3 = Vec{} + 0x6b206574U;
+        const Vec j4 = Vec{} + input[0], j5 = Vec{} + input[1], j6 = Vec{} + input[2], j7 = Vec{} + input[3];
+        const Vec j8 = Vec{} + input[4], j9 = Vec{} + input[5], j10 = Vec{} + input[6], j11 = Vec{} + input[7];
+        const Vec j12 = lane_index + counter_lo;
+        // A lane whose counter wrapped around carries into the first nonce word. The comparison
+        // yields all ones (-1) for those lanes.
+        const Vec j13 = (Vec{} + counter_hi) - (Vec)(j12 < (Vec{} + counter_lo));
+        const Vec j14 = Vec{} + input[10], j15 = Vec{} + input[11];
+
+        Vec x0 = j0, x1 = j1, x2 = j2, x3 = j3, x4 = j4, x5 = j5, x6 = j6, x7 = j7;
+        Vec x8 = j8, x9 = j9, x10 = j10, x11 = j11, x12 = j12, x13 = j13, x14 = j14, x15 = j15;
+
+        for (int round{0}; round < 10; ++round) {
+            VecQuarterRound(x0, x4, x8, x12);
+            VecQuarterRound(x1, x5, x9, x13);
+            VecQuarterRound(x2, x6, x10, x14);
+            VecQuarterRound(x3, x7, x11, x15);
+            VecQuarterRound(x0, x5, x10, x15);
+            VecQuarterRound(x1, x6, x11, x12);
+            VecQuarterRound(x2, x7, x8, x13);
+            VecQuarterRound(x3, x4, x9, x14);
+        }
+
+        uint32_t words[16][LANES];
+        const Vec result[16]{x0 + j0, x1 + j1, x2 + j2, x3 + j3, x4 + j4, x5 + j5, x6 + j6, x7 + j7,
+                             x8 + j8, x9 + j9, x10 + j10, x11 + j11, x12 + j12, x13 + j13, x14 + j14, x15 + j15};
+        std::memcpy(words, result, sizeof(words));
+
+        for (size_t lane{0}; lane < LANES; ++lane) {
+            std::byte* c{out + lane * BLOCKLEN};
+            if (in) {
+                const std::byte* m{in + lane * BLOCKLEN};
+                for (size_t k{0}; k < 16; ++k) VecWriteLE32(c + 4 * k, words[k][lane] ^ VecReadLE32(m + 4 * k));
+            } else {
+                for (size_t k{0}; k < 16; ++k) VecWriteLE32(c + 4 * k, words[k][lane]);
+            }
+        }
+
+        out += LANES * BLOCKLEN;
+        if (in) in += LANES * BLOCKLEN;
+        const uint32_t next_lo{counter_lo + uint32_t(LANES)};
+        if (next_lo < counter_lo) ++counter_hi;
+        counter_lo = next_lo;
+    }
+    return groups * LANES;
+}
+
+} // namespace
+
+#endif // BITCOIN_CRYPTO_CHACHA20_VEC_IPP
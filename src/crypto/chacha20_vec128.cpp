@@ -0,0 +1,22 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 128-bit vectors are part of the baseline instruction set on x86_64 (SSE2) and
+// AArch64 (NEON), so this file needs no extra compile flags.
+#if defined(__SSE2__) || defined(__ARM_NEON)
+
+#include <crypto/chacha20_vec.ipp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chacha20_vec128 {
+size_t Crypt_4way(const uint32_t input[12], const std::byte* in, std::byte* out, size_t blocks) noexcept
+{
+    typedef uint32_t vec128 __attribute__((vector_size(16)));
+    return ChaCha20CryptVec<vec128, 4>(input, in, out, blocks);
+}
+} // namespace chacha20_vec128
+
+#endif
@@ -5,6 +5,7 @@
 #include <crypto/hex_base.h>
 
 #include <array>
+#include <cassert>
 #include <cstring>
 #include <string>
 
@@ -65,3 +66,18 @@ signed char HexDigit(char c)
     return p_util_hexdigit[(unsigned char)c];
 }
 
+
+bool DecodeHexDigits(std::string_view hex, std::span<uint8_t> out)
+{
+    assert(hex.size() == out.size() * 2);
+    // Decode every pair without branching on the characters; the digits of
+    // invalid characters are -1, which sets the sign of `invalid`.
+    int invalid{0};
+    for (size_t i{0}; i < out.size(); ++i) {
+        const int hi{p_util_hexdigit[(unsigned char)hex[2 * i]]};
+        const int lo{p_util_hexdigit[(unsigned char)hex[2 * i + 1]]};
+        invalid |= hi | lo;
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return invalid >= 0;
+}
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 /**
  * Convert a span of bytes to a lower-case hexadecimal string.
@@ -20,4 +21,11 @@ inline std::string HexStr(const std::span<const std::byte> s) { return HexStr(Ma
 
 signed char HexDigit(char c);
 
+/**
+ * Decode a string of hex digits, without whitespace, into `out`, which must be
+ * half its size. Returns false if one of the characters is not a hex digit, in
+ * which case the contents of `out` are unspecified.
+ */
+bool DecodeHexDigits(std::string_view hex, std::span<uint8_t> out);
+
 #endif // BITCOIN_CRYPTO_HEX_BASE_H
@@ -4,10 +4,19 @@
 
 #include <crypto/ripemd160.h>
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 
 #include <cstring>
 
+#if defined(ENABLE_AVX2)
+namespace ripemd160_avx2
+{
+/** Perform a RIPEMD-160 transformation on eight states, s[5*i..5*i+4] by chunks[i]. */
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -235,6 +244,38 @@ void Transform(uint32_t* s, const unsigned char* chunk)
 
 } // namespace ripemd160
 
+using Transform_8wayType = void (*)(uint32_t*, const unsigned char* const*);
+
+Transform_8wayType DetectTransform_8way()
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        uint32_t xcr0, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        GetCPUID(0, 0, eax, ebx, ecx, edx);
+        if (eax >= 7) {
+            GetCPUID(7, 0, eax, ebx, ecx, edx);
+            // AVX2 needs the OS to save the XMM and YMM registers.
+            if (((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06) return ripemd160_avx2::Transform_8way;
+        }
+    }
+#endif
+    return nullptr;
+}
+
+/** Pad a 32-byte input into a single RIPEMD-160 chunk. */
+void Pad32(unsigned char* chunk, const unsigned char* in)
+{
+    std::memcpy(chunk, in, 32);
+    std::memset(chunk + 32, 0, 32);
+    chunk[32] = 0x80;
+    WriteLE64(chunk + 56, 256);
+}
+
 } // namespace
 
 ////// RIPEMD160
@@ -290,3 +331,37 @@ CRIPEMD160& CRIPEMD160::Reset()
     ripemd160::Initialize(s);
     return *this;
 }
+
+void RIPEMD160_32(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    static const Transform_8wayType transform_8way{DetectTransform_8way()};
+
+    if (transform_8way) {
+        while (blocks >= 8) {
+            unsigned char padded[8][64];
+            const unsigned char* chunks[8];
+            uint32_t s[40];
+            for (int i = 0; i < 8; ++i) {
+                Pad32(padded[i], in + 32 * i);
+                chunks[i] = padded[i];
+                ripemd160::Initialize(s + 5 * i);
+            }
+            transform_8way(s, chunks);
+            for (int i = 0; i < 40; ++i) WriteLE32(out + 4 * i, s[i]);
+            out += 20 * 8;
+            in += 32 * 8;
+            blocks -= 8;
+        }
+    }
+    while (blocks) {
+        unsigned char chunk[64];
+        uint32_t s[5];
+        Pad32(chunk, in);
+        ripemd160::Initialize(s);
+        ripemd160::Transform(s, chunk);
+        for (int i = 0; i < 5; ++i) WriteLE32(out + 4 * i, s[i]);
+        out += 20;
+        in += 32;
+        --blocks;
+    }
+}
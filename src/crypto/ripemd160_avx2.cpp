@@ -0,0 +1,258 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+#include <crypto/common.h>
+
+namespace ripemd160_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w) { return Add(Add(x, y), Add(z, w)); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+/** Compute ~x & y. */
+__m256i inline AndNot(__m256i x, __m256i y) { return _mm256_andnot_si256(x, y); }
+__m256i inline Not(__m256i x) { return Xor(x, K(0xFFFFFFFFul)); }
+__m256i inline RotL(__m256i x, int i) { return Or(_mm256_slli_epi32(x, i), _mm256_srli_epi32(x, 32 - i)); }
+
+__m256i inline f1(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline f2(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), AndNot(x, z)); }
+__m256i inline f3(__m256i x, __m256i y, __m256i z) { return Xor(Or(x, Not(y)), z); }
+__m256i inline f4(__m256i x, __m256i y, __m256i z) { return Or(And(x, z), AndNot(z, y)); }
+__m256i inline f5(__m256i x, __m256i y, __m256i z) { return Xor(x, Or(y, Not(z))); }
+
+void ALWAYS_INLINE Round(__m256i& a, __m256i& c, __m256i e, __m256i f, __m256i x, uint32_t k, int r)
+{
+    a = Add(RotL(Add(a, f, x, K(k)), r), e);
+    c = RotL(c, 10);
+}
+
+void ALWAYS_INLINE R11(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f1(b, c, d), x, 0, r); }
+void ALWAYS_INLINE R21(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f2(b, c, d), x, 0x5A827999ul, r); }
+void ALWAYS_INLINE R31(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f3(b, c, d), x, 0x6ED9EBA1ul, r); }
+void ALWAYS_INLINE R41(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f4(b, c, d), x, 0x8F1BBCDCul, r); }
+void ALWAYS_INLINE R51(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f5(b, c, d), x, 0xA953FD4Eul, r); }
+
+void ALWAYS_INLINE R12(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f5(b, c, d), x, 0x50A28BE6ul, r); }
+void ALWAYS_INLINE R22(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f4(b, c, d), x, 0x5C4DD124ul, r); }
+void ALWAYS_INLINE R32(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f3(b, c, d), x, 0x6D703EF3ul, r); }
+void ALWAYS_INLINE R42(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f2(b, c, d), x, 0x7A6D76E9ul, r); }
+void ALWAYS_INLINE R52(__m256i& a, __m256i b, __m256i& c, __m256i d, __m256i e, __m256i x, int r) { Round(a, c, e, f1(b, c, d), x, 0, r); }
+
+/** Read word i of each of the eight chunks. */
+__m256i inline ReadLanes(const unsigned char* const* chunks, int i)
+{
+    return _mm256_setr_epi32(ReadLE32(chunks[0] + i), ReadLE32(chunks[1] + i), ReadLE32(chunks[2] + i), ReadLE32(chunks[3] + i),
+                             ReadLE32(chunks[4] + i), ReadLE32(chunks[5] + i), ReadLE32(chunks[6] + i), ReadLE32(chunks[7] + i));
+}
+
+/** Gather word i of the five-word states of the eight lanes. */
+__m256i inline LoadState(const uint32_t* s, int i)
+{
+    return _mm256_setr_epi32(s[i], s[5 + i], s[10 + i], s[15 + i], s[20 + i], s[25 + i], s[30 + i], s[35 + i]);
+}
+
+void inline StoreState(uint32_t* s, int i, __m256i v)
+{
+    alignas(32) uint32_t tmp[8];
+    _mm256_store_si256((__m256i*)tmp, v);
+    for (int j = 0; j < 8; ++j) s[5 * j + i] = tmp[j];
+}
+
+} // namespace
+
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks)
+{
+    __m256i a1 = LoadState(s, 0), b1 = LoadState(s, 1), c1 = LoadState(s, 2), d1 = LoadState(s, 3), e1 = LoadState(s, 4);
+    __m256i a2 = a1, b2 = b1, c2 = c1, d2 = d1, e2 = e1;
+    const __m256i s0 = a1, s1 = b1, s2 = c1, s3 = d1, s4 = e1;
+    const __m256i w0 = ReadLanes(chunks, 0), w1 = ReadLanes(chunks, 4), w2 = ReadLanes(chunks, 8), w3 = ReadLanes(chunks, 12);
+    const __m256i w4 = ReadLanes(chunks, 16), w5 = ReadLanes(chunks, 20), w6 = ReadLanes(chunks, 24), w7 = ReadLanes(chunks, 28);
+    const __m256i w8 = ReadLanes(chunks, 32), w9 = ReadLanes(chunks, 36), w10 = ReadLanes(chunks, 40), w11 = ReadLanes(chunks, 44);
+    const __m256i w12 = ReadLanes(chunks, 48), w13 = ReadLanes(chunks, 52), w14 = ReadLanes(chunks, 56), w15 = ReadLanes(chunks, 60);
+
+    R11(a1, b1, c1, d1, e1, w0, 11);
+    R12(a2, b2, c2, d2, e2, w5, 8);
+    R11(e1, a1, b1, c1, d1, w1, 14);
+    R12(e2, a2, b2, c2, d2, w14, 9);
+    R11(d1, e1, a1, b1, c1, w2, 15);
+    R12(d2, e2, a2, b2, c2, w7, 9);
+    R11(c1, d1, e1, a1, b1, w3, 12);
+    R12(c2, d2, e2, a2, b2, w0, 11);
+    R11(b1, c1, d1, e1, a1, w4, 5);
+    R12(b2, c2, d2, e2, a2, w9, 13);
+    R11(a1, b1, c1, d1, e1, w5, 8);
+    R12(a2, b2, c2, d2, e2, w2, 15);
+    R11(e1, a1, b1, c1, d1, w6, 7);
+    R12(e2, a2, b2, c2, d2, w11, 15);
+    R11(d1, e1, a1, b1, c1, w7, 9);
+    R12(d2, e2, a2, b2, c2, w4, 5);
+    R11(c1, d1, e1, a1, b1, w8, 11);
+    R12(c2, d2, e2, a2, b2, w13, 7);
+    R11(b1, c1, d1, e1, a1, w9, 13);
+    R12(b2, c2, d2, e2, a2, w6, 7);
+    R11(a1, b1, c1, d1, e1, w10, 14);
+    R12(a2, b2, c2, d2, e2, w15, 8);
+    R11(e1, a1, b1, c1, d1, w11, 15);
+    R12(e2, a2, b2, c2, d2, w8, 11);
+    R11(d1, e1, a1, b1, c1, w12, 6);
+    R12(d2, e2, a2, b2, c2, w1, 14);
+    R11(c1, d1, e1, a1, b1, w13, 7);
+    R12(c2, d2, e2, a2, b2, w10, 14);
+    R11(b1, c1, d1, e1, a1, w14, 9);
+    R12(b2, c2, d2, e2, a2, w3, 12);
+    R11(a1, b1, c1, d1, e1, w15, 8);
+    R12(a2, b2, c2, d2, e2, w12, 6);
+
+    R21(e1, a1, b1, c1, d1, w7, 7);
+    R22(e2, a2, b2, c2, d2, w6, 9);
+    R21(d1, e1, a1, b1, c1, w4, 6);
+    R22(d2, e2, a2, b2, c2, w11, 13);
+    R21(c1, d1, e1, a1, b1, w13, 8);
+    R22(c2, d2, e2, a2, b2, w3, 15);
+    R21(b1, c1, d1, e1, a1, w1, 13);
+    R22(b2, c2, d2, e2, a2, w7, 7);
+    R21(a1, b1, c1, d1, e1, w10, 11);
+    R22(a2, b2, c2, d2, e2, w0, 12);
+    R21(e1, a1, b1, c1, d1, w6, 9);
+    R22(e2, a2, b2, c2, d2, w13, 8);
+    R21(d1, e1, a1, b1, c1, w15, 7);
+    R22(d2, e2, a2, b2, c2, w5, 9);
+    R21(c1, d1, e1, a1, b1, w3, 15);
+    R22(c2, d2, e2, a2, b2, w10, 11);
+    R21(b1, c1, d1, e1, a1, w12, 7);
+    R22(b2, c2, d2, e2, a2, w14, 7);
+    R21(a1, b1, c1, d1, e1, w0, 12);
+    R22(a2, b2, c2, d2, e2, w15, 7);
+    R21(e1, a1, b1, c1, d1, w9, 15);
+    R22(e2, a2, b2, c2, d2, w8, 12);
+    R21(d1, e1, a1, b1, c1, w5, 9);
+    R22(d2, e2, a2, b2, c2, w12, 7);
+    R21(c1, d1, e1, a1, b1, w2, 11);
+    R22(c2, d2, e2, a2, b2, w4, 6);
+    R21(b1, c1, d1, e1, a1, w14, 7);
+    R22(b2, c2, d2, e2, a2, w9, 15);
+    R21(a1, b1, c1, d1, e1, w11, 13);
+    R22(a2, b2, c2, d2, e2, w1, 13);
+    R21(e1, a1, b1, c1, d1, w8, 12);
+    R22(e2, a2, b2, c2, d2, w2, 11);
+
+    R31(d1, e1, a1, b1, c1, w3, 11);
+    R32(d2, e2, a2, b2, c2, w15, 9);
+    R31(c1, d1, e1, a1, b1, w10, 13);
+    R32(c2, d2, e2, a2, b2, w5, 7);
+    R31(b1, c1, d1, e1, a1, w14, 6);
+    R32(b2, c2, d2, e2, a2, w1, 15);
+    R31(a1, b1, c1, d1, e1, w4, 7);
+    R32(a2, b2, c2, d2, e2, w3, 11);
+    R31(e1, a1, b1, c1, d1, w9, 14);
+    R32(e2, a2, b2, c2, d2, w7, 8);
+    R31(d1, e1, a1, b1, c1, w15, 9);
+    R32(d2, e2, a2, b2, c2, w14, 6);
+    R31(c1, d1, e1, a1, b1, w8, 13);
+    R32(c2, d2, e2, a2, b2, w6, 6);
+    R31(b1, c1, d1, e1, a1, w1, 15);
+    R32(b2, c2, d2, e2, a2, w9, 14);
+    R31(a1, b1, c1, d1, e1, w2, 14);
+    R32(a2, b2, c2, d2, e2, w11, 12);
+    R31(e1, a1, b1, c1, d1, w7, 8);
+    R32(e2, a2, b2, c2, d2, w8, 13);
+    R31(d1, e1, a1, b1, c1, w0, 13);
+    R32(d2, e2, a2, b2, c2, w12, 5);
+    R31(c1, d1, e1, a1, b1, w6, 6);
+    R32(c2, d2, e2, a2, b2, w2, 14);
+    R31(b1, c1, d1, e1, a1, w13, 5);
+    R32(b2, c2, d2, e2, a2, w10, 13);
+    R31(a1, b1, c1, d1, e1, w11, 12);
+    R32(a2, b2, c2, d2, e2, w0, 13);
+    R31(e1, a1, b1, c1, d1, w5, 7);
+    R32(e2, a2, b2, c2, d2, w4, 7);
+    R31(d1, e1, a1, b1, c1, w12, 5);
+    R32(d2, e2, a2, b2, c2, w13, 5);
+
+    R41(c1, d1, e1, a1, b1, w1, 11);
+    R42(c2, d2, e2, a2, b2, w8, 15);
+    R41(b1, c1, d1, e1, a1, w9, 12);
+    R42(b2, c2, d2, e2, a2, w6, 5);
+    R41(a1, b1, c1, d1, e1, w11, 14);
+    R42(a2, b2, c2, d2, e2, w4, 8);
+    R41(e1, a1, b1, c1, d1, w10, 15);
+    R42(e2, a2, b2, c2, d2, w1, 11);
+    R41(d1, e1, a1, b1, c1, w0, 14);
+    R42(d2, e2, a2, b2, c2, w3, 14);
+    R41(c1, d1, e1, a1, b1, w8, 15);
+    R42(c2, d2, e2, a2, b2, w11, 14);
+    R41(b1, c1, d1, e1, a1, w12, 9);
+    R42(b2, c2, d2, e2, a2, w15, 6);
+    R41(a1, b1, c1, d1, e1, w4, 8);
+    R42(a2, b2, c2, d2, e2, w0, 14);
+    R41(e1, a1, b1, c1, d1, w13, 9);
+    R42(e2, a2, b2, c2, d2, w5, 6);
+    R41(d1, e1, a1, b1, c1, w3, 14);
+    R42(d2, e2, a2, b2, c2, w12, 9);
+    R41(c1, d1, e1, a1, b1, w7, 5);
+    R42(c2, d2, e2, a2, b2, w2, 12);
+    R41(b1, c1, d1, e1, a1, w15, 6);
+    R42(b2, c2, d2, e2, a2, w13, 9);
+    R41(a1, b1, c1, d1, e1, w14, 8);
+    R42(a2, b2, c2, d2, e2, w9, 12);
+    R41(e1, a1, b1, c1, d1, w5, 6);
+    R42(e2, a2, b2, c2, d2, w7, 5);
+    R41(d1, e1, a1, b1, c1, w6, 5);
+    R42(d2, e2, a2, b2, c2, w10, 15);
+    R41(c1, d1, e1, a1, b1, w2, 12);
+    R42(c2, d2, e2, a2, b2, w14, 8);
+
+    R51(b1, c1, d1, e1, a1, w4, 9);
+    R52(b2, c2, d2, e2, a2, w12, 8);
+    R51(a1, b1, c1, d1, e1, w0, 15);
+    R52(a2, b2, c2, d2, e2, w15, 5);
+    R51(e1, a1, b1, c1, d1, w5, 5);
+    R52(e2, a2, b2, c2, d2, w10, 12);
+    R51(d1, e1, a1, b1, c1, w9, 11);
+    R52(d2, e2, a2, b2, c2, w4, 9);
+    R51(c1, d1, e1, a1, b1, w7, 6);
+    R52(c2, d2, e2, a2, b2, w1, 12);
+    R51(b1, c1, d1, e1, a1, w12, 8);
+    R52(b2, c2, d2, e2, a2, w5, 5);
+    R51(a1, b1, c1, d1, e1, w2, 13);
+    R52(a2, b2, c2, d2, e2, w8, 14);
+    R51(e1, a1, b1, c1, d1, w10, 12);
+    R52(e2, a2, b2, c2, d2, w7, 6);
+    R51(d1, e1, a1, b1, c1, w14, 5);
+    R52(d2, e2, a2, b2, c2, w6, 8);
+    R51(c1, d1, e1, a1, b1, w1, 12);
+    R52(c2, d2, e2, a2, b2, w2, 13);
+    R51(b1, c1, d1, e1, a1, w3, 13);
+    R52(b2, c2, d2, e2, a2, w13, 6);
+    R51(a1, b1, c1, d1, e1, w8, 14);
+    R52(a2, b2, c2, d2, e2, w14, 5);
+    R51(e1, a1, b1, c1, d1, w11, 11);
+    R52(e2, a2, b2, c2, d2, w0, 15);
+    R51(d1, e1, a1, b1, c1, w6, 8);
+    R52(d2, e2, a2, b2, c2, w3, 13);
+    R51(c1, d1, e1, a1, b1, w15, 5);
+    R52(c2, d2, e2, a2, b2, w9, 11);
+    R51(b1, c1, d1, e1, a1, w13, 6);
+    R52(b2, c2, d2, e2, a2, w11, 11);
+
+    StoreState(s, 0, Add(Add(s1, c1), d2));
+    StoreState(s, 1, Add(Add(s2, d1), e2));
+    StoreState(s, 2, Add(Add(s3, e1), a2));
+    StoreState(s, 3, Add(Add(s4, a1), b2));
+    StoreState(s, 4, Add(Add(s0, b1), c2));
+}
+
+} // namespace ripemd160_avx2
+
+#endif
@@ -39,6 +39,11 @@ namespace sha256d64_avx2
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_x86_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -437,6 +442,8 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+/** Transform one chunk for each of 8 independent states, stored one after the other. */
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -482,6 +489,7 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -565,6 +573,21 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformMulti_8way, if available, against Transform on different states.
+    if (TransformMulti_8way) {
+        uint32_t states[64];
+        uint32_t expected[64];
+        const unsigned char* chunks[8];
+        for (size_t i = 0; i < 8; ++i) {
+            std::copy(result[i], result[i] + 8, states + 8 * i);
+            std::copy(result[i], result[i] + 8, expected + 8 * i);
+            chunks[i] = data + 1 + 64 * (7 - i);
+            Transform(expected + 8 * i, chunks[i], 1);
+        }
+        TransformMulti_8way(states, chunks);
+        if (!std::equal(states, states + 64, expected)) return false;
+    }
+
     return true;
 }
 
@@ -590,6 +613,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformMulti_8way = nullptr;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
@@ -646,6 +670,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #if defined(ENABLE_AVX2)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256_avx2::Transform_8way;
         ret += ",avx2(8way)";
     }
 #endif
@@ -779,3 +804,131 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+namespace {
+
+/** A message being SHA256'd in one lane of HashMulti. */
+struct MultiLane {
+    //! Index of the input, or -1 if the lane is idle.
+    ptrdiff_t input{-1};
+    //! Whether the input is double-SHA256'd.
+    bool twice{false};
+    //! Whether the first hash is done, and the lane hashes it again.
+    bool second{false};
+    //! Chunks of the input hashed so far, and the total including padding.
+    size_t chunk{0};
+    size_t chunks{0};
+    //! Chunks taken from the input itself, before the ones in the tail.
+    size_t data_chunks{0};
+    const unsigned char* data{nullptr};
+    //! The end of the input and its padding.
+    unsigned char tail[128];
+
+    void Start(ptrdiff_t index, std::span<const unsigned char> in, bool double_hash, uint32_t* s)
+    {
+        input = index;
+        twice = double_hash;
+        second = false;
+        chunk = 0;
+        data = in.data();
+        data_chunks = in.size() / 64;
+        const size_t rem{in.size() % 64};
+        const size_t tail_size{rem + 9 <= 64 ? 64U : 128U};
+        std::fill(tail, tail + tail_size, 0);
+        if (rem) std::memcpy(tail, in.data() + 64 * data_chunks, rem);
+        tail[rem] = 0x80;
+        WriteBE64(tail + tail_size - 8, in.size() << 3);
+        chunks = data_chunks + tail_size / 64;
+        sha256::Initialize(s);
+    }
+
+    const unsigned char* Chunk() const { return chunk < data_chunks ? data + 64 * chunk : tail + 64 * (chunk - data_chunks); }
+
+    /** Move past the chunk just transformed. Returns whether the input is done, with its hash in out. */
+    bool Next(uint32_t* s, unsigned char* out)
+    {
+        if (++chunk < chunks) return false;
+        const bool done{second || !twice};
+        unsigned char* hash{done ? out : tail};
+        for (int i = 0; i < 8; ++i) WriteBE32(hash + 4 * i, s[i]);
+        if (done) return true;
+        // Hash the 32-byte first hash again, as a single padded chunk.
+        std::fill(tail + 32, tail + 64, 0);
+        tail[32] = 0x80;
+        WriteBE64(tail + 56, 256);
+        second = true;
+        chunk = 0;
+        data_chunks = 0;
+        chunks = 1;
+        sha256::Initialize(s);
+        return false;
+    }
+};
+
+/** Compute the single or double SHA256's of inputs, in the lanes of TransformMulti_8way. */
+void HashMulti(unsigned char* out, std::span<const std::span<const unsigned char>> inputs, bool double_hash)
+{
+    // Below this many busy lanes, transforming them one by one is faster.
+    static constexpr int MIN_LANES{3};
+    static const unsigned char idle_chunk[64] = {0};
+    uint32_t s[64];
+    MultiLane lanes[8];
+    size_t next{0};
+    int busy{0};
+    for (int i = 0; i < 8 && next < inputs.size(); ++i, ++busy) {
+        lanes[i].Start(next, inputs[next], double_hash, s + 8 * i);
+        ++next;
+    }
+    while (busy > 0) {
+        const unsigned char* chunks[8];
+        for (int i = 0; i < 8; ++i) {
+            chunks[i] = lanes[i].input < 0 ? idle_chunk : lanes[i].Chunk();
+        }
+        if (busy >= MIN_LANES) {
+            TransformMulti_8way(s, chunks);
+        } else {
+            for (int i = 0; i < 8; ++i) {
+                if (lanes[i].input >= 0) Transform(s + 8 * i, chunks[i], 1);
+            }
+        }
+        for (int i = 0; i < 8; ++i) {
+            MultiLane& lane{lanes[i]};
+            if (lane.input < 0 || !lane.Next(s + 8 * i, out + 32 * lane.input)) continue;
+            if (next < inputs.size()) {
+                lane.Start(next, inputs[next], double_hash, s + 8 * i);
+                ++next;
+            } else {
+                lane.input = -1;
+                --busy;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void SHA256Multi(unsigned char* out, std::span<const std::span<const unsigned char>> inputs)
+{
+    if (!TransformMulti_8way) {
+        for (const auto& in : inputs) {
+            CSHA256().Write(in.data(), in.size()).Finalize(out);
+            out += CSHA256::OUTPUT_SIZE;
+        }
+        return;
+    }
+    HashMulti(out, inputs, /*double_hash=*/false);
+}
+
+void SHA256DMulti(unsigned char* out, std::span<const std::span<const unsigned char>> inputs)
+{
+    if (!TransformMulti_8way) {
+        for (const auto& in : inputs) {
+            unsigned char hash[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(in.data(), in.size()).Finalize(hash);
+            CSHA256().Write(hash, sizeof(hash)).Finalize(out);
+            out += CSHA256::OUTPUT_SIZE;
+        }
+        return;
+    }
+    HashMulti(out, inputs, /*double_hash=*/true);
+}
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <span>
 #include <string>
 
 /** A hasher class for SHA-256. */
@@ -50,4 +51,18 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the SHA256's of inputs of any length, several at a time when a
+ *  multi-lane implementation is available.
+ *  output:  pointer to a inputs.size()*32 byte output buffer
+ *  inputs:  the data to hash.
+ */
+void SHA256Multi(unsigned char* output, std::span<const std::span<const unsigned char>> inputs);
+
+/** Compute the double-SHA256's of inputs of any length, several at a time
+ *  when a multi-lane implementation is available.
+ *  output:  pointer to a inputs.size()*32 byte output buffer
+ *  inputs:  the data to hash.
+ */
+void SHA256DMulti(unsigned char* output, std::span<const std::span<const unsigned char>> inputs);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
@@ -4,7 +4,19 @@
 
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+#include <crypto/common.h>
+
 #include <bit>
+#include <cassert>
+
+#if defined(ENABLE_AVX2)
+namespace siphash_avx2
+{
+/** Compute SipHashUint256 of the eight 32-byte values at vals[0..7] into out[0..7]. */
+void Uint256_8way(uint64_t k0, uint64_t k1, const unsigned char* const* vals, uint64_t* out);
+}
+#endif
 
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
@@ -52,6 +64,18 @@ CSipHasher& CSipHasher::Write(std::span<const unsigned char> data)
     uint8_t c = count;
 
     while (data.size() > 0) {
+        if (c % 8 == 0 && data.size() >= 8) {
+            // Process whole words at once when aligned with them.
+            t = ReadLE64(data.data());
+            v3 ^= t;
+            SIPROUND;
+            SIPROUND;
+            v0 ^= t;
+            t = 0;
+            c += 8;
+            data = data.subspan(8);
+            continue;
+        }
         t |= uint64_t{data.front()} << (8 * (c % 8));
         c++;
         if ((c & 7) == 0) {
@@ -172,3 +196,48 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+using Uint256_8wayType = void (*)(uint64_t, uint64_t, const unsigned char* const*, uint64_t*);
+
+Uint256_8wayType DetectUint256_8way()
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        uint32_t xcr0, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        GetCPUID(0, 0, eax, ebx, ecx, edx);
+        if (eax >= 7) {
+            GetCPUID(7, 0, eax, ebx, ecx, edx);
+            // AVX2 needs the OS to save the XMM and YMM registers.
+            if (((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06) return siphash_avx2::Uint256_8way;
+        }
+    }
+#endif
+    return nullptr;
+}
+
+} // namespace
+
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, std::span<const uint256* const> vals, std::span<uint64_t> out)
+{
+    assert(vals.size() == out.size());
+    static const Uint256_8wayType uint256_8way{DetectUint256_8way()};
+
+    size_t i{0};
+    if (uint256_8way) {
+        for (; i + 8 <= vals.size(); i += 8) {
+            const unsigned char* data[8];
+            for (size_t j{0}; j < 8; ++j) data[j] = vals[i + j]->data();
+            uint256_8way(k0, k1, data, &out[i]);
+        }
+    }
+    for (; i < vals.size(); ++i) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
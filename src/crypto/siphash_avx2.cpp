@@ -0,0 +1,95 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace siphash_avx2 {
+namespace {
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+// Rotations by whole bytes are single shuffles.
+__m256i inline RotL16(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13, 6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13)); }
+__m256i inline RotL32(__m256i x) { return _mm256_shuffle_epi32(x, 0xB1); }
+
+/** The SipHash state of four lanes. */
+struct State {
+    __m256i v0, v1, v2, v3;
+
+    explicit State(uint64_t k0, uint64_t k1)
+        : v0{K(0x736f6d6570736575ULL ^ k0)}, v1{K(0x646f72616e646f6dULL ^ k1)},
+          v2{K(0x6c7967656e657261ULL ^ k0)}, v3{K(0x7465646279746573ULL ^ k1)} {}
+
+    void ALWAYS_INLINE Round()
+    {
+        v0 = Add(v0, v1); v1 = RotL(v1, 13); v1 = Xor(v1, v0);
+        v0 = RotL32(v0);
+        v2 = Add(v2, v3); v3 = RotL16(v3); v3 = Xor(v3, v2);
+        v0 = Add(v0, v3); v3 = RotL(v3, 21); v3 = Xor(v3, v0);
+        v2 = Add(v2, v1); v1 = RotL(v1, 17); v1 = Xor(v1, v2);
+        v2 = RotL32(v2);
+    }
+
+    __m256i Finalize() const { return Xor(Xor(v0, v1), Xor(v2, v3)); }
+};
+
+/** Load four 32-byte values, and transpose them so that w[i] holds word i of each. */
+void ALWAYS_INLINE Load(const unsigned char* const* vals, __m256i w[4])
+{
+    const __m256i r0{_mm256_loadu_si256((const __m256i*)vals[0])};
+    const __m256i r1{_mm256_loadu_si256((const __m256i*)vals[1])};
+    const __m256i r2{_mm256_loadu_si256((const __m256i*)vals[2])};
+    const __m256i r3{_mm256_loadu_si256((const __m256i*)vals[3])};
+    const __m256i t0{_mm256_unpacklo_epi64(r0, r1)}, t1{_mm256_unpackhi_epi64(r0, r1)};
+    const __m256i t2{_mm256_unpacklo_epi64(r2, r3)}, t3{_mm256_unpackhi_epi64(r2, r3)};
+    w[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    w[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    w[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    w[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+} // namespace
+
+void Uint256_8way(uint64_t k0, uint64_t k1, const unsigned char* const* vals, uint64_t* out)
+{
+    // Two independent groups of four lanes, interleaved to hide the latency of each round.
+    State a{k0, k1}, b{k0, k1};
+    __m256i wa[4], wb[4];
+    Load(vals, wa);
+    Load(vals + 4, wb);
+    for (int i = 0; i < 4; ++i) {
+        a.v3 = Xor(a.v3, wa[i]);
+        b.v3 = Xor(b.v3, wb[i]);
+        a.Round(); b.Round();
+        a.Round(); b.Round();
+        a.v0 = Xor(a.v0, wa[i]);
+        b.v0 = Xor(b.v0, wb[i]);
+    }
+    const __m256i len{K(uint64_t{4} << 59)};
+    a.v3 = Xor(a.v3, len);
+    b.v3 = Xor(b.v3, len);
+    a.Round(); b.Round();
+    a.Round(); b.Round();
+    a.v0 = Xor(a.v0, len);
+    b.v0 = Xor(b.v0, len);
+    a.v2 = Xor(a.v2, K(0xFF));
+    b.v2 = Xor(b.v2, K(0xFF));
+    for (int i = 0; i < 4; ++i) {
+        a.Round(); b.Round();
+    }
+    _mm256_storeu_si256((__m256i*)out, a.Finalize());
+    _mm256_storeu_si256((__m256i*)(out + 4), b.Finalize());
+}
+
+} // namespace siphash_avx2
+
+#endif
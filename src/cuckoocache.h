@@ -5,6 +5,8 @@
 #ifndef BITCOIN_CUCKOOCACHE_H
 #define BITCOIN_CUCKOOCACHE_H
 
+#include <memusage.h>
+#include <support/hugepages.h>
 #include <util/fastrange.h>
 
 #include <algorithm>
@@ -14,6 +16,7 @@
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -161,6 +164,10 @@ template <typename Element, typename Hash>
 class cache
 {
 private:
+    /** Number of elements whose hash locations are prefetched at once by the
+     * batch contains(), i.e. 8 times as many table slots. */
+    static constexpr size_t PREFETCH_GROUP_SIZE{8};
+
     /** table stores all the elements */
     std::vector<Element> table;
 
@@ -331,13 +338,17 @@ public:
      * setup should only be called once.
      *
      * @param new_size the desired number of elements to store
+     * @param huge_pages whether to advise the table to be backed by huge pages
      * @returns the maximum number of elements storable
      */
-    uint32_t setup(uint32_t new_size)
+    uint32_t setup(uint32_t new_size, bool huge_pages = false)
     {
         // depth_limit must be at least one otherwise errors can occur.
         size = std::max<uint32_t>(2, new_size);
         depth_limit = static_cast<uint8_t>(std::log2(static_cast<float>(size)));
+        // Advise before the elements are constructed, which touches the memory.
+        table.reserve(size);
+        if (huge_pages) AdviseHugePages(table.data(), size * sizeof(Element));
         table.resize(size);
         collection_flags.setup(size);
         epoch_flags.resize(size);
@@ -357,17 +368,18 @@ public:
      *
      * @param bytes the approximate number of bytes to use for this data
      * structure
+     * @param huge_pages whether to advise the table to be backed by huge pages
      * @returns A pair of the maximum number of elements storable (see setup()
      * documentation for more detail) and the approximate total size of these
      * elements in bytes.
      */
-    std::pair<uint32_t, size_t> setup_bytes(size_t bytes)
+    std::pair<uint32_t, size_t> setup_bytes(size_t bytes, bool huge_pages = false)
     {
         uint32_t requested_num_elems(std::min<size_t>(
             bytes / sizeof(Element),
             std::numeric_limits<uint32_t>::max()));
 
-        auto num_elems = setup(requested_num_elems);
+        auto num_elems = setup(requested_num_elems, huge_pages);
 
         size_t approx_size_bytes = num_elems * sizeof(Element);
         return std::make_pair(num_elems, approx_size_bytes);
@@ -393,8 +405,9 @@ public:
      * @post one of the following: All previously inserted elements and e are
      * now in the table, one previously inserted element is evicted from the
      * table, the entry attempted to be inserted is evicted.
+     * @returns false if an element was evicted, true otherwise
      */
-    inline void insert(Element e)
+    inline bool insert(Element e)
     {
         epoch_check();
         uint32_t last_loc = invalid();
@@ -406,7 +419,7 @@ public:
             if (table[loc] == e) {
                 please_keep(loc);
                 epoch_flags[loc] = last_epoch;
-                return;
+                return true;
             }
         for (uint8_t depth = 0; depth < depth_limit; ++depth) {
             // First try to insert to an empty slot, if one exists
@@ -416,7 +429,7 @@ public:
                 table[loc] = std::move(e);
                 please_keep(loc);
                 epoch_flags[loc] = last_epoch;
-                return;
+                return true;
             }
             /** Swap with the element at the location that was
             * not the last one looked at. Example:
@@ -442,6 +455,7 @@ public:
             // Recompute the locs -- unfortunately happens one too many times!
             locs = compute_hashes(e);
         }
+        return false;
     }
 
     /** contains iterates through the hash locations for a given element
@@ -482,6 +496,61 @@ public:
             }
         return false;
     }
+
+    /** contains for a group of elements at once, e.g. the keys of all the
+     * transactions of a block. The hash locations of up to
+     * PREFETCH_GROUP_SIZE elements are prefetched before any of them is
+     * probed, so the cache misses on the table overlap instead of being
+     * waited for one element at a time. Same semantics as contains() called on
+     * each element in order.
+     *
+     * @param elems the elements to check
+     * @param erase whether to attempt setting the garbage collect flag of the
+     * elements that are found
+     * @returns for each element, whether it is found
+     */
+    std::vector<bool> contains(std::span<const Element> elems, const bool erase) const
+    {
+        std::vector<bool> found(elems.size());
+        std::array<std::array<uint32_t, 8>, PREFETCH_GROUP_SIZE> group_locs;
+        for (size_t begin = 0; begin < elems.size(); begin += PREFETCH_GROUP_SIZE) {
+            const size_t count = std::min(PREFETCH_GROUP_SIZE, elems.size() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                group_locs[i] = compute_hashes(elems[begin + i]);
+#if defined(__GNUC__)
+                for (const uint32_t loc : group_locs[i]) __builtin_prefetch(&table[loc]);
+#endif
+            }
+            for (size_t i = 0; i < count; ++i) {
+                for (const uint32_t loc : group_locs[i]) {
+                    if (table[loc] == elems[begin + i]) {
+                        if (erase) allow_erase(loc);
+                        found[begin + i] = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return found;
+    }
+
+    /** Call fn with every element of the cache which has not been erased,
+     * e.g. to save the cache. Must not run concurrently with insert(). */
+    template <typename F>
+    void ForEach(F&& fn) const
+    {
+        for (uint32_t i = 0; i < size; ++i) {
+            if (!collection_flags.bit_is_set(i)) fn(table[i]);
+        }
+    }
+
+    /** Memory used by the table and the flags of the cache, which is set up
+     * once and does not change afterwards. */
+    size_t DynamicMemoryUsage() const
+    {
+        return memusage::DynamicUsage(table) + memusage::MallocUsage((size + 7) / 8) +
+               memusage::MallocUsage((epoch_flags.capacity() + 7) / 8);
+    }
 };
 } // namespace CuckooCache
 
@@ -12,6 +12,7 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
+#include <util/time.h>
 
 #include <algorithm>
 #include <cassert>
@@ -30,6 +31,7 @@
 #include <leveldb/write_batch.h>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <utility>
 
 static auto CharCast(const std::byte* data) { return reinterpret_cast<const char*>(data); }
@@ -134,12 +136,14 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBTuning& tuning)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    const int write_buffer_percent{std::clamp(tuning.write_buffer_percent, 1, 49)};
+    options.block_cache = leveldb::NewLRUCache(nCacheSize / 100 * (100 - 2 * write_buffer_percent));
+    options.write_buffer_size = nCacheSize / 100 * write_buffer_percent; // up to two write buffers may be held in memory simultaneously
+    options.block_size = tuning.block_size;
+    options.filter_policy = tuning.bloom_bits_per_key > 0 ? leveldb::NewBloomFilterPolicy(tuning.bloom_bits_per_key) : nullptr;
     options.compression = leveldb::kNoCompression;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -147,7 +151,7 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         // on corruption in later versions.
         options.paranoid_checks = true;
     }
-    options.max_file_size = std::max(options.max_file_size, DBWRAPPER_MAX_FILE_SIZE);
+    options.max_file_size = std::max(options.max_file_size, tuning.max_file_size);
     SetMaxOpenFiles(&options);
     return options;
 }
@@ -220,7 +224,7 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     DBContext().iteroptions.verify_checksums = true;
     DBContext().iteroptions.fill_cache = false;
     DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
+    DBContext().options = GetOptions(params.cache_bytes, params.tuning);
     DBContext().options.create_if_missing = true;
     if (params.memory_only) {
         DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -289,7 +293,9 @@ bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
     if (log_memory) {
         mem_before = DynamicMemoryUsage() / 1024.0 / 1024;
     }
+    const auto write_start{SteadyClock::now()};
     leveldb::Status status = DBContext().pdb->Write(fSync ? DBContext().syncoptions : DBContext().writeoptions, &batch.m_impl_batch->batch);
+    m_write_time_us += Ticks<std::chrono::microseconds>(SteadyClock::now() - write_start);
     HandleError(status);
     if (log_memory) {
         double mem_after = DynamicMemoryUsage() / 1024.0 / 1024;
@@ -329,11 +335,13 @@ std::vector<unsigned char> CDBWrapper::CreateObfuscateKey() const
     return ret;
 }
 
-std::optional<std::string> CDBWrapper::ReadImpl(std::span<const std::byte> key) const
+std::optional<std::string> CDBWrapper::ReadImpl(std::span<const std::byte> key, const leveldb::Snapshot* snapshot) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
     std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
+    leveldb::ReadOptions options{DBContext().readoptions};
+    options.snapshot = snapshot;
+    leveldb::Status status = DBContext().pdb->Get(options, slKey, &strValue);
     if (!status.ok()) {
         if (status.IsNotFound())
             return std::nullopt;
@@ -368,6 +376,32 @@ size_t CDBWrapper::EstimateSizeImpl(std::span<const std::byte> key1, std::span<c
     return size;
 }
 
+DBStats CDBWrapper::GetStats() const
+{
+    DBStats stats;
+    stats.write_time = std::chrono::microseconds{m_write_time_us.load()};
+    stats.memory_usage = DynamicMemoryUsage();
+    std::string table;
+    if (!DBContext().pdb->GetProperty("leveldb.stats", &table)) return stats;
+    // After three header lines, leveldb.stats has one line per level:
+    // level, files, size (MiB), compaction time (s), compaction read and written (MiB).
+    std::istringstream lines{table};
+    std::string line;
+    for (int header{0}; header < 3 && std::getline(lines, line); ++header) {}
+    while (std::getline(lines, line)) {
+        std::istringstream fields{line};
+        DBLevelStats level;
+        double size, read, written;
+        if (fields >> level.level >> level.files >> size >> level.compaction_seconds >> read >> written) {
+            level.size_mib = size;
+            level.compaction_read_mib = read;
+            level.compaction_written_mib = written;
+            stats.levels.push_back(level);
+        }
+    }
+    return stats;
+}
+
 bool CDBWrapper::IsEmpty()
 {
     std::unique_ptr<CDBIterator> it(NewIterator());
@@ -376,9 +410,12 @@ bool CDBWrapper::IsEmpty()
 }
 
 struct CDBIterator::IteratorImpl {
+    //! Snapshot read by iter, if any. Declared first so it outlives iter.
+    const std::shared_ptr<const leveldb::Snapshot> snapshot;
     const std::unique_ptr<leveldb::Iterator> iter;
 
-    explicit IteratorImpl(leveldb::Iterator* _iter) : iter{_iter} {}
+    explicit IteratorImpl(leveldb::Iterator* _iter, std::shared_ptr<const leveldb::Snapshot> _snapshot = nullptr)
+        : snapshot{std::move(_snapshot)}, iter{_iter} {}
 };
 
 CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter) : parent(_parent),
@@ -389,6 +426,30 @@ CDBIterator* CDBWrapper::NewIterator()
     return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
 }
 
+CDBWrapper::Snapshot CDBWrapper::GetSnapshot() const
+{
+    leveldb::DB* const pdb{DBContext().pdb};
+    return {pdb->GetSnapshot(), [pdb](const leveldb::Snapshot* s) { pdb->ReleaseSnapshot(s); }};
+}
+
+CDBIterator* CDBWrapper::NewIterator(Snapshot snapshot) const
+{
+    leveldb::ReadOptions options{DBContext().iteroptions};
+    options.snapshot = snapshot.get();
+    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(options), std::move(snapshot))};
+}
+
+std::vector<std::unique_ptr<CDBIterator>> CDBWrapper::NewIterators(size_t count)
+{
+    const Snapshot snapshot{GetSnapshot()};
+    std::vector<std::unique_ptr<CDBIterator>> iterators;
+    iterators.reserve(count);
+    for (size_t i{0}; i < count; ++i) {
+        iterators.emplace_back(NewIterator(snapshot));
+    }
+    return iterators;
+}
+
 void CDBIterator::SeekImpl(std::span<const std::byte> key)
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
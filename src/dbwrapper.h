@@ -12,7 +12,10 @@
 #include <util/check.h>
 #include <util/fs.h>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -30,6 +33,32 @@ struct DBOptions {
     bool force_compact = false;
 };
 
+//! LevelDB settings matching how a database is accessed.
+struct DBTuning {
+    //! Approximate size of the blocks in which data is read and cached.
+    size_t block_size{4 << 10};
+    //! Bits per key of the bloom filter that avoids reading blocks for absent
+    //! keys, or 0 for none.
+    int bloom_bits_per_key{10};
+    //! Size of table files. Larger files mean fewer but longer compactions.
+    size_t max_file_size{DBWRAPPER_MAX_FILE_SIZE};
+    //! Share of the cache used as write buffer, in percent. Up to two write
+    //! buffers may be held in memory at once, the rest of the cache caches
+    //! blocks.
+    int write_buffer_percent{25};
+};
+
+//! Random point lookups through the whole key space, like the coins database.
+inline constexpr DBTuning DB_TUNING_RANDOM_READ{};
+//! Data mostly appended in key order and read sequentially or rarely, like the
+//! block index and the optional indexes. Larger blocks and files and a larger
+//! write buffer mean fewer compactions and reads.
+inline constexpr DBTuning DB_TUNING_APPEND{
+    .block_size = 16 << 10,
+    .max_file_size = 2 * DBWRAPPER_MAX_FILE_SIZE,
+    .write_buffer_percent = 40,
+};
+
 //! Application-specific storage settings.
 struct DBParams {
     //! Location in the filesystem where leveldb data will be stored.
@@ -45,6 +74,28 @@ struct DBParams {
     bool obfuscate = false;
     //! Passed-through options.
     DBOptions options{};
+    //! LevelDB settings for the access pattern of the database.
+    DBTuning tuning{DB_TUNING_RANDOM_READ};
+};
+
+//! Compaction statistics of one level of a LevelDB database.
+struct DBLevelStats {
+    int level;
+    int files;
+    //! The sizes are rounded to whole MiB by LevelDB.
+    uint64_t size_mib;
+    double compaction_seconds;
+    uint64_t compaction_read_mib;
+    uint64_t compaction_written_mib;
+};
+
+struct DBStats {
+    //! Levels that hold files or were compacted.
+    std::vector<DBLevelStats> levels;
+    //! Time spent writing batches, including waiting for compactions to make
+    //! room for the writes.
+    std::chrono::microseconds write_time{0};
+    size_t memory_usage{0};
 };
 
 class dbwrapper_error : public std::runtime_error
@@ -176,6 +227,9 @@ public:
 };
 
 struct LevelDBContext;
+namespace leveldb {
+class Snapshot;
+} // namespace leveldb
 
 class CDBWrapper
 {
@@ -204,7 +258,10 @@ private:
     //! whether or not the database resides in memory
     bool m_is_memory;
 
-    std::optional<std::string> ReadImpl(std::span<const std::byte> key) const;
+    //! total time spent in WriteBatch
+    std::atomic<int64_t> m_write_time_us{0};
+
+    std::optional<std::string> ReadImpl(std::span<const std::byte> key, const leveldb::Snapshot* snapshot = nullptr) const;
     bool ExistsImpl(std::span<const std::byte> key) const;
     size_t EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const;
     auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
@@ -216,13 +273,23 @@ public:
     CDBWrapper(const CDBWrapper&) = delete;
     CDBWrapper& operator=(const CDBWrapper&) = delete;
 
+    /**
+     * Consistent read-only view of the database as of the time it was taken
+     * with GetSnapshot(), unaffected by later writes. It is released with its
+     * last copy, which must not outlive the database.
+     */
+    using Snapshot = std::shared_ptr<const leveldb::Snapshot>;
+
+    Snapshot GetSnapshot() const;
+
+    //! Read the value of key, as of snapshot if one is given.
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const K& key, V& value, const Snapshot& snapshot = nullptr) const
     {
         DataStream ssKey{};
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
-        std::optional<std::string> strValue{ReadImpl(ssKey)};
+        std::optional<std::string> strValue{ReadImpl(ssKey, snapshot.get())};
         if (!strValue) {
             return false;
         }
@@ -274,7 +341,20 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    //! Compaction and write statistics, e.g. to tune the database.
+    DBStats GetStats() const;
+
     CDBIterator* NewIterator();
+    //! Return an iterator over the database as of snapshot, which it keeps alive.
+    CDBIterator* NewIterator(Snapshot snapshot) const;
+
+    /**
+     * Return `count` iterators that all read the same snapshot of the
+     * database, e.g. to scan disjoint key ranges of it concurrently. Each
+     * iterator must only be used by one thread at a time. The snapshot is
+     * released with the last of them.
+     */
+    std::vector<std::unique_ptr<CDBIterator>> NewIterators(size_t count);
 
     /**
      * Return true if the database managed by this class contains no entries.
@@ -39,6 +39,7 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-maxtxfee=<amt>",
         "-mintxfee=<amt>",
         "-paytxfee=<amt>",
+        "-rescanthreads=<n>",
         "-signer=<cmd>",
         "-spendzeroconfchange",
         "-txconfirmtarget=<n>",
@@ -49,6 +50,8 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-walletrbf",
         "-walletrejectlongchains",
         "-walletcrosschain",
+        "-sqlitenormalsync",
+        "-sqlitewal",
         "-unsafesqlitesync",
     });
 }
@@ -3,17 +3,20 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <cstdint>
 #include <stdexcept>
+#include <system_error>
 
 #include <flatfile.h>
 #include <logging.h>
 #include <tinyformat.h>
 #include <util/fs_helpers.h>
 
-FlatFileSeq::FlatFileSeq(fs::path dir, const char* prefix, size_t chunk_size) :
+FlatFileSeq::FlatFileSeq(fs::path dir, const char* prefix, size_t chunk_size, fs::path cold_dir) :
     m_dir(std::move(dir)),
     m_prefix(prefix),
-    m_chunk_size(chunk_size)
+    m_chunk_size(chunk_size),
+    m_cold_dir(std::move(cold_dir))
 {
     if (chunk_size == 0) {
         throw std::invalid_argument("chunk_size must be positive");
@@ -25,9 +28,18 @@ std::string FlatFilePos::ToString() const
     return strprintf("FlatFilePos(nFile=%i, nPos=%i)", nFile, nPos);
 }
 
+fs::path FlatFileSeq::BaseName(const FlatFilePos& pos) const
+{
+    return fs::u8path(strprintf("%s%05u.dat", m_prefix, pos.nFile));
+}
+
 fs::path FlatFileSeq::FileName(const FlatFilePos& pos) const
 {
-    return m_dir / fs::u8path(strprintf("%s%05u.dat", m_prefix, pos.nFile));
+    const fs::path name{BaseName(pos)};
+    if (!m_cold_dir.empty() && !fs::exists(m_dir / name) && fs::exists(m_cold_dir / name)) {
+        return m_cold_dir / name;
+    }
+    return m_dir / name;
 }
 
 FILE* FlatFileSeq::Open(const FlatFilePos& pos, bool read_only) const
@@ -38,6 +50,12 @@ FILE* FlatFileSeq::Open(const FlatFilePos& pos, bool read_only) const
     fs::path path = FileName(pos);
     fs::create_directories(path.parent_path());
     FILE* file = fsbridge::fopen(path, read_only ? "rb": "rb+");
+    if (!file && !m_cold_dir.empty()) {
+        // The file may have been moved to the cold directory since its name
+        // was looked up.
+        path = FileName(pos);
+        file = fsbridge::fopen(path, read_only ? "rb": "rb+");
+    }
     if (!file && !read_only)
         file = fsbridge::fopen(path, "wb+");
     if (!file) {
@@ -112,3 +130,53 @@ bool FlatFileSeq::Flush(const FlatFilePos& pos, bool finalize) const
     }
     return true;
 }
+
+bool FlatFileSeq::CopyToColdDir(const FlatFilePos& pos) const
+{
+    const fs::path name{BaseName(pos)};
+    const fs::path path{m_dir / name};
+    std::error_code ec;
+    if (m_cold_dir.empty() || !fs::exists(path)) return true;
+
+    const uint64_t size{fs::file_size(path, ec)};
+    if (ec) {
+        LogError("Unable to get the size of file %s: %s", fs::PathToString(path), ec.message());
+        return false;
+    }
+    // Copy to a temporary file first, so that an incomplete copy is never used.
+    const fs::path cold_path{m_cold_dir / name};
+    const fs::path tmp_path{cold_path + ".tmp"};
+    try {
+        fs::create_directories(m_cold_dir);
+        if (!CheckDiskSpace(m_cold_dir, size)) {
+            LogError("Not enough disk space to copy %s to %s", fs::PathToString(name), fs::PathToString(m_cold_dir));
+            return false;
+        }
+        fs::copy_file(path, tmp_path, fs::copy_options::overwrite_existing);
+    } catch (const fs::filesystem_error& e) {
+        LogError("Unable to copy %s to %s: %s", fs::PathToString(path), fs::PathToString(tmp_path), e.code().message());
+        return false;
+    }
+    FILE* file{fsbridge::fopen(tmp_path, "rb+")};
+    const bool committed{file && FileCommit(file)};
+    if (file && fclose(file) != 0) {
+        LogError("Failed to close file %s", fs::PathToString(tmp_path));
+        return false;
+    }
+    if (!committed || !RenameOver(tmp_path, cold_path)) {
+        LogError("Unable to commit %s", fs::PathToString(cold_path));
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    DirectoryCommit(m_cold_dir);
+    return true;
+}
+
+void FlatFileSeq::RemoveCopiedToColdDir(const FlatFilePos& pos) const
+{
+    const fs::path name{BaseName(pos)};
+    std::error_code ec;
+    if (m_cold_dir.empty() || !fs::exists(m_cold_dir / name)) return;
+    fs::remove(m_dir / name, ec);
+    DirectoryCommit(m_dir);
+}
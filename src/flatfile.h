@@ -48,6 +48,9 @@ private:
     const fs::path m_dir;
     const char* const m_prefix;
     const size_t m_chunk_size;
+    const fs::path m_cold_dir;
+
+    fs::path BaseName(const FlatFilePos& pos) const;
 
 public:
     /**
@@ -56,10 +59,15 @@ public:
      * @param dir The base directory that all files live in.
      * @param prefix A short prefix given to all file names.
      * @param chunk_size Disk space is pre-allocated in multiples of this amount.
+     * @param cold_dir Directory files may be moved to with MoveToColdDir(), if not empty.
      */
-    FlatFileSeq(fs::path dir, const char* prefix, size_t chunk_size);
+    FlatFileSeq(fs::path dir, const char* prefix, size_t chunk_size, fs::path cold_dir = {});
 
-    /** Get the name of the file at the given position. */
+    /**
+     * Get the name of the file at the given position: in the cold directory
+     * if it was moved there, in the base directory otherwise, which is also
+     * where new files are created.
+     */
     fs::path FileName(const FlatFilePos& pos) const;
 
     /** Open a handle to the file at the given position. */
@@ -84,6 +92,22 @@ public:
      * @return true on success, false on failure.
      */
     bool Flush(const FlatFilePos& pos, bool finalize = false) const;
+
+    /**
+     * Copy the file at the given position from the base directory to the cold
+     * directory, without removing it from the base directory, where it is
+     * still used. The copy is committed to disk before it is put in place.
+     *
+     * @return true on success, or if the file is not in the base directory.
+     */
+    bool CopyToColdDir(const FlatFilePos& pos) const;
+
+    /**
+     * Remove the file at the given position from the base directory once it
+     * has been copied with CopyToColdDir(), so that the copy is used instead.
+     * Handles opened before keep reading the removed file.
+     */
+    void RemoveCopiedToColdDir(const FlatFilePos& pos) const;
 };
 
 #endif // BITCOIN_FLATFILE_H
@@ -8,7 +8,10 @@
 #include <crypto/hmac_sha512.h>
 
 #include <bit>
+#include <cassert>
+#include <cstring>
 #include <string>
+#include <vector>
 
 unsigned int MurmurHash3(unsigned int nHashSeed, std::span<const unsigned char> vDataToHash)
 {
@@ -75,6 +78,18 @@ void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char he
     CHMAC_SHA512(chainCode.begin(), chainCode.size()).Write(&header, 1).Write(data, 32).Write(num, 4).Finalize(output);
 }
 
+void Hash160Multi(std::span<uint160> out, std::span<const std::span<const unsigned char>> inputs)
+{
+    assert(out.size() == inputs.size());
+    std::vector<unsigned char> sha(inputs.size() * CSHA256::OUTPUT_SIZE);
+    std::vector<unsigned char> ripemd(inputs.size() * CRIPEMD160::OUTPUT_SIZE);
+    SHA256Multi(sha.data(), inputs);
+    RIPEMD160_32(ripemd.data(), sha.data(), inputs.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        std::memcpy(out[i].begin(), ripemd.data() + i * CRIPEMD160::OUTPUT_SIZE, CRIPEMD160::OUTPUT_SIZE);
+    }
+}
+
 uint256 SHA256Uint256(const uint256& input)
 {
     uint256 result;
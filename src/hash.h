@@ -96,6 +96,10 @@ inline uint160 Hash160(const T1& in1)
     return result;
 }
 
+/** Compute the 160-bit hashes of many inputs, several at a time when
+ *  multi-lane SHA256 and RIPEMD-160 implementations are available. */
+void Hash160Multi(std::span<uint160> out, std::span<const std::span<const unsigned char>> inputs);
+
 /** A writer stream (for serialization) that computes a 256-bit hash. */
 class HashWriter
 {
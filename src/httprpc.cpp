@@ -9,15 +9,20 @@
 #include <httpserver.h>
 #include <logging.h>
 #include <netaddress.h>
+#include <rpc/jsonstream.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/metrics.h>
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -37,6 +42,8 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+/* Maximum number of threads working on one batch request */
+static int g_rpc_batch_threads{DEFAULT_RPC_BATCH_THREADS};
 
 static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq)
 {
@@ -55,7 +62,7 @@ static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCReq
     std::string strReply = JSONRPCReplyObj(NullUniValue, std::move(objError), jreq.id, jreq.m_json_version).write() + "\n";
 
     req->WriteHeader("Content-Type", "application/json");
-    req->WriteReply(nStatus, strReply);
+    req->WriteReply(nStatus, std::move(strReply));
 }
 
 //This function checks username and password against -rpcauth
@@ -101,6 +108,62 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return CheckUserAuthorized(user, pass);
 }
 
+/**
+ * Execute the requests of a batch on up to g_rpc_batch_threads threads: the
+ * calling one, and HTTP worker threads if the work queue has room. Returns the
+ * responses in request order, with std::nullopt for notifications.
+ */
+static std::vector<std::optional<UniValue>> ExecuteBatch(UniValue batch, const JSONRPCRequest& base_request)
+{
+    struct State {
+        const UniValue batch;
+        const JSONRPCRequest base_request;
+        std::vector<std::optional<UniValue>> responses;
+        std::atomic<size_t> next{0};
+        Mutex mutex;
+        std::condition_variable cv;
+        size_t remaining GUARDED_BY(mutex);
+
+        State(UniValue&& b, const JSONRPCRequest& r) : batch{std::move(b)}, base_request{r}, responses(batch.size()), remaining{batch.size()} {}
+
+        /** Execute requests that no other thread has claimed until there are none left. */
+        void Work() EXCLUSIVE_LOCKS_REQUIRED(!mutex)
+        {
+            for (size_t i; (i = next++) < batch.size();) {
+                // Batches never throw HTTP errors, they are always just included
+                // in "HTTP OK" responses. Notifications never get any response.
+                JSONRPCRequest jreq{base_request};
+                UniValue response;
+                try {
+                    jreq.parse(batch[i]);
+                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
+                } catch (UniValue& e) {
+                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+                } catch (const std::exception& e) {
+                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+                }
+                if (!jreq.IsNotification()) {
+                    responses[i] = std::move(response);
+                }
+                LOCK(mutex);
+                if (--remaining == 0) cv.notify_all();
+            }
+        }
+    };
+
+    // Helper tasks may only start after the batch is done, so they share ownership of it.
+    auto state{std::make_shared<State>(std::move(batch), base_request)};
+    const size_t helpers{std::min<size_t>(g_rpc_batch_threads - 1, std::max<size_t>(state->batch.size(), 1) - 1)};
+    for (size_t i{0}; i < helpers; ++i) {
+        if (!HTTPTryEnqueueTask([state] { state->Work(); })) break;
+    }
+    // This thread works on the batch too, so it completes even if no worker is idle.
+    state->Work();
+    WAIT_LOCK(state->mutex, lock);
+    state->cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(state->mutex) { return state->remaining == 0; });
+    return std::move(state->responses);
+}
+
 static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 {
     // JSONRPC handles only POST
@@ -162,7 +225,58 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
-            reply = JSONRPCExec(jreq, catch_errors);
+
+            // Methods may stream a large result. It is sent as a chunked reply as soon
+            // as the first chunk is ready, at which point errors can no longer be reported.
+            bool streaming{false};
+            JSONStreamWriter stream{
+                [&](std::string&& chunk) {
+                    if (!streaming) {
+                        req->WriteHeader("Content-Type", "application/json");
+                        req->WriteReplyStart(HTTP_OK);
+                        streaming = true;
+                    }
+                    req->WriteReplyChunk(std::move(chunk));
+                },
+                jreq.m_json_version == JSONRPCVersion::V2 ? R"({"jsonrpc":"2.0","result":)" : R"({"result":)"};
+            // Clients may ask for serialized data as raw bytes rather than hex in JSON.
+            std::vector<std::byte> binary_result;
+            const bool accepts_binary{req->GetHeader("accept").second.find("application/octet-stream") != std::string::npos};
+            if (!jreq.IsNotification()) {
+                jreq.m_result_stream = &stream;
+                if (accepts_binary) jreq.m_binary_result = &binary_result;
+            }
+            bool failed{false};
+            try {
+                reply = JSONRPCExec(jreq, catch_errors);
+                if (stream.Started() && reply.find_value("error").isNull()) {
+                    // Same layout as JSONRPCReplyObj
+                    std::string suffix{jreq.m_json_version == JSONRPCVersion::V1_LEGACY ? R"(,"error":null)" : ""};
+                    if (jreq.id.has_value()) suffix += R"(,"id":)" + jreq.id->write();
+                    stream.Finish(suffix + "}\n");
+                }
+            } catch (...) {
+                jreq.m_result_stream = nullptr;
+                jreq.m_binary_result = nullptr;
+                if (!streaming) throw;
+                failed = true;
+            }
+            jreq.m_result_stream = nullptr;
+            jreq.m_binary_result = nullptr;
+            if (streaming) {
+                failed = failed || !reply.find_value("error").isNull();
+                if (failed) {
+                    LogPrintf("RPC method %s failed after part of its reply was sent, closing it\n", jreq.strMethod);
+                }
+                req->WriteReplyEnd();
+                return !failed;
+            }
+
+            if (!binary_result.empty() && reply.find_value("error").isNull()) {
+                req->WriteHeader("Content-Type", "application/octet-stream");
+                req->WriteReply(HTTP_OK, binary_result);
+                return true;
+            }
 
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
@@ -191,22 +305,10 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             }
 
             // Execute each request
+            const size_t batch_size{valRequest.size()};
             reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
-                // Batches never throw HTTP errors, they are always just included
-                // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
-                try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
-                } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
-                } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
-                }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
-                }
+            for (auto& response : ExecuteBatch(std::move(valRequest), jreq)) {
+                if (response) reply.push_back(std::move(*response));
             }
             // Return no response for an all-notification batch, but only if the
             // batch request is non-empty. Technically according to the JSON-RPC
@@ -217,7 +319,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // relying on previous behavior. Return an empty array instead of an
             // empty response in this case to favor being backwards compatible
             // over complying with the JSON-RPC 2.0 spec in this case.
-            if (reply.size() == 0 && valRequest.size() > 0) {
+            if (reply.size() == 0 && batch_size > 0) {
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
@@ -237,6 +339,19 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
     return true;
 }
 
+static bool HTTPReq_Metrics(HTTPRequest* req)
+{
+    if (req->GetRequestMethod() != HTTPRequest::GET) {
+        req->WriteReply(HTTP_BAD_METHOD, "Metrics are only served to GET requests");
+        return false;
+    }
+    // Rendering only reads atomics, so this never waits for cs_main or any of
+    // the locks of the code updating the metrics.
+    req->WriteHeader("Content-Type", "application/openmetrics-text; version=1.0.0; charset=utf-8");
+    req->WriteReply(HTTP_OK, metrics::GetRegistry().Render());
+    return true;
+}
+
 static bool InitRPCAuthentication()
 {
     std::string user;
@@ -333,6 +448,7 @@ bool StartHTTPRPC(const std::any& context)
     LogDebug(BCLog::RPC, "Starting HTTP RPC server\n");
     if (!InitRPCAuthentication())
         return false;
+    g_rpc_batch_threads = std::max<int>(gArgs.GetIntArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), 1);
 
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
     RegisterHTTPHandler("/", true, handle_rpc);
@@ -357,3 +473,14 @@ void StopHTTPRPC()
         UnregisterHTTPHandler("/wallet/", false);
     }
 }
+
+void StartHTTPMetrics()
+{
+    LogDebug(BCLog::RPC, "Starting HTTP metrics endpoint\n");
+    RegisterHTTPHandler("/metrics", true, [](HTTPRequest* req, const std::string&) { return HTTPReq_Metrics(req); });
+}
+
+void StopHTTPMetrics()
+{
+    UnregisterHTTPHandler("/metrics", true);
+}
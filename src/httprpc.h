@@ -7,6 +7,9 @@
 
 #include <any>
 
+/** Default for -rpcbatchthreads, the maximum number of threads executing the requests of one batch */
+static constexpr int DEFAULT_RPC_BATCH_THREADS{4};
+
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
  */
@@ -31,4 +34,13 @@ void InterruptREST();
  */
 void StopREST();
 
+/** Serve the metrics of the node at /metrics, in the OpenMetrics text format.
+ * Requests to it are not authenticated.
+ * Precondition; HTTP has been started.
+ */
+void StartHTTPMetrics();
+/** Stop serving metrics.
+ */
+void StopHTTPMetrics();
+
 #endif // BITCOIN_HTTPRPC_H
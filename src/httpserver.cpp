@@ -17,8 +17,12 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/threadnames.h>
+#include <util/time.h>
+#include <util/trace.h>
 #include <util/translation.h>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
@@ -29,6 +33,7 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <sys/types.h>
@@ -39,6 +44,7 @@
 #include <event2/http.h>
 #include <event2/http_struct.h>
 #include <event2/keyvalq_struct.h>
+#include <event2/listener.h>
 #include <event2/thread.h>
 #include <event2/util.h>
 
@@ -69,6 +75,20 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Work item that is not tied to an HTTP request, see HTTPTryEnqueueTask */
+class HTTPTask final : public HTTPClosure
+{
+public:
+    explicit HTTPTask(std::function<void()> fn) : m_fn{std::move(fn)} {}
+    void operator()() override { m_fn(); }
+
+private:
+    std::function<void()> m_fn;
+};
+
+TRACEPOINT_SEMAPHORE(http, request_enqueued);
+TRACEPOINT_SEMAPHORE(http, request_dequeued);
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
  */
@@ -76,27 +96,62 @@ template <typename WorkItem>
 class WorkQueue
 {
 private:
+    struct Entry {
+        std::unique_ptr<WorkItem> item;
+        SteadyClock::time_point enqueued;
+    };
     Mutex cs;
     std::condition_variable cond GUARDED_BY(cs);
-    std::deque<std::unique_ptr<WorkItem>> queue GUARDED_BY(cs);
+    std::deque<Entry> queue GUARDED_BY(cs);
     bool running GUARDED_BY(cs){true};
     const size_t maxDepth;
+    //! How long items beyond maxDepth may wait for room before being rejected.
+    const std::chrono::milliseconds m_max_wait;
 
 public:
-    explicit WorkQueue(size_t _maxDepth) : maxDepth(_maxDepth)
+    explicit WorkQueue(size_t _maxDepth, std::chrono::milliseconds max_wait = {}) : maxDepth(_maxDepth), m_max_wait(max_wait)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
      */
     ~WorkQueue() = default;
-    /** Enqueue a work item */
-    bool Enqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    /** Enqueue a work item. If the queue is full, the item waits for room for up to the
+     *  maximum wait time instead of being rejected; waiting items that timed out are
+     *  removed and handed back through `expired`. */
+    bool Enqueue(WorkItem* item, std::vector<std::unique_ptr<WorkItem>>& expired) EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    {
+        LOCK(cs);
+        if (!running) {
+            return false;
+        }
+        const auto now{SteadyClock::now()};
+        if (queue.size() >= maxDepth) {
+            for (auto it{queue.begin() + maxDepth}; it != queue.end();) {
+                if (now - it->enqueued > m_max_wait) {
+                    expired.push_back(std::move(it->item));
+                    it = queue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            if (queue.size() >= maxDepth && m_max_wait == std::chrono::milliseconds::zero()) {
+                TRACEPOINT(http, request_enqueued, (uint64_t)queue.size(), (uint64_t)maxDepth, false);
+                return false;
+            }
+        }
+        queue.push_back({std::unique_ptr<WorkItem>(item), now});
+        TRACEPOINT(http, request_enqueued, (uint64_t)queue.size(), (uint64_t)maxDepth, true);
+        cond.notify_one();
+        return true;
+    }
+    /** Enqueue a work item only if the queue has room. It then never waits or expires. */
+    bool TryEnqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
     {
         LOCK(cs);
         if (!running || queue.size() >= maxDepth) {
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        queue.push_back({std::unique_ptr<WorkItem>(item), SteadyClock::now()});
         cond.notify_one();
         return true;
     }
@@ -111,7 +166,10 @@ public:
                     cond.wait(lock);
                 if (!running && queue.empty())
                     break;
-                i = std::move(queue.front());
+                TRACEPOINT(http, request_dequeued,
+                    (uint64_t)(queue.size() - 1),
+                    int64_t{Ticks<std::chrono::nanoseconds>(SteadyClock::now() - queue.front().enqueued)});
+                i = std::move(queue.front().item);
                 queue.pop_front();
             }
             (*i)();
@@ -139,10 +197,17 @@ struct HTTPPathHandler
 
 /** HTTP module state */
 
-//! libevent event loop
-static struct event_base* eventBase = nullptr;
-//! HTTP server
-static struct evhttp* eventHTTP = nullptr;
+/** An event loop thread with its own evhttp, accepting connections on the shared listening sockets. */
+struct HTTPReactor {
+    struct event_base* base{nullptr};
+    struct evhttp* http{nullptr};
+    //! The listening sockets of this reactor's evhttp
+    std::vector<evhttp_bound_socket*> sockets;
+    std::thread thread;
+};
+
+//! Event loops, the first of which binds the listening sockets
+static std::vector<HTTPReactor> g_http_reactors;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
 //! Work queue for handling longer requests off the event loop thread
@@ -150,8 +215,6 @@ static std::unique_ptr<WorkQueue<HTTPClosure>> g_work_queue{nullptr};
 //! Handlers for (sub)paths
 static GlobalMutex g_httppathhandlers_mutex;
 static std::vector<HTTPPathHandler> pathHandlers GUARDED_BY(g_httppathhandlers_mutex);
-//! Bound listening sockets
-static std::vector<evhttp_bound_socket *> boundSockets;
 
 /**
  * @brief Helps keep track of open `evhttp_connection`s with active `evhttp_requests`
@@ -329,12 +392,17 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
     if (i != iend) {
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
         assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
+        std::vector<std::unique_ptr<HTTPClosure>> expired;
+        if (g_work_queue->Enqueue(item.get(), expired)) {
             item.release(); /* if true, queue took ownership */
         } else {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
             item->req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
         }
+        for (const auto& request : expired) {
+            LogPrintf("WARNING: request rejected after waiting -rpcworkqueuewait for room in the http work queue\n");
+            static_cast<HTTPWorkItem&>(*request).req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
+        }
     } else {
         hreq->WriteReply(HTTP_NOT_FOUND);
     }
@@ -348,9 +416,9 @@ static void http_reject_request_cb(struct evhttp_request* req, void*)
 }
 
 /** Event dispatcher thread */
-static void ThreadHTTP(struct event_base* base)
+static void ThreadHTTP(struct event_base* base, int reactor_num)
 {
-    util::ThreadRename("http");
+    util::ThreadRename(reactor_num == 0 ? std::string{"http"} : strprintf("http.%i", reactor_num));
     LogDebug(BCLog::HTTP, "Entering http event loop\n");
     event_base_dispatch(base);
     // Event loop will be interrupted by InterruptHTTPServer()
@@ -404,12 +472,39 @@ static bool HTTPBindAddresses(struct evhttp* http)
             if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (sockopt_arg_type)&one, sizeof(one)) == SOCKET_ERROR) {
                 LogInfo("WARNING: Unable to set TCP_NODELAY on RPC server socket, continuing anyway\n");
             }
-            boundSockets.push_back(bind_handle);
+            g_http_reactors.front().sockets.push_back(bind_handle);
         } else {
             LogPrintf("Binding RPC on address %s port %i failed.\n", i->first, i->second);
         }
     }
-    return !boundSockets.empty();
+    return !g_http_reactors.front().sockets.empty();
+}
+
+/** Free the reactors of a server that was not started. */
+static void FreeHTTPReactors()
+{
+    // The first reactor last, as it owns the listening sockets.
+    for (auto reactor = g_http_reactors.rbegin(); reactor != g_http_reactors.rend(); ++reactor) {
+        evhttp_free(reactor->http);
+        event_base_free(reactor->base);
+    }
+    g_http_reactors.clear();
+}
+
+/** Let an additional reactor's evhttp accept connections on the sockets bound by the first one. */
+static bool HTTPShareBoundSockets(HTTPReactor& reactor)
+{
+    for (evhttp_bound_socket* bound : g_http_reactors.front().sockets) {
+        // The socket stays owned (and is closed) by the first reactor, and is already listening.
+        evconnlistener* listener{evconnlistener_new(reactor.base, nullptr, nullptr, LEV_OPT_REUSEABLE | LEV_OPT_CLOSE_ON_EXEC, 0, evhttp_bound_socket_get_fd(bound))};
+        evhttp_bound_socket* handle{listener ? evhttp_bind_listener(reactor.http, listener) : nullptr};
+        if (!handle) {
+            if (listener) evconnlistener_free(listener);
+            return false;
+        }
+        reactor.sockets.push_back(handle);
+    }
+    return true;
 }
 
 /** Simple wrapper to set thread name and run work queue */
@@ -456,34 +551,51 @@ bool InitHTTPServer(const util::SignalInterrupt& interrupt)
     evthread_use_pthreads();
 #endif
 
-    raii_event_base base_ctr = obtain_event_base();
+    const int num_reactors{int(std::clamp<int64_t>(gArgs.GetIntArg("-rpcserverthreads", DEFAULT_HTTP_SERVER_THREADS), 1, MAX_HTTP_SERVER_THREADS))};
+    std::vector<std::pair<raii_event_base, raii_evhttp>> reactors;
+    for (int i = 0; i < num_reactors; ++i) {
+        raii_event_base base_ctr = obtain_event_base();
 
-    /* Create a new evhttp object to handle requests. */
-    raii_evhttp http_ctr = obtain_evhttp(base_ctr.get());
-    struct evhttp* http = http_ctr.get();
-    if (!http) {
-        LogPrintf("couldn't create evhttp. Exiting.\n");
-        return false;
-    }
+        /* Create a new evhttp object to handle requests. */
+        raii_evhttp http_ctr = obtain_evhttp(base_ctr.get());
+        struct evhttp* http = http_ctr.get();
+        if (!http) {
+            LogPrintf("couldn't create evhttp. Exiting.\n");
+            return false;
+        }
 
-    evhttp_set_timeout(http, gArgs.GetIntArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT));
-    evhttp_set_max_headers_size(http, MAX_HEADERS_SIZE);
-    evhttp_set_max_body_size(http, MAX_SIZE);
-    evhttp_set_gencb(http, http_request_cb, (void*)&interrupt);
+        evhttp_set_timeout(http, gArgs.GetIntArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT));
+        evhttp_set_max_headers_size(http, MAX_HEADERS_SIZE);
+        evhttp_set_max_body_size(http, MAX_SIZE);
+        evhttp_set_gencb(http, http_request_cb, (void*)&interrupt);
+        reactors.emplace_back(std::move(base_ctr), std::move(http_ctr));
+    }
 
-    if (!HTTPBindAddresses(http)) {
+    // transfer ownership to g_http_reactors via .release()
+    for (auto& [base_ctr, http_ctr] : reactors) {
+        g_http_reactors.emplace_back();
+        g_http_reactors.back().base = base_ctr.release();
+        g_http_reactors.back().http = http_ctr.release();
+    }
+    if (!HTTPBindAddresses(g_http_reactors.front().http)) {
         LogPrintf("Unable to bind any endpoint for RPC server\n");
+        FreeHTTPReactors();
         return false;
     }
+    for (size_t i = 1; i < g_http_reactors.size(); ++i) {
+        if (!HTTPShareBoundSockets(g_http_reactors[i])) {
+            LogPrintf("Unable to share the RPC server sockets between event threads\n");
+            FreeHTTPReactors();
+            return false;
+        }
+    }
 
     LogDebug(BCLog::HTTP, "Initialized HTTP server\n");
     int workQueueDepth = std::max((long)gArgs.GetIntArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogDebug(BCLog::HTTP, "creating work queue of depth %d\n", workQueueDepth);
+    const std::chrono::milliseconds max_wait{std::max<int64_t>(gArgs.GetIntArg("-rpcworkqueuewait", DEFAULT_HTTP_WORKQUEUE_WAIT), 0)};
+    LogDebug(BCLog::HTTP, "creating work queue of depth %d, with requests waiting up to %dms for room\n", workQueueDepth, count_milliseconds(max_wait));
 
-    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth);
-    // transfer ownership to eventBase/HTTP via .release()
-    eventBase = base_ctr.release();
-    eventHTTP = http_ctr.release();
+    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth, max_wait);
     return true;
 }
 
@@ -495,14 +607,15 @@ void UpdateHTTPServerLogging(bool enable) {
     }
 }
 
-static std::thread g_thread_http;
 static std::vector<std::thread> g_thread_http_workers;
 
 void StartHTTPServer()
 {
     int rpcThreads = std::max((long)gArgs.GetIntArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogInfo("Starting HTTP server with %d worker threads\n", rpcThreads);
-    g_thread_http = std::thread(ThreadHTTP, eventBase);
+    LogInfo("Starting HTTP server with %d worker threads and %d event threads\n", rpcThreads, g_http_reactors.size());
+    for (size_t i = 0; i < g_http_reactors.size(); ++i) {
+        g_http_reactors[i].thread = std::thread(ThreadHTTP, g_http_reactors[i].base, int(i));
+    }
 
     for (int i = 0; i < rpcThreads; i++) {
         g_thread_http_workers.emplace_back(HTTPWorkQueueRun, g_work_queue.get(), i);
@@ -512,9 +625,9 @@ void StartHTTPServer()
 void InterruptHTTPServer()
 {
     LogDebug(BCLog::HTTP, "Interrupting HTTP server\n");
-    if (eventHTTP) {
+    for (const HTTPReactor& reactor : g_http_reactors) {
         // Reject requests on current connections
-        evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
+        evhttp_set_gencb(reactor.http, http_reject_request_cb, nullptr);
     }
     if (g_work_queue) {
         g_work_queue->Interrupt();
@@ -533,38 +646,51 @@ void StopHTTPServer()
     }
     // Unlisten sockets, these are what make the event loop running, which means
     // that after this and all connections are closed the event loop will quit.
-    for (evhttp_bound_socket *socket : boundSockets) {
-        evhttp_del_accept_socket(eventHTTP, socket);
+    // Those of the first reactor last, as it owns the sockets.
+    for (auto reactor = g_http_reactors.rbegin(); reactor != g_http_reactors.rend(); ++reactor) {
+        for (evhttp_bound_socket* socket : reactor->sockets) {
+            evhttp_del_accept_socket(reactor->http, socket);
+        }
+        reactor->sockets.clear();
     }
-    boundSockets.clear();
     {
         if (const auto n_connections{g_requests.CountActiveConnections()}; n_connections != 0) {
             LogDebug(BCLog::HTTP, "Waiting for %d connections to stop HTTP server\n", n_connections);
         }
         g_requests.WaitUntilEmpty();
     }
-    if (eventHTTP) {
+    for (HTTPReactor& reactor : g_http_reactors) {
         // Schedule a callback to call evhttp_free in the event base thread, so
         // that evhttp_free does not need to be called again after the handling
         // of unfinished request connections that follows.
-        event_base_once(eventBase, -1, EV_TIMEOUT, [](evutil_socket_t, short, void*) {
-            evhttp_free(eventHTTP);
-            eventHTTP = nullptr;
-        }, nullptr, nullptr);
-    }
-    if (eventBase) {
-        LogDebug(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
-        if (g_thread_http.joinable()) g_thread_http.join();
-        event_base_free(eventBase);
-        eventBase = nullptr;
+        event_base_once(reactor.base, -1, EV_TIMEOUT, [](evutil_socket_t, short, void* http) {
+            evhttp_free(static_cast<struct evhttp*>(http));
+        }, reactor.http, nullptr);
+    }
+    if (!g_http_reactors.empty()) {
+        LogDebug(BCLog::HTTP, "Waiting for HTTP event threads to exit\n");
+        for (HTTPReactor& reactor : g_http_reactors) {
+            if (reactor.thread.joinable()) reactor.thread.join();
+            event_base_free(reactor.base);
+        }
+        g_http_reactors.clear();
     }
     g_work_queue.reset();
     LogDebug(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
+bool HTTPTryEnqueueTask(std::function<void()> task)
+{
+    if (!g_work_queue) return false;
+    auto item{std::make_unique<HTTPTask>(std::move(task))};
+    if (!g_work_queue->TryEnqueue(item.get())) return false;
+    item.release(); // queue took ownership
+    return true;
+}
+
 struct event_base* EventBase()
 {
-    return eventBase;
+    return g_http_reactors.empty() ? nullptr : g_http_reactors.front().base;
 }
 
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
@@ -600,7 +726,9 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrup
 
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (m_chunks && req) {
+        WriteReplyEnd();
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL_SERVER_ERROR, "Unhandled request");
@@ -625,17 +753,12 @@ std::string HTTPRequest::ReadBody()
     if (!buf)
         return "";
     size_t size = evbuffer_get_length(buf);
-    /** Trivial implementation: if this is ever a performance bottleneck,
-     * internal copying can be avoided in multi-segment buffers by using
-     * evbuffer_peek and an awkward loop. Though in that case, it'd be even
-     * better to not copy into an intermediate string but use a stream
-     * abstraction to consume the evbuffer on the fly in the parsing algorithm.
-     */
-    const char* data = (const char*)evbuffer_pullup(buf, size);
-    if (!data) // returns nullptr in case of empty buffer
-        return "";
-    std::string rv(data, size);
-    evbuffer_drain(buf, size);
+    // Copy the (possibly multi-segment) buffer into the string in one go, rather than
+    // first linearizing it with evbuffer_pullup.
+    std::string rv(size, '\0');
+    const auto copied{evbuffer_remove(buf, rv.data(), size)};
+    if (copied < 0) return "";
+    rv.resize(copied);
     return rv;
 }
 
@@ -654,30 +777,140 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
 {
     assert(!replySent && req);
-    if (m_interrupt) {
-        WriteHeader("Connection", "close");
-    }
-    // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
     evbuffer_add(evb, reply.data(), reply.size());
+    SendReply(nStatus);
+}
+
+void HTTPRequest::WriteReplyOwned(int nStatus, std::string&& reply)
+{
+    assert(!replySent && req);
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (!reply.empty()) {
+        // Hand the body over to libevent, which frees it once sent.
+        auto body{std::make_unique<std::string>(std::move(reply))};
+        if (evbuffer_add_reference(evb, body->data(), body->size(), [](const void*, size_t, void* arg) {
+                delete static_cast<std::string*>(arg);
+            }, body.get()) == 0) {
+            body.release();
+        } else {
+            evbuffer_add(evb, body->data(), body->size());
+        }
+    }
+    SendReply(nStatus);
+}
+
+/** Re-enable reading from the socket. This is the second part of the libevent workaround in http_request_cb. */
+static void ReenableReading(evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
+void HTTPRequest::PostToEventThread(std::function<void()> fn)
+{
+    evhttp_connection* conn{evhttp_request_get_connection(req)};
+    struct event_base* base{conn ? evhttp_connection_get_base(conn) : EventBase()};
+    HTTPEvent* ev = new HTTPEvent(base, true, std::move(fn));
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::SendReply(int nStatus)
+{
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    // Send event to the http thread of the connection to send reply message
     auto req_copy = req;
-    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+    PostToEventThread([req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
+        ReenableReading(req_copy);
+    });
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+/** Progress of a chunked reply, shared with the event thread. */
+struct HTTPRequest::ChunkState {
+    Mutex mutex;
+    std::condition_variable cv;
+    //! Bytes handed to the event thread, and those known to be written to the socket.
+    uint64_t posted GUARDED_BY(mutex){0};
+    uint64_t flushed GUARDED_BY(mutex){0};
+    //! Bytes that evhttp has been given, only accessed on the event thread.
+    uint64_t sent{0};
+};
+
+void HTTPRequest::WriteReplyStart(int nStatus)
+{
+    assert(!replySent && req && !m_chunks);
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    m_chunks = std::make_shared<ChunkState>();
+    auto req_copy = req;
+    PostToEventThread([req_copy, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    replySent = true;
+}
+
+void HTTPRequest::WriteReplyChunk(std::string&& chunk)
+{
+    assert(m_chunks && req);
+    if (chunk.empty()) return;
+    {
+        WAIT_LOCK(m_chunks->mutex, lock);
+        const std::chrono::seconds timeout{gArgs.GetIntArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT)};
+        auto deadline{SteadyClock::now() + timeout};
+        uint64_t last_flushed{m_chunks->flushed};
+        while (m_chunks->posted - m_chunks->flushed > MAX_PENDING_CHUNK_BYTES) {
+            if (m_interrupt) throw std::runtime_error("Shutting down");
+            m_chunks->cv.wait_for(lock, std::chrono::milliseconds{100});
+            if (m_chunks->flushed != last_flushed) {
+                last_flushed = m_chunks->flushed;
+                deadline = SteadyClock::now() + timeout;
+            } else if (SteadyClock::now() > deadline) {
+                throw std::runtime_error("Client stopped reading the reply");
             }
         }
+        m_chunks->posted += chunk.size();
+    }
+    auto req_copy = req;
+    PostToEventThread([req_copy, chunks = m_chunks, chunk = std::move(chunk)]() mutable {
+        struct evbuffer* buf{evbuffer_new()};
+        if (!buf) return;
+        evbuffer_add(buf, chunk.data(), chunk.size());
+        chunks->sent += chunk.size();
+        // evhttp calls back once its output buffer is empty, i.e. everything given to it so far
+        // has been written. A callback replaces the one of the previous chunk.
+        evhttp_send_reply_chunk_with_cb(req_copy, buf, [](evhttp_connection*, void* arg) {
+            auto& state{*static_cast<ChunkState*>(arg)};
+            WITH_LOCK(state.mutex, state.flushed = state.sent);
+            state.cv.notify_all();
+        }, chunks.get());
+        evbuffer_free(buf);
+    });
+}
+
+void HTTPRequest::WriteReplyEnd()
+{
+    assert(m_chunks && req);
+    auto req_copy = req;
+    // The state must outlive the callback of the last chunk, which evhttp_send_reply_end replaces.
+    PostToEventThread([req_copy, chunks = m_chunks]{
+        evhttp_send_reply_end(req_copy);
+        ReenableReading(req_copy);
     });
-    ev->trigger(nullptr);
-    replySent = true;
     req = nullptr; // transferred back to main thread
 }
 
@@ -5,10 +5,13 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <concepts>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <utility>
 
 namespace util {
 class SignalInterrupt;
@@ -27,6 +30,16 @@ static const int DEFAULT_HTTP_WORKQUEUE=64;
 
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
+/**
+ * The default value for `-rpcworkqueuewait`, in milliseconds: how long a request may wait
+ * for room in a full work queue before it is rejected. 0 rejects it right away.
+ */
+static const int DEFAULT_HTTP_WORKQUEUE_WAIT{0};
+
+/** The default value for `-rpcserverthreads`, the number of event threads accepting HTTP connections. */
+static const int DEFAULT_HTTP_SERVER_THREADS{1};
+static const int MAX_HTTP_SERVER_THREADS{16};
+
 struct evhttp_request;
 struct event_base;
 class CService;
@@ -59,6 +72,12 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Run a task on an HTTP worker thread, if the work queue has room for it.
+ * Returns false (and drops the task) when the queue is full or the server is
+ * shutting down.
+ */
+bool HTTPTryEnqueueTask(std::function<void()> task);
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -143,6 +162,42 @@ public:
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+    /** Write HTTP reply, handing the body over to the event thread without copying it. */
+    template <typename T>
+        requires std::same_as<T, std::string>
+    void WriteReply(int nStatus, T&& reply)
+    {
+        WriteReplyOwned(nStatus, std::move(reply));
+    }
+
+    /**
+     * Start a reply with chunked transfer encoding, for a body that is written
+     * incrementally with WriteReplyChunk() and completed with WriteReplyEnd().
+     *
+     * @note Replaces WriteReply(); call WriteHeader() before.
+     */
+    void WriteReplyStart(int nStatus);
+    /**
+     * Send a chunk of a reply started with WriteReplyStart(). Waits for the
+     * client to read earlier chunks while more than MAX_PENDING_CHUNK_BYTES are
+     * unsent, so that a slow client bounds the memory used for the reply.
+     *
+     * @throws std::runtime_error if the client does not read for -rpcservertimeout
+     */
+    void WriteReplyChunk(std::string&& chunk);
+    /** Complete a reply started with WriteReplyStart(). */
+    void WriteReplyEnd();
+
+    static constexpr size_t MAX_PENDING_CHUNK_BYTES{1 << 20};
+
+private:
+    struct ChunkState;
+    std::shared_ptr<ChunkState> m_chunks;
+
+    void WriteReplyOwned(int nStatus, std::string&& reply);
+    void SendReply(int nStatus);
+    /** Run `fn` on the event thread of the request's connection. */
+    void PostToEventThread(std::function<void()> fn);
 };
 
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
@@ -5,9 +5,11 @@
 #include <chainparams.h>
 #include <common/args.h>
 #include <index/base.h>
+#include <index/blockcache.h>
 #include <interfaces/chain.h>
 #include <kernel/chain.h>
 #include <logging.h>
+#include <logging/timer.h>
 #include <node/abort.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -15,12 +17,19 @@
 #include <node/interface_ui.h>
 #include <tinyformat.h>
 #include <undo.h>
+#include <util/metrics.h>
 #include <util/string.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
+#include <util/time.h>
+#include <util/trace.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <any>
 #include <chrono>
+#include <deque>
+#include <future>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -28,10 +37,15 @@
 #include <thread>
 #include <utility>
 
+TRACEPOINT_SEMAPHORE(index, commit);
+
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Longest pause of the initial sync for a new tip block, in case it turns out invalid and is never connected.
+constexpr auto MAX_TIP_BLOCK_PAUSE{10s};
+constexpr auto TIP_BLOCK_POLL_INTERVAL{50ms};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -56,7 +70,8 @@ BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool
         .memory_only = f_memory,
         .wipe_data = f_wipe,
         .obfuscate = f_obfuscate,
-        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }()}}
+        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }(),
+        .tuning = DB_TUNING_APPEND}}
 {}
 
 bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
@@ -74,7 +89,8 @@ void BaseIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator
 }
 
 BaseIndex::BaseIndex(std::unique_ptr<interfaces::Chain> chain, std::string name)
-    : m_chain{std::move(chain)}, m_name{std::move(name)} {}
+    : m_chain{std::move(chain)}, m_name{std::move(name)},
+      m_height_metric{metrics::GetRegistry().GetGauge("bitcoin_index_height", "Height of the best block of each index", {{"index", m_name}})} {}
 
 BaseIndex::~BaseIndex()
 {
@@ -149,45 +165,124 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
-bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data)
+struct BaseIndex::PreparedBlock {
+    const CBlockIndex* pindex;
+    interfaces::BlockInfo info;
+    std::shared_ptr<const CBlock> block;
+    std::shared_ptr<const CBlockUndo> block_undo;
+    std::any data;
+    //! Whether reading the block from disk succeeded.
+    bool ok{false};
+
+    explicit PreparedBlock(const CBlockIndex* index) : pindex{index}, info{kernel::MakeBlockInfo(index)} {}
+    PreparedBlock(const PreparedBlock&) = delete;
+    PreparedBlock& operator=(const PreparedBlock&) = delete;
+};
+
+bool BaseIndex::PrepareBlock(PreparedBlock& prepared, const CBlock* block_data)
 {
-    interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block_data);
-
-    CBlock block;
-    if (!block_data) { // disk lookup if block data wasn't provided
-        if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
-            FatalErrorf("Failed to read block %s from disk",
-                        pindex->GetBlockHash().ToString());
+    const CBlockIndex* pindex{prepared.pindex};
+    node::BlockManager& blockman{m_chainstate->m_blockman};
+    if (block_data) {
+        prepared.info.data = block_data;
+    } else { // disk lookup if block data wasn't provided
+        if (m_block_cache) {
+            prepared.block = m_block_cache->GetBlock(blockman, *pindex);
+        } else if (auto block{std::make_shared<CBlock>()}; blockman.ReadBlock(*block, *pindex)) {
+            prepared.block = std::move(block);
+        }
+        if (!prepared.block) {
+            LogError("Failed to read block %s from disk", pindex->GetBlockHash().ToString());
             return false;
         }
-        block_info.data = &block;
+        prepared.info.data = prepared.block.get();
     }
 
-    CBlockUndo block_undo;
     if (CustomOptions().connect_undo_data) {
-        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
-            FatalErrorf("Failed to read undo block data %s from disk",
-                        pindex->GetBlockHash().ToString());
+        if (pindex->nHeight == 0) {
+            prepared.block_undo = std::make_shared<CBlockUndo>();
+        } else if (m_block_cache && !block_data) {
+            prepared.block_undo = m_block_cache->GetBlockUndo(blockman, *pindex);
+        } else if (auto block_undo{std::make_shared<CBlockUndo>()}; blockman.ReadBlockUndo(*block_undo, *pindex)) {
+            prepared.block_undo = std::move(block_undo);
+        }
+        if (!prepared.block_undo) {
+            LogError("Failed to read undo block data %s from disk", pindex->GetBlockHash().ToString());
             return false;
         }
-        block_info.undo_data = &block_undo;
+        prepared.info.undo_data = prepared.block_undo.get();
     }
 
-    if (!CustomAppend(block_info)) {
+    prepared.data = CustomPrepare(prepared.info);
+    prepared.ok = true;
+    return true;
+}
+
+bool BaseIndex::AppendBlock(PreparedBlock& prepared)
+{
+    if (!prepared.ok) {
+        FatalErrorf("Failed to read block %s from disk",
+                    prepared.pindex->GetBlockHash().ToString());
+        return false;
+    }
+    if (!CustomAppendPrepared(prepared.info, std::move(prepared.data))) {
         FatalErrorf("Failed to write block %s to index database",
-                    pindex->GetBlockHash().ToString());
+                    prepared.pindex->GetBlockHash().ToString());
         return false;
     }
-
     return true;
 }
 
+void BaseIndex::ThrottleSync(const PreparedBlock& prepared, std::chrono::microseconds busy)
+{
+    // Leave the disk and CPU to the validation of a new block at the tip.
+    while (!m_interrupt) {
+        const auto received{m_tip_block_received.load()};
+        if (received == std::chrono::steady_clock::time_point{} ||
+            std::chrono::steady_clock::now() > received + MAX_TIP_BLOCK_PAUSE) break;
+        if (!m_interrupt.sleep_for(TIP_BLOCK_POLL_INTERVAL)) break;
+    }
+
+    if (!m_throttle.Enabled()) return;
+    uint64_t bytes_read{0};
+    if (m_throttle.LimitsReads()) {
+        if (prepared.block) bytes_read += ::GetSerializeSize(TX_WITH_WITNESS(*prepared.block));
+        if (prepared.block_undo) bytes_read += ::GetSerializeSize(*prepared.block_undo);
+    }
+    if (const auto pause{m_throttle.Account(bytes_read, busy)}; pause > 0us) {
+        m_interrupt.sleep_for(pause);
+    }
+}
+
+bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data)
+{
+    PreparedBlock prepared{pindex};
+    PrepareBlock(prepared, block_data);
+    return AppendBlock(prepared);
+}
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
+
+        // Have the other indexes syncing at the same time keep the blocks they
+        // read for this one, and the other way around.
+        const bool need_undo{CustomOptions().connect_undo_data};
+        if (m_block_cache) m_block_cache->AddReader(need_undo);
+        const auto remove_reader{[need_undo](IndexBlockCache* cache) { cache->RemoveReader(need_undo); }};
+        const std::unique_ptr<IndexBlockCache, decltype(remove_reader)> cache_reader{m_block_cache.get(), remove_reader};
+
+        // Blocks after pindex are read and prepared by the workers, while this
+        // thread appends them one by one in chain order.
+        ThreadPool pool{"idxsync"};
+        if (m_sync_threads > 1) pool.Start(m_sync_threads);
+        const size_t max_ahead{2 * pool.WorkersCount()};
+        std::deque<std::future<std::unique_ptr<PreparedBlock>>> ahead;
+        const CBlockIndex* pindex_ahead{pindex};
+
         while (true) {
             if (m_interrupt) {
                 LogInfo("%s: m_interrupt set; exiting ThreadSync", GetName());
@@ -200,6 +295,17 @@ void BaseIndex::Sync()
                 return;
             }
 
+            while (ahead.size() < max_ahead) {
+                const CBlockIndex* next{WITH_LOCK(cs_main, return NextSyncBlock(pindex_ahead, m_chainstate->m_chain))};
+                if (!next) break;
+                ahead.push_back(pool.Submit([this, next] {
+                    auto prepared{std::make_unique<PreparedBlock>(next)};
+                    PrepareBlock(*prepared);
+                    return prepared;
+                }));
+                pindex_ahead = next;
+            }
+
             const CBlockIndex* pindex_next = WITH_LOCK(cs_main, return NextSyncBlock(pindex, m_chainstate->m_chain));
             // If pindex_next is null, it means pindex is the chain tip, so
             // commit data indexed so far.
@@ -226,10 +332,25 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
-
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            const auto block_start{std::chrono::steady_clock::now()};
+            std::unique_ptr<PreparedBlock> prepared;
+            if (!ahead.empty()) {
+                prepared = ahead.front().get();
+                ahead.pop_front();
+            }
+            if (!prepared || prepared->pindex != pindex) {
+                // The blocks read ahead are not on the chain anymore (or none
+                // were), so drop them and continue from this block.
+                ahead.clear();
+                pindex_ahead = pindex;
+                prepared = std::make_unique<PreparedBlock>(pindex);
+                PrepareBlock(*prepared);
+            }
+            if (!AppendBlock(*prepared)) return; // error logged internally
 
             auto current_time{std::chrono::steady_clock::now()};
+            ThrottleSync(*prepared, std::chrono::duration_cast<std::chrono::microseconds>(current_time - block_start));
+            current_time = std::chrono::steady_clock::now();
             if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
                 LogInfo("Syncing %s with block chain from height %d",
                           GetName(), pindex->nHeight);
@@ -254,6 +375,8 @@ void BaseIndex::Sync()
 
 bool BaseIndex::Commit()
 {
+    TIME_SCOPE("IndexCommit");
+    [[maybe_unused]] const auto time_start{SteadyClock::now()};
     // Don't commit anything if we haven't indexed any block yet
     // (this could happen if init is interrupted).
     bool ok = m_best_block_index != nullptr;
@@ -262,7 +385,14 @@ bool BaseIndex::Commit()
         ok = CustomCommit(batch);
         if (ok) {
             GetDB().WriteBestBlock(batch, GetLocator(*m_chain, m_best_block_index.load()->GetBlockHash()));
+            [[maybe_unused]] const size_t batch_size{batch.ApproximateSize()};
             ok = GetDB().WriteBatch(batch);
+            TRACEPOINT(index, commit,
+                GetName().c_str(),
+                m_best_block_index.load()->nHeight,
+                (uint64_t)batch_size,
+                int64_t{Ticks<std::chrono::nanoseconds>(SteadyClock::now() - time_start)},
+                ok);
         }
     }
     if (!ok) {
@@ -316,8 +446,16 @@ bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_ti
     return true;
 }
 
+void BaseIndex::NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block)
+{
+    // Only signaled for blocks extending the tip outside of IBD.
+    if (!m_synced) m_tip_block_received = std::chrono::steady_clock::now();
+}
+
 void BaseIndex::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
 {
+    m_tip_block_received = std::chrono::steady_clock::time_point{};
+
     // Ignore events from the assumed-valid chain; we will process its blocks
     // (sequentially) after it is fully verified by the background chainstate. This
     // is to avoid any out-of-order indexing.
@@ -488,6 +626,8 @@ void BaseIndex::SetBestBlockIndex(const CBlockIndex* block)
         WITH_LOCK(::cs_main, m_chainstate->m_blockman.UpdatePruneLock(GetName(), prune_lock));
     }
 
+    m_height_metric.Set(block ? block->nHeight : -1);
+
     // Intentionally set m_best_block_index as the last step in this function,
     // after updating prune locks above, and after making any other references
     // to *this, so the BlockUntilSyncedToCurrentChain function (which checks
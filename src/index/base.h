@@ -10,17 +10,35 @@
 #include <interfaces/types.h>
 #include <util/string.h>
 #include <util/threadinterrupt.h>
+#include <util/throttle.h>
 #include <validationinterface.h>
 
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <utility>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class IndexBlockCache;
 class ChainstateManager;
 namespace interfaces {
 class Chain;
 } // namespace interfaces
+namespace metrics {
+class Gauge;
+} // namespace metrics
+
+/** Number of threads reading and preparing blocks while an index catches up with the chain (0 = auto). */
+static constexpr int DEFAULT_INDEX_SYNC_THREADS{0};
+static constexpr int MAX_INDEX_SYNC_THREADS{16};
+/** Rate in MiB/s at which an index reads blocks while catching up with the chain (0 = unlimited). */
+static constexpr int64_t DEFAULT_INDEX_SYNC_READ_RATE{0};
+/** Share of the time in percent an index spends working while catching up with the chain. */
+static constexpr int DEFAULT_INDEX_SYNC_CPU_SHARE{100};
 
 struct IndexSummary {
     std::string name;
@@ -80,6 +98,23 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Number of threads used by Sync() to read and prepare blocks ahead of the
+    /// one being appended. With one, everything happens on the sync thread.
+    int m_sync_threads{1};
+
+    /// Blocks read during the initial sync, shared with the other indexes.
+    std::shared_ptr<IndexBlockCache> m_block_cache;
+
+    /// Budget of the initial sync.
+    Throttle m_throttle{0, 100};
+
+    /// When a new block extending the tip was received, until it is
+    /// connected. The initial sync pauses in the meantime.
+    std::atomic<std::chrono::steady_clock::time_point> m_tip_block_received{};
+
+    /// A block read from disk along with the result of CustomPrepare().
+    struct PreparedBlock;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -95,6 +130,17 @@ private:
 
     bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
 
+    /// Read the block (unless block_data is given) and its undo data if needed,
+    /// and call CustomPrepare. Safe to call from any thread.
+    bool PrepareBlock(PreparedBlock& prepared, const CBlock* block_data = nullptr);
+
+    /// Pass a prepared block to CustomAppendPrepared.
+    bool AppendBlock(PreparedBlock& prepared);
+
+    /// Pause the initial sync while a new tip block is validated, and as long
+    /// as m_throttle requires after a block took `busy` to index.
+    void ThrottleSync(const PreparedBlock& prepared, std::chrono::microseconds busy);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -104,11 +150,17 @@ protected:
     std::unique_ptr<interfaces::Chain> m_chain;
     Chainstate* m_chainstate{nullptr};
     const std::string m_name;
+    //! Height of the best block of the index, served as a metric.
+    metrics::Gauge& m_height_metric;
+
+    void NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block) override;
 
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
 
     void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override;
 
+    std::string SubscriberName() const override { return m_name; }
+
     /// Return custom notification options for index.
     [[nodiscard]] virtual interfaces::Chain::NotifyOptions CustomOptions() { return {}; }
 
@@ -118,6 +170,16 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Do the part of the work for a block that does not depend on the blocks
+    /// before it, e.g. compute the entries to write. During the initial sync,
+    /// this is called on worker threads for blocks ahead of the one being
+    /// appended, so it must not touch any mutable state of the index.
+    [[nodiscard]] virtual std::any CustomPrepare(const interfaces::BlockInfo& block) const { return {}; }
+
+    /// Write index entries for a newly connected block, given the result of
+    /// CustomPrepare for it. Blocks are always appended in chain order.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -151,6 +213,19 @@ public:
     /// validation interface so that it stays in sync with blockchain updates.
     [[nodiscard]] bool Init();
 
+    /// Set the number of threads reading and preparing blocks during the
+    /// initial sync. Must be called before StartBackgroundSync.
+    void SetSyncThreads(int threads) { m_sync_threads = threads; }
+
+    /// Share the blocks read during the initial sync with the other indexes
+    /// using the same cache. Must be called before StartBackgroundSync.
+    void SetBlockCache(std::shared_ptr<IndexBlockCache> cache) { m_block_cache = std::move(cache); }
+    const IndexBlockCache* GetBlockCache() const { return m_block_cache.get(); }
+
+    /// Limit the read rate and CPU share of the initial sync. Must be called
+    /// before StartBackgroundSync.
+    void SetSyncThrottle(const Throttle& throttle) { m_throttle = throttle; }
+
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
@@ -166,6 +241,12 @@ public:
 
     /// Get a summary of the index and its state.
     IndexSummary GetSummary() const;
+
+    /// Get statistics of the index database.
+    DBStats GetDBStats() const { return GetDB().GetStats(); }
+
+    /// Get the approximate memory used by the index database.
+    size_t GetDBMemoryUsage() const { return GetDB().DynamicMemoryUsage(); }
 };
 
 #endif // BITCOIN_INDEX_BASE_H
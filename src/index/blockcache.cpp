@@ -0,0 +1,116 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockcache.h>
+
+#include <chain.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <undo.h>
+
+#include <utility>
+
+void IndexBlockCache::AddReader(bool undo)
+{
+    LOCK(m_mutex);
+    ++m_blocks.readers;
+    if (undo) ++m_undos.readers;
+}
+
+void IndexBlockCache::RemoveReader(bool undo)
+{
+    LOCK(m_mutex);
+    // Entries kept for an index that stopped syncing would only be evicted
+    // once the cache is full, and nothing is worth keeping for a single reader.
+    if (--m_blocks.readers < 2) Clear(m_blocks);
+    if (undo && --m_undos.readers < 2) Clear(m_undos);
+}
+
+template <typename T>
+void IndexBlockCache::Clear(Shelf<T>& shelf)
+{
+    AssertLockHeld(m_mutex);
+    for (const auto& [_, entry] : shelf.entries) m_bytes -= entry.bytes;
+    shelf.entries.clear();
+    shelf.order.clear();
+}
+
+void IndexBlockCache::Trim()
+{
+    AssertLockHeld(m_mutex);
+    const auto evict_oldest{[&](auto& shelf) {
+        while (!shelf.order.empty()) {
+            auto it{shelf.entries.find(shelf.order.front())};
+            shelf.order.pop_front();
+            if (it != shelf.entries.end()) {
+                m_bytes -= it->second.bytes;
+                shelf.entries.erase(it);
+                return;
+            }
+        }
+    }};
+    while (m_bytes > m_max_bytes) {
+        // Blocks take more space than their undo data, so when both hold
+        // entries, start with the blocks.
+        if (!m_blocks.entries.empty()) {
+            evict_oldest(m_blocks);
+        } else {
+            evict_oldest(m_undos);
+        }
+    }
+}
+
+template <typename T, typename Read>
+std::shared_ptr<const T> IndexBlockCache::Get(Shelf<T> IndexBlockCache::*shelf_member, const uint256& hash, Read read)
+{
+    {
+        LOCK(m_mutex);
+        Shelf<T>& shelf{this->*shelf_member};
+        auto it{shelf.entries.find(hash)};
+        if (it != shelf.entries.end()) {
+            ++m_hits;
+            auto data{it->second.data};
+            if (--it->second.takes_left == 0) {
+                m_bytes -= it->second.bytes;
+                shelf.entries.erase(it);
+            }
+            return data;
+        }
+    }
+
+    auto [data, bytes]{read()};
+    if (!data) return nullptr;
+
+    LOCK(m_mutex);
+    Shelf<T>& shelf{this->*shelf_member};
+    // Keep it for the other readers, unless one of them was faster.
+    if (shelf.readers > 1 && bytes <= m_max_bytes && !shelf.entries.contains(hash)) {
+        shelf.entries.emplace(hash, typename Shelf<T>::Entry{data, bytes, shelf.readers - 1});
+        shelf.order.push_back(hash);
+        m_bytes += bytes;
+        Trim();
+    }
+    return data;
+}
+
+std::shared_ptr<const CBlock> IndexBlockCache::GetBlock(const node::BlockManager& blockman, const CBlockIndex& index)
+{
+    return Get(&IndexBlockCache::m_blocks, index.GetBlockHash(), [&]() -> std::pair<std::shared_ptr<const CBlock>, size_t> {
+        auto block{std::make_shared<CBlock>()};
+        if (!blockman.ReadBlock(*block, index)) return {};
+        const size_t bytes{::GetSerializeSize(TX_WITH_WITNESS(*block))};
+        return {std::move(block), bytes};
+    });
+}
+
+std::shared_ptr<const CBlockUndo> IndexBlockCache::GetBlockUndo(const node::BlockManager& blockman, const CBlockIndex& index)
+{
+    return Get(&IndexBlockCache::m_undos, index.GetBlockHash(), [&]() -> std::pair<std::shared_ptr<const CBlockUndo>, size_t> {
+        auto block_undo{std::make_shared<CBlockUndo>()};
+        if (!blockman.ReadBlockUndo(*block_undo, index)) return {};
+        const size_t bytes{::GetSerializeSize(*block_undo)};
+        return {std::move(block_undo), bytes};
+    });
+}
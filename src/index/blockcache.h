@@ -0,0 +1,84 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKCACHE_H
+#define BITCOIN_INDEX_BLOCKCACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+namespace node {
+class BlockManager;
+} // namespace node
+
+/** Memory used by the blocks and undo data kept for indexes that have yet to process them. */
+static constexpr size_t DEFAULT_INDEX_BLOCK_CACHE_BYTES{64 << 20};
+
+/**
+ * Blocks and undo data read from disk by an index catching up with the chain,
+ * kept for the other indexes syncing at the same time, so that together they
+ * read and deserialize every block only once.
+ *
+ * Each index registers as a reader while it syncs. An entry is dropped as soon
+ * as all other readers took it, or, oldest first, when the cache grows beyond
+ * its size limit, e.g. because one of the indexes is far behind the others.
+ */
+class IndexBlockCache
+{
+public:
+    explicit IndexBlockCache(size_t max_bytes = DEFAULT_INDEX_BLOCK_CACHE_BYTES) : m_max_bytes{max_bytes} {}
+
+    /** Register a syncing index, which will read blocks, and undo data if undo is set. */
+    void AddReader(bool undo) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void RemoveReader(bool undo) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Get a block from the cache, or read it from disk. Returns null if reading fails. */
+    std::shared_ptr<const CBlock> GetBlock(const node::BlockManager& blockman, const CBlockIndex& index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Get the undo data of a block from the cache, or read it from disk. Returns null if reading fails. */
+    std::shared_ptr<const CBlockUndo> GetBlockUndo(const node::BlockManager& blockman, const CBlockIndex& index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Number of requests served from the cache. */
+    uint64_t Hits() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_hits); }
+    /** Memory used by the entries in the cache, as their serialized size. */
+    size_t Bytes() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_bytes); }
+
+private:
+    template <typename T>
+    struct Shelf {
+        struct Entry {
+            std::shared_ptr<const T> data;
+            size_t bytes;
+            //! Number of readers that are still expected to take the entry.
+            int takes_left;
+        };
+        std::map<uint256, Entry> entries;
+        //! Hashes in insertion order, for eviction. May contain hashes of entries already taken.
+        std::deque<uint256> order;
+        int readers{0};
+    };
+
+    template <typename T, typename Read>
+    std::shared_ptr<const T> Get(Shelf<T> IndexBlockCache::*shelf, const uint256& hash, Read read) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    template <typename T>
+    void Clear(Shelf<T>& shelf) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Trim() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const size_t m_max_bytes;
+    mutable Mutex m_mutex;
+    Shelf<CBlock> m_blocks GUARDED_BY(m_mutex);
+    Shelf<CBlockUndo> m_undos GUARDED_BY(m_mutex);
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+};
+
+#endif // BITCOIN_INDEX_BLOCKCACHE_H
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
 #include <map>
 
 #include <clientversion.h>
@@ -145,6 +146,26 @@ bool BlockFilterIndex::CustomInit(const std::optional<interfaces::BlockRef>& blo
         m_last_header = *op_last_header;
     }
 
+    // Load the filter hashes and headers of the index's chain into memory.
+    LOCK(m_cs_headers_cache);
+    m_chain_entries.clear();
+    m_recent_filters.clear();
+    if (block) {
+        m_chain_entries.reserve(block->height + 1);
+        std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+        db_it->Seek(DBHeightKey(0));
+        for (int height = 0; height <= block->height; ++height) {
+            DBHeightKey key(height);
+            std::pair<uint256, DBVal> value;
+            if (!db_it->Valid() || !db_it->GetKey(key) || key.height != height || !db_it->GetValue(value)) {
+                LogError("unable to read value in %s at key (%c, %d)", GetName(), DB_BLOCK_HEIGHT, height);
+                return false;
+            }
+            m_chain_entries.push_back({value.first, value.second.hash, value.second.header});
+            db_it->Next();
+        }
+    }
+
     return true;
 }
 
@@ -271,15 +292,59 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
-bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::any BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
-    BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    return BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    BlockFilter filter{std::move(*Assert(std::any_cast<BlockFilter>(&prepared)))};
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
-    if (res) m_last_header = header; // update last header
+    if (res) {
+        m_last_header = header; // update last header
+
+        LOCK(m_cs_headers_cache);
+        TruncateChainEntries(block.height);
+        if (m_chain_entries.size() == size_t(block.height)) {
+            m_chain_entries.push_back({block.hash, filter.GetHash(), header});
+            m_recent_filters.push_back(std::move(filter));
+            if (m_recent_filters.size() > CF_RECENT_FILTERS_CACHE_SZ) m_recent_filters.pop_front();
+        }
+    }
     return res;
 }
 
+void BlockFilterIndex::TruncateChainEntries(int height)
+{
+    AssertLockHeld(m_cs_headers_cache);
+    while (m_chain_entries.size() > size_t(height)) {
+        // m_recent_filters holds the filters of the last entries.
+        if (!m_recent_filters.empty()) m_recent_filters.pop_back();
+        m_chain_entries.pop_back();
+    }
+}
+
+const BlockFilterIndex::ChainEntry* BlockFilterIndex::FindChainEntry(const CBlockIndex* block_index) const
+{
+    AssertLockHeld(m_cs_headers_cache);
+    const size_t height{size_t(block_index->nHeight)};
+    if (height >= m_chain_entries.size() || m_chain_entries[height].block_hash != block_index->GetBlockHash()) {
+        return nullptr;
+    }
+    return &m_chain_entries[height];
+}
+
+const BlockFilter* BlockFilterIndex::FindRecentFilter(const CBlockIndex* block_index) const
+{
+    AssertLockHeld(m_cs_headers_cache);
+    if (!FindChainEntry(block_index)) return nullptr;
+    const size_t first_height{m_chain_entries.size() - m_recent_filters.size()};
+    if (size_t(block_index->nHeight) < first_height) return nullptr;
+    return &m_recent_filters[block_index->nHeight - first_height];
+}
+
 bool BlockFilterIndex::Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header)
 {
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
@@ -342,6 +407,9 @@ bool BlockFilterIndex::CustomRemove(const interfaces::BlockInfo& block)
 
     // Update cached header to the previous block hash
     m_last_header = *Assert(ReadFilterHeader(block.height - 1, *Assert(block.prev_hash)));
+
+    LOCK(m_cs_headers_cache);
+    TruncateChainEntries(block.height);
     return true;
 }
 
@@ -424,6 +492,14 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
 
 bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
 {
+    {
+        LOCK(m_cs_headers_cache);
+        if (const BlockFilter* filter = FindRecentFilter(block_index)) {
+            filter_out = *filter;
+            return true;
+        }
+    }
+
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
@@ -436,6 +512,11 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint25
 {
     LOCK(m_cs_headers_cache);
 
+    if (const ChainEntry* chain_entry = FindChainEntry(block_index)) {
+        header_out = chain_entry->filter_header;
+        return true;
+    }
+
     bool is_checkpoint{block_index->nHeight % CFCHECKPT_INTERVAL == 0};
 
     if (is_checkpoint) {
@@ -465,19 +546,39 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint25
 bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* stop_index,
                                          std::vector<BlockFilter>& filters_out) const
 {
-    std::vector<DBVal> entries;
-    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
-        return false;
+    // Take the filters of the recent blocks on the index's chain from memory, and read only the
+    // others from disk.
+    std::vector<BlockFilter> recent_filters;
+    const CBlockIndex* disk_stop_index{stop_index};
+    {
+        LOCK(m_cs_headers_cache);
+        if (start_height >= 0 && start_height <= stop_index->nHeight && FindChainEntry(stop_index)) {
+            const int recent_start{int(m_chain_entries.size() - m_recent_filters.size())};
+            const int first_recent{std::clamp(recent_start, start_height, stop_index->nHeight + 1)};
+            for (int height = first_recent; height <= stop_index->nHeight; ++height) {
+                recent_filters.push_back(m_recent_filters[height - recent_start]);
+            }
+            disk_stop_index = first_recent > start_height ? stop_index->GetAncestor(first_recent - 1) : nullptr;
+        }
     }
 
-    filters_out.resize(entries.size());
-    auto filter_pos_it = filters_out.begin();
-    for (const auto& entry : entries) {
-        if (!ReadFilterFromDisk(entry.pos, entry.hash, *filter_pos_it)) {
+    filters_out.clear();
+    if (disk_stop_index) {
+        std::vector<DBVal> entries;
+        if (!LookupRange(*m_db, m_name, start_height, disk_stop_index, entries)) {
             return false;
         }
-        ++filter_pos_it;
+
+        filters_out.resize(entries.size());
+        auto filter_pos_it = filters_out.begin();
+        for (const auto& entry : entries) {
+            if (!ReadFilterFromDisk(entry.pos, entry.hash, *filter_pos_it)) {
+                return false;
+            }
+            ++filter_pos_it;
+        }
     }
+    filters_out.insert(filters_out.end(), std::make_move_iterator(recent_filters.begin()), std::make_move_iterator(recent_filters.end()));
 
     return true;
 }
@@ -486,6 +587,18 @@ bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex
                                              std::vector<uint256>& hashes_out) const
 
 {
+    {
+        LOCK(m_cs_headers_cache);
+        if (start_height >= 0 && start_height <= stop_index->nHeight && FindChainEntry(stop_index)) {
+            hashes_out.clear();
+            hashes_out.reserve(stop_index->nHeight - start_height + 1);
+            for (int height = start_height; height <= stop_index->nHeight; ++height) {
+                hashes_out.push_back(m_chain_entries[height].filter_hash);
+            }
+            return true;
+        }
+    }
+
     std::vector<DBVal> entries;
     if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
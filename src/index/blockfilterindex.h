@@ -12,13 +12,18 @@
 #include <index/base.h>
 #include <util/hasher.h>
 
+#include <deque>
 #include <unordered_map>
+#include <vector>
 
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
+/** Number of most recent filters kept in memory, as those are requested most by light clients. */
+static constexpr size_t CF_RECENT_FILTERS_CACHE_SZ{1000};
+
 /**
  * BlockFilterIndex is used to store and retrieve block filters, hashes, and headers for a range of
  * blocks by height. An index is constructed for each supported filter type with its own database
@@ -38,10 +43,28 @@ private:
     bool ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const;
     size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter);
 
-    Mutex m_cs_headers_cache;
+    mutable Mutex m_cs_headers_cache;
     /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
     std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
+    struct ChainEntry {
+        uint256 block_hash;
+        uint256 filter_hash;
+        uint256 filter_header;
+    };
+    /** Filter hash and header of every block on the index's chain, by height, so that getcfheaders
+     *  and getcfcheckpt requests for that chain are served without disk access. */
+    std::vector<ChainEntry> m_chain_entries GUARDED_BY(m_cs_headers_cache);
+    /** Filters of the last blocks of m_chain_entries, the oldest first. */
+    std::deque<BlockFilter> m_recent_filters GUARDED_BY(m_cs_headers_cache);
+
+    /** The entry for a block if it is on the index's chain, or nullptr. */
+    const ChainEntry* FindChainEntry(const CBlockIndex* block_index) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_headers_cache);
+    /** The cached filter for a block if it is on the index's chain and recent enough, or nullptr. */
+    const BlockFilter* FindRecentFilter(const CBlockIndex* block_index) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_headers_cache);
+    /** Drop the cached data of all blocks at or above the given height. */
+    void TruncateChainEntries(int height) EXCLUSIVE_LOCKS_REQUIRED(m_cs_headers_cache);
+
     // Last computed header to avoid disk reads on every new block.
     uint256 m_last_header{};
 
@@ -58,7 +81,9 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
 
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
@@ -72,18 +97,18 @@ public:
     BlockFilterType GetFilterType() const { return m_filter_type; }
 
     /** Get a single filter by block. */
-    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const;
+    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a single filter header by block. */
     bool LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a range of filters between two heights on a chain. */
     bool LookupFilterRange(int start_height, const CBlockIndex* stop_index,
-                           std::vector<BlockFilter>& filters_out) const;
+                           std::vector<BlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a range of filter hashes between two heights on a chain. */
     bool LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
-                               std::vector<uint256>& hashes_out) const;
+                               std::vector<uint256>& hashes_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 };
 
 /**
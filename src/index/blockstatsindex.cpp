@@ -0,0 +1,60 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockstatsindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <sync.h>
+#include <undo.h>
+#include <util/check.h>
+#include <validation.h>
+
+using node::BlockStats;
+
+static constexpr uint8_t DB_BLOCK_STATS{'s'};
+
+std::unique_ptr<BlockStatsIndex> g_block_stats_index;
+
+BlockStatsIndex::BlockStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "blockstatsindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "blockstats"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+interfaces::Chain::NotifyOptions BlockStatsIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    return options;
+}
+
+bool BlockStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    assert(block.data);
+    const CBlockIndex* index{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash))};
+    if (!index) {
+        LogError("block %s not found in the block index", block.hash.ToString());
+        return false;
+    }
+    const CBlockUndo& block_undo{*Assert(block.undo_data)};
+    if (block_undo.vtxundo.size() + 1 != block.data->vtx.size()) {
+        LogError("undo data of block %s does not match its transactions", block.hash.ToString());
+        return false;
+    }
+    return m_db->Write(std::make_pair(DB_BLOCK_STATS, block.hash), node::ComputeBlockStats(*block.data, block_undo, *index));
+}
+
+std::optional<BlockStats> BlockStatsIndex::LookUpStats(const CBlockIndex& block_index) const
+{
+    BlockStats stats;
+    if (!m_db->Read(std::make_pair(DB_BLOCK_STATS, block_index.GetBlockHash()), stats)) return std::nullopt;
+    return stats;
+}
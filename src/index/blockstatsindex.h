@@ -0,0 +1,51 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKSTATSINDEX_H
+#define BITCOIN_INDEX_BLOCKSTATSINDEX_H
+
+#include <index/base.h>
+#include <node/blockstats.h>
+
+#include <optional>
+
+class CBlockIndex;
+
+static constexpr bool DEFAULT_BLOCKSTATSINDEX{false};
+
+/**
+ * BlockStatsIndex stores the statistics reported by getblockstats for every
+ * block, so that they can be returned without reading the block and its undo
+ * data from disk again.
+ *
+ * The statistics are keyed by block hash. As they only depend on the block
+ * itself, the entries of blocks that are disconnected in a reorg remain valid
+ * and are simply kept.
+ */
+class BlockStatsIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit BlockStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the statistics of a block. Returns nullopt if the block has not been indexed.
+    std::optional<node::BlockStats> LookUpStats(const CBlockIndex& block_index) const;
+};
+
+/// The global block statistics index. May be null.
+extern std::unique_ptr<BlockStatsIndex> g_block_stats_index;
+
+#endif // BITCOIN_INDEX_BLOCKSTATSINDEX_H
@@ -112,7 +112,38 @@ CoinStatsIndex::CoinStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t
     m_db = std::make_unique<CoinStatsIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
 }
 
-bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::any CoinStatsIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    // Hash the coins created and spent by the block into an accumulator of
+    // its own, so that this can be done for several blocks concurrently
+    // and appending the block only takes one multiplication by it.
+    MuHash3072 block_muhash;
+    if (block.height == 0) return block_muhash;
+
+    assert(block.data);
+    for (size_t i = 0; i < block.data->vtx.size(); ++i) {
+        const auto& tx{block.data->vtx.at(i)};
+
+        // Skip duplicate txid coinbase transactions (BIP30).
+        if (IsBIP30Unspendable(block.hash, block.height) && tx->IsCoinBase()) continue;
+
+        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+            Coin coin{tx->vout[j], block.height, tx->IsCoinBase()};
+            if (coin.out.scriptPubKey.IsUnspendable()) continue;
+            ApplyCoinHash(block_muhash, COutPoint{tx->GetHash(), j}, coin);
+        }
+
+        if (!tx->IsCoinBase()) {
+            const auto& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                RemoveCoinHash(block_muhash, tx->vin[j].prevout, tx_undo.vprevout[j]);
+            }
+        }
+    }
+    return block_muhash;
+}
+
+bool CoinStatsIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
 {
     const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
     m_total_subsidy += block_subsidy;
@@ -136,6 +167,8 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
             }
         }
 
+        m_muhash *= *Assert(std::any_cast<MuHash3072>(&prepared));
+
         // Add the new utxos created from the block
         assert(block.data);
         for (size_t i = 0; i < block.data->vtx.size(); ++i) {
@@ -150,27 +183,23 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
             for (uint32_t j = 0; j < tx->vout.size(); ++j) {
                 const CTxOut& out{tx->vout[j]};
-                Coin coin{out, block.height, tx->IsCoinBase()};
-                COutPoint outpoint{tx->GetHash(), j};
 
                 // Skip unspendable coins
-                if (coin.out.scriptPubKey.IsUnspendable()) {
-                    m_total_unspendable_amount += coin.out.nValue;
-                    m_total_unspendables_scripts += coin.out.nValue;
+                if (out.scriptPubKey.IsUnspendable()) {
+                    m_total_unspendable_amount += out.nValue;
+                    m_total_unspendables_scripts += out.nValue;
                     continue;
                 }
 
-                ApplyCoinHash(m_muhash, outpoint, coin);
-
                 if (tx->IsCoinBase()) {
-                    m_total_coinbase_amount += coin.out.nValue;
+                    m_total_coinbase_amount += out.nValue;
                 } else {
-                    m_total_new_outputs_ex_coinbase_amount += coin.out.nValue;
+                    m_total_new_outputs_ex_coinbase_amount += out.nValue;
                 }
 
                 ++m_transaction_output_count;
-                m_total_amount += coin.out.nValue;
-                m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
+                m_total_amount += out.nValue;
+                m_bogo_size += GetBogoSize(out.scriptPubKey);
             }
 
             // The coinbase tx has no undo data since no former output is spent
@@ -178,10 +207,7 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                 const auto& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
 
                 for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
-                    Coin coin{tx_undo.vprevout[j]};
-                    COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
-
-                    RemoveCoinHash(m_muhash, outpoint, coin);
+                    const Coin& coin{tx_undo.vprevout[j]};
 
                     m_total_prevout_spent_amount += coin.out.nValue;
 
@@ -0,0 +1,192 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scripthashindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <undo.h>
+#include <util/check.h>
+
+#include <ios>
+#include <map>
+#include <set>
+
+static constexpr uint8_t DB_SCRIPTHASH{'h'};
+
+std::unique_ptr<ScriptHashIndex> g_scripthash_index;
+
+uint256 ComputeScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+namespace {
+
+struct DBKey {
+    uint256 scripthash;
+    int height;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPTHASH);
+        s << scripthash;
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPTHASH) {
+            throw std::ios_base::failure("Invalid format for scripthash index DB key");
+        }
+        s >> scripthash;
+        height = ser_readdata32be(s);
+    }
+};
+
+/**
+ * The transactions of a block in the history of a script, each as its position
+ * in the block shifted left by one, with the low bit set if it spends from the
+ * script. They are stored in ascending order as varint deltas, so that most
+ * take a single byte.
+ */
+struct DBVal {
+    std::vector<uint32_t> codes;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        WriteCompactSize(s, codes.size());
+        uint32_t prev{0};
+        for (const uint32_t code : codes) {
+            s << VARINT(code - prev);
+            prev = code;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        codes.resize(ReadCompactSize(s));
+        uint32_t prev{0};
+        for (uint32_t& code : codes) {
+            uint32_t delta;
+            s >> VARINT(delta);
+            code = prev += delta;
+        }
+    }
+};
+
+using BlockEntries = std::map<uint256, std::set<uint32_t>>;
+
+} // namespace
+
+static bool CollectEntries(const interfaces::BlockInfo& block, BlockEntries& entries)
+{
+    const CBlock& block_data{*Assert(block.data)};
+    const CBlockUndo& block_undo{*Assert(block.undo_data)};
+    if (block_undo.vtxundo.size() + 1 != block_data.vtx.size()) {
+        LogError("undo data of block %s does not match its transactions", block.hash.ToString());
+        return false;
+    }
+    for (uint32_t tx_pos{0}; tx_pos < block_data.vtx.size(); ++tx_pos) {
+        const CTransaction& tx{*block_data.vtx[tx_pos]};
+        for (const CTxOut& out : tx.vout) {
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            entries[ComputeScriptHash(out.scriptPubKey)].insert(tx_pos << 1);
+        }
+        if (tx_pos == 0) continue;
+        for (const Coin& coin : block_undo.vtxundo[tx_pos - 1].vprevout) {
+            entries[ComputeScriptHash(coin.out.scriptPubKey)].insert(tx_pos << 1 | 1);
+        }
+    }
+    return true;
+}
+
+ScriptHashIndex::ScriptHashIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scripthashindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "scripthash"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+interfaces::Chain::NotifyOptions ScriptHashIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+std::any ScriptHashIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    BlockEntries entries;
+    if (block.height == 0 || !CollectEntries(block, entries)) return {};
+    return entries;
+}
+
+bool ScriptHashIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    if (block.height == 0) return true;
+    const BlockEntries* entries{std::any_cast<BlockEntries>(&prepared)};
+    if (!entries) return false; // failure cause logged in CustomPrepare
+
+    CDBBatch batch(*m_db);
+    for (const auto& [scripthash, codes] : *entries) {
+        batch.Write(DBKey{scripthash, block.height}, DBVal{{codes.begin(), codes.end()}});
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool ScriptHashIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    if (block.height == 0) return true;
+    BlockEntries entries;
+    if (!CollectEntries(block, entries)) return false;
+
+    CDBBatch batch(*m_db);
+    for (const auto& [scripthash, _] : entries) {
+        batch.Erase(DBKey{scripthash, block.height});
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool ScriptHashIndex::FindHistory(const uint256& scripthash, int start_height, int end_height, size_t max_entries,
+                                  std::vector<ScriptHashTxRef>& history, std::optional<int>& next_height) const
+{
+    history.clear();
+    next_height.reset();
+
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(DBKey{scripthash, start_height}); db_it->Valid(); db_it->Next()) {
+        DBKey key;
+        if (!db_it->GetKey(key) || key.scripthash != scripthash || key.height > end_height) break;
+        if (history.size() >= max_entries) {
+            next_height = key.height;
+            break;
+        }
+        DBVal value;
+        if (!db_it->GetValue(value)) {
+            LogError("Cannot read %s history at height %d", scripthash.ToString(), key.height);
+            return false;
+        }
+        for (const uint32_t code : value.codes) {
+            history.push_back({.height = key.height, .tx_pos = code >> 1, .spending = (code & 1) != 0});
+        }
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTHASHINDEX_H
+#define BITCOIN_INDEX_SCRIPTHASHINDEX_H
+
+#include <index/base.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTHASHINDEX{false};
+
+/** A transaction of the history of a script: it either pays to the script or spends an output paying to it. */
+struct ScriptHashTxRef {
+    int height;
+    //! Position of the transaction in its block.
+    uint32_t tx_pos;
+    bool spending;
+
+    SERIALIZE_METHODS(ScriptHashTxRef, obj) { READWRITE(obj.height, VARINT(obj.tx_pos), obj.spending); }
+};
+
+/** The hash identifying a script in the index: its SHA256, as in the Electrum protocol. */
+uint256 ComputeScriptHash(const CScript& script);
+
+/**
+ * ScriptHashIndex maps the hash of every scriptPubKey to the transactions
+ * funding or spending it, for Electrum-style address history queries.
+ *
+ * There is one entry per script and block, keyed by script hash and height,
+ * which holds the positions of the transactions in the block. Entries of
+ * blocks disconnected in a reorg are removed.
+ */
+class ScriptHashIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptHashIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the history of a script between two heights (inclusive), in
+    /// chain order. The transactions of a block are either all returned or
+    /// not at all: once at least max_entries were found, the lookup stops
+    /// after the current block and next_height is set to where to continue.
+    bool FindHistory(const uint256& scripthash, int start_height, int end_height, size_t max_entries,
+                     std::vector<ScriptHashTxRef>& history, std::optional<int>& next_height) const;
+};
+
+/// The global scripthash index. May be null.
+extern std::unique_ptr<ScriptHashIndex> g_scripthash_index;
+
+#endif // BITCOIN_INDEX_SCRIPTHASHINDEX_H
@@ -0,0 +1,157 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/spenderindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <crypto/siphash.h>
+#include <dbwrapper.h>
+#include <index/disktxpos.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+#include <sync.h>
+#include <util/check.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <ios>
+#include <span>
+#include <vector>
+
+static constexpr uint8_t DB_SPENDER{'s'};
+static constexpr uint8_t DB_SIPHASH_KEY{'K'};
+
+std::unique_ptr<SpenderIndex> g_spender_index;
+
+namespace {
+
+/** An output spent by the transaction at pos. The value of the entry is empty. */
+struct DBKey {
+    uint64_t hash;
+    CDiskTxPos pos;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SPENDER);
+        ser_writedata64(s, hash);
+        s << pos;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SPENDER) {
+            throw std::ios_base::failure("Invalid format for spender index DB key");
+        }
+        hash = ser_readdata64(s);
+        s >> pos;
+    }
+};
+
+} // namespace
+
+SpenderIndex::SpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "spenderindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "spender"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+
+    if (!m_db->Read(DB_SIPHASH_KEY, m_siphash_key)) {
+        FastRandomContext rng;
+        m_siphash_key = {rng.rand64(), rng.rand64()};
+        m_db->Write(DB_SIPHASH_KEY, m_siphash_key, /*fSync=*/true);
+    }
+}
+
+uint64_t SpenderIndex::HashOutpoint(const COutPoint& prevout) const
+{
+    return SipHashUint256Extra(m_siphash_key.first, m_siphash_key.second, prevout.hash.ToUint256(), prevout.n);
+}
+
+interfaces::Chain::NotifyOptions SpenderIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.disconnect_data = true;
+    return options;
+}
+
+std::any SpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    const CBlock& block_data{*Assert(block.data)};
+    std::vector<DBKey> keys;
+    CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block_data.vtx.size()));
+    for (const auto& tx : block_data.vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                keys.push_back({HashOutpoint(txin.prevout), pos});
+            }
+        }
+        pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
+    }
+    return keys;
+}
+
+bool SpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    CDBBatch batch(*m_db);
+    for (const DBKey& key : *Assert(std::any_cast<std::vector<DBKey>>(&prepared))) {
+        batch.Write(key, std::span<const std::byte>{});
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool SpenderIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    for (const DBKey& key : std::any_cast<std::vector<DBKey>>(CustomPrepare(block))) {
+        batch.Erase(key);
+    }
+    return m_db->WriteBatch(batch);
+}
+
+std::optional<TxSpender> SpenderIndex::FindSpender(const COutPoint& prevout) const
+{
+    const uint64_t hash{HashOutpoint(prevout)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(DBKey{hash, {}}); db_it->Valid(); db_it->Next()) {
+        DBKey key;
+        if (!db_it->GetKey(key) || key.hash != hash) break;
+
+        AutoFile file{m_chainstate->m_blockman.OpenBlockFile(key.pos, true)};
+        if (file.IsNull()) {
+            LogError("OpenBlockFile failed");
+            return std::nullopt;
+        }
+        CBlockHeader header;
+        CTransactionRef tx;
+        try {
+            file >> header;
+            file.seek(key.pos.nTxOffset, SEEK_CUR);
+            file >> TX_WITH_WITNESS(tx);
+        } catch (const std::exception& e) {
+            LogError("Deserialize or I/O error - %s", e.what());
+            return std::nullopt;
+        }
+        // Skip the transactions spending other outputs with the same hash.
+        if (std::none_of(tx->vin.begin(), tx->vin.end(), [&](const CTxIn& txin) { return txin.prevout == prevout; })) continue;
+
+        const uint256 block_hash{header.GetHash()};
+        const CBlockIndex* block_index{WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block_hash))};
+        if (!block_index) {
+            LogError("block %s not found in the block index", block_hash.ToString());
+            return std::nullopt;
+        }
+        return TxSpender{.tx = std::move(tx), .block_hash = block_hash, .height = block_index->nHeight};
+    }
+    return std::nullopt;
+}
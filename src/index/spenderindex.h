@@ -0,0 +1,66 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SPENDERINDEX_H
+#define BITCOIN_INDEX_SPENDERINDEX_H
+
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+static constexpr bool DEFAULT_SPENDERINDEX{false};
+
+/** The confirmed transaction spending an output. */
+struct TxSpender {
+    CTransactionRef tx;
+    uint256 block_hash;
+    int height;
+};
+
+/**
+ * SpenderIndex maps every spent output to the position on disk of the
+ * transaction spending it.
+ *
+ * To keep the entries small, outputs are keyed by a salted 64-bit hash of the
+ * outpoint rather than the outpoint itself. The transactions of colliding
+ * entries are read from disk to find the one actually spending the output.
+ */
+class SpenderIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+    //! Salt of the outpoint hashes, generated when the index is created.
+    std::pair<uint64_t, uint64_t> m_siphash_key;
+
+    bool AllowPrune() const override { return false; }
+
+    uint64_t HashOutpoint(const COutPoint& prevout) const;
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit SpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the confirmed transaction spending an output, if any.
+    std::optional<TxSpender> FindSpender(const COutPoint& prevout) const;
+};
+
+/// The global spender index. May be null.
+extern std::unique_ptr<SpenderIndex> g_spender_index;
+
+#endif // BITCOIN_INDEX_SPENDERINDEX_H
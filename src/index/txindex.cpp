@@ -4,23 +4,67 @@
 
 #include <index/txindex.h>
 
+#include <chain.h>
 #include <clientversion.h>
 #include <common/args.h>
 #include <index/disktxpos.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <util/check.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <ios>
+#include <numeric>
+#include <tuple>
+
 constexpr uint8_t DB_TXINDEX{'t'};
+constexpr uint8_t DB_TXINDEX_COMPACT{'c'};
+
+/** Transactions at most this far after the last one read from a block file are reached by reading through instead of seeking. */
+static constexpr int64_t MAX_TX_READ_GAP{64 << 10};
 
 std::unique_ptr<TxIndex> g_txindex;
 
+namespace {
+
+/** A transaction in the compact format, keyed by the first 8 bytes of its hash. The value is empty. */
+struct CompactTxKey {
+    uint64_t prefix;
+    int height;
+    uint32_t tx_index;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_TXINDEX_COMPACT);
+        ser_writedata64(s, prefix);
+        ser_writedata32be(s, height);
+        s << VARINT(tx_index);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t key{ser_readdata8(s)};
+        if (key != DB_TXINDEX_COMPACT) {
+            throw std::ios_base::failure("Invalid format for compact txindex DB key");
+        }
+        prefix = ser_readdata64(s);
+        height = ser_readdata32be(s);
+        s >> VARINT(tx_index);
+    }
+};
 
-/** Access to the txindex database (indexes/txindex/) */
+} // namespace
+
+/** Access to the txindex database (indexes/txindex/ or indexes/txindexcompact/) */
 class TxIndex::DB : public BaseIndex::DB
 {
 public:
-    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    explicit DB(const fs::path& path, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
     /// Read the disk location of the transaction data with the given hash. Returns false if the
     /// transaction hash is not indexed.
@@ -28,10 +72,13 @@ public:
 
     /// Write a batch of transaction positions to the DB.
     [[nodiscard]] bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
+
+    /// Write or erase a batch of transactions in the compact format.
+    [[nodiscard]] bool UpdateCompactTxs(const std::vector<CompactTxKey>& keys, bool erase);
 };
 
-TxIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
-    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txindex", n_cache_size, f_memory, f_wipe)
+TxIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(path, n_cache_size, f_memory, f_wipe)
 {}
 
 bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
@@ -48,32 +95,87 @@ bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_
     return WriteBatch(batch);
 }
 
-TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
-    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe))
+bool TxIndex::DB::UpdateCompactTxs(const std::vector<CompactTxKey>& keys, bool erase)
+{
+    CDBBatch batch(*this);
+    for (const CompactTxKey& key : keys) {
+        if (erase) {
+            batch.Erase(key);
+        } else {
+            batch.Write(key, std::span<const std::byte>{});
+        }
+    }
+    return WriteBatch(batch);
+}
+
+TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe, bool compact)
+    : BaseIndex(std::move(chain), "txindex"),
+      m_db(std::make_unique<TxIndex::DB>(gArgs.GetDataDirNet() / "indexes" / (compact ? "txindexcompact" : "txindex"), n_cache_size, f_memory, f_wipe)),
+      m_compact{compact}
 {}
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+//! Positions of the transactions of a block, computed by TxIndex::CustomPrepare.
+using TxPositions = std::vector<std::pair<uint256, CDiskTxPos>>;
+
+static std::vector<CompactTxKey> CompactTxKeys(const interfaces::BlockInfo& block)
+{
+    const CBlock& block_data{*Assert(block.data)};
+    std::vector<CompactTxKey> keys;
+    keys.reserve(block_data.vtx.size());
+    for (uint32_t tx_index{0}; tx_index < block_data.vtx.size(); ++tx_index) {
+        keys.push_back({block_data.vtx[tx_index]->GetHash().ToUint256().GetUint64(0), block.height, tx_index});
+    }
+    return keys;
+}
+
+interfaces::Chain::NotifyOptions TxIndex::CustomOptions()
+{
+    // Compact entries locate transactions by height, so they must not outlive
+    // a reorg.
+    interfaces::Chain::NotifyOptions options;
+    options.disconnect_data = m_compact;
+    return options;
+}
+
+std::any TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    if (block.height == 0) return {};
+    if (m_compact) return CompactTxKeys(block);
 
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
-    std::vector<std::pair<uint256, CDiskTxPos>> vPos;
+    TxPositions vPos;
     vPos.reserve(block.data->vtx.size());
     for (const auto& tx : block.data->vtx) {
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    return vPos;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    if (block.height == 0) return true;
+    if (m_compact) return m_db->UpdateCompactTxs(*Assert(std::any_cast<std::vector<CompactTxKey>>(&prepared)), /*erase=*/false);
+    return m_db->WriteTxs(*Assert(std::any_cast<TxPositions>(&prepared)));
+}
+
+bool TxIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    // Full entries of disconnected blocks still point to a valid location.
+    if (!m_compact || block.height == 0) return true;
+    return m_db->UpdateCompactTxs(CompactTxKeys(block), /*erase=*/true);
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
 bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
 {
+    if (m_compact) return FindTxCompact(tx_hash, block_hash, tx);
+
     CDiskTxPos postx;
     if (!m_db->ReadTxPos(tx_hash, postx)) {
         return false;
@@ -100,3 +202,155 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
     block_hash = header.GetHash();
     return true;
 }
+
+bool TxIndex::FindTxCompact(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+{
+    const uint64_t prefix{tx_hash.GetUint64(0)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(CompactTxKey{prefix, 0, 0}); db_it->Valid(); db_it->Next()) {
+        CompactTxKey key;
+        if (!db_it->GetKey(key) || key.prefix != prefix) break;
+
+        // The block may be briefly missing from the active chain during a reorg.
+        const CBlockIndex* block_index{WITH_LOCK(cs_main, return m_chainstate->m_chain[key.height])};
+        if (!block_index) continue;
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlock(block, *block_index)) {
+            return false;
+        }
+        // Skip the transactions whose hash only shares the prefix.
+        if (key.tx_index >= block.vtx.size() || block.vtx[key.tx_index]->GetHash() != tx_hash) continue;
+        tx = block.vtx[key.tx_index];
+        block_hash = block_index->GetBlockHash();
+        return true;
+    }
+    return false;
+}
+
+/** Read the transactions at the given positions in one block file, sorted by position. */
+void TxIndex::ReadTxs(std::span<const std::pair<CDiskTxPos, size_t>> positions, std::span<const uint256> tx_hashes,
+                      std::vector<std::optional<std::pair<uint256, CTransactionRef>>>& found) const
+{
+    AutoFile file{m_chainstate->m_blockman.OpenBlockFile(FlatFilePos{positions.front().first.nFile, 0}, /*fReadOnly=*/true)};
+    if (file.IsNull()) {
+        LogError("OpenBlockFile failed");
+        return;
+    }
+    // The block whose header was read last, and where its transactions start.
+    std::optional<unsigned int> block_pos;
+    uint256 block_hash;
+    int64_t txs_pos{0};
+    const auto move_to{[&](int64_t pos) {
+        const int64_t file_pos{file.tell()};
+        if (pos >= file_pos && pos - file_pos <= MAX_TX_READ_GAP) {
+            file.ignore(pos - file_pos);
+        } else {
+            file.seek(pos, SEEK_SET);
+        }
+    }};
+    for (const auto& [pos, i] : positions) {
+        try {
+            if (pos.nPos != block_pos) {
+                CBlockHeader header;
+                move_to(pos.nPos);
+                file >> header;
+                block_pos = pos.nPos;
+                block_hash = header.GetHash();
+                txs_pos = file.tell();
+            }
+            CTransactionRef tx;
+            move_to(txs_pos + pos.nTxOffset);
+            file >> TX_WITH_WITNESS(tx);
+            if (tx->GetHash() != tx_hashes[i]) {
+                LogError("txid mismatch");
+                continue;
+            }
+            found[i].emplace(block_hash, std::move(tx));
+        } catch (const std::exception& e) {
+            LogError("Deserialize or I/O error - %s", e.what());
+            // Read the header again, from a known position.
+            block_pos.reset();
+            try {
+                file.seek(0, SEEK_SET);
+            } catch (const std::exception&) {
+                return;
+            }
+        }
+    }
+}
+
+std::vector<std::optional<std::pair<uint256, CTransactionRef>>> TxIndex::FindTxs(std::span<const uint256> tx_hashes) const
+{
+    if (m_compact) return FindTxsCompact(tx_hashes);
+
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> found(tx_hashes.size());
+    std::vector<size_t> order(tx_hashes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return tx_hashes[a] < tx_hashes[b]; });
+
+    // The positions of the found transactions, and the indexes of their hashes.
+    std::vector<std::pair<CDiskTxPos, size_t>> positions;
+    {
+        std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+        for (const size_t i : order) {
+            const auto key{std::make_pair(DB_TXINDEX, tx_hashes[i])};
+            db_it->Seek(key);
+            std::pair<uint8_t, uint256> found_key;
+            CDiskTxPos pos;
+            if (db_it->Valid() && db_it->GetKey(found_key) && found_key == key && db_it->GetValue(pos)) {
+                positions.emplace_back(pos, i);
+            }
+        }
+    }
+    std::ranges::sort(positions, {}, [](const auto& entry) {
+        const CDiskTxPos& pos{entry.first};
+        return std::tuple{pos.nFile, pos.nPos, pos.nTxOffset};
+    });
+
+    for (auto file_begin{positions.begin()}; file_begin != positions.end();) {
+        const int file_num{file_begin->first.nFile};
+        const auto file_end{std::find_if(file_begin, positions.end(), [&](const auto& entry) { return entry.first.nFile != file_num; })};
+        ReadTxs(std::span{file_begin, file_end}, tx_hashes, found);
+        file_begin = file_end;
+    }
+    return found;
+}
+
+std::vector<std::optional<std::pair<uint256, CTransactionRef>>> TxIndex::FindTxsCompact(std::span<const uint256> tx_hashes) const
+{
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> found(tx_hashes.size());
+    // The entries sharing the prefix of each hash, and the index of the hash.
+    std::vector<std::pair<CompactTxKey, size_t>> candidates;
+    {
+        std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+        for (size_t i{0}; i < tx_hashes.size(); ++i) {
+            const uint64_t prefix{tx_hashes[i].GetUint64(0)};
+            for (db_it->Seek(CompactTxKey{prefix, 0, 0}); db_it->Valid(); db_it->Next()) {
+                CompactTxKey key;
+                if (!db_it->GetKey(key) || key.prefix != prefix) break;
+                candidates.emplace_back(key, i);
+            }
+        }
+    }
+    std::ranges::sort(candidates, {}, [](const auto& entry) { return std::pair{entry.first.height, entry.first.tx_index}; });
+
+    CBlock block;
+    const CBlockIndex* block_index{nullptr};
+    for (const auto& [key, i] : candidates) {
+        if (found[i]) continue;
+        if (!block_index || block_index->nHeight != key.height) {
+            // The block may be briefly missing from the active chain during a reorg.
+            block_index = WITH_LOCK(cs_main, return m_chainstate->m_chain[key.height]);
+            if (!block_index) continue;
+            block.SetNull();
+            if (!m_chainstate->m_blockman.ReadBlock(block, *block_index)) {
+                block_index = nullptr;
+                continue;
+            }
+        }
+        // Skip the transactions whose hash only shares the prefix.
+        if (key.tx_index >= block.vtx.size() || block.vtx[key.tx_index]->GetHash() != tx_hashes[i]) continue;
+        found[i].emplace(block_index->GetBlockHash(), block.vtx[key.tx_index]);
+    }
+    return found;
+}
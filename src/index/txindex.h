@@ -6,13 +6,25 @@
 #define BITCOIN_INDEX_TXINDEX_H
 
 #include <index/base.h>
+#include <index/disktxpos.h>
+
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 static constexpr bool DEFAULT_TXINDEX{false};
+static constexpr bool DEFAULT_TXINDEX_COMPACT{false};
 
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
  * The index is written to a LevelDB database and records the filesystem
  * location of each transaction by transaction hash.
+ *
+ * In the compact format the transactions are keyed by the first 8 bytes of
+ * their hash and located by block height and position in the block, which
+ * takes less than half the space. A lookup reads the whole block, and the
+ * transactions of colliding entries are compared against the hash.
  */
 class TxIndex final : public BaseIndex
 {
@@ -21,17 +33,29 @@ protected:
 
 private:
     const std::unique_ptr<DB> m_db;
+    const bool m_compact;
 
     bool AllowPrune() const override { return false; }
 
+    bool FindTxCompact(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> FindTxsCompact(std::span<const uint256> tx_hashes) const;
+    void ReadTxs(std::span<const std::pair<CDiskTxPos, size_t>> positions, std::span<const uint256> tx_hashes,
+                 std::vector<std::optional<std::pair<uint256, CTransactionRef>>>& found) const;
+
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
 
     BaseIndex::DB& GetDB() const override;
 
 public:
     /// Constructs the index, which becomes available to be queried.
-    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false, bool compact = false);
 
     // Destructor is declared because this class contains a unique_ptr to an incomplete type.
     virtual ~TxIndex() override;
@@ -43,6 +67,16 @@ public:
     /// @param[out]  tx  The transaction itself.
     /// @return  true if transaction is found, false otherwise
     bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+
+    /// Look up many transactions by hash at once. The positions are looked up
+    /// with one database iterator in key order, then the transactions are
+    /// read in the order they are stored in: each block file is opened once,
+    /// and transactions close to each other are read sequentially instead of
+    /// seeking to each. In the compact format, each block is read once.
+    ///
+    /// @return  For each hash, the hash of the block the transaction is found
+    ///          in and the transaction, or std::nullopt if it is not found.
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> FindTxs(std::span<const uint256> tx_hashes) const;
 };
 
 /// The global transaction index, used in GetTransaction. May be null.
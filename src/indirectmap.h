@@ -5,7 +5,10 @@
 #ifndef BITCOIN_INDIRECTMAP_H
 #define BITCOIN_INDIRECTMAP_H
 
+#include <cstddef>
 #include <map>
+#include <unordered_map>
+#include <utility>
 
 template <class T>
 struct DereferencingComparator { bool operator()(const T a, const T b) const { return *a < *b; } };
@@ -55,4 +58,57 @@ public:
     const_iterator cend() const     { return m.cend(); }
 };
 
+template <class T, class Hash>
+struct DereferencingHasher : private Hash {
+    size_t operator()(const T* a) const noexcept(noexcept(std::declval<const Hash&>()(*a))) { return Hash::operator()(*a); }
+};
+
+template <class T>
+struct DereferencingEqual { bool operator()(const T* a, const T* b) const { return *a == *b; } };
+
+/* Hash map whose keys are pointers, but are hashed and compared by their
+ * dereferenced values, with the same value interface as indirectmap.
+ *
+ * Lookups are a hash and, usually, a single comparison instead of a walk down
+ * a tree, at the cost of iterating in no particular order and of having no
+ * lower_bound.
+ *
+ * Objects pointed to by keys must not be modified in any way that changes
+ * their hash or the result of DereferencingEqual.
+ */
+template <class K, class T, class Hash>
+class unordered_indirectmap {
+private:
+    typedef std::unordered_map<const K*, T, DereferencingHasher<K, Hash>, DereferencingEqual<K>> base;
+    base m;
+public:
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+    typedef typename base::size_type size_type;
+    typedef typename base::value_type value_type;
+
+    // passthrough (pointer interface)
+    std::pair<iterator, bool> insert(const value_type& value) { return m.insert(value); }
+
+    // pass address (value interface)
+    iterator find(const K& key)                     { return m.find(&key); }
+    const_iterator find(const K& key) const         { return m.find(&key); }
+    size_type erase(const K& key)                   { return m.erase(&key); }
+    size_type count(const K& key) const             { return m.count(&key); }
+
+    // passthrough
+    bool empty() const              { return m.empty(); }
+    size_type size() const          { return m.size(); }
+    size_type max_size() const      { return m.max_size(); }
+    size_type bucket_count() const  { return m.bucket_count(); }
+    void reserve(size_type count)   { m.reserve(count); }
+    void clear()                    { m.clear(); }
+    iterator begin()                { return m.begin(); }
+    iterator end()                  { return m.end(); }
+    const_iterator begin() const    { return m.begin(); }
+    const_iterator end() const      { return m.end(); }
+    const_iterator cbegin() const   { return m.cbegin(); }
+    const_iterator cend() const     { return m.cend(); }
+};
+
 #endif // BITCOIN_INDIRECTMAP_H
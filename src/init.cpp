@@ -24,8 +24,12 @@
 #include <hash.h>
 #include <httprpc.h>
 #include <httpserver.h>
+#include <index/blockcache.h>
 #include <index/blockfilterindex.h>
+#include <index/blockstatsindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
+#include <index/spenderindex.h>
 #include <index/txindex.h>
 #include <init/common.h>
 #include <interfaces/chain.h>
@@ -34,6 +38,7 @@
 #include <interfaces/mining.h>
 #include <interfaces/node.h>
 #include <kernel/caches.h>
+#include <kernel/coinstats.h>
 #include <kernel/context.h>
 #include <key.h>
 #include <logging.h>
@@ -44,10 +49,12 @@
 #include <netbase.h>
 #include <netgroup.h>
 #include <node/blockmanager_args.h>
+#include <node/blockreadahead.h>
 #include <node/blockstorage.h>
 #include <node/caches.h>
 #include <node/chainstate.h>
 #include <node/chainstatemanager_args.h>
+#include <node/coins_cache_persist.h>
 #include <node/context.h>
 #include <node/interface_ui.h>
 #include <node/kernel_notifications.h>
@@ -56,6 +63,7 @@
 #include <node/mempool_persist_args.h>
 #include <node/miner.h>
 #include <node/peerman_args.h>
+#include <node/validation_cache_persist.h>
 #include <policy/feerate.h>
 #include <policy/fees.h>
 #include <policy/fees_args.h>
@@ -79,12 +87,15 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/moneystr.h>
+#include <util/numa.h>
+#include <util/readwritefile.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/syserror.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/threadnames.h>
 #include <util/time.h>
 #include <util/translation.h>
@@ -99,6 +110,8 @@
 #include <cstdio>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <optional>
 #include <set>
 #include <string>
 #include <thread>
@@ -126,17 +139,28 @@ using node::BlockManager;
 using node::CalculateCacheSizes;
 using node::ChainstateLoadResult;
 using node::ChainstateLoadStatus;
+using node::CoinsCachePath;
+using node::DEFAULT_BLOCK_TEMPLATE_MAX_AGE;
+using node::DEFAULT_PERSIST_COINS_CACHE;
 using node::DEFAULT_PERSIST_MEMPOOL;
+using node::DEFAULT_PERSIST_VALIDATION_CACHE;
 using node::DEFAULT_PRINT_MODIFIED_FEE;
 using node::DEFAULT_STOPATHEIGHT;
+using node::DumpCoinsCache;
 using node::DumpMempool;
+using node::DumpValidationCache;
 using node::ImportBlocks;
 using node::KernelNotifications;
 using node::LoadChainstate;
+using node::LoadCoinsCache;
 using node::LoadMempool;
+using node::LoadValidationCache;
 using node::MempoolPath;
 using node::NodeContext;
+using node::ShouldPersistCoinsCache;
 using node::ShouldPersistMempool;
+using node::ShouldPersistValidationCache;
+using node::ValidationCachePath;
 using node::VerifyLoadedChainstate;
 using util::Join;
 using util::ReplaceAll;
@@ -144,8 +168,11 @@ using util::ToString;
 
 static constexpr bool DEFAULT_PROXYRANDOMIZE{true};
 static constexpr bool DEFAULT_REST_ENABLE{false};
+static constexpr bool DEFAULT_METRICS_ENABLE{false};
 static constexpr bool DEFAULT_I2P_ACCEPT_INCOMING{true};
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+static constexpr int DEFAULT_SHARED_POOL_THREADS{0};
+static constexpr int MAX_SHARED_POOL_THREADS{64};
 
 #ifdef WIN32
 // Win32 LevelDB doesn't use filedescriptors, and the ones used for
@@ -296,6 +323,7 @@ void Shutdown(NodeContext& node)
 
     StopHTTPRPC();
     StopREST();
+    StopHTTPMetrics();
     StopRPC();
     StopHTTPServer();
     StopMapPort();
@@ -308,10 +336,16 @@ void Shutdown(NodeContext& node)
     StopTorControl();
 
     if (node.background_init_thread.joinable()) node.background_init_thread.join();
+    // Background validation may still wait for the validation queue to drain.
+    if (node.chainman) node.chainman->StopBackgroundValidation();
     // After everything has been shut down, but before things get flushed, stop the
     // the scheduler. After this point, SyncWithValidationInterfaceQueue() should not be called anymore
     // as this would prevent the shutdown from completing.
     if (node.scheduler) node.scheduler->stop();
+    GetSharedThreadPool().Stop();
+    if (node.validation_scheduler) node.validation_scheduler->stop();
+    for (auto& thread : node.validation_scheduler_threads) thread.join();
+    node.validation_scheduler_threads.clear();
 
     // After the threads that potentially access these pointers have been stopped,
     // destruct and reset all to nullptr.
@@ -324,6 +358,13 @@ void Shutdown(NodeContext& node)
     if (node.mempool && node.mempool->GetLoadTried() && ShouldPersistMempool(*node.args)) {
         DumpMempool(*node.mempool, MempoolPath(*node.args));
     }
+    if (node.chainman && ShouldPersistValidationCache(*node.args)) {
+        DumpValidationCache(node.chainman->m_validation_cache, ValidationCachePath(*node.args));
+    }
+    // Before the final flush, which empties the coins cache.
+    if (node.chainman && ShouldPersistCoinsCache(*node.args)) {
+        DumpCoinsCache(node.chainman->ActiveChainstate(), CoinsCachePath(*node.args));
+    }
 
     // Drop transactions we were still watching, record fee estimations and unregister
     // fee estimator from validation interface.
@@ -352,6 +393,9 @@ void Shutdown(NodeContext& node)
     for (auto* index : node.indexes) index->Stop();
     if (g_txindex) g_txindex.reset();
     if (g_coin_stats_index) g_coin_stats_index.reset();
+    if (g_block_stats_index) g_block_stats_index.reset();
+    if (g_scripthash_index) g_scripthash_index.reset();
+    if (g_spender_index) g_spender_index.reset();
     DestroyAllBlockFilterIndexes();
     node.indexes.clear(); // all instances are nullptr now
 
@@ -389,6 +433,7 @@ void Shutdown(NodeContext& node)
     node.fee_estimator.reset();
     node.chainman.reset();
     node.validation_signals.reset();
+    node.validation_scheduler.reset();
     node.scheduler.reset();
     node.ecc_context.reset();
     node.kernel.reset();
@@ -396,6 +441,7 @@ void Shutdown(NodeContext& node)
     RemovePidFile(*node.args);
 
     LogPrintf("%s: done\n", __func__);
+    LogInstance().StopAsyncWriter();
 }
 
 /**
@@ -467,6 +513,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-alertnotify=<cmd>", "Execute command when an alert is raised (%s in cmd is replaced by message)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet3: %s, testnet4: %s, signet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnet4ChainParams->GetConsensus().defaultAssumeValid.GetHex(), signetChainParams->GetConsensus().defaultAssumeValid.GetHex()), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockdatacache=<n>", strprintf("Maximum memory in MiB for recently read blocks and undo data, served to peers, indexes and clients without reading them from disk again (0 = disabled, up to %d, default: %d)", kernel::MAX_BLOCK_DATA_CACHE_MIB, kernel::DEFAULT_BLOCK_DATA_CACHE_MIB), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksdir=<dir>", "Specify directory to hold blocks subdirectory for *.dat files (default: <datadir>)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksxor",
                    strprintf("Whether an XOR-key applies to blocksdir *.dat files. "
@@ -475,44 +522,78 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
                              "(default: %u)",
                              kernel::DEFAULT_XOR_BLOCKSDIR),
                    ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-batchschnorr", strprintf("When connecting blocks, defer the Schnorr signature checks of each input until its scripts have run and verify them together (default: %u)", DEFAULT_BATCH_SCHNORR), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-fastprune", "Use smaller block files and lower minimum prune height for testing purposes", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
 #if HAVE_SYSTEM
     argsman.AddArg("-blocknotify=<cmd>", "Execute command when the best block changes (%s in cmd is replaced by block hash)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
+    argsman.AddArg("-blockreadahead=<n>", strprintf("Read and deserialize up to <n> blocks from disk ahead of connecting them, overlapping block I/O with validation during IBD and reindex (0 = disabled, up to %d, default: %d)", node::MAX_BLOCK_READ_AHEAD, node::DEFAULT_BLOCK_READ_AHEAD), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockreadaheadthreads=<n>", strprintf("Set the number of threads reading blocks ahead for -blockreadahead, i.e. the number of block reads in flight at once. Raising it helps on storage with high per-request latency (1 to %d, default: %d)", node::MAX_BLOCK_READ_AHEAD_THREADS, node::DEFAULT_BLOCK_READ_AHEAD_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blockreconstructionextratxn=<n>", strprintf("Extra transactions to keep in memory for compact block reconstructions (default: %u)", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockscanthreads=<n>", strprintf("Set the number of threads of the shared thread pool matching block filters in scanblocks and reading blocks in scanblocks and getdescriptoractivity (0 = auto, up to %d, default: %d)", MAX_BLOCK_SCAN_THREADS, DEFAULT_BLOCK_SCAN_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksonly", strprintf("Whether to reject transactions from network peers. Disables automatic broadcast and rebroadcast of transactions, unless the source peer has the 'forcerelay' permission. RPC transactions are not affected. (default: %u)", DEFAULT_BLOCKSONLY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockstatsindex", strprintf("Maintain an index of per block statistics, used by the getblockstats and getblockstatsrange RPCs (default: %u)", DEFAULT_BLOCKSTATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-coinsflushchunk=<n>", strprintf("Write up to <n> modified coins to the chainstate database between blocks, so that periodic and cache-full flushes have less left to write and stall validation for a shorter time (0 = disabled, default: %d)", DEFAULT_COINS_FLUSH_CHUNK), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-coinstatsindex", strprintf("Maintain coinstats index used by the gettxoutsetinfo RPC (default: %u)", DEFAULT_COINSTATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-coldblocksdepth=<n>", strprintf("Move block and undo files to -coldblocksdir once all their blocks are at least <n> blocks below the tip (minimum: %u, default: %u)", MIN_BLOCKS_TO_KEEP, kernel::DEFAULT_COLD_BLOCKS_DEPTH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-coldblocksdir=<dir>", "Specify directory to hold a blocks subdirectory for the *.dat files of old blocks, e.g. on slower and cheaper storage than -blocksdir. Files are moved there in the background and read from either directory, and may be compressed by the filesystem if the blocks directory was created with -blocksxor=0. This mode is incompatible with -prune. (default: none)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-conf=<file>", strprintf("Specify path to read-only configuration file. Relative paths will be prefixed by datadir location (only useable from command line, not configuration file) (default: %s)", BITCOIN_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY | ArgsManager::DISALLOW_NEGATION, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dbasyncwrite", strprintf("Commit coins database write batches on a background thread while the next batch is serialized (default: %u)", DEFAULT_DB_ASYNC_WRITE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (minimum %d, default: %d). Make sure you have enough RAM. In addition, unused memory allocated to the mempool is shared with this cache (see -maxmempool).", MIN_DB_CACHE >> 20, DEFAULT_DB_CACHE >> 20), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dbcachedynamic", strprintf("During initial block download, grow or shrink the coins cache to the memory the system has available instead of using -dbcache, and flush it early when memory gets scarce. Follows cgroup v2 memory limits in containers. Linux only (default: %u)", DEFAULT_DBCACHE_DYNAMIC), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dbmissingcache=<n>", strprintf("Number of outpoints recently found missing in the coins database to remember, so repeated lookups of them skip the database (0 to disable, default: %u)", DEFAULT_DB_MISSING_CACHE_ENTRIES), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-headercheckthreads=<n>", strprintf("Set the number of threads hashing and checking the proof of work of received headers in parallel (0 = disabled, up to %d, default: %d)", MAX_HEADER_CHECK_THREADS, DEFAULT_HEADER_CHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-hugepages", strprintf("Advise the kernel to back the coins cache and the script execution and signature caches with transparent huge pages, which speeds up their lookups (only on Linux, default: %u)", DEFAULT_HUGE_PAGES), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-allowignoredconf", strprintf("For backwards compatibility, treat an unused %s file in the datadir as a warning, not an error.", BITCOIN_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-indexsynccpushare=<n>", strprintf("Limit the share of the time in percent each index spends working while it catches up with the block chain (1 to 100, default: %d)", DEFAULT_INDEX_SYNC_CPU_SHARE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-indexsyncreadrate=<n>", strprintf("Limit the rate in MiB/s at which each index reads blocks while it catches up with the block chain (0 = unlimited, default: %d)", DEFAULT_INDEX_SYNC_READ_RATE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-indexsyncthreads=<n>", strprintf("Set the number of threads reading and preparing blocks while an index catches up with the block chain (0 = auto, up to %d, default: %d)", MAX_INDEX_SYNC_THREADS, DEFAULT_INDEX_SYNC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE_MB), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-mempoolbatchtrim", strprintf("When the mempool is full, evict all transactions needed to get below -maxmempool in one batch, using their feerates from before the eviction (default: %u)", DEFAULT_MEMPOOL_BATCH_TRIM), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY_HOURS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-mempoollogsize=<n>", strprintf("Keep the last <n> additions and removals of mempool transactions in memory, for getmempooldelta (default: %u)", DEFAULT_MEMPOOL_LOG_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet3: %s, testnet4: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnet4ChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-backgroundpar=<n>", strprintf("Set the number of threads dedicated to validating the background chainstate of a snapshot loaded with loadtxoutset, one of which connects its blocks. "
+        "The background chainstate then gets its own block read-ahead and lets new blocks of the active chainstate go first (0 = share the -par threads, up to %d, default: %d)",
+        MAX_SCRIPTCHECK_THREADS, DEFAULT_BACKGROUND_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-numanode=<n>", "Run the threads of the node on the CPUs of NUMA node <n>, so that the coins cache and the signature caches are allocated in memory local to the script verification and message handler threads (only on Linux, default: all CPUs)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (0 = auto, up to %d, <0 = leave that many cores free, default: %d)",
         MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-persistcoinscache", strprintf("Whether to save the outpoints of the coins in the coins cache on shutdown and read those coins back into the cache on restart, so that blocks and transactions find them in the cache right away (default: %u)", DEFAULT_PERSIST_COINS_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempoolv1",
                    strprintf("Whether a mempool.dat file created by -persistmempool or the savemempool RPC will be written in the legacy format "
                              "(version 1) or the current format (version 2). This temporary option will be removed in the future. (default: %u)",
                              DEFAULT_PERSIST_V1_DAT),
                    ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-persistvalidationcache", strprintf("Whether to save the script execution and signature caches on shutdown and load them on restart, so that blocks are validated as fast after a restart as before it (default: %u)", DEFAULT_PERSIST_VALIDATION_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-prefetchthreads=<n>", strprintf("Set the number of threads looking up the inputs of a block in the UTXO database in parallel before connecting it (0 = disabled, up to %d, default: %d)", MAX_INPUT_PREFETCH_THREADS, DEFAULT_INPUT_PREFETCH_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >=%u = automatically prune block files to stay under the specified target size in MiB)", MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-reindex", "If enabled, wipe chain state and block index, and rebuild them from blk*.dat files on disk. Also wipe and rebuild other optional indexes that are active. If an assumeutxo snapshot was loaded, its chainstate will be wiped as well. The snapshot can then be reloaded via RPC.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-reindex-chainstate", "If enabled, wipe chain state, and rebuild it from blk*.dat files on disk. If an assumeutxo snapshot was loaded, its chainstate will be wiped as well. The snapshot can then be reloaded via RPC.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-reindexscanthreads=<n>", strprintf("Set the number of threads scanning block files for blocks ahead of accepting them during -reindex (0 = disabled, up to %d, default: %d)", kernel::MAX_REINDEX_SCAN_THREADS, kernel::DEFAULT_REINDEX_SCAN_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-scripthashindex", strprintf("Maintain an index of the transactions funding and spending every scriptPubKey, used by the getscripthashhistory RPC and the /rest/scripthash/ endpoint (default: %u)", DEFAULT_SCRIPTHASHINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-settings=<file>", strprintf("Specify path to dynamic settings data file. Can be disabled with -nosettings. File is written at runtime and not meant to be edited by users (use %s instead for custom settings). Relative paths will be prefixed by datadir location. (default: %s)", BITCOIN_CONF_FILENAME, BITCOIN_SETTINGS_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-sharedthreads=<n>", strprintf("Set the number of threads of the pool shared by parallel work, such as loading the block index at startup and the RPCs scanning blocks (0 = one per core, up to %d, default: %d)", MAX_SHARED_POOL_THREADS, DEFAULT_SHARED_POOL_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-spenderindex", strprintf("Maintain an index of the transactions spending every output, used by the gettxspendingprevout RPC to look up confirmed spends (default: %u)", DEFAULT_SPENDERINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #if HAVE_SYSTEM
     argsman.AddArg("-startupnotify=<cmd>", "Execute command on startup.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-shutdownnotify=<cmd>", "Execute command immediately before beginning shutdown. The need for shutdown may be urgent, so be careful not to delay it long (if the command doesn't require interaction with the server, consider having it fork into the background).", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-txindexcompact", strprintf("Store the -txindex in a compact format, keyed by a prefix of the transaction hash and locating transactions by block height and position. It takes less than half the space, but every lookup reads the whole block (default: %u)", DEFAULT_TXINDEX_COMPACT), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-validationcallbackthreads=<n>", strprintf("Set the number of threads delivering validation notifications to wallets, indexes and other subscribers. "
+        "Each subscriber then gets its own queue of notifications, so that a slow one does not delay the others (0 = deliver them to all subscribers in series on the scheduler thread, up to %d, default: %d)",
+        MAX_VALIDATION_CALLBACK_THREADS, DEFAULT_VALIDATION_CALLBACK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-utxoscanthreads=<n>", strprintf("Set the number of threads reading the UTXO set concurrently in scantxoutset, gettxoutsetinfo without coinstatsindex and chunked dumptxoutset (0 = auto, up to %d, default: %d)", kernel::MAX_UTXO_SCAN_THREADS, kernel::DEFAULT_UTXO_SCAN_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blockfilterindex=<type>",
                  strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
                  " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
@@ -535,7 +616,10 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-maxconnections=<n>", strprintf("Maintain at most <n> automatic connections to peers (default: %u). This limit does not apply to connections manually added via -addnode or the addnode RPC, which have a separate limit of %u.", DEFAULT_MAX_PEER_CONNECTIONS, MAX_ADDNODE_CONNECTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-maxreceivebuffer=<n>", strprintf("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXRECEIVEBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-maxsendbuffer=<n>", strprintf("Maximum per-connection memory usage for the send buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXSENDBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-maxtotalsendbuffer=<n>", strprintf("Maximum memory usage for the send buffers of all connections together, <n>*1000 bytes. Above it, no new messages are produced for peers whose send buffer is not empty (default: %u)", DEFAULT_MAXTOTALSENDBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-maxuploadrate=<n>", strprintf("Limit outbound traffic to <n>*1000 bytes per second, shared between propagation of new blocks, transaction relay and serving of historical blocks and filters by their weights (%u:%u:%u). Idle capacity is used by busy classes. Does not apply to peers with 'download' permission. 0 = no limit (default: %u)", DEFAULT_TRAFFIC_CLASS_WEIGHTS[0], DEFAULT_TRAFFIC_CLASS_WEIGHTS[1], DEFAULT_TRAFFIC_CLASS_WEIGHTS[2], DEFAULT_MAX_UPLOAD_RATE), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-maxuploadtarget=<n>", strprintf("Tries to keep outbound traffic under the given target per 24h. Limit does not apply to peers with 'download' permission or blocks created within past week. 0 = no limit (default: %s). Optional suffix units [k|K|m|M|g|G|t|T] (default: M). Lowercase is 1000 base while uppercase is 1024 base", DEFAULT_MAX_UPLOAD_TARGET), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-msghandlerthreads=<n>", strprintf("Number of threads to process p2p messages with, each handling a fixed share of the peers. Pings are answered without waiting for the other threads (1 to %d, default: %d)", MAX_MESSAGE_HANDLER_THREADS, DEFAULT_MESSAGE_HANDLER_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
 #ifdef HAVE_SOCKADDR_UN
     argsman.AddArg("-onion=<ip:port|path>", "Use separate SOCKS5 proxy to reach peers via Tor onion services, set -noonion to disable (default: -proxy). May be a local file path prefixed with 'unix:'.", ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
 #else
@@ -571,6 +655,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
                    OptionsCategory::CONNECTION);
     argsman.AddArg("-proxyrandomize", strprintf("Randomize credentials for every proxy connection. This enables Tor stream isolation (default: %u)", DEFAULT_PROXYRANDOMIZE), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-seednode=<ip>", "Connect to a node to retrieve peer addresses, and disconnect. This option can be specified multiple times to connect to multiple nodes. During startup, seednodes will be tried before dnsseeds.", ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-netepoll", strprintf("Wait on p2p sockets with a persistent epoll set instead of rebuilding a poll() set on every loop (only on Linux, default: %u)", DEFAULT_NET_EPOLL), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::CONNECTION);
     argsman.AddArg("-networkactive", "Enable all P2P network activity (default: 1). Can be changed by the setnetworkactive RPC command", ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-timeout=<n>", strprintf("Specify socket connection timeout in milliseconds. If an initial attempt to connect is unsuccessful after this amount of time, drop it (minimum: 1, default: %d)", DEFAULT_CONNECT_TIMEOUT), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-peertimeout=<n>", strprintf("Specify a p2p connection timeout delay in seconds. After connecting to a peer, wait this amount of time before considering disconnection based on inactivity (minimum: 1, default: %d)", DEFAULT_PEER_CONNECT_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::CONNECTION);
@@ -594,23 +679,31 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubrawtxbatch=<address>", "Enable publish raw transactions in batches in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequence=<address>", "Enable publish hash block and tx sequence in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubrawtxbatchhwm=<n>", strprintf("Set publish raw transaction batch outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubrawtxbatchinterval=<n>", strprintf("Set the number of milliseconds transactions are held to be published together by -zmqpubrawtxbatch (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_TX_BATCH_INTERVAL_MS), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequencehwm=<n>", strprintf("Set publish hash sequence message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqrepmempool=<address>", "Reply to requests in <address> with a snapshot of the mempool and its mempool sequence number", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
+    hidden_args.emplace_back("-zmqpubrawtxbatch=<address>");
     hidden_args.emplace_back("-zmqpubsequence=<n>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
+    hidden_args.emplace_back("-zmqpubrawtxbatchhwm=<n>");
+    hidden_args.emplace_back("-zmqpubrawtxbatchinterval=<n>");
     hidden_args.emplace_back("-zmqpubsequencehwm=<n>");
+    hidden_args.emplace_back("-zmqrepmempool=<address>");
 #endif
 
     argsman.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -621,6 +714,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     // Checkpoints were removed. We keep `-checkpoints` as a hidden arg to display a more user friendly error when set.
     argsman.AddArg("-checkpoints", "", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     argsman.AddArg("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-lockstats", strprintf("Record the time spent waiting for and holding locks, by lock and acquisition site, for the getlockstats RPC (default: %u)", DEFAULT_LOCKSTATS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-stopafterblockimport", strprintf("Stop running after importing blocks from disk (default: %u)", DEFAULT_STOPAFTERBLOCKIMPORT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-stopatheight", strprintf("Stop running after reaching the given height in the main chain (default: %u)", DEFAULT_STOPATHEIGHT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-limitancestorcount=<n>", strprintf("Do not accept transactions if number of in-mempool ancestors is <n> or more (default: %u)", DEFAULT_ANCESTOR_LIMIT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -629,6 +723,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-limitdescendantsize=<n>", strprintf("Do not accept transactions if any ancestor would have more than <n> kilobytes of in-mempool descendants (default: %u).", DEFAULT_DESCENDANT_SIZE_LIMIT_KVB), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-test=<option>", "Pass a test-only option. Options include : " + Join(TEST_OPTIONS_DOC, ", ") + ".", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-capturemessages", "Capture all P2P messages to disk", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-msgprocstats", strprintf("Record the time spent processing received P2P messages, by message type and by peer, see getmsgprocstats (default: %u)", DEFAULT_MSGPROC_STATS), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-mocktime=<n>", "Replace actual time with " + UNIX_EPOCH_TIME + " (default: 0)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_VALIDATION_CACHE_BYTES >> 20), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-maxtipage=<n>",
@@ -662,23 +757,28 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-blockmaxweight=<n>", strprintf("Set maximum BIP141 block weight (default: %d)", DEFAULT_BLOCK_MAX_WEIGHT), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-blockreservedweight=<n>", strprintf("Reserve space for the fixed-size block header plus the largest coinbase transaction the mining software may add to the block. (default: %d).", DEFAULT_BLOCK_RESERVED_WEIGHT), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-blockmintxfee=<amt>", strprintf("Set lowest fee rate (in %s/kvB) for transactions to be included in block creation. (default: %s)", CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
+    argsman.AddArg("-blocktemplatemaxage=<n>", strprintf("Serve a cached block template for up to <n> seconds after the mempool changed, as long as the tip is unchanged and its transactions are still in the mempool. A template is always reused while the mempool is unchanged (default: %d)", DEFAULT_BLOCK_TEMPLATE_MAX_AGE), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-blockversion=<n>", "Override block version to test forking scenarios", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::BLOCK_CREATION);
 
     argsman.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-metrics", strprintf("Serve metrics in the OpenMetrics text format at /metrics on the RPC port, to any client allowed by -rpcallowip and without authentication (default: %u)", DEFAULT_METRICS_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid values for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0), a network/CIDR (e.g. 1.2.3.4/24), all ipv4 (0.0.0.0/0), or all ipv6 (::/0). RFC4193 is allowed only if -cjdnsreachable=0. This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
+    argsman.AddArg("-rpcbatchthreads=<n>", strprintf("Set the maximum number of threads executing the requests of one JSON-RPC batch, taken from idle -rpcthreads (default: %d)", DEFAULT_RPC_BATCH_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcbind=<addr>[:port]", "Bind to given address to listen for JSON-RPC connections. Do not expose the RPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -rpcport. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost)", ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcdoccheck", strprintf("Throw a non-fatal error at runtime if the documentation for an RPC is incorrect (default: %u)", DEFAULT_RPC_DOC_CHECK), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpccookiefile=<loc>", "Location of the auth cookie. Relative paths will be prefixed by a net-specific datadir location. (default: data dir)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpccookieperms=<readable-by>", strprintf("Set permissions on the RPC auth cookie file so that it is readable by [owner|group|all] (default: owner [via umask 0077])"), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcport=<port>", strprintf("Listen for JSON-RPC connections on <port> (default: %u, testnet3: %u, testnet4: %u, signet: %u, regtest: %u)", defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort(), testnet4BaseParams->RPCPort(), signetBaseParams->RPCPort(), regtestBaseParams->RPCPort()), ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcserverthreads=<n>", strprintf("Set the number of event threads accepting RPC connections and parsing requests (1 to %d, default: %d)", MAX_HTTP_SERVER_THREADS, DEFAULT_HTTP_SERVER_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcthreads=<n>", strprintf("Set the number of threads to service RPC calls (default: %d)", DEFAULT_HTTP_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelist=<whitelist>", "Set a whitelist to filter incoming RPC calls for a specific user. The field <whitelist> comes in the format: <USERNAME>:<rpc 1>,<rpc 2>,...,<rpc n>. If multiple whitelists are set for a given user, they are set-intersected. See -rpcwhitelistdefault documentation for information on default whitelist behavior.", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelistdefault", "Sets default behavior for rpc whitelisting. Unless rpcwhitelistdefault is set to 0, if any -rpcwhitelist is set, the rpc server acts as if all rpc users are subject to empty-unless-otherwise-specified whitelists. If rpcwhitelistdefault is set to 1 and no -rpcwhitelist is set, rpc server acts as if all rpc users are subject to empty whitelists.", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcworkqueue=<n>", strprintf("Set the maximum depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcworkqueuewait=<n>", strprintf("Let a request wait up to <n> milliseconds for room in a full work queue before rejecting it. Meanwhile no further requests are read from its connection (default: %d)", DEFAULT_HTTP_WORKQUEUE_WAIT), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-server", "Accept command line and JSON-RPC commands", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     if (can_listen_ipc) {
         argsman.AddArg("-ipcbind=<address>", "Bind to Unix socket address and listen for incoming connections. Valid address values are \"unix\" to listen on the default path, <datadir>/node.sock, or \"unix:/custom/path\" to specify a custom path. Can be specified multiple times to listen on multiple paths. Default behavior is not to listen on any path. If relative paths are specified, they are interpreted relative to the network data directory. If paths include any parent directory components and the parent directories do not exist, they will be created.", ArgsManager::ALLOW_ANY, OptionsCategory::IPC);
@@ -718,6 +818,7 @@ static bool AppInitServers(NodeContext& node)
     if (!StartHTTPRPC(&node))
         return false;
     if (args.GetBoolArg("-rest", DEFAULT_REST_ENABLE)) StartREST(&node);
+    if (args.GetBoolArg("-metrics", DEFAULT_METRICS_ENABLE)) StartHTTPMetrics();
     StartHTTPServer();
     return true;
 }
@@ -929,6 +1030,8 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         return InitError(strprintf(_("Specified blocks directory \"%s\" does not exist."), args.GetArg("-blocksdir", "")));
     }
 
+    g_lock_stats_enabled = args.GetBoolArg("-lockstats", DEFAULT_LOCKSTATS);
+
     // parse and validate enabled filter types
     std::string blockfilterindex_value = args.GetArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX);
     if (blockfilterindex_value == "" || blockfilterindex_value == "1") {
@@ -961,6 +1064,8 @@ bool AppInitParameterInteraction(const ArgsManager& args)
     if (args.GetIntArg("-prune", 0)) {
         if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (args.GetBoolArg("-spenderindex", DEFAULT_SPENDERINDEX))
+            return InitError(_("Prune mode is incompatible with -spenderindex."));
         if (args.GetBoolArg("-reindex-chainstate", false)) {
             return InitError(_("Prune mode is incompatible with -reindex-chainstate. Use full -reindex instead."));
         }
@@ -1192,7 +1297,9 @@ bool CheckHostPortOptions(const ArgsManager& args) {
         {"-zmqpubhashtx",    true,                false},
         {"-zmqpubrawblock",  true,                false},
         {"-zmqpubrawtx",     true,                false},
+        {"-zmqpubrawtxbatch", true,               false},
         {"-zmqpubsequence",  true,                false},
+        {"-zmqrepmempool",   true,                false},
     }) {
         for (const std::string& param_value : args.GetArgs(param_name)) {
             const std::string param_value_hostport{
@@ -1252,6 +1359,7 @@ static ChainstateLoadResult InitAndLoadChainstate(
             .path = args.GetDataDirNet() / "blocks" / "index",
             .cache_bytes = cache_sizes.block_tree_db,
             .wipe_data = do_reindex,
+            .tuning = DB_TUNING_APPEND,
         },
     };
     Assert(ApplyArgsManOptions(args, blockman_opts)); // no error can happen, already checked in AppInitParameterInteraction
@@ -1269,6 +1377,9 @@ static ChainstateLoadResult InitAndLoadChainstate(
     }
     ChainstateManager& chainman = *node.chainman;
     if (chainman.m_interrupt) return {ChainstateLoadStatus::INTERRUPTED, {}};
+    if (ShouldPersistValidationCache(args)) {
+        LoadValidationCache(chainman.m_validation_cache, ValidationCachePath(args));
+    }
 
     // This is defined and set here instead of inline in validation.h to avoid a hard
     // dependency between validation and index/base, since the latter is not in
@@ -1348,6 +1459,29 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
 
     LogPrintf("Using at most %i automatic connections (%i file descriptors available)\n", nMaxConnections, available_fds);
 
+    // Before any cache is allocated or thread started, as threads inherit the
+    // CPUs the calling thread can run on.
+    if (args.IsArgSet("-numanode")) {
+        const int64_t numa_node{args.GetIntArg("-numanode", 0)};
+        const auto cpus{numa_node >= 0 && numa_node <= std::numeric_limits<int>::max() ? util::GetNumaNodeCpus(static_cast<int>(numa_node)) : std::nullopt};
+        if (!cpus || cpus->empty() || !util::SetThreadAffinity(*cpus)) {
+            return InitError(strprintf(_("Unable to run on the CPUs of NUMA node %d."), numa_node));
+        }
+        LogPrintf("Running on the %u CPUs of NUMA node %d\n", cpus->size(), numa_node);
+    } else if (const auto numa_nodes{util::GetNumaNodes()}; numa_nodes && numa_nodes->size() > 1) {
+        LogPrintf("Running on the CPUs of %u NUMA nodes, see -numanode\n", numa_nodes->size());
+    }
+
+    if (args.GetBoolArg("-hugepages", DEFAULT_HUGE_PAGES)) {
+        // Reads e.g. "always [madvise] never", with the mode in use in brackets.
+        const auto [ok, thp_mode]{ReadBinaryFile("/sys/kernel/mm/transparent_hugepage/enabled", /*maxsize=*/1024)};
+        if (ok && thp_mode.find("[never]") == std::string::npos) {
+            LogPrintf("Backing the coins cache and the script execution and signature caches with transparent huge pages\n");
+        } else {
+            LogWarning("Transparent huge pages are not enabled, -hugepages falls back to regular pages");
+        }
+    }
+
     // Warn about relative -datadir path.
     if (args.IsArgSet("-datadir") && !args.GetPathArg("-datadir").is_absolute()) {
         LogPrintf("Warning: relative datadir option '%s' specified, which will be interpreted relative to the "
@@ -1361,8 +1495,15 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     node.scheduler = std::make_unique<CScheduler>();
     auto& scheduler = *node.scheduler;
 
-    // Start the lightweight task scheduler thread
-    scheduler.m_service_thread = std::thread(util::TraceThread, "scheduler", [&] { scheduler.serviceQueue(); });
+    // Start the lightweight task scheduler threads, background tasks getting
+    // their own so that they do not delay the others.
+    scheduler.m_service_thread = std::thread(util::TraceThread, "scheduler", [&] { scheduler.serviceTaskClass(CScheduler::TaskClass::DEFAULT); });
+    scheduler.m_background_thread = std::thread(util::TraceThread, "schedbg", [&] { scheduler.serviceTaskClass(CScheduler::TaskClass::BACKGROUND); });
+
+    // -sharedthreads=0 means one thread per core
+    int shared_pool_threads{int(args.GetIntArg("-sharedthreads", DEFAULT_SHARED_POOL_THREADS))};
+    if (shared_pool_threads <= 0) shared_pool_threads = GetNumCores();
+    GetSharedThreadPool().Start(std::clamp(shared_pool_threads, 1, MAX_SHARED_POOL_THREADS));
 
     // Gather some entropy once per minute.
     scheduler.scheduleEvery([]{
@@ -1378,7 +1519,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                 LogError("Failed to send shutdown signal after disk space check\n");
             }
         }
-    }, std::chrono::minutes{5});
+    }, std::chrono::minutes{5}, CScheduler::TaskClass::BACKGROUND);
 
     LogInstance().SetRateLimiting(std::make_unique<BCLog::LogRateLimiter>(
         [&scheduler](auto func, auto window) { scheduler.scheduleEvery(std::move(func), window); },
@@ -1386,7 +1527,19 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         1h));
 
     assert(!node.validation_signals);
-    node.validation_signals = std::make_unique<ValidationSignals>(std::make_unique<SerialTaskRunner>(scheduler));
+    if (const int callback_threads{std::clamp<int>(args.GetIntArg("-validationcallbackthreads", DEFAULT_VALIDATION_CALLBACK_THREADS), 0, MAX_VALIDATION_CALLBACK_THREADS)}; callback_threads > 0) {
+        node.validation_scheduler = std::make_unique<CScheduler>();
+        auto& validation_scheduler{*node.validation_scheduler};
+        for (int n{0}; n < callback_threads; ++n) {
+            node.validation_scheduler_threads.emplace_back(util::TraceThread, strprintf("valcb.%d", n), [&] { validation_scheduler.serviceQueue(); });
+        }
+        LogInfo("Delivering validation notifications with %d threads\n", callback_threads);
+        node.validation_signals = std::make_unique<ValidationSignals>([&validation_scheduler](std::function<void()> func) {
+            validation_scheduler.schedule(std::move(func), std::chrono::steady_clock::now());
+        });
+    } else {
+        node.validation_signals = std::make_unique<ValidationSignals>(std::make_unique<SerialTaskRunner>(scheduler));
+    }
     auto& validation_signals = *node.validation_signals;
 
     // Create client interfaces for wallets that are supposed to be loaded
@@ -1533,7 +1686,8 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
 
         // Flush estimates to disk periodically
         CBlockPolicyEstimator* fee_estimator = node.fee_estimator.get();
-        scheduler.scheduleEvery([fee_estimator] { fee_estimator->FlushFeeEstimates(); }, FEE_FLUSH_INTERVAL);
+        scheduler.scheduleEvery([fee_estimator] { fee_estimator->FlushFeeEstimates(); }, FEE_FLUSH_INTERVAL, CScheduler::TaskClass::BACKGROUND);
+        fee_estimator->StartWorker();
         validation_signals.RegisterValidationInterface(fee_estimator);
     }
 
@@ -1687,6 +1841,9 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         [&chainman = node.chainman](std::vector<std::byte>& block, const CBlockIndex& index) {
             assert(chainman);
             return chainman->m_blockman.ReadRawBlock(block, WITH_LOCK(cs_main, return index.GetBlockPos()));
+        },
+        [&mempool = node.mempool]() -> std::shared_ptr<const MempoolSnapshot> {
+            return mempool ? mempool->GetSnapshot() : nullptr;
         });
 
     if (g_zmq_notification_interface) {
@@ -1767,10 +1924,15 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                                      peerman_opts);
     validation_signals.RegisterValidationInterface(node.peerman.get());
 
+#ifdef ENABLE_ZMQ
+    // The mempool is set up for good now, so it can be served.
+    if (g_zmq_notification_interface) g_zmq_notification_interface->StartMempoolServer();
+#endif
+
     // ********************************************************* Step 8: start indexers
 
     if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
-        g_txindex = std::make_unique<TxIndex>(interfaces::MakeChain(node), index_cache_sizes.tx_index, false, do_reindex);
+        g_txindex = std::make_unique<TxIndex>(interfaces::MakeChain(node), index_cache_sizes.tx_index, false, do_reindex, args.GetBoolArg("-txindexcompact", DEFAULT_TXINDEX_COMPACT));
         node.indexes.emplace_back(g_txindex.get());
     }
 
@@ -1784,8 +1946,36 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         node.indexes.emplace_back(g_coin_stats_index.get());
     }
 
+    if (args.GetBoolArg("-blockstatsindex", DEFAULT_BLOCKSTATSINDEX)) {
+        g_block_stats_index = std::make_unique<BlockStatsIndex>(interfaces::MakeChain(node), /*cache_size=*/0, false, do_reindex);
+        node.indexes.emplace_back(g_block_stats_index.get());
+    }
+
+    if (args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX)) {
+        g_scripthash_index = std::make_unique<ScriptHashIndex>(interfaces::MakeChain(node), /*cache_size=*/0, false, do_reindex);
+        node.indexes.emplace_back(g_scripthash_index.get());
+    }
+
+    if (args.GetBoolArg("-spenderindex", DEFAULT_SPENDERINDEX)) {
+        g_spender_index = std::make_unique<SpenderIndex>(interfaces::MakeChain(node), /*cache_size=*/0, false, do_reindex);
+        node.indexes.emplace_back(g_spender_index.get());
+    }
+
     // Init indexes
-    for (auto index : node.indexes) if (!index->Init()) return false;
+    // -indexsyncthreads=0 means one thread per core
+    int index_sync_threads{int(args.GetIntArg("-indexsyncthreads", DEFAULT_INDEX_SYNC_THREADS))};
+    if (index_sync_threads <= 0) index_sync_threads = GetNumCores();
+    index_sync_threads = std::clamp(index_sync_threads, 1, MAX_INDEX_SYNC_THREADS);
+    const Throttle index_sync_throttle{uint64_t(std::max<int64_t>(args.GetIntArg("-indexsyncreadrate", DEFAULT_INDEX_SYNC_READ_RATE), 0)) << 20,
+                                       int(args.GetIntArg("-indexsynccpushare", DEFAULT_INDEX_SYNC_CPU_SHARE))};
+    // Indexes catching up at the same time read every block only once.
+    const auto block_cache{node.indexes.size() > 1 ? std::make_shared<IndexBlockCache>() : nullptr};
+    for (auto index : node.indexes) {
+        index->SetSyncThreads(index_sync_threads);
+        index->SetBlockCache(block_cache);
+        index->SetSyncThrottle(index_sync_throttle);
+        if (!index->Init()) return false;
+    }
 
     // ********************************************************* Step 9: load wallet
     for (const auto& client : node.chain_clients) {
@@ -1884,6 +2074,11 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
             chainman.GetNotifications().fatalError(err_str);
             return;
         }
+        // Warm up the coins cache with the coins it held before the restart,
+        // before the mempool, whose transactions spend many of them.
+        if (ShouldPersistCoinsCache(args)) {
+            LoadCoinsCache(chainman.ActiveChainstate(), CoinsCachePath(args), chainman.m_interrupt);
+        }
         // Load mempool from disk
         if (auto* pool{chainman.ActiveChainstate().GetMempool()}) {
             LoadMempool(*pool, ShouldPersistMempool(args) ? MempoolPath(args) : fs::path{}, chainman.ActiveChainstate(), {});
@@ -1945,10 +2140,14 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     connOptions.m_banman = node.banman.get();
     connOptions.m_msgproc = node.peerman.get();
     connOptions.nSendBufferMaxSize = 1000 * args.GetIntArg("-maxsendbuffer", DEFAULT_MAXSENDBUFFER);
+    connOptions.m_total_send_buffer_max_size = 1000 * args.GetIntArg("-maxtotalsendbuffer", DEFAULT_MAXTOTALSENDBUFFER);
     connOptions.nReceiveFloodSize = 1000 * args.GetIntArg("-maxreceivebuffer", DEFAULT_MAXRECEIVEBUFFER);
     connOptions.m_added_nodes = args.GetArgs("-addnode");
     connOptions.nMaxOutboundLimit = *opt_max_upload;
+    connOptions.m_max_upload_rate = 1000 * uint64_t(std::max<int64_t>(0, args.GetIntArg("-maxuploadrate", DEFAULT_MAX_UPLOAD_RATE)));
     connOptions.m_peer_connect_timeout = peer_connect_timeout;
+    connOptions.m_use_epoll = args.GetBoolArg("-netepoll", DEFAULT_NET_EPOLL);
+    connOptions.m_message_handler_threads = args.GetIntArg("-msghandlerthreads", DEFAULT_MESSAGE_HANDLER_THREADS);
     connOptions.whitelist_forcerelay = args.GetBoolArg("-whitelistforcerelay", DEFAULT_WHITELISTFORCERELAY);
     connOptions.whitelist_relay = args.GetBoolArg("-whitelistrelay", DEFAULT_WHITELISTRELAY);
 
@@ -2109,7 +2308,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     BanMan* banman = node.banman.get();
     scheduler.scheduleEvery([banman]{
         banman->DumpBanlist();
-    }, DUMP_BANS_INTERVAL);
+    }, DUMP_BANS_INTERVAL, CScheduler::TaskClass::BACKGROUND);
 
     if (node.peerman) node.peerman->StartScheduledTasks(scheduler);
 
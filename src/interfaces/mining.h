@@ -37,6 +37,16 @@ public:
     // Block contains a dummy coinbase transaction that should not be used.
     virtual CBlock getBlock() = 0;
 
+    /**
+     * Serialize the block returned by getBlock() into a shared memory segment
+     * instead of sending it over the IPC connection, which saves copying large
+     * templates through the socket.
+     *
+     * @returns the segment, which stays available as long as this template,
+     *          or nothing if shared memory is not supported.
+     */
+    virtual std::optional<node::SharedMemoryRef> getBlockSharedMemory() = 0;
+
     // Fees per transaction, not including coinbase transaction.
     virtual std::vector<CAmount> getTxFees() = 0;
     // Sigop cost per transaction, not including coinbase transaction.
@@ -47,7 +57,9 @@ public:
     virtual int getWitnessCommitmentIndex() = 0;
 
     /**
-     * Compute merkle path to the coinbase transaction
+     * Merkle path to the coinbase transaction, computed once with the
+     * template: the merkle root of a block with another coinbase is the
+     * coinbase hash combined with it, without hashing the other transactions.
      *
      * @return merkle path ordered from the deepest
      */
@@ -72,6 +84,15 @@ public:
      * the tip is more than 20 minutes old.
      */
     virtual std::unique_ptr<BlockTemplate> waitNext(const node::BlockWaitOptions options = {}) = 0;
+
+    /**
+     * Changes of the block relative to the template this one was returned
+     * for by waitNext(), which usually are a few transactions, so that
+     * clients can update the previous block instead of calling getBlock().
+     *
+     * @returns the diff, or nothing if this template was not returned by waitNext().
+     */
+    virtual std::optional<node::BlockTemplateDiff> getDiff() = 0;
 };
 
 //! Interface giving clients (RPC, Stratum v2 Template Provider in the future)
@@ -256,6 +256,9 @@ public:
     //! Get tx confirm target.
     virtual unsigned int getConfirmTarget() = 0;
 
+    //! Get estimate of the memory used by the wallet transactions.
+    virtual size_t getMemoryUsage() = 0;
+
     // Return whether HD enabled.
     virtual bool hdEnabled() = 0;
 
@@ -1,11 +1,316 @@
 // Copyright (c) 2022 The Bitcoin Core developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kernel/bitcoinkernel.h>
+
+#include <chain.h>
+#include <consensus/validation.h>
+#include <kernel/caches.h>
+#include <kernel/chainparams.h>
+#include <kernel/checks.h>
+#include <kernel/context.h>
+#include <kernel/notifications_interface.h>
+#include <kernel/warning.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <node/chainstate.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <streams.h>
+#include <sync.h>
+#include <undo.h>
+#include <util/fs.h>
+#include <util/signalinterrupt.h>
+#include <util/task_runner.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
+#include <validation.h>
+#include <validationinterface.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <list>
+#include <memory>
+#include <span>
 #include <string>
+#include <thread>
+#include <vector>
 
 // Define G_TRANSLATION_FUN symbol in libbitcoinkernel library so users of the
 // library aren't required to export this symbol
 extern const TranslateFn G_TRANSLATION_FUN{nullptr};
+
+namespace {
+
+std::unique_ptr<const CChainParams> ChainParamsFor(kernel_ChainType chain_type)
+{
+    switch (chain_type) {
+    case kernel_CHAIN_TYPE_MAINNET: return CChainParams::Main();
+    case kernel_CHAIN_TYPE_TESTNET: return CChainParams::TestNet();
+    case kernel_CHAIN_TYPE_TESTNET_4: return CChainParams::TestNet4();
+    case kernel_CHAIN_TYPE_SIGNET: return CChainParams::SigNet(CChainParams::SigNetOptions{});
+    case kernel_CHAIN_TYPE_REGTEST: return CChainParams::RegTest(CChainParams::RegTestOptions{});
+    }
+    return nullptr;
+}
+
+//! Number of script check threads besides the validation thread, following the
+//! convention of -par for values <= 0.
+int ScriptCheckThreads(int verification_threads)
+{
+    if (verification_threads < 0) {
+        verification_threads += static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    return std::clamp(verification_threads, 0, MAX_SCRIPTCHECK_THREADS);
+}
+
+class KernelNotifications final : public kernel::Notifications
+{
+public:
+    void flushError(const bilingual_str& message) override
+    {
+        LogError("Error flushing block data to disk: %s\n", message.original);
+    }
+    void fatalError(const bilingual_str& message) override
+    {
+        LogError("Fatal error: %s\n", message.original);
+    }
+};
+
+//! Records the validation state of the block being processed, which
+//! ProcessNewBlock only reports through the BlockChecked signal. Only used from
+//! the thread processing blocks.
+class BlockStateCatcher final : public CValidationInterface
+{
+public:
+    uint256 m_hash;
+    bool m_found{false};
+    BlockValidationState m_state;
+
+    void Reset(const uint256& hash)
+    {
+        m_hash = hash;
+        m_found = false;
+        m_state = {};
+    }
+
+protected:
+    void BlockChecked(const CBlock& block, const BlockValidationState& state) override
+    {
+        if (block.GetHash() != m_hash) return;
+        m_found = true;
+        m_state = state;
+    }
+};
+
+} // namespace
+
+struct kernel_ChainstateManager {
+    kernel::Context m_context;
+    std::unique_ptr<const CChainParams> m_chainparams;
+    KernelNotifications m_notifications;
+    ValidationSignals m_signals{std::make_unique<util::ImmediateTaskRunner>()};
+    util::SignalInterrupt m_interrupt;
+    std::unique_ptr<ChainstateManager> m_chainman;
+    std::shared_ptr<BlockStateCatcher> m_state_catcher{std::make_shared<BlockStateCatcher>()};
+    //! Single worker validating the submitted batches in order. Declared last
+    //! so that it is stopped before anything it uses is destroyed.
+    ThreadPool m_pool{"kernelblocks"};
+
+    kernel_BlockProcessingResult ProcessBlock(const std::shared_ptr<CBlock>& block)
+    {
+        {
+            LOCK(::cs_main);
+            const CBlockIndex* prev{m_chainman->m_blockman.LookupBlockIndex(block->hashPrevBlock)};
+            if (prev) m_chainman->UpdateUncommittedBlockStructures(*block, prev);
+        }
+        m_state_catcher->Reset(block->GetHash());
+        bool new_block{false};
+        const bool accepted{m_chainman->ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, &new_block)};
+        if (!accepted) return kernel_BLOCK_INVALID;
+        if (!new_block) return kernel_BLOCK_DUPLICATE;
+        if (!m_state_catcher->m_found) return kernel_BLOCK_INCONCLUSIVE;
+        return m_state_catcher->m_state.IsValid() ? kernel_BLOCK_ACCEPTED : kernel_BLOCK_INVALID;
+    }
+
+    //! Look up the block at the given height of the active chain, returning
+    //! null unless its status includes the given flag.
+    const CBlockIndex* LookupActive(int32_t height, uint32_t status) const
+    {
+        LOCK(::cs_main);
+        const CBlockIndex* index{m_chainman->ActiveChain()[height]};
+        if (!index || !(index->nStatus & status)) return nullptr;
+        return index;
+    }
+};
+
+void kernel_logging_set_callback(kernel_LogCallback callback, void* user_data)
+{
+    static std::list<std::function<void(const std::string&)>>::iterator g_callback;
+    static bool g_connected{false};
+    if (g_connected) {
+        LogInstance().DeleteCallback(g_callback);
+        g_connected = false;
+    }
+    if (!callback) {
+        LogInstance().DisableLogging();
+        return;
+    }
+    LogInstance().m_print_to_console = false;
+    LogInstance().m_print_to_file = false;
+    g_callback = LogInstance().PushBackCallback([callback, user_data](const std::string& message) {
+        callback(user_data, message.data(), message.size());
+    });
+    g_connected = true;
+    LogInstance().StartLogging();
+}
+
+kernel_ChainstateManager* kernel_chainstate_manager_create(
+    kernel_ChainType chain_type,
+    const char* data_dir, size_t data_dir_len,
+    int verification_threads)
+{
+    try {
+        auto chainman{std::make_unique<kernel_ChainstateManager>()};
+        if (!kernel::SanityChecks(chainman->m_context)) return nullptr;
+        chainman->m_chainparams = ChainParamsFor(chain_type);
+        if (!chainman->m_chainparams) return nullptr;
+
+        const fs::path abs_datadir{fs::absolute(fs::PathFromString({data_dir, data_dir_len}))};
+        fs::create_directories(abs_datadir);
+        const kernel::CacheSizes cache_sizes{DEFAULT_KERNEL_CACHE};
+        const ChainstateManager::Options chainman_opts{
+            .chainparams = *chainman->m_chainparams,
+            .datadir = abs_datadir,
+            .notifications = chainman->m_notifications,
+            .signals = &chainman->m_signals,
+            .worker_threads_num = ScriptCheckThreads(verification_threads),
+        };
+        const node::BlockManager::Options blockman_opts{
+            .chainparams = chainman_opts.chainparams,
+            .blocks_dir = abs_datadir / "blocks",
+            .notifications = chainman_opts.notifications,
+            .block_tree_db_params = DBParams{
+                .path = abs_datadir / "blocks" / "index",
+                .cache_bytes = cache_sizes.block_tree_db,
+                .tuning = DB_TUNING_APPEND,
+            },
+        };
+        chainman->m_chainman = std::make_unique<ChainstateManager>(chainman->m_interrupt, chainman_opts, blockman_opts);
+
+        node::ChainstateLoadOptions options;
+        auto [status, error] = node::LoadChainstate(*chainman->m_chainman, cache_sizes, options);
+        if (status == node::ChainstateLoadStatus::SUCCESS) {
+            std::tie(status, error) = node::VerifyLoadedChainstate(*chainman->m_chainman, options);
+        }
+        if (status != node::ChainstateLoadStatus::SUCCESS) {
+            LogError("Failed to load chainstate: %s\n", error.original);
+            return nullptr;
+        }
+        for (Chainstate* chainstate : WITH_LOCK(::cs_main, return chainman->m_chainman->GetAll())) {
+            BlockValidationState state;
+            if (!chainstate->ActivateBestChain(state, nullptr)) {
+                LogError("Failed to connect best block: %s\n", state.ToString());
+                return nullptr;
+            }
+        }
+
+        chainman->m_signals.RegisterSharedValidationInterface(chainman->m_state_catcher);
+        chainman->m_pool.Start(1);
+        return chainman.release();
+    } catch (const std::exception& e) {
+        LogError("Failed to create chainstate manager: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void kernel_chainstate_manager_destroy(kernel_ChainstateManager* chainman)
+{
+    if (!chainman) return;
+    chainman->m_pool.Stop();
+    chainman->m_signals.UnregisterSharedValidationInterface(chainman->m_state_catcher);
+    chainman->m_signals.FlushBackgroundCallbacks();
+    {
+        LOCK(::cs_main);
+        for (Chainstate* chainstate : chainman->m_chainman->GetAll()) {
+            if (chainstate->CanFlushToDisk()) {
+                chainstate->ForceFlushStateToDisk();
+                chainstate->ResetCoinsViews();
+            }
+        }
+    }
+    delete chainman;
+}
+
+int kernel_chainstate_manager_submit_blocks(
+    kernel_ChainstateManager* chainman,
+    const unsigned char* const* blocks, const size_t* block_lens, size_t count,
+    kernel_BlockProcessed callback, void* user_data)
+{
+    // Deserialize on the caller's thread so the caller's buffers are not used
+    // after returning. Null entries stand for blocks failing to deserialize.
+    std::vector<std::shared_ptr<CBlock>> batch(count);
+    for (size_t i{0}; i < count; ++i) {
+        try {
+            auto block{std::make_shared<CBlock>()};
+            SpanReader{std::span{blocks[i], block_lens[i]}} >> TX_WITH_WITNESS(*block);
+            batch[i] = std::move(block);
+        } catch (const std::exception&) {
+        }
+    }
+    try {
+        (void)chainman->m_pool.Submit([chainman, batch = std::move(batch), callback, user_data] {
+            for (size_t i{0}; i < batch.size(); ++i) {
+                const auto result{batch[i] ? chainman->ProcessBlock(batch[i]) : kernel_BLOCK_DESERIALIZATION_FAILED};
+                if (callback) callback(user_data, i, result);
+            }
+        });
+    } catch (const std::exception&) {
+        return -1;
+    }
+    return 0;
+}
+
+void kernel_chainstate_manager_wait(kernel_ChainstateManager* chainman)
+{
+    // The pool has a single worker taking tasks in order, so once an empty task
+    // has run, so have all the batches submitted before it.
+    chainman->m_pool.Submit([] {}).wait();
+}
+
+int32_t kernel_chainstate_manager_get_height(const kernel_ChainstateManager* chainman)
+{
+    return WITH_LOCK(::cs_main, return chainman->m_chainman->ActiveHeight());
+}
+
+int kernel_chainstate_manager_read_block(
+    const kernel_ChainstateManager* chainman, int32_t height,
+    kernel_WriteBytes writer, void* user_data)
+{
+    const CBlockIndex* index{chainman->LookupActive(height, BLOCK_HAVE_DATA)};
+    if (!index) return -1;
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return index->GetBlockPos())};
+    std::vector<std::byte> block;
+    if (!chainman->m_chainman->m_blockman.ReadRawBlock(block, pos)) return -1;
+    writer(user_data, reinterpret_cast<const unsigned char*>(block.data()), block.size());
+    return 0;
+}
+
+int kernel_chainstate_manager_read_block_undo(
+    const kernel_ChainstateManager* chainman, int32_t height,
+    kernel_WriteBytes writer, void* user_data)
+{
+    if (height <= 0) return -1;
+    const CBlockIndex* index{chainman->LookupActive(height, BLOCK_HAVE_UNDO)};
+    if (!index) return -1;
+    CBlockUndo undo;
+    if (!chainman->m_chainman->m_blockman.ReadBlockUndo(undo, *index)) return -1;
+    DataStream stream;
+    stream << undo;
+    writer(user_data, reinterpret_cast<const unsigned char*>(stream.data()), stream.size());
+    return 0;
+}
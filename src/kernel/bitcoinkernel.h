@@ -0,0 +1,164 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_KERNEL_BITCOINKERNEL_H
+#define BITCOIN_KERNEL_BITCOINKERNEL_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#endif // __cplusplus
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @file bitcoinkernel.h
+ *
+ * C interface to the validation engine of libbitcoinkernel.
+ *
+ * IMPORTANT: THIS INTERFACE IS EXPERIMENTAL AND MAY CHANGE IN FUTURE VERSIONS.
+ *
+ * A kernel_ChainstateManager owns a chainstate in a data directory. Blocks are
+ * submitted to it in batches of serialized blocks and validated on a thread
+ * owned by the chainstate manager, in submission order; a callback reports the
+ * result of each block as it is done. Script checks are spread over the number
+ * of verification threads the host requests when creating the chainstate
+ * manager.
+ *
+ * Stored blocks and undo data can be read from any thread, concurrently with
+ * block validation. Only the lookup of their position on disk takes the
+ * validation lock; reading and serializing them does not.
+ *
+ * Unless documented otherwise, pointer arguments must not be null, and byte
+ * arrays are passed as a pointer and a length. Functions returning int return
+ * 0 on success and -1 on failure.
+ */
+
+/** Opaque chainstate manager. */
+typedef struct kernel_ChainstateManager kernel_ChainstateManager;
+
+/** Chain the chainstate manager validates. */
+typedef enum {
+    kernel_CHAIN_TYPE_MAINNET = 0,
+    kernel_CHAIN_TYPE_TESTNET = 1,
+    kernel_CHAIN_TYPE_TESTNET_4 = 2,
+    kernel_CHAIN_TYPE_SIGNET = 3,
+    kernel_CHAIN_TYPE_REGTEST = 4,
+} kernel_ChainType;
+
+/** Outcome of processing one submitted block. */
+typedef enum {
+    //! The block is valid and was not known before.
+    kernel_BLOCK_ACCEPTED = 0,
+    //! The block was already known.
+    kernel_BLOCK_DUPLICATE = 1,
+    //! The block, or the chain it builds on, is invalid.
+    kernel_BLOCK_INVALID = 2,
+    //! The block was stored but not validated yet, e.g. because its parent is
+    //! not known or it is not on the most-work chain.
+    kernel_BLOCK_INCONCLUSIVE = 3,
+    //! The submitted bytes are not a serialized block.
+    kernel_BLOCK_DESERIALIZATION_FAILED = 4,
+} kernel_BlockProcessingResult;
+
+/**
+ * Called once for every block of a submitted batch, in order, from the
+ * validation thread of the chainstate manager.
+ *
+ * @param[in] user_data The user_data passed along with the batch.
+ * @param[in] index     Position of the block in its batch.
+ * @param[in] result    Outcome of processing the block.
+ */
+typedef void (*kernel_BlockProcessed)(void* user_data, size_t index, kernel_BlockProcessingResult result);
+
+/** Receives serialized data; the bytes are only valid during the call. */
+typedef void (*kernel_WriteBytes)(void* user_data, const unsigned char* bytes, size_t bytes_len);
+
+/** Receives a log message; the message is only valid during the call. */
+typedef void (*kernel_LogCallback)(void* user_data, const char* message, size_t message_len);
+
+/**
+ * Send the log messages of the library to the callback instead of buffering
+ * them. Logging is disabled when callback is null. Call this before creating
+ * a chainstate manager; messages logged before or while changing the callback
+ * may be dropped.
+ */
+void kernel_logging_set_callback(kernel_LogCallback callback, void* user_data);
+
+/**
+ * Open or create the chainstate in data_dir and connect the best chain known
+ * to it.
+ *
+ * @param[in] chain_type          Chain to validate.
+ * @param[in] data_dir            Data directory, created if needed. Blocks are stored in its "blocks" subdirectory.
+ * @param[in] data_dir_len        Length of data_dir.
+ * @param[in] verification_threads Number of threads running script checks, in addition to the validation thread.
+ *                                0 runs them on the validation thread, and a negative value leaves that many cores free.
+ * @return                        The chainstate manager, or null on failure.
+ */
+kernel_ChainstateManager* kernel_chainstate_manager_create(
+    kernel_ChainType chain_type,
+    const char* data_dir, size_t data_dir_len,
+    int verification_threads);
+
+/**
+ * Wait for the submitted blocks to be processed, flush the chainstate to disk
+ * and release the chainstate manager. Null is ignored.
+ */
+void kernel_chainstate_manager_destroy(kernel_ChainstateManager* chainman);
+
+/**
+ * Submit a batch of serialized blocks for validation and return without
+ * waiting for them to be processed. The blocks are copied, so the buffers can
+ * be released as soon as this returns. Batches are processed in the order they
+ * are submitted, and callback is called for each block as it is done with.
+ *
+ * @param[in] blocks     Serialized blocks.
+ * @param[in] block_lens Length of each serialized block.
+ * @param[in] count      Number of blocks in the batch.
+ * @param[in] callback   Called with the result of each block. May be null.
+ * @param[in] user_data  Passed to callback.
+ */
+int kernel_chainstate_manager_submit_blocks(
+    kernel_ChainstateManager* chainman,
+    const unsigned char* const* blocks, const size_t* block_lens, size_t count,
+    kernel_BlockProcessed callback, void* user_data);
+
+/** Wait for all blocks submitted so far to be processed. */
+void kernel_chainstate_manager_wait(kernel_ChainstateManager* chainman);
+
+/** Return the height of the tip of the active chain, or -1 if it is empty. */
+int32_t kernel_chainstate_manager_get_height(const kernel_ChainstateManager* chainman);
+
+/**
+ * Write the serialized block at the given height of the active chain.
+ *
+ * @return 0 if the block was written, -1 if there is no such block or its data
+ *         is not available (e.g. pruned).
+ */
+int kernel_chainstate_manager_read_block(
+    const kernel_ChainstateManager* chainman, int32_t height,
+    kernel_WriteBytes writer, void* user_data);
+
+/**
+ * Write the serialized undo data of the block at the given height of the
+ * active chain, holding the outputs it spent.
+ *
+ * @return 0 if the undo data was written, -1 if there is no such block, it is
+ *         the genesis block, or its undo data is not available.
+ */
+int kernel_chainstate_manager_read_block_undo(
+    const kernel_ChainstateManager* chainman, int32_t height,
+    kernel_WriteBytes writer, void* user_data);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // __cplusplus
+
+#endif // BITCOIN_KERNEL_BITCOINKERNEL_H
@@ -16,6 +16,16 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+/** Default for -reindexscanthreads, the number of threads scanning block files during -reindex (0 = disabled) */
+static constexpr int DEFAULT_REINDEX_SCAN_THREADS{0};
+/** Maximum number of threads scanning block files during -reindex */
+static constexpr int MAX_REINDEX_SCAN_THREADS{16};
+/** Default for -blockdatacache, the memory in MiB for recently read blocks and undo data */
+static constexpr int64_t DEFAULT_BLOCK_DATA_CACHE_MIB{16};
+/** Maximum for -blockdatacache in MiB */
+static constexpr int64_t MAX_BLOCK_DATA_CACHE_MIB{1024};
+/** Default for -coldblocksdepth, the depth below the tip from which block files are moved to -coldblocksdir */
+static constexpr int DEFAULT_COLD_BLOCKS_DEPTH{4320};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -26,7 +36,15 @@ struct BlockManagerOpts {
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
     uint64_t prune_target{0};
     bool fast_prune{false};
+    //! Number of threads scanning block files for blocks ahead of -reindex accepting them. Zero scans and accepts on one thread.
+    int reindex_scan_threads{DEFAULT_REINDEX_SCAN_THREADS};
+    //! Memory for recently read raw blocks and undo data from the newest block files, split evenly between the two.
+    size_t block_data_cache_bytes{DEFAULT_BLOCK_DATA_CACHE_MIB << 20};
     const fs::path blocks_dir;
+    //! Directory block and undo files are moved to once all their blocks are
+    //! cold_blocks_depth deep below the tip, or empty to keep them in blocks_dir.
+    fs::path cold_blocks_dir{};
+    int cold_blocks_depth{DEFAULT_COLD_BLOCKS_DEPTH};
     Notifications& notifications;
     DBParams block_tree_db_params;
 };
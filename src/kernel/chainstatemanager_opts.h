@@ -22,6 +22,9 @@ class CChainParams;
 class ValidationSignals;
 
 static constexpr auto DEFAULT_MAX_TIP_AGE{24h};
+static constexpr bool DEFAULT_BATCH_SCHNORR{false};
+static constexpr bool DEFAULT_DBCACHE_DYNAMIC{false};
+static constexpr bool DEFAULT_HUGE_PAGES{false};
 
 namespace kernel {
 
@@ -46,8 +49,29 @@ struct ChainstateManagerOpts {
     ValidationSignals* signals{nullptr};
     //! Number of script check worker threads. Zero means no parallel verification.
     int worker_threads_num{0};
+    //! Number of threads dedicated to the background chainstate of a snapshot: one connecting its
+    //! blocks and the rest running its script checks. Zero connects them on the thread processing
+    //! blocks for the active chainstate, sharing its script check workers.
+    int background_worker_threads_num{0};
     size_t script_execution_cache_bytes{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES};
     size_t signature_cache_bytes{DEFAULT_SIGNATURE_CACHE_BYTES};
+    //! Advise the coins cache and the script execution and signature caches to be backed by huge pages.
+    bool huge_pages{DEFAULT_HUGE_PAGES};
+    //! Number of blocks to read and deserialize ahead of ConnectTip. Zero disables the read-ahead stage.
+    int block_read_ahead{0};
+    //! Number of I/O threads reading blocks ahead, i.e. the number of block reads in flight at once.
+    int block_read_ahead_threads{2};
+    //! Number of threads looking up block inputs in the UTXO database before ConnectBlock. Zero disables prefetching.
+    int input_prefetch_threads{0};
+    //! Number of threads hashing and checking the proof of work of received headers. Zero checks them on the calling thread.
+    int header_check_threads{0};
+    //! Number of modified coins written to the coins database per incremental flush step. Zero disables incremental flushing.
+    int64_t coins_flush_chunk{0};
+    //! Defer the Schnorr signature checks of each input in ConnectBlock and verify them together.
+    bool batch_schnorr{DEFAULT_BATCH_SCHNORR};
+    //! If set, the coins cache is sized during IBD to use the memory this
+    //! returns as available (in bytes), instead of the configured size.
+    std::function<std::optional<uint64_t>()> available_memory{};
 };
 
 } // namespace kernel
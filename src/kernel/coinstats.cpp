@@ -20,15 +20,19 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <cassert>
+#include <future>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -91,13 +95,50 @@ static void ApplyCoinHash(std::nullptr_t, const COutPoint& outpoint, const Coin&
 template <typename T>
 static void ApplyHash(T& hash_obj, const Txid& hash, const std::map<uint32_t, Coin>& outputs)
 {
-    for (auto it = outputs.begin(); it != outputs.end(); ++it) {
-        COutPoint outpoint = COutPoint(hash, it->first);
-        Coin coin = it->second;
-        ApplyCoinHash(hash_obj, outpoint, coin);
+    for (const auto& [n, coin] : outputs) {
+        ApplyCoinHash(hash_obj, COutPoint{hash, n}, coin);
+    }
+}
+
+//! Like ApplyCoinHash() for each output, but with one serialization buffer.
+static void ApplyHash(MuHash3072& muhash, const Txid& hash, const std::map<uint32_t, Coin>& outputs)
+{
+    DataStream ss{};
+    for (const auto& [n, coin] : outputs) {
+        ss.clear();
+        TxOutSer(ss, COutPoint{hash, n}, coin);
+        muhash.Insert(MakeUCharSpan(ss));
     }
 }
 
+void SerializedCoinsHasher::HashOutputs()
+{
+    ApplyHash(m_hash_writer, m_txid, m_outputs);
+    m_outputs.clear();
+}
+
+void SerializedCoinsHasher::Add(const COutPoint& outpoint, const Coin& coin)
+{
+    if (!m_ordered) return;
+    if (!m_outputs.empty() && outpoint.hash != m_txid) {
+        // Keys of the coins database sort like txids, so a txid coming after a
+        // greater one or again after another one is out of order.
+        if (outpoint.hash < m_txid) {
+            m_ordered = false;
+            return;
+        }
+        HashOutputs();
+    }
+    m_txid = outpoint.hash;
+    if (!m_outputs.emplace(outpoint.n, coin).second) m_ordered = false;
+}
+
+uint256 SerializedCoinsHasher::Finalize()
+{
+    if (!m_outputs.empty()) HashOutputs();
+    return m_hash_writer.GetHash();
+}
+
 static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
 {
     assert(!outputs.empty());
@@ -111,20 +152,17 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Add the statistics of the coins visited by `cursor`.
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ComputeUTXOStats(CCoinsViewCursor& cursor, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
@@ -137,12 +175,78 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
             LogError("%s: unable to read value\n", __func__);
             return false;
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+//! Add the statistics computed over a disjoint range of the coins.
+static void AddStats(CCoinsStats& stats, const CCoinsStats& other)
+{
+    stats.nTransactions += other.nTransactions;
+    stats.nTransactionOutputs += other.nTransactionOutputs;
+    stats.nBogoSize += other.nBogoSize;
+    stats.coins_count += other.coins_count;
+    // Amounts are not negative, so the total overflows if and only if a partial one does.
+    if (stats.total_amount.has_value() && other.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *other.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
+
+static void AddHash(MuHash3072& muhash, const MuHash3072& other) { muhash *= other; }
+static void AddHash(std::nullptr_t, std::nullptr_t) {}
+
+//! Add the statistics of the coins of `view`, reading disjoint ranges of them concurrently.
+template <typename T>
+static bool ComputeShardedUTXOStats(CCoinsView* view, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point, int threads)
+{
+    const auto cursors{view->Cursors(threads)};
+    assert(!cursors.empty());
+    ThreadPool pool{"utxostats"};
+    pool.Start(cursors.size());
+    std::vector<std::future<std::optional<std::pair<CCoinsStats, T>>>> results;
+    for (const auto& cursor : cursors) {
+        results.push_back(pool.Submit([&, &range = *cursor]() -> std::optional<std::pair<CCoinsStats, T>> {
+            std::pair<CCoinsStats, T> result{};
+            if (!ComputeUTXOStats(range, result.first, result.second, interruption_point)) return std::nullopt;
+            return result;
+        }));
+    }
+    // Wait for all ranges before returning, even if one of them failed.
+    bool success{true};
+    for (auto& future : results) {
+        const auto result{future.get()};
+        if (!result) {
+            success = false;
+            continue;
+        }
+        AddStats(stats, result->first);
+        AddHash(hash_obj, result->second);
+    }
+    return success;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point, int threads)
+{
+    bool success{false};
+    // The serialized hash depends on the order of the coins, so it can only
+    // be computed by a single thread.
+    if (std::is_same_v<T, HashWriter> || threads <= 1) {
+        std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
+        assert(pcursor);
+        success = ComputeUTXOStats(*pcursor, stats, hash_obj, interruption_point);
+    } else if constexpr (!std::is_same_v<T, HashWriter>) {
+        success = ComputeShardedUTXOStats(view, stats, hash_obj, interruption_point, threads);
+    }
+    if (!success) return false;
 
     FinalizeHash(hash_obj, stats);
 
@@ -151,7 +255,7 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int threads)
 {
     CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
     CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
@@ -160,14 +264,14 @@ std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsV
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return ComputeUTXOStats(view, stats, ss, interruption_point, threads);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            return ComputeUTXOStats(view, stats, muhash, interruption_point, threads);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            return ComputeUTXOStats(view, stats, nullptr, interruption_point, threads);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
@@ -5,13 +5,17 @@
 #ifndef BITCOIN_KERNEL_COINSTATS_H
 #define BITCOIN_KERNEL_COINSTATS_H
 
+#include <coins.h>
 #include <consensus/amount.h>
 #include <crypto/muhash.h>
+#include <hash.h>
+#include <primitives/transaction.h>
 #include <streams.h>
 #include <uint256.h>
 
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <optional>
 
 class CCoinsView;
@@ -23,6 +27,11 @@ class BlockManager;
 } // namespace node
 
 namespace kernel {
+//! -utxoscanthreads default; 0 means one thread per core.
+static constexpr int DEFAULT_UTXO_SCAN_THREADS{0};
+//! Maximum number of threads scanning the UTXO set at once.
+static constexpr int MAX_UTXO_SCAN_THREADS{16};
+
 enum class CoinStatsHashType {
     HASH_SERIALIZED,
     MUHASH,
@@ -76,7 +85,41 @@ uint64_t GetBogoSize(const CScript& script_pub_key);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+/**
+ * Compute the HASH_SERIALIZED hash of a set of coins as they are streamed,
+ * e.g. while loading a UTXO snapshot, instead of reading them back from a
+ * view. The coins must come in the key order of the coins database, which is
+ * the order snapshots are written in: once they do not, IsOrdered() returns
+ * false and the hash must be computed from a view of the coins instead.
+ */
+class SerializedCoinsHasher
+{
+    HashWriter m_hash_writer{};
+    //! Outputs of the txid being added, hashed in the order of their index
+    //! once the next txid comes, like ComputeUTXOStats() does.
+    Txid m_txid;
+    std::map<uint32_t, Coin> m_outputs;
+    bool m_ordered{true};
+
+    void HashOutputs();
+
+public:
+    void Add(const COutPoint& outpoint, const Coin& coin);
+    //! Whether the txids came in ascending order and no outpoint came twice.
+    bool IsOrdered() const { return m_ordered; }
+    //! The hash of the coins added, if IsOrdered().
+    uint256 Finalize();
+};
+
+/**
+ * Calculate statistics about the unspent transaction output set of `view`.
+ *
+ * With more than one thread, disjoint ranges of the coins are read
+ * concurrently (see CCoinsView::Cursors) and their statistics are combined.
+ * HASH_SERIALIZED depends on the order of the coins and is always computed
+ * by a single thread.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, int threads = 1);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
@@ -8,18 +8,24 @@
 #include <consensus/amount.h>
 #include <consensus/validation.h>
 #include <core_memusage.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <policy/settings.h>
+#include <prevector.h>
 #include <primitives/transaction.h>
+#include <script/interpreter.h>
+#include <util/check.h>
 #include <util/epochguard.h>
 #include <util/overflow.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
+#include <utility>
 
 class CBlockIndex;
 
@@ -50,6 +56,59 @@ struct CompareIteratorByHash {
     }
 };
 
+/**
+ * Set of entries, kept sorted by txid in a prevector.
+ *
+ * Most transactions have no more than a couple of in-mempool parents and
+ * children. A std::set allocates a node for every one of them, while this
+ * stores up to N inline in the entry and any others in a single array.
+ * Inserting and erasing are linear, which is fine for the small sizes seen
+ * for links between entries; graph walks collecting many entries should use
+ * a std::set instead.
+ */
+template <unsigned int N, typename T>
+class SortedPrevectorSet
+{
+    prevector<N, T> m_elems;
+
+public:
+    using const_iterator = typename prevector<N, T>::const_iterator;
+    using iterator = const_iterator;
+
+    const_iterator begin() const { return m_elems.begin(); }
+    const_iterator end() const { return m_elems.end(); }
+    const_iterator cbegin() const { return m_elems.begin(); }
+    const_iterator cend() const { return m_elems.end(); }
+    size_t size() const { return m_elems.size(); }
+    bool empty() const { return m_elems.empty(); }
+
+    const_iterator find(const T& value) const
+    {
+        const auto it{std::lower_bound(m_elems.begin(), m_elems.end(), value, CompareIteratorByHash{})};
+        return it != m_elems.end() && !CompareIteratorByHash{}(value, *it) ? it : m_elems.end();
+    }
+    size_t count(const T& value) const { return find(value) != end(); }
+    bool contains(const T& value) const { return find(value) != end(); }
+
+    std::pair<const_iterator, bool> insert(const T& value)
+    {
+        auto it{std::lower_bound(m_elems.begin(), m_elems.end(), value, CompareIteratorByHash{})};
+        if (it != m_elems.end() && !CompareIteratorByHash{}(value, *it)) return {it, false};
+        return {m_elems.insert(it, value), true};
+    }
+
+    size_t erase(const T& value)
+    {
+        const auto it{std::lower_bound(m_elems.begin(), m_elems.end(), value, CompareIteratorByHash{})};
+        if (it == m_elems.end() || CompareIteratorByHash{}(value, *it)) return 0;
+        m_elems.erase(it);
+        return 1;
+    }
+
+    //! Memory allocated outside of the set itself.
+    size_t DynamicMemoryUsage() const { return memusage::DynamicUsage(m_elems); }
+};
+
 /** \class CTxMemPoolEntry
  *
  * CTxMemPoolEntry stores data about the corresponding transaction, as well
@@ -67,8 +126,10 @@ class CTxMemPoolEntry
 public:
     typedef std::reference_wrapper<const CTxMemPoolEntry> CTxMemPoolEntryRef;
     // two aliases, should the types ever diverge
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Parents;
-    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
+    typedef SortedPrevectorSet<2, CTxMemPoolEntryRef> Parents;
+    typedef SortedPrevectorSet<2, CTxMemPoolEntryRef> Children;
+    //! Set of entries for walking the graph of in-mempool ancestors or descendants.
+    typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Entries;
 
 private:
     CTxMemPoolEntry(const CTxMemPoolEntry&) = default;
@@ -76,19 +137,19 @@ private:
         explicit ExplicitCopyTag() = default;
     };
 
+    // Members are ordered by size to avoid padding.
     const CTransactionRef tx;
     mutable Parents m_parents;
     mutable Children m_children;
     const CAmount nFee;             //!< Cached to avoid expensive parent-transaction lookups
-    const int32_t nTxWeight;         //!< ... and avoid recomputing tx weight (also used for GetTxSize())
     const size_t nUsageSize;        //!< ... and total memory usage
     const int64_t nTime;            //!< Local time when entering the mempool
     const uint64_t entry_sequence;  //!< Sequence number used to determine whether this transaction is too recent for relay
-    const unsigned int entryHeight; //!< Chain height when entering the mempool
-    const bool spendsCoinbase;      //!< keep track of transactions that spend a coinbase
     const int64_t sigOpCost;        //!< Total sigop cost
     CAmount m_modified_fee;         //!< Used for determining the priority of the transaction for mining in a block
     mutable LockPoints lockPoints;  //!< Track the height and time at which tx was final
+    const int32_t nTxWeight;        //!< ... and avoid recomputing tx weight (also used for GetTxSize())
+    const unsigned int entryHeight; //!< Chain height when entering the mempool
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -104,6 +165,12 @@ private:
     int64_t nSizeWithAncestors;
     CAmount nModFeesWithAncestors;
     int64_t nSigOpCostWithAncestors;
+    const bool spendsCoinbase;      //!< keep track of transactions that spend a coinbase
+
+    //! Sighash midstates computed when the transaction was validated, for reuse when it is
+    //! validated in a block. Null if there were none (for example for legacy-only spends).
+    mutable std::shared_ptr<const PrecomputedTransactionData> m_precomputed_txdata;
+    mutable size_t m_precomputed_txdata_usage{0};
 
 public:
     CTxMemPoolEntry(const CTransactionRef& tx, CAmount fee,
@@ -112,20 +179,20 @@ public:
                     int64_t sigops_cost, LockPoints lp)
         : tx{tx},
           nFee{fee},
-          nTxWeight{GetTransactionWeight(*tx)},
           nUsageSize{RecursiveDynamicUsage(tx)},
           nTime{time},
           entry_sequence{entry_sequence},
-          entryHeight{entry_height},
-          spendsCoinbase{spends_coinbase},
           sigOpCost{sigops_cost},
           m_modified_fee{nFee},
           lockPoints{lp},
+          nTxWeight{GetTransactionWeight(*tx)},
+          entryHeight{entry_height},
           nSizeWithDescendants{GetTxSize()},
           nModFeesWithDescendants{nFee},
           nSizeWithAncestors{GetTxSize()},
           nModFeesWithAncestors{nFee},
-          nSigOpCostWithAncestors{sigOpCost} {}
+          nSigOpCostWithAncestors{sigOpCost},
+          spendsCoinbase{spends_coinbase} {}
 
     CTxMemPoolEntry(ExplicitCopyTag, const CTxMemPoolEntry& entry) : CTxMemPoolEntry(entry) {}
     CTxMemPoolEntry& operator=(const CTxMemPoolEntry&) = delete;
@@ -147,7 +214,7 @@ public:
     uint64_t GetSequence() const { return entry_sequence; }
     int64_t GetSigOpCost() const { return sigOpCost; }
     CAmount GetModifiedFee() const { return m_modified_fee; }
-    size_t DynamicMemoryUsage() const { return nUsageSize; }
+    size_t DynamicMemoryUsage() const { return nUsageSize + m_precomputed_txdata_usage; }
     const LockPoints& GetLockPoints() const { return lockPoints; }
 
     // Adjusts the descendant state.
@@ -162,6 +229,19 @@ public:
         m_modified_fee = SaturatingAdd(m_modified_fee, fee_diff);
     }
 
+    const std::shared_ptr<const PrecomputedTransactionData>& GetPrecomputedTxData() const { return m_precomputed_txdata; }
+    /** Keep the data precomputed for the validation of the transaction. As this changes
+     *  the memory usage of the entry, it must be set before the entry is added to a mempool. */
+    void SetPrecomputedTxData(PrecomputedTransactionData&& txdata) const
+    {
+        Assume(!m_precomputed_txdata);
+        m_precomputed_txdata = std::make_shared<const PrecomputedTransactionData>(std::move(txdata));
+        m_precomputed_txdata_usage = memusage::DynamicUsage(m_precomputed_txdata) + memusage::DynamicUsage(m_precomputed_txdata->m_spent_outputs);
+        for (const CTxOut& out : m_precomputed_txdata->m_spent_outputs) {
+            m_precomputed_txdata_usage += RecursiveDynamicUsage(out);
+        }
+    }
+
     // Update the LockPoints after a reorg
     void UpdateLockPoints(const LockPoints& lp) const
     {
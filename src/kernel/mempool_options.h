@@ -21,8 +21,12 @@ static constexpr unsigned int DEFAULT_MAX_MEMPOOL_SIZE_MB{300};
 static constexpr unsigned int DEFAULT_BLOCKSONLY_MAX_MEMPOOL_SIZE_MB{5};
 /** Default for -mempoolexpiry, expiration time for mempool transactions in hours */
 static constexpr unsigned int DEFAULT_MEMPOOL_EXPIRY_HOURS{336};
+/** Default for -mempoollogsize, number of mempool changes kept for getmempooldelta */
+static constexpr unsigned int DEFAULT_MEMPOOL_LOG_SIZE{50'000};
 /** Whether to fall back to legacy V1 serialization when writing mempool.dat */
 static constexpr bool DEFAULT_PERSIST_V1_DAT{false};
+/** Whether to evict the packages needed to get below -maxmempool in one batch */
+static constexpr bool DEFAULT_MEMPOOL_BATCH_TRIM{false};
 /** Default for -acceptnonstdtxn */
 static constexpr bool DEFAULT_ACCEPT_NON_STD_TXN{false};
 
@@ -40,6 +44,8 @@ struct MemPoolOptions {
     int64_t max_size_bytes{DEFAULT_MAX_MEMPOOL_SIZE_MB * 1'000'000};
     std::chrono::seconds expiry{std::chrono::hours{DEFAULT_MEMPOOL_EXPIRY_HOURS}};
     CFeeRate incremental_relay_feerate{DEFAULT_INCREMENTAL_RELAY_FEE};
+    /** Number of the last additions and removals of transactions logged for CTxMemPool::GetChanges() */
+    size_t log_size{DEFAULT_MEMPOOL_LOG_SIZE};
     /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
     CFeeRate min_relay_feerate{DEFAULT_MIN_RELAY_TX_FEE};
     CFeeRate dust_relay_feerate{DUST_RELAY_TX_FEE};
@@ -54,6 +60,11 @@ struct MemPoolOptions {
     bool permit_bare_multisig{DEFAULT_PERMIT_BAREMULTISIG};
     bool require_standard{true};
     bool persist_v1_dat{DEFAULT_PERSIST_V1_DAT};
+    /**
+     * When over max_size_bytes, select all packages needed to get below it
+     * at once and remove them together, instead of one package at a time.
+     */
+    bool batch_trim{DEFAULT_MEMPOOL_BATCH_TRIM};
     MemPoolLimits limits{};
 
     ValidationSignals* signals{nullptr};
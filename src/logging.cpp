@@ -15,6 +15,7 @@
 #include <cstring>
 #include <map>
 #include <optional>
+#include <thread>
 #include <utility>
 
 using util::Join;
@@ -97,6 +98,7 @@ bool BCLog::Logger::StartLogging()
 
 void BCLog::Logger::DisconnectTestLogger()
 {
+    StopAsyncWriter();
     StdLockGuard scoped_lock(m_cs);
     m_buffering = true;
     if (m_fileout != nullptr) fclose(m_fileout);
@@ -414,6 +416,7 @@ void BCLog::Logger::FormatLogStrInPlace(std::string& str, BCLog::LogFlags catego
 
 void BCLog::Logger::LogPrintStr(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
 {
+    if (m_async_active.load(std::memory_order_relaxed) && EnqueueAsync(str, std::move(source_loc), category, level, should_ratelimit)) return;
     StdLockGuard scoped_lock(m_cs);
     return LogPrintStr_(str, std::move(source_loc), category, level, should_ratelimit);
 }
@@ -421,22 +424,24 @@ void BCLog::Logger::LogPrintStr(std::string_view str, std::source_location&& sou
 // NOLINTNEXTLINE(misc-no-recursion)
 void BCLog::Logger::LogPrintStr_(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
 {
-    std::string str_prefixed = LogEscapeMessage(str);
+    LogPrintStr_(BufferedLog{
+                     .now = SystemClock::now(),
+                     .mocktime = GetMockTime(),
+                     .str = LogEscapeMessage(str),
+                     .threadname = util::ThreadGetInternalName(),
+                     .source_loc = std::move(source_loc),
+                     .category = category,
+                     .level = level,
+                 },
+                 should_ratelimit);
+}
 
+// NOLINTNEXTLINE(misc-no-recursion)
+void BCLog::Logger::LogPrintStr_(BufferedLog&& log, bool should_ratelimit)
+{
     if (m_buffering) {
-        {
-            BufferedLog buf{
-                .now = SystemClock::now(),
-                .mocktime = GetMockTime(),
-                .str = str_prefixed,
-                .threadname = util::ThreadGetInternalName(),
-                .source_loc = std::move(source_loc),
-                .category = category,
-                .level = level,
-            };
-            m_cur_buffer_memusage += MemUsage(buf);
-            m_msgs_before_open.push_back(std::move(buf));
-        }
+        m_cur_buffer_memusage += MemUsage(log);
+        m_msgs_before_open.push_back(std::move(log));
 
         while (m_cur_buffer_memusage > m_max_buffer_memusage) {
             if (m_msgs_before_open.empty()) {
@@ -451,7 +456,9 @@ void BCLog::Logger::LogPrintStr_(std::string_view str, std::source_location&& so
         return;
     }
 
-    FormatLogStrInPlace(str_prefixed, category, level, source_loc, util::ThreadGetInternalName(), SystemClock::now(), GetMockTime());
+    std::string& str_prefixed{log.str};
+    const std::source_location& source_loc{log.source_loc};
+    FormatLogStrInPlace(str_prefixed, log.category, log.level, source_loc, log.threadname, log.now, log.mocktime);
     bool ratelimit{false};
     if (should_ratelimit && m_limiter) {
         auto status{m_limiter->Consume(source_loc, str_prefixed)};
@@ -500,6 +507,95 @@ void BCLog::Logger::LogPrintStr_(std::string_view str, std::source_location&& so
     }
 }
 
+bool BCLog::Logger::EnqueueAsync(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
+{
+    // Only capture what can not be recovered later; escaping and formatting
+    // are left to the writer thread.
+    AsyncLog entry{
+        .log = {
+            .now = SystemClock::now(),
+            .mocktime = GetMockTime(),
+            .str = std::string{str},
+            .threadname = util::ThreadGetInternalName(),
+            .source_loc = std::move(source_loc),
+            .category = category,
+            .level = level,
+        },
+        .should_ratelimit = should_ratelimit,
+    };
+    const size_t usage{MemUsage(entry.log)};
+    bool notify;
+    {
+        StdLockGuard scoped_lock(m_async_mutex);
+        if (!m_async_running) return false;
+        if (m_async_memusage + usage > m_max_async_memusage) {
+            ++m_async_lines_dropped;
+            ++m_async_lines_dropped_total;
+            return true;
+        }
+        // The writer takes the whole queue at once, so it only needs to be
+        // woken up for the first message.
+        notify = m_async_queue.empty();
+        m_async_memusage += usage;
+        m_async_queue.push_back(std::move(entry));
+    }
+    if (notify) m_async_cond.notify_one();
+    return true;
+}
+
+void BCLog::Logger::AsyncWriterThread()
+{
+    util::ThreadRename("logger");
+    std::vector<AsyncLog> batch;
+    while (true) {
+        bool running;
+        uint64_t dropped;
+        {
+            StdLockGuard scoped_lock(m_async_mutex);
+            m_async_cond.wait(m_async_mutex, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_async_mutex) { return !m_async_running || !m_async_queue.empty(); });
+            batch.swap(m_async_queue);
+            m_async_memusage = 0;
+            dropped = std::exchange(m_async_lines_dropped, 0);
+            running = m_async_running;
+        }
+        // Take m_cs for each message rather than for the whole batch, as
+        // logging threads need it to look up category log levels.
+        for (auto& entry : batch) {
+            entry.log.str = LogEscapeMessage(entry.log.str);
+            StdLockGuard scoped_lock(m_cs);
+            LogPrintStr_(std::move(entry.log), entry.should_ratelimit);
+        }
+        batch.clear();
+        if (dropped > 0) {
+            StdLockGuard scoped_lock(m_cs);
+            LogPrintStr_(strprintf("Log queue full, %d log lines dropped.\n", dropped), std::source_location::current(), LogFlags::ALL, Level::Warning, /*should_ratelimit=*/false);
+        }
+        if (!running) break;
+    }
+}
+
+void BCLog::Logger::StartAsyncWriter(size_t max_queue_memusage)
+{
+    StdLockGuard scoped_lock(m_async_mutex);
+    assert(!m_async_running);
+    m_max_async_memusage = max_queue_memusage;
+    m_async_running = true;
+    m_async_active = true;
+    m_async_thread = std::thread(&Logger::AsyncWriterThread, this);
+}
+
+void BCLog::Logger::StopAsyncWriter()
+{
+    {
+        StdLockGuard scoped_lock(m_async_mutex);
+        if (!m_async_running) return;
+        m_async_running = false;
+        m_async_active = false;
+    }
+    m_async_cond.notify_one();
+    m_async_thread.join();
+}
+
 void BCLog::Logger::ShrinkDebugFile()
 {
     // Amount of debug.log to save at end when shrinking (must fit in memory)
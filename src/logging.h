@@ -14,6 +14,7 @@
 #include <util/time.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -21,6 +22,7 @@
 #include <mutex>
 #include <source_location>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -31,6 +33,7 @@ static const bool DEFAULT_LOGTIMESTAMPS = true;
 static const bool DEFAULT_LOGTHREADNAMES = false;
 static const bool DEFAULT_LOGSOURCELOCATIONS = false;
 static constexpr bool DEFAULT_LOGLEVELALWAYS = false;
+static constexpr bool DEFAULT_LOGASYNC = false;
 extern const char * const DEFAULT_DEBUGLOGFILE;
 
 extern bool fLogIPs;
@@ -104,6 +107,7 @@ namespace BCLog {
     };
     constexpr auto DEFAULT_LOG_LEVEL{Level::Debug};
     constexpr size_t DEFAULT_MAX_LOG_BUFFER{1'000'000}; // buffer up to 1MB of log data prior to StartLogging
+    constexpr size_t DEFAULT_MAX_ASYNC_LOG_BUFFER{8'000'000}; // queue up to 8MB of log data for the background writer before dropping messages
     constexpr uint64_t RATELIMIT_MAX_BYTES{1024 * 1024}; // maximum number of bytes that can be logged within one window
 
     //! Keeps track of an individual source location and how many available bytes are left for logging from it.
@@ -200,6 +204,28 @@ namespace BCLog {
         size_t m_cur_buffer_memusage GUARDED_BY(m_cs){0};
         size_t m_buffer_lines_discarded GUARDED_BY(m_cs){0};
 
+        //! A log message queued for the background writer, see StartAsyncWriter().
+        struct AsyncLog {
+            BufferedLog log;
+            bool should_ratelimit;
+        };
+
+        //! Protects the queue of the background writer. Messages are only
+        //! enqueued under this lock, so that logging threads never wait for
+        //! m_cs or for the log file to be written.
+        StdMutex m_async_mutex;
+        std::condition_variable_any m_async_cond;
+        std::vector<AsyncLog> m_async_queue GUARDED_BY(m_async_mutex);
+        size_t m_async_memusage GUARDED_BY(m_async_mutex){0};
+        size_t m_max_async_memusage GUARDED_BY(m_async_mutex){DEFAULT_MAX_ASYNC_LOG_BUFFER};
+        //! Lines dropped because the queue was full, since the last time that was logged.
+        uint64_t m_async_lines_dropped GUARDED_BY(m_async_mutex){0};
+        bool m_async_running GUARDED_BY(m_async_mutex){false};
+        //! Cached view on m_async_running, to keep the synchronous path free of m_async_mutex.
+        std::atomic<bool> m_async_active{false};
+        std::atomic<uint64_t> m_async_lines_dropped_total{0};
+        std::thread m_async_thread;
+
         //! Manages the rate limiting of each log location.
         std::unique_ptr<LogRateLimiter> m_limiter GUARDED_BY(m_cs);
 
@@ -223,6 +249,13 @@ namespace BCLog {
         /** Send a string to the log output (internal) */
         void LogPrintStr_(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
             EXCLUSIVE_LOCKS_REQUIRED(m_cs);
+        /** Send an escaped message, timestamped by its caller, to the log output (internal) */
+        void LogPrintStr_(BufferedLog&& log, bool should_ratelimit) EXCLUSIVE_LOCKS_REQUIRED(m_cs);
+
+        /** Queue a message for the background writer. Returns false if it is not running. */
+        bool EnqueueAsync(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
+            EXCLUSIVE_LOCKS_REQUIRED(!m_async_mutex);
+        void AsyncWriterThread() EXCLUSIVE_LOCKS_REQUIRED(!m_cs, !m_async_mutex);
 
         std::string GetLogPrefix(LogFlags category, Level level) const;
 
@@ -241,7 +274,7 @@ namespace BCLog {
 
         /** Send a string to the log output */
         void LogPrintStr(std::string_view str, std::source_location&& source_loc, BCLog::LogFlags category, BCLog::Level level, bool should_ratelimit)
-            EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
+            EXCLUSIVE_LOCKS_REQUIRED(!m_cs, !m_async_mutex);
 
         /** Returns whether logs will be written to any output */
         bool Enabled() const EXCLUSIVE_LOCKS_REQUIRED(!m_cs)
@@ -268,7 +301,19 @@ namespace BCLog {
         /** Start logging (and flush all buffered messages) */
         bool StartLogging() EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
         /** Only for testing */
-        void DisconnectTestLogger() EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
+        void DisconnectTestLogger() EXCLUSIVE_LOCKS_REQUIRED(!m_cs, !m_async_mutex);
+
+        /**
+         * Hand log messages over to a background thread, which formats and
+         * writes them, instead of writing them on the logging thread. Messages
+         * are dropped, and the number of dropped lines logged, when more than
+         * max_queue_memusage bytes of them are waiting to be written.
+         */
+        void StartAsyncWriter(size_t max_queue_memusage = DEFAULT_MAX_ASYNC_LOG_BUFFER) EXCLUSIVE_LOCKS_REQUIRED(!m_async_mutex);
+        /** Write all queued messages and stop the background writer, if running. */
+        void StopAsyncWriter() EXCLUSIVE_LOCKS_REQUIRED(!m_async_mutex);
+        /** Number of lines dropped by the background writer because its queue was full. */
+        uint64_t AsyncLinesDropped() const { return m_async_lines_dropped_total.load(); }
 
         void SetRateLimiting(std::unique_ptr<LogRateLimiter>&& limiter) EXCLUSIVE_LOCKS_REQUIRED(!m_cs)
         {
@@ -0,0 +1,76 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <logging/timer.h>
+
+#include <sync.h>
+#include <util/metrics.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+
+namespace BCLog {
+namespace detail {
+
+//! Scope path in the tree of the scopes timed by one thread.
+struct ScopeTimerNode {
+    std::string path;
+    metrics::Histogram* histogram{nullptr};
+    std::map<std::string, std::unique_ptr<ScopeTimerNode>, std::less<>> children;
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::ScopeTimerNode;
+
+//! Root of the scopes timed by this thread, and the innermost scope being timed.
+thread_local ScopeTimerNode g_root;
+thread_local ScopeTimerNode* g_current{&g_root};
+
+GlobalMutex g_scope_timers_mutex;
+//! Histograms of the paths timed by all threads. Never destroyed, as the
+//! histograms of the metrics registry they point to.
+auto& g_scope_timers GUARDED_BY(g_scope_timers_mutex){*new std::map<std::string, const metrics::Histogram*>};
+
+ScopeTimerNode* EnterScope(std::string_view name)
+{
+    ScopeTimerNode* parent{g_current};
+    auto it{parent->children.find(name)};
+    if (it == parent->children.end()) {
+        auto node{std::make_unique<ScopeTimerNode>()};
+        node->path = parent == &g_root ? std::string{name} : parent->path + '/' + std::string{name};
+        node->histogram = &metrics::GetRegistry().GetHistogram("bitcoin_scope_seconds", "Time spent in timed scopes of the code",
+                                                               metrics::DURATION_BUCKETS, {{"scope", node->path}});
+        WITH_LOCK(g_scope_timers_mutex, g_scope_timers.try_emplace(node->path, node->histogram));
+        it = parent->children.emplace(std::string{name}, std::move(node)).first;
+    }
+    g_current = it->second.get();
+    return g_current;
+}
+
+} // namespace
+
+ScopeTimer::ScopeTimer(std::string_view name)
+    : m_parent{g_current},
+      m_node{EnterScope(name)},
+      m_start{std::chrono::steady_clock::now()}
+{
+}
+
+ScopeTimer::~ScopeTimer()
+{
+    m_node->histogram->Observe(std::chrono::steady_clock::now() - m_start);
+    g_current = m_parent;
+}
+
+std::vector<std::pair<std::string, const metrics::Histogram*>> GetScopeTimers()
+{
+    LOCK(g_scope_timers_mutex);
+    return {g_scope_timers.begin(), g_scope_timers.end()};
+}
+
+} // namespace BCLog
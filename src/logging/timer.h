@@ -14,7 +14,19 @@
 #include <chrono>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+namespace metrics {
+class Histogram;
+} // namespace metrics
+
+namespace BCLog {
+namespace detail {
+struct ScopeTimerNode;
+} // namespace detail
+} // namespace BCLog
 
 namespace BCLog {
 
@@ -95,9 +107,41 @@ private:
     const bool m_message_on_completion;
 };
 
+/**
+ * RAII-style object that adds the time spent in a scope to a histogram, without
+ * logging anything.
+ *
+ * Scope timers nested on the same thread are named by the path of the
+ * enclosing scopes, e.g. "ActivateBestChain/ConnectTip". The histogram of each
+ * path is registered in the metrics registry as bitcoin_scope_seconds on first
+ * use and then cached per thread, so that a timer costs two clock reads and a
+ * lookup in a small map.
+ */
+class ScopeTimer
+{
+public:
+    //! @param[in] name  Name of the scope, without '/'.
+    explicit ScopeTimer(std::string_view name);
+    ~ScopeTimer();
+
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    detail::ScopeTimerNode* const m_parent;
+    detail::ScopeTimerNode* const m_node;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+//! Histograms of all the scope paths timed so far, by path.
+std::vector<std::pair<std::string, const metrics::Histogram*>> GetScopeTimers();
+
 } // namespace BCLog
 
 
+#define TIME_SCOPE(name) \
+    BCLog::ScopeTimer UNIQUE_NAME(scope_timer)(name)
+
 #define LOG_TIME_MICROS_WITH_CATEGORY(end_msg, log_category) \
     BCLog::Timer<std::chrono::microseconds> UNIQUE_NAME(logging_timer)(__func__, end_msg, log_category)
 #define LOG_TIME_MILLIS_WITH_CATEGORY(end_msg, log_category) \
@@ -29,6 +29,7 @@
 #include <random.h>
 #include <scheduler.h>
 #include <util/fs.h>
+#include <util/metrics.h>
 #include <util/sock.h>
 #include <util/strencodings.h>
 #include <util/thread.h>
@@ -45,6 +46,7 @@
 #include <functional>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 TRACEPOINT_SEMAPHORE(net, closed_connection);
 TRACEPOINT_SEMAPHORE(net, evicted_inbound_connection);
@@ -52,6 +54,18 @@ TRACEPOINT_SEMAPHORE(net, inbound_connection);
 TRACEPOINT_SEMAPHORE(net, outbound_connection);
 TRACEPOINT_SEMAPHORE(net, outbound_message);
 
+namespace {
+metrics::Counter& g_metric_bytes_recv{metrics::GetRegistry().GetCounter("bitcoin_net_received_bytes", "Bytes received from peers")};
+metrics::Counter& g_metric_bytes_sent{metrics::GetRegistry().GetCounter("bitcoin_net_sent_bytes", "Bytes sent to peers")};
+metrics::Gauge& g_metric_peers_inbound{metrics::GetRegistry().GetGauge("bitcoin_peers", "Connected peers, by direction", {{"direction", "inbound"}})};
+metrics::Gauge& g_metric_peers_outbound{metrics::GetRegistry().GetGauge("bitcoin_peers", "Connected peers, by direction", {{"direction", "outbound"}})};
+
+metrics::Gauge& PeersMetric(const CNode& node)
+{
+    return node.IsInboundConn() ? g_metric_peers_inbound : g_metric_peers_outbound;
+}
+} // namespace
+
 /** Maximum number of block-relay-only anchor connections */
 static constexpr size_t MAX_BLOCK_RELAY_ONLY_ANCHORS = 2;
 static_assert (MAX_BLOCK_RELAY_ONLY_ANCHORS <= static_cast<size_t>(MAX_BLOCK_RELAY_ONLY_CONNECTIONS), "MAX_BLOCK_RELAY_ONLY_ANCHORS must not exceed MAX_BLOCK_RELAY_ONLY_CONNECTIONS.");
@@ -120,7 +134,100 @@ std::string strSubVersion;
 
 size_t CSerializedNetMsg::GetMemoryUsage() const noexcept
 {
-    return sizeof(*this) + memusage::DynamicUsage(m_type) + memusage::DynamicUsage(data);
+    size_t usage{sizeof(*this) + memusage::DynamicUsage(m_type) + memusage::DynamicUsage(data)};
+    if (m_shared_data) usage += memusage::DynamicUsage(m_shared_data) + memusage::DynamicUsage(*m_shared_data);
+    return usage;
+}
+
+void CSerializedNetMsg::ClearPayload() noexcept
+{
+    ClearShrink(data);
+    m_shared_data.reset();
+}
+
+DataStream DataStreamPool::Get()
+{
+    LOCK(m_mutex);
+    if (m_buffers.empty()) return DataStream{};
+    DataStream stream{std::move(m_buffers.back())};
+    m_buffers.pop_back();
+    m_total_bytes -= stream.GetMemoryUsage();
+    return stream;
+}
+
+void DataStreamPool::Return(DataStream&& stream)
+{
+    stream.clear();
+    const size_t bytes{stream.GetMemoryUsage()};
+    // Moved-from streams have no buffer to reuse.
+    if (bytes <= sizeof(DataStream) || bytes > m_max_buffer_bytes) return;
+    LOCK(m_mutex);
+    if (m_total_bytes + bytes > m_max_total_bytes) return;
+    m_total_bytes += bytes;
+    m_buffers.push_back(std::move(stream));
+}
+
+DataStreamPool& RecvBufferPool()
+{
+    // Leaked on purpose, as messages may be destroyed during static destruction.
+    static DataStreamPool* pool{new DataStreamPool{MAX_RECV_POOL_BUFFER_BYTES, MAX_RECV_POOL_TOTAL_BYTES}};
+    return *pool;
+}
+
+void EllSwiftKeyPool::Start()
+{
+    if (m_thread.joinable()) return;
+    WITH_LOCK(m_mutex, m_stop = false);
+    m_thread = std::thread(&util::TraceThread, "v2keys", [this] { ThreadFill(); });
+}
+
+void EllSwiftKeyPool::Stop()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+EllSwiftKeyPool::Key EllSwiftKeyPool::Get()
+{
+    {
+        LOCK(m_mutex);
+        if (!m_keys.empty()) {
+            Key key{std::move(m_keys.back())};
+            m_keys.pop_back();
+            m_cv.notify_all();
+            return key;
+        }
+        ++m_misses;
+    }
+    return Generate();
+}
+
+EllSwiftKeyPool::Key EllSwiftKeyPool::Generate()
+{
+    CKey key{GenerateRandomKey()};
+    const EllSwiftPubKey pubkey{key.EllSwiftCreate(MakeByteSpan(GetRandHash()))};
+    return {std::move(key), pubkey};
+}
+
+void EllSwiftKeyPool::ThreadFill()
+{
+    while (true) {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_keys.size() < m_target_size; });
+            if (m_stop) return;
+        }
+        // Generate the key without holding the lock, for Get() not to wait on it.
+        Key key{Generate()};
+        LOCK(m_mutex);
+        m_keys.push_back(std::move(key));
+    }
+}
+
+CNetMessage::~CNetMessage()
+{
+    RecvBufferPool().Return(std::move(m_recv));
 }
 
 size_t CNetMessage::GetMemoryUsage() const noexcept
@@ -538,6 +645,7 @@ CNode* CConnman::ConnectNode(CAddress addrConnect, const char *pszDest, bool fCo
                                     .i2p_sam_session = std::move(i2p_transient_session),
                                     .recv_flood_size = nReceiveFloodSize,
                                     .use_v2transport = use_v2transport,
+                                    .v2_key_pool = &m_v2_key_pool,
                                 });
         pnode->AddRef();
 
@@ -634,6 +742,7 @@ void CNode::CopyStats(CNodeStats& stats)
         LOCK(cs_vSend);
         X(mapSendBytesPerMsgType);
         X(nSendBytes);
+        X(m_send_memusage);
     }
     {
         LOCK(cs_vRecv);
@@ -719,6 +828,13 @@ V1Transport::V1Transport(const NodeId node_id) noexcept
     Reset();
 }
 
+size_t V1Transport::GetReceiveMemoryUsage() const noexcept
+{
+    AssertLockNotHeld(m_recv_mutex);
+    LOCK(m_recv_mutex);
+    return hdrbuf.GetMemoryUsage() + vRecv.GetMemoryUsage();
+}
+
 Transport::Info V1Transport::GetInfo() const noexcept
 {
     return {.transport_type = TransportProtocolType::V1, .session_id = {}};
@@ -801,7 +917,7 @@ CNetMessage V1Transport::GetReceivedMessage(const std::chrono::microseconds time
     reject_message = false;
     // decompose a single CNetMessage from the TransportDeserializer
     LOCK(m_recv_mutex);
-    CNetMessage msg(std::move(vRecv));
+    CNetMessage msg(std::exchange(vRecv, RecvBufferPool().Get()));
 
     // store message type string, time, and sizes
     msg.m_type = hdr.GetMessageType();
@@ -838,13 +954,13 @@ bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     AssertLockNotHeld(m_send_mutex);
     // Determine whether a new message can be set.
     LOCK(m_send_mutex);
-    if (m_sending_header || m_bytes_sent < m_message_to_send.data.size()) return false;
+    if (m_sending_header || m_bytes_sent < m_message_to_send.Payload().size()) return false;
 
     // create dbl-sha256 checksum
-    uint256 hash = Hash(msg.data);
+    uint256 hash = Hash(msg.Payload());
 
     // create header
-    CMessageHeader hdr(m_magic_bytes, msg.m_type.c_str(), msg.data.size());
+    CMessageHeader hdr(m_magic_bytes, msg.m_type.c_str(), msg.Payload().size());
     memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
 
     // serialize header
@@ -866,11 +982,11 @@ Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const
         return {std::span{m_header_to_send}.subspan(m_bytes_sent),
                 // We have more to send after the header if the message has payload, or if there
                 // is a next message after that.
-                have_next_message || !m_message_to_send.data.empty(),
+                have_next_message || !m_message_to_send.Payload().empty(),
                 m_message_to_send.m_type
                };
     } else {
-        return {std::span{m_message_to_send.data}.subspan(m_bytes_sent),
+        return {m_message_to_send.Payload().subspan(m_bytes_sent),
                 // We only have more to send after this message's payload if there is another
                 // message.
                 have_next_message,
@@ -879,18 +995,28 @@ Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const
     }
 }
 
+std::span<const uint8_t> V1Transport::GetNextBytesToSend() const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (m_sending_header) return m_message_to_send.Payload();
+    return {};
+}
+
 void V1Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
     m_bytes_sent += bytes_sent;
-    if (m_sending_header && m_bytes_sent == m_header_to_send.size()) {
-        // We're done sending a message's header. Switch to sending its data bytes.
+    if (m_sending_header && m_bytes_sent >= m_header_to_send.size()) {
+        // We're done sending a message's header. Switch to sending its data bytes, some of
+        // which may have been sent along with it.
         m_sending_header = false;
-        m_bytes_sent = 0;
-    } else if (!m_sending_header && m_bytes_sent == m_message_to_send.data.size()) {
-        // We're done sending a message's data. Wipe the data vector to reduce memory consumption.
-        ClearShrink(m_message_to_send.data);
+        m_bytes_sent -= m_header_to_send.size();
+    }
+    if (!m_sending_header && m_bytes_sent == m_message_to_send.Payload().size()) {
+        // We're done sending a message's data. Release it to reduce memory consumption.
+        m_message_to_send.ClearPayload();
         m_bytes_sent = 0;
     }
 }
@@ -993,7 +1119,10 @@ void V2Transport::StartSendingHandshake() noexcept
 }
 
 V2Transport::V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage) noexcept
-    : m_cipher{key, ent32}, m_initiating{initiating}, m_nodeid{nodeid},
+    : V2Transport{nodeid, initiating, key, key.EllSwiftCreate(ent32), std::move(garbage)} {}
+
+V2Transport::V2Transport(NodeId nodeid, bool initiating, const CKey& key, const EllSwiftPubKey& pubkey, std::vector<uint8_t> garbage) noexcept
+    : m_cipher{key, pubkey}, m_initiating{initiating}, m_nodeid{nodeid},
       m_v1_fallback{nodeid},
       m_recv_state{initiating ? RecvState::KEY : RecvState::KEY_MAYBE_V1},
       m_send_garbage{std::move(garbage)},
@@ -1011,6 +1140,12 @@ V2Transport::V2Transport(NodeId nodeid, bool initiating) noexcept
     : V2Transport{nodeid, initiating, GenerateRandomKey(),
                   MakeByteSpan(GetRandHash()), GenerateRandomGarbage()} {}
 
+V2Transport::V2Transport(NodeId nodeid, bool initiating, EllSwiftKeyPool& key_pool) noexcept
+    : V2Transport{nodeid, initiating, key_pool.Get(), GenerateRandomGarbage()} {}
+
+V2Transport::V2Transport(NodeId nodeid, bool initiating, EllSwiftKeyPool::Key key, std::vector<uint8_t> garbage) noexcept
+    : V2Transport{nodeid, initiating, key.key, key.pubkey, std::move(garbage)} {}
+
 void V2Transport::SetReceiveState(RecvState recv_state) noexcept
 {
     AssertLockHeld(m_recv_mutex);
@@ -1453,7 +1588,7 @@ CNetMessage V2Transport::GetReceivedMessage(std::chrono::microseconds time, bool
     Assume(m_recv_state == RecvState::APP_READY);
     std::span<const uint8_t> contents{m_recv_decode_buffer};
     auto msg_type = GetMessageType(contents);
-    CNetMessage msg{DataStream{}};
+    CNetMessage msg{RecvBufferPool().Get()};
     // Note that BIP324Cipher::EXPANSION also includes the length descriptor size.
     msg.m_raw_message_size = m_recv_decode_buffer.size() + BIP324Cipher::EXPANSION;
     if (msg_type) {
@@ -1482,26 +1617,27 @@ bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     // is available) and the send buffer is empty. This limits the number of messages in the send
     // buffer to just one, and leaves the responsibility for queueing them up to the caller.
     if (!(m_send_state == SendState::READY && m_send_buffer.empty())) return false;
-    // Construct contents (encoding message type + payload).
-    std::vector<uint8_t> contents;
+    // Construct contents (encoding message type + payload) directly in the send buffer, at the
+    // position its ciphertext goes to, and encrypt it there in place.
     auto short_message_id = V2_MESSAGE_MAP(msg.m_type);
+    const size_t type_size{short_message_id ? 1 : 1 + CMessageHeader::MESSAGE_TYPE_SIZE};
+    const auto payload{msg.Payload()};
+    const size_t contents_size{type_size + payload.size()};
+    // Initialize with zeroes, so that contents[0] and the unused positions in
+    // contents[1..13] remain 0x00 for a message type string.
+    m_send_buffer.assign(contents_size + BIP324Cipher::EXPANSION, 0);
+    const auto contents{std::span{m_send_buffer}.subspan(BIP324Cipher::LENGTH_LEN + BIP324Cipher::HEADER_LEN, contents_size)};
     if (short_message_id) {
-        contents.resize(1 + msg.data.size());
         contents[0] = *short_message_id;
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1);
     } else {
-        // Initialize with zeroes, and then write the message type string starting at offset 1.
-        // This means contents[0] and the unused positions in contents[1..13] remain 0x00.
-        contents.resize(1 + CMessageHeader::MESSAGE_TYPE_SIZE + msg.data.size(), 0);
-        std::copy(msg.m_type.begin(), msg.m_type.end(), contents.data() + 1);
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1 + CMessageHeader::MESSAGE_TYPE_SIZE);
-    }
-    // Construct ciphertext in send buffer.
-    m_send_buffer.resize(contents.size() + BIP324Cipher::EXPANSION);
+        // Write the message type string starting at offset 1.
+        std::copy(msg.m_type.begin(), msg.m_type.end(), contents.begin() + 1);
+    }
+    std::copy(payload.begin(), payload.end(), contents.begin() + type_size);
     m_cipher.Encrypt(MakeByteSpan(contents), {}, false, MakeWritableByteSpan(m_send_buffer));
     m_send_type = msg.m_type;
     // Release memory
-    ClearShrink(msg.data);
+    msg.ClearPayload();
     return true;
 }
 
@@ -1522,6 +1658,16 @@ Transport::BytesToSend V2Transport::GetBytesToSend(bool have_next_message) const
     };
 }
 
+std::span<const uint8_t> V2Transport::GetNextBytesToSend() const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (m_send_state == SendState::V1) return m_v1_fallback.GetNextBytesToSend();
+    // Packets are encrypted as a whole into m_send_buffer, so it is all returned by
+    // GetBytesToSend().
+    return {};
+}
+
 void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -1570,6 +1716,16 @@ size_t V2Transport::GetSendMemoryUsage() const noexcept
     return sizeof(m_send_buffer) + memusage::DynamicUsage(m_send_buffer);
 }
 
+size_t V2Transport::GetReceiveMemoryUsage() const noexcept
+{
+    AssertLockNotHeld(m_recv_mutex);
+    LOCK(m_recv_mutex);
+    if (m_recv_state == RecvState::V1) return m_v1_fallback.GetReceiveMemoryUsage();
+
+    return sizeof(m_recv_buffer) + memusage::DynamicUsage(m_recv_buffer) +
+           sizeof(m_recv_decode_buffer) + memusage::DynamicUsage(m_recv_decode_buffer);
+}
+
 Transport::Info V2Transport::GetInfo() const noexcept
 {
     AssertLockNotHeld(m_recv_mutex);
@@ -1591,12 +1747,13 @@ Transport::Info V2Transport::GetInfo() const noexcept
     return info;
 }
 
-std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
+std::pair<size_t, bool> CConnman::SocketSendData(CNode& node)
 {
     auto it = node.vSendMsg.begin();
     size_t nSentSize = 0;
     bool data_left{false}; //!< second return value (whether unsent data remains)
     std::optional<bool> expected_more;
+    const bool limit_rate{m_upload_rate_limiter.IsLimited() && !node.HasPermission(NetPermissionFlags::Download)};
 
     while (true) {
         if (it != node.vSendMsg.end()) {
@@ -1607,16 +1764,42 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
             if (node.m_transport->SetMessageToSend(*it)) {
                 // Update memory usage of send buffer (as *it will be deleted).
                 node.m_send_memusage -= memusage;
+                m_total_send_memusage -= memusage;
                 ++it;
             }
         }
-        const auto& [data, more, msg_type] = node.m_transport->GetBytesToSend(it != node.vSendMsg.end());
+        const bool have_next_message{it != node.vSendMsg.end()};
+        const auto& [to_send, more, msg_type] = node.m_transport->GetBytesToSend(have_next_message);
+        std::span<const uint8_t> data{to_send};
+        // Bytes of the same message following data, which can be handed to the socket along
+        // with it, saving a system call per message (e.g. a V1 header and its payload).
+        auto next_data{data.empty() ? std::span<const uint8_t>{} : node.m_transport->GetNextBytesToSend()};
+        const TrafficClass traffic_class{GetTrafficClass(msg_type)};
+        bool rate_limited{false};
+        if (!data.empty() && limit_rate) {
+            const uint64_t allowance{m_upload_rate_limiter.Available(traffic_class, SteadyClock::now())};
+            if (allowance == 0) {
+                m_upload_rate_limiter.RecordThrottled(traffic_class);
+                data_left = true;
+                break;
+            }
+            if (allowance < data.size() + next_data.size()) {
+                // Send what the limit allows; the rest is sent once more tokens are available.
+                data = data.first(std::min<size_t>(allowance, data.size()));
+                next_data = {};
+                rate_limited = true;
+            }
+        }
         // We rely on the 'more' value returned by GetBytesToSend to correctly predict whether more
         // bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
         // verify that the previously returned 'more' was correct.
         if (expected_more.has_value()) Assume(!data.empty() == *expected_more);
-        expected_more = more;
+        // Once next_data is sent too, there is only more to send if there is a next message. If
+        // the rate limit cut data short, nothing more is sent right away, so don't cork it.
+        const bool more_after{!rate_limited && (next_data.empty() ? more : have_next_message)};
+        expected_more = more_after;
         data_left = !data.empty(); // will be overwritten on next loop if all of data gets sent
+        const size_t data_size{data.size() + next_data.size()};
         int nBytes = 0;
         if (!data.empty()) {
             LOCK(node.m_sock_mutex);
@@ -1628,11 +1811,16 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
             }
             int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
 #ifdef MSG_MORE
-            if (more) {
+            if (more_after) {
                 flags |= MSG_MORE;
             }
 #endif
-            nBytes = node.m_sock->Send(reinterpret_cast<const char*>(data.data()), data.size(), flags);
+            if (next_data.empty()) {
+                nBytes = node.m_sock->Send(reinterpret_cast<const char*>(data.data()), data.size(), flags);
+            } else {
+                const std::array<std::span<const uint8_t>, 2> segments{data, next_data};
+                nBytes = node.m_sock->SendV(segments, flags);
+            }
         }
         if (nBytes > 0) {
             node.m_last_send = GetTime<std::chrono::seconds>();
@@ -1644,7 +1832,8 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
                 node.AccountForSentBytes(msg_type, nBytes);
             }
             nSentSize += nBytes;
-            if ((size_t)nBytes != data.size()) {
+            if (limit_rate) m_upload_rate_limiter.Consume(traffic_class, nBytes, SteadyClock::now());
+            if (rate_limited || (size_t)nBytes != data_size) {
                 // could not send full message; stop sending more
                 break;
             }
@@ -1661,15 +1850,22 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
         }
     }
 
-    node.fPauseSend = node.m_send_memusage + node.m_transport->GetSendMemoryUsage() > nSendBufferMaxSize;
-
     if (it == node.vSendMsg.end()) {
         assert(node.m_send_memusage == 0);
     }
     node.vSendMsg.erase(node.vSendMsg.begin(), it);
+    node.fPauseSend = ShouldPauseSend(node);
     return {nSentSize, data_left};
 }
 
+bool CConnman::ShouldPauseSend(const CNode& node) const
+{
+    if (node.m_send_memusage + node.m_transport->GetSendMemoryUsage() > nSendBufferMaxSize) return true;
+    // Over the global budget, stop producing messages for every peer with a backlog. Peers
+    // reading promptly drain theirs and resume soon, slow readers stay paused.
+    return node.m_send_memusage > 0 && m_total_send_memusage > m_total_send_buffer_max_size;
+}
+
 /** Try to find a connection to evict when the node is full.
  *  Extreme care must be taken to avoid opening the node to attacker
  *   triggered network partitioning.
@@ -1680,37 +1876,34 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
  */
 bool CConnman::AttemptToEvictConnection()
 {
-    std::vector<NodeEvictionCandidate> vEvictionCandidates;
-    {
-
-        LOCK(m_nodes_mutex);
-        for (const CNode* node : m_nodes) {
-            if (node->fDisconnect)
-                continue;
-            NodeEvictionCandidate candidate{
-                .id = node->GetId(),
-                .m_connected = node->m_connected,
-                .m_min_ping_time = node->m_min_ping_time,
-                .m_last_block_time = node->m_last_block_time,
-                .m_last_tx_time = node->m_last_tx_time,
-                .fRelevantServices = node->m_has_all_wanted_services,
-                .m_relay_txs = node->m_relays_txs.load(),
-                .fBloomFilter = node->m_bloom_filter_loaded.load(),
-                .nKeyedNetGroup = node->nKeyedNetGroup,
-                .prefer_evict = node->m_prefer_evict,
-                .m_is_local = node->addr.IsLocal(),
-                .m_network = node->ConnectedThroughNetwork(),
-                .m_noban = node->HasPermission(NetPermissionFlags::NoBan),
-                .m_conn_type = node->m_conn_type,
-            };
-            vEvictionCandidates.push_back(candidate);
-        }
-    }
-    const std::optional<NodeId> node_id_to_evict = SelectNodeToEvict(std::move(vEvictionCandidates));
+    LOCK(m_nodes_mutex);
+    // Only peers whose eviction criteria changed since the last attempt are re-ranked.
+    for (const CNode* node : m_nodes) {
+        if (node->fDisconnect) {
+            m_eviction_candidates.Remove(node->GetId());
+            continue;
+        }
+        m_eviction_candidates.AddOrUpdate({
+            .id = node->GetId(),
+            .m_connected = node->m_connected,
+            .m_min_ping_time = node->m_min_ping_time,
+            .m_last_block_time = node->m_last_block_time,
+            .m_last_tx_time = node->m_last_tx_time,
+            .fRelevantServices = node->m_has_all_wanted_services,
+            .m_relay_txs = node->m_relays_txs.load(),
+            .fBloomFilter = node->m_bloom_filter_loaded.load(),
+            .nKeyedNetGroup = node->nKeyedNetGroup,
+            .prefer_evict = node->m_prefer_evict,
+            .m_is_local = node->addr.IsLocal(),
+            .m_network = node->ConnectedThroughNetwork(),
+            .m_noban = node->HasPermission(NetPermissionFlags::NoBan),
+            .m_conn_type = node->m_conn_type,
+        });
+    }
+    const std::optional<NodeId> node_id_to_evict = m_eviction_candidates.SelectNodeToEvict();
     if (!node_id_to_evict) {
         return false;
     }
-    LOCK(m_nodes_mutex);
     for (CNode* pnode : m_nodes) {
         if (pnode->GetId() == *node_id_to_evict) {
             LogDebug(BCLog::NET, "selected %s connection for eviction, %s", pnode->ConnectionTypeAsString(), pnode->DisconnectMsg(fLogIPs));
@@ -1721,6 +1914,7 @@ bool CConnman::AttemptToEvictConnection()
                 pnode->ConnectedThroughNetwork(),
                 Ticks<std::chrono::seconds>(pnode->m_connected));
             pnode->fDisconnect = true;
+            m_eviction_candidates.Remove(pnode->GetId());
             return true;
         }
     }
@@ -1837,6 +2031,7 @@ void CConnman::CreateNodeFromAcceptedSocket(std::unique_ptr<Sock>&& sock,
                                  .prefer_evict = discouraged,
                                  .recv_flood_size = nReceiveFloodSize,
                                  .use_v2transport = use_v2transport,
+                                 .v2_key_pool = &m_v2_key_pool,
                              });
     pnode->AddRef();
     m_msgproc->InitializeNode(*pnode, local_services);
@@ -1844,6 +2039,7 @@ void CConnman::CreateNodeFromAcceptedSocket(std::unique_ptr<Sock>&& sock,
         LOCK(m_nodes_mutex);
         m_nodes.push_back(pnode);
     }
+    PeersMetric(*pnode).Add(1);
     LogDebug(BCLog::NET, "connection from %s accepted\n", addr.ToStringAddrPort());
     TRACEPOINT(net, inbound_connection,
         pnode->GetId(),
@@ -1924,6 +2120,8 @@ void CConnman::DisconnectNodes()
             {
                 // remove from m_nodes
                 m_nodes.erase(remove(m_nodes.begin(), m_nodes.end(), pnode), m_nodes.end());
+                m_eviction_candidates.Remove(pnode->GetId());
+                PeersMetric(*pnode).Add(-1);
 
                 // Add to reconnection list if appropriate. We don't reconnect right here, because
                 // the creation of a connection is a blocking operation (up to several seconds),
@@ -2046,6 +2244,27 @@ bool CConnman::InactivityCheck(const CNode& node) const
     return false;
 }
 
+/** Events to wait for on a node's socket: receiving unless paused, and sending if there is
+ *  anything to send that the upload rate limit allows. */
+static Sock::Event GetWaitEvents(CNode& node, UploadRateLimiter& limiter)
+{
+    bool select_recv = !node.fPauseRecv;
+    bool select_send;
+    {
+        LOCK(node.cs_vSend);
+        // Sending is possible if either there are bytes to send right now, or if there will be
+        // once a potential message from vSendMsg is handed to the transport. GetBytesToSend
+        // determines both of these in a single call.
+        const auto& [to_send, more, msg_type] = node.m_transport->GetBytesToSend(!node.vSendMsg.empty());
+        select_send = !to_send.empty() || more;
+        // A throttled node is checked again once the wait times out.
+        if (!to_send.empty() && limiter.IsLimited() && !node.HasPermission(NetPermissionFlags::Download)) {
+            select_send = limiter.Available(GetTrafficClass(msg_type), SteadyClock::now()) > 0;
+        }
+    }
+    return (select_send ? Sock::SEND : 0) | (select_recv ? Sock::RECV : 0);
+}
+
 Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
 {
     Sock::EventsPerSock events_per_sock;
@@ -2055,21 +2274,11 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
     }
 
     for (CNode* pnode : nodes) {
-        bool select_recv = !pnode->fPauseRecv;
-        bool select_send;
-        {
-            LOCK(pnode->cs_vSend);
-            // Sending is possible if either there are bytes to send right now, or if there will be
-            // once a potential message from vSendMsg is handed to the transport. GetBytesToSend
-            // determines both of these in a single call.
-            const auto& [to_send, more, _msg_type] = pnode->m_transport->GetBytesToSend(!pnode->vSendMsg.empty());
-            select_send = !to_send.empty() || more;
-        }
-        if (!select_recv && !select_send) continue;
+        const Sock::Event event{GetWaitEvents(*pnode, m_upload_rate_limiter)};
+        if (!event) continue;
 
         LOCK(pnode->m_sock_mutex);
         if (pnode->m_sock) {
-            Sock::Event event = (select_send ? Sock::SEND : 0) | (select_recv ? Sock::RECV : 0);
             events_per_sock.emplace(pnode->m_sock, Sock::Events{event});
         }
     }
@@ -2077,6 +2286,53 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
     return events_per_sock;
 }
 
+#ifdef USE_EPOLL
+void CConnman::UpdateSockPoller(std::span<CNode* const> nodes)
+{
+    for (const ListenSocket& listen_socket : vhListenSocket) {
+        m_sock_poller->SetInterest(listen_socket.sock, Sock::RECV);
+    }
+
+    for (CNode* pnode : nodes) {
+        const Sock::Event event{GetWaitEvents(*pnode, m_upload_rate_limiter)};
+
+        LOCK(pnode->m_sock_mutex);
+        if (pnode->m_sock) {
+            m_sock_poller->SetInterest(pnode->m_sock, event);
+        }
+    }
+
+    // Nodes that were disconnected or lost their socket were not seen above.
+    m_sock_poller->RemoveStale();
+}
+#endif
+
+Sock::EventsPerSock CConnman::WaitSockets(std::span<CNode* const> nodes)
+{
+    const auto timeout = std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS);
+    Sock::EventsPerSock events_per_sock;
+
+#ifdef USE_EPOLL
+    if (m_sock_poller) {
+        UpdateSockPoller(nodes);
+        if (!m_sock_poller->HasInterest() || !m_sock_poller->Wait(timeout, events_per_sock)) {
+            interruptNet.sleep_for(timeout);
+        }
+        return events_per_sock;
+    }
+#endif
+
+    // Check for the readiness of the already connected sockets and the
+    // listening sockets in one call ("readiness" as in poll(2) or
+    // select(2)). If none are ready, wait for a short while and return
+    // empty sets.
+    events_per_sock = GenerateWaitSockets(nodes);
+    if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        interruptNet.sleep_for(timeout);
+    }
+    return events_per_sock;
+}
+
 void CConnman::SocketHandler()
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
@@ -2086,16 +2342,7 @@ void CConnman::SocketHandler()
     {
         const NodesSnapshot snap{*this, /*shuffle=*/false};
 
-        const auto timeout = std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS);
-
-        // Check for the readiness of the already connected sockets and the
-        // listening sockets in one call ("readiness" as in poll(2) or
-        // select(2)). If none are ready, wait for a short while and return
-        // empty sets.
-        events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
-            interruptNet.sleep_for(timeout);
-        }
+        events_per_sock = WaitSockets(snap.Nodes());
 
         // Service (send/receive) each of the already connected nodes.
         SocketHandlerConnected(snap.Nodes(), events_per_sock);
@@ -2233,9 +2480,9 @@ void CConnman::WakeMessageHandler()
 {
     {
         LOCK(mutexMsgProc);
-        fMsgProcWake = true;
+        ++m_msgproc_wake_count;
     }
-    condMsgProc.notify_one();
+    condMsgProc.notify_all();
 }
 
 void CConnman::ThreadDNSAddressSeed()
@@ -2631,15 +2878,27 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
         int nOutboundBlockRelay = 0;
         int outbound_privacy_network_peers = 0;
         std::set<std::vector<unsigned char>> outbound_ipv46_peer_netgroups;
+        // Unfinished connection attempts, which count as the connections they may become.
+        std::vector<CAddress> pending_addrs;
+        std::array<int, Network::NET_MAX> pending_per_network{};
 
         {
             LOCK(m_nodes_mutex);
+            std::vector<std::pair<CAddress, ConnectionType>> outbound;
             for (const CNode* pnode : m_nodes) {
-                if (pnode->IsFullOutboundConn()) nOutboundFullRelay++;
-                if (pnode->IsBlockOnlyConn()) nOutboundBlockRelay++;
+                outbound.emplace_back(pnode->addr, pnode->m_conn_type);
+            }
+            for (const PendingOutbound& pending : m_pending_outbound) {
+                outbound.emplace_back(pending.addr, pending.conn_type);
+                pending_addrs.push_back(pending.addr);
+                ++pending_per_network[pending.addr.GetNetwork()];
+            }
+            for (const auto& [address, conn_type] : outbound) {
+                if (conn_type == ConnectionType::OUTBOUND_FULL_RELAY) nOutboundFullRelay++;
+                if (conn_type == ConnectionType::BLOCK_RELAY) nOutboundBlockRelay++;
 
                 // Make sure our persistent outbound slots to ipv4/ipv6 peers belong to different netgroups.
-                switch (pnode->m_conn_type) {
+                switch (conn_type) {
                     // We currently don't take inbound connections into account. Since they are
                     // free to make, an attacker could make them to prevent us from connecting to
                     // certain peers.
@@ -2652,7 +2911,6 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
                     case ConnectionType::MANUAL:
                     case ConnectionType::OUTBOUND_FULL_RELAY:
                     case ConnectionType::BLOCK_RELAY:
-                        const CAddress address{pnode->addr};
                         if (address.IsTor() || address.IsI2P() || address.IsCJDNS()) {
                             // Since our addrman-groups for these networks are
                             // random, without relation to the route we
@@ -2746,6 +3004,11 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
             continue;
         }
 
+        // Attempts to fill the regular slots run concurrently, so that slow connection attempts
+        // do not hold up the others. Anything extra waits until those are done.
+        const bool filling_slots{anchor || nOutboundFullRelay < m_max_outbound_full_relay || nOutboundBlockRelay < m_max_outbound_block_relay};
+        if (pending_addrs.size() >= (filling_slots ? size_t(MAX_CONCURRENT_OUTBOUND_ATTEMPTS) : 1)) continue;
+
         addrman.ResolveCollisions();
 
         const auto current_time{NodeClock::now()};
@@ -2759,7 +3022,8 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
                 m_anchors.pop_back();
                 if (!addr.IsValid() || IsLocal(addr) || !g_reachable_nets.Contains(addr) ||
                     !m_msgproc->HasAllDesirableServiceFlags(addr.nServices) ||
-                    outbound_ipv46_peer_netgroups.count(m_netgroupman.GetGroup(addr))) continue;
+                    outbound_ipv46_peer_netgroups.count(m_netgroupman.GetGroup(addr)) ||
+                    std::ranges::count(pending_addrs, static_cast<const CNetAddr&>(addr), [](const CAddress& a) -> const CNetAddr& { return a; })) continue;
                 addrConnect = addr;
                 LogDebug(BCLog::NET, "Trying to make an anchor connection to %s\n", addrConnect.ToStringAddrPort());
                 break;
@@ -2818,6 +3082,12 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
                 continue;
             }
 
+            // Leave room for attempts to other networks, and do not try an address twice at once.
+            if (pending_per_network[addr.GetNetwork()] >= MAX_CONCURRENT_OUTBOUND_ATTEMPTS_PER_NETWORK ||
+                std::ranges::count(pending_addrs, static_cast<const CNetAddr&>(addr), [](const CAddress& a) -> const CNetAddr& { return a; })) {
+                continue;
+            }
+
             // only consider very recently tried nodes after 30 failed attempts
             if (current_time - addr_last_try < 10min && nTries < 30) {
                 continue;
@@ -2870,7 +3140,16 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect, std
             const bool count_failures{((int)outbound_ipv46_peer_netgroups.size() + outbound_privacy_network_peers) >= std::min(m_max_automatic_connections - 1, 2)};
             // Use BIP324 transport when both us and them have NODE_V2_P2P set.
             const bool use_v2transport(addrConnect.nServices & GetLocalServices() & NODE_P2P_V2);
-            OpenNetworkConnection(addrConnect, count_failures, std::move(grant), /*strDest=*/nullptr, conn_type, use_v2transport);
+            std::list<PendingOutbound>::iterator pending;
+            {
+                LOCK(m_nodes_mutex);
+                pending = m_pending_outbound.insert(m_pending_outbound.end(), PendingOutbound{addrConnect, conn_type});
+            }
+            (void)m_outbound_pool.Submit([this, pending, addrConnect, count_failures, grant = std::move(grant), conn_type, use_v2transport]() mutable {
+                OpenNetworkConnection(addrConnect, count_failures, std::move(grant), /*strDest=*/nullptr, conn_type, use_v2transport);
+                LOCK(m_nodes_mutex);
+                m_pending_outbound.erase(pending);
+            });
         }
     }
 }
@@ -3010,6 +3289,7 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     {
         LOCK(m_nodes_mutex);
         m_nodes.push_back(pnode);
+        PeersMetric(*pnode).Add(1);
 
         // update connection count by network
         if (pnode->IsManualOrFullOutboundConn()) ++m_network_conn_counts[pnode->addr.GetNetwork()];
@@ -3025,9 +3305,9 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
 
 Mutex NetEventsInterface::g_msgproc_mutex;
 
-void CConnman::ThreadMessageHandler()
+void CConnman::ThreadMessageHandler(int shard)
 {
-    LOCK(NetEventsInterface::g_msgproc_mutex);
+    uint64_t wake_count{0};
 
     while (!flagInterruptMsgProc)
     {
@@ -3042,6 +3322,17 @@ void CConnman::ThreadMessageHandler()
             for (CNode* pnode : snap.Nodes()) {
                 if (pnode->fDisconnect)
                     continue;
+                if (pnode->GetId() % m_message_handler_threads != shard)
+                    continue;
+
+                // Messages such as ping don't need to wait for the peers of the
+                // other shards to release g_msgproc_mutex.
+                if (m_message_handler_threads > 1 && m_msgproc->ProcessPeerLocalMessage(pnode)) {
+                    fMoreWork = true;
+                    continue;
+                }
+
+                LOCK(NetEventsInterface::g_msgproc_mutex);
 
                 // Receive messages
                 bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
@@ -3058,9 +3349,9 @@ void CConnman::ThreadMessageHandler()
 
         WAIT_LOCK(mutexMsgProc, lock);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return fMsgProcWake; });
+            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [&]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return m_msgproc_wake_count != wake_count; });
         }
-        fMsgProcWake = false;
+        wake_count = m_msgproc_wake_count;
     }
 }
 
@@ -3343,10 +3634,19 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     interruptNet.reset();
     flagInterruptMsgProc = false;
 
-    {
-        LOCK(mutexMsgProc);
-        fMsgProcWake = false;
+
+#ifdef USE_EPOLL
+    if (m_use_epoll && !m_sock_poller) {
+        try {
+            m_sock_poller = std::make_unique<SockPoller>();
+        } catch (const std::runtime_error& e) {
+            LogWarning("%s, falling back to poll()", e.what());
+        }
     }
+#endif
+
+    // Keep keys ready for V2 connections, which we only make and accept if we support V2
+    if (m_local_services & NODE_P2P_V2) m_v2_key_pool.Start();
 
     // Send and receive from sockets, accept connections
     threadSocketHandler = std::thread(&util::TraceThread, "net", [this] { ThreadSocketHandler(); });
@@ -3368,13 +3668,17 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
         return false;
     }
     if (connOptions.m_use_addrman_outgoing || !connOptions.m_specified_outgoing.empty()) {
+        m_outbound_pool.Start(MAX_CONCURRENT_OUTBOUND_ATTEMPTS);
         threadOpenConnections = std::thread(
             &util::TraceThread, "opencon",
             [this, connect = connOptions.m_specified_outgoing, seed_nodes = std::move(seed_nodes)] { ThreadOpenConnections(connect, seed_nodes); });
     }
 
     // Process messages
-    threadMessageHandler = std::thread(&util::TraceThread, "msghand", [this] { ThreadMessageHandler(); });
+    for (int shard{0}; shard < m_message_handler_threads; ++shard) {
+        threadMessageHandlers.emplace_back(&util::TraceThread, shard == 0 ? "msghand" : strprintf("msghand.%d", shard),
+                                           [this, shard] { ThreadMessageHandler(shard); });
+    }
 
     if (m_i2p_sam_session) {
         threadI2PAcceptIncoming =
@@ -3382,7 +3686,7 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     }
 
     // Dump network addresses
-    scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL);
+    scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL, CScheduler::TaskClass::BACKGROUND);
 
     // Run the ASMap Health check once and then schedule it to run every 24h.
     if (m_netgroupman.UsingASMap()) {
@@ -3437,16 +3741,21 @@ void CConnman::StopThreads()
     if (threadI2PAcceptIncoming.joinable()) {
         threadI2PAcceptIncoming.join();
     }
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (auto& thread : threadMessageHandlers) {
+        if (thread.joinable()) thread.join();
+    }
+    threadMessageHandlers.clear();
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
+    // Wait for the connection attempts it started, which return quickly once interrupted.
+    m_outbound_pool.Stop();
     if (threadOpenAddedConnections.joinable())
         threadOpenAddedConnections.join();
     if (threadDNSAddressSeed.joinable())
         threadDNSAddressSeed.join();
     if (threadSocketHandler.joinable())
         threadSocketHandler.join();
+    m_v2_key_pool.Stop();
 }
 
 void CConnman::StopNodes()
@@ -3467,9 +3776,14 @@ void CConnman::StopNodes()
 
     // Delete peer connections.
     std::vector<CNode*> nodes;
-    WITH_LOCK(m_nodes_mutex, nodes.swap(m_nodes));
+    {
+        LOCK(m_nodes_mutex);
+        nodes.swap(m_nodes);
+        m_eviction_candidates.Clear();
+    }
     for (CNode* pnode : nodes) {
         LogDebug(BCLog::NET, "Stopping node, %s", pnode->DisconnectMsg(fLogIPs));
+        PeersMetric(*pnode).Add(-1);
         pnode->CloseSocketDisconnect();
         DeleteNode(pnode);
     }
@@ -3487,6 +3801,7 @@ void CConnman::DeleteNode(CNode* pnode)
 {
     assert(pnode);
     m_msgproc->FinalizeNode(*pnode);
+    m_total_send_memusage -= WITH_LOCK(pnode->cs_vSend, return pnode->m_send_memusage);
     delete pnode;
 }
 
@@ -3629,6 +3944,17 @@ void CConnman::GetNodeStats(std::vector<CNodeStats>& vstats) const
     }
 }
 
+CConnman::PeerMemoryUsage CConnman::GetPeerMemoryUsage() const
+{
+    PeerMemoryUsage usage;
+    LOCK(m_nodes_mutex);
+    for (CNode* pnode : m_nodes) {
+        usage.send += WITH_LOCK(pnode->cs_vSend, return pnode->m_send_memusage) + pnode->m_transport->GetSendMemoryUsage();
+        usage.receive += pnode->GetProcessQueueMemoryUsage() + pnode->m_transport->GetReceiveMemoryUsage();
+    }
+    return usage;
+}
+
 bool CConnman::DisconnectNode(const std::string& strNode)
 {
     LOCK(m_nodes_mutex);
@@ -3675,6 +4001,7 @@ bool CConnman::DisconnectNode(NodeId id)
 void CConnman::RecordBytesRecv(uint64_t bytes)
 {
     nTotalBytesRecv += bytes;
+    g_metric_bytes_recv.Inc(bytes);
 }
 
 void CConnman::RecordBytesSent(uint64_t bytes)
@@ -3683,6 +4010,7 @@ void CConnman::RecordBytesSent(uint64_t bytes)
     LOCK(m_total_bytes_sent_mutex);
 
     nTotalBytesSent += bytes;
+    g_metric_bytes_sent.Inc(bytes);
 
     const auto now = GetTime<std::chrono::seconds>();
     if (nMaxOutboundCycleStartTime + MAX_UPLOAD_TIMEFRAME < now)
@@ -3777,9 +4105,10 @@ ServiceFlags CConnman::GetLocalServices() const
     return m_local_services;
 }
 
-static std::unique_ptr<Transport> MakeTransport(NodeId id, bool use_v2transport, bool inbound) noexcept
+static std::unique_ptr<Transport> MakeTransport(NodeId id, bool use_v2transport, bool inbound, EllSwiftKeyPool* v2_key_pool) noexcept
 {
     if (use_v2transport) {
+        if (v2_key_pool) return std::make_unique<V2Transport>(id, /*initiating=*/!inbound, *v2_key_pool);
         return std::make_unique<V2Transport>(id, /*initiating=*/!inbound);
     } else {
         return std::make_unique<V1Transport>(id);
@@ -3796,7 +4125,7 @@ CNode::CNode(NodeId idIn,
              ConnectionType conn_type_in,
              bool inbound_onion,
              CNodeOptions&& node_opts)
-    : m_transport{MakeTransport(idIn, node_opts.use_v2transport, conn_type_in == ConnectionType::INBOUND)},
+    : m_transport{MakeTransport(idIn, node_opts.use_v2transport, conn_type_in == ConnectionType::INBOUND, node_opts.v2_key_pool)},
       m_permission_flags{node_opts.permission_flags},
       m_sock{sock},
       m_connected{GetTime<std::chrono::seconds>()},
@@ -3858,18 +4187,39 @@ std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage()
     return std::make_pair(std::move(msgs.front()), !m_msg_process_queue.empty());
 }
 
+std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage(std::span<const std::string_view> msg_types)
+{
+    LOCK(m_msg_process_queue_mutex);
+    if (m_msg_process_queue.empty()) return std::nullopt;
+    if (std::ranges::find(msg_types, m_msg_process_queue.front().m_type) == msg_types.end()) return std::nullopt;
+
+    std::list<CNetMessage> msgs;
+    // Just take one message
+    msgs.splice(msgs.begin(), m_msg_process_queue, m_msg_process_queue.begin());
+    m_msg_process_queue_size -= msgs.front().GetMemoryUsage();
+    fPauseRecv = m_msg_process_queue_size > m_recv_flood_size;
+
+    return std::make_pair(std::move(msgs.front()), !m_msg_process_queue.empty());
+}
+
 bool CConnman::NodeFullyConnected(const CNode* pnode)
 {
     return pnode && pnode->fSuccessfullyConnected && !pnode->fDisconnect;
 }
 
+size_t CNode::GetProcessQueueMemoryUsage() const
+{
+    LOCK(m_msg_process_queue_mutex);
+    return m_msg_process_queue_size;
+}
+
 void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
-    size_t nMessageSize = msg.data.size();
+    size_t nMessageSize = msg.Payload().size();
     LogDebug(BCLog::NET, "sending %s (%d bytes) peer=%d\n", msg.m_type, nMessageSize, pnode->GetId());
     if (gArgs.GetBoolArg("-capturemessages", false)) {
-        CaptureMessage(pnode->addr, msg.m_type, msg.data, /*is_incoming=*/false);
+        CaptureMessage(pnode->addr, msg.m_type, msg.Payload(), /*is_incoming=*/false);
     }
 
     TRACEPOINT(net, outbound_message,
@@ -3877,8 +4227,8 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         pnode->m_addr_name.c_str(),
         pnode->ConnectionTypeAsString().c_str(),
         msg.m_type.c_str(),
-        msg.data.size(),
-        msg.data.data()
+        msg.Payload().size(),
+        msg.Payload().data()
     );
 
     size_t nBytesSent = 0;
@@ -3891,8 +4241,10 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         const bool queue_was_empty{to_send.empty() && pnode->vSendMsg.empty()};
 
         // Update memory usage of send buffer.
-        pnode->m_send_memusage += msg.GetMemoryUsage();
-        if (pnode->m_send_memusage + pnode->m_transport->GetSendMemoryUsage() > nSendBufferMaxSize) pnode->fPauseSend = true;
+        const size_t memusage{msg.GetMemoryUsage()};
+        pnode->m_send_memusage += memusage;
+        m_total_send_memusage += memusage;
+        if (ShouldPauseSend(*pnode)) pnode->fPauseSend = true;
         // Move message to vSendMsg queue.
         pnode->vSendMsg.push_back(std::move(msg));
 
@@ -16,10 +16,12 @@
 #include <i2p.h>
 #include <kernel/messagestartchars.h>
 #include <net_permissions.h>
+#include <net_ratelimit.h>
 #include <netaddress.h>
 #include <netbase.h>
 #include <netgroup.h>
 #include <node/connection_types.h>
+#include <node/eviction.h>
 #include <node/protocol_version.h>
 #include <policy/feerate.h>
 #include <protocol.h>
@@ -32,7 +34,9 @@
 #include <util/check.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
+#include <util/threadpool.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -43,6 +47,7 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <string_view>
 #include <thread>
 #include <unordered_set>
 #include <vector>
@@ -72,6 +77,10 @@ static const int MAX_ADDNODE_CONNECTIONS = 8;
 static const int MAX_BLOCK_RELAY_ONLY_CONNECTIONS = 2;
 /** Maximum number of feeler connections */
 static const int MAX_FEELER_CONNECTIONS = 1;
+/** Maximum number of automatic outbound connection attempts in flight at the same time. */
+static constexpr int MAX_CONCURRENT_OUTBOUND_ATTEMPTS{4};
+/** Maximum number of automatic outbound connection attempts in flight at the same time to one network. */
+static constexpr int MAX_CONCURRENT_OUTBOUND_ATTEMPTS_PER_NETWORK{2};
 /** -listen default */
 static const bool DEFAULT_LISTEN = true;
 /** The maximum number of peer connections to maintain. */
@@ -82,6 +91,12 @@ static const std::string DEFAULT_MAX_UPLOAD_TARGET{"0M"};
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 static const int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** -netepoll default: wait for the sockets with a persistent SockPoller where available */
+static constexpr bool DEFAULT_NET_EPOLL{true};
+/** -msghandlerthreads default */
+static constexpr int DEFAULT_MESSAGE_HANDLER_THREADS{1};
+/** Maximum number of message handler threads */
+static constexpr int MAX_MESSAGE_HANDLER_THREADS{16};
 /** Number of file descriptors required for message capture **/
 static const int NUM_FDS_MESSAGE_CAPTURE = 1;
 /** Interval for ASMap Health Check **/
@@ -92,6 +107,8 @@ static constexpr bool DEFAULT_DNSSEED{true};
 static constexpr bool DEFAULT_FIXEDSEEDS{true};
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
+/** Default for -maxtotalsendbuffer, the memory budget for the send queues of all peers together. */
+static const size_t DEFAULT_MAXTOTALSENDBUFFER = 100 * 1000;
 
 static constexpr bool DEFAULT_V2_TRANSPORT{true};
 
@@ -120,18 +137,43 @@ struct CSerializedNetMsg {
     CSerializedNetMsg(const CSerializedNetMsg& msg) = delete;
     CSerializedNetMsg& operator=(const CSerializedNetMsg&) = delete;
 
+    /** Copy the message. Once MakeShared() was called, copies share the payload
+     *  instead of duplicating it, which makes sending one message to many peers cheap. */
     CSerializedNetMsg Copy() const
     {
         CSerializedNetMsg copy;
         copy.data = data;
+        copy.m_shared_data = m_shared_data;
         copy.m_type = m_type;
         return copy;
     }
 
+    /** Move the payload in `data` into an immutable, reference counted buffer. */
+    void MakeShared()
+    {
+        if (m_shared_data) return;
+        m_shared_data = std::make_shared<const std::vector<unsigned char>>(std::move(data));
+        data = {};
+    }
+
+    /** The payload, wherever it is stored. */
+    std::span<const unsigned char> Payload() const noexcept
+    {
+        if (m_shared_data) return *m_shared_data;
+        return data;
+    }
+
+    /** Release the payload (or this message's reference to it). */
+    void ClearPayload() noexcept;
+
+    /** Payload owned by this message. Unused once the payload is shared. */
     std::vector<unsigned char> data;
+    /** Payload shared with copies of this message, see MakeShared(). */
+    std::shared_ptr<const std::vector<unsigned char>> m_shared_data;
     std::string m_type;
 
-    /** Compute total memory usage of this object (own memory + any dynamic memory). */
+    /** Compute total memory usage of this object (own memory + any dynamic memory).
+     *  A shared payload is counted in full, as it is kept alive by every copy. */
     size_t GetMemoryUsage() const noexcept;
 };
 
@@ -201,6 +243,7 @@ public:
     bool m_bip152_highbandwidth_from;
     int m_starting_height;
     uint64_t nSendBytes;
+    size_t m_send_memusage;
     mapMsgTypeSize mapSendBytesPerMsgType;
     uint64_t nRecvBytes;
     mapMsgTypeSize mapRecvBytesPerMsgType;
@@ -224,6 +267,92 @@ public:
 };
 
 
+/**
+ * Pool of the buffers of DataStreams, so that the buffers of messages which
+ * have been processed are reused for the next ones instead of being freed
+ * and allocated again. Buffers larger than max_buffer_bytes, or returned when
+ * the pool already holds max_total_bytes, are freed.
+ */
+class DataStreamPool
+{
+public:
+    DataStreamPool(size_t max_buffer_bytes, size_t max_total_bytes)
+        : m_max_buffer_bytes{max_buffer_bytes}, m_max_total_bytes{max_total_bytes} {}
+
+    /** Get an empty DataStream, with the buffer of a returned one if any. */
+    DataStream Get() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Return a DataStream which is not used anymore, for its buffer to be reused. */
+    void Return(DataStream&& stream) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    size_t NumBuffers() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_buffers.size()); }
+    size_t TotalBytes() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_total_bytes); }
+
+private:
+    const size_t m_max_buffer_bytes;
+    const size_t m_max_total_bytes;
+    mutable Mutex m_mutex;
+    std::vector<DataStream> m_buffers GUARDED_BY(m_mutex);
+    size_t m_total_bytes GUARDED_BY(m_mutex){0};
+};
+
+/** Buffers of received messages which are kept for reuse, up to the size of most block messages. */
+static constexpr size_t MAX_RECV_POOL_BUFFER_BYTES{4 * 1000 * 1000};
+/** Total size of the buffers of received messages which are kept for reuse. */
+static constexpr size_t MAX_RECV_POOL_TOTAL_BYTES{16 * 1000 * 1000};
+
+/** Pool of the buffers of the messages received from all peers. */
+DataStreamPool& RecvBufferPool();
+
+/**
+ * Pool of ephemeral BIP324 keys with their ElligatorSwift encoding, so that
+ * V2 connections do not have to generate them, which is the costliest part of
+ * setting up a V2Transport, on the thread accepting or opening connections.
+ * Once started, a background thread keeps the pool filled up to its target
+ * size. Each key is handed out only once; when the pool is empty, a new key is
+ * generated on the spot.
+ */
+class EllSwiftKeyPool
+{
+public:
+    struct Key {
+        CKey key;
+        EllSwiftPubKey pubkey;
+    };
+
+    explicit EllSwiftKeyPool(size_t target_size) : m_target_size{target_size} {}
+    ~EllSwiftKeyPool() { Stop(); }
+
+    /** Start the thread filling the pool. */
+    void Start() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Stop the thread filling the pool. The pool can still be used. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Take a key out of the pool, or generate one if it is empty. */
+    Key Get() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Generate a new random key and its encoding. */
+    static Key Generate();
+
+    size_t TargetSize() const { return m_target_size; }
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_keys.size()); }
+    /** Number of keys which had to be generated on the spot, as the pool was empty. */
+    uint64_t Misses() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_misses); }
+
+private:
+    void ThreadFill() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    const size_t m_target_size;
+    mutable Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Key> m_keys GUARDED_BY(m_mutex);
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+};
+
+/** Number of BIP324 keys kept ready for new V2 connections. */
+static constexpr size_t V2_KEY_POOL_SIZE{32};
+
 /** Transport protocol agnostic message container.
  * Ideally it should only contain receive time, payload,
  * type and size.
@@ -246,6 +375,8 @@ public:
     CNetMessage(const CNetMessage&) = delete;
     CNetMessage& operator=(CNetMessage&&) = default;
     CNetMessage& operator=(const CNetMessage&) = delete;
+    /** Returns the buffer of the message to RecvBufferPool(). */
+    ~CNetMessage();
 
     /** Compute total memory usage of this object (own memory + any dynamic memory). */
     size_t GetMemoryUsage() const noexcept;
@@ -288,6 +419,9 @@ public:
      */
     virtual CNetMessage GetReceivedMessage(std::chrono::microseconds time, bool& reject_message) = 0;
 
+    /** Return the memory usage of this transport attributable to partially received data. */
+    virtual size_t GetReceiveMemoryUsage() const noexcept = 0;
+
     // 2. Sending side functions, for converting messages into bytes to be sent over the wire.
 
     /** Set the next message to send.
@@ -348,9 +482,19 @@ public:
      */
     virtual BytesToSend GetBytesToSend(bool have_next_message) const noexcept = 0;
 
-    /** Report how many bytes returned by the last GetBytesToSend() have been sent.
+    /** Get the bytes that GetBytesToSend() would return after its to_send is all sent, if
+     *  they belong to the same message and are already known, so that both can be handed to
+     *  the socket at once. For V1Transport this is the payload while sending the header.
+     *
+     * Like to_send, the result refers to data internal to the transport.
+     */
+    virtual std::span<const uint8_t> GetNextBytesToSend() const noexcept = 0;
+
+    /** Report how many bytes returned by the last GetBytesToSend() (and GetNextBytesToSend())
+     *  have been sent.
      *
-     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result.
+     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result plus the
+     * size of the last GetNextBytesToSend() result.
      *
      * If bytes_sent=0, this call has no effect.
      */
@@ -439,9 +583,11 @@ public:
     }
 
     CNetMessage GetReceivedMessage(std::chrono::microseconds time, bool& reject_message) override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
+    size_t GetReceiveMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
 
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    std::span<const uint8_t> GetNextBytesToSend() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     bool ShouldReconnectV1() const noexcept override { return false; }
@@ -631,6 +777,8 @@ private:
     /** Process bytes in m_recv_buffer, while in VERSION/APP state. */
     bool ProcessReceivedPacketBytes() noexcept EXCLUSIVE_LOCKS_REQUIRED(m_recv_mutex);
 
+    V2Transport(NodeId nodeid, bool initiating, EllSwiftKeyPool::Key key, std::vector<uint8_t> garbage) noexcept;
+
 public:
     static constexpr uint32_t MAX_GARBAGE_LEN = 4095;
 
@@ -641,17 +789,28 @@ public:
      */
     V2Transport(NodeId nodeid, bool initiating) noexcept;
 
+    /** Construct a V2 transport with a key taken from key_pool.
+     *
+     * @param[in] nodeid      the node's NodeId (only for debug log output).
+     * @param[in] initiating  whether we are the initiator side.
+     * @param[in] key_pool    the pool to take our ephemeral key from.
+     */
+    V2Transport(NodeId nodeid, bool initiating, EllSwiftKeyPool& key_pool) noexcept;
+
     /** Construct a V2 transport with specified keys and garbage (test use only). */
     V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage) noexcept;
+    V2Transport(NodeId nodeid, bool initiating, const CKey& key, const EllSwiftPubKey& pubkey, std::vector<uint8_t> garbage) noexcept;
 
     // Receive side functions.
     bool ReceivedMessageComplete() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
     bool ReceivedBytes(std::span<const uint8_t>& msg_bytes) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex, !m_send_mutex);
     CNetMessage GetReceivedMessage(std::chrono::microseconds time, bool& reject_message) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
+    size_t GetReceiveMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
 
     // Send side functions.
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    std::span<const uint8_t> GetNextBytesToSend() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
 
@@ -667,6 +826,8 @@ struct CNodeOptions
     bool prefer_evict = false;
     size_t recv_flood_size{DEFAULT_MAXRECEIVEBUFFER * 1000};
     bool use_v2transport = false;
+    /** Where V2 connections take their key from, if not null. */
+    EllSwiftKeyPool* v2_key_pool = nullptr;
 };
 
 /** Information about a peer */
@@ -751,6 +912,13 @@ public:
     std::optional<std::pair<CNetMessage, bool>> PollMessage()
         EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
 
+    /** Like PollMessage(), but only take the next message if its type is one of `msg_types`. */
+    std::optional<std::pair<CNetMessage, bool>> PollMessage(std::span<const std::string_view> msg_types)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
+
+    /** Memory used by the received messages waiting to be processed. */
+    size_t GetProcessQueueMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
+
     /** Account for the total size of a sent message in the per msg type connection stats. */
     void AccountForSentBytes(const std::string& msg_type, size_t sent_bytes)
         EXCLUSIVE_LOCKS_REQUIRED(cs_vSend)
@@ -978,7 +1146,7 @@ private:
     const size_t m_recv_flood_size;
     std::list<CNetMessage> vRecvMsg; // Used only by SocketHandler thread
 
-    Mutex m_msg_process_queue_mutex;
+    mutable Mutex m_msg_process_queue_mutex;
     std::list<CNetMessage> m_msg_process_queue GUARDED_BY(m_msg_process_queue_mutex);
     size_t m_msg_process_queue_size GUARDED_BY(m_msg_process_queue_mutex){0};
 
@@ -1040,6 +1208,16 @@ public:
     */
     virtual bool SendMessages(CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
 
+    /**
+    * Process the next message received from a given node if it only touches
+    * the state of that node, without g_msgproc_mutex. Must not run concurrently
+    * with ProcessMessages() for the same node.
+    *
+    * @param[in]   pnode           The node which we have received messages from.
+    * @return                      True if a message was processed
+    */
+    virtual bool ProcessPeerLocalMessage(CNode* pnode) = 0;
+
 
 protected:
     /**
@@ -1061,8 +1239,11 @@ public:
         NetEventsInterface* m_msgproc = nullptr;
         BanMan* m_banman = nullptr;
         unsigned int nSendBufferMaxSize = 0;
+        size_t m_total_send_buffer_max_size = DEFAULT_MAXTOTALSENDBUFFER * 1000;
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundLimit = 0;
+        //! Limit on the outbound traffic rate in bytes per second, 0 for none.
+        uint64_t m_max_upload_rate = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeIncoming;
@@ -1079,6 +1260,8 @@ public:
         bool m_i2p_accept_incoming;
         bool whitelist_forcerelay = DEFAULT_WHITELISTFORCERELAY;
         bool whitelist_relay = DEFAULT_WHITELISTRELAY;
+        bool m_use_epoll = DEFAULT_NET_EPOLL;
+        int m_message_handler_threads = DEFAULT_MESSAGE_HANDLER_THREADS;
     };
 
     void Init(const Options& connOptions) EXCLUSIVE_LOCKS_REQUIRED(!m_added_nodes_mutex, !m_total_bytes_sent_mutex)
@@ -1096,12 +1279,14 @@ public:
         m_banman = connOptions.m_banman;
         m_msgproc = connOptions.m_msgproc;
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
+        m_total_send_buffer_max_size = connOptions.m_total_send_buffer_max_size;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = std::chrono::seconds{connOptions.m_peer_connect_timeout};
         {
             LOCK(m_total_bytes_sent_mutex);
             nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
         }
+        m_upload_rate_limiter.SetRate(connOptions.m_max_upload_rate);
         vWhitelistedRangeIncoming = connOptions.vWhitelistedRangeIncoming;
         vWhitelistedRangeOutgoing = connOptions.vWhitelistedRangeOutgoing;
         {
@@ -1116,6 +1301,8 @@ public:
         m_onion_binds = connOptions.onion_binds;
         whitelist_forcerelay = connOptions.whitelist_forcerelay;
         whitelist_relay = connOptions.whitelist_relay;
+        m_use_epoll = connOptions.m_use_epoll;
+        m_message_handler_threads = std::clamp(connOptions.m_message_handler_threads, 1, MAX_MESSAGE_HANDLER_THREADS);
     }
 
     CConnman(uint64_t seed0, uint64_t seed1, AddrMan& addrman, const NetGroupManager& netgroupman,
@@ -1263,6 +1450,21 @@ public:
     uint64_t GetTotalBytesRecv() const;
     uint64_t GetTotalBytesSent() const EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex);
 
+    const EllSwiftKeyPool& GetV2KeyPool() const { return m_v2_key_pool; }
+    //! Memory used by the send queues of all peers together.
+    size_t GetTotalSendMemoryUsage() const { return m_total_send_memusage; }
+
+    struct PeerMemoryUsage {
+        //! Messages queued to be sent, and the transport buffers sending them.
+        size_t send{0};
+        //! Messages received but not processed yet, and the transport buffers receiving them.
+        size_t receive{0};
+    };
+    //! Memory used by the send and receive buffers of all peers together.
+    PeerMemoryUsage GetPeerMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex);
+    //! Limiter of the outbound traffic rate (-maxuploadrate).
+    const UploadRateLimiter& GetUploadRateLimiter() const { return m_upload_rate_limiter; }
+
     /** Get a unique deterministic randomizer. */
     CSipHasher GetDeterministicRandomizer(uint64_t id) const;
 
@@ -1299,7 +1501,12 @@ private:
     void AddAddrFetch(const std::string& strDest) EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex);
     void ProcessAddrFetch() EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex, !m_unused_i2p_sessions_mutex);
     void ThreadOpenConnections(std::vector<std::string> connect, std::span<const std::string> seed_nodes) EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex, !m_added_nodes_mutex, !m_nodes_mutex, !m_unused_i2p_sessions_mutex, !m_reconnections_mutex);
-    void ThreadMessageHandler() EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc);
+    /**
+     * Process the messages of the peers in message handler shard `shard`, i.e. those
+     * with `GetId() % m_message_handler_threads == shard`. Each peer is only ever
+     * handled by one thread, so its messages are processed in order.
+     */
+    void ThreadMessageHandler(int shard) EXCLUSIVE_LOCKS_REQUIRED(!mutexMsgProc, !NetEventsInterface::g_msgproc_mutex);
     void ThreadI2PAcceptIncoming();
     void AcceptConnection(const ListenSocket& hListenSocket);
 
@@ -1328,6 +1535,22 @@ private:
      */
     Sock::EventsPerSock GenerateWaitSockets(std::span<CNode* const> nodes);
 
+    /**
+     * Wait for IO readiness of the connected and listening sockets, or for a
+     * short while if there are none to wait on.
+     * @param[in] nodes Wait on these nodes' sockets.
+     * @return sockets that are ready for IO
+     */
+    Sock::EventsPerSock WaitSockets(std::span<CNode* const> nodes);
+
+#ifdef USE_EPOLL
+    /**
+     * Bring the interest registered with m_sock_poller up to date with the
+     * nodes' send and receive state, and forget about closed sockets.
+     */
+    void UpdateSockPoller(std::span<CNode* const> nodes);
+#endif
+
     /**
      * Check connected and listening sockets for IO readiness and process them accordingly.
      */
@@ -1363,7 +1586,7 @@ private:
      */
     bool AlreadyConnectedToAddress(const CAddress& addr);
 
-    bool AttemptToEvictConnection();
+    bool AttemptToEvictConnection() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex);
     CNode* ConnectNode(CAddress addrConnect, const char *pszDest, bool fCountFailure, ConnectionType conn_type, bool use_v2transport) EXCLUSIVE_LOCKS_REQUIRED(!m_unused_i2p_sessions_mutex);
     void AddWhitelistPermissionFlags(NetPermissionFlags& flags, const CNetAddr &addr, const std::vector<NetWhitelistPermissions>& ranges) const;
 
@@ -1372,7 +1595,12 @@ private:
     NodeId GetNewNodeId();
 
     /** (Try to) send data from node's vSendMsg. Returns (bytes_sent, data_left). */
-    std::pair<size_t, bool> SocketSendData(CNode& node) const EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend);
+    std::pair<size_t, bool> SocketSendData(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend);
+
+    /** Whether sending to node should be paused: its own send buffer is above
+     *  nSendBufferMaxSize, or the send queues of all peers together are above
+     *  m_total_send_buffer_max_size and this one is not empty. */
+    bool ShouldPauseSend(const CNode& node) const EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend);
 
     void DumpAddresses();
 
@@ -1419,6 +1647,9 @@ private:
     std::chrono::seconds nMaxOutboundCycleStartTime GUARDED_BY(m_total_bytes_sent_mutex) {0};
     uint64_t nMaxOutboundLimit GUARDED_BY(m_total_bytes_sent_mutex);
 
+    /** Limits the outbound traffic rate of peers without the download permission. */
+    UploadRateLimiter m_upload_rate_limiter;
+
     // P2P timeout in seconds
     std::chrono::seconds m_peer_connect_timeout;
 
@@ -1429,6 +1660,9 @@ private:
     std::vector<NetWhitelistPermissions> vWhitelistedRangeOutgoing;
 
     unsigned int nSendBufferMaxSize{0};
+    size_t m_total_send_buffer_max_size{0};
+    /** Sum of CNode::m_send_memusage over all nodes. */
+    std::atomic<size_t> m_total_send_memusage{0};
     unsigned int nReceiveFloodSize{0};
 
     std::vector<ListenSocket> vhListenSocket;
@@ -1444,6 +1678,8 @@ private:
 
     mutable Mutex m_added_nodes_mutex;
     std::vector<CNode*> m_nodes GUARDED_BY(m_nodes_mutex);
+    /** Inbound peers that may be evicted, refreshed from m_nodes on every eviction attempt. */
+    EvictionCandidates m_eviction_candidates GUARDED_BY(m_nodes_mutex);
     std::list<CNode*> m_nodes_disconnected;
     mutable RecursiveMutex m_nodes_mutex;
     std::atomic<NodeId> nLastNodeId{0};
@@ -1452,6 +1688,19 @@ private:
     // Stores number of full-tx connections (outbound and manual) per network
     std::array<unsigned int, Network::NET_MAX> m_network_conn_counts GUARDED_BY(m_nodes_mutex) = {};
 
+    /** An automatic outbound connection attempt that has not finished yet. */
+    struct PendingOutbound {
+        CAddress addr;
+        ConnectionType conn_type;
+    };
+    /** Attempts started by ThreadOpenConnections. They are counted like connected peers when picking
+     *  the next connection, and only removed once the resulting node (if any) is in m_nodes. */
+    std::list<PendingOutbound> m_pending_outbound GUARDED_BY(m_nodes_mutex);
+    /** Runs the attempts in m_pending_outbound, so that slow connects and proxy handshakes overlap. */
+    ThreadPool m_outbound_pool{"opencon"};
+    /** Ephemeral keys for new V2 connections, filled in the background if we support V2. */
+    EllSwiftKeyPool m_v2_key_pool{V2_KEY_POOL_SIZE};
+
     /**
      * Cache responses to addr requests to minimize privacy leak.
      * Attack example: scraping addrs in real-time may allow an attacker
@@ -1534,8 +1783,8 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake GUARDED_BY(mutexMsgProc);
+    /** Incremented for waking the message processor threads. */
+    uint64_t m_msgproc_wake_count GUARDED_BY(mutexMsgProc){0};
 
     std::condition_variable condMsgProc;
     Mutex mutexMsgProc;
@@ -1560,7 +1809,7 @@ private:
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> threadMessageHandlers;
     std::thread threadI2PAcceptIncoming;
 
     /** flag for deciding to connect to an extra outbound peer,
@@ -1592,6 +1841,22 @@ private:
      */
     bool whitelist_relay;
 
+    /**
+     * Whether to wait for the sockets with m_sock_poller instead of Sock::WaitMany().
+     */
+    bool m_use_epoll{false};
+
+    /** Number of threads, and shards of peers, messages are processed by. */
+    int m_message_handler_threads{DEFAULT_MESSAGE_HANDLER_THREADS};
+
+#ifdef USE_EPOLL
+    /**
+     * Sockets and the events wanted on them, registered between iterations of
+     * SocketHandler(). Only used by the socket handler thread.
+     */
+    std::unique_ptr<SockPoller> m_sock_poller;
+#endif
+
     /**
      * Mutex protecting m_i2p_sam_sessions.
      */
@@ -69,7 +69,6 @@
 #include <deque>
 #include <exception>
 #include <functional>
-#include <future>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
@@ -89,6 +88,8 @@ using namespace util::hex_literals;
 
 TRACEPOINT_SEMAPHORE(net, inbound_message);
 TRACEPOINT_SEMAPHORE(net, misbehaving_connection);
+TRACEPOINT_SEMAPHORE(net, processed_message);
+TRACEPOINT_SEMAPHORE(net, blocks_to_download);
 
 /** Headers download timeout.
  *  Timeout = base + per_header * (expected number of headers) */
@@ -124,8 +125,20 @@ static const unsigned int MAX_LOCATOR_SZ = 101;
 static const unsigned int MAX_INV_SZ = 50000;
 /** Limit to avoid sending big packets. Not used in processing incoming GETDATA for compatibility */
 static const unsigned int MAX_GETDATA_SZ = 1000;
-/** Number of blocks that can be requested at any given time from a single peer. */
+/** Number of blocks that can be requested at any given time from a single peer, until its
+ *  throughput has been measured. It is also the lower bound of the adaptive per-peer limit. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
+/** Upper bound of the per-peer in-flight block limit for peers that deliver blocks quickly. */
+static const int MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER = 128;
+/** The per-peer in-flight block limit is sized so that the last requested block is expected
+ *  to arrive this long after being requested, given the peer's measured block interval. */
+static constexpr auto BLOCK_DOWNLOAD_TARGET_LATENCY{1s};
+/** Weight of a new sample in the per-peer block interval and latency moving averages is 1/N. */
+static constexpr int BLOCK_DOWNLOAD_STATS_SMOOTHING{8};
+/** A block holding back the download window is requested from a second peer once its request
+ *  is this old (and twice as old as the second peer's average block latency), well before
+ *  the stalling timeout disconnects the first peer. */
+static constexpr auto BLOCK_STEAL_MIN_AGE{1s};
 /** Default time during which a peer must stall block download progress before being disconnected.
  * the actual timeout is increased temporarily if peers are disconnected for hitting the timeout */
 static constexpr auto BLOCK_STALLING_TIMEOUT_DEFAULT{2s};
@@ -137,6 +150,9 @@ static const int MAX_CMPCTBLOCK_DEPTH = 5;
 /** Maximum depth of blocks we're willing to respond to GETBLOCKTXN requests for. */
 static const int MAX_BLOCKTXN_DEPTH = 10;
 static_assert(MAX_BLOCKTXN_DEPTH <= MIN_BLOCKS_TO_KEEP, "MAX_BLOCKTXN_DEPTH too high");
+/** Maximum number of serialized full-size HEADERS responses to keep around for answering GETHEADERS.
+ *  At 2000 headers per response this is about 10 MB. */
+static constexpr size_t MAX_HEADERS_CACHE_ENTRIES{64};
 /** Size of the "block download window": how far ahead of our current height do we fetch?
  *  Larger windows tolerate larger download speed differences between peer, but increase the potential
  *  degree of disordering of blocks on disk (which make reindexing and pruning harder). We'll probably
@@ -204,6 +220,63 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the block was requested. */
+    std::chrono::microseconds m_requested_time{0us};
+};
+
+/**
+ * Transactions to announce to a peer, kept in the order they are announced
+ * in, so that an announcement round takes them from the front without
+ * sorting them or looking them up in the mempool.
+ */
+class TxInventoryQueue
+{
+    using Entry = std::pair<TxRelayOrder, GenTxid>;
+    struct EntryOrder {
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            if (a.first < b.first) return true;
+            if (b.first < a.first) return false;
+            return a.second < b.second;
+        }
+    };
+    std::set<Entry, EntryOrder> m_queue;
+    std::map<GenTxid, std::set<Entry, EntryOrder>::const_iterator> m_index;
+
+public:
+    /** Add a transaction, unless it is already queued. */
+    void Push(const GenTxid& gtxid, const TxRelayOrder& order)
+    {
+        const auto [it, inserted]{m_index.try_emplace(gtxid)};
+        if (inserted) it->second = m_queue.emplace(order, gtxid).first;
+    }
+
+    /** Take the transaction to announce next. The queue must not be empty. */
+    GenTxid Pop()
+    {
+        Assume(!m_queue.empty());
+        const GenTxid gtxid{m_queue.begin()->second};
+        m_index.erase(gtxid);
+        m_queue.erase(m_queue.begin());
+        return gtxid;
+    }
+
+    void Erase(const GenTxid& gtxid)
+    {
+        if (const auto it{m_index.find(gtxid)}; it != m_index.end()) {
+            m_queue.erase(it->second);
+            m_index.erase(it);
+        }
+    }
+
+    void Clear()
+    {
+        m_queue.clear();
+        m_index.clear();
+    }
+
+    bool Empty() const { return m_queue.empty(); }
+    size_t Size() const { return m_queue.size(); }
 };
 
 /**
@@ -296,13 +369,14 @@ struct Peer {
         mutable RecursiveMutex m_tx_inventory_mutex;
         /** A filter of all the (w)txids that the peer has announced to
          *  us or we have announced to the peer. We use this to avoid announcing
-         *  the same (w)txid to a peer that already has the transaction. */
-        CRollingBloomFilter m_tx_inventory_known_filter GUARDED_BY(m_tx_inventory_mutex){50000, 0.000001};
-        /** Set of transaction ids we still have to announce (txid for
-         *  non-wtxid-relay peers, wtxid for wtxid-relay peers). We use the
-         *  mempool to sort transactions in dependency order before relay, so
-         *  this does not have to be sorted. */
-        std::set<GenTxid> m_tx_inventory_to_send GUARDED_BY(m_tx_inventory_mutex);
+         *  the same (w)txid to a peer that already has the transaction. It is
+         *  looked up and updated for every announcement, so each of these
+         *  touches a single cache line. */
+        CBlockedRollingBloomFilter m_tx_inventory_known_filter GUARDED_BY(m_tx_inventory_mutex){50000, 0.000001};
+        /** Transaction ids we still have to announce (txid for
+         *  non-wtxid-relay peers, wtxid for wtxid-relay peers), in the order
+         *  they are announced in. */
+        TxInventoryQueue m_tx_inventory_to_send GUARDED_BY(m_tx_inventory_mutex);
         /** Whether the peer has requested us to send our complete mempool. Only
          *  permitted if the peer has NetPermissionFlags::Mempool or we advertise
          *  NODE_BLOOM. See BIP35. */
@@ -449,6 +523,16 @@ struct CNodeState {
     std::list<QueuedBlock> vBlocksInFlight;
     //! When the first entry in vBlocksInFlight started downloading. Don't care when vBlocksInFlight is empty.
     std::chrono::microseconds m_downloading_since{0us};
+    //! How many blocks may be in flight from this peer at once, adapted to its measured block interval.
+    int m_blocks_in_flight_limit{MAX_BLOCKS_IN_TRANSIT_PER_PEER};
+    //! Number of requested blocks this peer delivered.
+    uint64_t m_blocks_received{0};
+    //! When this peer last delivered a requested block.
+    std::chrono::microseconds m_last_block_received{0us};
+    //! Moving average of the time this peer took per block while it had blocks in flight.
+    std::chrono::microseconds m_block_interval_avg{0us};
+    //! Moving average of the time between requesting a block from this peer and receiving it.
+    std::chrono::microseconds m_block_latency_avg{0us};
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload{false};
     /** Whether this peer wants invs or cmpctblocks (when possible) for block announcements. */
@@ -517,15 +601,18 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
+    std::string SubscriberName() const override { return "peerman"; }
 
     /** Implement NetEventsInterface */
     void InitializeNode(const CNode& node, ServiceFlags our_services) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_tx_download_mutex);
-    void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_tx_download_mutex);
+    void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_tx_download_mutex, !m_msgproc_stats_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
     bool ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_msgproc_stats_mutex);
     bool SendMessages(CNode* pto) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, g_msgproc_mutex, !m_tx_download_mutex);
+    bool ProcessPeerLocalMessage(CNode* pfrom) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_tx_download_mutex);
 
     /** Implement PeerManager */
     void StartScheduledTasks(CScheduler& scheduler) override;
@@ -534,7 +621,11 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
+    size_t GetOrphanageMemoryUsage() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
     PeerManagerInfo GetInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
+    bool HasMessageProcessingStats() const override { return m_opts.msgproc_stats; }
+    std::map<std::string, MessageProcessingStats> GetMessageTypeProcessingStats() const override EXCLUSIVE_LOCKS_REQUIRED(!m_msgproc_stats_mutex);
+    std::map<NodeId, MessageProcessingStats> GetPeerProcessingStats() const override EXCLUSIVE_LOCKS_REQUIRED(!m_msgproc_stats_mutex);
     void SendPings() override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void RelayTransaction(const Txid& txid, const Wtxid& wtxid) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void SetBestBlock(int height, std::chrono::seconds time) override
@@ -550,6 +641,15 @@ public:
     ServiceFlags GetDesirableServiceFlags(ServiceFlags services) const override;
 
 private:
+    /** Report a message about to be processed to tracing and, if enabled, message capture. */
+    void TraceInboundMessage(const CNode& pfrom, const CNetMessage& msg);
+
+    /** Answer a ping. Only touches the state of `pfrom`. */
+    void ProcessPing(CNode& pfrom, DataStream& vRecv);
+
+    /** Account for the pong answering our last ping, if it does. Only touches the state of `pfrom` and `peer`. */
+    void ProcessPong(CNode& pfrom, Peer& peer, DataStream& vRecv, std::chrono::microseconds time_received);
+
     /** Consider evicting an outbound peer based on the amount of time they've been behind our tip */
     void ConsiderEviction(CNode& pto, Peer& peer, std::chrono::seconds time_in_seconds) EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_msgproc_mutex);
 
@@ -851,10 +951,20 @@ private:
                                                 std::chrono::seconds average_interval) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
 
+    /** Processing time of received messages, if enabled by -msgprocstats. Messages of unknown type
+     *  count as NET_MESSAGE_TYPE_OTHER. */
+    mutable Mutex m_msgproc_stats_mutex;
+    std::map<std::string, MessageProcessingStats> m_msgtype_stats GUARDED_BY(m_msgproc_stats_mutex);
+    std::map<NodeId, MessageProcessingStats> m_peer_msgproc_stats GUARDED_BY(m_msgproc_stats_mutex);
+    void RecordMessageProcessing(NodeId peer, const std::string& msg_type, SteadyClock::duration duration,
+                                 std::chrono::nanoseconds cs_main_wait) EXCLUSIVE_LOCKS_REQUIRED(!m_msgproc_stats_mutex);
+
     // All of the following cache a recent block, and are protected by m_most_recent_block_mutex
     Mutex m_most_recent_block_mutex;
     std::shared_ptr<const CBlock> m_most_recent_block GUARDED_BY(m_most_recent_block_mutex);
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> m_most_recent_compact_block GUARDED_BY(m_most_recent_block_mutex);
+    /** m_most_recent_compact_block serialized once, its payload shared by the copies sent to each peer. */
+    CSerializedNetMsg m_most_recent_compact_block_msg GUARDED_BY(m_most_recent_block_mutex);
     uint256 m_most_recent_block_hash GUARDED_BY(m_most_recent_block_mutex);
     std::unique_ptr<const std::map<GenTxid, CTransactionRef>> m_most_recent_block_txs GUARDED_BY(m_most_recent_block_mutex);
 
@@ -900,6 +1010,15 @@ private:
      */
     bool BlockRequested(NodeId nodeid, const CBlockIndex& block, std::list<QueuedBlock>::iterator** pit = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Update the download statistics and in-flight limit of a peer that delivered a block
+     *  we requested from it, and drop the now redundant full block requests to other peers. */
+    void BlockReceived(NodeId nodeid, const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** Request the oldest block in flight from `staller` from peer `nodeid` too, if that request
+     *  is old enough that `nodeid` is expected to deliver the block sooner.
+     *  @return the block to request, or nullptr */
+    const CBlockIndex* MaybeStealBlockRequest(const Peer& peer, NodeId staller, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     bool TipMayBeStale() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     /** Update pindexLastCommonBlock and add not-in-flight missing successors to vBlocks, until it has
@@ -946,6 +1065,12 @@ private:
     /** When our tip was last updated. */
     std::atomic<std::chrono::seconds> m_last_tip_update{0s};
 
+    /** Announce transactions chosen by a reconciliation round to the peer right away, bypassing
+     *  the trickle queue (and so the reconciliation set) and skipping those it already knows or
+     *  that left our mempool. */
+    void AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids)
+        EXCLUSIVE_LOCKS_REQUIRED(NetEventsInterface::g_msgproc_mutex);
+
     /** Determine whether or not a peer can request a transaction, and return it (or nullptr if not found or not allowed). */
     CTransactionRef FindTxForGetData(const Peer::TxRelay& tx_relay, const CInv& inv)
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, NetEventsInterface::g_msgproc_mutex);
@@ -1003,6 +1128,23 @@ private:
      * about and we fully-validated them at some point.
      */
     bool BlockRequestAllowed(const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** A serialized HEADERS response of max_headers_result headers of the active chain. */
+    struct CachedHeaders {
+        //! The last header in the response. The entry is only valid while this is in the active chain.
+        const CBlockIndex* m_last;
+        CSerializedNetMsg m_msg;
+        uint64_t m_last_used;
+    };
+    /** Full-size HEADERS responses, by the height of their first header. Bootstrapping peers tend to
+     *  request the same ranges, so this saves walking the chain and serializing again for each one. */
+    std::map<int, CachedHeaders> m_headers_cache GUARDED_BY(cs_main);
+    uint64_t m_headers_cache_clock GUARDED_BY(cs_main){0};
+
+    /** Get the HEADERS response for the headers of the active chain from first to last (inclusive),
+     *  which must be max_headers_result headers, from the cache or by serializing and caching it. */
+    const CSerializedNetMsg& GetCachedHeaders(const CBlockIndex& first, const CBlockIndex& last) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
         EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
@@ -1148,6 +1290,17 @@ static bool CanServeWitnesses(const Peer& peer)
     return peer.m_their_services & NODE_WITNESS;
 }
 
+/**
+ * Return the payload of a received message to RecvBufferPool() once it has
+ * been deserialized, rather than when the message is destroyed, so that the raw
+ * bytes of a block are not held along with the deserialized block while it is
+ * validated and written to disk.
+ */
+static void ReleaseRecvBuffer(DataStream& vRecv)
+{
+    RecvBufferPool().Return(std::exchange(vRecv, DataStream{}));
+}
+
 std::chrono::microseconds PeerManagerImpl::NextInvToInbounds(std::chrono::microseconds now,
                                                              std::chrono::seconds average_interval)
 {
@@ -1235,11 +1388,12 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     // Make sure it's not being fetched already from same peer.
     RemoveBlockRequest(hash, nodeid);
 
+    const auto now{GetTime<std::chrono::microseconds>()};
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr)});
+            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr), now});
     if (state->vBlocksInFlight.size() == 1) {
         // We're starting a block download (batch) from this peer.
-        state->m_downloading_since = GetTime<std::chrono::microseconds>();
+        state->m_downloading_since = now;
         m_peers_downloading_from++;
     }
     auto itInFlight = mapBlocksInFlight.insert(std::make_pair(hash, std::make_pair(nodeid, it)));
@@ -1249,6 +1403,65 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     return true;
 }
 
+void PeerManagerImpl::BlockReceived(NodeId nodeid, const uint256& hash)
+{
+    CNodeState& state{*Assert(State(nodeid))};
+    auto range{mapBlocksInFlight.equal_range(hash)};
+    auto it{std::find_if(range.first, range.second, [&](const auto& entry) { return entry.second.first == nodeid; })};
+    if (it == range.second) return;
+
+    // The peer was busy with this block since it was requested, or since it delivered the
+    // previous one if that came later.
+    const auto now{GetTime<std::chrono::microseconds>()};
+    const auto requested{it->second.second->m_requested_time};
+    const auto interval{now - std::max(requested, state.m_last_block_received)};
+    const auto latency{now - requested};
+    auto update_avg = [](std::chrono::microseconds& avg, std::chrono::microseconds sample) {
+        avg = avg == 0us ? sample : avg + (sample - avg) / BLOCK_DOWNLOAD_STATS_SMOOTHING;
+    };
+    update_avg(state.m_block_interval_avg, std::max(interval, 1us));
+    update_avg(state.m_block_latency_avg, latency);
+    state.m_last_block_received = now;
+    ++state.m_blocks_received;
+    // Keep as many blocks in flight as the peer delivers in BLOCK_DOWNLOAD_TARGET_LATENCY.
+    const auto wanted{BLOCK_DOWNLOAD_TARGET_LATENCY / std::max(state.m_block_interval_avg, 1us)};
+    state.m_blocks_in_flight_limit = std::clamp<int64_t>(wanted, MAX_BLOCKS_IN_TRANSIT_PER_PEER, MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER);
+
+    // Another peer may still have this block in flight if it was re-requested from this one. A
+    // full block request there is redundant now; a compact block download is left alone.
+    std::vector<NodeId> redundant;
+    for (; range.first != range.second; ++range.first) {
+        const auto& [other, queued]{range.first->second};
+        if (other != nodeid && !queued->partialBlock) redundant.push_back(other);
+    }
+    for (const NodeId other : redundant) RemoveBlockRequest(hash, other);
+}
+
+const CBlockIndex* PeerManagerImpl::MaybeStealBlockRequest(const Peer& peer, NodeId staller, std::chrono::microseconds now)
+{
+    if (staller == peer.m_id) return nullptr;
+    const CNodeState* state{State(peer.m_id)};
+    CNodeState* staller_state{State(staller)};
+    if (!state || !staller_state || staller_state->vBlocksInFlight.empty()) return nullptr;
+    // Only steal for peers whose own latency is known to be good.
+    if (state->m_blocks_received == 0) return nullptr;
+
+    // Blocks are requested in height order, so the oldest request is the one holding back the window.
+    const QueuedBlock& queued{staller_state->vBlocksInFlight.front()};
+    if (queued.partialBlock || !queued.pindex) return nullptr;
+    const auto age{now - queued.m_requested_time};
+    if (age < BLOCK_STEAL_MIN_AGE || age < 2 * state->m_block_latency_avg) return nullptr;
+
+    const CBlockIndex& block{*queued.pindex};
+    if (mapBlocksInFlight.count(block.GetBlockHash()) != 1) return nullptr;
+    if (!state->pindexBestKnownBlock || state->pindexBestKnownBlock->GetAncestor(block.nHeight) != &block) return nullptr;
+    if (!CanServeWitnesses(peer) && DeploymentActiveAt(block, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return nullptr;
+
+    // The staller gets to start over with the smallest in-flight limit.
+    staller_state->m_blocks_in_flight_limit = MAX_BLOCKS_IN_TRANSIT_PER_PEER;
+    return &block;
+}
+
 void PeerManagerImpl::MaybeSetPeerAsAnnouncingHeaderAndIDs(NodeId nodeid)
 {
     AssertLockHeld(cs_main);
@@ -1662,6 +1875,7 @@ void PeerManagerImpl::FinalizeNode(const CNode& node)
         LOCK(m_headers_presync_mutex);
         m_headers_presync_stats.erase(nodeid);
     }
+    WITH_LOCK(m_msgproc_stats_mutex, m_peer_msgproc_stats.erase(nodeid));
     LogDebug(BCLog::NET, "Cleared nodestate for peer=%d\n", nodeid);
 }
 
@@ -1714,6 +1928,10 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
             if (queue.pindex)
                 stats.vHeightInFlight.push_back(queue.pindex->nHeight);
         }
+        stats.m_blocks_in_flight_limit = state->m_blocks_in_flight_limit;
+        stats.m_blocks_received = state->m_blocks_received;
+        stats.m_block_interval_avg = state->m_block_interval_avg;
+        stats.m_block_latency_avg = state->m_block_latency_avg;
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -1760,6 +1978,42 @@ std::vector<TxOrphanage::OrphanTxBase> PeerManagerImpl::GetOrphanTransactions()
     return m_txdownloadman.GetOrphanTransactions();
 }
 
+size_t PeerManagerImpl::GetOrphanageMemoryUsage()
+{
+    LOCK(m_tx_download_mutex);
+    return m_txdownloadman.GetOrphanageMemoryUsage();
+}
+
+void PeerManagerImpl::RecordMessageProcessing(NodeId peer, const std::string& msg_type, SteadyClock::duration duration,
+                                              std::chrono::nanoseconds cs_main_wait)
+{
+    const bool known{std::ranges::find(ALL_NET_MESSAGE_TYPES, msg_type) != ALL_NET_MESSAGE_TYPES.end()};
+    const std::string& type{known ? msg_type : NET_MESSAGE_TYPE_OTHER};
+
+    TRACEPOINT(net, processed_message,
+        peer,
+        type.c_str(),
+        std::chrono::nanoseconds{duration}.count(),
+        cs_main_wait.count()
+    );
+
+    LOCK(m_msgproc_stats_mutex);
+    for (MessageProcessingStats* stats : {&m_msgtype_stats[type], &m_peer_msgproc_stats[peer]}) {
+        stats->time.Add(duration);
+        stats->cs_main_wait += cs_main_wait;
+    }
+}
+
+std::map<std::string, MessageProcessingStats> PeerManagerImpl::GetMessageTypeProcessingStats() const
+{
+    return WITH_LOCK(m_msgproc_stats_mutex, return m_msgtype_stats);
+}
+
+std::map<NodeId, MessageProcessingStats> PeerManagerImpl::GetPeerProcessingStats() const
+{
+    return WITH_LOCK(m_msgproc_stats_mutex, return m_peer_msgproc_stats);
+}
+
 PeerManagerInfo PeerManagerImpl::GetInfo() const
 {
     return PeerManagerInfo{
@@ -1871,6 +2125,34 @@ bool PeerManagerImpl::BlockRequestAllowed(const CBlockIndex* pindex)
            (GetBlockProofEquivalentTime(*m_chainman.m_best_header, *pindex, *m_chainman.m_best_header, m_chainparams.GetConsensus()) < STALE_RELAY_AGE_LIMIT);
 }
 
+const CSerializedNetMsg& PeerManagerImpl::GetCachedHeaders(const CBlockIndex& first, const CBlockIndex& last)
+{
+    AssertLockHeld(cs_main);
+    auto it = m_headers_cache.find(first.nHeight);
+    // A reorg replaces the block at the end of the range, or at least one before it.
+    if (it == m_headers_cache.end() || it->second.m_last != &last) {
+        if (it != m_headers_cache.end()) {
+            m_headers_cache.erase(it);
+        } else if (m_headers_cache.size() >= MAX_HEADERS_CACHE_ENTRIES) {
+            m_headers_cache.erase(std::min_element(m_headers_cache.begin(), m_headers_cache.end(), [](const auto& a, const auto& b) {
+                return a.second.m_last_used < b.second.m_last_used;
+            }));
+        }
+        // we must use CBlocks, as CBlockHeaders won't include the 0x00 nTx count at the end
+        std::vector<CBlock> headers;
+        headers.reserve(last.nHeight - first.nHeight + 1);
+        for (const CBlockIndex* pindex = &first; pindex; pindex = m_chainman.ActiveChain().Next(pindex)) {
+            headers.emplace_back(pindex->GetBlockHeader());
+            if (pindex == &last) break;
+        }
+        CSerializedNetMsg msg{NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(headers))};
+        msg.MakeShared();
+        it = m_headers_cache.emplace(first.nHeight, CachedHeaders{&last, std::move(msg), 0}).first;
+    }
+    it->second.m_last_used = ++m_headers_cache_clock;
+    return it->second.m_msg;
+}
+
 std::optional<std::string> PeerManagerImpl::FetchBlock(NodeId peer_id, const CBlockIndex& block_index)
 {
     if (m_chainman.m_blockman.LoadingBlocks()) return "Loading blocks ...";
@@ -1929,8 +2211,7 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
       m_warnings{warnings},
       m_opts{opts}
 {
-    // While Erlay support is incomplete, it must be enabled explicitly via -txreconciliation.
-    // This argument can go away after Erlay support is complete.
+    // Erlay is still experimental, so it must be enabled explicitly via -txreconciliation.
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
@@ -2023,8 +2304,8 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
     if (!DeploymentActiveAt(*pindex, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return;
 
     uint256 hashBlock(pblock->GetHash());
-    const std::shared_future<CSerializedNetMsg> lazy_ser{
-        std::async(std::launch::deferred, [&] { return NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock); })};
+    CSerializedNetMsg ser_cmpctblock{NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock)};
+    ser_cmpctblock.MakeShared();
 
     {
         auto most_recent_block_txs = std::make_unique<std::map<GenTxid, CTransactionRef>>();
@@ -2037,10 +2318,11 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
         m_most_recent_block_hash = hashBlock;
         m_most_recent_block = pblock;
         m_most_recent_compact_block = pcmpctblock;
+        m_most_recent_compact_block_msg = ser_cmpctblock.Copy();
         m_most_recent_block_txs = std::move(most_recent_block_txs);
     }
 
-    m_connman.ForEachNode([this, pindex, &lazy_ser, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    m_connman.ForEachNode([this, pindex, &ser_cmpctblock, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
 
         if (pnode->GetCommonVersion() < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect)
@@ -2054,7 +2336,6 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
             LogDebug(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerManager::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
 
-            const CSerializedNetMsg& ser_cmpctblock{lazy_ser.get()};
             PushMessage(*pnode, ser_cmpctblock.Copy());
             state.pindexBestHeaderSent = pindex;
         }
@@ -2152,6 +2433,9 @@ void PeerManagerImpl::SendPings()
 
 void PeerManagerImpl::RelayTransaction(const Txid& txid, const Wtxid& wtxid)
 {
+    // Looked up once for all peers.
+    const TxRelayOrder order{m_mempool.GetRelayOrder(txid)};
+
     LOCK(m_peer_mutex);
     for(auto& it : m_peer_map) {
         Peer& peer = *it.second;
@@ -2168,7 +2452,7 @@ void PeerManagerImpl::RelayTransaction(const Txid& txid, const Wtxid& wtxid)
 
         const auto gtxid{peer.m_wtxid_relay ? GenTxid{wtxid} : GenTxid{txid}};
         if (!tx_relay->m_tx_inventory_known_filter.contains(gtxid.ToUint256())) {
-            tx_relay->m_tx_inventory_to_send.insert(gtxid);
+            tx_relay->m_tx_inventory_to_send.Push(gtxid, order);
         }
     }
 }
@@ -2226,10 +2510,12 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
 {
     std::shared_ptr<const CBlock> a_recent_block;
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
+    CSerializedNetMsg a_recent_compact_block_msg;
     {
         LOCK(m_most_recent_block_mutex);
         a_recent_block = m_most_recent_block;
         a_recent_compact_block = m_most_recent_compact_block;
+        a_recent_compact_block_msg = m_most_recent_compact_block_msg.Copy();
     }
 
     bool need_activate_chain = false;
@@ -2300,11 +2586,18 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     std::shared_ptr<const CBlock> pblock;
     if (a_recent_block && a_recent_block->GetHash() == inv.hash) {
         pblock = a_recent_block;
-    } else if (inv.IsMsgWitnessBlk()) {
+    } else if (inv.IsMsgWitnessBlk() || inv.IsMsgBlk()) {
         // Fast-path: in this case it is possible to serve the block directly from disk,
-        // as the network format matches the format on disk
-        std::vector<std::byte> block_data;
-        if (!m_chainman.m_blockman.ReadRawBlock(block_data, block_pos)) {
+        // as the network format matches the format on disk, or is the format on
+        // disk with the witness data dropped, which does not need the block to
+        // be deserialized.
+        // Read straight into the message payload, which the transport sends
+        // from without copying it again.
+        CSerializedNetMsg msg;
+        msg.m_type = NetMsgType::BLOCK;
+        const bool read{inv.IsMsgWitnessBlk() ? m_chainman.m_blockman.ReadRawBlock(msg.data, block_pos) :
+                                                 m_chainman.m_blockman.ReadRawBlockNoWitness(msg.data, block_pos)};
+        if (!read) {
             if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(*pindex))) {
                 LogDebug(BCLog::NET, "Block was pruned before it could be read, %s\n", pfrom.DisconnectMsg(fLogIPs));
             } else {
@@ -2313,7 +2606,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
             pfrom.fDisconnect = true;
             return;
         }
-        MakeAndPushMessage(pfrom, NetMsgType::BLOCK, std::span{block_data});
+        m_connman.PushMessage(&pfrom, std::move(msg));
         // Don't set pblock as we've sent the block
     } else {
         // Send block from disk
@@ -2365,7 +2658,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
             // instead we respond with the full, non-compact block.
             if (can_direct_fetch && pindex->nHeight >= tip->nHeight - MAX_CMPCTBLOCK_DEPTH) {
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == inv.hash) {
-                    MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
+                    PushMessage(pfrom, std::move(a_recent_compact_block_msg));
                 } else {
                     CBlockHeaderAndShortTxIDs cmpctblock{*pblock, m_rng.rand64()};
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, cmpctblock);
@@ -2391,6 +2684,30 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     }
 }
 
+void PeerManagerImpl::AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay || wtxids.empty()) return;
+
+    std::vector<CInv> invs;
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    for (const Wtxid& wtxid : wtxids) {
+        if (tx_relay->m_tx_inventory_known_filter.contains(wtxid.ToUint256())) continue;
+        if (!m_mempool.exists(wtxid)) continue;
+        tx_relay->m_tx_inventory_known_filter.insert(wtxid.ToUint256());
+        invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+        if (invs.size() == MAX_INV_SZ) {
+            MakeAndPushMessage(node, NetMsgType::INV, invs);
+            invs.clear();
+        }
+    }
+    if (!invs.empty()) MakeAndPushMessage(node, NetMsgType::INV, invs);
+
+    // Ensure we'll respond to GETDATA requests for anything we've just announced
+    LOCK(m_mempool.cs);
+    tx_relay->m_last_inv_sequence = m_mempool.GetSequence();
+}
+
 CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay, const CInv& inv)
 {
     auto gtxid{ToGenTxid(inv)};
@@ -2898,11 +3215,26 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
     // REDOWNLOAD) can be validated without further anti-DoS checks.
     bool already_validated_work = false;
 
+    // Headers that are already in memory, e.g. because another peer synced
+    // the same chain, do not need the anti-DoS headers sync.
+    const bool headers_known{WITH_LOCK(::cs_main, return IsAncestorOfBestHeaderOrTip(m_chainman.m_blockman.LookupBlockIndex(headers.back().GetHash())))};
+
     // If we're in the middle of headers sync, let it do its magic.
     bool have_headers_sync = false;
     {
         LOCK(peer.m_headers_sync_mutex);
 
+        if (headers_known && peer.m_headers_sync) {
+            // Rather than keeping commitments to and redownloading a chain that
+            // is already known, which would have every peer serving it hold
+            // its own copy of the sync state, end this peer's sync and process
+            // the headers as usual, below.
+            LogDebug(BCLog::NET, "Ending low-work headers sync with peer=%d, its headers are already known\n", pfrom.GetId());
+            peer.m_headers_sync.reset(nullptr);
+            LOCK(m_headers_presync_mutex);
+            m_headers_presync_stats.erase(pfrom.GetId());
+        }
+
         already_validated_work = IsContinuationOfLowWorkHeadersSync(peer, pfrom, headers);
 
         // The headers we passed in may have been:
@@ -3435,6 +3767,81 @@ void PeerManagerImpl::LogBlockHeader(const CBlockIndex& index, const CNode& peer
     }
 }
 
+void PeerManagerImpl::ProcessPing(CNode& pfrom, DataStream& vRecv)
+{
+    if (pfrom.GetCommonVersion() > BIP0031_VERSION) {
+        uint64_t nonce = 0;
+        vRecv >> nonce;
+        // Echo the message back with the nonce. This allows for two useful features:
+        //
+        // 1) A remote node can quickly check if the connection is operational
+        // 2) Remote nodes can measure the latency of the network thread. If this node
+        //    is overloaded it won't respond to pings quickly and the remote node can
+        //    avoid sending us more work, like chain download requests.
+        //
+        // The nonce stops the remote getting confused between different pings: without
+        // it, if the remote node sends a ping once per second and this node takes 5
+        // seconds to respond to each, the 5th ping the remote sends would appear to
+        // return very quickly.
+        MakeAndPushMessage(pfrom, NetMsgType::PONG, nonce);
+    }
+}
+
+void PeerManagerImpl::ProcessPong(CNode& pfrom, Peer& peer, DataStream& vRecv, std::chrono::microseconds time_received)
+{
+    const auto ping_end = time_received;
+    uint64_t nonce = 0;
+    size_t nAvail = vRecv.in_avail();
+    bool bPingFinished = false;
+    std::string sProblem;
+
+    if (nAvail >= sizeof(nonce)) {
+        vRecv >> nonce;
+
+        // Only process pong message if there is an outstanding ping (old ping without nonce should never pong)
+        if (peer.m_ping_nonce_sent != 0) {
+            if (nonce == peer.m_ping_nonce_sent) {
+                // Matching pong received, this ping is no longer outstanding
+                bPingFinished = true;
+                const auto ping_time = ping_end - peer.m_ping_start.load();
+                if (ping_time.count() >= 0) {
+                    // Let connman know about this successful ping-pong
+                    pfrom.PongReceived(ping_time);
+                } else {
+                    // This should never happen
+                    sProblem = "Timing mishap";
+                }
+            } else {
+                // Nonce mismatches are normal when pings are overlapping
+                sProblem = "Nonce mismatch";
+                if (nonce == 0) {
+                    // This is most likely a bug in another implementation somewhere; cancel this ping
+                    bPingFinished = true;
+                    sProblem = "Nonce zero";
+                }
+            }
+        } else {
+            sProblem = "Unsolicited pong without ping";
+        }
+    } else {
+        // This is most likely a bug in another implementation somewhere; cancel this ping
+        bPingFinished = true;
+        sProblem = "Short payload";
+    }
+
+    if (!(sProblem.empty())) {
+        LogDebug(BCLog::NET, "pong peer=%d: %s, %x expected, %x received, %u bytes\n",
+            pfrom.GetId(),
+            sProblem,
+            peer.m_ping_nonce_sent,
+            nonce,
+            nAvail);
+    }
+    if (bPingFinished) {
+        peer.m_ping_nonce_sent = 0;
+    }
+}
+
 void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type, DataStream& vRecv,
                                      const std::chrono::microseconds time_received,
                                      const std::atomic<bool>& interruptMsgProc)
@@ -3717,7 +4124,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             // leaking the time of arrival to a spy.
             Assume(WITH_LOCK(
                 tx_relay->m_tx_inventory_mutex,
-                return tx_relay->m_tx_inventory_to_send.empty() &&
+                return tx_relay->m_tx_inventory_to_send.Empty() &&
                        tx_relay->m_next_inv_send_time == 0s));
         }
 
@@ -3951,6 +4358,59 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reqrecon from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+        uint16_t remote_set_size, remote_q;
+        vRecv >> remote_set_size >> remote_q;
+        const auto skdata{m_txreconciliation->RespondToReconciliationRequest(pfrom.GetId(), remote_set_size, remote_q)};
+        if (!skdata) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reqrecon), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::SKETCH, *skdata);
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "sketch from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        const auto diff{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)};
+        if (!diff) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected sketch), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{diff->m_success}, diff->m_ask_shortids);
+        AnnounceReconciledTxs(pfrom, *peer, diff->m_announce);
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reconcildiff from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+        uint8_t success;
+        std::vector<uint32_t> ask_shortids;
+        vRecv >> success >> ask_shortids;
+        const auto announce{m_txreconciliation->HandleReconcilDiff(pfrom.GetId(), success != 0, ask_shortids)};
+        if (!announce) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reconcildiff), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(pfrom, *peer, *announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::INV) {
         std::vector<CInv> vInv;
         vRecv >> vInv;
@@ -4001,6 +4461,8 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(*peer, inv.hash);
+                // The peer has the transaction, so it need not be reconciled with it.
+                if (m_txreconciliation && inv.IsMsgWtx()) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
 
                 if (!m_chainman.IsInitialBlockDownload()) {
                     const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
@@ -4241,10 +4703,21 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 pindex = m_chainman.ActiveChain().Next(pindex);
         }
 
+        LogDebug(BCLog::NET, "getheaders %d to %s from peer=%d\n", (pindex ? pindex->nHeight : -1), hashStop.IsNull() ? "end" : hashStop.ToString(), pfrom.GetId());
+
+        // A response with the maximum number of headers is shared between peers asking for the same range.
+        const int last_height{pindex ? pindex->nHeight + int(m_opts.max_headers_result) - 1 : -1};
+        if (pindex && hashStop.IsNull() && last_height <= m_chainman.ActiveChain().Height()) {
+            const CBlockIndex& last{*Assert(m_chainman.ActiveChain()[last_height])};
+            // See below for why pindexBestHeaderSent is reset rather than increased.
+            nodestate->pindexBestHeaderSent = &last;
+            m_connman.PushMessage(&pfrom, GetCachedHeaders(*pindex, last).Copy());
+            return;
+        }
+
         // we must use CBlocks, as CBlockHeaders won't include the 0x00 nTx count at the end
         std::vector<CBlock> vHeaders;
         int nLimit = m_opts.max_headers_result;
-        LogDebug(BCLog::NET, "getheaders %d to %s from peer=%d\n", (pindex ? pindex->nHeight : -1), hashStop.IsNull() ? "end" : hashStop.ToString(), pfrom.GetId());
         for (; pindex; pindex = m_chainman.ActiveChain().Next(pindex))
         {
             vHeaders.emplace_back(pindex->GetBlockHeader());
@@ -4289,6 +4762,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         const uint256& hash = peer->m_wtxid_relay ? wtxid : txid;
         AddKnownTx(*peer, hash);
+        if (m_txreconciliation && peer->m_wtxid_relay) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), ptx->GetWitnessHash());
 
         LOCK2(cs_main, m_tx_download_mutex);
 
@@ -4349,6 +4823,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         CBlockHeaderAndShortTxIDs cmpctblock;
         vRecv >> cmpctblock;
+        ReleaseRecvBuffer(vRecv);
 
         bool received_new_header = false;
         const auto blockhash = cmpctblock.header.GetHash();
@@ -4597,6 +5072,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         BlockTransactions resp;
         vRecv >> resp;
+        ReleaseRecvBuffer(vRecv);
 
         return ProcessCompactBlockTxns(pfrom, *peer, resp);
     }
@@ -4652,6 +5128,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
         vRecv >> TX_WITH_WITNESS(*pblock);
+        ReleaseRecvBuffer(vRecv);
 
         LogDebug(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom.GetId());
 
@@ -4674,6 +5151,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             // Always process the block if we requested it, since we may
             // need it even when it's not a candidate for a new best tip.
             forceProcessing = IsBlockRequested(hash);
+            BlockReceived(pfrom.GetId(), hash);
             RemoveBlockRequest(hash, pfrom.GetId());
             // mapBlockSource is only used for punishing peers and setting
             // which peers send us compact blocks, so the race between here and
@@ -4756,77 +5234,12 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
     }
 
     if (msg_type == NetMsgType::PING) {
-        if (pfrom.GetCommonVersion() > BIP0031_VERSION) {
-            uint64_t nonce = 0;
-            vRecv >> nonce;
-            // Echo the message back with the nonce. This allows for two useful features:
-            //
-            // 1) A remote node can quickly check if the connection is operational
-            // 2) Remote nodes can measure the latency of the network thread. If this node
-            //    is overloaded it won't respond to pings quickly and the remote node can
-            //    avoid sending us more work, like chain download requests.
-            //
-            // The nonce stops the remote getting confused between different pings: without
-            // it, if the remote node sends a ping once per second and this node takes 5
-            // seconds to respond to each, the 5th ping the remote sends would appear to
-            // return very quickly.
-            MakeAndPushMessage(pfrom, NetMsgType::PONG, nonce);
-        }
+        ProcessPing(pfrom, vRecv);
         return;
     }
 
     if (msg_type == NetMsgType::PONG) {
-        const auto ping_end = time_received;
-        uint64_t nonce = 0;
-        size_t nAvail = vRecv.in_avail();
-        bool bPingFinished = false;
-        std::string sProblem;
-
-        if (nAvail >= sizeof(nonce)) {
-            vRecv >> nonce;
-
-            // Only process pong message if there is an outstanding ping (old ping without nonce should never pong)
-            if (peer->m_ping_nonce_sent != 0) {
-                if (nonce == peer->m_ping_nonce_sent) {
-                    // Matching pong received, this ping is no longer outstanding
-                    bPingFinished = true;
-                    const auto ping_time = ping_end - peer->m_ping_start.load();
-                    if (ping_time.count() >= 0) {
-                        // Let connman know about this successful ping-pong
-                        pfrom.PongReceived(ping_time);
-                    } else {
-                        // This should never happen
-                        sProblem = "Timing mishap";
-                    }
-                } else {
-                    // Nonce mismatches are normal when pings are overlapping
-                    sProblem = "Nonce mismatch";
-                    if (nonce == 0) {
-                        // This is most likely a bug in another implementation somewhere; cancel this ping
-                        bPingFinished = true;
-                        sProblem = "Nonce zero";
-                    }
-                }
-            } else {
-                sProblem = "Unsolicited pong without ping";
-            }
-        } else {
-            // This is most likely a bug in another implementation somewhere; cancel this ping
-            bPingFinished = true;
-            sProblem = "Short payload";
-        }
-
-        if (!(sProblem.empty())) {
-            LogDebug(BCLog::NET, "pong peer=%d: %s, %x expected, %x received, %u bytes\n",
-                pfrom.GetId(),
-                sProblem,
-                peer->m_ping_nonce_sent,
-                nonce,
-                nAvail);
-        }
-        if (bPingFinished) {
-            peer->m_ping_nonce_sent = 0;
-        }
+        ProcessPong(pfrom, *peer, vRecv, time_received);
         return;
     }
 
@@ -4933,7 +5346,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         std::vector<CInv> vInv;
         vRecv >> vInv;
         std::vector<GenTxid> tx_invs;
-        if (vInv.size() <= node::MAX_PEER_TX_ANNOUNCEMENTS + MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        if (vInv.size() <= node::MAX_PEER_TX_ANNOUNCEMENTS + MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER) {
             for (CInv &inv : vInv) {
                 if (inv.IsGenTxMsg()) {
                     tx_invs.emplace_back(ToGenTxid(inv));
@@ -4989,6 +5402,62 @@ bool PeerManagerImpl::MaybeDiscourageAndDisconnect(CNode& pnode, Peer& peer)
     return true;
 }
 
+void PeerManagerImpl::TraceInboundMessage(const CNode& pfrom, const CNetMessage& msg)
+{
+    TRACEPOINT(net, inbound_message,
+        pfrom.GetId(),
+        pfrom.m_addr_name.c_str(),
+        pfrom.ConnectionTypeAsString().c_str(),
+        msg.m_type.c_str(),
+        msg.m_recv.size(),
+        msg.m_recv.data()
+    );
+
+    if (m_opts.capture_messages) {
+        CaptureMessage(pfrom.addr, msg.m_type, MakeUCharSpan(msg.m_recv), /*is_incoming=*/true);
+    }
+}
+
+bool PeerManagerImpl::ProcessPeerLocalMessage(CNode* pfrom)
+{
+    AssertLockNotHeld(m_tx_download_mutex);
+
+    static constexpr std::array<std::string_view, 2> PEER_LOCAL_MSG_TYPES{NetMsgType::PING, NetMsgType::PONG};
+
+    PeerRef peer = GetPeerRef(pfrom->GetId());
+    if (peer == nullptr) return false;
+    if (!pfrom->fSuccessfullyConnected || pfrom->fDisconnect || pfrom->fPauseSend) return false;
+
+    // Leave it to ProcessMessages() whenever it would do something else first,
+    // so that e.g. a pong still follows the answers to earlier getdata.
+    {
+        LOCK(peer->m_getdata_requests_mutex);
+        if (!peer->m_getdata_requests.empty()) return false;
+    }
+    {
+        TRY_LOCK(m_tx_download_mutex, lock_tx_download);
+        if (!lock_tx_download || m_txdownloadman.HaveMoreWork(peer->m_id)) return false;
+    }
+
+    auto poll_result{pfrom->PollMessage(PEER_LOCAL_MSG_TYPES)};
+    if (!poll_result) return false;
+    CNetMessage& msg{poll_result->first};
+
+    TraceInboundMessage(*pfrom, msg);
+    LogDebug(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(msg.m_type), msg.m_recv.size(), pfrom->GetId());
+
+    try {
+        if (msg.m_type == NetMsgType::PING) {
+            ProcessPing(*pfrom, msg.m_recv);
+        } else {
+            ProcessPong(*pfrom, *peer, msg.m_recv, msg.m_time);
+        }
+    } catch (const std::exception& e) {
+        LogDebug(BCLog::NET, "%s(%s, %u bytes): Exception '%s' (%s) caught\n", __func__, SanitizeString(msg.m_type), msg.m_message_size, e.what(), typeid(e).name());
+    }
+    return true;
+}
+
 bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(m_tx_download_mutex);
@@ -5034,21 +5503,17 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
     CNetMessage& msg{poll_result->first};
     bool fMoreWork = poll_result->second;
 
-    TRACEPOINT(net, inbound_message,
-        pfrom->GetId(),
-        pfrom->m_addr_name.c_str(),
-        pfrom->ConnectionTypeAsString().c_str(),
-        msg.m_type.c_str(),
-        msg.m_recv.size(),
-        msg.m_recv.data()
-    );
-
-    if (m_opts.capture_messages) {
-        CaptureMessage(pfrom->addr, msg.m_type, MakeUCharSpan(msg.m_recv), /*is_incoming=*/true);
-    }
+    TraceInboundMessage(*pfrom, msg);
 
     try {
-        ProcessMessage(*pfrom, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        if (m_opts.msgproc_stats) {
+            LockWaitTracker cs_main_wait{cs_main};
+            const auto start{SteadyClock::now()};
+            ProcessMessage(*pfrom, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+            RecordMessageProcessing(pfrom->GetId(), msg.m_type, SteadyClock::now() - start, cs_main_wait.waited);
+        } else {
+            ProcessMessage(*pfrom, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        }
         if (interruptMsgProc) return false;
         {
             LOCK(peer->m_getdata_requests_mutex);
@@ -5433,22 +5898,6 @@ void PeerManagerImpl::MaybeSendFeefilter(CNode& pto, Peer& peer, std::chrono::mi
     }
 }
 
-namespace {
-class CompareInvMempoolOrder
-{
-    const CTxMemPool* m_mempool;
-public:
-    explicit CompareInvMempoolOrder(CTxMemPool* mempool) : m_mempool{mempool} {}
-
-    bool operator()(std::set<GenTxid>::iterator a, std::set<GenTxid>::iterator b)
-    {
-        /* As std::make_heap produces a max-heap, we want the entries with the
-         * fewest ancestors/highest fee to sort later. */
-        return m_mempool->CompareDepthAndScore(*b, *a);
-    }
-};
-} // namespace
-
 bool PeerManagerImpl::RejectIncomingTxs(const CNode& peer) const
 {
     // block-relay-only peers may never send txs to us
@@ -5653,7 +6102,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     {
                         LOCK(m_most_recent_block_mutex);
                         if (m_most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            cached_cmpctblock_msg = NetMsg::Make(NetMsgType::CMPCTBLOCK, *m_most_recent_compact_block);
+                            cached_cmpctblock_msg = m_most_recent_compact_block_msg.Copy();
                         }
                     }
                     if (cached_cmpctblock_msg.has_value()) {
@@ -5744,7 +6193,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                 // Time to send but the peer has requested we not relay transactions.
                 if (fSendTrickle) {
                     LOCK(tx_relay->m_bloom_filter_mutex);
-                    if (!tx_relay->m_relay_txs) tx_relay->m_tx_inventory_to_send.clear();
+                    if (!tx_relay->m_relay_txs) tx_relay->m_tx_inventory_to_send.Clear();
                 }
 
                 // Respond to BIP35 mempool requests
@@ -5762,7 +6211,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                                 txinfo.tx->GetWitnessHash().ToUint256() :
                                 txinfo.tx->GetHash().ToUint256(),
                         };
-                        tx_relay->m_tx_inventory_to_send.erase(ToGenTxid(inv));
+                        tx_relay->m_tx_inventory_to_send.Erase(ToGenTxid(inv));
 
                         // Don't send transactions that peers will not put into their mempool
                         if (txinfo.fee < filterrate.GetFee(txinfo.vsize)) {
@@ -5782,55 +6231,56 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
 
                 // Determine transactions to relay
                 if (fSendTrickle) {
-                    // Produce a vector with all candidates for sending
-                    std::vector<std::set<GenTxid>::iterator> vInvTx;
-                    vInvTx.reserve(tx_relay->m_tx_inventory_to_send.size());
-                    for (std::set<GenTxid>::iterator it = tx_relay->m_tx_inventory_to_send.begin(); it != tx_relay->m_tx_inventory_to_send.end(); it++) {
-                        vInvTx.push_back(it);
-                    }
                     const CFeeRate filterrate{tx_relay->m_fee_filter_received.load()};
-                    // Topologically and fee-rate sort the inventory we send for privacy and priority reasons.
-                    // A heap is used so that not all items need sorting if only a few are being sent.
-                    CompareInvMempoolOrder compareInvMempoolOrder(&m_mempool);
-                    std::make_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
                     unsigned int nRelayedTransactions = 0;
                     LOCK(tx_relay->m_bloom_filter_mutex);
-                    size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.size()/1000)*5};
+                    size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.Size()/1000)*5};
                     broadcast_max = std::min<size_t>(INVENTORY_BROADCAST_MAX, broadcast_max);
-                    while (!vInvTx.empty() && nRelayedTransactions < broadcast_max) {
-                        // Fetch the top element from the heap
-                        std::pop_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
-                        std::set<GenTxid>::iterator it = vInvTx.back();
-                        vInvTx.pop_back();
-                        GenTxid hash = *it;
-                        Assume(peer->m_wtxid_relay == hash.IsWtxid());
-                        CInv inv(peer->m_wtxid_relay ? MSG_WTX : MSG_TX, hash.ToUint256());
-                        // Remove it from the to-be-sent set
-                        tx_relay->m_tx_inventory_to_send.erase(it);
-                        // Check if not in the filter already
-                        if (tx_relay->m_tx_inventory_known_filter.contains(hash.ToUint256())) {
-                            continue;
-                        }
-                        // Not in the mempool anymore? don't bother sending it.
-                        auto txinfo{std::visit([&](const auto& id) { return m_mempool.info(id); }, hash)};
-                        if (!txinfo.tx) {
-                            continue;
-                        }
-                        // Peer told you to not send transactions at that feerate? Don't bother sending it.
-                        if (txinfo.fee < filterrate.GetFee(txinfo.vsize)) {
-                            continue;
+                    // The queue is in topological and feerate order already, for
+                    // privacy and priority reasons.
+                    while (!tx_relay->m_tx_inventory_to_send.Empty() && nRelayedTransactions < broadcast_max) {
+                        // Take as many candidates as could still be sent and look them
+                        // up in the mempool at once, rather than locking it for each.
+                        std::vector<GenTxid> candidates;
+                        while (!tx_relay->m_tx_inventory_to_send.Empty() && candidates.size() < broadcast_max - nRelayedTransactions) {
+                            const GenTxid hash{tx_relay->m_tx_inventory_to_send.Pop()};
+                            Assume(peer->m_wtxid_relay == hash.IsWtxid());
+                            // Check if not in the filter already
+                            if (!tx_relay->m_tx_inventory_known_filter.contains(hash.ToUint256())) candidates.push_back(hash);
                         }
-                        if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
-                        // Send
-                        vInv.push_back(inv);
-                        nRelayedTransactions++;
-                        if (vInv.size() == MAX_INV_SZ) {
-                            MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
-                            vInv.clear();
+                        const std::vector<TxMempoolInfo> txinfos{m_mempool.info(candidates)};
+                        for (size_t i{0}; i < candidates.size(); ++i) {
+                            const GenTxid& hash{candidates[i]};
+                            const TxMempoolInfo& txinfo{txinfos[i]};
+                            // Not in the mempool anymore? don't bother sending it.
+                            if (!txinfo.tx) {
+                                continue;
+                            }
+                            // Peer told you to not send transactions at that feerate? Don't bother sending it.
+                            if (txinfo.fee < filterrate.GetFee(txinfo.vsize)) {
+                                continue;
+                            }
+                            if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
+                            // Leave it to the next reconciliation round with the peer, unless it is
+                            // one of the peers the transaction is still flooded to.
+                            if (m_txreconciliation && hash.IsWtxid()) {
+                                const Wtxid& wtxid{std::get<Wtxid>(hash)};
+                                if (!m_txreconciliation->ShouldFanoutTo(wtxid, pto->GetId()) &&
+                                    m_txreconciliation->AddToSet(pto->GetId(), wtxid)) {
+                                    continue;
+                                }
+                            }
+                            // Send
+                            vInv.emplace_back(peer->m_wtxid_relay ? MSG_WTX : MSG_TX, hash.ToUint256());
+                            nRelayedTransactions++;
+                            if (vInv.size() == MAX_INV_SZ) {
+                                MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
+                                vInv.clear();
+                            }
+                            tx_relay->m_tx_inventory_known_filter.insert(hash.ToUint256());
                         }
-                        tx_relay->m_tx_inventory_known_filter.insert(hash.ToUint256());
                     }
 
                     // Ensure we'll respond to GETDATA requests for anything we've just announced
@@ -5841,6 +6291,13 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         if (!vInv.empty())
             MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
 
+        // Start a reconciliation round with the peer if it is time to
+        if (m_txreconciliation) {
+            if (const auto request{m_txreconciliation->InitiateReconciliationRequest(pto->GetId(), current_time)}) {
+                MakeAndPushMessage(*pto, NetMsgType::REQRECON, request->first, request->second);
+            }
+        }
+
         // Detect whether we're stalling
         auto stalling_timeout = m_block_stalling_timeout.load();
         if (state.m_stalling_since.count() && state.m_stalling_since < current_time - stalling_timeout) {
@@ -5912,11 +6369,11 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < static_cast<size_t>(state.m_blocks_in_flight_limit)) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
             auto get_inflight_budget = [&state]() {
-                return std::max(0, MAX_BLOCKS_IN_TRANSIT_PER_PEER - static_cast<int>(state.vBlocksInFlight.size()));
+                return std::max(0, state.m_blocks_in_flight_limit - static_cast<int>(state.vBlocksInFlight.size()));
             };
 
             // If a snapshot chainstate is in use, we want to find its next blocks
@@ -5932,6 +6389,25 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     vToDownload, from_tip,
                     Assert(m_chainman.GetSnapshotBaseBlock()));
             }
+            // The window is held back by another peer: ask for its oldest block in flight here as
+            // well, if this peer can be expected to deliver it sooner.
+            bool stole{false};
+            if (staller != -1 && vToDownload.size() < static_cast<size_t>(get_inflight_budget())) {
+                if (const CBlockIndex* stolen{MaybeStealBlockRequest(*peer, staller, current_time)}) {
+                    LogDebug(BCLog::NET, "Requesting block %s (%d) held back by peer=%d from peer=%d too\n",
+                             stolen->GetBlockHash().ToString(), stolen->nHeight, staller, pto->GetId());
+                    vToDownload.push_back(stolen);
+                    stole = true;
+                }
+            }
+            TRACEPOINT(net, blocks_to_download,
+                pto->GetId(),
+                get_inflight_budget(),
+                (uint32_t)vToDownload.size(),
+                vToDownload.empty() ? -1 : vToDownload.front()->nHeight,
+                vToDownload.empty() ? -1 : vToDownload.back()->nHeight,
+                staller,
+                stole);
             for (const CBlockIndex *pindex : vToDownload) {
                 uint32_t nFetchFlags = GetFetchFlags(*peer);
                 vGetData.emplace_back(MSG_BLOCK | nFetchFlags, pindex->GetBlockHash());
@@ -5939,7 +6415,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                 LogDebug(BCLog::NET, "Requesting block %s (%d) peer=%d\n", pindex->GetBlockHash().ToString(),
                     pindex->nHeight, pto->GetId());
             }
-            if (state.vBlocksInFlight.empty() && staller != -1) {
+            if ((state.vBlocksInFlight.empty() || stole) && staller != -1) {
                 if (State(staller)->m_stalling_since == 0us) {
                     State(staller)->m_stalling_since = current_time;
                     LogDebug(BCLog::NET, "Stall started peer=%d\n", staller);
@@ -11,11 +11,13 @@
 #include <protocol.h>
 #include <threadsafety.h>
 #include <txorphanage.h>
+#include <util/histogram.h>
 #include <validationinterface.h>
 
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -48,6 +50,16 @@ static const unsigned int MAX_CMPCTBLOCKS_INFLIGHT_PER_BLOCK = 3;
 /** Number of headers sent in one getheaders result. We rely on the assumption that if a peer sends
  *  less than this number, we reached its tip. Changing this value is a protocol upgrade. */
 static const unsigned int MAX_HEADERS_RESULTS = 2000;
+/** Default for -msgprocstats, whether to time the processing of each received message. */
+static constexpr bool DEFAULT_MSGPROC_STATS{false};
+
+/** Time spent processing received messages, of one message type or of one peer. */
+struct MessageProcessingStats {
+    //! Processing time of each message.
+    LatencyHistogram time;
+    //! Time spent waiting for cs_main while processing the messages.
+    std::chrono::nanoseconds cs_main_wait{0};
+};
 
 struct CNodeStateStats {
     int nSyncHeight = -1;
@@ -55,6 +67,10 @@ struct CNodeStateStats {
     int m_starting_height = -1;
     std::chrono::microseconds m_ping_wait;
     std::vector<int> vHeightInFlight;
+    int m_blocks_in_flight_limit{0};
+    uint64_t m_blocks_received{0};
+    std::chrono::microseconds m_block_interval_avg{0us};
+    std::chrono::microseconds m_block_latency_avg{0us};
     bool m_relay_txs;
     CAmount m_fee_filter_received;
     uint64_t m_addr_processed = 0;
@@ -91,6 +107,8 @@ public:
         //! Number of headers sent in one getheaders message result (this is
         //! a test-only option).
         uint32_t max_headers_result{MAX_HEADERS_RESULTS};
+        //! Whether the processing time of each received message is recorded
+        bool msgproc_stats{DEFAULT_MSGPROC_STATS};
     };
 
     static std::unique_ptr<PeerManager> make(CConnman& connman, AddrMan& addrman,
@@ -115,9 +133,19 @@ public:
 
     virtual std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() = 0;
 
+    /** Estimate of the memory used by the orphanage. */
+    virtual size_t GetOrphanageMemoryUsage() = 0;
+
     /** Get peer manager info. */
     virtual PeerManagerInfo GetInfo() const = 0;
 
+    /** Whether message processing statistics are recorded (-msgprocstats). */
+    virtual bool HasMessageProcessingStats() const = 0;
+
+    /** Message processing statistics by message type, and by (connected) peer. */
+    virtual std::map<std::string, MessageProcessingStats> GetMessageTypeProcessingStats() const = 0;
+    virtual std::map<NodeId, MessageProcessingStats> GetPeerProcessingStats() const = 0;
+
     /** Relay transaction to all peers. */
     virtual void RelayTransaction(const Txid& txid, const Wtxid& wtxid) = 0;
 
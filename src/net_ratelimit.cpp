@@ -0,0 +1,132 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net_ratelimit.h>
+
+#include <protocol.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+TrafficClass GetTrafficClass(std::string_view msg_type)
+{
+    if (msg_type == NetMsgType::BLOCK || msg_type == NetMsgType::MERKLEBLOCK ||
+        msg_type == NetMsgType::CFILTER || msg_type == NetMsgType::CFHEADERS ||
+        msg_type == NetMsgType::CFCHECKPT) {
+        return TrafficClass::BLOCK_SERVING;
+    }
+    if (msg_type == NetMsgType::TX || msg_type == NetMsgType::INV ||
+        msg_type == NetMsgType::GETDATA || msg_type == NetMsgType::NOTFOUND ||
+        msg_type == NetMsgType::REQRECON || msg_type == NetMsgType::SKETCH ||
+        msg_type == NetMsgType::RECONCILDIFF) {
+        return TrafficClass::TX_RELAY;
+    }
+    return TrafficClass::PROPAGATION;
+}
+
+std::string TrafficClassAsString(TrafficClass traffic_class)
+{
+    switch (traffic_class) {
+    case TrafficClass::PROPAGATION: return "propagation";
+    case TrafficClass::TX_RELAY: return "txrelay";
+    case TrafficClass::BLOCK_SERVING: return "blockserving";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+void UploadRateLimiter::SetRate(uint64_t bytes_per_second, const std::array<uint32_t, NUM_TRAFFIC_CLASSES>& weights)
+{
+    LOCK(m_mutex);
+    m_rate = bytes_per_second;
+    const uint64_t total_weight{std::accumulate(weights.begin(), weights.end(), uint64_t{0})};
+    Assume(bytes_per_second == 0 || total_weight > 0);
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) {
+        Bucket& bucket{m_buckets[i]};
+        bucket.rate = total_weight ? double(bytes_per_second) * weights[i] / total_weight : 0;
+        bucket.tokens = bucket.rate;
+        bucket.stats.weight = weights[i];
+    }
+    m_last_refill = {};
+}
+
+uint64_t UploadRateLimiter::GetRate() const
+{
+    LOCK(m_mutex);
+    return m_rate;
+}
+
+bool UploadRateLimiter::MayBorrow(size_t borrower, size_t lender) const
+{
+    AssertLockHeld(m_mutex);
+    return lender > borrower || m_buckets[lender].IsFull();
+}
+
+void UploadRateLimiter::Refill(SteadyClock::time_point now)
+{
+    AssertLockHeld(m_mutex);
+    if (m_last_refill == SteadyClock::time_point{}) m_last_refill = now;
+    if (now <= m_last_refill) return;
+    const double elapsed{std::chrono::duration<double>(now - m_last_refill).count()};
+    for (Bucket& bucket : m_buckets) {
+        bucket.tokens = std::min(bucket.rate, bucket.tokens + bucket.rate * elapsed);
+    }
+    m_last_refill = now;
+}
+
+uint64_t UploadRateLimiter::Available(TrafficClass traffic_class, SteadyClock::time_point now)
+{
+    LOCK(m_mutex);
+    if (m_rate == 0) return std::numeric_limits<uint64_t>::max();
+    Refill(now);
+    const size_t cls{size_t(traffic_class)};
+    // A class in debt waits for it to be repaid, even if it could borrow.
+    if (m_buckets[cls].tokens < 0) return 0;
+    double available{m_buckets[cls].tokens};
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) {
+        if (i != cls && MayBorrow(cls, i)) available += std::max(m_buckets[i].tokens, 0.0);
+    }
+    return uint64_t(available);
+}
+
+void UploadRateLimiter::Consume(TrafficClass traffic_class, uint64_t bytes, SteadyClock::time_point now)
+{
+    LOCK(m_mutex);
+    if (m_rate == 0) return;
+    Refill(now);
+    const size_t cls{size_t(traffic_class)};
+    Bucket& own{m_buckets[cls]};
+    own.stats.bytes_sent += bytes;
+    double left{double(bytes)};
+    const double from_own{std::clamp(own.tokens, 0.0, left)};
+    own.tokens -= from_own;
+    left -= from_own;
+    // Borrow from the lowest priority classes first. Which ones may lend is decided before
+    // spending anything, as doing so can leave a lender no longer full.
+    std::array<bool, NUM_TRAFFIC_CLASSES> may_borrow{};
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) may_borrow[i] = i != cls && MayBorrow(cls, i);
+    for (size_t i{NUM_TRAFFIC_CLASSES}; i-- > 0 && left > 0;) {
+        if (!may_borrow[i]) continue;
+        const double from_lender{std::clamp(m_buckets[i].tokens, 0.0, left)};
+        m_buckets[i].tokens -= from_lender;
+        left -= from_lender;
+    }
+    own.tokens -= left;
+}
+
+void UploadRateLimiter::RecordThrottled(TrafficClass traffic_class)
+{
+    LOCK(m_mutex);
+    ++m_buckets[size_t(traffic_class)].stats.throttled;
+}
+
+std::array<UploadRateLimiter::ClassStats, NUM_TRAFFIC_CLASSES> UploadRateLimiter::GetStats() const
+{
+    LOCK(m_mutex);
+    std::array<ClassStats, NUM_TRAFFIC_CLASSES> stats;
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) stats[i] = m_buckets[i].stats;
+    return stats;
+}
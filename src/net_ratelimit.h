@@ -0,0 +1,104 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NET_RATELIMIT_H
+#define BITCOIN_NET_RATELIMIT_H
+
+#include <sync.h>
+#include <util/time.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Classes of outbound traffic, in order of decreasing priority.
+ *
+ * The class of a message is derived from its type. Messages that are not
+ * transaction relay or bulk data (including the v2 handshake) are counted
+ * as propagation traffic, as they are small and often latency-sensitive.
+ */
+enum class TrafficClass : uint8_t {
+    PROPAGATION,   //!< Compact blocks, block transactions, headers and control messages
+    TX_RELAY,      //!< Transaction announcements, requests and transactions
+    BLOCK_SERVING, //!< Full blocks, merkle blocks and compact block filters
+};
+
+static constexpr size_t NUM_TRAFFIC_CLASSES{3};
+
+/** Share of -maxuploadrate of every TrafficClass, as relative weights. */
+static constexpr std::array<uint32_t, NUM_TRAFFIC_CLASSES> DEFAULT_TRAFFIC_CLASS_WEIGHTS{6, 3, 1};
+
+/** The default for -maxuploadrate, in kB/s. 0 = Unlimited */
+static constexpr uint64_t DEFAULT_MAX_UPLOAD_RATE{0};
+
+TrafficClass GetTrafficClass(std::string_view msg_type);
+std::string TrafficClassAsString(TrafficClass traffic_class);
+
+/**
+ * Limits the rate of outbound traffic with a token bucket per TrafficClass.
+ *
+ * Every class fills its bucket at its weighted share of the total rate, and
+ * holds at most one second worth of tokens. When sending, a class may also
+ * spend the tokens of lower priority classes, and those of classes whose
+ * bucket is full, i.e. that have been idle. Unused capacity is therefore not
+ * wasted, while a class that is busy keeps its share against lower priority
+ * traffic: bulk uploads of historical blocks cannot starve block propagation.
+ *
+ * Spending more than is available (as concurrent senders may) leaves the
+ * bucket of the class in debt, which is repaid before it can send again.
+ */
+class UploadRateLimiter
+{
+public:
+    struct ClassStats {
+        uint32_t weight{0};
+        //! Bytes sent while limited.
+        uint64_t bytes_sent{0};
+        //! Number of times sending had to wait for tokens.
+        uint64_t throttled{0};
+    };
+
+    /** Set the total rate in bytes per second (0 disables limiting) and the weights of the classes. */
+    void SetRate(uint64_t bytes_per_second, const std::array<uint32_t, NUM_TRAFFIC_CLASSES>& weights = DEFAULT_TRAFFIC_CLASS_WEIGHTS)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    uint64_t GetRate() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool IsLimited() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return GetRate() != 0; }
+
+    /** Number of bytes of the given class that may be sent at `now`. Unbounded when not limited. */
+    uint64_t Available(TrafficClass traffic_class, SteadyClock::time_point now) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Account for `bytes` of the given class having been sent at `now`. */
+    void Consume(TrafficClass traffic_class, uint64_t bytes, SteadyClock::time_point now) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Record that a sender of the given class is waiting for tokens. */
+    void RecordThrottled(TrafficClass traffic_class) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    std::array<ClassStats, NUM_TRAFFIC_CLASSES> GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Bucket {
+        //! Refill rate in bytes per second, and the capacity.
+        double rate{0};
+        //! Available bytes; negative when in debt.
+        double tokens{0};
+        ClassStats stats;
+
+        bool IsFull() const { return tokens >= rate; }
+    };
+
+    /** Whether `borrower` may spend the tokens of `lender`. */
+    bool MayBorrow(size_t borrower, size_t lender) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Refill(SteadyClock::time_point now) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    mutable Mutex m_mutex;
+    uint64_t m_rate GUARDED_BY(m_mutex){0};
+    std::array<Bucket, NUM_TRAFFIC_CLASSES> m_buckets GUARDED_BY(m_mutex);
+    SteadyClock::time_point m_last_refill GUARDED_BY(m_mutex){};
+};
+
+#endif // BITCOIN_NET_RATELIMIT_H
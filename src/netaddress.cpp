@@ -8,6 +8,7 @@
 #include <crypto/common.h>
 #include <crypto/sha3.h>
 #include <hash.h>
+#include <memusage.h>
 #include <prevector.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
@@ -703,6 +704,11 @@ std::vector<unsigned char> CNetAddr::GetAddrBytes() const
     return std::vector<unsigned char>(m_addr.begin(), m_addr.end());
 }
 
+size_t CNetAddr::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_addr);
+}
+
 // private extensions to enum Network, only returned by GetExtNetwork,
 // and only used in GetReachabilityFrom
 static const int NET_TEREDO = NET_MAX;
@@ -203,6 +203,8 @@ public:
     bool HasLinkedIPv4() const;
 
     std::vector<unsigned char> GetAddrBytes() const;
+    //! Memory allocated for addresses too long to be stored inline, e.g. Tor v3 and I2P addresses.
+    size_t DynamicMemoryUsage() const;
     int GetReachabilityFrom(const CNetAddr& paddrPartner) const;
 
     explicit CNetAddr(const struct in6_addr& pipv6Addr, const uint32_t scope = 0);
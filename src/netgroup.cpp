@@ -8,6 +8,10 @@
 #include <logging.h>
 #include <util/asmap.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+
 uint256 NetGroupManager::GetAsmapChecksum() const
 {
     if (!m_asmap.size()) return {};
@@ -84,6 +88,22 @@ uint32_t NetGroupManager::GetMappedAS(const CNetAddr& address) const
     if (m_asmap.size() == 0 || (net_class != NET_IPV4 && net_class != NET_IPV6)) {
         return 0; // Indicates not found, safe because AS0 is reserved per RFC7607.
     }
+    if (m_decoded_asmap) {
+        std::array<uint8_t, 16> ip;
+        if (address.HasLinkedIPv4()) {
+            // For lookup, treat as if it was just an IPv4 address (IPV4_IN_IPV6_PREFIX + IPv4 bits)
+            std::copy(IPV4_IN_IPV6_PREFIX.begin(), IPV4_IN_IPV6_PREFIX.end(), ip.begin());
+            const uint32_t ipv4 = address.GetLinkedIPv4();
+            for (int i = 0; i < 4; ++i) {
+                ip[12 + i] = ipv4 >> (24 - 8 * i);
+            }
+        } else {
+            assert(address.IsIPv6());
+            const auto addr_bytes = address.GetAddrBytes();
+            std::copy(addr_bytes.begin(), addr_bytes.end(), ip.begin());
+        }
+        return m_decoded_asmap->Lookup(ip);
+    }
     std::vector<bool> ip_bits(128);
     if (address.HasLinkedIPv4()) {
         // For lookup, treat as if it was just an IPv4 address (IPV4_IN_IPV6_PREFIX + IPv4 bits)
@@ -7,7 +7,9 @@
 
 #include <netaddress.h>
 #include <uint256.h>
+#include <util/asmap.h>
 
+#include <optional>
 #include <vector>
 
 /**
@@ -16,7 +18,7 @@
 class NetGroupManager {
 public:
     explicit NetGroupManager(std::vector<bool> asmap)
-        : m_asmap{std::move(asmap)}
+        : m_asmap{std::move(asmap)}, m_decoded_asmap{DecodedAsmap::Decode(m_asmap)}
     {}
 
     /** Get a checksum identifying the asmap being used. */
@@ -71,6 +73,10 @@ private:
      * This is initialized in the constructor, const, and therefore is
      * thread-safe. */
     const std::vector<bool> m_asmap;
+
+    /** m_asmap decoded for faster lookups. Lookups are interpreted from
+     *  m_asmap instead if it did not pass the sanity check. */
+    const std::optional<DecodedAsmap> m_decoded_asmap;
 };
 
 #endif // BITCOIN_NETGROUP_H
@@ -0,0 +1,117 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKDATACACHE_H
+#define BITCOIN_NODE_BLOCKDATACACHE_H
+
+#include <flatfile.h>
+#include <sync.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+namespace node {
+/**
+ * Size-bounded least-recently-used cache of data read from the block or undo
+ * files, keyed by its position on disk.
+ *
+ * Newly connected blocks are typically requested by many peers, the ZMQ
+ * publisher, REST clients and the indexes in a short time, so keeping the
+ * last few in memory saves re-reading them from disk. Values are shared, so
+ * a reader can hold one after it has been evicted.
+ */
+template <typename T>
+class BlockDataCache
+{
+public:
+    struct Stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        size_t entries{0};
+        size_t bytes{0};
+    };
+
+    explicit BlockDataCache(size_t max_bytes) : m_max_bytes{max_bytes} {}
+
+    BlockDataCache(const BlockDataCache&) = delete;
+    BlockDataCache& operator=(const BlockDataCache&) = delete;
+
+    bool Enabled() const { return m_max_bytes > 0; }
+
+    //! Return the entry at `pos` and mark it as the most recently used, or nullptr.
+    std::shared_ptr<const T> Get(const FlatFilePos& pos) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        const auto it{m_index.find(Key(pos))};
+        if (it == m_index.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->value;
+    }
+
+    //! Add an entry accounted as `bytes` large, evicting the least recently used ones.
+    void Put(const FlatFilePos& pos, std::shared_ptr<const T> value, size_t bytes) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (bytes > m_max_bytes) return;
+        LOCK(m_mutex);
+        if (m_index.contains(Key(pos))) return;
+        m_lru.push_front({pos, std::move(value), bytes});
+        m_index.emplace(Key(pos), m_lru.begin());
+        m_bytes += bytes;
+        while (m_bytes > m_max_bytes) Erase(std::prev(m_lru.end()));
+    }
+
+    //! Drop the entries of the given files, e.g. because they were pruned.
+    void EraseFiles(const std::set<int>& files) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        for (auto it{m_lru.begin()}; it != m_lru.end();) {
+            it = files.contains(it->pos.nFile) ? Erase(it) : std::next(it);
+        }
+    }
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return {.hits = m_hits, .misses = m_misses, .entries = m_lru.size(), .bytes = m_bytes};
+    }
+
+private:
+    struct Entry {
+        FlatFilePos pos;
+        std::shared_ptr<const T> value;
+        size_t bytes;
+    };
+    using EntryIt = typename std::list<Entry>::iterator;
+
+    static std::pair<int, unsigned int> Key(const FlatFilePos& pos) { return {pos.nFile, pos.nPos}; }
+
+    EntryIt Erase(EntryIt it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        m_bytes -= it->bytes;
+        m_index.erase(Key(it->pos));
+        return m_lru.erase(it);
+    }
+
+    const size_t m_max_bytes;
+    mutable Mutex m_mutex;
+    //! Most recently used first.
+    std::list<Entry> m_lru GUARDED_BY(m_mutex);
+    std::map<std::pair<int, unsigned int>, EntryIt> m_index GUARDED_BY(m_mutex);
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKDATACACHE_H
@@ -4,15 +4,19 @@
 
 #include <node/blockmanager_args.h>
 
+#include <chainparamsbase.h>
 #include <common/args.h>
 #include <node/blockstorage.h>
 #include <node/database_args.h>
 #include <tinyformat.h>
+#include <util/fs.h>
 #include <util/result.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace node {
 util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Options& opts)
@@ -35,6 +39,32 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
+    if (auto value{args.GetIntArg("-reindexscanthreads")}) {
+        opts.reindex_scan_threads = std::clamp<int64_t>(*value, 0, kernel::MAX_REINDEX_SCAN_THREADS);
+    }
+
+    if (auto value{args.GetIntArg("-blockdatacache")}) {
+        opts.block_data_cache_bytes = std::clamp<int64_t>(*value, 0, kernel::MAX_BLOCK_DATA_CACHE_MIB) << 20;
+    }
+
+    if (const fs::path cold_dir{args.GetPathArg("-coldblocksdir")}; !cold_dir.empty()) {
+        if (opts.prune_target) {
+            return util::Error{_("-coldblocksdir is incompatible with -prune.")};
+        }
+        if (!fs::is_directory(cold_dir)) {
+            return util::Error{strprintf(_("Specified cold blocks directory \"%s\" does not exist."), args.GetArg("-coldblocksdir", ""))};
+        }
+        // Laid out like -blocksdir, so that the networks do not share files.
+        opts.cold_blocks_dir = fs::absolute(cold_dir) / fs::PathFromString(BaseParams().DataDir()) / "blocks";
+        fs::create_directories(opts.cold_blocks_dir);
+        if (fs::equivalent(opts.cold_blocks_dir, opts.blocks_dir)) {
+            return util::Error{_("-coldblocksdir must not be the blocks directory.")};
+        }
+    }
+    if (auto value{args.GetIntArg("-coldblocksdepth")}) {
+        opts.cold_blocks_depth = std::clamp<int64_t>(*value, MIN_BLOCKS_TO_KEEP, std::numeric_limits<int>::max());
+    }
+
     ReadDatabaseArgs(args, opts.block_tree_db_params.options);
 
     return {};
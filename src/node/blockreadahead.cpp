@@ -0,0 +1,96 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockreadahead.h>
+
+#include <chain.h>
+#include <flatfile.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <undo.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace node {
+BlockReadAhead::BlockReadAhead(const BlockManager& blockman, size_t window, int num_threads)
+    : m_blockman{blockman},
+      m_window{window},
+      m_pool{"blkread"}
+{
+    LogInfo("Block read-ahead uses %d threads for up to %u blocks", num_threads, m_window);
+    m_pool.Start(num_threads);
+}
+
+BlockReadAhead::~BlockReadAhead()
+{
+    // Join the I/O threads before the entries (and the block manager they
+    // read from) go away.
+    m_pool.Stop();
+}
+
+void BlockReadAhead::Schedule(std::span<const CBlockIndex* const> to_connect, bool with_undo)
+{
+    AssertLockHeld(::cs_main);
+    const auto wanted{to_connect.first(std::min(to_connect.size(), m_window))};
+
+    LOCK(m_mutex);
+    // Drop blocks that are no longer about to be connected.
+    std::erase_if(m_entries, [&](const Entry& entry) {
+        return std::none_of(wanted.begin(), wanted.end(), [&](const CBlockIndex* index) { return index->GetBlockHash() == entry.hash; });
+    });
+    for (const CBlockIndex* index : wanted) {
+        const uint256 hash{index->GetBlockHash()};
+        auto it{std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) { return entry.hash == hash; })};
+        if (it == m_entries.end()) {
+            if (!(index->nStatus & BLOCK_HAVE_DATA)) continue;
+            const FlatFilePos pos{index->GetBlockPos()};
+            it = m_entries.insert(m_entries.end(), {hash, m_pool.Submit([this, pos, hash]() -> std::shared_ptr<const CBlock> {
+                                                        auto block{std::make_shared<CBlock>()};
+                                                        if (!m_blockman.ReadBlock(*block, pos, hash)) return nullptr;
+                                                        return block;
+                                                    }).share(), {}});
+        }
+        if (with_undo && !it->undo.valid() && index->pprev && (index->nStatus & BLOCK_HAVE_UNDO)) {
+            const FlatFilePos pos{index->GetUndoPos()};
+            it->undo = m_pool.Submit([this, pos, prev_hash = index->pprev->GetBlockHash()]() -> std::shared_ptr<CBlockUndo> {
+                           auto undo{std::make_shared<CBlockUndo>()};
+                           if (!m_blockman.ReadBlockUndo(*undo, pos, prev_hash)) return nullptr;
+                           return undo;
+                       }).share();
+        }
+    }
+}
+
+std::shared_ptr<const CBlock> BlockReadAhead::Take(const CBlockIndex& index, std::shared_ptr<CBlockUndo>* undo)
+{
+    std::shared_future<std::shared_ptr<const CBlock>> pending;
+    std::shared_future<std::shared_ptr<CBlockUndo>> pending_undo;
+    {
+        LOCK(m_mutex);
+        auto it{std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) { return entry.hash == index.GetBlockHash(); })};
+        if (it == m_entries.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        pending = std::move(it->block);
+        pending_undo = std::move(it->undo);
+        m_entries.erase(it);
+    }
+    if (undo && pending_undo.valid()) *undo = pending_undo.get();
+    auto block{pending.get()};
+    if (block) {
+        ++m_hits;
+    } else {
+        ++m_misses;
+    }
+    return block;
+}
+
+size_t BlockReadAhead::Size() const
+{
+    return WITH_LOCK(m_mutex, return m_entries.size());
+}
+} // namespace node
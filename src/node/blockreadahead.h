@@ -0,0 +1,103 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKREADAHEAD_H
+#define BITCOIN_NODE_BLOCKREADAHEAD_H
+
+#include <kernel/cs_main.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/threadpool.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <span>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+
+namespace node {
+class BlockManager;
+
+/** Default for -blockreadahead, the number of blocks read ahead of ConnectTip (0 = disabled). */
+static constexpr int DEFAULT_BLOCK_READ_AHEAD{0};
+/** Upper bound on -blockreadahead, bounding the memory held by deserialized blocks. */
+static constexpr int MAX_BLOCK_READ_AHEAD{64};
+/** Default for -blockreadaheadthreads, the number of I/O threads reading blocks ahead. */
+static constexpr int DEFAULT_BLOCK_READ_AHEAD_THREADS{2};
+/** Upper bound on -blockreadaheadthreads. */
+static constexpr int MAX_BLOCK_READ_AHEAD_THREADS{32};
+
+/**
+ * Bounded read-ahead stage for blocks that are about to be connected.
+ *
+ * While the validation thread connects the current block, a small pool of
+ * I/O threads reads and deserializes the next blocks on the path to the
+ * most-work chain, so ConnectTip does not have to wait on disk and
+ * deserialization for them.
+ *
+ * At most `window` blocks are held (or in flight) at any time. Blocks which
+ * are no longer on the scheduled path, e.g. after a reorg or an invalid block,
+ * are discarded on the next call to Schedule().
+ *
+ * Blocks about to be disconnected in a reorg are read ahead the same way,
+ * together with their undo data.
+ */
+class BlockReadAhead
+{
+public:
+    BlockReadAhead(const BlockManager& blockman, size_t window, int num_threads);
+    ~BlockReadAhead();
+
+    BlockReadAhead(const BlockReadAhead&) = delete;
+    BlockReadAhead& operator=(const BlockReadAhead&) = delete;
+
+    /**
+     * Make sure reads for the first `window` blocks of `to_connect` (in
+     * connection order) are in flight, and drop every other read-ahead block.
+     * With `with_undo`, as for blocks about to be disconnected, their undo
+     * data is read too.
+     */
+    void Schedule(std::span<const CBlockIndex* const> to_connect, bool with_undo = false) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex);
+
+    /**
+     * Return the block for `index` if it was scheduled, waiting for its read
+     * to complete. Returns nullptr if the block was not scheduled or could not
+     * be read, in which case the caller should read it itself so errors are
+     * reported in the usual way. The same goes for the undo data of the block
+     * if `undo` is set.
+     */
+    std::shared_ptr<const CBlock> Take(const CBlockIndex& index, std::shared_ptr<CBlockUndo>* undo = nullptr) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Number of blocks currently scheduled or held. */
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    uint64_t GetHits() const { return m_hits; }
+    uint64_t GetMisses() const { return m_misses; }
+
+private:
+    struct Entry {
+        uint256 hash;
+        std::shared_future<std::shared_ptr<const CBlock>> block;
+        //! Only valid if the undo data was scheduled.
+        std::shared_future<std::shared_ptr<CBlockUndo>> undo;
+    };
+
+    const BlockManager& m_blockman;
+    const size_t m_window;
+    ThreadPool m_pool;
+    mutable Mutex m_mutex;
+    //! Scheduled blocks, in connection order.
+    std::list<Entry> m_entries GUARDED_BY(m_mutex);
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKREADAHEAD_H
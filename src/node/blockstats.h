@@ -0,0 +1,75 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKSTATS_H
+#define BITCOIN_NODE_BLOCKSTATS_H
+
+#include <consensus/amount.h>
+#include <serialize.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+
+namespace node {
+static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
+
+/** Used by getblockstats to get feerates at different percentiles by weight  */
+void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
+
+/**
+ * Statistics about the transactions of a block, as reported by getblockstats.
+ * Only those derived from the block and its undo data are included, not the
+ * ones that are known from the block index (e.g. the time or the subsidy).
+ * All amounts are in satoshis, and feerates in satoshis per virtual byte.
+ */
+struct BlockStats {
+    CAmount avgfee{0};
+    CAmount avgfeerate{0};
+    int64_t avgtxsize{0};
+    std::array<CAmount, NUM_GETBLOCKSTATS_PERCENTILES> feerate_percentiles{};
+    int64_t ins{0};
+    CAmount maxfee{0};
+    CAmount maxfeerate{0};
+    int64_t maxtxsize{0};
+    CAmount medianfee{0};
+    int64_t mediantxsize{0};
+    CAmount minfee{0};
+    CAmount minfeerate{0};
+    int64_t mintxsize{0};
+    int64_t outs{0};
+    int64_t swtotal_size{0};
+    int64_t swtotal_weight{0};
+    int64_t swtxs{0};
+    CAmount total_out{0};
+    int64_t total_size{0};
+    int64_t total_weight{0};
+    CAmount totalfee{0};
+    int64_t txs{0};
+    int64_t utxo_increase{0};
+    int64_t utxo_size_inc{0};
+    int64_t utxo_increase_actual{0};
+    int64_t utxo_size_inc_actual{0};
+
+    SERIALIZE_METHODS(BlockStats, obj)
+    {
+        READWRITE(obj.avgfee, obj.avgfeerate, obj.avgtxsize, obj.ins, obj.maxfee,
+                  obj.maxfeerate, obj.maxtxsize, obj.medianfee, obj.mediantxsize, obj.minfee, obj.minfeerate,
+                  obj.mintxsize, obj.outs, obj.swtotal_size, obj.swtotal_weight, obj.swtxs, obj.total_out,
+                  obj.total_size, obj.total_weight, obj.totalfee, obj.txs, obj.utxo_increase, obj.utxo_size_inc,
+                  obj.utxo_increase_actual, obj.utxo_size_inc_actual);
+        for (auto& feerate : obj.feerate_percentiles) READWRITE(feerate);
+    }
+};
+
+/** Compute the statistics of a block, given its undo data and its entry in the block index. */
+BlockStats ComputeBlockStats(const CBlock& block, const CBlockUndo& block_undo, const CBlockIndex& index);
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKSTATS_H
@@ -6,6 +6,7 @@
 
 #include <arith_uint256.h>
 #include <chain.h>
+#include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <dbwrapper.h>
@@ -16,8 +17,11 @@
 #include <kernel/messagestartchars.h>
 #include <kernel/notifications_interface.h>
 #include <logging.h>
+#include <logging/timer.h>
+#include <memusage.h>
 #include <pow.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
@@ -34,13 +38,21 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <map>
+#include <numeric>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
@@ -105,50 +117,98 @@ bool BlockTreeDB::ReadFlag(const std::string& name, bool& fValue)
     return true;
 }
 
-bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+namespace {
+struct DiskBlockIndexRecord {
+    uint256 hash;
+    CDiskBlockIndex index;
+};
+
+/**
+ * Read the block index records of the block hashes whose first serialized
+ * byte is in [first, last], and check their proof of work.
+ *
+ * @returns the records, or std::nullopt on error or interruption.
+ */
+std::optional<std::deque<DiskBlockIndexRecord>> ReadBlockIndexRange(CDBWrapper& db, uint8_t first, uint8_t last, const Consensus::Params& consensusParams, const util::SignalInterrupt& interrupt)
 {
-    AssertLockHeld(::cs_main);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    uint256 start;
+    start.begin()[0] = first;
+    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, start));
 
-    // Load m_block_index
+    std::deque<DiskBlockIndexRecord> records;
     while (pcursor->Valid()) {
-        if (interrupt) return false;
+        if (interrupt) return std::nullopt;
         std::pair<uint8_t, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.ConstructBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
-                    LogError("%s: CheckProofOfWork failed: %s\n", __func__, pindexNew->ToString());
-                    return false;
-                }
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX || key.second.begin()[0] > last) break;
+        DiskBlockIndexRecord& record{records.emplace_back()};
+        if (!pcursor->GetValue(record.index)) {
+            LogError("%s: failed to read value\n", __func__);
+            return std::nullopt;
+        }
+        record.hash = record.index.ConstructBlockHash();
+        if (!CheckProofOfWork(record.hash, record.index.nBits, consensusParams)) {
+            LogError("%s: CheckProofOfWork failed: block %s at height %d\n", __func__, record.hash.ToString(), record.index.nHeight);
+            return std::nullopt;
+        }
+        pcursor->Next();
+    }
+    return records;
+}
+} // namespace
 
-                pcursor->Next();
-            } else {
-                LogError("%s: failed to read value\n", __func__);
-                return false;
-            }
-        } else {
-            break;
+bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+{
+    AssertLockHeld(::cs_main);
+
+    // The records are keyed by block hash, so that ranges of the first byte of
+    // the hashes hold as many records each. They are read and deserialized,
+    // and their proof of work checked, on the shared thread pool, while this
+    // thread constructs the block index objects from the ranges in order. Few
+    // ranges are read ahead so that not all records are held in memory at once.
+    SharedThreadPool::Group pool{GetSharedThreadPool(), SharedThreadPool::Priority::HIGH, GetSharedThreadPool().WorkersCount()};
+    const size_t concurrency{pool.Concurrency()};
+    const size_t num_ranges{concurrency > 1 ? std::min<size_t>(16 * concurrency, 256) : 1};
+    std::deque<std::future<std::optional<std::deque<DiskBlockIndexRecord>>>> reads;
+    size_t next_range{0};
+    const auto read_next{[&] {
+        const uint8_t first = next_range * 256 / num_ranges;
+        const uint8_t last = (next_range + 1) * 256 / num_ranges - 1;
+        reads.push_back(pool.Submit([this, first, last, &consensusParams, &interrupt] {
+            return ReadBlockIndexRange(*this, first, last, consensusParams, interrupt);
+        }));
+        ++next_range;
+    }};
+
+    // Load m_block_index
+    bool ok{true};
+    while (next_range < num_ranges && reads.size() < 2 * concurrency) read_next();
+    while (!reads.empty()) {
+        auto records{reads.front().get()};
+        reads.pop_front();
+        if (!records) ok = false;
+        // Wait for the reads in progress, which refer to this frame, on failure.
+        if (!ok) continue;
+        if (next_range < num_ranges) read_next();
+        for (const auto& [hash, diskindex] : *records) {
+            // Construct block index object
+            CBlockIndex* pindexNew = insertBlockIndex(hash);
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
         }
     }
 
-    return true;
+    return ok;
 }
 } // namespace kernel
 
@@ -189,6 +249,16 @@ std::vector<CBlockIndex*> BlockManager::GetAllBlockIndices()
     return rv;
 }
 
+size_t BlockManager::DynamicMemoryUsage() const
+{
+    AssertLockHeld(cs_main);
+    return memusage::DynamicUsage(m_block_index) +
+           memusage::DynamicUsage(m_blocks_unlinked) +
+           memusage::DynamicUsage(m_dirty_blockindex) +
+           memusage::DynamicUsage(m_dirty_fileinfo) +
+           memusage::DynamicUsage(m_blockfile_info);
+}
+
 CBlockIndex* BlockManager::LookupBlockIndex(const uint256& hash)
 {
     AssertLockHeld(cs_main);
@@ -203,11 +273,11 @@ const CBlockIndex* BlockManager::LookupBlockIndex(const uint256& hash) const
     return it == m_block_index.end() ? nullptr : &it->second;
 }
 
-CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header)
+CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, const uint256& hash, CBlockIndex*& best_header)
 {
     AssertLockHeld(cs_main);
 
-    auto [mi, inserted] = m_block_index.try_emplace(block.GetHash(), block);
+    auto [mi, inserted] = m_block_index.try_emplace(hash, block);
     if (!inserted) {
         return &mi->second;
     }
@@ -396,6 +466,26 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
     return pindex;
 }
 
+std::vector<CBlockIndex*> BlockManager::SortByHeight(std::vector<CBlockIndex*> block_indices)
+{
+    if (block_indices.empty()) return block_indices;
+    const auto [min, max]{std::ranges::minmax(block_indices, CBlockIndexHeightOnlyComparator{})};
+    const size_t num_heights{size_t(int64_t{max->nHeight} - min->nHeight) + 1};
+    if (num_heights > block_indices.size()) {
+        // Heights are missing, which the caller reports.
+        std::sort(block_indices.begin(), block_indices.end(), CBlockIndexHeightOnlyComparator());
+        return block_indices;
+    }
+    // Heights are as many as the blocks at most, so that a counting sort
+    // orders them without comparisons.
+    std::vector<size_t> offsets(num_heights + 1);
+    for (const CBlockIndex* pindex : block_indices) ++offsets[pindex->nHeight - min->nHeight + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<CBlockIndex*> sorted(block_indices.size());
+    for (CBlockIndex* pindex : block_indices) sorted[offsets[pindex->nHeight - min->nHeight]++] = pindex;
+    return sorted;
+}
+
 bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
 {
     if (!m_block_tree_db->LoadBlockIndexGuts(
@@ -428,9 +518,7 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
     Assert(m_snapshot_height.has_value() == snapshot_blockhash.has_value());
 
     // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
+    std::vector<CBlockIndex*> vSortedByHeight{SortByHeight(GetAllBlockIndices())};
 
     CBlockIndex* previous_index{nullptr};
     for (CBlockIndex* pindex : vSortedByHeight) {
@@ -499,6 +587,7 @@ bool BlockManager::WriteBlockIndexDB()
 
 bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
 {
+    TIME_SCOPE("LoadBlockIndexDB");
     if (!LoadBlockIndex(snapshot_blockhash)) {
         return false;
     }
@@ -543,6 +632,7 @@ bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_block
             const auto last_height_in_file = m_blockfile_info[i].nHeightLast;
             m_blockfile_cursors[BlockfileTypeForHeight(last_height_in_file)] = {static_cast<int>(i), 0};
         }
+        m_newest_block_file = std::max<int>(m_blockfile_info.size(), 1) - 1;
     }
 
     // Check whether we have ever pruned block & undo files
@@ -660,6 +750,18 @@ CBlockFileInfo* BlockManager::GetBlockFileInfo(size_t n)
 bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const
 {
     const FlatFilePos pos{WITH_LOCK(::cs_main, return index.GetUndoPos())};
+    return ReadBlockUndo(blockundo, pos, index.pprev->GetBlockHash());
+}
+
+bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash) const
+{
+    const bool use_cache{m_block_undo_cache.Enabled() && IsCacheableFile(pos.nFile)};
+    if (use_cache) {
+        if (const auto cached{m_block_undo_cache.Get(pos)}) {
+            blockundo = *cached;
+            return true;
+        }
+    }
 
     // Open history file to read
     AutoFile file{OpenUndoFile(pos, true)};
@@ -673,7 +775,7 @@ bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index
         // Read block
         HashVerifier verifier{filein}; // Use HashVerifier, as reserializing may lose data, c.f. commit d3424243
 
-        verifier << index.pprev->GetBlockHash();
+        verifier << prev_hash;
         verifier >> blockundo;
 
         uint256 hashChecksum;
@@ -689,6 +791,9 @@ bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index
         return false;
     }
 
+    if (use_cache) {
+        m_block_undo_cache.Put(pos, std::make_shared<const CBlockUndo>(blockundo), GetSerializeSize(blockundo));
+    }
     return true;
 }
 
@@ -765,23 +870,193 @@ uint64_t BlockManager::CalculateCurrentUsage()
 }
 
 void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
+{
+    m_raw_block_cache.EraseFiles(setFilesToPrune);
+    m_block_undo_cache.EraseFiles(setFilesToPrune);
+    RemoveBlockFiles(setFilesToPrune);
+}
+
+void BlockManager::RemoveBlockFiles(const std::set<int>& files) const
 {
     std::error_code ec;
-    for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
-        FlatFilePos pos(*it, 0);
+    for (const int file : files) {
+        FlatFilePos pos(file, 0);
         const bool removed_blockfile{fs::remove(m_block_file_seq.FileName(pos), ec)};
         const bool removed_undofile{fs::remove(m_undo_file_seq.FileName(pos), ec)};
         if (removed_blockfile || removed_undofile) {
-            LogDebug(BCLog::BLOCKSTORAGE, "Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
+            LogDebug(BCLog::BLOCKSTORAGE, "Prune: %s deleted blk/rev (%05u)\n", __func__, file);
         }
     }
 }
 
+void BlockManager::UnlinkPrunedFilesInBackground(const std::set<int>& files)
+{
+    if (files.empty()) return;
+    m_raw_block_cache.EraseFiles(files);
+    m_block_undo_cache.EraseFiles(files);
+    {
+        LOCK(m_unlink_mutex);
+        m_files_to_unlink.insert(files.begin(), files.end());
+        if (!m_unlink_thread.joinable()) {
+            m_unlink_thread = std::thread(&util::TraceThread, "prune", [this] { ThreadUnlinkPrunedFiles(); });
+        }
+    }
+    m_unlink_cv.notify_all();
+}
+
+void BlockManager::WaitForPrunedFilesUnlinked()
+{
+    WAIT_LOCK(m_unlink_mutex, lock);
+    m_unlink_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_unlink_mutex) { return m_files_to_unlink.empty() && !m_unlinking; });
+}
+
+void BlockManager::ThreadUnlinkPrunedFiles()
+{
+    WAIT_LOCK(m_unlink_mutex, lock);
+    while (true) {
+        m_unlink_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_unlink_mutex) { return !m_files_to_unlink.empty() || m_stop_unlinking; });
+        // Files queued before stopping are still deleted.
+        if (m_files_to_unlink.empty()) return;
+        const std::set<int> files{std::exchange(m_files_to_unlink, {})};
+        m_unlinking = true;
+        {
+            REVERSE_LOCK(lock, m_unlink_mutex);
+            RemoveBlockFiles(files);
+        }
+        m_unlinking = false;
+        m_unlink_cv.notify_all();
+    }
+}
+
+void BlockManager::MoveOldFilesToColdDir(int tip_height)
+{
+    if (m_opts.cold_blocks_dir.empty()) return;
+    std::vector<int> files;
+    {
+        LOCK(cs_LastBlockFile);
+        for (int file{0}; file < static_cast<int>(m_blockfile_info.size()); ++file) {
+            const CBlockFileInfo& info{m_blockfile_info[file]};
+            if (info.nBlocks == 0 || static_cast<int64_t>(info.nHeightLast) + m_opts.cold_blocks_depth > tip_height) continue;
+            if (std::ranges::any_of(m_blockfile_cursors, [&](const auto& cursor) { return cursor && cursor->file_num == file; })) continue;
+            files.push_back(file);
+        }
+    }
+    {
+        LOCK(m_cold_mutex);
+        for (const int file : files) {
+            if (m_cold_files.insert(file).second) m_files_to_move.insert(file);
+        }
+        if (m_files_to_move.empty()) return;
+        if (!m_cold_thread.joinable()) {
+            m_cold_thread = std::thread(&util::TraceThread, "coldblocks", [this] { ThreadMoveFilesToColdDir(); });
+        }
+    }
+    m_cold_cv.notify_all();
+}
+
+void BlockManager::WaitForColdFilesMoved()
+{
+    WAIT_LOCK(m_cold_mutex, lock);
+    m_cold_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_cold_mutex) { return m_files_to_move.empty() && !m_moving; });
+}
+
+void BlockManager::ThreadMoveFilesToColdDir()
+{
+    WAIT_LOCK(m_cold_mutex, lock);
+    while (true) {
+        m_cold_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_cold_mutex) { return !m_files_to_move.empty() || m_stop_moving; });
+        // Unlike pruned files, queued files are left in place when stopping:
+        // they are queued again after a restart.
+        if (m_stop_moving) return;
+        const int file{*m_files_to_move.begin()};
+        m_files_to_move.erase(m_files_to_move.begin());
+        m_moving = true;
+        bool moved;
+        {
+            REVERSE_LOCK(lock, m_cold_mutex);
+            moved = MoveFileToColdDir(file);
+        }
+        // Try again after the next flush.
+        if (!moved) m_cold_files.erase(file);
+        m_moving = false;
+        m_cold_cv.notify_all();
+    }
+}
+
+bool BlockManager::MoveFileToColdDir(int file)
+{
+    const FlatFilePos pos{file, 0};
+    const auto sizes{[&] {
+        LOCK(cs_LastBlockFile);
+        return std::pair{m_blockfile_info[file].nSize, m_blockfile_info[file].nUndoSize};
+    }};
+    // Data written to the files while they are copied, e.g. the undo data of
+    // a block connected in a reorg deeper than cold_blocks_depth, would be
+    // lost, so the copies are only used if the sizes did not change.
+    const auto sizes_before{sizes()};
+    if (!m_block_file_seq.CopyToColdDir(pos) || !m_undo_file_seq.CopyToColdDir(pos)) {
+        LogWarning("Failed to copy blk/rev (%05u) to the cold blocks directory %s", file, fs::PathToString(m_opts.cold_blocks_dir));
+        return false;
+    }
+    if (sizes() != sizes_before) {
+        LogDebug(BCLog::BLOCKSTORAGE, "blk/rev (%05u) changed while being copied to the cold blocks directory\n", file);
+        return false;
+    }
+    m_block_file_seq.RemoveCopiedToColdDir(pos);
+    m_undo_file_seq.RemoveCopiedToColdDir(pos);
+    LogDebug(BCLog::BLOCKSTORAGE, "Moved blk/rev (%05u) to the cold blocks directory\n", file);
+    return true;
+}
+
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
     return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_xor_key};
 }
 
+std::optional<std::vector<ScannedBlock>> BlockManager::ScanBlockFile(int file_num) const
+{
+    AutoFile file{OpenBlockFile({file_num, 0}, /*fReadOnly=*/true)};
+    if (file.IsNull()) return std::nullopt;
+
+    const MessageStartChars& message_start{GetParams().MessageStart()};
+    std::vector<ScannedBlock> blocks;
+    BufferedFile blkdat{file, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
+    // Where to resume scanning, see ChainstateManager::LoadExternalBlockFile().
+    uint64_t rewind{blkdat.GetPos()};
+    while (!blkdat.eof()) {
+        if (m_interrupt) break;
+
+        blkdat.SetPos(rewind);
+        rewind++;
+        blkdat.SetLimit();
+        unsigned int size{0};
+        try {
+            MessageStartChars buf;
+            blkdat.FindByte(std::byte(message_start[0]));
+            rewind = blkdat.GetPos() + 1;
+            blkdat >> buf;
+            if (buf != message_start) continue;
+            blkdat >> size;
+            if (size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE) continue;
+        } catch (const std::exception&) {
+            // No further block, as at the end of every block file.
+            break;
+        }
+        try {
+            const uint64_t block_pos{blkdat.GetPos()};
+            blkdat.SetLimit(block_pos + size);
+            CBlockHeader header;
+            blkdat >> header;
+            rewind = block_pos + size;
+            blkdat.SkipTo(rewind);
+            blocks.push_back({FlatFilePos{file_num, static_cast<unsigned int>(block_pos)}, header.GetHash(), header.hashPrevBlock});
+        } catch (const std::exception& e) {
+            LogDebug(BCLog::REINDEX, "%s: unexpected data in blk%05u.dat at offset 0x%x - %s. continuing\n", __func__, file_num, (rewind - 1), e.what());
+        }
+    }
+    return blocks;
+}
+
 /** Open an undo file (rev?????.dat) */
 AutoFile BlockManager::OpenUndoFile(const FlatFilePos& pos, bool fReadOnly) const
 {
@@ -845,6 +1120,7 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
     FlatFilePos pos;
     pos.nFile = nFile;
     pos.nPos = m_blockfile_info[nFile].nSize;
+    if (nFile > m_newest_block_file) m_newest_block_file = nFile;
 
     if (nFile != last_blockfile) {
         LogDebug(BCLog::BLOCKSTORAGE, "Leaving block file %i: %s (onto %i) (height %i)\n",
@@ -996,23 +1272,29 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const
+bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, SteadyClock::duration* deserialize_time) const
 {
     block.SetNull();
 
-    // Open history file to read
+    // Use the cached raw block if there is one, but do not add to the cache
+    // here: blocks are read like this when connecting them, and every one of
+    // those would evict the blocks being served.
+    std::shared_ptr<const std::vector<std::byte>> cached;
+    if (m_raw_block_cache.Enabled() && IsCacheableFile(pos.nFile)) cached = m_raw_block_cache.Get(pos);
     std::vector<std::byte> block_data;
-    if (!ReadRawBlock(block_data, pos)) {
+    if (!cached && !ReadRawBlockImpl(block_data, pos)) {
         return false;
     }
 
+    const auto deserialize_start{SteadyClock::now()};
     try {
         // Read block
-        SpanReader{block_data} >> TX_WITH_WITNESS(block);
+        SpanReader{cached ? std::span{*cached} : std::span{block_data}} >> TX_WITH_WITNESS(block);
     } catch (const std::exception& e) {
         LogError("Deserialize or I/O error - %s at %s while reading block", e.what(), pos.ToString());
         return false;
     }
+    if (deserialize_time) *deserialize_time += SteadyClock::now() - deserialize_start;
 
     const auto block_hash{block.GetHash()};
 
@@ -1037,13 +1319,14 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::o
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
+bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index, SteadyClock::duration* deserialize_time) const
 {
     const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
-    return ReadBlock(block, block_pos, index.GetBlockHash());
+    return ReadBlock(block, block_pos, index.GetBlockHash(), deserialize_time);
 }
 
-bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const
+template <typename Byte>
+bool BlockManager::ReadRawBlockImpl(std::vector<Byte>& block, const FlatFilePos& pos) const
 {
     if (pos.nPos < STORAGE_HEADER_BYTES) {
         // If nPos is less than STORAGE_HEADER_BYTES, we can't read the header that precedes the block data
@@ -1077,7 +1360,7 @@ bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos
         }
 
         block.resize(blk_size); // Zeroing of memory is intentional here
-        filein.read(block);
+        filein.read(MakeWritableByteSpan(block));
     } catch (const std::exception& e) {
         LogError("Read from block file failed: %s for %s while reading raw block", e.what(), pos.ToString());
         return false;
@@ -1086,6 +1369,52 @@ bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos
     return true;
 }
 
+template <typename Byte>
+bool BlockManager::ReadRawBlockCached(std::vector<Byte>& block, const FlatFilePos& pos) const
+{
+    if (!m_raw_block_cache.Enabled() || !IsCacheableFile(pos.nFile)) return ReadRawBlockImpl(block, pos);
+    if (const auto cached{m_raw_block_cache.Get(pos)}) {
+        block.resize(cached->size());
+        std::memcpy(block.data(), cached->data(), cached->size());
+        return true;
+    }
+    if (!ReadRawBlockImpl(block, pos)) return false;
+    auto entry{std::make_shared<std::vector<std::byte>>(block.size())};
+    std::memcpy(entry->data(), block.data(), block.size());
+    m_raw_block_cache.Put(pos, std::move(entry), block.size());
+    return true;
+}
+
+bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const
+{
+    return ReadRawBlockCached(block, pos);
+}
+
+bool BlockManager::ReadRawBlock(std::vector<unsigned char>& block, const FlatFilePos& pos) const
+{
+    return ReadRawBlockCached(block, pos);
+}
+
+bool BlockManager::ReadRawBlockNoWitness(std::vector<unsigned char>& block, const FlatFilePos& pos) const
+{
+    const bool cacheable{m_no_witness_block_cache.Enabled() && IsCacheableFile(pos.nFile)};
+    auto stripped{cacheable ? m_no_witness_block_cache.Get(pos) : nullptr};
+    if (!stripped) {
+        std::vector<std::byte> raw_block;
+        if (!ReadRawBlockCached(raw_block, pos)) return false;
+        auto entry{std::make_shared<std::vector<std::byte>>()};
+        if (!StripBlockWitness(raw_block, *entry)) {
+            LogError("Deserialize error at %s while stripping the witness data of a block", pos.ToString());
+            return false;
+        }
+        if (cacheable) m_no_witness_block_cache.Put(pos, entry, entry->size());
+        stripped = std::move(entry);
+    }
+    block.resize(stripped->size());
+    std::memcpy(block.data(), stripped->data(), stripped->size());
+    return true;
+}
+
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
 {
     const unsigned int block_size{static_cast<unsigned int>(GetSerializeSize(TX_WITH_WITNESS(block)))};
@@ -1180,8 +1509,11 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
     : m_prune_mode{opts.prune_target > 0},
       m_xor_key{InitBlocksdirXorKey(opts)},
       m_opts{std::move(opts)},
-      m_block_file_seq{FlatFileSeq{m_opts.blocks_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE}},
-      m_undo_file_seq{FlatFileSeq{m_opts.blocks_dir, "rev", UNDOFILE_CHUNK_SIZE}},
+      m_block_file_seq{FlatFileSeq{m_opts.blocks_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE, m_opts.cold_blocks_dir}},
+      m_undo_file_seq{FlatFileSeq{m_opts.blocks_dir, "rev", UNDOFILE_CHUNK_SIZE, m_opts.cold_blocks_dir}},
+      m_raw_block_cache{m_opts.block_data_cache_bytes / 2},
+      m_block_undo_cache{m_opts.block_data_cache_bytes / 4},
+      m_no_witness_block_cache{m_opts.block_data_cache_bytes / 4},
       m_interrupt{interrupt}
 {
     m_block_tree_db = std::make_unique<BlockTreeDB>(m_opts.block_tree_db_params);
@@ -1196,6 +1528,16 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
     }
 }
 
+BlockManager::~BlockManager()
+{
+    WITH_LOCK(m_unlink_mutex, m_stop_unlinking = true);
+    m_unlink_cv.notify_all();
+    if (m_unlink_thread.joinable()) m_unlink_thread.join();
+    WITH_LOCK(m_cold_mutex, m_stop_moving = true);
+    m_cold_cv.notify_all();
+    if (m_cold_thread.joinable()) m_cold_thread.join();
+}
+
 class ImportingNow
 {
     std::atomic<bool>& m_importing;
@@ -1213,6 +1555,22 @@ public:
     }
 };
 
+bool StripBlockWitness(std::span<const std::byte> block, std::vector<std::byte>& stripped)
+{
+    stripped.clear();
+    stripped.reserve(block.size());
+    try {
+        const BlockView view{block};
+        stripped.insert(stripped.end(), view.Prefix().begin(), view.Prefix().end());
+        for (const TxView& tx : view.Transactions()) {
+            for (const auto part : tx.NoWitnessParts()) stripped.insert(stripped.end(), part.begin(), part.end());
+        }
+    } catch (const std::ios_base::failure&) {
+        return false;
+    }
+    return true;
+}
+
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths)
 {
     ImportingNow imp{chainman.m_blockman.m_importing};
@@ -1223,22 +1581,54 @@ void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_
         // Map of disk positions for blocks with unknown parent (only used for reindex);
         // parent hash -> child disk position, multiple children can have the same parent.
         std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
-        while (true) {
-            FlatFilePos pos(nFile, 0);
-            if (!fs::exists(chainman.m_blockman.GetBlockPosFilename(pos))) {
-                break; // No block files left to reindex
-            }
-            AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
-            if (file.IsNull()) {
-                break; // This error is logged in OpenBlockFile
+        if (const int scan_threads{chainman.m_blockman.ReindexScanThreads()}; scan_threads > 0) {
+            // Scan the files for blocks on a thread pool, a few files ahead
+            // of the files being accepted, which stays serial.
+            ThreadPool scan_pool{"reindexscan"};
+            scan_pool.Start(scan_threads);
+            std::deque<std::future<std::optional<std::vector<ScannedBlock>>>> scans;
+            int next_scan{0};
+            while (true) {
+                while (scans.size() < size_t(2 * scan_threads) && fs::exists(chainman.m_blockman.GetBlockPosFilename(FlatFilePos(next_scan, 0)))) {
+                    scans.push_back(scan_pool.Submit([&blockman = chainman.m_blockman, file_num = next_scan] { return blockman.ScanBlockFile(file_num); }));
+                    ++next_scan;
+                }
+                if (scans.empty()) break; // No block files left to reindex
+                std::optional<std::vector<ScannedBlock>> blocks;
+                try {
+                    blocks = scans.front().get();
+                } catch (const std::runtime_error& e) {
+                    chainman.GetNotifications().fatalError(strprintf(_("System error while loading external block file: %s"), e.what()));
+                    return;
+                }
+                scans.pop_front();
+                if (!blocks) break; // This error is logged in OpenBlockFile
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                chainman.LoadScannedBlockFile(*blocks, blocks_with_unknown_parent);
+                if (chainman.m_interrupt) {
+                    LogPrintf("Interrupt requested. Exit %s\n", __func__);
+                    return;
+                }
+                nFile++;
             }
-            LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-            chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
-            if (chainman.m_interrupt) {
-                LogPrintf("Interrupt requested. Exit %s\n", __func__);
-                return;
+        } else {
+            while (true) {
+                FlatFilePos pos(nFile, 0);
+                if (!fs::exists(chainman.m_blockman.GetBlockPosFilename(pos))) {
+                    break; // No block files left to reindex
+                }
+                AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
+                if (file.IsNull()) {
+                    break; // This error is logged in OpenBlockFile
+                }
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+                if (chainman.m_interrupt) {
+                    LogPrintf("Interrupt requested. Exit %s\n", __func__);
+                    return;
+                }
+                nFile++;
             }
-            nFile++;
         }
         WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
         chainman.m_blockman.m_blockfiles_indexed = true;
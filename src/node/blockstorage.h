@@ -13,15 +13,19 @@
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
 #include <kernel/messagestartchars.h>
+#include <node/blockdatacache.h>
 #include <primitives/block.h>
 #include <streams.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/time.h>
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -31,6 +35,7 @@
 #include <set>
 #include <span>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -84,7 +89,18 @@ static constexpr uint32_t UNDO_DATA_DISK_OVERHEAD{STORAGE_HEADER_BYTES + uint256
 // we ever switch to another associative container, we need to either use a
 // container that has stable addressing (true of all std associative
 // containers), or make the key a `std::unique_ptr<CBlockIndex>`
-using BlockMap = std::unordered_map<uint256, CBlockIndex, BlockHasher>;
+//
+// The nodes of the map are allocated from chunks of a PoolResource, as for
+// CCoinsMap, so that the hundreds of thousands of entries of the block index
+// cost no allocator overhead each and lie next to each other in memory.
+using BlockMap = std::unordered_map<uint256,
+                                    CBlockIndex,
+                                    BlockHasher,
+                                    std::equal_to<uint256>,
+                                    PoolAllocator<std::pair<const uint256, CBlockIndex>,
+                                                  sizeof(std::pair<const uint256, CBlockIndex>) + sizeof(void*) * 4>>;
+
+using BlockMapMemoryResource = BlockMap::allocator_type::ResourceType;
 
 struct CBlockIndexWorkComparator {
     bool operator()(const CBlockIndex* pa, const CBlockIndex* pb) const;
@@ -127,6 +143,12 @@ struct BlockfileCursor {
 
 std::ostream& operator<<(std::ostream& os, const BlockfileCursor& cursor);
 
+/** Position and header hashes of a block found in a block file by BlockManager::ScanBlockFile(). */
+struct ScannedBlock {
+    FlatFilePos pos;
+    uint256 hash;
+    uint256 prev_hash;
+};
 
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
@@ -143,6 +165,10 @@ class BlockManager
 private:
     const CChainParams& GetParams() const { return m_opts.chainparams; }
     const Consensus::Params& GetConsensus() const { return m_opts.chainparams.GetConsensus(); }
+    template <typename Byte>
+    bool ReadRawBlockImpl(std::vector<Byte>& block, const FlatFilePos& pos) const;
+    template <typename Byte>
+    bool ReadRawBlockCached(std::vector<Byte>& block, const FlatFilePos& pos) const;
     /**
      * Load the blocktree off disk and into memory. Populate certain metadata
      * per index entry (nStatus, nChainWork, nTimeMax, etc.) as well as peripheral
@@ -151,6 +177,9 @@ private:
     bool LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Order block index entries by height, blocks of the same height in no particular order. */
+    static std::vector<CBlockIndex*> SortByHeight(std::vector<CBlockIndex*> block_indices);
+
     /** Return false if block file or undo file flushing fails. */
     [[nodiscard]] bool FlushBlockFile(int blockfile_num, bool fFinalize, bool finalize_undo);
 
@@ -258,10 +287,49 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    //! Recently read raw blocks, keyed by block position.
+    mutable BlockDataCache<std::vector<std::byte>> m_raw_block_cache;
+    //! Recently read undo data, keyed by undo position.
+    mutable BlockDataCache<CBlockUndo> m_block_undo_cache;
+    //! Recently served blocks stripped of their witness data, keyed by block position.
+    mutable BlockDataCache<std::vector<std::byte>> m_no_witness_block_cache;
+    //! Highest block file number written to or loaded. Only data in this and
+    //! the previous file is added to the caches, so sweeping through old
+    //! blocks (e.g. when syncing an index) does not churn them.
+    std::atomic<int> m_newest_block_file{0};
+    bool IsCacheableFile(int file_num) const { return file_num + 1 >= m_newest_block_file.load(); }
+
+    //! Pruned files not deleted yet, which a thread started by the first
+    //! UnlinkPrunedFilesInBackground() call deletes.
+    Mutex m_unlink_mutex;
+    std::condition_variable m_unlink_cv;
+    std::set<int> m_files_to_unlink GUARDED_BY(m_unlink_mutex);
+    //! Whether the thread is deleting files taken from m_files_to_unlink.
+    bool m_unlinking GUARDED_BY(m_unlink_mutex){false};
+    bool m_stop_unlinking GUARDED_BY(m_unlink_mutex){false};
+    std::thread m_unlink_thread;
+    void ThreadUnlinkPrunedFiles() EXCLUSIVE_LOCKS_REQUIRED(!m_unlink_mutex);
+    void RemoveBlockFiles(const std::set<int>& files) const;
+
+    //! Old files not moved to the cold blocks directory yet, which a thread
+    //! started by the first MoveOldFilesToColdDir() call moves.
+    Mutex m_cold_mutex;
+    std::condition_variable m_cold_cv;
+    std::set<int> m_files_to_move GUARDED_BY(m_cold_mutex);
+    //! Files moved or queued to be moved, which are not queued again.
+    std::set<int> m_cold_files GUARDED_BY(m_cold_mutex);
+    //! Whether the thread is moving a file taken from m_files_to_move.
+    bool m_moving GUARDED_BY(m_cold_mutex){false};
+    bool m_stop_moving GUARDED_BY(m_cold_mutex){false};
+    std::thread m_cold_thread;
+    void ThreadMoveFilesToColdDir() EXCLUSIVE_LOCKS_REQUIRED(!m_cold_mutex);
+    bool MoveFileToColdDir(int file);
+
 public:
     using Options = kernel::BlockManagerOpts;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts);
+    ~BlockManager();
 
     const util::SignalInterrupt& m_interrupt;
     std::atomic<bool> m_importing{false};
@@ -274,7 +342,8 @@ public:
      */
     std::atomic_bool m_blockfiles_indexed{true};
 
-    BlockMap m_block_index GUARDED_BY(cs_main);
+    BlockMapMemoryResource m_block_index_memory_resource{};
+    BlockMap m_block_index GUARDED_BY(cs_main){0, BlockHasher{}, std::equal_to<uint256>{}, &m_block_index_memory_resource};
 
     /**
      * The height of the base block of an assumeutxo snapshot, if one is in use.
@@ -292,6 +361,10 @@ public:
 
     std::vector<CBlockIndex*> GetAllBlockIndices() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    //! Memory used by the block index, the block file statistics and the
+    //! bookkeeping around them, not including the block tree database.
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /**
      * All pairs A->B, where A (or one of its ancestors) misses transactions, but B has transactions.
      * Pruned nodes may have entries where B is missing data.
@@ -311,7 +384,12 @@ public:
      */
     void ScanAndUnlinkAlreadyPrunedFiles() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
-    CBlockIndex* AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    CBlockIndex* AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        return AddToBlockIndex(block, block.GetHash(), best_header);
+    }
+    //! As above, for a header whose hash the caller already computed.
+    CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256& hash, CBlockIndex*& best_header) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Create a new block index entry for a given block hash */
     CBlockIndex* InsertBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -402,6 +480,17 @@ public:
     /** Open a block file (blk?????.dat) */
     AutoFile OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const;
 
+    /**
+     * Find the blocks stored in block file `file_num`, in file order, by
+     * searching for the network magic like LoadExternalBlockFile() does. Only
+     * the headers are deserialized. Does not access the block index, so it
+     * can run on several files in parallel. Returns std::nullopt if the file
+     * cannot be opened, and throws std::runtime_error on read errors.
+     */
+    std::optional<std::vector<ScannedBlock>> ScanBlockFile(int file_num) const;
+
+    int ReindexScanThreads() const { return m_opts.reindex_scan_threads; }
+
     /** Translation to a filesystem path */
     fs::path GetBlockPosFilename(const FlatFilePos& pos) const;
 
@@ -410,16 +499,64 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
-    /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
+    /**
+     * Unlink the specified files on a background thread, as deleting large
+     * files takes a while on some filesystems. The files must have been pruned
+     * with PruneOneBlockFile(), so that the block file statistics and the
+     * pruning target no longer account for them, and their data is no longer
+     * served from the caches when this returns.
+     */
+    void UnlinkPrunedFilesInBackground(const std::set<int>& files) EXCLUSIVE_LOCKS_REQUIRED(!m_unlink_mutex);
+
+    /** Wait for the files passed to UnlinkPrunedFilesInBackground() to be unlinked. */
+    void WaitForPrunedFilesUnlinked() EXCLUSIVE_LOCKS_REQUIRED(!m_unlink_mutex);
+
+    /**
+     * If a cold blocks directory is configured, move the block and undo files
+     * whose blocks are all at least cold_blocks_depth below tip_height there
+     * on a background thread. No more data is written to such files, and they
+     * are read from either directory, so moving them is transparent to
+     * readers. The files being written to are never moved.
+     */
+    void MoveOldFilesToColdDir(int tip_height) EXCLUSIVE_LOCKS_REQUIRED(!m_cold_mutex);
+
+    /** Wait for the files queued by MoveOldFilesToColdDir() to be moved. */
+    void WaitForColdFilesMoved() EXCLUSIVE_LOCKS_REQUIRED(!m_cold_mutex);
+
+    /**
+     * Functions for disk access for blocks. If `deserialize_time` is set, the
+     * time spent deserializing the block (as opposed to reading the file) is
+     * added to it.
+     */
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, SteadyClock::duration* deserialize_time = nullptr) const;
+    bool ReadBlock(CBlock& block, const CBlockIndex& index, SteadyClock::duration* deserialize_time = nullptr) const;
     bool ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const;
+    /** Read the raw block into a network message payload, to send it without another copy. */
+    bool ReadRawBlock(std::vector<unsigned char>& block, const FlatFilePos& pos) const;
+    /**
+     * Read the block serialized without the witness data of its transactions,
+     * as sent to peers that did not ask for it, into a network message payload.
+     */
+    bool ReadRawBlockNoWitness(std::vector<unsigned char>& block, const FlatFilePos& pos) const;
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
+    /** Read the undo data at pos of the block whose parent is prev_hash, without locking cs_main. */
+    bool ReadBlockUndo(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash) const;
+
+    BlockDataCache<std::vector<std::byte>>::Stats GetRawBlockCacheStats() const { return m_raw_block_cache.GetStats(); }
+    BlockDataCache<CBlockUndo>::Stats GetBlockUndoCacheStats() const { return m_block_undo_cache.GetStats(); }
+    BlockDataCache<std::vector<std::byte>>::Stats GetNoWitnessBlockCacheStats() const { return m_no_witness_block_cache.GetStats(); }
 
     void CleanupBlockRevFiles() const;
 };
 
+/**
+ * Copy a serialized block to `stripped` without the witness data of its
+ * transactions, i.e. as serialized with TX_NO_WITNESS, without deserializing
+ * it. Return false if the block is not well formed.
+ */
+bool StripBlockWitness(std::span<const std::byte> block, std::vector<std::byte>& stripped);
+
 // Calls ActivateBestChain() even if no blocks are imported.
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths);
 } // namespace node
@@ -8,10 +8,12 @@
 #include <common/args.h>
 #include <common/system.h>
 #include <logging.h>
+#include <node/blockreadahead.h>
 #include <node/coins_view_args.h>
 #include <node/database_args.h>
 #include <tinyformat.h>
 #include <uint256.h>
+#include <util/meminfo.h>
 #include <util/result.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
@@ -59,6 +61,10 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     // Subtract 1 because the main thread counts towards the par threads.
     opts.worker_threads_num = script_threads - 1;
 
+    if (auto value{args.GetIntArg("-backgroundpar")}) {
+        opts.background_worker_threads_num = std::clamp<int64_t>(*value, 0, MAX_SCRIPTCHECK_THREADS);
+    }
+
     if (auto max_size = args.GetIntArg("-maxsigcachesize")) {
         // 1. When supplied with a max_size of 0, both the signature cache and
         //    script execution cache create the minimum possible cache (2
@@ -69,6 +75,31 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
         opts.signature_cache_bytes = clamped_size_each;
     }
 
+    if (args.GetBoolArg("-dbcachedynamic", DEFAULT_DBCACHE_DYNAMIC)) {
+        opts.available_memory = [] { return util::GetAvailableMemory(); };
+    }
+
+    if (auto value{args.GetIntArg("-blockreadahead")}) {
+        opts.block_read_ahead = std::clamp<int64_t>(*value, 0, MAX_BLOCK_READ_AHEAD);
+    }
+    if (auto value{args.GetIntArg("-blockreadaheadthreads")}) {
+        opts.block_read_ahead_threads = std::clamp<int64_t>(*value, 1, MAX_BLOCK_READ_AHEAD_THREADS);
+    }
+
+    if (auto value{args.GetIntArg("-prefetchthreads")}) {
+        opts.input_prefetch_threads = std::clamp<int64_t>(*value, 0, MAX_INPUT_PREFETCH_THREADS);
+    }
+
+    if (auto value{args.GetIntArg("-headercheckthreads")}) {
+        opts.header_check_threads = std::clamp<int64_t>(*value, 0, MAX_HEADER_CHECK_THREADS);
+    }
+
+    if (auto value{args.GetIntArg("-coinsflushchunk")}) opts.coins_flush_chunk = std::max<int64_t>(*value, 0);
+
+    if (auto value{args.GetBoolArg("-batchschnorr")}) opts.batch_schnorr = *value;
+
+    if (auto value{args.GetBoolArg("-hugepages")}) opts.huge_pages = *value;
+
     return {};
 }
 } // namespace node
@@ -4,24 +4,197 @@
 
 #include <node/coin.h>
 
+#include <chain.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
+#include <primitives/block_view.h>
+#include <streams.h>
+#include <txdb.h>
+#include <tinyformat.h>
 #include <txmempool.h>
+#include <undo.h>
+#include <util/check.h>
+#include <util/hasher.h>
+#include <util/signalinterrupt.h>
+#include <util/translation.h>
 #include <validation.h>
 
+#include <ios>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
 namespace node {
+namespace {
+/**
+ * Look up outpoints in the mempool, if given, and in the active chainstate.
+ * cs_main is only held to find the outpoints in the mempool and the coins
+ * cache, and to take a snapshot of the coins database at the same tip; the
+ * other outpoints are then read from the snapshot without holding it.
+ */
+CoinsLookup LookupCoinsAtTip(ChainstateManager& chainman, const CTxMemPool* mempool, std::span<const COutPoint> outpoints, bool include_mempool_spent)
+{
+    CoinsLookup lookup;
+    lookup.coins.resize(outpoints.size());
+    // Outpoints neither in the mempool nor cached, and their indexes in outpoints.
+    std::vector<COutPoint> uncached;
+    std::vector<size_t> uncached_index;
+    std::unique_ptr<CCoinsViewDBSnapshot> db_snapshot;
+    {
+        LOCK(cs_main);
+        Chainstate& chainstate{chainman.ActiveChainstate()};
+        const CCoinsViewCache& cache{chainstate.CoinsTip()};
+        const auto lookup_cache{[&](size_t i) {
+            if (const Coin* coin{cache.PeekCoin(outpoints[i])}) {
+                if (!coin->IsSpent()) lookup.coins[i] = *coin;
+            } else {
+                uncached.push_back(outpoints[i]);
+                uncached_index.push_back(i);
+            }
+        }};
+        if (mempool) {
+            LOCK(mempool->cs);
+            for (size_t i{0}; i < outpoints.size(); ++i) {
+                const COutPoint& outpoint{outpoints[i]};
+                if (!include_mempool_spent && mempool->isSpent(outpoint)) continue;
+                if (const CTransactionRef tx{mempool->get(outpoint.hash)}) {
+                    // Like CCoinsViewMemPool, prefer the mempool transaction over a pruned cache entry.
+                    if (outpoint.n < tx->vout.size()) lookup.coins[i].emplace(tx->vout[outpoint.n], MEMPOOL_HEIGHT, false);
+                } else {
+                    lookup_cache(i);
+                }
+            }
+        } else {
+            for (size_t i{0}; i < outpoints.size(); ++i) lookup_cache(i);
+        }
+        if (!uncached.empty()) db_snapshot = chainstate.CoinsDB().GetSnapshot();
+        lookup.height = chainman.ActiveHeight();
+        lookup.tip_hash = chainman.ActiveTip()->GetBlockHash();
+    }
+    if (db_snapshot) {
+        auto found{db_snapshot->GetCoins(uncached)};
+        for (size_t j{0}; j < uncached.size(); ++j) lookup.coins[uncached_index[j]] = std::move(found[j]);
+    }
+    return lookup;
+}
+} // namespace
+
 void FindCoins(const NodeContext& node, std::map<COutPoint, Coin>& coins)
 {
     assert(node.mempool);
     assert(node.chainman);
-    LOCK2(cs_main, node.mempool->cs);
-    CCoinsViewCache& chain_view = node.chainman->ActiveChainstate().CoinsTip();
-    CCoinsViewMemPool mempool_view(&chain_view, *node.mempool);
-    for (auto& [outpoint, coin] : coins) {
-        if (auto c{mempool_view.GetCoin(outpoint)}) {
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(coins.size());
+    for (const auto& [outpoint, _] : coins) outpoints.push_back(outpoint);
+    auto lookup{LookupCoinsAtTip(*node.chainman, node.mempool.get(), outpoints, /*include_mempool_spent=*/true)};
+    size_t i{0};
+    for (auto& [_, coin] : coins) {
+        if (auto& c{lookup.coins[i++]}) {
             coin = std::move(*c);
         } else {
-            coin.Clear(); // Either the coin is not in the CCoinsViewCache or is spent
+            coin.Clear(); // Either the coin is not in the chainstate or is spent
         }
     }
 }
+
+CoinsLookup LookupCoins(ChainstateManager& chainman, const CTxMemPool* mempool, std::span<const COutPoint> outpoints)
+{
+    return LookupCoinsAtTip(chainman, mempool, outpoints, /*include_mempool_spent=*/false);
+}
+
+util::Result<CoinsLookup> LookupCoinsAtHeight(ChainstateManager& chainman, std::span<const COutPoint> outpoints, int height)
+{
+    CoinsLookup lookup{LookupCoinsAtTip(chainman, /*mempool=*/nullptr, outpoints, /*include_mempool_spent=*/false)};
+    if (height > lookup.height) return util::Error{Untranslated("Height is above the tip")};
+
+    // The blocks to undo, from the tip the coins were looked up at, which may
+    // no longer be the active tip, down to the block at height.
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindex{Assert(chainman.m_blockman.LookupBlockIndex(lookup.tip_hash))};
+        for (; pindex->nHeight > height; pindex = pindex->pprev) {
+            if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !(pindex->nStatus & BLOCK_HAVE_UNDO)) {
+                return util::Error{Untranslated(strprintf("Block data not available at height %d", pindex->nHeight))};
+            }
+            blocks.push_back(pindex);
+        }
+        lookup.height = pindex->nHeight;
+        lookup.tip_hash = pindex->GetBlockHash();
+    }
+
+    // Indexes in outpoints of each outpoint, and of the outpoints of each txid.
+    std::unordered_map<COutPoint, std::vector<size_t>, SaltedOutpointHasher> by_outpoint;
+    std::unordered_map<Txid, std::vector<size_t>, SaltedTxidHasher> by_txid;
+    for (size_t i{0}; i < outpoints.size(); ++i) {
+        by_outpoint[outpoints[i]].push_back(i);
+        by_txid[outpoints[i].hash].push_back(i);
+    }
+
+    std::vector<std::byte> block_data;
+    for (const CBlockIndex* pindex : blocks) {
+        if (chainman.m_interrupt) return util::Error{Untranslated("Shutting down")};
+        const FlatFilePos pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+        const FlatFilePos undo_pos{WITH_LOCK(cs_main, return pindex->GetUndoPos())};
+        std::optional<BlockView> block;
+        if (chainman.m_blockman.ReadRawBlock(block_data, pos)) {
+            try {
+                block.emplace(block_data);
+            } catch (const std::ios_base::failure&) {
+            }
+        }
+        if (!block || block->Transactions().empty()) {
+            return util::Error{Untranslated(strprintf("Failed to read block at height %d", pindex->nHeight))};
+        }
+        std::optional<CBlockUndo> block_undo;
+        // Undo the transactions in reverse order, as in DisconnectBlock.
+        const auto& txs{block->Transactions()};
+        for (size_t tx_index{txs.size()}; tx_index-- > 0;) {
+            const TxView& tx{txs[tx_index]};
+            if (const auto it{by_txid.find(tx.GetHash())}; it != by_txid.end()) {
+                for (const size_t i : it->second) lookup.coins[i].reset();
+            }
+            if (tx_index == 0) continue; // The coinbase spends nothing.
+            uint32_t input{0};
+            bool ok{true};
+            tx.ForEachInput([&](const COutPoint& prevout, std::span<const unsigned char>, uint32_t) {
+                const auto it{by_outpoint.find(prevout)};
+                const uint32_t j{input++};
+                if (it == by_outpoint.end() || !ok) return;
+                if (!block_undo) {
+                    block_undo.emplace();
+                    if (!chainman.m_blockman.ReadBlockUndo(*block_undo, undo_pos, pindex->pprev->GetBlockHash()) ||
+                        block_undo->vtxundo.size() + 1 != txs.size()) {
+                        ok = false;
+                        return;
+                    }
+                }
+                const CTxUndo& tx_undo{block_undo->vtxundo[tx_index - 1]};
+                if (j >= tx_undo.vprevout.size()) {
+                    ok = false;
+                    return;
+                }
+                for (const size_t i : it->second) lookup.coins[i] = tx_undo.vprevout[j];
+            });
+            if (!ok) return util::Error{Untranslated(strprintf("Failed to read undo data at height %d", pindex->nHeight))};
+        }
+    }
+    return lookup;
+}
+
+std::vector<std::byte> SerializeCoinsLookup(const CoinsLookup& lookup)
+{
+    std::vector<unsigned char> bitmap((lookup.coins.size() + 7) / 8);
+    for (size_t i{0}; i < lookup.coins.size(); ++i) {
+        if (lookup.coins[i]) bitmap[i / 8] |= 1 << (i % 8);
+    }
+    DataStream ss;
+    ss << lookup.height << lookup.tip_hash << bitmap;
+    WriteCompactSize(ss, lookup.coins.size() - std::count(lookup.coins.begin(), lookup.coins.end(), std::nullopt));
+    for (const auto& coin : lookup.coins) {
+        // The coin as in BIP64: a dummy transaction version, the height and the output
+        if (coin) ss << uint32_t{0} << uint32_t{coin->nHeight} << coin->out;
+    }
+    return {ss.begin(), ss.end()};
+}
 } // namespace node
@@ -5,10 +5,20 @@
 #ifndef BITCOIN_NODE_COIN_H
 #define BITCOIN_NODE_COIN_H
 
+#include <coins.h>
+#include <uint256.h>
+#include <util/result.h>
+
+#include <cstddef>
 #include <map>
+#include <optional>
+#include <span>
+#include <vector>
 
+class ChainstateManager;
 class COutPoint; // 输出点类
 class Coin;      // 硬币类
+class CTxMemPool;
 
 namespace node {
 struct NodeContext; // 节点上下文结构体
@@ -26,6 +36,44 @@ struct NodeContext; // 节点上下文结构体
  */
 void FindCoins(const node::NodeContext& node, std::map<COutPoint, Coin>& coins);
 
+/** Maximum number of outpoints of a LookupCoins() request from RPC or REST */
+static constexpr size_t MAX_COINS_LOOKUP{100'000};
+
+/** Result of LookupCoins() */
+struct CoinsLookup {
+    //! Height and hash of the tip the coins were looked up at.
+    int height{-1};
+    uint256 tip_hash;
+    //! For each looked up outpoint, its coin, or std::nullopt if unspent or unknown.
+    std::vector<std::optional<Coin>> coins;
+};
+
+/**
+ * Look up many outpoints in the current chain UTXO set at once: coins that are
+ * cached are served from the cache, the others are read in key order from a
+ * snapshot of the database taken at the same tip, after releasing cs_main. If
+ * `mempool` is given, coins created by mempool transactions are included and
+ * coins spent by them are not.
+ */
+CoinsLookup LookupCoins(ChainstateManager& chainman, const CTxMemPool* mempool, std::span<const COutPoint> outpoints);
+
+/**
+ * Look up many outpoints as they were in the UTXO set of the active chain
+ * right after the block at `height` was connected: they are looked up at the
+ * tip, then the blocks above `height` are undone on them, from the tip
+ * backwards, using their undo data. Each block is read without deserializing
+ * it, and its undo data is only read if it spends one of the outpoints, so the
+ * cost grows with the depth of `height`. Fails if the data of one of those
+ * blocks is not available, e.g. because it was pruned.
+ */
+util::Result<CoinsLookup> LookupCoinsAtHeight(ChainstateManager& chainman, std::span<const COutPoint> outpoints, int height);
+
+/**
+ * Serialize a lookup like a BIP64 getutxos response: the height and hash of the
+ * tip, a bitmap of the coins that were found, and those coins.
+ */
+std::vector<std::byte> SerializeCoinsLookup(const CoinsLookup& lookup);
+
 } // namespace node
 
 #endif // BITCOIN_NODE_COIN_H
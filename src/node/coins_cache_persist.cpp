@@ -0,0 +1,134 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/coins_cache_persist.h>
+
+#include <coins.h>
+#include <common/args.h>
+#include <hash.h>
+#include <logging.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <util/fs_helpers.h>
+#include <util/signalinterrupt.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace node {
+static constexpr uint64_t COINS_CACHE_DUMP_VERSION{1};
+//! Number of coins read from the database per cs_main hold when loading.
+static constexpr size_t COINS_CACHE_LOAD_BATCH{1000};
+
+bool ShouldPersistCoinsCache(const ArgsManager& argsman)
+{
+    return argsman.GetBoolArg("-persistcoinscache", DEFAULT_PERSIST_COINS_CACHE);
+}
+
+fs::path CoinsCachePath(const ArgsManager& argsman)
+{
+    return argsman.GetDataDirNet() / "coins_cache.dat";
+}
+
+bool DumpCoinsCache(Chainstate& chainstate, const fs::path& dump_path)
+{
+    const auto start{SteadyClock::now()};
+    std::vector<COutPoint> outpoints;
+    {
+        LOCK(::cs_main);
+        if (!chainstate.CanFlushToDisk()) return false;
+        outpoints = chainstate.CoinsTip().GetCachedOutpoints();
+    }
+    // In the order of the database keys, so that they are read sequentially on load.
+    std::sort(outpoints.begin(), outpoints.end());
+
+    const fs::path file_fspath{dump_path + ".new"};
+    AutoFile file{fsbridge::fopen(file_fspath, "wb")};
+    if (file.IsNull()) {
+        LogInfo("Failed to open %s for writing the coins cache. Continuing anyway.\n", fs::PathToString(file_fspath));
+        return false;
+    }
+    try {
+        HashedSourceWriter writer{file};
+        writer << COINS_CACHE_DUMP_VERSION << outpoints;
+        file << writer.GetHash();
+        if (!file.Commit()) {
+            (void)file.fclose();
+            throw std::runtime_error("Commit failed");
+        }
+        if (file.fclose() != 0) {
+            throw std::runtime_error("Close failed");
+        }
+        if (!RenameOver(file_fspath, dump_path)) {
+            throw std::runtime_error("Rename failed");
+        }
+    } catch (const std::exception& e) {
+        LogInfo("Failed to dump the coins cache: %s. Continuing anyway.\n", e.what());
+        (void)file.fclose();
+        return false;
+    }
+    LogInfo("Dumped %u coins cache outpoints in %.3fs\n", outpoints.size(), Ticks<SecondsDouble>(SteadyClock::now() - start));
+    return true;
+}
+
+bool LoadCoinsCache(Chainstate& chainstate, const fs::path& load_path, const util::SignalInterrupt& interrupt)
+{
+    const auto start{SteadyClock::now()};
+    AutoFile file{fsbridge::fopen(load_path, "rb")};
+    if (file.IsNull()) {
+        LogInfo("Failed to open coins cache file. Continuing anyway.\n");
+        return false;
+    }
+    std::vector<COutPoint> outpoints;
+    try {
+        HashVerifier verifier{file};
+        uint64_t version;
+        verifier >> version;
+        if (version != COINS_CACHE_DUMP_VERSION) {
+            throw std::runtime_error{"Unknown version"};
+        }
+        verifier >> outpoints;
+        uint256 checksum;
+        file >> checksum;
+        if (checksum != verifier.GetHash()) {
+            throw std::runtime_error{"Checksum mismatch, data corrupted"};
+        }
+    } catch (const std::exception& e) {
+        LogInfo("Failed to load the coins cache: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+
+    size_t loaded{0};
+    std::vector<COutPoint> lookups;
+    for (size_t begin{0}; begin < outpoints.size() && !interrupt; begin += COINS_CACHE_LOAD_BATCH) {
+        const auto batch{std::span{outpoints}.subspan(begin, std::min(COINS_CACHE_LOAD_BATCH, outpoints.size() - begin))};
+        // The coins are read and inserted under the same cs_main hold, so that
+        // they are the current version of the outpoints in the database.
+        LOCK(::cs_main);
+        if (!chainstate.CanFlushToDisk()) break;
+        CCoinsViewCache& tip{chainstate.CoinsTip()};
+        // Leave room for new blocks, so that loading does not cause a flush.
+        if (tip.DynamicMemoryUsage() >= chainstate.m_coinstip_cache_size_bytes / 10 * 9) break;
+        lookups.clear();
+        for (const COutPoint& outpoint : batch) {
+            if (!tip.HaveCoinInCache(outpoint)) lookups.push_back(outpoint);
+        }
+        auto coins{chainstate.CoinsErrorCatcher().GetCoins(lookups)};
+        for (size_t i{0}; i < lookups.size(); ++i) {
+            if (coins[i] && tip.AddFetchedCoin(lookups[i], std::move(*coins[i]))) ++loaded;
+        }
+    }
+    LogInfo("Loaded %u of %u coins cache outpoints in %.3fs\n", loaded, outpoints.size(), Ticks<SecondsDouble>(SteadyClock::now() - start));
+    return true;
+}
+} // namespace node
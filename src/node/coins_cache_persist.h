@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_COINS_CACHE_PERSIST_H
+#define BITCOIN_NODE_COINS_CACHE_PERSIST_H
+
+#include <kernel/cs_main.h>
+#include <sync.h>
+#include <util/fs.h>
+
+class ArgsManager;
+class Chainstate;
+namespace util {
+class SignalInterrupt;
+} // namespace util
+
+namespace node {
+
+/**
+ * Default for -persistcoinscache, indicating whether the node should save the
+ * outpoints of the coins in its coins cache on shutdown and load those coins
+ * back into the cache on start.
+ */
+static constexpr bool DEFAULT_PERSIST_COINS_CACHE{false};
+
+bool ShouldPersistCoinsCache(const ArgsManager& argsman);
+fs::path CoinsCachePath(const ArgsManager& argsman);
+
+/**
+ * Save the outpoints of the unspent coins in the coins cache of `chainstate`,
+ * in key order, to a file. Only the outpoints are saved: the coins themselves
+ * are in the database after the final flush.
+ */
+bool DumpCoinsCache(Chainstate& chainstate, const fs::path& dump_path) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+/**
+ * Read the coins of the outpoints of a file written by DumpCoinsCache() from
+ * the database into the coins cache of `chainstate`, in batches, releasing
+ * cs_main in between. Outpoints that are no longer unspent are skipped. Stops
+ * before the cache gets close to its configured size, or on interrupt.
+ */
+bool LoadCoinsCache(Chainstate& chainstate, const fs::path& load_path, const util::SignalInterrupt& interrupt) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+} // namespace node
+
+#endif // BITCOIN_NODE_COINS_CACHE_PERSIST_H
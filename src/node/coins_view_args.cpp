@@ -7,10 +7,15 @@
 #include <common/args.h>
 #include <txdb.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace node {
 void ReadCoinsViewArgs(const ArgsManager& args, CoinsViewOptions& options)
 {
     if (auto value = args.GetIntArg("-dbbatchsize")) options.batch_write_bytes = *value;
+    if (auto value = args.GetBoolArg("-dbasyncwrite")) options.async_batch_write = *value;
     if (auto value = args.GetIntArg("-dbcrashratio")) options.simulate_crash_ratio = *value;
+    if (auto value = args.GetIntArg("-dbmissingcache")) options.missing_cache_entries = std::max<int64_t>(*value, 0);
 }
 } // namespace node
@@ -134,6 +134,12 @@ struct NodeContext {
     //! 调度器 - 管理后台任务调度
     std::unique_ptr<CScheduler> scheduler;
 
+    //! Scheduler and threads delivering validation notifications to the queues
+    //! of subscribers with -validationcallbackthreads, if any.
+    //! 使用-validationcallbackthreads时，向订阅者队列传递验证通知的调度器及其线程。
+    std::unique_ptr<CScheduler> validation_scheduler;
+    std::vector<std::thread> validation_scheduler_threads;
+
     //! RPC中断点函数 - 用于RPC调用的中断检查
     std::function<void()> rpc_interruption_point = [] {};
 
@@ -238,3 +238,188 @@ void ProtectEvictionCandidatesByRatio(std::vector<NodeEvictionCandidate>& evicti
     // Disconnect from the network group with the most connections
     return vEvictionCandidates.front().id;
 }
+
+bool EvictionCandidates::RankCompare::operator()(const Entry* a, const Entry* b) const
+{
+    if (comparator(b->candidate, a->candidate)) return true;
+    if (comparator(a->candidate, b->candidate)) return false;
+    return a->candidate.id < b->candidate.id;
+}
+
+EvictionCandidates::EvictionCandidates()
+    : m_by_netgroup{RankCompare{CompareNetGroupKeyed}},
+      m_by_ping{RankCompare{ReverseCompareNodeMinPingTime}},
+      m_by_tx_time{RankCompare{CompareNodeTXTime}},
+      m_by_block_relay_only_time{RankCompare{CompareNodeBlockRelayOnlyTime}},
+      m_by_block_time{RankCompare{CompareNodeBlockTime}},
+      m_by_uptime{RankCompare{ReverseCompareNodeTimeConnected}},
+      m_network_by_uptime{Ranking{RankCompare{ReverseCompareNodeTimeConnected}}, Ranking{RankCompare{ReverseCompareNodeTimeConnected}},
+                          Ranking{RankCompare{ReverseCompareNodeTimeConnected}}, Ranking{RankCompare{ReverseCompareNodeTimeConnected}}}
+{
+}
+
+void EvictionCandidates::Insert(const Entry& entry)
+{
+    m_by_netgroup.insert(&entry);
+    m_by_ping.insert(&entry);
+    m_by_tx_time.insert(&entry);
+    m_by_block_relay_only_time.insert(&entry);
+    m_by_block_time.insert(&entry);
+    m_by_uptime.insert(&entry);
+    for (size_t i{0}; i < NETWORKS.size(); ++i) {
+        if (NETWORKS[i].Contains(entry.candidate)) m_network_by_uptime[i].insert(&entry);
+    }
+}
+
+void EvictionCandidates::Erase(const Entry& entry)
+{
+    m_by_netgroup.erase(&entry);
+    m_by_ping.erase(&entry);
+    m_by_tx_time.erase(&entry);
+    m_by_block_relay_only_time.erase(&entry);
+    m_by_block_time.erase(&entry);
+    m_by_uptime.erase(&entry);
+    for (size_t i{0}; i < NETWORKS.size(); ++i) {
+        if (NETWORKS[i].Contains(entry.candidate)) m_network_by_uptime[i].erase(&entry);
+    }
+}
+
+void EvictionCandidates::AddOrUpdate(const NodeEvictionCandidate& candidate)
+{
+    // Same as ProtectNoBanConnections() and ProtectOutboundConnections().
+    if (candidate.m_noban || candidate.m_conn_type != ConnectionType::INBOUND) {
+        Remove(candidate.id);
+        return;
+    }
+    auto [it, inserted]{m_entries.try_emplace(candidate.id, Entry{candidate})};
+    if (!inserted) {
+        if (it->second.candidate == candidate) return;
+        Erase(it->second);
+        it->second.candidate = candidate;
+    }
+    Insert(it->second);
+}
+
+void EvictionCandidates::Remove(NodeId id)
+{
+    const auto it{m_entries.find(id)};
+    if (it == m_entries.end()) return;
+    Erase(it->second);
+    m_entries.erase(it);
+}
+
+void EvictionCandidates::Clear()
+{
+    m_by_netgroup.clear();
+    m_by_ping.clear();
+    m_by_tx_time.clear();
+    m_by_block_relay_only_time.clear();
+    m_by_block_time.clear();
+    m_by_uptime.clear();
+    for (Ranking& ranking : m_network_by_uptime) ranking.clear();
+    m_entries.clear();
+}
+
+std::optional<NodeId> EvictionCandidates::SelectNodeToEvict()
+{
+    // Equivalent of EraseLastKElements(): protect the candidates among the k most protected
+    // unprotected ones in `ranking` for which `predicate` is true.
+    const auto protect = [&](const Ranking& ranking, size_t k, auto predicate) {
+        for (auto it{ranking.begin()}; k > 0 && it != ranking.end(); ++it) {
+            const Entry* entry{*it};
+            if (entry->is_protected) continue;
+            --k;
+            if (predicate(entry->candidate)) {
+                entry->is_protected = true;
+                m_protected.push_back(entry);
+            }
+        }
+    };
+    const auto any = [](const NodeEvictionCandidate&) { return true; };
+
+    protect(m_by_netgroup, 4, any);
+    protect(m_by_ping, 8, any);
+    protect(m_by_tx_time, 4, any);
+    protect(m_by_block_relay_only_time, 8, [](const NodeEvictionCandidate& n) { return !n.m_relay_txs && n.fRelevantServices; });
+    protect(m_by_block_time, 4, any);
+
+    // ProtectEvictionCandidatesByRatio(), with the counts of unprotected candidates per
+    // disadvantaged network derived from the (few) candidates protected so far.
+    const size_t initial_size{m_entries.size() - m_protected.size()};
+    const size_t total_protect_size{initial_size / 2};
+    struct Net { size_t index; size_t count; };
+    std::array<Net, NETWORKS.size()> networks;
+    for (size_t i{0}; i < NETWORKS.size(); ++i) {
+        networks[i] = {i, m_network_by_uptime[i].size()};
+        for (const Entry* entry : m_protected) {
+            if (NETWORKS[i].Contains(entry->candidate)) --networks[i].count;
+        }
+    }
+    std::stable_sort(networks.begin(), networks.end(), [](Net a, Net b) { return a.count < b.count; });
+
+    const size_t max_protect_by_network{total_protect_size / 2};
+    size_t num_protected{0};
+    while (num_protected < max_protect_by_network) {
+        auto num_networks = std::count_if(networks.begin(), networks.end(), [](const Net& n) { return n.count; });
+        if (num_networks == 0) {
+            break;
+        }
+        const size_t disadvantaged_to_protect{max_protect_by_network - num_protected};
+        const size_t protect_per_network{std::max(disadvantaged_to_protect / num_networks, static_cast<size_t>(1))};
+        bool protected_at_least_one{false};
+
+        for (Net& n : networks) {
+            if (n.count == 0) continue;
+            const size_t before{m_protected.size()};
+            protect(m_network_by_uptime[n.index], protect_per_network, any);
+            const size_t delta{m_protected.size() - before};
+            if (delta > 0) {
+                protected_at_least_one = true;
+                num_protected += delta;
+                if (num_protected >= max_protect_by_network) {
+                    break;
+                }
+                n.count -= delta;
+            }
+        }
+        if (!protected_at_least_one) {
+            break;
+        }
+    }
+    protect(m_by_uptime, total_protect_size - num_protected, any);
+
+    // Visit the remaining candidates from the most recently connected one, as
+    // SelectNodeToEvict() does after ProtectEvictionCandidatesByRatio().
+    const auto remaining = [&](auto visit) {
+        for (auto it{m_by_uptime.rbegin()}; it != m_by_uptime.rend(); ++it) {
+            if (!(*it)->is_protected) visit((*it)->candidate);
+        }
+    };
+    bool any_prefer_evict{false};
+    remaining([&](const NodeEvictionCandidate& n) { any_prefer_evict |= n.prefer_evict; });
+
+    // Identify the network group with the most connections and youngest member, and
+    // pick that youngest member.
+    struct Group { unsigned int count{0}; std::chrono::seconds time{0}; NodeId youngest{0}; };
+    std::unordered_map<uint64_t, Group> groups;
+    std::optional<NodeId> result;
+    unsigned int most_connections{0};
+    std::chrono::seconds most_connections_time{0};
+    remaining([&](const NodeEvictionCandidate& n) {
+        if (any_prefer_evict && !n.prefer_evict) return;
+        Group& group{groups[n.nKeyedNetGroup]};
+        if (group.count++ == 0) {
+            group.time = n.m_connected;
+            group.youngest = n.id;
+        }
+        if (group.count > most_connections || (group.count == most_connections && group.time > most_connections_time)) {
+            most_connections = group.count;
+            most_connections_time = group.time;
+            result = group.youngest;
+        }
+    });
+
+    for (const Entry* entry : m_protected) entry->is_protected = false;
+    m_protected.clear();
+    return result;
+}
@@ -8,9 +8,12 @@
 #include <node/connection_types.h>
 #include <net_permissions.h>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <optional>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 typedef int64_t NodeId; // 节点ID类型定义
@@ -34,6 +37,8 @@ struct NodeEvictionCandidate {
     Network m_network;                            // 网络类型
     bool m_noban;                                 // 是否禁止封禁
     ConnectionType m_conn_type;                   // 连接类型
+
+    bool operator==(const NodeEvictionCandidate&) const = default;
 };
 
 /**
@@ -94,4 +99,70 @@ struct NodeEvictionCandidate {
  */
 void ProtectEvictionCandidatesByRatio(std::vector<NodeEvictionCandidate>& vEvictionCandidates);
 
+/**
+ * Eviction candidates with their protection rankings (by netgroup, ping time,
+ * tx and block times, uptime and disadvantaged network) kept up to date on
+ * every change, so that selecting a peer to evict needs no sorting.
+ *
+ * The selection follows SelectNodeToEvict(): the fixed-size protection passes
+ * only visit the top of their ranking, and the remaining passes are linear in
+ * the number of candidates. Ties within a ranking are broken by id.
+ *
+ * Only inbound peers without the noban permission are kept, as the others are
+ * never evicted. Not thread-safe.
+ */
+class EvictionCandidates
+{
+public:
+    EvictionCandidates();
+    EvictionCandidates(const EvictionCandidates&) = delete;
+    EvictionCandidates& operator=(const EvictionCandidates&) = delete;
+
+    /** Add a candidate, or update the one with the same id. O(log n), and O(1) if nothing changed. */
+    void AddOrUpdate(const NodeEvictionCandidate& candidate);
+    /** Remove the candidate with the given id, if any. O(log n). */
+    void Remove(NodeId id);
+    void Clear();
+    size_t Size() const { return m_entries.size(); }
+
+    /** Same as SelectNodeToEvict() on all candidates. */
+    [[nodiscard]] std::optional<NodeId> SelectNodeToEvict();
+
+private:
+    struct Entry {
+        NodeEvictionCandidate candidate;
+        //! Scratch space of SelectNodeToEvict(), false outside of it.
+        mutable bool is_protected{false};
+    };
+    using Comparator = bool (*)(const NodeEvictionCandidate&, const NodeEvictionCandidate&);
+    /** Orders entries by decreasing protection under a comparator of eviction.cpp (the most protected first), then by id. */
+    struct RankCompare {
+        Comparator comparator;
+        bool operator()(const Entry* a, const Entry* b) const;
+    };
+    using Ranking = std::set<const Entry*, RankCompare>;
+    //! Disadvantaged networks of ProtectEvictionCandidatesByRatio().
+    struct DisadvantagedNetwork {
+        bool is_local;
+        Network id;
+        bool Contains(const NodeEvictionCandidate& c) const { return is_local ? c.m_is_local : c.m_network == id; }
+    };
+    static constexpr std::array<DisadvantagedNetwork, 4> NETWORKS{{{false, NET_CJDNS}, {false, NET_I2P}, {/*localhost=*/true, NET_MAX}, {false, NET_ONION}}};
+
+    void Insert(const Entry& entry);
+    void Erase(const Entry& entry);
+
+    std::unordered_map<NodeId, Entry> m_entries;
+    Ranking m_by_netgroup;
+    Ranking m_by_ping;
+    Ranking m_by_tx_time;
+    Ranking m_by_block_relay_only_time;
+    Ranking m_by_block_time;
+    Ranking m_by_uptime;
+    //! Members of NETWORKS, by uptime.
+    std::array<Ranking, NETWORKS.size()> m_network_by_uptime;
+    //! Protected entries, to reset them after a selection.
+    std::vector<const Entry*> m_protected;
+};
+
 #endif // BITCOIN_NODE_EVICTION_H
@@ -49,6 +49,7 @@
 #include <rpc/blockchain.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <streams.h>
 #include <support/allocators/secure.h>
 #include <sync.h>
 #include <txmempool.h>
@@ -56,6 +57,7 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/result.h>
+#include <util/shm.h>
 #include <util/signalinterrupt.h>
 #include <util/string.h>
 #include <util/translation.h>
@@ -477,6 +479,7 @@ public:
     void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override {
         m_notifications->chainStateFlushed(role, locator);
     }
+    std::string SubscriberName() const override { return "wallet"; }
     std::shared_ptr<Chain::Notifications> m_notifications;
 };
 
@@ -545,13 +548,12 @@ public:
     explicit ChainImpl(NodeContext& node) : m_node(node) {}
     std::optional<int> getHeight() override
     {
-        const int height{WITH_LOCK(::cs_main, return chainman().ActiveChain().Height())};
+        const int height{chainman().ActiveChainView()->Height()};
         return height >= 0 ? std::optional{height} : std::nullopt;
     }
     uint256 getBlockHash(int height) override
     {
-        LOCK(::cs_main);
-        return Assert(chainman().ActiveChain()[height])->GetBlockHash();
+        return Assert((*chainman().ActiveChainView())[height])->GetBlockHash();
     }
     bool haveBlockOnDisk(int height) override
     {
@@ -561,8 +563,7 @@ public:
     }
     CBlockLocator getTipLocator() override
     {
-        LOCK(::cs_main);
-        return chainman().ActiveChain().GetLocator();
+        return GetLocator(chainman().ActiveChainView()->Tip());
     }
     CBlockLocator getActiveChainLocator(const uint256& block_hash) override
     {
@@ -874,9 +875,11 @@ class BlockTemplateImpl : public BlockTemplate
 public:
     explicit BlockTemplateImpl(BlockAssembler::Options assemble_options,
                                std::unique_ptr<CBlockTemplate> block_template,
-                               NodeContext& node) : m_assemble_options(std::move(assemble_options)),
-                                                    m_block_template(std::move(block_template)),
-                                                    m_node(node)
+                               NodeContext& node,
+                               std::vector<CTransactionRef> previous_txs = {}) : m_assemble_options(std::move(assemble_options)),
+                                                                                 m_block_template(std::move(block_template)),
+                                                                                 m_previous_txs(std::move(previous_txs)),
+                                                                                 m_node(node)
     {
         assert(m_block_template);
     }
@@ -891,6 +894,22 @@ public:
         return m_block_template->block;
     }
 
+    std::optional<SharedMemoryRef> getBlockSharedMemory() override
+    {
+#ifndef WIN32
+        LOCK(m_block_shm_mutex);
+        if (!m_block_shm) {
+            DataStream block;
+            block << TX_WITH_WITNESS(m_block_template->block);
+            m_block_shm = SharedMemory::Create(block);
+            if (!m_block_shm) return std::nullopt;
+        }
+        return SharedMemoryRef{.name = m_block_shm->Name(), .size = m_block_shm->Data().size()};
+#else
+        return std::nullopt;
+#endif
+    }
+
     std::vector<CAmount> getTxFees() override
     {
         return m_block_template->vTxFees;
@@ -918,26 +937,45 @@ public:
 
     std::vector<uint256> getCoinbaseMerklePath() override
     {
-        return TransactionMerklePath(m_block_template->block, 0);
+        return m_block_template->m_coinbase_merkle_path;
     }
 
     bool submitSolution(uint32_t version, uint32_t timestamp, uint32_t nonce, CTransactionRef coinbase) override
     {
-        AddMerkleRootAndCoinbase(m_block_template->block, std::move(coinbase), version, timestamp, nonce);
+        AddMerkleRootAndCoinbase(m_block_template->block, std::move(coinbase), version, timestamp, nonce, m_block_template->m_coinbase_merkle_path);
+#ifndef WIN32
+        // The block changed, so the segment is stale.
+        WITH_LOCK(m_block_shm_mutex, m_block_shm.reset());
+#endif
         return chainman().ProcessNewBlock(std::make_shared<const CBlock>(m_block_template->block), /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr);
     }
 
     std::unique_ptr<BlockTemplate> waitNext(BlockWaitOptions options) override
     {
         auto new_template = WaitAndCreateNewBlock(chainman(), notifications(), m_node.mempool.get(), m_block_template, options, m_assemble_options);
-        if (new_template) return std::make_unique<BlockTemplateImpl>(m_assemble_options, std::move(new_template), m_node);
+        if (new_template) return std::make_unique<BlockTemplateImpl>(m_assemble_options, std::move(new_template), m_node, m_block_template->block.vtx);
         return nullptr;
     }
 
+    std::optional<BlockTemplateDiff> getDiff() override
+    {
+        if (m_previous_txs.empty()) return std::nullopt;
+        return DiffBlockTemplates(m_previous_txs, m_block_template->block);
+    }
+
     const BlockAssembler::Options m_assemble_options;
 
     const std::unique_ptr<CBlockTemplate> m_block_template;
 
+    //! Transactions of the template waitNext() was called on, if any.
+    const std::vector<CTransactionRef> m_previous_txs;
+
+#ifndef WIN32
+    Mutex m_block_shm_mutex;
+    //! Serialized block, created by the first getBlockSharedMemory() call.
+    std::optional<SharedMemory> m_block_shm GUARDED_BY(m_block_shm_mutex);
+#endif
+
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     KernelNotifications& notifications() { return *Assert(m_node.notifications); }
     NodeContext& m_node;
@@ -975,7 +1013,8 @@ public:
 
         BlockAssembler::Options assemble_options{options};
         ApplyArgsManOptions(*Assert(m_node.args), assemble_options);
-        return std::make_unique<BlockTemplateImpl>(assemble_options, BlockAssembler{chainman().ActiveChainstate(), context()->mempool.get(), assemble_options}.CreateNewBlock(), m_node);
+        const std::chrono::seconds max_age{Assert(m_node.args)->GetIntArg("-blocktemplatemaxage", DEFAULT_BLOCK_TEMPLATE_MAX_AGE)};
+        return std::make_unique<BlockTemplateImpl>(assemble_options, m_template_cache.CreateNewBlock(chainman().ActiveChainstate(), context()->mempool.get(), assemble_options, max_age), m_node);
     }
 
     bool checkBlock(const CBlock& block, const node::BlockCheckOptions& options, std::string& reason, std::string& debug) override
@@ -991,6 +1030,7 @@ public:
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     KernelNotifications& notifications() { return *Assert(m_node.notifications); }
     NodeContext& m_node;
+    BlockTemplateCache m_template_cache;
 };
 } // namespace
 } // namespace node
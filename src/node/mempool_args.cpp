@@ -18,6 +18,7 @@
 #include <util/moneystr.h>
 #include <util/translation.h>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 
@@ -55,6 +56,8 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& argsman, const CChainP
 
     if (auto hours = argsman.GetIntArg("-mempoolexpiry")) mempool_opts.expiry = std::chrono::hours{*hours};
 
+    if (auto size = argsman.GetIntArg("-mempoollogsize")) mempool_opts.log_size = std::max<int64_t>(*size, 0);
+
     // incremental relay fee sets the minimum feerate increase necessary for replacement in the mempool
     // and the amount the mempool min fee increases above the feerate of txs evicted due to mempool limiting.
     if (const auto arg{argsman.GetArg("-incrementalrelayfee")}) {
@@ -103,6 +106,8 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& argsman, const CChainP
 
     mempool_opts.persist_v1_dat = argsman.GetBoolArg("-persistmempoolv1", mempool_opts.persist_v1_dat);
 
+    mempool_opts.batch_trim = argsman.GetBoolArg("-mempoolbatchtrim", mempool_opts.batch_trim);
+
     ApplyArgsManOptions(argsman, mempool_opts.limits);
 
     return {};
@@ -29,6 +29,7 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -39,6 +40,11 @@ namespace node {
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
 
+//! Transactions read ahead while loading, so their inputs are prefetched together.
+static constexpr size_t MEMPOOL_LOAD_BATCH_SIZE{1000};
+//! Size of the buffers mempool.dat is read and written through.
+static constexpr size_t MEMPOOL_FILE_BUFFER_SIZE{1 << 20};
+
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
     if (load_path.empty()) return false;
@@ -68,59 +74,70 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             return false;
         }
         file.SetXor(xor_key);
+        // Transactions are made of many small fields, read them in larger chunks.
+        BufferedReader reader{std::move(file), MEMPOOL_FILE_BUFFER_SIZE};
         uint64_t total_txns_to_load;
-        file >> total_txns_to_load;
+        reader >> total_txns_to_load;
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
         int next_tenth_to_report = 0;
+        std::vector<std::tuple<CTransactionRef, int64_t, int64_t>> batch;
+        std::vector<CTransactionRef> to_prefetch;
         while (txns_tried < total_txns_to_load) {
-            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
-            if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
-                next_tenth_to_report = percentage_done / 10;
-            }
-            ++txns_tried;
-
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> TX_WITH_WITNESS(tx);
-            file >> nTime;
-            file >> nFeeDelta;
-
-            if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+            batch.clear();
+            to_prefetch.clear();
+            while (batch.size() < MEMPOOL_LOAD_BATCH_SIZE && txns_tried + batch.size() < total_txns_to_load) {
+                auto& [tx, nTime, nFeeDelta] = batch.emplace_back();
+                reader >> TX_WITH_WITNESS(tx);
+                reader >> nTime;
+                reader >> nFeeDelta;
+                if (opts.use_current_time) {
+                    nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                }
+                if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) to_prefetch.push_back(tx);
             }
+            // Look up the coins spent by the batch on the prefetch threads, if
+            // any, instead of one by one during acceptance.
+            WITH_LOCK(cs_main, active_chainstate.PrefetchInputs(to_prefetch));
+
+            for (const auto& [tx, nTime, nFeeDelta] : batch) {
+                const int percentage_done(100.0 * txns_tried / total_txns_to_load);
+                if (next_tenth_to_report < percentage_done / 10) {
+                    LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
+                            percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                    next_tenth_to_report = percentage_done / 10;
+                }
+                ++txns_tried;
 
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
-            }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
-                LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
-                if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
-                    ++count;
-                } else {
-                    // mempool may contain the transaction already, e.g. from
-                    // wallet(s) having loaded it while we were processing
-                    // mempool transactions; consider these as valid, instead of
-                    // failed, but mark them as 'already there'
-                    if (pool.exists(tx->GetHash())) {
-                        ++already_there;
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta && opts.apply_fee_delta_priority) {
+                    pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+                    LOCK(cs_main);
+                    const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+                    if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
+                        ++count;
                     } else {
-                        ++failed;
+                        // mempool may contain the transaction already, e.g. from
+                        // wallet(s) having loaded it while we were processing
+                        // mempool transactions; consider these as valid, instead of
+                        // failed, but mark them as 'already there'
+                        if (pool.exists(tx->GetHash())) {
+                            ++already_there;
+                        } else {
+                            ++failed;
+                        }
                     }
+                } else {
+                    ++expired;
                 }
-            } else {
-                ++expired;
+                if (active_chainstate.m_chainman.m_interrupt)
+                    return false;
             }
-            if (active_chainstate.m_chainman.m_interrupt)
-                return false;
         }
         std::map<uint256, CAmount> mapDeltas;
-        file >> mapDeltas;
+        reader >> mapDeltas;
 
         if (opts.apply_fee_delta_priority) {
             for (const auto& i : mapDeltas) {
@@ -129,7 +146,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         }
 
         std::set<uint256> unbroadcast_txids;
-        file >> unbroadcast_txids;
+        reader >> unbroadcast_txids;
         if (opts.apply_unbroadcast_set) {
             unbroadcast = unbroadcast_txids.size();
             for (const auto& txid : unbroadcast_txids) {
@@ -186,20 +203,26 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
         }
         file.SetXor(xor_key);
 
-        uint64_t mempool_transactions_to_write(vinfo.size());
-        file << mempool_transactions_to_write;
-        LogInfo("Writing %u mempool transactions to file...\n", mempool_transactions_to_write);
-        for (const auto& i : vinfo) {
-            file << TX_WITH_WITNESS(*(i.tx));
-            file << int64_t{count_seconds(i.m_time)};
-            file << int64_t{i.nFeeDelta};
-            mapDeltas.erase(i.tx->GetHash());
-        }
+        {
+            // Stream the records through a buffer instead of handing every
+            // field of every transaction to the file separately.
+            BufferedWriter writer{file, MEMPOOL_FILE_BUFFER_SIZE};
+            uint64_t mempool_transactions_to_write(vinfo.size());
+            writer << mempool_transactions_to_write;
+            LogInfo("Writing %u mempool transactions to file...\n", mempool_transactions_to_write);
+            for (const auto& i : vinfo) {
+                writer << TX_WITH_WITNESS(*(i.tx));
+                writer << int64_t{count_seconds(i.m_time)};
+                writer << int64_t{i.nFeeDelta};
+                mapDeltas.erase(i.tx->GetHash());
+            }
 
-        file << mapDeltas;
+            writer << mapDeltas;
 
-        LogInfo("Writing %d unbroadcast transactions to file.\n", unbroadcast_txids.size());
-        file << unbroadcast_txids;
+            LogInfo("Writing %d unbroadcast transactions to file.\n", unbroadcast_txids.size());
+            writer << unbroadcast_txids;
+            writer.flush();
+        }
 
         if (!skip_file_commit && !file.Commit()) {
             (void)file.fclose();
@@ -22,12 +22,15 @@
 #include <policy/policy.h>
 #include <pow.h>
 #include <primitives/transaction.h>
+#include <util/hasher.h>
 #include <util/moneystr.h>
 #include <util/signalinterrupt.h>
 #include <util/time.h>
 #include <validation.h>
 
 #include <algorithm>
+#include <cassert>
+#include <unordered_map>
 #include <utility>
 
 namespace node {
@@ -170,6 +173,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock()
     coinbaseTx.nLockTime = static_cast<uint32_t>(nHeight - 1);
     pblock->vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
     pblocktemplate->vchCoinbaseCommitment = m_chainstate.m_chainman.GenerateCoinbaseCommitment(*pblock, pindexPrev);
+    pblocktemplate->m_coinbase_merkle_path = TransactionMerklePath(*pblock, 0);
 
     LogPrintf("CreateNewBlock(): block weight: %u txs: %u fees: %ld sigops %d\n", GetBlockWeight(*pblock), nBlockTx, nFees, nBlockSigOpsCost);
 
@@ -441,7 +445,53 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     }
 }
 
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce)
+static bool SameOptions(const BlockAssembler::Options& a, const BlockAssembler::Options& b)
+{
+    return a.use_mempool == b.use_mempool &&
+           a.block_reserved_weight == b.block_reserved_weight &&
+           a.coinbase_output_max_additional_sigops == b.coinbase_output_max_additional_sigops &&
+           a.coinbase_output_script == b.coinbase_output_script &&
+           a.nBlockMaxWeight == b.nBlockMaxWeight &&
+           a.blockMinFeeRate == b.blockMinFeeRate &&
+           a.test_block_validity == b.test_block_validity &&
+           a.print_modified_fee == b.print_modified_fee;
+}
+
+bool BlockTemplateCache::CanReuse(const Entry& entry, const CBlockIndex& tip, const CTxMemPool* mempool, const BlockAssembler::Options& options,
+                                  std::chrono::seconds max_age)
+{
+    if (entry.block_template.block.hashPrevBlock != tip.GetBlockHash()) return false;
+    if (mempool != entry.mempool || !SameOptions(options, entry.options)) return false;
+    if (!mempool) return true;
+    if (mempool->GetTransactionsUpdated() != entry.mempool_updates && SteadyClock::now() - entry.created >= max_age) return false;
+    // Transactions may have been replaced or evicted.
+    const auto& vtx{entry.block_template.block.vtx};
+    return std::all_of(vtx.begin() + 1, vtx.end(), [&](const CTransactionRef& tx) { return mempool->exists(tx->GetHash()); });
+}
+
+std::unique_ptr<CBlockTemplate> BlockTemplateCache::CreateNewBlock(Chainstate& chainstate, const CTxMemPool* mempool, const BlockAssembler::Options& options,
+                                                                   std::chrono::seconds max_age)
+{
+    if (!options.use_mempool) mempool = nullptr;
+    LOCK(::cs_main);
+    const CBlockIndex* tip{Assert(chainstate.m_chain.Tip())};
+    if (const auto entry{WITH_LOCK(m_mutex, return m_entry)}; entry && CanReuse(*entry, *tip, mempool, options, max_age)) {
+        auto block_template{std::make_unique<CBlockTemplate>(entry->block_template)};
+        UpdateTime(&block_template->block, chainstate.m_chainman.GetConsensus(), tip);
+        return block_template;
+    }
+
+    // Read before assembling, so that changes while it runs cause a new
+    // template for the next request.
+    const auto created{SteadyClock::now()};
+    const unsigned int mempool_updates{mempool ? mempool->GetTransactionsUpdated() : 0};
+    auto block_template{BlockAssembler{chainstate, mempool, options}.CreateNewBlock()};
+    auto entry{std::make_shared<const Entry>(*block_template, options, mempool, mempool_updates, created)};
+    WITH_LOCK(m_mutex, m_entry = std::move(entry));
+    return block_template;
+}
+
+void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce, std::span<const uint256> coinbase_merkle_path)
 {
     if (block.vtx.size() == 0) {
         block.vtx.emplace_back(coinbase);
@@ -451,7 +501,35 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
     block.nVersion = version;
     block.nTime = timestamp;
     block.nNonce = nonce;
-    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.hashMerkleRoot = ComputeMerkleRootFromPath(block.vtx[0]->GetHash(), coinbase_merkle_path, 0);
+}
+
+BlockTemplateDiff DiffBlockTemplates(const std::vector<CTransactionRef>& previous, const CBlock& block)
+{
+    assert(!previous.empty() && !block.vtx.empty());
+    BlockTemplateDiff diff;
+    std::unordered_map<Txid, uint32_t, SaltedTxidHasher> previous_positions;
+    previous_positions.reserve(previous.size() - 1);
+    for (size_t i{1}; i < previous.size(); ++i) {
+        previous_positions.emplace(previous[i]->GetHash(), i - 1);
+    }
+    std::vector<bool> kept(previous.size() - 1);
+    diff.order.reserve(block.vtx.size() - 1);
+    for (size_t i{1}; i < block.vtx.size(); ++i) {
+        const auto it{previous_positions.find(block.vtx[i]->GetHash())};
+        if (it == previous_positions.end()) {
+            diff.order.push_back(-1);
+            diff.added.push_back(block.vtx[i]);
+        } else {
+            diff.order.push_back(it->second);
+            kept[it->second] = true;
+        }
+    }
+    for (uint32_t pos{0}; pos < kept.size(); ++pos) {
+        if (!kept[pos]) diff.removed.push_back(pos);
+    }
+    diff.coinbase_value_change = block.vtx[0]->GetValueOut() - previous[0]->GetValueOut();
+    return diff;
 }
 
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
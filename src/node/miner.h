@@ -10,12 +10,18 @@
 #include <node/types.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
+#include <sync.h>
 #include <txmempool.h>
+#include <uint256.h>
 #include <util/feefrac.h>
+#include <util/time.h>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/indexed_by.hpp>
@@ -47,6 +53,8 @@ struct CBlockTemplate
     // Sigops per transaction, not including coinbase transaction (unlike CBlock::vtx).
     std::vector<int64_t> vTxSigOpsCost;
     std::vector<unsigned char> vchCoinbaseCommitment;
+    // Merkle path to the coinbase transaction, which does not depend on the coinbase itself.
+    std::vector<uint256> m_coinbase_merkle_path;
     /* A vector of package fee rates, ordered by the sequence in which
      * packages are selected for inclusion in the block template.*/
     std::vector<FeeFrac> m_package_feerates;
@@ -220,6 +228,45 @@ private:
     void SortForBlock(const CTxMemPool::setEntries& package, std::vector<CTxMemPool::txiter>& sortedEntries);
 };
 
+/** Default for -blocktemplatemaxage, in seconds. */
+static constexpr int64_t DEFAULT_BLOCK_TEMPLATE_MAX_AGE{0};
+
+/**
+ * Keeps the last template built by BlockAssembler, so that repeated requests
+ * with the same options are served by copying it instead of selecting
+ * transactions from the whole mempool again.
+ *
+ * The cached template is reused while the tip is unchanged and all of its
+ * transactions are still in the mempool, if the mempool has not changed
+ * since it was built or it is younger than the given maximum age. In the
+ * latter case transactions that arrived since are left out until a new
+ * template is built, like getblocktemplate does for five seconds.
+ */
+class BlockTemplateCache
+{
+public:
+    /** Return a copy of the cached template with an updated time, or a new one. */
+    std::unique_ptr<CBlockTemplate> CreateNewBlock(Chainstate& chainstate, const CTxMemPool* mempool, const BlockAssembler::Options& options,
+                                                   std::chrono::seconds max_age) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        CBlockTemplate block_template;
+        BlockAssembler::Options options;
+        const CTxMemPool* mempool;
+        //! CTxMemPool::GetTransactionsUpdated() before the template was built.
+        unsigned int mempool_updates;
+        SteadyClock::time_point created;
+    };
+
+    static bool CanReuse(const Entry& entry, const CBlockIndex& tip, const CTxMemPool* mempool, const BlockAssembler::Options& options,
+                         std::chrono::seconds max_age);
+
+    //! Only held to swap the entry, so callers may hold any other lock.
+    Mutex m_mutex;
+    std::shared_ptr<const Entry> m_entry GUARDED_BY(m_mutex);
+};
+
 /**
  * Get the minimum time a miner should use in the next block. This always
  * accounts for the BIP94 timewarp rule, so does not necessarily reflect the
@@ -235,8 +282,14 @@ void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 /** Apply -blockmintxfee and -blockmaxweight options from ArgsManager to BlockAssembler options. */
 void ApplyArgsManOptions(const ArgsManager& gArgs, BlockAssembler::Options& options);
 
-/* Compute the block's merkle root, insert or replace the coinbase transaction and the merkle root into the block */
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce);
+/* Insert or replace the coinbase transaction into the block, and compute its merkle root from the merkle path to the coinbase */
+void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce, std::span<const uint256> coinbase_merkle_path);
+
+/**
+ * Compute the changes from the transactions of a previous template, coinbase
+ * included, to block.
+ */
+BlockTemplateDiff DiffBlockTemplates(const std::vector<CTransactionRef>& previous, const CBlock& block);
 
 /**
  * Return a new block template when fees rise to a certain threshold or after a
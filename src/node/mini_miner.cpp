@@ -249,13 +249,15 @@ void MiniMiner::BuildMockTemplate(std::optional<CFeeRate> target_feerate)
 {
     const auto num_txns{m_entries_by_txid.size()};
     uint32_t sequence_num{0};
+    // The entries ordered by ancestor feerate. Only the descendants of the transactions selected at
+    // each iteration have their ancestor feerate changed, so only these are reinserted, instead of
+    // sorting all entries again.
+    std::set<MockEntryMap::iterator, AncestorFeerateComparator> by_feerate(m_entries.begin(), m_entries.end());
     while (!m_entries_by_txid.empty()) {
-        // Sort again, since transaction removal may change some m_entries' ancestor feerates.
-        std::sort(m_entries.begin(), m_entries.end(), AncestorFeerateComparator());
-
         // Pick highest ancestor feerate entry.
-        auto best_iter = m_entries.begin();
-        Assume(best_iter != m_entries.end());
+        Assume(by_feerate.size() == m_entries.size());
+        auto best_iter = by_feerate.begin();
+        Assume(best_iter != by_feerate.end());
         const auto ancestor_package_size = (*best_iter)->second.GetSizeWithAncestors();
         const auto ancestor_package_fee = (*best_iter)->second.GetModFeesWithAncestors();
         // Stop here. Everything that didn't "make it into the block" has bumpfee.
@@ -288,7 +290,17 @@ void MiniMiner::BuildMockTemplate(std::optional<CFeeRate> target_feerate)
         for (const auto& ancestor : ancestors) {
             m_inclusion_order.emplace(Txid::FromUint256(ancestor->first), sequence_num);
         }
+        // Take the descendants out of the ordering while their ancestor feerates change, and put
+        // back the ones which remain.
+        std::vector<MockEntryMap::iterator> updated;
+        for (const auto& ancestor : ancestors) {
+            for (const auto& descendant : m_descendant_set_by_txid.at(ancestor->first)) {
+                by_feerate.erase(descendant);
+                if (ancestors.count(descendant) == 0) updated.push_back(descendant);
+            }
+        }
         DeleteAncestorPackage(ancestors);
+        by_feerate.insert(updated.begin(), updated.end());
         SanityCheck();
         ++sequence_num;
     }
@@ -26,6 +26,8 @@ void ApplyArgsManOptions(const ArgsManager& argsman, PeerManager::Options& optio
 
     if (auto value{argsman.GetBoolArg("-capturemessages")}) options.capture_messages = *value;
 
+    if (auto value{argsman.GetBoolArg("-msgprocstats")}) options.msgproc_stats = *value;
+
     if (auto value{argsman.GetBoolArg("-blocksonly")}) options.ignore_incoming_txs = *value;
 }
 
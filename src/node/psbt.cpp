@@ -10,7 +10,9 @@
 #include <policy/settings.h>
 #include <tinyformat.h>
 
+#include <cstdint>
 #include <numeric>
+#include <vector>
 
 namespace node {
 PSBTAnalysis AnalyzePSBT(PartiallySignedTransaction psbtx)
@@ -26,6 +28,18 @@ PSBTAnalysis AnalyzePSBT(PartiallySignedTransaction psbtx)
 
     const PrecomputedTransactionData txdata = PrecomputePSBTData(psbtx);
 
+    // Verify the inputs and find out what the non-final ones are missing up
+    // front, as this is where the time goes and several inputs can be
+    // processed at once.
+    std::vector<uint8_t> input_final(psbtx.inputs.size()), input_complete(psbtx.inputs.size());
+    std::vector<SignatureData> input_outdata(psbtx.inputs.size());
+    ForEachPSBTInput(psbtx, [&](unsigned int i) {
+        input_final[i] = PSBTInputSignedAndVerified(psbtx, i, &txdata);
+        if (!input_final[i]) {
+            input_complete[i] = SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, std::nullopt, &input_outdata[i]) == PSBTError::OK;
+        }
+    });
+
     for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
         PSBTInput& input = psbtx.inputs[i];
         PSBTInputAnalysis& input_analysis = result.inputs[i];
@@ -59,12 +73,12 @@ PSBTAnalysis AnalyzePSBT(PartiallySignedTransaction psbtx)
         }
 
         // Check if it is final
-        if (!PSBTInputSignedAndVerified(psbtx, i, &txdata)) {
+        if (!input_final[i]) {
             input_analysis.is_final = false;
 
             // Figure out what is missing
-            SignatureData outdata;
-            bool complete = SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, std::nullopt, &outdata) == PSBTError::OK;
+            const SignatureData& outdata = input_outdata[i];
+            bool complete = input_complete[i];
 
             // Things are missing
             if (!complete) {
@@ -174,6 +174,9 @@ public:
 
     /** Wrapper for TxOrphanage::GetOrphanTransactions */
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() const;
+
+    /** Wrapper for TxOrphanage::DynamicMemoryUsage */
+    size_t GetOrphanageMemoryUsage() const;
 };
 } // namespace node
 #endif // BITCOIN_NODE_TXDOWNLOADMAN_H
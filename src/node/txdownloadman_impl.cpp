@@ -87,6 +87,10 @@ std::vector<TxOrphanage::OrphanTxBase> TxDownloadManager::GetOrphanTransactions(
 {
     return m_impl->GetOrphanTransactions();
 }
+size_t TxDownloadManager::GetOrphanageMemoryUsage() const
+{
+    return m_impl->GetOrphanageMemoryUsage();
+}
 
 // TxDownloadManagerImpl
 void TxDownloadManagerImpl::ActiveTipChange()
@@ -585,4 +589,8 @@ std::vector<TxOrphanage::OrphanTxBase> TxDownloadManagerImpl::GetOrphanTransacti
 {
     return m_orphanage.GetOrphanTransactions();
 }
+size_t TxDownloadManagerImpl::GetOrphanageMemoryUsage() const
+{
+    return m_orphanage.DynamicMemoryUsage();
+}
 } // namespace node
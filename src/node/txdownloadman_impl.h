@@ -189,6 +189,7 @@ public:
     void CheckIsEmpty(NodeId nodeid);
 
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() const;
+    size_t GetOrphanageMemoryUsage() const;
 
 protected:
     /** Helper for getting deduplicated vector of Txids in vin. */
@@ -5,9 +5,15 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
+#include <random.h>
 #include <util/check.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <unordered_map>
 #include <variant>
 
@@ -29,6 +35,17 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/** Sketches are built over 32-bit short ids, see BIP-330. */
+constexpr uint32_t RECON_FIELD_SIZE{32};
+/** Coefficient for the false positive rate of sketch decoding, see BIP-330. */
+constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+/** Largest sketch capacity we build or accept. */
+constexpr uint32_t MAX_SKETCH_CAPACITY{2 << 12};
+/** Coefficient q we announce for estimating the set difference, see BIP-330. */
+constexpr double RECON_Q{0.25};
+/** q is sent as an integer scaled by this factor. */
+constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +53,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +61,40 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions we want to announce to the peer through the next reconciliation, by short id. */
+    std::unordered_map<uint32_t, Wtxid> m_local_set;
+
+    /** As a responder, the set our last sketch was built from, until the RECONCILDIFF arrives. */
+    std::unordered_map<uint32_t, Wtxid> m_local_set_snapshot;
+
+    /** As an initiator, whether we sent a REQRECON that was not answered yet. As a responder,
+     *  whether we sent a SKETCH and wait for the RECONCILDIFF. */
+    bool m_round_ongoing{false};
+
+    /** As an initiator, when to send the next REQRECON. */
+    std::chrono::microseconds m_next_request_time{0};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Short id of a transaction for sketches exchanged with this peer, never 0 (see BIP-330). */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + uint32_t(s % 0xFFFFFFFF);
+    }
+
+    /** Sketch capacity for our set against a remote set of the given size, per BIP-330. */
+    static uint32_t EstimateSketchCapacity(size_t local_set_size, uint16_t remote_set_size, uint16_t remote_q)
+    {
+        const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+        const size_t weighted_min_size{size_t(remote_q) * std::min<size_t>(local_set_size, remote_set_size) / Q_PRECISION};
+        const size_t estimated_diff{1 + weighted_min_size + set_size_diff};
+        return Minisketch::ComputeCapacity(RECON_FIELD_SIZE, estimated_diff, RECON_FALSE_POSITIVE_COEF);
+    }
 };
 
 } // namespace
@@ -76,6 +116,30 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Number of registered peers we initiate reconciliations with (outbound) and we respond to (inbound). */
+    size_t m_outbounds_count GUARDED_BY(m_txreconciliation_mutex){0};
+    size_t m_inbounds_count GUARDED_BY(m_txreconciliation_mutex){0};
+
+    /** Key for the per-transaction and per-peer fanout choice. */
+    const uint64_t m_fanout_k0{FastRandomContext().rand64()};
+    const uint64_t m_fanout_k1{FastRandomContext().rand64()};
+
+    TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
+    const TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -122,6 +186,7 @@ public:
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
         recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        ++(is_peer_inbound ? m_inbounds_count : m_outbounds_count);
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -129,6 +194,9 @@ public:
     {
         AssertLockNotHeld(m_txreconciliation_mutex);
         LOCK(m_txreconciliation_mutex);
+        if (const auto* state{GetRegisteredPeerState(peer_id)}) {
+            --(state->m_we_initiate ? m_outbounds_count : m_inbounds_count);
+        }
         if (m_states.erase(peer_id)) {
             LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Forget txreconciliation state of peer=%d\n", peer_id);
         }
@@ -142,6 +210,156 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state) return false;
+
+        const uint32_t short_id{state->ComputeShortID(wtxid)};
+        const auto it{state->m_local_set.find(short_id)};
+        if (it != state->m_local_set.end()) return it->second == wtxid;
+        if (state->m_local_set.size() >= MAX_RECON_SET_SIZE) return false;
+        state->m_local_set.emplace(short_id, wtxid);
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Trace, "Added %s to the reconciliation set for peer=%d\n", wtxid.ToString(), peer_id);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state) return false;
+
+        const auto it{state->m_local_set.find(state->ComputeShortID(wtxid))};
+        if (it == state->m_local_set.end() || it->second != wtxid) return false;
+        state->m_local_set.erase(it);
+        return true;
+    }
+
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        const auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state) return true;
+
+        const double fraction{state->m_we_initiate ? OUTBOUND_FANOUT_DESTINATIONS / m_outbounds_count : INBOUND_FANOUT_DESTINATIONS_FRACTION};
+        if (fraction >= 1) return true;
+        const uint64_t hash{CSipHasher(m_fanout_k0, m_fanout_k1).Write(wtxid.ToUint256()).Write(uint64_t(peer_id)).Finalize()};
+        return (hash >> 11) < uint64_t(std::ldexp(fraction, 53));
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || !state->m_we_initiate || state->m_round_ongoing) return std::nullopt;
+
+        if (state->m_next_request_time == 0us) {
+            // Give the set some time to fill after the connection is set up.
+            state->m_next_request_time = now + RECON_REQUEST_INTERVAL;
+            return std::nullopt;
+        }
+        if (now < state->m_next_request_time) return std::nullopt;
+
+        state->m_next_request_time = now + RECON_REQUEST_INTERVAL;
+        state->m_round_ongoing = true;
+        const uint16_t set_size{uint16_t(std::min<size_t>(state->m_local_set.size(), std::numeric_limits<uint16_t>::max()))};
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Initiate reconciliation with peer=%d, local set size=%u\n", peer_id, set_size);
+        return std::make_pair(set_size, uint16_t(RECON_Q * Q_PRECISION));
+    }
+
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id, uint16_t remote_set_size, uint16_t remote_q) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_round_ongoing) return std::nullopt;
+
+        state->m_round_ongoing = true;
+        state->m_local_set_snapshot = std::move(state->m_local_set);
+        state->m_local_set.clear();
+
+        // An empty sketch makes the initiator fall back to announcing its whole set, and to
+        // have us announce ours. That is the best outcome too when the difference is expected
+        // to exceed the largest sketch we build.
+        std::vector<uint8_t> skdata;
+        const uint32_t capacity{TxReconciliationState::EstimateSketchCapacity(state->m_local_set_snapshot.size(), remote_set_size, remote_q)};
+        if (!state->m_local_set_snapshot.empty() && capacity <= MAX_SKETCH_CAPACITY) {
+            Minisketch sketch{node::MakeMinisketch32(capacity)};
+            for (const auto& [short_id, _] : state->m_local_set_snapshot) sketch.Add(short_id);
+            skdata = sketch.Serialize();
+        }
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Respond to reconciliation request from peer=%d, local set size=%u, remote set size=%u, sketch capacity=%u\n",
+                      peer_id, state->m_local_set_snapshot.size(), remote_set_size, skdata.size() * 8 / RECON_FIELD_SIZE);
+        return skdata;
+    }
+
+    std::optional<ReconciliationDiff> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || !state->m_we_initiate || !state->m_round_ongoing) return std::nullopt;
+        state->m_round_ongoing = false;
+
+        ReconciliationDiff diff;
+        const size_t capacity{skdata.size() * 8 / RECON_FIELD_SIZE};
+        if (capacity > 0 && capacity <= MAX_SKETCH_CAPACITY && capacity * RECON_FIELD_SIZE == skdata.size() * 8) {
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(skdata);
+            Minisketch local_sketch{node::MakeMinisketch32(capacity)};
+            for (const auto& [short_id, _] : state->m_local_set) local_sketch.Add(short_id);
+            remote_sketch.Merge(local_sketch);
+
+            std::vector<uint64_t> differences(capacity);
+            if (remote_sketch.Decode(differences)) {
+                diff.m_success = true;
+                for (const uint64_t short_id : differences) {
+                    const auto it{state->m_local_set.find(uint32_t(short_id))};
+                    if (it != state->m_local_set.end()) {
+                        diff.m_announce.push_back(it->second);
+                    } else {
+                        diff.m_ask_shortids.push_back(uint32_t(short_id));
+                    }
+                }
+            }
+        }
+        if (!diff.m_success) {
+            // Fall back to announcing our whole set, and the peer will do the same.
+            for (const auto& [_, wtxid] : state->m_local_set) diff.m_announce.push_back(wtxid);
+        }
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d %s: local set size=%u, to announce=%u, to request=%u\n",
+                      peer_id, diff.m_success ? "succeeded" : "failed", state->m_local_set.size(), diff.m_announce.size(), diff.m_ask_shortids.size());
+        state->m_local_set.clear();
+        return diff;
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_we_initiate || !state->m_round_ongoing) return std::nullopt;
+        state->m_round_ongoing = false;
+
+        std::vector<Wtxid> announce;
+        if (success) {
+            for (const uint32_t short_id : ask_shortids) {
+                const auto it{state->m_local_set_snapshot.find(short_id)};
+                if (it != state->m_local_set_snapshot.end()) announce.push_back(it->second);
+            }
+        } else {
+            for (const auto& [_, wtxid] : state->m_local_set_snapshot) announce.push_back(wtxid);
+        }
+        state->m_local_set_snapshot.clear();
+        return announce;
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +386,38 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const
+{
+    return m_impl->ShouldFanoutTo(wtxid, peer_id);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::RespondToReconciliationRequest(NodeId peer_id, uint16_t remote_set_size, uint16_t remote_q)
+{
+    return m_impl->RespondToReconciliationRequest(peer_id, remote_set_size, remote_q);
+}
+
+std::optional<ReconciliationDiff> TxReconciliationTracker::HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids)
+{
+    return m_impl->HandleReconcilDiff(peer_id, success, ask_shortids);
+}
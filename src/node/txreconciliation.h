@@ -7,14 +7,35 @@
 
 #include <net.h>
 #include <sync.h>
+#include <util/transaction_identifier.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version
  * 支持的交易对账协议版本 */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
 
+/** Maximum number of transactions in the reconciliation set of a peer. Transactions that do not
+ * fit are announced to the peer by flooding instead.
+ * 对等节点对账集合中的最大交易数量。放不下的交易改为通过泛洪向对等节点宣布。 */
+static constexpr size_t MAX_RECON_SET_SIZE{3000};
+/** Interval between the reconciliation requests we send to each peer we initiate with.
+ * 我们向每个由我们发起对账的对等节点发送对账请求的间隔。 */
+static constexpr std::chrono::seconds RECON_REQUEST_INTERVAL{8};
+/** Expected number of reconciling outbound peers a transaction is still flooded to.
+ * 交易仍然泛洪到的进行对账的出站对等节点的期望数量。 */
+static constexpr double OUTBOUND_FANOUT_DESTINATIONS{1};
+/** Fraction of reconciling inbound peers a transaction is still flooded to.
+ * 交易仍然泛洪到的进行对账的入站对等节点的比例。 */
+static constexpr double INBOUND_FANOUT_DESTINATIONS_FRACTION{0.1};
+
 /**
  * 交易对账注册结果枚举
  * 定义了注册对等节点进行交易对账时的可能结果
@@ -26,6 +47,22 @@ enum class ReconciliationRegisterResult {
     PROTOCOL_VIOLATION,  // 协议违规
 };
 
+/**
+ * Outcome of a reconciliation round on the initiator side, see TxReconciliationTracker::HandleSketch.
+ * 发起者一侧一轮对账的结果，参见 TxReconciliationTracker::HandleSketch。
+ */
+struct ReconciliationDiff {
+    /** Whether the set difference was found (sent to the peer in RECONCILDIFF).
+     * 是否找到了集合差异（在 RECONCILDIFF 中发送给对等节点）。 */
+    bool m_success{false};
+    /** Short ids of the transactions we are missing, to request from the peer.
+     * 我们缺少的交易的短ID，将向对等节点请求。 */
+    std::vector<uint32_t> m_ask_shortids;
+    /** Transactions the peer is missing (all of our set on failure), to announce to it.
+     * 对等节点缺少的交易（失败时为我们的整个集合），将向其宣布。 */
+    std::vector<Wtxid> m_announce;
+};
+
 /**
  * Transaction reconciliation is a way for nodes to efficiently announce transactions.
  * This object keeps track of all txreconciliation-related communications with the peers.
@@ -128,6 +165,72 @@ public:
      * 检查对等节点是否已注册与我们进行交易对账。
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a transaction to the reconciliation set of the peer, instead of announcing it.
+     * Returns false if the caller has to announce it by flooding instead: the peer is not
+     * registered, the set is full or the transaction's short id collides within the set.
+     *
+     * 步骤1. 将交易添加到对等节点的对账集合中，而不是宣布它。
+     * 如果调用者必须改为通过泛洪宣布它，则返回false：对等节点未注册、集合已满或交易的短ID在集合内冲突。
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the reconciliation set of the peer, e.g. because the peer
+     * announced it to us. Returns whether it was in the set.
+     *
+     * 从对等节点的对账集合中移除交易，例如因为对等节点已向我们宣布了它。返回它是否在集合中。
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Whether a transaction should still be flooded to the peer rather than reconciled. Always
+     * true for peers that are not registered. The choice is random but fixed per transaction and
+     * peer, with OUTBOUND_FANOUT_DESTINATIONS and INBOUND_FANOUT_DESTINATIONS_FRACTION as targets.
+     *
+     * 交易是否仍应泛洪到对等节点而不是对账。对于未注册的对等节点始终为true。选择是随机的，
+     * 但对每个交易和对等节点是固定的，目标为 OUTBOUND_FANOUT_DESTINATIONS 和 INBOUND_FANOUT_DESTINATIONS_FRACTION。
+     */
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const;
+
+    /**
+     * Step 2. If we initiate reconciliations with the peer, no round is ongoing and it is time for
+     * the next one, start a round and return the (set size, q) to send in a REQRECON message.
+     *
+     * 步骤2. 如果由我们发起与对等节点的对账、当前没有进行中的轮次且到了下一轮的时间，
+     * 则开始一轮并返回要在 REQRECON 消息中发送的（集合大小, q）。
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2 (responder). Handle a REQRECON from the peer: return our sketch to send back in a
+     * SKETCH message and keep a snapshot of the set it covers until RECONCILDIFF arrives. Returns
+     * std::nullopt if the request violates the protocol.
+     *
+     * 步骤2（响应者）。处理来自对等节点的 REQRECON：返回要在 SKETCH 消息中发回的草图，并保留其所覆盖集合的快照，
+     * 直到 RECONCILDIFF 到达。如果请求违反协议，则返回 std::nullopt。
+     */
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id, uint16_t remote_set_size, uint16_t remote_q);
+
+    /**
+     * Steps 3-4. Handle the SKETCH the peer sent in response to our request: find the set
+     * difference and clear our set. Returns std::nullopt if no request was outstanding.
+     *
+     * 步骤3-4. 处理对等节点响应我们的请求而发送的 SKETCH：找到集合差异并清空我们的集合。
+     * 如果没有未完成的请求，则返回 std::nullopt。
+     */
+    std::optional<ReconciliationDiff> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata);
+
+    /**
+     * Final step (responder). Handle the RECONCILDIFF concluding the round: return the
+     * transactions of the snapshot to announce to the peer, i.e. the ones it asked for, or all of
+     * them on failure. Returns std::nullopt if no round was ongoing.
+     *
+     * 最后一步（响应者）。处理结束本轮的 RECONCILDIFF：返回快照中要向对等节点宣布的交易，
+     * 即它请求的交易，失败时则为全部交易。如果没有进行中的轮次，则返回 std::nullopt。
+     */
+    std::optional<std::vector<Wtxid>> HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids);
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
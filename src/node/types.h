@@ -21,10 +21,14 @@
 
 #include <consensus/amount.h>
 #include <cstddef>
+#include <cstdint>
 #include <policy/policy.h>
+#include <primitives/transaction.h>
 #include <script/script.h>
+#include <string>
 #include <uint256.h>
 #include <util/time.h>
+#include <vector>
 
 namespace node {
 
@@ -142,6 +146,51 @@ struct BlockCheckOptions {
      */
     bool check_pow{true};
 };
+
+/**
+ * 区块模板差异结构体
+ * 描述由waitNext()返回的模板相对于前一个模板的变化
+ *
+ * Changes of a template returned by BlockTemplate::waitNext() relative to the
+ * template it was waited from, so that a client can update the previous block
+ * instead of transferring and parsing all of the transactions again.
+ * 客户端可以据此更新之前的区块，而无需再次传输和解析所有交易。
+ *
+ * Positions are those of the transactions after the coinbase, i.e. position 0
+ * is vtx[1].
+ * 位置不包括coinbase交易，即位置0是vtx[1]。
+ */
+struct BlockTemplateDiff {
+    //! Positions in the previous template of the transactions not in this one
+    //! - 前一个模板中不在此模板中的交易的位置
+    std::vector<uint32_t> removed;
+    //! Transactions not in the previous template, in block order
+    //! - 不在前一个模板中的交易，按区块顺序排列
+    std::vector<CTransactionRef> added;
+    //! For each transaction of this template, its position in the previous
+    //! template, or -1 for the next transaction of added
+    //! - 此模板中每个交易在前一个模板中的位置，-1表示added中的下一个交易
+    std::vector<int64_t> order;
+    //! Coinbase output value of this template minus that of the previous one
+    //! - 此模板与前一个模板的coinbase输出值之差
+    CAmount coinbase_value_change{0};
+};
+
+/**
+ * 共享内存引用结构体
+ * 指向保存序列化数据的命名共享内存段
+ *
+ * Named shared memory segment holding serialized data, which the receiving
+ * process maps with SharedMemory::Open() instead of receiving the data over
+ * the IPC socket.
+ * 接收进程使用SharedMemory::Open()映射该段，而不是通过IPC套接字接收数据。
+ */
+struct SharedMemoryRef {
+    //! Name of the segment - 共享内存段的名称
+    std::string name;
+    //! Number of bytes of data at the start of the segment - 段开头的数据字节数
+    uint64_t size{0};
+};
 } // namespace node
 
 #endif // BITCOIN_NODE_TYPES_H
@@ -16,9 +16,11 @@
 #include <util/check.h>
 #include <util/fs.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 // UTXO set snapshot magic bytes
 // UTXO集合快照魔数字节
@@ -39,10 +41,17 @@ namespace node {
 class SnapshotMetadata
 {
     inline static const uint16_t VERSION{2}; // 快照元数据版本
-    const std::set<uint16_t> m_supported_versions{VERSION}; // 支持的版本集合
+    const std::set<uint16_t> m_supported_versions{VERSION, CHUNKED_VERSION}; // 支持的版本集合
     const MessageStartChars m_network_magic; // 网络魔数
 
 public:
+    //! Version of snapshots whose coins are stored in SnapshotChunks, which
+    //! can be decoded and checked independently of each other.
+    static constexpr uint16_t CHUNKED_VERSION{3};
+
+    //! The version of the snapshot, which determines the format of its coins.
+    uint16_t m_version{VERSION};
+
     //! The hash of the block that reflects the tip of the chain for the
     //! UTXO set contained in this snapshot.
     //!
@@ -68,15 +77,20 @@ public:
      * @param network_magic 网络魔数
      * @param base_blockhash 基础区块哈希
      * @param coins_count 硬币数量
+     * @param chunked whether the coins are stored in SnapshotChunks
      */
     SnapshotMetadata(
         const MessageStartChars network_magic,
         const uint256& base_blockhash,
-        uint64_t coins_count) :
+        uint64_t coins_count,
+        bool chunked = false) :
             m_network_magic(network_magic),
+            m_version(chunked ? CHUNKED_VERSION : VERSION),
             m_base_blockhash(base_blockhash),
             m_coins_count(coins_count) { }
 
+    bool IsChunked() const { return m_version == CHUNKED_VERSION; }
+
     /**
      * 序列化快照元数据
      * @param s 输出流
@@ -84,7 +98,7 @@ public:
     template <typename Stream>
     inline void Serialize(Stream& s) const {
         s << SNAPSHOT_MAGIC_BYTES;  // 写入魔数
-        s << VERSION;               // 写入版本
+        s << m_version;             // 写入版本
         s << m_network_magic;       // 写入网络魔数
         s << m_base_blockhash;      // 写入基础区块哈希
         s << m_coins_count;         // 写入硬币数量
@@ -111,6 +125,7 @@ public:
         if (m_supported_versions.find(version) == m_supported_versions.end()) {
             throw std::ios_base::failure(strprintf("Version of snapshot %s does not match any of the supported versions.", version));
         }
+        m_version = version;
 
         // Read the network magic (pchMessageStart)
         // 读取网络魔数（pchMessageStart）
@@ -133,6 +148,24 @@ public:
     }
 };
 
+//! Target size of the payload of the chunks written in chunked snapshots. A
+//! chunk only ends after all the coins of a txid, so it can be bigger.
+static constexpr size_t SNAPSHOT_CHUNK_SIZE{1 << 20};
+
+//! A chunk of the coins of a snapshot of SnapshotMetadata::CHUNKED_VERSION.
+//! Chunks follow the metadata in the order of the coins.
+struct SnapshotChunk {
+    //! Number of coins in the payload.
+    uint64_t coins_count{0};
+    //! The coins, grouped by txid as in unchunked snapshots: the txid, the
+    //! number of its coins, and each coin preceded by its output index.
+    std::vector<std::byte> payload;
+    //! Hash(payload), to detect corrupted chunks before loading them.
+    uint256 payload_hash;
+
+    SERIALIZE_METHODS(SnapshotChunk, obj) { READWRITE(COMPACTSIZE(obj.coins_count), obj.payload, obj.payload_hash); }
+};
+
 //! The file in the snapshot chainstate dir which stores the base blockhash. This is
 //! needed to reconstruct snapshot chainstates on init.
 //!
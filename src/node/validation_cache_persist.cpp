@@ -0,0 +1,111 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/validation_cache_persist.h>
+
+#include <common/args.h>
+#include <hash.h>
+#include <logging.h>
+#include <streams.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <util/fs_helpers.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+namespace node {
+static constexpr uint64_t VALIDATION_CACHE_DUMP_VERSION{1};
+
+bool ShouldPersistValidationCache(const ArgsManager& argsman)
+{
+    return argsman.GetBoolArg("-persistvalidationcache", DEFAULT_PERSIST_VALIDATION_CACHE);
+}
+
+fs::path ValidationCachePath(const ArgsManager& argsman)
+{
+    return argsman.GetDataDirNet() / "validation_cache.dat";
+}
+
+bool DumpValidationCache(const ValidationCache& cache, const fs::path& dump_path)
+{
+    const auto start{SteadyClock::now()};
+    std::vector<uint256> script_entries;
+    uint256 script_nonce;
+    {
+        LOCK(::cs_main);
+        script_entries = cache.ScriptExecutionCacheEntries();
+        script_nonce = cache.ScriptExecutionCacheNonce();
+    }
+    const std::vector<uint256> signature_entries{cache.m_signature_cache.Entries()};
+
+    const fs::path file_fspath{dump_path + ".new"};
+    AutoFile file{fsbridge::fopen(file_fspath, "wb")};
+    if (file.IsNull()) {
+        LogInfo("Failed to open %s for writing the validation cache. Continuing anyway.\n", fs::PathToString(file_fspath));
+        return false;
+    }
+    try {
+        HashedSourceWriter writer{file};
+        writer << VALIDATION_CACHE_DUMP_VERSION;
+        writer << script_nonce << script_entries;
+        writer << cache.m_signature_cache.Nonce() << signature_entries;
+        file << writer.GetHash();
+        if (!file.Commit()) {
+            (void)file.fclose();
+            throw std::runtime_error("Commit failed");
+        }
+        if (file.fclose() != 0) {
+            throw std::runtime_error("Close failed");
+        }
+        if (!RenameOver(file_fspath, dump_path)) {
+            throw std::runtime_error("Rename failed");
+        }
+    } catch (const std::exception& e) {
+        LogInfo("Failed to dump the validation cache: %s. Continuing anyway.\n", e.what());
+        (void)file.fclose();
+        return false;
+    }
+    LogInfo("Dumped %u script execution and %u signature cache entries in %.3fs\n",
+            script_entries.size(), signature_entries.size(), Ticks<SecondsDouble>(SteadyClock::now() - start));
+    return true;
+}
+
+bool LoadValidationCache(ValidationCache& cache, const fs::path& load_path)
+{
+    AutoFile file{fsbridge::fopen(load_path, "rb")};
+    if (file.IsNull()) {
+        LogInfo("Failed to open validation cache file. Continuing anyway.\n");
+        return false;
+    }
+    uint256 script_nonce, signature_nonce;
+    std::vector<uint256> script_entries, signature_entries;
+    try {
+        HashVerifier verifier{file};
+        uint64_t version;
+        verifier >> version;
+        if (version != VALIDATION_CACHE_DUMP_VERSION) {
+            throw std::runtime_error{"Unknown version"};
+        }
+        verifier >> script_nonce >> script_entries;
+        verifier >> signature_nonce >> signature_entries;
+        uint256 checksum;
+        file >> checksum;
+        if (checksum != verifier.GetHash()) {
+            throw std::runtime_error{"Checksum mismatch, data corrupted"};
+        }
+    } catch (const std::exception& e) {
+        LogInfo("Failed to load the validation cache: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+    WITH_LOCK(::cs_main, cache.RestoreScriptExecutionCache(script_nonce, script_entries));
+    cache.m_signature_cache.Restore(signature_nonce, signature_entries);
+    LogInfo("Loaded %u script execution and %u signature cache entries\n", script_entries.size(), signature_entries.size());
+    return true;
+}
+} // namespace node
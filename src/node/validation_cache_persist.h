@@ -0,0 +1,39 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
+#define BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
+
+#include <kernel/cs_main.h>
+#include <sync.h>
+#include <util/fs.h>
+
+class ArgsManager;
+class ValidationCache;
+
+namespace node {
+
+/**
+ * Default for -persistvalidationcache, indicating whether the node should save
+ * its script execution and signature caches on shutdown and load them on start.
+ */
+static constexpr bool DEFAULT_PERSIST_VALIDATION_CACHE{false};
+
+bool ShouldPersistValidationCache(const ArgsManager& argsman);
+fs::path ValidationCachePath(const ArgsManager& argsman);
+
+/** Save the entries of the script execution and signature caches, with their nonces, to a file. */
+bool DumpValidationCache(const ValidationCache& cache, const fs::path& dump_path) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+/**
+ * Replace the entries of the caches with those of a file written by
+ * DumpValidationCache(). As entries of the caches let scripts and signatures
+ * be skipped during validation, the file must come from this node. Must be
+ * called before the caches are used.
+ */
+bool LoadValidationCache(ValidationCache& cache, const fs::path& load_path) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+} // namespace node
+
+#endif // BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
@@ -522,6 +522,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
 bool CBlockPolicyEstimator::removeTx(uint256 hash)
 {
     LOCK(m_cs_fee_estimator);
+    ProcessQueue();
     return _removeTx(hash, /*inBlock=*/false);
 }
 
@@ -530,6 +531,9 @@ bool CBlockPolicyEstimator::_removeTx(const uint256& hash, bool inBlock)
     AssertLockHeld(m_cs_fee_estimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        // Transactions entered at the current height are not counted by the
+        // estimates yet (see m_estimates_epoch).
+        if (pos->second.blockHeight != nBestSeenHeight) ++m_estimates_epoch;
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -576,26 +580,77 @@ CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath
     }
 }
 
-CBlockPolicyEstimator::~CBlockPolicyEstimator() = default;
+CBlockPolicyEstimator::~CBlockPolicyEstimator()
+{
+    m_worker.Stop();
+}
+
+void CBlockPolicyEstimator::StartWorker()
+{
+    SyncWithWorker();
+    m_worker.Start(/*num_workers=*/1);
+}
+
+void CBlockPolicyEstimator::SyncWithWorker()
+{
+    if (WITH_LOCK(m_queue_mutex, return m_queue.empty())) return;
+    LOCK(m_cs_fee_estimator);
+    ProcessQueue();
+}
+
+void CBlockPolicyEstimator::QueueEvent(std::function<void()> event)
+{
+    {
+        LOCK(m_queue_mutex);
+        m_queue.push_back(std::move(event));
+        if (std::exchange(m_queue_scheduled, true)) return;
+    }
+    // Without a worker, this runs right away.
+    (void)m_worker.Submit([this]() EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex) {
+        LOCK(m_cs_fee_estimator);
+        ProcessQueue();
+    });
+}
+
+void CBlockPolicyEstimator::ProcessQueue()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    std::deque<std::function<void()>> events;
+    {
+        LOCK(m_queue_mutex);
+        events.swap(m_queue);
+        m_queue_scheduled = false;
+    }
+    for (const auto& event : events) event();
+}
 
 void CBlockPolicyEstimator::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/)
 {
-    processTransaction(tx);
+    QueueEvent([this, tx]() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator) { _processTransaction(tx); });
 }
 
 void CBlockPolicyEstimator::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/)
 {
-    removeTx(tx->GetHash());
+    QueueEvent([this, hash = tx->GetHash().ToUint256()]() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator) { _removeTx(hash, /*inBlock=*/false); });
 }
 
 void CBlockPolicyEstimator::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
 {
-    processBlock(txs_removed_for_block, nBlockHeight);
+    QueueEvent([this, txs_removed_for_block, nBlockHeight]() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator) {
+        _processBlock(txs_removed_for_block, nBlockHeight);
+    });
 }
 
 void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo& tx)
 {
     LOCK(m_cs_fee_estimator);
+    ProcessQueue();
+    _processTransaction(tx);
+}
+
+void CBlockPolicyEstimator::_processTransaction(const NewMempoolTransactionInfo& tx)
+{
+    AssertLockHeld(m_cs_fee_estimator);
     const unsigned int txHeight = tx.info.txHeight;
     const auto& hash = tx.info.m_tx->GetHash();
     if (mapMemPoolTxs.count(hash)) {
@@ -670,6 +725,14 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
                                          unsigned int nBlockHeight)
 {
     LOCK(m_cs_fee_estimator);
+    ProcessQueue();
+    _processBlock(txs_removed_for_block, nBlockHeight);
+}
+
+void CBlockPolicyEstimator::_processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
+                                          unsigned int nBlockHeight)
+{
+    AssertLockHeld(m_cs_fee_estimator);
     if (nBlockHeight <= nBestSeenHeight) {
         // Ignore side chains and re-orgs; assuming they are random
         // they don't affect the estimate.
@@ -683,6 +746,7 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
     // calls to removeTx (via processBlockTx) correctly calculate age
     // of unconfirmed txs to remove from tracking.
     nBestSeenHeight = nBlockHeight;
+    ++m_estimates_epoch;
 
     // Update unconfirmed circular buffer
     feeStats->ClearCurrent(nBlockHeight);
@@ -870,7 +934,39 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
-    LOCK(m_cs_fee_estimator);
+    const std::pair key{confTarget, conservative};
+    {
+        LOCK(m_estimates_mutex);
+        if (m_estimates_cache_epoch == m_estimates_epoch.load()) {
+            if (const auto it{m_estimates_cache.find(key)}; it != m_estimates_cache.end()) {
+                if (feeCalc) *feeCalc = it->second.calc;
+                return it->second.feerate;
+            }
+        }
+    }
+
+    CachedEstimate estimate;
+    uint64_t epoch;
+    {
+        LOCK(m_cs_fee_estimator);
+        // Only changed while holding m_cs_fee_estimator.
+        epoch = m_estimates_epoch.load();
+        estimate.feerate = _estimateSmartFee(confTarget, &estimate.calc, conservative);
+    }
+    if (feeCalc) *feeCalc = estimate.calc;
+
+    LOCK(m_estimates_mutex);
+    if (m_estimates_cache_epoch < epoch) {
+        m_estimates_cache.clear();
+        m_estimates_cache_epoch = epoch;
+    }
+    if (m_estimates_cache_epoch == epoch) m_estimates_cache.emplace(key, estimate);
+    return estimate.feerate;
+}
+
+CFeeRate CBlockPolicyEstimator::_estimateSmartFee(int confTarget, FeeCalculation* feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -1052,6 +1148,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            ++m_estimates_epoch;
         }
     }
     catch (const std::exception& e) {
@@ -1065,6 +1162,7 @@ void CBlockPolicyEstimator::FlushUnconfirmed()
 {
     const auto startclear{SteadyClock::now()};
     LOCK(m_cs_fee_estimator);
+    ProcessQueue();
     size_t num_entries = mapMemPoolTxs.size();
     // Remove every entry in mapMemPoolTxs
     while (!mapMemPoolTxs.empty()) {
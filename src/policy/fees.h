@@ -12,14 +12,19 @@
 #include <threadsafety.h>
 #include <uint256.h>
 #include <util/fs.h>
+#include <util/threadpool.h>
 #include <validationinterface.h>
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -205,15 +210,15 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** Process a transaction accepted to the mempool*/
     void processTransaction(const NewMempoolTransactionInfo& tx)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** Remove a transaction from the mempool tracking stats for non BLOCK removal reasons*/
     bool removeTx(uint256 hash)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** DEPRECATED. Return a feerate estimate */
     CFeeRate estimateFee(int confTarget) const
@@ -225,7 +230,7 @@ public:
      *  valid over longer time horizons also.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_estimates_mutex);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -241,11 +246,11 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
@@ -253,7 +258,7 @@ public:
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -262,18 +267,60 @@ public:
     /** Calculates the age of the file, since last modified */
     std::chrono::hours GetFeeEstimatorFileAge();
 
+    /**
+     * Apply the validation interface events on a dedicated thread instead of
+     * the thread delivering them. Until this is called, they are applied
+     * right away.
+     */
+    void StartWorker() EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
+
+    /** Apply the validation interface events not applied by the worker yet. */
+    void SyncWithWorker() EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
+
 protected:
     /** Overridden from CValidationInterface. */
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
+    std::string SubscriberName() const override { return "fee_estimator"; }
 
 private:
     mutable Mutex m_cs_fee_estimator;
 
+    /**
+     * Validation interface events waiting to be applied, each of them
+     * requiring m_cs_fee_estimator. They are applied in batches, taking the
+     * lock once for all events that arrived while the worker was busy. Lock
+     * order is m_cs_fee_estimator, then m_queue_mutex, so events are applied
+     * in the order they were queued no matter which thread applies them.
+     */
+    Mutex m_queue_mutex;
+    std::deque<std::function<void()>> m_queue GUARDED_BY(m_queue_mutex);
+    //! Whether a task applying m_queue has been submitted to m_worker and not started yet.
+    bool m_queue_scheduled GUARDED_BY(m_queue_mutex){false};
+
+    /**
+     * Bumped whenever applied changes may change the result of
+     * estimateSmartFee. Transactions entering the mempool do not: they are
+     * only counted as unconfirmed once older than a block.
+     */
+    std::atomic<uint64_t> m_estimates_epoch{0};
+
+    struct CachedEstimate {
+        CFeeRate feerate;
+        FeeCalculation calc;
+    };
+    /**
+     * Results of estimateSmartFee for m_estimates_cache_epoch, by target and
+     * mode, so that repeated calls do not need m_cs_fee_estimator.
+     */
+    mutable Mutex m_estimates_mutex;
+    mutable std::map<std::pair<int, bool>, CachedEstimate> m_estimates_cache GUARDED_BY(m_estimates_mutex);
+    mutable uint64_t m_estimates_cache_epoch GUARDED_BY(m_estimates_mutex){0};
+
     unsigned int nBestSeenHeight GUARDED_BY(m_cs_fee_estimator){0};
     unsigned int firstRecordedHeight GUARDED_BY(m_cs_fee_estimator){0};
     unsigned int historicalFirst GUARDED_BY(m_cs_fee_estimator){0};
@@ -317,6 +364,19 @@ private:
     /** A non-thread-safe helper for the removeTx function */
     bool _removeTx(const uint256& hash, bool inBlock)
         EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    /** Non-thread-safe helpers for processTransaction and processBlock */
+    void _processTransaction(const NewMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    void _processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    CFeeRate _estimateSmartFee(int confTarget, FeeCalculation* feeCalc, bool conservative) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
+    /** Queue an event to be applied by the worker, or apply it right away without one. */
+    void QueueEvent(std::function<void()> event) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_queue_mutex);
+    /** Apply all queued events */
+    void ProcessQueue() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_queue_mutex);
+
+    //! Applies queued events once started. Declared last, so it is stopped before the state it updates is destroyed.
+    ThreadPool m_worker{"feeest"};
 };
 
 class FeeFilterRounder
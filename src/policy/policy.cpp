@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <optional>
 #include <vector>
 
 CAmount GetDustThreshold(const CTxOut& txout, const CFeeRate& dustRelayFeeIn)
@@ -76,8 +77,36 @@ std::vector<uint32_t> GetDust(const CTransaction& tx, CFeeRate dust_relay_rate)
     return dust_outputs;
 }
 
+/**
+ * Classify the most common output templates on their exact bytes, without
+ * the allocations of Solver. Other scripts are left to Solver.
+ */
+static std::optional<TxoutType> MatchCommonTemplate(const CScript& script)
+{
+    const size_t size{script.size()};
+    if (size == 2 + WITNESS_V0_KEYHASH_SIZE && script[0] == OP_0 && script[1] == WITNESS_V0_KEYHASH_SIZE) {
+        return TxoutType::WITNESS_V0_KEYHASH;
+    }
+    if (size == 2 + WITNESS_V1_TAPROOT_SIZE && script[1] == WITNESS_V1_TAPROOT_SIZE) {
+        if (script[0] == OP_1) return TxoutType::WITNESS_V1_TAPROOT;
+        if (script[0] == OP_0) return TxoutType::WITNESS_V0_SCRIPTHASH;
+    }
+    if (script.IsPayToScriptHash()) return TxoutType::SCRIPTHASH;
+    if (size == 25 && script[0] == OP_DUP && script[1] == OP_HASH160 && script[2] == 20 &&
+        script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG) {
+        return TxoutType::PUBKEYHASH;
+    }
+    if (script.IsPayToAnchor()) return TxoutType::ANCHOR;
+    return std::nullopt;
+}
+
 bool IsStandard(const CScript& scriptPubKey, TxoutType& whichType)
 {
+    if (const auto type{MatchCommonTemplate(scriptPubKey)}) {
+        whichType = *type;
+        return true;
+    }
+
     std::vector<std::vector<unsigned char> > vSolutions;
     whichType = Solver(scriptPubKey, vSolutions);
 
@@ -189,7 +218,8 @@ bool AreInputsStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
         const CTxOut& prev = mapInputs.AccessCoin(tx.vin[i].prevout).out;
 
         std::vector<std::vector<unsigned char> > vSolutions;
-        TxoutType whichType = Solver(prev.scriptPubKey, vSolutions);
+        const auto common_type{MatchCommonTemplate(prev.scriptPubKey)};
+        TxoutType whichType = common_type ? *common_type : Solver(prev.scriptPubKey, vSolutions);
         if (whichType == TxoutType::NONSTANDARD || whichType == TxoutType::WITNESS_UNKNOWN) {
             // WITNESS_UNKNOWN failures are typically also caught with a policy
             // flag in the script interpreter, but it can be helpful to catch
@@ -227,16 +257,17 @@ bool IsWitnessStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
 
         const CTxOut &prev = mapInputs.AccessCoin(tx.vin[i].prevout).out;
 
-        // get the scriptPubKey corresponding to this input:
-        CScript prevScript = prev.scriptPubKey;
+        // get the scriptPubKey corresponding to this input, without copying it:
+        const CScript* prevScript{&prev.scriptPubKey};
+        CScript redeemScript;
 
         // witness stuffing detected
-        if (prevScript.IsPayToAnchor()) {
+        if (prevScript->IsPayToAnchor()) {
             return false;
         }
 
         bool p2sh = false;
-        if (prevScript.IsPayToScriptHash()) {
+        if (prevScript->IsPayToScriptHash()) {
             std::vector <std::vector<unsigned char> > stack;
             // If the scriptPubKey is P2SH, we try to extract the redeemScript casually by converting the scriptSig
             // into a stack. We do not check IsPushOnly nor compare the hash as these will be done later anyway.
@@ -245,7 +276,8 @@ bool IsWitnessStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
                 return false;
             if (stack.empty())
                 return false;
-            prevScript = CScript(stack.back().begin(), stack.back().end());
+            redeemScript = CScript(stack.back().begin(), stack.back().end());
+            prevScript = &redeemScript;
             p2sh = true;
         }
 
@@ -253,7 +285,7 @@ bool IsWitnessStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
         std::vector<unsigned char> witnessprogram;
 
         // Non-witness program must not be associated with any witness
-        if (!prevScript.IsWitnessProgram(witnessversion, witnessprogram))
+        if (!prevScript->IsWitnessProgram(witnessversion, witnessprogram))
             return false;
 
         // Check P2WSH standard limits
@@ -11,6 +11,8 @@
 #include <uint256.h>
 #include <util/time.h>
 
+#include <memory>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -65,6 +67,29 @@ public:
 };
 
 
+struct BlockMetadata;
+
+/** Serializes the transactions of a block, and computes their hashes
+ *  together and allocates them together when deserializing them. */
+struct BlockTransactionsFormatter {
+    template <typename Stream>
+    void Ser(Stream& s, const std::vector<CTransactionRef>& vtx)
+    {
+        s << vtx;
+    }
+
+    template <typename Stream>
+    void Unser(Stream& s, std::vector<CTransactionRef>& vtx)
+    {
+        const uint64_t count{ReadCompactSize(s)};
+        std::vector<CMutableTransaction> txs;
+        while (txs.size() < count) {
+            txs.emplace_back(deserialize, s);
+        }
+        vtx = MakeTransactionRefs(std::move(txs));
+    }
+};
+
 class CBlock : public CBlockHeader
 {
 public:
@@ -75,6 +100,7 @@ public:
     mutable bool fChecked;                            // CheckBlock()
     mutable bool m_checked_witness_commitment{false}; // CheckWitnessCommitment()
     mutable bool m_checked_merkle_root{false};        // CheckMerkleRoot()
+    mutable std::shared_ptr<const BlockMetadata> m_metadata; // GetBlockMetadata()
 
     CBlock()
     {
@@ -89,7 +115,7 @@ public:
 
     SERIALIZE_METHODS(CBlock, obj)
     {
-        READWRITE(AsBase<CBlockHeader>(obj), obj.vtx);
+        READWRITE(AsBase<CBlockHeader>(obj), Using<BlockTransactionsFormatter>(obj.vtx));
     }
 
     void SetNull()
@@ -99,6 +125,7 @@ public:
         fChecked = false;
         m_checked_witness_commitment = false;
         m_checked_merkle_root = false;
+        m_metadata.reset();
     }
 
     CBlockHeader GetBlockHeader() const
@@ -0,0 +1,110 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block_view.h>
+
+#include <hash.h>
+#include <serialize.h>
+#include <streams.h>
+
+#include <algorithm>
+#include <ios>
+
+uint64_t TxView::ReadCount(std::span<const std::byte>& data)
+{
+    SpanReader reader{data};
+    const uint64_t count{ReadCompactSize(reader)};
+    data = data.last(reader.size());
+    return count;
+}
+
+std::span<const unsigned char> TxView::ReadScript(std::span<const std::byte>& data)
+{
+    const uint64_t size{ReadCount(data)};
+    if (size > data.size()) throw std::ios_base::failure("TxView: end of data");
+    const auto script{UCharSpanCast(data.first(size))};
+    data = data.subspan(size);
+    return script;
+}
+
+TxView::TxView(std::span<const std::byte>& data)
+{
+    const size_t size_before{data.size()};
+    // Offset in the transaction of the next byte to be read.
+    const auto offset{[&] { return static_cast<uint32_t>(size_before - data.size()); }};
+    const auto skip{[&](size_t n) {
+        if (n > data.size()) throw std::ios_base::failure("TxView: end of data");
+        data = data.subspan(n);
+    }};
+    const auto tx_begin{data.data()};
+
+    skip(VERSION_SIZE);
+    m_vin_begin = offset();
+    uint64_t num_inputs{ReadCount(data)};
+    uint8_t flags{0};
+    if (num_inputs == 0) {
+        // The extended format, as in UnserializeTransaction: a dummy empty
+        // vin and the flags.
+        if (data.empty()) throw std::ios_base::failure("TxView: end of data");
+        flags = std::to_integer<uint8_t>(data[0]);
+        if (flags != 0) {
+            skip(1);
+            m_vin_begin = offset();
+            num_inputs = ReadCount(data);
+        }
+    }
+    for (uint64_t i{0}; i < num_inputs; ++i) {
+        skip(uint256::size() + sizeof(uint32_t)); // prevout
+        ReadScript(data);
+        skip(sizeof(uint32_t)); // nSequence
+    }
+    m_vout_begin = offset();
+    const uint64_t num_outputs{ReadCount(data)};
+    for (uint64_t i{0}; i < num_outputs; ++i) {
+        skip(sizeof(CAmount));
+        ReadScript(data);
+    }
+    m_witness_begin = offset();
+    if (flags & 1) {
+        for (uint64_t i{0}; i < num_inputs; ++i) {
+            const uint64_t num_items{ReadCount(data)};
+            for (uint64_t j{0}; j < num_items; ++j) ReadScript(data);
+        }
+        flags ^= 1;
+    }
+    if (flags) throw std::ios_base::failure("Unknown transaction optional data");
+    m_locktime_begin = offset();
+    skip(sizeof(uint32_t));
+    m_data = {tx_begin, offset()};
+    m_num_inputs = num_inputs;
+    m_num_outputs = num_outputs;
+}
+
+Txid TxView::GetHash() const
+{
+    HashWriter hasher{};
+    for (const auto part : NoWitnessParts()) hasher.write(part);
+    return Txid::FromUint256(hasher.GetHash());
+}
+
+Wtxid TxView::GetWitnessHash() const
+{
+    if (!HasWitness()) return Wtxid::FromUint256(GetHash().ToUint256());
+    HashWriter hasher{};
+    hasher.write(m_data);
+    return Wtxid::FromUint256(hasher.GetHash());
+}
+
+BlockView::BlockView(std::span<const std::byte> block)
+{
+    SpanReader reader{block};
+    reader >> m_header;
+    const uint64_t num_txs{ReadCompactSize(reader)};
+    m_prefix = block.first(block.size() - reader.size());
+    std::span<const std::byte> data{block.subspan(m_prefix.size())};
+    // Each transaction takes at least 10 bytes, so do not trust the count for
+    // the allocation more than the data.
+    m_txs.reserve(std::min<uint64_t>(num_txs, data.size() / 10));
+    for (uint64_t i{0}; i < num_txs; ++i) m_txs.emplace_back(data);
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+#define BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+
+#include <consensus/amount.h>
+#include <crypto/common.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <span.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * A view of a serialized transaction, which reads its fields from the
+ * serialization when they are asked for, without copying them.
+ *
+ * This is for code that only needs part of each transaction of a block, e.g.
+ * its hash or its output scripts, and would otherwise deserialize all of it,
+ * with the allocations of every script and witness stack. The serialization
+ * must outlive the view.
+ */
+class TxView
+{
+public:
+    /**
+     * Parse the transaction serialized with witness data at the start of
+     * `data`, and advance `data` past it.
+     *
+     * @throws std::ios_base::failure if it is not well formed, as when deserializing it.
+     */
+    explicit TxView(std::span<const std::byte>& data);
+
+    //! The whole serialization of the transaction, with witness data.
+    std::span<const std::byte> Data() const { return m_data; }
+    bool HasWitness() const { return m_vin_begin != VERSION_SIZE; }
+    uint32_t Version() const { return ReadLE32(UCharCast(m_data.data())); }
+    uint32_t LockTime() const { return ReadLE32(UCharCast(m_data.data() + m_locktime_begin)); }
+    size_t NumInputs() const { return m_num_inputs; }
+    size_t NumOutputs() const { return m_num_outputs; }
+
+    /**
+     * The parts of the serialization whose concatenation is the transaction
+     * serialized without witness data: the version, the inputs and outputs,
+     * and the lock time.
+     */
+    std::array<std::span<const std::byte>, 3> NoWitnessParts() const
+    {
+        return {m_data.first(VERSION_SIZE),
+                m_data.subspan(m_vin_begin, m_witness_begin - m_vin_begin),
+                m_data.subspan(m_locktime_begin)};
+    }
+
+    Txid GetHash() const;
+    Wtxid GetWitnessHash() const;
+
+    //! Call `fn(prevout, script_sig, sequence)` for each input, in order.
+    template <typename Fn>
+    void ForEachInput(Fn&& fn) const
+    {
+        std::span<const std::byte> data{m_data.subspan(m_vin_begin, m_vout_begin - m_vin_begin)};
+        ReadCount(data);
+        for (size_t i{0}; i < m_num_inputs; ++i) {
+            const COutPoint prevout{Txid::FromUint256(uint256{UCharSpanCast(data.first(uint256::size()))}),
+                                    ReadLE32(UCharCast(data.data() + uint256::size()))};
+            data = data.subspan(uint256::size() + sizeof(uint32_t));
+            const auto script_sig{ReadScript(data)};
+            const uint32_t sequence{ReadLE32(UCharCast(data.data()))};
+            data = data.subspan(sizeof(uint32_t));
+            fn(prevout, script_sig, sequence);
+        }
+    }
+
+    //! Call `fn(value, script_pubkey)` for each output, in order.
+    template <typename Fn>
+    void ForEachOutput(Fn&& fn) const
+    {
+        std::span<const std::byte> data{m_data.subspan(m_vout_begin, m_witness_begin - m_vout_begin)};
+        ReadCount(data);
+        for (size_t i{0}; i < m_num_outputs; ++i) {
+            const CAmount value{static_cast<CAmount>(ReadLE64(UCharCast(data.data())))};
+            data = data.subspan(sizeof(CAmount));
+            fn(value, ReadScript(data));
+        }
+    }
+
+private:
+    static constexpr size_t VERSION_SIZE{sizeof(uint32_t)};
+
+    //! Read a compact size from the start of `data` and advance past it.
+    static uint64_t ReadCount(std::span<const std::byte>& data);
+    //! Read a length-prefixed script from the start of `data` and advance past it.
+    static std::span<const unsigned char> ReadScript(std::span<const std::byte>& data);
+
+    std::span<const std::byte> m_data;
+    //! Offsets in m_data of the number of inputs, after the marker and flags if any.
+    uint32_t m_vin_begin;
+    //! Offset of the number of outputs.
+    uint32_t m_vout_begin;
+    //! Offset of the witness data, or of the lock time if there is none.
+    uint32_t m_witness_begin;
+    uint32_t m_locktime_begin;
+    uint32_t m_num_inputs;
+    uint32_t m_num_outputs;
+};
+
+/**
+ * A view of a serialized block (as stored on disk, with witness data), with
+ * its header and the boundaries of its transactions parsed when it is
+ * created. See TxView.
+ */
+class BlockView
+{
+public:
+    /** @throws std::ios_base::failure if the block is not well formed. */
+    explicit BlockView(std::span<const std::byte> block);
+
+    const CBlockHeader& Header() const { return m_header; }
+    //! The serialized header and number of transactions, which precede the transactions.
+    std::span<const std::byte> Prefix() const { return m_prefix; }
+    const std::vector<TxView>& Transactions() const { return m_txs; }
+
+private:
+    CBlockHeader m_header;
+    std::span<const std::byte> m_prefix;
+    std::vector<TxView> m_txs;
+};
+
+#endif // BITCOIN_PRIMITIVES_BLOCK_VIEW_H
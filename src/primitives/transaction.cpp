@@ -7,15 +7,20 @@
 
 #include <consensus/amount.h>
 #include <crypto/hex_base.h>
+#include <crypto/sha256.h>
 #include <hash.h>
 #include <script/script.h>
 #include <serialize.h>
+#include <streams.h>
+#include <support/allocators/monotonic_arena.h>
 #include <tinyformat.h>
 #include <uint256.h>
 #include <util/transaction_identifier.h>
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <new>
 #include <stdexcept>
 
 std::string COutPoint::ToString() const
@@ -94,6 +99,62 @@ Wtxid CTransaction::ComputeWitnessHash() const
 
 CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
 CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const Txid& hash, const Wtxid& witness_hash) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{hash}, m_witness_hash{witness_hash} {}
+
+namespace {
+//! Destroys a transaction allocated in a MonotonicArena, whose memory is freed with the arena.
+struct MonotonicArenaTxDeleter {
+    void operator()(const CTransaction* tx) const noexcept { tx->~CTransaction(); }
+};
+
+//! Arena memory per transaction, for the transaction and its shared_ptr control block.
+constexpr size_t ARENA_BYTES_PER_TX{sizeof(CTransaction) + 64};
+} // namespace
+
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs)
+{
+    if (txs.empty()) return {};
+
+    // Serialize the transactions, and those with a witness again with it, to
+    // hash all of them in one go.
+    std::vector<unsigned char> data;
+    std::vector<size_t> ends;
+    for (const CMutableTransaction& tx : txs) {
+        VectorWriter{data, data.size(), TX_NO_WITNESS(tx)};
+        ends.push_back(data.size());
+        if (tx.HasWitness()) {
+            VectorWriter{data, data.size(), TX_WITH_WITNESS(tx)};
+            ends.push_back(data.size());
+        }
+    }
+    std::vector<std::span<const unsigned char>> inputs;
+    inputs.reserve(ends.size());
+    size_t begin{0};
+    for (const size_t end : ends) {
+        inputs.emplace_back(data.data() + begin, end - begin);
+        begin = end;
+    }
+    std::vector<unsigned char> hashes(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256DMulti(hashes.data(), inputs);
+
+    // The transactions and their reference counts are allocated from one
+    // arena instead of twice per transaction, and freed at once when the last
+    // of them is freed.
+    const auto arena{std::make_shared<MonotonicArena>(txs.size() * ARENA_BYTES_PER_TX)};
+    const MonotonicArenaAllocator<CTransaction> allocator{arena};
+    std::vector<CTransactionRef> refs;
+    refs.reserve(txs.size());
+    const unsigned char* hash{hashes.data()};
+    for (CMutableTransaction& tx : txs) {
+        const Txid txid{Txid::FromUint256(uint256{std::span{hash, CSHA256::OUTPUT_SIZE}})};
+        if (tx.HasWitness()) hash += CSHA256::OUTPUT_SIZE;
+        const Wtxid wtxid{Wtxid::FromUint256(uint256{std::span{hash, CSHA256::OUTPUT_SIZE}})};
+        hash += CSHA256::OUTPUT_SIZE;
+        const CTransaction* ptx{new (arena->Allocate(sizeof(CTransaction), alignof(CTransaction))) CTransaction(std::move(tx), txid, wtxid)};
+        refs.emplace_back(ptx, MonotonicArenaTxDeleter{}, allocator);
+    }
+    return refs;
+}
 
 CAmount CTransaction::GetValueOut() const
 {
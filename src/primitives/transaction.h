@@ -319,6 +319,10 @@ private:
 
     bool ComputeHasWitness() const;
 
+    /** Convert a CMutableTransaction into a CTransaction with hashes computed by the caller. */
+    CTransaction(CMutableTransaction&& tx, const Txid& hash, const Wtxid& witness_hash);
+    friend std::vector<std::shared_ptr<const CTransaction>> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+
 public:
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
@@ -423,4 +427,11 @@ struct CMutableTransaction
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/** Convert many transactions at once, computing their hashes together, which
+ *  is faster on hardware hashing several messages in parallel. The
+ *  transactions are allocated together, and their memory is only freed once
+ *  all of them are, so holders of a transaction for a long time should keep a
+ *  copy of it instead. */
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+
 #endif // BITCOIN_PRIMITIVES_TRANSACTION_H
@@ -264,6 +264,22 @@ inline constexpr const char* WTXIDRELAY{"wtxidrelay"};
  * txreconciliation, as described by BIP 330.
  */
 inline constexpr const char* SENDTXRCNCL{"sendtxrcncl"};
+/**
+ * Contains a 2-byte local set size and a 2-byte q-coefficient, with which the
+ * initiator of a txreconciliation round requests a sketch of the peer's
+ * reconciliation set, as described by BIP 330.
+ */
+inline constexpr const char* REQRECON{"reqrecon"};
+/**
+ * Contains a sketch of the responder's reconciliation set, sent in response
+ * to a reqrecon message, as described by BIP 330.
+ */
+inline constexpr const char* SKETCH{"sketch"};
+/**
+ * Concludes a txreconciliation round: a 1-byte success flag and the short ids
+ * of the transactions the initiator is missing, as described by BIP 330.
+ */
+inline constexpr const char* RECONCILDIFF{"reconcildiff"};
 }; // namespace NetMsgType
 
 /** All known message types (see above). Keep this in the same order as the list of messages above. */
@@ -303,6 +319,9 @@ inline const std::array ALL_NET_MESSAGE_TYPES{std::to_array<std::string>({
     NetMsgType::CFCHECKPT,
     NetMsgType::WTXIDRELAY,
     NetMsgType::SENDTXRCNCL,
+    NetMsgType::REQRECON,
+    NetMsgType::SKETCH,
+    NetMsgType::RECONCILDIFF,
 })};
 
 /** nServices flags */
@@ -4,15 +4,26 @@
 
 #include <psbt.h>
 
+#include <common/system.h>
 #include <common/types.h>
 #include <node/types.h>
 #include <policy/policy.h>
 #include <script/signingprovider.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <vector>
 
 using common::PSBTError;
 
+//! Maximum number of threads signing the inputs of one PSBT.
+static constexpr int MAX_PSBT_SIGNING_THREADS{16};
+
 PartiallySignedTransaction::PartiallySignedTransaction(const CMutableTransaction& tx) : tx(tx)
 {
     inputs.resize(tx.vin.size());
@@ -298,7 +309,7 @@ bool PSBTInputSigned(const PSBTInput& input)
     return !input.final_script_sig.empty() || !input.final_script_witness.IsNull();
 }
 
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
 {
     CTxOut utxo;
     assert(psbt.inputs.size() >= input_index);
@@ -487,6 +498,34 @@ PSBTError SignPSBTInput(const SigningProvider& provider, PartiallySignedTransact
     return sig_complete ? PSBTError::OK : PSBTError::INCOMPLETE;
 }
 
+void ForEachPSBTInput(const PartiallySignedTransaction& psbt, const std::function<void(unsigned int)>& fn)
+{
+    const unsigned int count = psbt.inputs.size();
+    const unsigned int threads = count < MIN_PARALLEL_PSBT_INPUTS ? 1 : std::clamp(GetNumCores(), 1, MAX_PSBT_SIGNING_THREADS);
+    if (threads == 1) {
+        for (unsigned int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    ThreadPool pool{"psbtsign"};
+    pool.Start(threads - 1);
+    std::vector<std::future<void>> futures;
+    futures.reserve(threads - 1);
+    for (unsigned int task = 1; task < threads; ++task) {
+        futures.push_back(pool.Submit([&fn, task, threads, count] {
+            for (unsigned int i = task; i < count; i += threads) fn(i);
+        }));
+    }
+    std::exception_ptr error;
+    try {
+        for (unsigned int i = 0; i < count; i += threads) fn(i);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) future.wait();
+    if (error) std::rethrow_exception(error);
+    for (auto& future : futures) future.get();
+}
+
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx)
 {
     // Figure out if any non_witness_utxos should be dropped
@@ -530,12 +569,14 @@ bool FinalizePSBT(PartiallySignedTransaction& psbtx)
     //   signature, but have not combined them yet (e.g. because the combiner that created this
     //   PartiallySignedTransaction did not understand them), this will combine them into a final
     //   script.
-    bool complete = true;
+    std::atomic<bool> complete{true};
     const PrecomputedTransactionData txdata = PrecomputePSBTData(psbtx);
-    for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
+    ForEachPSBTInput(psbtx, [&](unsigned int i) {
         PSBTInput& input = psbtx.inputs.at(i);
-        complete &= (SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, input.sighash_type, nullptr, true) == PSBTError::OK);
-    }
+        if (SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, input.sighash_type, nullptr, true) != PSBTError::OK) {
+            complete = false;
+        }
+    });
 
     return complete;
 }
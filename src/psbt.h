@@ -16,6 +16,7 @@
 #include <span.h>
 #include <streams.h>
 
+#include <functional>
 #include <optional>
 
 namespace node {
@@ -1397,7 +1398,7 @@ PrecomputedTransactionData PrecomputePSBTData(const PartiallySignedTransaction&
 bool PSBTInputSigned(const PSBTInput& input);
 
 /** Checks whether a PSBTInput is already signed by doing script verification using final fields. */
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
 
 /** Signs a PSBTInput, verifying that all provided data matches what is being signed.
  *
@@ -1406,6 +1407,18 @@ bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned
  **/
 [[nodiscard]] PSBTError SignPSBTInput(const SigningProvider& provider, PartiallySignedTransaction& psbt, int index, const PrecomputedTransactionData* txdata, std::optional<int> sighash = std::nullopt, SignatureData* out_sigdata = nullptr, bool finalize = true);
 
+/** PSBTs with at least this many inputs have them signed on several threads. */
+static constexpr size_t MIN_PARALLEL_PSBT_INPUTS{64};
+
+/**
+ * Call fn(index) for every input of a PSBT and wait for all calls to return.
+ * For PSBTs with at least MIN_PARALLEL_PSBT_INPUTS inputs the calls run on
+ * several threads, so fn may only modify the input it is given (as
+ * SignPSBTInput does). An exception thrown by fn is rethrown once all calls
+ * have finished.
+ */
+void ForEachPSBTInput(const PartiallySignedTransaction& psbt, const std::function<void(unsigned int)>& fn);
+
 /**  Reduces the size of the PSBT by dropping unnecessary `non_witness_utxos` (i.e. complete previous transactions) from a psbt when all inputs are segwit v1. */
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx);
 
@@ -55,6 +55,7 @@ ClientModel::ClientModel(interfaces::Node& node, OptionsModel *_optionsModel, QO
         // the following calls will acquire the required lock
         Q_EMIT mempoolSizeChanged(m_node.getMempoolSize(), m_node.getMempoolDynamicUsage(), m_node.getMempoolMaxUsage());
         Q_EMIT bytesChanged(m_node.getTotalBytesRecv(), m_node.getTotalBytesSent());
+        EmitPendingTipNotifications();
     });
     connect(m_thread, &QThread::finished, timer, &QObject::deleteLater);
     connect(m_thread, &QThread::started, [timer] { timer->start(); });
@@ -234,18 +235,39 @@ void ClientModel::TipChanged(SynchronizationState sync_state, interfaces::BlockT
         WITH_LOCK(m_cached_tip_mutex, m_cached_tip_blocks = tip.block_hash;);
     }
 
-    // Throttle GUI notifications about (a) blocks during initial sync, and (b) both blocks and headers during reindex.
-    const bool throttle = (sync_state != SynchronizationState::POST_INIT && synctype == SyncType::BLOCK_SYNC) || sync_state == SynchronizationState::INIT_REINDEX;
+    // Throttle GUI notifications about blocks and headers during initial sync and reindex.
+    // A throttled notification is not dropped, but coalesced with the following ones
+    // and emitted by the polling timer, so the GUI ends up showing the latest tip.
+    const bool throttle = sync_state != SynchronizationState::POST_INIT;
     const auto now{throttle ? SteadyClock::now() : SteadyClock::time_point{}};
     auto& nLastUpdateNotification = synctype != SyncType::BLOCK_SYNC ? g_last_header_tip_update_notification : g_last_block_tip_update_notification;
+    const TipNotification notification{tip.block_height, tip.block_time, verification_progress, synctype, sync_state};
+    LOCK(m_pending_tip_mutex);
+    auto& pending{synctype != SyncType::BLOCK_SYNC ? m_pending_header_tip : m_pending_block_tip};
     if (throttle && now < nLastUpdateNotification + MODEL_UPDATE_DELAY) {
+        pending = notification;
         return;
     }
 
-    Q_EMIT numBlocksChanged(tip.block_height, QDateTime::fromSecsSinceEpoch(tip.block_time), verification_progress, synctype, sync_state);
+    pending.reset();
+    EmitTipNotification(notification);
     nLastUpdateNotification = now;
 }
 
+void ClientModel::EmitTipNotification(const TipNotification& notification)
+{
+    Q_EMIT numBlocksChanged(notification.height, QDateTime::fromSecsSinceEpoch(notification.block_time), notification.verification_progress, notification.synctype, notification.sync_state);
+}
+
+void ClientModel::EmitPendingTipNotifications()
+{
+    LOCK(m_pending_tip_mutex);
+    for (auto* pending : {&m_pending_header_tip, &m_pending_block_tip}) {
+        if (*pending) EmitTipNotification(**pending);
+        pending->reset();
+    }
+}
+
 void ClientModel::subscribeToCoreSignals()
 {
     m_event_handlers.emplace_back(m_node.handleShowProgress(
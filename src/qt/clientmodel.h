@@ -9,7 +9,9 @@
 #include <QDateTime>
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <sync.h>
 #include <uint256.h>
 
@@ -110,7 +112,22 @@ private:
     //! A thread to interact with m_node asynchronously
     QThread* const m_thread;
 
-    void TipChanged(SynchronizationState sync_state, interfaces::BlockTip tip, double verification_progress, SyncType synctype) EXCLUSIVE_LOCKS_REQUIRED(!m_cached_tip_mutex);
+    //! Arguments of a numBlocksChanged() notification
+    struct TipNotification {
+        int height;
+        int64_t block_time;
+        double verification_progress;
+        SyncType synctype;
+        SynchronizationState sync_state;
+    };
+    Mutex m_pending_tip_mutex;
+    //! Latest throttled header and block tip notifications, emitted by the polling timer unless superseded
+    std::optional<TipNotification> m_pending_header_tip GUARDED_BY(m_pending_tip_mutex);
+    std::optional<TipNotification> m_pending_block_tip GUARDED_BY(m_pending_tip_mutex);
+
+    void TipChanged(SynchronizationState sync_state, interfaces::BlockTip tip, double verification_progress, SyncType synctype) EXCLUSIVE_LOCKS_REQUIRED(!m_cached_tip_mutex, !m_pending_tip_mutex);
+    void EmitTipNotification(const TipNotification& notification) EXCLUSIVE_LOCKS_REQUIRED(m_pending_tip_mutex);
+    void EmitPendingTipNotifications() EXCLUSIVE_LOCKS_REQUIRED(!m_pending_tip_mutex);
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
 
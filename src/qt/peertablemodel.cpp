@@ -10,6 +10,7 @@
 #include <interfaces/node.h>
 
 #include <utility>
+#include <vector>
 
 #include <QList>
 #include <QTimer>
@@ -148,6 +149,20 @@ QModelIndex PeerTableModel::index(int row, int column, const QModelIndex& parent
     return QModelIndex();
 }
 
+/** Whether the statistics of a peer displayed in the table are the same. */
+static bool DisplayedStatsEqual(const CNodeStats& a, const CNodeStats& b)
+{
+    return a.m_connected == b.m_connected &&
+           a.m_addr_name == b.m_addr_name &&
+           a.fInbound == b.fInbound &&
+           a.m_conn_type == b.m_conn_type &&
+           a.m_network == b.m_network &&
+           a.m_min_ping_time == b.m_min_ping_time &&
+           a.nSendBytes == b.nSendBytes &&
+           a.nRecvBytes == b.nRecvBytes &&
+           a.cleanSubVer == b.cleanSubVer;
+}
+
 void PeerTableModel::refresh()
 {
     interfaces::Node::NodesStats nodes_stats;
@@ -175,6 +190,12 @@ void PeerTableModel::refresh()
         endRemoveRows();
     }
 
+    // The rows kept in the table whose displayed statistics changed.
+    std::vector<bool> changed(m_peers_data.size());
+    for (int i = 0; i < m_peers_data.size(); ++i) {
+        changed[i] = !DisplayedStatsEqual(m_peers_data.at(i).nodeStats, new_peers_data.at(i).nodeStats);
+    }
+
     if (m_peers_data.size() < new_peers_data.size()) {
         // Some peers have been added to the end of the table.
         beginInsertRows(QModelIndex(), m_peers_data.size(), new_peers_data.size() - 1);
@@ -184,7 +205,18 @@ void PeerTableModel::refresh()
         m_peers_data.swap(new_peers_data);
     }
 
-    const auto top_left = index(0, 0);
-    const auto bottom_right = index(rowCount() - 1, columnCount() - 1);
-    Q_EMIT dataChanged(top_left, bottom_right);
+    if (rowCount() == 0) return;
+    // The age of every peer changes with time, the other columns only when their
+    // statistics did, which avoids sorting all rows again on every refresh.
+    Q_EMIT dataChanged(index(0, Age), index(rowCount() - 1, Age));
+    for (size_t begin = 0; begin < changed.size();) {
+        if (!changed[begin]) {
+            ++begin;
+            continue;
+        }
+        size_t end = begin + 1;
+        while (end < changed.size() && changed[end]) ++end;
+        Q_EMIT dataChanged(index(begin, 0), index(end - 1, columnCount() - 1));
+        begin = end;
+    }
 }
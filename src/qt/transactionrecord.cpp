@@ -212,6 +212,11 @@ bool TransactionRecord::statusUpdateNeeded(const uint256& block_hash) const
     return status.m_cur_block_hash != block_hash || status.needsUpdate;
 }
 
+bool TransactionRecord::statusSettled() const
+{
+    return !status.m_cur_block_hash.IsNull() && !status.needsUpdate && status.status == TransactionStatus::Confirmed;
+}
+
 QString TransactionRecord::getTxHash() const
 {
     return QString::fromStdString(hash.ToString());
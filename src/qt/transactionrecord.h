@@ -128,6 +128,11 @@ public:
     /** Return whether a status update is needed.
      */
     bool statusUpdateNeeded(const uint256& block_hash) const;
+
+    /** Return whether the cached status no longer changes as blocks come in,
+     * only on a change of the transaction notified by the wallet, e.g. in a reorg.
+     */
+    bool statusSettled() const;
 };
 
 #endif // BITCOIN_QT_TRANSACTIONRECORD_H
@@ -196,12 +196,15 @@ public:
             parent->endRemoveRows();
             break;
         case CT_UPDATED:
-            // Miscellaneous updates -- nothing to do, status update will take care of this, and is only computed for
-            // visible transactions.
+            // Miscellaneous updates -- status update will take care of this, and is only computed for
+            // visible transactions. Still signal the change, as updateConfirmations() skips settled rows.
             for (int i = lowerIndex; i < upperIndex; i++) {
                 TransactionRecord *rec = &cachedWallet[i];
                 rec->status.needsUpdate = true;
             }
+            if (inModel) {
+                Q_EMIT parent->dataChanged(parent->index(lowerIndex, TransactionTableModel::Status), parent->index(upperIndex - 1, TransactionTableModel::Amount));
+            }
             break;
         }
     }
@@ -284,10 +287,20 @@ void TransactionTableModel::updateConfirmations()
 {
     // Blocks came in since last poll.
     // Invalidate status (number of confirmations) and (possibly) description
-    //  for all rows. Qt is smart enough to only actually request the data for the
-    //  visible rows.
-    Q_EMIT dataChanged(index(0, Status), index(priv->size()-1, Status));
-    Q_EMIT dataChanged(index(0, ToAddress), index(priv->size()-1, ToAddress));
+    //  for the rows whose status is not settled yet. The proxy models filter and
+    //  sort every changed row again, which refreshes its status from the wallet,
+    //  so signalling all rows makes each block slow on large wallets. Settled rows
+    //  still get a fresh status whenever they are displayed.
+    int begin = -1;
+    for (int i = 0; i <= priv->size(); ++i) {
+        const bool settled = i == priv->size() || priv->cachedWallet[i].statusSettled();
+        if (!settled && begin < 0) begin = i;
+        if (settled && begin >= 0) {
+            Q_EMIT dataChanged(index(begin, Status), index(i - 1, Status));
+            Q_EMIT dataChanged(index(begin, ToAddress), index(i - 1, ToAddress));
+            begin = -1;
+        }
+    }
 }
 
 int TransactionTableModel::rowCount(const QModelIndex &parent) const
@@ -620,22 +620,52 @@ void FastRandomContext::RandomSeed() noexcept
 {
     uint256 seed = GetRandHash();
     rng.SetKey(MakeByteSpan(seed));
+    m_bufleft = 0;
     requires_seed = false;
 }
 
+void FastRandomContext::Refill() noexcept
+{
+    const size_t size{m_refill_blocks * ChaCha20Aligned::BLOCKLEN};
+    rng.Keystream(std::span{m_buffer}.last(size));
+    m_bufleft = size;
+    m_refill_blocks = std::min(m_refill_blocks * 2, BUFFER_BLOCKS);
+}
+
 void FastRandomContext::fillrand(std::span<std::byte> output) noexcept
 {
     if (requires_seed) RandomSeed();
-    rng.Keystream(output);
+    // Consume the buffered keystream first, so that the output is the same as
+    // that of an unbuffered ChaCha20.
+    const size_t reuse{std::min(m_bufleft, output.size())};
+    std::copy_n(m_buffer.end() - m_bufleft, reuse, output.begin());
+    m_bufleft -= reuse;
+    output = output.subspan(reuse);
+    if (output.size() >= ChaCha20Aligned::BLOCKLEN) {
+        const size_t blocks{output.size() / ChaCha20Aligned::BLOCKLEN};
+        rng.Keystream(output.first(blocks * ChaCha20Aligned::BLOCKLEN));
+        output = output.subspan(blocks * ChaCha20Aligned::BLOCKLEN);
+    }
+    if (!output.empty()) {
+        Refill();
+        std::copy_n(m_buffer.end() - m_bufleft, output.size(), output.begin());
+        m_bufleft -= output.size();
+    }
 }
 
 FastRandomContext::FastRandomContext(const uint256& seed) noexcept : requires_seed(false), rng(MakeByteSpan(seed)) {}
 
+FastRandomContext::~FastRandomContext()
+{
+    memory_cleanse(m_buffer.data(), m_buffer.size());
+}
+
 void FastRandomContext::Reseed(const uint256& seed) noexcept
 {
     FlushCache();
     requires_seed = false;
     rng = {MakeByteSpan(seed)};
+    m_bufleft = 0;
 }
 
 bool Random_SanityCheck()
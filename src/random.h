@@ -375,11 +375,24 @@ public:
  */
 class FastRandomContext : public RandomMixin<FastRandomContext>
 {
+public:
+    /** Maximum number of keystream blocks generated ahead of use, enough for one call into
+     *  the widest (16-way) ChaCha20 implementation. */
+    static constexpr size_t BUFFER_BLOCKS{16};
+
 private:
     bool requires_seed;
-    ChaCha20 rng;
+    ChaCha20Aligned rng;
+    /** Keystream generated ahead of use, so that refills can use the multi-block ChaCha20
+     *  implementations. Its last m_bufleft bytes are unused. */
+    std::array<std::byte, BUFFER_BLOCKS * ChaCha20Aligned::BLOCKLEN> m_buffer;
+    size_t m_bufleft{0};
+    /** Blocks generated by the next refill. This doubles with every refill up to
+     *  BUFFER_BLOCKS, so that short-lived contexts do not compute blocks they never use. */
+    size_t m_refill_blocks{1};
 
     void RandomSeed() noexcept;
+    void Refill() noexcept;
 
 public:
     /** Construct a FastRandomContext with GetRandHash()-based entropy (or zero key if fDeterministic). */
@@ -388,15 +401,22 @@ public:
     /** Initialize with explicit seed (only for testing) */
     explicit FastRandomContext(const uint256& seed) noexcept;
 
+    /** Destructor to clean up the buffered keystream. */
+    ~FastRandomContext();
+
     /** Reseed with explicit seed (only for testing). */
     void Reseed(const uint256& seed) noexcept;
 
     /** Generate a random 64-bit integer. */
     uint64_t rand64() noexcept
     {
-        if (requires_seed) RandomSeed();
+        if (m_bufleft >= 8) {
+            const uint64_t ret{ReadLE64(m_buffer.data() + m_buffer.size() - m_bufleft)};
+            m_bufleft -= 8;
+            return ret;
+        }
         std::array<std::byte, 8> buf;
-        rng.Keystream(buf);
+        fillrand(buf);
         return ReadLE64(buf.data());
     }
 
@@ -14,8 +14,10 @@
 #include <flatfile.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/scripthashindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
+#include <node/coin.h>
 #include <node/context.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -31,19 +33,30 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <any>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include <univalue.h>
 
+using node::CoinsLookup;
 using node::GetTransaction;
+using node::LookupCoins;
+using node::MAX_COINS_LOOKUP;
 using node::NodeContext;
+using node::SerializeCoinsLookup;
 using util::SplitString;
 
-static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+/** Confirmations after which responses about a block or its transactions are served as immutable */
+static constexpr int REST_IMMUTABLE_MIN_CONFIRMATIONS{6};
 
 static const struct {
     RESTResponseFormat rf;
@@ -55,20 +68,6 @@ static const struct {
       {RESTResponseFormat::JSON, "json"},
 };
 
-struct CCoin {
-    uint32_t nHeight;
-    CTxOut out;
-
-    CCoin() : nHeight(0) {}
-    explicit CCoin(Coin&& in) : nHeight(in.nHeight), out(std::move(in.out)) {}
-
-    SERIALIZE_METHODS(CCoin, obj)
-    {
-        uint32_t nTxVerDummy = 0;
-        READWRITE(nTxVerDummy, obj.nHeight, obj.out);
-    }
-};
-
 static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, std::string message)
 {
     req->WriteHeader("Content-Type", "text/plain");
@@ -160,6 +159,114 @@ RESTResponseFormat ParseDataFormat(std::string& param, const std::string& strReq
     return RESTResponseFormat::UNDEF;
 }
 
+bool ETagMatches(std::string_view if_none_match, std::string_view etag)
+{
+    for (std::string_view tag : SplitString(if_none_match, ',')) {
+        tag = util::TrimStringView(tag);
+        // If-None-Match uses the weak comparison
+        if (tag.starts_with("W/")) tag.remove_prefix(2);
+        if (tag == "*" || tag == etag) return true;
+    }
+    return false;
+}
+
+std::optional<ByteRange> ParseByteRange(std::string_view range, size_t size, bool& unsatisfiable)
+{
+    unsatisfiable = false;
+    range = util::TrimStringView(range);
+    if (!range.starts_with("bytes=")) return std::nullopt;
+    range.remove_prefix(6);
+    const size_t dash{range.find('-')};
+    if (dash == std::string_view::npos || range.find(',') != std::string_view::npos) return std::nullopt;
+    const std::string_view first_str{util::TrimStringView(range.substr(0, dash))};
+    const std::string_view last_str{util::TrimStringView(range.substr(dash + 1))};
+    if (first_str.empty()) {
+        // Suffix range: the last n bytes
+        const auto suffix{ToIntegral<uint64_t>(last_str)};
+        if (!suffix) return std::nullopt;
+        if (*suffix == 0 || size == 0) {
+            unsatisfiable = true;
+            return std::nullopt;
+        }
+        return ByteRange{size - std::min<uint64_t>(*suffix, size), size - 1};
+    }
+    const auto first{ToIntegral<uint64_t>(first_str)};
+    if (!first) return std::nullopt;
+    uint64_t last{std::numeric_limits<uint64_t>::max()};
+    if (!last_str.empty()) {
+        const auto parsed{ToIntegral<uint64_t>(last_str)};
+        if (!parsed || *parsed < *first) return std::nullopt;
+        last = *parsed;
+    }
+    if (*first >= size) {
+        unsatisfiable = true;
+        return std::nullopt;
+    }
+    return ByteRange{size_t(*first), size_t(std::min<uint64_t>(last, size - 1))};
+}
+
+/** Strong ETag of a REST response that is fully determined by `resource` and the format. */
+static std::string MakeETag(std::string_view resource, RESTResponseFormat rf)
+{
+    for (const auto& rf_name : rf_names) {
+        if (rf_name.rf == rf) return strprintf("\"%s.%s\"", resource, rf_name.name);
+    }
+    return strprintf("\"%s\"", resource);
+}
+
+/** Whether a block is in the active chain, with enough confirmations for its data to be served as immutable */
+static bool IsImmutable(const ChainstateManager& chainman, const CBlockIndex& block_index) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    const CChain& chain{chainman.ActiveChain()};
+    return chain.Contains(&block_index) && chain.Height() - block_index.nHeight + 1 >= REST_IMMUTABLE_MIN_CONFIRMATIONS;
+}
+
+/**
+ * Write the caching headers for a response with the given ETag. Immutable
+ * responses may be cached indefinitely, others have to be revalidated.
+ */
+static void WriteCacheHeaders(HTTPRequest* req, const std::string& etag, bool immutable)
+{
+    req->WriteHeader("ETag", etag);
+    req->WriteHeader("Cache-Control", immutable ? "public, max-age=31536000, immutable" : "no-cache");
+}
+
+/** Reply 304 Not Modified if the client already has the response with the given ETag. */
+static bool ReplyIfNotModified(HTTPRequest* req, const std::string& etag, bool immutable)
+{
+    const auto if_none_match{req->GetHeader("if-none-match")};
+    if (!if_none_match.first || !ETagMatches(if_none_match.second, etag)) return false;
+    WriteCacheHeaders(req, etag, immutable);
+    req->WriteReply(HTTP_NOT_MODIFIED);
+    return true;
+}
+
+/**
+ * Reply with `data`, or the part of it requested by a Range header, unless an
+ * If-Range header names a different version.
+ */
+static void WriteRangeReply(HTTPRequest* req, std::span<const std::byte> data, const std::string& etag)
+{
+    req->WriteHeader("Accept-Ranges", "bytes");
+    const auto range_header{req->GetHeader("range")};
+    const auto if_range{req->GetHeader("if-range")};
+    if (range_header.first && (!if_range.first || util::TrimStringView(if_range.second) == etag)) {
+        bool unsatisfiable;
+        const auto range{ParseByteRange(range_header.second, data.size(), unsatisfiable)};
+        if (unsatisfiable) {
+            req->WriteHeader("Content-Range", strprintf("bytes */%u", data.size()));
+            req->WriteReply(HTTP_RANGE_NOT_SATISFIABLE);
+            return;
+        }
+        if (range) {
+            req->WriteHeader("Content-Range", strprintf("bytes %u-%u/%u", range->first, range->last, data.size()));
+            req->WriteReply(HTTP_PARTIAL_CONTENT, data.subspan(range->first, range->last - range->first + 1));
+            return;
+        }
+    }
+    req->WriteReply(HTTP_OK, data);
+}
+
 static std::string AvailableDataFormatsString()
 {
     std::string formats;
@@ -351,6 +458,11 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
+    // The spent outputs of a block never change.
+    const std::string etag{MakeETag(hashStr + ".spenttxouts", rf)};
+    const bool immutable{WITH_LOCK(cs_main, return IsImmutable(*chainman, *pblockindex))};
+    if (ReplyIfNotModified(req, etag, immutable)) return true;
+
     CBlockUndo block_undo;
     if (pblockindex->nHeight > 0 && !chainman->m_blockman.ReadBlockUndo(block_undo, *pblockindex)) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " undo not available");
@@ -361,6 +473,7 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         DataStream ssSpentResponse{};
         SerializeBlockUndo(ssSpentResponse, block_undo);
         req->WriteHeader("Content-Type", "application/octet-stream");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, ssSpentResponse);
         return true;
     }
@@ -370,6 +483,7 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         SerializeBlockUndo(ssSpentResponse, block_undo);
         const std::string strHex{HexStr(ssSpentResponse) + "\n"};
         req->WriteHeader("Content-Type", "text/plain");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
@@ -379,6 +493,7 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         BlockUndoToJSON(block_undo, result);
         std::string strJSON = result.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strJSON);
         return true;
     }
@@ -407,6 +522,7 @@ static bool rest_block(const std::any& context,
     FlatFilePos pos{};
     const CBlockIndex* pblockindex = nullptr;
     const CBlockIndex* tip = nullptr;
+    bool immutable{false};
     ChainstateManager* maybe_chainman = GetChainman(context, req);
     if (!maybe_chainman) return false;
     ChainstateManager& chainman = *maybe_chainman;
@@ -424,8 +540,14 @@ static bool rest_block(const std::any& context,
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (not fully downloaded)");
         }
         pos = pblockindex->GetBlockPos();
+        immutable = IsImmutable(chainman, *pblockindex);
     }
 
+    // The serialized block never changes, unlike the JSON with its confirmations.
+    const std::string etag{MakeETag(hashStr, rf)};
+    const bool cacheable{rf == RESTResponseFormat::BINARY || rf == RESTResponseFormat::HEX};
+    if (cacheable && ReplyIfNotModified(req, etag, immutable)) return true;
+
     std::vector<std::byte> block_data{};
     if (!chainman.m_blockman.ReadRawBlock(block_data, pos)) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
@@ -434,13 +556,15 @@ static bool rest_block(const std::any& context,
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         req->WriteHeader("Content-Type", "application/octet-stream");
-        req->WriteReply(HTTP_OK, block_data);
+        WriteCacheHeaders(req, etag, immutable);
+        WriteRangeReply(req, block_data, etag);
         return true;
     }
 
     case RESTResponseFormat::HEX: {
         const std::string strHex{HexStr(block_data) + "\n"};
         req->WriteHeader("Content-Type", "text/plain");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
@@ -624,6 +748,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
 
     const CBlockIndex* block_index;
     bool block_was_connected;
+    bool immutable;
     {
         ChainstateManager* maybe_chainman = GetChainman(context, req);
         if (!maybe_chainman) return false;
@@ -634,8 +759,13 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
             return RESTERR(req, HTTP_NOT_FOUND, uri_parts[1] + " not found");
         }
         block_was_connected = block_index->IsValid(BLOCK_VALID_SCRIPTS);
+        immutable = IsImmutable(chainman, *block_index);
     }
 
+    // The filter of a block never changes.
+    const std::string etag{MakeETag(uri_parts[1] + "." + uri_parts[0], rf)};
+    if (ReplyIfNotModified(req, etag, immutable)) return true;
+
     bool index_ready = index->BlockUntilSyncedToCurrentChain();
 
     BlockFilter filter;
@@ -659,6 +789,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
         ssResp << filter;
 
         req->WriteHeader("Content-Type", "application/octet-stream");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, ssResp);
         return true;
     }
@@ -668,6 +799,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
 
         std::string strHex = HexStr(ssResp) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
@@ -676,6 +808,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
         ret.pushKV("filter", HexStr(filter.GetEncodedFilter()));
         std::string strJSON = ret.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strJSON);
         return true;
     }
@@ -761,14 +894,29 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
 
     std::string param;
     const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
-    if (param != "contents" && param != "info") {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents>.json");
+    if (param != "contents" && param != "info" && param != "delta") {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents|delta>.json");
     }
 
     const CTxMemPool* mempool = GetMemPool(context, req);
     if (!mempool) return false;
 
     switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        if (param != "contents") {
+            return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+        }
+        const std::vector<std::byte> txids{MempoolTxidsToBinary(*mempool)};
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, txids);
+        } else {
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, HexStr(txids) + "\n");
+        }
+        return true;
+    }
     case RESTResponseFormat::JSON: {
         std::string str_json;
         if (param == "contents") {
@@ -796,6 +944,18 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
             str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+        } else if (param == "delta") {
+            std::optional<std::string> raw_since;
+            try {
+                raw_since = req->GetQueryParameter("since");
+            } catch (const std::runtime_error& e) {
+                return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+            }
+            const auto since{raw_since ? ToIntegral<uint64_t>(*raw_since) : std::nullopt};
+            if (!since) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "The \"since\" query parameter must be a mempool sequence value.");
+            }
+            str_json = MempoolChangesToJSON(*mempool, *since).write() + "\n";
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
         }
@@ -834,12 +994,24 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
+    // The response is determined by the witness and the block hash, which may change until the
+    // transaction is deeply confirmed.
+    const std::string etag{MakeETag(tx->GetWitnessHash().GetHex() + (hashBlock.IsNull() ? "" : "." + hashBlock.GetHex()), rf)};
+    bool immutable{false};
+    if (!hashBlock.IsNull()) {
+        LOCK(cs_main);
+        const CBlockIndex* block_index{node->chainman->m_blockman.LookupBlockIndex(hashBlock)};
+        immutable = block_index && IsImmutable(*node->chainman, *block_index);
+    }
+    if (ReplyIfNotModified(req, etag, immutable)) return true;
+
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         DataStream ssTx;
         ssTx << TX_WITH_WITNESS(tx);
 
         req->WriteHeader("Content-Type", "application/octet-stream");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, ssTx);
         return true;
     }
@@ -850,6 +1022,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
 
         std::string strHex = HexStr(ssTx) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
@@ -859,6 +1032,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         TxToUniv(*tx, /*block_hash=*/hashBlock, /*entry=*/ objTx);
         std::string strJSON = objTx.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
+        WriteCacheHeaders(req, etag, immutable);
         req->WriteReply(HTTP_OK, strJSON);
         return true;
     }
@@ -961,67 +1135,28 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
     }
 
     // limit max outpoints
-    if (vOutPoints.size() > MAX_GETUTXOS_OUTPOINTS)
-        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Error: max outpoints exceeded (max: %d, tried: %d)", MAX_GETUTXOS_OUTPOINTS, vOutPoints.size()));
-
-    // check spentness and form a bitmap (as well as a JSON capable human-readable string representation)
-    std::vector<unsigned char> bitmap;
-    std::vector<CCoin> outs;
-    std::string bitmapStringRepresentation;
-    std::vector<bool> hits;
-    bitmap.resize((vOutPoints.size() + 7) / 8);
+    if (vOutPoints.size() > MAX_COINS_LOOKUP)
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Error: max outpoints exceeded (max: %d, tried: %d)", MAX_COINS_LOOKUP, vOutPoints.size()));
+
     ChainstateManager* maybe_chainman = GetChainman(context, req);
     if (!maybe_chainman) return false;
-    ChainstateManager& chainman = *maybe_chainman;
-    decltype(chainman.ActiveHeight()) active_height;
-    uint256 active_hash;
-    {
-        auto process_utxos = [&vOutPoints, &outs, &hits, &active_height, &active_hash, &chainman](const CCoinsView& view, const CTxMemPool* mempool) EXCLUSIVE_LOCKS_REQUIRED(chainman.GetMutex()) {
-            for (const COutPoint& vOutPoint : vOutPoints) {
-                auto coin = !mempool || !mempool->isSpent(vOutPoint) ? view.GetCoin(vOutPoint) : std::nullopt;
-                hits.push_back(coin.has_value());
-                if (coin) outs.emplace_back(std::move(*coin));
-            }
-            active_height = chainman.ActiveHeight();
-            active_hash = chainman.ActiveTip()->GetBlockHash();
-        };
-
-        if (fCheckMemPool) {
-            const CTxMemPool* mempool = GetMemPool(context, req);
-            if (!mempool) return false;
-            // use db+mempool as cache backend in case user likes to query mempool
-            LOCK2(cs_main, mempool->cs);
-            CCoinsViewCache& viewChain = chainman.ActiveChainstate().CoinsTip();
-            CCoinsViewMemPool viewMempool(&viewChain, *mempool);
-            process_utxos(viewMempool, mempool);
-        } else {
-            LOCK(cs_main);
-            process_utxos(chainman.ActiveChainstate().CoinsTip(), nullptr);
-        }
-
-        for (size_t i = 0; i < hits.size(); ++i) {
-            const bool hit = hits[i];
-            bitmapStringRepresentation.append(hit ? "1" : "0"); // form a binary string representation (human-readable for json output)
-            bitmap[i / 8] |= ((uint8_t)hit) << (i % 8);
-        }
+    const CTxMemPool* mempool{nullptr};
+    if (fCheckMemPool) {
+        mempool = GetMemPool(context, req);
+        if (!mempool) return false;
     }
+    const CoinsLookup lookup{LookupCoins(*maybe_chainman, mempool, vOutPoints)};
 
     switch (rf) {
     case RESTResponseFormat::BINARY: {
-        // serialize data
         // use exact same output as mentioned in Bip64
-        DataStream ssGetUTXOResponse{};
-        ssGetUTXOResponse << active_height << active_hash << bitmap << outs;
-
         req->WriteHeader("Content-Type", "application/octet-stream");
-        req->WriteReply(HTTP_OK, ssGetUTXOResponse);
+        req->WriteReply(HTTP_OK, SerializeCoinsLookup(lookup));
         return true;
     }
 
     case RESTResponseFormat::HEX: {
-        DataStream ssGetUTXOResponse{};
-        ssGetUTXOResponse << active_height << active_hash << bitmap << outs;
-        std::string strHex = HexStr(ssGetUTXOResponse) + "\n";
+        std::string strHex = HexStr(SerializeCoinsLookup(lookup)) + "\n";
 
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
@@ -1033,22 +1168,25 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
 
         // pack in some essentials
         // use more or less the same output as mentioned in Bip64
-        objGetUTXOResponse.pushKV("chainHeight", active_height);
-        objGetUTXOResponse.pushKV("chaintipHash", active_hash.GetHex());
-        objGetUTXOResponse.pushKV("bitmap", bitmapStringRepresentation);
-
+        objGetUTXOResponse.pushKV("chainHeight", lookup.height);
+        objGetUTXOResponse.pushKV("chaintipHash", lookup.tip_hash.GetHex());
+        // form a binary string representation (human-readable for json output)
+        std::string bitmapStringRepresentation;
         UniValue utxos(UniValue::VARR);
-        for (const CCoin& coin : outs) {
+        for (const auto& coin : lookup.coins) {
+            bitmapStringRepresentation.append(coin ? "1" : "0");
+            if (!coin) continue;
             UniValue utxo(UniValue::VOBJ);
-            utxo.pushKV("height", (int32_t)coin.nHeight);
-            utxo.pushKV("value", ValueFromAmount(coin.out.nValue));
+            utxo.pushKV("height", (int32_t)coin->nHeight);
+            utxo.pushKV("value", ValueFromAmount(coin->out.nValue));
 
             // include the script in a json output
             UniValue o(UniValue::VOBJ);
-            ScriptToUniv(coin.out.scriptPubKey, /*out=*/o, /*include_hex=*/true, /*include_address=*/true);
+            ScriptToUniv(coin->out.scriptPubKey, /*out=*/o, /*include_hex=*/true, /*include_address=*/true);
             utxo.pushKV("scriptPubKey", std::move(o));
             utxos.push_back(std::move(utxo));
         }
+        objGetUTXOResponse.pushKV("bitmap", bitmapStringRepresentation);
         objGetUTXOResponse.pushKV("utxos", std::move(utxos));
 
         // return json string
@@ -1075,17 +1213,16 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(height_str, SAFE_CHARS_URI));
     }
 
-    CBlockIndex* pblockindex = nullptr;
+    const CBlockIndex* pblockindex = nullptr;
     {
         ChainstateManager* maybe_chainman = GetChainman(context, req);
         if (!maybe_chainman) return false;
         ChainstateManager& chainman = *maybe_chainman;
-        LOCK(cs_main);
-        const CChain& active_chain = chainman.ActiveChain();
-        if (*blockheight > active_chain.Height()) {
+        const auto active_chain{chainman.ActiveChainView()};
+        if (*blockheight > active_chain->Height()) {
             return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
         }
-        pblockindex = active_chain[*blockheight];
+        pblockindex = (*active_chain)[*blockheight];
     }
     switch (rf) {
     case RESTResponseFormat::BINARY: {
@@ -1113,6 +1250,120 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_headers_by_height(const std::any& context, HTTPRequest* req,
+                                   const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string height_str;
+    const RESTResponseFormat rf = ParseDataFormat(height_str, str_uri_part);
+
+    const auto height{ToIntegral<int32_t>(height_str)};
+    if (!height || *height < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(height_str, SAFE_CHARS_URI));
+    }
+    std::string raw_count;
+    try {
+        raw_count = req->GetQueryParameter("count").value_or(util::ToString(MAX_REST_HEADERS_RESULTS));
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto count{ToIntegral<int32_t>(raw_count)};
+    if (!count || *count < 1 || *count > MAX_HEADERS_RANGE_COUNT) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Header count is invalid or out of acceptable range (1-%d): %s", MAX_HEADERS_RANGE_COUNT, SanitizeString(raw_count)));
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    const auto active_chain{maybe_chainman->ActiveChainView()};
+    if (*height > active_chain->Height()) {
+        return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY: {
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, SerializeHeadersRange(*active_chain, *height, *count));
+        return true;
+    }
+    case RESTResponseFormat::HEX: {
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, HexStr(SerializeHeadersRange(*active_chain, *height, *count)) + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, hex)");
+    }
+    }
+}
+
+static bool rest_scripthash(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string hash_str;
+    const RESTResponseFormat rf = ParseDataFormat(hash_str, uri_part);
+
+    auto scripthash{uint256::FromHex(hash_str)};
+    if (!scripthash) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + SanitizeString(hash_str, SAFE_CHARS_URI));
+    }
+    if (!g_scripthash_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled. Start with -scripthashindex");
+    }
+    if (!g_scripthash_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Script hashes are still in the process of being indexed");
+    }
+
+    std::string raw_start, raw_end, raw_count;
+    try {
+        raw_start = req->GetQueryParameter("start").value_or("0");
+        raw_end = req->GetQueryParameter("end").value_or(util::ToString(g_scripthash_index->GetSummary().best_block_height));
+        raw_count = req->GetQueryParameter("count").value_or(util::ToString(DEFAULT_SCRIPTHASH_HISTORY_COUNT));
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto start_height{ToIntegral<int32_t>(raw_start)};
+    const auto end_height{ToIntegral<int32_t>(raw_end)};
+    if (!start_height || !end_height || *start_height < 0 || *end_height < *start_height) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid range of heights");
+    }
+    const auto count{ToIntegral<int32_t>(raw_count)};
+    if (!count || *count < 1 || *count > MAX_SCRIPTHASH_HISTORY_COUNT) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Count is invalid or out of acceptable range (1-%d): %s", MAX_SCRIPTHASH_HISTORY_COUNT, SanitizeString(raw_count)));
+    }
+
+    std::vector<ScriptHashTxRef> history;
+    std::optional<int> next_height;
+    if (!g_scripthash_index->FindHistory(*scripthash, *start_height, *end_height, *count, history, next_height)) {
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the scripthash index");
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        DataStream ssResp{};
+        ssResp << int32_t{next_height.value_or(-1)} << history;
+        if (rf == RESTResponseFormat::HEX) {
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, HexStr(ssResp) + "\n");
+        } else {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, ssResp);
+        }
+        return true;
+    }
+    case RESTResponseFormat::JSON: {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, ScriptHashHistoryToJSON(*maybe_chainman, *scripthash, history, next_height).write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1129,7 +1380,9 @@ static const struct {
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/headersbyheight/", rest_headers_by_height},
       {"/rest/spenttxouts/", rest_spent_txouts},
+      {"/rest/scripthash/", rest_scripthash},
 };
 
 void StartREST(const std::any& context)
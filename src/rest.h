@@ -5,7 +5,10 @@
 #ifndef BITCOIN_REST_H
 #define BITCOIN_REST_H
 
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 enum class RESTResponseFormat {
     UNDEF,
@@ -25,4 +28,23 @@ enum class RESTResponseFormat {
  */
 RESTResponseFormat ParseDataFormat(std::string& param, const std::string& strReq);
 
+/** Whether an If-None-Match header value lists the given strong ETag (or is "*"). */
+bool ETagMatches(std::string_view if_none_match, std::string_view etag);
+
+/** Inclusive byte range of a response body. */
+struct ByteRange {
+    size_t first;
+    size_t last;
+};
+
+/**
+ * Parse the value of a Range header for a body of `size` bytes. Only a single
+ * range in bytes is supported.
+ *
+ * @param[out]  unsatisfiable   Set if the range is valid but outside the body.
+ * @return      The range, or std::nullopt if the header is to be ignored, i.e.
+ *              the whole body is to be sent (or the range is unsatisfiable).
+ */
+std::optional<ByteRange> ParseByteRange(std::string_view range, size_t size, bool& unsatisfiable);
+
 #endif // BITCOIN_REST_H
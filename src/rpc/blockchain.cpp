@@ -10,9 +10,11 @@
 #include <chainparams.h>
 #include <chainparamsbase.h>
 #include <clientversion.h>
+#include <common/system.h>
 #include <coins.h>
 #include <common/args.h>
 #include <consensus/amount.h>
+#include <consensus/blockmetadata.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <core_io.h>
@@ -21,18 +23,24 @@
 #include <flatfile.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
+#include <index/blockstatsindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
+#include <node/blockstats.h>
 #include <node/blockstorage.h>
+#include <node/coin.h>
 #include <node/context.h>
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -48,6 +56,7 @@
 #include <util/fs.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -55,11 +64,17 @@
 
 #include <cstdint>
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <future>
+#include <ios>
 #include <iterator>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <vector>
 
 using kernel::CCoinsStats;
@@ -88,6 +103,23 @@ UniValue WriteUTXOSnapshot(
     const fs::path& temppath,
     const std::function<void()>& interruption_point = {});
 
+static UniValue WriteChunkedUTXOSnapshot(
+    Chainstate& chainstate,
+    std::span<const std::unique_ptr<CCoinsViewCursor>> cursors,
+    const CCoinsStats& stats,
+    const CBlockIndex* tip,
+    AutoFile&& afile,
+    const fs::path& path,
+    const fs::path& temppath,
+    int threads,
+    const std::function<void()>& interruption_point);
+
+//! Number of coins per range of chunked snapshots serialized by one task;
+//! bounds the memory used by the ranges serialized ahead of the file.
+static constexpr uint64_t SNAPSHOT_RANGE_COINS{250'000};
+//! Maximum number of ranges, each of which holds a database iterator.
+static constexpr uint64_t MAX_SNAPSHOT_RANGES{1024};
+
 /* Calculate the difficulty for a given block index.
  */
 double GetDifficulty(const CBlockIndex& blockindex)
@@ -178,19 +210,33 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit, JSONStreamWriter* stream)
 {
     UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
 
-    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
-    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
-    result.pushKV("weight", (int)::GetBlockWeight(block));
+    const BlockMetadata metadata{ComputeBlockMetadata(block)};
+    result.pushKV("strippedsize", (int)metadata.stripped_size);
+    result.pushKV("size", (int)metadata.total_size);
+    result.pushKV("weight", (int)metadata.Weight());
     UniValue txs(UniValue::VARR);
+    if (stream) {
+        stream->BeginObject();
+        stream->Members(result);
+        stream->Key("tx");
+        stream->BeginArray();
+    }
+    const auto add_tx{[&](UniValue&& tx) {
+        if (stream) {
+            stream->Value(tx);
+        } else {
+            txs.push_back(std::move(tx));
+        }
+    }};
 
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                add_tx(tx->GetHash().GetHex());
             }
             break;
 
@@ -208,11 +254,16 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                add_tx(std::move(objTx));
             }
             break;
     }
 
+    if (stream) {
+        stream->EndArray();
+        stream->EndObject();
+        return NullUniValue;
+    }
     result.pushKV("tx", std::move(txs));
 
     return result;
@@ -234,8 +285,7 @@ static RPCHelpMan getblockcount()
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    return chainman.ActiveChain().Height();
+    return chainman.ActiveChainView()->Height();
 },
     };
 }
@@ -255,8 +305,7 @@ static RPCHelpMan getbestblockhash()
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    return chainman.ActiveChain().Tip()->GetBlockHash().GetHex();
+    return chainman.ActiveChainView()->Tip()->GetBlockHash().GetHex();
 },
     };
 }
@@ -544,14 +593,13 @@ static RPCHelpMan getblockhash()
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    const CChain& active_chain = chainman.ActiveChain();
+    const auto active_chain{chainman.ActiveChainView()};
 
     int nHeight = request.params[0].getInt<int>();
-    if (nHeight < 0 || nHeight > active_chain.Height())
+    if (nHeight < 0 || nHeight > active_chain->Height())
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Block height out of range");
 
-    const CBlockIndex* pblockindex = active_chain[nHeight];
+    const CBlockIndex* pblockindex = (*active_chain)[nHeight];
     return pblockindex->GetBlockHash().GetHex();
 },
     };
@@ -620,8 +668,7 @@ static RPCHelpMan getblockheader()
     {
         DataStream ssBlock{};
         ssBlock << pblockindex->GetBlockHeader();
-        std::string strHex = HexStr(ssBlock);
-        return strHex;
+        return HexOrBinaryResult(request, ssBlock);
     }
 
     return blockheaderToJSON(*tip, *pblockindex, chainman.GetConsensus().powLimit);
@@ -629,6 +676,51 @@ static RPCHelpMan getblockheader()
     };
 }
 
+std::vector<std::byte> SerializeHeadersRange(const CChainView& chain, int height, int count)
+{
+    DataStream ss_headers{};
+    const int end_height{std::min(chain.Height(), height + count - 1)};
+    ss_headers.reserve(std::max(end_height - height + 1, 0) * size_t{80});
+    for (int h{height}; h <= end_height; ++h) {
+        ss_headers << chain[h]->GetBlockHeader();
+    }
+    return {ss_headers.begin(), ss_headers.end()};
+}
+
+static RPCHelpMan getblockheaders()
+{
+    return RPCHelpMan{
+        "getblockheaders",
+        "Returns the serialized, hex-encoded headers of consecutive blocks in the best-block-chain, from the height provided.\n"
+        "The headers are 80 bytes each and in height order. Fewer than count headers are returned when the tip is reached.\n",
+        {
+            {"height", RPCArg::Type::NUM, RPCArg::Optional::NO, "The height of the first block"},
+            {"count", RPCArg::Type::NUM, RPCArg::Optional::NO, strprintf("The number of headers to return (1-%d)", MAX_HEADERS_RANGE_COUNT)},
+        },
+        RPCResult{
+            RPCResult::Type::STR_HEX, "", "The serialized headers, one after the other"},
+        RPCExamples{
+            HelpExampleCli("getblockheaders", "1000 2000")
+            + HelpExampleRpc("getblockheaders", "1000, 2000")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const auto height{self.Arg<int>("height")};
+    const auto count{self.Arg<int>("count")};
+    if (count < 1 || count > MAX_HEADERS_RANGE_COUNT) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Count is out of range (1-%d)", MAX_HEADERS_RANGE_COUNT));
+    }
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const auto active_chain{chainman.ActiveChainView()};
+    if (height < 0 || height > active_chain->Height()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Block height out of range");
+    }
+    return HexOrBinaryResult(request, SerializeHeadersRange(*active_chain, height, count));
+},
+    };
+}
+
 void CheckBlockDataAvailability(BlockManager& blockman, const CBlockIndex& blockindex, bool check_for_undo)
 {
     AssertLockHeld(cs_main);
@@ -816,7 +908,7 @@ static RPCHelpMan getblock()
     const std::vector<std::byte> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
-        return HexStr(block_data);
+        return HexOrBinaryResult(request, block_data);
     }
 
     DataStream block_stream{block_data};
@@ -832,7 +924,9 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
-    return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+    // Verbose blocks can be large, so write them straight into the reply where possible.
+    JSONStreamWriter* stream{tx_verbosity == TxVerbosity::SHOW_TXID ? nullptr : request.m_result_stream};
+    return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit, stream);
 },
     };
 }
@@ -935,16 +1029,57 @@ CoinStatsHashType ParseHashType(const std::string& hash_type_input)
     }
 }
 
+//! Number of threads to scan the whole UTXO set with.
+static int GetUTXOScanThreads(const ArgsManager& args)
+{
+    // -utxoscanthreads=0 means one thread per core
+    int threads = args.GetIntArg("-utxoscanthreads", kernel::DEFAULT_UTXO_SCAN_THREADS);
+    if (threads <= 0) threads = GetNumCores();
+    return std::clamp(threads, 1, kernel::MAX_UTXO_SCAN_THREADS);
+}
+
+//! Number of threads to match block filters and read blocks with in scanblocks and getdescriptoractivity.
+static int GetBlockScanThreads(const ArgsManager& args)
+{
+    // -blockscanthreads=0 means one thread per core
+    int threads = args.GetIntArg("-blockscanthreads", DEFAULT_BLOCK_SCAN_THREADS);
+    if (threads <= 0) threads = GetNumCores();
+    return std::clamp(threads, 1, MAX_BLOCK_SCAN_THREADS);
+}
+
+/**
+ * Call fn(i) for every i in [0, count), spread over the tasks the group may
+ * run at once on the shared thread pool (or on this thread if it has no
+ * workers), and wait for all calls to return. An exception thrown by any of
+ * them is rethrown once all have finished.
+ */
+template <typename F>
+static void ParallelFor(SharedThreadPool::Group& pool, size_t count, const F& fn)
+{
+    const size_t tasks{std::clamp<size_t>(pool.Concurrency(), 1, std::max<size_t>(count, 1))};
+    std::vector<std::future<void>> futures;
+    futures.reserve(tasks);
+    for (size_t task{0}; task < tasks; ++task) {
+        futures.push_back(pool.Submit([&fn, task, tasks, count] {
+            for (size_t i{task}; i < count; i += tasks) fn(i);
+        }));
+    }
+    for (auto& future : futures) future.wait();
+    for (auto& future : futures) future.get();
+}
+
 /**
  * Calculate statistics about the unspent transaction output set
  *
  * @param[in] index_requested Signals if the coinstatsindex should be used (when available).
+ * @param[in] threads Number of threads scanning the UTXO set if the index is not used.
  */
 static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::BlockManager& blockman,
                                                        kernel::CoinStatsHashType hash_type,
                                                        const std::function<void()>& interruption_point = {},
                                                        const CBlockIndex* pindex = nullptr,
-                                                       bool index_requested = true)
+                                                       bool index_requested = true,
+                                                       int threads = 1)
 {
     // Use CoinStatsIndex if it is requested and available and a hash_type of Muhash or None was requested
     if ((hash_type == kernel::CoinStatsHashType::MUHASH || hash_type == kernel::CoinStatsHashType::NONE) && g_coin_stats_index && index_requested) {
@@ -962,7 +1097,7 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view->GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point, threads);
 }
 
 static RPCHelpMan gettxoutsetinfo()
@@ -1068,7 +1203,7 @@ static RPCHelpMan gettxoutsetinfo()
         }
     }
 
-    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested, GetUTXOScanThreads(EnsureArgsman(node)));
     if (maybe_stats.has_value()) {
         const CCoinsStats& stats = maybe_stats.value();
         ret.pushKV("height", (int64_t)stats.nHeight);
@@ -1091,7 +1226,7 @@ static RPCHelpMan gettxoutsetinfo()
 
             CCoinsStats prev_stats{};
             if (pindex->nHeight > 0) {
-                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested);
+                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested, GetUTXOScanThreads(EnsureArgsman(node)));
                 if (!maybe_prev_stats) {
                     throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
                 }
@@ -1159,7 +1294,6 @@ static RPCHelpMan gettxout()
 {
     NodeContext& node = EnsureAnyNodeContext(request.context);
     ChainstateManager& chainman = EnsureChainman(node);
-    LOCK(cs_main);
 
     UniValue ret(UniValue::VOBJ);
 
@@ -1169,26 +1303,15 @@ static RPCHelpMan gettxout()
     if (!request.params[2].isNull())
         fMempool = request.params[2].get_bool();
 
-    Chainstate& active_chainstate = chainman.ActiveChainstate();
-    CCoinsViewCache* coins_view = &active_chainstate.CoinsTip();
-
-    std::optional<Coin> coin;
-    if (fMempool) {
-        const CTxMemPool& mempool = EnsureMemPool(node);
-        LOCK(mempool.cs);
-        CCoinsViewMemPool view(coins_view, mempool);
-        if (!mempool.isSpent(out)) coin = view.GetCoin(out);
-    } else {
-        coin = coins_view->GetCoin(out);
-    }
+    const node::CoinsLookup lookup{node::LookupCoins(chainman, fMempool ? &EnsureMemPool(node) : nullptr, {&out, 1})};
+    const std::optional<Coin>& coin{lookup.coins[0]};
     if (!coin) return UniValue::VNULL;
 
-    const CBlockIndex* pindex = active_chainstate.m_blockman.LookupBlockIndex(coins_view->GetBestBlock());
-    ret.pushKV("bestblock", pindex->GetBlockHash().GetHex());
+    ret.pushKV("bestblock", lookup.tip_hash.GetHex());
     if (coin->nHeight == MEMPOOL_HEIGHT) {
         ret.pushKV("confirmations", 0);
     } else {
-        ret.pushKV("confirmations", (int64_t)(pindex->nHeight - coin->nHeight + 1));
+        ret.pushKV("confirmations", (int64_t)(lookup.height - coin->nHeight + 1));
     }
     ret.pushKV("value", ValueFromAmount(coin->out.nValue));
     UniValue o(UniValue::VOBJ);
@@ -1201,6 +1324,183 @@ static RPCHelpMan gettxout()
     };
 }
 
+//! Parse an array of {"txid", "vout"} objects, as given to gettxouts.
+static std::vector<COutPoint> ParseOutpoints(const UniValue& param)
+{
+    const UniValue& output_params = param.get_array();
+    if (output_params.size() > node::MAX_COINS_LOOKUP) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Too many outputs (max: %d, tried: %d)", node::MAX_COINS_LOOKUP, output_params.size()));
+    }
+
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(output_params.size());
+    for (unsigned int idx = 0; idx < output_params.size(); idx++) {
+        const UniValue& o = output_params[idx].get_obj();
+
+        RPCTypeCheckObj(o,
+                        {
+                            {"txid", UniValueType(UniValue::VSTR)},
+                            {"vout", UniValueType(UniValue::VNUM)},
+                        }, /*fAllowNull=*/false, /*fStrict=*/true);
+
+        const Txid txid = Txid::FromUint256(ParseHashO(o, "txid"));
+        const int nOutput{o.find_value("vout").getInt<int>()};
+        if (nOutput < 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, vout cannot be negative");
+        }
+        outpoints.emplace_back(txid, nOutput);
+    }
+    return outpoints;
+}
+
+static std::vector<RPCResult> CoinsLookupTxOutsDoc(const std::string& confirmations_doc)
+{
+    return {
+        {RPCResult::Type::OBJ, "", "", {
+            {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+            {RPCResult::Type::NUM, "vout", "The output number"},
+            {RPCResult::Type::NUM, "confirmations", confirmations_doc},
+            {RPCResult::Type::STR_AMOUNT, "value", "The transaction value in " + CURRENCY_UNIT},
+            {RPCResult::Type::OBJ, "scriptPubKey", "", {
+                {RPCResult::Type::STR, "asm", "Disassembly of the output script"},
+                {RPCResult::Type::STR, "desc", "Inferred descriptor for the output"},
+                {RPCResult::Type::STR_HEX, "hex", "The raw output script bytes, hex-encoded"},
+                {RPCResult::Type::STR, "type", "The type, eg pubkeyhash"},
+                {RPCResult::Type::STR, "address", /*optional=*/true, "The Bitcoin address (only if a well-defined address exists)"},
+            }},
+            {RPCResult::Type::BOOL, "coinbase", "Coinbase or not"},
+        }},
+    };
+}
+
+//! The result of gettxouts and gettxoutsat, with the hash of the block looked up at as `hash_key`.
+static UniValue CoinsLookupToJSON(const node::CoinsLookup& lookup, std::span<const COutPoint> outpoints, const std::string& hash_key)
+{
+    std::string bitmap;
+    UniValue txouts(UniValue::VARR);
+    for (size_t i{0}; i < outpoints.size(); ++i) {
+        const std::optional<Coin>& coin{lookup.coins[i]};
+        bitmap += coin ? '1' : '0';
+        if (!coin) continue;
+        UniValue txout(UniValue::VOBJ);
+        txout.pushKV("txid", outpoints[i].hash.GetHex());
+        txout.pushKV("vout", outpoints[i].n);
+        if (coin->nHeight == MEMPOOL_HEIGHT) {
+            txout.pushKV("confirmations", 0);
+        } else {
+            txout.pushKV("confirmations", (int64_t)(lookup.height - coin->nHeight + 1));
+        }
+        txout.pushKV("value", ValueFromAmount(coin->out.nValue));
+        UniValue o(UniValue::VOBJ);
+        ScriptToUniv(coin->out.scriptPubKey, /*out=*/o, /*include_hex=*/true, /*include_address=*/true);
+        txout.pushKV("scriptPubKey", std::move(o));
+        txout.pushKV("coinbase", (bool)coin->fCoinBase);
+        txouts.push_back(std::move(txout));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV(hash_key, lookup.tip_hash.GetHex());
+    ret.pushKV("height", lookup.height);
+    ret.pushKV("bitmap", bitmap);
+    ret.pushKV("txouts", std::move(txouts));
+    return ret;
+}
+
+static RPCHelpMan gettxouts()
+{
+    return RPCHelpMan{
+        "gettxouts",
+        "Returns details about several unspent transaction outputs.\n"
+        "All outputs are looked up at the same tip in one pass, reading those not cached from a snapshot of the database in key order, so a large batch is much cheaper than calling gettxout for each.\n"
+        "If the client accepts application/octet-stream, the result is replied in the binary format of BIP64 instead.\n",
+        {
+            {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, strprintf("The transaction outputs to look up (at most %d)", node::MAX_COINS_LOOKUP),
+                {
+                    {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "",
+                        {
+                            {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The transaction id"},
+                            {"vout", RPCArg::Type::NUM, RPCArg::Optional::NO, "The output number"},
+                        },
+                    },
+                },
+            },
+            {"include_mempool", RPCArg::Type::BOOL, RPCArg::Default{true}, "Whether to include the mempool. Note that an unspent output that is spent in the mempool won't appear."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block at the tip of the chain"},
+                {RPCResult::Type::NUM, "height", "The height of the block at the tip of the chain"},
+                {RPCResult::Type::STR, "bitmap", "For each of the given outputs in order, 1 if it was found unspent, 0 otherwise"},
+                {RPCResult::Type::ARR, "txouts", "The unspent outputs, in the order of the given outputs", CoinsLookupTxOutsDoc("The number of confirmations")},
+            }},
+        RPCExamples{
+            HelpExampleCli("gettxouts", "\"[{\\\"txid\\\":\\\"a08e6907dbbd3d809776dbfc5d82e371b764ed838b5655e72f463568df1aadf0\\\",\\\"vout\\\":3}]\"")
+            + HelpExampleRpc("gettxouts", "\"[{\\\"txid\\\":\\\"a08e6907dbbd3d809776dbfc5d82e371b764ed838b5655e72f463568df1aadf0\\\",\\\"vout\\\":3}]\"")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::vector<COutPoint> outpoints{ParseOutpoints(request.params[0])};
+    const bool include_mempool{request.params[1].isNull() ? true : request.params[1].get_bool()};
+
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+    const node::CoinsLookup lookup{node::LookupCoins(chainman, include_mempool ? &EnsureMemPool(node) : nullptr, outpoints)};
+
+    if (request.m_binary_result) {
+        *request.m_binary_result = node::SerializeCoinsLookup(lookup);
+        return NullUniValue;
+    }
+
+    return CoinsLookupToJSON(lookup, outpoints, "bestblock");
+},
+    };
+}
+
+static RPCHelpMan gettxoutsat()
+{
+    return RPCHelpMan{
+        "gettxoutsat",
+        "Returns details about transaction outputs as they were in the UTXO set right after the block at the given height was connected.\n"
+        "The outputs are looked up at the tip, and the blocks above the height are then undone on them from their undo data, so the\n"
+        "call takes longer the deeper the height, and fails if the data of one of those blocks was pruned. Mempool transactions are ignored.\n",
+        {
+            {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, strprintf("The transaction outputs to look up (at most %d)", node::MAX_COINS_LOOKUP),
+                {
+                    {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "",
+                        {
+                            {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The transaction id"},
+                            {"vout", RPCArg::Type::NUM, RPCArg::Optional::NO, "The output number"},
+                        },
+                    },
+                },
+            },
+            {"height", RPCArg::Type::NUM, RPCArg::Optional::NO, "The height of the block after which to look up the outputs"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block at the given height"},
+                {RPCResult::Type::NUM, "height", "The given height"},
+                {RPCResult::Type::STR, "bitmap", "For each of the given outputs in order, 1 if it was unspent at that height, 0 otherwise"},
+                {RPCResult::Type::ARR, "txouts", "The outputs unspent at that height, in the order of the given outputs", CoinsLookupTxOutsDoc("The number of confirmations at that height")},
+            }},
+        RPCExamples{
+            HelpExampleCli("gettxoutsat", "\"[{\\\"txid\\\":\\\"a08e6907dbbd3d809776dbfc5d82e371b764ed838b5655e72f463568df1aadf0\\\",\\\"vout\\\":3}]\" 800000")
+            + HelpExampleRpc("gettxoutsat", "\"[{\\\"txid\\\":\\\"a08e6907dbbd3d809776dbfc5d82e371b764ed838b5655e72f463568df1aadf0\\\",\\\"vout\\\":3}]\", 800000")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::vector<COutPoint> outpoints{ParseOutpoints(request.params[0])};
+    const int height{request.params[1].getInt<int>()};
+    if (height < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, height cannot be negative");
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const auto lookup{node::LookupCoinsAtHeight(chainman, outpoints, height)};
+    if (!lookup) throw JSONRPCError(RPC_MISC_ERROR, util::ErrorString(lookup).original);
+    return CoinsLookupToJSON(*lookup, outpoints, "blockhash");
+},
+    };
+}
+
 static RPCHelpMan verifychain()
 {
     return RPCHelpMan{
@@ -1808,68 +2108,136 @@ static RPCHelpMan getchaintxstats()
     };
 }
 
-template<typename T>
-static T CalculateTruncatedMedian(std::vector<T>& scores)
+static std::vector<RPCResult> BlockStatsResultFields()
 {
-    size_t size = scores.size();
-    if (size == 0) {
-        return 0;
-    }
+    return {
+        {RPCResult::Type::NUM, "avgfee", /*optional=*/true, "Average fee in the block"},
+        {RPCResult::Type::NUM, "avgfeerate", /*optional=*/true, "Average feerate (in satoshis per virtual byte)"},
+        {RPCResult::Type::NUM, "avgtxsize", /*optional=*/true, "Average transaction size"},
+        {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "The block hash (to check for potential reorgs)"},
+        {RPCResult::Type::ARR_FIXED, "feerate_percentiles", /*optional=*/true, "Feerates at the 10th, 25th, 50th, 75th, and 90th percentile weight unit (in satoshis per virtual byte)",
+        {
+            {RPCResult::Type::NUM, "10th_percentile_feerate", "The 10th percentile feerate"},
+            {RPCResult::Type::NUM, "25th_percentile_feerate", "The 25th percentile feerate"},
+            {RPCResult::Type::NUM, "50th_percentile_feerate", "The 50th percentile feerate"},
+            {RPCResult::Type::NUM, "75th_percentile_feerate", "The 75th percentile feerate"},
+            {RPCResult::Type::NUM, "90th_percentile_feerate", "The 90th percentile feerate"},
+        }},
+        {RPCResult::Type::NUM, "height", /*optional=*/true, "The height of the block"},
+        {RPCResult::Type::NUM, "ins", /*optional=*/true, "The number of inputs (excluding coinbase)"},
+        {RPCResult::Type::NUM, "maxfee", /*optional=*/true, "Maximum fee in the block"},
+        {RPCResult::Type::NUM, "maxfeerate", /*optional=*/true, "Maximum feerate (in satoshis per virtual byte)"},
+        {RPCResult::Type::NUM, "maxtxsize", /*optional=*/true, "Maximum transaction size"},
+        {RPCResult::Type::NUM, "medianfee", /*optional=*/true, "Truncated median fee in the block"},
+        {RPCResult::Type::NUM, "mediantime", /*optional=*/true, "The block median time past"},
+        {RPCResult::Type::NUM, "mediantxsize", /*optional=*/true, "Truncated median transaction size"},
+        {RPCResult::Type::NUM, "minfee", /*optional=*/true, "Minimum fee in the block"},
+        {RPCResult::Type::NUM, "minfeerate", /*optional=*/true, "Minimum feerate (in satoshis per virtual byte)"},
+        {RPCResult::Type::NUM, "mintxsize", /*optional=*/true, "Minimum transaction size"},
+        {RPCResult::Type::NUM, "outs", /*optional=*/true, "The number of outputs"},
+        {RPCResult::Type::NUM, "subsidy", /*optional=*/true, "The block subsidy"},
+        {RPCResult::Type::NUM, "swtotal_size", /*optional=*/true, "Total size of all segwit transactions"},
+        {RPCResult::Type::NUM, "swtotal_weight", /*optional=*/true, "Total weight of all segwit transactions"},
+        {RPCResult::Type::NUM, "swtxs", /*optional=*/true, "The number of segwit transactions"},
+        {RPCResult::Type::NUM, "time", /*optional=*/true, "The block time"},
+        {RPCResult::Type::NUM, "total_out", /*optional=*/true, "Total amount in all outputs (excluding coinbase and thus reward [ie subsidy + totalfee])"},
+        {RPCResult::Type::NUM, "total_size", /*optional=*/true, "Total size of all non-coinbase transactions"},
+        {RPCResult::Type::NUM, "total_weight", /*optional=*/true, "Total weight of all non-coinbase transactions"},
+        {RPCResult::Type::NUM, "totalfee", /*optional=*/true, "The fee total"},
+        {RPCResult::Type::NUM, "txs", /*optional=*/true, "The number of transactions (including coinbase)"},
+        {RPCResult::Type::NUM, "utxo_increase", /*optional=*/true, "The increase/decrease in the number of unspent outputs (not discounting op_return and similar)"},
+        {RPCResult::Type::NUM, "utxo_size_inc", /*optional=*/true, "The increase/decrease in size for the utxo index (not discounting op_return and similar)"},
+        {RPCResult::Type::NUM, "utxo_increase_actual", /*optional=*/true, "The increase/decrease in the number of unspent outputs, not counting unspendables"},
+        {RPCResult::Type::NUM, "utxo_size_inc_actual", /*optional=*/true, "The increase/decrease in size for the utxo index, not counting unspendables"},
+    };
+}
 
-    std::sort(scores.begin(), scores.end());
-    if (size % 2 == 0) {
-        return (scores[size / 2 - 1] + scores[size / 2]) / 2;
-    } else {
-        return scores[size / 2];
+static std::set<std::string> ParseSelectedStats(const UniValue& param)
+{
+    std::set<std::string> stats;
+    if (!param.isNull()) {
+        const UniValue stats_univalue = param.get_array();
+        for (unsigned int i = 0; i < stats_univalue.size(); i++) {
+            const std::string stat = stats_univalue[i].get_str();
+            stats.insert(stat);
+        }
     }
+    return stats;
 }
 
-void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight)
+/** Look up the statistics of a block in the blockstatsindex, or compute them from the block and undo data on disk. */
+static node::BlockStats GetBlockStats(ChainstateManager& chainman, const CBlockIndex& pindex)
 {
-    if (scores.empty()) {
-        return;
+    if (g_block_stats_index) {
+        if (auto stats{g_block_stats_index->LookUpStats(pindex)}) return *stats;
     }
+    const CBlock& block = GetBlockChecked(chainman.m_blockman, pindex);
+    const CBlockUndo& blockUndo = GetUndoChecked(chainman.m_blockman, pindex);
+    return node::ComputeBlockStats(block, blockUndo, pindex);
+}
 
-    std::sort(scores.begin(), scores.end());
-
-    // 10th, 25th, 50th, 75th, and 90th percentile weight units.
-    const double weights[NUM_GETBLOCKSTATS_PERCENTILES] = {
-        total_weight / 10.0, total_weight / 4.0, total_weight / 2.0, (total_weight * 3.0) / 4.0, (total_weight * 9.0) / 10.0
-    };
-
-    int64_t next_percentile_index = 0;
-    int64_t cumulative_weight = 0;
-    for (const auto& element : scores) {
-        cumulative_weight += element.second;
-        while (next_percentile_index < NUM_GETBLOCKSTATS_PERCENTILES && cumulative_weight >= weights[next_percentile_index]) {
-            result[next_percentile_index] = element.first;
-            ++next_percentile_index;
-        }
+/** The statistics of a block as returned by getblockstats, restricted to the selected ones (if any). */
+static UniValue BlockStatsToJSON(const node::BlockStats& stats, const CBlockIndex& pindex, const Consensus::Params& consensus, const std::set<std::string>& selected)
+{
+    UniValue feerates_res(UniValue::VARR);
+    for (const CAmount feerate : stats.feerate_percentiles) {
+        feerates_res.push_back(feerate);
     }
 
-    // Fill any remaining percentiles with the last value.
-    for (int64_t i = next_percentile_index; i < NUM_GETBLOCKSTATS_PERCENTILES; i++) {
-        result[i] = scores.back().first;
+    UniValue ret_all(UniValue::VOBJ);
+    ret_all.pushKV("avgfee", stats.avgfee);
+    ret_all.pushKV("avgfeerate", stats.avgfeerate); // Unit: sat/vbyte
+    ret_all.pushKV("avgtxsize", stats.avgtxsize);
+    ret_all.pushKV("blockhash", pindex.GetBlockHash().GetHex());
+    ret_all.pushKV("feerate_percentiles", std::move(feerates_res));
+    ret_all.pushKV("height", (int64_t)pindex.nHeight);
+    ret_all.pushKV("ins", stats.ins);
+    ret_all.pushKV("maxfee", stats.maxfee);
+    ret_all.pushKV("maxfeerate", stats.maxfeerate);
+    ret_all.pushKV("maxtxsize", stats.maxtxsize);
+    ret_all.pushKV("medianfee", stats.medianfee);
+    ret_all.pushKV("mediantime", pindex.GetMedianTimePast());
+    ret_all.pushKV("mediantxsize", stats.mediantxsize);
+    ret_all.pushKV("minfee", stats.minfee);
+    ret_all.pushKV("minfeerate", stats.minfeerate);
+    ret_all.pushKV("mintxsize", stats.mintxsize);
+    ret_all.pushKV("outs", stats.outs);
+    ret_all.pushKV("subsidy", GetBlockSubsidy(pindex.nHeight, consensus));
+    ret_all.pushKV("swtotal_size", stats.swtotal_size);
+    ret_all.pushKV("swtotal_weight", stats.swtotal_weight);
+    ret_all.pushKV("swtxs", stats.swtxs);
+    ret_all.pushKV("time", pindex.GetBlockTime());
+    ret_all.pushKV("total_out", stats.total_out);
+    ret_all.pushKV("total_size", stats.total_size);
+    ret_all.pushKV("total_weight", stats.total_weight);
+    ret_all.pushKV("totalfee", stats.totalfee);
+    ret_all.pushKV("txs", stats.txs);
+    ret_all.pushKV("utxo_increase", stats.utxo_increase);
+    ret_all.pushKV("utxo_size_inc", stats.utxo_size_inc);
+    ret_all.pushKV("utxo_increase_actual", stats.utxo_increase_actual);
+    ret_all.pushKV("utxo_size_inc_actual", stats.utxo_size_inc_actual);
+
+    if (selected.empty()) {
+        return ret_all;
     }
-}
 
-template<typename T>
-static inline bool SetHasKeys(const std::set<T>& set) {return false;}
-template<typename T, typename Tk, typename... Args>
-static inline bool SetHasKeys(const std::set<T>& set, const Tk& key, const Args&... args)
-{
-    return (set.count(key) != 0) || SetHasKeys(set, args...);
+    UniValue ret(UniValue::VOBJ);
+    for (const std::string& stat : selected) {
+        const UniValue& value = ret_all[stat];
+        if (value.isNull()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic '%s'", stat));
+        }
+        ret.pushKV(stat, value);
+    }
+    return ret;
 }
 
-// outpoint (needed for the utxo index) + nHeight + fCoinBase
-static constexpr size_t PER_UTXO_OVERHEAD = sizeof(COutPoint) + sizeof(uint32_t) + sizeof(bool);
-
 static RPCHelpMan getblockstats()
 {
     return RPCHelpMan{
         "getblockstats",
         "Compute per block statistics for a given window. All amounts are in satoshis.\n"
-                "It won't work for some heights with pruning.\n",
+                "It won't work for some heights with pruning, unless they are in the blockstatsindex.\n",
                 {
                     {"hash_or_height", RPCArg::Type::NUM, RPCArg::Optional::NO, "The block hash or height of the target block",
                      RPCArgOptions{
@@ -1884,47 +2252,7 @@ static RPCHelpMan getblockstats()
                         RPCArgOptions{.oneline_description="stats"}},
                 },
                 RPCResult{
-            RPCResult::Type::OBJ, "", "",
-            {
-                {RPCResult::Type::NUM, "avgfee", /*optional=*/true, "Average fee in the block"},
-                {RPCResult::Type::NUM, "avgfeerate", /*optional=*/true, "Average feerate (in satoshis per virtual byte)"},
-                {RPCResult::Type::NUM, "avgtxsize", /*optional=*/true, "Average transaction size"},
-                {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "The block hash (to check for potential reorgs)"},
-                {RPCResult::Type::ARR_FIXED, "feerate_percentiles", /*optional=*/true, "Feerates at the 10th, 25th, 50th, 75th, and 90th percentile weight unit (in satoshis per virtual byte)",
-                {
-                    {RPCResult::Type::NUM, "10th_percentile_feerate", "The 10th percentile feerate"},
-                    {RPCResult::Type::NUM, "25th_percentile_feerate", "The 25th percentile feerate"},
-                    {RPCResult::Type::NUM, "50th_percentile_feerate", "The 50th percentile feerate"},
-                    {RPCResult::Type::NUM, "75th_percentile_feerate", "The 75th percentile feerate"},
-                    {RPCResult::Type::NUM, "90th_percentile_feerate", "The 90th percentile feerate"},
-                }},
-                {RPCResult::Type::NUM, "height", /*optional=*/true, "The height of the block"},
-                {RPCResult::Type::NUM, "ins", /*optional=*/true, "The number of inputs (excluding coinbase)"},
-                {RPCResult::Type::NUM, "maxfee", /*optional=*/true, "Maximum fee in the block"},
-                {RPCResult::Type::NUM, "maxfeerate", /*optional=*/true, "Maximum feerate (in satoshis per virtual byte)"},
-                {RPCResult::Type::NUM, "maxtxsize", /*optional=*/true, "Maximum transaction size"},
-                {RPCResult::Type::NUM, "medianfee", /*optional=*/true, "Truncated median fee in the block"},
-                {RPCResult::Type::NUM, "mediantime", /*optional=*/true, "The block median time past"},
-                {RPCResult::Type::NUM, "mediantxsize", /*optional=*/true, "Truncated median transaction size"},
-                {RPCResult::Type::NUM, "minfee", /*optional=*/true, "Minimum fee in the block"},
-                {RPCResult::Type::NUM, "minfeerate", /*optional=*/true, "Minimum feerate (in satoshis per virtual byte)"},
-                {RPCResult::Type::NUM, "mintxsize", /*optional=*/true, "Minimum transaction size"},
-                {RPCResult::Type::NUM, "outs", /*optional=*/true, "The number of outputs"},
-                {RPCResult::Type::NUM, "subsidy", /*optional=*/true, "The block subsidy"},
-                {RPCResult::Type::NUM, "swtotal_size", /*optional=*/true, "Total size of all segwit transactions"},
-                {RPCResult::Type::NUM, "swtotal_weight", /*optional=*/true, "Total weight of all segwit transactions"},
-                {RPCResult::Type::NUM, "swtxs", /*optional=*/true, "The number of segwit transactions"},
-                {RPCResult::Type::NUM, "time", /*optional=*/true, "The block time"},
-                {RPCResult::Type::NUM, "total_out", /*optional=*/true, "Total amount in all outputs (excluding coinbase and thus reward [ie subsidy + totalfee])"},
-                {RPCResult::Type::NUM, "total_size", /*optional=*/true, "Total size of all non-coinbase transactions"},
-                {RPCResult::Type::NUM, "total_weight", /*optional=*/true, "Total weight of all non-coinbase transactions"},
-                {RPCResult::Type::NUM, "totalfee", /*optional=*/true, "The fee total"},
-                {RPCResult::Type::NUM, "txs", /*optional=*/true, "The number of transactions (including coinbase)"},
-                {RPCResult::Type::NUM, "utxo_increase", /*optional=*/true, "The increase/decrease in the number of unspent outputs (not discounting op_return and similar)"},
-                {RPCResult::Type::NUM, "utxo_size_inc", /*optional=*/true, "The increase/decrease in size for the utxo index (not discounting op_return and similar)"},
-                {RPCResult::Type::NUM, "utxo_increase_actual", /*optional=*/true, "The increase/decrease in the number of unspent outputs, not counting unspendables"},
-                {RPCResult::Type::NUM, "utxo_size_inc_actual", /*optional=*/true, "The increase/decrease in size for the utxo index, not counting unspendables"},
-            }},
+            RPCResult::Type::OBJ, "", "", BlockStatsResultFields()},
                 RPCExamples{
                     HelpExampleCli("getblockstats", R"('"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09"' '["minfeerate","avgfeerate"]')") +
                     HelpExampleCli("getblockstats", R"(1000 '["minfeerate","avgfeerate"]')") +
@@ -1935,223 +2263,240 @@ static RPCHelpMan getblockstats()
 {
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
     const CBlockIndex& pindex{*CHECK_NONFATAL(ParseHashOrHeight(request.params[0], chainman))};
+    const std::set<std::string> stats{ParseSelectedStats(request.params[1])};
 
-    std::set<std::string> stats;
-    if (!request.params[1].isNull()) {
-        const UniValue stats_univalue = request.params[1].get_array();
-        for (unsigned int i = 0; i < stats_univalue.size(); i++) {
-            const std::string stat = stats_univalue[i].get_str();
-            stats.insert(stat);
-        }
-    }
-
-    const CBlock& block = GetBlockChecked(chainman.m_blockman, pindex);
-    const CBlockUndo& blockUndo = GetUndoChecked(chainman.m_blockman, pindex);
-
-    const bool do_all = stats.size() == 0; // Calculate everything if nothing selected (default)
-    const bool do_mediantxsize = do_all || stats.count("mediantxsize") != 0;
-    const bool do_medianfee = do_all || stats.count("medianfee") != 0;
-    const bool do_feerate_percentiles = do_all || stats.count("feerate_percentiles") != 0;
-    const bool loop_inputs = do_all || do_medianfee || do_feerate_percentiles ||
-        SetHasKeys(stats, "utxo_increase", "utxo_increase_actual", "utxo_size_inc", "utxo_size_inc_actual", "totalfee", "avgfee", "avgfeerate", "minfee", "maxfee", "minfeerate", "maxfeerate");
-    const bool loop_outputs = do_all || loop_inputs || stats.count("total_out");
-    const bool do_calculate_size = do_mediantxsize ||
-        SetHasKeys(stats, "total_size", "avgtxsize", "mintxsize", "maxtxsize", "swtotal_size");
-    const bool do_calculate_weight = do_all || SetHasKeys(stats, "total_weight", "avgfeerate", "swtotal_weight", "avgfeerate", "feerate_percentiles", "minfeerate", "maxfeerate");
-    const bool do_calculate_sw = do_all || SetHasKeys(stats, "swtxs", "swtotal_size", "swtotal_weight");
-
-    CAmount maxfee = 0;
-    CAmount maxfeerate = 0;
-    CAmount minfee = MAX_MONEY;
-    CAmount minfeerate = MAX_MONEY;
-    CAmount total_out = 0;
-    CAmount totalfee = 0;
-    int64_t inputs = 0;
-    int64_t maxtxsize = 0;
-    int64_t mintxsize = MAX_BLOCK_SERIALIZED_SIZE;
-    int64_t outputs = 0;
-    int64_t swtotal_size = 0;
-    int64_t swtotal_weight = 0;
-    int64_t swtxs = 0;
-    int64_t total_size = 0;
-    int64_t total_weight = 0;
-    int64_t utxos = 0;
-    int64_t utxo_size_inc = 0;
-    int64_t utxo_size_inc_actual = 0;
-    std::vector<CAmount> fee_array;
-    std::vector<std::pair<CAmount, int64_t>> feerate_array;
-    std::vector<int64_t> txsize_array;
-
-    for (size_t i = 0; i < block.vtx.size(); ++i) {
-        const auto& tx = block.vtx.at(i);
-        outputs += tx->vout.size();
-
-        CAmount tx_total_out = 0;
-        if (loop_outputs) {
-            for (const CTxOut& out : tx->vout) {
-                tx_total_out += out.nValue;
-
-                size_t out_size = GetSerializeSize(out) + PER_UTXO_OVERHEAD;
-                utxo_size_inc += out_size;
-
-                // The Genesis block and the repeated BIP30 block coinbases don't change the UTXO
-                // set counts, so they have to be excluded from the statistics
-                if (pindex.nHeight == 0 || (IsBIP30Repeat(pindex) && tx->IsCoinBase())) continue;
-                // Skip unspendable outputs since they are not included in the UTXO set
-                if (out.scriptPubKey.IsUnspendable()) continue;
-
-                ++utxos;
-                utxo_size_inc_actual += out_size;
-            }
-        }
-
-        if (tx->IsCoinBase()) {
-            continue;
-        }
-
-        inputs += tx->vin.size(); // Don't count coinbase's fake input
-        total_out += tx_total_out; // Don't count coinbase reward
+    return BlockStatsToJSON(GetBlockStats(chainman, pindex), pindex, chainman.GetParams().GetConsensus(), stats);
+},
+    };
+}
 
-        int64_t tx_size = 0;
-        if (do_calculate_size) {
+static RPCHelpMan getblockstatsrange()
+{
+    return RPCHelpMan{
+        "getblockstatsrange",
+        "Compute the per block statistics of getblockstats for a range of heights of the active chain. All amounts are in satoshis.\n"
+        "With -blockstatsindex, the statistics are read from the index instead of being computed from the blocks on disk.\n",
+        {
+            {"start_height", RPCArg::Type::NUM, RPCArg::Optional::NO, "The height of the first block"},
+            {"end_height", RPCArg::Type::NUM, RPCArg::Optional::NO, "The height of the last block (inclusive)"},
+            {"stats", RPCArg::Type::ARR, RPCArg::DefaultHint{"all values"}, "Values to plot (see getblockstats)",
+                {
+                    {"height", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Selected statistic"},
+                    {"time", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Selected statistic"},
+                },
+                RPCArgOptions{.oneline_description="stats"}},
+        },
+        RPCResult{
+            RPCResult::Type::ARR, "", "The statistics of the blocks, in order of height",
+            {
+                {RPCResult::Type::OBJ, "", "", BlockStatsResultFields()},
+            }},
+        RPCExamples{
+            HelpExampleCli("getblockstatsrange", R"(1000 2000 '["minfeerate","avgfeerate"]')") +
+            HelpExampleRpc("getblockstatsrange", R"(1000, 2000, ["minfeerate","avgfeerate"])")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const int start_height{request.params[0].getInt<int>()};
+    const int end_height{request.params[1].getInt<int>()};
+    const std::set<std::string> stats{ParseSelectedStats(request.params[2])};
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid range of heights");
+    }
 
-            tx_size = tx->GetTotalSize();
-            if (do_mediantxsize) {
-                txsize_array.push_back(tx_size);
-            }
-            maxtxsize = std::max(maxtxsize, tx_size);
-            mintxsize = std::min(mintxsize, tx_size);
-            total_size += tx_size;
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = chainman.ActiveChain();
+        if (end_height > active_chain.Height()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Target block height %d after current tip %d", end_height, active_chain.Height()));
         }
-
-        int64_t weight = 0;
-        if (do_calculate_weight) {
-            weight = GetTransactionWeight(*tx);
-            total_weight += weight;
+        for (int height{start_height}; height <= end_height; ++height) {
+            blocks.push_back(active_chain[height]);
         }
+    }
 
-        if (do_calculate_sw && tx->HasWitness()) {
-            ++swtxs;
-            swtotal_size += tx_size;
-            swtotal_weight += weight;
+    const Consensus::Params& consensus{chainman.GetParams().GetConsensus()};
+    // Stream long ranges rather than holding the statistics of all blocks at once.
+    if (JSONStreamWriter* stream{request.m_result_stream}) {
+        stream->BeginArray();
+        for (const CBlockIndex* pindex : blocks) {
+            stream->Value(BlockStatsToJSON(GetBlockStats(chainman, *pindex), *pindex, consensus, stats));
         }
+        stream->EndArray();
+        return NullUniValue;
+    }
+    UniValue ret(UniValue::VARR);
+    for (const CBlockIndex* pindex : blocks) {
+        ret.push_back(BlockStatsToJSON(GetBlockStats(chainman, *pindex), *pindex, consensus, stats));
+    }
+    return ret;
+},
+    };
+}
 
-        if (loop_inputs) {
-            CAmount tx_total_in = 0;
-            const auto& txundo = blockUndo.vtxundo.at(i - 1);
-            for (const Coin& coin: txundo.vprevout) {
-                const CTxOut& prevoutput = coin.out;
-
-                tx_total_in += prevoutput.nValue;
-                size_t prevout_size = GetSerializeSize(prevoutput) + PER_UTXO_OVERHEAD;
-                utxo_size_inc -= prevout_size;
-                utxo_size_inc_actual -= prevout_size;
-            }
-
-            CAmount txfee = tx_total_in - tx_total_out;
-            CHECK_NONFATAL(MoneyRange(txfee));
-            if (do_medianfee) {
-                fee_array.push_back(txfee);
+UniValue ScriptHashHistoryToJSON(ChainstateManager& chainman, const uint256& scripthash, const std::vector<ScriptHashTxRef>& history, const std::optional<int>& next_height)
+{
+    UniValue entries(UniValue::VARR);
+    const CBlockIndex* pindex{nullptr};
+    std::vector<std::byte> block_data;
+    std::optional<BlockView> block;
+    for (const ScriptHashTxRef& ref : history) {
+        if (!pindex || pindex->nHeight != ref.height) {
+            // Read each block once, to look up the ids of its transactions,
+            // which does not need it deserialized.
+            FlatFilePos pos{};
+            {
+                LOCK(cs_main);
+                pindex = chainman.ActiveChain()[ref.height];
+                if (!pindex) break; // the chain got shorter since the lookup
+                pos = pindex->GetBlockPos();
             }
-            maxfee = std::max(maxfee, txfee);
-            minfee = std::min(minfee, txfee);
-            totalfee += txfee;
-
-            // New feerate uses satoshis per virtual byte instead of per serialized byte
-            CAmount feerate = weight ? (txfee * WITNESS_SCALE_FACTOR) / weight : 0;
-            if (do_feerate_percentiles) {
-                feerate_array.emplace_back(feerate, weight);
+            block.reset();
+            if (chainman.m_blockman.ReadRawBlock(block_data, pos)) {
+                try {
+                    block.emplace(block_data);
+                } catch (const std::ios_base::failure&) {
+                }
             }
-            maxfeerate = std::max(maxfeerate, feerate);
-            minfeerate = std::min(minfeerate, feerate);
         }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("height", ref.height);
+        entry.pushKV("blockhash", pindex->GetBlockHash().GetHex());
+        entry.pushKV("txpos", ref.tx_pos);
+        if (block && ref.tx_pos < block->Transactions().size()) {
+            entry.pushKV("txid", block->Transactions()[ref.tx_pos].GetHash().GetHex());
+        }
+        entry.pushKV("type", ref.spending ? "spending" : "funding");
+        entries.push_back(std::move(entry));
     }
 
-    CAmount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = { 0 };
-    CalculatePercentilesByWeight(feerate_percentiles, feerate_array, total_weight);
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("scripthash", scripthash.GetHex());
+    ret.pushKV("history", std::move(entries));
+    if (next_height) ret.pushKV("next_height", *next_height);
+    return ret;
+}
 
-    UniValue feerates_res(UniValue::VARR);
-    for (int64_t i = 0; i < NUM_GETBLOCKSTATS_PERCENTILES; i++) {
-        feerates_res.push_back(feerate_percentiles[i]);
+static RPCHelpMan getscripthashhistory()
+{
+    return RPCHelpMan{
+        "getscripthashhistory",
+        "Return the transactions funding or spending a scriptPubKey, in chain order. Requires -scripthashindex.\n"
+        "Long histories are returned in pages of at least count transactions; continue from next_height to get the next one.\n",
+        {
+            {"scripthash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The SHA256 of the scriptPubKey, in reversed byte order as in the Electrum protocol"},
+            {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The height of the first block to look at"},
+            {"end_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the height of the index"}, "The height of the last block to look at (inclusive)"},
+            {"count", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_SCRIPTHASH_HISTORY_COUNT}, strprintf("The number of transactions after which to stop at the end of a block (1 to %d)", MAX_SCRIPTHASH_HISTORY_COUNT)},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::STR_HEX, "scripthash", "The script hash"},
+                {RPCResult::Type::ARR, "history", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "height", "The height of the block"},
+                        {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block"},
+                        {RPCResult::Type::NUM, "txpos", "The position of the transaction in the block"},
+                        {RPCResult::Type::STR_HEX, "txid", /*optional=*/true, "The transaction id, unless the block was pruned"},
+                        {RPCResult::Type::STR, "type", "\"funding\" if the transaction pays to the script, \"spending\" if it spends an output paying to it"},
+                    }},
+                }},
+                {RPCResult::Type::NUM, "next_height", /*optional=*/true, "The height to continue from, if not all of the range was looked at"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getscripthashhistory", "\"8b01df4e368ea28f8dc0423bcf7a4923e3a12d307c875e47a0cfbf90b5c39161\"") +
+            HelpExampleRpc("getscripthashhistory", "\"8b01df4e368ea28f8dc0423bcf7a4923e3a12d307c875e47a0cfbf90b5c39161\", 0, 1000")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_scripthash_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Index is not enabled. Start with -scripthashindex");
+    }
+    const uint256 scripthash{ParseHashV(request.params[0], "scripthash")};
+    const int count{self.Arg<int>("count")};
+    if (count < 1 || count > MAX_SCRIPTHASH_HISTORY_COUNT) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count must be between 1 and %d", MAX_SCRIPTHASH_HISTORY_COUNT));
     }
 
-    UniValue ret_all(UniValue::VOBJ);
-    ret_all.pushKV("avgfee", (block.vtx.size() > 1) ? totalfee / (block.vtx.size() - 1) : 0);
-    ret_all.pushKV("avgfeerate", total_weight ? (totalfee * WITNESS_SCALE_FACTOR) / total_weight : 0); // Unit: sat/vbyte
-    ret_all.pushKV("avgtxsize", (block.vtx.size() > 1) ? total_size / (block.vtx.size() - 1) : 0);
-    ret_all.pushKV("blockhash", pindex.GetBlockHash().GetHex());
-    ret_all.pushKV("feerate_percentiles", std::move(feerates_res));
-    ret_all.pushKV("height", (int64_t)pindex.nHeight);
-    ret_all.pushKV("ins", inputs);
-    ret_all.pushKV("maxfee", maxfee);
-    ret_all.pushKV("maxfeerate", maxfeerate);
-    ret_all.pushKV("maxtxsize", maxtxsize);
-    ret_all.pushKV("medianfee", CalculateTruncatedMedian(fee_array));
-    ret_all.pushKV("mediantime", pindex.GetMedianTimePast());
-    ret_all.pushKV("mediantxsize", CalculateTruncatedMedian(txsize_array));
-    ret_all.pushKV("minfee", (minfee == MAX_MONEY) ? 0 : minfee);
-    ret_all.pushKV("minfeerate", (minfeerate == MAX_MONEY) ? 0 : minfeerate);
-    ret_all.pushKV("mintxsize", mintxsize == MAX_BLOCK_SERIALIZED_SIZE ? 0 : mintxsize);
-    ret_all.pushKV("outs", outputs);
-    ret_all.pushKV("subsidy", GetBlockSubsidy(pindex.nHeight, chainman.GetParams().GetConsensus()));
-    ret_all.pushKV("swtotal_size", swtotal_size);
-    ret_all.pushKV("swtotal_weight", swtotal_weight);
-    ret_all.pushKV("swtxs", swtxs);
-    ret_all.pushKV("time", pindex.GetBlockTime());
-    ret_all.pushKV("total_out", total_out);
-    ret_all.pushKV("total_size", total_size);
-    ret_all.pushKV("total_weight", total_weight);
-    ret_all.pushKV("totalfee", totalfee);
-    ret_all.pushKV("txs", (int64_t)block.vtx.size());
-    ret_all.pushKV("utxo_increase", outputs - inputs);
-    ret_all.pushKV("utxo_size_inc", utxo_size_inc);
-    ret_all.pushKV("utxo_increase_actual", utxos - inputs);
-    ret_all.pushKV("utxo_size_inc_actual", utxo_size_inc_actual);
-
-    if (do_all) {
-        return ret_all;
+    if (!g_scripthash_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because scripthashindex is still syncing. Current height: %d", g_scripthash_index->GetSummary().best_block_height));
+    }
+    const int start_height{self.Arg<int>("start_height")};
+    const int end_height{request.params[2].isNull() ? g_scripthash_index->GetSummary().best_block_height : request.params[2].getInt<int>()};
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid range of heights");
     }
 
-    UniValue ret(UniValue::VOBJ);
-    for (const std::string& stat : stats) {
-        const UniValue& value = ret_all[stat];
-        if (value.isNull()) {
-            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic '%s'", stat));
-        }
-        ret.pushKV(stat, value);
+    std::vector<ScriptHashTxRef> history;
+    std::optional<int> next_height;
+    if (!g_scripthash_index->FindHistory(scripthash, start_height, end_height, count, history, next_height)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read the scripthash index");
     }
-    return ret;
+    return ScriptHashHistoryToJSON(EnsureAnyChainman(request.context), scripthash, history, next_height);
 },
     };
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Search for a given set of pubkey scripts, scanning the ranges of the cursors concurrently
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, std::span<const std::unique_ptr<CCoinsViewCursor>> cursors, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
 {
     scan_progress = 0;
     count = 0;
-    while (cursor->Valid()) {
-        COutPoint key;
-        Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
-        if (++count % 8192 == 0) {
-            interruption_point();
-            if (should_abort) {
-                // allow to abort the scan via the abort reference
-                return false;
+    // Progress is the share of two-byte txid prefixes passed by all cursors.
+    std::atomic<uint32_t> prefixes_done{0};
+    std::atomic<int64_t> total_count{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::map<COutPoint, Coin>> results(cursors.size());
+    ThreadPool pool{"scantxoutset"};
+    if (cursors.size() > 1) pool.Start(cursors.size());
+    std::vector<std::future<bool>> scans;
+    for (size_t i{0}; i < cursors.size(); ++i) {
+        scans.push_back(pool.Submit([&, &cursor = *cursors[i], &found = results[i]]() {
+            std::optional<uint32_t> last_prefix;
+            while (cursor.Valid()) {
+                COutPoint key;
+                Coin coin;
+                if (stop || !cursor.GetKey(key) || !cursor.GetValue(coin)) return false;
+                if (++total_count % 8192 == 0) {
+                    try {
+                        interruption_point();
+                    } catch (...) {
+                        stop = true;
+                        throw;
+                    }
+                    if (should_abort) {
+                        // allow to abort the scan via the abort reference
+                        stop = true;
+                        return false;
+                    }
+                }
+                const uint32_t prefix = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
+                if (!last_prefix) last_prefix = prefix;
+                if (total_count % 256 == 0) {
+                    // update progress reference every 256 item
+                    const uint32_t done{prefixes_done += prefix - *last_prefix};
+                    last_prefix = prefix;
+                    scan_progress = (int)(done * 100.0 / 65536.0 + 0.5);
+                }
+                if (needles.count(coin.out.scriptPubKey)) {
+                    found.emplace(key, coin);
+                }
+                cursor.Next();
             }
-        }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
-        if (needles.count(coin.out.scriptPubKey)) {
-            out_results.emplace(key, coin);
-        }
-        cursor->Next();
+            return true;
+        }));
     }
+    bool success{true};
+    for (auto& scan : scans) success &= scan.get();
+    count = total_count;
+    if (!success) return false;
+    for (auto& found : results) out_results.merge(found);
     scan_progress = 100;
     return true;
 }
@@ -2334,7 +2679,7 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
         {
@@ -2342,10 +2687,11 @@ static RPCHelpMan scantxoutset()
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            cursors = active_chainstate.CoinsDB().Cursors(GetUTXOScanThreads(EnsureArgsman(node)));
+            CHECK_NONFATAL(!cursors.empty());
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2412,16 +2758,25 @@ public:
 
 static bool CheckBlockFilterMatches(BlockManager& blockman, const CBlockIndex& blockindex, const GCSFilter::ElementSet& needles)
 {
-    const CBlock block{GetBlockChecked(blockman, blockindex)};
+    const std::vector<std::byte> block_data{GetRawBlockChecked(blockman, blockindex)};
     const CBlockUndo block_undo{GetUndoChecked(blockman, blockindex)};
 
-    // Check if any of the outputs match the scriptPubKey
-    for (const auto& tx : block.vtx) {
-        if (std::any_of(tx->vout.cbegin(), tx->vout.cend(), [&](const auto& txout) {
-                return needles.count(std::vector<unsigned char>(txout.scriptPubKey.begin(), txout.scriptPubKey.end())) != 0;
-            })) {
-            return true;
-        }
+    // Check if any of the outputs match the scriptPubKey, reading them from
+    // the raw block into one buffer rather than deserializing the block.
+    std::optional<BlockView> block;
+    try {
+        block.emplace(block_data);
+    } catch (const std::ios_base::failure&) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    }
+    GCSFilter::Element element;
+    bool match{false};
+    for (const TxView& tx : block->Transactions()) {
+        tx.ForEachOutput([&](CAmount, std::span<const unsigned char> script_pubkey) {
+            element.assign(script_pubkey.begin(), script_pubkey.end());
+            match = match || needles.contains(element);
+        });
+        if (match) return true;
     }
     // Check if any of the inputs match the scriptPubKey
     for (const auto& txundo : block_undo.vtxundo) {
@@ -2561,6 +2916,9 @@ static RPCHelpMan scanblocks()
         int start_block_height = start_index->nHeight; // for progress reporting
         const int total_blocks_to_process = stop_block->nHeight - start_block_height;
 
+        const int threads{GetBlockScanThreads(EnsureArgsman(node))};
+        SharedThreadPool::Group pool{GetSharedThreadPool(), SharedThreadPool::Priority::LOW, size_t(threads)};
+
         g_scanfilter_should_abort_scan = false;
         g_scanfilter_progress = 0;
         g_scanfilter_progress_height = start_block_height;
@@ -2581,20 +2939,25 @@ static RPCHelpMan scanblocks()
                     stop_block;
 
             if (index->LookupFilterRange(start_block, end_range, filters)) {
-                for (const BlockFilter& filter : filters) {
-                    // compare the elements-set with each filter
-                    if (filter.GetFilter().MatchAny(needle_set)) {
-                        if (filter_false_positives) {
-                            // Double check the filter matches by scanning the block
-                            const CBlockIndex& blockindex = *CHECK_NONFATAL(WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(filter.GetBlockHash())));
-
-                            if (!CheckBlockFilterMatches(chainman.m_blockman, blockindex, needle_set)) {
-                                continue;
-                            }
-                        }
-
-                        blocks.push_back(filter.GetBlockHash().GetHex());
+                // compare the elements-set with each filter, spread over the workers
+                std::vector<char> matches(filters.size());
+                ParallelFor(pool, filters.size(), [&](size_t i) {
+                    matches[i] = filters[i].GetFilter().MatchAny(needle_set);
+                });
+                if (filter_false_positives) {
+                    // Double check the filter matches by scanning the blocks, reading them concurrently
+                    std::vector<size_t> matched;
+                    for (size_t i{0}; i < filters.size(); ++i) {
+                        if (matches[i]) matched.push_back(i);
                     }
+                    ParallelFor(pool, matched.size(), [&](size_t m) {
+                        const BlockFilter& filter{filters[matched[m]]};
+                        const CBlockIndex& blockindex = *CHECK_NONFATAL(WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(filter.GetBlockHash())));
+                        matches[matched[m]] = CheckBlockFilterMatches(chainman.m_blockman, blockindex, needle_set);
+                    });
+                }
+                for (size_t i{0}; i < filters.size(); ++i) {
+                    if (matches[i]) blocks.push_back(filters[i].GetBlockHash().GetHex());
                 }
             }
             start_index = end_range;
@@ -2763,8 +3126,16 @@ static RPCHelpMan getdescriptoractivity()
         blockman = CHECK_NONFATAL(&active_chainstate.m_blockman);
     }
 
-    for (const CBlockIndex* blockindex : blockindexes_sorted) {
-        const CBlock block{GetBlockChecked(chainman.m_blockman, *blockindex)};
+    // Read and scan the blocks concurrently, collecting the events of each block
+    // separately so they can be returned in order.
+    const std::vector<const CBlockIndex*> blockindexes(blockindexes_sorted.begin(), blockindexes_sorted.end());
+    std::vector<std::vector<UniValue>> block_activity(blockindexes.size());
+    const int threads{GetBlockScanThreads(EnsureArgsman(node))};
+    SharedThreadPool::Group pool{GetSharedThreadPool(), SharedThreadPool::Priority::LOW, size_t(threads)};
+    ParallelFor(pool, blockindexes.size(), [&](size_t b) {
+        const CBlockIndex* blockindex{blockindexes[b]};
+        std::vector<UniValue>& events{block_activity[b]};
+        const CBlock block{GetBlockChecked(*blockman, *blockindex)};
         const CBlockUndo block_undo{GetUndoChecked(*blockman, *blockindex)};
 
         for (size_t i = 0; i < block.vtx.size(); ++i) {
@@ -2778,7 +3149,7 @@ static RPCHelpMan getdescriptoractivity()
                     const auto& coin = txundo.vprevout.at(vin_idx);
                     const auto& txin = tx->vin.at(vin_idx);
                     if (scripts_to_watch.contains(coin.out.scriptPubKey)) {
-                        activity.push_back(AddSpend(
+                        events.push_back(AddSpend(
                                     coin.out.scriptPubKey, coin.out.nValue, tx, vin_idx, txin, blockindex));
                     }
                 }
@@ -2787,10 +3158,13 @@ static RPCHelpMan getdescriptoractivity()
             for (size_t vout_idx = 0; vout_idx < tx->vout.size(); ++vout_idx) {
                 const auto& vout = tx->vout.at(vout_idx);
                 if (scripts_to_watch.contains(vout.scriptPubKey)) {
-                    activity.push_back(AddReceive(vout, blockindex, vout_idx, tx));
+                    events.push_back(AddReceive(vout, blockindex, vout_idx, tx));
                 }
             }
         }
+    });
+    for (auto& events : block_activity) {
+        for (auto& event : events) activity.push_back(std::move(event));
     }
 
     bool search_mempool = true;
@@ -2991,6 +3365,9 @@ static RPCHelpMan dumptxoutset()
                     {"rollback", RPCArg::Type::NUM, RPCArg::Optional::OMITTED,
                         "Height or hash of the block to roll back to before creating the snapshot. Note: The further this number is from the tip, the longer this process will take. Consider setting a higher -rpcclienttimeout value in this case.",
                     RPCArgOptions{.skip_type_check = true, .type_str = {"", "string or numeric"}}},
+                    {"chunked", RPCArg::Type::BOOL, RPCArg::Default{false},
+                        "Write the coins in chunks with their own hashes, serialized concurrently by -utxoscanthreads threads. "
+                        "Such snapshots are also decoded concurrently by loadtxoutset, but cannot be loaded by nodes predating snapshot version 3."},
                 },
             },
         },
@@ -3008,7 +3385,8 @@ static RPCHelpMan dumptxoutset()
         RPCExamples{
             HelpExampleCli("-rpcclienttimeout=0 dumptxoutset", "utxo.dat latest") +
             HelpExampleCli("-rpcclienttimeout=0 dumptxoutset", "utxo.dat rollback") +
-            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat rollback=853456)")
+            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat rollback=853456)") +
+            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat latest chunked=true)")
         },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -3032,6 +3410,7 @@ static RPCHelpMan dumptxoutset()
     } else {
         throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid snapshot type \"%s\" specified. Please specify \"rollback\" or \"latest\"", snapshot_type));
     }
+    const bool chunked{options.exists("chunked") && options["chunked"].get_bool()};
 
     const ArgsManager& args{EnsureAnyArgsman(request.context)};
     const fs::path path = fsbridge::AbsPathJoin(args.GetDataDirNet(), fs::u8path(request.params[0].get_str()));
@@ -3091,6 +3470,9 @@ static RPCHelpMan dumptxoutset()
 
     Chainstate* chainstate;
     std::unique_ptr<CCoinsViewCursor> cursor;
+    // Cursors over consecutive ranges of the coins, for chunked snapshots
+    std::vector<std::unique_ptr<CCoinsViewCursor>> range_cursors;
+    const int threads{GetUTXOScanThreads(args)};
     CCoinsStats stats;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
@@ -3112,17 +3494,32 @@ static RPCHelpMan dumptxoutset()
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
         } else {
             std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
+            if (chunked) {
+                // Taken while holding the lock too, so that they read the same coins as cursor.
+                range_cursors = chainstate->CoinsDB().Cursors(std::clamp<uint64_t>(stats.coins_count / SNAPSHOT_RANGE_COINS, threads, MAX_SNAPSHOT_RANGES));
+                cursor.reset();
+            }
         }
     }
 
-    UniValue result = WriteUTXOSnapshot(*chainstate,
-                                        cursor.get(),
-                                        &stats,
-                                        tip,
-                                        std::move(afile),
-                                        path,
-                                        temppath,
-                                        node.rpc_interruption_point);
+    UniValue result = chunked ?
+        WriteChunkedUTXOSnapshot(*chainstate,
+                                 range_cursors,
+                                 stats,
+                                 tip,
+                                 std::move(afile),
+                                 path,
+                                 temppath,
+                                 threads,
+                                 node.rpc_interruption_point) :
+        WriteUTXOSnapshot(*chainstate,
+                          cursor.get(),
+                          &stats,
+                          tip,
+                          std::move(afile),
+                          path,
+                          temppath,
+                          node.rpc_interruption_point);
     fs::rename(temppath, path);
 
     result.pushKV("path", path.utf8string());
@@ -3169,6 +3566,30 @@ PrepareUTXOSnapshot(
     return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
 }
 
+//! Serialize the coins of a txid as stored in snapshots.
+template <typename Stream>
+static void SerializeSnapshotCoins(Stream& s, const Txid& txid, const std::vector<std::pair<uint32_t, Coin>>& coins)
+{
+    s << txid;
+    WriteCompactSize(s, coins.size());
+    for (const auto& [n, coin] : coins) {
+        WriteCompactSize(s, n);
+        s << coin;
+    }
+}
+
+static UniValue UTXOSnapshotResult(size_t written_coins_count, const CBlockIndex* tip, const fs::path& path, const CCoinsStats& stats)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("coins_written", written_coins_count);
+    result.pushKV("base_hash", tip->GetBlockHash().ToString());
+    result.pushKV("base_height", tip->nHeight);
+    result.pushKV("path", path.utf8string());
+    result.pushKV("txoutset_hash", stats.hashSerialized.ToString());
+    result.pushKV("nchaintx", tip->m_chain_tx_count);
+    return result;
+}
+
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
@@ -3199,18 +3620,8 @@ UniValue WriteUTXOSnapshot(
     // leveldb that keys are lexicographically sorted.
     // In the coins vector we collect all coins that belong to a certain tx hash
     // (key.hash) and when we have them all (key.hash != last_hash) we write
-    // them to file using the below lambda function.
+    // them to file using SerializeSnapshotCoins.
     // See also https://github.com/bitcoin/bitcoin/issues/25675
-    auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
-        for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
-            ++written_coins_count;
-        }
-    };
-
     pcursor->GetKey(key);
     last_hash = key.hash;
     while (pcursor->Valid()) {
@@ -3218,7 +3629,8 @@ UniValue WriteUTXOSnapshot(
         ++iter;
         if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
             if (key.hash != last_hash) {
-                write_coins_to_file(afile, last_hash, coins, written_coins_count);
+                SerializeSnapshotCoins(afile, last_hash, coins);
+                written_coins_count += coins.size();
                 last_hash = key.hash;
                 coins.clear();
             }
@@ -3228,7 +3640,8 @@ UniValue WriteUTXOSnapshot(
     }
 
     if (!coins.empty()) {
-        write_coins_to_file(afile, last_hash, coins, written_coins_count);
+        SerializeSnapshotCoins(afile, last_hash, coins);
+        written_coins_count += coins.size();
     }
 
     CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
@@ -3238,14 +3651,100 @@ UniValue WriteUTXOSnapshot(
             strprintf("Error closing %s: %s", fs::PathToString(temppath), SysErrorString(errno)));
     }
 
-    UniValue result(UniValue::VOBJ);
-    result.pushKV("coins_written", written_coins_count);
-    result.pushKV("base_hash", tip->GetBlockHash().ToString());
-    result.pushKV("base_height", tip->nHeight);
-    result.pushKV("path", path.utf8string());
-    result.pushKV("txoutset_hash", maybe_stats->hashSerialized.ToString());
-    result.pushKV("nchaintx", tip->m_chain_tx_count);
-    return result;
+    return UTXOSnapshotResult(written_coins_count, tip, path, *maybe_stats);
+}
+
+//! Serialize the coins visited by cursor into chunks of chunked snapshots.
+static std::vector<node::SnapshotChunk> SerializeSnapshotChunks(CCoinsViewCursor& cursor, const std::function<void()>& interruption_point)
+{
+    std::vector<node::SnapshotChunk> chunks;
+    DataStream payload;
+    uint64_t payload_coins{0};
+    Txid txid;
+    std::vector<std::pair<uint32_t, Coin>> coins;
+    const auto add_coins{[&] {
+        SerializeSnapshotCoins(payload, txid, coins);
+        payload_coins += coins.size();
+        coins.clear();
+    }};
+    const auto end_chunk{[&] {
+        node::SnapshotChunk& chunk{chunks.emplace_back()};
+        chunk.coins_count = payload_coins;
+        chunk.payload.assign(payload.begin(), payload.end());
+        chunk.payload_hash = Hash(chunk.payload);
+        payload.clear();
+        payload_coins = 0;
+    }};
+
+    unsigned int iter{0};
+    COutPoint key;
+    Coin coin;
+    for (; cursor.Valid(); cursor.Next()) {
+        if (++iter % 5000 == 0 && interruption_point) interruption_point();
+        if (!cursor.GetKey(key) || !cursor.GetValue(coin)) continue;
+        if (!coins.empty() && key.hash != txid) {
+            add_coins();
+            if (payload.size() >= node::SNAPSHOT_CHUNK_SIZE) end_chunk();
+        }
+        txid = key.hash;
+        coins.emplace_back(key.n, std::move(coin));
+    }
+    if (!coins.empty()) add_coins();
+    if (payload_coins > 0) end_chunk();
+    return chunks;
+}
+
+/**
+ * Write a chunked snapshot of the coins visited by cursors, which must cover
+ * consecutive ranges of the coins in order. The ranges are serialized
+ * concurrently on `threads` threads, ahead of the range being written to
+ * afile, and at most one more than there are threads so that the memory
+ * used stays bounded.
+ */
+static UniValue WriteChunkedUTXOSnapshot(
+    Chainstate& chainstate,
+    std::span<const std::unique_ptr<CCoinsViewCursor>> cursors,
+    const CCoinsStats& stats,
+    const CBlockIndex* tip,
+    AutoFile&& afile,
+    const fs::path& path,
+    const fs::path& temppath,
+    int threads,
+    const std::function<void()>& interruption_point)
+{
+    LOG_TIME_SECONDS(strprintf("writing chunked UTXO snapshot at height %s (%s) to file %s (via %s) with %d threads",
+        tip->nHeight, tip->GetBlockHash().ToString(),
+        fs::PathToString(path), fs::PathToString(temppath), threads));
+
+    afile << SnapshotMetadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), stats.coins_count, /*chunked=*/true};
+
+    ThreadPool pool{"utxodump"};
+    pool.Start(threads);
+    std::deque<std::future<std::vector<node::SnapshotChunk>>> pending;
+    size_t next_range{0};
+    size_t written_coins_count{0};
+    while (next_range < cursors.size() || !pending.empty()) {
+        while (next_range < cursors.size() && pending.size() <= static_cast<size_t>(threads)) {
+            pending.push_back(pool.Submit([&cursor = *cursors[next_range], &interruption_point] {
+                return SerializeSnapshotChunks(cursor, interruption_point);
+            }));
+            ++next_range;
+        }
+        for (const node::SnapshotChunk& chunk : pending.front().get()) {
+            afile << chunk;
+            written_coins_count += chunk.coins_count;
+        }
+        pending.pop_front();
+    }
+
+    CHECK_NONFATAL(written_coins_count == stats.coins_count);
+
+    if (afile.fclose() != 0) {
+        throw std::ios_base::failure(
+            strprintf("Error closing %s: %s", fs::PathToString(temppath), SysErrorString(errno)));
+    }
+
+    return UTXOSnapshotResult(written_coins_count, tip, path, stats);
 }
 
 UniValue CreateUTXOSnapshot(
@@ -3253,8 +3752,21 @@ UniValue CreateUTXOSnapshot(
     Chainstate& chainstate,
     AutoFile&& afile,
     const fs::path& path,
-    const fs::path& tmppath)
+    const fs::path& tmppath,
+    bool chunked)
 {
+    if (chunked) {
+        CCoinsStats stats;
+        const CBlockIndex* tip;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+        {
+            LOCK(::cs_main);
+            std::tie(std::ignore, stats, tip) = PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point);
+            // Several ranges served by fewer threads, as in dumptxoutset.
+            cursors = chainstate.CoinsDB().Cursors(4);
+        }
+        return WriteChunkedUTXOSnapshot(chainstate, cursors, stats, tip, std::move(afile), path, tmppath, /*threads=*/2, node.rpc_interruption_point);
+    }
     auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
     return WriteUTXOSnapshot(chainstate,
                              cursor.get(),
@@ -3357,6 +3869,14 @@ const std::vector<RPCResult> RPCHelpForChainstate{
     {RPCResult::Type::STR_HEX, "snapshot_blockhash", /*optional=*/true, "the base block of the snapshot this chainstate is based on, if any"},
     {RPCResult::Type::NUM, "coins_db_cache_bytes", "size of the coinsdb cache"},
     {RPCResult::Type::NUM, "coins_tip_cache_bytes", "size of the coinstip cache"},
+    {RPCResult::Type::OBJ, "coins_flush", "writes of the coinstip cache to the coinsdb", {
+        {RPCResult::Type::BOOL, "incremental_pending", "whether incremental writes (-coinsflushchunk) have left the coinsdb behind the tip"},
+        {RPCResult::Type::NUM, "full_flushes", "number of writes of all modified coins at once"},
+        {RPCResult::Type::NUM, "chunks", "number of incremental writes"},
+        {RPCResult::Type::NUM, "chunk_coins", "number of modified coins written incrementally"},
+        {RPCResult::Type::NUM, "stall_time", "total time in seconds validation waited for coins to be written"},
+        {RPCResult::Type::NUM, "max_stall", "longest single write of coins in seconds"},
+    }},
     {RPCResult::Type::BOOL, "validated", "whether the chainstate is fully validated. True if all blocks in the chainstate were validated, false if the chain is based on a snapshot and the snapshot has not yet been validated."},
 };
 
@@ -3383,7 +3903,7 @@ return RPCHelpMan{
 
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
 
-    auto make_chain_data = [&](const Chainstate& cs, bool validated) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    auto make_chain_data = [&](Chainstate& cs, bool validated) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
         UniValue data(UniValue::VOBJ);
         if (!cs.m_chain.Tip()) {
@@ -3400,6 +3920,15 @@ return RPCHelpMan{
         data.pushKV("verificationprogress", chainman.GuessVerificationProgress(tip));
         data.pushKV("coins_db_cache_bytes",  cs.m_coinsdb_cache_size_bytes);
         data.pushKV("coins_tip_cache_bytes", cs.m_coinstip_cache_size_bytes);
+        const CoinsFlushStats flush_stats{cs.GetCoinsFlushStats()};
+        UniValue coins_flush(UniValue::VOBJ);
+        coins_flush.pushKV("incremental_pending", cs.HasCoinsViews() && cs.CoinsDB().IsPartiallyWritten());
+        coins_flush.pushKV("full_flushes", flush_stats.full_flushes);
+        coins_flush.pushKV("chunks", flush_stats.chunks);
+        coins_flush.pushKV("chunk_coins", flush_stats.chunk_coins);
+        coins_flush.pushKV("stall_time", Ticks<SecondsDouble>(flush_stats.stall_time));
+        coins_flush.pushKV("max_stall", Ticks<SecondsDouble>(flush_stats.max_stall));
+        data.pushKV("coins_flush", std::move(coins_flush));
         if (cs.m_from_snapshot_blockhash) {
             data.pushKV("snapshot_blockhash", cs.m_from_snapshot_blockhash->ToString());
         }
@@ -3421,22 +3950,183 @@ return RPCHelpMan{
 }
 
 
+static RPCHelpMan getblockconnectstats()
+{
+    return RPCHelpMan{
+        "getblockconnectstats",
+        strprintf("Return the time spent in each stage of connecting the most recently connected blocks.\n"
+                  "Timings are kept for the last %d blocks connected by any chainstate, and are not persisted across restarts.\n"
+                  "Stages that did not run for a block, for example reading a block that was received from a peer, are reported as 0.\n",
+                  BLOCK_CONNECT_STATS_SIZE),
+        {
+            {"count", RPCArg::Type::NUM, RPCArg::DefaultHint{"all"}, "Only return the most recent count blocks"},
+        },
+        RPCResult{
+            RPCResult::Type::ARR, "", "blocks ordered by the time they were connected, the most recent last",
+            {
+                {RPCResult::Type::OBJ, "", "", {
+                    {RPCResult::Type::STR_HEX, "hash", "the block hash"},
+                    {RPCResult::Type::NUM, "height", "the block height"},
+                    {RPCResult::Type::NUM, "read", "milliseconds spent reading the block from disk, or waiting for it to be read ahead"},
+                    {RPCResult::Type::NUM, "deserialize", "milliseconds spent deserializing the block"},
+                    {RPCResult::Type::NUM, "check", "milliseconds spent in CheckBlock and the other checks before the transactions are connected"},
+                    {RPCResult::Type::NUM, "inputs", "milliseconds spent prefetching the block's inputs (-prefetchthreads)"},
+                    {RPCResult::Type::NUM, "connect", "milliseconds spent connecting the transactions, including input lookups"},
+                    {RPCResult::Type::NUM, "verify", "milliseconds spent waiting for the script checks after the transactions were connected"},
+                    {RPCResult::Type::NUM, "undo", "milliseconds spent writing the undo data"},
+                    {RPCResult::Type::NUM, "index", "milliseconds spent updating the block index"},
+                    {RPCResult::Type::NUM, "flush", "milliseconds spent writing the block's changes to the coins cache"},
+                    {RPCResult::Type::NUM, "chainstate", "milliseconds spent writing the chainstate to disk after the block"},
+                    {RPCResult::Type::NUM, "total", "milliseconds spent connecting the block in total"},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getblockconnectstats", "")
+            + HelpExampleCli("getblockconnectstats", "10")
+            + HelpExampleRpc("getblockconnectstats", "10")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const std::vector<BlockConnectStats> all_stats{WITH_LOCK(::cs_main, return chainman.GetBlockConnectStats())};
+    size_t count{all_stats.size()};
+    if (!request.params[0].isNull()) {
+        const int requested{request.params[0].getInt<int>()};
+        if (requested < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+        count = std::min<size_t>(count, requested);
+    }
+
+    UniValue result(UniValue::VARR);
+    for (auto it{all_stats.end() - count}; it != all_stats.end(); ++it) {
+        const BlockConnectStats& stats{*it};
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("hash", stats.hash.GetHex());
+        entry.pushKV("height", stats.height);
+        entry.pushKV("read", Ticks<MillisecondsDouble>(stats.read));
+        entry.pushKV("deserialize", Ticks<MillisecondsDouble>(stats.deserialize));
+        entry.pushKV("check", Ticks<MillisecondsDouble>(stats.check));
+        entry.pushKV("inputs", Ticks<MillisecondsDouble>(stats.inputs));
+        entry.pushKV("connect", Ticks<MillisecondsDouble>(stats.connect));
+        entry.pushKV("verify", Ticks<MillisecondsDouble>(stats.verify));
+        entry.pushKV("undo", Ticks<MillisecondsDouble>(stats.undo));
+        entry.pushKV("index", Ticks<MillisecondsDouble>(stats.index));
+        entry.pushKV("flush", Ticks<MillisecondsDouble>(stats.flush));
+        entry.pushKV("chainstate", Ticks<MillisecondsDouble>(stats.chainstate));
+        entry.pushKV("total", Ticks<MillisecondsDouble>(stats.total));
+        result.push_back(std::move(entry));
+    }
+    return result;
+},
+    };
+}
+
+template <typename T>
+static UniValue BlockDataCacheStatsToJSON(const typename node::BlockDataCache<T>::Stats& stats)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("hits", stats.hits);
+    result.pushKV("misses", stats.misses);
+    result.pushKV("entries", stats.entries);
+    result.pushKV("bytes", stats.bytes);
+    return result;
+}
+
+static RPCHelpMan getblockdatacacheinfo()
+{
+    const std::vector<RPCResult> cache_stats{
+        {RPCResult::Type::NUM, "hits", "number of reads served from memory"},
+        {RPCResult::Type::NUM, "misses", "number of reads that went to disk"},
+        {RPCResult::Type::NUM, "entries", "number of entries currently cached"},
+        {RPCResult::Type::NUM, "bytes", "approximate size of the cached entries in bytes"},
+    };
+    return RPCHelpMan{
+        "getblockdatacacheinfo",
+        "Return statistics of the in-memory cache of recently read blocks and undo data (-blockdatacache).\n"
+        "Only reads of the newest block files are cached, and counted.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::OBJ, "blocks", "cache of raw blocks", cache_stats},
+                {RPCResult::Type::OBJ, "undo", "cache of block undo data", cache_stats},
+                {RPCResult::Type::OBJ, "blocks_no_witness", "cache of blocks without witness data, as served to peers that do not ask for it", cache_stats},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getblockdatacacheinfo", "")
+            + HelpExampleRpc("getblockdatacacheinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("blocks", BlockDataCacheStatsToJSON<std::vector<std::byte>>(chainman.m_blockman.GetRawBlockCacheStats()));
+    result.pushKV("undo", BlockDataCacheStatsToJSON<CBlockUndo>(chainman.m_blockman.GetBlockUndoCacheStats()));
+    result.pushKV("blocks_no_witness", BlockDataCacheStatsToJSON<std::vector<std::byte>>(chainman.m_blockman.GetNoWitnessBlockCacheStats()));
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getsignaturecacheinfo()
+{
+    return RPCHelpMan{
+        "getsignaturecacheinfo",
+        "Return statistics of the cache of valid signatures (-maxsigcachesize), counted since startup.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "hits", "number of signatures found in the cache"},
+                {RPCResult::Type::NUM, "misses", "number of signatures not found in the cache, which were verified"},
+                {RPCResult::Type::NUM, "inserts", "number of valid signatures added to the cache"},
+                {RPCResult::Type::NUM, "evictions", "number of entries dropped to make room for added ones"},
+                {RPCResult::Type::NUM, "max_entries", "maximum number of entries the cache can hold"},
+                {RPCResult::Type::NUM, "max_bytes", "approximate size of the cache in bytes when full"},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getsignaturecacheinfo", "")
+            + HelpExampleRpc("getsignaturecacheinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const SignatureCacheStats stats{chainman.m_validation_cache.m_signature_cache.GetStats()};
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("hits", stats.hits);
+    result.pushKV("misses", stats.misses);
+    result.pushKV("inserts", stats.inserts);
+    result.pushKV("evictions", stats.evictions);
+    result.pushKV("max_entries", stats.max_entries);
+    result.pushKV("max_bytes", stats.max_bytes);
+    return result;
+},
+    };
+}
+
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"blockchain", &getblockchaininfo},
         {"blockchain", &getchaintxstats},
         {"blockchain", &getblockstats},
+        {"blockchain", &getblockstatsrange},
+        {"blockchain", &getscripthashhistory},
         {"blockchain", &getbestblockhash},
         {"blockchain", &getblockcount},
         {"blockchain", &getblock},
         {"blockchain", &getblockfrompeer},
         {"blockchain", &getblockhash},
         {"blockchain", &getblockheader},
+        {"blockchain", &getblockheaders},
         {"blockchain", &getchaintips},
         {"blockchain", &getdifficulty},
         {"blockchain", &getdeploymentinfo},
         {"blockchain", &gettxout},
+        {"blockchain", &gettxouts},
+        {"blockchain", &gettxoutsat},
         {"blockchain", &gettxoutsetinfo},
         {"blockchain", &pruneblockchain},
         {"blockchain", &verifychain},
@@ -3448,6 +4138,9 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &getblockconnectstats},
+        {"blockchain", &getblockdatacacheinfo},
+        {"blockchain", &getsignaturecacheinfo},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
@@ -14,18 +14,32 @@
 
 #include <any>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
+class CChainView;
 class Chainstate;
+class JSONStreamWriter;
 class UniValue;
+struct ScriptHashTxRef;
 namespace node {
 class BlockManager;
 struct NodeContext;
 } // namespace node
 
-static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
+//! -blockscanthreads default; 0 means one thread per core.
+static constexpr int DEFAULT_BLOCK_SCAN_THREADS{0};
+//! Maximum number of threads for -blockscanthreads.
+static constexpr int MAX_BLOCK_SCAN_THREADS{16};
+
+//! Number of transactions after which a script hash history lookup stops, by default and at most.
+static constexpr int DEFAULT_SCRIPTHASH_HISTORY_COUNT{1000};
+static constexpr int MAX_SCRIPTHASH_HISTORY_COUNT{100'000};
+
+//! Maximum number of headers returned for a range of heights by getblockheaders or REST.
+static constexpr int MAX_HEADERS_RANGE_COUNT{100'000};
 
 /**
  * Get the difficulty of the net wrt to the given block index.
@@ -35,17 +49,28 @@ static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
  */
 double GetDifficulty(const CBlockIndex& blockindex);
 
-/** Block description to JSON */
-UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+/**
+ * Block description to JSON. When `stream` is given, the description is written
+ * into it (one transaction at a time) and null is returned.
+ */
+UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit, JSONStreamWriter* stream = nullptr) LOCKS_EXCLUDED(cs_main);
+
+/** Script hash history to JSON, with the transaction ids looked up in the blocks on disk. */
+UniValue ScriptHashHistoryToJSON(ChainstateManager& chainman, const uint256& scripthash, const std::vector<ScriptHashTxRef>& history, const std::optional<int>& next_height) LOCKS_EXCLUDED(cs_main);
+
+/**
+ * The headers of up to `count` blocks of `chain` from `height` on, serialized
+ * one after the other, 80 bytes each. They are read from the block index, so
+ * no lock is needed.
+ */
+std::vector<std::byte> SerializeHeadersRange(const CChainView& chain, int height, int count);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
-/** Used by getblockstats to get feerates at different percentiles by weight  */
-void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
-
 /**
  * Test-only helper to create UTXO snapshots given a chainstate and a file handle.
+ * @param[in] chunked Write a chunked snapshot, see dumptxoutset.
  * @return a UniValue map containing metadata about the snapshot.
  */
 UniValue CreateUTXOSnapshot(
@@ -53,7 +78,8 @@ UniValue CreateUTXOSnapshot(
     Chainstate& chainstate,
     AutoFile&& afile,
     const fs::path& path,
-    const fs::path& tmppath);
+    const fs::path& tmppath,
+    bool chunked = false);
 
 //! Return height of highest block that has been pruned, or std::nullopt if no blocks have been pruned
 std::optional<int> GetPruneHeight(const node::BlockManager& blockman, const CChain& chain) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
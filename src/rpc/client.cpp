@@ -110,11 +110,17 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbosity" },
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
+    { "getblockheaders", 0, "height" },
+    { "getblockheaders", 1, "count" },
+    { "getblockconnectstats", 0, "count" },
     { "getchaintxstats", 0, "nblocks" },
     { "gettransaction", 1, "include_watchonly" },
     { "gettransaction", 2, "verbose" },
     { "getrawtransaction", 1, "verbosity" },
     { "getrawtransaction", 1, "verbose" },
+    { "getrawtransactions", 0, "txids" },
+    { "getrawtransactions", 1, "verbosity" },
+    { "getrawtransactions", 1, "verbose" },
     { "createrawtransaction", 0, "inputs" },
     { "createrawtransaction", 1, "outputs" },
     { "createrawtransaction", 2, "locktime" },
@@ -184,11 +190,16 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "converttopsbt", 2, "iswitness"},
     { "gettxout", 1, "n" },
     { "gettxout", 2, "include_mempool" },
+    { "gettxouts", 0, "outputs" },
+    { "gettxouts", 1, "include_mempool" },
+    { "gettxoutsat", 0, "outputs" },
+    { "gettxoutsat", 1, "height" },
     { "gettxoutproof", 0, "txids" },
     { "gettxoutsetinfo", 1, "hash_or_height" },
     { "gettxoutsetinfo", 2, "use_index"},
     { "dumptxoutset", 2, "options" },
     { "dumptxoutset", 2, "rollback" },
+    { "dumptxoutset", 2, "chunked" },
     { "lockunspent", 0, "unlock" },
     { "lockunspent", 1, "transactions" },
     { "lockunspent", 2, "persistent" },
@@ -243,6 +254,12 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "verifychain", 1, "nblocks" },
     { "getblockstats", 0, "hash_or_height" },
     { "getblockstats", 1, "stats" },
+    { "getblockstatsrange", 0, "start_height" },
+    { "getblockstatsrange", 1, "end_height" },
+    { "getblockstatsrange", 2, "stats" },
+    { "getscripthashhistory", 1, "start_height" },
+    { "getscripthashhistory", 2, "end_height" },
+    { "getscripthashhistory", 3, "count" },
     { "pruneblockchain", 0, "height" },
     { "keypoolrefill", 0, "newsize" },
     { "getrawmempool", 0, "verbose" },
@@ -258,8 +275,11 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "setnetworkactive", 0, "state" },
     { "setwalletflag", 1, "value" },
     { "getmempoolancestors", 1, "verbose" },
+    { "getmempooldelta", 0, "since" },
     { "getmempooldescendants", 1, "verbose" },
     { "gettxspendingprevout", 0, "outputs" },
+    { "gettxspendingprevout", 1, "options" },
+    { "gettxspendingprevout", 1, "spent_only" },
     { "bumpfee", 1, "options" },
     { "bumpfee", 1, "conf_target"},
     { "bumpfee", 1, "fee_rate"},
@@ -272,6 +292,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "psbtbumpfee", 1, "replaceable"},
     { "psbtbumpfee", 1, "outputs"},
     { "psbtbumpfee", 1, "original_change_index"},
+    { "getlockstats", 0, "reset" },
     { "logging", 0, "include" },
     { "logging", 1, "exclude" },
     { "disconnectnode", 1, "nodeid" },
@@ -0,0 +1,110 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+
+#include <univalue.h>
+#include <util/check.h>
+
+#include <utility>
+
+JSONStreamWriter::JSONStreamWriter(Sink sink, std::string prefix, size_t flush_size)
+    : m_sink{std::move(sink)}, m_prefix{std::move(prefix)}, m_flush_size{flush_size}
+{
+}
+
+void JSONStreamWriter::BeforeToken()
+{
+    if (!m_started) {
+        m_buffer = std::move(m_prefix);
+        m_started = true;
+    }
+}
+
+void JSONStreamWriter::BeforeValue()
+{
+    BeforeToken();
+    if (m_after_key) {
+        m_after_key = false;
+        return;
+    }
+    if (!m_first.empty()) {
+        if (!m_first.back()) m_buffer += ',';
+        m_first.back() = false;
+    }
+}
+
+void JSONStreamWriter::MaybeFlush()
+{
+    if (m_buffer.size() >= m_flush_size) {
+        m_sink(std::exchange(m_buffer, {}));
+    }
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    BeforeValue();
+    m_buffer += '{';
+    m_first.push_back(true);
+}
+
+void JSONStreamWriter::EndObject()
+{
+    Assume(!m_first.empty() && !m_after_key);
+    m_first.pop_back();
+    m_buffer += '}';
+    MaybeFlush();
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    BeforeValue();
+    m_buffer += '[';
+    m_first.push_back(true);
+}
+
+void JSONStreamWriter::EndArray()
+{
+    Assume(!m_first.empty() && !m_after_key);
+    m_first.pop_back();
+    m_buffer += ']';
+    MaybeFlush();
+}
+
+void JSONStreamWriter::Key(std::string_view key)
+{
+    Assume(!m_first.empty() && !m_after_key);
+    BeforeValue();
+    m_buffer += UniValue{std::string{key}}.write();
+    m_buffer += ':';
+    m_after_key = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    BeforeValue();
+    m_buffer += value.write();
+    MaybeFlush();
+}
+
+void JSONStreamWriter::KeyValue(std::string_view key, const UniValue& value)
+{
+    Key(key);
+    Value(value);
+}
+
+void JSONStreamWriter::Members(const UniValue& object)
+{
+    for (size_t i{0}; i < object.size(); ++i) {
+        KeyValue(object.getKeys()[i], object.getValues()[i]);
+    }
+}
+
+void JSONStreamWriter::Finish(std::string_view suffix)
+{
+    Assume(m_first.empty());
+    if (!m_started) return;
+    m_buffer += suffix;
+    if (!m_buffer.empty()) m_sink(std::exchange(m_buffer, {}));
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_JSONSTREAM_H
+#define BITCOIN_RPC_JSONSTREAM_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class UniValue;
+
+/**
+ * Writes JSON incrementally, handing the output to a sink in chunks of about
+ * flush_size bytes, so that a large document never needs to be held in memory
+ * in full, neither as UniValue tree nor as string.
+ *
+ * Containers are opened and closed explicitly, and their elements can be
+ * written as UniValue values. Commas and colons are inserted as needed. The
+ * output is identical to that of UniValue::write() without indentation.
+ */
+class JSONStreamWriter
+{
+public:
+    using Sink = std::function<void(std::string&& chunk)>;
+    static constexpr size_t DEFAULT_FLUSH_SIZE{64 << 10};
+
+    /** `prefix` is written before the first token, e.g. to embed the document in a JSON-RPC reply. */
+    explicit JSONStreamWriter(Sink sink, std::string prefix = {}, size_t flush_size = DEFAULT_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    /** Write the key of the next member of the current object. */
+    void Key(std::string_view key);
+    /** Write a value: an array element, an object member after Key(), or the whole document. */
+    void Value(const UniValue& value);
+    void KeyValue(std::string_view key, const UniValue& value);
+    /** Write all members of `object` into the current object. */
+    void Members(const UniValue& object);
+
+    /** Whether anything has been written, i.e. the prefix has been emitted. */
+    bool Started() const { return m_started; }
+    /** Append `suffix` (if started) and hand everything buffered to the sink. */
+    void Finish(std::string_view suffix = {});
+
+private:
+    void BeforeToken();
+    void BeforeValue();
+    void MaybeFlush();
+
+    Sink m_sink;
+    std::string m_prefix;
+    const size_t m_flush_size;
+    std::string m_buffer;
+    //! For each open container, whether no element has been written into it yet.
+    std::vector<bool> m_first;
+    bool m_after_key{false};
+    bool m_started{false};
+};
+
+#endif // BITCOIN_RPC_JSONSTREAM_H
@@ -10,24 +10,29 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/spenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <net_processing.h>
 #include <node/mempool_persist_args.h>
 #include <node/types.h>
-#include <policy/rbf.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
+#include <streams.h>
 #include <txmempool.h>
 #include <univalue.h>
 #include <util/fs.h>
+#include <util/histogram.h>
 #include <util/moneystr.h>
 #include <util/strencodings.h>
 #include <util/time.h>
 #include <util/vector.h>
+#include <validation.h>
 
+#include <array>
+#include <string_view>
 #include <utility>
 
 using node::DumpMempool;
@@ -286,33 +291,28 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+static void entryToJSON(UniValue& info, const MempoolEntrySnapshot& e)
 {
-    AssertLockHeld(pool.cs);
-
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    info.pushKV("vsize", e.vsize);
+    info.pushKV("weight", e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.count_with_descendants);
+    info.pushKV("descendantsize", e.size_with_descendants);
+    info.pushKV("ancestorcount", e.count_with_ancestors);
+    info.pushKV("ancestorsize", e.size_with_ancestors);
+    info.pushKV("wtxid", e.tx->GetWitnessHash().ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.mod_fees_with_ancestors));
+    fees.pushKV("descendant", ValueFromAmount(e.mod_fees_with_descendants));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(txin.prevout.hash))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : e.parents) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -324,63 +324,62 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.children) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
-
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
-    }
-
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+    info.pushKV("bip125-replaceable", e.bip125_replaceable);
+    info.pushKV("unbroadcast", e.unbroadcast);
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
 {
+    if (verbose && include_mempool_sequence) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
+    }
+    // Serialize a shared copy, so the mempool is not locked meanwhile.
+    const auto snapshot{pool.GetSnapshot()};
     if (verbose) {
-        if (include_mempool_sequence) {
-            throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
-        }
-        LOCK(pool.cs);
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        for (const MempoolEntrySnapshot& e : snapshot->entries) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
+            entryToJSON(info, e);
             // Mempool has unique entries so there is no advantage in using
             // UniValue::pushKV, which checks if the key already exists in O(N).
             // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+            o.pushKVEnd(e.tx->GetHash().ToString(), std::move(info));
         }
         return o;
     } else {
         UniValue a(UniValue::VARR);
-        uint64_t mempool_sequence;
-        {
-            LOCK(pool.cs);
-            for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
-            }
-            mempool_sequence = pool.GetSequence();
+        for (const MempoolEntrySnapshot& e : snapshot->entries) {
+            a.push_back(e.tx->GetHash().ToString());
         }
         if (!include_mempool_sequence) {
             return a;
         } else {
             UniValue o(UniValue::VOBJ);
             o.pushKV("txids", std::move(a));
-            o.pushKV("mempool_sequence", mempool_sequence);
+            o.pushKV("mempool_sequence", snapshot->sequence);
             return o;
         }
     }
 }
 
+std::vector<std::byte> MempoolTxidsToBinary(const CTxMemPool& pool)
+{
+    const auto snapshot{pool.GetSnapshot()};
+    std::vector<Txid> txids;
+    txids.reserve(snapshot->entries.size());
+    for (const MempoolEntrySnapshot& e : snapshot->entries) {
+        txids.push_back(e.tx->GetHash());
+    }
+    DataStream ss;
+    ss << txids;
+    return {ss.begin(), ss.end()};
+}
+
 static RPCHelpMan getrawmempool()
 {
     return RPCHelpMan{
@@ -427,7 +426,70 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
-    return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
+    const CTxMemPool& mempool{EnsureAnyMemPool(request.context)};
+    if (!fVerbose && !include_mempool_sequence && request.m_binary_result) {
+        *request.m_binary_result = MempoolTxidsToBinary(mempool);
+        return NullUniValue;
+    }
+    return MempoolToJSON(mempool, fVerbose, include_mempool_sequence);
+},
+    };
+}
+
+UniValue MempoolChangesToJSON(const CTxMemPool& pool, uint64_t since)
+{
+    const MempoolChanges changes{pool.GetChanges(since)};
+    UniValue changes_json(UniValue::VARR);
+    for (const MempoolChange& change : changes.changes) {
+        UniValue change_json(UniValue::VOBJ);
+        change_json.pushKV("sequence", change.sequence);
+        change_json.pushKV("txid", change.txid.ToString());
+        change_json.pushKV("type", change.removal_reason ? "removed" : "added");
+        if (change.removal_reason) change_json.pushKV("reason", RemovalReasonToString(*change.removal_reason));
+        changes_json.push_back(std::move(change_json));
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("mempool_sequence", changes.sequence);
+    result.pushKV("truncated", changes.truncated);
+    result.pushKV("changes", std::move(changes_json));
+    return result;
+}
+
+static RPCHelpMan getmempooldelta()
+{
+    return RPCHelpMan{
+        "getmempooldelta",
+        "Returns the transactions added to and removed from the memory pool since a mempool sequence value,\n"
+        "as returned by getrawmempool with mempool_sequence=true or by a previous call.\n"
+        "Only the last -mempoollogsize changes are kept. If some of the requested changes were dropped,\n"
+        "the result is truncated and the mempool needs to be fetched again with getrawmempool.\n",
+        {
+            {"since", RPCArg::Type::NUM, RPCArg::Optional::NO, "The mempool sequence value to return the changes from."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "mempool_sequence", "The current mempool sequence value, to return the next changes from"},
+                {RPCResult::Type::BOOL, "truncated", "Whether some of the changes since the given sequence are no longer kept, in which case none is returned"},
+                {RPCResult::Type::ARR, "changes", "The changes, in the order they were made",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "sequence", "The mempool sequence value of the change"},
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                        {RPCResult::Type::STR, "type", "\"added\" or \"removed\""},
+                        {RPCResult::Type::STR, "reason", /*optional=*/true, "Why the transaction was removed (e.g. \"block\", \"conflict\", \"replaced\", \"sizelimit\", \"expiry\", \"reorg\")"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getmempooldelta", "1000")
+            + HelpExampleRpc("getmempooldelta", "1000")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CTxMemPool& mempool{EnsureAnyMemPool(request.context)};
+    return MempoolChangesToJSON(mempool, self.Arg<uint64_t>("since"));
 },
     };
 }
@@ -464,32 +526,37 @@ static RPCHelpMan getmempoolancestors()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    auto ancestors{mempool.AssumeCalculateMemPoolAncestors(self.m_name, *entry, CTxMemPool::Limits::NoLimits(), /*fSearchForParents=*/false)};
+        auto ancestors{mempool.AssumeCalculateMemPoolAncestors(self.m_name, *entry, CTxMemPool::Limits::NoLimits(), /*fSearchForParents=*/false)};
 
-    if (!fVerbose) {
-        UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            o.push_back(ancestorIt->GetTx().GetHash().ToString());
+        if (!fVerbose) {
+            UniValue o(UniValue::VARR);
+            for (CTxMemPool::txiter ancestorIt : ancestors) {
+                o.push_back(ancestorIt->GetTx().GetHash().ToString());
+            }
+            return o;
         }
-        return o;
-    } else {
-        UniValue o(UniValue::VOBJ);
+        entries.reserve(ancestors.size());
         for (CTxMemPool::txiter ancestorIt : ancestors) {
-            const CTxMemPoolEntry &e = *ancestorIt;
-            const uint256& _hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(_hash.ToString(), std::move(info));
+            entries.push_back(mempool.GetEntrySnapshot(*ancestorIt));
         }
-        return o;
     }
+
+    UniValue o(UniValue::VOBJ);
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        o.pushKV(e.tx->GetHash().ToString(), std::move(info));
+    }
+    return o;
 },
     };
 }
@@ -526,36 +593,41 @@ static RPCHelpMan getmempooldescendants()
     Txid txid{Txid::FromUint256(ParseHashV(request.params[0], "parameter 1"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto it{mempool.GetIter(txid)};
-    if (!it) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto it{mempool.GetIter(txid)};
+        if (!it) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    CTxMemPool::setEntries setDescendants;
-    mempool.CalculateDescendants(*it, setDescendants);
-    // CTxMemPool::CalculateDescendants will include the given tx
-    setDescendants.erase(*it);
+        CTxMemPool::setEntries setDescendants;
+        mempool.CalculateDescendants(*it, setDescendants);
+        // CTxMemPool::CalculateDescendants will include the given tx
+        setDescendants.erase(*it);
 
-    if (!fVerbose) {
-        UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            o.push_back(descendantIt->GetTx().GetHash().ToString());
-        }
+        if (!fVerbose) {
+            UniValue o(UniValue::VARR);
+            for (CTxMemPool::txiter descendantIt : setDescendants) {
+                o.push_back(descendantIt->GetTx().GetHash().ToString());
+            }
 
-        return o;
-    } else {
-        UniValue o(UniValue::VOBJ);
+            return o;
+        }
+        entries.reserve(setDescendants.size());
         for (CTxMemPool::txiter descendantIt : setDescendants) {
-            const CTxMemPoolEntry &e = *descendantIt;
-            const uint256& _hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(_hash.ToString(), std::move(info));
+            entries.push_back(mempool.GetEntrySnapshot(*descendantIt));
         }
-        return o;
     }
+
+    UniValue o(UniValue::VOBJ);
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        o.pushKV(e.tx->GetHash().ToString(), std::move(info));
+    }
+    return o;
 },
     };
 }
@@ -579,15 +651,17 @@ static RPCHelpMan getmempoolentry()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
-
-    const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+    const auto entry{[&] {
+        LOCK(mempool.cs);
+        const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
+        return mempool.GetEntrySnapshot(*entry);
+    }()};
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(info, entry);
     return info;
 },
     };
@@ -596,7 +670,9 @@ static RPCHelpMan getmempoolentry()
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool to find transactions spending any of the given outputs.\n"
+        "All outputs are looked up while holding the mempool lock once, so a large batch is cheaper than many calls.\n"
+        "With -spenderindex, the confirmed transactions spending the outputs are looked up as well.",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -608,15 +684,23 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"spent_only", RPCArg::Type::BOOL, RPCArg::Default{false}, "Only return the outputs spent by a transaction, leaving out the others"},
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true unless -spenderindex is enabled"}, "Only look for spending transactions in the mempool"},
+                },
+            },
         },
         RPCResult{
-            RPCResult::Type::ARR, "", "",
+            RPCResult::Type::ARR, "", "In the order of the given outputs",
             {
                 {RPCResult::Type::OBJ, "", "",
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the hash of the block containing the spending transaction (omitted if it is in the mempool)"},
+                    {RPCResult::Type::NUM, "height", /*optional=*/true, "the height of the block containing the spending transaction (omitted if it is in the mempool)"},
                 }},
             }
         },
@@ -652,19 +736,49 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
+            const UniValue& spent_only_param{request.params[1]["spent_only"]};
+            const bool spent_only{spent_only_param.isNull() ? false : spent_only_param.get_bool()};
+            const UniValue& mempool_only_param{request.params[1]["mempool_only"]};
+            const bool mempool_only{mempool_only_param.isNull() ? !g_spender_index : mempool_only_param.get_bool()};
+            if (!mempool_only) {
+                if (!g_spender_index) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Looking up confirmed spending transactions requires -spenderindex");
+                }
+                if (!g_spender_index->BlockUntilSyncedToCurrentChain()) {
+                    throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because spenderindex is still syncing. Current height: %d", g_spender_index->GetSummary().best_block_height));
+                }
+            }
+
             const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-            LOCK(mempool.cs);
+            // Only the txids are needed once the lock is released.
+            std::vector<std::optional<Txid>> spending_txids(prevouts.size());
+            {
+                LOCK(mempool.cs);
+                const auto spending_txs{mempool.GetConflictTxs(prevouts)};
+                for (size_t i{0}; i < prevouts.size(); ++i) {
+                    if (spending_txs[i]) spending_txids[i] = spending_txs[i]->GetHash();
+                }
+            }
 
             UniValue result{UniValue::VARR};
 
-            for (const COutPoint& prevout : prevouts) {
+            for (size_t i{0}; i < prevouts.size(); ++i) {
+                // An output spent in the mempool is not spent in the chain.
+                std::optional<TxSpender> spender;
+                if (!spending_txids[i] && !mempool_only) {
+                    spender = g_spender_index->FindSpender(prevouts[i]);
+                    if (spender) spending_txids[i] = spender->tx->GetHash();
+                }
+                if (spent_only && !spending_txids[i]) continue;
                 UniValue o(UniValue::VOBJ);
-                o.pushKV("txid", prevout.hash.ToString());
-                o.pushKV("vout", (uint64_t)prevout.n);
-
-                const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
-                if (spendingTx != nullptr) {
-                    o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                o.pushKV("txid", prevouts[i].hash.ToString());
+                o.pushKV("vout", (uint64_t)prevouts[i].n);
+                if (spending_txids[i]) {
+                    o.pushKV("spendingtxid", spending_txids[i]->ToString());
+                }
+                if (spender) {
+                    o.pushKV("blockhash", spender->block_hash.GetHex());
+                    o.pushKV("height", spender->height);
                 }
 
                 result.push_back(std::move(o));
@@ -683,7 +797,14 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("loaded", pool.GetLoadTried());
     ret.pushKV("size", (int64_t)pool.size());
     ret.pushKV("bytes", (int64_t)pool.GetTotalTxSize());
-    ret.pushKV("usage", (int64_t)pool.DynamicMemoryUsage());
+    const MempoolMemoryUsage usage{pool.GetMemoryUsage()};
+    ret.pushKV("usage", (int64_t)usage.Total());
+    UniValue usage_breakdown(UniValue::VOBJ);
+    usage_breakdown.pushKV("transactions", (int64_t)usage.transactions);
+    usage_breakdown.pushKV("entries", (int64_t)usage.entries);
+    usage_breakdown.pushKV("links", (int64_t)usage.links);
+    usage_breakdown.pushKV("indexes", (int64_t)usage.indexes);
+    ret.pushKV("usage_breakdown", std::move(usage_breakdown));
     ret.pushKV("total_fee", ValueFromAmount(pool.GetTotalFee()));
     ret.pushKV("maxmempool", pool.m_opts.max_size_bytes);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(), pool.m_opts.min_relay_feerate).GetFeePerK()));
@@ -706,6 +827,13 @@ static RPCHelpMan getmempoolinfo()
                 {RPCResult::Type::NUM, "size", "Current tx count"},
                 {RPCResult::Type::NUM, "bytes", "Sum of all virtual transaction sizes as defined in BIP 141. Differs from actual serialized size because witness data is discounted"},
                 {RPCResult::Type::NUM, "usage", "Total memory usage for the mempool"},
+                {RPCResult::Type::OBJ, "usage_breakdown", "How the memory usage is split, adding up to usage",
+                {
+                    {RPCResult::Type::NUM, "transactions", "Memory used by the transactions themselves"},
+                    {RPCResult::Type::NUM, "entries", "Memory used by the mempool entries holding them, including their indexes"},
+                    {RPCResult::Type::NUM, "links", "Memory used by the links between in-mempool parents and children"},
+                    {RPCResult::Type::NUM, "indexes", "Memory used by the indexes of spent outputs, prioritisations and the random order used for transaction relay"},
+                }},
                 {RPCResult::Type::STR_AMOUNT, "total_fee", "Total fees for the mempool in " + CURRENCY_UNIT + ", ignoring modified fees through prioritisetransaction"},
                 {RPCResult::Type::NUM, "maxmempool", "Maximum memory usage for the mempool"},
                 {RPCResult::Type::STR_AMOUNT, "mempoolminfee", "Minimum fee rate in " + CURRENCY_UNIT + "/kvB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee"},
@@ -824,6 +952,79 @@ static RPCHelpMan savemempool()
     };
 }
 
+//! Names of the MempoolAcceptStage values in getmempoolacceptstats.
+static constexpr std::array<std::string_view, MEMPOOL_ACCEPT_STAGE_COUNT> MEMPOOL_ACCEPT_STAGE_NAMES{
+    "prechecks", "coins", "replacement", "policy_scripts", "consensus_scripts", "submit", "limit_mempool", "total"};
+
+static RPCHelpMan getmempoolacceptstats()
+{
+    return RPCHelpMan{
+        "getmempoolacceptstats",
+        strprintf("Return latency histograms of the stages of mempool acceptance, by result.\n"
+                  "Results are \"accepted\" and \"rejected:<reason>\" for single transactions, including testmempoolaccept and transactions re-added after a reorg, "
+                  "and \"package\" and \"package-rejected:<reason>\" for packages.\n"
+                  "Histogram bucket 0 counts durations below 1 microsecond, bucket i those from 2^(i-1) up to 2^i microseconds, and the last of the %d buckets the rest.\n"
+                  "The timings are not persisted across restarts.\n",
+                  LatencyHistogram::BUCKETS),
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ_DYN, "", "",
+            {
+                {RPCResult::Type::OBJ, "result", "the result of the acceptance", {
+                    {RPCResult::Type::NUM, "count", "number of acceptances with this result"},
+                    {RPCResult::Type::OBJ_DYN, "stages", "the stages that ran at least once: prechecks (including coins), coins (input lookups), replacement (RBF and package limits), "
+                                                          "policy_scripts, consensus_scripts, submit (adding to the mempool), limit_mempool and total", {
+                        {RPCResult::Type::OBJ, "stage", "", {
+                            {RPCResult::Type::NUM, "count", "number of acceptances that ran the stage"},
+                            {RPCResult::Type::NUM, "total", "milliseconds spent in the stage in total"},
+                            {RPCResult::Type::NUM, "max", "the longest time spent in the stage, in milliseconds"},
+                            {RPCResult::Type::NUM, "p50", "upper bound of the median, in milliseconds"},
+                            {RPCResult::Type::NUM, "p90", "upper bound of the 90th percentile, in milliseconds"},
+                            {RPCResult::Type::NUM, "p99", "upper bound of the 99th percentile, in milliseconds"},
+                            {RPCResult::Type::ARR, "histogram", "number of acceptances per bucket", {
+                                {RPCResult::Type::NUM, "", ""},
+                            }},
+                        }},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getmempoolacceptstats", "")
+            + HelpExampleRpc("getmempoolacceptstats", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const auto all_stats{WITH_LOCK(::cs_main, return chainman.GetMempoolAcceptStats())};
+
+    UniValue ret(UniValue::VOBJ);
+    for (const auto& [result, stats] : all_stats) {
+        UniValue stages(UniValue::VOBJ);
+        for (size_t i{0}; i < MEMPOOL_ACCEPT_STAGE_COUNT; ++i) {
+            const LatencyHistogram& histogram{stats.stages[i]};
+            if (histogram.Count() == 0) continue;
+            UniValue stage(UniValue::VOBJ);
+            stage.pushKV("count", histogram.Count());
+            stage.pushKV("total", Ticks<MillisecondsDouble>(histogram.Total()));
+            stage.pushKV("max", Ticks<MillisecondsDouble>(histogram.Max()));
+            stage.pushKV("p50", Ticks<MillisecondsDouble>(histogram.Quantile(0.5)));
+            stage.pushKV("p90", Ticks<MillisecondsDouble>(histogram.Quantile(0.9)));
+            stage.pushKV("p99", Ticks<MillisecondsDouble>(histogram.Quantile(0.99)));
+            UniValue buckets(UniValue::VARR);
+            for (const uint64_t count : histogram.Buckets()) buckets.push_back(count);
+            stage.pushKV("histogram", std::move(buckets));
+            stages.pushKV(std::string{MEMPOOL_ACCEPT_STAGE_NAMES[i]}, std::move(stage));
+        }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("count", stats.stages[size_t(MempoolAcceptStage::TOTAL)].Count());
+        entry.pushKV("stages", std::move(stages));
+        ret.pushKV(result, std::move(entry));
+    }
+    return ret;
+},
+    };
+}
+
 static std::vector<RPCResult> OrphanDescription()
 {
     return {
@@ -1137,10 +1338,12 @@ void RegisterMempoolRPCCommands(CRPCTable& t)
         {"rawtransactions", &sendrawtransaction},
         {"rawtransactions", &testmempoolaccept},
         {"blockchain", &getmempoolancestors},
+        {"blockchain", &getmempooldelta},
         {"blockchain", &getmempooldescendants},
         {"blockchain", &getmempoolentry},
         {"blockchain", &gettxspendingprevout},
         {"blockchain", &getmempoolinfo},
+        {"blockchain", &getmempoolacceptstats},
         {"blockchain", &getrawmempool},
         {"blockchain", &importmempool},
         {"blockchain", &savemempool},
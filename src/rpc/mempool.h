@@ -5,6 +5,10 @@
 #ifndef BITCOIN_RPC_MEMPOOL_H
 #define BITCOIN_RPC_MEMPOOL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 class CTxMemPool;
 class UniValue;
 
@@ -14,4 +18,10 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
+/** Changes of the mempool since a mempool sequence to JSON, see CTxMemPool::GetChanges() */
+UniValue MempoolChangesToJSON(const CTxMemPool& pool, uint64_t since);
+
+/** Ids of the mempool transactions, serialized as a vector of 32-byte hashes */
+std::vector<std::byte> MempoolTxidsToBinary(const CTxMemPool& pool);
+
 #endif // BITCOIN_RPC_MEMPOOL_H
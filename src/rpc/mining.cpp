@@ -45,6 +45,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 using interfaces::BlockRef;
 using interfaces::BlockTemplate;
@@ -164,12 +165,29 @@ static bool GenerateBlock(ChainstateManager& chainman, CBlock&& block, uint64_t&
 static UniValue generateBlocks(ChainstateManager& chainman, Mining& miner, const CScript& coinbase_output_script, int nGenerate, uint64_t nMaxTries)
 {
     UniValue blockHashes(UniValue::VARR);
+    // -regtest only: build all blocks with one assembler instead of a new
+    // template from the mining interface each time, and skip testing the
+    // validity of these templates, as ProcessNewBlock() checks them anyway.
+    std::optional<BlockAssembler> assembler;
+    if (const NodeContext* node{miner.context()}; node && chainman.GetParams().MineBlocksOnDemand()) {
+        BlockAssembler::Options options;
+        options.coinbase_output_script = coinbase_output_script;
+        options.test_block_validity = false;
+        ApplyArgsManOptions(*CHECK_NONFATAL(node->args), options);
+        assembler.emplace(chainman.ActiveChainstate(), node->mempool.get(), options);
+    }
     while (nGenerate > 0 && !chainman.m_interrupt) {
-        std::unique_ptr<BlockTemplate> block_template(miner.createNewBlock({ .coinbase_output_script = coinbase_output_script }));
-        CHECK_NONFATAL(block_template);
+        CBlock block;
+        if (assembler) {
+            block = std::move(assembler->CreateNewBlock()->block);
+        } else {
+            std::unique_ptr<BlockTemplate> block_template(miner.createNewBlock({ .coinbase_output_script = coinbase_output_script }));
+            CHECK_NONFATAL(block_template);
+            block = block_template->getBlock();
+        }
 
         std::shared_ptr<const CBlock> block_out;
-        if (!GenerateBlock(chainman, block_template->getBlock(), nMaxTries, block_out, /*process_new_block=*/true)) {
+        if (!GenerateBlock(chainman, std::move(block), nMaxTries, block_out, /*process_new_block=*/true)) {
             break;
         }
 
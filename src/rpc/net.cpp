@@ -148,6 +148,7 @@ static RPCHelpMan getpeerinfo()
                     {RPCResult::Type::NUM_TIME, "last_block", "The " + UNIX_EPOCH_TIME + " of the last block received from this peer"},
                     {RPCResult::Type::NUM, "bytessent", "The total bytes sent"},
                     {RPCResult::Type::NUM, "bytesrecv", "The total bytes received"},
+                    {RPCResult::Type::NUM, "sendqueuebytes", "Memory used by messages queued for sending to this peer, in bytes. A payload shared with other peers is counted in full"},
                     {RPCResult::Type::NUM_TIME, "conntime", "The " + UNIX_EPOCH_TIME + " of the connection"},
                     {RPCResult::Type::NUM, "timeoffset", "The time offset in seconds"},
                     {RPCResult::Type::NUM, "pingtime", /*optional=*/true, "The last ping time in milliseconds (ms), if any"},
@@ -166,6 +167,13 @@ static RPCHelpMan getpeerinfo()
                     {
                         {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                     }},
+                    {RPCResult::Type::OBJ, "block_download", "Statistics of the blocks we requested from this peer",
+                    {
+                        {RPCResult::Type::NUM, "inflight_limit", "How many blocks may be in flight from this peer at once, adapted to how fast it delivers them"},
+                        {RPCResult::Type::NUM, "blocks_received", "The number of requested blocks received from this peer"},
+                        {RPCResult::Type::NUM, "avg_interval", "Moving average in seconds of the time the peer took per block while blocks were in flight, or 0"},
+                        {RPCResult::Type::NUM, "avg_latency", "Moving average in seconds of the time from requesting a block to receiving it, or 0"},
+                    }},
                     {RPCResult::Type::BOOL, "addr_relay_enabled", "Whether we participate in address relay with this peer"},
                     {RPCResult::Type::NUM, "addr_processed", "The total number of addresses processed, excluding those dropped due to rate limiting"},
                     {RPCResult::Type::NUM, "addr_rate_limited", "The total number of addresses dropped due to rate limiting"},
@@ -244,6 +252,7 @@ static RPCHelpMan getpeerinfo()
         obj.pushKV("last_block", count_seconds(stats.m_last_block_time));
         obj.pushKV("bytessent", stats.nSendBytes);
         obj.pushKV("bytesrecv", stats.nRecvBytes);
+        obj.pushKV("sendqueuebytes", stats.m_send_memusage);
         obj.pushKV("conntime", count_seconds(stats.m_connected));
         obj.pushKV("timeoffset", Ticks<std::chrono::seconds>(statestats.time_offset));
         if (stats.m_last_ping_time > 0us) {
@@ -272,6 +281,12 @@ static RPCHelpMan getpeerinfo()
             heights.push_back(height);
         }
         obj.pushKV("inflight", std::move(heights));
+        UniValue block_download(UniValue::VOBJ);
+        block_download.pushKV("inflight_limit", statestats.m_blocks_in_flight_limit);
+        block_download.pushKV("blocks_received", statestats.m_blocks_received);
+        block_download.pushKV("avg_interval", Ticks<SecondsDouble>(statestats.m_block_interval_avg));
+        block_download.pushKV("avg_latency", Ticks<SecondsDouble>(statestats.m_block_latency_avg));
+        obj.pushKV("block_download", std::move(block_download));
         obj.pushKV("addr_relay_enabled", statestats.m_addr_relay_enabled);
         obj.pushKV("addr_processed", statestats.m_addr_processed);
         obj.pushKV("addr_rate_limited", statestats.m_addr_rate_limited);
@@ -566,6 +581,7 @@ static RPCHelpMan getnettotals()
                    {
                        {RPCResult::Type::NUM, "totalbytesrecv", "Total bytes received"},
                        {RPCResult::Type::NUM, "totalbytessent", "Total bytes sent"},
+                       {RPCResult::Type::NUM, "totalsendqueuebytes", "Memory used by the send queues of all peers together, in bytes"},
                        {RPCResult::Type::NUM_TIME, "timemillis", "Current system " + UNIX_EPOCH_TIME + " in milliseconds"},
                        {RPCResult::Type::OBJ, "uploadtarget", "",
                        {
@@ -576,6 +592,19 @@ static RPCHelpMan getnettotals()
                            {RPCResult::Type::NUM, "bytes_left_in_cycle", "Bytes left in current time cycle"},
                            {RPCResult::Type::NUM, "time_left_in_cycle", "Seconds left in current time cycle"},
                         }},
+                       {RPCResult::Type::OBJ, "uploadrate", "",
+                       {
+                           {RPCResult::Type::NUM, "limit", "Limit in bytes per second (0 if unlimited)"},
+                           {RPCResult::Type::OBJ_DYN, "classes", "Traffic classes sharing the limit",
+                           {
+                               {RPCResult::Type::OBJ, "class", "",
+                               {
+                                   {RPCResult::Type::NUM, "weight", "Relative share of the limit"},
+                                   {RPCResult::Type::NUM, "bytessent", "Bytes sent while limited"},
+                                   {RPCResult::Type::NUM, "throttled", "Number of times sending waited for the limit"},
+                               }},
+                           }},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -590,6 +619,7 @@ static RPCHelpMan getnettotals()
     UniValue obj(UniValue::VOBJ);
     obj.pushKV("totalbytesrecv", connman.GetTotalBytesRecv());
     obj.pushKV("totalbytessent", connman.GetTotalBytesSent());
+    obj.pushKV("totalsendqueuebytes", connman.GetTotalSendMemoryUsage());
     obj.pushKV("timemillis", TicksSinceEpoch<std::chrono::milliseconds>(SystemClock::now()));
 
     UniValue outboundLimit(UniValue::VOBJ);
@@ -600,6 +630,91 @@ static RPCHelpMan getnettotals()
     outboundLimit.pushKV("bytes_left_in_cycle", connman.GetOutboundTargetBytesLeft());
     outboundLimit.pushKV("time_left_in_cycle", count_seconds(connman.GetMaxOutboundTimeLeftInCycle()));
     obj.pushKV("uploadtarget", std::move(outboundLimit));
+
+    const UploadRateLimiter& limiter{connman.GetUploadRateLimiter()};
+    UniValue upload_rate(UniValue::VOBJ);
+    upload_rate.pushKV("limit", limiter.GetRate());
+    UniValue classes(UniValue::VOBJ);
+    const auto class_stats{limiter.GetStats()};
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("weight", class_stats[i].weight);
+        entry.pushKV("bytessent", class_stats[i].bytes_sent);
+        entry.pushKV("throttled", class_stats[i].throttled);
+        classes.pushKV(TrafficClassAsString(TrafficClass(i)), std::move(entry));
+    }
+    upload_rate.pushKV("classes", std::move(classes));
+    obj.pushKV("uploadrate", std::move(upload_rate));
+    return obj;
+},
+    };
+}
+
+static std::vector<RPCResult> MessageProcessingStatsDescription()
+{
+    return {
+        {RPCResult::Type::NUM, "count", "number of messages processed"},
+        {RPCResult::Type::NUM, "total", "milliseconds spent processing them in total"},
+        {RPCResult::Type::NUM, "max", "the longest time spent on one message, in milliseconds"},
+        {RPCResult::Type::NUM, "p50", "upper bound of the median, in milliseconds"},
+        {RPCResult::Type::NUM, "p90", "upper bound of the 90th percentile, in milliseconds"},
+        {RPCResult::Type::NUM, "p99", "upper bound of the 99th percentile, in milliseconds"},
+        {RPCResult::Type::NUM, "cs_main_wait", "milliseconds of the total spent waiting for the cs_main lock"},
+    };
+}
+
+static UniValue MessageProcessingStatsToJSON(const MessageProcessingStats& stats)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("count", stats.time.Count());
+    obj.pushKV("total", Ticks<MillisecondsDouble>(stats.time.Total()));
+    obj.pushKV("max", Ticks<MillisecondsDouble>(stats.time.Max()));
+    obj.pushKV("p50", Ticks<MillisecondsDouble>(stats.time.Quantile(0.5)));
+    obj.pushKV("p90", Ticks<MillisecondsDouble>(stats.time.Quantile(0.9)));
+    obj.pushKV("p99", Ticks<MillisecondsDouble>(stats.time.Quantile(0.99)));
+    obj.pushKV("cs_main_wait", Ticks<MillisecondsDouble>(stats.cs_main_wait));
+    return obj;
+}
+
+static RPCHelpMan getmsgprocstats()
+{
+    return RPCHelpMan{"getmsgprocstats",
+                "Returns the time spent processing received P2P messages, by message type and by connected peer.\n"
+                "Only recorded with -msgprocstats. The timings are not persisted across restarts.\n",
+                {},
+                RPCResult{
+                   RPCResult::Type::OBJ, "", "",
+                   {
+                       {RPCResult::Type::BOOL, "enabled", "whether message processing is timed (-msgprocstats)"},
+                       {RPCResult::Type::OBJ_DYN, "msgtypes", "the message types received at least once, with unknown ones as \"" + NET_MESSAGE_TYPE_OTHER + "\"", {
+                           {RPCResult::Type::OBJ, "msgtype", "", MessageProcessingStatsDescription()},
+                       }},
+                       {RPCResult::Type::OBJ_DYN, "peers", "the connected peers that sent at least one message, by peer id", {
+                           {RPCResult::Type::OBJ, "id", "", MessageProcessingStatsDescription()},
+                       }},
+                   }},
+                RPCExamples{
+                    HelpExampleCli("getmsgprocstats", "")
+            + HelpExampleRpc("getmsgprocstats", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    const PeerManager& peerman = EnsurePeerman(node);
+
+    UniValue msgtypes(UniValue::VOBJ);
+    for (const auto& [msg_type, stats] : peerman.GetMessageTypeProcessingStats()) {
+        msgtypes.pushKV(msg_type, MessageProcessingStatsToJSON(stats));
+    }
+    UniValue peers(UniValue::VOBJ);
+    for (const auto& [id, stats] : peerman.GetPeerProcessingStats()) {
+        peers.pushKV(util::ToString(id), MessageProcessingStatsToJSON(stats));
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("enabled", peerman.HasMessageProcessingStats());
+    obj.pushKV("msgtypes", std::move(msgtypes));
+    obj.pushKV("peers", std::move(peers));
     return obj;
 },
     };
@@ -646,6 +761,12 @@ static RPCHelpMan getnetworkinfo()
                         {RPCResult::Type::NUM, "connections_in", "the number of inbound connections"},
                         {RPCResult::Type::NUM, "connections_out", "the number of outbound connections"},
                         {RPCResult::Type::BOOL, "networkactive", "whether p2p networking is enabled"},
+                        {RPCResult::Type::OBJ, "v2_key_pool", "the pool of keys kept ready for new v2 connections",
+                        {
+                            {RPCResult::Type::NUM, "size", "the number of keys in the pool"},
+                            {RPCResult::Type::NUM, "target_size", "the number of keys the pool is filled up to, if v2 connections are supported"},
+                            {RPCResult::Type::NUM, "misses", "the number of keys which had to be generated for a new connection, the pool being empty"},
+                        }},
                         {RPCResult::Type::ARR, "networks", "information per network",
                         {
                             {RPCResult::Type::OBJ, "", "",
@@ -705,6 +826,12 @@ static RPCHelpMan getnetworkinfo()
         obj.pushKV("connections", node.connman->GetNodeCount(ConnectionDirection::Both));
         obj.pushKV("connections_in", node.connman->GetNodeCount(ConnectionDirection::In));
         obj.pushKV("connections_out", node.connman->GetNodeCount(ConnectionDirection::Out));
+        const EllSwiftKeyPool& v2_key_pool{node.connman->GetV2KeyPool()};
+        UniValue v2_key_pool_info(UniValue::VOBJ);
+        v2_key_pool_info.pushKV("size", v2_key_pool.Size());
+        v2_key_pool_info.pushKV("target_size", v2_key_pool.TargetSize());
+        v2_key_pool_info.pushKV("misses", v2_key_pool.Misses());
+        obj.pushKV("v2_key_pool", std::move(v2_key_pool_info));
     }
     obj.pushKV("networks",      GetNetworksInfo());
     if (node.mempool) {
@@ -1202,6 +1329,7 @@ void RegisterNetRPCCommands(CRPCTable& t)
         {"network", &disconnectnode},
         {"network", &getaddednodeinfo},
         {"network", &getnettotals},
+        {"network", &getmsgprocstats},
         {"network", &getnetworkinfo},
         {"network", &setban},
         {"network", &listbanned},
@@ -5,28 +5,51 @@
 
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 
+#include <addrman.h>
 #include <chainparams.h>
+#include <dbwrapper.h>
 #include <httpserver.h>
+#include <index/base.h>
+#include <index/blockcache.h>
 #include <index/blockfilterindex.h>
+#include <index/blockstatsindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
+#include <index/spenderindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
 #include <interfaces/init.h>
 #include <interfaces/ipc.h>
+#include <interfaces/wallet.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <logging/timer.h>
+#include <net.h>
+#include <net_processing.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <scheduler.h>
+#include <sync.h>
+#include <txdb.h>
+#include <txmempool.h>
 #include <univalue.h>
 #include <util/any.h>
 #include <util/check.h>
+#include <util/metrics.h>
+#include <util/string.h>
 #include <util/time.h>
+#include <util/vector.h>
+#include <validation.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <map>
+#include <set>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
 #endif
@@ -120,6 +143,59 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+//! Estimates of the memory used by the subsystems of the node, in bytes.
+static UniValue RPCMemoryUsage(const node::NodeContext& node)
+{
+    UniValue obj(UniValue::VOBJ);
+    size_t total{0};
+    const auto push{[&](const std::string& key, size_t usage) {
+        obj.pushKV(key, uint64_t(usage));
+        total += usage;
+    }};
+    if (node.chainman) {
+        LOCK(::cs_main);
+        size_t coins_cache{0}, coins_db{0};
+        for (Chainstate* chainstate : node.chainman->GetAll()) {
+            if (!chainstate->CanFlushToDisk()) continue;
+            coins_cache += chainstate->CoinsTip().DynamicMemoryUsage();
+            coins_db += chainstate->CoinsDB().GetDBMemoryUsage();
+        }
+        push("coins_cache", coins_cache);
+        push("coins_db", coins_db);
+        push("block_index", node.chainman->m_blockman.DynamicMemoryUsage());
+        push("block_tree_db", node.chainman->m_blockman.m_block_tree_db->DynamicMemoryUsage());
+        push("signature_cache", node.chainman->m_validation_cache.m_signature_cache.DynamicMemoryUsage());
+        push("script_cache", node.chainman->m_validation_cache.m_script_execution_cache.DynamicMemoryUsage());
+    }
+    if (node.mempool) push("mempool", node.mempool->DynamicMemoryUsage());
+    if (node.peerman) push("orphanage", node.peerman->GetOrphanageMemoryUsage());
+    if (node.addrman) push("addrman", node.addrman->DynamicMemoryUsage());
+    if (node.connman) {
+        const auto peers{node.connman->GetPeerMemoryUsage()};
+        push("peer_send_buffers", peers.send);
+        push("peer_receive_buffers", peers.receive);
+    }
+    size_t indexes{0};
+    std::set<const IndexBlockCache*> block_caches;
+    for (const BaseIndex* index : node.indexes) {
+        indexes += index->GetDBMemoryUsage();
+        // The cache of blocks read during the initial sync is shared by all indexes.
+        if (const auto* cache{index->GetBlockCache()}; cache && block_caches.insert(cache).second) {
+            indexes += cache->Bytes();
+        }
+    }
+    push("indexes", indexes);
+    size_t wallets{0};
+    if (node.wallet_loader) {
+        for (const auto& wallet : node.wallet_loader->getWallets()) {
+            wallets += wallet->getMemoryUsage();
+        }
+    }
+    push("wallets", wallets);
+    obj.pushKV("total", uint64_t(total));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -164,6 +240,23 @@ static RPCHelpMan getmemoryinfo()
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "usage", "Estimates of the bytes of memory used by the subsystems of the node. Allocator overhead is approximated and memory not tracked by any subsystem is not included",
+                            {
+                                {RPCResult::Type::NUM, "coins_cache", /*optional=*/true, "In-memory cache of the UTXO set (-dbcache)"},
+                                {RPCResult::Type::NUM, "coins_db", /*optional=*/true, "Caches and buffers of the UTXO set database"},
+                                {RPCResult::Type::NUM, "block_index", /*optional=*/true, "Headers and metadata of all known blocks"},
+                                {RPCResult::Type::NUM, "block_tree_db", /*optional=*/true, "Caches and buffers of the block index database"},
+                                {RPCResult::Type::NUM, "signature_cache", /*optional=*/true, "Cache of verified signatures"},
+                                {RPCResult::Type::NUM, "script_cache", /*optional=*/true, "Cache of verified transaction scripts"},
+                                {RPCResult::Type::NUM, "mempool", /*optional=*/true, "Memory pool, as in getmempoolinfo usage"},
+                                {RPCResult::Type::NUM, "orphanage", /*optional=*/true, "Orphan transactions"},
+                                {RPCResult::Type::NUM, "addrman", /*optional=*/true, "Addresses of known peers"},
+                                {RPCResult::Type::NUM, "peer_send_buffers", /*optional=*/true, "Messages queued to be sent to peers"},
+                                {RPCResult::Type::NUM, "peer_receive_buffers", /*optional=*/true, "Messages received from peers but not processed yet"},
+                                {RPCResult::Type::NUM, "indexes", "Databases of the optional indexes and the blocks cached for their initial sync"},
+                                {RPCResult::Type::NUM, "wallets", "Transactions, outputs and address books of the loaded wallets"},
+                                {RPCResult::Type::NUM, "total", "Sum of the above"},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -180,6 +273,7 @@ static RPCHelpMan getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("usage", RPCMemoryUsage(EnsureAnyNodeContext(request.context)));
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -194,6 +288,179 @@ static RPCHelpMan getmemoryinfo()
     };
 }
 
+static RPCHelpMan getlockstats()
+{
+    const std::vector<RPCResult> histograms{
+        {RPCResult::Type::ARR, "wait_histogram", "number of acquisitions by time waited, in the buckets of bucket_limits_us", {{RPCResult::Type::NUM, "", ""}}},
+        {RPCResult::Type::ARR, "hold_histogram", "number of releases by time held, in the buckets of bucket_limits_us", {{RPCResult::Type::NUM, "", ""}}},
+    };
+    const std::vector<RPCResult> totals{
+        {RPCResult::Type::NUM, "acquisitions", "number of times the lock was taken"},
+        {RPCResult::Type::NUM, "contended", "number of times the lock was held by another thread when taking it"},
+        {RPCResult::Type::NUM, "wait_us", "total time spent waiting to take the lock, in microseconds"},
+        {RPCResult::Type::NUM, "hold_us", "total time the lock was held, in microseconds. Includes the time spent waiting on condition variables with the lock"},
+        {RPCResult::Type::NUM, "max_wait_us", "longest time spent waiting to take the lock, in microseconds"},
+        {RPCResult::Type::NUM, "max_hold_us", "longest time the lock was held, in microseconds"},
+    };
+    return RPCHelpMan{
+        "getlockstats",
+        "Returns the time spent waiting for and holding each lock, by lock and by acquisition site.\n"
+        "Statistics are only collected while the node runs with -lockstats.\n",
+        {
+            {"reset", RPCArg::Type::BOOL, RPCArg::Default{false}, "Reset the statistics after returning them."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::BOOL, "enabled", "whether statistics are being collected (-lockstats)"},
+                {RPCResult::Type::ARR, "bucket_limits_us", "exclusive upper limits of the histogram buckets in microseconds, the last bucket being unbounded", {{RPCResult::Type::NUM, "", ""}}},
+                {RPCResult::Type::OBJ_DYN, "locks", "statistics of all the sites taking a lock, by lock name", {
+                    {RPCResult::Type::OBJ, "name", "", Cat(std::vector<RPCResult>{totals}, histograms)},
+                }},
+                {RPCResult::Type::ARR, "sites", "statistics by acquisition site, by decreasing hold time", {
+                    {RPCResult::Type::OBJ, "", "", Cat(std::vector<RPCResult>{
+                        {RPCResult::Type::STR, "lock", "the lock, as named at the site"},
+                        {RPCResult::Type::STR, "file", "the source file"},
+                        {RPCResult::Type::NUM, "line", "the line in the source file"},
+                    }, Cat(std::vector<RPCResult>{totals}, histograms))},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getlockstats", "")
+          + HelpExampleCli("getlockstats", "true")
+          + HelpExampleRpc("getlockstats", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    struct Totals {
+        uint64_t acquisitions{0}, contended{0}, wait_ns{0}, hold_ns{0}, max_wait_ns{0}, max_hold_ns{0};
+        std::array<uint64_t, LockSiteStats::HISTOGRAM_BUCKETS> wait_histogram{}, hold_histogram{};
+    };
+    const auto to_json{[](const Totals& totals, UniValue& obj) {
+        obj.pushKV("acquisitions", totals.acquisitions);
+        obj.pushKV("contended", totals.contended);
+        obj.pushKV("wait_us", totals.wait_ns / 1000);
+        obj.pushKV("hold_us", totals.hold_ns / 1000);
+        obj.pushKV("max_wait_us", totals.max_wait_ns / 1000);
+        obj.pushKV("max_hold_us", totals.max_hold_ns / 1000);
+        UniValue wait_histogram(UniValue::VARR), hold_histogram(UniValue::VARR);
+        for (const auto count : totals.wait_histogram) wait_histogram.push_back(count);
+        for (const auto count : totals.hold_histogram) hold_histogram.push_back(count);
+        obj.pushKV("wait_histogram", std::move(wait_histogram));
+        obj.pushKV("hold_histogram", std::move(hold_histogram));
+    }};
+
+    std::vector<std::pair<const LockSiteStats*, Totals>> sites;
+    std::map<std::string, Totals> locks;
+    for (const LockSiteStats* stats : GetAllLockSiteStats()) {
+        Totals site;
+        site.acquisitions = stats->acquisitions.load();
+        if (site.acquisitions == 0) continue;
+        site.contended = stats->contended.load();
+        site.wait_ns = stats->wait_ns.load();
+        site.hold_ns = stats->hold_ns.load();
+        site.max_wait_ns = stats->max_wait_ns.load();
+        site.max_hold_ns = stats->max_hold_ns.load();
+        for (size_t i{0}; i < LockSiteStats::HISTOGRAM_BUCKETS; ++i) {
+            site.wait_histogram[i] = stats->wait_histogram[i].load();
+            site.hold_histogram[i] = stats->hold_histogram[i].load();
+        }
+        // Sites name the same global lock with or without its scope.
+        Totals& lock{locks[std::string{util::RemovePrefixView(stats->name, "::")}]};
+        lock.acquisitions += site.acquisitions;
+        lock.contended += site.contended;
+        lock.wait_ns += site.wait_ns;
+        lock.hold_ns += site.hold_ns;
+        lock.max_wait_ns = std::max(lock.max_wait_ns, site.max_wait_ns);
+        lock.max_hold_ns = std::max(lock.max_hold_ns, site.max_hold_ns);
+        for (size_t i{0}; i < LockSiteStats::HISTOGRAM_BUCKETS; ++i) {
+            lock.wait_histogram[i] += site.wait_histogram[i];
+            lock.hold_histogram[i] += site.hold_histogram[i];
+        }
+        sites.emplace_back(stats, site);
+    }
+    if (!request.params[0].isNull() && request.params[0].get_bool()) ResetLockSiteStats();
+    std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) { return a.second.hold_ns > b.second.hold_ns; });
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("enabled", g_lock_stats_enabled.load());
+    UniValue bucket_limits(UniValue::VARR);
+    for (size_t i{0}; i + 1 < LockSiteStats::HISTOGRAM_BUCKETS; ++i) bucket_limits.push_back(uint64_t{1} << i);
+    ret.pushKV("bucket_limits_us", std::move(bucket_limits));
+    UniValue locks_json(UniValue::VOBJ);
+    for (const auto& [name, totals] : locks) {
+        UniValue obj(UniValue::VOBJ);
+        to_json(totals, obj);
+        locks_json.pushKV(name, std::move(obj));
+    }
+    ret.pushKV("locks", std::move(locks_json));
+    UniValue sites_json(UniValue::VARR);
+    for (const auto& [stats, totals] : sites) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("lock", stats->name);
+        obj.pushKV("file", std::string{util::RemovePrefixView(stats->file, "./")});
+        obj.pushKV("line", stats->line);
+        to_json(totals, obj);
+        sites_json.push_back(std::move(obj));
+    }
+    ret.pushKV("sites", std::move(sites_json));
+    return ret;
+},
+    };
+}
+
+static RPCHelpMan getscopetimers()
+{
+    return RPCHelpMan{
+        "getscopetimers",
+        "Returns the time spent in the timed scopes of the code, by scope path.\n"
+        "Scopes entered while another timed scope is running on the same thread are named by the path of the enclosing scopes, e.g. \"ActivateBestChain/ConnectTip\".\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::ARR, "bucket_limits_us", "inclusive upper limits of the histogram buckets in microseconds, the last bucket being unbounded", {{RPCResult::Type::NUM, "", ""}}},
+                {RPCResult::Type::OBJ_DYN, "scopes", "statistics by scope path", {
+                    {RPCResult::Type::OBJ, "path", "", {
+                        {RPCResult::Type::NUM, "count", "number of times the scope was run"},
+                        {RPCResult::Type::NUM, "total_us", "total time spent in the scope, in microseconds"},
+                        {RPCResult::Type::ARR, "histogram", "number of runs by time spent, in the buckets of bucket_limits_us", {{RPCResult::Type::NUM, "", ""}}},
+                    }},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getscopetimers", "")
+          + HelpExampleRpc("getscopetimers", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue ret(UniValue::VOBJ);
+    UniValue bucket_limits(UniValue::VARR);
+    for (const double limit : metrics::DURATION_BUCKETS) bucket_limits.push_back(int64_t(limit * 1e6));
+    ret.pushKV("bucket_limits_us", std::move(bucket_limits));
+    UniValue scopes(UniValue::VOBJ);
+    for (const auto& [path, histogram] : BCLog::GetScopeTimers()) {
+        const auto counts{histogram->BucketCounts()};
+        UniValue obj(UniValue::VOBJ);
+        UniValue histogram_json(UniValue::VARR);
+        uint64_t count{0};
+        for (const auto n : counts) {
+            histogram_json.push_back(n);
+            count += n;
+        }
+        obj.pushKV("count", count);
+        obj.pushKV("total_us", int64_t(histogram->Sum() * 1e6));
+        obj.pushKV("histogram", std::move(histogram_json));
+        scopes.pushKV(path, std::move(obj));
+    }
+    ret.pushKV("scopes", std::move(scopes));
+    return ret;
+},
+    };
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -395,6 +662,18 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_block_stats_index) {
+        result.pushKVs(SummaryToJSON(g_block_stats_index->GetSummary(), index_name));
+    }
+
+    if (g_scripthash_index) {
+        result.pushKVs(SummaryToJSON(g_scripthash_index->GetSummary(), index_name));
+    }
+
+    if (g_spender_index) {
+        result.pushKVs(SummaryToJSON(g_spender_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
@@ -404,10 +683,114 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static UniValue DBStatsToJSON(const DBStats& stats)
+{
+    UniValue levels(UniValue::VARR);
+    for (const DBLevelStats& level : stats.levels) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("level", level.level);
+        entry.pushKV("files", level.files);
+        entry.pushKV("size_mib", level.size_mib);
+        entry.pushKV("compaction_time", level.compaction_seconds);
+        entry.pushKV("compaction_read_mib", level.compaction_read_mib);
+        entry.pushKV("compaction_written_mib", level.compaction_written_mib);
+        levels.push_back(std::move(entry));
+    }
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("memory_usage", stats.memory_usage);
+    ret.pushKV("write_time", Ticks<SecondsDouble>(stats.write_time));
+    ret.pushKV("levels", std::move(levels));
+    return ret;
+}
+
+static RPCHelpMan getdbinfo()
+{
+    const std::vector<RPCResult> db_stats{
+        {RPCResult::Type::NUM, "memory_usage", "approximate memory used by the block cache and write buffers in bytes"},
+        {RPCResult::Type::NUM, "write_time", "seconds spent writing since startup, including waiting for compactions to make room"},
+        {RPCResult::Type::ARR, "levels", "levels that hold files or were compacted", {
+            {RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::NUM, "level", "the level"},
+                {RPCResult::Type::NUM, "files", "number of table files"},
+                {RPCResult::Type::NUM, "size_mib", "size of the table files in MiB"},
+                {RPCResult::Type::NUM, "compaction_time", "seconds spent compacting into this level"},
+                {RPCResult::Type::NUM, "compaction_read_mib", "MiB read by those compactions"},
+                {RPCResult::Type::NUM, "compaction_written_mib", "MiB written by those compactions"},
+            }},
+        }},
+    };
+    return RPCHelpMan{
+        "getdbinfo",
+        "Returns LevelDB compaction and write statistics of the databases of the node.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::OBJ, "chainstate", "the coins database of the active chainstate", Cat(std::vector<RPCResult>{db_stats}, {
+                    {RPCResult::Type::OBJ, "missing_coins_cache", "outpoints recently found missing, so looking them up again skips the database (-dbmissingcache)", {
+                        {RPCResult::Type::NUM, "hits", "number of lookups answered without reading the database"},
+                        {RPCResult::Type::NUM, "entries", "number of outpoints currently remembered"},
+                    }},
+                })},
+                {RPCResult::Type::OBJ, "blocks_index", "the block index database", db_stats},
+                {RPCResult::Type::OBJ_DYN, "indexes", "the databases of the optional indexes, by name", {
+                    {RPCResult::Type::OBJ, "name", "", db_stats},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getdbinfo", "")
+          + HelpExampleRpc("getdbinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue result(UniValue::VOBJ);
+    {
+        LOCK(::cs_main);
+        const CCoinsViewDB& coins_db{chainman.ActiveChainstate().CoinsDB()};
+        UniValue chainstate{DBStatsToJSON(coins_db.GetDBStats())};
+        const auto missing_coins{coins_db.GetMissingCoinsStats()};
+        UniValue missing_coins_cache(UniValue::VOBJ);
+        missing_coins_cache.pushKV("hits", missing_coins.hits);
+        missing_coins_cache.pushKV("entries", missing_coins.entries);
+        chainstate.pushKV("missing_coins_cache", std::move(missing_coins_cache));
+        result.pushKV("chainstate", std::move(chainstate));
+        result.pushKV("blocks_index", DBStatsToJSON(chainman.m_blockman.m_block_tree_db->GetStats()));
+    }
+
+    UniValue indexes(UniValue::VOBJ);
+    if (g_txindex) {
+        indexes.pushKV(g_txindex->GetName(), DBStatsToJSON(g_txindex->GetDBStats()));
+    }
+    if (g_coin_stats_index) {
+        indexes.pushKV(g_coin_stats_index->GetName(), DBStatsToJSON(g_coin_stats_index->GetDBStats()));
+    }
+    if (g_block_stats_index) {
+        indexes.pushKV(g_block_stats_index->GetName(), DBStatsToJSON(g_block_stats_index->GetDBStats()));
+    }
+    if (g_scripthash_index) {
+        indexes.pushKV(g_scripthash_index->GetName(), DBStatsToJSON(g_scripthash_index->GetDBStats()));
+    }
+    if (g_spender_index) {
+        indexes.pushKV(g_spender_index->GetName(), DBStatsToJSON(g_spender_index->GetDBStats()));
+    }
+    ForEachBlockFilterIndex([&indexes](const BlockFilterIndex& index) {
+        indexes.pushKV(index.GetName(), DBStatsToJSON(index.GetDBStats()));
+    });
+    result.pushKV("indexes", std::move(indexes));
+    return result;
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
+        {"control", &getdbinfo},
+        {"control", &getlockstats},
         {"control", &getmemoryinfo},
+        {"control", &getscopetimers},
         {"control", &logging},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
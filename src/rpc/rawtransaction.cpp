@@ -32,6 +32,7 @@
 #include <script/sign.h>
 #include <script/signingprovider.h>
 #include <script/solver.h>
+#include <streams.h>
 #include <uint256.h>
 #include <undo.h>
 #include <util/bip32.h>
@@ -368,7 +369,9 @@ static RPCHelpMan getrawtransaction()
     }
 
     if (verbosity <= 0) {
-        return EncodeHexTx(*tx);
+        DataStream ss_tx;
+        ss_tx << TX_WITH_WITNESS(*tx);
+        return HexOrBinaryResult(request, ss_tx);
     }
 
     UniValue result(UniValue::VOBJ);
@@ -412,6 +415,103 @@ static RPCHelpMan getrawtransaction()
     };
 }
 
+/** Maximum number of transactions looked up by one getrawtransactions call */
+static constexpr size_t MAX_RAW_TRANSACTIONS_LOOKUP{10'000};
+
+static RPCHelpMan getrawtransactions()
+{
+    return RPCHelpMan{
+        "getrawtransactions",
+        "Returns several transactions at once, from the mempool or, if -txindex is enabled, from any block.\n"
+        "The transactions not in the mempool are looked up in the index in one pass and read in the order they are stored on disk,\n"
+        "so a large batch is much cheaper than calling getrawtransaction for each.\n",
+        {
+            {"txids", RPCArg::Type::ARR, RPCArg::Optional::NO, strprintf("The transaction ids (at most %d)", MAX_RAW_TRANSACTIONS_LOOKUP),
+                {
+                    {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "A transaction id"},
+                },
+            },
+            {"verbosity|verbose", RPCArg::Type::NUM, RPCArg::Default{0}, "0 for hex-encoded data, 1 for JSON objects",
+             RPCArgOptions{.skip_type_check = true}},
+        },
+        {
+            RPCResult{"if verbosity is not set or set to 0",
+                RPCResult::Type::ARR, "", "For each of the given txids in order, the transaction, or null if it was not found",
+                {
+                    {RPCResult::Type::STR_HEX, "data", "The serialized transaction as a hex-encoded string"},
+                }},
+            RPCResult{"if verbosity is set to 1",
+                RPCResult::Type::ARR, "", "For each of the given txids in order, the transaction, or null if it was not found",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ELISION, "", "Same output as getrawtransaction with verbosity = 1"},
+                    }},
+                }},
+        },
+        RPCExamples{
+            HelpExampleCli("getrawtransactions", "\"[\\\"mytxid\\\",\\\"myothertxid\\\"]\"")
+            + HelpExampleCli("getrawtransactions", "\"[\\\"mytxid\\\",\\\"myothertxid\\\"]\" 1")
+            + HelpExampleRpc("getrawtransactions", "[\"mytxid\", \"myothertxid\"], 1")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+
+    const UniValue& txid_params{request.params[0].get_array()};
+    if (txid_params.size() > MAX_RAW_TRANSACTIONS_LOOKUP) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Too many txids (max: %d, tried: %d)", MAX_RAW_TRANSACTIONS_LOOKUP, txid_params.size()));
+    }
+    std::vector<uint256> hashes;
+    hashes.reserve(txid_params.size());
+    for (size_t i{0}; i < txid_params.size(); ++i) {
+        hashes.push_back(ParseHashV(txid_params[i], strprintf("txids[%d]", i)));
+    }
+    const int verbosity{ParseVerbosity(request.params[1], /*default_verbosity=*/0, /*allow_bool=*/true)};
+
+    // Like getrawtransaction, prefer the mempool, then look up the others in the index.
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> found(hashes.size());
+    std::vector<size_t> not_in_mempool;
+    if (node.mempool) {
+        LOCK(node.mempool->cs);
+        for (size_t i{0}; i < hashes.size(); ++i) {
+            if (CTransactionRef tx{node.mempool->get(Txid::FromUint256(hashes[i]))}) {
+                found[i].emplace(uint256{}, std::move(tx));
+            } else {
+                not_in_mempool.push_back(i);
+            }
+        }
+    } else {
+        not_in_mempool.resize(hashes.size());
+        std::iota(not_in_mempool.begin(), not_in_mempool.end(), 0);
+    }
+    if (g_txindex && !not_in_mempool.empty()) {
+        g_txindex->BlockUntilSyncedToCurrentChain();
+        std::vector<uint256> index_hashes;
+        index_hashes.reserve(not_in_mempool.size());
+        for (const size_t i : not_in_mempool) index_hashes.push_back(hashes[i]);
+        auto index_found{g_txindex->FindTxs(index_hashes)};
+        for (size_t j{0}; j < not_in_mempool.size(); ++j) found[not_in_mempool[j]] = std::move(index_found[j]);
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const auto& entry : found) {
+        if (!entry) {
+            result.push_back(NullUniValue);
+        } else if (verbosity <= 0) {
+            result.push_back(EncodeHexTx(*entry->second));
+        } else {
+            UniValue tx_result(UniValue::VOBJ);
+            TxToJSON(*entry->second, entry->first, tx_result, chainman.ActiveChainstate());
+            result.push_back(std::move(tx_result));
+        }
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan createrawtransaction()
 {
     return RPCHelpMan{
@@ -2116,6 +2216,7 @@ void RegisterRawTransactionRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"rawtransactions", &getrawtransaction},
+        {"rawtransactions", &getrawtransactions},
         {"rawtransactions", &createrawtransaction},
         {"rawtransactions", &decoderawtransaction},
         {"rawtransactions", &decodescript},
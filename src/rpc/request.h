@@ -7,12 +7,16 @@
 #define BITCOIN_RPC_REQUEST_H
 
 #include <any>
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <univalue.h>
 #include <util/fs.h>
 
+class JSONStreamWriter;
+
 enum class JSONRPCVersion {
     V1_LEGACY,
     V2
@@ -61,6 +65,18 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * If set, the method may write its result into this stream instead of
+     * returning it, for a reply that is sent while it is being generated.
+     * The method then returns null.
+     */
+    JSONStreamWriter* m_result_stream{nullptr};
+    /**
+     * Set if the client accepts a binary reply. Methods whose result is
+     * hex-encoded serialized data may then store the raw bytes here instead,
+     * see HexOrBinaryResult().
+     */
+    std::vector<std::byte>* m_binary_result{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
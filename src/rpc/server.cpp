@@ -15,10 +15,12 @@
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <sync.h>
+#include <util/metrics.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/time.h>
+#include <util/trace.h>
 #include <validation.h>
 
 #include <algorithm>
@@ -36,6 +38,12 @@ static bool fRPCInWarmup GUARDED_BY(g_rpc_warmup_mutex) = true;
 static std::string rpcWarmupStatus GUARDED_BY(g_rpc_warmup_mutex) = "RPC server started";
 static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler);
 
+TRACEPOINT_SEMAPHORE(rpc, request_start);
+TRACEPOINT_SEMAPHORE(rpc, request_end);
+
+static metrics::Histogram& g_metric_request_time{metrics::GetRegistry().GetHistogram("bitcoin_rpc_request_seconds", "Time to execute RPC requests")};
+static metrics::Counter& g_metric_request_errors{metrics::GetRegistry().GetCounter("bitcoin_rpc_errors", "RPC requests failing or calling an unknown method")};
+
 struct RPCCommandExecutionInfo
 {
     std::string method;
@@ -65,6 +73,33 @@ struct RPCCommandExecution
     }
 };
 
+//! Fires the rpc:request_start and rpc:request_end tracepoints around the
+//! execution of a request, and records it in the RPC metrics.
+struct RPCRequestTracer
+{
+    const JSONRPCRequest& request;
+    const SteadyClock::time_point start{SteadyClock::now()};
+    bool success{false};
+
+    explicit RPCRequestTracer(const JSONRPCRequest& request_in) : request{request_in}
+    {
+        TRACEPOINT(rpc, request_start,
+            request.strMethod.c_str(),
+            request.URI.c_str());
+    }
+    ~RPCRequestTracer()
+    {
+        const auto elapsed{SteadyClock::now() - start};
+        g_metric_request_time.Observe(elapsed);
+        if (!success) g_metric_request_errors.Inc();
+        TRACEPOINT(rpc, request_end,
+            request.strMethod.c_str(),
+            request.URI.c_str(),
+            int64_t{Ticks<std::chrono::nanoseconds>(elapsed)},
+            success);
+    }
+};
+
 std::string CRPCTable::help(const std::string& strCommand, const JSONRPCRequest& helpreq) const
 {
     std::string strRet;
@@ -485,10 +520,15 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     }
 
     // Find method
+    RPCRequestTracer tracer{request};
     auto it = mapCommands.find(request.strMethod);
     if (it != mapCommands.end()) {
+        // Only known methods are counted, so that the methods labelling the
+        // metric are bounded.
+        metrics::GetRegistry().GetCounter("bitcoin_rpc_requests", "RPC requests, by method", {{"method", request.strMethod}}).Inc();
         UniValue result;
         if (ExecuteCommands(it->second, request, result)) {
+            tracer.success = true;
             return result;
         }
     }
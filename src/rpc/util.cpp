@@ -15,6 +15,7 @@
 #include <node/types.h>
 #include <outputtype.h>
 #include <pow.h>
+#include <rpc/jsonstream.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
 #include <script/interpreter.h>
@@ -347,6 +348,15 @@ public:
     }
 };
 
+UniValue HexOrBinaryResult(const JSONRPCRequest& request, std::span<const std::byte> data)
+{
+    if (request.m_binary_result) {
+        request.m_binary_result->assign(data.begin(), data.end());
+        return NullUniValue;
+    }
+    return HexStr(data);
+}
+
 UniValue DescribeAddress(const CTxDestination& dest)
 {
     return std::visit(DescribeAddressVisitor(), dest);
@@ -662,7 +672,10 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
     m_req = &request;
     UniValue ret = m_fun(*this, request);
     m_req = nullptr;
-    if (gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
+    // A streamed or binary result is not available for checking.
+    const bool streamed{request.m_result_stream && request.m_result_stream->Started()};
+    const bool binary{request.m_binary_result && !request.m_binary_result->empty()};
+    if (!streamed && !binary && gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
         UniValue mismatch{UniValue::VARR};
         for (const auto& res : m_results.m_results) {
             UniValue match{res.MatchesType(ret)};
@@ -24,6 +24,7 @@
 #include <initializer_list>
 #include <map>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -140,6 +141,12 @@ CTxDestination AddAndGetMultisigDestination(const int required, const std::vecto
 
 UniValue DescribeAddress(const CTxDestination& dest);
 
+/**
+ * Result for hex-encoded serialized data: the hex string, or null if the data
+ * was stored in the binary result of a request that accepts one.
+ */
+UniValue HexOrBinaryResult(const JSONRPCRequest& request, std::span<const std::byte> data);
+
 /** Parse a sighash string representation and raise an RPC error if it is invalid. */
 std::optional<int> ParseSighashString(const UniValue& sighash);
 
@@ -7,6 +7,7 @@
 #include <sync.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <utility>
@@ -16,11 +17,28 @@ CScheduler::CScheduler() = default;
 CScheduler::~CScheduler()
 {
     assert(nThreadsServicingQueue == 0);
-    if (stopWhenEmpty) assert(taskQueue.empty());
+    if (stopWhenEmpty) assert(empty());
 }
 
+bool CScheduler::empty() const
+{
+    return std::ranges::all_of(taskQueues, [](const TaskQueue& queue) { return queue.empty(); });
+}
+
+CScheduler::TaskQueue* CScheduler::NextTaskQueue(std::optional<TaskClass> task_class)
+{
+    if (task_class) {
+        TaskQueue& queue{taskQueues[size_t(*task_class)]};
+        return queue.empty() ? nullptr : &queue;
+    }
+    TaskQueue* next{nullptr};
+    for (TaskQueue& queue : taskQueues) {
+        if (!queue.empty() && (!next || queue.begin()->first < next->begin()->first)) next = &queue;
+    }
+    return next;
+}
 
-void CScheduler::serviceQueue()
+void CScheduler::serviceQueueImpl(std::optional<TaskClass> task_class)
 {
     WAIT_LOCK(newTaskMutex, lock);
     ++nThreadsServicingQueue;
@@ -30,7 +48,7 @@ void CScheduler::serviceQueue()
     // is called.
     while (!shouldStop()) {
         try {
-            while (!shouldStop() && taskQueue.empty()) {
+            while (!shouldStop() && !NextTaskQueue(task_class)) {
                 // Wait until there is something to do.
                 newTaskScheduled.wait(lock);
             }
@@ -38,20 +56,21 @@ void CScheduler::serviceQueue()
             // Wait until either there is a new task, or until
             // the time of the first item on the queue:
 
-            while (!shouldStop() && !taskQueue.empty()) {
-                std::chrono::steady_clock::time_point timeToWaitFor = taskQueue.begin()->first;
+            while (!shouldStop() && NextTaskQueue(task_class)) {
+                std::chrono::steady_clock::time_point timeToWaitFor = NextTaskQueue(task_class)->begin()->first;
                 if (newTaskScheduled.wait_until(lock, timeToWaitFor) == std::cv_status::timeout) {
                     break; // Exit loop after timeout, it means we reached the time of the event
                 }
             }
 
             // If there are multiple threads, the queue can empty while we're waiting (another
-            // thread may service the task we were waiting on).
-            if (shouldStop() || taskQueue.empty())
+            // thread may service the task we were waiting on), and the next task may not be due.
+            TaskQueue* queue{NextTaskQueue(task_class)};
+            if (shouldStop() || !queue || queue->begin()->first > std::chrono::steady_clock::now())
                 continue;
 
-            Function f = taskQueue.begin()->second;
-            taskQueue.erase(taskQueue.begin());
+            Function f = queue->begin()->second;
+            queue->erase(queue->begin());
 
             {
                 // Unlock before calling f, so it can reschedule itself or another task
@@ -65,16 +84,17 @@ void CScheduler::serviceQueue()
         }
     }
     --nThreadsServicingQueue;
-    newTaskScheduled.notify_one();
+    newTaskScheduled.notify_all();
 }
 
-void CScheduler::schedule(CScheduler::Function f, std::chrono::steady_clock::time_point t)
+void CScheduler::schedule(CScheduler::Function f, std::chrono::steady_clock::time_point t, TaskClass task_class)
 {
     {
         LOCK(newTaskMutex);
-        taskQueue.insert(std::make_pair(t, f));
+        taskQueues[size_t(task_class)].insert(std::make_pair(t, f));
     }
-    newTaskScheduled.notify_one();
+    // Threads may service different classes of tasks, so wake all of them.
+    newTaskScheduled.notify_all();
 }
 
 void CScheduler::MockForward(std::chrono::seconds delta_seconds)
@@ -84,40 +104,44 @@ void CScheduler::MockForward(std::chrono::seconds delta_seconds)
     {
         LOCK(newTaskMutex);
 
-        // use temp_queue to maintain updated schedule
-        std::multimap<std::chrono::steady_clock::time_point, Function> temp_queue;
+        for (TaskQueue& queue : taskQueues) {
+            // use temp_queue to maintain updated schedule
+            TaskQueue temp_queue;
 
-        for (const auto& element : taskQueue) {
-            temp_queue.emplace_hint(temp_queue.cend(), element.first - delta_seconds, element.second);
-        }
+            for (const auto& element : queue) {
+                temp_queue.emplace_hint(temp_queue.cend(), element.first - delta_seconds, element.second);
+            }
 
-        // point taskQueue to temp_queue
-        taskQueue = std::move(temp_queue);
+            // point queue to temp_queue
+            queue = std::move(temp_queue);
+        }
     }
 
-    // notify that the taskQueue needs to be processed
-    newTaskScheduled.notify_one();
+    // notify that the taskQueues need to be processed
+    newTaskScheduled.notify_all();
 }
 
-static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta)
+static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta, CScheduler::TaskClass task_class)
 {
     f();
-    s.scheduleFromNow([=, &s] { Repeat(s, f, delta); }, delta);
+    s.scheduleFromNow([=, &s] { Repeat(s, f, delta, task_class); }, delta, task_class);
 }
 
-void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta)
+void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta, TaskClass task_class)
 {
-    scheduleFromNow([this, f, delta] { Repeat(*this, f, delta); }, delta);
+    scheduleFromNow([this, f, delta, task_class] { Repeat(*this, f, delta, task_class); }, delta, task_class);
 }
 
 size_t CScheduler::getQueueInfo(std::chrono::steady_clock::time_point& first,
                                 std::chrono::steady_clock::time_point& last) const
 {
     LOCK(newTaskMutex);
-    size_t result = taskQueue.size();
-    if (!taskQueue.empty()) {
-        first = taskQueue.begin()->first;
-        last = taskQueue.rbegin()->first;
+    size_t result = 0;
+    for (const TaskQueue& queue : taskQueues) {
+        if (queue.empty()) continue;
+        first = result ? std::min(first, queue.begin()->first) : queue.begin()->first;
+        last = result ? std::max(last, queue.rbegin()->first) : queue.rbegin()->first;
+        result += queue.size();
     }
     return result;
 }
@@ -10,12 +10,14 @@
 #include <threadsafety.h>
 #include <util/task_runner.h>
 
+#include <array>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <map>
+#include <optional>
 #include <thread>
 #include <utility>
 
@@ -35,6 +37,10 @@
  * t->join();
  * delete t;
  * delete s; // Must be done after thread is interrupted/joined.
+ *
+ * Tasks are of a TaskClass, so that threads servicing only some classes of
+ * tasks can be dedicated to them, e.g. to keep tasks doing disk I/O from
+ * delaying the other ones.
  */
 class CScheduler
 {
@@ -43,16 +49,26 @@ public:
     ~CScheduler();
 
     std::thread m_service_thread;
+    //! Thread servicing the BACKGROUND tasks, if m_service_thread does not.
+    std::thread m_background_thread;
 
     typedef std::function<void()> Function;
 
+    enum class TaskClass {
+        //! Tasks which others wait for or which should run on time, e.g. validation notifications.
+        DEFAULT,
+        //! Periodic tasks which may take a while, e.g. writing files.
+        BACKGROUND,
+    };
+    static constexpr size_t NUM_TASK_CLASSES{2};
+
     /** Call func at/after time t */
-    void schedule(Function f, std::chrono::steady_clock::time_point t) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    void schedule(Function f, std::chrono::steady_clock::time_point t, TaskClass task_class = TaskClass::DEFAULT) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
     /** Call f once after the delta has passed */
-    void scheduleFromNow(Function f, std::chrono::milliseconds delta) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
+    void scheduleFromNow(Function f, std::chrono::milliseconds delta, TaskClass task_class = TaskClass::DEFAULT) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
     {
-        schedule(std::move(f), std::chrono::steady_clock::now() + delta);
+        schedule(std::move(f), std::chrono::steady_clock::now() + delta, task_class);
     }
 
     /**
@@ -61,7 +77,7 @@ public:
      * The timing is not exact: Every time f is finished, it is rescheduled to run again after delta. If you need more
      * accurate scheduling, don't use this method.
      */
-    void scheduleEvery(Function f, std::chrono::milliseconds delta) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    void scheduleEvery(Function f, std::chrono::milliseconds delta, TaskClass task_class = TaskClass::DEFAULT) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
     /**
      * Mock the scheduler to fast forward in time.
@@ -73,21 +89,24 @@ public:
     /**
      * Services the queue 'forever'. Should be run in a thread.
      */
-    void serviceQueue() EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    void serviceQueue() EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex) { serviceQueueImpl(std::nullopt); }
+
+    /** Services the tasks of one class only 'forever', like serviceQueue(). */
+    void serviceTaskClass(TaskClass task_class) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex) { serviceQueueImpl(task_class); }
 
     /** Tell any threads running serviceQueue to stop as soon as the current task is done */
     void stop() EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
     {
         WITH_LOCK(newTaskMutex, stopRequested = true);
         newTaskScheduled.notify_all();
-        if (m_service_thread.joinable()) m_service_thread.join();
+        JoinServiceThreads();
     }
     /** Tell any threads running serviceQueue to stop when there is no work left to be done */
     void StopWhenDrained() EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
     {
         WITH_LOCK(newTaskMutex, stopWhenEmpty = true);
         newTaskScheduled.notify_all();
-        if (m_service_thread.joinable()) m_service_thread.join();
+        JoinServiceThreads();
     }
 
     /**
@@ -102,13 +121,26 @@ public:
     bool AreThreadsServicingQueue() const EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
 private:
+    using TaskQueue = std::multimap<std::chrono::steady_clock::time_point, Function>;
+
     mutable Mutex newTaskMutex;
     std::condition_variable newTaskScheduled;
-    std::multimap<std::chrono::steady_clock::time_point, Function> taskQueue GUARDED_BY(newTaskMutex);
+    //! Tasks of each TaskClass.
+    std::array<TaskQueue, NUM_TASK_CLASSES> taskQueues GUARDED_BY(newTaskMutex);
     int nThreadsServicingQueue GUARDED_BY(newTaskMutex){0};
     bool stopRequested GUARDED_BY(newTaskMutex){false};
     bool stopWhenEmpty GUARDED_BY(newTaskMutex){false};
-    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && taskQueue.empty()); }
+    //! Run the tasks of the given class, or of all classes.
+    void serviceQueueImpl(std::optional<TaskClass> task_class) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && empty()); }
+    bool empty() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
+    //! The queue of the next task of the given class, or of any class, or nullptr if there is none.
+    TaskQueue* NextTaskQueue(std::optional<TaskClass> task_class) EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
+    void JoinServiceThreads()
+    {
+        if (m_service_thread.joinable()) m_service_thread.join();
+        if (m_background_thread.joinable()) m_background_thread.join();
+    }
 };
 
 /**
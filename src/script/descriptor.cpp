@@ -2148,7 +2148,8 @@ std::vector<std::unique_ptr<DescriptorImpl>> ParseScript(uint32_t& key_exp_index
                 for (auto& pub : parser.m_keys) {
                     pubs.emplace_back(std::move(pub.at(i)));
                 }
-                ret.emplace_back(std::make_unique<MiniscriptDescriptor>(std::move(pubs), node->Clone()));
+                // The last descriptor takes the parsed node, only the others need a copy of it.
+                ret.emplace_back(std::make_unique<MiniscriptDescriptor>(std::move(pubs), i + 1 == num_multipath ? std::move(node) : node->Clone()));
             }
             return ret;
         }
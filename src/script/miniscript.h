@@ -537,7 +537,7 @@ struct Node {
                 new_subs.emplace_back(std::move(*child));
             }
             // std::make_unique (and therefore MakeNodeRef) doesn't work on private constructors
-            return std::unique_ptr<Node>{new Node{internal::NoDupCheck{}, node.m_script_ctx, node.fragment, std::move(new_subs), node.keys, node.data, node.k}};
+            return std::unique_ptr<Node>{new Node{node, std::move(new_subs)}};
         };
         return TreeEval<NodeRef<Key>>(upfn);
     }
@@ -560,11 +560,13 @@ private:
     //! for all subnodes as well.
     mutable std::optional<bool> has_duplicate_keys;
 
-    // Constructor which takes all of the data that a Node could possibly contain.
-    // This is kept private as no valid fragment has all of these arguments.
+    // Constructor which copies all of the data of a node, with clones of its subs. The cached
+    // properties of the node are copied rather than recomputed, as they only depend on the
+    // data and on the cached properties of the subs, which are the same.
     // Only used by Clone()
-    Node(internal::NoDupCheck, MiniscriptContext script_ctx, Fragment nt, std::vector<NodeRef<Key>> sub, std::vector<Key> key, std::vector<unsigned char> arg, uint32_t val)
-        : fragment(nt), k(val), keys(key), data(std::move(arg)), subs(std::move(sub)), m_script_ctx{script_ctx}, ops(CalcOps()), ss(CalcStackSize()), ws(CalcWitnessSize()), typ(CalcType()), scriptlen(CalcScriptLen()) {}
+    Node(const Node& node, std::vector<NodeRef<Key>> sub)
+        : fragment(node.fragment), k(node.k), keys(node.keys), data(node.data), subs(std::move(sub)), m_script_ctx{node.m_script_ctx},
+          ops(node.ops), ss(node.ss), ws(node.ws), typ(node.typ), scriptlen(node.scriptlen), has_duplicate_keys(node.has_duplicate_keys) {}
 
     //! Compute the length of the script for this miniscript (including children).
     size_t CalcScriptLen() const {
@@ -13,27 +13,71 @@
 #include <span.h>
 #include <uint256.h>
 
+#include <algorithm>
+#include <cassert>
 #include <mutex>
 #include <shared_mutex>
 #include <vector>
 
-SignatureCache::SignatureCache(const size_t max_size_bytes)
+SignatureCache::SignatureCache(const size_t max_size_bytes, const bool huge_pages)
+    : m_max_size_bytes{max_size_bytes},
+      m_huge_pages{huge_pages}
 {
-    uint256 nonce = GetRandHash();
+    Reset(GetRandHash());
+    LogPrintf("Using %zu MiB out of %zu MiB requested for signature cache, able to store %zu elements\n",
+              m_max_bytes >> 20, max_size_bytes >> 20, m_max_entries);
+}
+
+void SignatureCache::Reset(const uint256& nonce)
+{
+    m_nonce = nonce;
     // We want the nonce to be 64 bytes long to force the hasher to process
     // this chunk, which makes later hash computations more efficient. We
     // just write our 32-byte entropy, and then pad with 'E' for ECDSA and
     // 'S' for Schnorr (followed by 0 bytes).
     static constexpr unsigned char PADDING_ECDSA[32] = {'E'};
     static constexpr unsigned char PADDING_SCHNORR[32] = {'S'};
-    m_salted_hasher_ecdsa.Write(nonce.begin(), 32);
+    m_salted_hasher_ecdsa.Reset().Write(nonce.begin(), 32);
     m_salted_hasher_ecdsa.Write(PADDING_ECDSA, 32);
-    m_salted_hasher_schnorr.Write(nonce.begin(), 32);
+    m_salted_hasher_schnorr.Reset().Write(nonce.begin(), 32);
     m_salted_hasher_schnorr.Write(PADDING_SCHNORR, 32);
 
-    const auto [num_elems, approx_size_bytes] = setValid.setup_bytes(max_size_bytes);
-    LogPrintf("Using %zu MiB out of %zu MiB requested for signature cache, able to store %zu elements\n",
-              approx_size_bytes >> 20, max_size_bytes >> 20, num_elems);
+    m_max_entries = 0;
+    m_max_bytes = 0;
+    for (Shard& shard : m_shards) {
+        const auto [num_elems, approx_size_bytes] = shard.setValid.setup_bytes(m_max_size_bytes / NUM_SHARDS, m_huge_pages);
+        m_max_entries += num_elems;
+        m_max_bytes += approx_size_bytes;
+    }
+}
+
+std::vector<uint256> SignatureCache::Entries() const
+{
+    std::vector<uint256> entries;
+    for (const Shard& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.cs_sigcache);
+        shard.setValid.ForEach([&](const uint256& entry) { entries.push_back(entry); });
+    }
+    return entries;
+}
+
+void SignatureCache::Restore(const uint256& nonce, std::span<const uint256> entries)
+{
+    Reset(nonce);
+    for (const uint256& entry : entries) Set(entry);
+    // Restored entries are not counted as inserted by validation.
+    for (Shard& shard : m_shards) {
+        shard.inserts = 0;
+        shard.evictions = 0;
+    }
+}
+
+SignatureCache::Shard& SignatureCache::GetShard(const uint256& entry)
+{
+    // SignatureCacheHasher maps the high bits of each 32-bit word to a position in
+    // the shard, so pick the shard from low bits to keep the positions uniform.
+    static_assert(NUM_SHARDS <= 256);
+    return m_shards[entry.data()[0] % NUM_SHARDS];
 }
 
 void SignatureCache::ComputeEntryECDSA(uint256& entry, const uint256& hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey) const
@@ -50,14 +94,67 @@ void SignatureCache::ComputeEntrySchnorr(uint256& entry, const uint256& hash, st
 
 bool SignatureCache::Get(const uint256& entry, const bool erase)
 {
-    std::shared_lock<std::shared_mutex> lock(cs_sigcache);
-    return setValid.contains(entry, erase);
+    Shard& shard{GetShard(entry)};
+    bool found;
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.cs_sigcache);
+        found = shard.setValid.contains(entry, erase);
+    }
+    (found ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
+    return found;
 }
 
 void SignatureCache::Set(const uint256& entry)
 {
-    std::unique_lock<std::shared_mutex> lock(cs_sigcache);
-    setValid.insert(entry);
+    Shard& shard{GetShard(entry)};
+    bool evicted;
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.cs_sigcache);
+        evicted = !shard.setValid.insert(entry);
+    }
+    shard.inserts.fetch_add(1, std::memory_order_relaxed);
+    if (evicted) shard.evictions.fetch_add(1, std::memory_order_relaxed);
+}
+
+SignatureCacheStats SignatureCache::GetStats() const
+{
+    SignatureCacheStats stats;
+    for (const Shard& shard : m_shards) {
+        stats.hits += shard.hits.load(std::memory_order_relaxed);
+        stats.misses += shard.misses.load(std::memory_order_relaxed);
+        stats.inserts += shard.inserts.load(std::memory_order_relaxed);
+        stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+    }
+    stats.max_entries = m_max_entries;
+    stats.max_bytes = m_max_bytes;
+    return stats;
+}
+
+size_t SignatureCache::DynamicMemoryUsage() const
+{
+    size_t usage{0};
+    for (const Shard& shard : m_shards) {
+        usage += shard.setValid.DynamicMemoryUsage();
+    }
+    return usage;
+}
+
+void SchnorrBatch::Add(std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, const uint256& sighash, std::optional<uint256> cache_entry)
+{
+    Entry& entry{m_entries.emplace_back(Entry{{}, pubkey, sighash, cache_entry})};
+    assert(sig.size() == entry.sig.size());
+    std::copy(sig.begin(), sig.end(), entry.sig.begin());
+}
+
+bool SchnorrBatch::Verify(SignatureCache& signature_cache) const
+{
+    for (const Entry& entry : m_entries) {
+        if (!entry.pubkey.VerifySchnorr(entry.sighash, entry.sig)) return false;
+    }
+    for (const Entry& entry : m_entries) {
+        if (entry.cache_entry) signature_cache.Set(*entry.cache_entry);
+    }
+    return true;
 }
 
 bool CachingTransactionSignatureChecker::VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
@@ -78,6 +175,10 @@ bool CachingTransactionSignatureChecker::VerifySchnorrSignature(std::span<const
     uint256 entry;
     m_signature_cache.ComputeEntrySchnorr(entry, sighash, sig, pubkey);
     if (m_signature_cache.Get(entry, !store)) return true;
+    if (m_schnorr_batch) {
+        m_schnorr_batch->Add(sig, pubkey, sighash, store ? std::optional{entry} : std::nullopt);
+        return true;
+    }
     if (!TransactionSignatureChecker::VerifySchnorrSignature(sig, pubkey, sighash)) return false;
     if (store) m_signature_cache.Set(entry);
     return true;
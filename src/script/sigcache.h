@@ -9,18 +9,22 @@
 #include <consensus/amount.h>
 #include <crypto/sha256.h>
 #include <cuckoocache.h>
+#include <pubkey.h>
 #include <script/interpreter.h>
 #include <span.h>
 #include <uint256.h>
 #include <util/hasher.h>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <shared_mutex>
 #include <vector>
 
 class CPubKey;
 class CTransaction;
-class XOnlyPubKey;
 
 // DoS prevention: limit cache size to 32MiB (over 1000000 entries on 64-bit
 // systems). Due to how we count cache size, actual memory usage is slightly
@@ -30,23 +34,60 @@ static constexpr size_t DEFAULT_SIGNATURE_CACHE_BYTES{DEFAULT_VALIDATION_CACHE_B
 static constexpr size_t DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES{DEFAULT_VALIDATION_CACHE_BYTES / 2};
 static_assert(DEFAULT_VALIDATION_CACHE_BYTES == DEFAULT_SIGNATURE_CACHE_BYTES + DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES);
 
+/** Counters of a signature cache since its creation. */
+struct SignatureCacheStats {
+    //! Signatures found in the cache.
+    uint64_t hits{0};
+    //! Signatures not found in the cache, which were verified.
+    uint64_t misses{0};
+    //! Valid signatures added to the cache.
+    uint64_t inserts{0};
+    //! Entries dropped to make room for added ones.
+    uint64_t evictions{0};
+    //! Maximum number of entries the cache can hold.
+    size_t max_entries{0};
+    //! Approximate memory usage of the cache when full.
+    size_t max_bytes{0};
+};
+
 /**
  * Valid signature cache, to avoid doing expensive ECDSA signature checking
  * twice for every transaction (once when accepted into memory pool, and
  * again when accepted into the block chain)
+ *
+ * The cache is split into shards, selected by the entry, each with its own
+ * lock, so that the script check threads rarely wait for each other.
  */
 class SignatureCache
 {
 private:
+    static constexpr size_t NUM_SHARDS{16};
+
     //! Entries are SHA256(nonce || 'E' or 'S' || 31 zero bytes || signature hash || public key || signature):
+    uint256 m_nonce;
     CSHA256 m_salted_hasher_ecdsa;
     CSHA256 m_salted_hasher_schnorr;
     typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
-    map_type setValid;
-    std::shared_mutex cs_sigcache;
+    struct Shard {
+        map_type setValid;
+        mutable std::shared_mutex cs_sigcache;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> inserts{0};
+        std::atomic<uint64_t> evictions{0};
+    };
+    std::array<Shard, NUM_SHARDS> m_shards;
+    const size_t m_max_size_bytes;
+    const bool m_huge_pages;
+    size_t m_max_entries{0};
+    size_t m_max_bytes{0};
+
+    Shard& GetShard(const uint256& entry);
+    //! Set the nonce of the entries, and empty the shards.
+    void Reset(const uint256& nonce);
 
 public:
-    SignatureCache(size_t max_size_bytes);
+    SignatureCache(size_t max_size_bytes, bool huge_pages = false);
 
     SignatureCache(const SignatureCache&) = delete;
     SignatureCache& operator=(const SignatureCache&) = delete;
@@ -58,6 +99,61 @@ public:
     bool Get(const uint256& entry, const bool erase);
 
     void Set(const uint256& entry);
+
+    SignatureCacheStats GetStats() const;
+
+    //! Nonce of the entries, which are only meaningful with it.
+    const uint256& Nonce() const { return m_nonce; }
+
+    //! Copy of the entries of the cache, e.g. to save them.
+    std::vector<uint256> Entries() const;
+
+    /**
+     * Replace the entries of the cache with saved ones, computed with `nonce`.
+     * Must be called before the cache is used, e.g. at startup.
+     */
+    void Restore(const uint256& nonce, std::span<const uint256> entries);
+
+    //! Memory used by the tables of all shards.
+    size_t DynamicMemoryUsage() const;
+};
+
+/**
+ * Schnorr signature checks whose verification was deferred, so that they can
+ * be verified together once script execution has finished.
+ *
+ * Deferring is sound because a failed Schnorr check of a non-empty signature
+ * always fails the script (BIP 340-342): a script that succeeded assuming its
+ * deferred signatures were valid is valid exactly if they all are.
+ */
+class SchnorrBatch
+{
+private:
+    struct Entry {
+        std::array<unsigned char, 64> sig;
+        XOnlyPubKey pubkey;
+        uint256 sighash;
+        //! Signature cache entry to store once the signature is known to be valid.
+        std::optional<uint256> cache_entry;
+    };
+    std::vector<Entry> m_entries;
+
+public:
+    void Add(std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, const uint256& sighash, std::optional<uint256> cache_entry);
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+    void clear() { m_entries.clear(); }
+
+    /**
+     * Verify all deferred signatures, returning whether they are all valid.
+     * Signatures of checks that asked for it are added to `signature_cache`.
+     *
+     * The bundled libsecp256k1 does not offer batch verification yet, so the
+     * signatures are verified one by one; this is the single place to switch
+     * to a multi-scalar multiplication once it does.
+     */
+    bool Verify(SignatureCache& signature_cache) const;
 };
 
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker
@@ -65,9 +161,11 @@ class CachingTransactionSignatureChecker : public TransactionSignatureChecker
 private:
     bool store;
     SignatureCache& m_signature_cache;
+    //! If set, Schnorr signatures missing from the cache are deferred to this batch instead of verified.
+    SchnorrBatch* m_schnorr_batch;
 
 public:
-    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, SignatureCache& signature_cache, PrecomputedTransactionData& txdataIn) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn, MissingDataBehavior::ASSERT_FAIL), store(storeIn), m_signature_cache(signature_cache)  {}
+    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, SignatureCache& signature_cache, PrecomputedTransactionData& txdataIn, SchnorrBatch* schnorr_batch = nullptr) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn, MissingDataBehavior::ASSERT_FAIL), store(storeIn), m_signature_cache(signature_cache), m_schnorr_batch(schnorr_batch) {}
 
     bool VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& vchPubKey, const uint256& sighash) const override;
     bool VerifySchnorrSignature(std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, const uint256& sighash) const override;
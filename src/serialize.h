@@ -13,6 +13,7 @@
 #include <span.h>
 
 #include <algorithm>
+#include <bit>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
@@ -288,6 +289,19 @@ template <typename Stream> void Serialize(Stream& s, bool a)    { uint8_t f = a;
 template <typename Stream> void Unserialize(Stream& s, bool& a) { uint8_t f = ser_readdata8(s); a = f; }
 // clang-format on
 
+/**
+ * Types serialized as their representation in memory, so that vectors of them
+ * are serialized with a single write or read of all their elements: bytes,
+ * integers on little-endian platforms, and types opting in with a
+ * SERIALIZED_BYTES member equal to their size, such as uint256.
+ */
+template <typename T>
+concept BulkSerializable = BasicByte<T> ||
+    (std::endian::native == std::endian::little &&
+     (std::same_as<T, int16_t> || std::same_as<T, uint16_t> || std::same_as<T, int32_t> || std::same_as<T, uint32_t> ||
+      std::same_as<T, int64_t> || std::same_as<T, uint64_t>)) ||
+    (std::is_trivially_copyable_v<T> && requires { requires T::SERIALIZED_BYTES == sizeof(T); });
+
 
 /**
  * Compact Size
@@ -811,7 +825,7 @@ void Unserialize(Stream& is, std::basic_string<C>& str)
 template <typename Stream, unsigned int N, typename T>
 void Serialize(Stream& os, const prevector<N, T>& v)
 {
-    if constexpr (BasicByte<T>) { // Use optimized version for unformatted basic bytes
+    if constexpr (BulkSerializable<T>) { // Use optimized version for elements serialized as their bytes
         WriteCompactSize(os, v.size());
         if (!v.empty()) os.write(MakeByteSpan(v));
     } else {
@@ -823,7 +837,7 @@ void Serialize(Stream& os, const prevector<N, T>& v)
 template <typename Stream, unsigned int N, typename T>
 void Unserialize(Stream& is, prevector<N, T>& v)
 {
-    if constexpr (BasicByte<T>) { // Use optimized version for unformatted basic bytes
+    if constexpr (BulkSerializable<T>) { // Use optimized version for elements serialized as their bytes
         // Limit size per read so bogus size value won't cause out of memory
         v.clear();
         unsigned int nSize = ReadCompactSize(is);
@@ -846,7 +860,7 @@ void Unserialize(Stream& is, prevector<N, T>& v)
 template <typename Stream, typename T, typename A>
 void Serialize(Stream& os, const std::vector<T, A>& v)
 {
-    if constexpr (BasicByte<T>) { // Use optimized version for unformatted basic bytes
+    if constexpr (BulkSerializable<T>) { // Use optimized version for elements serialized as their bytes
         WriteCompactSize(os, v.size());
         if (!v.empty()) os.write(MakeByteSpan(v));
     } else if constexpr (std::is_same_v<T, bool>) {
@@ -866,7 +880,7 @@ void Serialize(Stream& os, const std::vector<T, A>& v)
 template <typename Stream, typename T, typename A>
 void Unserialize(Stream& is, std::vector<T, A>& v)
 {
-    if constexpr (BasicByte<T>) { // Use optimized version for unformatted basic bytes
+    if constexpr (BulkSerializable<T>) { // Use optimized version for elements serialized as their bytes
         // Limit size per read so bogus size value won't cause out of memory
         v.clear();
         unsigned int nSize = ReadCompactSize(is);
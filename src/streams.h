@@ -6,6 +6,7 @@
 #ifndef BITCOIN_STREAMS_H
 #define BITCOIN_STREAMS_H
 
+#include <crypto/common.h>
 #include <logging.h>
 #include <serialize.h>
 #include <span.h>
@@ -15,6 +16,7 @@
 #include <util/syserror.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -35,7 +37,27 @@ inline void Xor(std::span<std::byte> write, std::span<const std::byte> key, size
     }
     key_offset %= key.size();
 
-    for (size_t i = 0, j = key_offset; i != write.size(); i++) {
+    size_t i = 0;
+    if (key.size() == sizeof(uint64_t)) {
+        // Obfuscation keys are 8 bytes long, so XOR a word at a time with
+        // the key rotated to the offset. The loop is simple enough for
+        // compilers to vectorize it with the baseline instruction set.
+        std::byte rotated[sizeof(uint64_t)];
+        for (size_t k = 0; k < sizeof(uint64_t); ++k) {
+            rotated[k] = key[(key_offset + k) % sizeof(uint64_t)];
+        }
+        uint64_t key_word;
+        std::memcpy(&key_word, rotated, sizeof(key_word));
+        for (; write.size() - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, write.data() + i, sizeof(word));
+            word ^= key_word;
+            std::memcpy(write.data() + i, &word, sizeof(word));
+        }
+        // `i` is a multiple of the key size, so the tail starts at key_offset.
+    }
+
+    for (size_t j = key_offset; i != write.size(); i++) {
         write[i] ^= key[j++];
 
         // This potentially acts on very many bytes of data, so it's
@@ -335,15 +357,23 @@ class BitStreamWriter
 private:
     OStream& m_ostream;
 
-    /// Buffered byte waiting to be written to the output stream. The byte is
-    /// written buffer when m_offset reaches 8 or Flush() is called.
-    uint8_t m_buffer{0};
+    /// Buffered bits waiting to be written to the output stream, a word at a
+    /// time. The word is written when m_offset reaches 64, and its bytes
+    /// holding bits are written when Flush() is called.
+    uint64_t m_buffer{0};
 
     /// Number of high order bits in m_buffer already written by previous
     /// Write() calls and not yet flushed to the stream. The next bit to be
     /// written to is at this offset from the most significant bit position.
     int m_offset{0};
 
+    void WriteBytes(int nbytes)
+    {
+        std::array<std::byte, 8> bytes;
+        WriteBE64(bytes.data(), m_buffer);
+        m_ostream.write(std::span{bytes}.first(nbytes));
+    }
+
 public:
     explicit BitStreamWriter(OStream& ostream) : m_ostream(ostream) {}
 
@@ -353,23 +383,25 @@ public:
     }
 
     /** Write the nbits least significant bits of a 64-bit int to the output
-     * stream. Data is buffered until it completes an octet.
+     * stream. Data is buffered until it completes a 64-bit word.
      */
     void Write(uint64_t data, int nbits) {
         if (nbits < 0 || nbits > 64) {
             throw std::out_of_range("nbits must be between 0 and 64");
         }
+        if (nbits == 0) return;
 
-        while (nbits > 0) {
-            int bits = std::min(8 - m_offset, nbits);
-            m_buffer |= (data << (64 - nbits)) >> (64 - 8 + m_offset);
-            m_offset += bits;
-            nbits -= bits;
-
-            if (m_offset == 8) {
-                Flush();
-            }
+        const uint64_t bits{data << (64 - nbits)};
+        m_buffer |= bits >> m_offset;
+        const int written{64 - m_offset};
+        if (nbits < written) {
+            m_offset += nbits;
+            return;
         }
+        WriteBytes(8);
+        // Keep the bits which did not fit in the word.
+        m_buffer = nbits > written ? bits << written : 0;
+        m_offset = nbits - written;
     }
 
     /** Flush any unwritten bits to the output stream, padding with 0's to the
@@ -380,7 +412,7 @@ public:
             return;
         }
 
-        m_ostream << m_buffer;
+        WriteBytes((m_offset + 7) / 8);
         m_buffer = 0;
         m_offset = 0;
     }
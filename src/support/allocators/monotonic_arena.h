@@ -0,0 +1,102 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Memory for objects that are allocated together and freed together, such as
+ * the transactions of a block.
+ *
+ * Allocations are carved out of chunks of memory, one after the other, and
+ * freeing an allocation does nothing: the chunks are freed at once when the
+ * arena is destroyed. This replaces an allocation and a deallocation per
+ * object by one per chunk, at the cost of keeping the memory of all objects
+ * until the last of them is freed.
+ *
+ * MonotonicArena is not thread-safe. It is intended to be filled by one thread
+ * and used through MonotonicArenaAllocator, which keeps it alive as long as any
+ * object allocated from it.
+ */
+class MonotonicArena
+{
+public:
+    //! @param[in] chunk_size_bytes  Size of the chunks. Larger allocations get a chunk of their own.
+    explicit MonotonicArena(size_t chunk_size_bytes) : m_chunk_size_bytes{chunk_size_bytes} {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment)
+    {
+        void* ptr{m_available};
+        size_t space(m_available_end - m_available);
+        if (!std::align(alignment, bytes, ptr, space)) {
+            // Not zero-initialized, unlike std::make_unique<std::byte[]>.
+            space = std::max(bytes + alignment, m_chunk_size_bytes);
+            ptr = m_chunks.emplace_back(new std::byte[space]).get();
+            m_available_end = static_cast<std::byte*>(ptr) + space;
+            ptr = std::align(alignment, bytes, ptr, space);
+            assert(ptr);
+        }
+        m_available = static_cast<std::byte*>(ptr) + bytes;
+        return ptr;
+    }
+
+    //! Number of chunks allocated, for tests.
+    size_t NumChunks() const { return m_chunks.size(); }
+
+private:
+    const size_t m_chunk_size_bytes;
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    //! Memory left in the last chunk.
+    std::byte* m_available{nullptr};
+    std::byte* m_available_end{nullptr};
+};
+
+/**
+ * Allocator allocating from a MonotonicArena, e.g. for std::allocate_shared.
+ * Copies of the allocator share the arena.
+ */
+template <typename T>
+class MonotonicArenaAllocator
+{
+    template <typename U>
+    friend class MonotonicArenaAllocator;
+
+    std::shared_ptr<MonotonicArena> m_arena;
+
+public:
+    using value_type = T;
+
+    explicit MonotonicArenaAllocator(std::shared_ptr<MonotonicArena> arena) noexcept : m_arena{std::move(arena)} {}
+
+    template <typename U>
+    MonotonicArenaAllocator(const MonotonicArenaAllocator<U>& other) noexcept : m_arena{other.m_arena}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    friend bool operator==(const MonotonicArenaAllocator<T>& a, const MonotonicArenaAllocator<U>& b) noexcept
+    {
+        return a.m_arena == b.m_arena;
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_ARENA_H
@@ -5,6 +5,9 @@
 #ifndef BITCOIN_SUPPORT_ALLOCATORS_POOL_H
 #define BITCOIN_SUPPORT_ALLOCATORS_POOL_H
 
+#include <support/hugepages.h>
+
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
@@ -95,6 +98,16 @@ class PoolResource final
      */
     const size_t m_chunk_size_bytes;
 
+    /**
+     * Whether chunks are aligned to and advised to be backed by huge pages.
+     */
+    const bool m_huge_pages;
+
+    /**
+     * Alignment of the chunks.
+     */
+    const size_t m_chunk_align_bytes;
+
     /**
      * Contains all allocated pools of memory, used to free the data in the destructor.
      */
@@ -158,7 +171,9 @@ class PoolResource final
             PlacementAddToList(m_available_memory_it, m_free_lists[remaining_available_bytes / ELEM_ALIGN_BYTES]);
         }
 
-        void* storage = ::operator new (m_chunk_size_bytes, std::align_val_t{ELEM_ALIGN_BYTES});
+        void* storage = ::operator new (m_chunk_size_bytes, std::align_val_t{m_chunk_align_bytes});
+        // Before the chunk is touched. Without huge pages, it falls back to regular pages.
+        if (m_huge_pages) AdviseHugePages(storage, m_chunk_size_bytes);
         m_available_memory_it = new (storage) std::byte[m_chunk_size_bytes];
         m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
         m_allocated_chunks.emplace_back(m_available_memory_it);
@@ -170,21 +185,30 @@ class PoolResource final
     friend class PoolResourceTester;
 
 public:
+    /**
+     * Default size in bytes of the chunks, 2^18=262144.
+     */
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE_BYTES{262144};
+
     /**
      * Construct a new PoolResource object which allocates the first chunk.
      * chunk_size_bytes will be rounded up to next multiple of ELEM_ALIGN_BYTES.
+     * With huge_pages, chunks are aligned to HUGE_PAGE_SIZE and advised to be
+     * backed by huge pages, which is only useful for chunks of whole huge pages.
      */
-    explicit PoolResource(std::size_t chunk_size_bytes)
-        : m_chunk_size_bytes(NumElemAlignBytes(chunk_size_bytes) * ELEM_ALIGN_BYTES)
+    explicit PoolResource(std::size_t chunk_size_bytes, bool huge_pages = false)
+        : m_chunk_size_bytes(NumElemAlignBytes(chunk_size_bytes) * ELEM_ALIGN_BYTES),
+          m_huge_pages(huge_pages),
+          m_chunk_align_bytes(huge_pages ? std::max(HUGE_PAGE_SIZE, ELEM_ALIGN_BYTES) : ELEM_ALIGN_BYTES)
     {
         assert(m_chunk_size_bytes >= MAX_BLOCK_SIZE_BYTES);
         AllocateChunk();
     }
 
     /**
-     * Construct a new Pool Resource object, defaults to 2^18=262144 chunk size.
+     * Construct a new Pool Resource object with the default chunk size.
      */
-    PoolResource() : PoolResource(262144) {}
+    PoolResource() : PoolResource(DEFAULT_CHUNK_SIZE_BYTES) {}
 
     /**
      * Disable copy & move semantics, these are not supported for the resource.
@@ -201,7 +225,7 @@ public:
     {
         for (std::byte* chunk : m_allocated_chunks) {
             std::destroy(chunk, chunk + m_chunk_size_bytes);
-            ::operator delete ((void*)chunk, std::align_val_t{ELEM_ALIGN_BYTES});
+            ::operator delete ((void*)chunk, std::align_val_t{m_chunk_align_bytes});
         }
     }
 
@@ -0,0 +1,23 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <support/hugepages.h>
+
+#include <cstdint>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+bool AdviseHugePages(void* p, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+    const uintptr_t begin{(reinterpret_cast<uintptr_t>(p) + HUGE_PAGE_SIZE - 1) & ~uintptr_t{HUGE_PAGE_SIZE - 1}};
+    const uintptr_t end{(reinterpret_cast<uintptr_t>(p) + size) & ~uintptr_t{HUGE_PAGE_SIZE - 1}};
+    if (end <= begin) return false;
+    return madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
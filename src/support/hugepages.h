@@ -0,0 +1,22 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_HUGEPAGES_H
+#define BITCOIN_SUPPORT_HUGEPAGES_H
+
+#include <cstddef>
+
+/** Size of the transparent huge pages of x86_64 and most arm64 kernels. */
+static constexpr size_t HUGE_PAGE_SIZE{2 << 20};
+
+/**
+ * Advise the kernel to back the whole huge pages within [p, p + size) with
+ * transparent huge pages (MADV_HUGEPAGE), which spares TLB misses on random
+ * accesses to large tables. To take effect right away, the memory must not
+ * have been touched yet. Returns false if the advice failed or is not
+ * supported on this platform, in which case regular pages are used.
+ */
+bool AdviseHugePages(void* p, size_t size);
+
+#endif // BITCOIN_SUPPORT_HUGEPAGES_H
@@ -9,11 +9,15 @@
 #include <util/strencodings.h>
 #include <util/threadnames.h>
 
+#include <algorithm>
+#include <bit>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <system_error>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -320,3 +324,113 @@ bool LockStackEmpty()
 bool g_debug_lockorder_abort = true;
 
 #endif /* DEBUG_LOCKORDER */
+
+thread_local LockWaitTracker* g_lock_wait_tracker{nullptr};
+
+std::atomic<bool> g_lock_stats_enabled{DEFAULT_LOCKSTATS};
+
+namespace {
+size_t HistogramBucket(std::chrono::nanoseconds duration)
+{
+    const auto micros{std::chrono::duration_cast<std::chrono::microseconds>(duration).count()};
+    if (micros <= 0) return 0;
+    return std::min<size_t>(std::bit_width(static_cast<uint64_t>(micros)), LockSiteStats::HISTOGRAM_BUCKETS - 1);
+}
+
+void Record(std::atomic<uint64_t>& total, std::atomic<uint64_t>& max, LockSiteStats::Histogram& histogram, std::chrono::nanoseconds duration)
+{
+    const uint64_t nanos{static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0))};
+    total.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t prev_max{max.load(std::memory_order_relaxed)};
+    while (prev_max < nanos && !max.compare_exchange_weak(prev_max, nanos, std::memory_order_relaxed)) {}
+    histogram[HistogramBucket(duration)].fetch_add(1, std::memory_order_relaxed);
+}
+
+struct LockSiteKey {
+    const char* name;
+    const char* file;
+    int line;
+    bool operator==(const LockSiteKey&) const = default;
+};
+
+struct LockSiteKeyHasher {
+    size_t operator()(const LockSiteKey& key) const
+    {
+        return std::hash<const void*>{}(key.file) ^ (std::hash<const void*>{}(key.name) << 1) ^ (static_cast<size_t>(key.line) << 16);
+    }
+};
+
+//! All acquisition sites, by name, file and line. The same site can be seen
+//! with different string pointers, e.g. from an inline function in a header
+//! used by several translation units, so the strings are compared.
+struct LockSiteRegistry {
+    std::mutex mutex;
+    std::map<std::tuple<std::string_view, std::string_view, int>, std::unique_ptr<LockSiteStats>> sites;
+};
+
+LockSiteRegistry& GetLockSiteRegistry()
+{
+    // Leaked like the logger, so that threads still running at exit can use it.
+    static LockSiteRegistry* registry{new LockSiteRegistry()};
+    return *registry;
+}
+} // namespace
+
+void LockSiteStats::RecordAcquired(bool was_contended, std::chrono::nanoseconds waited)
+{
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (was_contended) contended.fetch_add(1, std::memory_order_relaxed);
+    Record(wait_ns, max_wait_ns, wait_histogram, waited);
+}
+
+void LockSiteStats::RecordReleased(std::chrono::nanoseconds held)
+{
+    Record(hold_ns, max_hold_ns, hold_histogram, held);
+}
+
+void LockSiteStats::Reset()
+{
+    for (auto* counter : {&acquisitions, &contended, &wait_ns, &hold_ns, &max_wait_ns, &max_hold_ns}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto* histogram : {&wait_histogram, &hold_histogram}) {
+        for (auto& bucket : *histogram) bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LockSiteStats& GetLockSiteStats(const char* name, const char* file, int line)
+{
+    // Look sites up by pointer in a per-thread cache first, so that profiling
+    // does not serialize all lock acquisitions on the registry mutex.
+    thread_local std::unordered_map<LockSiteKey, LockSiteStats*, LockSiteKeyHasher> cache;
+    const LockSiteKey key{name, file, line};
+    if (const auto it{cache.find(key)}; it != cache.end()) return *it->second;
+
+    auto& registry{GetLockSiteRegistry()};
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it{registry.sites.find({name, file, line})};
+    if (it == registry.sites.end()) {
+        auto stats{std::make_unique<LockSiteStats>(name, file, line)};
+        // Key the entry by the strings it owns.
+        it = registry.sites.emplace(std::tuple<std::string_view, std::string_view, int>{stats->name, stats->file, line}, std::move(stats)).first;
+    }
+    cache.emplace(key, it->second.get());
+    return *it->second;
+}
+
+std::vector<const LockSiteStats*> GetAllLockSiteStats()
+{
+    auto& registry{GetLockSiteRegistry()};
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<const LockSiteStats*> result;
+    result.reserve(registry.sites.size());
+    for (const auto& [_, stats] : registry.sites) result.push_back(stats.get());
+    return result;
+}
+
+void ResetLockSiteStats()
+{
+    auto& registry{GetLockSiteRegistry()};
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& [_, stats] : registry.sites) stats->Reset();
+}
@@ -14,11 +14,17 @@
 #include <threadsafety.h> // IWYU pragma: export
 #include <util/macros.h>
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////
 //                                            //
@@ -140,6 +146,80 @@ using Mutex = AnnotatedMixin<std::mutex>;
  */
 class GlobalMutex : public Mutex { };
 
+struct LockWaitTracker;
+/** The lock wait tracker of the current thread, if any. */
+extern thread_local LockWaitTracker* g_lock_wait_tracker;
+
+/**
+ * Accumulates the time the current thread spends blocked on acquiring one
+ * particular mutex, for as long as the tracker exists.
+ */
+struct LockWaitTracker {
+    template <typename PARENT>
+    explicit LockWaitTracker(const AnnotatedMixin<PARENT>& cs) : mutex{static_cast<const PARENT*>(&cs)}, m_prev{g_lock_wait_tracker}
+    {
+        g_lock_wait_tracker = this;
+    }
+    ~LockWaitTracker() { g_lock_wait_tracker = m_prev; }
+
+    LockWaitTracker(const LockWaitTracker&) = delete;
+    LockWaitTracker& operator=(const LockWaitTracker&) = delete;
+
+    const void* const mutex;
+    std::chrono::nanoseconds waited{0};
+
+private:
+    LockWaitTracker* const m_prev;
+};
+
+static constexpr bool DEFAULT_LOCKSTATS{false};
+
+/** Whether UniqueLock records wait and hold times in LockSiteStats (-lockstats). */
+extern std::atomic<bool> g_lock_stats_enabled;
+
+/**
+ * Wait and hold time statistics of the locks taken at one source location.
+ * Only updated while g_lock_stats_enabled is set.
+ *
+ * Hold times of locks waited on with a condition variable include the time
+ * spent waiting, as the mutex is released behind the lock's back.
+ */
+struct LockSiteStats {
+    //! Number of histogram buckets. Bucket 0 counts durations below 1µs and
+    //! bucket i those in [2^(i-1), 2^i) µs, the last bucket being unbounded.
+    static constexpr size_t HISTOGRAM_BUCKETS{26};
+    using Histogram = std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS>;
+
+    LockSiteStats(std::string name_in, std::string file_in, int line_in)
+        : name{std::move(name_in)}, file{std::move(file_in)}, line{line_in} {}
+
+    //! Lock expression, as written at the acquisition site.
+    const std::string name;
+    const std::string file;
+    const int line;
+
+    std::atomic<uint64_t> acquisitions{0};
+    //! Acquisitions that had to wait for another thread to release the lock.
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> wait_ns{0};
+    std::atomic<uint64_t> hold_ns{0};
+    std::atomic<uint64_t> max_wait_ns{0};
+    std::atomic<uint64_t> max_hold_ns{0};
+    Histogram wait_histogram{};
+    Histogram hold_histogram{};
+
+    void RecordAcquired(bool was_contended, std::chrono::nanoseconds waited);
+    void RecordReleased(std::chrono::nanoseconds held);
+    void Reset();
+};
+
+/** Return the statistics of the given acquisition site, creating them if needed. */
+LockSiteStats& GetLockSiteStats(const char* name, const char* file, int line);
+/** Return the statistics of all acquisition sites seen so far. */
+std::vector<const LockSiteStats*> GetAllLockSiteStats();
+/** Zero the statistics of all acquisition sites. */
+void ResetLockSiteStats();
+
 #define AssertLockHeld(cs) AssertLockHeldInternal(#cs, __FILE__, __LINE__, &cs)
 
 inline void AssertLockNotHeldInline(const char* name, const char* file, int line, Mutex* cs) EXCLUSIVE_LOCKS_REQUIRED(!cs) { AssertLockNotHeldInternal(name, file, line, cs); }
@@ -154,9 +234,36 @@ class SCOPED_LOCKABLE UniqueLock : public MutexType::unique_lock
 private:
     using Base = typename MutexType::unique_lock;
 
+    //! Statistics of the acquisition site while profiling, see g_lock_stats_enabled.
+    LockSiteStats* m_stats{nullptr};
+    std::chrono::steady_clock::time_point m_acquired;
+
     void Enter(const char* pszName, const char* pszFile, int nLine)
     {
         EnterCritical(pszName, pszFile, nLine, Base::mutex());
+        if (g_lock_stats_enabled.load(std::memory_order_relaxed)) {
+            m_stats = &GetLockSiteStats(pszName, pszFile, nLine);
+            if (Base::try_lock()) {
+                m_acquired = std::chrono::steady_clock::now();
+                m_stats->RecordAcquired(/*was_contended=*/false, {});
+                return;
+            }
+            const auto start{std::chrono::steady_clock::now()};
+            Base::lock();
+            m_acquired = std::chrono::steady_clock::now();
+            m_stats->RecordAcquired(/*was_contended=*/true, m_acquired - start);
+            if (g_lock_wait_tracker && g_lock_wait_tracker->mutex == Base::mutex()) {
+                g_lock_wait_tracker->waited += m_acquired - start;
+            }
+            return;
+        }
+        if (g_lock_wait_tracker && g_lock_wait_tracker->mutex == Base::mutex()) {
+            if (Base::try_lock()) return;
+            const auto start{std::chrono::steady_clock::now()};
+            Base::lock();
+            g_lock_wait_tracker->waited += std::chrono::steady_clock::now() - start;
+            return;
+        }
 #ifdef DEBUG_LOCKCONTENTION
         if (Base::try_lock()) return;
         LOG_TIME_MICROS_WITH_CATEGORY(strprintf("lock contention %s, %s:%d", pszName, pszFile, nLine), BCLog::LOCK);
@@ -168,12 +275,22 @@ private:
     {
         EnterCritical(pszName, pszFile, nLine, Base::mutex(), true);
         if (Base::try_lock()) {
+            if (g_lock_stats_enabled.load(std::memory_order_relaxed)) {
+                m_stats = &GetLockSiteStats(pszName, pszFile, nLine);
+                m_acquired = std::chrono::steady_clock::now();
+                m_stats->RecordAcquired(/*was_contended=*/false, {});
+            }
             return true;
         }
         LeaveCritical();
         return false;
     }
 
+    void RecordReleased()
+    {
+        if (m_stats) m_stats->RecordReleased(std::chrono::steady_clock::now() - m_acquired);
+    }
+
 public:
     UniqueLock(MutexType& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) EXCLUSIVE_LOCK_FUNCTION(mutexIn) : Base(mutexIn, std::defer_lock)
     {
@@ -196,8 +313,10 @@ public:
 
     ~UniqueLock() UNLOCK_FUNCTION()
     {
-        if (Base::owns_lock())
+        if (Base::owns_lock()) {
+            RecordReleased();
             LeaveCritical();
+        }
     }
 
     operator bool()
@@ -220,6 +339,7 @@ public:
             assert(std::addressof(mutex) == lock.mutex());
 
             CheckLastCritical((void*)lock.mutex(), lockname, _guardname, _file, _line);
+            lock.RecordReleased();
             lock.unlock();
             LeaveCritical();
             lock.swap(templock);
@@ -229,6 +349,7 @@ public:
             templock.swap(lock);
             EnterCritical(lockname.c_str(), file.c_str(), line, lock.mutex());
             lock.lock();
+            lock.m_acquired = std::chrono::steady_clock::now();
         }
 
      private:
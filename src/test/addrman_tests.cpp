@@ -722,6 +722,36 @@ BOOST_AUTO_TEST_CASE(caddrinfo_get_new_bucket)
     BOOST_CHECK(buckets.size() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(asmap_decoded_lookup)
+{
+    const std::vector<bool> asmap = FromBytes(test::data::asmap);
+    const auto decoded{DecodedAsmap::Decode(asmap)};
+    BOOST_REQUIRE(decoded);
+    NetGroupManager ngm_asmap{asmap};
+    BOOST_CHECK_EQUAL(ngm_asmap.GetMappedAS(ResolveIP("250.1.1.1")), 1000U);
+    BOOST_CHECK_EQUAL(ngm_asmap.GetMappedAS(ResolveIP("101.3.1.1")), 3U);
+    BOOST_CHECK_EQUAL(ngm_asmap.GetMappedAS(ResolveIP("102.1.1.1")), 0U);
+
+    // The decoded asmap gives the same ASNs as the interpreter, for IPv4
+    // addresses around the mapped prefixes and for random IPv6 addresses.
+    FastRandomContext rng{/*fDeterministic=*/true};
+    for (int i = 0; i < 2000; ++i) {
+        std::array<uint8_t, 16> ip;
+        std::copy(IPV4_IN_IPV6_PREFIX.begin(), IPV4_IN_IPV6_PREFIX.end(), ip.begin());
+        ip[12] = i % 2 ? 250 : 100 + rng.randrange(3);
+        for (int j = 13; j < 16; ++j) ip[j] = j == 13 ? rng.randrange(10) : rng.rand32();
+        if (i % 10 == 0) rng.fillrand(std::as_writable_bytes(std::span{ip}));
+        std::vector<bool> ip_bits;
+        for (const uint8_t byte : ip) {
+            for (int bit = 7; bit >= 0; --bit) ip_bits.push_back((byte >> bit) & 1);
+        }
+        BOOST_CHECK_EQUAL(decoded->Lookup(ip), Interpret(asmap, ip_bits));
+    }
+
+    BOOST_CHECK(!DecodedAsmap::Decode({}));
+    BOOST_CHECK(!DecodedAsmap::Decode(std::vector<bool>(asmap.begin(), asmap.end() - 8)));
+}
+
 BOOST_AUTO_TEST_CASE(addrman_serialization)
 {
     std::vector<bool> asmap1 = FromBytes(test::data::asmap);
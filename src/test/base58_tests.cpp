@@ -76,6 +76,16 @@ BOOST_AUTO_TEST_CASE(base58_DecodeBase58)
     constexpr auto expected{"971a55"_hex_u8};
     BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
 
+    // max_ret_len bounds the decoded size, leading zeroes included, at any length.
+    for (int size{0}; size < 100; ++size) {
+        auto data{m_rng.randbytes(size)};
+        if (size > 0 && m_rng.randbool()) data[0] = 0;
+        const std::string encoded{EncodeBase58(data)};
+        BOOST_CHECK(DecodeBase58(encoded, result, size));
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), data.begin(), data.end());
+        if (size > 0) BOOST_CHECK(!DecodeBase58(encoded, result, size - 1));
+    }
+
     BOOST_CHECK( DecodeBase58Check("3vQB7B6MrGQZaxCuFg4oh"s, result, 100));
     BOOST_CHECK(!DecodeBase58Check("3vQB7B6MrGQZaxCuFg4oi"s, result, 100));
     BOOST_CHECK(!DecodeBase58Check("3vQB7B6MrGQZaxCuFg4oh0IOl"s, result, 100));
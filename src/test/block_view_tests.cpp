@@ -0,0 +1,135 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <primitives/block_view.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <ios>
+#include <span>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(block_view_tests, BasicTestingSetup)
+
+static CScript RandomScript(FastRandomContext& rng, size_t max_size)
+{
+    const auto bytes{rng.randbytes(rng.randrange(max_size))};
+    return CScript(bytes.begin(), bytes.end());
+}
+
+static CBlock RandomBlock(FastRandomContext& rng)
+{
+    CBlock block;
+    block.nVersion = rng.rand32();
+    block.hashPrevBlock = rng.rand256();
+    block.hashMerkleRoot = rng.rand256();
+    block.nTime = rng.rand32();
+    block.nBits = rng.rand32();
+    block.nNonce = rng.rand32();
+    for (int i{0}; i < 20; ++i) {
+        CMutableTransaction mtx;
+        mtx.version = rng.rand32();
+        mtx.nLockTime = rng.rand32();
+        const bool witness{i == 0 || rng.randbool()};
+        mtx.vin.resize(1 + rng.randrange(4));
+        for (CTxIn& txin : mtx.vin) {
+            txin.prevout = {Txid::FromUint256(rng.rand256()), rng.rand32()};
+            txin.scriptSig = RandomScript(rng, 300);
+            txin.nSequence = rng.rand32();
+            if (witness) {
+                txin.scriptWitness.stack.resize(rng.randrange(4));
+                for (auto& item : txin.scriptWitness.stack) item = rng.randbytes(rng.randrange(100));
+            }
+        }
+        if (witness) mtx.vin[0].scriptWitness.stack.push_back(rng.randbytes(1));
+        mtx.vout.resize(rng.randrange(300));
+        for (CTxOut& txout : mtx.vout) {
+            txout.nValue = rng.randrange(MAX_MONEY);
+            txout.scriptPubKey = RandomScript(rng, 40);
+        }
+        block.vtx.push_back(MakeTransactionRef(mtx));
+    }
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(block_view_fields)
+{
+    for (int i{0}; i < 10; ++i) {
+        const CBlock block{RandomBlock(m_rng)};
+        DataStream stream;
+        stream << TX_WITH_WITNESS(block);
+        const std::span<const std::byte> data{stream};
+        const BlockView view{data};
+
+        BOOST_CHECK_EQUAL(view.Header().GetHash(), block.GetHash());
+        BOOST_CHECK_EQUAL(view.Prefix().size(), 80U + GetSizeOfCompactSize(block.vtx.size()));
+        BOOST_REQUIRE_EQUAL(view.Transactions().size(), block.vtx.size());
+        size_t total_size{view.Prefix().size()};
+        for (size_t j{0}; j < block.vtx.size(); ++j) {
+            const CTransaction& tx{*block.vtx[j]};
+            const TxView& tx_view{view.Transactions()[j]};
+            total_size += tx_view.Data().size();
+            BOOST_CHECK_EQUAL(tx_view.Data().size(), tx.GetTotalSize());
+            BOOST_CHECK_EQUAL(tx_view.HasWitness(), tx.HasWitness());
+            BOOST_CHECK_EQUAL(tx_view.GetHash(), tx.GetHash());
+            BOOST_CHECK_EQUAL(tx_view.GetWitnessHash(), tx.GetWitnessHash());
+            BOOST_CHECK_EQUAL(tx_view.Version(), tx.version);
+            BOOST_CHECK_EQUAL(tx_view.LockTime(), tx.nLockTime);
+            BOOST_REQUIRE_EQUAL(tx_view.NumInputs(), tx.vin.size());
+            BOOST_REQUIRE_EQUAL(tx_view.NumOutputs(), tx.vout.size());
+
+            size_t input{0};
+            tx_view.ForEachInput([&](const COutPoint& prevout, std::span<const unsigned char> script_sig, uint32_t sequence) {
+                const CTxIn& txin{tx.vin[input++]};
+                BOOST_CHECK(prevout == txin.prevout);
+                BOOST_CHECK(CScript(script_sig.begin(), script_sig.end()) == txin.scriptSig);
+                BOOST_CHECK_EQUAL(sequence, txin.nSequence);
+            });
+            BOOST_CHECK_EQUAL(input, tx.vin.size());
+            size_t output{0};
+            tx_view.ForEachOutput([&](CAmount value, std::span<const unsigned char> script_pubkey) {
+                const CTxOut& txout{tx.vout[output++]};
+                BOOST_CHECK_EQUAL(value, txout.nValue);
+                BOOST_CHECK(CScript(script_pubkey.begin(), script_pubkey.end()) == txout.scriptPubKey);
+            });
+            BOOST_CHECK_EQUAL(output, tx.vout.size());
+
+            DataStream no_witness;
+            for (const auto part : tx_view.NoWitnessParts()) no_witness.write(part);
+            BOOST_CHECK_EQUAL(no_witness.size(), GetSerializeSize(TX_NO_WITNESS(tx)));
+        }
+        BOOST_CHECK_EQUAL(total_size, data.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(block_view_malformed)
+{
+    const CBlock block{RandomBlock(m_rng)};
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+    std::vector<std::byte> data{stream.begin(), stream.end()};
+
+    // Every truncation of the block is rejected, like when deserializing it.
+    for (size_t size{0}; size < data.size(); size += 1 + m_rng.randrange(100)) {
+        BOOST_CHECK_THROW(BlockView{std::span{data}.first(size)}, std::ios_base::failure);
+    }
+
+    // As are unknown transaction flags, after the version and the marker.
+    const size_t tx_begin{80 + GetSizeOfCompactSize(block.vtx.size())};
+    std::vector<std::byte> tx_data{data.begin() + tx_begin, data.end()};
+    std::span<const std::byte> tx_span{tx_data};
+    BOOST_REQUIRE(TxView{tx_span}.HasWitness());
+    tx_data[5] = std::byte{3};
+    std::span<const std::byte> bad_span{tx_data};
+    BOOST_CHECK_THROW(TxView{bad_span}, std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
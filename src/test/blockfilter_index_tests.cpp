@@ -260,6 +260,10 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     assert(tip->nHeight >= 0);
     BOOST_CHECK_EQUAL(filters.size(), tip->nHeight + 1U);
     BOOST_CHECK_EQUAL(filter_hashes.size(), tip->nHeight + 1U);
+    for (int height = 0; height <= tip->nHeight; ++height) {
+        BOOST_CHECK_EQUAL(filters[height].GetBlockHash(), tip->GetAncestor(height)->GetBlockHash());
+        BOOST_CHECK_EQUAL(filters[height].GetHash(), filter_hashes[height]);
+    }
 
     filters.clear();
     filter_hashes.clear();
@@ -268,6 +272,30 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_sync, BuildChainTestingSetup)
+{
+    // Blocks are read and filters built out of order by the workers, but the
+    // filter header chain must come out the same as with a sequential sync.
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    filter_index.SetSyncThreads(4);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+    BOOST_CHECK(filter_index.BlockUntilSyncedToCurrentChain());
+
+    {
+        LOCK(cs_main);
+        uint256 last_header;
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+        }
+    }
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
@@ -5,6 +5,9 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <undo.h>
+#include <node/blockdatacache.h>
+#include <node/blockreadahead.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
@@ -17,10 +20,17 @@
 #include <test/util/logging.h>
 #include <test/util/setup_common.h>
 
+#include <fstream>
+#include <memory>
+
 using node::STORAGE_HEADER_BYTES;
+using node::BlockReadAhead;
+using node::BlockDataCache;
 using node::BlockManager;
 using node::KernelNotifications;
 using node::MAX_BLOCKFILE_SIZE;
+using node::ScannedBlock;
+using node::StripBlockWitness;
 
 // use BasicTestingSetup here for the data directory configuration, setup, and cleanup
 BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, BasicTestingSetup)
@@ -137,6 +147,203 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_availability, TestChain100Setup)
     BOOST_CHECK(!blockman.CheckBlockDataAvailability(tip, *last_pruned_block));
 }
 
+BOOST_FIXTURE_TEST_CASE(blockmanager_block_read_ahead, TestChain100Setup)
+{
+    BlockManager& blockman{m_node.chainman->m_blockman};
+    BlockReadAhead read_ahead{blockman, /*window=*/4, /*num_threads=*/2};
+
+    std::vector<const CBlockIndex*> upcoming;
+    {
+        LOCK(::cs_main);
+        const CChain& chain{m_node.chainman->ActiveChain()};
+        for (int height = 10; height < 20; ++height) upcoming.push_back(chain[height]);
+        read_ahead.Schedule(upcoming);
+    }
+    // Only the first `window` blocks are read ahead.
+    BOOST_CHECK_EQUAL(read_ahead.Size(), 4U);
+
+    // Blocks are returned once, with the expected contents.
+    for (int i = 0; i < 2; ++i) {
+        const auto block{read_ahead.Take(*upcoming[i])};
+        BOOST_REQUIRE(block);
+        BOOST_CHECK_EQUAL(block->GetHash(), upcoming[i]->GetBlockHash());
+        BOOST_CHECK(!read_ahead.Take(*upcoming[i]));
+    }
+    BOOST_CHECK_EQUAL(read_ahead.Size(), 2U);
+
+    // Blocks that are no longer scheduled are dropped, new ones are read.
+    WITH_LOCK(::cs_main, read_ahead.Schedule(std::span{upcoming}.subspan(6)));
+    BOOST_CHECK_EQUAL(read_ahead.Size(), 4U);
+    BOOST_CHECK(!read_ahead.Take(*upcoming[2]));
+    const auto block{read_ahead.Take(*upcoming[6])};
+    BOOST_REQUIRE(block);
+    BOOST_CHECK_EQUAL(block->GetHash(), upcoming[6]->GetBlockHash());
+    BOOST_CHECK_EQUAL(read_ahead.GetHits(), 3U);
+    BOOST_CHECK_EQUAL(read_ahead.GetMisses(), 3U);
+
+    // Blocks about to be disconnected are read with their undo data.
+    WITH_LOCK(::cs_main, read_ahead.Schedule(std::span{upcoming}.subspan(7), /*with_undo=*/true));
+    std::shared_ptr<CBlockUndo> undo;
+    const auto disconnected{read_ahead.Take(*upcoming[7], &undo)};
+    BOOST_REQUIRE(disconnected && undo);
+    CBlockUndo expected_undo;
+    BOOST_REQUIRE(blockman.ReadBlockUndo(expected_undo, *upcoming[7]));
+    BOOST_CHECK_EQUAL(undo->vtxundo.size(), expected_undo.vtxundo.size());
+    BOOST_CHECK_EQUAL(undo->vtxundo.size() + 1, disconnected->vtx.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_scan_block_file, TestChain100Setup)
+{
+    const BlockManager& blockman{m_node.chainman->m_blockman};
+    const auto scanned{blockman.ScanBlockFile(0)};
+    BOOST_REQUIRE(scanned);
+    // The genesis block and the 100 mined blocks, in the order they were written.
+    BOOST_REQUIRE_EQUAL(scanned->size(), 101U);
+    LOCK(::cs_main);
+    const CChain& chain{m_node.chainman->ActiveChain()};
+    for (int height = 0; height <= 100; ++height) {
+        const ScannedBlock& block{(*scanned)[height]};
+        BOOST_CHECK_EQUAL(block.hash, chain[height]->GetBlockHash());
+        BOOST_CHECK_EQUAL(block.prev_hash, height > 0 ? chain[height - 1]->GetBlockHash() : uint256{});
+        BOOST_CHECK(block.pos == chain[height]->GetBlockPos());
+    }
+    BOOST_CHECK(!blockman.ScanBlockFile(1));
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_raw_block, TestChain100Setup)
+{
+    const BlockManager& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    CBlock block;
+    BOOST_REQUIRE(blockman.ReadBlock(block, *tip));
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return tip->GetBlockPos())};
+
+    // Both overloads return the block in network serialization.
+    DataStream expected{};
+    expected << TX_WITH_WITNESS(block);
+    std::vector<std::byte> raw;
+    BOOST_REQUIRE(blockman.ReadRawBlock(raw, pos));
+    BOOST_CHECK(std::ranges::equal(raw, std::span{expected}));
+    std::vector<unsigned char> payload;
+    BOOST_REQUIRE(blockman.ReadRawBlock(payload, pos));
+    BOOST_CHECK(std::ranges::equal(MakeByteSpan(payload), std::span{expected}));
+}
+
+BOOST_AUTO_TEST_CASE(block_data_cache_eviction)
+{
+    BlockDataCache<int> cache{/*max_bytes=*/10};
+    cache.Put({0, 1}, std::make_shared<const int>(1), 4);
+    cache.Put({0, 2}, std::make_shared<const int>(2), 4);
+    BOOST_CHECK_EQUAL(*cache.Get({0, 1}), 1);
+    // The least recently used entry is evicted to make room.
+    cache.Put({1, 1}, std::make_shared<const int>(3), 4);
+    BOOST_CHECK(!cache.Get({0, 2}));
+    BOOST_CHECK_EQUAL(*cache.Get({1, 1}), 3);
+    // Entries larger than the cache are not added.
+    cache.Put({1, 2}, std::make_shared<const int>(4), 11);
+    BOOST_CHECK(!cache.Get({1, 2}));
+
+    cache.EraseFiles({1});
+    BOOST_CHECK(!cache.Get({1, 1}));
+    const auto stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.hits, 2U);
+    BOOST_CHECK_EQUAL(stats.misses, 3U);
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.bytes, 4U);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_cache, TestChain100Setup)
+{
+    const BlockManager& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return tip->GetBlockPos())};
+    const auto blocks_before{blockman.GetRawBlockCacheStats()};
+    const auto undo_before{blockman.GetBlockUndoCacheStats()};
+
+    // Reading a block to deserialize it uses the cache, but does not fill it.
+    CBlock block;
+    BOOST_REQUIRE(blockman.ReadBlock(block, *tip));
+    std::vector<std::byte> first, second;
+    BOOST_REQUIRE(blockman.ReadRawBlock(first, pos));
+    BOOST_REQUIRE(blockman.ReadRawBlock(second, pos));
+    BOOST_CHECK(first == second);
+    BOOST_REQUIRE(blockman.ReadBlock(block, *tip));
+    BOOST_CHECK_EQUAL(block.GetHash(), tip->GetBlockHash());
+    const auto blocks_after{blockman.GetRawBlockCacheStats()};
+    BOOST_CHECK_EQUAL(blocks_after.misses - blocks_before.misses, 2U);
+    BOOST_CHECK_EQUAL(blocks_after.hits - blocks_before.hits, 2U);
+    BOOST_CHECK_EQUAL(blocks_after.bytes - blocks_before.bytes, first.size());
+
+    CBlockUndo first_undo, second_undo;
+    BOOST_REQUIRE(blockman.ReadBlockUndo(first_undo, *tip));
+    BOOST_REQUIRE(blockman.ReadBlockUndo(second_undo, *tip));
+    BOOST_CHECK_EQUAL(first_undo.vtxundo.size(), second_undo.vtxundo.size());
+    const auto undo_after{blockman.GetBlockUndoCacheStats()};
+    BOOST_CHECK_EQUAL(undo_after.misses - undo_before.misses, 1U);
+    BOOST_CHECK_EQUAL(undo_after.hits - undo_before.hits, 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_block_no_witness, TestChain100Setup)
+{
+    const BlockManager& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return tip->GetBlockPos())};
+    CBlock block;
+    BOOST_REQUIRE(blockman.ReadBlock(block, *tip));
+    BOOST_REQUIRE(block.vtx[0]->HasWitness());
+    const auto before{blockman.GetNoWitnessBlockCacheStats()};
+
+    std::vector<unsigned char> expected;
+    VectorWriter{expected, 0, TX_NO_WITNESS(block)};
+    std::vector<unsigned char> first, second;
+    BOOST_REQUIRE(blockman.ReadRawBlockNoWitness(first, pos));
+    BOOST_REQUIRE(blockman.ReadRawBlockNoWitness(second, pos));
+    BOOST_CHECK(first == expected);
+    BOOST_CHECK(second == expected);
+    const auto after{blockman.GetNoWitnessBlockCacheStats()};
+    BOOST_CHECK_EQUAL(after.misses - before.misses, 1U);
+    BOOST_CHECK_EQUAL(after.hits - before.hits, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_strip_block_witness)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.nBits = 0x207fffff;
+    CMutableTransaction witness_tx;
+    witness_tx.vin.resize(2);
+    witness_tx.vin[0].prevout = {Txid::FromUint256(uint256::ONE), 1};
+    witness_tx.vin[0].scriptSig = CScript() << OP_1;
+    witness_tx.vin[0].scriptWitness.stack = {{1, 2, 3}, {}};
+    witness_tx.vin[1].scriptWitness.stack = {std::vector<unsigned char>(300, 4)};
+    witness_tx.vout.emplace_back(1, CScript() << OP_TRUE);
+    witness_tx.nLockTime = 17;
+    CMutableTransaction legacy_tx{witness_tx};
+    for (auto& txin : legacy_tx.vin) txin.scriptWitness.SetNull();
+    legacy_tx.vout.resize(300, CTxOut{2, CScript() << OP_2});
+    block.vtx = {MakeTransactionRef(witness_tx), MakeTransactionRef(legacy_tx), MakeTransactionRef(witness_tx)};
+
+    DataStream with_witness, without_witness;
+    with_witness << TX_WITH_WITNESS(block);
+    without_witness << TX_NO_WITNESS(block);
+    std::vector<std::byte> serialized{with_witness.begin(), with_witness.end()};
+    const std::vector<std::byte> expected{without_witness.begin(), without_witness.end()};
+    std::vector<std::byte> stripped;
+    BOOST_REQUIRE(StripBlockWitness(serialized, stripped));
+    BOOST_CHECK(stripped == expected);
+    // Without witness data the block is copied as is.
+    BOOST_REQUIRE(StripBlockWitness(expected, stripped));
+    BOOST_CHECK(stripped == expected);
+
+    // Truncated blocks are not well formed.
+    for (size_t size : {size_t{0}, size_t{79}, size_t{81}, serialized.size() / 2, serialized.size() - 1}) {
+        BOOST_CHECK(!StripBlockWitness(std::span{serialized}.first(size), stripped));
+    }
+    // Nor are unknown flags.
+    serialized[80 + 1 + 5] = std::byte{3};
+    BOOST_CHECK(!StripBlockWitness(serialized, stripped));
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
 {
     CBlockIndex* fake_index{WITH_LOCK(m_node.chainman->GetMutex(), return m_node.chainman->ActiveChain().Tip())};
@@ -216,4 +423,85 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_unlink_in_background)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    auto blockman{std::make_unique<BlockManager>(*Assert(m_node.shutdown_signal), blockman_opts)};
+    const auto path{[&](const char* prefix, int file) { return m_args.GetBlocksDirPath() / fs::u8path(strprintf("%s%05u.dat", prefix, file)); }};
+    for (const int file : {0, 1}) {
+        std::ofstream{path("blk", file)} << "data";
+        std::ofstream{path("rev", file)} << "data";
+    }
+
+    blockman->UnlinkPrunedFilesInBackground({0});
+    blockman->WaitForPrunedFilesUnlinked();
+    BOOST_CHECK(!fs::exists(path("blk", 0)));
+    BOOST_CHECK(!fs::exists(path("rev", 0)));
+    BOOST_CHECK(fs::exists(path("blk", 1)));
+
+    // Files queued before the block manager is destroyed are still unlinked.
+    blockman->UnlinkPrunedFilesInBackground({1});
+    blockman.reset();
+    BOOST_CHECK(!fs::exists(path("blk", 1)));
+    BOOST_CHECK(!fs::exists(path("rev", 1)));
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_move_to_cold_dir)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const fs::path cold_dir{m_args.GetDataDirNet() / "cold"};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        // Small block files, so that the blocks below span several.
+        .fast_prune = true,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .cold_blocks_dir = cold_dir,
+        .cold_blocks_depth = 288,
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+    const CBlock& block{Params().GenesisBlock()};
+    std::vector<FlatFilePos> positions;
+    for (int height{0}; positions.empty() || positions.back().nFile < 2; ++height) {
+        positions.push_back(blockman.WriteBlock(block, height));
+    }
+    const int tip_height{static_cast<int>(positions.size()) - 1};
+    const auto file_name{[](int file) { return fs::u8path(strprintf("blk%05u.dat", file)); }};
+
+    // No file is deep enough yet.
+    blockman.MoveOldFilesToColdDir(tip_height);
+    blockman.WaitForColdFilesMoved();
+    BOOST_CHECK(!fs::exists(cold_dir / file_name(0)));
+
+    // Old files are moved, but not the one being written to.
+    blockman.MoveOldFilesToColdDir(tip_height + 1000);
+    blockman.WaitForColdFilesMoved();
+    for (const int file : {0, 1}) {
+        BOOST_CHECK(!fs::exists(m_args.GetBlocksDirPath() / file_name(file)));
+        BOOST_CHECK(fs::exists(cold_dir / file_name(file)));
+    }
+    BOOST_CHECK(fs::exists(m_args.GetBlocksDirPath() / file_name(2)));
+    BOOST_CHECK(!fs::exists(cold_dir / file_name(2)));
+
+    // Blocks are read from either directory.
+    for (const FlatFilePos& pos : {positions.front(), positions.back()}) {
+        CBlock read_block;
+        BOOST_CHECK(blockman.ReadBlock(read_block, pos, block.GetHash()));
+        BOOST_CHECK_EQUAL(blockman.GetBlockPosFilename(pos), (pos.nFile < 2 ? cold_dir : m_args.GetBlocksDirPath()) / file_name(pos.nFile));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
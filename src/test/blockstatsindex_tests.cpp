@@ -0,0 +1,65 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/blockstatsindex.h>
+#include <interfaces/chain.h>
+#include <node/blockstats.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(blockstatsindex_tests)
+
+static void CheckIndexedStats(const BlockStatsIndex& index, ChainstateManager& chainman, const CBlockIndex& block_index)
+{
+    const auto stats{index.LookUpStats(block_index)};
+    BOOST_REQUIRE(stats);
+    CBlock block;
+    CBlockUndo block_undo;
+    BOOST_REQUIRE(chainman.m_blockman.ReadBlock(block, block_index));
+    if (block_index.nHeight > 0) BOOST_REQUIRE(chainman.m_blockman.ReadBlockUndo(block_undo, block_index));
+    DataStream indexed, computed;
+    indexed << *stats;
+    computed << node::ComputeBlockStats(block, block_undo, block_index);
+    BOOST_CHECK(indexed.str() == computed.str());
+    BOOST_CHECK_EQUAL(stats->txs, int64_t(block.vtx.size()));
+}
+
+BOOST_FIXTURE_TEST_CASE(blockstatsindex_initial_sync, TestChain100Setup)
+{
+    BlockStatsIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_CHECK(!index.LookUpStats(*tip));
+
+    index.Sync();
+
+    for (const CBlockIndex* block_index{tip}; block_index; block_index = block_index->pprev) {
+        CheckIndexedStats(index, *m_node.chainman, *block_index);
+    }
+
+    // A block spending a coinbase has fees and spent outputs.
+    const CScript script_pub_key{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, script_pub_key, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    CreateAndProcessBlock({spend}, script_pub_key);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+
+    tip = WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip());
+    CheckIndexedStats(index, *m_node.chainman, *tip);
+    const auto stats{index.LookUpStats(*tip)};
+    BOOST_REQUIRE(stats);
+    BOOST_CHECK_EQUAL(stats->txs, 2);
+    BOOST_CHECK_EQUAL(stats->ins, 1);
+    BOOST_CHECK_EQUAL(stats->totalfee, 1 * COIN);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,7 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <variant>
@@ -1049,6 +1050,290 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_sync_chunk)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewCache cache{&base};
+    const auto make_coin{[&] { return Coin{CTxOut{m_rng.randrange(1000) + 1, CScript{}}, 1, false}; }};
+
+    const uint256 old_tip{m_rng.rand256()};
+    const COutPoint spent{Txid::FromUint256(m_rng.rand256()), 0};
+    cache.AddCoin(spent, make_coin(), /*possible_overwrite=*/false);
+    cache.SetBestBlock(old_tip);
+    BOOST_REQUIRE(cache.Flush());
+    BOOST_CHECK(!cache.HasFlaggedEntries());
+
+    // Five new coins and one spend of a coin the database has.
+    std::vector<COutPoint> added;
+    for (int i{0}; i < 5; ++i) {
+        added.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+        cache.AddCoin(added.back(), make_coin(), /*possible_overwrite=*/false);
+    }
+    BOOST_CHECK(cache.SpendCoin(spent));
+    const uint256 tip1{m_rng.rand256()};
+    cache.SetBestBlock(tip1);
+
+    size_t written{0};
+    BOOST_REQUIRE(cache.SyncChunk(2, written));
+    BOOST_CHECK_EQUAL(written, 2U);
+    BOOST_CHECK(cache.HasFlaggedEntries());
+    BOOST_CHECK(base.IsPartiallyWritten());
+    BOOST_CHECK(base.GetBestBlock().IsNull());
+    BOOST_CHECK(base.GetHeadBlocks() == std::vector<uint256>({tip1, old_tip}));
+
+    // The tip may move on between chunks, the old tip is kept for replaying.
+    const uint256 tip2{m_rng.rand256()};
+    cache.SetBestBlock(tip2);
+    BOOST_REQUIRE(cache.SyncChunk(2, written));
+    BOOST_CHECK_EQUAL(written, 2U);
+    BOOST_CHECK(base.GetHeadBlocks() == std::vector<uint256>({tip2, old_tip}));
+
+    BOOST_REQUIRE(cache.SyncChunk(10, written));
+    BOOST_CHECK_EQUAL(written, 2U);
+    BOOST_CHECK(!cache.HasFlaggedEntries());
+    BOOST_CHECK(!base.IsPartiallyWritten());
+    BOOST_CHECK(base.GetHeadBlocks().empty());
+    BOOST_CHECK_EQUAL(base.GetBestBlock(), tip2);
+    for (const COutPoint& outpoint : added) {
+        BOOST_CHECK(base.HaveCoin(outpoint));
+        BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    }
+    BOOST_CHECK(!base.HaveCoin(spent));
+    BOOST_CHECK(!cache.HaveCoinInCache(spent));
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_batch_write_pipelined)
+{
+    // Small batches split the flush into many partial writes, committed on a
+    // background thread or synchronously.
+    for (const bool async : {false, true}) {
+        CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {.batch_write_bytes = 1 << 10, .async_batch_write = async}};
+        CCoinsViewCache cache{&base};
+        std::vector<COutPoint> added;
+        for (int i{0}; i < 1000; ++i) {
+            added.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+            cache.AddCoin(added.back(), Coin{CTxOut{i + 1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        }
+        const uint256 tip{m_rng.rand256()};
+        cache.SetBestBlock(tip);
+        BOOST_REQUIRE(cache.Flush());
+        BOOST_CHECK_EQUAL(base.GetBestBlock(), tip);
+        BOOST_CHECK(base.GetHeadBlocks().empty());
+        for (int i{0}; i < 1000; ++i) {
+            const auto coin{base.GetCoin(added[i])};
+            BOOST_REQUIRE(coin);
+            BOOST_CHECK_EQUAL(coin->out.nValue, i + 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_db_bulk_write)
+{
+    // Small batches split each bulk write into many.
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {.batch_write_bytes = 1 << 10, .missing_cache_entries = 4}};
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    for (int i{0}; i < 1000; ++i) {
+        coins.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), uint32_t(i)}, Coin{CTxOut{i + 1, CScript{}}, 1, false});
+    }
+    std::sort(coins.begin(), coins.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    // A coin remembered as missing is found once written.
+    BOOST_CHECK(!base.GetCoin(coins[0].first));
+    base.BulkWrite(std::span{coins}.first(500));
+    base.BulkWrite(std::span{coins}.subspan(500));
+    base.BulkWrite({});
+    BOOST_CHECK(base.GetBestBlock().IsNull());
+    BOOST_CHECK(base.GetHeadBlocks().empty());
+    for (const auto& [outpoint, coin] : coins) {
+        const auto found{base.GetCoin(outpoint)};
+        BOOST_REQUIRE(found);
+        BOOST_CHECK(found->out == coin.out);
+    }
+
+    // The best block is set by flushing a cache on top.
+    CCoinsViewCache cache{&base};
+    const uint256 tip{m_rng.rand256()};
+    cache.SetBestBlock(tip);
+    BOOST_REQUIRE(cache.Flush());
+    BOOST_CHECK_EQUAL(base.GetBestBlock(), tip);
+    BOOST_CHECK(cache.HaveCoin(coins.back().first));
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_db_missing_coins_cache)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {.missing_cache_entries = 4}};
+    const COutPoint missing{Txid::FromUint256(m_rng.rand256()), 0};
+    BOOST_CHECK(!base.GetCoin(missing));
+    BOOST_CHECK_EQUAL(base.GetMissingCoinsStats().entries, 1U);
+    BOOST_CHECK_EQUAL(base.GetMissingCoinsStats().hits, 0U);
+    BOOST_CHECK(!base.HaveCoin(missing));
+    BOOST_CHECK(!base.GetCoin(missing));
+    BOOST_CHECK_EQUAL(base.GetMissingCoinsStats().hits, 2U);
+
+    // Writing the coin makes it visible again.
+    {
+        CCoinsViewCache cache{&base};
+        cache.AddCoin(missing, Coin{CTxOut{7, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        cache.SetBestBlock(m_rng.rand256());
+        BOOST_REQUIRE(cache.Flush());
+    }
+    BOOST_CHECK(base.HaveCoin(missing));
+    BOOST_REQUIRE(base.GetCoin(missing));
+    BOOST_CHECK_EQUAL(base.GetCoin(missing)->out.nValue, 7);
+    BOOST_CHECK_EQUAL(base.GetMissingCoinsStats().entries, 0U);
+
+    // The oldest entries are forgotten to stay within the limit.
+    for (uint32_t n{1}; n <= 10; ++n) {
+        BOOST_CHECK(!base.GetCoin(COutPoint{missing.hash, n}));
+        BOOST_CHECK_LE(base.GetMissingCoinsStats().entries, 4U);
+    }
+    const uint64_t hits{base.GetMissingCoinsStats().hits};
+    BOOST_CHECK(!base.GetCoin(COutPoint{missing.hash, 10}));
+    BOOST_CHECK(!base.GetCoin(COutPoint{missing.hash, 1}));
+    BOOST_CHECK_EQUAL(base.GetMissingCoinsStats().hits, hits + 1);
+
+    CCoinsViewDB disabled{{.path = "test2", .cache_bytes = 1 << 23, .memory_only = true}, {.missing_cache_entries = 0}};
+    BOOST_CHECK(!disabled.GetCoin(missing));
+    BOOST_CHECK(!disabled.GetCoin(missing));
+    BOOST_CHECK_EQUAL(disabled.GetMissingCoinsStats().entries, 0U);
+    BOOST_CHECK_EQUAL(disabled.GetMissingCoinsStats().hits, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_get_coins_batch)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    std::vector<COutPoint> outpoints;
+    {
+        CCoinsViewCache cache{&base};
+        for (int i{0}; i < 50; ++i) {
+            outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), i % 3);
+            cache.AddCoin(outpoints.back(), Coin{CTxOut{i + 1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        }
+        cache.SetBestBlock(m_rng.rand256());
+        BOOST_REQUIRE(cache.Flush());
+    }
+    CCoinsViewCache cache{&base};
+    // Coins that are only in the cache, spent in the cache, cached, missing, and duplicates.
+    outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+    cache.AddCoin(outpoints.back(), Coin{CTxOut{100, CScript{}}, 2, false}, /*possible_overwrite=*/false);
+    BOOST_REQUIRE(cache.SpendCoin(outpoints[0]));
+    BOOST_REQUIRE(cache.GetCoin(outpoints[1]));
+    outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+    outpoints.push_back(outpoints[2]);
+    std::shuffle(outpoints.begin(), outpoints.end(), m_rng);
+
+    for (const CCoinsView* view : {static_cast<const CCoinsView*>(&base), static_cast<const CCoinsView*>(&cache)}) {
+        const auto coins{view->GetCoins(outpoints)};
+        BOOST_REQUIRE_EQUAL(coins.size(), outpoints.size());
+        for (size_t i{0}; i < outpoints.size(); ++i) {
+            const auto expected{view->GetCoin(outpoints[i])};
+            BOOST_REQUIRE_EQUAL(coins[i].has_value(), expected.has_value());
+            if (expected) BOOST_CHECK(coins[i]->out == expected->out);
+        }
+    }
+    BOOST_CHECK(base.GetCoins({}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_db_sharded_cursors)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    std::vector<COutPoint> added;
+    {
+        CCoinsViewCache cache{&base};
+        for (int i{0}; i < 500; ++i) {
+            const Txid txid{Txid::FromUint256(m_rng.rand256())};
+            // Several outputs per transaction, which must end up in the same range.
+            for (uint32_t n{0}; n < 3; ++n) {
+                added.emplace_back(txid, n);
+                cache.AddCoin(added.back(), Coin{CTxOut{i + 1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+            }
+        }
+        cache.SetBestBlock(m_rng.rand256());
+        BOOST_REQUIRE(cache.Flush());
+    }
+    std::sort(added.begin(), added.end());
+
+    for (const size_t count : {1, 3, 16}) {
+        auto cursors{base.Cursors(count)};
+        BOOST_REQUIRE_EQUAL(cursors.size(), count);
+
+        // Coins written after the cursors were created are not visited.
+        CCoinsViewCache cache{&base};
+        const COutPoint later{Txid::FromUint256(m_rng.rand256()), 0};
+        cache.AddCoin(later, Coin{CTxOut{1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        BOOST_REQUIRE(cache.Flush());
+
+        std::vector<COutPoint> visited;
+        for (auto& cursor : cursors) {
+            BOOST_CHECK_EQUAL(cursor->GetBestBlock(), base.GetBestBlock());
+            const size_t range_begin{visited.size()};
+            for (; cursor->Valid(); cursor->Next()) {
+                COutPoint key;
+                Coin coin;
+                BOOST_REQUIRE(cursor->GetKey(key));
+                BOOST_REQUIRE(cursor->GetValue(coin));
+                visited.push_back(key);
+            }
+            // The outputs of a transaction are never split between ranges.
+            if (range_begin > 0 && range_begin < visited.size()) {
+                BOOST_CHECK(visited[range_begin - 1].hash != visited[range_begin].hash);
+            }
+        }
+        // Together the ranges visit every coin once, in order.
+        BOOST_CHECK(visited == added);
+
+        CCoinsViewCache spend{&base};
+        spend.SpendCoin(later);
+        BOOST_REQUIRE(spend.Flush());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_reuse_view)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewCache tip{&base};
+    CCoinsViewCache view{&tip};
+    const auto add_coins{[&] {
+        std::vector<COutPoint> outpoints;
+        for (uint32_t i{0}; i < 100; ++i) {
+            outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+            view.AddCoin(outpoints.back(), Coin{CTxOut{1, CScript{}}, 1, false}, /*possible_overwrite=*/false);
+        }
+        return outpoints;
+    }};
+
+    // Flushing without reallocating keeps the memory, which is reused for the
+    // next changes.
+    const auto first{add_coins()};
+    const uint256 first_block{m_rng.rand256()};
+    view.SetBestBlock(first_block);
+    const size_t usage{view.DynamicMemoryUsage()};
+    BOOST_REQUIRE(view.Flush(/*reallocate_cache=*/false));
+    BOOST_CHECK_EQUAL(view.GetCacheSize(), 0U);
+    BOOST_CHECK_EQUAL(view.DynamicMemoryUsage(), usage);
+    BOOST_CHECK_EQUAL(tip.GetBestBlock(), first_block);
+    for (const auto& outpoint : first) BOOST_CHECK(tip.HaveCoinInCache(outpoint));
+    const auto second{add_coins()};
+    BOOST_CHECK_EQUAL(view.DynamicMemoryUsage(), usage);
+
+    // Resetting discards the changes and follows the best block of the base.
+    BOOST_CHECK(view.SpendCoin(first[0]));
+    BOOST_CHECK(view.HasFlaggedEntries());
+    const uint256 second_block{m_rng.rand256()};
+    tip.SetBestBlock(second_block);
+    view.Reset();
+    BOOST_CHECK_EQUAL(view.GetCacheSize(), 0U);
+    BOOST_CHECK(!view.HasFlaggedEntries());
+    BOOST_CHECK_EQUAL(view.GetBestBlock(), second_block);
+    BOOST_CHECK(view.HaveCoin(first[0]));
+    BOOST_CHECK(!view.HaveCoin(second[0]));
+    view.SanityCheck();
+
+    // A regular flush releases the memory.
+    add_coins();
+    BOOST_REQUIRE(view.Flush());
+    BOOST_CHECK_LT(view.DynamicMemoryUsage(), usage);
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
@@ -0,0 +1,159 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <coinsfile.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <util/fs.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace {
+struct CoinsFileTestingSetup : public BasicTestingSetup {
+    const fs::path m_path{m_args.GetDataDirBase() / "coinsfile"};
+
+    //! Apply `coins` (a zero value meaning spent) through a cache on top of `view`.
+    static void Write(CCoinsViewFile& view, const std::map<COutPoint, CAmount>& coins, const uint256& tip)
+    {
+        CCoinsViewCache cache{&view};
+        for (const auto& [outpoint, value] : coins) {
+            if (value) {
+                cache.AddCoin(outpoint, Coin{CTxOut{value, CScript{}}, 1, false}, /*possible_overwrite=*/true);
+            } else {
+                cache.SpendCoin(outpoint);
+            }
+        }
+        cache.SetBestBlock(tip);
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    static void Check(const CCoinsViewFile& view, const std::map<COutPoint, CAmount>& expected)
+    {
+        size_t unspent{0};
+        for (const auto& [outpoint, value] : expected) {
+            const auto coin{view.GetCoin(outpoint)};
+            BOOST_REQUIRE_EQUAL(coin.has_value(), value != 0);
+            BOOST_CHECK_EQUAL(view.HaveCoin(outpoint), value != 0);
+            if (coin) {
+                BOOST_CHECK_EQUAL(coin->out.nValue, value);
+                ++unspent;
+            }
+        }
+        BOOST_CHECK_EQUAL(view.CoinCount(), unspent);
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(coinsfile_tests, CoinsFileTestingSetup)
+
+BOOST_AUTO_TEST_CASE(coinsfile_write_and_reload)
+{
+    std::map<COutPoint, CAmount> expected;
+    std::map<COutPoint, CAmount> changes;
+    for (int i{0}; i < 100; ++i) changes[COutPoint{Txid::FromUint256(m_rng.rand256()), 0}] = i + 1;
+    const uint256 tip1{m_rng.rand256()};
+    {
+        CCoinsViewFile view{{.path = m_path}};
+        BOOST_CHECK(view.GetBestBlock().IsNull());
+        Write(view, changes, tip1);
+        expected = changes;
+        BOOST_CHECK_EQUAL(view.GetBestBlock(), tip1);
+        Check(view, expected);
+    }
+
+    // Spend half of the coins and overwrite some of the rest.
+    changes.clear();
+    for (auto& [outpoint, value] : expected) {
+        changes[outpoint] = value % 2 ? 0 : value * 1000;
+    }
+    const uint256 tip2{m_rng.rand256()};
+    {
+        CCoinsViewFile view{{.path = m_path}};
+        BOOST_CHECK_EQUAL(view.GetBestBlock(), tip1);
+        Check(view, expected);
+        Write(view, changes, tip2);
+        expected = changes;
+        Check(view, expected);
+    }
+
+    CCoinsViewFile view{{.path = m_path}};
+    BOOST_CHECK_EQUAL(view.GetBestBlock(), tip2);
+    BOOST_CHECK(view.GetHeadBlocks().empty());
+    Check(view, expected);
+
+    // The cursor returns the unspent coins in outpoint order.
+    std::vector<COutPoint> visited;
+    for (auto cursor{view.Cursor()}; cursor->Valid(); cursor->Next()) {
+        COutPoint outpoint;
+        Coin coin;
+        BOOST_REQUIRE(cursor->GetKey(outpoint));
+        BOOST_REQUIRE(cursor->GetValue(coin));
+        BOOST_CHECK_EQUAL(coin.out.nValue, expected.at(outpoint));
+        visited.push_back(outpoint);
+    }
+    BOOST_CHECK_EQUAL(visited.size(), view.CoinCount());
+    BOOST_CHECK(std::is_sorted(visited.begin(), visited.end()));
+}
+
+BOOST_AUTO_TEST_CASE(coinsfile_interrupted_write)
+{
+    std::map<COutPoint, CAmount> expected;
+    for (int i{0}; i < 10; ++i) expected[COutPoint{Txid::FromUint256(m_rng.rand256()), 1}] = i + 1;
+    const uint256 tip{m_rng.rand256()};
+    uint64_t size;
+    {
+        CCoinsViewFile view{{.path = m_path}};
+        Write(view, expected, tip);
+        size = view.FileSize();
+    }
+
+    // Records of a write that did not reach its state record are dropped.
+    {
+        AutoFile file{fsbridge::fopen(m_path / "coins.dat", "ab")};
+        BOOST_REQUIRE(!file.IsNull());
+        file << uint8_t{'c'} << COutPoint{Txid::FromUint256(m_rng.rand256()), 0};
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }
+    BOOST_CHECK_GT(fs::file_size(m_path / "coins.dat"), size);
+
+    CCoinsViewFile view{{.path = m_path}};
+    BOOST_CHECK_EQUAL(fs::file_size(m_path / "coins.dat"), size);
+    BOOST_CHECK_EQUAL(view.GetBestBlock(), tip);
+    Check(view, expected);
+}
+
+BOOST_AUTO_TEST_CASE(coinsfile_compaction)
+{
+    CCoinsViewFile view{{.path = m_path, .compact_min_bytes = 1}};
+    std::map<COutPoint, CAmount> expected;
+    std::vector<COutPoint> outpoints;
+    for (int i{0}; i < 50; ++i) outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+
+    // Overwriting the same coins again and again makes most of the file stale
+    // and triggers rewrites, which must keep the file from growing.
+    uint64_t max_size{0};
+    for (int round{0}; round < 20; ++round) {
+        std::map<COutPoint, CAmount> changes;
+        for (const auto& outpoint : outpoints) changes[outpoint] = round * 100 + outpoint.n + 1;
+        Write(view, changes, m_rng.rand256());
+        expected = changes;
+        if (round == 0) max_size = 3 * view.FileSize();
+        BOOST_CHECK_LE(view.FileSize(), max_size);
+    }
+    Check(view, expected);
+
+    const uint256 tip{view.GetBestBlock()};
+    const uint64_t size{view.FileSize()};
+    CCoinsViewFile reloaded{{.path = m_path}};
+    BOOST_CHECK_EQUAL(reloaded.GetBestBlock(), tip);
+    BOOST_CHECK_EQUAL(reloaded.FileSize(), size);
+    Check(reloaded, expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
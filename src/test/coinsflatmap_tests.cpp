@@ -0,0 +1,113 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <coinsflatmap.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(coinsflatmap_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(flatmap_basic)
+{
+    CoinsFlatMap map{/*deterministic=*/true};
+    BOOST_CHECK(map.empty());
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 7};
+    BOOST_CHECK_EQUAL(map.Find(outpoint), CoinsFlatMap::npos);
+
+    const auto [slot, inserted]{map.TryEmplace(outpoint)};
+    BOOST_CHECK(inserted);
+    BOOST_CHECK(map.Value(slot).IsSpent());
+    BOOST_CHECK_EQUAL(map.GetFlags(slot), 0);
+    map.Value(slot) = Coin{CTxOut{42, CScript{}}, 100, false};
+    map.AddFlags(slot, CCoinsCacheEntry::DIRTY);
+    BOOST_CHECK_EQUAL(map.FlaggedCount(), 1U);
+
+    const auto [slot2, inserted2]{map.TryEmplace(outpoint)};
+    BOOST_CHECK(!inserted2);
+    BOOST_CHECK_EQUAL(slot2, slot);
+    BOOST_CHECK_EQUAL(map.Find(outpoint), slot);
+    BOOST_CHECK(map.Key(slot) == outpoint);
+    BOOST_CHECK_EQUAL(map.Value(slot).out.nValue, 42);
+
+    map.AddFlags(slot, CCoinsCacheEntry::FRESH);
+    BOOST_CHECK_EQUAL(map.GetFlags(slot), CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH);
+    BOOST_CHECK_EQUAL(map.FlaggedCount(), 1U);
+    map.ClearFlags(slot);
+    BOOST_CHECK_EQUAL(map.FlaggedCount(), 0U);
+
+    BOOST_CHECK(map.Erase(outpoint));
+    BOOST_CHECK(!map.Erase(outpoint));
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK_EQUAL(map.Find(outpoint), CoinsFlatMap::npos);
+}
+
+BOOST_AUTO_TEST_CASE(flatmap_matches_std_map)
+{
+    // Few distinct txids and many lookups of missing keys exercise long probe
+    // sequences, wrap-around and backward-shift deletion.
+    CoinsFlatMap map;
+    std::map<COutPoint, std::pair<CAmount, uint8_t>> expected;
+    std::vector<Txid> txids;
+    for (int i{0}; i < 8; ++i) txids.push_back(Txid::FromUint256(m_rng.rand256()));
+
+    for (int i{0}; i < 20000; ++i) {
+        const COutPoint outpoint{txids[m_rng.randrange(txids.size())], static_cast<uint32_t>(m_rng.randrange(400))};
+        switch (m_rng.randrange(4)) {
+        case 0:
+        case 1: {
+            const auto [slot, inserted]{map.TryEmplace(outpoint)};
+            BOOST_CHECK_EQUAL(inserted, !expected.contains(outpoint));
+            const CAmount value{static_cast<CAmount>(m_rng.randrange(1000)) + 1};
+            const uint8_t flags{static_cast<uint8_t>(m_rng.randrange(4))};
+            map.Value(slot) = Coin{CTxOut{value, CScript{}}, 1, false};
+            map.ClearFlags(slot);
+            if (flags) map.AddFlags(slot, flags);
+            expected[outpoint] = {value, flags};
+            break;
+        }
+        case 2:
+            BOOST_CHECK_EQUAL(map.Erase(outpoint), expected.erase(outpoint) == 1);
+            break;
+        case 3: {
+            const size_t slot{map.Find(outpoint)};
+            const auto it{expected.find(outpoint)};
+            BOOST_REQUIRE_EQUAL(slot == CoinsFlatMap::npos, it == expected.end());
+            if (it != expected.end()) {
+                BOOST_CHECK_EQUAL(map.Value(slot).out.nValue, it->second.first);
+                BOOST_CHECK_EQUAL(map.GetFlags(slot), it->second.second);
+            }
+            break;
+        }
+        }
+    }
+
+    BOOST_CHECK_EQUAL(map.size(), expected.size());
+    size_t flagged{0};
+    for (const auto& [outpoint, entry] : expected) {
+        const size_t slot{map.Find(outpoint)};
+        BOOST_REQUIRE(slot != CoinsFlatMap::npos);
+        BOOST_CHECK_EQUAL(map.Value(slot).out.nValue, entry.first);
+        if (entry.second) ++flagged;
+    }
+    BOOST_CHECK_EQUAL(map.FlaggedCount(), flagged);
+    size_t visited{0};
+    map.ForEachFlagged([&](size_t slot) {
+        BOOST_CHECK_EQUAL(map.GetFlags(slot), expected.at(map.Key(slot)).second);
+        ++visited;
+    });
+    BOOST_CHECK_EQUAL(visited, flagged);
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK_EQUAL(map.FlaggedCount(), 0U);
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1086,6 +1086,57 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256dmulti)
+{
+    for (int i = 0; i <= 32; ++i) {
+        // Lengths around the chunk boundaries, where the padding takes one more chunk.
+        std::vector<std::vector<unsigned char>> data;
+        std::vector<std::span<const unsigned char>> inputs;
+        for (int j = 0; j < i; ++j) {
+            data.push_back(m_rng.randbytes(m_rng.randbool() ? m_rng.randrange(200) : 64 * m_rng.randrange(4) + 55 + m_rng.randrange(3)));
+        }
+        inputs.assign(data.begin(), data.end());
+        std::vector<unsigned char> out1(32 * i), out2(32 * i);
+        for (int j = 0; j < i; ++j) {
+            CHash256().Write(data[j]).Finalize({out1.data() + 32 * j, 32});
+        }
+        SHA256DMulti(out2.data(), inputs);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha256multi)
+{
+    for (int i = 0; i <= 32; ++i) {
+        std::vector<std::vector<unsigned char>> data;
+        for (int j = 0; j < i; ++j) {
+            data.push_back(m_rng.randbytes(m_rng.randbool() ? m_rng.randrange(200) : 64 * m_rng.randrange(4) + 55 + m_rng.randrange(3)));
+        }
+        const std::vector<std::span<const unsigned char>> inputs(data.begin(), data.end());
+        std::vector<unsigned char> out1(32 * i), out2(32 * i);
+        for (int j = 0; j < i; ++j) {
+            CSHA256().Write(data[j].data(), data[j].size()).Finalize(out1.data() + 32 * j);
+        }
+        SHA256Multi(out2.data(), inputs);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ripemd160_32)
+{
+    unsigned char in[32 * 19];
+    unsigned char out1[20 * 19];
+    unsigned char out2[20 * 19];
+    for (unsigned char& c : in) c = m_rng.randbits(8);
+    for (int i = 0; i <= 19; ++i) {
+        for (int j = 0; j < i; ++j) {
+            CRIPEMD160().Write(in + 32 * j, 32).Finalize(out1 + 20 * j);
+        }
+        RIPEMD160_32(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 20 * i) == 0);
+    }
+}
+
 void CryptoTest::TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
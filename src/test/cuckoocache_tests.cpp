@@ -13,6 +13,7 @@
 #include <deque>
 #include <mutex>
 #include <shared_mutex>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -49,6 +50,37 @@ BOOST_AUTO_TEST_CASE(test_cuckoocache_no_fakes)
     }
 };
 
+/* Test that looking up a group of elements at once finds the same ones as
+ * looking them up one at a time, including for a partial last group.
+ */
+BOOST_AUTO_TEST_CASE(test_cuckoocache_batch_contains)
+{
+    SeedRandomForTest(SeedRand::ZEROS);
+    CuckooCache::cache<uint256, SignatureCacheHasher> cc{};
+    cc.setup_bytes(1 << 20);
+    std::vector<uint256> inserted;
+    for (int x = 0; x < 10000; ++x) {
+        inserted.push_back(m_rng.rand256());
+        cc.insert(inserted.back());
+    }
+    std::vector<uint256> elems;
+    for (int x = 0; x < 1001; ++x) {
+        elems.push_back(m_rng.randbool() ? inserted[m_rng.randrange(inserted.size())] : m_rng.rand256());
+    }
+    BOOST_CHECK(cc.contains(std::span<const uint256>{}, false).empty());
+    const std::vector<bool> found{cc.contains(elems, false)};
+    BOOST_REQUIRE_EQUAL(found.size(), elems.size());
+    size_t count = 0;
+    for (size_t i = 0; i < elems.size(); ++i) {
+        BOOST_CHECK_EQUAL(found[i], cc.contains(elems[i], false));
+        count += found[i];
+    }
+    BOOST_CHECK(count > 0 && count < elems.size());
+    // Erasing only marks the elements, which are still found until overwritten.
+    BOOST_CHECK(cc.contains(elems, true) == found);
+    BOOST_CHECK(cc.contains(elems, false) == found);
+}
+
 struct HitRateTest : BasicTestingSetup {
 /** This helper returns the hit rate when megabytes*load worth of entries are
  * inserted into a megabytes sized cache
@@ -202,6 +202,36 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot)
+{
+    CDBWrapper dbw({.path = m_args.GetDataDirBase() / "dbwrapper_snapshot", .cache_bytes = 1 << 20, .memory_only = true, .wipe_data = false, .obfuscate = true});
+    const uint8_t key{'k'}, key2{'l'};
+    const uint256 in{m_rng.rand256()};
+    BOOST_CHECK(dbw.Write(key, in));
+
+    const CDBWrapper::Snapshot snapshot{dbw.GetSnapshot()};
+    BOOST_CHECK(dbw.Write(key, m_rng.rand256()));
+    BOOST_CHECK(dbw.Write(key2, in));
+
+    // The snapshot neither sees the overwritten value nor the new key.
+    uint256 res;
+    BOOST_REQUIRE(dbw.Read(key, res, snapshot));
+    BOOST_CHECK_EQUAL(res, in);
+    BOOST_CHECK(!dbw.Read(key2, res, snapshot));
+    BOOST_REQUIRE(dbw.Read(key, res));
+    BOOST_CHECK(res != in);
+    BOOST_CHECK(dbw.Read(key2, res));
+
+    std::unique_ptr<CDBIterator> it{dbw.NewIterator(snapshot)};
+    it->Seek(key);
+    uint8_t key_res;
+    BOOST_REQUIRE(it->GetKey(key_res) && it->GetValue(res));
+    BOOST_CHECK_EQUAL(key_res, key);
+    BOOST_CHECK_EQUAL(res, in);
+    it->Next();
+    BOOST_CHECK(!it->Valid());
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -280,6 +310,36 @@ BOOST_AUTO_TEST_CASE(existing_data_reindex)
     BOOST_CHECK_EQUAL(res3.ToString(), in2.ToString());
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_tuning_and_stats)
+{
+    for (const DBTuning& tuning : {DB_TUNING_RANDOM_READ, DB_TUNING_APPEND, DBTuning{.bloom_bits_per_key = 0}}) {
+        const fs::path ph{m_args.GetDataDirBase() / fs::u8path(strprintf("dbwrapper_tuning_%d_%d", tuning.block_size, tuning.bloom_bits_per_key))};
+        {
+            CDBWrapper dbw{{.path = ph, .cache_bytes = 1 << 20, .tuning = tuning}};
+            CDBBatch batch{dbw};
+            for (uint32_t i{0}; i < 1000; ++i) batch.Write(i, uint256::ONE);
+            BOOST_CHECK(dbw.WriteBatch(batch));
+            const DBStats stats{dbw.GetStats()};
+            BOOST_CHECK_GT(stats.write_time.count(), 0);
+            BOOST_CHECK_GT(stats.memory_usage, 0U);
+        }
+
+        // Compacting on startup moves the data into table files.
+        CDBWrapper dbw{{.path = ph, .cache_bytes = 1 << 20, .options = {.force_compact = true}, .tuning = tuning}};
+        for (uint32_t i{0}; i < 1000; ++i) {
+            uint256 value;
+            BOOST_REQUIRE(dbw.Read(i, value));
+            BOOST_CHECK_EQUAL(value, uint256::ONE);
+        }
+        BOOST_CHECK(!dbw.Exists(uint32_t{1000}));
+        const DBStats stats{dbw.GetStats()};
+        BOOST_REQUIRE(!stats.levels.empty());
+        int files{0};
+        for (const DBLevelStats& level : stats.levels) files += level.files;
+        BOOST_CHECK_GT(files, 0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(iterator_ordering)
 {
     fs::path ph = m_args.GetDataDirBase() / "iterator_ordering";
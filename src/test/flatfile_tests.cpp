@@ -130,4 +130,44 @@ BOOST_AUTO_TEST_CASE(flatfile_flush)
     BOOST_CHECK_EQUAL(fs::file_size(seq.FileName(FlatFilePos(0, 1))), 1U);
 }
 
+BOOST_AUTO_TEST_CASE(flatfile_cold_dir)
+{
+    const auto data_dir = m_args.GetDataDirBase();
+    const auto cold_dir = data_dir / "cold";
+    FlatFileSeq seq(data_dir, "a", 16 * 1024, cold_dir);
+    const std::string data("The cold directory holds old files.");
+
+    // New files are created in the base directory.
+    {
+        AutoFile file{seq.Open(FlatFilePos(0, 0))};
+        file << data;
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }
+    BOOST_CHECK_EQUAL(seq.FileName(FlatFilePos(0, 0)), data_dir / "a00000.dat");
+
+    // Copied files are used from the base directory until removed from it.
+    AutoFile open_before_move{seq.Open(FlatFilePos(0, 0), true)};
+    BOOST_CHECK(seq.CopyToColdDir(FlatFilePos(0, 0)));
+    BOOST_CHECK(fs::exists(cold_dir / "a00000.dat"));
+    BOOST_CHECK(!fs::exists(cold_dir / "a00000.dat.tmp"));
+    BOOST_CHECK_EQUAL(seq.FileName(FlatFilePos(0, 0)), data_dir / "a00000.dat");
+    seq.RemoveCopiedToColdDir(FlatFilePos(0, 0));
+    BOOST_CHECK(!fs::exists(data_dir / "a00000.dat"));
+    BOOST_CHECK_EQUAL(seq.FileName(FlatFilePos(0, 0)), cold_dir / "a00000.dat");
+
+    // Handles opened before and after the move read the data.
+    AutoFile open_after_move{seq.Open(FlatFilePos(0, 0), true)};
+    for (AutoFile* file : {&open_before_move, &open_after_move}) {
+        std::string read;
+        *file >> read;
+        BOOST_CHECK_EQUAL(read, data);
+    }
+
+    // Files that are not in the base directory are left alone.
+    BOOST_CHECK(seq.CopyToColdDir(FlatFilePos(0, 0)));
+    BOOST_CHECK(seq.CopyToColdDir(FlatFilePos(1, 0)));
+    BOOST_CHECK(!fs::exists(cold_dir / "a00001.dat"));
+    BOOST_CHECK_EQUAL(seq.FileName(FlatFilePos(1, 0)), data_dir / "a00001.dat");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,9 @@
 #include <test/fuzz/fuzz.h>
 #include <util/asmap.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstdint>
 #include <vector>
 
@@ -59,4 +62,20 @@ FUZZ_TARGET(asmap)
     }
     NetGroupManager netgroupman{asmap};
     (void)netgroupman.GetMappedAS(net_addr);
+
+    // The decoded asmap gives the same ASN as the interpreter.
+    std::array<uint8_t, 16> ip{};
+    if (ipv6) {
+        std::copy(addr_data, addr_data + ADDR_IPV6_SIZE, ip.begin());
+    } else {
+        std::copy(IPV4_IN_IPV6_PREFIX.begin(), IPV4_IN_IPV6_PREFIX.end(), ip.begin());
+        std::copy(addr_data, addr_data + ADDR_IPV4_SIZE, ip.begin() + IPV4_IN_IPV6_PREFIX.size());
+    }
+    std::vector<bool> ip_bits;
+    for (const uint8_t byte : ip) {
+        for (int bit = 7; bit >= 0; --bit) ip_bits.push_back((byte >> bit) & 1);
+    }
+    const auto decoded{DecodedAsmap::Decode(asmap)};
+    assert(decoded);
+    assert(decoded->Lookup(ip) == Interpret(asmap, ip_bits));
 }
@@ -40,6 +40,15 @@ FUZZ_TARGET(node_eviction)
     // Make a copy since eviction_candidates may be in some valid but otherwise
     // indeterminate state after the SelectNodeToEvict(&&) call.
     const std::vector<NodeEvictionCandidate> eviction_candidates_copy = eviction_candidates;
+    EvictionCandidates incremental_candidates;
+    for (const NodeEvictionCandidate& candidate : eviction_candidates) {
+        incremental_candidates.AddOrUpdate(candidate);
+    }
+    if (const auto incremental_to_evict{incremental_candidates.SelectNodeToEvict()}) {
+        assert(std::any_of(eviction_candidates.begin(), eviction_candidates.end(), [&](const NodeEvictionCandidate& c) {
+            return c.id == *incremental_to_evict && !c.m_noban && c.m_conn_type == ConnectionType::INBOUND;
+        }));
+    }
     const std::optional<NodeId> node_to_evict = SelectNodeToEvict(std::move(eviction_candidates));
     if (node_to_evict) {
         assert(std::any_of(eviction_candidates_copy.begin(), eviction_candidates_copy.end(), [&node_to_evict](const NodeEvictionCandidate& eviction_candidate) { return *node_to_evict == eviction_candidate.id; }));
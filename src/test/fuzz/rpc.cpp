@@ -116,28 +116,37 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getbestblockhash",
     "getblock",
     "getblockchaininfo",
+    "getblockconnectstats",
+    "getblockdatacacheinfo",
     "getblockcount",
     "getblockfilter",
     "getblockfrompeer", // when no peers are connected, no p2p message is sent
     "getblockhash",
     "getblockheader",
+    "getblockheaders",
     "getblockstats",
+    "getblockstatsrange",
     "getblocktemplate",
     "getchaintips",
     "getchainstates",
     "getchaintxstats",
     "getconnectioncount",
+    "getdbinfo",
     "getdeploymentinfo",
     "getdescriptoractivity",
     "getdescriptorinfo",
     "getdifficulty",
     "getindexinfo",
+    "getlockstats",
     "getmemoryinfo",
+    "getmempoolacceptstats",
     "getmempoolancestors",
+    "getmempooldelta",
     "getmempooldescendants",
     "getmempoolentry",
     "getmempoolinfo",
     "getmininginfo",
+    "getmsgprocstats",
     "getnettotals",
     "getnetworkhashps",
     "getnetworkinfo",
@@ -148,8 +157,14 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawaddrman",
     "getrawmempool",
     "getrawtransaction",
+    "getrawtransactions",
     "getrpcinfo",
+    "getscopetimers",
+    "getscripthashhistory",
+    "getsignaturecacheinfo",
     "gettxout",
+    "gettxouts",
+    "gettxoutsat",
     "gettxoutsetinfo",
     "gettxspendingprevout",
     "help",
@@ -172,6 +172,13 @@ ssize_t FuzzedSock::Send(const void* data, size_t len, int flags) const
     return r;
 }
 
+ssize_t FuzzedSock::SendV(std::span<const std::span<const uint8_t>> data, int flags) const
+{
+    size_t len{0};
+    for (const auto& segment : data) len += segment.size();
+    return Send(nullptr, len, flags);
+}
+
 ssize_t FuzzedSock::Recv(void* buf, size_t len, int flags) const
 {
     // Have a permanent error at recv_errnos[0] because when the fuzzed data is exhausted
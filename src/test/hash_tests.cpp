@@ -146,6 +146,40 @@ BOOST_AUTO_TEST_CASE(siphash)
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between SipHashUint256 and SipHashUint256Batch, for sizes
+    // which are not a multiple of the number of lanes too.
+    const uint64_t k0{ctx.rand64()}, k1{ctx.rand64()};
+    std::vector<uint256> vals(19);
+    std::vector<const uint256*> ptrs;
+    for (uint256& val : vals) {
+        val = m_rng.rand256();
+        ptrs.push_back(&val);
+    }
+    for (size_t count : {0, 1, 8, 19}) {
+        std::vector<uint64_t> out(count);
+        SipHashUint256Batch(k0, k1, std::span{ptrs}.first(count), out);
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], SipHashUint256(k0, k1, vals[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash160multi)
+{
+    // Compressed and uncompressed public key sizes, the latter taking two chunks.
+    std::vector<std::vector<unsigned char>> data;
+    for (int i = 0; i < 21; ++i) {
+        data.push_back(m_rng.randbytes(m_rng.randbool() ? 33 : 65));
+    }
+    const std::vector<std::span<const unsigned char>> inputs(data.begin(), data.end());
+    for (size_t count : {0, 1, 8, 21}) {
+        std::vector<uint160> out(count);
+        Hash160Multi(out, std::span{inputs}.first(count));
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], Hash160(data[i]));
+        }
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilter.h>
+#include <index/blockcache.h>
+#include <index/blockfilterindex.h>
+#include <index/txindex.h>
+#include <interfaces/chain.h>
+#include <primitives/block.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(index_blockcache_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(take_and_evict)
+{
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const node::BlockManager& blockman{m_node.chainman->m_blockman};
+
+    // With a single reader nothing is kept.
+    IndexBlockCache cache;
+    cache.AddReader(/*undo=*/true);
+    BOOST_REQUIRE(cache.GetBlock(blockman, *tip));
+    BOOST_CHECK_EQUAL(cache.Bytes(), 0U);
+
+    // With three, an entry is kept until the two others took it.
+    cache.AddReader(/*undo=*/false);
+    cache.AddReader(/*undo=*/false);
+    const auto block{cache.GetBlock(blockman, *tip)};
+    BOOST_REQUIRE(block);
+    BOOST_CHECK_EQUAL(block->GetHash(), tip->GetBlockHash());
+    BOOST_CHECK(cache.Bytes() > 0);
+    BOOST_CHECK_EQUAL(cache.GetBlock(blockman, *tip), block);
+    BOOST_CHECK_EQUAL(cache.GetBlock(blockman, *tip), block);
+    BOOST_CHECK_EQUAL(cache.Hits(), 2U);
+    BOOST_CHECK_EQUAL(cache.Bytes(), 0U);
+
+    // Undo data is only read by one of them.
+    BOOST_REQUIRE(cache.GetBlockUndo(blockman, *tip));
+    BOOST_CHECK_EQUAL(cache.Bytes(), 0U);
+
+    // The oldest entries make room for new ones.
+    const size_t block_size{::GetSerializeSize(TX_WITH_WITNESS(*block))};
+    IndexBlockCache small{block_size};
+    small.AddReader(/*undo=*/false);
+    small.AddReader(/*undo=*/false);
+    BOOST_REQUIRE(small.GetBlock(blockman, *tip));
+    BOOST_REQUIRE(small.GetBlock(blockman, *tip->pprev));
+    BOOST_CHECK(small.Bytes() <= block_size);
+    BOOST_REQUIRE(small.GetBlock(blockman, *tip));
+    BOOST_CHECK_EQUAL(small.Hits(), 0U);
+
+    // Nothing is kept once a single reader is left.
+    cache.RemoveReader(/*undo=*/false);
+    cache.AddReader(/*undo=*/false);
+    BOOST_REQUIRE(cache.GetBlock(blockman, *tip));
+    BOOST_CHECK(cache.Bytes() > 0);
+    cache.RemoveReader(/*undo=*/false);
+    cache.RemoveReader(/*undo=*/false);
+    BOOST_CHECK_EQUAL(cache.Bytes(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(shared_sync)
+{
+    // Stand in for two more indexes that are still syncing, so that the blocks
+    // read by the txindex are kept for the filter index.
+    const auto cache{std::make_shared<IndexBlockCache>()};
+    cache->AddReader(/*undo=*/true);
+    cache->AddReader(/*undo=*/true);
+
+    TxIndex txindex{interfaces::MakeChain(m_node), 1 << 20, true};
+    txindex.SetBlockCache(cache);
+    BOOST_REQUIRE(txindex.Init());
+    txindex.Sync();
+    BOOST_CHECK_EQUAL(cache->Hits(), 0U);
+
+    BlockFilterIndex filter_index{interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true};
+    filter_index.SetBlockCache(cache);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_CHECK_EQUAL(cache->Hits(), uint64_t(tip->nHeight + 1));
+
+    // Both indexes have all blocks.
+    for (const auto& tx : m_coinbase_txns) {
+        uint256 block_hash;
+        CTransactionRef tx_disk;
+        BOOST_CHECK(txindex.FindTx(tx->GetHash(), block_hash, tx_disk));
+    }
+    BlockFilter filter;
+    BOOST_CHECK(filter_index.LookupFilter(tip, filter));
+    CBlock block;
+    CBlockUndo block_undo;
+    BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlock(block, *tip));
+    BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlockUndo(block_undo, *tip));
+    BOOST_CHECK_EQUAL(filter.GetHash(), BlockFilter(BlockFilterType::BASIC, block, block_undo).GetHash());
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+    filter_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
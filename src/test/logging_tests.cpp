@@ -11,6 +11,7 @@
 #include <tinyformat.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/metrics.h>
 #include <util/string.h>
 
 #include <chrono>
@@ -20,6 +21,7 @@
 #include <iostream>
 #include <source_location>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -92,6 +94,30 @@ BOOST_AUTO_TEST_CASE(logging_timer)
     BOOST_CHECK_EQUAL(micro_timer.LogMsg("msg").substr(0, result_prefix.size()), result_prefix);
 }
 
+BOOST_AUTO_TEST_CASE(logging_scope_timer)
+{
+    const auto count{[](const std::string& path) -> uint64_t {
+        for (const auto& [timer_path, histogram] : BCLog::GetScopeTimers()) {
+            if (timer_path == path) return histogram->Count();
+        }
+        return 0;
+    }};
+    const auto outer{count("logging_tests_outer")};
+    const auto inner{count("logging_tests_outer/inner")};
+    {
+        TIME_SCOPE("logging_tests_outer");
+        for (int i{0}; i < 2; ++i) {
+            TIME_SCOPE("inner");
+        }
+        // Scopes of other threads are not nested in the scopes of this one.
+        std::thread{[] { TIME_SCOPE("logging_tests_thread"); }}.join();
+    }
+    BOOST_CHECK_EQUAL(count("logging_tests_outer"), outer + 1);
+    BOOST_CHECK_EQUAL(count("logging_tests_outer/inner"), inner + 2);
+    BOOST_CHECK_GE(count("logging_tests_thread"), 1U);
+    BOOST_CHECK_EQUAL(count("logging_tests_outer/logging_tests_thread"), 0U);
+}
+
 BOOST_FIXTURE_TEST_CASE(logging_LogPrintStr, LogSetup)
 {
     LogInstance().m_log_sourcelocations = true;
@@ -170,6 +196,47 @@ BOOST_FIXTURE_TEST_CASE(logging_LogPrintMacros, LogSetup)
     BOOST_CHECK_EQUAL_COLLECTIONS(log_lines.begin(), log_lines.end(), expected.begin(), expected.end());
 }
 
+BOOST_FIXTURE_TEST_CASE(logging_AsyncWriter, LogSetup)
+{
+    LogInstance().StartAsyncWriter();
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100; ++i) {
+        LogInfo("foo%d: %s", i, "bar\x01");
+        expected.push_back(strprintf("foo%d: bar\\x01", i));
+    }
+    LogInstance().StopAsyncWriter();
+    std::ifstream file{tmp_log_path};
+    std::vector<std::string> log_lines;
+    for (std::string log; std::getline(file, log);) {
+        log_lines.push_back(log);
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(log_lines.begin(), log_lines.end(), expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(logging_AsyncWriterDropped, LogSetup)
+{
+    const uint64_t prev_dropped{LogInstance().AsyncLinesDropped()};
+    // No message fits in the queue, so all of them are dropped.
+    LogInstance().StartAsyncWriter(/*max_queue_memusage=*/1);
+    for (int i = 0; i < 10; ++i) {
+        LogInfo("foo%d", i);
+    }
+    LogInstance().StopAsyncWriter();
+    BOOST_CHECK_EQUAL(LogInstance().AsyncLinesDropped(), prev_dropped + 10);
+    // Once stopped, messages are written synchronously again.
+    LogInfo("bar");
+    std::ifstream file{tmp_log_path};
+    std::vector<std::string> log_lines;
+    for (std::string log; std::getline(file, log);) {
+        log_lines.push_back(log);
+    }
+    std::vector<std::string> expected = {
+        "[warning] Log queue full, 10 log lines dropped.",
+        "bar",
+    };
+    BOOST_CHECK_EQUAL_COLLECTIONS(log_lines.begin(), log_lines.end(), expected.begin(), expected.end());
+}
+
 BOOST_FIXTURE_TEST_CASE(logging_LogPrintMacros_CategoryName, LogSetup)
 {
     LogInstance().EnableCategory(BCLog::LogFlags::ALL);
@@ -6,6 +6,7 @@
 #include <policy/policy.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
+#include <util/rbf.h>
 #include <util/time.h>
 
 #include <test/util/setup_common.h>
@@ -20,6 +21,7 @@ static constexpr auto REMOVAL_REASON_DUMMY = MemPoolRemovalReason::REPLACED;
 class MemPoolTest final : public CTxMemPool
 {
 public:
+    using CTxMemPool::CTxMemPool;
     using CTxMemPool::GetMinFee;
 };
 
@@ -804,4 +806,273 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTestsDiamond)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolRemoveForBlockChainTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // A chain [ta] <- [tb] <- [tc] <- [td] with [tb] also spending [tx], and a
+    // block confirming [ta], [tx] and [tb] at once.
+    CTransactionRef ta, tx, tb, tc, td;
+    ta = make_tx(/*output_values=*/{10 * COIN});
+    tx = make_tx(/*output_values=*/{10 * COIN});
+    tb = make_tx(/*output_values=*/{9 * COIN}, /*inputs=*/{ta, tx});
+    tc = make_tx(/*output_values=*/{8 * COIN}, /*inputs=*/{tb});
+    td = make_tx(/*output_values=*/{7 * COIN}, /*inputs=*/{tc});
+    for (const auto& tx_ref : {ta, tx, tb, tc, td}) {
+        AddToMempool(pool, entry.Fee(10000LL).FromTx(tx_ref));
+    }
+    BOOST_CHECK_EQUAL(pool.GetIter(td->GetHash()).value()->GetCountWithAncestors(), 5U);
+
+    pool.removeForBlock({ta, tx, tb}, 1);
+    BOOST_CHECK_EQUAL(pool.size(), 2U);
+    const auto c{pool.GetIter(tc->GetHash()).value()};
+    const auto d{pool.GetIter(td->GetHash()).value()};
+    BOOST_CHECK_EQUAL(c->GetCountWithAncestors(), 1U);
+    BOOST_CHECK_EQUAL(c->GetSizeWithAncestors(), c->GetTxSize());
+    BOOST_CHECK_EQUAL(c->GetModFeesWithAncestors(), 10000LL);
+    BOOST_CHECK_EQUAL(d->GetCountWithAncestors(), 2U);
+    BOOST_CHECK_EQUAL(d->GetSizeWithAncestors(), c->GetTxSize() + d->GetTxSize());
+    BOOST_CHECK_EQUAL(d->GetModFeesWithAncestors(), 20000LL);
+    BOOST_CHECK_EQUAL(d->GetSigOpCostWithAncestors(), c->GetSigOpCost() + d->GetSigOpCost());
+    BOOST_CHECK_EQUAL(c->GetCountWithDescendants(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolRelayOrderTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    CMutableTransaction parent;
+    parent.vout.resize(1);
+    parent.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    parent.vout[0].nValue = 10 * COIN;
+    AddToMempool(pool, entry.Fee(1000LL).FromTx(parent));
+
+    CMutableTransaction child;
+    child.vin.resize(1);
+    child.vin[0].prevout = COutPoint(parent.GetHash(), 0);
+    child.vout.resize(1);
+    child.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    child.vout[0].nValue = 9 * COIN;
+    AddToMempool(pool, entry.Fee(100000LL).FromTx(child));
+
+    CMutableTransaction other;
+    other.vout.resize(1);
+    other.vout[0].scriptPubKey = CScript() << OP_12 << OP_EQUAL;
+    other.vout[0].nValue = 5 * COIN;
+    AddToMempool(pool, entry.Fee(2000LL).FromTx(other));
+
+    // Parents before their children whatever their feerates, then by feerate.
+    const TxRelayOrder parent_order{pool.GetRelayOrder(parent.GetHash())};
+    const TxRelayOrder child_order{pool.GetRelayOrder(child.GetHash())};
+    const TxRelayOrder other_order{pool.GetRelayOrder(other.GetHash())};
+    const TxRelayOrder missing_order{pool.GetRelayOrder(Txid::FromUint256(uint256::ONE))};
+    BOOST_CHECK(parent_order < child_order);
+    BOOST_CHECK(other_order < parent_order);
+    BOOST_CHECK(child_order < missing_order);
+
+    const std::vector<GenTxid> gtxids{GenTxid{parent.GetHash()}, GenTxid{Txid::FromUint256(uint256::ONE)}, GenTxid{CTransaction{child}.GetWitnessHash()}};
+    const auto infos{pool.info(gtxids)};
+    BOOST_REQUIRE_EQUAL(infos.size(), 3U);
+    BOOST_CHECK_EQUAL(infos[0].tx->GetHash(), parent.GetHash());
+    BOOST_CHECK(!infos[1].tx);
+    BOOST_CHECK_EQUAL(infos[2].tx->GetHash(), child.GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(MempoolSnapshotTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // [ta] signals replaceability, which [tb] inherits. [tc] is unrelated.
+    CMutableTransaction mta{*make_tx(/*output_values=*/{10 * COIN})};
+    mta.vin.resize(1);
+    mta.vin[0].nSequence = MAX_BIP125_RBF_SEQUENCE;
+    const CTransactionRef ta{MakeTransactionRef(mta)};
+    const CTransactionRef tb{make_tx(/*output_values=*/{9 * COIN}, /*inputs=*/{ta})};
+    const CTransactionRef tc{make_tx(/*output_values=*/{8 * COIN})};
+    AddToMempool(pool, entry.Fee(10000LL).FromTx(ta));
+    AddToMempool(pool, entry.Fee(20000LL).FromTx(tb));
+
+    const auto snapshot{pool.GetSnapshot()};
+    BOOST_CHECK_EQUAL(snapshot->sequence, pool.GetSequence());
+    BOOST_REQUIRE_EQUAL(snapshot->entries.size(), 2U);
+    const MempoolEntrySnapshot& a{snapshot->entries[0]};
+    const MempoolEntrySnapshot& b{snapshot->entries[1]};
+    BOOST_CHECK(a.tx == ta);
+    BOOST_CHECK(b.tx == tb);
+    BOOST_CHECK(a.bip125_replaceable);
+    BOOST_CHECK(b.bip125_replaceable);
+    BOOST_CHECK(a.children == std::vector{tb->GetHash()});
+    BOOST_CHECK(b.parents == std::vector{ta->GetHash()});
+    BOOST_CHECK_EQUAL(b.count_with_ancestors, 2U);
+    BOOST_CHECK_EQUAL(b.mod_fees_with_ancestors, 30000LL);
+    BOOST_CHECK_EQUAL(a.mod_fees_with_descendants, 30000LL);
+    BOOST_CHECK(!a.unbroadcast);
+
+    // The single entry copy agrees with the full one.
+    const auto b_copy{pool.GetEntrySnapshot(*pool.GetEntry(tb->GetHash()))};
+    BOOST_CHECK(b_copy.bip125_replaceable);
+    BOOST_CHECK(b_copy.parents == b.parents);
+
+    // The snapshot is shared until the mempool changes.
+    BOOST_CHECK_EQUAL(pool.GetSnapshot(), snapshot);
+    pool.AddUnbroadcastTx(ta->GetHash());
+    const auto unbroadcast_snapshot{pool.GetSnapshot()};
+    BOOST_CHECK(unbroadcast_snapshot != snapshot);
+    BOOST_CHECK(unbroadcast_snapshot->entries[0].unbroadcast);
+
+    AddToMempool(pool, entry.Fee(1000LL).FromTx(tc));
+    const auto new_snapshot{pool.GetSnapshot()};
+    BOOST_CHECK(new_snapshot != unbroadcast_snapshot);
+    BOOST_CHECK_EQUAL(new_snapshot->entries.size(), 3U);
+    for (const auto& e : new_snapshot->entries) {
+        BOOST_CHECK_EQUAL(e.bip125_replaceable, e.tx != tc);
+    }
+    // Earlier snapshots are not changed.
+    BOOST_CHECK_EQUAL(snapshot->entries.size(), 2U);
+
+    pool.PrioritiseTransaction(tc->GetHash(), 5000);
+    BOOST_CHECK(pool.GetSnapshot() != new_snapshot);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolChangesTest)
+{
+    CTxMemPool::Options opts{MemPoolOptionsForTest(m_node)};
+    opts.log_size = 3;
+    bilingual_str error;
+    CTxMemPool pool{opts, error};
+    BOOST_REQUIRE(error.empty());
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    const uint64_t start{pool.GetSequence()};
+    const CTransactionRef ta{make_tx(/*output_values=*/{COIN})};
+    const CTransactionRef tb{make_tx(/*output_values=*/{2 * COIN})};
+    AddToMempool(pool, entry.FromTx(ta));
+    BOOST_CHECK_EQUAL(pool.LogAddition(ta->GetHash()), start);
+    AddToMempool(pool, entry.FromTx(tb));
+    BOOST_CHECK_EQUAL(pool.LogAddition(tb->GetHash()), start + 1);
+    pool.removeRecursive(*ta, MemPoolRemovalReason::CONFLICT);
+
+    const MempoolChanges changes{pool.GetChanges(start)};
+    BOOST_CHECK(!changes.truncated);
+    BOOST_CHECK_EQUAL(changes.sequence, start + 3);
+    BOOST_REQUIRE_EQUAL(changes.changes.size(), 3U);
+    BOOST_CHECK_EQUAL(changes.changes[0].txid, ta->GetHash());
+    BOOST_CHECK(!changes.changes[0].removal_reason);
+    BOOST_CHECK_EQUAL(changes.changes[1].txid, tb->GetHash());
+    BOOST_CHECK(!changes.changes[1].removal_reason);
+    BOOST_CHECK_EQUAL(changes.changes[2].sequence, start + 2);
+    BOOST_CHECK_EQUAL(changes.changes[2].txid, ta->GetHash());
+    BOOST_CHECK(changes.changes[2].removal_reason == MemPoolRemovalReason::CONFLICT);
+
+    // Only the changes from the given sequence on are returned, and none from
+    // the current one.
+    BOOST_CHECK_EQUAL(pool.GetChanges(start + 2).changes.size(), 1U);
+    const MempoolChanges none{pool.GetChanges(start + 3)};
+    BOOST_CHECK(!none.truncated);
+    BOOST_CHECK(none.changes.empty());
+    BOOST_CHECK(pool.GetChanges(start + 4).truncated);
+
+    // Once the log is full, the oldest changes are dropped.
+    pool.removeRecursive(*tb, MemPoolRemovalReason::EXPIRY);
+    const MempoolChanges truncated{pool.GetChanges(start)};
+    BOOST_CHECK(truncated.truncated);
+    BOOST_CHECK(truncated.changes.empty());
+    const MempoolChanges last{pool.GetChanges(start + 1)};
+    BOOST_CHECK(!last.truncated);
+    BOOST_REQUIRE_EQUAL(last.changes.size(), 3U);
+    BOOST_CHECK(last.changes[2].removal_reason == MemPoolRemovalReason::EXPIRY);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolMemoryUsageTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    const CTransactionRef parent{make_tx(/*output_values=*/{COIN, COIN, COIN, COIN})};
+    AddToMempool(pool, entry.FromTx(parent));
+    std::vector<CTransactionRef> children;
+    for (uint32_t i{0}; i < 4; ++i) {
+        children.push_back(make_tx(/*output_values=*/{COIN / 2}, /*inputs=*/{parent}, /*input_indices=*/{i}));
+        AddToMempool(pool, entry.FromTx(children.back()));
+
+        const MempoolMemoryUsage usage{pool.GetMemoryUsage()};
+        BOOST_CHECK_EQUAL(usage.Total(), pool.DynamicMemoryUsage());
+        size_t tx_usage{RecursiveDynamicUsage(parent)};
+        for (const auto& child : children) tx_usage += RecursiveDynamicUsage(child);
+        BOOST_CHECK_EQUAL(usage.transactions, tx_usage);
+        BOOST_CHECK_GT(usage.entries, 0U);
+        // Up to two children are linked without an allocation.
+        BOOST_CHECK_EQUAL(usage.links == 0, children.size() <= 2);
+    }
+
+    // Links are kept in txid order.
+    const auto& links{pool.GetEntry(parent->GetHash())->GetMemPoolChildrenConst()};
+    BOOST_CHECK_EQUAL(links.size(), 4U);
+    BOOST_CHECK(std::is_sorted(links.begin(), links.end(), CompareIteratorByHash{}));
+    for (const auto& child : children) {
+        BOOST_CHECK(links.contains(*pool.GetEntry(child->GetHash())));
+    }
+    BOOST_CHECK_EQUAL(pool.GetEntry(children[0]->GetHash())->GetMemPoolParentsConst().begin()->get().GetTx().GetHash(), parent->GetHash());
+
+    pool.removeRecursive(*parent, MemPoolRemovalReason::REPLACED);
+    const MempoolMemoryUsage usage{pool.GetMemoryUsage()};
+    BOOST_CHECK_EQUAL(usage.transactions, 0U);
+    BOOST_CHECK_EQUAL(usage.entries, 0U);
+    BOOST_CHECK_EQUAL(usage.links, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolBatchTrimTest)
+{
+    CTxMemPool::Options opts{MemPoolOptionsForTest(m_node)};
+    opts.batch_trim = true;
+    bilingual_str error;
+    MemPoolTest pool{opts, error};
+    BOOST_REQUIRE(error.empty());
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // Independent transactions with increasing fees, and a low fee parent
+    // whose child pays for both.
+    std::vector<CTransactionRef> txs;
+    for (int i{0}; i < 10; ++i) {
+        txs.push_back(make_tx(/*output_values=*/{i * COIN + 1}));
+        AddToMempool(pool, entry.Fee(1000 * (i + 1)).FromTx(txs.back()));
+    }
+    const CTransactionRef parent{make_tx(/*output_values=*/{COIN})};
+    const CTransactionRef child{make_tx(/*output_values=*/{COIN / 2}, /*inputs=*/{parent})};
+    AddToMempool(pool, entry.Fee(100).FromTx(parent));
+    AddToMempool(pool, entry.Fee(100000).FromTx(child));
+
+    const size_t limit{pool.DynamicMemoryUsage() / 2};
+    pool.TrimToSize(limit);
+    BOOST_CHECK_LE(pool.DynamicMemoryUsage(), limit);
+    BOOST_CHECK(pool.exists(parent->GetHash()));
+    BOOST_CHECK(pool.exists(child->GetHash()));
+    BOOST_CHECK(pool.exists(txs.back()->GetHash()));
+
+    // The lowest fee transactions were evicted, and the minimum fee is bumped
+    // above the highest feerate among them.
+    size_t evicted{0};
+    bool kept{false};
+    CFeeRate max_removed;
+    for (const auto& tx : txs) {
+        if (pool.exists(tx->GetHash())) {
+            kept = true;
+            continue;
+        }
+        BOOST_CHECK(!kept);
+        max_removed = CFeeRate(1000 * (++evicted), GetVirtualTransactionSize(*tx));
+    }
+    BOOST_CHECK(0U < evicted && evicted < txs.size());
+    BOOST_CHECK_EQUAL(pool.GetMinFee(1).GetFeePerK(), max_removed.GetFeePerK() + 1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,19 +10,6 @@
 
 BOOST_FIXTURE_TEST_SUITE(merkle_tests, TestingSetup)
 
-static uint256 ComputeMerkleRootFromBranch(const uint256& leaf, const std::vector<uint256>& vMerkleBranch, uint32_t nIndex) {
-    uint256 hash = leaf;
-    for (std::vector<uint256>::const_iterator it = vMerkleBranch.begin(); it != vMerkleBranch.end(); ++it) {
-        if (nIndex & 1) {
-            hash = Hash(*it, hash);
-        } else {
-            hash = Hash(hash, *it);
-        }
-        nIndex >>= 1;
-    }
-    return hash;
-}
-
 // Older version of the merkle root computation code, for comparison.
 static uint256 BlockBuildMerkleTree(const CBlock& block, bool* fMutated, std::vector<uint256>& vMerkleTree)
 {
@@ -138,7 +125,7 @@ BOOST_AUTO_TEST_CASE(merkle_test)
                     std::vector<uint256> newBranch = TransactionMerklePath(block, mtx);
                     std::vector<uint256> oldBranch = BlockGetMerkleBranch(block, merkleTree, mtx);
                     BOOST_CHECK(oldBranch == newBranch);
-                    BOOST_CHECK(ComputeMerkleRootFromBranch(block.vtx[mtx]->GetHash(), newBranch, mtx) == oldRoot);
+                    BOOST_CHECK(ComputeMerkleRootFromPath(block.vtx[mtx]->GetHash(), newBranch, mtx) == oldRoot);
                 }
             }
         }
@@ -146,6 +133,25 @@ BOOST_AUTO_TEST_CASE(merkle_test)
 }
 
 
+BOOST_AUTO_TEST_CASE(merkle_test_coinbase_path)
+{
+    for (int ntx : {1, 2, 3, 7, 8, 33}) {
+        CBlock block;
+        block.vtx.resize(ntx);
+        for (int j = 0; j < ntx; j++) {
+            CMutableTransaction mtx;
+            mtx.nLockTime = j;
+            block.vtx[j] = MakeTransactionRef(std::move(mtx));
+        }
+        // The path to the coinbase stays valid when the coinbase is replaced.
+        const std::vector<uint256> path{TransactionMerklePath(block, 0)};
+        CMutableTransaction coinbase;
+        coinbase.nLockTime = 1000 + ntx;
+        block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+        BOOST_CHECK_EQUAL(ComputeMerkleRootFromPath(block.vtx[0]->GetHash(), path, 0), BlockMerkleRoot(block));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(merkle_test_empty_block)
 {
     bool mutated = false;
@@ -0,0 +1,85 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/metrics.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(metrics_tests)
+
+BOOST_AUTO_TEST_CASE(registration)
+{
+    metrics::Registry registry;
+    auto& counter{registry.GetCounter("test_events", "Events")};
+    counter.Inc();
+    counter.Inc(2);
+    BOOST_CHECK_EQUAL(counter.Value(), 3U);
+    // The same name and labels return the same metric, other labels another one.
+    BOOST_CHECK_EQUAL(&registry.GetCounter("test_events", "Events"), &counter);
+    BOOST_CHECK_NE(&registry.GetCounter("test_events", "Events", {{"kind", "a"}}), &counter);
+
+    auto& gauge{registry.GetGauge("test_level", "Level")};
+    gauge.Set(5);
+    gauge.Add(-7);
+    BOOST_CHECK_EQUAL(gauge.Value(), -2);
+
+    BOOST_CHECK_THROW(registry.GetGauge("test_events", "Events"), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(histogram)
+{
+    metrics::Histogram histogram{{1, 2, 4}};
+    histogram.Observe(0.5);
+    histogram.Observe(1);
+    histogram.Observe(3);
+    histogram.Observe(10);
+    histogram.Observe(1500ms);
+    BOOST_CHECK_EQUAL(histogram.Count(), 5U);
+    BOOST_CHECK_CLOSE(histogram.Sum(), 16, 1e-9);
+    const std::vector<uint64_t> expected{2, 1, 1, 1};
+    const auto counts{histogram.BucketCounts()};
+    BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(render)
+{
+    metrics::Registry registry;
+    BOOST_CHECK_EQUAL(registry.Render(), "# EOF\n");
+
+    registry.GetGauge("test_peers", "Connected peers", {{"direction", "in"}}).Set(3);
+    registry.GetGauge("test_peers", "Connected peers", {{"direction", "out"}}).Set(8);
+    registry.GetCounter("test_bytes", "Bytes\nsent").Inc(42);
+    registry.GetCounter("test_calls", "Calls", {{"method", "a\"b\\c"}}).Inc();
+    auto& histogram{registry.GetHistogram("test_seconds", "Durations", {0.5, 1})};
+    histogram.Observe(0.25);
+    histogram.Observe(2);
+
+    BOOST_CHECK_EQUAL(registry.Render(),
+        "# TYPE test_bytes counter\n"
+        "# HELP test_bytes Bytes\\nsent\n"
+        "test_bytes_total 42\n"
+        "# TYPE test_calls counter\n"
+        "# HELP test_calls Calls\n"
+        "test_calls_total{method=\"a\\\"b\\\\c\"} 1\n"
+        "# TYPE test_peers gauge\n"
+        "# HELP test_peers Connected peers\n"
+        "test_peers{direction=\"in\"} 3\n"
+        "test_peers{direction=\"out\"} 8\n"
+        "# TYPE test_seconds histogram\n"
+        "# HELP test_seconds Durations\n"
+        "test_seconds_bucket{le=\"0.5\"} 1\n"
+        "test_seconds_bucket{le=\"1\"} 1\n"
+        "test_seconds_bucket{le=\"+Inf\"} 2\n"
+        "test_seconds_count 2\n"
+        "test_seconds_sum 2.25\n"
+        "# EOF\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,12 +11,14 @@
 #include <interfaces/mining.h>
 #include <node/miner.h>
 #include <policy/policy.h>
+#include <streams.h>
 #include <test/util/random.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/feefrac.h>
+#include <util/shm.h>
 #include <util/strencodings.h>
 #include <util/time.h>
 #include <util/translation.h>
@@ -151,6 +153,21 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     BOOST_CHECK(block.vtx[2]->GetHash() == hashHighFeeTx);
     BOOST_CHECK(block.vtx[3]->GetHash() == hashMediumFeeTx);
 
+#ifndef WIN32
+    // The block shared with other processes is the one getBlock() returns.
+    const auto shm_ref{block_template->getBlockSharedMemory()};
+    BOOST_REQUIRE(shm_ref);
+    {
+        const auto shm{SharedMemory::Open(shm_ref->name, shm_ref->size)};
+        BOOST_REQUIRE(shm);
+        CBlock shared_block;
+        SpanReader{shm->Data()} >> TX_WITH_WITNESS(shared_block);
+        BOOST_CHECK(shared_block.GetHash() == block.GetHash());
+        BOOST_CHECK_EQUAL(shared_block.vtx.size(), block.vtx.size());
+    }
+    BOOST_CHECK_EQUAL(block_template->getBlockSharedMemory()->name, shm_ref->name);
+#endif
+
     // Test the inclusion of package feerates in the block template and ensure they are sequential.
     const auto block_package_feerates = BlockAssembler{m_node.chainman->ActiveChainstate(), &tx_mempool, options}.CreateNewBlock()->m_package_feerates;
     BOOST_CHECK(block_package_feerates.size() == 2);
@@ -202,6 +219,8 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     AddToMempool(tx_mempool, entry.Fee(feeToUse + 2).FromTx(tx));
 
     // waitNext() should return if fees for the new template are at least 1 sat up
+    BOOST_CHECK(!block_template->getDiff());
+    const CBlock previous_block{block};
     block_template = block_template->waitNext({.fee_threshold = 1});
     BOOST_REQUIRE(block_template);
     block = block_template->getBlock();
@@ -209,6 +228,21 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     BOOST_CHECK(block.vtx[4]->GetHash() == hashFreeTx);
     BOOST_CHECK(block.vtx[5]->GetHash() == hashLowFeeTx);
 
+    // The diff turns the previous block into the new one
+    const auto diff{block_template->getDiff()};
+    BOOST_REQUIRE(diff);
+    BOOST_CHECK(diff->removed.empty());
+    BOOST_REQUIRE_EQUAL(diff->added.size(), 2U);
+    BOOST_CHECK_EQUAL(diff->coinbase_value_change, block.vtx[0]->GetValueOut() - previous_block.vtx[0]->GetValueOut());
+    BOOST_CHECK_GT(diff->coinbase_value_change, 0);
+    auto added{diff->added.begin()};
+    BOOST_REQUIRE_EQUAL(diff->order.size(), block.vtx.size() - 1);
+    for (size_t i{0}; i < diff->order.size(); ++i) {
+        const CTransactionRef& tx{diff->order[i] == -1 ? *added++ : previous_block.vtx.at(diff->order[i] + 1)};
+        BOOST_CHECK(tx->GetHash() == block.vtx[i + 1]->GetHash());
+    }
+    BOOST_CHECK(added == diff->added.end());
+
     // Test that transaction selection properly updates ancestor fee
     // calculations as ancestor transactions get included in a block.
     // Add a 0-fee transaction that has 2 outputs.
@@ -782,4 +816,50 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     TestPrioritisedMining(scriptPubKey, txFirst);
 }
 
+BOOST_FIXTURE_TEST_CASE(block_template_cache, TestChain100Setup)
+{
+    node::BlockTemplateCache cache;
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    CTxMemPool& mempool{*Assert(m_node.mempool)};
+    BlockAssembler::Options options;
+    options.test_block_validity = false;
+    TestMemPoolEntryHelper entry;
+    const auto spend{[&](size_t i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{m_coinbase_txns[i]->GetHash(), 0});
+        tx.vout.emplace_back(m_coinbase_txns[i]->vout[0].nValue - 1000, CScript{} << OP_TRUE);
+        const auto tx_ref{MakeTransactionRef(tx)};
+        LOCK2(cs_main, mempool.cs);
+        AddToMempool(mempool, entry.Fee(1000).SpendsCoinbase(true).FromTx(tx_ref));
+        return tx_ref;
+    }};
+    const auto template_txs{[&](std::chrono::seconds max_age) {
+        const auto block_template{cache.CreateNewBlock(chainstate, &mempool, options, max_age)};
+        std::set<Txid> txids;
+        for (const auto& tx : std::span{block_template->block.vtx}.subspan(1)) txids.insert(tx->GetHash());
+        return txids;
+    }};
+
+    BOOST_CHECK(template_txs(0s).empty());
+    const auto a{spend(0)};
+    BOOST_CHECK(template_txs(0s) == std::set{a->GetHash()});
+
+    // Within the maximum age the cached template is reused after additions,
+    // but not once one of its transactions left the mempool.
+    const auto b{spend(1)};
+    BOOST_CHECK(template_txs(1h) == std::set{a->GetHash()});
+    WITH_LOCK(mempool.cs, mempool.removeRecursive(*a, MemPoolRemovalReason::REPLACED));
+    BOOST_CHECK(template_txs(1h) == std::set{b->GetHash()});
+
+    const auto c{spend(2)};
+    BOOST_CHECK(template_txs(0s) == std::set({b->GetHash(), c->GetHash()}));
+
+    // A new tip always causes a new template.
+    const auto tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    CreateAndProcessBlock({}, CScript{} << OP_TRUE);
+    BOOST_CHECK(WITH_LOCK(cs_main, return chainstate.m_chain.Tip()->GetBlockHash()) != tip);
+    BOOST_CHECK_EQUAL(cache.CreateNewBlock(chainstate, &mempool, options, 1h)->block.hashPrevBlock,
+                      WITH_LOCK(cs_main, return chainstate.m_chain.Tip()->GetBlockHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
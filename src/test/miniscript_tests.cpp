@@ -472,6 +472,15 @@ void Test(const std::string& ms, const std::string& hexscript, int mode, const K
         if (stacklimit != -1) BOOST_CHECK_MESSAGE((int)*node->GetStackSize() == stacklimit, "Stack limit mismatch: " << ms << " (" << *node->GetStackSize() << " vs " << stacklimit << ")");
         if (max_wit_size) BOOST_CHECK_MESSAGE(*node->GetWitnessSize() == *max_wit_size, "Witness size limit mismatch: " << ms << " (" << *node->GetWitnessSize() << " vs " << *max_wit_size << ")");
         if (stack_exec) BOOST_CHECK_MESSAGE(*node->GetExecStackSize() == *stack_exec, "Stack execution limit mismatch: " << ms << " (" << *node->GetExecStackSize() << " vs " << *stack_exec << ")");
+        // A clone has the same script and properties, which are copied rather than recomputed.
+        const auto clone{node->Clone()};
+        BOOST_CHECK_MESSAGE(clone->ToScript(converter) == computed_script, "Clone script mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->GetType() == node->GetType(), "Clone type mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->ScriptSize() == node->ScriptSize(), "Clone script size mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->GetOps() == node->GetOps(), "Clone ops mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->GetStackSize() == node->GetStackSize(), "Clone stack size mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->GetWitnessSize() == node->GetWitnessSize(), "Clone witness size mismatch: " + ms);
+        BOOST_CHECK_MESSAGE(clone->IsSane() == node->IsSane(), "Clone sanity mismatch: " + ms);
         TestSatisfy(converter, ms, node);
     }
 }
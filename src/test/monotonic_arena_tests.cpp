@@ -0,0 +1,86 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <support/allocators/monotonic_arena.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(monotonic_arena_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(allocating)
+{
+    MonotonicArena arena{64};
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 0U);
+
+    // Allocations follow each other in a chunk, aligned as requested.
+    auto* a{static_cast<std::byte*>(arena.Allocate(1, 1))};
+    auto* b{static_cast<std::byte*>(arena.Allocate(8, 8))};
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(b) % 8, 0U);
+    BOOST_CHECK(b > a && b - a <= 8);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 1U);
+
+    // Allocations larger than a chunk get their own.
+    arena.Allocate(100, 8);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 2U);
+    // Allocations not fitting the rest of the chunk get a new one.
+    arena.Allocate(60, 8);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(shared_ownership)
+{
+    auto arena{std::make_shared<MonotonicArena>(1024)};
+    const std::weak_ptr<MonotonicArena> weak_arena{arena};
+    auto first{std::allocate_shared<const uint64_t>(MonotonicArenaAllocator<uint64_t>{arena}, 1)};
+    auto second{std::allocate_shared<const uint64_t>(MonotonicArenaAllocator<uint64_t>{arena}, 2)};
+    BOOST_CHECK_EQUAL(arena->NumChunks(), 1U);
+
+    // The objects keep the arena alive until the last of them is freed.
+    arena.reset();
+    first.reset();
+    BOOST_CHECK(!weak_arena.expired());
+    BOOST_CHECK_EQUAL(*second, 2U);
+    second.reset();
+    BOOST_CHECK(weak_arena.expired());
+}
+
+BOOST_AUTO_TEST_CASE(block_transactions)
+{
+    CBlock block;
+    for (uint32_t i{0}; i < 10; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+        if (i % 2) tx.vin[0].scriptWitness.stack.push_back(m_rng.randbytes(72));
+        tx.vout.emplace_back(i, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+
+    std::vector<CTransactionRef> kept;
+    {
+        CBlock deserialized;
+        stream >> TX_WITH_WITNESS(deserialized);
+        BOOST_REQUIRE_EQUAL(deserialized.vtx.size(), block.vtx.size());
+        for (size_t i{0}; i < block.vtx.size(); ++i) {
+            BOOST_CHECK_EQUAL(deserialized.vtx[i]->GetHash(), block.vtx[i]->GetHash());
+            BOOST_CHECK_EQUAL(deserialized.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+        }
+        kept = {deserialized.vtx[1], deserialized.vtx[6]};
+    }
+    // Transactions outlive the block they were deserialized with.
+    BOOST_CHECK(*kept[0] == *block.vtx[1]);
+    BOOST_CHECK(*kept[1] == *block.vtx[6]);
+    BOOST_CHECK(kept[0]->vin[0].scriptWitness.stack == block.vtx[1]->vin[0].scriptWitness.stack);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <netaddress.h>
 #include <net.h>
+#include <node/eviction.h>
 #include <test/util/net.h>
 #include <test/util/setup_common.h>
 
@@ -11,6 +12,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <numeric>
 #include <optional>
 #include <unordered_set>
 #include <vector>
@@ -682,4 +684,61 @@ BOOST_AUTO_TEST_CASE(peer_eviction_test)
     }
 }
 
+// Random candidates with ids first_id..first_id+n-1 whose eviction order does not depend on
+// how ties are broken: all times differ, and the four highest netgroups are unique.
+static std::vector<NodeEvictionCandidate> GetTieFreeEvictionCandidates(int n, NodeId first_id, FastRandomContext& random_context)
+{
+    const auto permutation = [&] {
+        std::vector<int64_t> values(n);
+        std::iota(values.begin(), values.end(), 0);
+        std::shuffle(values.begin(), values.end(), random_context);
+        return values;
+    };
+    const auto connected{permutation()}, ping{permutation()}, block_time{permutation()}, tx_time{permutation()};
+    std::vector<NodeEvictionCandidate> candidates{GetRandomNodeEvictionCandidates(n, random_context)};
+    for (int i{0}; i < n; ++i) {
+        NodeEvictionCandidate& c{candidates[i]};
+        c.id = first_id + i;
+        c.m_connected = std::chrono::seconds{connected[i]};
+        c.m_min_ping_time = std::chrono::microseconds{ping[i]};
+        c.m_last_block_time = std::chrono::seconds{block_time[i]};
+        c.m_last_tx_time = std::chrono::seconds{tx_time[i]};
+        c.nKeyedNetGroup = i < 4 ? 100 + i : random_context.randrange(8);
+        // Some peers that are never evicted, not among those with a unique netgroup.
+        if (i >= 4 && random_context.randrange(10) == 0) c.m_noban = true;
+        if (i >= 4 && random_context.randrange(10) == 0) c.m_conn_type = ConnectionType::OUTBOUND_FULL_RELAY;
+    }
+    std::shuffle(candidates.begin(), candidates.end(), random_context);
+    return candidates;
+}
+
+BOOST_AUTO_TEST_CASE(incremental_eviction_candidates_test)
+{
+    FastRandomContext random_context{true};
+
+    for (int number_of_nodes = 0; number_of_nodes < 200; ++number_of_nodes) {
+        EvictionCandidates candidates;
+        for (const auto& c : GetTieFreeEvictionCandidates(number_of_nodes, 0, random_context)) {
+            candidates.AddOrUpdate(c);
+        }
+        // Replace the candidates by a fresh set overlapping with the old one, updating the
+        // peers present in both and removing the others.
+        const NodeId first_id = random_context.randrange(number_of_nodes + 1);
+        const int size = random_context.randrange(number_of_nodes + 1);
+        const auto expected{GetTieFreeEvictionCandidates(size, first_id, random_context)};
+        for (NodeId id = 0; id < first_id; ++id) candidates.Remove(id);
+        for (const auto& c : expected) candidates.AddOrUpdate(c);
+        for (NodeId id = first_id + size; id < number_of_nodes; ++id) candidates.Remove(id);
+
+        const size_t eligible = std::count_if(expected.begin(), expected.end(), [](const NodeEvictionCandidate& c) {
+            return !c.m_noban && c.m_conn_type == ConnectionType::INBOUND;
+        });
+        BOOST_CHECK_EQUAL(candidates.Size(), eligible);
+        const std::optional<NodeId> selected{candidates.SelectNodeToEvict()};
+        BOOST_CHECK(selected == SelectNodeToEvict(std::vector{expected}));
+        // Selecting has no side effects.
+        BOOST_CHECK(selected == candidates.SelectNodeToEvict());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net_ratelimit.h>
+#include <protocol.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+
+using namespace std::chrono_literals;
+
+BOOST_FIXTURE_TEST_SUITE(net_ratelimit_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(traffic_classes)
+{
+    BOOST_CHECK(GetTrafficClass(NetMsgType::CMPCTBLOCK) == TrafficClass::PROPAGATION);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::BLOCKTXN) == TrafficClass::PROPAGATION);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::HEADERS) == TrafficClass::PROPAGATION);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::PING) == TrafficClass::PROPAGATION);
+    BOOST_CHECK(GetTrafficClass("") == TrafficClass::PROPAGATION);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::TX) == TrafficClass::TX_RELAY);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::INV) == TrafficClass::TX_RELAY);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::BLOCK) == TrafficClass::BLOCK_SERVING);
+    BOOST_CHECK(GetTrafficClass(NetMsgType::CFILTER) == TrafficClass::BLOCK_SERVING);
+}
+
+BOOST_AUTO_TEST_CASE(unlimited)
+{
+    UploadRateLimiter limiter;
+    const SteadyClock::time_point now{1h};
+    BOOST_CHECK(!limiter.IsLimited());
+    limiter.Consume(TrafficClass::BLOCK_SERVING, 1'000'000, now);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), std::numeric_limits<uint64_t>::max());
+    BOOST_CHECK_EQUAL(limiter.GetStats()[size_t(TrafficClass::BLOCK_SERVING)].bytes_sent, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(weighted_buckets)
+{
+    UploadRateLimiter limiter;
+    limiter.SetRate(10'000, {6, 3, 1});
+    BOOST_CHECK(limiter.IsLimited());
+    SteadyClock::time_point now{1h};
+
+    // All buckets start full, so that any class may use the whole capacity.
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), 10'000U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::PROPAGATION, now), 10'000U);
+
+    // Bulk traffic drains everything.
+    limiter.Consume(TrafficClass::BLOCK_SERVING, 10'000, now);
+    for (size_t i{0}; i < NUM_TRAFFIC_CLASSES; ++i) {
+        BOOST_CHECK_EQUAL(limiter.Available(TrafficClass(i), now), 0U);
+    }
+
+    // Half a second later the buckets hold 3000, 1500 and 500 bytes. None is full, so
+    // only the higher priority classes can borrow, from the lower priority ones.
+    now += 500ms;
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), 500U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::TX_RELAY, now), 2'000U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::PROPAGATION, now), 5'000U);
+
+    // Overspending (e.g. by concurrent senders) leaves the class in debt, even though
+    // it could still borrow from others.
+    limiter.Consume(TrafficClass::TX_RELAY, 3'000, now);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::TX_RELAY, now), 0U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), 0U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::PROPAGATION, now), 3'000U);
+
+    // Buckets refill up to one second worth of tokens; after that they are idle
+    // and lend to anyone.
+    now += 10s;
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), 10'000U);
+
+    // A busy higher priority class keeps its share from the lower priority ones.
+    limiter.Consume(TrafficClass::PROPAGATION, 1, now);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), 4'000U);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::PROPAGATION, now), 9'999U);
+
+    limiter.RecordThrottled(TrafficClass::TX_RELAY);
+    const auto stats{limiter.GetStats()};
+    BOOST_CHECK_EQUAL(stats[size_t(TrafficClass::PROPAGATION)].weight, 6U);
+    BOOST_CHECK_EQUAL(stats[size_t(TrafficClass::PROPAGATION)].bytes_sent, 1U);
+    BOOST_CHECK_EQUAL(stats[size_t(TrafficClass::TX_RELAY)].bytes_sent, 3'000U);
+    BOOST_CHECK_EQUAL(stats[size_t(TrafficClass::TX_RELAY)].throttled, 1U);
+    BOOST_CHECK_EQUAL(stats[size_t(TrafficClass::BLOCK_SERVING)].bytes_sent, 10'000U);
+
+    // Disabling the limit lifts it immediately.
+    limiter.SetRate(0);
+    BOOST_CHECK_EQUAL(limiter.Available(TrafficClass::BLOCK_SERVING, now), std::numeric_limits<uint64_t>::max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
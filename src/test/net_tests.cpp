@@ -16,6 +16,7 @@
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <test/util/net.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <test/util/validation.h>
@@ -29,7 +30,9 @@
 #include <ios>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
 
 using namespace std::literals;
 using namespace util::hex_literals;
@@ -888,6 +891,53 @@ BOOST_AUTO_TEST_CASE(initial_advertise_from_version_message)
     m_node.args->ForceSetArg("-bind", "");
 }
 
+BOOST_AUTO_TEST_CASE(process_peer_local_message)
+{
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    CNode peer{/*id=*/0,
+               /*sock=*/nullptr,
+               /*addrIn=*/CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               /*addrBindIn=*/CService{},
+               /*addrNameIn=*/std::string{},
+               /*conn_type_in=*/ConnectionType::INBOUND,
+               /*inbound_onion=*/false};
+    {
+        LOCK(NetEventsInterface::g_msgproc_mutex);
+        connman.Handshake(peer,
+                          /*successfully_connected=*/true,
+                          /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*version=*/PROTOCOL_VERSION,
+                          /*relay_txs=*/true);
+        connman.FlushSendBuffer(peer);
+    }
+
+    (void)connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::PING, uint64_t{42}));
+    (void)connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::GETADDR));
+    peer.fPauseSend = false;
+
+    // The ping is answered without g_msgproc_mutex.
+    BOOST_CHECK(m_node.peerman->ProcessPeerLocalMessage(&peer));
+    {
+        LOCK(peer.cs_vSend);
+        const auto& [to_send, _more, msg_type] = peer.m_transport->GetBytesToSend(false);
+        BOOST_CHECK(!to_send.empty());
+        BOOST_CHECK_EQUAL(msg_type, NetMsgType::PONG);
+    }
+    connman.FlushSendBuffer(peer);
+
+    // The getaddr is left in the queue for ProcessMessages().
+    BOOST_CHECK(!m_node.peerman->ProcessPeerLocalMessage(&peer));
+    {
+        LOCK(NetEventsInterface::g_msgproc_mutex);
+        connman.ProcessMessagesOnce(peer);
+    }
+    BOOST_CHECK(!peer.PollMessage());
+
+    m_node.peerman->FinalizeNode(peer);
+}
 
 BOOST_AUTO_TEST_CASE(advertise_local_address)
 {
@@ -1546,4 +1596,183 @@ BOOST_AUTO_TEST_CASE(v2transport_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(v1transport_next_bytes_to_send)
+{
+    V1Transport sender{/*node_id=*/0};
+    V1Transport receiver{/*node_id=*/1};
+
+    CSerializedNetMsg msg{NetMsg::Make(NetMsgType::PING, uint64_t{0x1122334455667788})};
+    BOOST_REQUIRE(sender.SetMessageToSend(msg));
+
+    // While sending the header, the payload is available as well.
+    std::vector<uint8_t> wire;
+    {
+        const auto& [to_send, more, msg_type] = sender.GetBytesToSend(/*have_next_message=*/false);
+        BOOST_CHECK_EQUAL(to_send.size(), CMessageHeader::HEADER_SIZE);
+        BOOST_CHECK(more);
+        const auto next{sender.GetNextBytesToSend()};
+        BOOST_CHECK_EQUAL(next.size(), sizeof(uint64_t));
+        wire.insert(wire.end(), to_send.begin(), to_send.end());
+        wire.insert(wire.end(), next.begin(), next.end());
+    }
+
+    // Sending both partially leaves the rest of the payload to send.
+    sender.MarkBytesSent(CMessageHeader::HEADER_SIZE + 3);
+    {
+        const auto& [to_send, more, msg_type] = sender.GetBytesToSend(/*have_next_message=*/false);
+        BOOST_CHECK_EQUAL(to_send.size(), sizeof(uint64_t) - 3);
+        BOOST_CHECK(!more);
+        BOOST_CHECK(std::ranges::equal(to_send, std::span{wire}.subspan(CMessageHeader::HEADER_SIZE + 3)));
+        BOOST_CHECK(sender.GetNextBytesToSend().empty());
+    }
+    BOOST_CHECK(!sender.SetMessageToSend(msg));
+    sender.MarkBytesSent(sizeof(uint64_t) - 3);
+    BOOST_CHECK(std::get<0>(sender.GetBytesToSend(/*have_next_message=*/false)).empty());
+
+    // The bytes form a valid message.
+    std::span<const uint8_t> to_recv{wire};
+    BOOST_REQUIRE(receiver.ReceivedBytes(to_recv));
+    BOOST_REQUIRE(to_recv.empty());
+    BOOST_REQUIRE(receiver.ReceivedMessageComplete());
+    bool reject{false};
+    CNetMessage received{receiver.GetReceivedMessage(/*time=*/{}, reject)};
+    BOOST_CHECK(!reject);
+    BOOST_CHECK_EQUAL(received.m_type, NetMsgType::PING);
+    BOOST_CHECK_EQUAL(received.m_recv.size(), sizeof(uint64_t));
+
+    // A message without payload has nothing to send after its header.
+    CSerializedNetMsg verack{NetMsg::Make(NetMsgType::VERACK)};
+    BOOST_REQUIRE(sender.SetMessageToSend(verack));
+    BOOST_CHECK(sender.GetNextBytesToSend().empty());
+    sender.MarkBytesSent(CMessageHeader::HEADER_SIZE);
+    BOOST_CHECK(std::get<0>(sender.GetBytesToSend(/*have_next_message=*/false)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(shared_payload_send)
+{
+    CSerializedNetMsg msg{NetMsg::Make(NetMsgType::PING, uint64_t{0x1122334455667788})};
+    const std::vector<unsigned char> payload{msg.data};
+    const size_t owned_usage{msg.GetMemoryUsage()};
+    msg.MakeShared();
+    BOOST_CHECK(msg.data.empty());
+    BOOST_CHECK(std::ranges::equal(msg.Payload(), payload));
+    // The shared payload is still accounted for.
+    BOOST_CHECK_GE(msg.GetMemoryUsage(), owned_usage);
+
+    // Copies share the payload instead of duplicating it.
+    CSerializedNetMsg copy1{msg.Copy()};
+    CSerializedNetMsg copy2{msg.Copy()};
+    BOOST_CHECK_EQUAL(copy1.Payload().data(), msg.Payload().data());
+    BOOST_CHECK_EQUAL(msg.m_shared_data.use_count(), 3);
+
+    // Sending a copy releases its reference, and leaves the others intact.
+    V1Transport sender{/*node_id=*/0};
+    V1Transport receiver{/*node_id=*/1};
+    BOOST_REQUIRE(sender.SetMessageToSend(copy1));
+    std::vector<uint8_t> wire;
+    while (true) {
+        const auto& [to_send, more, msg_type] = sender.GetBytesToSend(/*have_next_message=*/false);
+        if (to_send.empty()) break;
+        wire.insert(wire.end(), to_send.begin(), to_send.end());
+        sender.MarkBytesSent(to_send.size());
+    }
+    BOOST_CHECK_EQUAL(msg.m_shared_data.use_count(), 2);
+    BOOST_CHECK(std::ranges::equal(copy2.Payload(), payload));
+
+    std::span<const uint8_t> to_recv{wire};
+    BOOST_REQUIRE(receiver.ReceivedBytes(to_recv));
+    BOOST_REQUIRE(receiver.ReceivedMessageComplete());
+    bool reject{false};
+    CNetMessage received{receiver.GetReceivedMessage(/*time=*/{}, reject)};
+    BOOST_CHECK(!reject);
+    BOOST_CHECK_EQUAL(received.m_type, NetMsgType::PING);
+    BOOST_CHECK(std::ranges::equal(MakeUCharSpan(received.m_recv), payload));
+
+}
+
+BOOST_AUTO_TEST_CASE(data_stream_pool)
+{
+    DataStreamPool pool{/*max_buffer_bytes=*/10000, /*max_total_bytes=*/15000};
+    BOOST_CHECK_EQUAL(pool.Get().GetMemoryUsage(), sizeof(DataStream));
+
+    // Returned buffers are handed out again, emptied.
+    DataStream stream{pool.Get()};
+    stream.resize(4000);
+    stream.ignore(100);
+    const auto* buffer{stream.data() - 100};
+    pool.Return(std::move(stream));
+    BOOST_CHECK_EQUAL(pool.NumBuffers(), 1U);
+    DataStream reused{pool.Get()};
+    BOOST_CHECK(reused.empty());
+    BOOST_CHECK_EQUAL(reused.data(), buffer);
+    BOOST_CHECK_EQUAL(pool.NumBuffers(), 0U);
+    BOOST_CHECK_EQUAL(pool.TotalBytes(), 0U);
+
+    // Buffers too large, or over the total, are freed.
+    DataStream large;
+    large.resize(20000);
+    pool.Return(std::move(large));
+    BOOST_CHECK_EQUAL(pool.NumBuffers(), 0U);
+    for (int i{0}; i < 5; ++i) {
+        DataStream s;
+        s.resize(4000);
+        pool.Return(std::move(s));
+    }
+    BOOST_CHECK_EQUAL(pool.NumBuffers(), 3U);
+    BOOST_CHECK_LE(pool.TotalBytes(), 15000U);
+
+    // Messages return their buffer to the pool of received messages.
+    const size_t num_buffers{RecvBufferPool().NumBuffers()};
+    {
+        DataStream recv;
+        recv.resize(1000);
+        CNetMessage msg{std::move(recv)};
+    }
+    BOOST_CHECK_EQUAL(RecvBufferPool().NumBuffers(), num_buffers + 1);
+}
+
+BOOST_AUTO_TEST_CASE(ellswift_key_pool)
+{
+    EllSwiftKeyPool pool{/*target_size=*/4};
+
+    // Keys are generated on the spot until the pool is started.
+    const EllSwiftKeyPool::Key first{pool.Get()};
+    BOOST_CHECK(first.pubkey.Decode() == first.key.GetPubKey());
+    BOOST_CHECK_EQUAL(pool.Misses(), 1U);
+    BOOST_CHECK_EQUAL(pool.Size(), 0U);
+
+    // Once started, the pool is filled up to its target size, and refilled as keys are taken.
+    pool.Start();
+    std::set<CPubKey> pubkeys{first.key.GetPubKey()};
+    for (int i{0}; i < 10; ++i) {
+        while (pool.Size() < pool.TargetSize()) std::this_thread::sleep_for(1ms);
+        const EllSwiftKeyPool::Key key{pool.Get()};
+        BOOST_CHECK(key.pubkey.Decode() == key.key.GetPubKey());
+        // Each key is only handed out once.
+        BOOST_CHECK(pubkeys.insert(key.key.GetPubKey()).second);
+    }
+    BOOST_CHECK_EQUAL(pool.Misses(), 1U);
+    pool.Stop();
+
+    // After stopping, the remaining keys can still be used.
+    while (pool.Size() > 0) BOOST_CHECK(pubkeys.insert(pool.Get().key.GetPubKey()).second);
+    BOOST_CHECK_EQUAL(pool.Misses(), 1U);
+
+    // V2 transports taking their key from the pool complete a handshake with each other.
+    V2Transport initiator{/*nodeid=*/0, /*initiating=*/true, pool};
+    V2Transport responder{/*nodeid=*/1, /*initiating=*/false, pool};
+    BOOST_CHECK_EQUAL(pool.Misses(), 3U);
+    for (int i{0}; i < 4; ++i) {
+        for (auto [from, to] : {std::pair{&initiator, &responder}, std::pair{&responder, &initiator}}) {
+            const auto& [bytes, _more, _type] = from->GetBytesToSend(/*have_next_message=*/false);
+            std::span<const uint8_t> msg_bytes{bytes};
+            const size_t size{msg_bytes.size()};
+            BOOST_REQUIRE(to->ReceivedBytes(msg_bytes));
+            from->MarkBytesSent(size);
+        }
+    }
+    BOOST_CHECK(initiator.GetInfo().session_id);
+    BOOST_CHECK(initiator.GetInfo().session_id == responder.GetInfo().session_id);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
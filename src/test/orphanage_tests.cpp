@@ -4,6 +4,7 @@
 
 #include <arith_uint256.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <pubkey.h>
@@ -511,6 +512,31 @@ BOOST_AUTO_TEST_CASE(multiple_announcers)
         BOOST_CHECK_EQUAL(orphanage.Size(), expected_total_count);
     }
 }
+BOOST_AUTO_TEST_CASE(memory_usage)
+{
+    FastRandomContext det_rand{true};
+    TxOrphanage orphanage;
+    const size_t empty_usage{orphanage.DynamicMemoryUsage()};
+
+    auto ptx = MakeTransactionSpending({}, det_rand);
+    BOOST_CHECK(orphanage.AddTx(ptx, /*peer=*/0));
+    const size_t usage{orphanage.DynamicMemoryUsage()};
+    // At least the transaction itself is accounted for.
+    BOOST_CHECK_GT(usage, empty_usage + RecursiveDynamicUsage(*ptx));
+
+    // Another announcer only adds to the set of announcers.
+    BOOST_CHECK(orphanage.AddAnnouncer(ptx->GetWitnessHash(), /*peer=*/1));
+    BOOST_CHECK_GT(orphanage.DynamicMemoryUsage(), usage);
+    BOOST_CHECK_LT(orphanage.DynamicMemoryUsage(), usage + RecursiveDynamicUsage(*ptx));
+
+    // Erasing the orphan releases the transaction, only the capacity of the
+    // eviction list is kept.
+    orphanage.EraseForPeer(0);
+    orphanage.EraseForPeer(1);
+    BOOST_CHECK_EQUAL(orphanage.Size(), 0U);
+    BOOST_CHECK_LT(orphanage.DynamicMemoryUsage(), empty_usage + RecursiveDynamicUsage(*ptx));
+}
+
 BOOST_AUTO_TEST_CASE(peer_worksets)
 {
     const NodeId node0{0};
@@ -265,4 +265,65 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimatesWorker)
+{
+    // Estimates of an estimator applying events on its worker match those of
+    // one applying them right away.
+    CBlockPolicyEstimator direct{FeeestPath(*m_node.args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    CBlockPolicyEstimator worker{FeeestPath(*m_node.args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    worker.StartWorker();
+    CTxMemPool& mpool = *Assert(m_node.mempool);
+    m_node.validation_signals->RegisterValidationInterface(&direct);
+    m_node.validation_signals->RegisterValidationInterface(&worker);
+    TestMemPoolEntryHelper entry;
+
+    const auto check_estimates{[&] {
+        m_node.validation_signals->SyncWithValidationInterfaceQueue();
+        worker.SyncWithWorker();
+        for (const bool conservative : {false, true}) {
+            for (int target{1}; target <= 30; ++target) {
+                FeeCalculation calc_direct, calc_worker, calc_cached;
+                const CFeeRate feerate{direct.estimateSmartFee(target, &calc_direct, conservative)};
+                BOOST_CHECK(worker.estimateSmartFee(target, &calc_worker, conservative) == feerate);
+                BOOST_CHECK_EQUAL(calc_worker.returnedTarget, calc_direct.returnedTarget);
+                // Served from the cache the second time.
+                BOOST_CHECK(worker.estimateSmartFee(target, &calc_cached, conservative) == feerate);
+                BOOST_CHECK_EQUAL(calc_cached.returnedTarget, calc_direct.returnedTarget);
+            }
+        }
+    }};
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    std::vector<std::pair<CAmount, CTransactionRef>> mempool_txs;
+    for (int blocknum{0}; blocknum < 60; ++blocknum) {
+        for (int j{0}; j < 20; ++j) {
+            tx.vin[0].prevout.n = 100 * blocknum + j;
+            const CTransactionRef ptx{MakeTransactionRef(tx)};
+            const CAmount fee{1000 * (j + 1)};
+            LOCK2(cs_main, mpool.cs);
+            AddToMempool(mpool, entry.Fee(fee).Height(blocknum).FromTx(ptx));
+            m_node.validation_signals->TransactionAddedToMempool(
+                NewMempoolTransactionInfo(ptx, fee, GetVirtualTransactionSize(*ptx), blocknum,
+                                          /*mempool_limit_bypassed=*/false, /*submitted_in_package=*/false,
+                                          /*chainstate_is_current=*/true, /*has_no_mempool_parents=*/true),
+                mpool.GetAndIncrementSequence());
+            mempool_txs.emplace_back(fee, ptx);
+        }
+        // Confirm the higher fee half of the transactions.
+        std::sort(mempool_txs.begin(), mempool_txs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<CTransactionRef> block;
+        for (size_t i{mempool_txs.size() / 2}; i < mempool_txs.size(); ++i) block.push_back(mempool_txs[i].second);
+        mempool_txs.resize(mempool_txs.size() / 2);
+        WITH_LOCK(mpool.cs, mpool.removeForBlock(block, blocknum + 1));
+        if (blocknum % 20 == 19) check_estimates();
+    }
+    BOOST_CHECK(worker.estimateSmartFee(2, nullptr, false) != CFeeRate(0));
+
+    m_node.validation_signals->UnregisterValidationInterface(&worker);
+    m_node.validation_signals->UnregisterValidationInterface(&direct);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
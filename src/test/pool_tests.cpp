@@ -154,6 +154,26 @@ BOOST_AUTO_TEST_CASE(random_allocations)
     PoolResourceTester::CheckAllDataAccountedFor(resource);
 }
 
+BOOST_AUTO_TEST_CASE(huge_pages)
+{
+    auto resource = PoolResource<128, 8>(HUGE_PAGE_SIZE, /*huge_pages=*/true);
+    BOOST_TEST(resource.ChunkSizeBytes() == HUGE_PAGE_SIZE);
+
+    // Blocks are carved from the start of the chunks, which are aligned to huge pages.
+    std::vector<void*> blocks;
+    for (size_t i = 0; i <= HUGE_PAGE_SIZE / 128; ++i) {
+        blocks.push_back(resource.Allocate(128, 8));
+    }
+    BOOST_TEST(resource.NumAllocatedChunks() == 2U);
+    BOOST_TEST(reinterpret_cast<uintptr_t>(blocks.front()) % HUGE_PAGE_SIZE == 0U);
+    BOOST_TEST(reinterpret_cast<uintptr_t>(blocks.back()) % HUGE_PAGE_SIZE == 0U);
+
+    for (void* block : blocks) {
+        resource.Deallocate(block, 128, 8);
+    }
+    PoolResourceTester::CheckAllDataAccountedFor(resource);
+}
+
 BOOST_AUTO_TEST_CASE(memusage_test)
 {
     auto std_map = std::unordered_map<int64_t, int64_t>{};
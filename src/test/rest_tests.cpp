@@ -8,6 +8,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <string>
+#include <string_view>
 
 BOOST_FIXTURE_TEST_SUITE(rest_tests, BasicTestingSetup)
 
@@ -45,4 +46,47 @@ BOOST_AUTO_TEST_CASE(test_query_string)
     BOOST_CHECK_EQUAL(param, "/rest/endpoint/someresource");
     BOOST_CHECK_EQUAL(rf, RESTResponseFormat::UNDEF);
 }
+BOOST_AUTO_TEST_CASE(test_etag_matches)
+{
+    BOOST_CHECK(ETagMatches("\"abc.bin\"", "\"abc.bin\""));
+    BOOST_CHECK(ETagMatches(" \"x\", \"abc.bin\" ", "\"abc.bin\""));
+    BOOST_CHECK(ETagMatches("W/\"abc.bin\"", "\"abc.bin\""));
+    BOOST_CHECK(ETagMatches("*", "\"abc.bin\""));
+    BOOST_CHECK(!ETagMatches("\"abc.hex\"", "\"abc.bin\""));
+    BOOST_CHECK(!ETagMatches("abc.bin", "\"abc.bin\""));
+    BOOST_CHECK(!ETagMatches("", "\"abc.bin\""));
+}
+
+BOOST_AUTO_TEST_CASE(test_byte_range)
+{
+    bool unsatisfiable;
+    const auto check{[&](std::string_view header, size_t first, size_t last) {
+        const auto range{ParseByteRange(header, 100, unsatisfiable)};
+        BOOST_REQUIRE(range);
+        BOOST_CHECK(!unsatisfiable);
+        BOOST_CHECK_EQUAL(range->first, first);
+        BOOST_CHECK_EQUAL(range->last, last);
+    }};
+    check("bytes=0-9", 0, 9);
+    check("bytes=10-", 10, 99);
+    check("bytes=90-200", 90, 99);
+    check("bytes=-10", 90, 99);
+    check("bytes=-1000", 0, 99);
+    check(" bytes=5-5", 5, 5);
+
+    // Ignored: the whole body is sent
+    for (const auto header : {"", "bytes=", "bytes=-", "bytes=9-0", "bytes=a-b", "bytes=0-1,5-6", "items=0-1", "bytes=1"}) {
+        BOOST_CHECK(!ParseByteRange(header, 100, unsatisfiable));
+        BOOST_CHECK(!unsatisfiable);
+    }
+
+    // Unsatisfiable
+    for (const auto header : {"bytes=100-", "bytes=200-300", "bytes=-0"}) {
+        BOOST_CHECK(!ParseByteRange(header, 100, unsatisfiable));
+        BOOST_CHECK(unsatisfiable);
+    }
+    BOOST_CHECK(!ParseByteRange("bytes=-5", 0, unsatisfiable));
+    BOOST_CHECK(unsatisfiable);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,9 +4,11 @@
 
 #include <core_io.h>
 #include <interfaces/chain.h>
+#include <node/blockstats.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
 #include <rpc/client.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <test/util/setup_common.h>
@@ -17,6 +19,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+using node::CalculatePercentilesByWeight;
+using node::NUM_GETBLOCKSTATS_PERCENTILES;
 using util::SplitString;
 
 static UniValue JSON(std::string_view json)
@@ -639,4 +643,47 @@ BOOST_AUTO_TEST_CASE(rpc_arg_helper)
     CheckRpc(params, UniValue{JSON(R"([5, "hello", 4, "test", true, 1.23, "world"])")}, check_positional);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_json_stream_writer)
+{
+    UniValue inner{UniValue::VOBJ};
+    inner.pushKV("a", 1);
+    inner.pushKV("b\"", UniValue{UniValue::VARR});
+    UniValue expected{UniValue::VOBJ};
+    expected.pushKV("hash", "00ff");
+    expected.pushKV("size", 42);
+    UniValue txs{UniValue::VARR};
+    for (int i{0}; i < 100; ++i) txs.push_back(inner);
+    expected.pushKV("tx", txs);
+    expected.pushKV("empty", UniValue{UniValue::VOBJ});
+
+    std::vector<std::string> chunks;
+    JSONStreamWriter stream{[&](std::string&& chunk) { chunks.push_back(std::move(chunk)); }, R"({"result":)", /*flush_size=*/64};
+    BOOST_CHECK(!stream.Started());
+    stream.BeginObject();
+    BOOST_CHECK(stream.Started());
+    stream.KeyValue("hash", "00ff");
+    stream.KeyValue("size", 42);
+    stream.Key("tx");
+    stream.BeginArray();
+    for (int i{0}; i < 100; ++i) stream.Value(inner);
+    stream.EndArray();
+    stream.Key("empty");
+    stream.BeginObject();
+    stream.EndObject();
+    stream.EndObject();
+    stream.Finish("}");
+
+    // The output was handed over in several chunks of roughly the flush size.
+    BOOST_CHECK_GT(chunks.size(), 10U);
+    std::string output;
+    for (const auto& chunk : chunks) output += chunk;
+    BOOST_CHECK_EQUAL(output, R"({"result":)" + expected.write() + "}");
+
+    // Nothing is written when nothing was streamed.
+    chunks.clear();
+    JSONStreamWriter unused{[&](std::string&& chunk) { chunks.push_back(std::move(chunk)); }, "prefix"};
+    unused.Finish("suffix");
+    BOOST_CHECK(chunks.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <functional>
+#include <future>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -212,4 +213,36 @@ BOOST_AUTO_TEST_CASE(mockforward)
     BOOST_CHECK(delta > 2*60 && delta < 3*60);
 }
 
+BOOST_AUTO_TEST_CASE(task_classes)
+{
+    CScheduler scheduler;
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future()};
+    std::promise<void> background_started;
+    scheduler.schedule([&] {
+        background_started.set_value();
+        released.wait();
+    }, std::chrono::steady_clock::now(), CScheduler::TaskClass::BACKGROUND);
+
+    // A thread servicing the default tasks does not run background tasks.
+    scheduler.m_service_thread = std::thread([&] { scheduler.serviceTaskClass(CScheduler::TaskClass::DEFAULT); });
+    std::promise<void> default_done;
+    scheduler.scheduleFromNow([&] { default_done.set_value(); }, std::chrono::milliseconds{1});
+    default_done.get_future().wait();
+    std::chrono::steady_clock::time_point first, last;
+    BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 1U);
+
+    // Default tasks still run while a background task is running.
+    scheduler.m_background_thread = std::thread([&] { scheduler.serviceTaskClass(CScheduler::TaskClass::BACKGROUND); });
+    background_started.get_future().wait();
+    std::promise<void> default_done_again;
+    scheduler.scheduleFromNow([&] { default_done_again.set_value(); }, std::chrono::milliseconds{1});
+    default_done_again.get_future().wait();
+    BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 0U);
+
+    release.set_value();
+    scheduler.stop();
+    BOOST_CHECK(!scheduler.AreThreadsServicingQueue());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,75 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/scripthashindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(scripthashindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(scripthashindex_history, TestChain100Setup)
+{
+    ScriptHashIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+    index.Sync();
+
+    // All test chain blocks pay to the coinbase key, from height 1 on.
+    const uint256 coinbase_hash{ComputeScriptHash(m_coinbase_txns[0]->vout[0].scriptPubKey)};
+    std::vector<ScriptHashTxRef> history;
+    std::optional<int> next_height;
+    BOOST_REQUIRE(index.FindHistory(coinbase_hash, 0, 1000, 1000, history, next_height));
+    BOOST_CHECK(!next_height);
+    BOOST_REQUIRE_EQUAL(history.size(), m_coinbase_txns.size());
+    for (size_t i{0}; i < history.size(); ++i) {
+        BOOST_CHECK_EQUAL(history[i].height, int(i + 1));
+        BOOST_CHECK_EQUAL(history[i].tx_pos, 0U);
+        BOOST_CHECK(!history[i].spending);
+    }
+
+    // Lookups are paged, and limited to a range of heights.
+    BOOST_REQUIRE(index.FindHistory(coinbase_hash, 5, 1000, 10, history, next_height));
+    BOOST_CHECK_EQUAL(history.size(), 10U);
+    BOOST_CHECK_EQUAL(history.front().height, 5);
+    BOOST_CHECK_EQUAL(next_height.value_or(0), 15);
+    BOOST_REQUIRE(index.FindHistory(coinbase_hash, 20, 29, 1000, history, next_height));
+    BOOST_CHECK_EQUAL(history.size(), 10U);
+    BOOST_CHECK(!next_height);
+
+    // Spend a coinbase to a new script in a block paying to yet another one.
+    const CScript dest_script{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    const CScript miner_script{GetScriptForDestination(WitnessV0KeyHash(GenerateRandomKey().GetPubKey()))};
+    CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, dest_script, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    CreateAndProcessBlock({spend}, miner_script);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+    const int height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Height())};
+
+    BOOST_REQUIRE(index.FindHistory(coinbase_hash, height, height, 1000, history, next_height));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].tx_pos, 1U);
+    BOOST_CHECK(history[0].spending);
+
+    BOOST_REQUIRE(index.FindHistory(ComputeScriptHash(dest_script), 0, height, 1000, history, next_height));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].height, height);
+    BOOST_CHECK_EQUAL(history[0].tx_pos, 1U);
+    BOOST_CHECK(!history[0].spending);
+
+    BOOST_REQUIRE(index.FindHistory(ComputeScriptHash(miner_script), 0, height, 1000, history, next_height));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].tx_pos, 0U);
+
+    // Unknown scripts have no history.
+    BOOST_REQUIRE(index.FindHistory(uint256::ONE, 0, height, 1000, history, next_height));
+    BOOST_CHECK(history.empty());
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,7 +6,9 @@
 #include <serialize.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
 #include <util/strencodings.h>
+#include <util/transaction_identifier.h>
 
 #include <cstdint>
 #include <string>
@@ -193,6 +195,47 @@ BOOST_AUTO_TEST_CASE(vector_bool)
     BOOST_CHECK((HashWriter{} << vec1).GetHash() == (HashWriter{} << vec2).GetHash());
 }
 
+template <typename T>
+void CheckBulkVector(const std::vector<T>& vec)
+{
+    static_assert(BulkSerializable<T>);
+    // Serialized as with the element by element formatter.
+    DataStream bulk;
+    bulk << vec;
+    DataStream elements;
+    elements << Using<VectorFormatter<DefaultFormatter>>(vec);
+    BOOST_CHECK_EQUAL(HexStr(bulk), HexStr(elements));
+    BOOST_CHECK_EQUAL(GetSerializeSize(vec), bulk.size());
+
+    std::vector<T> vec2;
+    bulk >> vec2;
+    BOOST_CHECK(vec == vec2);
+    prevector<4, T> pre;
+    elements >> pre;
+    BOOST_CHECK(std::equal(vec.begin(), vec.end(), pre.begin(), pre.end()));
+}
+
+BOOST_AUTO_TEST_CASE(vector_bulk)
+{
+    CheckBulkVector(std::vector<uint16_t>{0, 1, 0xfffe});
+    CheckBulkVector(std::vector<int32_t>{-1, 0x12345678, 7, -2, 3});
+    CheckBulkVector(std::vector<uint64_t>{0x0102030405060708, 0});
+    CheckBulkVector(std::vector<uint256>{m_rng.rand256(), uint256::ONE, m_rng.rand256(), m_rng.rand256(), m_rng.rand256()});
+    CheckBulkVector(std::vector<Txid>{Txid::FromUint256(m_rng.rand256())});
+    CheckBulkVector(std::vector<uint256>{});
+
+    static_assert(!BulkSerializable<bool>);
+    static_assert(!BulkSerializable<std::vector<uint256>>);
+    static_assert(!BulkSerializable<CSerializeMethodsTestSingle>);
+
+    // A claimed size is not trusted for allocating.
+    DataStream truncated;
+    WriteCompactSize(truncated, MAX_SIZE);
+    truncated << uint256::ONE;
+    std::vector<uint256> vec;
+    BOOST_CHECK_THROW(truncated >> vec, std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_CASE(array)
 {
     std::array<uint8_t, 32> array1{1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 1, 0, 1, 0, 0, 1};
@@ -4,9 +4,12 @@
 
 #include <addresstype.h>
 #include <coins.h>
+#include <consensus/blockmetadata.h>
 #include <consensus/consensus.h>
 #include <consensus/tx_verify.h>
+#include <consensus/validation.h>
 #include <key.h>
+#include <primitives/block.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
@@ -228,4 +231,46 @@ BOOST_AUTO_TEST_CASE(GetTxSigOpCost)
     }
 }
 
+BOOST_AUTO_TEST_CASE(block_metadata)
+{
+    CBlock block;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript{} << OP_0 << OP_0;
+    coinbase.vout.emplace_back(50, CScript{} << OP_1 << OP_CHECKSIG);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    CMutableTransaction spend;
+    spend.vin.resize(2);
+    spend.vin[0].prevout = COutPoint{Txid::FromUint256(m_rng.rand256()), 0};
+    spend.vin[0].scriptWitness.stack.emplace_back(72, 0x01);
+    spend.vin[1].prevout = COutPoint{Txid::FromUint256(m_rng.rand256()), 1};
+    spend.vout.emplace_back(10, CScript{} << OP_1 << OP_2 << OP_CHECKMULTISIG);
+    block.vtx.push_back(MakeTransactionRef(spend));
+
+    const auto metadata{GetBlockMetadata(block)};
+    BOOST_REQUIRE_EQUAL(metadata->txs.size(), block.vtx.size());
+    for (size_t i{0}; i < block.vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(metadata->txs[i].stripped_size, ::GetSerializeSize(TX_NO_WITNESS(*block.vtx[i])));
+        BOOST_CHECK_EQUAL(metadata->txs[i].total_size, ::GetSerializeSize(TX_WITH_WITNESS(*block.vtx[i])));
+        BOOST_CHECK_EQUAL(metadata->txs[i].Weight(), GetTransactionWeight(*block.vtx[i]));
+        BOOST_CHECK_EQUAL(metadata->txs[i].legacy_sigops, GetLegacySigOpCount(*block.vtx[i]));
+    }
+    BOOST_CHECK_EQUAL(metadata->stripped_size, ::GetSerializeSize(TX_NO_WITNESS(block)));
+    BOOST_CHECK_EQUAL(metadata->total_size, ::GetSerializeSize(TX_WITH_WITNESS(block)));
+    BOOST_CHECK_EQUAL(metadata->Weight(), GetBlockWeight(block));
+    BOOST_CHECK_EQUAL(metadata->legacy_sigops, 1U + MAX_PUBKEYS_PER_MULTISIG);
+
+    // The metadata is cached until the transactions change.
+    BOOST_CHECK_EQUAL(GetBlockMetadata(block), metadata);
+    spend.vout.emplace_back(10, CScript{} << OP_CHECKSIG);
+    block.vtx[1] = MakeTransactionRef(spend);
+    const auto updated{GetBlockMetadata(block)};
+    BOOST_CHECK(updated != metadata);
+    BOOST_CHECK_EQUAL(updated->legacy_sigops, 2U + MAX_PUBKEYS_PER_MULTISIG);
+    BOOST_CHECK_EQUAL(updated->Weight(), GetBlockWeight(block));
+    block.vtx.pop_back();
+    BOOST_CHECK_EQUAL(GetBlockMetadata(block)->txs.size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
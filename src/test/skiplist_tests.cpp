@@ -188,4 +188,62 @@ BOOST_AUTO_TEST_CASE(findearliestatleast_edge_test)
     BOOST_CHECK(ret2->nTimeMax >= 200 && ret2->nHeight == 4);
 }
 
+BOOST_AUTO_TEST_CASE(chainview_test)
+{
+    // A main chain and a branch that splits off at a random height.
+    const int main_length{3 * CChainView::CHUNK_SIZE + 10};
+    const int fork_height{static_cast<int>(m_rng.randrange(main_length))};
+    std::vector<CBlockIndex> main(main_length), side(2 * CChainView::CHUNK_SIZE);
+    for (int i{0}; i < main_length; ++i) {
+        main[i].nHeight = i;
+        main[i].pprev = i ? &main[i - 1] : nullptr;
+        main[i].BuildSkip();
+    }
+    for (size_t i{0}; i < side.size(); ++i) {
+        side[i].nHeight = fork_height + 1 + i;
+        side[i].pprev = i ? &side[i - 1] : &main[fork_height];
+        side[i].BuildSkip();
+    }
+
+    const auto check_view{[](const CChainView& view, const CChain& chain) {
+        BOOST_CHECK_EQUAL(view.Height(), chain.Height());
+        BOOST_CHECK_EQUAL(view.Tip(), chain.Tip());
+        BOOST_CHECK(!view[-1] && !view[chain.Height() + 1]);
+        for (int height{0}; height <= chain.Height(); ++height) BOOST_CHECK_EQUAL(view[height], chain[height]);
+    }};
+
+    CChain chain;
+    CChainView view;
+    BOOST_CHECK(!view.Tip());
+    BOOST_CHECK_EQUAL(view.Height(), -1);
+
+    // Extend the chain one block at a time around a chunk boundary, then in
+    // larger steps, each view built from the previous one.
+    for (int height : {0, 1, CChainView::CHUNK_SIZE - 2, CChainView::CHUNK_SIZE - 1, CChainView::CHUNK_SIZE, CChainView::CHUNK_SIZE + 1, main_length - 1}) {
+        chain.SetTip(main[height]);
+        view = CChainView{chain, view};
+        check_view(view, chain);
+    }
+
+    // Reorganize to the branch, shorter and then longer than the main chain,
+    // and back.
+    for (CBlockIndex* tip : {&side[0], &side.back(), &main.back(), &main[fork_height]}) {
+        chain.SetTip(*tip);
+        view = CChainView{chain, view};
+        check_view(view, chain);
+    }
+    chain.SetTip(side.back());
+    const CChainView side_view{chain, view};
+    check_view(side_view, chain);
+    // The previous view is unchanged.
+    BOOST_CHECK_EQUAL(view.Tip(), &main[fork_height]);
+
+    // Ancestry checks against the view of the branch.
+    BOOST_CHECK(side_view.Contains(&main[fork_height]));
+    BOOST_CHECK_EQUAL(side_view.FindFork(&main.back()), &main[fork_height]);
+    BOOST_CHECK_EQUAL(side_view.FindFork(&side[5]), &side[5]);
+    BOOST_CHECK(!side_view.FindFork(nullptr));
+    if (fork_height + 1 < main_length) BOOST_CHECK(!side_view.Contains(&main[fork_height + 1]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -169,6 +169,71 @@ BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
     receiver.join();
 }
 
+#ifdef USE_EPOLL
+BOOST_AUTO_TEST_CASE(sock_poller)
+{
+    int s[2];
+    CreateSocketPair(s);
+    int t[2];
+    CreateSocketPair(t);
+
+    auto sock0{std::make_shared<const Sock>(s[0])};
+    Sock sock1(s[1]);
+    auto sock2{std::make_shared<const Sock>(t[0])};
+    Sock sock3(t[1]);
+
+    SockPoller poller;
+    BOOST_CHECK(!poller.HasInterest());
+
+    poller.SetInterest(sock0, Sock::RECV);
+    poller.SetInterest(sock2, Sock::RECV | Sock::SEND);
+    BOOST_CHECK(poller.HasInterest());
+    BOOST_CHECK_EQUAL(poller.Size(), 2U);
+
+    // Nothing to read, but sock2 can be written to.
+    Sock::EventsPerSock ready;
+    BOOST_REQUIRE(poller.Wait(0ms, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.begin()->first == sock2);
+    BOOST_CHECK_EQUAL(ready.begin()->second.occurred, Sock::SEND);
+
+    // Once the interest in sending is dropped, only received data wakes up the poller.
+    poller.SetInterest(sock2, Sock::RECV);
+    ready.clear();
+    BOOST_REQUIRE(poller.Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+
+    BOOST_REQUIRE_EQUAL(sock1.Send("a", 1, 0), 1);
+    ready.clear();
+    BOOST_REQUIRE(poller.Wait(1min, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.begin()->first == sock0);
+    BOOST_CHECK_EQUAL(ready.begin()->second.occurred, Sock::RECV);
+
+    // No interest at all, the pending byte on sock0 is not reported.
+    poller.SetInterest(sock0, 0);
+    BOOST_CHECK_EQUAL(poller.Size(), 2U);
+    ready.clear();
+    BOOST_REQUIRE(poller.Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+
+    // Sockets whose interest is not renewed are forgotten.
+    poller.RemoveStale();
+    poller.SetInterest(sock2, Sock::RECV);
+    poller.RemoveStale();
+    BOOST_CHECK_EQUAL(poller.Size(), 1U);
+    BOOST_CHECK(poller.HasInterest());
+
+    // The remaining socket is still waited on.
+    BOOST_REQUIRE_EQUAL(sock3.Send("b", 1, 0), 1);
+    ready.clear();
+    BOOST_REQUIRE(poller.Wait(1min, ready));
+    BOOST_REQUIRE_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.begin()->first == sock2);
+    BOOST_CHECK(ready.begin()->second.occurred & Sock::RECV);
+}
+#endif // USE_EPOLL
+
 #endif /* WIN32 */
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,46 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/spenderindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(spenderindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(spenderindex_find_spender, TestChain100Setup)
+{
+    SpenderIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+    index.Sync();
+
+    // No output of the test chain is spent yet.
+    const COutPoint coinbase_out{m_coinbase_txns[0]->GetHash(), 0};
+    BOOST_CHECK(!index.FindSpender(coinbase_out));
+
+    const CScript dest_script{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, dest_script, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, dest_script)};
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+    const int height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Height())};
+
+    const auto spender{index.FindSpender(coinbase_out)};
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->tx->GetHash(), spend.GetHash());
+    BOOST_CHECK_EQUAL(spender->block_hash, block.GetHash());
+    BOOST_CHECK_EQUAL(spender->height, height);
+
+    // Outputs of the spending transaction and other coinbases remain unspent.
+    BOOST_CHECK(!index.FindSpender(COutPoint{spend.GetHash(), 0}));
+    BOOST_CHECK(!index.FindSpender(COutPoint{m_coinbase_txns[1]->GetHash(), 0}));
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
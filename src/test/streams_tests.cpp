@@ -221,6 +221,33 @@ BOOST_AUTO_TEST_CASE(bitstream_reader_writer)
     BOOST_CHECK_THROW(bit_reader.Read(8), std::ios_base::failure);
 }
 
+BOOST_AUTO_TEST_CASE(bitstream_writer_words)
+{
+    // Writes of any size, which cross the words buffered by the writer, are read back.
+    std::vector<std::pair<uint64_t, int>> writes;
+    int total_bits{0};
+    for (int i = 0; i < 1000; ++i) {
+        const int nbits = m_rng.randrange(65);
+        const uint64_t value = nbits == 0 ? 0 : m_rng.rand64() >> (64 - nbits);
+        writes.emplace_back(value, nbits);
+        total_bits += nbits;
+    }
+    DataStream data{};
+    {
+        BitStreamWriter bit_writer{data};
+        for (const auto& [value, nbits] : writes) {
+            // Bits above nbits are ignored.
+            bit_writer.Write(value | (nbits < 64 ? m_rng.rand64() << nbits : 0), nbits);
+        }
+    }
+    BOOST_CHECK_EQUAL(data.size(), size_t((total_bits + 7) / 8));
+
+    BitStreamReader bit_reader{data};
+    for (const auto& [value, nbits] : writes) {
+        BOOST_CHECK_EQUAL(bit_reader.Read(nbits), value);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
 {
     std::vector<std::byte> in;
@@ -255,6 +282,22 @@ BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
     }
 }
 
+BOOST_AUTO_TEST_CASE(xor_word_key)
+{
+    // 8-byte keys take a word-at-a-time path, which must match XOR-ing byte by byte.
+    const auto key{m_rng.randbytes<std::byte>(8)};
+    const auto data{m_rng.randbytes<std::byte>(100)};
+    for (size_t size{0}; size <= data.size(); size += 7) {
+        for (size_t key_offset{0}; key_offset < 20; ++key_offset) {
+            std::vector<std::byte> xored{data.begin(), data.begin() + size};
+            util::Xor(xored, key, key_offset);
+            for (size_t i{0}; i < size; ++i) {
+                BOOST_CHECK(xored[i] == (data[i] ^ key[(key_offset + i) % key.size()]));
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(streams_buffered_file)
 {
     fs::path streams_test_filename = m_args.GetDataDirBase() / "streams_test_tmp";
@@ -7,8 +7,12 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <future>
 #include <mutex>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
 
 namespace {
 template <typename MutexType>
@@ -140,4 +144,59 @@ BOOST_AUTO_TEST_CASE(inconsistent_lock_order_detected)
 #endif // DEBUG_LOCKORDER
 }
 
+BOOST_AUTO_TEST_CASE(lock_stats)
+{
+    const bool prev{g_lock_stats_enabled};
+    g_lock_stats_enabled = true;
+    Mutex lock_stats_mutex;
+    std::promise<void> locked;
+    std::thread holder{[&] {
+        LOCK(lock_stats_mutex);
+        locked.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }};
+    locked.get_future().wait();
+    {
+        LOCK(lock_stats_mutex);
+    }
+    holder.join();
+    g_lock_stats_enabled = false;
+    // Nothing is recorded while disabled, so this site is not listed.
+    {
+        LOCK(lock_stats_mutex);
+    }
+    g_lock_stats_enabled = prev;
+
+    std::vector<const LockSiteStats*> sites;
+    for (const LockSiteStats* stats : GetAllLockSiteStats()) {
+        if (stats->name == "lock_stats_mutex") sites.push_back(stats);
+    }
+    BOOST_REQUIRE_EQUAL(sites.size(), 2U);
+    if (sites[0]->line > sites[1]->line) std::swap(sites[0], sites[1]);
+    const LockSiteStats& holder_site{*sites[0]};
+    const LockSiteStats& waiter_site{*sites[1]};
+
+    BOOST_CHECK_EQUAL(holder_site.acquisitions, 1U);
+    BOOST_CHECK_EQUAL(holder_site.contended, 0U);
+    BOOST_CHECK_GE(holder_site.max_hold_ns, 10'000'000U);
+    BOOST_CHECK_EQUAL(waiter_site.acquisitions, 1U);
+    BOOST_CHECK_EQUAL(waiter_site.contended, 1U);
+    BOOST_CHECK_GT(waiter_site.wait_ns, 0U);
+    BOOST_CHECK_EQUAL(waiter_site.max_wait_ns, waiter_site.wait_ns.load());
+    for (const LockSiteStats* site : sites) {
+        const auto count{[](const LockSiteStats::Histogram& histogram) {
+            return std::accumulate(histogram.begin(), histogram.end(), uint64_t{0}, [](uint64_t sum, const auto& bucket) { return sum + bucket.load(); });
+        }};
+        BOOST_CHECK_EQUAL(count(site->wait_histogram), 1U);
+        BOOST_CHECK_EQUAL(count(site->hold_histogram), 1U);
+    }
+    // Held for at least 10ms, i.e. in [2^13, 2^14) µs (bucket 14) or above.
+    BOOST_CHECK_EQUAL(std::accumulate(holder_site.hold_histogram.begin(), holder_site.hold_histogram.begin() + 14, uint64_t{0}, [](uint64_t sum, const auto& bucket) { return sum + bucket.load(); }), 0U);
+
+    ResetLockSiteStats();
+    BOOST_CHECK_EQUAL(holder_site.acquisitions, 0U);
+    BOOST_CHECK_EQUAL(waiter_site.acquisitions, 0U);
+    BOOST_CHECK_EQUAL(waiter_site.max_wait_ns, 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/threadpool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(threadpool_results)
+{
+    ThreadPool pool{"test"};
+    pool.Start(/*num_workers=*/3);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 3U);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+
+    // Exceptions are propagated through the future.
+    auto failing{pool.Submit([]() -> int { throw std::runtime_error{"task failed"}; })};
+    BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_stop_drains_queue)
+{
+    std::atomic<int> counter{0};
+    std::vector<std::future<void>> futures;
+    {
+        ThreadPool pool{"test"};
+        pool.Start(/*num_workers=*/2);
+        for (int i = 0; i < 50; ++i) {
+            futures.push_back(pool.Submit([&counter] { ++counter; }));
+        }
+        pool.Stop();
+        BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 0U);
+    }
+    BOOST_CHECK_EQUAL(counter, 50);
+    for (auto& future : futures) future.get();
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_no_workers)
+{
+    // Without worker threads, tasks run synchronously on the caller.
+    ThreadPool pool{"test"};
+    const auto caller{std::this_thread::get_id()};
+    auto future{pool.Submit([] { return std::this_thread::get_id(); })};
+    BOOST_CHECK(future.wait_for(std::chrono::seconds{0}) == std::future_status::ready);
+    BOOST_CHECK(future.get() == caller);
+}
+
+BOOST_AUTO_TEST_CASE(shared_threadpool_groups)
+{
+    SharedThreadPool pool{"test"};
+    pool.Start(/*num_workers=*/4);
+
+    // No more tasks of a group run at once than its maximum.
+    SharedThreadPool::Group capped{pool, SharedThreadPool::Priority::NORMAL, /*max_running=*/2};
+    BOOST_CHECK_EQUAL(capped.Concurrency(), 2U);
+    std::atomic<int> running{0}, max_running{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 50; ++i) {
+        futures.push_back(capped.Submit([&] {
+            const int now{++running};
+            for (int prev{max_running}; prev < now && !max_running.compare_exchange_weak(prev, now);) {}
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+            --running;
+        }));
+    }
+    for (auto& future : futures) future.get();
+    BOOST_CHECK_LE(max_running, 2);
+
+    // Tasks of higher priority groups run first.
+    SharedThreadPool single_pool{"test"};
+    single_pool.Start(/*num_workers=*/1);
+    SharedThreadPool::Group high{single_pool, SharedThreadPool::Priority::HIGH, /*max_running=*/1};
+    SharedThreadPool::Group low{single_pool, SharedThreadPool::Priority::LOW, /*max_running=*/1};
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future()};
+    auto blocker{low.Submit([&] { released.wait(); })};
+    Mutex order_mutex;
+    std::vector<char> order;
+    futures.clear();
+    for (int i = 0; i < 3; ++i) futures.push_back(low.Submit([&] { WITH_LOCK(order_mutex, order.push_back('l')); }));
+    for (int i = 0; i < 3; ++i) futures.push_back(high.Submit([&] { WITH_LOCK(order_mutex, order.push_back('h')); }));
+    release.set_value();
+    for (auto& future : futures) future.get();
+    blocker.get();
+    const std::vector<char> expected{'h', 'h', 'h', 'l', 'l', 'l'};
+    BOOST_CHECK(WITH_LOCK(order_mutex, return order) == expected);
+
+    // Without workers, tasks run on the caller.
+    single_pool.Stop();
+    BOOST_CHECK_EQUAL(high.Concurrency(), 1U);
+    BOOST_CHECK(high.Submit([] { return std::this_thread::get_id(); }).get() == std::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/throttle.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(throttle_tests)
+
+BOOST_AUTO_TEST_CASE(unlimited)
+{
+    Throttle throttle{0, 100};
+    BOOST_CHECK(!throttle.Enabled());
+    BOOST_CHECK(throttle.Account(1 << 30, 1s) == 0us);
+}
+
+BOOST_AUTO_TEST_CASE(cpu_share)
+{
+    Throttle throttle{0, 25};
+    BOOST_CHECK(throttle.Enabled());
+    BOOST_CHECK(!throttle.LimitsReads());
+    // Working a quarter of the time means pausing three times as long.
+    BOOST_CHECK(throttle.Account(0, 100ms) == 300ms);
+    // Short pauses are carried over until they add up.
+    BOOST_CHECK(throttle.Account(0, 1ms) == 0us);
+    BOOST_CHECK(throttle.Account(0, 1ms) == 0us);
+    BOOST_CHECK(throttle.Account(0, 2ms) == 12ms);
+    // Out of range shares are clamped.
+    BOOST_CHECK(Throttle(0, 0).Account(0, 10ms) == 990ms);
+    BOOST_CHECK(!Throttle(0, 1000).Enabled());
+}
+
+BOOST_AUTO_TEST_CASE(read_rate)
+{
+    Throttle throttle{1 << 20, 100};
+    BOOST_CHECK(throttle.LimitsReads());
+    // Reading 1 MiB takes a second, including the time spent working.
+    BOOST_CHECK(throttle.Account(1 << 20, 200ms) == 800ms);
+    // Units of work slower than the rate need no pause.
+    BOOST_CHECK(throttle.Account(1 << 10, 500ms) == 0us);
+    // The larger of the two pauses applies.
+    Throttle both{1 << 20, 50};
+    BOOST_CHECK(both.Account(1 << 20, 100ms) == 900ms);
+    BOOST_CHECK(both.Account(1 << 10, 100ms) == 100ms);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include <txgraph.h>
 
 #include <random.h>
+#include <util/threadpool.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -287,4 +288,38 @@ BOOST_AUTO_TEST_CASE(txgraph_trim_big_singletons)
     }
 }
 
+BOOST_AUTO_TEST_CASE(txgraph_relinearize_parallel)
+{
+    /** The number of clusters, enough for them to be relinearized on the shared thread pool. */
+    static constexpr int NUM_CLUSTERS = 40;
+    static constexpr int NUM_TX_PER_CLUSTER = 20;
+
+    FastRandomContext rng;
+    auto graph = MakeTxGraph(/*max_cluster_count=*/NUM_TX_PER_CLUSTER, /*max_cluster_size=*/100'000);
+    std::vector<TxGraph::Ref> refs;
+    refs.reserve(NUM_CLUSTERS * NUM_TX_PER_CLUSTER);
+    for (int cluster = 0; cluster < NUM_CLUSTERS; ++cluster) {
+        for (int tx = 0; tx < NUM_TX_PER_CLUSTER; ++tx) {
+            refs.push_back(graph->AddTransaction(FeePerWeight{int64_t(rng.randrange(10'000)), int32_t(rng.randrange(1000) + 1)}));
+            if (tx > 0) graph->AddDependency(/*parent=*/refs[refs.size() - 1 - (1 + rng.randrange(tx))], /*child=*/refs.back());
+        }
+    }
+
+    GetSharedThreadPool().Start(2);
+    for (int round = 0; round < 3; ++round) {
+        graph->DoWork();
+        graph->SanityCheck();
+        BOOST_CHECK_EQUAL(graph->GetTransactionCount(), NUM_CLUSTERS * NUM_TX_PER_CLUSTER);
+        // Every cluster was relinearized, and is still whole.
+        for (int cluster = 0; cluster < NUM_CLUSTERS; ++cluster) {
+            BOOST_CHECK_EQUAL(graph->GetCluster(refs[cluster * NUM_TX_PER_CLUSTER]).size(), NUM_TX_PER_CLUSTER);
+        }
+        // Change a fee in every cluster, so that all of them need relinearizing again.
+        for (int cluster = 0; cluster < NUM_CLUSTERS; ++cluster) {
+            graph->SetTransactionFee(refs[cluster * NUM_TX_PER_CLUSTER + rng.randrange(NUM_TX_PER_CLUSTER)], rng.randrange(10'000));
+        }
+    }
+    GetSharedThreadPool().Stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -73,4 +73,84 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_compact, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true, false, /*compact=*/true);
+    BOOST_REQUIRE(txindex.Init());
+    txindex.Sync();
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const auto& txn : Params().GenesisBlock().vtx) {
+        BOOST_CHECK(!txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+    }
+    for (const auto& txn : m_coinbase_txns) {
+        BOOST_REQUIRE(txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK_EQUAL(tx_disk->GetHash(), txn->GetHash());
+    }
+
+    // Transactions in new blocks are found at their position in the block.
+    const CScript coinbase_script_pub_key{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, coinbase_script_pub_key, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, coinbase_script_pub_key)};
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    for (const auto& txn : block.vtx) {
+        BOOST_REQUIRE(txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK_EQUAL(tx_disk->GetHash(), txn->GetHash());
+        BOOST_CHECK_EQUAL(block_hash, block.GetHash());
+    }
+
+    // The transactions of a disconnected block are no longer found.
+    BlockValidationState state;
+    CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    CreateAndProcessBlock({}, GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey())));
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(!txindex.FindTx(spend.GetHash(), block_hash, tx_disk));
+    BOOST_CHECK(!txindex.FindTx(block.vtx[0]->GetHash(), block_hash, tx_disk));
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_find_txs, TestChain100Setup)
+{
+    for (const bool compact : {false, true}) {
+        TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true, false, compact);
+        BOOST_REQUIRE(txindex.Init());
+        txindex.Sync();
+
+        // Transactions are returned in the order of the request, whatever their order on disk.
+        std::vector<uint256> hashes;
+        std::vector<std::optional<uint256>> expected;
+        for (size_t i{0}; i < m_coinbase_txns.size(); i += 3) {
+            const size_t j{m_coinbase_txns.size() - 1 - i};
+            hashes.push_back(m_coinbase_txns[j]->GetHash());
+            expected.push_back(hashes.back());
+            hashes.push_back(m_rng.rand256());
+            expected.push_back(std::nullopt);
+        }
+        hashes.push_back(m_coinbase_txns[0]->GetHash());
+        expected.push_back(hashes.back());
+        hashes.push_back(m_coinbase_txns[0]->GetHash());
+        expected.push_back(hashes.back());
+
+        const auto found{txindex.FindTxs(hashes)};
+        BOOST_REQUIRE_EQUAL(found.size(), hashes.size());
+        for (size_t i{0}; i < hashes.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(found[i].has_value(), expected[i].has_value());
+            if (!found[i]) continue;
+            CTransactionRef tx_disk;
+            uint256 block_hash;
+            BOOST_REQUIRE(txindex.FindTx(hashes[i], block_hash, tx_disk));
+            BOOST_CHECK_EQUAL(found[i]->first, block_hash);
+            BOOST_CHECK_EQUAL(found[i]->second->GetHash(), *expected[i]);
+        }
+        BOOST_CHECK(txindex.FindTxs({}).empty());
+
+        m_node.validation_signals->SyncWithValidationInterfaceQueue();
+        txindex.Stop();
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -251,6 +251,20 @@ BOOST_AUTO_TEST_CASE(package_validation_tests)
         BOOST_CHECK_EQUAL(it_giant_tx->second.m_state.GetRejectReason(), "tx-size");
     }
 
+    // A script failure found by the package-wide script checks is reported for the transaction it belongs to.
+    CMutableTransaction mtx_child_bad_sig{mtx_child};
+    mtx_child_bad_sig.vout[0].nValue -= 1;
+    CTransactionRef tx_child_bad_sig = MakeTransactionRef(mtx_child_bad_sig);
+    Package package_bad_sig{tx_parent, tx_child_bad_sig};
+    const auto result_bad_sig = ProcessNewPackage(m_node.chainman->ActiveChainstate(), *m_node.mempool, package_bad_sig, /*test_accept=*/true, /*client_maxfeerate=*/{});
+    BOOST_CHECK_EQUAL(result_bad_sig.m_state.GetResult(), PackageValidationResult::PCKG_TX);
+    BOOST_CHECK_EQUAL(result_bad_sig.m_state.GetRejectReason(), "transaction failed");
+    BOOST_CHECK(!result_bad_sig.m_tx_results.contains(tx_parent->GetWitnessHash()));
+    auto it_bad_sig = result_bad_sig.m_tx_results.find(tx_child_bad_sig->GetWitnessHash());
+    BOOST_REQUIRE(it_bad_sig != result_bad_sig.m_tx_results.end());
+    BOOST_CHECK_EQUAL(it_bad_sig->second.m_state.GetResult(), TxValidationResult::TX_CONSENSUS);
+    BOOST_CHECK(it_bad_sig->second.m_state.GetRejectReason().starts_with("mandatory-script-verify-flag-failed"));
+
     // Check that mempool size hasn't changed.
     BOOST_CHECK_EQUAL(m_node.mempool->size(), initialPoolSize);
 }
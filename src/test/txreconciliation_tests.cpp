@@ -8,6 +8,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
@@ -81,4 +84,111 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(AddToSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    NodeId peer_id0 = 0;
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Unregistered peers get every transaction flooded.
+    BOOST_CHECK(!tracker.AddToSet(peer_id0, wtxid));
+    BOOST_CHECK(tracker.ShouldFanoutTo(wtxid, peer_id0));
+
+    tracker.PreRegisterPeer(peer_id0);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.AddToSet(peer_id0, wtxid));
+    // Adding twice is harmless.
+    BOOST_CHECK(tracker.AddToSet(peer_id0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(peer_id0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(peer_id0, wtxid));
+
+    // The set is bounded.
+    for (size_t i = 0; i < MAX_RECON_SET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(peer_id0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(peer_id0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationRoundTest)
+{
+    // Connect an initiator and a responder, each knowing the other as peer 0.
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    NodeId peer_id0 = 0;
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(peer_id0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(peer_id0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(peer_id0, /*is_peer_inbound=*/false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(peer_id0, /*is_peer_inbound=*/true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+
+    // Only the initiator requests, and not right after the connection is set up.
+    std::chrono::microseconds now{1s};
+    BOOST_CHECK(!responder.InitiateReconciliationRequest(peer_id0, now));
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(peer_id0, now));
+    // Messages out of turn are rejected.
+    BOOST_CHECK(!initiator.HandleSketch(peer_id0, {}));
+    BOOST_CHECK(!responder.HandleReconcilDiff(peer_id0, true, {}));
+
+    std::vector<Wtxid> initiator_only, responder_only;
+    for (int i = 0; i < 50; ++i) {
+        const Wtxid shared{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_CHECK(initiator.AddToSet(peer_id0, shared));
+        BOOST_CHECK(responder.AddToSet(peer_id0, shared));
+    }
+    for (int i = 0; i < 5; ++i) {
+        initiator_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_CHECK(initiator.AddToSet(peer_id0, initiator_only.back()));
+    }
+    for (int i = 0; i < 3; ++i) {
+        responder_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_CHECK(responder.AddToSet(peer_id0, responder_only.back()));
+    }
+
+    now += RECON_REQUEST_INTERVAL;
+    const auto request{initiator.InitiateReconciliationRequest(peer_id0, now)};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK_EQUAL(request->first, 55);
+    // No second request while the round is ongoing.
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(peer_id0, now + RECON_REQUEST_INTERVAL));
+
+    const auto sketch{responder.RespondToReconciliationRequest(peer_id0, request->first, request->second)};
+    BOOST_REQUIRE(sketch);
+    BOOST_CHECK(!sketch->empty());
+    BOOST_CHECK(!responder.RespondToReconciliationRequest(peer_id0, request->first, request->second));
+
+    const auto diff{initiator.HandleSketch(peer_id0, *sketch)};
+    BOOST_REQUIRE(diff);
+    BOOST_CHECK(diff->m_success);
+    BOOST_CHECK_EQUAL(diff->m_ask_shortids.size(), responder_only.size());
+    std::vector<Wtxid> announced{diff->m_announce};
+    std::sort(announced.begin(), announced.end());
+    std::sort(initiator_only.begin(), initiator_only.end());
+    BOOST_CHECK(announced == initiator_only);
+
+    const auto missing{responder.HandleReconcilDiff(peer_id0, diff->m_success, diff->m_ask_shortids)};
+    BOOST_REQUIRE(missing);
+    announced = *missing;
+    std::sort(announced.begin(), announced.end());
+    std::sort(responder_only.begin(), responder_only.end());
+    BOOST_CHECK(announced == responder_only);
+
+    // Both sets were emptied by the round. An empty set on the responder side makes the round
+    // fail, and the initiator announces its whole set.
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+    BOOST_CHECK(initiator.AddToSet(peer_id0, wtxid));
+    now += RECON_REQUEST_INTERVAL;
+    const auto request2{initiator.InitiateReconciliationRequest(peer_id0, now)};
+    BOOST_REQUIRE(request2);
+    BOOST_CHECK_EQUAL(request2->first, 1);
+    const auto sketch2{responder.RespondToReconciliationRequest(peer_id0, request2->first, request2->second)};
+    BOOST_REQUIRE(sketch2);
+    BOOST_CHECK(sketch2->empty());
+    const auto diff2{initiator.HandleSketch(peer_id0, *sketch2)};
+    BOOST_REQUIRE(diff2);
+    BOOST_CHECK(!diff2->m_success);
+    BOOST_CHECK(diff2->m_announce == std::vector<Wtxid>{wtxid});
+    const auto missing2{responder.HandleReconcilDiff(peer_id0, diff2->m_success, diff2->m_ask_shortids)};
+    BOOST_REQUIRE(missing2);
+    BOOST_CHECK(missing2->empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
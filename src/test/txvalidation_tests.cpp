@@ -2,7 +2,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <key_io.h>
 #include <policy/packages.h>
 #include <policy/policy.h>
@@ -53,6 +55,70 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_reject_coinbase, TestChain100Setup)
     BOOST_CHECK(result.m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
 }
 
+/**
+ * Ensure that the stages of mempool acceptance are timed by result.
+ */
+BOOST_FIXTURE_TEST_CASE(tx_mempool_accept_stats, TestChain100Setup)
+{
+    const auto tx{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/0,
+                                                                   coinbaseKey, GetScriptForDestination(PKHash(coinbaseKey.GetPubKey())),
+                                                                   /*output_amount=*/49 * COIN, /*submit=*/false))};
+    LOCK(cs_main);
+    BOOST_CHECK(m_node.chainman->ProcessTransaction(tx).m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(m_node.chainman->ProcessTransaction(tx).m_result_type == MempoolAcceptResult::ResultType::INVALID);
+
+    const auto stats{m_node.chainman->GetMempoolAcceptStats()};
+    const auto stage_count{[&](const std::string& result, MempoolAcceptStage stage) {
+        const auto it{stats.find(result)};
+        return it == stats.end() ? 0 : it->second.stages[size_t(stage)].Count();
+    }};
+    BOOST_CHECK_EQUAL(stage_count("accepted", MempoolAcceptStage::TOTAL), 1U);
+    BOOST_CHECK_EQUAL(stage_count("accepted", MempoolAcceptStage::COINS), 1U);
+    BOOST_CHECK_EQUAL(stage_count("accepted", MempoolAcceptStage::POLICY_SCRIPTS), 1U);
+    BOOST_CHECK_EQUAL(stage_count("accepted", MempoolAcceptStage::SUBMIT), 1U);
+    BOOST_CHECK_EQUAL(stage_count("accepted", MempoolAcceptStage::REPLACEMENT), 0U);
+    // The second submission fails in the pre-checks, before any script is run.
+    BOOST_CHECK_EQUAL(stage_count("rejected:txn-already-in-mempool", MempoolAcceptStage::TOTAL), 1U);
+    BOOST_CHECK_EQUAL(stage_count("rejected:txn-already-in-mempool", MempoolAcceptStage::PRECHECKS), 1U);
+    BOOST_CHECK_EQUAL(stage_count("rejected:txn-already-in-mempool", MempoolAcceptStage::POLICY_SCRIPTS), 0U);
+}
+
+/**
+ * Ensure that the sighash midstates of segwit transactions are kept with their mempool entry.
+ */
+BOOST_FIXTURE_TEST_CASE(tx_mempool_precomputed_txdata, TestChain100Setup)
+{
+    const CScript p2wpkh{GetScriptForDestination(WitnessV0KeyHash(coinbaseKey.GetPubKey()))};
+    const auto parent{MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/0,
+                                                                       coinbaseKey, p2wpkh, /*output_amount=*/49 * COIN))};
+    const auto child{MakeTransactionRef(CreateValidMempoolTransaction(parent, /*input_vout=*/0, /*input_height=*/101,
+                                                                      coinbaseKey, p2wpkh, /*output_amount=*/48 * COIN))};
+    {
+        LOCK(m_node.mempool->cs);
+        // Nothing is precomputed for the legacy spend.
+        const auto parent_entry{m_node.mempool->GetIter(parent->GetWitnessHash())};
+        BOOST_REQUIRE(parent_entry);
+        BOOST_CHECK(!(*parent_entry)->GetPrecomputedTxData());
+        BOOST_CHECK_EQUAL((*parent_entry)->DynamicMemoryUsage(), RecursiveDynamicUsage(parent));
+
+        const auto child_entry{m_node.mempool->GetIter(child->GetWitnessHash())};
+        BOOST_REQUIRE(child_entry);
+        const auto& txdata{(*child_entry)->GetPrecomputedTxData()};
+        BOOST_REQUIRE(txdata);
+        BOOST_CHECK(txdata->m_bip143_segwit_ready);
+        BOOST_CHECK(!txdata->m_bip341_taproot_ready);
+        BOOST_CHECK_EQUAL(txdata->m_spent_outputs.size(), 1U);
+        BOOST_CHECK(txdata->m_spent_outputs[0] == parent->vout[0]);
+        BOOST_CHECK_GT((*child_entry)->DynamicMemoryUsage(), RecursiveDynamicUsage(child));
+    }
+
+    // The block is valid when connected starting from the kept data.
+    const CBlock block{CreateAndProcessBlock({CMutableTransaction{*parent}, CMutableTransaction{*child}}, p2wpkh)};
+    LOCK(cs_main);
+    BOOST_CHECK_EQUAL(m_node.chainman->ActiveChain().Tip()->GetBlockHash(), block.GetHash());
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 0U);
+}
+
 // Generate a number of random, nonexistent outpoints.
 static inline std::vector<COutPoint> random_outpoints(size_t num_outpoints) {
     std::vector<COutPoint> outpoints;
@@ -4,6 +4,7 @@
 
 #include <consensus/validation.h>
 #include <key.h>
+#include <node/validation_cache_persist.h>
 #include <random.h>
 #include <script/sigcache.h>
 #include <script/sign.h>
@@ -15,6 +16,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <fstream>
+
 struct Dersig100Setup : public TestChain100Setup {
     Dersig100Setup()
         : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-testactivationheight=dersig@102"}}} {}
@@ -385,4 +388,75 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, Dersig100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(schnorr_batch, BasicTestingSetup)
+{
+    SignatureCache signature_cache{DEFAULT_SIGNATURE_CACHE_BYTES};
+    SchnorrBatch batch;
+    BOOST_CHECK(batch.empty());
+    BOOST_CHECK(batch.Verify(signature_cache));
+
+    std::vector<uint256> entries;
+    for (int i = 0; i < 4; ++i) {
+        CKey key{GenerateRandomKey()};
+        const XOnlyPubKey pubkey{key.GetPubKey()};
+        const uint256 sighash{m_rng.rand256()};
+        std::array<unsigned char, 64> sig;
+        BOOST_REQUIRE(key.SignSchnorr(sighash, sig, nullptr, m_rng.rand256()));
+        uint256 entry;
+        signature_cache.ComputeEntrySchnorr(entry, sighash, sig, pubkey);
+        entries.push_back(entry);
+        // Only ask for the first two signatures to be cached.
+        batch.Add(sig, pubkey, sighash, i < 2 ? std::optional{entry} : std::nullopt);
+        if (i == 3) {
+            // A signature for another message makes the whole batch invalid.
+            SchnorrBatch bad_batch;
+            bad_batch.Add(sig, pubkey, m_rng.rand256(), entry);
+            BOOST_CHECK(!bad_batch.Verify(signature_cache));
+        }
+    }
+    BOOST_CHECK_EQUAL(batch.size(), 4U);
+    BOOST_CHECK(batch.Verify(signature_cache));
+    BOOST_CHECK(signature_cache.Get(entries[0], /*erase=*/false));
+    BOOST_CHECK(signature_cache.Get(entries[1], /*erase=*/false));
+    BOOST_CHECK(!signature_cache.Get(entries[2], /*erase=*/false));
+    BOOST_CHECK(!signature_cache.Get(entries[3], /*erase=*/false));
+}
+
+BOOST_FIXTURE_TEST_CASE(validation_cache_persist, BasicTestingSetup)
+{
+    const fs::path path{m_args.GetDataDirNet() / "validation_cache.dat"};
+    const std::vector<unsigned char> sig(64, 1);
+    const XOnlyPubKey pubkey{XOnlyPubKey::NUMS_H};
+    const uint256 sighash{m_rng.rand256()};
+    uint256 script_entry{m_rng.rand256()};
+    uint256 signature_entry;
+    {
+        ValidationCache cache{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES, DEFAULT_SIGNATURE_CACHE_BYTES};
+        WITH_LOCK(::cs_main, cache.m_script_execution_cache.insert(script_entry));
+        cache.m_signature_cache.ComputeEntrySchnorr(signature_entry, sighash, sig, pubkey);
+        cache.m_signature_cache.Set(signature_entry);
+        BOOST_REQUIRE(node::DumpValidationCache(cache, path));
+    }
+
+    ValidationCache cache{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES, DEFAULT_SIGNATURE_CACHE_BYTES};
+    BOOST_CHECK(!cache.m_signature_cache.Get(signature_entry, /*erase=*/false));
+    BOOST_REQUIRE(node::LoadValidationCache(cache, path));
+    BOOST_CHECK(WITH_LOCK(::cs_main, return cache.m_script_execution_cache.contains(script_entry, /*erase=*/false)));
+    BOOST_CHECK(cache.m_signature_cache.Get(signature_entry, /*erase=*/false));
+    // Entries computed after loading match the loaded ones.
+    uint256 entry;
+    cache.m_signature_cache.ComputeEntrySchnorr(entry, sighash, sig, pubkey);
+    BOOST_CHECK_EQUAL(entry, signature_entry);
+
+    // A corrupted file is not loaded.
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(40);
+        file.put(0);
+    }
+    ValidationCache other{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES, DEFAULT_SIGNATURE_CACHE_BYTES};
+    BOOST_CHECK(!node::LoadValidationCache(other, path));
+    BOOST_CHECK(!other.m_signature_cache.Get(signature_entry, /*erase=*/false));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
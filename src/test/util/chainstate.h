@@ -27,6 +27,8 @@ const auto NoMalleation = [](AutoFile& file, node::SnapshotMetadata& meta){};
  * loaded into an otherwise mostly-uninitialized datadir. It also allows us to test
  * conditions that would otherwise cause shutdowns based on the IBD chainstate going
  * past the snapshot it generated.
+ *
+ * If `chunked` is true, the snapshot is written and loaded as a chunked snapshot.
  */
 template<typename F = decltype(NoMalleation)>
 static bool
@@ -34,7 +36,8 @@ CreateAndActivateUTXOSnapshot(
     TestingSetup* fixture,
     F malleation = NoMalleation,
     bool reset_chainstate = false,
-    bool in_memory_chainstate = false)
+    bool in_memory_chainstate = false,
+    bool chunked = false)
 {
     node::NodeContext& node = fixture->m_node;
     fs::path root = fixture->m_path_root;
@@ -51,7 +54,8 @@ CreateAndActivateUTXOSnapshot(
                                          node.chainman->ActiveChainstate(),
                                          std::move(auto_outfile), // Will close auto_outfile.
                                          snapshot_path,
-                                         snapshot_path);
+                                         snapshot_path,
+                                         chunked);
     LogPrintf(
         "Wrote UTXO snapshot to %s: %s\n", fs::PathToString(snapshot_path.make_preferred()), result.write());
 
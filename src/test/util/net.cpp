@@ -153,6 +153,13 @@ ZeroSock::~ZeroSock() { m_socket = INVALID_SOCKET; }
 
 ssize_t ZeroSock::Send(const void*, size_t len, int) const { return len; }
 
+ssize_t ZeroSock::SendV(std::span<const std::span<const uint8_t>> data, int) const
+{
+    size_t len{0};
+    for (const auto& segment : data) len += segment.size();
+    return len;
+}
+
 ssize_t ZeroSock::Recv(void* buf, size_t len, int flags) const
 {
     memset(buf, 0x0, len);
@@ -350,6 +357,16 @@ ssize_t DynSock::Send(const void* buf, size_t len, int) const
     return len;
 }
 
+ssize_t DynSock::SendV(std::span<const std::span<const uint8_t>> data, int) const
+{
+    size_t len{0};
+    for (const auto& segment : data) {
+        m_pipes->send.PushBytes(segment.data(), segment.size());
+        len += segment.size();
+    }
+    return len;
+}
+
 std::unique_ptr<Sock> DynSock::Accept(sockaddr* addr, socklen_t* addr_len) const
 {
     ZeroSock::Accept(addr, addr_len);
@@ -252,11 +252,15 @@ ChainTestingSetup::ChainTestingSetup(const ChainType chainType, TestOpts opts)
         ChainstateManager::Options chainman_opts{
             .chainparams = chainparams,
             .datadir = m_args.GetDataDirNet(),
-            .check_block_index = 1,
+            .check_block_index = opts.check_block_index ? 1 : 0,
             .notifications = *m_node.notifications,
             .signals = m_node.validation_signals.get(),
             // Use no worker threads while fuzzing to avoid non-determinism
-            .worker_threads_num = EnableFuzzDeterminism() ? 0 : 2,
+            .worker_threads_num = EnableFuzzDeterminism() ? 0 : opts.worker_threads_num,
+            .background_worker_threads_num = int(m_args.GetIntArg("-backgroundpar", 0)),
+            .block_read_ahead = int(m_args.GetIntArg("-blockreadahead", 0)),
+            .input_prefetch_threads = int(m_args.GetIntArg("-prefetchthreads", 0)),
+            .header_check_threads = int(m_args.GetIntArg("-headercheckthreads", 0)),
         };
         if (opts.min_validation_cache) {
             chainman_opts.script_execution_cache_bytes = 0;
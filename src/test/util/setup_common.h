@@ -56,6 +56,8 @@ struct TestOpts {
     bool setup_net{true};
     bool setup_validation_interface{true};
     bool min_validation_cache{false}; // Equivalent of -maxsigcachebytes=0
+    int worker_threads_num{2}; // Script check threads besides the validation thread
+    bool check_block_index{true};
 };
 
 /** Basic testing setup.
@@ -104,7 +106,7 @@ struct BasicTestingSetup {
  * initialization behaviour.
  */
 struct ChainTestingSetup : public BasicTestingSetup {
-    kernel::CacheSizes m_kernel_cache_sizes{node::CalculateCacheSizes(m_args).kernel};
+    kernel::CacheSizes m_kernel_cache_sizes{node::CalculateCacheSizes(*m_node.args).kernel};
     bool m_coins_db_in_memory{true};
     bool m_block_tree_db_in_memory{true};
     std::function<void()> m_make_chainman{};
@@ -16,6 +16,9 @@
 #include <util/byte_units.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/histogram.h>
+#include <util/meminfo.h>
+#include <util/numa.h>
 #include <util/moneystr.h>
 #include <util/overflow.h>
 #include <util/readwritefile.h>
@@ -1629,6 +1632,56 @@ BOOST_AUTO_TEST_CASE(util_WriteBinaryFile)
     BOOST_CHECK_EQUAL(actual_text, expected_text);
 }
 
+BOOST_AUTO_TEST_CASE(util_GetAvailableMemory)
+{
+    const fs::path proc{m_args.GetDataDirBase() / "proc"};
+    const fs::path cgroup_root{m_args.GetDataDirBase() / "cgroup"};
+    const fs::path cgroup{cgroup_root / "system.slice" / "node.scope"};
+    fs::create_directories(proc / "self");
+    fs::create_directories(cgroup);
+    BOOST_CHECK(!util::GetAvailableMemory(proc, cgroup_root));
+
+    BOOST_REQUIRE(WriteBinaryFile(proc / "meminfo", "MemTotal:       32768000 kB\nMemFree:         1000000 kB\nMemAvailable:    8000000 kB\n"));
+    BOOST_CHECK_EQUAL(*util::GetAvailableMemory(proc, cgroup_root), 8000000ULL * 1024);
+
+    // A cgroup without a limit does not change the result.
+    BOOST_REQUIRE(WriteBinaryFile(proc / "self" / "cgroup", "0::/system.slice/node.scope\n"));
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.max", "max\n"));
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.current", "1000\n"));
+    BOOST_CHECK_EQUAL(*util::GetAvailableMemory(proc, cgroup_root), 8000000ULL * 1024);
+
+    // The room below the limit counts, with inactive page cache as free.
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.max", "2147483648\n"));
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.current", "2000000000\n"));
+    BOOST_CHECK_EQUAL(*util::GetAvailableMemory(proc, cgroup_root), 147483648U);
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.stat", "anon 1500000000\nactive_file 100000000\ninactive_file 400000000\n"));
+    BOOST_CHECK_EQUAL(*util::GetAvailableMemory(proc, cgroup_root), 547483648U);
+
+    // Usage above the limit means there is nothing left.
+    BOOST_REQUIRE(WriteBinaryFile(cgroup / "memory.current", "3000000000\n"));
+    BOOST_CHECK_EQUAL(*util::GetAvailableMemory(proc, cgroup_root), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(util_numa)
+{
+    BOOST_CHECK(util::ParseCpuList("") == std::vector<int>{});
+    BOOST_CHECK(util::ParseCpuList("3") == std::vector<int>{3});
+    BOOST_CHECK((util::ParseCpuList("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    for (const auto list : {"a", "1,", "-1", "3-1", "1-2-3", "0-100000"}) {
+        BOOST_CHECK(!util::ParseCpuList(list));
+    }
+
+    const fs::path node_dir{m_args.GetDataDirBase() / "node"};
+    fs::create_directories(node_dir / "node1");
+    BOOST_CHECK(!util::GetNumaNodes(node_dir));
+    BOOST_CHECK(!util::GetNumaNodeCpus(1, node_dir));
+    BOOST_REQUIRE(WriteBinaryFile(node_dir / "online", "0-1\n"));
+    BOOST_REQUIRE(WriteBinaryFile(node_dir / "node1" / "cpulist", "4-7,12-15\n"));
+    BOOST_CHECK((util::GetNumaNodes(node_dir) == std::vector<int>{0, 1}));
+    BOOST_CHECK((util::GetNumaNodeCpus(1, node_dir) == std::vector<int>{4, 5, 6, 7, 12, 13, 14, 15}));
+    BOOST_CHECK(!util::GetNumaNodeCpus(0, node_dir));
+}
+
 BOOST_AUTO_TEST_CASE(clearshrink_test)
 {
     {
@@ -1749,4 +1802,29 @@ BOOST_AUTO_TEST_CASE(mib_string_literal_test)
     BOOST_CHECK_EXCEPTION(operator""_MiB(static_cast<unsigned long long>(max_mib) + 1), std::overflow_error, HasReason("MiB value too large for size_t byte conversion"));
 }
 
+BOOST_AUTO_TEST_CASE(latency_histogram_test)
+{
+    using namespace std::chrono_literals;
+    LatencyHistogram histogram;
+    BOOST_CHECK(histogram.Quantile(0.5) == 0ns);
+    histogram.Add(500ns);
+    histogram.Add(1us);
+    histogram.Add(3us);
+    for (int i{0}; i < 100; ++i) histogram.Add(1ms);
+    histogram.Add(1h);
+
+    BOOST_CHECK_EQUAL(histogram.Count(), 104U);
+    BOOST_CHECK(histogram.Total() == 500ns + 1us + 3us + 100ms + 1h);
+    BOOST_CHECK(histogram.Max() == 1h);
+    const auto& buckets{histogram.Buckets()};
+    BOOST_CHECK_EQUAL(buckets[0], 1U);
+    BOOST_CHECK_EQUAL(buckets[1], 1U);
+    BOOST_CHECK_EQUAL(buckets[2], 1U);
+    BOOST_CHECK_EQUAL(buckets[10], 100U);
+    BOOST_CHECK_EQUAL(buckets[LatencyHistogram::BUCKETS - 1], 1U);
+    BOOST_CHECK(histogram.Quantile(0.01) == 1us);
+    BOOST_CHECK(histogram.Quantile(0.5) == 1024us);
+    BOOST_CHECK(histogram.Quantile(1.0) == 1h);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
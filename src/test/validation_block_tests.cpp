@@ -16,6 +16,7 @@
 #include <util/time.h>
 #include <validation.h>
 #include <validationinterface.h>
+#include <versionbits.h>
 
 #include <thread>
 
@@ -364,4 +365,48 @@ BOOST_AUTO_TEST_CASE(witness_commitment_index)
 
     BOOST_CHECK_EQUAL(GetWitnessCommitmentIndex(pblock), 2);
 }
+namespace {
+struct HeaderCheckTestingSetup : public TestingSetup {
+    HeaderCheckTestingSetup()
+        : TestingSetup{ChainType::REGTEST, {.extra_args = {"-headercheckthreads=2"}}} {}
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(process_headers_parallel_checks, HeaderCheckTestingSetup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    const auto make_headers{[&](const CBlockHeader& start, size_t count) {
+        std::vector<CBlockHeader> headers;
+        uint256 prev_hash{start.GetHash()};
+        uint32_t time{start.nTime};
+        while (headers.size() < count) {
+            CBlockHeader& header{headers.emplace_back()};
+            header.nVersion = VERSIONBITS_LAST_OLD_BLOCK_VERSION;
+            header.hashPrevBlock = prev_hash;
+            header.nTime = ++time;
+            header.nBits = start.nBits;
+            while (!CheckProofOfWork(header.GetHash(), header.nBits, chainman.GetConsensus())) ++header.nNonce;
+            prev_hash = header.GetHash();
+        }
+        return headers;
+    }};
+
+    // Large enough to be split over the header check threads.
+    const auto headers{make_headers(chainman.GetParams().GenesisBlock(), 300)};
+    BlockValidationState state;
+    const CBlockIndex* last{nullptr};
+    BOOST_CHECK(chainman.ProcessNewBlockHeaders(headers, /*min_pow_checked=*/true, state, &last));
+    BOOST_REQUIRE(last);
+    BOOST_CHECK_EQUAL(last->nHeight, 300);
+    BOOST_CHECK(last->GetBlockHash() == headers.back().GetHash());
+
+    // A header without valid proof of work stops the batch, and the headers
+    // before it are still accepted.
+    auto more{make_headers(headers.back(), 200)};
+    while (CheckProofOfWork(more[150].GetHash(), more[150].nBits, chainman.GetConsensus())) ++more[150].nNonce;
+    BOOST_CHECK(!chainman.ProcessNewBlockHeaders(more, /*min_pow_checked=*/true, state, &last));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.m_best_header->nHeight), 450);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,9 +4,12 @@
 //
 #include <chainparams.h>
 #include <consensus/validation.h>
+#include <node/blockreadahead.h>
+#include <node/coins_cache_persist.h>
 #include <node/kernel_notifications.h>
 #include <random.h>
 #include <rpc/blockchain.h>
+#include <script/script.h>
 #include <sync.h>
 #include <test/util/chainstate.h>
 #include <test/util/coins.h>
@@ -16,12 +19,147 @@
 #include <util/check.h>
 #include <validation.h>
 
+#include <fstream>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(validation_chainstate_tests, ChainTestingSetup)
 
+struct PrefetchTestingSetup : public TestChain100Setup {
+    PrefetchTestingSetup()
+        : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-prefetchthreads=2", "-blockreadahead=4"}}} {}
+};
+
+//! Test that block inputs are prefetched from the coins database before connecting a block.
+BOOST_FIXTURE_TEST_CASE(chainstate_prefetch_inputs, PrefetchTestingSetup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+
+    // Spend two mature coinbase outputs, and chain a third transaction on the first.
+    const CScript script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    const auto tx1{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 0, coinbaseKey, script, 49 * COIN, /*submit=*/false)};
+    const auto tx2{CreateValidMempoolTransaction(m_coinbase_txns[1], 0, 0, coinbaseKey, script, 49 * COIN, /*submit=*/false)};
+    const auto tx3{CreateValidMempoolTransaction(MakeTransactionRef(tx1), 0, 0, coinbaseKey, script, 48 * COIN, /*submit=*/false)};
+    const CBlock block{CreateBlock({tx1, tx2, tx3}, script, chainstate)};
+
+    LOCK(::cs_main);
+    // Move every coin out of the in-memory cache.
+    BOOST_REQUIRE(chainstate.CoinsTip().Flush());
+    for (const auto& tx : {tx1, tx2}) {
+        BOOST_CHECK(!chainstate.CoinsTip().HaveCoinInCache(tx.vin[0].prevout));
+    }
+
+    // Only the coins not created within the block itself are looked up.
+    BOOST_CHECK_EQUAL(chainstate.PrefetchInputs(block.vtx), 2U);
+    BOOST_CHECK_EQUAL(chainstate.CoinsTip().GetFetchStats().prefetched, 2U);
+    for (const auto& tx : {tx1, tx2}) {
+        BOOST_CHECK(chainstate.CoinsTip().HaveCoinInCache(tx.vin[0].prevout));
+    }
+    BOOST_CHECK(!chainstate.CoinsTip().HaveCoinInCache(tx3.vin[0].prevout));
+
+    // Prefetched coins are fetched from the cache and do not need to be flushed.
+    const auto stats{chainstate.CoinsTip().GetFetchStats()};
+    BOOST_CHECK(chainstate.CoinsTip().AccessCoin(tx1.vin[0].prevout).out.nValue == 50 * COIN);
+    BOOST_CHECK_EQUAL(chainstate.CoinsTip().GetFetchStats().hits, stats.hits + 1);
+    BOOST_CHECK_EQUAL(chainstate.PrefetchInputs(block.vtx), 0U);
+    BOOST_CHECK(chainstate.CoinsTip().Sync());
+}
+
+//! Test that blocks connected with input prefetching and read-ahead enabled produce the same chain.
+BOOST_FIXTURE_TEST_CASE(chainstate_prefetch_connect, PrefetchTestingSetup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    const CScript script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    for (int i = 0; i < 5; ++i) {
+        WITH_LOCK(::cs_main, BOOST_REQUIRE(chainman.ActiveChainstate().CoinsTip().Flush()));
+        const auto tx{CreateValidMempoolTransaction(m_coinbase_txns[i], 0, 0, coinbaseKey, script, 49 * COIN, /*submit=*/false)};
+        const CBlock block{CreateAndProcessBlock({tx}, script)};
+        BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()), block.GetHash());
+    }
+    const uint256 tip_hash{WITH_LOCK(::cs_main, return chainman.ActiveChain().Tip()->GetBlockHash())};
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveHeight()), 105);
+
+    // Disconnect and reconnect the new blocks, which reads them back from disk
+    // through the read-ahead stage.
+    BlockValidationState state;
+    CBlockIndex* fork{WITH_LOCK(::cs_main, return chainman.ActiveChain()[101])};
+    BOOST_REQUIRE(chainman.ActiveChainstate().InvalidateBlock(state, fork));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveHeight()), 100);
+    WITH_LOCK(::cs_main, chainman.ActiveChainstate().ResetBlockFailureFlags(fork));
+    BOOST_REQUIRE(chainman.ActiveChainstate().ActivateBestChain(state));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()), tip_hash);
+    BOOST_CHECK(Assert(chainman.m_block_read_ahead)->GetHits() > 0);
+}
+
+//! Test that the stage timings of the most recently connected blocks are kept.
+BOOST_FIXTURE_TEST_CASE(chainstate_connect_stats, TestChain100Setup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    const auto connected{WITH_LOCK(::cs_main, return chainman.GetBlockConnectStats())};
+    // The genesis block and the 100 blocks mined by the setup.
+    BOOST_REQUIRE_EQUAL(connected.size(), 101U);
+    BOOST_CHECK_EQUAL(connected.front().height, 0);
+    BOOST_CHECK_EQUAL(connected.back().height, 100);
+    BOOST_CHECK_EQUAL(connected.back().hash, WITH_LOCK(::cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()));
+    // Blocks processed as they are mined are not read from disk.
+    BOOST_CHECK(connected.back().read == SteadyClock::duration{});
+    BOOST_CHECK(connected.back().deserialize == SteadyClock::duration{});
+
+    // Reconnecting blocks reads them back from disk.
+    BlockValidationState state;
+    CBlockIndex* fork{WITH_LOCK(::cs_main, return chainman.ActiveChain()[95])};
+    BOOST_REQUIRE(chainman.ActiveChainstate().InvalidateBlock(state, fork));
+    WITH_LOCK(::cs_main, chainman.ActiveChainstate().ResetBlockFailureFlags(fork));
+    BOOST_REQUIRE(chainman.ActiveChainstate().ActivateBestChain(state));
+    const auto reconnected{WITH_LOCK(::cs_main, return chainman.GetBlockConnectStats())};
+    BOOST_REQUIRE_EQUAL(reconnected.size(), 107U);
+    for (size_t i{101}; i < reconnected.size(); ++i) {
+        const BlockConnectStats& stats{reconnected[i]};
+        BOOST_CHECK_EQUAL(stats.height, int(i) - 6);
+        BOOST_CHECK(stats.deserialize > SteadyClock::duration{});
+        BOOST_CHECK(stats.read + stats.deserialize + stats.check + stats.inputs + stats.connect + stats.verify +
+                        stats.undo + stats.index + stats.flush + stats.chainstate <= stats.total);
+    }
+
+    // Only the most recent blocks are kept.
+    const CScript script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    while (WITH_LOCK(::cs_main, return chainman.GetBlockConnectStats().size()) < BLOCK_CONNECT_STATS_SIZE) {
+        CreateAndProcessBlock({}, script);
+    }
+    CreateAndProcessBlock({}, script);
+    const auto latest{WITH_LOCK(::cs_main, return chainman.GetBlockConnectStats())};
+    BOOST_CHECK_EQUAL(latest.size(), BLOCK_CONNECT_STATS_SIZE);
+    BOOST_CHECK_EQUAL(latest.back().height, WITH_LOCK(::cs_main, return chainman.ActiveHeight()));
+}
+
+//! Test that the coins cache is warmed up from a dump of its outpoints.
+BOOST_FIXTURE_TEST_CASE(chainstate_coins_cache_persist, TestChain100Setup)
+{
+    Chainstate& chainstate{Assert(m_node.chainman)->ActiveChainstate()};
+    const COutPoint outpoint{m_coinbase_txns[0]->GetHash(), 0};
+    const fs::path path{m_args.GetDataDirNet() / "coins_cache.dat"};
+    BOOST_REQUIRE(WITH_LOCK(::cs_main, return chainstate.CoinsTip().HaveCoinInCache(outpoint)));
+    BOOST_REQUIRE(node::DumpCoinsCache(chainstate, path));
+
+    // Flushing empties the cache, and loading the dump fills it back.
+    chainstate.ForceFlushStateToDisk();
+    BOOST_REQUIRE(!WITH_LOCK(::cs_main, return chainstate.CoinsTip().HaveCoinInCache(outpoint)));
+    BOOST_CHECK(node::LoadCoinsCache(chainstate, path, m_node.chainman->m_interrupt));
+    BOOST_CHECK(WITH_LOCK(::cs_main, return chainstate.CoinsTip().HaveCoinInCache(outpoint)));
+
+    // A corrupted dump is not loaded.
+    chainstate.ForceFlushStateToDisk();
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(10);
+        file.put('\xff');
+    }
+    BOOST_CHECK(!node::LoadCoinsCache(chainstate, path, m_node.chainman->m_interrupt));
+    BOOST_CHECK(!WITH_LOCK(::cs_main, return chainstate.CoinsTip().HaveCoinInCache(outpoint)));
+}
+
 //! Test resizing coins-related Chainstate caches during runtime.
 //!
 BOOST_AUTO_TEST_CASE(validation_chainstate_resize_caches)
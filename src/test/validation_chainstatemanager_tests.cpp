@@ -63,6 +63,7 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager, TestChain100Setup)
     auto active_tip = WITH_LOCK(manager.GetMutex(), return manager.ActiveTip());
     auto exp_tip = c1.m_chain.Tip();
     BOOST_CHECK_EQUAL(active_tip, exp_tip);
+    BOOST_CHECK_EQUAL(manager.ActiveChainView()->Tip(), exp_tip);
 
     BOOST_CHECK(!manager.SnapshotBlockhash().has_value());
 
@@ -103,6 +104,9 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager, TestChain100Setup)
     BOOST_CHECK_EQUAL(active_tip, active_tip2->pprev);
     BOOST_CHECK_EQUAL(active_tip, c1.m_chain.Tip());
     BOOST_CHECK_EQUAL(active_tip2, c2.m_chain.Tip());
+    // The view follows the active chainstate.
+    BOOST_CHECK_EQUAL(manager.ActiveChainView()->Tip(), active_tip2);
+    BOOST_CHECK_EQUAL((*manager.ActiveChainView())[110], active_tip);
 
     // Let scheduler events finish running to avoid accessing memory that is going to be unloaded
     m_node.validation_signals->SyncWithValidationInterfaceQueue();
@@ -168,9 +172,10 @@ struct SnapshotTestSetup : TestChain100Setup {
     // Note that this means the tests run considerably slower than in-memory DB
     // tests, but we can't otherwise test this functionality since it relies on
     // destructive filesystem operations.
-    SnapshotTestSetup() : TestChain100Setup{
+    explicit SnapshotTestSetup(std::vector<const char*> extra_args = {}) : TestChain100Setup{
                               {},
                               {
+                                  .extra_args = std::move(extra_args),
                                   .coins_db_in_memory = false,
                                   .block_tree_db_in_memory = false,
                               },
@@ -414,6 +419,31 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, SnapshotTestSetup)
     this->SetupSnapshot();
 }
 
+//! Test activation of chunked snapshots, whose chunks are decoded concurrently.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_chunked_snapshot, SnapshotTestSetup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    mineBlocks(10);
+
+    // A chunk is missing but the count is correct, so the hash of the coins
+    // computed while loading them does not match.
+    BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
+        this, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            BOOST_REQUIRE(metadata.IsChunked());
+            node::SnapshotChunk chunk;
+            auto_infile >> chunk;
+            metadata.m_coins_count -= chunk.coins_count;
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_CHECK(!chainman.IsSnapshotActive());
+
+    BOOST_REQUIRE(CreateAndActivateUTXOSnapshot(this, NoMalleation, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_CHECK(chainman.IsSnapshotActive());
+    LOCK(::cs_main);
+    for (const CTransactionRef& txn : m_coinbase_txns) {
+        BOOST_CHECK(chainman.ActiveChainstate().CoinsTip().HaveCoin(COutPoint{txn->GetHash(), 0}));
+    }
+}
+
 //! Test LoadBlockIndex behavior when multiple chainstates are in use.
 //!
 //! - First, verify that setBlockIndexCandidates is as expected when using a single,
@@ -424,6 +454,33 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, SnapshotTestSetup)
 //!   chainstate only contains fully validated blocks and the other chainstate contains all blocks,
 //!   except those marked assume-valid, because those entries don't HAVE_DATA.
 //!
+struct BackgroundParTestSetup : SnapshotTestSetup {
+    BackgroundParTestSetup() : SnapshotTestSetup{{"-backgroundpar=2", "-blockreadahead=4"}} {}
+};
+
+//! Test that the background chainstate uses its own script check queue and
+//! read-ahead stage with -backgroundpar, and that new blocks are still
+//! connected to the active chainstate.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_background_par, BackgroundParTestSetup)
+{
+    auto [background_cs, snapshot_cs] = this->SetupSnapshot();
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    {
+        LOCK(::cs_main);
+        BOOST_CHECK(&chainman.GetCheckQueue(*background_cs) != &chainman.GetCheckQueue(*snapshot_cs));
+        BOOST_CHECK(&chainman.GetCheckQueue(*snapshot_cs) == &chainman.GetCheckQueue());
+        BOOST_CHECK(chainman.GetCheckQueue(*background_cs).HasThreads());
+        BOOST_CHECK(chainman.GetBlockReadAhead(*background_cs) != chainman.GetBlockReadAhead(*snapshot_cs));
+        BOOST_CHECK(chainman.GetBlockReadAhead(*snapshot_cs) == chainman.m_block_read_ahead.get());
+    }
+
+    const int height{WITH_LOCK(::cs_main, return chainman.ActiveHeight())};
+    mineBlocks(2);
+    chainman.StopBackgroundValidation();
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveHeight()), height + 2);
+    BOOST_CHECK(WITH_LOCK(::cs_main, return chainman.BackgroundSyncInProgress()));
+}
+
 BOOST_FIXTURE_TEST_CASE(chainstatemanager_loadblockindex, TestChain100Setup)
 {
     ChainstateManager& chainman = *Assert(m_node.chainman);
@@ -834,6 +891,12 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_args, BasicTestingSetup)
 
     BOOST_CHECK(!get_opts({"-minimumchainwork=xyz"}));                                                               // invalid hex characters
     BOOST_CHECK(!get_opts({"-minimumchainwork=01234567890123456789012345678901234567890123456789012345678901234"})); // > 64 hex chars
+
+    // test -backgroundpar
+    BOOST_CHECK_EQUAL(get_valid_opts({}).background_worker_threads_num, DEFAULT_BACKGROUND_SCRIPTCHECK_THREADS);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=3"}).background_worker_threads_num, 3);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=-1"}).background_worker_threads_num, 0);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=100"}).background_worker_threads_num, MAX_SCRIPTCHECK_THREADS);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,9 +9,17 @@
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <kernel/chain.h>
+#include <kernel/mempool_removal_reason.h>
+#include <util/metrics.h>
 #include <validationinterface.h>
 
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, ChainTestingSetup)
 
@@ -101,4 +109,70 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+class SequenceRecorder : public CValidationInterface
+{
+public:
+    explicit SequenceRecorder(std::string name) : m_name{std::move(name)} {}
+    void TransactionRemovedFromMempool(const CTransactionRef&, MemPoolRemovalReason, uint64_t mempool_sequence) override
+    {
+        if (m_on_call) m_on_call();
+        m_sequences.push_back(mempool_sequence);
+    }
+    std::string SubscriberName() const override { return m_name; }
+    const std::string m_name;
+    std::function<void()> m_on_call;
+    std::vector<uint64_t> m_sequences;
+};
+
+BOOST_AUTO_TEST_CASE(subscriber_queues)
+{
+    CScheduler scheduler;
+    std::vector<std::thread> threads;
+    for (int i{0}; i < 2; ++i) threads.emplace_back([&] { scheduler.serviceQueue(); });
+    ValidationSignals signals{[&](std::function<void()> func) { scheduler.schedule(std::move(func), std::chrono::steady_clock::now()); }};
+
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future()};
+    SequenceRecorder slow{"test_slow"}, fast{"test_fast"};
+    slow.m_on_call = [&] { released.wait(); };
+    std::promise<void> fast_done;
+    fast.m_on_call = [&] {
+        if (fast.m_sequences.size() == 4) fast_done.set_value();
+    };
+    signals.RegisterValidationInterface(&slow);
+    signals.RegisterValidationInterface(&fast);
+
+    // A subscriber blocked on a notification does not delay the others.
+    const auto tx{MakeTransactionRef(CMutableTransaction{})};
+    for (uint64_t i{1}; i <= 5; ++i) signals.TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, i);
+    const std::vector<uint64_t> expected{1, 2, 3, 4, 5};
+    fast_done.get_future().wait();
+    BOOST_CHECK_GE(signals.CallbacksPending(), 4U);
+    BOOST_CHECK_GE(metrics::GetRegistry().GetGauge("bitcoin_validation_callbacks_pending", "", {{"subscriber", "test_slow"}}).Value(), 4);
+
+    // Syncing waits for all subscribers, which get notifications in order.
+    release.set_value();
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(slow.m_sequences == expected);
+    BOOST_CHECK(fast.m_sequences == expected);
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 0U);
+    BOOST_CHECK_EQUAL(metrics::GetRegistry().GetGauge("bitcoin_validation_callbacks_pending", "", {{"subscriber", "test_slow"}}).Value(), 0);
+
+    // Unregistered subscribers get no more notifications.
+    signals.UnregisterValidationInterface(&slow);
+    signals.TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, 6);
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(slow.m_sequences.size(), 5U);
+    BOOST_CHECK_EQUAL(fast.m_sequences.back(), 6U);
+
+    // Once the scheduler is stopped, notifications are delivered by flushing.
+    scheduler.stop();
+    for (auto& thread : threads) thread.join();
+    signals.TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, 7);
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 1U);
+    signals.FlushBackgroundCallbacks();
+    BOOST_CHECK_EQUAL(fast.m_sequences.back(), 7U);
+    signals.UnregisterAllValidationInterfaces();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -14,9 +14,13 @@
 #include <uint256.h>
 #include <util/vector.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <numeric>
 #include <utility>
 
 static constexpr uint8_t DB_COIN{'C'};
@@ -44,12 +48,84 @@ struct CoinEntry {
     SERIALIZE_METHODS(CoinEntry, obj) { READWRITE(obj.key, obj.outpoint->hash, VARINT(obj.outpoint->n)); }
 };
 
+//! Move it to the coin of outpoint and read it, if there is one.
+std::optional<Coin> SeekCoin(CDBIterator& it, const COutPoint& outpoint)
+{
+    it.Seek(CoinEntry(&outpoint));
+    COutPoint found;
+    CoinEntry entry(&found);
+    if (Coin coin; it.Valid() && it.GetKey(entry) && entry.key == DB_COIN && found == outpoint && it.GetValue(coin)) return coin;
+    return std::nullopt;
+}
+
+//! Indexes of outpoints in the order of their keys, so that an iterator looking them up only moves forward.
+std::vector<size_t> KeyOrder(std::span<const COutPoint> outpoints)
+{
+    std::vector<size_t> order(outpoints.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return outpoints[a] < outpoints[b]; });
+    return order;
+}
+
 } // namespace
 
+bool MissingCoinsCache::Contains(const COutPoint& outpoint, uint64_t& seq) const
+{
+    if (m_max_entries == 0) return false;
+    LOCK(m_mutex);
+    if (m_generations[0].contains(outpoint) || m_generations[1].contains(outpoint)) {
+        ++m_hits;
+        return true;
+    }
+    seq = m_write_seq;
+    return false;
+}
+
+void MissingCoinsCache::Add(const COutPoint& outpoint, uint64_t seq)
+{
+    if (m_max_entries == 0) return;
+    LOCK(m_mutex);
+    // The coin may have been written since the database was read.
+    if (seq != m_write_seq || seq % 2 != 0) return;
+    if (m_generations[m_current].size() >= (m_max_entries + 1) / 2) {
+        m_current ^= 1;
+        m_generations[m_current].clear();
+    }
+    m_generations[m_current].insert(outpoint);
+    m_empty = false;
+}
+
+void MissingCoinsCache::BeginWrite()
+{
+    LOCK(m_mutex);
+    ++m_write_seq;
+}
+
+void MissingCoinsCache::Erase(const COutPoint& outpoint)
+{
+    if (m_empty) return;
+    LOCK(m_mutex);
+    m_generations[0].erase(outpoint);
+    m_generations[1].erase(outpoint);
+}
+
+void MissingCoinsCache::EndWrite()
+{
+    LOCK(m_mutex);
+    ++m_write_seq;
+}
+
+MissingCoinsCache::Stats MissingCoinsCache::GetStats() const
+{
+    LOCK(m_mutex);
+    return {.hits = m_hits, .entries = m_generations[0].size() + m_generations[1].size()};
+}
+
 CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_db_params{std::move(db_params)},
     m_options{std::move(options)},
-    m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
+    m_db{std::make_unique<CDBWrapper>(m_db_params)},
+    m_missing_coins{m_options.missing_cache_entries} { }
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
@@ -67,12 +143,66 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 
 std::optional<Coin> CCoinsViewDB::GetCoin(const COutPoint& outpoint) const
 {
+    uint64_t seq;
+    if (m_missing_coins.Contains(outpoint, seq)) return std::nullopt;
     if (Coin coin; m_db->Read(CoinEntry(&outpoint), coin)) return coin;
+    m_missing_coins.Add(outpoint, seq);
     return std::nullopt;
 }
 
+std::vector<std::optional<Coin>> CCoinsViewDB::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    std::vector<std::optional<Coin>> coins(outpoints.size());
+    std::unique_ptr<CDBIterator> it;
+    for (size_t i : KeyOrder(outpoints)) {
+        const COutPoint& outpoint{outpoints[i]};
+        uint64_t seq;
+        if (m_missing_coins.Contains(outpoint, seq)) continue;
+        if (!it) it.reset(m_db->NewIterator());
+        coins[i] = SeekCoin(*it, outpoint);
+        if (!coins[i]) m_missing_coins.Add(outpoint, seq);
+    }
+    return coins;
+}
+
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
-    return m_db->Exists(CoinEntry(&outpoint));
+    uint64_t seq;
+    if (m_missing_coins.Contains(outpoint, seq)) return false;
+    if (m_db->Exists(CoinEntry(&outpoint))) return true;
+    m_missing_coins.Add(outpoint, seq);
+    return false;
+}
+
+std::unique_ptr<CCoinsViewDBSnapshot> CCoinsViewDB::GetSnapshot() const
+{
+    return std::make_unique<CCoinsViewDBSnapshot>(*m_db, m_db->GetSnapshot());
+}
+
+std::optional<Coin> CCoinsViewDBSnapshot::GetCoin(const COutPoint& outpoint) const
+{
+    if (Coin coin; m_db.Read(CoinEntry(&outpoint), coin, m_snapshot)) return coin;
+    return std::nullopt;
+}
+
+std::vector<std::optional<Coin>> CCoinsViewDBSnapshot::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    std::vector<std::optional<Coin>> coins(outpoints.size());
+    if (outpoints.empty()) return coins;
+    const std::unique_ptr<CDBIterator> it{m_db.NewIterator(m_snapshot)};
+    for (size_t i : KeyOrder(outpoints)) coins[i] = SeekCoin(*it, outpoints[i]);
+    return coins;
+}
+
+bool CCoinsViewDBSnapshot::HaveCoin(const COutPoint& outpoint) const
+{
+    return GetCoin(outpoint).has_value();
+}
+
+uint256 CCoinsViewDBSnapshot::GetBestBlock() const
+{
+    uint256 hashBestChain;
+    if (!m_db.Read(DB_BEST_BLOCK, hashBestChain, m_snapshot)) return uint256();
+    return hashBestChain;
 }
 
 uint256 CCoinsViewDB::GetBestBlock() const {
@@ -91,7 +221,17 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) {
-    CDBBatch batch(*m_db);
+    // Full batches are committed on m_write_pool while the next one is being
+    // filled. At most one commit is in flight, which bounds memory to two
+    // batches and keeps them reaching the database in order.
+    CDBBatch batch_a(*m_db);
+    CDBBatch batch_b(*m_db);
+    CDBBatch* batch{&batch_a};
+    CDBBatch* spare{&batch_b};
+    std::future<void> pending_write;
+    const auto wait_for_write{[&] {
+        if (pending_write.valid()) pending_write.get();
+    }};
     size_t count = 0;
     size_t changed = 0;
     assert(!hashBlock.IsNull());
@@ -101,10 +241,12 @@ bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashB
         // We may be in the middle of replaying.
         std::vector<uint256> old_heads = GetHeadBlocks();
         if (old_heads.size() == 2) {
-            if (old_heads[0] != hashBlock) {
+            // A previous partial write from this process may have left the
+            // database between old_heads[1] and an earlier tip.
+            if (old_heads[0] != hashBlock && old_heads[0] != m_partial_head) {
                 LogPrintLevel(BCLog::COINDB, BCLog::Level::Error, "The coins database detected an inconsistent state, likely due to a previous crash or shutdown. You will need to restart bitcoind with the -reindex-chainstate or -reindex configuration option.\n");
             }
-            assert(old_heads[0] == hashBlock);
+            assert(old_heads[0] == hashBlock || old_heads[0] == m_partial_head);
             old_tip = old_heads[1];
         }
     }
@@ -113,60 +255,115 @@ bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashB
     // transition from old_tip to hashBlock.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
-    batch.Erase(DB_BEST_BLOCK);
-    batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
-
-    for (auto it{cursor.Begin()}; it != cursor.End();) {
-        if (it->second.IsDirty()) {
-            CoinEntry entry(&it->first);
-            if (it->second.coin.IsSpent()) {
-                batch.Erase(entry);
-            } else {
-                batch.Write(entry, it->second.coin);
-            }
-
-            changed++;
-        }
-        count++;
-        it = cursor.NextAndMaybeErase(*it);
-        if (batch.ApproximateSize() > m_options.batch_write_bytes) {
-            LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.ApproximateSize() * (1.0 / 1048576.0));
+    batch->Erase(DB_BEST_BLOCK);
+    batch->Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
+
+    // Lookups racing with this write must not remember added coins as missing.
+    m_missing_coins.BeginWrite();
+    const struct EndWrite {
+        MissingCoinsCache& cache;
+        ~EndWrite() { cache.EndWrite(); }
+    } end_write{m_missing_coins};
+
+    try {
+        for (auto it{cursor.Begin()}; it != cursor.End();) {
+            if (it->second.IsDirty()) {
+                CoinEntry entry(&it->first);
+                if (it->second.coin.IsSpent()) {
+                    batch->Erase(entry);
+                } else {
+                    m_missing_coins.Erase(it->first);
+                    batch->Write(entry, it->second.coin);
+                }
 
-            m_db->WriteBatch(batch);
-            batch.Clear();
-            if (m_options.simulate_crash_ratio) {
-                static FastRandomContext rng;
-                if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
-                    LogPrintf("Simulating a crash. Goodbye.\n");
-                    _Exit(0);
+                changed++;
+            }
+            count++;
+            it = cursor.NextAndMaybeErase(*it);
+            if (batch->ApproximateSize() > m_options.batch_write_bytes) {
+                LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch->ApproximateSize() * (1.0 / 1048576.0));
+
+                wait_for_write();
+                if (m_options.simulate_crash_ratio) {
+                    static FastRandomContext rng;
+                    if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
+                        LogPrintf("Simulating a crash. Goodbye.\n");
+                        _Exit(0);
+                    }
                 }
+                if (m_options.async_batch_write && m_write_pool.WorkersCount() == 0) m_write_pool.Start(1);
+                pending_write = m_write_pool.Submit([this, full = batch] {
+                    m_db->WriteBatch(*full);
+                    full->Clear();
+                });
+                std::swap(batch, spare);
             }
         }
+        wait_for_write();
+    } catch (...) {
+        // Do not let the batches go away under the background commit.
+        if (pending_write.valid()) pending_write.wait();
+        throw;
+    }
+
+    if (cursor.IsPartial()) {
+        // Not all flagged entries were handed to us. Leave the transition
+        // marker in place, so a crash before the rest is written is recovered
+        // by replaying the blocks from old_tip.
+        LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB, more to follow\n", batch->ApproximateSize() * (1.0 / 1048576.0));
+        bool ret = m_db->WriteBatch(*batch);
+        if (ret) m_partial_head = hashBlock;
+        LogDebug(BCLog::COINDB, "Committed %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
+        return ret;
     }
 
     // In the last batch, mark the database as consistent with hashBlock again.
-    batch.Erase(DB_HEAD_BLOCKS);
-    batch.Write(DB_BEST_BLOCK, hashBlock);
+    batch->Erase(DB_HEAD_BLOCKS);
+    batch->Write(DB_BEST_BLOCK, hashBlock);
 
-    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batch.ApproximateSize() * (1.0 / 1048576.0));
-    bool ret = m_db->WriteBatch(batch);
+    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batch->ApproximateSize() * (1.0 / 1048576.0));
+    bool ret = m_db->WriteBatch(*batch);
+    if (ret) m_partial_head.SetNull();
     LogDebug(BCLog::COINDB, "Committed %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
     return ret;
 }
 
+void CCoinsViewDB::BulkWrite(std::span<const std::pair<COutPoint, Coin>> coins)
+{
+    CDBBatch batch(*m_db);
+    for (const auto& [outpoint, coin] : coins) {
+        m_missing_coins.Erase(outpoint);
+        batch.Write(CoinEntry(&outpoint), coin);
+        if (batch.ApproximateSize() > m_options.batch_write_bytes) {
+            m_db->WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    m_db->WriteBatch(batch);
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
 }
 
+//! Number of distinct two-byte txid prefixes, by which Cursors() splits the coins.
+static constexpr uint32_t TXID_PREFIXES{0x10000};
+
+//! The first two bytes of a txid as stored, which determine its position in the database.
+static uint32_t TxidPrefix(const Txid& txid)
+{
+    return 0x100 * *UCharCast(txid.begin()) + *(UCharCast(txid.begin()) + 1);
+}
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
 public:
     // Prefer using CCoinsViewDB::Cursor() since we want to perform some
     // cache warmup on instantiation.
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn, uint32_t end_prefix = TXID_PREFIXES):
+        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn), m_end_prefix(end_prefix) {}
     ~CCoinsViewDBCursor() = default;
 
     bool GetKey(COutPoint &key) const override;
@@ -178,6 +375,11 @@ public:
 private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! Coins from the first txid with this prefix on are outside of the range of the cursor.
+    const uint32_t m_end_prefix;
+
+    //! Cache the key at the current position, or invalidate it after the last record of the range.
+    void CacheKey();
 
     friend class CCoinsViewDB;
 };
@@ -191,14 +393,41 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    i->CacheKey();
+    return i;
+}
+
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewDB::Cursors(size_t count) const
+{
+    count = std::clamp<size_t>(count, 1, TXID_PREFIXES);
+    const uint256 best_block{GetBestBlock()};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    cursors.reserve(count);
+    for (auto& iterator : const_cast<CDBWrapper&>(*m_db).NewIterators(count)) {
+        // Split the key space into ranges of txid prefixes of about the same
+        // size; txids are uniformly distributed, so the coins are too.
+        const uint32_t begin_prefix = TXID_PREFIXES * cursors.size() / count;
+        const uint32_t end_prefix = TXID_PREFIXES * (cursors.size() + 1) / count;
+        auto i = std::make_unique<CCoinsViewDBCursor>(iterator.release(), best_block, end_prefix);
+        uint256 first_txid;
+        *first_txid.begin() = begin_prefix >> 8;
+        *(first_txid.begin() + 1) = begin_prefix & 0xff;
+        const COutPoint first{Txid::FromUint256(first_txid), 0};
+        i->pcursor->Seek(CoinEntry(&first));
+        i->CacheKey();
+        cursors.push_back(std::move(i));
+    }
+    return cursors;
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || (entry.key == DB_COIN && TxidPrefix(keyTmp.second.hash) >= m_end_prefix)) {
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = entry.key;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -224,10 +453,5 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    CacheKey();
 }
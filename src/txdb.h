@@ -10,55 +10,172 @@
 #include <dbwrapper.h>
 #include <kernel/cs_main.h>
 #include <sync.h>
+#include <primitives/transaction.h>
 #include <util/fs.h>
+#include <util/hasher.h>
+#include <util/threadpool.h>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-class COutPoint;
 class uint256;
 
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -dbasyncwrite default
+static constexpr bool DEFAULT_DB_ASYNC_WRITE{true};
+//! -dbmissingcache default (entries)
+static constexpr size_t DEFAULT_DB_MISSING_CACHE_ENTRIES{50'000};
 
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
     //! Maximum database write batch size in bytes.
     size_t batch_write_bytes = nDefaultDbBatchSize;
+    //! Commit full batches on a background thread while the next batch is
+    //! being filled.
+    bool async_batch_write = DEFAULT_DB_ASYNC_WRITE;
     //! If non-zero, randomly exit when the database is flushed with (1/ratio)
     //! probability.
     int simulate_crash_ratio = 0;
+    //! Number of outpoints found missing to remember, see MissingCoinsCache.
+    size_t missing_cache_entries = DEFAULT_DB_MISSING_CACHE_ENTRIES;
+};
+
+/**
+ * Bounded set of outpoints recently looked up in the coins database and found
+ * missing, e.g. the inputs of orphan transactions, so that looking them up
+ * again does not read the database.
+ *
+ * Entries are exact, never probabilistic, so the cache cannot hide an
+ * existing coin. Writers call Erase() for every coin they add between
+ * BeginWrite() and EndWrite(), and a lookup that raced with a write is not
+ * remembered. Once half of the entries have been added since the last time,
+ * the older half is forgotten.
+ */
+class MissingCoinsCache
+{
+public:
+    struct Stats {
+        //! Number of lookups answered without reading the database.
+        uint64_t hits{0};
+        size_t entries{0};
+    };
+
+    explicit MissingCoinsCache(size_t max_entries) : m_max_entries{max_entries} {}
+
+    //! Whether `outpoint` is known to be missing. If not, `seq` is set to
+    //! pass to Add() once the database has been read.
+    bool Contains(const COutPoint& outpoint, uint64_t& seq) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Remember that a lookup which started with Contains() found nothing.
+    void Add(const COutPoint& outpoint, uint64_t seq) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void BeginWrite() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Forget `outpoint`, because a coin for it is about to be written.
+    void Erase(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void EndWrite() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const size_t m_max_entries;
+    mutable Mutex m_mutex;
+    //! The newer and the older half of the entries; m_current indexes the newer one.
+    std::array<std::unordered_set<COutPoint, SaltedOutpointHasher>, 2> m_generations GUARDED_BY(m_mutex);
+    size_t m_current GUARDED_BY(m_mutex){0};
+    //! Incremented when a write begins and ends, so it is odd during writes.
+    uint64_t m_write_seq GUARDED_BY(m_mutex){0};
+    mutable uint64_t m_hits GUARDED_BY(m_mutex){0};
+    //! Fast path for writers while nothing is cached.
+    std::atomic<bool> m_empty{true};
 };
 
 /** CCoinsView backed by the coin database (chainstate/) */
+class CCoinsViewDBSnapshot;
+
 class CCoinsViewDB final : public CCoinsView
 {
 protected:
     DBParams m_db_params;
     CoinsViewOptions m_options;
     std::unique_ptr<CDBWrapper> m_db;
+    //! Tip of the last partial BatchWrite, if the database has not been made
+    //! consistent since. Null otherwise.
+    uint256 m_partial_head;
+    //! Commits batches of BatchWrite in the background. Started on first use.
+    ThreadPool m_write_pool{"coindbwrite"};
+    mutable MissingCoinsCache m_missing_coins;
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
 
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    //! Looks up the coins with a single iterator in key order, from one snapshot of the database.
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t count) const override;
+
+    /**
+     * Write coins straight to the database, bypassing any cache on top of it
+     * and leaving the best block untouched, e.g. to load a snapshot into a
+     * database that is not in use yet. Coins written in key order across calls
+     * make each table file LevelDB writes cover a range of keys of its own, so
+     * that the tables are moved down the levels instead of being merged.
+     */
+    void BulkWrite(std::span<const std::pair<COutPoint, Coin>> coins);
+
+    //! Snapshot of the coins in the database, readable while it is written.
+    //! It must not outlive this view.
+    std::unique_ptr<CCoinsViewDBSnapshot> GetSnapshot() const;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
+    //! Whether a partial BatchWrite left the database between two blocks.
+    bool IsPartiallyWritten() const { return !m_partial_head.IsNull(); }
     size_t EstimateSize() const override;
 
     //! Dynamically alter the underlying leveldb cache size.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    //! Compaction and write statistics of the database.
+    DBStats GetDBStats() const { return m_db->GetStats(); }
+    //! Approximate memory used by the database, including its block cache.
+    size_t GetDBMemoryUsage() const { return m_db->DynamicMemoryUsage(); }
+    //! Statistics of the lookups of missing coins that did not read the database.
+    MissingCoinsCache::Stats GetMissingCoinsStats() const { return m_missing_coins.GetStats(); }
+
     //! @returns filesystem path to on-disk storage or std::nullopt if in memory.
     std::optional<fs::path> StoragePath() { return m_db->StoragePath(); }
 };
 
+/**
+ * Read-only view of the coins database as of the time it was taken with
+ * CCoinsViewDB::GetSnapshot(), unaffected by later flushes. It bypasses the
+ * missing coins cache, which describes the current state of the database.
+ */
+class CCoinsViewDBSnapshot final : public CCoinsView
+{
+    const CDBWrapper& m_db;
+    const CDBWrapper::Snapshot m_snapshot;
+
+public:
+    CCoinsViewDBSnapshot(const CDBWrapper& db, CDBWrapper::Snapshot snapshot) : m_db{db}, m_snapshot{std::move(snapshot)} {}
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    //! Looks up the coins with a single iterator in key order.
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    uint256 GetBestBlock() const override;
+};
+
 #endif // BITCOIN_TXDB_H
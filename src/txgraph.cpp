@@ -9,9 +9,11 @@
 #include <util/bitset.h>
 #include <util/check.h>
 #include <util/feefrac.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 
 #include <compare>
+#include <future>
 #include <memory>
 #include <set>
 #include <span>
@@ -23,6 +25,10 @@ using namespace cluster_linearize;
 
 /** The maximum number of levels a TxGraph can have (0 = main, 1 = staging). */
 static constexpr int MAX_LEVELS{2};
+/** The number of linearization iterations spent to make a Cluster acceptable. */
+static constexpr uint64_t ACCEPTABLE_ITERS{10000};
+/** The minimum number of Clusters to relinearize at once for this to be done in parallel. */
+static constexpr size_t MIN_PARALLEL_RELINEARIZE_CLUSTERS{16};
 
 // Forward declare the TxGraph implementation class.
 class TxGraphImpl;
@@ -191,6 +197,11 @@ public:
     void ApplyDependencies(TxGraphImpl& graph, std::span<std::pair<GraphIndex, GraphIndex>> to_apply) noexcept;
     /** Improve the linearization of this Cluster. */
     void Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept;
+    /** Compute an improved linearization of this Cluster, and whether it is optimal, without
+     *  modifying the Cluster, so that this can run on another thread. */
+    std::pair<std::vector<DepGraphIndex>, bool> ComputeLinearization(uint64_t max_iters, uint64_t rng_seed) const noexcept;
+    /** Replace the linearization of this Cluster with one computed by ComputeLinearization(). */
+    void SetLinearization(TxGraphImpl& graph, std::vector<DepGraphIndex> linearization, bool optimal) noexcept;
     /** For every chunk in the cluster, append its FeeFrac to ret. */
     void AppendChunkFeerates(std::vector<FeeFrac>& ret) const noexcept;
     /** Add a TrimTxData entry (filling m_chunk_feerate, m_index, m_tx_size) for every
@@ -1651,12 +1662,23 @@ void Cluster::Relinearize(TxGraphImpl& graph, uint64_t max_iters) noexcept
     Assume(!NeedsSplitting());
     // No work is required for Clusters which are already optimally linearized.
     if (IsOptimal()) return;
-    // Invoke the actual linearization algorithm (passing in the existing one).
     uint64_t rng_seed = graph.m_rng.rand64();
+    auto [linearization, optimal] = ComputeLinearization(max_iters, rng_seed);
+    SetLinearization(graph, std::move(linearization), optimal);
+}
+
+std::pair<std::vector<DepGraphIndex>, bool> Cluster::ComputeLinearization(uint64_t max_iters, uint64_t rng_seed) const noexcept
+{
+    // Invoke the actual linearization algorithm (passing in the existing one).
     auto [linearization, optimal] = Linearize(m_depgraph, max_iters, rng_seed, m_linearization);
     // Postlinearize if the result isn't optimal already. This guarantees (among other things)
     // that the chunks of the resulting linearization are all connected.
     if (!optimal) PostLinearize(m_depgraph, linearization);
+    return {std::move(linearization), optimal};
+}
+
+void Cluster::SetLinearization(TxGraphImpl& graph, std::vector<DepGraphIndex> linearization, bool optimal) noexcept
+{
     // Update the linearization.
     m_linearization = std::move(linearization);
     // Update the Cluster's quality.
@@ -1670,7 +1692,7 @@ void TxGraphImpl::MakeAcceptable(Cluster& cluster) noexcept
 {
     // Relinearize the Cluster if needed.
     if (!cluster.NeedsSplitting() && !cluster.IsAcceptable() && !cluster.IsOversized()) {
-        cluster.Relinearize(*this, 10000);
+        cluster.Relinearize(*this, ACCEPTABLE_ITERS);
     }
 }
 
@@ -1680,6 +1702,36 @@ void TxGraphImpl::MakeAllAcceptable(int level) noexcept
     auto& clusterset = GetClusterSet(level);
     if (clusterset.m_oversized == true) return;
     auto& queue = clusterset.m_clusters[int(QualityLevel::NEEDS_RELINEARIZE)];
+    // With many Clusters to relinearize, linearize them in parallel on the shared thread pool
+    // first, and only install the results afterwards, on this thread. Clusters are not modified
+    // until then, and the seeds are drawn up front, so the outcome does not depend on the workers.
+    SharedThreadPool& pool{GetSharedThreadPool()};
+    if (queue.size() >= MIN_PARALLEL_RELINEARIZE_CLUSTERS && pool.WorkersCount() > 1) {
+        std::vector<Cluster*> clusters;
+        std::vector<uint64_t> rng_seeds;
+        clusters.reserve(queue.size());
+        rng_seeds.reserve(queue.size());
+        for (const auto& cluster : queue) {
+            clusters.push_back(cluster.get());
+            rng_seeds.push_back(m_rng.rand64());
+        }
+        std::vector<std::pair<std::vector<DepGraphIndex>, bool>> results(clusters.size());
+        SharedThreadPool::Group group{pool, SharedThreadPool::Priority::NORMAL, pool.WorkersCount()};
+        const size_t tasks{std::min(group.Concurrency(), clusters.size())};
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks);
+        for (size_t task{0}; task < tasks; ++task) {
+            futures.push_back(group.Submit([&, task] {
+                for (size_t i{task}; i < clusters.size(); i += tasks) {
+                    results[i] = clusters[i]->ComputeLinearization(ACCEPTABLE_ITERS, rng_seeds[i]);
+                }
+            }));
+        }
+        for (auto& future : futures) future.get();
+        for (size_t i{0}; i < clusters.size(); ++i) {
+            clusters[i]->SetLinearization(*this, std::move(results[i].first), results[i].second);
+        }
+    }
     while (!queue.empty()) {
         MakeAcceptable(*queue.back().get());
     }
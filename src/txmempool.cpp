@@ -18,8 +18,10 @@
 #include <tinyformat.h>
 #include <util/check.h>
 #include <util/feefrac.h>
+#include <util/metrics.h>
 #include <util/moneystr.h>
 #include <util/overflow.h>
+#include <util/rbf.h>
 #include <util/result.h>
 #include <util/time.h>
 #include <util/trace.h>
@@ -27,15 +29,38 @@
 #include <validationinterface.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <numeric>
 #include <optional>
 #include <ranges>
+#include <unordered_map>
 #include <string_view>
 #include <utility>
 
 TRACEPOINT_SEMAPHORE(mempool, added);
 TRACEPOINT_SEMAPHORE(mempool, removed);
+TRACEPOINT_SEMAPHORE(mempool, trimmed);
+
+namespace {
+metrics::Gauge& g_metric_transactions{metrics::GetRegistry().GetGauge("bitcoin_mempool_transactions", "Transactions in the mempool")};
+metrics::Gauge& g_metric_vsize{metrics::GetRegistry().GetGauge("bitcoin_mempool_vsize_bytes", "Sum of the virtual sizes of the transactions in the mempool")};
+metrics::Gauge& g_metric_fees{metrics::GetRegistry().GetGauge("bitcoin_mempool_fees_sat", "Sum of the fees of the transactions in the mempool, in satoshis")};
+metrics::Counter& g_metric_added{metrics::GetRegistry().GetCounter("bitcoin_mempool_added", "Transactions added to the mempool")};
+
+metrics::Counter& RemovedMetric(MemPoolRemovalReason reason)
+{
+    static const auto counters{[] {
+        std::array<metrics::Counter*, size_t(MemPoolRemovalReason::REPLACED) + 1> ret;
+        for (size_t i{0}; i < ret.size(); ++i) {
+            ret[i] = &metrics::GetRegistry().GetCounter("bitcoin_mempool_removed", "Transactions removed from the mempool, by reason",
+                                                        {{"reason", RemovalReasonToString(MemPoolRemovalReason(i))}});
+        }
+        return ret;
+    }()};
+    return *counters[size_t(reason)];
+}
+} // namespace
 
 bool TestLockPointValidity(CChain& active_chain, const LockPoints& lp)
 {
@@ -57,8 +82,8 @@ bool TestLockPointValidity(CChain& active_chain, const LockPoints& lp)
 void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendants,
                                       const std::set<uint256>& setExclude, std::set<uint256>& descendants_to_remove)
 {
-    CTxMemPoolEntry::Children stageEntries, descendants;
-    stageEntries = updateIt->GetMemPoolChildrenConst();
+    const CTxMemPoolEntry::Children& children_of_update{updateIt->GetMemPoolChildrenConst()};
+    CTxMemPoolEntry::Entries stageEntries{children_of_update.begin(), children_of_update.end()}, descendants;
 
     while (!stageEntries.empty()) {
         const CTxMemPoolEntry& descendant = *stageEntries.begin();
@@ -108,6 +133,7 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendan
 void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256>& vHashesToUpdate)
 {
     AssertLockHeld(cs);
+    m_snapshot.reset();
     // For each entry in vHashesToUpdate, store the set of in-mempool, but not
     // in-vHashesToUpdate transactions, so that we don't have to recalculate
     // descendants when we come across a previously seen entry.
@@ -130,13 +156,14 @@ void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256>& vHashes
         if (it == mapTx.end()) {
             continue;
         }
-        auto iter = mapNextTx.lower_bound(COutPoint(Txid::FromUint256(hash), 0));
         // First calculate the children, and update CTxMemPoolEntry::m_children to
         // include them, and update their CTxMemPoolEntry::m_parents to include this tx.
         // we cache the in-mempool children to avoid duplicate updates
         {
             WITH_FRESH_EPOCH(m_epoch);
-            for (; iter != mapNextTx.end() && iter->first->hash == hash; ++iter) {
+            for (uint32_t n{0}; n < it->GetTx().vout.size(); ++n) {
+                const auto iter = mapNextTx.find(COutPoint(it->GetTx().GetHash(), n));
+                if (iter == mapNextTx.end()) continue;
                 const uint256 &childHash = iter->second->GetHash();
                 txiter childIter = mapTx.find(childHash);
                 assert(childIter != mapTx.end());
@@ -163,7 +190,7 @@ void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256>& vHashes
 util::Result<CTxMemPool::setEntries> CTxMemPool::CalculateAncestorsAndCheckLimits(
     int64_t entry_size,
     size_t entry_count,
-    CTxMemPoolEntry::Parents& staged_ancestors,
+    CTxMemPoolEntry::Entries& staged_ancestors,
     const Limits& limits) const
 {
     int64_t totalSizeWithAncestors = entry_size;
@@ -218,7 +245,7 @@ util::Result<void> CTxMemPool::CheckPackageLimits(const Package& package,
         return util::Error{Untranslated(strprintf("package size %u exceeds descendant size limit [limit: %u]", total_vsize, m_opts.limits.descendant_size_vbytes))};
     }
 
-    CTxMemPoolEntry::Parents staged_ancestors;
+    CTxMemPoolEntry::Entries staged_ancestors;
     for (const auto& tx : package) {
         for (const auto& input : tx->vin) {
             std::optional<txiter> piter = GetIter(input.prevout.hash);
@@ -245,7 +272,7 @@ util::Result<CTxMemPool::setEntries> CTxMemPool::CalculateMemPoolAncestors(
     const Limits& limits,
     bool fSearchForParents /* = true */) const
 {
-    CTxMemPoolEntry::Parents staged_ancestors;
+    CTxMemPoolEntry::Entries staged_ancestors;
     const CTransaction &tx = entry.GetTx();
 
     if (fSearchForParents) {
@@ -265,7 +292,8 @@ util::Result<CTxMemPool::setEntries> CTxMemPool::CalculateMemPoolAncestors(
         // If we're not searching for parents, we require this to already be an
         // entry in the mempool and use the entry's cached parents.
         txiter it = mapTx.iterator_to(entry);
-        staged_ancestors = it->GetMemPoolParentsConst();
+        const CTxMemPoolEntry::Parents& parents{it->GetMemPoolParentsConst()};
+        staged_ancestors.insert(parents.begin(), parents.end());
     }
 
     return CalculateAncestorsAndCheckLimits(entry.GetTxSize(), /*entry_count=*/1, staged_ancestors,
@@ -334,16 +362,29 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
         // Here we only update statistics and not data in CTxMemPool::Parents
         // and CTxMemPoolEntry::Children (which we need to preserve until we're
         // finished with all operations that need to traverse the mempool).
+        // Rather than walking the descendants of every removed transaction,
+        // which is quadratic for chains confirmed by the same block, update
+        // each descendant staying in the mempool once for all of its removed
+        // ancestors. Descendants that are removed as well are not updated.
+        setEntries setDescendants;
         for (txiter removeIt : entriesToRemove) {
-            setEntries setDescendants;
             CalculateDescendants(removeIt, setDescendants);
-            setDescendants.erase(removeIt); // don't update state for self
-            int32_t modifySize = -removeIt->GetTxSize();
-            CAmount modifyFee = -removeIt->GetModifiedFee();
-            int modifySigOps = -removeIt->GetSigOpCost();
-            for (txiter dit : setDescendants) {
-                mapTx.modify(dit, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(modifySize, modifyFee, -1, modifySigOps); });
+        }
+        for (txiter dit : setDescendants) {
+            if (entriesToRemove.count(dit)) continue;
+            int32_t modifySize = 0;
+            CAmount modifyFee = 0;
+            int64_t modifyCount = 0;
+            int64_t modifySigOps = 0;
+            // The parent links are still intact, see below.
+            for (txiter ancestorIt : AssumeCalculateMemPoolAncestors(__func__, *dit, Limits::NoLimits(), /*fSearchForParents=*/false)) {
+                if (!entriesToRemove.count(ancestorIt)) continue;
+                modifySize -= ancestorIt->GetTxSize();
+                modifyFee -= ancestorIt->GetModifiedFee();
+                --modifyCount;
+                modifySigOps -= ancestorIt->GetSigOpCost();
             }
+            mapTx.modify(dit, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(modifySize, modifyFee, modifyCount, modifySigOps); });
         }
     }
     for (txiter removeIt : entriesToRemove) {
@@ -368,6 +409,8 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
         // we use the cached notion of ancestor transactions as the set of
         // things to update for removal.
         auto ancestors{AssumeCalculateMemPoolAncestors(__func__, entry, Limits::NoLimits(), /*fSearchForParents=*/false)};
+        // Ancestors that are removed as well need no update.
+        std::erase_if(ancestors, [&](txiter ancestorIt) { return entriesToRemove.count(ancestorIt) > 0; });
         // Note that UpdateAncestorsOf severs the child links that point to
         // removeIt in the entries for the parents of removeIt.
         UpdateAncestorsOf(false, removeIt, ancestors);
@@ -482,6 +525,7 @@ void CTxMemPool::addNewTransaction(CTxMemPool::txiter newit, CTxMemPool::setEntr
     // (When we update the entry for in-mempool parents, memory usage will be
     // further updated.)
     cachedInnerUsage += entry.DynamicMemoryUsage();
+    m_total_tx_usage += entry.DynamicMemoryUsage();
 
     const CTransaction& tx = newit->GetTx();
     std::set<Txid> setParentTransactions;
@@ -504,12 +548,18 @@ void CTxMemPool::addNewTransaction(CTxMemPool::txiter newit, CTxMemPool::setEntr
     UpdateEntryForAncestors(newit, setAncestors);
 
     nTransactionsUpdated++;
+    m_snapshot.reset();
     totalTxSize += entry.GetTxSize();
     m_total_fee += entry.GetFee();
 
     txns_randomized.emplace_back(newit->GetSharedTx());
     newit->idx_randomized = txns_randomized.size() - 1;
 
+    g_metric_added.Inc();
+    g_metric_transactions.Set(mapTx.size());
+    g_metric_vsize.Set(totalTxSize);
+    g_metric_fees.Set(m_total_fee);
+
     TRACEPOINT(mempool, added,
         entry.GetTx().GetHash().data(),
         entry.GetTxSize(),
@@ -522,6 +572,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     // We increment mempool sequence value no matter removal reason
     // even if not directly reported below.
     uint64_t mempool_sequence = GetAndIncrementSequence();
+    LogChange(mempool_sequence, it->GetTx().GetHash(), reason);
 
     if (reason != MemPoolRemovalReason::BLOCK && m_opts.signals) {
         // Notify clients that a transaction has been removed from the mempool
@@ -557,9 +608,16 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     totalTxSize -= it->GetTxSize();
     m_total_fee -= it->GetFee();
     cachedInnerUsage -= it->DynamicMemoryUsage();
-    cachedInnerUsage -= memusage::DynamicUsage(it->GetMemPoolParentsConst()) + memusage::DynamicUsage(it->GetMemPoolChildrenConst());
+    m_total_tx_usage -= it->DynamicMemoryUsage();
+    cachedInnerUsage -= it->GetMemPoolParentsConst().DynamicMemoryUsage() + it->GetMemPoolChildrenConst().DynamicMemoryUsage();
     mapTx.erase(it);
     nTransactionsUpdated++;
+    m_snapshot.reset();
+
+    RemovedMetric(reason).Inc();
+    g_metric_transactions.Set(mapTx.size());
+    g_metric_vsize.Set(totalTxSize);
+    g_metric_fees.Set(m_total_fee);
 }
 
 // Calculates descendants of entry that are not already in setDescendants, and adds to
@@ -670,15 +728,20 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     Assume(!m_have_changeset);
     std::vector<RemovedMempoolTransactionInfo> txs_removed_for_block;
     txs_removed_for_block.reserve(vtx.size());
+    // Remove all confirmed transactions at once, so the descendants they
+    // leave behind are only updated once.
+    setEntries stage;
     for (const auto& tx : vtx)
     {
         txiter it = mapTx.find(tx->GetHash());
         if (it != mapTx.end()) {
-            setEntries stage;
             stage.insert(it);
             txs_removed_for_block.emplace_back(*it);
-            RemoveStaged(stage, true, MemPoolRemovalReason::BLOCK);
         }
+    }
+    RemoveStaged(stage, true, MemPoolRemovalReason::BLOCK);
+    for (const auto& tx : vtx)
+    {
         removeConflicts(*tx);
         ClearPrioritisation(tx->GetHash());
     }
@@ -702,6 +765,7 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
     uint64_t checkTotal = 0;
     CAmount check_total_fee{0};
     uint64_t innerUsage = 0;
+    uint64_t tx_usage{0};
     uint64_t prev_ancestor_count{0};
 
     CCoinsViewCache mempoolDuplicate(const_cast<CCoinsViewCache*>(&active_coins_tip));
@@ -710,9 +774,10 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
         checkTotal += it->GetTxSize();
         check_total_fee += it->GetFee();
         innerUsage += it->DynamicMemoryUsage();
+        tx_usage += it->DynamicMemoryUsage();
         const CTransaction& tx = it->GetTx();
-        innerUsage += memusage::DynamicUsage(it->GetMemPoolParentsConst()) + memusage::DynamicUsage(it->GetMemPoolChildrenConst());
-        CTxMemPoolEntry::Parents setParentCheck;
+        innerUsage += it->GetMemPoolParentsConst().DynamicMemoryUsage() + it->GetMemPoolChildrenConst().DynamicMemoryUsage();
+        CTxMemPoolEntry::Entries setParentCheck;
         for (const CTxIn &txin : tx.vin) {
             // Check that every mempool transaction's inputs refer to available coins, or other mempool tx's.
             indexed_transaction_set::const_iterator it2 = mapTx.find(txin.prevout.hash);
@@ -758,10 +823,11 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
         prev_ancestor_count = it->GetCountWithAncestors();
 
         // Check children against mapNextTx
-        CTxMemPoolEntry::Children setChildrenCheck;
-        auto iter = mapNextTx.lower_bound(COutPoint(it->GetTx().GetHash(), 0));
+        CTxMemPoolEntry::Entries setChildrenCheck;
         int32_t child_sizes{0};
-        for (; iter != mapNextTx.end() && iter->first->hash == it->GetTx().GetHash(); ++iter) {
+        for (uint32_t n{0}; n < it->GetTx().vout.size(); ++n) {
+            const auto iter = mapNextTx.find(COutPoint(it->GetTx().GetHash(), n));
+            if (iter == mapNextTx.end()) continue;
             txiter childit = mapTx.find(iter->second->GetHash());
             assert(childit != mapTx.end()); // mapNextTx points to in-mempool transactions
             if (setChildrenCheck.insert(*childit).second) {
@@ -792,6 +858,7 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
     assert(totalTxSize == checkTotal);
     assert(m_total_fee == check_total_fee);
     assert(innerUsage == cachedInnerUsage);
+    assert(tx_usage == m_total_tx_usage);
 }
 
 bool CTxMemPool::CompareDepthAndScore(const GenTxid& hasha, const GenTxid& hashb) const
@@ -856,6 +923,26 @@ std::vector<CTxMemPoolEntryRef> CTxMemPool::entryAll() const
     return ret;
 }
 
+std::vector<TxMempoolInfo> CTxMemPool::info(std::span<const GenTxid> gtxids) const
+{
+    LOCK(cs);
+    std::vector<TxMempoolInfo> ret;
+    ret.reserve(gtxids.size());
+    for (const GenTxid& gtxid : gtxids) {
+        const auto i{std::visit([&](const auto& id) EXCLUSIVE_LOCKS_REQUIRED(cs) { return GetIter(id); }, gtxid)};
+        ret.push_back(i.has_value() ? GetInfo(*i) : TxMempoolInfo{});
+    }
+    return ret;
+}
+
+TxRelayOrder CTxMemPool::GetRelayOrder(const Txid& txid) const
+{
+    LOCK(cs);
+    const auto i{GetIter(txid)};
+    if (!i.has_value()) return {};
+    return {.ancestors = (*i)->GetCountWithAncestors(), .feerate = FeeFrac{(*i)->GetFee(), (*i)->GetTxSize()}};
+}
+
 std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
 {
     LOCK(cs);
@@ -870,6 +957,96 @@ std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
     return ret;
 }
 
+MempoolEntrySnapshot CTxMemPool::CopyEntry(const CTxMemPoolEntry& entry) const
+{
+    AssertLockHeld(cs);
+    MempoolEntrySnapshot copy{
+        .tx = entry.GetSharedTx(),
+        .vsize = entry.GetTxSize(),
+        .weight = entry.GetTxWeight(),
+        .time = entry.GetTime(),
+        .height = entry.GetHeight(),
+        .fee = entry.GetFee(),
+        .modified_fee = entry.GetModifiedFee(),
+        .count_with_descendants = entry.GetCountWithDescendants(),
+        .size_with_descendants = entry.GetSizeWithDescendants(),
+        .mod_fees_with_descendants = entry.GetModFeesWithDescendants(),
+        .count_with_ancestors = entry.GetCountWithAncestors(),
+        .size_with_ancestors = entry.GetSizeWithAncestors(),
+        .mod_fees_with_ancestors = entry.GetModFeesWithAncestors(),
+        .parents = {},
+        .children = {},
+        .bip125_replaceable = false,
+        .unbroadcast = IsUnbroadcastTx(entry.GetTx().GetHash()),
+    };
+    copy.parents.reserve(entry.GetMemPoolParentsConst().size());
+    for (const CTxMemPoolEntry& parent : entry.GetMemPoolParentsConst()) copy.parents.push_back(parent.GetTx().GetHash());
+    copy.children.reserve(entry.GetMemPoolChildrenConst().size());
+    for (const CTxMemPoolEntry& child : entry.GetMemPoolChildrenConst()) copy.children.push_back(child.GetTx().GetHash());
+    return copy;
+}
+
+MempoolEntrySnapshot CTxMemPool::GetEntrySnapshot(const CTxMemPoolEntry& entry) const
+{
+    AssertLockHeld(cs);
+    MempoolEntrySnapshot copy{CopyEntry(entry)};
+    copy.bip125_replaceable = SignalsOptInRBF(entry.GetTx());
+    if (!copy.bip125_replaceable) {
+        const auto ancestors{AssumeCalculateMemPoolAncestors(__func__, entry, Limits::NoLimits(), /*fSearchForParents=*/false)};
+        copy.bip125_replaceable = std::ranges::any_of(ancestors, [](txiter it) { return SignalsOptInRBF(it->GetTx()); });
+    }
+    return copy;
+}
+
+std::shared_ptr<const MempoolSnapshot> CTxMemPool::GetSnapshot() const
+{
+    LOCK(cs);
+    if (m_snapshot) return m_snapshot;
+
+    auto snapshot{std::make_shared<MempoolSnapshot>()};
+    snapshot->sequence = GetSequence();
+    snapshot->entries.reserve(mapTx.size());
+    // Parents come first, so the replaceability of their ancestors is known,
+    // which saves walking the ancestors of every entry.
+    std::unordered_map<Txid, bool, SaltedTxidHasher> replaceable;
+    replaceable.reserve(mapTx.size());
+    for (const auto& it : GetSortedDepthAndScore()) {
+        MempoolEntrySnapshot& copy{snapshot->entries.emplace_back(CopyEntry(*it))};
+        copy.bip125_replaceable = SignalsOptInRBF(it->GetTx()) ||
+                                  std::ranges::any_of(copy.parents, [&](const Txid& parent) { return replaceable.at(parent); });
+        replaceable.emplace(it->GetTx().GetHash(), copy.bip125_replaceable);
+    }
+    m_snapshot = std::move(snapshot);
+    return m_snapshot;
+}
+
+void CTxMemPool::LogChange(uint64_t sequence, const Txid& txid, std::optional<MemPoolRemovalReason> removal_reason)
+{
+    AssertLockHeld(cs);
+    if (m_opts.log_size == 0) {
+        m_log_begin = sequence + 1;
+        return;
+    }
+    if (m_log.size() >= m_opts.log_size) {
+        m_log_begin = m_log.front().sequence + 1;
+        m_log.pop_front();
+    }
+    m_log.push_back({sequence, txid, removal_reason});
+}
+
+MempoolChanges CTxMemPool::GetChanges(uint64_t sequence) const
+{
+    LOCK(cs);
+    MempoolChanges result{.sequence = GetSequence()};
+    if (sequence < m_log_begin || sequence > result.sequence) {
+        result.truncated = true;
+        return result;
+    }
+    const auto begin{std::ranges::lower_bound(m_log, sequence, {}, &MempoolChange::sequence)};
+    result.changes.assign(begin, m_log.end());
+    return result;
+}
+
 const CTxMemPoolEntry* CTxMemPool::GetEntry(const Txid& txid) const
 {
     AssertLockHeld(cs);
@@ -908,6 +1085,7 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
                 mapTx.modify(descendantIt, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(0, nFeeDelta, 0, 0); });
             }
             ++nTransactionsUpdated;
+            m_snapshot.reset();
         }
         if (delta == 0) {
             mapDeltas.erase(hash);
@@ -960,6 +1138,15 @@ const CTransaction* CTxMemPool::GetConflictTx(const COutPoint& prevout) const
     return it == mapNextTx.end() ? nullptr : it->second;
 }
 
+std::vector<const CTransaction*> CTxMemPool::GetConflictTxs(std::span<const COutPoint> prevouts) const
+{
+    AssertLockHeld(cs);
+    std::vector<const CTransaction*> result;
+    result.reserve(prevouts.size());
+    for (const COutPoint& prevout : prevouts) result.push_back(GetConflictTx(prevout));
+    return result;
+}
+
 std::optional<CTxMemPool::txiter> CTxMemPool::GetIter(const Txid& txid) const
 {
     auto it = mapTx.find(txid.ToUint256());
@@ -1030,6 +1217,26 @@ std::optional<Coin> CCoinsViewMemPool::GetCoin(const COutPoint& outpoint) const
     return base->GetCoin(outpoint);
 }
 
+std::vector<std::optional<Coin>> CCoinsViewMemPool::GetCoins(std::span<const COutPoint> outpoints) const
+{
+    std::vector<std::optional<Coin>> coins(outpoints.size());
+    std::vector<size_t> from_base;
+    std::vector<COutPoint> lookups;
+    for (size_t i{0}; i < outpoints.size(); ++i) {
+        const COutPoint& outpoint{outpoints[i]};
+        if (m_temp_added.contains(outpoint) || mempool.exists(outpoint.hash)) {
+            coins[i] = GetCoin(outpoint);
+        } else {
+            from_base.push_back(i);
+            lookups.push_back(outpoint);
+        }
+    }
+    if (lookups.empty()) return coins;
+    auto found{base->GetCoins(lookups)};
+    for (size_t j{0}; j < from_base.size(); ++j) coins[from_base[j]] = std::move(found[j]);
+    return coins;
+}
+
 void CCoinsViewMemPool::PackageAddTransaction(const CTransactionRef& tx)
 {
     for (unsigned int n = 0; n < tx->vout.size(); ++n) {
@@ -1044,9 +1251,19 @@ void CCoinsViewMemPool::Reset()
 }
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
+    return GetMemoryUsage().Total();
+}
+
+MempoolMemoryUsage CTxMemPool::GetMemoryUsage() const
+{
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 15 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + cachedInnerUsage;
+    return {
+        .transactions = m_total_tx_usage,
+        // Estimate the overhead of mapTx to be 15 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
+        .entries = memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * mapTx.size(),
+        .links = cachedInnerUsage - m_total_tx_usage,
+        .indexes = memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized),
+    };
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked) {
@@ -1054,6 +1271,7 @@ void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked)
 
     if (m_unbroadcast_txids.erase(txid))
     {
+        m_snapshot.reset();
         LogDebug(BCLog::MEMPOOL, "Removed %i from set of unbroadcast txns%s\n", txid.GetHex(), (unchecked ? " before confirmation that txn was sent out" : ""));
     }
 }
@@ -1087,23 +1305,27 @@ int CTxMemPool::Expire(std::chrono::seconds time)
 void CTxMemPool::UpdateChild(txiter entry, txiter child, bool add)
 {
     AssertLockHeld(cs);
-    CTxMemPoolEntry::Children s;
-    if (add && entry->GetMemPoolChildren().insert(*child).second) {
-        cachedInnerUsage += memusage::IncrementalDynamicUsage(s);
-    } else if (!add && entry->GetMemPoolChildren().erase(*child)) {
-        cachedInnerUsage -= memusage::IncrementalDynamicUsage(s);
+    CTxMemPoolEntry::Children& children{entry->GetMemPoolChildren()};
+    cachedInnerUsage -= children.DynamicMemoryUsage();
+    if (add) {
+        children.insert(*child);
+    } else {
+        children.erase(*child);
     }
+    cachedInnerUsage += children.DynamicMemoryUsage();
 }
 
 void CTxMemPool::UpdateParent(txiter entry, txiter parent, bool add)
 {
     AssertLockHeld(cs);
-    CTxMemPoolEntry::Parents s;
-    if (add && entry->GetMemPoolParents().insert(*parent).second) {
-        cachedInnerUsage += memusage::IncrementalDynamicUsage(s);
-    } else if (!add && entry->GetMemPoolParents().erase(*parent)) {
-        cachedInnerUsage -= memusage::IncrementalDynamicUsage(s);
+    CTxMemPoolEntry::Parents& parents{entry->GetMemPoolParents()};
+    cachedInnerUsage -= parents.DynamicMemoryUsage();
+    if (add) {
+        parents.insert(*parent);
+    } else {
+        parents.erase(*parent);
     }
+    cachedInnerUsage += parents.DynamicMemoryUsage();
 }
 
 CFeeRate CTxMemPool::GetMinFee(size_t sizelimit) const {
@@ -1142,22 +1364,48 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
     AssertLockHeld(cs);
     Assume(!m_have_changeset);
 
+    [[maybe_unused]] const auto time_start{SteadyClock::now()};
+    [[maybe_unused]] const size_t usage_before{DynamicMemoryUsage()};
     unsigned nTxnRemoved = 0;
     CFeeRate maxFeeRateRemoved(0);
     while (!mapTx.empty() && DynamicMemoryUsage() > sizelimit) {
-        indexed_transaction_set::index<descendant_score>::type::iterator it = mapTx.get<descendant_score>().begin();
+        const auto& by_score{mapTx.get<descendant_score>()};
+        setEntries stage;
+        CFeeRate removed;
+        if (m_opts.batch_trim) {
+            // Stage packages from the lowest descendant score up until their
+            // memory covers the excess. Scores are not updated for the packages
+            // staged before, so this may evict a package the one at a time
+            // eviction would have kept, but it only walks the index once. If
+            // the estimate falls short, the next round stages some more.
+            const size_t excess{DynamicMemoryUsage() - sizelimit};
+            size_t freed{0};
+            for (auto it{by_score.begin()}; it != by_score.end() && freed < excess; ++it) {
+                const txiter entry{mapTx.project<0>(it)};
+                if (stage.contains(entry)) continue;
+                removed = std::max(removed, CFeeRate(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants()));
+                setEntries package;
+                CalculateDescendants(entry, package);
+                for (txiter staged : package) {
+                    if (!stage.insert(staged).second) continue;
+                    // As accounted for in GetMemoryUsage(), without the indexes.
+                    freed += memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) + staged->DynamicMemoryUsage() +
+                             staged->GetMemPoolParentsConst().DynamicMemoryUsage() + staged->GetMemPoolChildrenConst().DynamicMemoryUsage();
+                }
+            }
+        } else {
+            const auto it{by_score.begin()};
+            removed = CFeeRate(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants());
+            CalculateDescendants(mapTx.project<0>(it), stage);
+        }
 
         // We set the new mempool min fee to the feerate of the removed set, plus the
         // "minimum reasonable fee rate" (ie some value under which we consider txn
         // to have 0 fee). This way, we don't allow txn to enter mempool with feerate
         // equal to txn which were removed with no block in between.
-        CFeeRate removed(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants());
         removed += m_opts.incremental_relay_feerate;
         trackPackageRemoved(removed);
         maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
-
-        setEntries stage;
-        CalculateDescendants(mapTx.project<0>(it), stage);
         nTxnRemoved += stage.size();
 
         std::vector<CTransaction> txn;
@@ -1180,6 +1428,15 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
     if (maxFeeRateRemoved > CFeeRate(0)) {
         LogDebug(BCLog::MEMPOOL, "Removed %u txn, rolling minimum fee bumped to %s\n", nTxnRemoved, maxFeeRateRemoved.ToString());
     }
+    if (nTxnRemoved > 0) {
+        TRACEPOINT(mempool, trimmed,
+            (uint32_t)nTxnRemoved,
+            (uint64_t)usage_before,
+            (uint64_t)DynamicMemoryUsage(),
+            (uint64_t)sizelimit,
+            maxFeeRateRemoved.GetFeePerK(),
+            int64_t{Ticks<std::chrono::nanoseconds>(SteadyClock::now() - time_start)});
+    }
 }
 
 uint64_t CTxMemPool::CalculateDescendantMaximum(txiter entry) const {
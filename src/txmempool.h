@@ -33,9 +33,14 @@
 #include <boost/multi_index_container.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -136,6 +141,23 @@ public:
     }
 };
 
+/**
+ * Position of a transaction in the order it is announced to peers in: fewer
+ * in-mempool ancestors first, so that parents are announced before their
+ * children, then higher feerate first, as CompareTxMemPoolEntryByScore.
+ * Transactions not in the mempool come last.
+ */
+struct TxRelayOrder {
+    uint64_t ancestors{std::numeric_limits<uint64_t>::max()};
+    FeeFrac feerate;
+
+    bool operator<(const TxRelayOrder& other) const
+    {
+        if (ancestors != other.ancestors) return ancestors < other.ancestors;
+        return FeeRateCompare(feerate, other.feerate) > 0;
+    }
+};
+
 class CompareTxMemPoolEntryByEntryTime
 {
 public:
@@ -204,6 +226,78 @@ struct TxMempoolInfo
     int64_t nFeeDelta;
 };
 
+/**
+ * Copy of a mempool entry and its in-mempool relatives, so that it can be
+ * reported without holding CTxMemPool::cs.
+ */
+struct MempoolEntrySnapshot
+{
+    CTransactionRef tx;
+    int32_t vsize;
+    int32_t weight;
+    std::chrono::seconds time;
+    unsigned int height;
+    CAmount fee;
+    CAmount modified_fee;
+    uint64_t count_with_descendants;
+    int64_t size_with_descendants;
+    CAmount mod_fees_with_descendants;
+    uint64_t count_with_ancestors;
+    int64_t size_with_ancestors;
+    CAmount mod_fees_with_ancestors;
+    std::vector<Txid> parents;
+    std::vector<Txid> children;
+    //! Whether the transaction or one of its in-mempool ancestors signals BIP125 replaceability.
+    bool bip125_replaceable;
+    bool unbroadcast;
+};
+
+/** Immutable copy of all mempool entries, see CTxMemPool::GetSnapshot(). */
+struct MempoolSnapshot
+{
+    //! CTxMemPool::GetSequence() when it was taken.
+    uint64_t sequence;
+    //! In the order of CTxMemPool::entryAll(), so parents precede their children.
+    std::vector<MempoolEntrySnapshot> entries;
+};
+
+/** Addition or removal of a mempool transaction, see CTxMemPool::GetChanges(). */
+struct MempoolChange
+{
+    //! The mempool sequence the change was given, see CTxMemPool::GetSequence().
+    uint64_t sequence;
+    Txid txid;
+    //! Why the transaction was removed, or std::nullopt if it was added.
+    std::optional<MemPoolRemovalReason> removal_reason;
+};
+
+/** Result of CTxMemPool::GetChanges() */
+struct MempoolChanges
+{
+    //! CTxMemPool::GetSequence() when they were taken.
+    uint64_t sequence;
+    //! Whether some of the requested changes are no longer logged, in which
+    //! case no change is returned.
+    bool truncated{false};
+    //! In the order they were made.
+    std::vector<MempoolChange> changes;
+};
+
+/** Breakdown of CTxMemPool::DynamicMemoryUsage(), see CTxMemPool::GetMemoryUsage(). */
+struct MempoolMemoryUsage
+{
+    //! The transactions themselves.
+    size_t transactions{0};
+    //! The entries, including an estimate of the overhead of mapTx.
+    size_t entries{0};
+    //! Links between entries and their in-mempool parents and children.
+    size_t links{0};
+    //! mapNextTx, mapDeltas and txns_randomized.
+    size_t indexes{0};
+
+    size_t Total() const { return transactions + entries + links + indexes; }
+};
+
 /**
  * CTxMemPool stores valid-according-to-the-current-best-chain transactions
  * that may be included in the next block.
@@ -285,6 +379,7 @@ protected:
     uint64_t totalTxSize GUARDED_BY(cs){0};      //!< sum of all mempool tx's virtual sizes. Differs from serialized tx size since witness data is discounted. Defined in BIP 141.
     CAmount m_total_fee GUARDED_BY(cs){0};       //!< sum of all mempool tx's fees (NOT modified fee)
     uint64_t cachedInnerUsage GUARDED_BY(cs){0}; //!< sum of dynamic memory usage of all the map elements (NOT the maps themselves)
+    uint64_t m_total_tx_usage GUARDED_BY(cs){0}; //!< part of cachedInnerUsage taken by the transactions
 
     mutable int64_t lastRollingFeeUpdate GUARDED_BY(cs){GetTime()};
     mutable bool blockSinceLastRollingFeeBump GUARDED_BY(cs){false};
@@ -389,6 +484,19 @@ private:
      */
     std::set<uint256> m_unbroadcast_txids GUARDED_BY(cs);
 
+    //! Shared by GetSnapshot() callers until the mempool changes.
+    mutable std::shared_ptr<const MempoolSnapshot> m_snapshot GUARDED_BY(cs);
+
+    //! Copy an entry, except for its BIP125 replaceability.
+    MempoolEntrySnapshot CopyEntry(const CTxMemPoolEntry& entry) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    //! The last changes of the mempool, oldest first, at most m_opts.log_size of them.
+    std::deque<MempoolChange> m_log GUARDED_BY(cs);
+    //! The first sequence from which all changes are in m_log.
+    uint64_t m_log_begin GUARDED_BY(cs){1};
+
+    void LogChange(uint64_t sequence, const Txid& txid, std::optional<MemPoolRemovalReason> removal_reason) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
 
     /**
      * Helper function to calculate all in-mempool ancestors of staged_ancestors and apply ancestor
@@ -403,7 +511,7 @@ private:
      */
     util::Result<setEntries> CalculateAncestorsAndCheckLimits(int64_t entry_size,
                                                               size_t entry_count,
-                                                              CTxMemPoolEntry::Parents &staged_ancestors,
+                                                              CTxMemPoolEntry::Entries &staged_ancestors,
                                                               const Limits& limits
                                                               ) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -413,7 +521,7 @@ private:
     }
 
 public:
-    indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
+    unordered_indirectmap<COutPoint, const CTransaction*, SaltedOutpointHasher> mapNextTx GUARDED_BY(cs);
     std::map<uint256, CAmount> mapDeltas GUARDED_BY(cs);
 
     using Options = kernel::MemPoolOptions;
@@ -478,6 +586,8 @@ public:
 
     /** Get the transaction in the pool that spends the same prevout */
     const CTransaction* GetConflictTx(const COutPoint& prevout) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+    /** GetConflictTx() for each of the prevouts, in the same order */
+    std::vector<const CTransaction*> GetConflictTxs(std::span<const COutPoint> prevouts) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     /** Returns an iterator to the given hash, if found */
     std::optional<txiter> GetIter(const Txid& txid) const EXCLUSIVE_LOCKS_REQUIRED(cs);
@@ -660,10 +770,28 @@ public:
         return (i.has_value() && i.value()->GetSequence() < last_sequence) ? GetInfo(*i) : TxMempoolInfo{};
     }
 
+    /** Info for each of the given transactions, empty for those not in the mempool, under a single lock. */
+    std::vector<TxMempoolInfo> info(std::span<const GenTxid> gtxids) const;
+
+    /** Where a transaction comes in the order transactions are announced to peers in. */
+    TxRelayOrder GetRelayOrder(const Txid& txid) const;
+
     std::vector<CTxMemPoolEntryRef> entryAll() const EXCLUSIVE_LOCKS_REQUIRED(cs);
     std::vector<TxMempoolInfo> infoAll() const;
 
+    /** Copy an entry, e.g. to report it after releasing cs. */
+    MempoolEntrySnapshot GetEntrySnapshot(const CTxMemPoolEntry& entry) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    /**
+     * Return an immutable copy of all entries. It is taken once and shared
+     * until the mempool changes, so readers reporting the whole mempool hold
+     * cs for at most one copy, and not while serializing it.
+     */
+    std::shared_ptr<const MempoolSnapshot> GetSnapshot() const;
+
     size_t DynamicMemoryUsage() const;
+    //! Split DynamicMemoryUsage() into the transactions and the bookkeeping around them.
+    MempoolMemoryUsage GetMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
     void AddUnbroadcastTx(const uint256& txid)
@@ -671,7 +799,7 @@ public:
         LOCK(cs);
         // Sanity check the transaction is in the mempool & insert into
         // unbroadcast set.
-        if (exists(Txid::FromUint256(txid))) m_unbroadcast_txids.insert(txid);
+        if (exists(Txid::FromUint256(txid)) && m_unbroadcast_txids.insert(txid).second) m_snapshot.reset();
     };
 
     /** Removes a transaction from the unbroadcast set */
@@ -693,6 +821,7 @@ public:
 
     /** Guards this internal counter for external reporting */
     uint64_t GetAndIncrementSequence() const EXCLUSIVE_LOCKS_REQUIRED(cs) {
+        m_snapshot.reset();
         return m_sequence_number++;
     }
 
@@ -700,6 +829,23 @@ public:
         return m_sequence_number;
     }
 
+    /** Give the next sequence to the addition of a transaction, which was just added, and log it. */
+    uint64_t LogAddition(const Txid& txid) EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        const uint64_t sequence{GetAndIncrementSequence()};
+        LogChange(sequence, txid, /*removal_reason=*/std::nullopt);
+        return sequence;
+    }
+
+    /**
+     * Return the additions and removals of transactions from `sequence` on,
+     * e.g. since GetSequence() returned `sequence`, from the log of the last
+     * m_opts.log_size changes. If some of them are no longer logged, or
+     * `sequence` is ahead of the mempool, the result is marked as truncated,
+     * and the whole mempool needs to be fetched again instead.
+     */
+    MempoolChanges GetChanges(uint64_t sequence) const;
+
     /* Check that all direct conflicts are in a cluster size of two or less. Each
      * direct conflict may be in a separate cluster.
      */
@@ -936,6 +1082,8 @@ public:
     /** GetCoin, returning whether it exists and is not spent. Also updates m_non_base_coins if the
      * coin is not fetched from base. */
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    /** GetCoin for many outpoints, looking up those not created by mempool transactions in one batch. */
+    std::vector<std::optional<Coin>> GetCoins(std::span<const COutPoint> outpoints) const override;
     /** Add the coins created by this transaction. These coins are only temporarily stored in
      * m_temp_added and cannot be flushed to the back end. Only used for package validation. */
     void PackageAddTransaction(const CTransactionRef& tx);
@@ -5,12 +5,15 @@
 #include <txorphanage.h>
 
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <logging.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <util/time.h>
 
 #include <cassert>
+#include <utility>
 
 bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
 {
@@ -40,12 +43,15 @@ bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
     assert(ret.second);
     m_orphan_list.push_back(ret.first);
     for (const CTxIn& txin : tx->vin) {
-        m_outpoint_to_orphan_it[txin.prevout].insert(ret.first);
+        auto& orphans{m_outpoint_to_orphan_it[txin.prevout]};
+        // Spending the same outpoint twice is invalid, but is only checked later.
+        if (orphans.empty() || orphans.back() != ret.first) orphans.push_back(ret.first);
     }
     m_total_orphan_usage += sz;
     m_total_announcements += 1;
     auto& peer_info = m_peer_orphanage_info.try_emplace(peer).first->second;
     peer_info.m_total_usage += sz;
+    peer_info.m_announced.insert(wtxid);
 
     LogDebug(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u outsz %u)\n", hash.ToString(), wtxid.ToString(), sz,
              m_orphans.size(), m_outpoint_to_orphan_it.size());
@@ -61,6 +67,7 @@ bool TxOrphanage::AddAnnouncer(const Wtxid& wtxid, NodeId peer)
         if (ret.second) {
             auto& peer_info = m_peer_orphanage_info.try_emplace(peer).first->second;
             peer_info.m_total_usage += it->second.GetUsage();
+            peer_info.m_announced.insert(wtxid);
             m_total_announcements += 1;
             LogDebug(BCLog::TXPACKAGES, "added peer=%d as announcer of orphan tx %s\n", peer, wtxid.ToString());
             return true;
@@ -79,7 +86,7 @@ int TxOrphanage::EraseTx(const Wtxid& wtxid)
         auto itPrev = m_outpoint_to_orphan_it.find(txin.prevout);
         if (itPrev == m_outpoint_to_orphan_it.end())
             continue;
-        itPrev->second.erase(it);
+        std::erase(itPrev->second, it);
         if (itPrev->second.empty())
             m_outpoint_to_orphan_it.erase(itPrev);
     }
@@ -92,6 +99,7 @@ int TxOrphanage::EraseTx(const Wtxid& wtxid)
         auto peer_it = m_peer_orphanage_info.find(peer);
         if (Assume(peer_it != m_peer_orphanage_info.end())) {
             peer_it->second.m_total_usage -= tx_size;
+            peer_it->second.m_announced.erase(it->first);
         }
     }
 
@@ -117,23 +125,23 @@ int TxOrphanage::EraseTx(const Wtxid& wtxid)
 
 void TxOrphanage::EraseForPeer(NodeId peer)
 {
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it == m_peer_orphanage_info.end()) return;
+    const std::set<Wtxid> announced{std::move(peer_it->second.m_announced)};
     // Zeroes out this peer's m_total_usage.
-    m_peer_orphanage_info.erase(peer);
+    m_peer_orphanage_info.erase(peer_it);
 
     int nErased = 0;
-    std::map<Wtxid, OrphanTx>::iterator iter = m_orphans.begin();
-    while (iter != m_orphans.end())
-    {
-        // increment to avoid iterator becoming invalid after erasure
-        auto& [wtxid, orphan] = *iter++;
-        auto orphan_it = orphan.announcers.find(peer);
-        if (orphan_it != orphan.announcers.end()) {
-            orphan.announcers.erase(peer);
+    for (const Wtxid& wtxid : announced) {
+        const auto it = m_orphans.find(wtxid);
+        if (!Assume(it != m_orphans.end())) continue;
+        auto& orphan = it->second;
+        if (orphan.announcers.erase(peer)) {
             m_total_announcements -= 1;
 
             // No remaining announcers: clean up entry
             if (orphan.announcers.empty()) {
-                nErased += EraseTx(orphan.tx->GetWitnessHash());
+                nErased += EraseTx(wtxid);
             }
         }
     }
@@ -322,6 +330,22 @@ std::vector<TxOrphanage::OrphanTxBase> TxOrphanage::GetOrphanTransactions() cons
     return ret;
 }
 
+size_t TxOrphanage::DynamicMemoryUsage() const
+{
+    size_t usage{memusage::DynamicUsage(m_orphans) + memusage::DynamicUsage(m_peer_orphanage_info) +
+                 memusage::DynamicUsage(m_outpoint_to_orphan_it) + memusage::DynamicUsage(m_orphan_list)};
+    for (const auto& [wtxid, orphan] : m_orphans) {
+        usage += RecursiveDynamicUsage(orphan.tx) + memusage::DynamicUsage(orphan.announcers);
+    }
+    for (const auto& [peer, info] : m_peer_orphanage_info) {
+        usage += memusage::DynamicUsage(info.m_work_set) + memusage::DynamicUsage(info.m_announced);
+    }
+    for (const auto& [outpoint, orphans] : m_outpoint_to_orphan_it) {
+        usage += memusage::DynamicUsage(orphans);
+    }
+    return usage;
+}
+
 void TxOrphanage::SanityCheck() const
 {
     // Check that cached m_total_announcements is correct
@@ -340,6 +364,8 @@ void TxOrphanage::SanityCheck() const
         for (const auto& peer : orphan.announcers) {
             auto& count_peer_entry = counted_size_per_peer.try_emplace(peer).first->second;
             count_peer_entry += orphan.GetUsage();
+            const auto peer_it = m_peer_orphanage_info.find(peer);
+            Assume(peer_it != m_peer_orphanage_info.end() && peer_it->second.m_announced.contains(wtxid));
         }
     }
 
@@ -356,6 +382,7 @@ void TxOrphanage::SanityCheck() const
         auto it_counted = counted_size_per_peer.find(peerid);
         if (it_counted == counted_size_per_peer.end()) {
             Assume(info.m_total_usage == 0);
+            Assume(info.m_announced.empty());
         } else {
             Assume(it_counted->second == info.m_total_usage);
         }
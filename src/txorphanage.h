@@ -10,10 +10,13 @@
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <sync.h>
+#include <util/hasher.h>
 #include <util/time.h>
 
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 /** Expiration time for orphan transactions */
 static constexpr auto ORPHAN_TX_EXPIRE_TIME{20min};
@@ -97,6 +100,9 @@ public:
      * only counted once within this total. */
     unsigned int TotalOrphanUsage() const { return m_total_orphan_usage; }
 
+    /** Estimate of the memory used by the orphanage, including the transactions. */
+    size_t DynamicMemoryUsage() const;
+
     /** Total usage (weight) of orphans for which this peer is an announcer. If an orphan has multiple
      * announcers, its weight will be accounted for in each PeerOrphanInfo, so the total of all
      * peers' UsageByPeer() may be larger than TotalOrphanBytes(). */
@@ -132,6 +138,10 @@ protected:
          * GetTxToReconsider. */
         std::set<Wtxid> m_work_set;
 
+        /** Orphans for which this peer is an announcer, so that they are found without going through
+         * all orphans when the peer disconnects. */
+        std::set<Wtxid> m_announced;
+
         /** Total weight of orphans for which this peer is an announcer.
          * If orphans are provided by different peers, its weight will be accounted for in each
          * PeerOrphanInfo, so the total of all peers' m_total_usage may be larger than
@@ -143,18 +153,11 @@ protected:
 
     using OrphanMap = decltype(m_orphans);
 
-    struct IteratorComparator
-    {
-        template<typename I>
-        bool operator()(const I& a, const I& b) const
-        {
-            return a->first < b->first;
-        }
-    };
-
     /** Index from the parents' COutPoint into the m_orphans. Used
-     *  to remove orphan transactions from the m_orphans */
-    std::map<COutPoint, std::set<OrphanMap::iterator, IteratorComparator>> m_outpoint_to_orphan_it;
+     *  to remove orphan transactions from the m_orphans and to find the
+     *  children of a transaction. Few orphans spend the same outpoint, so
+     *  they are kept in a vector, in the order they were added. */
+    std::unordered_map<COutPoint, std::vector<OrphanMap::iterator>, SaltedOutpointHasher> m_outpoint_to_orphan_it;
 
     /** Orphan transactions in vector for quick random eviction */
     std::vector<OrphanMap::iterator> m_orphan_list;
@@ -9,17 +9,17 @@
 #include <primitives/transaction.h>
 #include <random.h>
 #include <uint256.h>
+#include <util/hasher.h>
 
-#include <boost/multi_index/indexed_by.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/tuple/tuple.hpp>
-
+#include <algorithm>
 #include <chrono>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <cassert>
 
@@ -28,7 +28,7 @@ namespace {
 /** The various states a (txhash,peer) pair can be in.
  *
  * Note that CANDIDATE is split up into 3 substates (DELAYED, BEST, READY), allowing more efficient implementation.
- * Also note that the sorting order of ByTxHashView relies on the specific order of values in this enum.
+ * Also note that GetCandidatePeers reports announcements in the order of the values in this enum.
  *
  * Expected behaviour is:
  *   - When first announced by a peer, the state is CANDIDATE_DELAYED until reqtime is reached.
@@ -57,22 +57,42 @@ enum class State : uint8_t {
 //! Type alias for sequence numbers.
 using SequenceNumber = uint64_t;
 
+//! Type alias for priorities.
+using Priority = uint64_t;
+
+/** A functor with embedded salt that computes priority of an announcement.
+ *
+ * Higher priorities are selected first.
+ */
+class PriorityComputer {
+    const uint64_t m_k0, m_k1;
+public:
+    explicit PriorityComputer(bool deterministic) :
+        m_k0{deterministic ? 0 : FastRandomContext().rand64()},
+        m_k1{deterministic ? 0 : FastRandomContext().rand64()} {}
+
+    Priority operator()(const uint256& txhash, NodeId peer, bool preferred) const
+    {
+        uint64_t low_bits = CSipHasher(m_k0, m_k1).Write(txhash).Write(peer).Finalize() >> 1;
+        return low_bits | uint64_t{preferred} << 63;
+    }
+};
+
 /** An announcement. This is the data we track for each txid or wtxid that is announced to us by each peer. */
 struct Announcement {
     /** Txid or wtxid that was announced. */
-    const GenTxid m_gtxid;
+    GenTxid m_gtxid;
     /** For CANDIDATE_{DELAYED,BEST,READY} the reqtime; for REQUESTED the expiry. */
     std::chrono::microseconds m_time;
     /** What peer the request was from. */
-    const NodeId m_peer;
-    /** What sequence number this announcement has. */
-    const SequenceNumber m_sequence : 59;
-    /** Whether the request is preferred. */
-    const bool m_preferred : 1;
+    NodeId m_peer;
+    /** The priority of this announcement, as computed by the tracker's PriorityComputer. */
+    Priority m_priority;
+    /** What sequence number this announcement has. Unique among all announcements ever created by a tracker. */
+    SequenceNumber m_sequence : 59;
     /** What state this announcement is in. */
     State m_state : 3 {State::CANDIDATE_DELAYED};
     State GetState() const { return m_state; }
-    void SetState(State state) { m_state = state; }
 
     /** Whether this announcement is selected. There can be at most 1 selected peer per txhash. */
     bool IsSelected() const
@@ -93,138 +113,41 @@ struct Announcement {
     }
 
     /** Construct a new announcement from scratch, initially in CANDIDATE_DELAYED state. */
-    Announcement(const GenTxid& gtxid, NodeId peer, bool preferred, std::chrono::microseconds reqtime,
+    Announcement(const GenTxid& gtxid, NodeId peer, Priority priority, std::chrono::microseconds reqtime,
                  SequenceNumber sequence)
-        : m_gtxid(gtxid), m_time(reqtime), m_peer(peer), m_sequence(sequence), m_preferred(preferred) {}
-};
-
-//! Type alias for priorities.
-using Priority = uint64_t;
-
-/** A functor with embedded salt that computes priority of an announcement.
- *
- * Higher priorities are selected first.
- */
-class PriorityComputer {
-    const uint64_t m_k0, m_k1;
-public:
-    explicit PriorityComputer(bool deterministic) :
-        m_k0{deterministic ? 0 : FastRandomContext().rand64()},
-        m_k1{deterministic ? 0 : FastRandomContext().rand64()} {}
-
-    Priority operator()(const uint256& txhash, NodeId peer, bool preferred) const
-    {
-        uint64_t low_bits = CSipHasher(m_k0, m_k1).Write(txhash).Write(peer).Finalize() >> 1;
-        return low_bits | uint64_t{preferred} << 63;
-    }
-
-    Priority operator()(const Announcement& ann) const
-    {
-        return operator()(ann.m_gtxid.ToUint256(), ann.m_peer, ann.m_preferred);
-    }
+        : m_gtxid(gtxid), m_time(reqtime), m_peer(peer), m_priority(priority), m_sequence(sequence) {}
 };
 
-// Definitions for the 3 indexes used in the main data structure.
+// The main data structure is a hash map from txhash to the (few) announcements for that txhash, so that all
+// per-txhash decisions (which announcement is CANDIDATE_BEST, whether only COMPLETED ones are left) are made by
+// scanning a short vector. It is complemented by:
+// * Per peer, the (txhash, sequence) pairs of its announcements and of its CANDIDATE_BEST announcements, for
+//   DisconnectedPeer and GetRequestable.
+// * A min-heap of the times of all CANDIDATE_DELAYED and REQUESTED announcements, for SetTimePoint.
 //
-// Each index has a By* type to identify it, a By*View data type to represent the view of announcement it is sorted
-// by, and an By*ViewExtractor type to convert an announcement into the By*View type.
-// See https://www.boost.org/doc/libs/1_58_0/libs/multi_index/doc/reference/key_extraction.html#key_extractors
-// for more information about the key extraction concept.
+// The per-peer lists and the heap are updated lazily: entries are only added, and checked against the map (by
+// sequence number and state) when they are used. They are compacted once most of their entries are stale.
 
-// The ByPeer index is sorted by (peer, state == CANDIDATE_BEST, txhash)
-//
-// Uses:
-// * Looking up existing announcements by peer/txhash, by checking both (peer, false, txhash) and
-//   (peer, true, txhash).
-// * Finding all CANDIDATE_BEST announcements for a given peer in GetRequestable.
-struct ByPeer {};
-using ByPeerView = std::tuple<NodeId, bool, const uint256&>;
-struct ByPeerViewExtractor
-{
-    using result_type = ByPeerView;
-    result_type operator()(const Announcement& ann) const
-    {
-        return ByPeerView{ann.m_peer, ann.GetState() == State::CANDIDATE_BEST, ann.m_gtxid.ToUint256()};
-    }
+/** A reference to an announcement by txhash, peer and sequence number, which may be stale. */
+struct AnnouncementRef {
+    uint256 m_txhash;
+    SequenceNumber m_sequence;
 };
 
-// The ByTxHash index is sorted by (txhash, state, priority).
-//
-// Note: priority == 0 whenever state != CANDIDATE_READY.
-//
-// Uses:
-// * Deleting all announcements with a given txhash in ForgetTxHash.
-// * Finding the best CANDIDATE_READY to convert to CANDIDATE_BEST, when no other CANDIDATE_READY or REQUESTED
-//   announcement exists for that txhash.
-// * Determining when no more non-COMPLETED announcements for a given txhash exist, so the COMPLETED ones can be
-//   deleted.
-struct ByTxHash {};
-using ByTxHashView = std::tuple<const uint256&, State, Priority>;
-class ByTxHashViewExtractor {
-    const PriorityComputer& m_computer;
-public:
-    explicit ByTxHashViewExtractor(const PriorityComputer& computer) : m_computer(computer) {}
-    using result_type = ByTxHashView;
-    result_type operator()(const Announcement& ann) const
-    {
-        const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? m_computer(ann) : 0;
-        return ByTxHashView{ann.m_gtxid.ToUint256(), ann.GetState(), prio};
-    }
-};
-
-enum class WaitState {
-    //! Used for announcements that need efficient testing of "is their timestamp in the future?".
-    FUTURE_EVENT,
-    //! Used for announcements whose timestamp is not relevant.
-    NO_EVENT,
-    //! Used for announcements that need efficient testing of "is their timestamp in the past?".
-    PAST_EVENT,
-};
-
-WaitState GetWaitState(const Announcement& ann)
-{
-    if (ann.IsWaiting()) return WaitState::FUTURE_EVENT;
-    if (ann.IsSelectable()) return WaitState::PAST_EVENT;
-    return WaitState::NO_EVENT;
-}
+/** An entry in the heap of CANDIDATE_DELAYED and REQUESTED announcements, which may be stale. */
+struct TimeEvent {
+    std::chrono::microseconds m_time;
+    SequenceNumber m_sequence;
+    NodeId m_peer;
+    uint256 m_txhash;
 
-// The ByTime index is sorted by (wait_state, time).
-//
-// All announcements with a timestamp in the future can be found by iterating the index forward from the beginning.
-// All announcements with a timestamp in the past can be found by iterating the index backwards from the end.
-//
-// Uses:
-// * Finding CANDIDATE_DELAYED announcements whose reqtime has passed, and REQUESTED announcements whose expiry has
-//   passed.
-// * Finding CANDIDATE_READY/BEST announcements whose reqtime is in the future (when the clock time went backwards).
-struct ByTime {};
-using ByTimeView = std::pair<WaitState, std::chrono::microseconds>;
-struct ByTimeViewExtractor
-{
-    using result_type = ByTimeView;
-    result_type operator()(const Announcement& ann) const
+    //! Heap order: the earliest event (with the lowest sequence number among equal times) comes first.
+    friend bool operator<(const TimeEvent& a, const TimeEvent& b)
     {
-        return ByTimeView{GetWaitState(ann), ann.m_time};
+        return std::tie(a.m_time, a.m_sequence) > std::tie(b.m_time, b.m_sequence);
     }
 };
 
-struct Announcement_Indices final : boost::multi_index::indexed_by<
-    boost::multi_index::ordered_unique<boost::multi_index::tag<ByPeer>, ByPeerViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTxHash>, ByTxHashViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTime>, ByTimeViewExtractor>
->
-{};
-
-/** Data type for the main data structure (Announcement objects with ByPeer/ByTxHash/ByTime indexes). */
-using Index = boost::multi_index_container<
-    Announcement,
-    Announcement_Indices
->;
-
-/** Helper type to simplify syntax of iterator types. */
-template<typename Tag>
-using Iter = typename Index::index<Tag>::type::iterator;
-
 /** Per-peer statistics object. */
 struct PeerInfo {
     size_t m_total = 0; //!< Total number of announcements for this peer.
@@ -232,6 +155,15 @@ struct PeerInfo {
     size_t m_requested = 0; //!< Number of REQUESTED announcements for this peer.
 };
 
+/** Per-peer data: statistics, plus lazily updated lists of its announcements. */
+struct PeerData {
+    PeerInfo m_info;
+    //! All announcements of this peer, and possibly stale entries.
+    std::vector<AnnouncementRef> m_announcements;
+    //! All CANDIDATE_BEST announcements of this peer, and possibly stale or duplicate entries.
+    std::vector<AnnouncementRef> m_best;
+};
+
 /** Per-txhash statistics object. Only used for sanity checking. */
 struct TxHashInfo
 {
@@ -258,15 +190,20 @@ bool operator==(const PeerInfo& a, const PeerInfo& b)
            std::tie(b.m_total, b.m_completed, b.m_requested);
 };
 
+/** Data type for the main data structure (announcements by txhash). */
+using Index = std::unordered_map<uint256, std::vector<Announcement>, SaltedTxidHasher>;
+
 /** (Re)compute the PeerInfo map from the index. Only used for sanity checking. */
 std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
 {
     std::unordered_map<NodeId, PeerInfo> ret;
-    for (const Announcement& ann : index) {
-        PeerInfo& info = ret[ann.m_peer];
-        ++info.m_total;
-        info.m_requested += (ann.GetState() == State::REQUESTED);
-        info.m_completed += (ann.GetState() == State::COMPLETED);
+    for (const auto& [_, anns] : index) {
+        for (const Announcement& ann : anns) {
+            PeerInfo& info = ret[ann.m_peer];
+            ++info.m_total;
+            info.m_requested += (ann.GetState() == State::REQUESTED);
+            info.m_completed += (ann.GetState() == State::COMPLETED);
+        }
     }
     return ret;
 }
@@ -275,22 +212,27 @@ std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
 std::map<uint256, TxHashInfo> ComputeTxHashInfo(const Index& index, const PriorityComputer& computer)
 {
     std::map<uint256, TxHashInfo> ret;
-    for (const Announcement& ann : index) {
-        TxHashInfo& info = ret[ann.m_gtxid.ToUint256()];
-        // Classify how many announcements of each state we have for this txhash.
-        info.m_candidate_delayed += (ann.GetState() == State::CANDIDATE_DELAYED);
-        info.m_candidate_ready += (ann.GetState() == State::CANDIDATE_READY);
-        info.m_candidate_best += (ann.GetState() == State::CANDIDATE_BEST);
-        info.m_requested += (ann.GetState() == State::REQUESTED);
-        // And track the priority of the best CANDIDATE_READY/CANDIDATE_BEST announcements.
-        if (ann.GetState() == State::CANDIDATE_BEST) {
-            info.m_priority_candidate_best = computer(ann);
-        }
-        if (ann.GetState() == State::CANDIDATE_READY) {
-            info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready, computer(ann));
+    for (const auto& [txhash, anns] : index) {
+        TxHashInfo& info = ret[txhash];
+        for (const Announcement& ann : anns) {
+            // The cached priority and the key must match the announcement.
+            assert(ann.m_gtxid.ToUint256() == txhash);
+            assert(ann.m_priority == computer(txhash, ann.m_peer, ann.m_priority >> 63));
+            // Classify how many announcements of each state we have for this txhash.
+            info.m_candidate_delayed += (ann.GetState() == State::CANDIDATE_DELAYED);
+            info.m_candidate_ready += (ann.GetState() == State::CANDIDATE_READY);
+            info.m_candidate_best += (ann.GetState() == State::CANDIDATE_BEST);
+            info.m_requested += (ann.GetState() == State::REQUESTED);
+            // And track the priority of the best CANDIDATE_READY/CANDIDATE_BEST announcements.
+            if (ann.GetState() == State::CANDIDATE_BEST) {
+                info.m_priority_candidate_best = ann.m_priority;
+            }
+            if (ann.GetState() == State::CANDIDATE_READY) {
+                info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready, ann.m_priority);
+            }
+            // Also keep track of which peers this txhash has an announcement for (so we can detect duplicates).
+            info.m_peers.push_back(ann.m_peer);
         }
-        // Also keep track of which peers this txhash has an announcement for (so we can detect duplicates).
-        info.m_peers.push_back(ann.m_peer);
     }
     return ret;
 }
@@ -309,15 +251,49 @@ class TxRequestTracker::Impl {
     //! This tracker's main data structure. See SanityCheck() for the invariants that apply to it.
     Index m_index;
 
-    //! Map with this tracker's per-peer statistics.
-    std::unordered_map<NodeId, PeerInfo> m_peerinfo;
+    //! The number of announcements in m_index.
+    size_t m_size{0};
+
+    //! Map with this tracker's per-peer statistics and announcement lists.
+    std::unordered_map<NodeId, PeerData> m_peerdata;
+
+    //! Heap of the times of CANDIDATE_DELAYED and REQUESTED announcements, including stale entries.
+    std::vector<TimeEvent> m_events;
+
+    //! An upper bound for the reqtime of all CANDIDATE_READY and CANDIDATE_BEST announcements. Only when the
+    //! clock goes back before it, some of them may have to be made CANDIDATE_DELAYED again.
+    std::chrono::microseconds m_max_selectable_time{std::chrono::microseconds::min()};
 
 public:
     void SanityCheck() const
     {
-        // Recompute m_peerdata from m_index. This verifies the data in it as it should just be caching statistics
-        // on m_index. It also verifies the invariant that no PeerInfo announcements with m_total==0 exist.
-        assert(m_peerinfo == RecomputePeerInfo(m_index));
+        // Recompute m_peerdata's statistics from m_index. This verifies the data in it as it should just be
+        // caching statistics on m_index. It also verifies the invariant that no PeerData entries with m_total==0
+        // exist.
+        std::unordered_map<NodeId, PeerInfo> peerinfo;
+        for (const auto& [peer, data] : m_peerdata) peerinfo.emplace(peer, data.m_info);
+        assert(peerinfo == RecomputePeerInfo(m_index));
+
+        // The lazily updated structures must cover every announcement they are responsible for.
+        std::set<std::pair<NodeId, SequenceNumber>> listed, listed_best;
+        for (const auto& [peer, data] : m_peerdata) {
+            for (const auto& ref : data.m_announcements) listed.emplace(peer, ref.m_sequence);
+            for (const auto& ref : data.m_best) listed_best.emplace(peer, ref.m_sequence);
+        }
+        std::set<std::tuple<NodeId, SequenceNumber, std::chrono::microseconds>> events;
+        for (const auto& event : m_events) events.emplace(event.m_peer, event.m_sequence, event.m_time);
+        size_t size{0};
+        for (const auto& [_, anns] : m_index) {
+            assert(!anns.empty());
+            for (const Announcement& ann : anns) {
+                ++size;
+                assert(listed.count({ann.m_peer, ann.m_sequence}));
+                if (ann.GetState() == State::CANDIDATE_BEST) assert(listed_best.count({ann.m_peer, ann.m_sequence}));
+                if (ann.IsWaiting()) assert(events.count({ann.m_peer, ann.m_sequence, ann.m_time}));
+                if (ann.IsSelectable()) assert(ann.m_time <= m_max_selectable_time);
+            }
+        }
+        assert(size == m_size);
 
         // Calculate per-txhash statistics from m_index, and validate invariants.
         for (auto& item : ComputeTxHashInfo(m_index, m_computer)) {
@@ -349,130 +325,192 @@ public:
 
     void PostGetRequestableSanityCheck(std::chrono::microseconds now) const
     {
-        for (const Announcement& ann : m_index) {
-            if (ann.IsWaiting()) {
-                // REQUESTED and CANDIDATE_DELAYED must have a time in the future (they should have been converted
-                // to COMPLETED/CANDIDATE_READY respectively).
-                assert(ann.m_time > now);
-            } else if (ann.IsSelectable()) {
-                // CANDIDATE_READY and CANDIDATE_BEST cannot have a time in the future (they should have remained
-                // CANDIDATE_DELAYED, or should have been converted back to it if time went backwards).
-                assert(ann.m_time <= now);
+        for (const auto& [_, anns] : m_index) {
+            for (const Announcement& ann : anns) {
+                if (ann.IsWaiting()) {
+                    // REQUESTED and CANDIDATE_DELAYED must have a time in the future (they should have been
+                    // converted to COMPLETED/CANDIDATE_READY respectively).
+                    assert(ann.m_time > now);
+                } else if (ann.IsSelectable()) {
+                    // CANDIDATE_READY and CANDIDATE_BEST cannot have a time in the future (they should have
+                    // remained CANDIDATE_DELAYED, or should have been converted back to it if time went backwards).
+                    assert(ann.m_time <= now);
+                }
             }
         }
     }
 
 private:
-    //! Wrapper around Index::...::erase that keeps m_peerinfo up to date.
-    template<typename Tag>
-    Iter<Tag> Erase(Iter<Tag> it)
+    //! Find the announcement of peer in anns, or nullptr.
+    static Announcement* Find(std::vector<Announcement>& anns, NodeId peer)
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        if (--peerit->second.m_total == 0) m_peerinfo.erase(peerit);
-        return m_index.get<Tag>().erase(it);
+        auto it = std::find_if(anns.begin(), anns.end(), [peer](const Announcement& ann) { return ann.m_peer == peer; });
+        return it == anns.end() ? nullptr : &*it;
     }
 
-    //! Wrapper around Index::...::modify that keeps m_peerinfo up to date.
-    template<typename Tag, typename Modifier>
-    void Modify(Iter<Tag> it, Modifier modifier)
+    //! Find the announcement a (possibly stale) reference points to, or nullptr.
+    Announcement* Find(const uint256& txhash, NodeId peer, SequenceNumber sequence)
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        m_index.get<Tag>().modify(it, std::move(modifier));
-        peerit->second.m_completed += it->GetState() == State::COMPLETED;
-        peerit->second.m_requested += it->GetState() == State::REQUESTED;
+        auto it = m_index.find(txhash);
+        if (it == m_index.end()) return nullptr;
+        Announcement* ann = Find(it->second, peer);
+        return ann && ann->m_sequence == sequence ? ann : nullptr;
+    }
+
+    //! Add a time event for a CANDIDATE_DELAYED or REQUESTED announcement.
+    void PushEvent(const Announcement& ann)
+    {
+        m_events.push_back(TimeEvent{ann.m_time, ann.m_sequence, ann.m_peer, ann.m_gtxid.ToUint256()});
+        std::push_heap(m_events.begin(), m_events.end());
+        if (m_events.size() > 2 * m_size + 64) {
+            // Most entries are stale. Rebuild the heap from the announcements that are waiting.
+            m_events.clear();
+            for (const auto& [_, anns] : m_index) {
+                for (const Announcement& a : anns) {
+                    if (a.IsWaiting()) m_events.push_back(TimeEvent{a.m_time, a.m_sequence, a.m_peer, a.m_gtxid.ToUint256()});
+                }
+            }
+            std::make_heap(m_events.begin(), m_events.end());
+        }
+    }
+
+    //! Remove the stale entries of a per-peer list (and duplicates, which sort next to each other by sequence).
+    template<typename Pred>
+    void CompactRefs(NodeId peer, std::vector<AnnouncementRef>& refs, Pred keep)
+    {
+        std::sort(refs.begin(), refs.end(), [](const auto& a, const auto& b) { return a.m_sequence < b.m_sequence; });
+        refs.erase(std::unique(refs.begin(), refs.end(), [](const auto& a, const auto& b) { return a.m_sequence == b.m_sequence; }), refs.end());
+        refs.erase(std::remove_if(refs.begin(), refs.end(), [&](const AnnouncementRef& ref) {
+            const Announcement* ann = Find(ref.m_txhash, peer, ref.m_sequence);
+            return !ann || !keep(*ann);
+        }), refs.end());
+    }
+
+    //! Change the state (and time) of an announcement, keeping m_peerdata, m_events and
+    //! m_max_selectable_time up to date.
+    void Modify(Announcement& ann, State state, std::chrono::microseconds time)
+    {
+        PeerData& data = m_peerdata.find(ann.m_peer)->second;
+        data.m_info.m_completed -= ann.GetState() == State::COMPLETED;
+        data.m_info.m_requested -= ann.GetState() == State::REQUESTED;
+        const bool was_waiting{ann.IsWaiting()};
+        const bool was_best{ann.GetState() == State::CANDIDATE_BEST};
+        const bool time_changed{ann.m_time != time};
+        ann.m_state = state;
+        ann.m_time = time;
+        data.m_info.m_completed += ann.GetState() == State::COMPLETED;
+        data.m_info.m_requested += ann.GetState() == State::REQUESTED;
+
+        if (ann.IsWaiting() && (!was_waiting || time_changed)) PushEvent(ann);
+        if (ann.IsSelectable()) m_max_selectable_time = std::max(m_max_selectable_time, ann.m_time);
+        if (ann.GetState() == State::CANDIDATE_BEST && !was_best) {
+            data.m_best.push_back(AnnouncementRef{ann.m_gtxid.ToUint256(), ann.m_sequence});
+            if (data.m_best.size() > 2 * data.m_info.m_total + 16) {
+                CompactRefs(ann.m_peer, data.m_best, [](const Announcement& a) { return a.GetState() == State::CANDIDATE_BEST; });
+            }
+        }
+    }
+
+    void SetState(Announcement& ann, State state) { Modify(ann, state, ann.m_time); }
+
+    //! Update m_peerdata for an announcement about to be deleted.
+    void ForgetPeerAnnouncement(const Announcement& ann)
+    {
+        auto peerit = m_peerdata.find(ann.m_peer);
+        peerit->second.m_info.m_completed -= ann.GetState() == State::COMPLETED;
+        peerit->second.m_info.m_requested -= ann.GetState() == State::REQUESTED;
+        if (--peerit->second.m_info.m_total == 0) m_peerdata.erase(peerit);
+        --m_size;
+    }
+
+    //! Delete one announcement. This invalidates it and, if it was the last one for its txhash, the index iterator.
+    void Erase(Index::iterator it, Announcement& ann)
+    {
+        ForgetPeerAnnouncement(ann);
+        std::vector<Announcement>& anns = it->second;
+        if (&ann != &anns.back()) ann = anns.back();
+        anns.pop_back();
+        if (anns.empty()) m_index.erase(it);
+    }
+
+    //! Delete all announcements for a txhash.
+    void EraseTxHash(Index::iterator it)
+    {
+        for (const Announcement& ann : it->second) ForgetPeerAnnouncement(ann);
+        m_index.erase(it);
+    }
+
+    //! The selected (CANDIDATE_BEST or REQUESTED) announcement among anns, or nullptr.
+    static Announcement* FindSelected(std::vector<Announcement>& anns)
+    {
+        auto it = std::find_if(anns.begin(), anns.end(), [](const Announcement& ann) { return ann.IsSelected(); });
+        return it == anns.end() ? nullptr : &*it;
     }
 
     //! Convert a CANDIDATE_DELAYED announcement into a CANDIDATE_READY. If this makes it the new best
     //! CANDIDATE_READY (and no REQUESTED exists) and better than the CANDIDATE_BEST (if any), it becomes the new
     //! CANDIDATE_BEST.
-    void PromoteCandidateReady(Iter<ByTxHash> it)
+    void PromoteCandidateReady(std::vector<Announcement>& anns, Announcement& ann)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() == State::CANDIDATE_DELAYED);
+        assert(ann.GetState() == State::CANDIDATE_DELAYED);
         // Convert CANDIDATE_DELAYED to CANDIDATE_READY first.
-        Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-        // The following code relies on the fact that the ByTxHash is sorted by txhash, and then by state (first
-        // _DELAYED, then _READY, then _BEST/REQUESTED). Within the _READY announcements, the best one (highest
-        // priority) comes last. Thus, if an existing _BEST exists for the same txhash that this announcement may
-        // be preferred over, it must immediately follow the newly created _READY.
-        auto it_next = std::next(it);
-        if (it_next == m_index.get<ByTxHash>().end() || it_next->m_gtxid.ToUint256() != it->m_gtxid.ToUint256() ||
-            it_next->GetState() == State::COMPLETED) {
+        SetState(ann, State::CANDIDATE_READY);
+        Announcement* selected = FindSelected(anns);
+        if (!selected) {
             // This is the new best CANDIDATE_READY, and there is no IsSelected() announcement for this txhash
             // already.
-            Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-        } else if (it_next->GetState() == State::CANDIDATE_BEST) {
-            Priority priority_old = m_computer(*it_next);
-            Priority priority_new = m_computer(*it);
-            if (priority_new > priority_old) {
-                // There is a CANDIDATE_BEST announcement already, but this one is better.
-                Modify<ByTxHash>(it_next, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-                Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-            }
+            SetState(ann, State::CANDIDATE_BEST);
+        } else if (selected->GetState() == State::CANDIDATE_BEST && ann.m_priority > selected->m_priority) {
+            // There is a CANDIDATE_BEST announcement already, but this one is better.
+            SetState(*selected, State::CANDIDATE_READY);
+            SetState(ann, State::CANDIDATE_BEST);
         }
     }
 
     //! Change the state of an announcement to something non-IsSelected(). If it was IsSelected(), the next best
     //! announcement will be marked CANDIDATE_BEST.
-    void ChangeAndReselect(Iter<ByTxHash> it, State new_state)
+    void ChangeAndReselect(std::vector<Announcement>& anns, Announcement& ann, State new_state)
     {
         assert(new_state == State::COMPLETED || new_state == State::CANDIDATE_DELAYED);
-        assert(it != m_index.get<ByTxHash>().end());
-        if (it->IsSelected() && it != m_index.get<ByTxHash>().begin()) {
-            auto it_prev = std::prev(it);
-            // The next best CANDIDATE_READY, if any, immediately precedes the REQUESTED or CANDIDATE_BEST
-            // announcement in the ByTxHash index.
-            if (it_prev->m_gtxid.ToUint256() == it->m_gtxid.ToUint256() && it_prev->GetState() == State::CANDIDATE_READY) {
-                // If one such CANDIDATE_READY exists (for this txhash), convert it to CANDIDATE_BEST.
-                Modify<ByTxHash>(it_prev, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
+        if (ann.IsSelected()) {
+            // If any CANDIDATE_READY exists (for this txhash), convert the best one to CANDIDATE_BEST.
+            Announcement* best_ready{nullptr};
+            for (Announcement& other : anns) {
+                if (other.GetState() == State::CANDIDATE_READY && (!best_ready || other.m_priority > best_ready->m_priority)) {
+                    best_ready = &other;
+                }
             }
+            if (best_ready) SetState(*best_ready, State::CANDIDATE_BEST);
         }
-        Modify<ByTxHash>(it, [new_state](Announcement& ann){ ann.SetState(new_state); });
+        SetState(ann, new_state);
     }
 
-    //! Check if 'it' is the only announcement for a given txhash that isn't COMPLETED.
-    bool IsOnlyNonCompleted(Iter<ByTxHash> it)
+    //! Check if 'ann' is the only announcement for a given txhash that isn't COMPLETED.
+    static bool IsOnlyNonCompleted(const std::vector<Announcement>& anns, const Announcement& ann)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() != State::COMPLETED); // Not allowed to call this on COMPLETED announcements.
-
-        // This announcement has a predecessor that belongs to the same txhash. Due to ordering, and the
-        // fact that 'it' is not COMPLETED, its predecessor cannot be COMPLETED here.
-        if (it != m_index.get<ByTxHash>().begin() && std::prev(it)->m_gtxid.ToUint256() == it->m_gtxid.ToUint256()) return false;
-
-        // This announcement has a successor that belongs to the same txhash, and is not COMPLETED.
-        if (std::next(it) != m_index.get<ByTxHash>().end() && std::next(it)->m_gtxid.ToUint256() == it->m_gtxid.ToUint256() &&
-            std::next(it)->GetState() != State::COMPLETED) return false;
-
-        return true;
+        assert(ann.GetState() != State::COMPLETED); // Not allowed to call this on COMPLETED announcements.
+        return std::all_of(anns.begin(), anns.end(), [&](const Announcement& other) {
+            return &other == &ann || other.GetState() == State::COMPLETED;
+        });
     }
 
     /** Convert any announcement to a COMPLETED one. If there are no non-COMPLETED announcements left for this
      *  txhash, they are deleted. If this was a REQUESTED announcement, and there are other CANDIDATEs left, the
      *  best one is made CANDIDATE_BEST. Returns whether the announcement still exists. */
-    bool MakeCompleted(Iter<ByTxHash> it)
+    bool MakeCompleted(Index::iterator it, Announcement& ann)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-
         // Nothing to be done if it's already COMPLETED.
-        if (it->GetState() == State::COMPLETED) return true;
+        if (ann.GetState() == State::COMPLETED) return true;
 
-        if (IsOnlyNonCompleted(it)) {
+        if (IsOnlyNonCompleted(it->second, ann)) {
             // This is the last non-COMPLETED announcement for this txhash. Delete all.
-            uint256 txhash = it->m_gtxid.ToUint256();
-            do {
-                it = Erase<ByTxHash>(it);
-            } while (it != m_index.get<ByTxHash>().end() && it->m_gtxid.ToUint256() == txhash);
+            EraseTxHash(it);
             return false;
         }
 
         // Mark the announcement COMPLETED, and select the next best announcement (the first CANDIDATE_READY) if
         // needed.
-        ChangeAndReselect(it, State::COMPLETED);
+        ChangeAndReselect(it->second, ann, State::COMPLETED);
 
         return true;
     }
@@ -487,109 +525,111 @@ private:
 
         // Iterate over all CANDIDATE_DELAYED and REQUESTED from old to new, as long as they're in the past,
         // and convert them to CANDIDATE_READY and COMPLETED respectively.
-        while (!m_index.empty()) {
-            auto it = m_index.get<ByTime>().begin();
-            if (it->GetState() == State::CANDIDATE_DELAYED && it->m_time <= now) {
-                PromoteCandidateReady(m_index.project<ByTxHash>(it));
-            } else if (it->GetState() == State::REQUESTED && it->m_time <= now) {
-                if (expired) expired->emplace_back(it->m_peer, it->m_gtxid);
-                MakeCompleted(m_index.project<ByTxHash>(it));
-            } else {
-                break;
+        while (!m_events.empty() && m_events.front().m_time <= now) {
+            const TimeEvent event = m_events.front();
+            std::pop_heap(m_events.begin(), m_events.end());
+            m_events.pop_back();
+            auto it = m_index.find(event.m_txhash);
+            if (it == m_index.end()) continue;
+            Announcement* ann = Find(it->second, event.m_peer);
+            if (!ann || ann->m_sequence != event.m_sequence || ann->m_time != event.m_time) continue;
+            if (ann->GetState() == State::CANDIDATE_DELAYED) {
+                PromoteCandidateReady(it->second, *ann);
+            } else if (ann->GetState() == State::REQUESTED) {
+                if (expired) expired->emplace_back(ann->m_peer, ann->m_gtxid);
+                MakeCompleted(it, *ann);
             }
         }
 
-        while (!m_index.empty()) {
+        if (now < m_max_selectable_time) {
             // If time went backwards, we may need to demote CANDIDATE_BEST and CANDIDATE_READY announcements back
             // to CANDIDATE_DELAYED. This is an unusual edge case, and unlikely to matter in production. However,
-            // it makes it much easier to specify and test TxRequestTracker::Impl's behaviour.
-            auto it = std::prev(m_index.get<ByTime>().end());
-            if (it->IsSelectable() && it->m_time > now) {
-                ChangeAndReselect(m_index.project<ByTxHash>(it), State::CANDIDATE_DELAYED);
-            } else {
-                break;
+            // it makes it much easier to specify and test TxRequestTracker::Impl's behaviour. A full scan is fine
+            // for it; no announcements are deleted by it.
+            m_max_selectable_time = std::chrono::microseconds::min();
+            for (auto& [_, anns] : m_index) {
+                for (Announcement& ann : anns) {
+                    if (ann.IsSelectable() && ann.m_time > now) ChangeAndReselect(anns, ann, State::CANDIDATE_DELAYED);
+                }
+                for (const Announcement& ann : anns) {
+                    if (ann.IsSelectable()) m_max_selectable_time = std::max(m_max_selectable_time, ann.m_time);
+                }
             }
         }
     }
 
 public:
     explicit Impl(bool deterministic) :
-        m_computer(deterministic),
-        // Explicitly initialize m_index as we need to pass a reference to m_computer to ByTxHashViewExtractor.
-        m_index(boost::make_tuple(
-            boost::make_tuple(ByPeerViewExtractor(), std::less<ByPeerView>()),
-            boost::make_tuple(ByTxHashViewExtractor(m_computer), std::less<ByTxHashView>()),
-            boost::make_tuple(ByTimeViewExtractor(), std::less<ByTimeView>())
-        )) {}
-
-    // Disable copying and assigning (a default copy won't work due the stateful ByTxHashViewExtractor).
+        m_computer(deterministic) {}
+
+    // Disable copying and assigning.
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
     void DisconnectedPeer(NodeId peer)
     {
-        auto& index = m_index.get<ByPeer>();
-        auto it = index.lower_bound(ByPeerView{peer, false, uint256::ZERO});
-        while (it != index.end() && it->m_peer == peer) {
-            // Check what to continue with after this iteration. 'it' will be deleted in what follows, so we need to
-            // decide what to continue with afterwards. There are a number of cases to consider:
-            // - std::next(it) is end() or belongs to a different peer. In that case, this is the last iteration
-            //   of the loop (denote this by setting it_next to end()).
-            // - 'it' is not the only non-COMPLETED announcement for its txhash. This means it will be deleted, but
-            //   no other Announcement objects will be modified. Continue with std::next(it) if it belongs to the
-            //   same peer, but decide this ahead of time (as 'it' may change position in what follows).
-            // - 'it' is the only non-COMPLETED announcement for its txhash. This means it will be deleted along
-            //   with all other announcements for the same txhash - which may include std::next(it). However, other
-            //   than 'it', no announcements for the same peer can be affected (due to (peer, txhash) uniqueness).
-            //   In other words, the situation where std::next(it) is deleted can only occur if std::next(it)
-            //   belongs to a different peer but the same txhash as 'it'. This is covered by the first bulletpoint
-            //   already, and we'll have set it_next to end().
-            auto it_next = (std::next(it) == index.end() || std::next(it)->m_peer != peer) ? index.end() :
-                std::next(it);
+        auto peerit = m_peerdata.find(peer);
+        if (peerit == m_peerdata.end()) return;
+        // Deleting the peer's last announcement deletes its PeerData, so take the list out first.
+        const std::vector<AnnouncementRef> refs = std::move(peerit->second.m_announcements);
+        for (const AnnouncementRef& ref : refs) {
+            auto it = m_index.find(ref.m_txhash);
+            if (it == m_index.end()) continue;
+            Announcement* ann = Find(it->second, peer);
+            if (!ann || ann->m_sequence != ref.m_sequence) continue;
             // If the announcement isn't already COMPLETED, first make it COMPLETED (which will mark other
             // CANDIDATEs as CANDIDATE_BEST, or delete all of a txhash's announcements if no non-COMPLETED ones are
             // left).
-            if (MakeCompleted(m_index.project<ByTxHash>(it))) {
+            if (MakeCompleted(it, *ann)) {
                 // Then actually delete the announcement (unless it was already deleted by MakeCompleted).
-                Erase<ByPeer>(it);
+                Erase(it, *ann);
             }
-            it = it_next;
         }
+        assert(!m_peerdata.count(peer));
     }
 
     void ForgetTxHash(const uint256& txhash)
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_gtxid.ToUint256() == txhash) {
-            it = Erase<ByTxHash>(it);
-        }
+        auto it = m_index.find(txhash);
+        if (it != m_index.end()) EraseTxHash(it);
     }
 
     void GetCandidatePeers(const uint256& txhash, std::vector<NodeId>& result_peers) const
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_gtxid.ToUint256() == txhash && it->GetState() != State::COMPLETED) {
-            result_peers.push_back(it->m_peer);
-            ++it;
+        auto it = m_index.find(txhash);
+        if (it == m_index.end()) return;
+        // Report them ordered by state, and CANDIDATE_READY ones by priority.
+        std::vector<std::tuple<State, Priority, NodeId>> candidates;
+        for (const Announcement& ann : it->second) {
+            if (ann.GetState() == State::COMPLETED) continue;
+            const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? ann.m_priority : 0;
+            candidates.emplace_back(ann.GetState(), prio, ann.m_peer);
         }
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto& [_, _prio, peer] : candidates) result_peers.push_back(peer);
     }
 
     void ReceivedInv(NodeId peer, const GenTxid& gtxid, bool preferred,
                      std::chrono::microseconds reqtime)
     {
-        // Bail out if we already have a CANDIDATE_BEST announcement for this (txhash, peer) combination. The case
-        // where there is a non-CANDIDATE_BEST announcement already will be caught by the uniqueness property of the
-        // ByPeer index when we try to emplace the new object below.
-        if (m_index.get<ByPeer>().count(ByPeerView{peer, true, gtxid.ToUint256()})) return;
+        const uint256& txhash = gtxid.ToUint256();
+        auto& anns = m_index[txhash];
 
-        // Try creating the announcement with CANDIDATE_DELAYED state (which will fail due to the uniqueness
-        // of the ByPeer index if a non-CANDIDATE_BEST announcement already exists with the same txhash and peer).
-        // Bail out in that case.
-        auto ret = m_index.get<ByPeer>().emplace(gtxid, peer, preferred, reqtime, m_current_sequence);
-        if (!ret.second) return;
+        // Bail out if we already have an announcement for this (txhash, peer) combination, in any state.
+        if (Find(anns, peer)) return;
+
+        // Create the announcement with CANDIDATE_DELAYED state.
+        const Announcement& ann = anns.emplace_back(gtxid, peer, m_computer(txhash, peer, preferred), reqtime, m_current_sequence);
 
         // Update accounting metadata.
-        ++m_peerinfo[peer].m_total;
+        ++m_size;
+        PeerData& data = m_peerdata[peer];
+        ++data.m_info.m_total;
+        data.m_announcements.push_back(AnnouncementRef{txhash, m_current_sequence});
+        if (data.m_announcements.size() > 2 * data.m_info.m_total + 16) {
+            CompactRefs(peer, data.m_announcements, [](const Announcement&) { return true; });
+        }
+        PushEvent(ann);
         ++m_current_sequence;
     }
 
@@ -600,41 +640,35 @@ public:
         // Move time.
         SetTimePoint(now, expired);
 
-        // Find all CANDIDATE_BEST announcements for this peer.
-        std::vector<const Announcement*> selected;
-        auto it_peer = m_index.get<ByPeer>().lower_bound(ByPeerView{peer, true, uint256::ZERO});
-        while (it_peer != m_index.get<ByPeer>().end() && it_peer->m_peer == peer &&
-            it_peer->GetState() == State::CANDIDATE_BEST) {
-            selected.emplace_back(&*it_peer);
-            ++it_peer;
-        }
+        auto peerit = m_peerdata.find(peer);
+        if (peerit == m_peerdata.end()) return {};
 
-        // Sort by sequence number.
-        std::sort(selected.begin(), selected.end(), [](const Announcement* a, const Announcement* b) {
-            return a->m_sequence < b->m_sequence;
-        });
+        // Find all CANDIDATE_BEST announcements for this peer. This leaves them sorted by sequence number.
+        std::vector<AnnouncementRef>& best = peerit->second.m_best;
+        CompactRefs(peer, best, [](const Announcement& ann) { return ann.GetState() == State::CANDIDATE_BEST; });
 
         // Convert to GenTxid and return.
         std::vector<GenTxid> ret;
-        ret.reserve(selected.size());
-        std::transform(selected.begin(), selected.end(), std::back_inserter(ret), [](const Announcement* ann) {
-            return ann->m_gtxid;
-        });
+        ret.reserve(best.size());
+        for (const AnnouncementRef& ref : best) {
+            ret.push_back(Find(ref.m_txhash, peer, ref.m_sequence)->m_gtxid);
+        }
         return ret;
     }
 
     void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
     {
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
+        auto it = m_index.find(txhash);
+        if (it == m_index.end()) return;
+        Announcement* ann = Find(it->second, peer);
+        if (!ann) return;
+
+        if (ann->GetState() != State::CANDIDATE_BEST) {
             // There is no CANDIDATE_BEST announcement, look for a _READY or _DELAYED instead. If the caller only
             // ever invokes RequestedTx with the values returned by GetRequestable, and no other non-const functions
             // other than ForgetTxHash and GetRequestable in between, this branch will never execute (as txhashes
             // returned by GetRequestable always correspond to CANDIDATE_BEST announcements).
-
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-            if (it == m_index.get<ByPeer>().end() || (it->GetState() != State::CANDIDATE_DELAYED &&
-                                                      it->GetState() != State::CANDIDATE_READY)) {
+            if (ann->GetState() != State::CANDIDATE_DELAYED && ann->GetState() != State::CANDIDATE_READY) {
                 // There is no CANDIDATE announcement tracked for this peer, so we have nothing to do. Either this
                 // txhash wasn't tracked at all (and the caller should have called ReceivedInv), or it was already
                 // requested and/or completed for other reasons and this is just a superfluous RequestedTx call.
@@ -644,63 +678,56 @@ public:
             // Look for an existing CANDIDATE_BEST or REQUESTED with the same txhash. We only need to do this if the
             // found announcement had a different state than CANDIDATE_BEST. If it did, invariants guarantee that no
             // other CANDIDATE_BEST or REQUESTED can exist.
-            auto it_old = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_BEST, 0});
-            if (it_old != m_index.get<ByTxHash>().end() && it_old->m_gtxid.ToUint256() == txhash) {
-                if (it_old->GetState() == State::CANDIDATE_BEST) {
+            if (Announcement* old = FindSelected(it->second)) {
+                if (old->GetState() == State::CANDIDATE_BEST) {
                     // The data structure's invariants require that there can be at most one CANDIDATE_BEST or one
                     // REQUESTED announcement per txhash (but not both simultaneously), so we have to convert any
                     // existing CANDIDATE_BEST to another CANDIDATE_* when constructing another REQUESTED.
                     // It doesn't matter whether we pick CANDIDATE_READY or _DELAYED here, as SetTimePoint()
                     // will correct it at GetRequestable() time. If time only goes forward, it will always be
                     // _READY, so pick that to avoid extra work in SetTimePoint().
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::CANDIDATE_READY); });
-                } else if (it_old->GetState() == State::REQUESTED) {
+                    SetState(*old, State::CANDIDATE_READY);
+                } else {
                     // As we're no longer waiting for a response to the previous REQUESTED announcement, convert it
                     // to COMPLETED. This also helps guaranteeing progress.
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::COMPLETED); });
+                    SetState(*old, State::COMPLETED);
                 }
             }
         }
 
-        Modify<ByPeer>(it, [expiry](Announcement& ann) {
-            ann.SetState(State::REQUESTED);
-            ann.m_time = expiry;
-        });
+        Modify(*ann, State::REQUESTED, expiry);
     }
 
     void ReceivedResponse(NodeId peer, const uint256& txhash)
     {
-        // We need to search the ByPeer index for both (peer, false, txhash) and (peer, true, txhash).
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        }
-        if (it != m_index.get<ByPeer>().end()) MakeCompleted(m_index.project<ByTxHash>(it));
+        auto it = m_index.find(txhash);
+        if (it == m_index.end()) return;
+        if (Announcement* ann = Find(it->second, peer)) MakeCompleted(it, *ann);
     }
 
     size_t CountInFlight(NodeId peer) const
     {
-        auto it = m_peerinfo.find(peer);
-        if (it != m_peerinfo.end()) return it->second.m_requested;
+        auto it = m_peerdata.find(peer);
+        if (it != m_peerdata.end()) return it->second.m_info.m_requested;
         return 0;
     }
 
     size_t CountCandidates(NodeId peer) const
     {
-        auto it = m_peerinfo.find(peer);
-        if (it != m_peerinfo.end()) return it->second.m_total - it->second.m_requested - it->second.m_completed;
+        auto it = m_peerdata.find(peer);
+        if (it != m_peerdata.end()) return it->second.m_info.m_total - it->second.m_info.m_requested - it->second.m_info.m_completed;
         return 0;
     }
 
     size_t Count(NodeId peer) const
     {
-        auto it = m_peerinfo.find(peer);
-        if (it != m_peerinfo.end()) return it->second.m_total;
+        auto it = m_peerdata.find(peer);
+        if (it != m_peerdata.end()) return it->second.m_info.m_total;
         return 0;
     }
 
     //! Count how many announcements are being tracked in total across all peers and transactions.
-    size_t Size() const { return m_index.size(); }
+    size_t Size() const { return m_size; }
 
     uint64_t ComputePriority(const uint256& txhash, NodeId peer, bool preferred) const
     {
@@ -90,8 +90,10 @@
  * Complexity:
  * - Memory usage is proportional to the total number of tracked announcements (Size()) plus the number of
  *   peers with a nonzero number of tracked announcements.
- * - CPU usage is generally logarithmic in the total number of tracked announcements, plus the number of
- *   announcements affected by an operation (amortized O(1) per announcement).
+ * - CPU usage is generally (expected, amortized) constant in the total number of tracked announcements, plus
+ *   linear in the number of announcements for the same txhash, and logarithmic in it for the operations that
+ *   move time forward (amortized O(1) per announcement affected). Only moving time backwards requires a scan
+ *   of all announcements.
  *
  * Context:
  * - In an earlier version of the transaction request logic it was possible for a peer to prevent us from seeing a
@@ -105,6 +105,8 @@ public:
     constexpr const unsigned char* end() const { return m_data.data() + WIDTH; }
 
     static constexpr unsigned int size() { return WIDTH; }
+    //! Serialized as its bytes, see BulkSerializable.
+    static constexpr size_t SERIALIZED_BYTES{WIDTH};
 
     constexpr uint64_t GetUint64(int pos) const { return ReadLE64(m_data.data() + pos * 8); }
 
@@ -5,6 +5,7 @@
 
 #include <univalue.h>
 
+#include <charconv>
 #include <iomanip>
 #include <map>
 #include <memory>
@@ -55,22 +56,28 @@ void UniValue::setNumStr(std::string str)
     val = std::move(str);
 }
 
-void UniValue::setInt(uint64_t val_)
+template <typename Int>
+static std::string IntToStr(Int val)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    // Large enough for the digits and sign of any 64 bit integer
+    char buf[24];
+    const auto res{std::to_chars(buf, buf + sizeof(buf), val)};
+    return std::string(buf, res.ptr);
+}
 
-    return setNumStr(oss.str());
+void UniValue::setInt(uint64_t val_)
+{
+    // The formatted number is known to be valid, so skip setNumStr's check.
+    clear();
+    typ = VNUM;
+    val = IntToStr(val_);
 }
 
 void UniValue::setInt(int64_t val_)
 {
-    std::ostringstream oss;
-
-    oss << val_;
-
-    return setNumStr(oss.str());
+    clear();
+    typ = VNUM;
+    val = IntToStr(val_);
 }
 
 void UniValue::setFloat(double val_)
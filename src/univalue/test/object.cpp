@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -169,6 +170,9 @@ void univalue_set()
         BOOST_CHECK_EQUAL(j.write(), "\"ab\\u0000c\"");
     }
 
+    v.setStr("\"quoted\"\ttab\\end");
+    BOOST_CHECK_EQUAL(v.write(), "\"\\\"quoted\\\"\\ttab\\\\end\"");
+
     v.setFloat(-1.01);
     BOOST_CHECK(v.isNum());
     BOOST_CHECK_EQUAL(v.getValStr(), "-1.01");
@@ -185,6 +189,12 @@ void univalue_set()
     BOOST_CHECK(v.isNum());
     BOOST_CHECK_EQUAL(v.getValStr(), "1023");
 
+    v.setInt(std::numeric_limits<int64_t>::min());
+    BOOST_CHECK_EQUAL(v.getValStr(), "-9223372036854775808");
+
+    v.setInt(std::numeric_limits<uint64_t>::max());
+    BOOST_CHECK_EQUAL(v.getValStr(), "18446744073709551615");
+
     v.setNumStr("-688");
     BOOST_CHECK(v.isNum());
     BOOST_CHECK_EQUAL(v.getValStr(), "-688");
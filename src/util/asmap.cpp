@@ -14,6 +14,8 @@
 #include <bit>
 #include <cassert>
 #include <cstdio>
+#include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -130,6 +132,76 @@ uint32_t Interpret(const std::vector<bool> &asmap, const std::vector<bool> &ip)
     return 0; // 0 is not a valid ASN
 }
 
+std::optional<DecodedAsmap> DecodedAsmap::Decode(const std::vector<bool>& asmap)
+{
+    if (!SanityCheckASMap(asmap, 128)) return std::nullopt;
+
+    // A sane asmap ends with a RETURN and at most 7 bits of padding, and no
+    // instruction is that short, so the instructions are decoded one after
+    // the other up to the padding.
+    DecodedAsmap decoded;
+    std::vector<uint32_t> offsets;
+    const std::vector<bool>::const_iterator begin = asmap.begin(), endpos = asmap.end();
+    std::vector<bool>::const_iterator pos = begin;
+    while (endpos - pos > 7) {
+        offsets.push_back(pos - begin);
+        const Instruction opcode = DecodeType(pos, endpos);
+        Op op{.type = uint8_t(opcode), .match_len = 0, .arg = 0};
+        if (opcode == Instruction::RETURN || opcode == Instruction::DEFAULT) {
+            op.arg = DecodeASN(pos, endpos);
+        } else if (opcode == Instruction::JUMP) {
+            // The bit offset of the target, turned into the index of its op below.
+            op.arg = DecodeJump(pos, endpos);
+            op.arg += pos - begin;
+        } else if (opcode == Instruction::MATCH) {
+            op.arg = DecodeMatch(pos, endpos);
+            op.match_len = std::bit_width(op.arg) - 1;
+        }
+        decoded.m_ops.push_back(op);
+    }
+    for (Op& op : decoded.m_ops) {
+        if (op.type != uint8_t(Instruction::JUMP)) continue;
+        const auto it{std::lower_bound(offsets.begin(), offsets.end(), op.arg)};
+        if (it == offsets.end() || *it != op.arg) return std::nullopt;
+        op.arg = it - offsets.begin();
+    }
+    return decoded;
+}
+
+uint32_t DecodedAsmap::Lookup(std::span<const uint8_t, 16> ip) const
+{
+    // The bits of the IP from bit `bit` on, most significant first.
+    const auto bits_at = [&](uint32_t bit, uint32_t len) {
+        uint32_t window{uint32_t(ip[bit / 8]) << 8};
+        if (bit / 8 + 1 < ip.size()) window |= ip[bit / 8 + 1];
+        return (window >> (16 - bit % 8 - len)) & ((1U << len) - 1);
+    };
+    uint32_t bit{0};
+    uint32_t default_asn{0};
+    size_t i{0};
+    // SanityCheckASMap ensures that every path ends with a RETURN before the
+    // 128 bits of the IP are consumed.
+    while (true) {
+        const Op& op{m_ops[i]};
+        switch (Instruction(op.type)) {
+        case Instruction::RETURN:
+            return op.arg;
+        case Instruction::JUMP:
+            i = bits_at(bit++, 1) ? op.arg : i + 1;
+            break;
+        case Instruction::MATCH:
+            if (bits_at(bit, op.match_len) != (op.arg & ((1U << op.match_len) - 1))) return default_asn;
+            bit += op.match_len;
+            ++i;
+            break;
+        case Instruction::DEFAULT:
+            default_asn = op.arg;
+            ++i;
+            break;
+        }
+    }
+}
+
 bool SanityCheckASMap(const std::vector<bool>& asmap, int bits)
 {
     const std::vector<bool>::const_iterator begin = asmap.begin(), endpos = asmap.end();
@@ -8,10 +8,38 @@
 #include <util/fs.h>
 
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <vector>
 
 uint32_t Interpret(const std::vector<bool> &asmap, const std::vector<bool> &ip);
 
+/**
+ * An asmap decoded once into a flat list of instructions, with the targets of
+ * jumps resolved, so that lookups neither decode the instructions they run
+ * nor test the bits of a match one by one. Lookups return the same ASN as
+ * Interpret on the asmap.
+ */
+class DecodedAsmap
+{
+public:
+    /** Decode an asmap of 128-bit IPs, or return std::nullopt if it does not pass SanityCheckASMap. */
+    static std::optional<DecodedAsmap> Decode(const std::vector<bool>& asmap);
+
+    /** The ASN of an IPv6 address, or of an IPv4 address mapped into IPv6. */
+    uint32_t Lookup(std::span<const uint8_t, 16> ip) const;
+
+private:
+    struct Op {
+        uint8_t type;
+        //! Number of bits compared by a match.
+        uint8_t match_len;
+        //! The ASN of a return or default, the bits of a match, or the index of the op jumped to.
+        uint32_t arg;
+    };
+    std::vector<Op> m_ops;
+};
+
 bool SanityCheckASMap(const std::vector<bool>& asmap, int bits);
 
 /** Read asmap from provided binary file */
@@ -14,8 +14,16 @@
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
 {
-    // Write quotient as unary-encoded: q 1's followed by one 0.
     uint64_t q = x >> P;
+    // Write the quotient and the remainder at once when they fit in a word,
+    // which they nearly always do: q 1's, one 0, and the bottom P bits of x.
+    if (q + 1 + P <= 64) {
+        const uint64_t remainder = x & ((uint64_t{1} << P) - 1);
+        bitwriter.Write((((uint64_t{1} << q) - 1) << (P + 1)) | remainder, q + 1 + P);
+        return;
+    }
+
+    // Write quotient as unary-encoded: q 1's followed by one 0.
     while (q > 0) {
         int nbits = q <= 64 ? static_cast<int>(q) : 64;
         bitwriter.Write(~0ULL, nbits);
@@ -0,0 +1,69 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_HISTOGRAM_H
+#define BITCOIN_UTIL_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Histogram of durations with power-of-two microsecond buckets, cheap enough
+ * to update on every call of a hot path.
+ *
+ * Bucket 0 counts durations below 1μs and bucket i > 0 those in
+ * [2^(i-1), 2^i) μs. The last bucket has no upper bound.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr size_t BUCKETS{24};
+
+    void Add(std::chrono::nanoseconds duration)
+    {
+        const auto micros{std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0)};
+        ++m_buckets[std::min<size_t>(std::bit_width(uint64_t(micros)), BUCKETS - 1)];
+        ++m_count;
+        m_total += duration;
+        m_max = std::max(m_max, duration);
+    }
+
+    uint64_t Count() const { return m_count; }
+    std::chrono::nanoseconds Total() const { return m_total; }
+    std::chrono::nanoseconds Max() const { return m_max; }
+    const std::array<uint64_t, BUCKETS>& Buckets() const { return m_buckets; }
+
+    //! Exclusive upper bound of bucket `i`, or the largest duration seen for the last bucket.
+    std::chrono::nanoseconds BucketUpperBound(size_t i) const
+    {
+        if (i + 1 >= BUCKETS) return m_max;
+        return std::chrono::microseconds{uint64_t{1} << i};
+    }
+
+    //! Upper bound of the bucket holding the `q` quantile (0 < q <= 1), capped at
+    //! the largest duration seen. Zero if the histogram is empty.
+    std::chrono::nanoseconds Quantile(double q) const
+    {
+        if (m_count == 0) return {};
+        const auto rank{std::max<uint64_t>(uint64_t(q * m_count + 0.5), 1)};
+        uint64_t seen{0};
+        for (size_t i{0}; i < BUCKETS; ++i) {
+            seen += m_buckets[i];
+            if (seen >= rank) return std::min(BucketUpperBound(i), m_max);
+        }
+        return m_max;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> m_buckets{};
+    uint64_t m_count{0};
+    std::chrono::nanoseconds m_total{};
+    std::chrono::nanoseconds m_max{};
+};
+
+#endif // BITCOIN_UTIL_HISTOGRAM_H
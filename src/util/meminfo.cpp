@@ -0,0 +1,68 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/meminfo.h>
+
+#include <util/readwritefile.h>
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace util {
+namespace {
+//! Maximum size of the small /proc and cgroup files read here.
+constexpr size_t MAX_INFO_FILE_SIZE{1 << 16};
+
+//! Value of the "<key><separator> <value> ..." line of `content`, if any.
+std::optional<uint64_t> FindValue(std::string_view content, std::string_view key)
+{
+    for (const std::string& line : SplitString(content, '\n')) {
+        if (!line.starts_with(key)) continue;
+        const auto fields{SplitString(TrimStringView(std::string_view{line}.substr(key.size())), ' ')};
+        return ToIntegral<uint64_t>(fields.front());
+    }
+    return std::nullopt;
+}
+
+std::optional<uint64_t> ReadNumber(const fs::path& path)
+{
+    const auto [ok, content]{ReadBinaryFile(path, MAX_INFO_FILE_SIZE)};
+    if (!ok) return std::nullopt;
+    // memory.max reads "max" when there is no limit.
+    return ToIntegral<uint64_t>(TrimStringView(content));
+}
+} // namespace
+
+std::optional<uint64_t> GetAvailableMemory(const fs::path& proc_dir, const fs::path& cgroup_dir)
+{
+    std::optional<uint64_t> available;
+    if (const auto [ok, meminfo]{ReadBinaryFile(proc_dir / "meminfo", MAX_INFO_FILE_SIZE)}; ok) {
+        // "MemAvailable:   16326500 kB"
+        if (const auto kib{FindValue(meminfo, "MemAvailable:")}) available = *kib * 1024;
+    }
+
+    const auto [ok, cgroups]{ReadBinaryFile(proc_dir / "self" / "cgroup", MAX_INFO_FILE_SIZE)};
+    if (!ok) return available;
+    for (const std::string& line : SplitString(cgroups, '\n')) {
+        // The unified (v2) hierarchy is listed as "0::<path>".
+        if (!line.starts_with("0::")) continue;
+        const fs::path cgroup{fs::PathFromString(std::string{TrimStringView(std::string_view{line}.substr(3))})};
+        const fs::path dir{cgroup_dir / fs::path{cgroup.relative_path()}};
+        const auto max{ReadNumber(dir / "memory.max")};
+        const auto current{ReadNumber(dir / "memory.current")};
+        if (!max || !current) continue;
+        uint64_t used{*current};
+        if (const auto [have_stat, stat]{ReadBinaryFile(dir / "memory.stat", MAX_INFO_FILE_SIZE)}; have_stat) {
+            used -= std::min(used, FindValue(stat, "inactive_file ").value_or(0));
+        }
+        const uint64_t cgroup_available{*max - std::min(*max, used)};
+        available = std::min(available.value_or(cgroup_available), cgroup_available);
+    }
+    return available;
+}
+} // namespace util
@@ -0,0 +1,27 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_MEMINFO_H
+#define BITCOIN_UTIL_MEMINFO_H
+
+#include <util/fs.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace util {
+/**
+ * Estimate the memory in bytes this process can still allocate without the
+ * system or its container running out.
+ *
+ * This is the kernel's MemAvailable estimate from /proc/meminfo, lowered to
+ * the room left below the cgroup v2 memory.max limit of the process, if one
+ * is set. Reclaimable page cache charged to the cgroup (inactive_file) is
+ * counted as available. Returns std::nullopt where neither is known, e.g. on
+ * systems other than Linux.
+ */
+std::optional<uint64_t> GetAvailableMemory(const fs::path& proc_dir = "/proc", const fs::path& cgroup_dir = "/sys/fs/cgroup");
+} // namespace util
+
+#endif // BITCOIN_UTIL_MEMINFO_H
@@ -0,0 +1,165 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/metrics.h>
+
+#include <tinyformat.h>
+#include <util/overloaded.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace metrics {
+namespace {
+
+//! Escape a label value or help text. Help texts do not escape double quotes.
+std::string Escape(std::string_view str, bool quotes)
+{
+    std::string ret;
+    ret.reserve(str.size());
+    for (const char c : str) {
+        if (c == '\\') {
+            ret += "\\\\";
+        } else if (c == '\n') {
+            ret += "\\n";
+        } else if (c == '"' && quotes) {
+            ret += "\\\"";
+        } else {
+            ret += c;
+        }
+    }
+    return ret;
+}
+
+std::string FormatLabels(const Labels& labels)
+{
+    std::string ret;
+    for (const auto& [name, value] : labels) {
+        if (!ret.empty()) ret += ',';
+        ret += name + "=\"" + Escape(value, /*quotes=*/true) + '"';
+    }
+    return ret;
+}
+
+//! Sample line for the given metric name, labels and value.
+std::string Sample(std::string_view name, std::string_view labels, std::string_view value)
+{
+    if (labels.empty()) return strprintf("%s %s\n", name, value);
+    return strprintf("%s{%s} %s\n", name, labels, value);
+}
+
+std::string FormatDouble(double value) { return strprintf("%.9g", value); }
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> bounds)
+    : m_bounds{std::move(bounds)},
+      m_buckets{std::make_unique<std::atomic<uint64_t>[]>(m_bounds.size() + 1)}
+{
+}
+
+void Histogram::Observe(double value)
+{
+    // Buckets are "less than or equal" buckets, as in OpenMetrics.
+    const auto bucket{std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin()};
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    double sum{m_sum.load(std::memory_order_relaxed)};
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+std::vector<uint64_t> Histogram::BucketCounts() const
+{
+    std::vector<uint64_t> counts(m_bounds.size() + 1);
+    for (size_t i{0}; i < counts.size(); ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+template <typename T, typename... Args>
+T& Registry::Get(std::string_view name, std::string_view help, const Labels& labels, Args&&... args)
+{
+    LOCK(m_mutex);
+    auto family{m_families.find(name)};
+    if (family == m_families.end()) {
+        family = m_families.emplace(std::string{name}, Family{.help = std::string{help}, .metrics = {}}).first;
+    } else if (!family->second.metrics.empty() && !std::holds_alternative<std::unique_ptr<T>>(family->second.metrics.begin()->second)) {
+        throw std::logic_error(strprintf("Metric %s registered with different types", name));
+    }
+    auto [it, inserted]{family->second.metrics.try_emplace(FormatLabels(labels))};
+    if (inserted) it->second = std::make_unique<T>(std::forward<Args>(args)...);
+    if (!std::holds_alternative<std::unique_ptr<T>>(it->second)) {
+        throw std::logic_error(strprintf("Metric %s registered with different types", name));
+    }
+    return *std::get<std::unique_ptr<T>>(it->second);
+}
+
+Counter& Registry::GetCounter(std::string_view name, std::string_view help, const Labels& labels)
+{
+    return Get<Counter>(name, help, labels);
+}
+
+Gauge& Registry::GetGauge(std::string_view name, std::string_view help, const Labels& labels)
+{
+    return Get<Gauge>(name, help, labels);
+}
+
+Histogram& Registry::GetHistogram(std::string_view name, std::string_view help, const std::vector<double>& bounds, const Labels& labels)
+{
+    return Get<Histogram>(name, help, labels, bounds);
+}
+
+std::string Registry::Render() const
+{
+    LOCK(m_mutex);
+    std::string ret;
+    for (const auto& [name, family] : m_families) {
+        if (family.metrics.empty()) continue;
+        const char* type{std::visit(util::Overloaded{
+            [](const std::unique_ptr<Counter>&) { return "counter"; },
+            [](const std::unique_ptr<Gauge>&) { return "gauge"; },
+            [](const std::unique_ptr<Histogram>&) { return "histogram"; },
+        }, family.metrics.begin()->second)};
+        ret += strprintf("# TYPE %s %s\n", name, type);
+        ret += strprintf("# HELP %s %s\n", name, Escape(family.help, /*quotes=*/false));
+        for (const auto& [labels, metric] : family.metrics) {
+            std::visit(util::Overloaded{
+                [&](const std::unique_ptr<Counter>& counter) {
+                    ret += Sample(name + "_total", labels, util::ToString(counter->Value()));
+                },
+                [&](const std::unique_ptr<Gauge>& gauge) {
+                    ret += Sample(name, labels, util::ToString(gauge->Value()));
+                },
+                [&](const std::unique_ptr<Histogram>& histogram) {
+                    // The last bucket and the count must agree, so both are
+                    // derived from the same reads of the buckets.
+                    const auto counts{histogram->BucketCounts()};
+                    const std::string prefix{labels.empty() ? "" : labels + ","};
+                    uint64_t cumulative{0};
+                    for (size_t i{0}; i < counts.size(); ++i) {
+                        cumulative += counts[i];
+                        const std::string bound{i < histogram->Bounds().size() ? strprintf("%g", histogram->Bounds()[i]) : "+Inf"};
+                        ret += Sample(name + "_bucket", strprintf("%sle=\"%s\"", prefix, bound), util::ToString(cumulative));
+                    }
+                    ret += Sample(name + "_count", labels, util::ToString(cumulative));
+                    ret += Sample(name + "_sum", labels, FormatDouble(histogram->Sum()));
+                },
+            }, metric);
+        }
+    }
+    ret += "# EOF\n";
+    return ret;
+}
+
+Registry& GetRegistry()
+{
+    // Leaked, so that metrics can be updated while static objects are
+    // destroyed at exit.
+    static Registry* g_registry{new Registry};
+    return *g_registry;
+}
+
+} // namespace metrics
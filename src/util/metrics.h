@@ -0,0 +1,131 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_METRICS_H
+#define BITCOIN_UTIL_METRICS_H
+
+#include <sync.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * Counters, gauges and histograms describing the node, served in the
+ * OpenMetrics text format.
+ *
+ * Metrics are registered once, usually at the time a module is set up, and
+ * then updated with relaxed atomic operations only, so they can be updated on
+ * hot paths and read without taking any of the locks of the code updating
+ * them. Values of different metrics are therefore not a consistent snapshot.
+ */
+namespace metrics {
+
+/** Names and values of the labels of one metric, e.g. {{"index", "txindex"}}. */
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/** Upper bounds, in seconds, of the buckets of histograms of durations. */
+inline const std::vector<double> DURATION_BUCKETS{
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+    0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 300};
+
+/** Number that only goes up, e.g. the number of blocks connected. */
+class Counter
+{
+public:
+    void Inc(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value{0};
+};
+
+/** Number that goes up and down, e.g. the number of peers. */
+class Gauge
+{
+public:
+    void Set(int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+    void Add(int64_t n) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    int64_t Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value{0};
+};
+
+/** Distribution of observed values over buckets with fixed upper bounds. */
+class Histogram
+{
+public:
+    //! @param[in] bounds  Upper bounds of the buckets, in increasing order. A
+    //!                    last bucket without upper bound is added.
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double value);
+    //! Observe a duration, in seconds.
+    void Observe(std::chrono::nanoseconds duration) { Observe(std::chrono::duration<double>{duration}.count()); }
+
+    const std::vector<double>& Bounds() const { return m_bounds; }
+    //! Number of observations in each bucket, the last one being unbounded.
+    //! Unlike the samples served, these are not cumulative.
+    std::vector<uint64_t> BucketCounts() const;
+    uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+    double Sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+private:
+    const std::vector<double> m_bounds;
+    const std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<double> m_sum{0};
+};
+
+/**
+ * Set of metrics, grouped in families of metrics sharing a name and differing
+ * by their labels.
+ *
+ * Getting a metric registers it on first use and returns the same object for
+ * the same name and labels afterwards. Metrics are never unregistered, so the
+ * references returned stay valid for the lifetime of the registry.
+ */
+class Registry
+{
+public:
+    //! @param[in] name  Name of the family, without the "_total" suffix added to its samples.
+    Counter& GetCounter(std::string_view name, std::string_view help, const Labels& labels = {}) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    Gauge& GetGauge(std::string_view name, std::string_view help, const Labels& labels = {}) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! The bounds of a histogram are those given when it was first registered.
+    Histogram& GetHistogram(std::string_view name, std::string_view help, const std::vector<double>& bounds = DURATION_BUCKETS, const Labels& labels = {}) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! All metrics in the OpenMetrics text format, families ordered by name.
+    std::string Render() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    using Metric = std::variant<std::unique_ptr<Counter>, std::unique_ptr<Gauge>, std::unique_ptr<Histogram>>;
+
+    struct Family {
+        std::string help;
+        //! Metrics by their formatted labels, e.g. `index="txindex"`.
+        std::map<std::string, Metric> metrics;
+    };
+
+    template <typename T, typename... Args>
+    T& Get(std::string_view name, std::string_view help, const Labels& labels, Args&&... args) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    mutable Mutex m_mutex;
+    std::map<std::string, Family, std::less<>> m_families GUARDED_BY(m_mutex);
+};
+
+/** Registry of the metrics of the node. It is never destroyed. */
+Registry& GetRegistry();
+
+} // namespace metrics
+
+#endif // BITCOIN_UTIL_METRICS_H
@@ -0,0 +1,71 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/numa.h>
+
+#include <util/readwritefile.h>
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace util {
+namespace {
+//! Maximum size of the small sysfs files read here.
+constexpr size_t MAX_LIST_FILE_SIZE{1 << 16};
+//! Above any CPU or node number, to reject absurd ranges.
+constexpr int MAX_CPU_NUMBER{1 << 16};
+
+std::optional<std::vector<int>> ReadList(const fs::path& path)
+{
+    const auto [ok, content]{ReadBinaryFile(path, MAX_LIST_FILE_SIZE)};
+    if (!ok) return std::nullopt;
+    return ParseCpuList(TrimStringView(content));
+}
+} // namespace
+
+std::optional<std::vector<int>> ParseCpuList(std::string_view list)
+{
+    std::vector<int> cpus;
+    if (list.empty()) return cpus;
+    for (const std::string& range : SplitString(list, ',')) {
+        const auto bounds{SplitString(range, '-')};
+        if (bounds.size() > 2) return std::nullopt;
+        const auto first{ToIntegral<int>(bounds.front())};
+        const auto last{ToIntegral<int>(bounds.back())};
+        if (!first || !last || *first < 0 || *last < *first || *last >= MAX_CPU_NUMBER) return std::nullopt;
+        for (int cpu{*first}; cpu <= *last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::optional<std::vector<int>> GetNumaNodes(const fs::path& node_dir)
+{
+    return ReadList(node_dir / "online");
+}
+
+std::optional<std::vector<int>> GetNumaNodeCpus(int node, const fs::path& node_dir)
+{
+    return ReadList(node_dir / fs::PathFromString("node" + ToString(node)) / "cpulist");
+}
+
+bool SetThreadAffinity(std::span<const int> cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(/*pid=*/0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+} // namespace util
@@ -0,0 +1,37 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_NUMA_H
+#define BITCOIN_UTIL_NUMA_H
+
+#include <util/fs.h>
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace util {
+/** Parse a list of CPUs or NUMA nodes in the sysfs format, e.g. "0-3,8,10-11". */
+std::optional<std::vector<int>> ParseCpuList(std::string_view list);
+
+/**
+ * The online NUMA nodes of the system, from the sysfs `node_dir`. Returns
+ * std::nullopt where that is not known, e.g. on systems other than Linux.
+ */
+std::optional<std::vector<int>> GetNumaNodes(const fs::path& node_dir = "/sys/devices/system/node");
+
+/** The CPUs local to NUMA node `node`, from the sysfs `node_dir`. */
+std::optional<std::vector<int>> GetNumaNodeCpus(int node, const fs::path& node_dir = "/sys/devices/system/node");
+
+/**
+ * Restrict the calling thread to run on `cpus`. Threads it creates later
+ * inherit the restriction, and memory is by default allocated on the NUMA
+ * node of the CPU that first touches it. Returns false if it failed or is not
+ * supported on this platform.
+ */
+bool SetThreadAffinity(std::span<const int> cpus);
+} // namespace util
+
+#endif // BITCOIN_UTIL_NUMA_H
@@ -0,0 +1,90 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/shm.h>
+
+#ifndef WIN32
+
+#include <random.h>
+#include <tinyformat.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+//! mmap() rejects empty mappings, so empty segments are mapped as one byte.
+size_t MappedSize(size_t size) { return size == 0 ? 1 : size; }
+} // namespace
+
+std::optional<SharedMemory> SharedMemory::Create(std::span<const std::byte> data)
+{
+    // Short enough for the 31 character limit of some systems.
+    const std::string name{strprintf("/btc-%d-%016x", getpid(), FastRandomContext{}.rand64())};
+    const int fd{shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR)};
+    if (fd == -1) return std::nullopt;
+    void* mapped{MAP_FAILED};
+    if (ftruncate(fd, MappedSize(data.size())) == 0) {
+        mapped = mmap(nullptr, MappedSize(data.size()), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+    if (!data.empty()) std::memcpy(mapped, data.data(), data.size());
+    return SharedMemory{name, mapped, data.size(), /*owner=*/true};
+}
+
+std::optional<SharedMemory> SharedMemory::Open(const std::string& name, size_t size)
+{
+    const int fd{shm_open(name.c_str(), O_RDONLY, 0)};
+    if (fd == -1) return std::nullopt;
+    struct stat st;
+    void* mapped{MAP_FAILED};
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= MappedSize(size)) {
+        mapped = mmap(nullptr, MappedSize(size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) return std::nullopt;
+    return SharedMemory{name, mapped, size, /*owner=*/false};
+}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept
+    : m_name{std::move(other.m_name)},
+      m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_owner{std::exchange(other.m_owner, false)} {}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept
+{
+    if (this != &other) {
+        Release();
+        m_name = std::move(other.m_name);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_owner = std::exchange(other.m_owner, false);
+    }
+    return *this;
+}
+
+SharedMemory::~SharedMemory()
+{
+    Release();
+}
+
+void SharedMemory::Release()
+{
+    if (m_data) munmap(m_data, MappedSize(m_size));
+    if (m_owner) shm_unlink(m_name.c_str());
+    m_data = nullptr;
+    m_owner = false;
+}
+
+#endif // WIN32
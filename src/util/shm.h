@@ -0,0 +1,55 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_SHM_H
+#define BITCOIN_UTIL_SHM_H
+
+#ifndef WIN32
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+/**
+ * Mapping of a named POSIX shared memory segment, used to hand large payloads
+ * to another process by name instead of copying them through a socket.
+ *
+ * The creator of a segment owns its name and removes it on destruction, while
+ * existing mappings, including the ones of other processes, stay valid until
+ * they are destroyed.
+ */
+class SharedMemory
+{
+public:
+    /** Create a new segment with a unique name holding a copy of data. */
+    static std::optional<SharedMemory> Create(std::span<const std::byte> data);
+    /** Map the first size bytes of the segment read-only. */
+    static std::optional<SharedMemory> Open(const std::string& name, size_t size);
+
+    SharedMemory(SharedMemory&& other) noexcept;
+    SharedMemory& operator=(SharedMemory&& other) noexcept;
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    ~SharedMemory();
+
+    const std::string& Name() const { return m_name; }
+    std::span<const std::byte> Data() const { return {static_cast<const std::byte*>(m_data), m_size}; }
+
+private:
+    SharedMemory(std::string name, void* data, size_t size, bool owner)
+        : m_name{std::move(name)}, m_data{data}, m_size{size}, m_owner{owner} {}
+    void Release();
+
+    std::string m_name;
+    void* m_data{nullptr};
+    size_t m_size{0};
+    //! Whether the name is removed on destruction.
+    bool m_owner{false};
+};
+
+#endif // WIN32
+
+#endif // BITCOIN_UTIL_SHM_H
@@ -11,6 +11,7 @@
 #include <util/threadinterrupt.h>
 #include <util/time.h>
 
+#include <array>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -19,6 +20,14 @@
 #include <poll.h>
 #endif
 
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 static inline bool IOErrorIsPermanent(int err)
 {
     return err != WSAEAGAIN && err != WSAEINTR && err != WSAEWOULDBLOCK && err != WSAEINPROGRESS;
@@ -47,6 +56,31 @@ ssize_t Sock::Send(const void* data, size_t len, int flags) const
     return send(m_socket, static_cast<const char*>(data), len, flags);
 }
 
+ssize_t Sock::SendV(std::span<const std::span<const uint8_t>> data, int flags) const
+{
+#ifdef WIN32
+    for (const auto& segment : data) {
+        if (!segment.empty()) return Send(segment.data(), segment.size(), flags);
+    }
+    return 0;
+#else
+    // Segments beyond those that fit are simply left unsent, as with a short write.
+    std::array<iovec, 8> iov;
+    size_t count{0};
+    for (const auto& segment : data) {
+        if (segment.empty()) continue;
+        if (count == iov.size()) break;
+        iov[count].iov_base = const_cast<uint8_t*>(segment.data());
+        iov[count].iov_len = segment.size();
+        ++count;
+    }
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = count;
+    return sendmsg(m_socket, &msg, flags);
+#endif
+}
+
 ssize_t Sock::Recv(void* buf, size_t len, int flags) const
 {
     return recv(m_socket, static_cast<char*>(buf), len, flags);
@@ -419,6 +453,106 @@ bool Sock::operator==(SOCKET s) const
     return m_socket == s;
 };
 
+#ifdef USE_EPOLL
+static uint32_t ToEpollEvents(Sock::Event events)
+{
+    uint32_t epoll_events{0};
+    if (events & Sock::RECV) epoll_events |= EPOLLIN;
+    if (events & Sock::SEND) epoll_events |= EPOLLOUT;
+    return epoll_events;
+}
+
+SockPoller::SockPoller() : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (m_epoll_fd == -1) {
+        throw std::runtime_error(strprintf("Unable to create epoll instance: %s", SysErrorString(errno)));
+    }
+}
+
+SockPoller::~SockPoller()
+{
+    close(m_epoll_fd);
+}
+
+void SockPoller::Control(SOCKET fd, Sock::Event from, Sock::Event to)
+{
+    if (from == to) return;
+    // Without interest the socket is taken out of the set altogether, as
+    // epoll(7) would still report errors and hang-ups on it.
+    const int op{from == 0 ? EPOLL_CTL_ADD : to == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD};
+    epoll_event event{};
+    event.events = ToEpollEvents(to);
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll_fd, op, fd, &event) == 0) return;
+    if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+        // Still registered through a duplicate of a closed descriptor.
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0) return;
+    } else if (op != EPOLL_CTL_ADD && errno == ENOENT) {
+        // Closed, and with it gone from the set, in the meantime.
+        if (to == 0 || epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0) return;
+    }
+    LogDebug(BCLog::NET, "epoll_ctl on socket %d failed: %s\n", fd, NetworkErrorString(errno));
+}
+
+void SockPoller::SetInterest(const std::shared_ptr<const Sock>& sock, Sock::Event requested)
+{
+    requested &= Sock::RECV | Sock::SEND;
+    const SOCKET fd{sock->m_socket};
+    auto [it, inserted]{m_registered.try_emplace(fd)};
+    Registration& registration{it->second};
+    registration.generation = m_generation;
+    if (!inserted && registration.sock.lock() != sock) {
+        // The descriptor was closed and reused for a new socket, which is not
+        // registered with the kernel yet.
+        if (registration.requested) --m_interested;
+        registration.requested = 0;
+    }
+    registration.sock = sock;
+    if (registration.requested == requested) return;
+    Control(fd, registration.requested, requested);
+    if (!registration.requested) ++m_interested;
+    if (!requested) --m_interested;
+    registration.requested = requested;
+}
+
+void SockPoller::RemoveStale()
+{
+    for (auto it{m_registered.begin()}; it != m_registered.end();) {
+        if (it->second.generation == m_generation) {
+            ++it;
+            continue;
+        }
+        if (it->second.requested) {
+            if (!it->second.sock.expired()) Control(it->first, it->second.requested, 0);
+            --m_interested;
+        }
+        it = m_registered.erase(it);
+    }
+    ++m_generation;
+}
+
+bool SockPoller::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& ready)
+{
+    // Level-triggered, so sockets not reported because the array is full are
+    // reported by the next call.
+    std::array<epoll_event, 256> events;
+    const int count{epoll_wait(m_epoll_fd, events.data(), events.size(), count_milliseconds(timeout))};
+    if (count == -1) return errno == EINTR;
+    for (int i{0}; i < count; ++i) {
+        const auto it{m_registered.find(events[i].data.fd)};
+        if (it == m_registered.end() || !it->second.requested) continue;
+        auto sock{it->second.sock.lock()};
+        if (!sock) continue;
+        Sock::Events occurred{it->second.requested};
+        if (events[i].events & EPOLLIN) occurred.occurred |= Sock::RECV;
+        if (events[i].events & EPOLLOUT) occurred.occurred |= Sock::SEND;
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) occurred.occurred |= Sock::ERR;
+        ready.emplace(std::move(sock), occurred);
+    }
+    return true;
+}
+#endif // USE_EPOLL
+
 std::string NetworkErrorString(int err)
 {
 #if defined(WIN32)
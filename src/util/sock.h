@@ -10,7 +10,10 @@
 #include <util/time.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 
@@ -64,6 +67,13 @@ public:
      */
     [[nodiscard]] virtual ssize_t Send(const void* data, size_t len, int flags) const;
 
+    /**
+     * sendmsg(2) wrapper, sending the concatenation of `data` with a single system call.
+     * Like `Send()` it may send fewer bytes than given, here possibly stopping short of the
+     * later segments (always so on Windows, where only the first non-empty one is sent).
+     */
+    [[nodiscard]] virtual ssize_t SendV(std::span<const std::span<const uint8_t>> data, int flags) const;
+
     /**
      * recv(2) wrapper. Equivalent to `recv(m_socket, buf, len, flags);`. Code that uses this
      * wrapper can be unit tested if this method is overridden by a mock Sock implementation.
@@ -269,6 +279,10 @@ public:
     bool operator==(SOCKET s) const;
 
 protected:
+#ifdef USE_EPOLL
+    friend class SockPoller;
+#endif
+
     /**
      * Contained socket. `INVALID_SOCKET` designates the object is empty.
      */
@@ -281,6 +295,70 @@ private:
     void Close();
 };
 
+#ifdef USE_EPOLL
+/**
+ * Persistent set of sockets to wait on, backed by epoll(7).
+ *
+ * Unlike with `Sock::WaitMany()`, the sockets and the events wanted on them
+ * stay registered in the kernel between waits. Setting the same interest again
+ * only costs a lookup, and a wait costs in proportion to the number of ready
+ * sockets rather than to the number of registered ones.
+ *
+ * Only `weak_ptr`s to the sockets are kept, so registering a socket does not
+ * delay closing it. A closed socket drops out of the kernel's set by itself.
+ * Not thread safe.
+ */
+class SockPoller
+{
+public:
+    /** @throws std::runtime_error if the epoll instance cannot be created. */
+    SockPoller();
+    ~SockPoller();
+
+    SockPoller(const SockPoller&) = delete;
+    SockPoller& operator=(const SockPoller&) = delete;
+
+    /**
+     * Wait for `requested` (bitwise-or of `Sock::RECV` and `Sock::SEND`) on `sock` from
+     * now on, or stop waiting on it if 0. Only changes result in a system call.
+     */
+    void SetInterest(const std::shared_ptr<const Sock>& sock, Sock::Event requested);
+
+    /** Forget the sockets whose interest was not set since the previous call. */
+    void RemoveStale();
+
+    /** Whether any socket has a non-zero interest. */
+    bool HasInterest() const { return m_interested > 0; }
+
+    /** Number of sockets whose interest has been set and not forgotten. */
+    size_t Size() const { return m_registered.size(); }
+
+    /**
+     * Wait for readiness of any of the sockets and add the ready ones, with what occurred
+     * on them, to `ready`. Like `Sock::WaitMany()`, `ERR` may be set even if not requested.
+     * @return true on success or timeout, false otherwise
+     */
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& ready);
+
+private:
+    struct Registration {
+        std::weak_ptr<const Sock> sock;
+        Sock::Event requested{0};
+        //! Value of m_generation when the interest was last set.
+        uint64_t generation{0};
+    };
+
+    //! Change the kernel's registration of `fd` from `from` to `to`.
+    void Control(SOCKET fd, Sock::Event from, Sock::Event to);
+
+    int m_epoll_fd;
+    std::unordered_map<SOCKET, Registration> m_registered;
+    uint64_t m_generation{0};
+    //! Number of entries of m_registered with a non-zero interest.
+    size_t m_interested{0};
+};
+#endif // USE_EPOLL
+
 /** Return readable error string for a network error code */
 std::string NetworkErrorString(int err);
 
@@ -49,8 +49,10 @@ bool IsHex(std::string_view str)
 template <typename Byte>
 std::optional<std::vector<Byte>> TryParseHex(std::string_view str)
 {
-    std::vector<Byte> vch;
-    vch.reserve(str.size() / 2); // two hex characters form a single byte
+    std::vector<Byte> vch(str.size() / 2); // two hex characters form a single byte
+    // Most strings have no whitespace, and are decoded in a single pass.
+    if (str.size() % 2 == 0 && DecodeHexDigits(str, MakeWritableUCharSpan(vch))) return vch;
+    vch.clear();
 
     auto it = str.begin();
     while (it != str.end()) {
@@ -0,0 +1,285 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <attributes.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads executing submitted tasks in FIFO order.
+ *
+ * Tasks are submitted with Submit(), which returns a std::future for the
+ * task's result. Exceptions thrown by a task are stored in that future.
+ *
+ * If the pool has no worker threads (Start() was not called or was called
+ * with zero workers), submitted tasks are executed synchronously on the
+ * calling thread. This keeps callers simple for configurations where
+ * parallelism is disabled.
+ */
+class ThreadPool
+{
+private:
+    const std::string m_name;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_work_queue GUARDED_BY(m_mutex);
+    bool m_interrupt GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (true) {
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_interrupt || !m_work_queue.empty(); });
+            // Drain remaining work before exiting, so no future is left unsatisfied.
+            if (m_work_queue.empty()) return;
+            auto task{std::move(m_work_queue.front())};
+            m_work_queue.pop_front();
+            REVERSE_LOCK(lock, m_mutex);
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(std::string name) : m_name{std::move(name)} {}
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() { Stop(); }
+
+    /** Spawn the worker threads. Must not be called while workers are running. */
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Assume(m_workers.empty());
+        WITH_LOCK(m_mutex, m_interrupt = false);
+        m_workers.reserve(num_workers);
+        for (int n = 0; n < num_workers; ++n) {
+            m_workers.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("%s.%i", m_name, n));
+                WorkerThread();
+            });
+        }
+    }
+
+    /** Finish all queued work and join the worker threads. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_interrupt = true);
+        m_cv.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    /** Queue a task for execution and return a future for its result. */
+    template <typename F>
+    [[nodiscard]] std::future<std::invoke_result_t<F>> Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        using R = std::invoke_result_t<F>;
+        auto task{std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn))};
+        std::future<R> result{task->get_future()};
+        if (m_workers.empty()) {
+            (*task)();
+            return result;
+        }
+        {
+            LOCK(m_mutex);
+            m_work_queue.emplace_back([task]() { (*task)(); });
+        }
+        m_cv.notify_one();
+        return result;
+    }
+
+    /** Number of tasks waiting to be picked up by a worker. */
+    size_t WorkQueueSize() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_work_queue.size());
+    }
+
+    size_t WorkersCount() const { return m_workers.size(); }
+};
+
+/**
+ * Pool of worker threads shared by the subsystems doing CPU-bound work in
+ * parallel, so that the number of threads busy with such work stays bounded
+ * however many of them run at the same time.
+ *
+ * Tasks are submitted through a Group, which has a priority and a maximum
+ * number of its tasks running at once. Workers run the tasks of the groups of
+ * the highest priority first, in turn among groups of the same priority, and
+ * leave the tasks of groups at their maximum to the other groups.
+ *
+ * As with ThreadPool, tasks are executed synchronously on the calling thread
+ * when the pool has no worker threads. Tasks must not wait for other tasks of
+ * the pool, as these may only be run once the waiting task is done.
+ */
+class SharedThreadPool
+{
+public:
+    enum class Priority { HIGH, NORMAL, LOW };
+    static constexpr size_t NUM_PRIORITIES{3};
+
+private:
+    //! State of a Group, guarded by m_mutex of its pool.
+    struct GroupState {
+        const Priority priority;
+        const size_t max_running;
+        size_t running{0};
+        std::deque<std::function<void()>> tasks;
+
+        GroupState(Priority priority_in, size_t max_running_in) : priority{priority_in}, max_running{max_running_in} {}
+    };
+
+    const std::string m_name;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Groups with queued tasks, by priority.
+    std::array<std::deque<std::shared_ptr<GroupState>>, NUM_PRIORITIES> m_queued GUARDED_BY(m_mutex);
+    bool m_interrupt GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    //! Take the next task which may run, rotating the groups of its priority.
+    std::optional<std::pair<std::shared_ptr<GroupState>, std::function<void()>>> NextTask() EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        for (auto& groups : m_queued) {
+            for (auto it{groups.begin()}; it != groups.end(); ++it) {
+                if ((*it)->running >= (*it)->max_running) continue;
+                auto group{*it};
+                auto task{std::move(group->tasks.front())};
+                group->tasks.pop_front();
+                ++group->running;
+                groups.erase(it);
+                if (!group->tasks.empty()) groups.push_back(group);
+                return std::make_pair(std::move(group), std::move(task));
+            }
+        }
+        return std::nullopt;
+    }
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (true) {
+            std::optional<std::pair<std::shared_ptr<GroupState>, std::function<void()>>> next;
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                next = NextTask();
+                return next || (m_interrupt && std::ranges::all_of(m_queued, [](const auto& groups) { return groups.empty(); }));
+            });
+            // Drain remaining work before exiting, so no future is left unsatisfied.
+            if (!next) return;
+            {
+                REVERSE_LOCK(lock, m_mutex);
+                next->second();
+            }
+            auto& group{*next->first};
+            // The group may have been left out while at its maximum.
+            if (group.running-- == group.max_running && !group.tasks.empty()) m_cv.notify_all();
+        }
+    }
+
+public:
+    /** Tasks of one subsystem, see SharedThreadPool. */
+    class Group
+    {
+    private:
+        SharedThreadPool& m_pool;
+        const std::shared_ptr<GroupState> m_state;
+
+    public:
+        //! @param[in] max_running  Maximum number of tasks of the group running at once, at least 1.
+        Group(SharedThreadPool& pool LIFETIMEBOUND, Priority priority, size_t max_running)
+            : m_pool{pool}, m_state{std::make_shared<GroupState>(priority, std::max<size_t>(max_running, 1))} {}
+
+        /** Queue a task for execution and return a future for its result. */
+        template <typename F>
+        [[nodiscard]] std::future<std::invoke_result_t<F>> Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_pool.m_mutex)
+        {
+            using R = std::invoke_result_t<F>;
+            auto task{std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn))};
+            std::future<R> result{task->get_future()};
+            if (m_pool.m_workers.empty()) {
+                (*task)();
+                return result;
+            }
+            {
+                LOCK(m_pool.m_mutex);
+                if (m_state->tasks.empty()) m_pool.m_queued[size_t(m_state->priority)].push_back(m_state);
+                m_state->tasks.emplace_back([task]() { (*task)(); });
+            }
+            m_pool.m_cv.notify_one();
+            return result;
+        }
+
+        /** Number of tasks of the group which may run at once. */
+        size_t Concurrency() const { return std::min(m_state->max_running, std::max<size_t>(m_pool.WorkersCount(), 1)); }
+    };
+
+    explicit SharedThreadPool(std::string name) : m_name{std::move(name)} {}
+
+    SharedThreadPool(const SharedThreadPool&) = delete;
+    SharedThreadPool& operator=(const SharedThreadPool&) = delete;
+
+    ~SharedThreadPool() { Stop(); }
+
+    /** Spawn the worker threads. Must not be called while workers are running. */
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Assume(m_workers.empty());
+        WITH_LOCK(m_mutex, m_interrupt = false);
+        m_workers.reserve(num_workers);
+        for (int n = 0; n < num_workers; ++n) {
+            m_workers.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("%s.%i", m_name, n));
+                WorkerThread();
+            });
+        }
+    }
+
+    /** Finish all queued work and join the worker threads. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_interrupt = true);
+        m_cv.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    size_t WorkersCount() const { return m_workers.size(); }
+};
+
+/**
+ * The pool shared by the subsystems of the node, started by it. It is never
+ * destroyed, so that it may be used during static destruction.
+ */
+inline SharedThreadPool& GetSharedThreadPool()
+{
+    static SharedThreadPool* pool{new SharedThreadPool{"shared"}};
+    return *pool;
+}
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
@@ -0,0 +1,27 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/throttle.h>
+
+#include <algorithm>
+#include <utility>
+
+Throttle::Throttle(uint64_t max_bytes_per_second, int cpu_percent)
+    : m_max_bytes_per_second{max_bytes_per_second}, m_cpu_percent{std::clamp(cpu_percent, 1, 100)}
+{
+}
+
+std::chrono::microseconds Throttle::Account(uint64_t bytes_read, std::chrono::microseconds busy)
+{
+    using std::chrono::microseconds;
+    // The unit of work must take at least as long as reading its bytes at the
+    // maximum rate, and as long as its busy time at the given share.
+    microseconds needed{busy * 100 / m_cpu_percent};
+    if (m_max_bytes_per_second > 0) {
+        needed = std::max(needed, microseconds{bytes_read * 1'000'000 / m_max_bytes_per_second});
+    }
+    m_owed += std::max(needed - busy, microseconds{0});
+    if (m_owed < MIN_PAUSE) return microseconds{0};
+    return std::exchange(m_owed, microseconds{0});
+}
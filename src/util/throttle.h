@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THROTTLE_H
+#define BITCOIN_UTIL_THROTTLE_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Budget of a background task, e.g. building an index, so that it leaves disk
+ * bandwidth and CPU time to the rest of the node.
+ *
+ * The task reports every unit of work it does, with the bytes it read and the
+ * time it took, and pauses for the time returned. Short pauses are added up
+ * and returned together once they are long enough to be worth sleeping.
+ */
+class Throttle
+{
+public:
+    //! Pauses shorter than this are carried over to the next unit of work.
+    static constexpr std::chrono::milliseconds MIN_PAUSE{10};
+
+    /**
+     * @param[in] max_bytes_per_second  Read rate to stay under, or 0 for no limit.
+     * @param[in] cpu_percent  Share of the time to be busy, from 1 to 100 (no limit).
+     */
+    Throttle(uint64_t max_bytes_per_second, int cpu_percent);
+
+    //! Whether the read rate is limited, so the callers need to count the bytes they read.
+    bool LimitsReads() const { return m_max_bytes_per_second > 0; }
+
+    //! Whether the budget limits anything at all.
+    bool Enabled() const { return LimitsReads() || m_cpu_percent < 100; }
+
+    //! Account for a unit of work, and return how long to pause after it.
+    std::chrono::microseconds Account(uint64_t bytes_read, std::chrono::microseconds busy);
+
+private:
+    uint64_t m_max_bytes_per_second;
+    int m_cpu_percent;
+    //! Pause owed but not returned yet.
+    std::chrono::microseconds m_owed{0};
+};
+
+#endif // BITCOIN_UTIL_THROTTLE_H
@@ -28,6 +28,11 @@
 #define TRACEPOINT_SEMAPHORE(context, event) \
     unsigned short context##_##event##_semaphore __attribute__((section(".probes")))
 
+// Declares a semaphore defined with TRACEPOINT_SEMAPHORE in another translation
+// unit, for tracepoints in headers.
+#define TRACEPOINT_SEMAPHORE_EXTERN(context, event) \
+    extern unsigned short context##_##event##_semaphore
+
 #include <sys/sdt.h>
 
 // Returns true if something is attached to the tracepoint.
@@ -45,6 +50,7 @@
 #else
 
 #define TRACEPOINT_SEMAPHORE(context, event)
+#define TRACEPOINT_SEMAPHORE_EXTERN(context, event)
 #define TRACEPOINT_ACTIVE(context, event) false
 #define TRACEPOINT(context, ...)
 
@@ -64,6 +64,8 @@ public:
     constexpr const std::byte* begin() const { return reinterpret_cast<const std::byte*>(m_wrapped.begin()); }
     constexpr const std::byte* end() const { return reinterpret_cast<const std::byte*>(m_wrapped.end()); }
     template <typename Stream> void Serialize(Stream& s) const { m_wrapped.Serialize(s); }
+    //! Serialized as its bytes, see BulkSerializable.
+    static constexpr size_t SERIALIZED_BYTES{uint256::SERIALIZED_BYTES};
     template <typename Stream> void Unserialize(Stream& s) { m_wrapped.Unserialize(s); }
 
     /** Conversion function to `uint256`.
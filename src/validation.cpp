@@ -12,6 +12,7 @@
 #include <checkqueue.h>
 #include <clientversion.h>
 #include <consensus/amount.h>
+#include <consensus/blockmetadata.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
 #include <consensus/tx_check.h>
@@ -30,6 +31,7 @@
 #include <kernel/warning.h>
 #include <logging.h>
 #include <logging/timer.h>
+#include <node/blockreadahead.h>
 #include <node/blockstorage.h>
 #include <node/utxo_snapshot.h>
 #include <policy/ephemeral_policy.h>
@@ -53,12 +55,14 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/hasher.h>
+#include <util/metrics.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -68,12 +72,15 @@
 #include <cassert>
 #include <chrono>
 #include <deque>
+#include <future>
 #include <numeric>
 #include <optional>
 #include <ranges>
+#include <set>
 #include <span>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 
 using kernel::CCoinsStats;
@@ -114,9 +121,29 @@ const std::vector<std::string> CHECKLEVEL_DOC {
 static constexpr int PRUNE_LOCK_BUFFER{10};
 
 TRACEPOINT_SEMAPHORE(validation, block_connected);
+TRACEPOINT_SEMAPHORE(validation, block_connect_stages);
 TRACEPOINT_SEMAPHORE(utxocache, flush);
+TRACEPOINT_SEMAPHORE(utxocache, flush_start);
+TRACEPOINT_SEMAPHORE(utxocache, flush_end);
+TRACEPOINT_SEMAPHORE(checkqueue, batch_taken);
 TRACEPOINT_SEMAPHORE(mempool, replaced);
 TRACEPOINT_SEMAPHORE(mempool, rejected);
+TRACEPOINT_SEMAPHORE(mempool, accept_stages);
+
+namespace {
+metrics::Gauge& g_metric_tip_height{metrics::GetRegistry().GetGauge("bitcoin_chain_height", "Height of the tip of the active chain")};
+metrics::Gauge& g_metric_ibd{metrics::GetRegistry().GetGauge("bitcoin_initial_block_download", "Whether the node is in initial block download")};
+metrics::Counter& g_metric_blocks_connected{metrics::GetRegistry().GetCounter("bitcoin_blocks_connected", "Blocks connected to the active chain")};
+metrics::Counter& g_metric_blocks_disconnected{metrics::GetRegistry().GetCounter("bitcoin_blocks_disconnected", "Blocks disconnected from the active chain")};
+metrics::Histogram& g_metric_block_connect_time{metrics::GetRegistry().GetHistogram("bitcoin_block_connect_seconds", "Time to connect a block to the active chain, including reading it from disk")};
+metrics::Counter& g_metric_mempool_accepted{metrics::GetRegistry().GetCounter("bitcoin_mempool_accept", "Transactions submitted to the mempool, by result", {{"result", "accepted"}})};
+metrics::Counter& g_metric_mempool_rejected{metrics::GetRegistry().GetCounter("bitcoin_mempool_accept", "Transactions submitted to the mempool, by result", {{"result", "rejected"}})};
+metrics::Gauge& g_metric_coins_cache_entries{metrics::GetRegistry().GetGauge("bitcoin_coins_cache_entries", "Coins in the cache of the active chainstate")};
+metrics::Gauge& g_metric_coins_cache_bytes{metrics::GetRegistry().GetGauge("bitcoin_coins_cache_bytes", "Memory used by the coins cache of the active chainstate")};
+metrics::Counter& g_metric_coins_flushes{metrics::GetRegistry().GetCounter("bitcoin_coins_flushes", "Writes of the coins cache to disk, by kind", {{"kind", "full"}})};
+metrics::Counter& g_metric_coins_chunks{metrics::GetRegistry().GetCounter("bitcoin_coins_flushes", "Writes of the coins cache to disk, by kind", {{"kind", "incremental"}})};
+metrics::Histogram& g_metric_coins_flush_time{metrics::GetRegistry().GetHistogram("bitcoin_coins_flush_seconds", "Time spent writing the coins cache to disk")};
+} // namespace
 
 const CBlockIndex* Chainstate::FindForkInGlobalIndex(const CBlockLocator& locator) const
 {
@@ -311,11 +338,19 @@ void Chainstate::MaybeUpdateMempoolForReorg(
         // back to the mempool starting with the earliest transaction that had
         // been previously seen in a block.
         const auto queuedTx = disconnectpool.take();
+        if (fAddToMempool) {
+            // Look up the coins spent by the transactions at once rather than
+            // for each transaction accepted.
+            const std::vector<CTransactionRef> txs(queuedTx.rbegin(), queuedTx.rend());
+            PrefetchInputs(txs);
+        }
         auto it = queuedTx.rbegin();
         while (it != queuedTx.rend()) {
-            // ignore validation errors in resurrected transactions
+            // ignore validation errors in resurrected transactions. The
+            // mempool gets a copy of the transaction, which would otherwise
+            // keep the memory of all the transactions of its block.
             if (!fAddToMempool || (*it)->IsCoinBase() ||
-                AcceptToMemoryPool(*this, *it, GetTime(),
+                AcceptToMemoryPool(*this, MakeTransactionRef(**it), GetTime(),
                     /*bypass_limits=*/true, /*test_accept=*/false).m_result_type !=
                         MempoolAcceptResult::ResultType::VALID) {
                 // If the transaction doesn't make it in to the mempool, remove any
@@ -624,6 +659,9 @@ public:
      */
     PackageMempoolAcceptResult AcceptPackage(const Package& package, ATMPArgs& args) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    //! Time spent in each stage so far. MempoolAcceptStage::TOTAL is left to the caller.
+    const MempoolAcceptTimes& GetStageTimes() const { return m_stage_times; }
+
 private:
     // All the intermediate state that gets passed between the various levels
     // of checking a given transaction.
@@ -663,8 +701,20 @@ private:
         /** A temporary cache containing serialized transaction data for signature verification.
          * Reused across PolicyScriptChecks and ConsensusScriptChecks. */
         PrecomputedTransactionData m_precomputed_txdata;
+        /** Whether the scripts already passed the policy flags in PackageScriptChecks(), so
+         * PolicyScriptChecks() does not need to run them again. */
+        bool m_policy_scripts_checked{false};
     };
 
+    // Run the checks of PreChecks() that depend on neither the chain nor the mempool: consensus
+    // sanity, standardness and size. They need no locks.
+    bool ContextFreeChecks(const CTransaction& tx, TxValidationState& state);
+
+    // Run ContextFreeChecks() on each package transaction before any lock is taken and remember the
+    // ones that passed, so PreChecks() can skip them. Failures are left to PreChecks() to report in
+    // package order.
+    void PackageContextFreeChecks(const std::vector<CTransactionRef>& txns);
+
     // Run the policy checks on a given transaction, excluding any script checks.
     // Looks up inputs, calculates feerate, considers replacement, evaluates
     // package limits, etc. As this function can be invoked for "free" by a peer,
@@ -685,6 +735,11 @@ private:
     // only invoke this on transactions that have otherwise passed policy checks.
     bool PolicyScriptChecks(const ATMPArgs& args, Workspace& ws) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
 
+    // Run the policy script checks of all package transactions on the script check queue, like
+    // ConnectBlock does. On success, the workspaces are marked so PolicyScriptChecks() skips them.
+    // Any failure is left to PolicyScriptChecks() to report, transaction by transaction.
+    void PackageScriptChecks(std::vector<Workspace>& workspaces) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
+
     // Re-run the script checks, using consensus flags, and try to cache the
     // result in the scriptcache. This should be done after
     // PolicyScriptChecks(). This requires that all inputs either be in our
@@ -724,6 +779,20 @@ private:
     }
 
 private:
+    /** Adds the time until it goes out of scope to a stage in m_stage_times. */
+    class StageTimer
+    {
+    public:
+        StageTimer(MemPoolAccept& accept, MempoolAcceptStage stage) : m_time{accept.m_stage_times[size_t(stage)]} {}
+        ~StageTimer() { m_time = m_time.value_or(SteadyClock::duration{}) + (SteadyClock::now() - m_start); }
+
+    private:
+        std::optional<SteadyClock::duration>& m_time;
+        const SteadyClock::time_point m_start{SteadyClock::now()};
+    };
+
+    MempoolAcceptTimes m_stage_times{};
+
     CTxMemPool& m_pool;
     CCoinsViewCache m_view;
     CCoinsViewMemPool m_viewmempool;
@@ -731,6 +800,9 @@ private:
 
     Chainstate& m_active_chainstate;
 
+    /** Wtxids of the transactions that passed ContextFreeChecks(). */
+    std::set<Wtxid> m_context_free_checked;
+
     // Fields below are per *sub*package state and must be reset prior to subsequent
     // AcceptSingleTransaction and AcceptMultipleTransactions invocations
     struct SubPackageState {
@@ -766,22 +838,8 @@ private:
     }
 };
 
-bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
+bool MemPoolAccept::ContextFreeChecks(const CTransaction& tx, TxValidationState& state)
 {
-    AssertLockHeld(cs_main);
-    AssertLockHeld(m_pool.cs);
-    const CTransactionRef& ptx = ws.m_ptx;
-    const CTransaction& tx = *ws.m_ptx;
-    const Txid& hash = ws.m_hash;
-
-    // Copy/alias what we need out of args
-    const int64_t nAcceptTime = args.m_accept_time;
-    const bool bypass_limits = args.m_bypass_limits;
-    std::vector<COutPoint>& coins_to_uncache = args.m_coins_to_uncache;
-
-    // Alias what we need out of ws
-    TxValidationState& state = ws.m_state;
-
     if (!CheckTransaction(tx, state)) {
         return false; // state filled in by CheckTransaction
     }
@@ -800,6 +858,39 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     if (::GetSerializeSize(TX_NO_WITNESS(tx)) < MIN_STANDARD_TX_NONWITNESS_SIZE)
         return state.Invalid(TxValidationResult::TX_NOT_STANDARD, "tx-size-small");
 
+    return true;
+}
+
+void MemPoolAccept::PackageContextFreeChecks(const std::vector<CTransactionRef>& txns)
+{
+    for (const auto& tx : txns) {
+        if (m_context_free_checked.contains(tx->GetWitnessHash())) continue;
+        TxValidationState state;
+        if (ContextFreeChecks(*tx, state)) m_context_free_checked.insert(tx->GetWitnessHash());
+    }
+}
+
+bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::PRECHECKS};
+    const CTransactionRef& ptx = ws.m_ptx;
+    const CTransaction& tx = *ws.m_ptx;
+    const Txid& hash = ws.m_hash;
+
+    // Copy/alias what we need out of args
+    const int64_t nAcceptTime = args.m_accept_time;
+    const bool bypass_limits = args.m_bypass_limits;
+    std::vector<COutPoint>& coins_to_uncache = args.m_coins_to_uncache;
+
+    // Alias what we need out of ws
+    TxValidationState& state = ws.m_state;
+
+    if (!m_context_free_checked.contains(tx.GetWitnessHash()) && !ContextFreeChecks(tx, state)) {
+        return false; // state filled in by ContextFreeChecks
+    }
+
     // Only accept nLockTime-using transactions that can be mined in the next
     // block; we don't want our mempool filled up with transactions that can't
     // be mined yet.
@@ -832,31 +923,34 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     m_view.SetBackend(m_viewmempool);
 
     const CCoinsViewCache& coins_cache = m_active_chainstate.CoinsTip();
-    // do all inputs exist?
-    for (const CTxIn& txin : tx.vin) {
-        if (!coins_cache.HaveCoinInCache(txin.prevout)) {
-            coins_to_uncache.push_back(txin.prevout);
-        }
-
-        // Note: this call may add txin.prevout to the coins cache
-        // (coins_cache.cacheCoins) by way of FetchCoin(). It should be removed
-        // later (via coins_to_uncache) if this tx turns out to be invalid.
-        if (!m_view.HaveCoin(txin.prevout)) {
-            // Are inputs missing because we already have the tx?
-            for (size_t out = 0; out < tx.vout.size(); out++) {
-                // Optimistically just do efficient check of cache for outputs
-                if (coins_cache.HaveCoinInCache(COutPoint(hash, out))) {
-                    return state.Invalid(TxValidationResult::TX_CONFLICT, "txn-already-known");
+    {
+        StageTimer coins_timer{*this, MempoolAcceptStage::COINS};
+        // do all inputs exist?
+        for (const CTxIn& txin : tx.vin) {
+            if (!coins_cache.HaveCoinInCache(txin.prevout)) {
+                coins_to_uncache.push_back(txin.prevout);
+            }
+
+            // Note: this call may add txin.prevout to the coins cache
+            // (coins_cache.cacheCoins) by way of FetchCoin(). It should be removed
+            // later (via coins_to_uncache) if this tx turns out to be invalid.
+            if (!m_view.HaveCoin(txin.prevout)) {
+                // Are inputs missing because we already have the tx?
+                for (size_t out = 0; out < tx.vout.size(); out++) {
+                    // Optimistically just do efficient check of cache for outputs
+                    if (coins_cache.HaveCoinInCache(COutPoint(hash, out))) {
+                        return state.Invalid(TxValidationResult::TX_CONFLICT, "txn-already-known");
+                    }
                 }
+                // Otherwise assume this might be an orphan tx for which we just haven't seen parents yet
+                return state.Invalid(TxValidationResult::TX_MISSING_INPUTS, "bad-txns-inputs-missingorspent");
             }
-            // Otherwise assume this might be an orphan tx for which we just haven't seen parents yet
-            return state.Invalid(TxValidationResult::TX_MISSING_INPUTS, "bad-txns-inputs-missingorspent");
         }
-    }
 
-    // This is const, but calls into the back end CoinsViews. The CCoinsViewDB at the bottom of the
-    // hierarchy brings the best block into scope. See CCoinsViewDB::GetBestBlock().
-    m_view.GetBestBlock();
+        // This is const, but calls into the back end CoinsViews. The CCoinsViewDB at the bottom of the
+        // hierarchy brings the best block into scope. See CCoinsViewDB::GetBestBlock().
+        m_view.GetBestBlock();
+    }
 
     // we have all inputs cached now, so switch back to dummy (to protect
     // against bugs where we pull more inputs from disk that miss being added
@@ -1069,6 +1163,7 @@ bool MemPoolAccept::ReplacementChecks(Workspace& ws)
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::REPLACEMENT};
 
     const CTransaction& tx = *ws.m_ptx;
     const uint256& hash = ws.m_hash;
@@ -1133,6 +1228,7 @@ bool MemPoolAccept::PackageMempoolChecks(const std::vector<CTransactionRef>& txn
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::REPLACEMENT};
 
     // CheckPackageLimits expects the package transactions to not already be in the mempool.
     assert(std::all_of(txns.cbegin(), txns.cend(), [this](const auto& tx) { return !m_pool.exists(tx->GetHash()); }));
@@ -1229,11 +1325,14 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::POLICY_SCRIPTS};
     const CTransaction& tx = *ws.m_ptx;
     TxValidationState& state = ws.m_state;
 
     constexpr unsigned int scriptVerifyFlags = STANDARD_SCRIPT_VERIFY_FLAGS;
 
+    if (ws.m_policy_scripts_checked) return true;
+
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
     if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
@@ -1253,10 +1352,35 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
     return true;
 }
 
+void MemPoolAccept::PackageScriptChecks(std::vector<Workspace>& workspaces)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::POLICY_SCRIPTS};
+    auto& queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    if (!queue.HasThreads()) return;
+
+    // Collect the checks of every transaction first. The checks point at the precomputed data in
+    // the workspaces, which stay in place until PolicyScriptChecks() is done with them.
+    CCheckQueueControl<CScriptCheck> control(queue);
+    for (Workspace& ws : workspaces) {
+        std::vector<CScriptCheck> checks;
+        TxValidationState state_dummy;
+        if (!CheckInputScripts(*ws.m_ptx, state_dummy, m_view, STANDARD_SCRIPT_VERIFY_FLAGS, true, false, ws.m_precomputed_txdata, GetValidationCache(), &checks)) {
+            // Leave the error to PolicyScriptChecks().
+            return;
+        }
+        control.Add(std::move(checks));
+    }
+    if (control.Complete().has_value()) return;
+    for (Workspace& ws : workspaces) ws.m_policy_scripts_checked = true;
+}
+
 bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::CONSENSUS_SCRIPTS};
     const CTransaction& tx = *ws.m_ptx;
     const uint256& hash = ws.m_hash;
     TxValidationState& state = ws.m_state;
@@ -1283,6 +1407,12 @@ bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
         return Assume(false);
     }
 
+    // Keep the sighash midstates with the entry, so that they are not computed again when the
+    // transaction is validated in a block.
+    if (ws.m_precomputed_txdata.m_bip143_segwit_ready || ws.m_precomputed_txdata.m_bip341_taproot_ready) {
+        ws.m_tx_handle->SetPrecomputedTxData(std::exchange(ws.m_precomputed_txdata, {}));
+    }
+
     return true;
 }
 
@@ -1290,6 +1420,7 @@ void MemPoolAccept::FinalizeSubpackage(const ATMPArgs& args)
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(m_pool.cs);
+    StageTimer timer{*this, MempoolAcceptStage::SUBMIT};
 
     if (!m_subpackage.m_changeset->GetRemovals().empty()) Assume(args.m_allow_replacement);
     // Remove conflicting transactions from the mempool
@@ -1400,6 +1531,7 @@ bool MemPoolAccept::SubmitPackage(const ATMPArgs& args, std::vector<Workspace>&
         results.emplace(ws.m_ptx->GetWitnessHash(),
                         MempoolAcceptResult::Success(std::move(m_subpackage.m_replaced_transactions), ws.m_vsize,
                                          ws.m_base_fees, effective_feerate, effective_feerate_wtxids));
+        const uint64_t mempool_sequence{m_pool.LogAddition(ws.m_ptx->GetHash())};
         if (!m_pool.m_opts.signals) continue;
         const CTransaction& tx = *ws.m_ptx;
         const auto tx_info = NewMempoolTransactionInfo(ws.m_ptx, ws.m_base_fees,
@@ -1407,7 +1539,7 @@ bool MemPoolAccept::SubmitPackage(const ATMPArgs& args, std::vector<Workspace>&
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
                                                        m_pool.HasNoInputsOf(tx));
-        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
+        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, mempool_sequence);
     }
     return all_submitted;
 }
@@ -1469,7 +1601,10 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
 
     // Limit the mempool, if appropriate.
     if (!args.m_package_submission && !args.m_bypass_limits) {
-        LimitMempoolSize(m_pool, m_active_chainstate.CoinsTip());
+        {
+            StageTimer timer{*this, MempoolAcceptStage::LIMIT_MEMPOOL};
+            LimitMempoolSize(m_pool, m_active_chainstate.CoinsTip());
+        }
         if (!m_pool.exists(ws.m_hash)) {
             // The tx no longer meets our (new) mempool minimum feerate but could be reconsidered in a package.
             ws.m_state.Invalid(TxValidationResult::TX_RECONSIDERABLE, "mempool full");
@@ -1477,6 +1612,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
         }
     }
 
+    const uint64_t mempool_sequence{m_pool.LogAddition(ws.m_ptx->GetHash())};
     if (m_pool.m_opts.signals) {
         const CTransaction& tx = *ws.m_ptx;
         auto iter = m_pool.GetIter(tx.GetHash());
@@ -1486,7 +1622,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
                                                        m_pool.HasNoInputsOf(tx));
-        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
+        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, mempool_sequence);
     }
 
     if (!m_subpackage.m_replaced_transactions.empty()) {
@@ -1507,6 +1643,7 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptMultipleTransactions(const std::
     // These context-free package limits can be done before taking the mempool lock.
     PackageValidationState package_state;
     if (!IsWellFormedPackage(txns, package_state, /*require_sorted=*/true)) return PackageMempoolAcceptResult(package_state, {});
+    PackageContextFreeChecks(txns);
 
     std::vector<Workspace> workspaces{};
     workspaces.reserve(txns.size());
@@ -1600,6 +1737,9 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptMultipleTransactions(const std::
         }
     }
 
+    // Spread the script checks of all transactions over the script check threads, if any.
+    PackageScriptChecks(workspaces);
+
     for (Workspace& ws : workspaces) {
         ws.m_package_feerate = package_feerate;
         if (!PolicyScriptChecks(args, ws)) {
@@ -1748,6 +1888,8 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
         m_view.SetBackend(m_dummy);
     }
 
+    PackageContextFreeChecks(package);
+
     LOCK(m_pool.cs);
     // Stores results from which we will create the returned PackageMempoolAcceptResult.
     // A result may be changed if a mempool transaction is evicted later due to LimitMempoolSize().
@@ -1831,7 +1973,10 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
 
     // Make sure we haven't exceeded max mempool size.
     // Package transactions that were submitted to mempool or already in mempool may be evicted.
-    LimitMempoolSize(m_pool, m_active_chainstate.CoinsTip());
+    {
+        StageTimer timer{*this, MempoolAcceptStage::LIMIT_MEMPOOL};
+        LimitMempoolSize(m_pool, m_active_chainstate.CoinsTip());
+    }
 
     for (const auto& tx : package) {
         const auto& wtxid = tx->GetWitnessHash();
@@ -1873,6 +2018,29 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
     return PackageMempoolAcceptResult(package_state_final, std::move(results_final));
 }
 
+//! Add the timings of one mempool acceptance to the chainstate manager's histograms and pass them to the tracepoint.
+void RecordAcceptTimes(ChainstateManager& chainman, const Txid& txid, size_t tx_count, const std::string& result,
+                       MempoolAcceptTimes times, SteadyClock::duration total) EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+{
+    times[size_t(MempoolAcceptStage::TOTAL)] = total;
+    const auto nanos{[&](MempoolAcceptStage stage) {
+        return Ticks<std::chrono::nanoseconds>(times[size_t(stage)].value_or(SteadyClock::duration{}));
+    }};
+    TRACEPOINT(mempool, accept_stages,
+        txid.data(),
+        result.c_str(),
+        tx_count,
+        nanos(MempoolAcceptStage::PRECHECKS),
+        nanos(MempoolAcceptStage::COINS),
+        nanos(MempoolAcceptStage::REPLACEMENT),
+        nanos(MempoolAcceptStage::POLICY_SCRIPTS),
+        nanos(MempoolAcceptStage::CONSENSUS_SCRIPTS),
+        nanos(MempoolAcceptStage::SUBMIT),
+        nanos(MempoolAcceptStage::LIMIT_MEMPOOL),
+        nanos(MempoolAcceptStage::TOTAL)
+    );
+    chainman.RecordMempoolAccept(result, times);
+}
 } // anon namespace
 
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
@@ -1885,7 +2053,15 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
 
     std::vector<COutPoint> coins_to_uncache;
     auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept);
-    MempoolAcceptResult result = MemPoolAccept(pool, active_chainstate).AcceptSingleTransaction(tx, args);
+    const auto time_start{SteadyClock::now()};
+    MemPoolAccept accept{pool, active_chainstate};
+    MempoolAcceptResult result = accept.AcceptSingleTransaction(tx, args);
+    if (!test_accept) {
+        (result.m_result_type == MempoolAcceptResult::ResultType::VALID ? g_metric_mempool_accepted : g_metric_mempool_rejected).Inc();
+    }
+    RecordAcceptTimes(active_chainstate.m_chainman, tx->GetHash(), /*tx_count=*/1,
+                      result.m_result_type == MempoolAcceptResult::ResultType::VALID ? "accepted" : "rejected:" + result.m_state.GetRejectReason(),
+                      accept.GetStageTimes(), SteadyClock::now() - time_start);
     if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
         // Remove coins that were not present in the coins cache before calling
         // AcceptSingleTransaction(); this is to prevent memory DoS in case we receive a large
@@ -1914,16 +2090,21 @@ PackageMempoolAcceptResult ProcessNewPackage(Chainstate& active_chainstate, CTxM
 
     std::vector<COutPoint> coins_to_uncache;
     const CChainParams& chainparams = active_chainstate.m_chainman.GetParams();
+    const auto time_start{SteadyClock::now()};
+    MemPoolAccept accept{pool, active_chainstate};
     auto result = [&]() EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
         AssertLockHeld(cs_main);
         if (test_accept) {
             auto args = MemPoolAccept::ATMPArgs::PackageTestAccept(chainparams, GetTime(), coins_to_uncache);
-            return MemPoolAccept(pool, active_chainstate).AcceptMultipleTransactions(package, args);
+            return accept.AcceptMultipleTransactions(package, args);
         } else {
             auto args = MemPoolAccept::ATMPArgs::PackageChildWithParents(chainparams, GetTime(), coins_to_uncache, client_maxfeerate);
-            return MemPoolAccept(pool, active_chainstate).AcceptPackage(package, args);
+            return accept.AcceptPackage(package, args);
         }
     }();
+    RecordAcceptTimes(active_chainstate.m_chainman, package.back()->GetHash(), package.size(),
+                      result.m_state.IsValid() ? "package" : "package-rejected:" + result.m_state.GetRejectReason(),
+                      accept.GetStageTimes(), SteadyClock::now() - time_start);
 
     // Uncache coins pertaining to transactions that were not submitted to the mempool.
     if (test_accept || result.m_state.IsInvalid()) {
@@ -1954,10 +2135,11 @@ CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
     : m_dbview{std::move(db_params), std::move(options)},
       m_catcherview(&m_dbview) {}
 
-void CoinsViews::InitCache()
+void CoinsViews::InitCache(bool huge_pages)
 {
     AssertLockHeld(::cs_main);
-    m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview);
+    m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview, /*deterministic=*/false, huge_pages);
+    m_connect_block_view = std::make_unique<CCoinsViewCache>(m_cacheview.get());
 }
 
 Chainstate::Chainstate(
@@ -2005,7 +2187,7 @@ void Chainstate::InitCoinsCache(size_t cache_size_bytes)
     AssertLockHeld(::cs_main);
     assert(m_coins_views != nullptr);
     m_coinstip_cache_size_bytes = cache_size_bytes;
-    m_coins_views->InitCache();
+    m_coins_views->InitCache(m_chainman.m_options.huge_pages);
 }
 
 // Note that though this is marked const, we may end up modifying `m_cached_finished_ibd`, which
@@ -2116,6 +2298,16 @@ std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     ScriptError error{SCRIPT_ERR_UNKNOWN_ERROR};
+    if (m_batch_schnorr) {
+        SchnorrBatch batch;
+        if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata, &batch), &error) &&
+            batch.Verify(*m_signature_cache)) {
+            return std::nullopt;
+        }
+        // Something is invalid. Verify without deferring to report the same
+        // error as an unbatched check would.
+        error = SCRIPT_ERR_UNKNOWN_ERROR;
+    }
     if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata), &error)) {
         return std::nullopt;
     } else {
@@ -2124,20 +2316,50 @@ std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
     }
 }
 
-ValidationCache::ValidationCache(const size_t script_execution_cache_bytes, const size_t signature_cache_bytes)
-    : m_signature_cache{signature_cache_bytes}
+ValidationCache::ValidationCache(const size_t script_execution_cache_bytes, const size_t signature_cache_bytes, const bool huge_pages)
+    : m_script_execution_cache_bytes{script_execution_cache_bytes},
+      m_huge_pages{huge_pages},
+      m_signature_cache{signature_cache_bytes, huge_pages}
+{
+    ResetScriptExecutionCache(GetRandHash());
+    const auto [num_elems, approx_size_bytes] = m_script_execution_cache.setup_bytes(script_execution_cache_bytes, huge_pages);
+    LogPrintf("Using %zu MiB out of %zu MiB requested for script execution cache, able to store %zu elements\n",
+              approx_size_bytes >> 20, script_execution_cache_bytes >> 20, num_elems);
+}
+
+void ValidationCache::ResetScriptExecutionCache(const uint256& nonce)
 {
     // Setup the salted hasher
-    uint256 nonce = GetRandHash();
+    m_script_execution_cache_nonce = nonce;
     // We want the nonce to be 64 bytes long to force the hasher to process
     // this chunk, which makes later hash computations more efficient. We
     // just write our 32-byte entropy twice to fill the 64 bytes.
+    m_script_execution_cache_hasher.Reset().Write(nonce.begin(), 32);
     m_script_execution_cache_hasher.Write(nonce.begin(), 32);
-    m_script_execution_cache_hasher.Write(nonce.begin(), 32);
+}
 
-    const auto [num_elems, approx_size_bytes] = m_script_execution_cache.setup_bytes(script_execution_cache_bytes);
-    LogPrintf("Using %zu MiB out of %zu MiB requested for script execution cache, able to store %zu elements\n",
-              approx_size_bytes >> 20, script_execution_cache_bytes >> 20, num_elems);
+uint256 ValidationCache::ScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags) const
+{
+    uint256 entry;
+    CSHA256 hasher{m_script_execution_cache_hasher};
+    hasher.Write(UCharCast(tx.GetWitnessHash().begin()), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(entry.begin());
+    return entry;
+}
+
+std::vector<uint256> ValidationCache::ScriptExecutionCacheEntries() const
+{
+    AssertLockHeld(::cs_main);
+    std::vector<uint256> entries;
+    m_script_execution_cache.ForEach([&](const uint256& entry) { entries.push_back(entry); });
+    return entries;
+}
+
+void ValidationCache::RestoreScriptExecutionCache(const uint256& nonce, std::span<const uint256> entries)
+{
+    AssertLockHeld(::cs_main);
+    ResetScriptExecutionCache(nonce);
+    m_script_execution_cache.setup_bytes(m_script_execution_cache_bytes, m_huge_pages);
+    for (const uint256& entry : entries) m_script_execution_cache.insert(entry);
 }
 
 /**
@@ -2176,9 +2398,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
     // correct (ie that the transaction hash which is in tx's prevouts
     // properly commits to the scriptPubKey in the inputs view of that
     // transaction).
-    uint256 hashCacheEntry;
-    CSHA256 hasher = validation_cache.ScriptExecutionCacheHasher();
-    hasher.Write(UCharCast(tx.GetWitnessHash().begin()), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+    const uint256 hashCacheEntry{validation_cache.ScriptExecutionCacheEntry(tx, flags)};
     AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
     if (validation_cache.m_script_execution_cache.contains(hashCacheEntry, !cacheFullScriptStore)) {
         return true;
@@ -2294,16 +2514,20 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CBlockUndo* block_undo)
 {
     AssertLockHeld(::cs_main);
     bool fClean = true;
 
-    CBlockUndo blockUndo;
-    if (!m_blockman.ReadBlockUndo(blockUndo, *pindex)) {
-        LogError("DisconnectBlock(): failure reading undo data\n");
-        return DISCONNECT_FAILED;
+    CBlockUndo read_undo;
+    if (!block_undo) {
+        if (!m_blockman.ReadBlockUndo(read_undo, *pindex)) {
+            LogError("DisconnectBlock(): failure reading undo data\n");
+            return DISCONNECT_FAILED;
+        }
+        block_undo = &read_undo;
     }
+    CBlockUndo& blockUndo{*block_undo};
 
     if (blockUndo.vtxundo.size() + 1 != block.vtx.size()) {
         LogError("DisconnectBlock(): block and undo data inconsistent\n");
@@ -2411,10 +2635,11 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex& block_index, const Ch
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
-                               CCoinsViewCache& view, bool fJustCheck)
+                               CCoinsViewCache& view, bool fJustCheck, BlockConnectStats* stats)
 {
     AssertLockHeld(cs_main);
     assert(pindex);
+    TIME_SCOPE("ConnectBlock");
 
     uint256 block_hash{block.GetHash()};
     assert(*pindex->phashBlock == block_hash);
@@ -2608,14 +2833,39 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // doesn't invalidate pointers into the vector, and keep txsdata in scope
     // for as long as `control`.
     std::optional<CCheckQueueControl<CScriptCheck>> control;
-    if (auto& queue = m_chainman.GetCheckQueue(); queue.HasThreads() && fScriptChecks) control.emplace(queue);
+    if (auto& queue = m_chainman.GetCheckQueue(*this); queue.HasThreads() && fScriptChecks) control.emplace(queue);
 
     std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
 
+    // Start from the data precomputed when the transactions were accepted to the mempool,
+    // rather than hashing them again for the scripts missing from the script execution cache.
+    if (m_mempool && fScriptChecks) {
+        LOCK(m_mempool->cs);
+        for (size_t i = 1; i < block.vtx.size(); i++) {
+            const auto it{m_mempool->GetIter(block.vtx[i]->GetWitnessHash())};
+            if (it && (*it)->GetPrecomputedTxData()) txsdata[i] = *(*it)->GetPrecomputedTxData();
+        }
+    }
+
+    // Look up all the transactions in the script execution cache at once, so the
+    // lookups can prefetch the cache slots, rather than one at a time in
+    // CheckInputScripts(). The scripts of the transactions found need no checks.
+    std::vector<bool> script_cached;
+    if (fScriptChecks && block.vtx.size() > 1) {
+        std::vector<uint256> cache_entries;
+        cache_entries.reserve(block.vtx.size() - 1);
+        for (size_t i = 1; i < block.vtx.size(); i++) {
+            cache_entries.push_back(m_chainman.m_validation_cache.ScriptExecutionCacheEntry(*block.vtx[i], flags));
+        }
+        // Like CheckInputScripts(), which would be called with cacheFullScriptStore set to fJustCheck.
+        script_cached = m_chainman.m_validation_cache.m_script_execution_cache.contains(cache_entries, /*erase=*/!fJustCheck);
+    }
+
     std::vector<int> prevheights;
     CAmount nFees = 0;
     int nInputs = 0;
     int64_t nSigOpsCost = 0;
+    const auto metadata{GetBlockMetadata(block)};
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
@@ -2661,13 +2911,13 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         // * legacy (always)
         // * p2sh (when P2SH enabled in flags and excludes coinbase)
         // * witness (when witness enabled in flags and excludes coinbase)
-        nSigOpsCost += GetTransactionSigOpCost(tx, view, flags);
+        nSigOpsCost += GetTransactionSigOpCost(tx, view, flags, metadata->txs[i].legacy_sigops);
         if (nSigOpsCost > MAX_BLOCK_SIGOPS_COST) {
             state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-sigops", "too many sigops");
             break;
         }
 
-        if (!tx.IsCoinBase() && fScriptChecks)
+        if (!tx.IsCoinBase() && fScriptChecks && !script_cached[i - 1])
         {
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
             bool tx_ok;
@@ -2677,6 +2927,9 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             if (control) {
                 std::vector<CScriptCheck> vChecks;
                 tx_ok = CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, &vChecks);
+                if (m_chainman.m_options.batch_schnorr && (flags & SCRIPT_VERIFY_TAPROOT)) {
+                    for (CScriptCheck& check : vChecks) check.SetBatchSchnorr(true);
+                }
                 if (tx_ok) control->Add(std::move(vChecks));
             } else {
                 tx_ok = CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache);
@@ -2756,6 +3009,14 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
              Ticks<SecondsDouble>(m_chainman.time_index),
              Ticks<MillisecondsDouble>(m_chainman.time_index) / m_chainman.num_blocks_total);
 
+    if (stats) {
+        stats->check = time_2 - time_start;
+        stats->connect = time_3 - time_2;
+        stats->verify = time_4 - time_3;
+        stats->undo = time_5 - time_4;
+        stats->index = time_6 - time_5;
+    }
+
     TRACEPOINT(validation, block_connected,
         block_hash.data(),
         pindex->nHeight,
@@ -2807,11 +3068,16 @@ bool Chainstate::FlushStateToDisk(
 {
     LOCK(cs_main);
     assert(this->CanFlushToDisk());
+    TIME_SCOPE("FlushStateToDisk");
     std::set<int> setFilesToPrune;
     bool full_flush_completed = false;
 
     const size_t coins_count = CoinsTip().GetCacheSize();
     const size_t coins_mem_usage = CoinsTip().DynamicMemoryUsage();
+    if (this == &m_chainman.ActiveChainstate()) {
+        g_metric_coins_cache_entries.Set(coins_count);
+        g_metric_coins_cache_bytes.Set(coins_mem_usage);
+    }
 
     try {
     {
@@ -2869,10 +3135,13 @@ bool Chainstate::FlushStateToDisk(
         bool fPeriodicWrite = mode == FlushStateMode::PERIODIC && nNow >= m_next_write;
         // Combine all conditions that result in a write to disk.
         bool should_write = (mode == FlushStateMode::ALWAYS) || fCacheLarge || fCacheCritical || fPeriodicWrite || fFlushForPrune;
+        // Otherwise write a bounded number of modified coins between blocks, so
+        // the next full write has less left to do while validation waits.
+        const bool fIncrementalWrite = !should_write && mode == FlushStateMode::PERIODIC && m_chainman.m_options.coins_flush_chunk > 0 && CoinsTip().HasFlaggedEntries();
         // Write blocks, block index and best chain related state to disk.
-        if (should_write) {
-            LogDebug(BCLog::COINDB, "Writing chainstate to disk: flush mode=%s, prune=%d, large=%d, critical=%d, periodic=%d",
-                     FlushStateModeNames[size_t(mode)], fFlushForPrune, fCacheLarge, fCacheCritical, fPeriodicWrite);
+        if (should_write || fIncrementalWrite) {
+            LogDebug(BCLog::COINDB, "Writing chainstate to disk: flush mode=%s, prune=%d, large=%d, critical=%d, periodic=%d, incremental=%d",
+                     FlushStateModeNames[size_t(mode)], fFlushForPrune, fCacheLarge, fCacheCritical, fPeriodicWrite, fIncrementalWrite);
 
             // Ensure we can write block index
             if (!CheckDiskSpace(m_blockman.m_opts.blocks_dir)) {
@@ -2901,10 +3170,47 @@ bool Chainstate::FlushStateToDisk(
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
-                m_blockman.UnlinkPrunedFiles(setFilesToPrune);
+                m_blockman.UnlinkPrunedFilesInBackground(setFilesToPrune);
             }
-
-            if (!CoinsTip().GetBestBlock().IsNull()) {
+            // And move old files to the cold blocks directory, if any.
+            m_blockman.MoveOldFilesToColdDir(m_chain.Height());
+
+            if (fIncrementalWrite && !CoinsTip().GetBestBlock().IsNull()) {
+                // The coins database may refer to the block index entries
+                // written above: until the last chunk is written, a crash is
+                // recovered by replaying the blocks up to the current tip.
+                const size_t max_entries{static_cast<size_t>(m_chainman.m_options.coins_flush_chunk)};
+                if (!CheckDiskSpace(m_chainman.m_options.datadir, 48 * 2 * 2 * std::min<size_t>(max_entries, coins_count))) {
+                    return FatalError(m_chainman.GetNotifications(), state, _("Disk space is too low!"));
+                }
+                TRACEPOINT(utxocache, flush_start,
+                    (uint32_t)mode,
+                    (uint64_t)coins_count,
+                    (uint64_t)coins_mem_usage,
+                    /*empty_cache=*/false,
+                    /*incremental=*/true);
+                const auto time_start{SteadyClock::now()};
+                size_t written{0};
+                if (!CoinsTip().SyncChunk(max_entries, written)) {
+                    return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to coin database."));
+                }
+                const auto elapsed{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - time_start)};
+                TRACEPOINT(utxocache, flush_end,
+                    int64_t{elapsed.count()},
+                    (uint64_t)CoinsTip().GetCacheSize(),
+                    (uint64_t)CoinsTip().DynamicMemoryUsage(),
+                    /*incremental=*/true,
+                    (uint64_t)written,
+                    !CoinsTip().HasFlaggedEntries());
+                ++m_coins_flush_stats.chunks;
+                g_metric_coins_chunks.Inc();
+                g_metric_coins_flush_time.Observe(elapsed);
+                m_coins_flush_stats.chunk_coins += written;
+                m_coins_flush_stats.stall_time += elapsed;
+                m_coins_flush_stats.max_stall = std::max(m_coins_flush_stats.max_stall, elapsed);
+                LogDebug(BCLog::BENCH, "  - Incremental coins write: %u coins, %.2fms%s\n", written, Ticks<MillisecondsDouble>(elapsed),
+                         CoinsTip().HasFlaggedEntries() ? "" : " (coins database consistent)");
+            } else if (!CoinsTip().GetBestBlock().IsNull()) {
                 if (coins_mem_usage >= WARN_FLUSH_COINS_SIZE) LogWarning("Flushing large (%d GiB) UTXO set to disk, it may take several minutes", coins_mem_usage >> 30);
                 LOG_TIME_MILLIS_WITH_CATEGORY(strprintf("write coins cache to disk (%d coins, %.2fKiB)",
                     coins_count, coins_mem_usage >> 10), BCLog::BENCH);
@@ -2919,9 +3225,29 @@ bool Chainstate::FlushStateToDisk(
                 }
                 // Flush the chainstate (which may refer to block index entries).
                 const auto empty_cache{(mode == FlushStateMode::ALWAYS) || fCacheLarge || fCacheCritical};
+                TRACEPOINT(utxocache, flush_start,
+                    (uint32_t)mode,
+                    (uint64_t)coins_count,
+                    (uint64_t)coins_mem_usage,
+                    (bool)empty_cache,
+                    /*incremental=*/false);
+                const auto time_start{SteadyClock::now()};
                 if (empty_cache ? !CoinsTip().Flush() : !CoinsTip().Sync()) {
                     return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to coin database."));
                 }
+                const auto elapsed{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - time_start)};
+                TRACEPOINT(utxocache, flush_end,
+                    int64_t{elapsed.count()},
+                    (uint64_t)CoinsTip().GetCacheSize(),
+                    (uint64_t)CoinsTip().DynamicMemoryUsage(),
+                    /*incremental=*/false,
+                    /*written=*/uint64_t{0},
+                    /*consistent=*/true);
+                ++m_coins_flush_stats.full_flushes;
+                g_metric_coins_flushes.Inc();
+                g_metric_coins_flush_time.Observe(elapsed);
+                m_coins_flush_stats.stall_time += elapsed;
+                m_coins_flush_stats.max_stall = std::max(m_coins_flush_stats.max_stall, elapsed);
                 full_flush_completed = true;
                 TRACEPOINT(utxocache, flush,
                     int64_t{Ticks<std::chrono::microseconds>(NodeClock::now() - nNow)},
@@ -3007,6 +3333,8 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
     if (m_mempool) {
         m_mempool->AddTransactionsUpdated(1);
     }
+    g_metric_tip_height.Set(pindexNew->nHeight);
+    g_metric_ibd.Set(m_chainman.IsInitialBlockDownload());
 
     std::vector<bilingual_str> warning_messages;
     if (!m_chainman.IsInitialBlockDownload()) {
@@ -3042,19 +3370,34 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     CBlockIndex *pindexDelete = m_chain.Tip();
     assert(pindexDelete);
     assert(pindexDelete->pprev);
-    // Read block from disk.
-    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-    CBlock& block = *pblock;
-    if (!m_blockman.ReadBlock(block, *pindexDelete)) {
-        LogError("DisconnectTip(): Failed to read block\n");
-        return false;
+    // An incremental flush leaves coins from any block up to the tip in the
+    // coins database. Complete it before disconnecting, as replaying towards
+    // the new tip after a crash would not undo coins of disconnected blocks.
+    if (CoinsDB().IsPartiallyWritten()) {
+        m_next_write = NodeClock::time_point::min();
+        if (!FlushStateToDisk(state, FlushStateMode::PERIODIC)) return false;
+    }
+    // Read block from disk, unless it was read ahead along with its undo data.
+    std::shared_ptr<const CBlock> pblock;
+    std::shared_ptr<CBlockUndo> block_undo;
+    if (node::BlockReadAhead* read_ahead{m_chainman.GetBlockReadAhead(*this)}) {
+        pblock = read_ahead->Take(*pindexDelete, &block_undo);
     }
+    if (!pblock) {
+        auto pblockNew = std::make_shared<CBlock>();
+        if (!m_blockman.ReadBlock(*pblockNew, *pindexDelete)) {
+            LogError("DisconnectTip(): Failed to read block\n");
+            return false;
+        }
+        pblock = std::move(pblockNew);
+    }
+    const CBlock& block = *pblock;
     // Apply the block atomically to the chain state.
     const auto time_start{SteadyClock::now()};
     {
         CCoinsViewCache view(&CoinsTip());
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK) {
+        if (DisconnectBlock(block, pindexDelete, view, block_undo.get()) != DISCONNECT_OK) {
             LogError("DisconnectTip(): DisconnectBlock %s failed\n", pindexDelete->GetBlockHash().ToString());
             return false;
         }
@@ -3089,8 +3432,10 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     }
 
     m_chain.SetTip(*pindexDelete->pprev);
+    m_chainman.UpdateActiveChainView();
 
     UpdateTip(pindexDelete->pprev);
+    if (this == &m_chainman.ActiveChainstate()) g_metric_blocks_disconnected.Inc();
     // Let wallets know transactions went from 1-confirmed to
     // 0-confirmed or conflicted:
     if (m_chainman.m_options.signals) {
@@ -3099,6 +3444,62 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     return true;
 }
 
+size_t Chainstate::PrefetchInputs(std::span<const CTransactionRef> txs)
+{
+    AssertLockHeld(cs_main);
+    ThreadPool& pool{m_chainman.m_input_prefetch_pool};
+    if (pool.WorkersCount() == 0) return 0;
+
+    // Collect the outpoints that are neither created by an earlier one of the
+    // transactions nor already cached.
+    CCoinsViewCache& tip{CoinsTip()};
+    std::unordered_set<Txid, SaltedTxidHasher> created;
+    created.reserve(txs.size());
+    std::vector<COutPoint> to_fetch;
+    for (const auto& tx : txs) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                if (created.contains(txin.prevout.hash) || tip.HaveCoinInCache(txin.prevout)) continue;
+                to_fetch.push_back(txin.prevout);
+            }
+        }
+        created.insert(tx->GetHash());
+    }
+    if (to_fetch.empty()) return 0;
+
+    // Look the coins up in the database in parallel. The reads go through the
+    // error catcher so that database errors are handled as for any other read.
+    // Lookups are sorted first, so each worker walks a contiguous key range.
+    std::sort(to_fetch.begin(), to_fetch.end());
+    to_fetch.erase(std::unique(to_fetch.begin(), to_fetch.end()), to_fetch.end());
+    const CCoinsView& db{CoinsErrorCatcher()};
+    const size_t num_chunks{std::min(to_fetch.size(), pool.WorkersCount())};
+    const size_t chunk_size{(to_fetch.size() + num_chunks - 1) / num_chunks};
+    std::vector<std::future<std::vector<std::optional<Coin>>>> futures;
+    futures.reserve(num_chunks);
+    for (size_t begin = 0; begin < to_fetch.size(); begin += chunk_size) {
+        const std::span chunk{std::span{to_fetch}.subspan(begin, std::min(chunk_size, to_fetch.size() - begin))};
+        futures.push_back(pool.Submit([&db, chunk] {
+            std::vector<std::optional<Coin>> coins;
+            coins.reserve(chunk.size());
+            for (const COutPoint& outpoint : chunk) coins.push_back(db.GetCoin(outpoint));
+            return coins;
+        }));
+    }
+
+    // Hand the results to the cache. Missing coins are not an error here, they
+    // may be spent or unconfirmed; validation finds out later.
+    size_t prefetched{0};
+    auto outpoint{to_fetch.begin()};
+    for (auto& future : futures) {
+        for (auto& coin : future.get()) {
+            if (coin && tip.AddFetchedCoin(*outpoint, std::move(*coin))) ++prefetched;
+            ++outpoint;
+        }
+    }
+    return prefetched;
+}
+
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
     std::shared_ptr<const CBlock> pblock;
@@ -3151,15 +3552,21 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     if (m_mempool) AssertLockHeld(m_mempool->cs);
 
     assert(pindexNew->pprev == m_chain.Tip());
+    TIME_SCOPE("ConnectTip");
+    BlockConnectStats stats{.hash = pindexNew->GetBlockHash(), .height = pindexNew->nHeight};
     // Read block from disk.
     const auto time_1{SteadyClock::now()};
     std::shared_ptr<const CBlock> pthisBlock;
     if (!pblock) {
-        std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
-        if (!m_blockman.ReadBlock(*pblockNew, *pindexNew)) {
-            return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
+        if (node::BlockReadAhead* read_ahead{m_chainman.GetBlockReadAhead(*this)}; read_ahead && (pthisBlock = read_ahead->Take(*pindexNew))) {
+            LogDebug(BCLog::BENCH, "  - Using read-ahead block\n");
+        } else {
+            std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
+            if (!m_blockman.ReadBlock(*pblockNew, *pindexNew, &stats.deserialize)) {
+                return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
+            }
+            pthisBlock = pblockNew;
         }
-        pthisBlock = pblockNew;
     } else {
         LogDebug(BCLog::BENCH, "  - Using cached block\n");
         pthisBlock = pblock;
@@ -3172,9 +3579,20 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     // num_blocks_total may be zero until the ConnectBlock() call below.
     LogDebug(BCLog::BENCH, "  - Load block from disk: %.2fms\n",
              Ticks<MillisecondsDouble>(time_2 - time_1));
+    stats.read = time_2 - time_1 - stats.deserialize;
+    const auto fetch_stats_before{CoinsTip().GetFetchStats()};
+    if (m_chainman.m_input_prefetch_pool.WorkersCount() > 0) {
+        const size_t prefetched{PrefetchInputs(blockConnecting.vtx)};
+        stats.inputs = SteadyClock::now() - time_2;
+        LogDebug(BCLog::BENCH, "  - Prefetch inputs: %.2fms (%u coins)\n",
+                 Ticks<MillisecondsDouble>(stats.inputs), prefetched);
+    }
     {
-        CCoinsViewCache view(&CoinsTip());
-        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view);
+        CCoinsViewCache& view{*Assert(m_coins_views->m_connect_block_view)};
+        // Its best block may be behind CoinsTip() after a reorg, and it may
+        // hold the changes of a block that failed to connect.
+        view.Reset();
+        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, /*fJustCheck=*/false, &stats);
         if (m_chainman.m_options.signals) {
             m_chainman.m_options.signals->BlockChecked(blockConnecting, state);
         }
@@ -3191,7 +3609,12 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
                  Ticks<MillisecondsDouble>(time_3 - time_2),
                  Ticks<SecondsDouble>(m_chainman.time_connect_total),
                  Ticks<MillisecondsDouble>(m_chainman.time_connect_total) / m_chainman.num_blocks_total);
-        bool flushed = view.Flush();
+        const auto fetch_stats{CoinsTip().GetFetchStats()};
+        LogDebug(BCLog::BENCH, "  - Coins cache: %u hits, %u misses, %u prefetched\n",
+                 fetch_stats.hits - fetch_stats_before.hits,
+                 fetch_stats.misses - fetch_stats_before.misses,
+                 fetch_stats.prefetched - fetch_stats_before.prefetched);
+        bool flushed = view.Flush(/*reallocate_cache=*/false);
         assert(flushed);
     }
     const auto time_4{SteadyClock::now()};
@@ -3217,11 +3640,16 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     }
     // Update m_chain & related variables.
     m_chain.SetTip(*pindexNew);
+    m_chainman.UpdateActiveChainView();
     UpdateTip(pindexNew);
 
     const auto time_6{SteadyClock::now()};
     m_chainman.time_post_connect += time_6 - time_5;
     m_chainman.time_total += time_6 - time_1;
+    if (this == &m_chainman.ActiveChainstate()) {
+        g_metric_blocks_connected.Inc();
+        g_metric_block_connect_time.Observe(time_6 - time_1);
+    }
     LogDebug(BCLog::BENCH, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_6 - time_5),
              Ticks<SecondsDouble>(m_chainman.time_post_connect),
@@ -3231,6 +3659,26 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
              Ticks<SecondsDouble>(m_chainman.time_total),
              Ticks<MillisecondsDouble>(m_chainman.time_total) / m_chainman.num_blocks_total);
 
+    stats.flush = time_4 - time_3;
+    stats.chainstate = time_5 - time_4;
+    stats.total = time_6 - time_1;
+    TRACEPOINT(validation, block_connect_stages,
+        stats.hash.data(),
+        stats.height,
+        Ticks<std::chrono::nanoseconds>(stats.read),
+        Ticks<std::chrono::nanoseconds>(stats.deserialize),
+        Ticks<std::chrono::nanoseconds>(stats.check),
+        Ticks<std::chrono::nanoseconds>(stats.inputs),
+        Ticks<std::chrono::nanoseconds>(stats.connect),
+        Ticks<std::chrono::nanoseconds>(stats.verify),
+        Ticks<std::chrono::nanoseconds>(stats.undo),
+        Ticks<std::chrono::nanoseconds>(stats.index),
+        Ticks<std::chrono::nanoseconds>(stats.flush),
+        Ticks<std::chrono::nanoseconds>(stats.chainstate)
+    );
+    m_chainman.m_block_connect_stats.push_back(stats);
+    if (m_chainman.m_block_connect_stats.size() > BLOCK_CONNECT_STATS_SIZE) m_chainman.m_block_connect_stats.pop_front();
+
     // If we are the background validation chainstate, check to see if we are done
     // validating the snapshot (i.e. our tip has reached the snapshot's base block).
     if (this != &m_chainman.ActiveChainstate()) {
@@ -3335,7 +3783,18 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
     // Disconnect active blocks which are no longer in the best chain.
     bool fBlocksDisconnected = false;
     DisconnectedBlockTransactions disconnectpool{MAX_DISCONNECTED_TX_POOL_BYTES};
-    while (m_chain.Tip() && m_chain.Tip() != pindexFork) {
+    std::vector<const CBlockIndex*> to_disconnect;
+    if (m_chainman.GetBlockReadAhead(*this)) {
+        for (const CBlockIndex* pindex{m_chain.Tip()}; pindex && pindex != pindexFork; pindex = pindex->pprev) {
+            to_disconnect.push_back(pindex);
+        }
+    }
+    for (size_t disconnected{0}; m_chain.Tip() && m_chain.Tip() != pindexFork; ++disconnected) {
+        if (node::BlockReadAhead* read_ahead{m_chainman.GetBlockReadAhead(*this)}; read_ahead && disconnected < to_disconnect.size()) {
+            // Keep reading the blocks we are about to disconnect, and their
+            // undo data, ahead of DisconnectTip.
+            read_ahead->Schedule(std::span{to_disconnect}.subspan(disconnected), /*with_undo=*/true);
+        }
         if (!DisconnectTip(state, &disconnectpool)) {
             // This is likely a fatal error, but keep the mempool consistent,
             // just in case. Only remove from the mempool in this case.
@@ -3367,6 +3826,18 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
         }
         nHeight = nTargetHeight;
 
+        if (node::BlockReadAhead* read_ahead{m_chainman.GetBlockReadAhead(*this)}) {
+            // Start reading the blocks we are about to connect, in connection
+            // order, so disk I/O and deserialization overlap with ConnectBlock.
+            std::vector<const CBlockIndex*> to_read;
+            to_read.reserve(vpindexToConnect.size());
+            for (const CBlockIndex* pindex : vpindexToConnect | std::views::reverse) {
+                if (pindex == pindexMostWork && pblock) continue;
+                to_read.push_back(pindex);
+            }
+            read_ahead->Schedule(to_read);
+        }
+
         // Connect new blocks.
         for (CBlockIndex* pindexConnect : vpindexToConnect | std::views::reverse) {
             if (!ConnectTip(state, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool)) {
@@ -3455,6 +3926,7 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
     // us in the middle of ProcessNewBlock - do not assume pblock is set
     // sanely for performance or correctness!
     AssertLockNotHeld(::cs_main);
+    TIME_SCOPE("ActivateBestChain");
 
     // ABC maintains a fair degree of expensive-to-calculate internal state
     // because this function periodically releases cs_main so that it does not lock up other threads for too long
@@ -3470,10 +3942,16 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
         return false;
     }
 
+    // The background chainstate lets blocks being connected to the active
+    // chainstate go first, so catching up does not delay the tip.
+    const bool yield_to_tip{WITH_LOCK(::cs_main, return GetRole() == ChainstateRole::BACKGROUND)};
+
     CBlockIndex *pindexMostWork = nullptr;
     CBlockIndex *pindexNewTip = nullptr;
     bool exited_ibd{false};
     do {
+        if (yield_to_tip) m_chainman.YieldToTipActivations();
+
         // Block until the validation queue drains. This should largely
         // never happen in normal operation, however may happen during
         // reindex, causing memory blowup if we run too far ahead.
@@ -3573,6 +4051,7 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
             if (m_chainman.m_options.signals && this == &m_chainman.ActiveChainstate()) {
                 m_chainman.m_options.signals->ActiveTipChange(*Assert(pindexNewTip), m_chainman.IsInitialBlockDownload());
             }
+            m_chainman.MaybeResizeCoinsCacheToMemory();
         } // release cs_main
         // When we reach this point, we switched to a new tip (stored in pindexNewTip).
 
@@ -4072,8 +4551,10 @@ bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensu
     // Note that witness malleability is checked in ContextualCheckBlock, so no
     // checks that use witness data may be performed here.
 
+    const auto metadata{GetBlockMetadata(block)};
+
     // Size limits
-    if (block.vtx.empty() || block.vtx.size() * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT || ::GetSerializeSize(TX_NO_WITNESS(block)) * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT)
+    if (block.vtx.empty() || block.vtx.size() * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT || metadata->stripped_size * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT)
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-length", "size limits failed");
 
     // First transaction must be coinbase, the rest must not be
@@ -4097,12 +4578,7 @@ bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensu
     }
     // This underestimates the number of sigops, because unlike ConnectBlock it
     // does not count witness and p2sh sigops.
-    unsigned int nSigOps = 0;
-    for (const auto& tx : block.vtx)
-    {
-        nSigOps += GetLegacySigOpCount(*tx);
-    }
-    if (nSigOps * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
+    if (metadata->legacy_sigops * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-sigops", "out-of-bounds SigOpCount");
 
     if (fCheckPOW && fCheckMerkleRoot)
@@ -4171,8 +4647,9 @@ bool IsBlockMutated(const CBlock& block, bool check_witness_root)
         //
         // Note: This is not a consensus change as this only applies to blocks that
         // don't have a coinbase transaction and would therefore already be invalid.
-        return std::any_of(block.vtx.begin(), block.vtx.end(),
-                           [](auto& tx) { return GetSerializeSize(TX_NO_WITNESS(tx)) == 64; });
+        const auto metadata{GetBlockMetadata(block)};
+        return std::any_of(metadata->txs.begin(), metadata->txs.end(),
+                           [](const TxMetadata& tx) { return tx.stripped_size == 64; });
     } else {
         // Theoretically it is still possible for a block with a 64 byte
         // coinbase transaction to be mutated but we neglect that possibility
@@ -4309,19 +4786,53 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     // large by filling up the coinbase witness, which doesn't change
     // the block hash, so we couldn't mark the block as permanently
     // failed).
-    if (GetBlockWeight(block) > MAX_BLOCK_WEIGHT) {
+    if (GetBlockMetadata(block)->Weight() > MAX_BLOCK_WEIGHT) {
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-weight", strprintf("%s : weight limit failed", __func__));
     }
 
     return true;
 }
 
-bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, CBlockIndex** ppindex, bool min_pow_checked)
+static CheckedHeader CheckHeaderProofOfWork(const CBlockHeader& header, const Consensus::Params& consensusParams)
+{
+    const uint256 hash{header.GetHash()};
+    return {hash, CheckProofOfWork(hash, header.nBits, consensusParams)};
+}
+
+/**
+ * Hash headers and check their proof of work, spread over the threads of
+ * `pool`. Small batches, such as a single announced header, are not worth
+ * handing off and are checked on the calling thread.
+ */
+static std::vector<CheckedHeader> CheckHeadersProofOfWork(std::span<const CBlockHeader> headers, ThreadPool& pool, const Consensus::Params& consensusParams)
+{
+    static constexpr size_t MIN_HEADERS_PER_TASK{64};
+    std::vector<CheckedHeader> checked(headers.size());
+    const size_t num_tasks{std::min(pool.WorkersCount(), headers.size() / MIN_HEADERS_PER_TASK)};
+    if (num_tasks < 2) {
+        std::transform(headers.begin(), headers.end(), checked.begin(),
+                       [&](const CBlockHeader& header) { return CheckHeaderProofOfWork(header, consensusParams); });
+        return checked;
+    }
+    const size_t task_size{(headers.size() + num_tasks - 1) / num_tasks};
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_tasks);
+    for (size_t begin = 0; begin < headers.size(); begin += task_size) {
+        const size_t end{std::min(begin + task_size, headers.size())};
+        futures.push_back(pool.Submit([&, begin, end] {
+            for (size_t i = begin; i < end; ++i) checked[i] = CheckHeaderProofOfWork(headers[i], consensusParams);
+        }));
+    }
+    for (auto& future : futures) future.get();
+    return checked;
+}
+
+bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, CBlockIndex** ppindex, bool min_pow_checked, const CheckedHeader* checked)
 {
     AssertLockHeld(cs_main);
 
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    const uint256 hash{checked ? checked->hash : block.GetHash()};
     BlockMap::iterator miSelf{m_blockman.m_block_index.find(hash)};
     if (hash != GetConsensus().hashGenesisBlock) {
         if (miSelf != m_blockman.m_block_index.end()) {
@@ -4336,7 +4847,8 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, GetConsensus())) {
+        if (checked ? !checked->pow_valid : !CheckProofOfWork(hash, block.nBits, GetConsensus())) {
+            state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
             LogDebug(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -4362,7 +4874,7 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
         LogDebug(BCLog::VALIDATION, "%s: not adding new block header %s, missing anti-dos proof-of-work validation\n", __func__, hash.ToString());
         return state.Invalid(BlockValidationResult::BLOCK_HEADER_LOW_WORK, "too-little-chainwork");
     }
-    CBlockIndex* pindex{m_blockman.AddToBlockIndex(block, m_best_header)};
+    CBlockIndex* pindex{m_blockman.AddToBlockIndex(block, hash, m_best_header)};
 
     if (ppindex)
         *ppindex = pindex;
@@ -4374,11 +4886,15 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
 bool ChainstateManager::ProcessNewBlockHeaders(std::span<const CBlockHeader> headers, bool min_pow_checked, BlockValidationState& state, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
+    // Hashing the headers is the bulk of the work that needs no chain
+    // context, so do it before taking cs_main. Only the lookups and
+    // contextual checks are done under the lock.
+    const std::vector<CheckedHeader> checked{CheckHeadersProofOfWork(headers, m_header_check_pool, GetConsensus())};
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); ++i) {
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            bool accepted{AcceptBlockHeader(header, state, &pindex, min_pow_checked)};
+            bool accepted{AcceptBlockHeader(headers[i], state, &pindex, min_pow_checked, &checked[i])};
             CheckBlockIndex();
 
             if (!accepted) {
@@ -4561,12 +5077,22 @@ bool ChainstateManager::ProcessNewBlock(const std::shared_ptr<const CBlock>& blo
 
     NotifyHeaderTip();
 
+    // Make the background chainstate, if any, wait for this block before
+    // connecting more of its own.
+    WITH_LOCK(m_tip_activations_mutex, ++m_tip_activations);
     BlockValidationState state; // Only used to report errors, not invalidity - ignore it
-    if (!ActiveChainstate().ActivateBestChain(state, block)) {
+    const bool activated{ActiveChainstate().ActivateBestChain(state, block)};
+    WITH_LOCK(m_tip_activations_mutex, --m_tip_activations);
+    m_tip_activations_cv.notify_all();
+    if (!activated) {
         LogError("%s: ActivateBestChain failed (%s)\n", __func__, state.ToString());
         return false;
     }
 
+    if (m_background_validation_pool.WorkersCount() > 0) {
+        ScheduleBackgroundValidation();
+        return true;
+    }
     Chainstate* bg_chain{WITH_LOCK(cs_main, return BackgroundSyncInProgress() ? m_ibd_chainstate.get() : nullptr)};
     BlockValidationState bg_state;
     if (bg_chain && !bg_chain->ActivateBestChain(bg_state, block)) {
@@ -4577,6 +5103,46 @@ bool ChainstateManager::ProcessNewBlock(const std::shared_ptr<const CBlock>& blo
     return true;
 }
 
+void ChainstateManager::ScheduleBackgroundValidation()
+{
+    if (!WITH_LOCK(cs_main, return BackgroundSyncInProgress())) return;
+    // A validation queued but not started yet will connect this block as well.
+    if (m_background_validation_queued.exchange(true)) return;
+    (void)m_background_validation_pool.Submit([this] {
+        m_background_validation_queued = false;
+        if (m_interrupt) return;
+        Chainstate* bg_chain{WITH_LOCK(cs_main, return BackgroundSyncInProgress() ? m_ibd_chainstate.get() : nullptr)};
+        BlockValidationState state;
+        if (bg_chain && !bg_chain->ActivateBestChain(state)) {
+            LogError("[background] ActivateBestChain failed (%s)\n", state.ToString());
+        }
+    });
+}
+
+void ChainstateManager::YieldToTipActivations()
+{
+    WAIT_LOCK(m_tip_activations_mutex, lock);
+    m_tip_activations_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_tip_activations_mutex) { return m_tip_activations == 0; });
+}
+
+CCheckQueue<CScriptCheck>& ChainstateManager::GetCheckQueue(const Chainstate& chainstate)
+{
+    AssertLockHeld(::cs_main);
+    if (m_background_script_check_queue && chainstate.GetRole() == ChainstateRole::BACKGROUND) {
+        return *m_background_script_check_queue;
+    }
+    return m_script_check_queue;
+}
+
+node::BlockReadAhead* ChainstateManager::GetBlockReadAhead(const Chainstate& chainstate) const
+{
+    AssertLockHeld(::cs_main);
+    if (m_background_block_read_ahead && chainstate.GetRole() == ChainstateRole::BACKGROUND) {
+        return m_background_block_read_ahead.get();
+    }
+    return m_block_read_ahead.get();
+}
+
 MempoolAcceptResult ChainstateManager::ProcessTransaction(const CTransactionRef& tx, bool test_accept)
 {
     AssertLockHeld(cs_main);
@@ -4673,6 +5239,8 @@ void PruneBlockFilesManual(Chainstate& active_chainstate, int nManualPruneHeight
             state, FlushStateMode::NONE, nManualPruneHeight)) {
         LogPrintf("%s: failed to flush state (%s)\n", __func__, state.ToString());
     }
+    // Return once the files are gone, as callers expect.
+    active_chainstate.m_blockman.WaitForPrunedFilesUnlinked();
 }
 
 bool Chainstate::LoadChainTip()
@@ -4692,6 +5260,7 @@ bool Chainstate::LoadChainTip()
         return false;
     }
     m_chain.SetTip(*pindex);
+    m_chainman.UpdateActiveChainView();
     PruneBlockIndexCandidates();
 
     tip = m_chain.Tip();
@@ -4754,6 +5323,57 @@ VerifyDBResult CVerifyDB::VerifyDB(
 
     const bool is_snapshot_cs{chainstate.m_from_snapshot_blockhash};
 
+    // Levels 0 to 2 check each block on its own, so that the blocks are read
+    // and checked on the shared thread pool ahead of the loop below, which
+    // disconnects them in order. Few blocks are read ahead as they are large.
+    struct CheckedBlock {
+        CBlock block;
+        //! The verification error, if any.
+        std::string error;
+    };
+    std::vector<const CBlockIndex*> to_read;
+    for (const CBlockIndex* p{chainstate.m_chain.Tip()}; p && p->pprev; p = p->pprev) {
+        if (p->nHeight <= chainstate.m_chain.Height() - nCheckDepth) break;
+        if ((chainstate.m_blockman.IsPruneMode() || is_snapshot_cs) && !(p->nStatus & BLOCK_HAVE_DATA)) break;
+        to_read.push_back(p);
+    }
+    SharedThreadPool::Group pool{GetSharedThreadPool(), SharedThreadPool::Priority::HIGH, GetSharedThreadPool().WorkersCount()};
+    std::deque<std::future<CheckedBlock>> reads;
+    // Wait for the reads ahead on return, as they use the block manager.
+    struct WaitReads {
+        std::deque<std::future<CheckedBlock>>& reads;
+        ~WaitReads() { for (const auto& read : reads) read.wait(); }
+    } wait_reads{reads};
+    size_t next_read{0};
+    const auto read_ahead{[&]() EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+        while (next_read < to_read.size() && reads.size() < 2 * pool.Concurrency()) {
+            const CBlockIndex& index{*to_read[next_read++]};
+            reads.push_back(pool.Submit([&blockman = chainstate.m_blockman, &consensus_params, nCheckLevel, height = index.nHeight, hash = index.GetBlockHash(),
+                                         block_pos = index.GetBlockPos(), undo_pos = index.GetUndoPos(), prev_hash = index.pprev->GetBlockHash()] {
+                CheckedBlock checked;
+                // check level 0: read from disk
+                if (!blockman.ReadBlock(checked.block, block_pos, hash)) {
+                    checked.error = strprintf("ReadBlock failed at %d, hash=%s", height, hash.ToString());
+                    return checked;
+                }
+                // check level 1: verify block validity
+                BlockValidationState state;
+                if (nCheckLevel >= 1 && !CheckBlock(checked.block, state, consensus_params)) {
+                    checked.error = strprintf("found bad block at %d, hash=%s (%s)", height, hash.ToString(), state.ToString());
+                    return checked;
+                }
+                // check level 2: verify undo validity
+                if (nCheckLevel >= 2 && !undo_pos.IsNull()) {
+                    CBlockUndo undo;
+                    if (!blockman.ReadBlockUndo(undo, undo_pos, prev_hash)) {
+                        checked.error = strprintf("found bad undo data at %d, hash=%s", height, hash.ToString());
+                    }
+                }
+                return checked;
+            }));
+        }
+    }};
+
     for (pindex = chainstate.m_chain.Tip(); pindex && pindex->pprev; pindex = pindex->pprev) {
         const int percentageDone = std::max(1, std::min(99, (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * (nCheckLevel >= 4 ? 50 : 100))));
         if (reportDone < percentageDone / 10) {
@@ -4772,28 +5392,15 @@ VerifyDBResult CVerifyDB::VerifyDB(
             skipped_no_block_data = true;
             break;
         }
-        CBlock block;
-        // check level 0: read from disk
-        if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
-            LogPrintf("Verification error: ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
-            return VerifyDBResult::CORRUPTED_BLOCK_DB;
-        }
-        // check level 1: verify block validity
-        if (nCheckLevel >= 1 && !CheckBlock(block, state, consensus_params)) {
-            LogPrintf("Verification error: found bad block at %d, hash=%s (%s)\n",
-                      pindex->nHeight, pindex->GetBlockHash().ToString(), state.ToString());
+        // check levels 0 to 2, done ahead, in order
+        read_ahead();
+        CheckedBlock checked{reads.front().get()};
+        reads.pop_front();
+        if (!checked.error.empty()) {
+            LogPrintf("Verification error: %s\n", checked.error);
             return VerifyDBResult::CORRUPTED_BLOCK_DB;
         }
-        // check level 2: verify undo validity
-        if (nCheckLevel >= 2 && pindex) {
-            CBlockUndo undo;
-            if (!pindex->GetUndoPos().IsNull()) {
-                if (!chainstate.m_blockman.ReadBlockUndo(undo, *pindex)) {
-                    LogPrintf("Verification error: found bad undo data at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
-                    return VerifyDBResult::CORRUPTED_BLOCK_DB;
-                }
-            }
-        }
+        const CBlock& block{checked.block};
         // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
         size_t curr_coins_usage = coins.DynamicMemoryUsage() + chainstate.CoinsTip().DynamicMemoryUsage();
 
@@ -4988,6 +5595,7 @@ void Chainstate::ClearBlockIndexCandidates()
 bool ChainstateManager::LoadBlockIndex()
 {
     AssertLockHeld(cs_main);
+    TIME_SCOPE("LoadBlockIndex");
     // Load block index from databases
     if (m_blockman.m_blockfiles_indexed) {
         bool ret{m_blockman.LoadBlockIndexDB(SnapshotBlockhash())};
@@ -5054,6 +5662,117 @@ bool Chainstate::LoadGenesisBlock()
     return true;
 }
 
+bool ChainstateManager::LoadExternalBlock(
+    const uint256& hash,
+    const uint256& prev_hash,
+    const FlatFilePos* dbp,
+    const std::function<std::shared_ptr<CBlock>()>& read_block,
+    std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent,
+    int& loaded)
+{
+    const CChainParams& params{GetParams()};
+
+    std::shared_ptr<CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
+
+    {
+        LOCK(cs_main);
+        // detect out of order blocks, and store them for later
+        if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(prev_hash)) {
+            LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                     prev_hash.ToString());
+            if (dbp && blocks_with_unknown_parent) {
+                blocks_with_unknown_parent->emplace(prev_hash, *dbp);
+            }
+            return true;
+        }
+
+        // process in case the block isn't known yet
+        const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
+        if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+            // This block can be processed immediately.
+            pblock = read_block();
+            if (!pblock) return true;
+
+            BlockValidationState state;
+            if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
+                loaded++;
+            }
+            if (state.IsError()) {
+                return false;
+            }
+        } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+            LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
+        }
+    }
+
+    // Activate the genesis block so normal node progress can continue
+    // During first -reindex, this will only connect Genesis since
+    // ActivateBestChain only connects blocks which are in the block tree db,
+    // which only contains blocks whose parents are in it.
+    // But do this only if genesis isn't activated yet, to avoid connecting many blocks
+    // without assumevalid in the case of a continuation of a reindex that
+    // was interrupted by the user.
+    if (hash == params.GetConsensus().hashGenesisBlock && WITH_LOCK(::cs_main, return ActiveHeight()) == -1) {
+        BlockValidationState state;
+        if (!ActiveChainstate().ActivateBestChain(state, nullptr)) {
+            return false;
+        }
+    }
+
+    if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
+        // must update the tip for pruning to work while importing with -loadblock.
+        // this is a tradeoff to conserve disk space at the expense of time
+        // spent updating the tip to be able to prune.
+        // otherwise, ActivateBestChain won't be called by the import process
+        // until after all of the block files are loaded. ActivateBestChain can be
+        // called by concurrent network message processing. but, that is not
+        // reliable for the purpose of pruning while importing.
+        bool activation_failure = false;
+        for (auto c : GetAll()) {
+            BlockValidationState state;
+            if (!c->ActivateBestChain(state, pblock)) {
+                LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
+                activation_failure = true;
+                break;
+            }
+        }
+        if (activation_failure) {
+            return false;
+        }
+    }
+
+    NotifyHeaderTip();
+
+    if (!blocks_with_unknown_parent) return true;
+
+    // Recursively process earlier encountered successors of this block
+    std::deque<uint256> queue;
+    queue.push_back(hash);
+    while (!queue.empty()) {
+        uint256 head = queue.front();
+        queue.pop_front();
+        auto range = blocks_with_unknown_parent->equal_range(head);
+        while (range.first != range.second) {
+            std::multimap<uint256, FlatFilePos>::iterator it = range.first;
+            std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+            if (m_blockman.ReadBlock(*pblockrecursive, it->second, {})) {
+                const auto& block_hash{pblockrecursive->GetHash()};
+                LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s", __func__, block_hash.ToString(), head.ToString());
+                LOCK(cs_main);
+                BlockValidationState dummy;
+                if (AcceptBlock(pblockrecursive, dummy, nullptr, true, &it->second, nullptr, true)) {
+                    loaded++;
+                    queue.push_back(block_hash);
+                }
+            }
+            range.first++;
+            blocks_with_unknown_parent->erase(it);
+            NotifyHeaderTip();
+        }
+    }
+    return true;
+}
+
 void ChainstateManager::LoadExternalBlockFile(
     AutoFile& file_in,
     FlatFilePos* dbp,
@@ -5110,106 +5829,15 @@ void ChainstateManager::LoadExternalBlockFile(
                 nRewind = nBlockPos + nSize;
                 blkdat.SkipTo(nRewind);
 
-                std::shared_ptr<CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
-
-                {
-                    LOCK(cs_main);
-                    // detect out of order blocks, and store them for later
-                    if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(header.hashPrevBlock)) {
-                        LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                                 header.hashPrevBlock.ToString());
-                        if (dbp && blocks_with_unknown_parent) {
-                            blocks_with_unknown_parent->emplace(header.hashPrevBlock, *dbp);
-                        }
-                        continue;
-                    }
-
-                    // process in case the block isn't known yet
-                    const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
-                    if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                        // This block can be processed immediately; rewind to its start, read and deserialize it.
-                        blkdat.SetPos(nBlockPos);
-                        pblock = std::make_shared<CBlock>();
-                        blkdat >> TX_WITH_WITNESS(*pblock);
-                        nRewind = blkdat.GetPos();
-
-                        BlockValidationState state;
-                        if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
-                            nLoaded++;
-                        }
-                        if (state.IsError()) {
-                            break;
-                        }
-                    } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
-                        LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
-                    }
-                }
-
-                // Activate the genesis block so normal node progress can continue
-                // During first -reindex, this will only connect Genesis since
-                // ActivateBestChain only connects blocks which are in the block tree db,
-                // which only contains blocks whose parents are in it.
-                // But do this only if genesis isn't activated yet, to avoid connecting many blocks
-                // without assumevalid in the case of a continuation of a reindex that
-                // was interrupted by the user.
-                if (hash == params.GetConsensus().hashGenesisBlock && WITH_LOCK(::cs_main, return ActiveHeight()) == -1) {
-                    BlockValidationState state;
-                    if (!ActiveChainstate().ActivateBestChain(state, nullptr)) {
-                        break;
-                    }
-                }
-
-                if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
-                    // must update the tip for pruning to work while importing with -loadblock.
-                    // this is a tradeoff to conserve disk space at the expense of time
-                    // spent updating the tip to be able to prune.
-                    // otherwise, ActivateBestChain won't be called by the import process
-                    // until after all of the block files are loaded. ActivateBestChain can be
-                    // called by concurrent network message processing. but, that is not
-                    // reliable for the purpose of pruning while importing.
-                    bool activation_failure = false;
-                    for (auto c : GetAll()) {
-                        BlockValidationState state;
-                        if (!c->ActivateBestChain(state, pblock)) {
-                            LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
-                            activation_failure = true;
-                            break;
-                        }
-                    }
-                    if (activation_failure) {
-                        break;
-                    }
-                }
-
-                NotifyHeaderTip();
-
-                if (!blocks_with_unknown_parent) continue;
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    auto range = blocks_with_unknown_parent->equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, FlatFilePos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (m_blockman.ReadBlock(*pblockrecursive, it->second, {})) {
-                            const auto& block_hash{pblockrecursive->GetHash()};
-                            LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s", __func__, block_hash.ToString(), head.ToString());
-                            LOCK(cs_main);
-                            BlockValidationState dummy;
-                            if (AcceptBlock(pblockrecursive, dummy, nullptr, true, &it->second, nullptr, true)) {
-                                nLoaded++;
-                                queue.push_back(block_hash);
-                            }
-                        }
-                        range.first++;
-                        blocks_with_unknown_parent->erase(it);
-                        NotifyHeaderTip();
-                    }
-                }
+                const auto read_block{[&] {
+                    // Rewind to the start of the block, read and deserialize it.
+                    blkdat.SetPos(nBlockPos);
+                    auto pblock{std::make_shared<CBlock>()};
+                    blkdat >> TX_WITH_WITNESS(*pblock);
+                    nRewind = blkdat.GetPos();
+                    return pblock;
+                }};
+                if (!LoadExternalBlock(hash, header.hashPrevBlock, dbp, read_block, blocks_with_unknown_parent, nLoaded)) break;
             } catch (const std::exception& e) {
                 // historical bugs added extra data to the block files that does not deserialize cleanly.
                 // commonly this data is between readable blocks, but it does not really matter. such data is not fatal to the import process.
@@ -5231,6 +5859,30 @@ void ChainstateManager::LoadExternalBlockFile(
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 }
 
+void ChainstateManager::LoadScannedBlockFile(
+    std::span<const node::ScannedBlock> blocks,
+    std::multimap<uint256, FlatFilePos>& blocks_with_unknown_parent)
+{
+    const auto start{SteadyClock::now()};
+    int loaded{0};
+    for (const node::ScannedBlock& scanned : blocks) {
+        if (m_interrupt) return;
+
+        const auto read_block{[&]() -> std::shared_ptr<CBlock> {
+            auto pblock{std::make_shared<CBlock>()};
+            if (!m_blockman.ReadBlock(*pblock, scanned.pos, scanned.hash)) return nullptr;
+            return pblock;
+        }};
+        try {
+            if (!LoadExternalBlock(scanned.hash, scanned.prev_hash, &scanned.pos, read_block, &blocks_with_unknown_parent, loaded)) break;
+        } catch (const std::exception& e) {
+            // See LoadExternalBlockFile().
+            LogDebug(BCLog::REINDEX, "%s: unexpected data at %s - %s. continuing\n", __func__, scanned.pos.ToString(), e.what());
+        }
+    }
+    LogPrintf("Loaded %i blocks from external file in %dms\n", loaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
+
 bool ChainstateManager::ShouldCheckBlockIndex() const
 {
     // Assert to verify Flatten() has been called.
@@ -5848,6 +6500,7 @@ util::Result<CBlockIndex*> ChainstateManager::ActivateSnapshot(
     m_snapshot_chainstate->m_mempool = m_active_chainstate->m_mempool;
     m_active_chainstate->m_mempool = nullptr;
     m_active_chainstate = m_snapshot_chainstate.get();
+    UpdateActiveChainView();
     m_blockman.m_snapshot_height = this->GetSnapshotBaseHeight();
 
     LogPrintf("[snapshot] successfully activated snapshot %s\n", base_blockhash.ToString());
@@ -5882,14 +6535,44 @@ static void SnapshotUTXOHashBreakpoint(const util::SignalInterrupt& interrupt)
     if (interrupt) throw StopHashingException();
 }
 
+//! Check the hash of a chunk of a chunked snapshot and decode its coins.
+static util::Result<std::vector<std::pair<COutPoint, Coin>>> DecodeSnapshotChunk(const node::SnapshotChunk& chunk)
+{
+    if (Hash(chunk.payload) != chunk.payload_hash) return util::Error{Untranslated("bad chunk hash")};
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    // The count is untrusted, and every coin takes more than one byte.
+    coins.reserve(std::min<uint64_t>(chunk.coins_count, chunk.payload.size()));
+    try {
+        SpanReader reader{chunk.payload};
+        while (!reader.empty()) {
+            Txid txid;
+            reader >> txid;
+            const uint64_t coins_per_txid{ReadCompactSize(reader)};
+            if (coins_per_txid > chunk.coins_count - coins.size()) return util::Error{Untranslated("more coins than the chunk count")};
+            for (uint64_t i{0}; i < coins_per_txid; ++i) {
+                auto& [outpoint, coin]{coins.emplace_back()};
+                outpoint.hash = txid;
+                outpoint.n = static_cast<uint32_t>(ReadCompactSize(reader));
+                reader >> coin;
+            }
+        }
+    } catch (const std::ios_base::failure&) {
+        return util::Error{Untranslated("truncated chunk")};
+    }
+    if (coins.size() != chunk.coins_count) return util::Error{Untranslated("fewer coins than the chunk count")};
+    return coins;
+}
+
 util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     Chainstate& snapshot_chainstate,
     AutoFile& coins_file,
     const SnapshotMetadata& metadata)
 {
-    // It's okay to release cs_main before we're done using `coins_cache` because we know
-    // that nothing else will be referencing the newly created snapshot_chainstate yet.
+    // It's okay to release cs_main before we're done using `coins_cache` and
+    // `coins_db` because we know that nothing else will be referencing the
+    // newly created snapshot_chainstate yet.
     CCoinsViewCache& coins_cache = *WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsTip());
+    CCoinsViewDB& coins_db = *WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
     uint256 base_blockhash = metadata.m_base_blockhash;
 
@@ -5924,80 +6607,122 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
 
     LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
     int64_t coins_processed{0};
-
-    while (coins_left > 0) {
-        try {
-            Txid txid;
-            coins_file >> txid;
-            size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
-
-            if (coins_per_txid > coins_left) {
-                return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+    // Snapshots are written in the order of the coins database, so the hash
+    // of their contents can be computed while loading them instead of over
+    // the database afterwards, unless the coins come out of that order.
+    kernel::SerializedCoinsHasher hasher;
+
+    // The coins are written straight to the database, not through the coins
+    // cache: they arrive in key order, so each batch covers keys above those
+    // of the batches before it, and LevelDB can move the tables it writes down
+    // the levels without merging them. A cache would hand them to the database
+    // in hash order instead, leaving the tables of one flush overlapping.
+    std::vector<std::pair<COutPoint, Coin>> pending;
+    const auto write_pending{[&] {
+        coins_db.BulkWrite(pending);
+        pending.clear();
+    }};
+
+    const auto add_coin{[&](COutPoint&& outpoint, Coin&& coin) -> util::Result<void> {
+        if (coin.nHeight > base_height ||
+            outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+        ) {
+            return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins",
+                      coins_count - coins_left))};
+        }
+        if (!MoneyRange(coin.out.nValue)) {
+            return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
+                      coins_count - coins_left))};
+        }
+        hasher.Add(outpoint, coin);
+        pending.emplace_back(std::move(outpoint), std::move(coin));
+
+        --coins_left;
+        ++coins_processed;
+
+        if (coins_processed % 1000000 == 0) {
+            LogPrintf("[snapshot] %d coins loaded (%.2f%%)\n",
+                coins_processed,
+                static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count));
+        }
+
+        // Write the coins every so often. If our average Coin size is roughly
+        // 41 bytes, writing every 120,000 coins means holding about 5MB.
+        if (coins_processed % 120000 == 0) {
+            if (m_interrupt) {
+                return util::Error{Untranslated("Aborting after an interrupt was requested")};
             }
+            write_pending();
+        }
+        return {};
+    }};
 
-            for (size_t i = 0; i < coins_per_txid; i++) {
-                COutPoint outpoint;
-                Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
-                outpoint.hash = txid;
-                coins_file >> coin;
-                if (coin.nHeight > base_height ||
-                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-                ) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins",
-                              coins_count - coins_left))};
-                }
-                if (!MoneyRange(coin.out.nValue)) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
-                              coins_count - coins_left))};
-                }
-                coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
-
-                --coins_left;
-                ++coins_processed;
+    if (!metadata.IsChunked()) {
+        while (coins_left > 0) {
+            try {
+                Txid txid;
+                coins_file >> txid;
+                size_t coins_per_txid{0};
+                coins_per_txid = ReadCompactSize(coins_file);
 
-                if (coins_processed % 1000000 == 0) {
-                    LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
-                        coins_processed,
-                        static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
-                        coins_cache.DynamicMemoryUsage() / (1000 * 1000));
+                if (coins_per_txid > coins_left) {
+                    return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
                 }
 
-                // Batch write and flush (if we need to) every so often.
-                //
-                // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
-                // means <5MB of memory imprecision.
-                if (coins_processed % 120000 == 0) {
-                    if (m_interrupt) {
-                        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-                    }
-
-                    const auto snapshot_cache_state = WITH_LOCK(::cs_main,
-                        return snapshot_chainstate.GetCoinsCacheSizeState());
-
-                    if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
-                        // This is a hack - we don't know what the actual best block is, but that
-                        // doesn't matter for the purposes of flushing the cache here. We'll set this
-                        // to its correct value (`base_blockhash`) below after the coins are loaded.
-                        coins_cache.SetBestBlock(GetRandHash());
-
-                        // No need to acquire cs_main since this chainstate isn't being used yet.
-                        FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
-                    }
+                for (size_t i = 0; i < coins_per_txid; i++) {
+                    COutPoint outpoint;
+                    Coin coin;
+                    outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
+                    outpoint.hash = txid;
+                    coins_file >> coin;
+                    if (auto res{add_coin(std::move(outpoint), std::move(coin))}; !res) return res;
                 }
+            } catch (const std::ios_base::failure&) {
+                return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
+                          coins_processed))};
+            }
+        }
+    } else {
+        // Chunks are read from the file in order and decoded concurrently by
+        // the pool, at most one more than it has workers ahead of the chunk
+        // being loaded into the cache.
+        ThreadPool pool{"snapshotload"};
+        pool.Start(std::clamp(m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS));
+        std::deque<std::future<util::Result<std::vector<std::pair<COutPoint, Coin>>>>> pending;
+        uint64_t chunk_coins_read{0};
+        while (chunk_coins_read < coins_count || !pending.empty()) {
+            while (chunk_coins_read < coins_count && pending.size() <= pool.WorkersCount()) {
+                node::SnapshotChunk chunk;
+                try {
+                    coins_file >> chunk;
+                } catch (const std::ios_base::failure&) {
+                    return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
+                              coins_processed))};
+                }
+                if (chunk.coins_count == 0 || chunk.coins_count > coins_count - chunk_coins_read) {
+                    return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+                }
+                chunk_coins_read += chunk.coins_count;
+                pending.push_back(pool.Submit([chunk = std::move(chunk)] { return DecodeSnapshotChunk(chunk); }));
+            }
+            auto coins{pending.front().get()};
+            pending.pop_front();
+            if (!coins) {
+                return util::Error{Untranslated(strprintf("Bad snapshot chunk after deserializing %d coins: %s",
+                          coins_processed, util::ErrorString(coins).original))};
+            }
+            for (auto& [outpoint, coin] : *coins) {
+                if (auto res{add_coin(std::move(outpoint), std::move(coin))}; !res) return res;
             }
-        } catch (const std::ios_base::failure&) {
-            return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
-                      coins_processed))};
         }
     }
 
-    // Important that we set this. This and the coins_cache accesses above are
-    // sort of a layer violation, but either we reach into the innards of
-    // CCoinsViewCache here or we have to invert some of the Chainstate to
-    // embed them in a snapshot-activation-specific CCoinsViewCache bulk load
-    // method.
+    write_pending();
+
+    // Important that we set this. This and the coins_db writes above are sort
+    // of a layer violation, but either we reach around CCoinsViewCache here or
+    // we have to invert some of the Chainstate to embed them in a
+    // snapshot-activation-specific CCoinsViewCache bulk load method.
     coins_cache.SetBestBlock(base_blockhash);
 
     bool out_of_coins{false};
@@ -6013,36 +6738,50 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
             coins_count))};
     }
 
-    LogPrintf("[snapshot] loaded %d (%.2f MB) coins from snapshot %s\n",
+    LogPrintf("[snapshot] loaded %d coins from snapshot %s\n",
         coins_count,
-        coins_cache.DynamicMemoryUsage() / (1000 * 1000),
         base_blockhash.ToString());
 
+    // Check the hash computed while loading before marking the written coins
+    // as those of the base block, so that a bad snapshot is never marked so.
+    const bool hashed_while_loading{hasher.IsOrdered()};
+    std::optional<uint256> hash_serialized;
+    if (hashed_while_loading) hash_serialized = hasher.Finalize();
+    const auto check_hash{[&]() -> util::Result<void> {
+        // Assert that the deserialized chainstate contents match the expected assumeutxo value.
+        if (AssumeutxoHash{*hash_serialized} != au_data.hash_serialized) {
+            return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
+                au_data.hash_serialized.ToString(), hash_serialized->ToString()))};
+        }
+        return {};
+    }};
+    if (hashed_while_loading) {
+        if (auto res{check_hash()}; !res) return res;
+    }
+
     // No need to acquire cs_main since this chainstate isn't being used yet.
     FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/true);
 
     assert(coins_cache.GetBestBlock() == base_blockhash);
 
-    // As above, okay to immediately release cs_main here since no other context knows
-    // about the snapshot_chainstate.
-    CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
-
-    std::optional<CCoinsStats> maybe_stats;
+    if (!hashed_while_loading) {
+        // As above, okay to immediately release cs_main here since no other context knows
+        // about the snapshot_chainstate.
+        CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
-    }
+        std::optional<CCoinsStats> maybe_stats;
 
-    // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
-        return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString()))};
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
+        if (auto res{check_hash()}; !res) return res;
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -6142,6 +6881,7 @@ SnapshotCompletionResult ChainstateManager::MaybeCompleteSnapshotValidation()
         LogError("[snapshot] deleting snapshot, reverting to validated chain, and stopping node\n");
 
         m_active_chainstate = m_ibd_chainstate.get();
+        UpdateActiveChainView();
         m_snapshot_chainstate->m_disabled = true;
         assert(!this->IsUsable(m_snapshot_chainstate.get()));
         assert(this->IsUsable(m_ibd_chainstate.get()));
@@ -6237,6 +6977,28 @@ Chainstate& ChainstateManager::ActiveChainstate() const
     return *m_active_chainstate;
 }
 
+std::shared_ptr<const CChainView> ChainstateManager::ActiveChainView() const
+{
+    LOCK(m_active_chain_view_mutex);
+    return m_active_chain_view;
+}
+
+void ChainstateManager::UpdateActiveChainView()
+{
+    AssertLockHeld(::cs_main);
+    const auto prev{ActiveChainView()};
+    std::shared_ptr<const CChainView> view;
+    if (!m_active_chainstate) {
+        view = std::make_shared<const CChainView>();
+    } else if (prev->Tip() != m_active_chainstate->m_chain.Tip()) {
+        view = std::make_shared<const CChainView>(m_active_chainstate->m_chain, *prev);
+    } else {
+        return;
+    }
+    LOCK(m_active_chain_view_mutex);
+    m_active_chain_view = std::move(view);
+}
+
 bool ChainstateManager::IsSnapshotActive() const
 {
     LOCK(::cs_main);
@@ -6279,11 +7041,41 @@ void ChainstateManager::MaybeRebalanceCaches()
     }
 }
 
+void ChainstateManager::MaybeResizeCoinsCacheToMemory()
+{
+    AssertLockHeld(::cs_main);
+    // Snapshot and background chainstates share the cache as set up by
+    // MaybeRebalanceCaches(), leave them alone.
+    if (!m_options.available_memory || m_snapshot_chainstate || !IsInitialBlockDownload()) return;
+    const auto now{SteadyClock::now()};
+    if (now < m_next_memory_check) return;
+    m_next_memory_check = now + DYNAMIC_COINS_CACHE_INTERVAL;
+    const auto available{m_options.available_memory()};
+    if (!available) return;
+
+    Chainstate& chainstate{ActiveChainstate()};
+    const size_t usage{chainstate.CoinsTip().DynamicMemoryUsage()};
+    const size_t current{chainstate.m_coinstip_cache_size_bytes};
+    size_t target{MIN_DYNAMIC_COINS_CACHE};
+    if (usage + *available > DYNAMIC_COINS_CACHE_HEADROOM + target) target = usage + *available - DYNAMIC_COINS_CACHE_HEADROOM;
+    // Ignore small changes, unless the cache has to be flushed to fit.
+    const size_t change{target > current ? target - current : current - target};
+    if (change < current / 8 && target >= usage) return;
+
+    LogInfo("[%s] resizing coins cache from %.1f MiB to %.1f MiB, %.1f MiB of memory available",
+            chainstate.ToString(), current * (1.0 / 1_MiB), target * (1.0 / 1_MiB), *available * (1.0 / 1_MiB));
+    chainstate.m_coinstip_cache_size_bytes = target;
+    // Flushes if the cache no longer fits.
+    BlockValidationState state;
+    chainstate.FlushStateToDisk(state, FlushStateMode::IF_NEEDED);
+}
+
 void ChainstateManager::ResetChainstates()
 {
     m_ibd_chainstate.reset();
     m_snapshot_chainstate.reset();
     m_active_chainstate = nullptr;
+    UpdateActiveChainView();
 }
 
 /**
@@ -6304,12 +7096,41 @@ ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Opt
       m_interrupt{interrupt},
       m_options{Flatten(std::move(options))},
       m_blockman{interrupt, std::move(blockman_options)},
-      m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes}
+      m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes, m_options.huge_pages},
+      m_block_read_ahead{m_options.block_read_ahead > 0 ? std::make_unique<node::BlockReadAhead>(m_blockman, m_options.block_read_ahead, m_options.block_read_ahead_threads) : nullptr},
+      m_background_block_read_ahead{m_options.block_read_ahead > 0 && m_options.background_worker_threads_num > 0 ?
+                                        std::make_unique<node::BlockReadAhead>(m_blockman, m_options.block_read_ahead, m_options.block_read_ahead_threads) :
+                                        nullptr}
+{
+    if (m_options.background_worker_threads_num > 0) {
+        const int threads{std::min(m_options.background_worker_threads_num, MAX_SCRIPTCHECK_THREADS)};
+        LogInfo("Background chainstate validation uses %d threads", threads);
+        m_background_script_check_queue = std::make_unique<CCheckQueue<CScriptCheck>>(/*batch_size=*/128, threads - 1);
+        m_background_validation_pool.Start(1);
+    }
+    if (m_options.input_prefetch_threads > 0) {
+        LogInfo("Block input prefetching uses %d threads", m_options.input_prefetch_threads);
+        m_input_prefetch_pool.Start(std::min(m_options.input_prefetch_threads, MAX_INPUT_PREFETCH_THREADS));
+    }
+    if (m_options.header_check_threads > 0) {
+        LogInfo("Header checks use %d threads", m_options.header_check_threads);
+        m_header_check_pool.Start(std::min(m_options.header_check_threads, MAX_HEADER_CHECK_THREADS));
+    }
+}
+
+void ChainstateManager::RecordMempoolAccept(const std::string& result, const MempoolAcceptTimes& times)
 {
+    AssertLockHeld(::cs_main);
+    auto& stats{m_mempool_accept_stats[result]};
+    for (size_t i{0}; i < MEMPOOL_ACCEPT_STAGE_COUNT; ++i) {
+        if (times[i]) stats.stages[i].Add(*times[i]);
+    }
 }
 
 ChainstateManager::~ChainstateManager()
 {
+    // Background validation uses the chainstates and the block manager.
+    StopBackgroundValidation();
     LOCK(::cs_main);
 
     m_versionbitscache.Clear();
@@ -6346,6 +7167,7 @@ Chainstate& ChainstateManager::ActivateExistingSnapshot(uint256 base_blockhash)
     m_snapshot_chainstate->m_mempool = m_active_chainstate->m_mempool;
     m_active_chainstate->m_mempool = nullptr;
     m_active_chainstate = m_snapshot_chainstate.get();
+    UpdateActiveChainView();
     return *m_snapshot_chainstate;
 }
 
@@ -6418,6 +7240,7 @@ bool ChainstateManager::DeleteSnapshotChainstate()
         return false;
     }
     m_active_chainstate = m_ibd_chainstate.get();
+    UpdateActiveChainView();
     m_active_chainstate->m_mempool = m_snapshot_chainstate->m_mempool;
     m_snapshot_chainstate.reset();
     return true;
@@ -27,16 +27,23 @@
 #include <txdb.h>
 #include <txmempool.h>
 #include <uint256.h>
+#include <util/byte_units.h>
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/histogram.h>
 #include <util/result.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <versionbits.h>
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -56,6 +63,7 @@ struct PrecomputedTransactionData;
 struct LockPoints;
 struct AssumeutxoData;
 namespace node {
+class BlockReadAhead;
 class SnapshotMetadata;
 } // namespace node
 namespace Consensus {
@@ -81,6 +89,28 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Default for -backgroundpar, the number of threads dedicated to the background chainstate of a snapshot (0 = none) */
+static constexpr int DEFAULT_BACKGROUND_SCRIPTCHECK_THREADS{0};
+
+/** Default for -prefetchthreads, the number of threads prefetching block inputs (0 = disabled) */
+static constexpr int DEFAULT_INPUT_PREFETCH_THREADS{0};
+/** Maximum number of threads prefetching block inputs */
+static constexpr int MAX_INPUT_PREFETCH_THREADS{16};
+
+/** Default for -headercheckthreads, the number of threads hashing received headers (0 = disabled) */
+static constexpr int DEFAULT_HEADER_CHECK_THREADS{0};
+/** Maximum number of threads hashing received headers */
+static constexpr int MAX_HEADER_CHECK_THREADS{16};
+
+/** Default for -coinsflushchunk, the number of modified coins written per incremental flush step (0 = disabled) */
+static constexpr int64_t DEFAULT_COINS_FLUSH_CHUNK{0};
+
+/** How often -dbcachedynamic checks the available memory */
+static constexpr auto DYNAMIC_COINS_CACHE_INTERVAL{10s};
+/** Memory -dbcachedynamic leaves available to the rest of the system */
+static constexpr size_t DYNAMIC_COINS_CACHE_HEADROOM{256_MiB};
+/** Smallest coins cache -dbcachedynamic shrinks to */
+static constexpr size_t MIN_DYNAMIC_COINS_CACHE{32_MiB};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -338,11 +368,15 @@ private:
     bool cacheStore;
     PrecomputedTransactionData *txdata;
     SignatureCache* m_signature_cache;
+    bool m_batch_schnorr{false};
 
 public:
     CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, SignatureCache& signature_cache, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
         m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache) { }
 
+    //! Verify the input's Schnorr signatures together after executing its scripts (see SchnorrBatch).
+    void SetBatchSchnorr(bool batch_schnorr) { m_batch_schnorr = batch_schnorr; }
+
     CScriptCheck(const CScriptCheck&) = delete;
     CScriptCheck& operator=(const CScriptCheck&) = delete;
     CScriptCheck(CScriptCheck&&) = default;
@@ -365,18 +399,38 @@ class ValidationCache
 private:
     //! Pre-initialized hasher to avoid having to recreate it for every hash calculation.
     CSHA256 m_script_execution_cache_hasher;
+    uint256 m_script_execution_cache_nonce;
+    const size_t m_script_execution_cache_bytes;
+    const bool m_huge_pages;
+
+    void ResetScriptExecutionCache(const uint256& nonce);
 
 public:
     CuckooCache::cache<uint256, SignatureCacheHasher> m_script_execution_cache;
     SignatureCache m_signature_cache;
 
-    ValidationCache(size_t script_execution_cache_bytes, size_t signature_cache_bytes);
+    ValidationCache(size_t script_execution_cache_bytes, size_t signature_cache_bytes, bool huge_pages = false);
 
     ValidationCache(const ValidationCache&) = delete;
     ValidationCache& operator=(const ValidationCache&) = delete;
 
     //! Return a copy of the pre-initialized hasher.
     CSHA256 ScriptExecutionCacheHasher() const { return m_script_execution_cache_hasher; }
+
+    //! Entry of the script execution cache for the scripts of `tx` checked with `flags`.
+    uint256 ScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags) const;
+
+    //! Nonce of the entries of the script execution cache.
+    const uint256& ScriptExecutionCacheNonce() const { return m_script_execution_cache_nonce; }
+
+    //! Copy of the entries of the script execution cache, e.g. to save them.
+    std::vector<uint256> ScriptExecutionCacheEntries() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Replace the entries of the script execution cache with saved ones,
+     * computed with `nonce`. Must be called before the cache is used.
+     */
+    void RestoreScriptExecutionCache(const uint256& nonce, std::span<const uint256> entries) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 
 /** Functions for validating blocks and updating the block tree */
@@ -407,6 +461,12 @@ BlockValidationState TestBlockValidity(
     bool check_pow,
     bool check_merkle_root) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+/** Hash of a block header and whether it has the proof of work claimed by its nBits. */
+struct CheckedHeader {
+    uint256 hash;
+    bool pow_valid;
+};
+
 /** Check with the proof of work on each blockheader matches the value in nBits */
 bool HasValidProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
 
@@ -459,6 +519,86 @@ enum class FlushStateMode: uint8_t {
     ALWAYS
 };
 
+/** Number of recently connected blocks whose stage timings are kept, see BlockConnectStats. */
+static constexpr size_t BLOCK_CONNECT_STATS_SIZE{144};
+
+/**
+ * Time spent in each stage of connecting one block in ConnectTip(). Stages
+ * that did not run for the block, such as reading a block that was passed
+ * in, are zero.
+ */
+struct BlockConnectStats {
+    uint256 hash;
+    int height{0};
+    //! Reading the block from disk, or waiting for it to be read ahead.
+    SteadyClock::duration read{};
+    //! Deserializing the block, when it was read by the connecting thread.
+    SteadyClock::duration deserialize{};
+    //! CheckBlock() and the other checks done before the transactions are connected.
+    SteadyClock::duration check{};
+    //! Prefetching the block's inputs (-prefetchthreads).
+    SteadyClock::duration inputs{};
+    //! Connecting the transactions: input lookups, transaction checks and
+    //! queueing the script checks (or running them, without script check threads).
+    SteadyClock::duration connect{};
+    //! Waiting for the script check threads once the transactions are connected.
+    SteadyClock::duration verify{};
+    //! Writing the undo data.
+    SteadyClock::duration undo{};
+    //! Updating the block index entry.
+    SteadyClock::duration index{};
+    //! Writing the block's changes to the coins cache.
+    SteadyClock::duration flush{};
+    //! Writing the chainstate to disk, if that was needed after the block.
+    SteadyClock::duration chainstate{};
+    //! The whole of ConnectTip().
+    SteadyClock::duration total{};
+};
+
+/** Stages of mempool acceptance whose latency is kept in MempoolAcceptStats. */
+enum class MempoolAcceptStage : uint8_t {
+    //! PreChecks(), including the input lookups.
+    PRECHECKS,
+    //! Looking up the inputs in the mempool and the coins cache, as part of PreChecks().
+    COINS,
+    //! Replacement checks, including ImprovesFeerateDiagram(), and the package limits.
+    REPLACEMENT,
+    //! Script checks with the policy flags.
+    POLICY_SCRIPTS,
+    //! Script checks with the consensus flags, which fill the script execution cache.
+    CONSENSUS_SCRIPTS,
+    //! Adding the transactions to the mempool and removing the ones they replace.
+    SUBMIT,
+    //! LimitMempoolSize() after the transactions were added.
+    LIMIT_MEMPOOL,
+    //! The whole of AcceptToMemoryPool() or ProcessNewPackage().
+    TOTAL,
+};
+static constexpr size_t MEMPOOL_ACCEPT_STAGE_COUNT{size_t(MempoolAcceptStage::TOTAL) + 1};
+
+/** Time spent in each stage by one AcceptToMemoryPool() or ProcessNewPackage() call. Stages that did not run are unset. */
+using MempoolAcceptTimes = std::array<std::optional<SteadyClock::duration>, MEMPOOL_ACCEPT_STAGE_COUNT>;
+
+/** Latency histograms of the mempool acceptance stages, for all calls with the same result. */
+struct MempoolAcceptStats {
+    //! Indexed by MempoolAcceptStage.
+    std::array<LatencyHistogram, MEMPOOL_ACCEPT_STAGE_COUNT> stages;
+};
+
+/** Counters describing how the coins cache of a chainstate was written to disk. */
+struct CoinsFlushStats {
+    //! Writes of all modified coins at once, during which validation waits.
+    uint64_t full_flushes{0};
+    //! Bounded incremental writes done between blocks (-coinsflushchunk).
+    uint64_t chunks{0};
+    //! Modified coins written by incremental writes.
+    uint64_t chunk_coins{0};
+    //! Total time spent writing the coins cache while holding cs_main.
+    std::chrono::microseconds stall_time{0};
+    //! Longest single write of the coins cache.
+    std::chrono::microseconds max_stall{0};
+};
+
 /**
  * A convenience class for constructing the CCoinsView* hierarchy used
  * to facilitate access to the UTXO set.
@@ -482,6 +622,10 @@ public:
     //! can fit per the dbcache setting.
     std::unique_ptr<CCoinsViewCache> m_cacheview GUARDED_BY(cs_main);
 
+    //! Scratch view on top of m_cacheview that ConnectTip() connects each block
+    //! to. It is kept, empty, between blocks, to reuse its memory.
+    std::unique_ptr<CCoinsViewCache> m_connect_block_view GUARDED_BY(cs_main);
+
     //! This constructor initializes CCoinsViewDB and CCoinsViewErrorCatcher instances, but it
     //! *does not* create a CCoinsViewCache instance by default. This is done separately because the
     //! presence of the cache has implications on whether or not we're allowed to flush the cache's
@@ -490,8 +634,8 @@ public:
     //! All arguments forwarded onto CCoinsViewDB.
     CoinsViews(DBParams db_params, CoinsViewOptions options);
 
-    //! Initialize the CCoinsViewCache member.
-    void InitCache() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    //! Initialize the CCoinsViewCache members.
+    void InitCache(bool huge_pages) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 
 enum class CoinsCacheSizeState
@@ -719,11 +863,12 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_chainstate_mutex)
         LOCKS_EXCLUDED(::cs_main);
 
-    // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+    // Block (dis)connection on a given view. DisconnectBlock reads the undo
+    // data of the block unless it is given, in which case it is consumed.
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CBlockUndo* block_undo = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
-                      CCoinsViewCache& view, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+                      CCoinsViewCache& view, bool fJustCheck = false, BlockConnectStats* stats = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Apply the effects of a block disconnection on the UTXO set.
     bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
@@ -779,12 +924,26 @@ public:
 
     std::string ToString() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    //! Counters of coins cache writes done by FlushStateToDisk.
+    CoinsFlushStats GetCoinsFlushStats() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main) { return m_coins_flush_stats; }
+
     //! Indirection necessary to make lock annotations work with an optional mempool.
     RecursiveMutex* MempoolMutex() const LOCK_RETURNED(m_mempool->cs)
     {
         return m_mempool ? &m_mempool->cs : nullptr;
     }
 
+    /**
+     * Look up the coins spent by `txs`, e.g. the transactions of a block,
+     * that are not in CoinsTip() yet in the UTXO database, using the
+     * chainstate manager's prefetch threads, and add them to CoinsTip() so
+     * ConnectBlock or mempool acceptance do not have to fetch them one by
+     * one. Does nothing if input prefetching is disabled.
+     *
+     * @returns the number of coins added to the cache.
+     */
+    size_t PrefetchInputs(std::span<const CTransactionRef> txs) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 private:
     bool ActivateBestChainStep(BlockValidationState& state, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
     bool ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
@@ -820,6 +979,8 @@ private:
 
     NodeClock::time_point m_next_write{NodeClock::time_point::max()};
 
+    CoinsFlushStats m_coins_flush_stats GUARDED_BY(::cs_main);
+
     /**
      * In case of an invalid snapshot, rename the coins leveldb directory so
      * that it can be examined for issue diagnosis.
@@ -914,6 +1075,10 @@ private:
     //! most-work chain.
     Chainstate* m_active_chainstate GUARDED_BY(::cs_main) {nullptr};
 
+    mutable Mutex m_active_chain_view_mutex;
+    //! A copy of the active chain, see ActiveChainView().
+    std::shared_ptr<const CChainView> m_active_chain_view GUARDED_BY(m_active_chain_view_mutex){std::make_shared<const CChainView>()};
+
     CBlockIndex* m_best_invalid GUARDED_BY(::cs_main){nullptr};
 
     /** The last header for which a headerTip notification was issued. */
@@ -933,18 +1098,35 @@ private:
         AutoFile& coins_file,
         const node::SnapshotMetadata& metadata);
 
+    /**
+     * Accept a block found in a block file if its parent is known, then the
+     * blocks in blocks_with_unknown_parent that were waiting for it. The
+     * block is only read with `read_block` if it needs to be accepted.
+     * Returns false if loading the file should stop.
+     */
+    bool LoadExternalBlock(
+        const uint256& hash,
+        const uint256& prev_hash,
+        const FlatFilePos* dbp,
+        const std::function<std::shared_ptr<CBlock>()>& read_block,
+        std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent,
+        int& loaded);
+
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to m_block_index.
      * Caller must set min_pow_checked=true in order to add a new header to the
      * block index (permanent memory storage), indicating that the header is
      * known to be part of a sufficiently high-work chain (anti-dos check).
+     * If `checked` is set, it holds the header's hash and proof-of-work
+     * result, computed by the caller without holding cs_main.
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
         BlockValidationState& state,
         CBlockIndex** ppindex,
-        bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        bool min_pow_checked,
+        const CheckedHeader* checked = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     friend Chainstate;
 
     /** Most recent headers presync progress update, for rate-limiting. */
@@ -962,6 +1144,37 @@ private:
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
 
+    //! Script verifications of the background chainstate, when it has
+    //! threads of its own (-backgroundpar). Null otherwise.
+    std::unique_ptr<CCheckQueue<CScriptCheck>> m_background_script_check_queue;
+
+    //! Single worker connecting the blocks of the background chainstate, when
+    //! it has threads of its own, so ProcessNewBlock does not wait for it.
+    ThreadPool m_background_validation_pool{"bgvalidation"};
+
+    //! Whether background validation is queued and has not started yet.
+    std::atomic_bool m_background_validation_queued{false};
+
+    //! Number of ProcessNewBlock calls connecting blocks to the active
+    //! chainstate. The background chainstate waits for them between blocks.
+    Mutex m_tip_activations_mutex;
+    std::condition_variable m_tip_activations_cv;
+    int m_tip_activations GUARDED_BY(m_tip_activations_mutex){0};
+
+    //! Connect the blocks of the background chainstate on its own thread,
+    //! unless that is queued already.
+    void ScheduleBackgroundValidation() LOCKS_EXCLUDED(::cs_main);
+
+    //! Wait for the ProcessNewBlock calls connecting blocks to the active
+    //! chainstate to finish.
+    void YieldToTipActivations() EXCLUSIVE_LOCKS_REQUIRED(!m_tip_activations_mutex);
+
+    //! Worker threads looking up block inputs in the UTXO database ahead of ConnectBlock.
+    ThreadPool m_input_prefetch_pool{"inprefetch"};
+
+    //! Worker threads hashing the headers passed to ProcessNewBlockHeaders before cs_main is taken.
+    ThreadPool m_header_check_pool{"hdrcheck"};
+
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
     SteadyClock::duration GUARDED_BY(::cs_main) time_check{};
@@ -977,6 +1190,12 @@ private:
     SteadyClock::duration GUARDED_BY(::cs_main) time_chainstate{};
     SteadyClock::duration GUARDED_BY(::cs_main) time_post_connect{};
 
+    //! Stage timings of the last BLOCK_CONNECT_STATS_SIZE blocks connected by any chainstate, oldest first.
+    std::deque<BlockConnectStats> m_block_connect_stats GUARDED_BY(::cs_main);
+
+    //! Mempool acceptance latencies by result: "accepted", "rejected:<reason>", "package" or "package-rejected:<reason>".
+    std::map<std::string, MempoolAcceptStats> m_mempool_accept_stats GUARDED_BY(::cs_main);
+
 public:
     using Options = kernel::ChainstateManagerOpts;
 
@@ -1021,6 +1240,15 @@ public:
 
     ValidationCache m_validation_cache;
 
+    //! Reads upcoming blocks ahead of ConnectTip. Null if -blockreadahead is disabled.
+    //! Declared after m_blockman, which it reads from.
+    const std::unique_ptr<node::BlockReadAhead> m_block_read_ahead;
+
+    //! Reads upcoming blocks of the background chainstate, so they do not evict
+    //! those of the active chainstate from m_block_read_ahead. Null unless both
+    //! -blockreadahead and -backgroundpar are enabled.
+    const std::unique_ptr<node::BlockReadAhead> m_background_block_read_ahead;
+
     /**
      * Whether initial block download has ended and IsInitialBlockDownload
      * should return false from now on.
@@ -1065,6 +1293,9 @@ public:
     //! coins databases. This will be split somehow across chainstates.
     size_t m_total_coinsdb_cache{0};
 
+    //! Earliest time of the next MaybeResizeCoinsCacheToMemory() check.
+    SteadyClock::time_point m_next_memory_check GUARDED_BY(::cs_main){};
+
     //! Instantiate a new chainstate.
     //!
     //! @param[in] mempool              The mempool to pass to the chainstate
@@ -1107,6 +1338,16 @@ public:
     int ActiveHeight() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) { return ActiveChain().Height(); }
     CBlockIndex* ActiveTip() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) { return ActiveChain().Tip(); }
 
+    /**
+     * A copy of the active chain as of its last tip change, for looking up
+     * blocks by height and checking whether blocks are in it without cs_main.
+     * It may lag behind ActiveChain() until the change that cs_main is held
+     * for is complete.
+     */
+    std::shared_ptr<const CChainView> ActiveChainView() const EXCLUSIVE_LOCKS_REQUIRED(!m_active_chain_view_mutex);
+    //! Update ActiveChainView() after the tip of the active chain or the active chainstate changed.
+    void UpdateActiveChainView() EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_active_chain_view_mutex);
+
     //! The state of a background sync (for net processing)
     bool BackgroundSyncInProgress() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) {
         return IsUsable(m_snapshot_chainstate.get()) && IsUsable(m_ibd_chainstate.get());
@@ -1177,6 +1418,18 @@ public:
         FlatFilePos* dbp = nullptr,
         std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent = nullptr);
 
+    /**
+     * Like LoadExternalBlockFile() during -reindex, for a block file that was
+     * already scanned by BlockManager::ScanBlockFile(). Each block is read
+     * back from its position when it can be accepted.
+     *
+     * @param[in]     blocks                        Blocks of one file, in file order
+     * @param[in,out] blocks_with_unknown_parent    See LoadExternalBlockFile()
+     */
+    void LoadScannedBlockFile(
+        std::span<const node::ScannedBlock> blocks,
+        std::multimap<uint256, FlatFilePos>& blocks_with_unknown_parent);
+
     /**
      * Process an incoming block. This only returns after the best known valid
      * block is made active. Note that it does not, however, guarantee that the
@@ -1256,6 +1509,12 @@ public:
     //! ResizeCoinsCaches() as needed.
     void MaybeRebalanceCaches() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    //! With Options::available_memory set, grow or shrink the coins cache of
+    //! the active chainstate during IBD to what the system has room for,
+    //! flushing it when it no longer fits. Checks at most every
+    //! DYNAMIC_COINS_CACHE_INTERVAL.
+    void MaybeResizeCoinsCacheToMemory() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /** Update uncommitted block structures (currently: only the witness reserved value). This is safe for submitted blocks. */
     void UpdateUncommittedBlockStructures(CBlock& block, const CBlockIndex* pindexPrev) const;
 
@@ -1320,6 +1579,32 @@ public:
 
     CCheckQueue<CScriptCheck>& GetCheckQueue() { return m_script_check_queue; }
 
+    //! The script check queue the given chainstate connects blocks with.
+    CCheckQueue<CScriptCheck>& GetCheckQueue(const Chainstate& chainstate) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! The block read-ahead stage of the given chainstate, or null if disabled.
+    node::BlockReadAhead* GetBlockReadAhead(const Chainstate& chainstate) const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! Stop connecting the blocks of the background chainstate on its own
+    //! thread and wait for that thread to exit. Called on shutdown, before the
+    //! chainstates are flushed; blocks are connected synchronously afterwards.
+    void StopBackgroundValidation() { m_background_validation_pool.Stop(); }
+
+    //! Stage timings of the most recently connected blocks, oldest first.
+    std::vector<BlockConnectStats> GetBlockConnectStats() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        return {m_block_connect_stats.begin(), m_block_connect_stats.end()};
+    }
+
+    //! Add the stage timings of a mempool acceptance to the histograms of its result.
+    void RecordMempoolAccept(const std::string& result, const MempoolAcceptTimes& times) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! Mempool acceptance latency histograms, by result.
+    std::map<std::string, MempoolAcceptStats> GetMempoolAcceptStats() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        return m_mempool_accept_stats;
+    }
+
     ~ChainstateManager();
 };
 
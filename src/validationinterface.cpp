@@ -14,11 +14,94 @@
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <util/check.h>
+#include <util/metrics.h>
 #include <util/task_runner.h>
 
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <list>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+namespace {
+/**
+ * Queue of the notifications of one subscriber, processed in order by tasks
+ * passed to a scheduling function, one notification per task. At most one
+ * task of a queue is scheduled at a time.
+ */
+class SubscriberQueue : public std::enable_shared_from_this<SubscriberQueue>
+{
+private:
+    const std::function<void(std::function<void()>)> m_schedule;
+    metrics::Gauge& m_pending_metric;
+    Mutex m_mutex;
+    std::list<std::function<void()>> m_pending GUARDED_BY(m_mutex);
+    bool m_scheduled GUARDED_BY(m_mutex){false};
+
+    void Process() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::function<void()> func;
+        {
+            LOCK(m_mutex);
+            // The queue may have been flushed since this task was scheduled.
+            if (m_pending.empty()) {
+                m_scheduled = false;
+                return;
+            }
+            func = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        m_pending_metric.Add(-1);
+        func();
+        {
+            LOCK(m_mutex);
+            m_scheduled = !m_pending.empty();
+            if (!m_scheduled) return;
+        }
+        m_schedule([self = shared_from_this()] { self->Process(); });
+    }
+
+public:
+    //! Whether the subscriber is registered. Notifications are dropped once it is not.
+    std::atomic<bool> m_registered{true};
+
+    SubscriberQueue(std::function<void(std::function<void()>)> schedule, const std::string& name)
+        : m_schedule{std::move(schedule)},
+          m_pending_metric{metrics::GetRegistry().GetGauge("bitcoin_validation_callbacks_pending", "Validation notifications queued, by subscriber", {{"subscriber", name}})} {}
+
+    ~SubscriberQueue() { m_pending_metric.Add(-int64_t(WITH_LOCK(m_mutex, return m_pending.size()))); }
+
+    void Insert(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        m_pending_metric.Add(1);
+        {
+            LOCK(m_mutex);
+            m_pending.emplace_back(std::move(func));
+            if (m_scheduled) return;
+            m_scheduled = true;
+        }
+        m_schedule([self = shared_from_this()] { self->Process(); });
+    }
+
+    //! Process the whole queue on the calling thread.
+    void Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_pending.empty()) {
+            auto func{std::move(m_pending.front())};
+            m_pending.pop_front();
+            m_pending_metric.Add(-1);
+            REVERSE_LOCK(lock, m_mutex);
+            func();
+        }
+    }
+
+    size_t Size() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_pending.size()); }
+};
+} // namespace
 
 /**
  * ValidationSignalsImpl manages a list of shared_ptr<CValidationInterface> callbacks.
@@ -27,6 +110,10 @@
  * registered, and a std::list is used to store the callbacks that are
  * currently registered as well as any callbacks that are just unregistered
  * and about to be deleted when they are done executing.
+ *
+ * Notifications are either queued on one task runner, each one being
+ * delivered to all subscribers in series, or queued on a SubscriberQueue of
+ * each subscriber.
  */
 class ValidationSignalsImpl
 {
@@ -36,21 +123,55 @@ private:
     //! count is equal to the number of current executions of that entry, plus 1
     //! if it's registered. It cannot be 0 because that would imply it is
     //! unregistered and also not being executed (so shouldn't exist).
-    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; };
+    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; std::shared_ptr<SubscriberQueue> queue; };
     std::list<ListEntry> m_list GUARDED_BY(m_mutex);
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
+    //! Queues of subscribers, which outlive their unregistration until they are done processing.
+    std::list<std::weak_ptr<SubscriberQueue>> m_queues GUARDED_BY(m_mutex);
+
+    static void MarkUnregistered(ListEntry& entry)
+    {
+        if (entry.queue) entry.queue->m_registered = false;
+    }
+
+    //! Queues which may still be processing notifications.
+    std::vector<std::shared_ptr<SubscriberQueue>> Queues() EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        for (auto it = m_queues.begin(); it != m_queues.end();) {
+            if (auto queue{it->lock()}) {
+                queues.push_back(std::move(queue));
+                ++it;
+            } else {
+                it = m_queues.erase(it);
+            }
+        }
+        return queues;
+    }
 
 public:
+    using Event = std::function<void(CValidationInterface&)>;
+
     std::unique_ptr<util::TaskRunnerInterface> m_task_runner;
+    const std::function<void(std::function<void()>)> m_schedule;
 
     explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner)
         : m_task_runner{std::move(Assert(task_runner))} {}
 
-    void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    explicit ValidationSignalsImpl(std::function<void(std::function<void()>)> schedule)
+        : m_schedule{std::move(Assert(schedule))} {}
+
+    void Register(std::shared_ptr<CValidationInterface> callbacks, const std::string& name) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto inserted = m_map.emplace(callbacks.get(), m_list.end());
-        if (inserted.second) inserted.first->second = m_list.emplace(m_list.end());
+        if (inserted.second) {
+            inserted.first->second = m_list.emplace(m_list.end());
+            if (m_schedule) {
+                inserted.first->second->queue = std::make_shared<SubscriberQueue>(m_schedule, name);
+                m_queues.push_back(inserted.first->second->queue);
+            }
+        }
         inserted.first->second->callbacks = std::move(callbacks);
     }
 
@@ -59,6 +180,7 @@ public:
         LOCK(m_mutex);
         auto it = m_map.find(callbacks);
         if (it != m_map.end()) {
+            MarkUnregistered(*it->second);
             if (!--it->second->count) m_list.erase(it->second);
             m_map.erase(it);
         }
@@ -72,6 +194,7 @@ public:
     {
         LOCK(m_mutex);
         for (const auto& entry : m_map) {
+            MarkUnregistered(*entry.second);
             if (!--entry.second->count) m_list.erase(entry.second);
         }
         m_map.clear();
@@ -89,28 +212,92 @@ public:
             it = --it->count ? std::next(it) : m_list.erase(it);
         }
     }
+
+    //! Queue an event for all subscribers registered now. With a single task
+    //! runner, `log` is called when the event is delivered.
+    void Enqueue(std::function<void()> log, Event event) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_task_runner) {
+            m_task_runner->insert([this, log = std::move(log), event = std::move(event)] {
+                log();
+                Iterate(event);
+            });
+            return;
+        }
+        const auto shared_event{std::make_shared<const Event>(std::move(event))};
+        // Queue the event on all queues at once, so that events queued by
+        // different threads are in the same order in all queues.
+        LOCK(m_mutex);
+        for (const auto& entry : m_list) {
+            if (!entry.queue->m_registered) continue;
+            entry.queue->Insert([callbacks = entry.callbacks, &registered = entry.queue->m_registered, shared_event] {
+                if (registered) (*shared_event)(*callbacks);
+            });
+        }
+    }
+
+    //! Call func once the events queued so far have been delivered to all subscribers.
+    void CallFunction(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_task_runner) {
+            m_task_runner->insert(std::move(func));
+            return;
+        }
+        LOCK(m_mutex);
+        const auto queues{Queues()};
+        if (queues.empty()) {
+            m_schedule(std::move(func));
+            return;
+        }
+        // The last queue to reach this point calls func.
+        auto remaining{std::make_shared<std::atomic<size_t>>(queues.size())};
+        auto shared_func{std::make_shared<std::function<void()>>(std::move(func))};
+        for (const auto& queue : queues) {
+            queue->Insert([remaining, shared_func] {
+                if (--*remaining == 0) (*shared_func)();
+            });
+        }
+    }
+
+    void Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_task_runner) return m_task_runner->flush();
+        for (const auto& queue : WITH_LOCK(m_mutex, return Queues())) queue->Flush();
+    }
+
+    size_t Pending() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_task_runner) return m_task_runner->size();
+        size_t pending{0};
+        for (const auto& queue : WITH_LOCK(m_mutex, return Queues())) pending = std::max(pending, queue->Size());
+        return pending;
+    }
 };
 
 ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner)
     : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner))} {}
 
+ValidationSignals::ValidationSignals(std::function<void(std::function<void()>)> schedule)
+    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(schedule))} {}
+
 ValidationSignals::~ValidationSignals() = default;
 
 void ValidationSignals::FlushBackgroundCallbacks()
 {
-    m_internals->m_task_runner->flush();
+    m_internals->Flush();
 }
 
 size_t ValidationSignals::CallbacksPending()
 {
-    return m_internals->m_task_runner->size();
+    return m_internals->Pending();
 }
 
 void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
 {
     // Each connection captures the shared_ptr to ensure that each callback is
     // executed before the subscriber is destroyed. For more details see #18338.
-    m_internals->Register(std::move(callbacks));
+    const std::string name{callbacks->SubscriberName()};
+    m_internals->Register(std::move(callbacks), name);
 }
 
 void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks)
@@ -137,7 +324,7 @@ void ValidationSignals::UnregisterAllValidationInterfaces()
 
 void ValidationSignals::CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    m_internals->m_task_runner->insert(std::move(func));
+    m_internals->CallFunction(std::move(func));
 }
 
 void ValidationSignals::SyncWithValidationInterfaceQueue()
@@ -159,10 +346,9 @@ void ValidationSignals::SyncWithValidationInterfaceQueue()
     do {                                                       \
         auto local_name = (name);                              \
         LOG_EVENT("Enqueuing " fmt, local_name, __VA_ARGS__);  \
-        m_internals->m_task_runner->insert([=] { \
+        m_internals->Enqueue([=] {                             \
             LOG_EVENT(fmt, local_name, __VA_ARGS__);           \
-            event();                                           \
-        });                                                    \
+        }, event);                                             \
     } while (0)
 
 #define LOG_EVENT(fmt, ...) \
@@ -173,8 +359,8 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    auto event = [pindexNew, pindexFork, fInitialDownload](CValidationInterface& callbacks) {
+        callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: new block hash=%s fork block hash=%s (in IBD=%s)", __func__,
                           pindexNew->GetBlockHash().ToString(),
@@ -190,8 +376,8 @@ void ValidationSignals::ActiveTipChange(const CBlockIndex& new_tip, bool is_ibd)
 
 void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
 {
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
+    auto event = [tx, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionAddedToMempool(tx, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
                           tx.info.m_tx->GetHash().ToString(),
@@ -199,8 +385,8 @@ void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInf
 }
 
 void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
+    auto event = [tx, reason, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s reason=%s", __func__,
                           tx->GetHash().ToString(),
@@ -209,8 +395,8 @@ void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx,
 }
 
 void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex) {
-    auto event = [role, pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
+    auto event = [role, pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockConnected(role, pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -219,8 +405,8 @@ void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_pt
 
 void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
 {
-    auto event = [txs_removed_for_block, nBlockHeight, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight); });
+    auto event = [txs_removed_for_block, nBlockHeight](CValidationInterface& callbacks) {
+        callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block height=%s txs removed=%s", __func__,
                           nBlockHeight,
@@ -229,8 +415,8 @@ void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<Rem
 
 void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex)
 {
-    auto event = [pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
+    auto event = [pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockDisconnected(pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -238,8 +424,8 @@ void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& p
 }
 
 void ValidationSignals::ChainStateFlushed(ChainstateRole role, const CBlockLocator &locator) {
-    auto event = [role, locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
+    auto event = [role, locator](CValidationInterface& callbacks) {
+        callbacks.ChainStateFlushed(role, locator);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
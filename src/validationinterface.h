@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace util {
@@ -156,10 +157,19 @@ protected:
      * has been received and connected to the headers tree, though not validated yet.
      */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
+    /**
+     * Name of the subscriber, labelling the metrics of its queue of
+     * notifications. Subscribers of the same kind may share a name.
+     */
+    virtual std::string SubscriberName() const { return "other"; }
     friend class ValidationSignals;
     friend class ValidationInterfaceTest;
 };
 
+/** Default for -validationcallbackthreads, delivering notifications in series on the scheduler thread. */
+static constexpr int DEFAULT_VALIDATION_CALLBACK_THREADS{0};
+static constexpr int MAX_VALIDATION_CALLBACK_THREADS{16};
+
 class ValidationSignalsImpl;
 class ValidationSignals {
 private:
@@ -171,6 +181,18 @@ public:
     // dispatches a single validation event to all subscribers sequentially.
     explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner);
 
+    /**
+     * Give each subscriber its own queue of notifications, so that a slow
+     * subscriber does not delay the others. The queue of a subscriber is
+     * processed in order, one notification at a time, by tasks passed to
+     * `schedule`, which may run the tasks of different queues concurrently.
+     *
+     * FlushBackgroundCallbacks() must only be called once the tasks passed to
+     * `schedule` are not run anymore. CallbacksPending() is the length of the
+     * longest queue.
+     */
+    explicit ValidationSignals(std::function<void(std::function<void()>)> schedule);
+
     ~ValidationSignals();
 
     /** Call any remaining callbacks on the calling thread */
@@ -176,6 +176,8 @@ struct CoinSelectionParams {
     bool m_include_unsafe_inputs = false;
     /** The maximum weight for this transaction. */
     std::optional<int> m_max_tx_weight{std::nullopt};
+    /** When true, BnB and CoinGrinder may run on a helper thread, concurrently with the other algorithms, for large pools. */
+    bool m_parallel_selection = true;
 
     CoinSelectionParams(FastRandomContext& rng_fast, int change_output_size, int change_spend_size,
                         CAmount min_change_target, CFeeRate effective_feerate,
@@ -21,6 +21,7 @@ class Wallet;
 
 namespace wallet {
 class CWallet;
+class WalletNotificationsDispatcher;
 using LoadWalletFn = std::function<void(std::unique_ptr<interfaces::Wallet> wallet)>;
 
 //! WalletContext struct containing references to state shared between CWallet
@@ -42,6 +43,9 @@ struct WalletContext {
     Mutex wallets_mutex;
     std::vector<std::shared_ptr<CWallet>> wallets GUARDED_BY(wallets_mutex);
     std::list<LoadWalletFn> wallet_load_fns GUARDED_BY(wallets_mutex);
+    //! Shared chain notification subscription of the wallets, created when the
+    //! first wallet is attached to the chain.
+    std::shared_ptr<WalletNotificationsDispatcher> notifications_dispatcher GUARDED_BY(wallets_mutex);
 
     //! Declare default constructor and destructor that are not inline, so code
     //! instantiating the WalletContext struct doesn't need to #include class
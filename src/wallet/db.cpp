@@ -154,6 +154,8 @@ void ReadDatabaseArgs(const ArgsManager& args, DatabaseOptions& options)
 {
     // Override current options with args values, if any were specified
     options.use_unsafe_sync = args.GetBoolArg("-unsafesqlitesync", options.use_unsafe_sync);
+    options.use_wal = args.GetBoolArg("-sqlitewal", options.use_wal);
+    options.use_normal_sync = args.GetBoolArg("-sqlitenormalsync", options.use_normal_sync);
 }
 
 } // namespace wallet
@@ -497,6 +497,11 @@ public:
         return result;
     }
     unsigned int getConfirmTarget() override { return m_wallet->m_confirm_target; }
+    size_t getMemoryUsage() override
+    {
+        LOCK(m_wallet->cs_wallet);
+        return m_wallet->DynamicMemoryUsage();
+    }
     bool hdEnabled() override { return m_wallet->IsHDEnabled(); }
     bool canGetAddresses() override { return m_wallet->CanGetAddresses(); }
     bool hasExternalSigner() override { return m_wallet->IsWalletFlagSet(WALLET_FLAG_EXTERNAL_SIGNER); }
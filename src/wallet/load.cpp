@@ -168,7 +168,7 @@ void StartWallets(WalletContext& context)
         pwallet->postInitProcess();
     }
 
-    context.scheduler->scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min);
+    context.scheduler->scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min, CScheduler::TaskClass::BACKGROUND);
 }
 
 void UnloadWallets(WalletContext& context)
@@ -255,8 +255,11 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse)
     bool allow_used_addresses = !avoid_reuse || !wallet.IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE);
     {
         LOCK(wallet.cs_wallet);
+        if (auto cached{wallet.GetCachedBalance(min_depth, avoid_reuse)}) return *cached;
         std::set<Txid> trusted_parents;
-        for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
+        const auto& txos{wallet.GetTXOs()};
+        for (const COutPoint& outpoint : wallet.GetUnspentTXOs()) {
+            const WalletTXO& txo{txos.at(outpoint)};
             const CWalletTx& wtx = txo.GetWalletTx();
 
             const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
@@ -282,6 +285,7 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse)
                 }
             }
         }
+        wallet.SetCachedBalance(min_depth, avoid_reuse, ret);
     }
     return ret;
 }
@@ -497,13 +497,26 @@ RPCHelpMan listtransactions()
 
         const CWallet::TxItems & txOrdered = pwallet->wtxOrdered;
 
+        // Number of entries skipped without being added to ret: the transactions
+        // whose entries are all skipped are listed without the details of
+        // WalletTxToJSON, which are the costliest part, only to count them.
+        int num_skipped{0};
         // iterate backwards until we have nCount items to return:
         for (CWallet::TxItems::const_reverse_iterator it = txOrdered.rbegin(); it != txOrdered.rend(); ++it)
         {
             CWalletTx *const pwtx = (*it).second;
+            if (ret.empty() && num_skipped < nFrom) {
+                std::vector<UniValue> entries;
+                ListTransactions(*pwallet, *pwtx, 0, /*fLong=*/false, entries, filter, filter_label);
+                if (num_skipped + (int)entries.size() <= nFrom) {
+                    num_skipped += entries.size();
+                    continue;
+                }
+            }
             ListTransactions(*pwallet, *pwtx, 0, true, ret, filter, filter_label);
-            if ((int)ret.size() >= (nCount+nFrom)) break;
+            if (num_skipped + (int)ret.size() >= (nCount+nFrom)) break;
         }
+        nFrom -= num_skipped;
     }
 
     // ret is newest to oldest
@@ -620,8 +633,13 @@ RPCHelpMan listsinceblock()
 
     UniValue transactions(UniValue::VARR);
 
-    for (const auto& [_, tx] : wallet.mapWallet) {
-
+    // Only the transactions confirmed or conflicted above height, or in no
+    // block, can be less than depth deep: skip the others using the index of
+    // the wallet transactions by height, so that the cost of polling grows
+    // with the number of new transactions rather than with the wallet.
+    const auto& txs_by_height{wallet.m_txs_by_height};
+    for (auto it{height ? txs_by_height.upper_bound(*height) : txs_by_height.begin()}; it != txs_by_height.end(); ++it) {
+        const CWalletTx& tx{*it->second};
         if (depth == -1 || abs(wallet.GetTxDepthInMainChain(tx)) < depth) {
             ListTransactions(wallet, tx, 0, true, transactions, filter, filter_label, include_change);
         }
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/system.h>
 #include <hash.h>
 #include <key_io.h>
 #include <logging.h>
@@ -16,9 +17,11 @@
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/time.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <future>
 #include <optional>
 
 using common::PSBTError;
@@ -575,47 +578,80 @@ std::optional<MigrationData> LegacyDataSPKM::MigrateToDescriptor()
     }
 
     // keyids is now all non-HD keys. Each key will have its own combo descriptor
-    for (const CKeyID& keyid : keyids) {
+    struct KeyToMigrate {
         CKey key;
-        if (!GetKey(keyid, key)) {
-            assert(false);
-        }
+        uint64_t creation_time{0};
+        std::string origin_str;
+        CPubKey pubkey;
+        std::unique_ptr<Descriptor> descriptor;
+    };
+    // Computing the public keys of the combo descriptors is most of the cost of migrating
+    // non-HD keys, and does not touch the wallet, so large wallets do it on several threads.
+    // The keys are migrated in chunks, not to keep all of them decrypted at once.
+    const int threads{keyids.size() >= MIN_PARALLEL_MIGRATION_KEYS ? std::min(GetNumCores(), MAX_TOPUP_THREADS) : 0};
+    ThreadPool pool{"migrate"};
+    pool.Start(threads);
+    std::vector<KeyToMigrate> keys_to_migrate;
+    for (auto chunk_begin{keyids.begin()}; chunk_begin != keyids.end();) {
+        keys_to_migrate.clear();
+        for (; chunk_begin != keyids.end() && keys_to_migrate.size() < MIGRATION_KEYS_CHUNK_SIZE; ++chunk_begin) {
+            const CKeyID& keyid{*chunk_begin};
+            KeyToMigrate& to_migrate{keys_to_migrate.emplace_back()};
+            if (!GetKey(keyid, to_migrate.key)) {
+                assert(false);
+            }
 
-        // Get birthdate from key meta
-        uint64_t creation_time = 0;
-        const auto& it = mapKeyMetadata.find(keyid);
-        if (it != mapKeyMetadata.end()) {
-            creation_time = it->second.nCreateTime;
+            // Get birthdate from key meta
+            const auto& it = mapKeyMetadata.find(keyid);
+            if (it != mapKeyMetadata.end()) {
+                to_migrate.creation_time = it->second.nCreateTime;
+            }
+
+            // Get the key origin
+            // Maybe this doesn't matter because floating keys here shouldn't have origins
+            KeyOriginInfo info;
+            bool has_info = GetKeyOrigin(keyid, info);
+            to_migrate.origin_str = has_info ? "[" + HexStr(info.fingerprint) + FormatHDKeypath(info.path) + "]" : "";
+        }
+
+        // Construct the combo descriptors
+        const size_t num_tasks{size_t(std::max(threads, 1))};
+        std::vector<std::future<void>> futures;
+        for (size_t task = 0; task < num_tasks; ++task) {
+            futures.push_back(pool.Submit([&, task] {
+                for (size_t j = task; j < keys_to_migrate.size(); j += num_tasks) {
+                    KeyToMigrate& to_migrate{keys_to_migrate[j]};
+                    to_migrate.pubkey = to_migrate.key.GetPubKey();
+                    std::string desc_str = "combo(" + to_migrate.origin_str + HexStr(to_migrate.pubkey) + ")";
+                    FlatSigningProvider keys;
+                    std::string error;
+                    std::vector<std::unique_ptr<Descriptor>> descs = Parse(desc_str, keys, error, false);
+                    CHECK_NONFATAL(descs.size() == 1); // It shouldn't be possible to have an invalid or multipath descriptor
+                    to_migrate.descriptor = std::move(descs.at(0));
+                }
+            }));
         }
+        for (auto& future : futures) future.wait();
+        for (auto& future : futures) future.get();
 
-        // Get the key origin
-        // Maybe this doesn't matter because floating keys here shouldn't have origins
-        KeyOriginInfo info;
-        bool has_info = GetKeyOrigin(keyid, info);
-        std::string origin_str = has_info ? "[" + HexStr(info.fingerprint) + FormatHDKeypath(info.path) + "]" : "";
+        for (KeyToMigrate& to_migrate : keys_to_migrate) {
+            WalletDescriptor w_desc(std::move(to_migrate.descriptor), to_migrate.creation_time, 0, 0, 0);
 
-        // Construct the combo descriptor
-        std::string desc_str = "combo(" + origin_str + HexStr(key.GetPubKey()) + ")";
-        FlatSigningProvider keys;
-        std::string error;
-        std::vector<std::unique_ptr<Descriptor>> descs = Parse(desc_str, keys, error, false);
-        CHECK_NONFATAL(descs.size() == 1); // It shouldn't be possible to have an invalid or multipath descriptor
-        WalletDescriptor w_desc(std::move(descs.at(0)), creation_time, 0, 0, 0);
+            // Make the DescriptorScriptPubKeyMan and get the scriptPubKeys
+            auto desc_spk_man = std::make_unique<DescriptorScriptPubKeyMan>(m_storage, w_desc, /*keypool_size=*/0);
+            WITH_LOCK(desc_spk_man->cs_desc_man, desc_spk_man->AddDescriptorKeyWithDB(batch, to_migrate.key, to_migrate.pubkey));
+            desc_spk_man->TopUpWithDB(batch);
+            auto desc_spks = desc_spk_man->GetScriptPubKeys();
 
-        // Make the DescriptorScriptPubKeyMan and get the scriptPubKeys
-        auto desc_spk_man = std::make_unique<DescriptorScriptPubKeyMan>(m_storage, w_desc, /*keypool_size=*/0);
-        WITH_LOCK(desc_spk_man->cs_desc_man, desc_spk_man->AddDescriptorKeyWithDB(batch, key, key.GetPubKey()));
-        desc_spk_man->TopUpWithDB(batch);
-        auto desc_spks = desc_spk_man->GetScriptPubKeys();
+            // Remove the scriptPubKeys from our current set
+            for (const CScript& spk : desc_spks) {
+                size_t erased = spks.erase(spk);
+                assert(erased == 1);
+                assert(IsMine(spk) == ISMINE_SPENDABLE);
+            }
 
-        // Remove the scriptPubKeys from our current set
-        for (const CScript& spk : desc_spks) {
-            size_t erased = spks.erase(spk);
-            assert(erased == 1);
-            assert(IsMine(spk) == ISMINE_SPENDABLE);
+            out.desc_spkms.push_back(std::move(desc_spk_man));
         }
-
-        out.desc_spkms.push_back(std::move(desc_spk_man));
     }
 
     // Handle HD keys by using the CHDChains
@@ -946,20 +982,41 @@ std::map<CKeyID, CKey> DescriptorScriptPubKeyMan::GetKeys() const
     AssertLockHeld(cs_desc_man);
     if (m_storage.HasEncryptionKeys() && !m_storage.IsLocked()) {
         KeyMap keys;
-        for (const auto& key_pair : m_map_crypted_keys) {
-            const CPubKey& pubkey = key_pair.second.first;
-            const std::vector<unsigned char>& crypted_secret = key_pair.second.second;
+        for (auto it = m_map_crypted_keys.begin(); it != m_map_crypted_keys.end(); ++it) {
             CKey key;
-            m_storage.WithEncryptionKey([&](const CKeyingMaterial& encryption_key) {
-                return DecryptKey(encryption_key, crypted_secret, pubkey, key);
-            });
-            keys[pubkey.GetID()] = key;
+            GetDecryptedKey(it, key);
+            keys[it->first] = key;
         }
         return keys;
     }
     return m_map_keys;
 }
 
+bool DescriptorScriptPubKeyMan::GetDecryptedKey(CryptedKeyMap::const_iterator it, CKey& key) const
+{
+    AssertLockHeld(cs_desc_man);
+    if (const auto cached{m_decrypted_keys.find(it->first)}; cached != m_decrypted_keys.end()) {
+        key = cached->second;
+        return true;
+    }
+    const auto& [pubkey, crypted_secret] = it->second;
+    if (!m_storage.WithEncryptionKey([&](const CKeyingMaterial& encryption_key) {
+            return DecryptKey(encryption_key, crypted_secret, pubkey, key);
+        })) {
+        return false;
+    }
+    // Lock() clears the cache under cs_desc_man after clearing the master
+    // key, so no key decrypted with it outlives the unlock.
+    if (m_decrypted_keys.size() < MAX_DECRYPTED_KEYS) m_decrypted_keys.emplace(it->first, key);
+    return true;
+}
+
+void DescriptorScriptPubKeyMan::ClearDecryptedKeys()
+{
+    LOCK(cs_desc_man);
+    m_decrypted_keys.clear();
+}
+
 bool DescriptorScriptPubKeyMan::HasPrivKey(const CKeyID& keyid) const
 {
     AssertLockHeld(cs_desc_man);
@@ -974,11 +1031,8 @@ std::optional<CKey> DescriptorScriptPubKeyMan::GetKey(const CKeyID& keyid) const
         if (it == m_map_crypted_keys.end()) {
             return std::nullopt;
         }
-        const std::vector<unsigned char>& crypted_secret = it->second.second;
         CKey key;
-        if (!Assume(m_storage.WithEncryptionKey([&](const CKeyingMaterial& encryption_key) {
-            return DecryptKey(encryption_key, crypted_secret, it->second.first, key);
-        }))) {
+        if (!Assume(GetDecryptedKey(it, key))) {
             return std::nullopt;
         }
         return key;
@@ -1023,36 +1077,78 @@ bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int siz
     FlatSigningProvider provider;
     provider.keys = GetKeys();
 
-    uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        DescriptorCache temp_cache;
+    struct Expansion {
+        bool ok{false};
+        std::vector<CScript> scripts;
+        FlatSigningProvider keys;
+        DescriptorCache cache;
+    };
+    // Expanding only reads the descriptor and the cache, so several indexes can be expanded at once.
+    const Descriptor& descriptor{*m_wallet_descriptor.descriptor};
+    const DescriptorCache& read_cache{m_wallet_descriptor.cache};
+    const auto expand{[&](int32_t i, Expansion& exp) {
         // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and its private key
-                continue;
+        exp.ok = descriptor.ExpandFromCache(i, read_cache, exp.scripts, exp.keys) ||
+                 descriptor.Expand(i, provider, exp.scripts, exp.keys, &exp.cache);
+    }};
+
+    uint256 id = GetID();
+    DescriptorCache new_items;
+    bool success{true};
+    bool first_batch{true};
+    while (success && m_max_cached_index + 1 < new_range_end) {
+        // The first new index is expanded on its own, as it may add the xpubs that the others
+        // are derived from to the cache. The rest of the range is then expanded in parallel.
+        const int32_t first{m_max_cached_index + 1};
+        const int32_t count{first_batch ? 1 : new_range_end - first};
+        first_batch = false;
+        std::vector<Expansion> expansions(count);
+        const int threads{count >= MIN_PARALLEL_TOPUP_SIZE ? std::min(GetNumCores(), MAX_TOPUP_THREADS) : 1};
+        if (threads > 1) {
+            ThreadPool pool{"topup"};
+            pool.Start(threads);
+            std::vector<std::future<void>> futures;
+            for (int task = 0; task < threads; ++task) {
+                futures.push_back(pool.Submit([&, task] {
+                    for (int32_t j = task; j < count; j += threads) expand(first + j, expansions[j]);
+                }));
             }
-            m_map_pubkeys[pubkey] = i;
+            for (auto& future : futures) future.wait();
+            for (auto& future : futures) future.get();
+        } else {
+            for (int32_t j = 0; j < count; ++j) expand(first + j, expansions[j]);
         }
-        // Merge and write the cache
-        DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
-        if (!batch.WriteDescriptorCacheItems(id, new_items)) {
-            throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+
+        for (int32_t j = 0; j < count; ++j) {
+            const Expansion& exp{expansions[j]};
+            const int32_t i{first + j};
+            if (!exp.ok) {
+                success = false;
+                break;
+            }
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(exp.scripts.begin(), exp.scripts.end());
+            for (const CScript& script : exp.scripts) {
+                m_map_script_pub_keys[script] = i;
+            }
+            for (const auto& pk_pair : exp.keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and its private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
+            }
+            // Merge the cache, and collect the new items to write them all at once
+            new_items.MergeAndDiff(m_wallet_descriptor.cache.MergeAndDiff(exp.cache));
+            m_max_cached_index++;
         }
-        m_max_cached_index++;
     }
+    if (!batch.WriteDescriptorCacheItems(id, new_items)) {
+        throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+    }
+    if (!success) return false;
     m_wallet_descriptor.range_end = new_range_end;
     batch.WriteDescriptor(GetID(), m_wallet_descriptor);
 
@@ -1308,12 +1404,16 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
     if (n_signed) {
         *n_signed = 0;
     }
-    for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
+    // Inputs are signed independently of each other, several at a time for
+    // large PSBTs. The result of each input is examined in order afterwards,
+    // with std::nullopt for the inputs that were skipped.
+    std::vector<std::optional<PSBTError>> results(psbtx.inputs.size());
+    ForEachPSBTInput(psbtx, [&](unsigned int i) {
         const CTxIn& txin = psbtx.tx->vin[i];
         PSBTInput& input = psbtx.inputs.at(i);
 
         if (PSBTInputSigned(input)) {
-            continue;
+            return;
         }
 
         // Get the scriptPubKey to know which SigningProvider to use
@@ -1322,12 +1422,13 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
             script = input.witness_utxo.scriptPubKey;
         } else if (input.non_witness_utxo) {
             if (txin.prevout.n >= input.non_witness_utxo->vout.size()) {
-                return PSBTError::MISSING_INPUTS;
+                results[i] = PSBTError::MISSING_INPUTS;
+                return;
             }
             script = input.non_witness_utxo->vout[txin.prevout.n].scriptPubKey;
         } else {
             // There's no UTXO so we can just skip this now
-            continue;
+            return;
         }
 
         std::unique_ptr<FlatSigningProvider> keys = std::make_unique<FlatSigningProvider>();
@@ -1373,12 +1474,18 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
             }
         }
 
-        PSBTError res = SignPSBTInput(HidingSigningProvider(keys.get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs), psbtx, i, &txdata, sighash_type, nullptr, finalize);
-        if (res != PSBTError::OK && res != PSBTError::INCOMPLETE) {
-            return res;
+        results[i] = SignPSBTInput(HidingSigningProvider(keys.get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs), psbtx, i, &txdata, sighash_type, nullptr, finalize);
+    });
+
+    for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
+        if (!results[i]) {
+            continue;
+        }
+        if (*results[i] != PSBTError::OK && *results[i] != PSBTError::INCOMPLETE) {
+            return *results[i];
         }
 
-        bool signed_one = PSBTInputSigned(input);
+        bool signed_one = PSBTInputSigned(psbtx.inputs.at(i));
         if (n_signed && (signed_one || !sign)) {
             // If sign is false, we assume that we _could_ sign if we get here. This
             // will never have false negatives; it is hard to tell under what i
@@ -63,6 +63,17 @@ static constexpr int64_t UNKNOWN_TIME = std::numeric_limits<int64_t>::max();
 //! Default for -keypool
 static const unsigned int DEFAULT_KEYPOOL_SIZE = 1000;
 
+//! Number of new descriptor indexes from which TopUp expands them on several threads
+static constexpr int32_t MIN_PARALLEL_TOPUP_SIZE{64};
+//! Maximum number of threads TopUp expands descriptor indexes on
+static constexpr int MAX_TOPUP_THREADS{16};
+//! Number of non-HD keys from which migration derives their descriptors on several threads
+static constexpr size_t MIN_PARALLEL_MIGRATION_KEYS{64};
+//! Number of non-HD keys migration keeps decrypted at once
+static constexpr size_t MIGRATION_KEYS_CHUNK_SIZE{4096};
+//! Maximum number of private keys of a descriptor kept decrypted while the wallet is unlocked
+static constexpr size_t MAX_DECRYPTED_KEYS{1000};
+
 std::vector<CKeyID> GetAffectedKeys(const CScript& spk, const SigningProvider& provider);
 
 struct WalletDestination
@@ -91,6 +102,8 @@ public:
 
     //! Check that the given decryption key is valid for this ScriptPubKeyMan, i.e. it decrypts all of the keys handled by it.
     virtual bool CheckDecryptionKey(const CKeyingMaterial& master_key) { return false; }
+    //! Forget the private keys kept decrypted since the wallet was unlocked, as it is locked again.
+    virtual void ClearDecryptedKeys() {}
     virtual bool Encrypt(const CKeyingMaterial& master_key, WalletBatch* batch) { return false; }
 
     virtual util::Result<CTxDestination> GetReservedDestination(const OutputType type, bool internal, int64_t& index) { return util::Error{Untranslated("Not supported")}; }
@@ -291,6 +304,10 @@ private:
 
     KeyMap m_map_keys GUARDED_BY(cs_desc_man);
     CryptedKeyMap m_map_crypted_keys GUARDED_BY(cs_desc_man);
+    //! Keys of m_map_crypted_keys decrypted since the wallet was unlocked, so
+    //! signing does not decrypt and verify them again for every input. CKey
+    //! keeps them in locked memory. Bounded by MAX_DECRYPTED_KEYS.
+    mutable KeyMap m_decrypted_keys GUARDED_BY(cs_desc_man);
 
     //! keeps track of whether Unlock has run a thorough check before
     bool m_decryption_thoroughly_checked = false;
@@ -301,6 +318,8 @@ private:
     bool AddDescriptorKeyWithDB(WalletBatch& batch, const CKey& key, const CPubKey &pubkey) EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man);
 
     KeyMap GetKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man);
+    //! Decrypt the key of m_map_crypted_keys, or get it from m_decrypted_keys. The wallet must be unlocked.
+    bool GetDecryptedKey(CryptedKeyMap::const_iterator it, CKey& key) const EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man);
 
     // Cached FlatSigningProviders to avoid regenerating them each time they are needed.
     mutable std::map<int32_t, FlatSigningProvider> m_map_signing_providers;
@@ -332,6 +351,7 @@ public:
     isminetype IsMine(const CScript& script) const override;
 
     bool CheckDecryptionKey(const CKeyingMaterial& master_key) override;
+    void ClearDecryptedKeys() override;
     bool Encrypt(const CKeyingMaterial& master_key, WalletBatch* batch) override;
 
     util::Result<CTxDestination> GetReservedDestination(const OutputType type, bool internal, int64_t& index) override;
@@ -20,6 +20,7 @@
 #include <util/moneystr.h>
 #include <util/rbf.h>
 #include <util/trace.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <util/transaction_identifier.h>
 #include <wallet/coincontrol.h>
@@ -30,6 +31,7 @@
 #include <wallet/wallet.h>
 
 #include <cmath>
+#include <future>
 
 using common::StringForFeeReason;
 using common::TransactionErrorString;
@@ -328,7 +330,9 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     std::set<Txid> trusted_parents;
     // Cache for whether each tx passes the tx level checks (first bool), and whether the transaction is "safe" (second bool)
     std::unordered_map<uint256, std::pair<bool, bool>, SaltedTxidHasher> tx_safe_cache;
-    for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
+    const auto& txos{wallet.GetTXOs()};
+    for (const COutPoint& outpoint : wallet.GetUnspentTXOs()) {
+        const WalletTXO& txo{txos.at(outpoint)};
         const CWalletTx& wtx = txo.GetWalletTx();
         const CTxOut& output = txo.GetTxOut();
 
@@ -713,37 +717,65 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
     }
 
     // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
-    if (!coin_selection_params.m_subtract_fee_outputs) {
-        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight)}) {
-            results.push_back(*bnb_result);
-        } else append_error(std::move(bnb_result));
-    }
+    const bool use_bnb{!coin_selection_params.m_subtract_fee_outputs};
+    // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
+    const bool use_cg{coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}};
 
     // Deduct change weight because remaining Coin Selection algorithms can create change output
-    int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
-    max_selection_weight -= change_outputs_weight;
-    if (max_selection_weight < 0 && results.empty()) {
-        return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+    const int change_outputs_weight{coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR};
+    const int max_change_selection_weight{max_selection_weight - change_outputs_weight};
+
+    // BnB and CoinGrinder are deterministic, and both sort positive_group, so they run in this
+    // order and must be done before SRD reads positive_group. Knapsack and SRD draw from
+    // rng_fast, so they always run on this thread, in this order. For large pools the former
+    // two can therefore run on a helper thread while Knapsack runs here.
+    std::optional<util::Result<SelectionResult>> bnb_result;
+    std::optional<util::Result<SelectionResult>> cg_result;
+    auto run_bnb = [&] {
+        if (use_bnb) bnb_result.emplace(SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight));
+    };
+    auto run_cg = [&] {
+        if (!use_cg) return;
+        cg_result.emplace(CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_change_selection_weight));
+        if (*cg_result) {
+            (*cg_result)->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+        }
+    };
+
+    ThreadPool pool{"coinselect"};
+    std::future<void> positive_only;
+    if (coin_selection_params.m_parallel_selection && max_change_selection_weight >= 0 && (use_bnb || use_cg) &&
+        groups.positive_group.size() >= MIN_PARALLEL_SELECTION_GROUPS && GetNumCores() > 1) {
+        pool.Start(1);
+        positive_only = pool.Submit([&] { run_bnb(); run_cg(); });
+    } else {
+        run_bnb();
+        if (max_change_selection_weight < 0 && !(bnb_result && *bnb_result)) {
+            return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+        }
     }
 
     // The knapsack solver has some legacy behavior where it will spend dust outputs. We retain this behavior, so don't filter for positive only here.
-    if (auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*knapsack_result);
-    } else append_error(std::move(knapsack_result));
-
-    if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
-        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight)}) {
-            cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
-            results.push_back(*cg_result);
+    auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_change_selection_weight)};
+
+    if (positive_only.valid()) {
+        positive_only.get();
+    } else {
+        run_cg();
+    }
+
+    auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_change_selection_weight)};
+
+    // Collect results and errors in a fixed order, so the choice below does not depend on scheduling
+    for (auto* result : {bnb_result ? &*bnb_result : nullptr, &knapsack_result, cg_result ? &*cg_result : nullptr, &srd_result}) {
+        if (!result) continue;
+        if (*result) {
+            results.push_back(**result);
         } else {
-            append_error(std::move(cg_result));
+            append_error(std::move(*result));
         }
     }
 
-    if (auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*srd_result);
-    } else append_error(std::move(srd_result));
-
     if (results.empty()) {
         // No solution found, retrieve the first explicit error (if any).
         // future: add 'severity level' to errors so the worst one can be retrieved instead of the first one.
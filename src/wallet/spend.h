@@ -20,6 +20,9 @@
 #include <vector>
 
 namespace wallet {
+//! Number of output groups from which ChooseSelectionResult runs BnB and CoinGrinder on a helper thread
+static constexpr size_t MIN_PARALLEL_SELECTION_GROUPS{500};
+
 /** Get the marginal bytes if spending the specified output from this transaction.
  * Use CoinControl to determine whether to expect signature grinding when calculating the size of the input spend. */
 int CalculateMaximumSignedInputSize(const CTxOut& txout, const CWallet* pwallet, const CCoinControl* coin_control);
@@ -18,6 +18,7 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
 #include <utility>
@@ -25,6 +26,8 @@
 
 namespace wallet {
 static constexpr int32_t WALLET_SCHEMA_VERSION = 0;
+//! Number of prepared statement sets a database keeps for reuse by new batches
+static constexpr size_t MAX_CACHED_STATEMENTS = 4;
 
 static std::span<const std::byte> SpanFromBlob(sqlite3_stmt* stmt, int col)
 {
@@ -112,7 +115,8 @@ Mutex SQLiteDatabase::g_sqlite_mutex;
 int SQLiteDatabase::g_sqlite_count = 0;
 
 SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_path, const DatabaseOptions& options, bool mock)
-    : WalletDatabase(), m_mock(mock), m_dir_path(dir_path), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
+    : WalletDatabase(), m_mock(mock), m_dir_path(dir_path), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync),
+      m_use_wal(options.use_wal), m_use_normal_sync(options.use_normal_sync)
 {
     {
         LOCK(g_sqlite_mutex);
@@ -148,6 +152,12 @@ SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_pa
 
 void SQLiteBatch::SetupSQLStatements()
 {
+    // Reuse the statements of a previously closed batch if possible, preparing them is not free
+    if (auto cached{m_database.TakeCachedStatements()}) {
+        for (size_t i = 0; i < cached->size(); ++i) *Statements()[i] = (*cached)[i];
+        return;
+    }
+
     const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
         {&m_read_stmt, "SELECT value FROM main WHERE key = ?"},
         {&m_insert_stmt, "INSERT INTO main VALUES(?, ?)"},
@@ -292,10 +302,20 @@ void SQLiteDatabase::Open()
     // Enable fullfsync for the platforms that use it
     SetPragma(m_db, "fullfsync", "true", "Failed to enable fullfsync");
 
+    // The journal mode is persistent, so set it either way. Because of the exclusive locking
+    // mode, the write-ahead log does not need a shared memory file.
+    if (!m_mock) {
+        SetPragma(m_db, "journal_mode", m_use_wal ? "WAL" : "DELETE", "Failed to set the journal mode");
+    }
+
     if (m_use_unsafe_sync) {
         // Use normal synchronous mode for the journal
         LogPrintf("WARNING SQLite is configured to not wait for data to be flushed to disk. Data loss and corruption may occur.\n");
         SetPragma(m_db, "synchronous", "OFF", "Failed to set synchronous mode to OFF");
+    } else if (m_use_normal_sync) {
+        // With a write-ahead log, commits are then only synced at checkpoints. The most recent
+        // commits may be lost on power failure, but the database is not corrupted.
+        SetPragma(m_db, "synchronous", "NORMAL", "Failed to set synchronous mode to NORMAL");
     }
 
     // Make the table for our key-value pairs
@@ -370,8 +390,36 @@ bool SQLiteDatabase::Backup(const std::string& dest) const
     return res == SQLITE_OK;
 }
 
+void SQLiteDatabase::FinalizeCachedStatements()
+{
+    LOCK(m_statements_mutex);
+    for (const auto& statements : m_cached_statements) {
+        for (sqlite3_stmt* stmt : statements) sqlite3_finalize(stmt);
+    }
+    m_cached_statements.clear();
+}
+
+std::optional<SQLiteStatements> SQLiteDatabase::TakeCachedStatements()
+{
+    LOCK(m_statements_mutex);
+    if (m_cached_statements.empty()) return std::nullopt;
+    SQLiteStatements statements{m_cached_statements.back()};
+    m_cached_statements.pop_back();
+    return statements;
+}
+
+bool SQLiteDatabase::CacheStatements(const SQLiteStatements& statements)
+{
+    LOCK(m_statements_mutex);
+    if (!m_db || m_cached_statements.size() >= MAX_CACHED_STATEMENTS) return false;
+    m_cached_statements.push_back(statements);
+    return true;
+}
+
 void SQLiteDatabase::Close()
 {
+    // Statements must be finalized before the connection can be closed
+    FinalizeCachedStatements();
     int res = sqlite3_close(m_db);
     if (res != SQLITE_OK) {
         throw std::runtime_error(strprintf("SQLiteDatabase: Failed to close database: %s\n", sqlite3_errstr(res)));
@@ -422,7 +470,20 @@ void SQLiteBatch::Close()
         }
     }
 
-    // Free all of the prepared statements
+    // Hand the prepared statements to the database for reuse, unless the connection is reset
+    if (!force_conn_refresh && m_database.m_db && std::ranges::all_of(Statements(), [](sqlite3_stmt** stmt) { return *stmt != nullptr; })) {
+        SQLiteStatements statements;
+        for (size_t i = 0; i < statements.size(); ++i) {
+            statements[i] = *Statements()[i];
+            sqlite3_clear_bindings(statements[i]);
+            sqlite3_reset(statements[i]);
+        }
+        if (m_database.CacheStatements(statements)) {
+            for (sqlite3_stmt** stmt : Statements()) *stmt = nullptr;
+        }
+    }
+
+    // Free all of the prepared statements that were not handed over
     const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
         {&m_read_stmt, "read"},
         {&m_insert_stmt, "insert"},
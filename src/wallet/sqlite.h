@@ -8,7 +8,11 @@
 #include <sync.h>
 #include <wallet/db.h>
 
+#include <array>
+#include <optional>
 #include <semaphore>
+#include <tuple>
+#include <vector>
 
 struct bilingual_str;
 
@@ -18,6 +22,9 @@ struct sqlite3;
 namespace wallet {
 class SQLiteDatabase;
 
+//! The prepared statements of a SQLiteBatch: read, insert, overwrite, delete and delete prefix
+using SQLiteStatements = std::array<sqlite3_stmt*, 5>;
+
 /** RAII class that provides a database cursor */
 class SQLiteCursor : public DatabaseCursor
 {
@@ -72,6 +79,11 @@ private:
      */
     bool m_txn{false};
 
+    std::array<sqlite3_stmt**, std::tuple_size_v<SQLiteStatements>> Statements()
+    {
+        return {&m_read_stmt, &m_insert_stmt, &m_overwrite_stmt, &m_delete_stmt, &m_delete_prefix_stmt};
+    }
+
     void SetupSQLStatements();
     bool ExecStatement(sqlite3_stmt* stmt, std::span<const std::byte> blob);
 
@@ -119,6 +131,11 @@ private:
 
     void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex);
 
+    /** Prepared statements of closed batches, kept so new batches do not have to prepare them again */
+    Mutex m_statements_mutex;
+    std::vector<SQLiteStatements> m_cached_statements GUARDED_BY(m_statements_mutex);
+    void FinalizeCachedStatements() EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
+
 public:
     SQLiteDatabase() = delete;
 
@@ -153,6 +170,7 @@ public:
         std::vector<fs::path> files;
         files.emplace_back(m_dir_path / fs::PathFromString(m_file_path));
         files.emplace_back(m_dir_path / fs::PathFromString(m_file_path + "-journal"));
+        files.emplace_back(m_dir_path / fs::PathFromString(m_file_path + "-wal"));
         return files;
     }
     std::string Format() override { return "sqlite"; }
@@ -163,8 +181,15 @@ public:
     /** Return true if there is an on-going txn in this connection */
     bool HasActiveTxn();
 
+    /** Take the prepared statements left by a closed batch, if there are any */
+    std::optional<SQLiteStatements> TakeCachedStatements() EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
+    /** Keep the prepared statements of a closed batch for reuse. Returns false if the cache is full. */
+    bool CacheStatements(const SQLiteStatements& statements) EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
+
     sqlite3* m_db{nullptr};
     bool m_use_unsafe_sync;
+    bool m_use_wal;
+    bool m_use_normal_sync;
 };
 
 std::unique_ptr<SQLiteDatabase> MakeSQLiteDatabase(const fs::path& path, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error);
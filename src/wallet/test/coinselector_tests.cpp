@@ -1399,6 +1399,49 @@ BOOST_AUTO_TEST_CASE(SelectCoins_effective_value_test)
     BOOST_CHECK(!result);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_selection_test)
+{
+    // Running BnB and CoinGrinder on a helper thread must not change the selection
+    const CAmount target{75 * COIN};
+    CCoinControl cc;
+    std::vector<CAmount> amounts;
+    FastRandomContext amount_rng{/*fDeterministic=*/true};
+    for (size_t i = 0; i < 2 * MIN_PARALLEL_SELECTION_GROUPS; ++i) {
+        amounts.push_back(CENT + amount_rng.randrange(COIN));
+    }
+    auto select = [&](bool parallel) {
+        FastRandomContext rand{/*fDeterministic=*/true};
+        CoinSelectionParams cs_params{
+            rand,
+            /*change_output_size=*/31,
+            /*change_spend_size=*/68,
+            /*min_change_target=*/CENT,
+            /*effective_feerate=*/CFeeRate(5000),
+            /*long_term_feerate=*/CFeeRate(1000),
+            /*discard_feerate=*/CFeeRate(3000),
+            /*tx_noinputs_size=*/10 + 34, // static header size + output size
+            /*avoid_partial=*/false,
+        };
+        cs_params.m_cost_of_change = cs_params.m_change_fee = cs_params.m_effective_feerate.GetFee(31);
+        cs_params.m_cost_of_change += cs_params.m_discard_feerate.GetFee(68);
+        cs_params.m_parallel_selection = parallel;
+        return select_coins(target, cs_params, cc, [&](CWallet& wallet) {
+            CoinsResult available_coins;
+            for (const CAmount amount : amounts) {
+                add_coin(available_coins, wallet, amount, cs_params.m_effective_feerate, 144, false, 0, true);
+            }
+            return available_coins;
+        }, m_node);
+    };
+    const auto sequential{select(/*parallel=*/false)};
+    const auto parallel{select(/*parallel=*/true)};
+    BOOST_REQUIRE(sequential);
+    BOOST_REQUIRE(parallel);
+    BOOST_CHECK(sequential->GetAlgo() == parallel->GetAlgo());
+    BOOST_CHECK_EQUAL(sequential->GetWaste(), parallel->GetWaste());
+    BOOST_CHECK(EquivalentResult(*sequential, *parallel));
+}
+
 BOOST_FIXTURE_TEST_CASE(wallet_coinsresult_test, BasicTestingSetup)
 {
     // Test case to verify CoinsResult object sanity.
@@ -7,6 +7,7 @@
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/string.h>
 #include <util/translation.h>
 #include <wallet/sqlite.h>
 #include <wallet/migrate.h>
@@ -297,5 +298,35 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK_EQUAL(read_value, value2);
 }
 
+BOOST_AUTO_TEST_CASE(wal_journal_and_statement_reuse)
+{
+    DatabaseOptions options;
+    options.use_wal = true;
+    options.use_normal_sync = true;
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<SQLiteDatabase> database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_REQUIRE(database);
+
+    // Writes through batches reusing the statements of earlier ones end up in the database
+    for (int i = 0; i < 10; ++i) {
+        std::unique_ptr<DatabaseBatch> batch{database->MakeBatch()};
+        BOOST_CHECK(batch->Write(std::string{"key"} + util::ToString(i), i));
+    }
+    const fs::path wal_path{m_path_root / "sqlite" / "wallet.dat-wal"};
+    BOOST_CHECK(fs::exists(wal_path));
+
+    // Closing the database checkpoints the log into the database file and removes it
+    database->Close();
+    BOOST_CHECK(!fs::exists(wal_path));
+    database->Open();
+    std::unique_ptr<DatabaseBatch> batch{database->MakeBatch()};
+    for (int i = 0; i < 10; ++i) {
+        int value{-1};
+        BOOST_CHECK(batch->Read(std::string{"key"} + util::ToString(i), value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
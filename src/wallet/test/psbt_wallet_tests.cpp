@@ -80,6 +80,49 @@ BOOST_AUTO_TEST_CASE(psbt_updater_test)
     BOOST_CHECK(m_wallet.FillPSBT(psbtx, complete, std::nullopt, true, true));
 }
 
+BOOST_AUTO_TEST_CASE(psbt_sign_many_inputs)
+{
+    LOCK(m_wallet.cs_wallet);
+    m_wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    import_descriptor(m_wallet, "wpkh(xprv9s21ZrQH143K2LE7W4Xf3jATf9jECxSb7wj91ZnmY4qEJrS66Qru9RFqq8xbkgT32ya6HqYJweFdJUEDf5Q6JFV7jMiUws7kQfe6Tv4RbfN/0h/0h/*h)");
+    std::vector<CScript> scripts;
+    for (ScriptPubKeyMan* spk_man : m_wallet.GetAllScriptPubKeyMans()) {
+        for (const CScript& script : spk_man->GetScriptPubKeys()) scripts.push_back(script);
+    }
+    BOOST_REQUIRE(!scripts.empty());
+
+    // Enough inputs for them to be signed on several threads, each with a witness UTXO
+    const size_t num_inputs{MIN_PARALLEL_PSBT_INPUTS + 3};
+    CMutableTransaction mtx;
+    for (size_t i = 0; i < num_inputs; ++i) {
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+    }
+    mtx.vout.emplace_back(num_inputs * 9000, scripts[0]);
+    PartiallySignedTransaction psbtx{mtx};
+    for (size_t i = 0; i < num_inputs; ++i) {
+        psbtx.inputs[i].witness_utxo = CTxOut{10000, scripts[i % scripts.size()]};
+    }
+
+    bool complete = false;
+    size_t n_signed = 0;
+    BOOST_REQUIRE(!m_wallet.FillPSBT(psbtx, complete, std::nullopt, /*sign=*/true, /*bip32derivs=*/false, &n_signed));
+    BOOST_CHECK(complete);
+    BOOST_CHECK_EQUAL(n_signed, num_inputs);
+    for (const PSBTInput& input : psbtx.inputs) {
+        BOOST_CHECK(!input.final_script_witness.IsNull());
+    }
+    BOOST_CHECK(FinalizePSBT(psbtx));
+
+    // A PSBT with an input spending an invalid prevout still fails as a whole
+    psbtx = PartiallySignedTransaction{mtx};
+    for (size_t i = 0; i < num_inputs; ++i) {
+        psbtx.inputs[i].witness_utxo = CTxOut{10000, scripts[i % scripts.size()]};
+    }
+    psbtx.inputs[num_inputs / 2].witness_utxo.SetNull();
+    psbtx.inputs[num_inputs / 2].non_witness_utxo = MakeTransactionRef(CMutableTransaction{});
+    BOOST_CHECK(m_wallet.FillPSBT(psbtx, complete, std::nullopt, /*sign=*/true, /*bip32derivs=*/false));
+}
+
 BOOST_AUTO_TEST_CASE(parse_hd_keypath)
 {
     std::vector<uint32_t> keypath;
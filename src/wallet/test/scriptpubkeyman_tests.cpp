@@ -37,5 +37,72 @@ BOOST_AUTO_TEST_CASE(DescriptorScriptPubKeyManTests)
     BOOST_CHECK(signprov_keypath_nums_h == nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(DescriptorScriptPubKeyManTopUp)
+{
+    CWallet keystore(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    CExtKey master;
+    master.SetSeed(GenerateRandomKey());
+    const std::string xprv{EncodeExtKey(master)};
+
+    // One range derived from a cached xpub, and one needing the private key for every index.
+    for (const std::string& desc_str : {"wpkh(" + xprv + "/0h/*)", "wpkh(" + xprv + "/0h/*h)"}) {
+        auto spk_man = CreateDescriptor(keystore, desc_str, true);
+        BOOST_REQUIRE(spk_man != nullptr);
+        const int32_t end_range{spk_man->GetEndRange()};
+        BOOST_CHECK_GE(end_range, MIN_PARALLEL_TOPUP_SIZE);
+        BOOST_CHECK(spk_man->TopUp(end_range + MIN_PARALLEL_TOPUP_SIZE));
+
+        FlatSigningProvider keys;
+        std::string error;
+        const auto descs{Parse(desc_str, keys, error, false)};
+        BOOST_REQUIRE_EQUAL(descs.size(), 1U);
+        const auto spks{spk_man->GetScriptPubKeys()};
+        BOOST_CHECK_EQUAL(spk_man->GetEndRange(), end_range + MIN_PARALLEL_TOPUP_SIZE);
+        BOOST_CHECK_EQUAL(spks.size(), size_t(spk_man->GetEndRange()));
+        for (int32_t i = 0; i < spk_man->GetEndRange(); ++i) {
+            std::vector<CScript> scripts;
+            FlatSigningProvider out;
+            BOOST_REQUIRE(descs[0]->Expand(i, keys, scripts, out));
+            BOOST_CHECK(spks.contains(scripts.at(0)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DescriptorScriptPubKeyManDecryptedKeys)
+{
+    CWallet keystore(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    keystore.SetWalletFlag(WALLET_FLAG_BLANK_WALLET);
+    // Enough descriptors for their keys to be checked on several threads on unlock.
+    std::vector<std::pair<DescriptorScriptPubKeyMan*, CKey>> spk_mans;
+    for (int i = 0; i < 10; ++i) {
+        const CKey key{GenerateRandomKey()};
+        auto spk_man{CreateDescriptor(keystore, "wpkh(" + EncodeSecret(key) + ")", true)};
+        BOOST_REQUIRE(spk_man != nullptr);
+        spk_mans.emplace_back(spk_man, key);
+    }
+    const auto get_key{[](DescriptorScriptPubKeyMan* spk_man, const CKey& key) {
+        LOCK(spk_man->cs_desc_man);
+        return spk_man->GetKey(key.GetPubKey().GetID());
+    }};
+
+    const SecureString passphrase{"passphrase"};
+    BOOST_REQUIRE(keystore.EncryptWallet(passphrase));
+    BOOST_CHECK(keystore.IsLocked());
+    BOOST_CHECK(!keystore.Unlock(SecureString{"wrong"}));
+    for (int round = 0; round < 2; ++round) {
+        BOOST_REQUIRE(keystore.Unlock(passphrase));
+        for (const auto& [spk_man, key] : spk_mans) {
+            // Decrypted the first time, then from the keys kept decrypted.
+            for (int j = 0; j < 2; ++j) {
+                const auto decrypted{get_key(spk_man, key)};
+                BOOST_REQUIRE(decrypted);
+                BOOST_CHECK(*decrypted == key);
+            }
+        }
+        BOOST_REQUIRE(keystore.Lock());
+        for (const auto& [spk_man, key] : spk_mans) BOOST_CHECK(!get_key(spk_man, key));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <future>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include <addresstype.h>
@@ -32,6 +33,8 @@
 #include <boost/test/unit_test.hpp>
 #include <univalue.h>
 
+#include <limits>
+
 using node::MAX_BLOCKFILE_SIZE;
 
 namespace wallet {
@@ -447,6 +450,140 @@ BOOST_FIXTURE_TEST_CASE(ListCoinsTest, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2U);
 }
 
+static void CheckUnspentTXOs(const CWallet& wallet)
+{
+    LOCK(wallet.cs_wallet);
+    std::unordered_set<COutPoint, SaltedOutpointHasher> expected;
+    for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
+        if (!wallet.IsSpent(outpoint)) expected.insert(outpoint);
+    }
+    BOOST_CHECK(wallet.GetUnspentTXOs() == expected);
+}
+
+BOOST_FIXTURE_TEST_CASE(UnspentTXOsTest, ListCoinsTestingSetup)
+{
+    CheckUnspentTXOs(*wallet);
+    BOOST_CHECK_EQUAL(WITH_LOCK(wallet->cs_wallet, return wallet->GetUnspentTXOs().size()), 1U);
+
+    // A confirmed spend replaces the spent coin with its outputs
+    const COutPoint coinbase_out{WITH_LOCK(wallet->cs_wallet, return *wallet->GetUnspentTXOs().begin())};
+    AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    CheckUnspentTXOs(*wallet);
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetUnspentTXOs().contains(coinbase_out)));
+
+    // An unconfirmed spend marks its inputs as spent until it is abandoned
+    CCoinControl dummy;
+    auto res = CreateTransaction(*wallet, {CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false}}, /*change_pos=*/std::nullopt, dummy);
+    BOOST_REQUIRE(res);
+    const CTransactionRef tx{res->tx};
+    BOOST_REQUIRE(wallet->AddToWallet(tx, TxStateInactive{}));
+    CheckUnspentTXOs(*wallet);
+    {
+        LOCK(wallet->cs_wallet);
+        for (const CTxIn& txin : tx->vin) BOOST_CHECK(!wallet->GetUnspentTXOs().contains(txin.prevout));
+    }
+    BOOST_CHECK(wallet->AbandonTransaction(tx->GetHash()));
+    CheckUnspentTXOs(*wallet);
+    {
+        LOCK(wallet->cs_wallet);
+        for (const CTxIn& txin : tx->vin) BOOST_CHECK(wallet->GetUnspentTXOs().contains(txin.prevout));
+    }
+}
+
+static void CheckTxsByHeight(const CWallet& wallet)
+{
+    LOCK(wallet.cs_wallet);
+    BOOST_CHECK_EQUAL(wallet.m_txs_by_height.size(), wallet.mapWallet.size());
+    for (const auto& [height, wtx] : wallet.m_txs_by_height) {
+        BOOST_CHECK_EQUAL(&wallet.mapWallet.at(wtx->GetHash()), wtx);
+        if (auto* conf{wtx->state<TxStateConfirmed>()}) {
+            BOOST_CHECK_EQUAL(height, conf->confirmed_block_height);
+        } else if (auto* conflicted{wtx->state<TxStateBlockConflicted>()}) {
+            BOOST_CHECK_EQUAL(height, conflicted->conflicting_block_height);
+        } else {
+            BOOST_CHECK_EQUAL(height, std::numeric_limits<int>::max());
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(TxsByHeightTest, TestChain100Setup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet = TestLoadWallet(context);
+    CKey key = GenerateRandomKey();
+    AddKey(*wallet, key);
+    CheckTxsByHeight(*wallet);
+
+    // An unconfirmed transaction comes last, then moves to the height of the block confirming it
+    const CMutableTransaction tx{TestSimpleSpend(*m_coinbase_txns[0], 0, coinbaseKey, GetScriptForRawPubKey(key.GetPubKey()))};
+    BOOST_REQUIRE(wallet->AddToWallet(MakeTransactionRef(tx), TxStateInactive{}));
+    CheckTxsByHeight(*wallet);
+    BOOST_CHECK_EQUAL(WITH_LOCK(wallet->cs_wallet, return wallet->m_txs_by_height.count(std::numeric_limits<int>::max())), 1U);
+    const CBlock block{CreateAndProcessBlock({tx}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()))};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    CheckTxsByHeight(*wallet);
+    {
+        LOCK(wallet->cs_wallet);
+        BOOST_REQUIRE_EQUAL(wallet->m_txs_by_height.size(), 1U);
+        BOOST_CHECK_EQUAL(wallet->m_txs_by_height.begin()->first, wallet->GetLastBlockHeight());
+    }
+
+    // Disconnecting the block moves the transaction back to the end
+    BlockValidationState state;
+    CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_REQUIRE_EQUAL(tip->GetBlockHash(), block.GetHash());
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    CheckTxsByHeight(*wallet);
+    BOOST_CHECK_EQUAL(WITH_LOCK(wallet->cs_wallet, return wallet->m_txs_by_height.count(std::numeric_limits<int>::max())), 1U);
+
+    // Removed transactions are removed from the index
+    {
+        LOCK(wallet->cs_wallet);
+        std::vector<Txid> to_remove{tx.GetHash()};
+        BOOST_CHECK(wallet->RemoveTxs(to_remove));
+        BOOST_CHECK(wallet->m_txs_by_height.empty());
+    }
+    CheckTxsByHeight(*wallet);
+
+    TestUnloadWallet(std::move(wallet));
+}
+
+static void CheckBalanceEqual(const Balance& a, const Balance& b)
+{
+    BOOST_CHECK_EQUAL(a.m_mine_trusted, b.m_mine_trusted);
+    BOOST_CHECK_EQUAL(a.m_mine_untrusted_pending, b.m_mine_untrusted_pending);
+    BOOST_CHECK_EQUAL(a.m_mine_immature, b.m_mine_immature);
+}
+
+BOOST_FIXTURE_TEST_CASE(BalanceCacheTest, ListCoinsTestingSetup)
+{
+    const Balance initial{GetBalance(*wallet)};
+    BOOST_CHECK_EQUAL(initial.m_mine_trusted, 50 * COIN);
+    BOOST_CHECK(WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/0, /*avoid_reuse=*/true).has_value()));
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/1, /*avoid_reuse=*/true).has_value()));
+
+    // Spending and confirming a coin invalidates the cached balance
+    AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    const Balance spent{GetBalance(*wallet)};
+    BOOST_CHECK_LT(spent.m_mine_trusted, initial.m_mine_trusted - 1 * COIN);
+    wallet->MarkDirty();
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/0, /*avoid_reuse=*/true).has_value()));
+    CheckBalanceEqual(spent, GetBalance(*wallet));
+
+    // A new block changes depths, so maturity and trust must be recomputed
+    CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    const Balance mined{GetBalance(*wallet)};
+    BOOST_CHECK_EQUAL(mined.m_mine_immature, spent.m_mine_immature + 50 * COIN);
+    wallet->MarkDirty();
+    CheckBalanceEqual(mined, GetBalance(*wallet));
+}
+
 void TestCoinsResult(ListCoinsTest& context, OutputType out_type, CAmount amount,
                      std::map<OutputType, size_t>& expected_coins_sizes)
 {
@@ -687,6 +824,50 @@ BOOST_FIXTURE_TEST_CASE(CreateWalletWithoutChain, BasicTestingSetup)
     WaitForDeleteWallet(std::move(wallet));
 }
 
+//! Check wallets sharing a chain each receive their own transactions through the
+//! shared notification subscription, including after one of them is unloaded.
+BOOST_FIXTURE_TEST_CASE(SharedChainNotifications, TestChain100Setup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet_a = TestLoadWallet(context);
+    auto wallet_b = TestLoadWallet(context);
+    CKey key_a = GenerateRandomKey();
+    CKey key_b = GenerateRandomKey();
+    AddKey(*wallet_a, key_a);
+    AddKey(*wallet_b, key_b);
+    {
+        LOCK(context.wallets_mutex);
+        BOOST_CHECK(context.notifications_dispatcher);
+    }
+
+    const Txid coinbase_a{CreateAndProcessBlock({}, GetScriptForRawPubKey(key_a.GetPubKey())).vtx[0]->GetHash()};
+    const Txid coinbase_b{CreateAndProcessBlock({}, GetScriptForRawPubKey(key_b.GetPubKey())).vtx[0]->GetHash()};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    const uint256 tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash())};
+    {
+        LOCK2(wallet_a->cs_wallet, wallet_b->cs_wallet);
+        BOOST_CHECK_EQUAL(wallet_a->mapWallet.count(coinbase_a), 1U);
+        BOOST_CHECK_EQUAL(wallet_a->mapWallet.count(coinbase_b), 0U);
+        BOOST_CHECK_EQUAL(wallet_b->mapWallet.count(coinbase_a), 0U);
+        BOOST_CHECK_EQUAL(wallet_b->mapWallet.count(coinbase_b), 1U);
+        BOOST_CHECK_EQUAL(wallet_a->GetLastBlockHash(), tip);
+        BOOST_CHECK_EQUAL(wallet_b->GetLastBlockHash(), tip);
+    }
+
+    TestUnloadWallet(std::move(wallet_a));
+    const Txid coinbase_c{CreateAndProcessBlock({}, GetScriptForRawPubKey(key_b.GetPubKey())).vtx[0]->GetHash()};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    {
+        LOCK(wallet_b->cs_wallet);
+        BOOST_CHECK_EQUAL(wallet_b->mapWallet.count(coinbase_c), 1U);
+        BOOST_CHECK_EQUAL(wallet_b->GetLastBlockHeight(), WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Height()));
+    }
+    TestUnloadWallet(std::move(wallet_b));
+}
+
 BOOST_FIXTURE_TEST_CASE(RemoveTxs, TestChain100Setup)
 {
     m_args.ForceSetArg("-unsafesqlitesync", "1");
@@ -712,11 +893,14 @@ BOOST_FIXTURE_TEST_CASE(RemoveTxs, TestChain100Setup)
         BOOST_CHECK(wallet->HasWalletSpend(prev_tx));
         BOOST_CHECK_EQUAL(wallet->mapWallet.count(block_hash), 1u);
 
+        BOOST_CHECK(wallet->GetUnspentTXOs().contains(COutPoint{block_hash, 0}));
+
         std::vector<Txid> vHashIn{ block_hash };
         BOOST_CHECK(wallet->RemoveTxs(vHashIn));
 
         BOOST_CHECK(!wallet->HasWalletSpend(prev_tx));
         BOOST_CHECK_EQUAL(wallet->mapWallet.count(block_hash), 0u);
+        BOOST_CHECK(!wallet->GetUnspentTXOs().contains(COutPoint{block_hash, 0}));
     }
 
     TestUnloadWallet(std::move(wallet));
@@ -19,6 +19,7 @@
 #include <bitset>
 #include <cstdint>
 #include <map>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -217,6 +218,8 @@ public:
     unsigned int nTimeSmart;
     int64_t nOrderPos; //!< position in ordered transaction list
     std::multimap<int64_t, CWalletTx*>::const_iterator m_it_wtxOrdered;
+    //! Position in CWallet::m_txs_by_height, once indexed (memory only)
+    std::optional<std::multimap<int, CWalletTx*>::const_iterator> m_it_txs_by_height;
 
     // memory only
     enum AmountType { DEBIT, CREDIT, AMOUNTTYPE_ENUM_ELEMENTS };
@@ -18,6 +18,7 @@
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <external_signer.h>
 #include <interfaces/chain.h>
 #include <interfaces/handler.h>
@@ -57,6 +58,7 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -73,7 +75,11 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <future>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -320,8 +326,10 @@ public:
         }
     }
 
-    void UpdateIfNeeded()
+    /** Returns whether the filter set changed, making earlier matches of it stale. */
+    bool UpdateIfNeeded()
     {
+        bool updated{false};
         // repopulate filter with new scripts if top-up has happened since last iteration
         for (const auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
             auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(m_wallet.GetScriptPubKeyMan(desc_spkm_id))};
@@ -330,15 +338,20 @@ public:
             if (current_range_end > last_range_end) {
                 AddScriptPubKeys(desc_spkm, last_range_end);
                 m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
+                updated = true;
             }
         }
+        return updated;
     }
 
     std::optional<bool> MatchesBlock(const uint256& block_hash) const
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, *m_filter_set);
     }
 
+    /** The current filter set, which is not modified afterwards so it can be matched on other threads. */
+    std::shared_ptr<const GCSFilter::ElementSet> GetFilterSet() const { return m_filter_set; }
+
 private:
     const CWallet& m_wallet;
     /** Map for keeping track of each range descriptor's last seen end range.
@@ -348,15 +361,94 @@ private:
       * take possible keypool top-ups into account.
       */
     std::map<uint256, int32_t> m_last_range_ends;
-    GCSFilter::ElementSet m_filter_set;
+    std::shared_ptr<GCSFilter::ElementSet> m_filter_set{std::make_shared<GCSFilter::ElementSet>()};
 
     void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {
+        // Copy the set if it was handed out by GetFilterSet, rather than modify it.
+        if (m_filter_set.use_count() > 1) m_filter_set = std::make_shared<GCSFilter::ElementSet>(*m_filter_set);
         for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
-            m_filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
+            m_filter_set->emplace(script_pub_key.begin(), script_pub_key.end());
         }
     }
 };
+
+/**
+ * Matches the block filters of, and reads, the blocks following the one being
+ * rescanned on the threads of a pool, so that the rescan does not wait on
+ * them one at a time.
+ *
+ * Blocks are looked up by height on the chain ending at the tip passed to
+ * Schedule(). If a reorg makes them differ from the blocks the rescan asks for,
+ * Take() returns nothing and the rescan reads the block itself.
+ */
+class RescanReadAhead
+{
+public:
+    struct Block {
+        //! Whether the block filter matches, or nullopt if not known (or not matched).
+        std::optional<bool> matches;
+        //! The block, if it was read, which it is unless its filter does not match.
+        std::shared_ptr<const CBlock> block;
+    };
+
+    RescanReadAhead(interfaces::Chain& chain, int threads) : m_chain{chain}, m_window{size_t(threads) * RESCAN_READ_AHEAD_PER_THREAD}
+    {
+        m_pool.Start(threads);
+    }
+
+    /**
+     * Make sure the blocks after `height`, up to `end_height` and the window
+     * size, are being matched against `filter_set` (if not null) and read.
+     */
+    void Schedule(int height, const uint256& tip_hash, int end_height, std::shared_ptr<const GCSFilter::ElementSet> filter_set)
+    {
+        const int last{std::min<int>(end_height, height + m_window)};
+        for (int next{m_entries.empty() ? height + 1 : m_entries.back().height + 1}; next <= last; ++next) {
+            uint256 hash;
+            if (!m_chain.findAncestorByHeight(tip_hash, next, FoundBlock().hash(hash))) break;
+            m_entries.push_back({next, hash, m_pool.Submit([&chain = m_chain, hash, filter_set] {
+                Block ret;
+                if (filter_set) ret.matches = chain.blockFilterMatchesAny(BlockFilterType::BASIC, hash, *filter_set);
+                if (ret.matches.value_or(true)) {
+                    auto block{std::make_shared<CBlock>()};
+                    chain.findBlock(hash, FoundBlock().data(*block));
+                    ret.block = std::move(block);
+                }
+                return ret;
+            })});
+        }
+    }
+
+    /** Return the result for the block at `height`, if it was scheduled with this hash. */
+    std::optional<Block> Take(int height, const uint256& hash)
+    {
+        while (!m_entries.empty() && m_entries.front().height < height) m_entries.pop_front();
+        if (m_entries.empty() || m_entries.front().height != height) return std::nullopt;
+        if (m_entries.front().hash != hash) {
+            Clear();
+            return std::nullopt;
+        }
+        Block ret{m_entries.front().result.get()};
+        m_entries.pop_front();
+        return ret;
+    }
+
+    /** Drop the scheduled blocks, e.g. because the filter set changed. */
+    void Clear() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        int height;
+        uint256 hash;
+        std::future<Block> result;
+    };
+
+    interfaces::Chain& m_chain;
+    const size_t m_window;
+    ThreadPool m_pool{"rescan"};
+    std::deque<Entry> m_entries;
+};
 } // namespace
 
 std::shared_ptr<CWallet> LoadWallet(WalletContext& context, const std::string& name, std::optional<bool> load_on_start, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error, std::vector<bilingual_str>& warnings)
@@ -629,6 +721,8 @@ void CWallet::SetLastBlockProcessedInMem(int block_height, uint256 block_hash)
 
     m_last_block_processed = block_hash;
     m_last_block_processed_height = block_height;
+    // Depths, and so the maturity and trust of transactions, are relative to the tip
+    MarkBalancesDirty();
 }
 
 void CWallet::SetLastBlockProcessed(int block_height, uint256 block_hash)
@@ -757,10 +851,13 @@ bool CWallet::IsSpent(const COutPoint& outpoint) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid, WalletBatch* batch)
 {
     mapTxSpends.insert(std::make_pair(outpoint, txid));
+    UpdateUnspentTXO(outpoint);
 
     if (batch) {
         UnlockCoin(outpoint, batch);
-    } else {
+    } else if (IsLockedCoin(outpoint)) {
+        // Only open a batch if there is a lock to erase, as this runs for every input of every
+        // transaction while the wallet is loaded
         WalletBatch temp_batch(GetDatabase());
         UnlockCoin(outpoint, &temp_batch);
     }
@@ -771,6 +868,22 @@ void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid, WalletBat
 }
 
 
+void CWallet::UpdateTxHeightIndex(CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    int height{std::numeric_limits<int>::max()};
+    if (auto* conf{wtx.state<TxStateConfirmed>()}) {
+        height = conf->confirmed_block_height;
+    } else if (auto* conflicted{wtx.state<TxStateBlockConflicted>()}) {
+        height = conflicted->conflicting_block_height;
+    }
+    if (wtx.m_it_txs_by_height) {
+        if ((*wtx.m_it_txs_by_height)->first == height) return;
+        m_txs_by_height.erase(*wtx.m_it_txs_by_height);
+    }
+    wtx.m_it_txs_by_height = m_txs_by_height.emplace(height, &wtx);
+}
+
 void CWallet::AddToSpends(const CWalletTx& wtx, WalletBatch* batch)
 {
     if (wtx.IsCoinBase()) // Coinbases don't spend anything!
@@ -933,6 +1046,7 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (auto& [_, wtx] : mapWallet)
             wtx.MarkDirty();
+        MarkBalancesDirty();
     }
 }
 
@@ -954,6 +1068,7 @@ bool CWallet::MarkReplaced(const Txid& originalHash, const Txid& newHash)
 
     // Refresh mempool status without waiting for transactionRemovedFromMempool or transactionAddedToMempool
     RefreshMempoolStatus(wtx, chain());
+    MarkBalancesDirty();
 
     WalletBatch batch(GetDatabase());
 
@@ -1026,6 +1141,9 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     bool fInsertedNew = ret.second;
     bool fUpdated = update_wtx && update_wtx(wtx, fInsertedNew);
     if (fInsertedNew) {
+        // Transactions of a block share its memory, which the wallet would
+        // otherwise keep for as long as it is loaded.
+        if (std::holds_alternative<TxStateConfirmed>(state)) wtx.SetTx(MakeTransactionRef(*tx));
         wtx.nTimeReceived = GetTime();
         wtx.nOrderPos = IncOrderPosNext(&batch);
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
@@ -1066,6 +1184,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
             CWalletTx* desc_tx = txs.back();
             txs.pop_back();
             desc_tx->m_state = inactive_state;
+            UpdateTxHeightIndex(*desc_tx);
             // Break caches since we have changed the state
             desc_tx->MarkDirty();
             batch.WriteTx(*desc_tx);
@@ -1083,6 +1202,8 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
         }
     }
 
+    UpdateTxHeightIndex(wtx);
+
     //// debug print
     WalletLogPrintf("AddToWallet %s  %s%s %s\n", hash.ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""), TxStateString(state));
 
@@ -1093,9 +1214,14 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    MarkBalancesDirty();
 
     // Cache the outputs that belong to the wallet
     RefreshTXOsFromTx(wtx);
+    // A state change may also change whether the outputs this transaction spends are spent
+    for (const CTxIn& txin : wtx.tx->vin) {
+        UpdateUnspentTXO(txin.prevout);
+    }
 
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1146,6 +1272,7 @@ bool CWallet::LoadToWallet(const Txid& hash, const UpdateWalletTxFn& fill_wtx)
     if (/* insertion took place */ ins.second) {
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
     }
+    UpdateTxHeightIndex(wtx);
     AddToSpends(wtx);
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
@@ -1162,6 +1289,7 @@ bool CWallet::LoadToWallet(const Txid& hash, const UpdateWalletTxFn& fill_wtx)
 
     // Make sure the tx outputs are known by the wallet
     RefreshTXOsFromTx(wtx);
+    MarkBalancesDirty();
     return true;
 }
 
@@ -1245,7 +1373,9 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
         }
+        UpdateUnspentTXO(txin.prevout);
     }
+    MarkBalancesDirty();
 }
 
 bool CWallet::AbandonTransaction(const Txid& hashTx)
@@ -1338,6 +1468,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const Txid& tx_hash, co
         TxUpdate update_state = try_updating_state(wtx);
         if (update_state != TxUpdate::UNCHANGED) {
             wtx.MarkDirty();
+            UpdateTxHeightIndex(wtx);
             if (batch) batch->WriteTx(wtx);
             // Iterate over all its outputs, and update those tx states as well (if applicable)
             for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
@@ -1379,6 +1510,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        MarkBalancesDirty();
     }
 
     const Txid& txid = tx->GetHash();
@@ -1401,6 +1533,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        MarkBalancesDirty();
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1792,6 +1925,9 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
 
+    std::unique_ptr<RescanReadAhead> read_ahead;
+    if (m_rescan_threads > 1) read_ahead = std::make_unique<RescanReadAhead>(chain(), m_rescan_threads);
+
     fAbortRescan = false;
     ShowProgress(strprintf("%s %s", GetDisplayName(), _("Rescanning…")), 0); // show rescan progress in GUI as dialog or on splashscreen, if rescan required on startup (e.g. due to corruption)
     uint256 tip_hash = WITH_LOCK(cs_wallet, return GetLastBlockHash());
@@ -1817,10 +1953,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
         }
 
+        std::optional<RescanReadAhead::Block> ahead;
+        if (read_ahead) ahead = read_ahead->Take(block_height, block_hash);
         bool fetch_block{true};
         if (fast_rescan_filter) {
-            fast_rescan_filter->UpdateIfNeeded();
-            auto matches_block{fast_rescan_filter->MatchesBlock(block_hash)};
+            if (fast_rescan_filter->UpdateIfNeeded() && read_ahead) {
+                // Blocks whose filters did not match may match the new scripts.
+                if (ahead && !ahead->block) ahead.reset();
+                read_ahead->Clear();
+            }
+            auto matches_block{ahead ? ahead->matches : fast_rescan_filter->MatchesBlock(block_hash)};
             if (matches_block.has_value()) {
                 if (*matches_block) {
                     LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
@@ -1841,10 +1983,20 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         uint256 next_block_hash;
         chain().findBlock(block_hash, FoundBlock().inActiveChain(block_still_active).nextBlock(FoundBlock().inActiveChain(next_block).hash(next_block_hash)));
 
+        if (read_ahead) {
+            const int end_height{max_height ? *max_height : WITH_LOCK(cs_wallet, return GetLastBlockHeight())};
+            read_ahead->Schedule(block_height, tip_hash, end_height, fast_rescan_filter ? fast_rescan_filter->GetFilterSet() : nullptr);
+        }
+
         if (fetch_block) {
-            // Read block data
-            CBlock block;
-            chain().findBlock(block_hash, FoundBlock().data(block));
+            // Read block data, unless it was read ahead
+            std::shared_ptr<const CBlock> read_block{ahead ? ahead->block : nullptr};
+            if (!read_block || read_block->IsNull()) {
+                auto new_block{std::make_shared<CBlock>()};
+                chain().findBlock(block_hash, FoundBlock().data(*new_block));
+                read_block = std::move(new_block);
+            }
+            const CBlock& block{*read_block};
 
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
@@ -1952,7 +2104,10 @@ bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx, std::string& err_string
     // If transaction was previously in the mempool, it should be updated when
     // TransactionRemovedFromMempool fires.
     bool ret = chain().broadcastTransaction(wtx.tx, m_default_max_tx_fee, relay, err_string);
-    if (ret) wtx.m_state = TxStateInMempool{};
+    if (ret) {
+        wtx.m_state = TxStateInMempool{};
+        MarkBalancesDirty();
+    }
     return ret;
 }
 
@@ -2321,14 +2476,22 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<Txid>& txs
         for (const auto& it : erased_txs) {
             const Txid hash{it->first};
             wtxOrdered.erase(it->second.m_it_wtxOrdered);
+            if (it->second.m_it_txs_by_height) m_txs_by_height.erase(*it->second.m_it_txs_by_height);
             for (const auto& txin : it->second.tx->vin)
                 mapTxSpends.erase(txin.prevout);
             for (unsigned int i = 0; i < it->second.tx->vout.size(); ++i) {
                 m_txos.erase(COutPoint(Txid::FromUint256(hash), i));
+                m_unspent_txos.erase(COutPoint(Txid::FromUint256(hash), i));
             }
             mapWallet.erase(it);
             NotifyTransactionChanged(hash, CT_DELETED);
         }
+        // The outputs spent by the removed transactions may be spendable again
+        for (const auto& it : erased_txs) {
+            for (const auto& txin : it->second.tx->vin) {
+                UpdateUnspentTXO(txin.prevout);
+            }
+        }
 
         MarkDirty();
     }, .on_abort={}});
@@ -2436,6 +2599,19 @@ size_t CWallet::KeypoolCountExternalKeys() const
     return count;
 }
 
+size_t CWallet::DynamicMemoryUsage() const
+{
+    AssertLockHeld(cs_wallet);
+
+    size_t usage{memusage::DynamicUsage(mapWallet) + memusage::DynamicUsage(wtxOrdered) + memusage::DynamicUsage(m_txs_by_height) +
+                 memusage::DynamicUsage(mapTxSpends) + memusage::DynamicUsage(m_txos) +
+                 memusage::DynamicUsage(m_unspent_txos) + memusage::DynamicUsage(m_address_book)};
+    for (const auto& [txid, wtx] : mapWallet) {
+        usage += RecursiveDynamicUsage(wtx.tx) + memusage::DynamicUsage(wtx.mapValue);
+    }
+    return usage;
+}
+
 unsigned int CWallet::GetKeyPoolSize() const
 {
     AssertLockHeld(cs_wallet);
@@ -2485,6 +2661,7 @@ util::Result<CTxDestination> CWallet::GetNewChangeDestination(const OutputType t
 }
 
 void CWallet::MarkDestinationsDirty(const std::set<CTxDestination>& destinations) {
+    MarkBalancesDirty();
     for (auto& entry : mapWallet) {
         CWalletTx& wtx = entry.second;
         if (wtx.m_is_cache_empty) continue;
@@ -2797,6 +2974,110 @@ std::unique_ptr<WalletDatabase> MakeWalletDatabase(const std::string& name, cons
     return MakeDatabase(*wallet_path, options, status, error_string);
 }
 
+//! Maximum number of threads processing a block for the loaded wallets at once.
+static constexpr int MAX_BLOCK_NOTIFICATION_THREADS{8};
+
+//! Receives chain notifications through a single subscription on behalf of
+//! every wallet attached to a chain and forwards them to each wallet. Block
+//! connections and disconnections are handled by the wallets concurrently:
+//! a wallet only takes its own cs_wallet while processing a block, and a
+//! notification is not finished until every wallet is done with it, so each
+//! wallet still sees the events in order.
+class WalletNotificationsDispatcher final : public interfaces::Chain::Notifications, public std::enable_shared_from_this<WalletNotificationsDispatcher>
+{
+public:
+    explicit WalletNotificationsDispatcher(interfaces::Chain& chain) : m_chain{chain} {}
+
+    //! Forward notifications to the wallet until the returned handler is destroyed.
+    std::unique_ptr<interfaces::Handler> Register(const std::shared_ptr<CWallet>& wallet) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            LOCK(m_mutex);
+            m_wallets.push_back(wallet);
+            if (!m_handler) m_handler = m_chain.handleNotifications(shared_from_this());
+        }
+        return interfaces::MakeCleanupHandler([self = shared_from_this(), wallet = wallet.get()] { self->Unregister(wallet); });
+    }
+
+    void transactionAddedToMempool(const CTransactionRef& tx) override
+    {
+        for (const auto& wallet : Wallets()) wallet->transactionAddedToMempool(tx);
+    }
+    void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason) override
+    {
+        for (const auto& wallet : Wallets()) wallet->transactionRemovedFromMempool(tx, reason);
+    }
+    void blockConnected(ChainstateRole role, const interfaces::BlockInfo& block) override
+    {
+        ForEachWalletConcurrently([&](CWallet& wallet) { wallet.blockConnected(role, block); });
+    }
+    void blockDisconnected(const interfaces::BlockInfo& block) override
+    {
+        ForEachWalletConcurrently([&](CWallet& wallet) { wallet.blockDisconnected(block); });
+    }
+    void updatedBlockTip() override
+    {
+        for (const auto& wallet : Wallets()) wallet->updatedBlockTip();
+    }
+    void chainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override
+    {
+        for (const auto& wallet : Wallets()) wallet->chainStateFlushed(role, locator);
+    }
+
+private:
+    void Unregister(const CWallet* wallet) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        // Declared before the lock so that the wallet and the chain
+        // subscription are released after m_mutex is unlocked.
+        std::shared_ptr<CWallet> removed;
+        std::unique_ptr<interfaces::Handler> handler;
+        LOCK(m_mutex);
+        const auto it{std::find_if(m_wallets.begin(), m_wallets.end(), [&](const auto& w) { return w.get() == wallet; })};
+        if (it != m_wallets.end()) {
+            removed = std::move(*it);
+            m_wallets.erase(it);
+        }
+        if (m_wallets.empty()) handler = std::move(m_handler);
+    }
+
+    std::vector<std::shared_ptr<CWallet>> Wallets() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return m_wallets;
+    }
+
+    //! Call fn for every wallet, several wallets at a time when there is more
+    //! than one of them and more than one core. Returns once all calls are done.
+    void ForEachWalletConcurrently(const std::function<void(CWallet&)>& fn)
+    {
+        const auto wallets{Wallets()};
+        if (wallets.size() > 1 && m_pool.WorkersCount() == 0) {
+            // Notifications are delivered one at a time, so the pool is only
+            // ever started and used from a single thread.
+            const int workers{std::min(GetNumCores(), MAX_BLOCK_NOTIFICATION_THREADS) - 1};
+            if (workers > 0) m_pool.Start(workers);
+        }
+        if (wallets.size() < 2 || m_pool.WorkersCount() == 0) {
+            for (const auto& wallet : wallets) fn(*wallet);
+            return;
+        }
+        std::vector<std::future<void>> futures;
+        futures.reserve(wallets.size() - 1);
+        for (size_t i = 1; i < wallets.size(); ++i) {
+            futures.push_back(m_pool.Submit([&fn, &wallet = *wallets[i]] { fn(wallet); }));
+        }
+        fn(*wallets[0]);
+        for (auto& future : futures) future.get();
+    }
+
+    interfaces::Chain& m_chain;
+    mutable Mutex m_mutex;
+    std::vector<std::shared_ptr<CWallet>> m_wallets GUARDED_BY(m_mutex);
+    //! Subscription to the chain, held while there are registered wallets.
+    std::unique_ptr<interfaces::Handler> m_handler GUARDED_BY(m_mutex);
+    ThreadPool m_pool{"walletblocks"};
+};
+
 std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::string& name, std::unique_ptr<WalletDatabase> database, uint64_t wallet_creation_flags, bilingual_str& error, std::vector<bilingual_str>& warnings)
 {
     interfaces::Chain* chain = context.chain;
@@ -2808,6 +3089,10 @@ std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::stri
     // should be possible to use std::allocate_shared.
     std::shared_ptr<CWallet> walletInstance(new CWallet(chain, name, std::move(database)), FlushAndDeleteWallet);
     walletInstance->m_keypool_size = std::max(args.GetIntArg("-keypool", DEFAULT_KEYPOOL_SIZE), int64_t{1});
+    // -rescanthreads=0 means one thread per core
+    int rescan_threads{static_cast<int>(args.GetIntArg("-rescanthreads", DEFAULT_RESCAN_THREADS))};
+    if (rescan_threads <= 0) rescan_threads = GetNumCores();
+    walletInstance->m_rescan_threads = std::clamp(rescan_threads, 1, MAX_RESCAN_THREADS);
     walletInstance->m_notify_tx_changed_script = args.GetArg("-walletnotify", "");
 
     // Load wallet
@@ -3043,7 +3328,13 @@ std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::stri
     }
     if (time_first_key) walletInstance->MaybeUpdateBirthTime(*time_first_key);
 
-    if (chain && !AttachChain(walletInstance, *chain, rescan_required, error, warnings)) {
+    std::shared_ptr<WalletNotificationsDispatcher> dispatcher;
+    if (chain) {
+        LOCK(context.wallets_mutex);
+        if (!context.notifications_dispatcher) context.notifications_dispatcher = std::make_shared<WalletNotificationsDispatcher>(*chain);
+        dispatcher = context.notifications_dispatcher;
+    }
+    if (chain && !AttachChain(walletInstance, *chain, *dispatcher, rescan_required, error, warnings)) {
         walletInstance->m_chain_notifications_handler.reset(); // Reset this pointer so that the wallet will actually be unloaded
         return nullptr;
     }
@@ -3059,7 +3350,7 @@ std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::stri
     return walletInstance;
 }
 
-bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interfaces::Chain& chain, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings)
+bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interfaces::Chain& chain, WalletNotificationsDispatcher& dispatcher, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings)
 {
     LOCK(walletInstance->cs_wallet);
     // allow setting the chain if it hasn't been set already but prevent changing it
@@ -3086,7 +3377,7 @@ bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interf
     // be pending on the validation-side until lock release. Blocks that are connected while the
     // rescan is ongoing will not be processed in the rescan but with the block connected notifications,
     // so the wallet will only be completeley synced after the notifications delivery.
-    walletInstance->m_chain_notifications_handler = walletInstance->chain().handleNotifications(walletInstance);
+    walletInstance->m_chain_notifications_handler = dispatcher.Register(walletInstance);
 
     // If rescan_required = true, rescan_height remains equal to 0
     int rescan_height = 0;
@@ -3297,21 +3588,49 @@ bool CWallet::Lock()
             memory_cleanse(vMasterKey.data(), vMasterKey.size() * sizeof(decltype(vMasterKey)::value_type));
             vMasterKey.clear();
         }
+        for (const auto& [_, spk_man] : m_spk_managers) spk_man->ClearDecryptedKeys();
     }
 
     NotifyStatusChanged(this);
     return true;
 }
 
+//! Number of ScriptPubKeyMans from which Unlock checks the master key against them on several threads
+static constexpr size_t MIN_PARALLEL_UNLOCK_SPKMS{8};
+//! Maximum number of threads Unlock checks the master key on
+static constexpr int MAX_UNLOCK_THREADS{16};
+
 bool CWallet::Unlock(const CKeyingMaterial& vMasterKeyIn)
 {
     {
         LOCK(cs_wallet);
-        for (const auto& spk_man_pair : m_spk_managers) {
-            if (!spk_man_pair.second->CheckDecryptionKey(vMasterKeyIn)) {
-                return false;
+        // Checking the master key decrypts keys, and all of them the first
+        // time, so spread the ScriptPubKeyMans over several threads when there
+        // are many of them, e.g. in a migrated wallet with one per key.
+        std::vector<ScriptPubKeyMan*> spk_mans;
+        spk_mans.reserve(m_spk_managers.size());
+        for (const auto& [_, spk_man] : m_spk_managers) spk_mans.push_back(spk_man.get());
+        const int threads{spk_mans.size() >= MIN_PARALLEL_UNLOCK_SPKMS ? std::min(GetNumCores(), MAX_UNLOCK_THREADS) : 1};
+        std::atomic<bool> failed{false};
+        const auto check{[&](int task, int tasks) {
+            for (size_t i = task; i < spk_mans.size() && !failed; i += tasks) {
+                if (!spk_mans[i]->CheckDecryptionKey(vMasterKeyIn)) failed = true;
             }
+        }};
+        if (threads > 1) {
+            ThreadPool pool{"unlock"};
+            pool.Start(threads);
+            std::vector<std::future<void>> futures;
+            for (int task = 0; task < threads; ++task) {
+                futures.push_back(pool.Submit([&, task] { check(task, threads); }));
+            }
+            for (auto& future : futures) future.wait();
+            // Rethrow the error of a ScriptPubKeyMan with keys that did not all decrypt.
+            for (auto& future : futures) future.get();
+        } else {
+            check(0, 1);
         }
+        if (failed) return false;
         vMasterKey = vMasterKeyIn;
     }
     NotifyStatusChanged(this);
@@ -3898,6 +4217,7 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
 
     // Update m_txos to match the descriptors remaining in this wallet
     m_txos.clear();
+    m_unspent_txos.clear();
     RefreshAllTXOs();
 
     // Check if the transactions in the wallet are still ours. Either they belong here, or they belong in the watchonly wallet.
@@ -4450,6 +4770,7 @@ void CWallet::RefreshTXOsFromTx(const CWalletTx& wtx)
         } else {
             m_txos.emplace(outpoint, WalletTXO{wtx, txout, ismine});
         }
+        UpdateUnspentTXO(outpoint);
     }
 }
 
@@ -4459,6 +4780,38 @@ void CWallet::RefreshAllTXOs()
     for (const auto& [_, wtx] : mapWallet) {
         RefreshTXOsFromTx(wtx);
     }
+    MarkBalancesDirty();
+}
+
+void CWallet::UpdateUnspentTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    if (m_txos.contains(outpoint) && !IsSpent(outpoint)) {
+        m_unspent_txos.insert(outpoint);
+    } else {
+        m_unspent_txos.erase(outpoint);
+    }
+    MarkBalancesDirty();
+}
+
+std::optional<Balance> CWallet::GetCachedBalance(int min_depth, bool avoid_reuse) const
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_balance_cache.find({min_depth, avoid_reuse})};
+    if (it == m_balance_cache.end()) return std::nullopt;
+    return it->second;
+}
+
+void CWallet::SetCachedBalance(int min_depth, bool avoid_reuse, const Balance& balance) const
+{
+    AssertLockHeld(cs_wallet);
+    m_balance_cache.insert_or_assign({min_depth, avoid_reuse}, balance);
+}
+
+void CWallet::MarkBalancesDirty() const
+{
+    AssertLockHeld(cs_wallet);
+    m_balance_cache.clear();
 }
 
 std::optional<WalletTXO> CWallet::GetTXO(const COutPoint& outpoint) const
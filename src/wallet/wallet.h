@@ -47,6 +47,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -83,6 +84,7 @@ struct bilingual_str;
 
 namespace wallet {
 struct WalletContext;
+class WalletNotificationsDispatcher;
 
 //! Explicitly delete the wallet.
 //! Blocks the current thread until the wallet is destructed.
@@ -129,6 +131,12 @@ static const bool DEFAULT_SPEND_ZEROCONF_CHANGE = true;
 static const bool DEFAULT_WALLET_REJECT_LONG_CHAINS{true};
 //! -txconfirmtarget default
 static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
+//! -rescanthreads default; 0 means one thread per core
+static constexpr int DEFAULT_RESCAN_THREADS{0};
+//! Maximum number of threads for -rescanthreads
+static constexpr int MAX_RESCAN_THREADS{16};
+//! Number of blocks a rescan matches the filters of and reads ahead, per thread
+static constexpr int RESCAN_READ_AHEAD_PER_THREAD{4};
 //! -walletrbf default
 static const bool DEFAULT_WALLET_RBF = true;
 static const bool DEFAULT_WALLETBROADCAST = true;
@@ -303,6 +311,12 @@ struct CRecipient
     bool fSubtractFeeFromAmount;
 };
 
+struct Balance {
+    CAmount m_mine_trusted{0};           //!< Trusted, at depth=GetBalance.min_depth or more
+    CAmount m_mine_untrusted_pending{0}; //!< Untrusted, but in mempool (pending)
+    CAmount m_mine_immature{0};          //!< Immature coinbases in the main chain
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet maintains a set of transactions and balances, and provides the ability to create new transactions.
@@ -346,6 +360,9 @@ private:
     void AddToSpends(const COutPoint& outpoint, const Txid& txid, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void AddToSpends(const CWalletTx& wtx, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /** Move a transaction to its place in m_txs_by_height, after its state changed. */
+    void UpdateTxHeightIndex(CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /**
      * Add a transaction to the wallet, or update it.  confirm.block_* should
      * be set when the transaction was known to be included in a block.  When
@@ -440,13 +457,23 @@ private:
 
     //! Set of both spent and unspent transaction outputs owned by this wallet
     std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher> m_txos GUARDED_BY(cs_wallet);
+    //! Subset of m_txos that is not spent by any active wallet transaction, so that
+    //! coin listing does not have to walk the whole history of the wallet
+    std::unordered_set<COutPoint, SaltedOutpointHasher> m_unspent_txos GUARDED_BY(cs_wallet);
+
+    /** Add or remove outpoint from m_unspent_txos to match its current spent status */
+    void UpdateUnspentTXO(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    //! Results of GetBalance, keyed by its min_depth and avoid_reuse arguments. Emptied by
+    //! MarkBalancesDirty() whenever a transaction state, a spent status or the chain tip changes.
+    mutable std::map<std::pair<int, bool>, Balance> m_balance_cache GUARDED_BY(cs_wallet);
 
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
      * block locator and m_last_block_processed, and registering for
      * notifications about new blocks and transactions.
      */
-    static bool AttachChain(const std::shared_ptr<CWallet>& wallet, interfaces::Chain& chain, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings);
+    static bool AttachChain(const std::shared_ptr<CWallet>& wallet, interfaces::Chain& chain, WalletNotificationsDispatcher& dispatcher, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings);
 
     static NodeClock::time_point GetDefaultNextResend();
 
@@ -502,6 +529,11 @@ public:
     typedef std::multimap<int64_t, CWalletTx*> TxItems;
     TxItems wtxOrdered;
 
+    /** Transactions by the height of the block they are confirmed or conflicted in.
+     *  Transactions with neither come last, at the maximum height. */
+    typedef std::multimap<int, CWalletTx*> TxsByHeight;
+    TxsByHeight m_txs_by_height GUARDED_BY(cs_wallet);
+
     int64_t nOrderPosNext GUARDED_BY(cs_wallet) = 0;
 
     std::map<CTxDestination, CAddressBookData> m_address_book GUARDED_BY(cs_wallet);
@@ -525,6 +557,16 @@ public:
 
     const std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher>& GetTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_txos; };
     std::optional<WalletTXO> GetTXO(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Return the cached GetBalance result for these arguments, if it is still valid */
+    std::optional<Balance> GetCachedBalance(int min_depth, bool avoid_reuse) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void SetCachedBalance(int min_depth, bool avoid_reuse, const Balance& balance) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Invalidate cached balances, must be called on any change that can affect them */
+    void MarkBalancesDirty() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** The outpoints of GetTXOs() which are not spent by an active wallet transaction */
+    const std::unordered_set<COutPoint, SaltedOutpointHasher>& GetUnspentTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_unspent_txos; };
+
+    /** Estimate of the memory used by the transactions, outputs and address book of the wallet. Keys are not included. */
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /** Cache outputs that belong to the wallet from a single transaction */
     void RefreshTXOsFromTx(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -748,6 +790,9 @@ public:
     /** Number of pre-generated keys/scripts by each spkm (part of the look-ahead process, used to detect payments) */
     int64_t m_keypool_size{DEFAULT_KEYPOOL_SIZE};
 
+    /** Number of threads matching block filters and reading blocks ahead of a rescan (1 = none) */
+    int m_rescan_threads{1};
+
     /** Notify external script when a wallet transaction comes in or is updated (handled by -walletnotify) */
     std::string m_notify_tx_changed_script;
 
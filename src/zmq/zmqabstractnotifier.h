@@ -5,9 +5,11 @@
 #ifndef BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 
 class CBlockIndex;
@@ -20,6 +22,8 @@ class CZMQAbstractNotifier
 {
 public:
     static const int DEFAULT_ZMQ_SNDHWM {1000};
+    //! Default for -zmqpubrawtxbatchinterval, the time transactions are held to be published together.
+    static constexpr int DEFAULT_ZMQ_TX_BATCH_INTERVAL_MS{100};
 
     CZMQAbstractNotifier() : outbound_message_high_water_mark(DEFAULT_ZMQ_SNDHWM) {}
     virtual ~CZMQAbstractNotifier();
@@ -57,6 +61,12 @@ public:
     // Notifies of transactions added to mempool or appearing in blocks
     virtual bool NotifyTransaction(const CTransaction &transaction);
 
+    //! Time by which the messages held back by the notifier should be
+    //! published with Flush(), if it holds any.
+    virtual std::optional<std::chrono::steady_clock::time_point> FlushDeadline() const { return std::nullopt; }
+    //! Publish the messages held back by the notifier.
+    virtual bool Flush() { return true; }
+
 protected:
     void* psocket{nullptr};
     std::string type;
@@ -0,0 +1,163 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <zmq/zmqmempoolserver.h>
+
+#include <crypto/common.h>
+#include <logging.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <streams.h>
+#include <txmempool.h>
+#include <util/thread.h>
+#include <zmq/zmqutil.h>
+
+#include <zmq.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+
+static const char* MSG_MEMPOOL = "mempool";
+
+//! How long the server thread waits for a request before checking whether it
+//! should stop.
+static constexpr long POLL_TIMEOUT_MS{100};
+
+CZMQMempoolServer::CZMQMempoolServer(std::string address, SnapshotFn get_snapshot)
+    : m_address{std::move(address)}, m_get_snapshot{std::move(get_snapshot)} {}
+
+CZMQMempoolServer::~CZMQMempoolServer()
+{
+    Shutdown();
+}
+
+bool CZMQMempoolServer::Initialize(void* pcontext)
+{
+    assert(!m_socket);
+    m_socket = zmq_socket(pcontext, ZMQ_REP);
+    if (!m_socket) {
+        zmqError("Failed to create socket");
+        return false;
+    }
+    // As for the notifiers, ZMQ_IPV6 must only be enabled for IPv6 addresses.
+    const int enable_ipv6{IsZMQAddressIPV6(m_address) ? 1 : 0};
+    if (zmq_setsockopt(m_socket, ZMQ_IPV6, &enable_ipv6, sizeof(enable_ipv6)) != 0) {
+        zmqError("Failed to set ZMQ_IPV6");
+        zmq_close(m_socket);
+        m_socket = nullptr;
+        return false;
+    }
+    if (zmq_bind(m_socket, m_address.c_str()) != 0) {
+        zmqError("Failed to bind address");
+        zmq_close(m_socket);
+        m_socket = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CZMQMempoolServer::Start()
+{
+    assert(m_socket && !m_thread.joinable());
+    m_thread = std::thread(&util::TraceThread, "zmqmempool", [this] { ThreadServe(); });
+}
+
+void CZMQMempoolServer::Shutdown()
+{
+    if (m_thread.joinable()) {
+        m_stop = true;
+        m_thread.join();
+    }
+    if (m_socket) {
+        LogDebug(BCLog::ZMQ, "Close socket at address %s\n", m_address);
+        int linger = 0;
+        zmq_setsockopt(m_socket, ZMQ_LINGER, &linger, sizeof(linger));
+        zmq_close(m_socket);
+        m_socket = nullptr;
+    }
+}
+
+void CZMQMempoolServer::ThreadServe()
+{
+    while (!m_stop) {
+        zmq_pollitem_t item{.socket = m_socket, .fd = 0, .events = ZMQ_POLLIN, .revents = 0};
+        const int rc{zmq_poll(&item, 1, POLL_TIMEOUT_MS)};
+        if (rc == -1) {
+            zmqError("Unable to poll mempool request socket");
+            return;
+        }
+        if (rc == 0) continue;
+
+        // The request itself is ignored; drain all of its parts.
+        int more{0};
+        do {
+            zmq_msg_t msg;
+            zmq_msg_init(&msg);
+            if (zmq_msg_recv(&msg, m_socket, 0) == -1) {
+                zmqError("Unable to receive mempool request");
+                zmq_msg_close(&msg);
+                return;
+            }
+            more = zmq_msg_more(&msg);
+            zmq_msg_close(&msg);
+        } while (more);
+
+        if (!Reply()) return;
+    }
+}
+
+//! zmq_msg_init_data() deallocation function, dropping the reference to the
+//! serialized snapshot once libzmq is done with it.
+static void ReleaseBody(void* /*data*/, void* hint)
+{
+    delete static_cast<std::shared_ptr<const DataStream>*>(hint);
+}
+
+bool CZMQMempoolServer::Reply()
+{
+    auto snapshot{m_get_snapshot()};
+    if (!snapshot) snapshot = std::make_shared<const MempoolSnapshot>();
+    if (snapshot != m_last_snapshot) {
+        // <8-byte LE sequence> | <CompactSize count> | <transactions>, parents
+        // before their children.
+        auto body{std::make_shared<DataStream>()};
+        unsigned char sequence[sizeof(uint64_t)];
+        WriteLE64(sequence, snapshot->sequence);
+        body->write(std::as_bytes(std::span{sequence}));
+        WriteCompactSize(*body, snapshot->entries.size());
+        for (const auto& entry : snapshot->entries) *body << TX_WITH_WITNESS(*entry.tx);
+        m_last_snapshot = std::move(snapshot);
+        m_last_body = std::move(body);
+    }
+    LogDebug(BCLog::ZMQ, "Reply with mempool snapshot of %d transactions at sequence %d to %s\n",
+             m_last_snapshot->entries.size(), m_last_snapshot->sequence, m_address);
+
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, strlen(MSG_MEMPOOL)) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        return false;
+    }
+    memcpy(zmq_msg_data(&msg), MSG_MEMPOOL, strlen(MSG_MEMPOOL));
+    if (zmq_msg_send(&msg, m_socket, ZMQ_SNDMORE) == -1) {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
+    }
+
+    auto* hint{new std::shared_ptr<const DataStream>{m_last_body}};
+    if (zmq_msg_init_data(&msg, const_cast<std::byte*>(m_last_body->data()), m_last_body->size(), ReleaseBody, hint) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        delete hint;
+        return false;
+    }
+    if (zmq_msg_send(&msg, m_socket, 0) == -1) {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
+    }
+    return true;
+}
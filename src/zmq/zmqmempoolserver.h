@@ -0,0 +1,58 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ZMQ_ZMQMEMPOOLSERVER_H
+#define BITCOIN_ZMQ_ZMQMEMPOOLSERVER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+class DataStream;
+struct MempoolSnapshot;
+
+/**
+ * Reply socket answering every request with a binary snapshot of the mempool,
+ * tagged with the mempool sequence number it was taken at, so that subscribers
+ * of the sequence topic can bootstrap their view of the mempool without an RPC
+ * round trip.
+ */
+class CZMQMempoolServer
+{
+public:
+    //! Returns the current snapshot, or null while there is no mempool.
+    using SnapshotFn = std::function<std::shared_ptr<const MempoolSnapshot>()>;
+
+    CZMQMempoolServer(std::string address, SnapshotFn get_snapshot);
+    ~CZMQMempoolServer();
+
+    const std::string& GetAddress() const { return m_address; }
+
+    //! Bind the socket. Requests are queued until Start().
+    bool Initialize(void* pcontext);
+    //! Start answering requests on the zmqmempool thread, once the mempool
+    //! get_snapshot reads is set up.
+    void Start();
+    void Shutdown();
+
+private:
+    void ThreadServe();
+    //! Reply to the request just received on the socket.
+    bool Reply();
+
+    const std::string m_address;
+    const SnapshotFn m_get_snapshot;
+    void* m_socket{nullptr};
+    std::atomic_bool m_stop{false};
+    std::thread m_thread;
+
+    //! Last snapshot served and its serialization, reused until the mempool
+    //! changes. Only used by the server thread.
+    std::shared_ptr<const MempoolSnapshot> m_last_snapshot;
+    std::shared_ptr<const DataStream> m_last_body;
+};
+
+#endif // BITCOIN_ZMQ_ZMQMEMPOOLSERVER_H
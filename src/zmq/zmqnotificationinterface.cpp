@@ -11,15 +11,20 @@
 #include <netbase.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <util/thread.h>
 #include <validationinterface.h>
 #include <zmq/zmqabstractnotifier.h>
+#include <zmq/zmqmempoolserver.h>
 #include <zmq/zmqpublishnotifier.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <map>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -34,13 +39,20 @@ CZMQNotificationInterface::~CZMQNotificationInterface()
 std::list<const CZMQAbstractNotifier*> CZMQNotificationInterface::GetActiveNotifiers() const
 {
     std::list<const CZMQAbstractNotifier*> result;
+    LOCK(m_notifiers_mutex);
     for (const auto& n : notifiers) {
         result.push_back(n.get());
     }
     return result;
 }
 
-std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index)
+void CZMQNotificationInterface::StartMempoolServer()
+{
+    if (m_mempool_server) m_mempool_server->Start();
+}
+
+std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index,
+                                                                             std::function<std::shared_ptr<const MempoolSnapshot>()> get_mempool_snapshot)
 {
     std::map<std::string, CZMQNotifierFactory> factories;
     factories["pubhashblock"] = CZMQAbstractNotifier::Create<CZMQPublishHashBlockNotifier>;
@@ -49,6 +61,10 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
         return std::make_unique<CZMQPublishRawBlockNotifier>(get_block_by_index);
     };
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
+    factories["pubrawtxbatch"] = []() -> std::unique_ptr<CZMQAbstractNotifier> {
+        const auto interval{std::max<int64_t>(gArgs.GetIntArg("-zmqpubrawtxbatchinterval", CZMQAbstractNotifier::DEFAULT_ZMQ_TX_BATCH_INTERVAL_MS), 0)};
+        return std::make_unique<CZMQPublishRawTransactionBatchNotifier>(std::chrono::milliseconds{interval});
+    };
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
 
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
@@ -70,10 +86,19 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
         }
     }
 
-    if (!notifiers.empty())
+    std::unique_ptr<CZMQMempoolServer> mempool_server;
+    if (auto address{gArgs.GetArg("-zmqrepmempool")}) {
+        if (address->starts_with(ADDR_PREFIX_UNIX)) {
+            address->replace(0, ADDR_PREFIX_UNIX.length(), ADDR_PREFIX_IPC);
+        }
+        mempool_server = std::make_unique<CZMQMempoolServer>(*address, std::move(get_mempool_snapshot));
+    }
+
+    if (!notifiers.empty() || mempool_server)
     {
         std::unique_ptr<CZMQNotificationInterface> notificationInterface(new CZMQNotificationInterface());
-        notificationInterface->notifiers = std::move(notifiers);
+        WITH_LOCK(notificationInterface->m_notifiers_mutex, notificationInterface->notifiers = std::move(notifiers));
+        notificationInterface->m_mempool_server = std::move(mempool_server);
 
         if (notificationInterface->Initialize()) {
             return notificationInterface;
@@ -101,15 +126,27 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
-    for (auto& notifier : notifiers) {
-        if (notifier->Initialize(pcontext)) {
-            LogDebug(BCLog::ZMQ, "Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
-        } else {
-            LogDebug(BCLog::ZMQ, "Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
+    {
+        LOCK(m_notifiers_mutex);
+        for (auto& notifier : notifiers) {
+            if (notifier->Initialize(pcontext)) {
+                LogDebug(BCLog::ZMQ, "Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
+            } else {
+                LogDebug(BCLog::ZMQ, "Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
+                return false;
+            }
+        }
+    }
+
+    if (m_mempool_server) {
+        if (!m_mempool_server->Initialize(pcontext)) {
+            LogDebug(BCLog::ZMQ, "Mempool server failed (address = %s)\n", m_mempool_server->GetAddress());
             return false;
         }
+        LogDebug(BCLog::ZMQ, "Mempool server ready (address = %s)\n", m_mempool_server->GetAddress());
     }
 
+    m_publisher = std::thread(&util::TraceThread, "zmqpub", [this] { ThreadPublish(); });
     return true;
 }
 
@@ -117,23 +154,75 @@ bool CZMQNotificationInterface::Initialize()
 void CZMQNotificationInterface::Shutdown()
 {
     LogDebug(BCLog::ZMQ, "Shutdown notification interface\n");
+    if (m_publisher.joinable()) {
+        // The publisher thread sends what is still queued or held back before exiting.
+        WITH_LOCK(m_queue_mutex, m_stop = true);
+        m_queue_cv.notify_all();
+        m_publisher.join();
+    }
     if (pcontext)
     {
+        LOCK(m_notifiers_mutex);
         for (auto& notifier : notifiers) {
             LogDebug(BCLog::ZMQ, "Shutdown notifier %s at %s\n", notifier->GetType(), notifier->GetAddress());
             notifier->Shutdown();
         }
+        if (m_mempool_server) m_mempool_server->Shutdown();
         zmq_ctx_term(pcontext);
 
         pcontext = nullptr;
     }
 }
 
-namespace {
+void CZMQNotificationInterface::Publish(std::function<void()> task)
+{
+    {
+        WAIT_LOCK(m_queue_mutex, lock);
+        m_queue_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_queue_mutex) { return m_queue.size() < MAX_PUBLISH_QUEUE || m_stop; });
+        if (m_stop) return;
+        m_queue.push_back(std::move(task));
+    }
+    m_queue_cv.notify_all();
+}
 
-template <typename Function>
-void TryForEachAndRemoveFailed(std::list<std::unique_ptr<CZMQAbstractNotifier>>& notifiers, const Function& func)
+void CZMQNotificationInterface::ThreadPublish()
 {
+    WAIT_LOCK(m_queue_mutex, lock);
+    while (true) {
+        if (m_queue.empty() && !m_stop) {
+            std::optional<std::chrono::steady_clock::time_point> deadline;
+            {
+                LOCK(m_notifiers_mutex);
+                for (const auto& notifier : notifiers) {
+                    if (const auto d{notifier->FlushDeadline()}; d && (!deadline || *d < *deadline)) deadline = d;
+                }
+            }
+            if (deadline) {
+                m_queue_cv.wait_until(lock, *deadline);
+            } else {
+                m_queue_cv.wait(lock);
+            }
+        }
+        std::deque<std::function<void()>> tasks;
+        tasks.swap(m_queue);
+        const bool stop{m_stop};
+        m_queue_cv.notify_all();
+        {
+            REVERSE_LOCK(lock, m_queue_mutex);
+            for (const auto& task : tasks) task();
+            const auto now{std::chrono::steady_clock::now()};
+            TryForEachAndRemoveFailed([&](CZMQAbstractNotifier* notifier) {
+                const auto deadline{notifier->FlushDeadline()};
+                return !deadline || (!stop && *deadline > now) || notifier->Flush();
+            });
+        }
+        if (stop && m_queue.empty()) return;
+    }
+}
+
+void CZMQNotificationInterface::TryForEachAndRemoveFailed(const std::function<bool(CZMQAbstractNotifier*)>& func)
+{
+    LOCK(m_notifiers_mutex);
     for (auto i = notifiers.begin(); i != notifiers.end(); ) {
         CZMQAbstractNotifier* notifier = i->get();
         if (func(notifier)) {
@@ -145,34 +234,36 @@ void TryForEachAndRemoveFailed(std::list<std::unique_ptr<CZMQAbstractNotifier>>&
     }
 }
 
-} // anonymous namespace
-
 void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
 {
     if (fInitialDownload || pindexNew == pindexFork) // In IBD or blocks were disconnected without any new ones
         return;
 
-    TryForEachAndRemoveFailed(notifiers, [pindexNew](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyBlock(pindexNew);
+    Publish([this, pindexNew] {
+        TryForEachAndRemoveFailed([pindexNew](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyBlock(pindexNew);
+        });
     });
 }
 
 void CZMQNotificationInterface::TransactionAddedToMempool(const NewMempoolTransactionInfo& ptx, uint64_t mempool_sequence)
 {
-    const CTransaction& tx = *(ptx.info.m_tx);
-
-    TryForEachAndRemoveFailed(notifiers, [&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransaction(tx) && notifier->NotifyTransactionAcceptance(tx, mempool_sequence);
+    Publish([this, ptx = ptx.info.m_tx, mempool_sequence] {
+        const CTransaction& tx = *ptx;
+        TryForEachAndRemoveFailed([&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyTransaction(tx) && notifier->NotifyTransactionAcceptance(tx, mempool_sequence);
+        });
     });
 }
 
 void CZMQNotificationInterface::TransactionRemovedFromMempool(const CTransactionRef& ptx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
 {
     // Called for all non-block inclusion reasons
-    const CTransaction& tx = *ptx;
-
-    TryForEachAndRemoveFailed(notifiers, [&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransactionRemoval(tx, mempool_sequence);
+    Publish([this, ptx, mempool_sequence] {
+        const CTransaction& tx = *ptx;
+        TryForEachAndRemoveFailed([&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyTransactionRemoval(tx, mempool_sequence);
+        });
     });
 }
 
@@ -181,31 +272,35 @@ void CZMQNotificationInterface::BlockConnected(ChainstateRole role, const std::s
     if (role == ChainstateRole::BACKGROUND) {
         return;
     }
-    for (const CTransactionRef& ptx : pblock->vtx) {
-        const CTransaction& tx = *ptx;
-        TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-            return notifier->NotifyTransaction(tx);
-        });
-    }
+    Publish([this, pblock, pindexConnected] {
+        for (const CTransactionRef& ptx : pblock->vtx) {
+            const CTransaction& tx = *ptx;
+            TryForEachAndRemoveFailed([&tx](CZMQAbstractNotifier* notifier) {
+                return notifier->NotifyTransaction(tx);
+            });
+        }
 
-    // Next we notify BlockConnect listeners for *all* blocks
-    TryForEachAndRemoveFailed(notifiers, [pindexConnected](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyBlockConnect(pindexConnected);
+        // Next we notify BlockConnect listeners for *all* blocks
+        TryForEachAndRemoveFailed([pindexConnected](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyBlockConnect(pindexConnected);
+        });
     });
 }
 
 void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
 {
-    for (const CTransactionRef& ptx : pblock->vtx) {
-        const CTransaction& tx = *ptx;
-        TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-            return notifier->NotifyTransaction(tx);
-        });
-    }
+    Publish([this, pblock, pindexDisconnected] {
+        for (const CTransactionRef& ptx : pblock->vtx) {
+            const CTransaction& tx = *ptx;
+            TryForEachAndRemoveFailed([&tx](CZMQAbstractNotifier* notifier) {
+                return notifier->NotifyTransaction(tx);
+            });
+        }
 
-    // Next we notify BlockDisconnect listeners for *all* blocks
-    TryForEachAndRemoveFailed(notifiers, [pindexDisconnected](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyBlockDisconnect(pindexDisconnected);
+        // Next we notify BlockDisconnect listeners for *all* blocks
+        TryForEachAndRemoveFailed([pindexDisconnected](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyBlockDisconnect(pindexDisconnected);
+        });
     });
 }
 
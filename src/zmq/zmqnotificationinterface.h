@@ -6,17 +6,24 @@
 #define BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 
 #include <primitives/transaction.h>
+#include <sync.h>
 #include <validationinterface.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
 class CZMQAbstractNotifier;
+class CZMQMempoolServer;
+struct MempoolSnapshot;
 struct NewMempoolTransactionInfo;
 
 class CZMQNotificationInterface final : public CValidationInterface
@@ -24,13 +31,21 @@ class CZMQNotificationInterface final : public CValidationInterface
 public:
     ~CZMQNotificationInterface();
 
-    std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const;
+    std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const EXCLUSIVE_LOCKS_REQUIRED(!m_notifiers_mutex);
 
-    static std::unique_ptr<CZMQNotificationInterface> Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index);
+    //! Start answering -zmqrepmempool requests. Called once the mempool is loaded.
+    void StartMempoolServer();
+
+    static std::unique_ptr<CZMQNotificationInterface> Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index,
+                                                             std::function<std::shared_ptr<const MempoolSnapshot>()> get_mempool_snapshot);
+
+    //! Maximum number of notifications queued for the publisher thread. Once
+    //! reached, validation callbacks wait for it to catch up.
+    static constexpr size_t MAX_PUBLISH_QUEUE{10'000};
 
 protected:
-    bool Initialize();
-    void Shutdown();
+    bool Initialize() EXCLUSIVE_LOCKS_REQUIRED(!m_notifiers_mutex, !m_queue_mutex);
+    void Shutdown() EXCLUSIVE_LOCKS_REQUIRED(!m_notifiers_mutex, !m_queue_mutex);
 
     // CValidationInterface
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override;
@@ -38,12 +53,32 @@ protected:
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected) override;
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected) override;
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+    std::string SubscriberName() const override { return "zmq"; }
 
 private:
     CZMQNotificationInterface();
 
+    //! Queue a notification to be published by the publisher thread.
+    void Publish(std::function<void()> task) EXCLUSIVE_LOCKS_REQUIRED(!m_queue_mutex);
+    //! Publisher thread: send the queued notifications, and the batches of the
+    //! notifiers that hold messages back, until Shutdown().
+    void ThreadPublish() EXCLUSIVE_LOCKS_REQUIRED(!m_notifiers_mutex, !m_queue_mutex);
+    //! Call func for each notifier, shutting down and removing those it fails for.
+    void TryForEachAndRemoveFailed(const std::function<bool(CZMQAbstractNotifier*)>& func) EXCLUSIVE_LOCKS_REQUIRED(!m_notifiers_mutex);
+
     void* pcontext{nullptr};
-    std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
+    mutable Mutex m_notifiers_mutex;
+    std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers GUARDED_BY(m_notifiers_mutex);
+    //! Answers -zmqrepmempool requests, if configured.
+    std::unique_ptr<CZMQMempoolServer> m_mempool_server;
+
+    //! Notifications waiting for the publisher thread, which alone sends on the
+    //! sockets, so that slow subscribers do not hold up validation callbacks.
+    Mutex m_queue_mutex;
+    std::condition_variable m_queue_cv;
+    std::deque<std::function<void()>> m_queue GUARDED_BY(m_queue_mutex);
+    bool m_stop GUARDED_BY(m_queue_mutex){false};
+    std::thread m_publisher;
 };
 
 extern std::unique_ptr<CZMQNotificationInterface> g_zmq_notification_interface;
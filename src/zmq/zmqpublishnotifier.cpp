@@ -44,6 +44,7 @@ static const char *MSG_HASHBLOCK = "hashblock";
 static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
+static const char *MSG_RAWTXBATCH = "rawtxbatch";
 static const char *MSG_SEQUENCE  = "sequence";
 
 // Internal function to send multipart message
@@ -89,17 +90,35 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
     return 0;
 }
 
-static bool IsZMQAddressIPV6(const std::string &zmq_address)
+//! zmq_msg_init_data() deallocation function, dropping the reference to the
+//! owner of the bytes of the message once libzmq is done with them.
+static void ReleaseZmqMessageOwner(void* /*data*/, void* hint)
 {
-    const std::string tcp_prefix = "tcp://";
-    const size_t tcp_index = zmq_address.rfind(tcp_prefix);
-    const size_t colon_index = zmq_address.rfind(':');
-    if (tcp_index == 0 && colon_index != std::string::npos) {
-        const std::string ip = zmq_address.substr(tcp_prefix.length(), colon_index - tcp_prefix.length());
-        const std::optional<CNetAddr> addr{LookupHost(ip, false)};
-        if (addr.has_value() && addr.value().IsIPv6()) return true;
+    delete static_cast<std::shared_ptr<const void>*>(hint);
+}
+
+// Internal function to send a message part, closing the message
+static bool zmq_send_part(void* sock, zmq_msg_t& msg, bool more)
+{
+    if (zmq_msg_send(&msg, sock, more ? ZMQ_SNDMORE : 0) == -1) {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
     }
-    return false;
+    zmq_msg_close(&msg);
+    return true;
+}
+
+// Internal function to send a message part holding a copy of data
+static bool zmq_send_copy(void* sock, const void* data, size_t size, bool more)
+{
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, size) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        return false;
+    }
+    memcpy(zmq_msg_data(&msg), data, size);
+    return zmq_send_part(sock, msg, more);
 }
 
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
@@ -217,6 +236,29 @@ bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void
     return true;
 }
 
+bool CZMQAbstractPublishNotifier::SendZmqMessage(const char* command, std::shared_ptr<const void> owner, std::span<const std::byte> data)
+{
+    assert(psocket);
+
+    if (!zmq_send_copy(psocket, command, strlen(command), /*more=*/true)) return false;
+
+    zmq_msg_t msg;
+    auto* hint{new std::shared_ptr<const void>{std::move(owner)}};
+    if (zmq_msg_init_data(&msg, const_cast<std::byte*>(data.data()), data.size(), ReleaseZmqMessageOwner, hint) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        delete hint;
+        return false;
+    }
+    if (!zmq_send_part(psocket, msg, /*more=*/true)) return false;
+
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(msgseq, nSequence);
+    if (!zmq_send_copy(psocket, msgseq, sizeof(msgseq), /*more=*/false)) return false;
+
+    nSequence++;
+    return true;
+}
+
 bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     uint256 hash = pindex->GetBlockHash();
@@ -243,22 +285,53 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogDebug(BCLog::ZMQ, "Publish rawblock %s to %s\n", pindex->GetBlockHash().GetHex(), this->address);
 
-    std::vector<std::byte> block{};
-    if (!m_get_block_by_index(block, *pindex)) {
+    auto block{std::make_shared<std::vector<std::byte>>()};
+    if (!m_get_block_by_index(*block, *pindex)) {
         zmqError("Can't read block from disk");
         return false;
     }
 
-    return SendZmqMessage(MSG_RAWBLOCK, block.data(), block.size());
+    const std::span<const std::byte> data{*block};
+    return SendZmqMessage(MSG_RAWBLOCK, std::move(block), data);
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
 {
     uint256 hash = transaction.GetHash();
     LogDebug(BCLog::ZMQ, "Publish rawtx %s to %s\n", hash.GetHex(), this->address);
-    DataStream ss;
-    ss << TX_WITH_WITNESS(transaction);
-    return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    auto ss{std::make_shared<DataStream>()};
+    *ss << TX_WITH_WITNESS(transaction);
+    const std::span<const std::byte> data{*ss};
+    return SendZmqMessage(MSG_RAWTX, std::move(ss), data);
+}
+
+bool CZMQPublishRawTransactionBatchNotifier::NotifyTransaction(const CTransaction &transaction)
+{
+    if (m_batch_count == 0) m_deadline = std::chrono::steady_clock::now() + m_interval;
+    m_batch << TX_WITH_WITNESS(transaction);
+    ++m_batch_count;
+    return m_batch.size() < MAX_BATCH_SIZE || Flush();
+}
+
+std::optional<std::chrono::steady_clock::time_point> CZMQPublishRawTransactionBatchNotifier::FlushDeadline() const
+{
+    if (m_batch_count == 0) return std::nullopt;
+    return m_deadline;
+}
+
+bool CZMQPublishRawTransactionBatchNotifier::Flush()
+{
+    if (m_batch_count == 0) return true;
+    LogDebug(BCLog::ZMQ, "Publish rawtxbatch of %d transactions to %s\n", m_batch_count, this->address);
+    // The body is the serialization of the vector of transactions.
+    auto ss{std::make_shared<DataStream>()};
+    ss->reserve(GetSizeOfCompactSize(m_batch_count) + m_batch.size());
+    WriteCompactSize(*ss, m_batch_count);
+    ss->write(m_batch);
+    m_batch.clear();
+    m_batch_count = 0;
+    const std::span<const std::byte> data{*ss};
+    return SendZmqMessage(MSG_RAWTXBATCH, std::move(ss), data);
 }
 
 // Helper function to send a 'sequence' topic message with the following structure:
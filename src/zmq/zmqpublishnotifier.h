@@ -5,11 +5,16 @@
 #ifndef BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 
+#include <streams.h>
 #include <zmq/zmqabstractnotifier.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 class CBlockIndex;
@@ -30,6 +35,11 @@ public:
     */
     bool SendZmqMessage(const char *command, const void* data, size_t size);
 
+    /* send zmq multipart message whose data part references the bytes of
+       `data`, kept alive by `owner` until libzmq is done with them, instead
+       of copying them */
+    bool SendZmqMessage(const char* command, std::shared_ptr<const void> owner, std::span<const std::byte> data);
+
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
 };
@@ -63,6 +73,26 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+/** Publishes the serialized transactions of rawtx in batches, at most once per interval. */
+class CZMQPublishRawTransactionBatchNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    const std::chrono::milliseconds m_interval;
+    //! Transactions held back, serialized one after the other.
+    DataStream m_batch;
+    uint64_t m_batch_count{0};
+    std::chrono::steady_clock::time_point m_deadline;
+
+public:
+    //! Publish a batch early once its transactions take this many bytes.
+    static constexpr size_t MAX_BATCH_SIZE{1 << 20};
+
+    explicit CZMQPublishRawTransactionBatchNotifier(std::chrono::milliseconds interval) : m_interval{interval} {}
+    bool NotifyTransaction(const CTransaction &transaction) override;
+    std::optional<std::chrono::steady_clock::time_point> FlushDeadline() const override;
+    bool Flush() override;
+};
+
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
 {
 public:
@@ -9,6 +9,9 @@
 
 void zmqError(const std::string& str);
 
+/** Whether the address is a TCP address with an IPv6 host, for which ZMQ_IPV6 must be enabled */
+bool IsZMQAddressIPV6(const std::string& zmq_address);
+
 /** Prefix for unix domain socket addresses (which are local filesystem paths) */
 const std::string ADDR_PREFIX_IPC = "ipc://"; // used by libzmq, example "ipc:///root/path/to/file"
 
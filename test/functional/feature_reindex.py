@@ -67,16 +67,19 @@ class ReindexTest(BitcoinTestFramework):
             bf.write(util_xor(b[b3_start:b4_start], xor_dat, offset=b2_start))
             bf.write(util_xor(b[b2_start:b3_start], xor_dat, offset=b3_start))
 
-        # The reindexing code should detect and accommodate out of order blocks.
-        with self.nodes[0].assert_debug_log([
-            'LoadExternalBlockFile: Out of order block',
-            'LoadExternalBlockFile: Processing out of order child',
-        ]):
-            extra_args = [["-reindex"]]
-            self.start_nodes(extra_args)
-
-        # All blocks should be accepted and processed.
-        assert_equal(self.nodes[0].getblockcount(), 12)
+        # The reindexing code should detect and accommodate out of order blocks,
+        # whether or not the block files are scanned in parallel.
+        for extra_args in [["-reindex"], ["-reindex", "-reindexscanthreads=2"]]:
+            with self.nodes[0].assert_debug_log([
+                'LoadExternalBlock: Out of order block',
+                'LoadExternalBlock: Processing out of order child',
+            ]):
+                self.start_nodes([extra_args])
+
+            # All blocks should be accepted and processed.
+            assert_equal(self.nodes[0].getblockcount(), 12)
+            self.stop_nodes()
+        self.start_nodes()
 
     def continue_reindex_after_shutdown(self):
         node = self.nodes[0]
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the scripthashindex.
+
+Test the getscripthashhistory RPC and the /rest/scripthash/ endpoint, and
+that the index follows reorgs.
+"""
+
+import hashlib
+import http.client
+from io import BytesIO
+import json
+import struct
+import urllib.parse
+
+from test_framework.messages import deser_compact_size
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+def scripthash(script):
+    return hashlib.sha256(script).digest()[::-1].hex()
+
+
+class ScriptHashIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [["-scripthashindex", "-rest"], []]
+
+    def rest_get(self, uri, query_params):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request('GET', f'/rest/{uri}?{urllib.parse.urlencode(query_params)}')
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        self.wait_until(lambda: node.getindexinfo('scripthashindex')['scripthashindex']['synced'])
+
+        self.log.info("Test the history of a new script")
+        _, dest_script, _ = getnewdestination()
+        sent = self.wallet.send_to(from_node=node, scriptPubKey=dest_script, amount=100000)
+        self.generate(self.wallet, 1)
+        height = node.getblockcount()
+        blockhash = node.getbestblockhash()
+        dest_hash = scripthash(dest_script)
+        assert_equal(node.getscripthashhistory(dest_hash), {
+            'scripthash': dest_hash,
+            'history': [{'height': height, 'blockhash': blockhash, 'txpos': 1, 'txid': sent['txid'], 'type': 'funding'}],
+        })
+
+        self.log.info("Test a transaction both spending from and paying to a script")
+        wallet_hash = scripthash(self.wallet.get_output_script())
+        history = node.getscripthashhistory(wallet_hash, height, height)['history']
+        assert_equal([(entry['txid'], entry['type']) for entry in history],
+                     [(node.getblock(blockhash)['tx'][0], 'funding'), (sent['txid'], 'funding'), (sent['txid'], 'spending')])
+
+        self.log.info("Test paging")
+        full = node.getscripthashhistory(wallet_hash)
+        assert 'next_height' not in full
+        page = node.getscripthashhistory(wallet_hash, 0, height, 10)
+        assert_equal(page['history'], full['history'][:10])
+        rest = node.getscripthashhistory(wallet_hash, page['next_height'])
+        assert_equal(page['history'] + rest['history'], full['history'])
+
+        self.log.info("Test the REST interface")
+        status, body = self.rest_get(f'scripthash/{wallet_hash}.json', {'count': 10})
+        assert_equal(status, 200)
+        assert_equal(json.loads(body), page)
+        status, body = self.rest_get(f'scripthash/{dest_hash}.bin', {'start': height})
+        assert_equal(status, 200)
+        assert_equal(struct.unpack('<i', body[:4])[0], -1)
+        assert_equal(body[4:], bytes([1]) + struct.pack('<i', height) + bytes([1, 0]))
+        status, body = self.rest_get(f'scripthash/{wallet_hash}.bin', {'count': 10})
+        assert_equal(status, 200)
+        assert_equal(struct.unpack('<i', body[:4])[0], page['next_height'])
+        assert_equal(deser_compact_size(BytesIO(body[4:])), len(page['history']))
+        status, _ = self.rest_get(f'scripthash/{dest_hash}.json', {'count': 0})
+        assert_equal(status, 400)
+        status, _ = self.rest_get(f'scripthash/{dest_hash}.json', {'start': height, 'end': height - 1})
+        assert_equal(status, 400)
+
+        self.log.info("Test that disconnected blocks are removed from the index")
+        node.invalidateblock(blockhash)
+        self.generateblock(node, output=self.wallet.get_address(), transactions=[], sync_fun=self.no_op)
+        assert_equal(node.getscripthashhistory(dest_hash)['history'], [])
+        self.generate(node, 1)
+        assert_equal(node.getscripthashhistory(dest_hash)['history'][0]['txid'], sent['txid'])
+
+        self.log.info("Test errors")
+        assert_raises_rpc_error(-8, "Invalid range of heights", node.getscripthashhistory, dest_hash, 10, 9)
+        assert_raises_rpc_error(-8, "count must be between 1 and 100000", node.getscripthashhistory, dest_hash, 0, 10, 0)
+        assert_raises_rpc_error(-1, "Index is not enabled", self.nodes[1].getscripthashhistory, dest_hash)
+
+
+if __name__ == '__main__':
+    ScriptHashIndexTest(__file__).main()
@@ -109,6 +109,13 @@ class TestBitcoinCli(BitcoinTestFramework):
         assert_equal(['foo', 'bar'], self.nodes[0].cli(f'-rpcuser={user}', '-stdin', '-stdinrpcpass', input=f'{password}\nfoo\nbar').echo())
         assert_raises_process_error(1, 'Incorrect rpcuser or rpcpassword', self.nodes[0].cli(f'-rpcuser={user}', '-stdin', '-stdinrpcpass', input='foo').echo)
 
+        self.log.info("Test -batch")
+        commands = [f"getblockhash {height}" for height in range(BLOCKS + 1)] + ["", "getblockcount", "echo a  b"]
+        lines = self.nodes[0].cli('-batch', '-batchsize=7', input="\n".join(commands)).send_cli().split("\n")
+        assert_equal(lines, [self.nodes[0].getblockhash(height) for height in range(BLOCKS + 1)] + [str(BLOCKS), '["a","b"]'])
+        assert_raises_process_error(8, "line 2: error code: -8", self.nodes[0].cli('-batch', input="getblockcount\ngetblockhash -1").send_cli)
+        assert_raises_process_error(1, "-batch and -stdin cannot be used together", self.nodes[0].cli('-batch', '-stdin', input="").send_cli)
+
         self.log.info("Test connecting to a non-existing server")
         assert_raises_process_error(1, "Could not connect to the server", self.nodes[0].cli('-rpcport=1').echo)
 
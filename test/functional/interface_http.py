@@ -8,6 +8,7 @@ from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import assert_equal, str_to_b64str
 
 import http.client
+import json
 import time
 import urllib.parse
 
@@ -178,6 +179,29 @@ class HTTPBasicsTest (BitcoinTestFramework):
         out1 = conn.getresponse().read()
         assert_equal(out1, b'{"result":"high-hash","error":null}\n')
 
+        self.log.info("Check binary results")
+        blockhash = self.nodes[0].getbestblockhash()
+        headers_binary = {"Authorization": f"Basic {str_to_b64str(authpair)}", "Accept": "application/octet-stream"}
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        for method, params, expected in [
+            ("getblock", [blockhash, 0], self.nodes[0].getblock(blockhash, 0)),
+            ("getblockheader", [blockhash, False], self.nodes[0].getblockheader(blockhash, False)),
+        ]:
+            conn.request('POST', '/', json.dumps({"method": method, "params": params}), headers_binary)
+            response = conn.getresponse()
+            assert_equal(response.getheader("Content-Type"), "application/octet-stream")
+            assert_equal(response.read(), bytes.fromhex(expected))
+        # Other results, and errors, are still JSON
+        conn.request('POST', '/', '{"method": "getblockcount"}', headers_binary)
+        response = conn.getresponse()
+        assert_equal(response.getheader("Content-Type"), "application/json")
+        assert_equal(json.loads(response.read())["result"], self.nodes[0].getblockcount())
+        conn.request('POST', '/', json.dumps({"method": "getblock", "params": ["00" * 32, 0]}), headers_binary)
+        response = conn.getresponse()
+        assert_equal(response.status, 500)
+        assert_equal(response.getheader("Content-Type"), "application/json")
+        assert_equal(json.loads(response.read())["error"]["message"], "Block not found")
+        conn.close()
 
         self.log.info("Check -rpcservertimeout")
         # The test framework typically reuses a single persistent HTTP connection
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the OpenMetrics endpoint served with -metrics."""
+
+import http.client
+import urllib.parse
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+
+class MetricsTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [["-metrics", "-txindex"], []]
+        self.supports_cli = False
+
+    def request(self, node, method="GET"):
+        url = urllib.parse.urlparse(node.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request(method, "/metrics")
+        return conn.getresponse()
+
+    def get_metrics(self, node):
+        resp = self.request(node)
+        assert_equal(resp.status, 200)
+        assert resp.getheader("Content-Type").startswith("application/openmetrics-text")
+        body = resp.read().decode()
+        assert body.endswith("# EOF\n")
+        samples = {}
+        for line in body.splitlines():
+            if line.startswith("#"):
+                continue
+            name, value = line.rsplit(" ", 1)
+            samples[name] = float(value)
+        return samples
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+
+        self.log.info("Check that metrics are served without authentication")
+        metrics = self.get_metrics(node)
+        assert_equal(metrics["bitcoin_chain_height"], node.getblockcount())
+        assert_equal(metrics['bitcoin_peers{direction="inbound"}'] + metrics['bitcoin_peers{direction="outbound"}'], len(node.getpeerinfo()))
+
+        self.log.info("Check the metrics of the chain, mempool and indexes")
+        self.generate(wallet, 3)
+        self.sync_all()
+        self.wait_until(lambda: node.getindexinfo("txindex")["txindex"]["synced"])
+        metrics = self.get_metrics(node)
+        assert_equal(metrics["bitcoin_chain_height"], node.getblockcount())
+        assert_equal(metrics['bitcoin_index_height{index="txindex"}'], node.getblockcount())
+        assert_greater_than(metrics["bitcoin_blocks_connected_total"], 0)
+        assert_equal(metrics['bitcoin_block_connect_seconds_bucket{le="+Inf"}'], metrics["bitcoin_block_connect_seconds_count"])
+        assert_greater_than(metrics["bitcoin_net_received_bytes_total"], 0)
+
+        tx = wallet.send_self_transfer(from_node=node)
+        metrics = self.get_metrics(node)
+        assert_equal(metrics["bitcoin_mempool_transactions"], 1)
+        assert_equal(metrics["bitcoin_mempool_vsize_bytes"], tx["tx"].get_vsize())
+        accepted = metrics['bitcoin_mempool_accept_total{result="accepted"}']
+        assert_greater_than(accepted, 0)
+        self.generate(node, 1)
+        metrics = self.get_metrics(node)
+        assert_equal(metrics["bitcoin_mempool_transactions"], 0)
+        assert_greater_than(metrics['bitcoin_mempool_removed_total{reason="block"}'], 0)
+
+        self.log.info("Check the RPC metrics")
+        calls = metrics.get('bitcoin_rpc_requests_total{method="getblockcount"}', 0)
+        errors = metrics["bitcoin_rpc_errors_total"]
+        node.getblockcount()
+        assert_raises_rpc_error(-8, "Block height out of range", node.getblockhash, -1)
+        metrics = self.get_metrics(node)
+        assert_equal(metrics['bitcoin_rpc_requests_total{method="getblockcount"}'], calls + 1)
+        assert_equal(metrics["bitcoin_rpc_errors_total"], errors + 1)
+
+        self.log.info("Check that only GET requests are served")
+        assert_equal(self.request(node, "POST").status, 405)
+
+        self.log.info("Check that metrics are not served by default")
+        assert_equal(self.request(self.nodes[1]).status, 404)
+
+
+if __name__ == '__main__':
+    MetricsTest(__file__).main()
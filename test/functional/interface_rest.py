@@ -17,12 +17,15 @@ from test_framework.messages import (
     BLOCK_HEADER_SIZE,
     COIN,
     deser_block_spent_outputs,
+    ser_compact_size,
+    ser_uint256_vector,
 )
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
     assert_equal,
     assert_greater_than,
     assert_greater_than_or_equal,
+    assert_raises_rpc_error,
 )
 from test_framework.wallet import (
     MiniWallet,
@@ -67,6 +70,7 @@ class RESTTest (BitcoinTestFramework):
             status: int = 200,
             ret_type: RetType = RetType.JSON,
             query_params: Optional[dict[str, typing.Any]] = None,
+            headers: Optional[dict[str, str]] = None,
             ) -> typing.Union[http.client.HTTPResponse, bytes, str, None]:
         rest_uri = '/rest' + uri
         if req_type in ReqType:
@@ -77,9 +81,9 @@ class RESTTest (BitcoinTestFramework):
         conn = http.client.HTTPConnection(self.url.hostname, self.url.port)
         self.log.debug(f'{http_method} {rest_uri} {body}')
         if http_method == 'GET':
-            conn.request('GET', rest_uri)
+            conn.request('GET', rest_uri, headers=headers or {})
         elif http_method == 'POST':
-            conn.request('POST', rest_uri, body)
+            conn.request('POST', rest_uri, body, headers=headers or {})
         resp = conn.getresponse()
 
         assert_equal(resp.status, status)
@@ -214,11 +218,31 @@ class RESTTest (BitcoinTestFramework):
         self.test_rest_request("/getutxos/aa-1234", ret_type=RetType.OBJ, status=400)
 
         # Test limits
-        long_uri = '/'.join([f"{txid}-{n_}" for n_ in range(20)])
-        self.test_rest_request(f"/getutxos/checkmempool/{long_uri}", http_method='POST', status=400, ret_type=RetType.OBJ)
-
-        long_uri = '/'.join([f'{txid}-{n_}' for n_ in range(15)])
-        self.test_rest_request(f"/getutxos/checkmempool/{long_uri}", http_method='POST', status=200)
+        long_uri = '/'.join([f'{txid}-{n_}' for n_ in range(20)])
+        json_obj = self.test_rest_request(f"/getutxos/checkmempool/{long_uri}", http_method='POST', status=200)
+        assert_equal(json_obj['bitmap'], ''.join('1' if n_ == spending[1] else '0' for n_ in range(20)))
+
+        max_outpoints = 100_000
+        outpoints_bin = (bytes.fromhex(txid)[::-1] + (0).to_bytes(4, 'little')) * (max_outpoints + 1)
+        self.test_rest_request("/getutxos", http_method='POST', req_type=ReqType.BIN, body=b'\x01' + ser_compact_size(max_outpoints + 1) + outpoints_bin, status=400, ret_type=RetType.OBJ)
+        bin_response = self.test_rest_request("/getutxos", http_method='POST', req_type=ReqType.BIN, body=b'\x01' + ser_compact_size(max_outpoints) + outpoints_bin[36:], ret_type=RetType.BYTES)
+        assert_equal(bin_response[36:39], ser_compact_size((max_outpoints + 7) // 8))
+
+        self.log.info("Test the gettxouts RPC")
+        outputs = [{"txid": txid, "vout": n_} for n_ in range(3)] + [{"txid": spent[0], "vout": spent[1]}]
+        for include_mempool in [True, False]:
+            res = self.nodes[0].gettxouts(outputs, include_mempool)
+            assert_equal(res['bestblock'], self.nodes[0].getbestblockhash())
+            assert_equal(res['height'], self.nodes[0].getblockcount())
+            expected = [(o, self.nodes[0].gettxout(o['txid'], o['vout'], include_mempool)) for o in outputs]
+            assert_equal(res['bitmap'], ''.join('0' if txout is None else '1' for _, txout in expected))
+            found = [(o, txout) for o, txout in expected if txout is not None]
+            assert_equal(len(res['txouts']), len(found))
+            for txout, (o, expected_txout) in zip(res['txouts'], found):
+                assert_equal((txout.pop('txid'), txout.pop('vout')), (o['txid'], o['vout']))
+                expected_txout.pop('bestblock')
+                assert_equal(txout, expected_txout)
+        assert_raises_rpc_error(-8, "vout cannot be negative", self.nodes[0].gettxouts, [{"txid": txid, "vout": -1}])
 
         self.generate(self.nodes[0], 1)  # generate block to not affect upcoming tests
 
@@ -258,6 +282,38 @@ class RESTTest (BitcoinTestFramework):
         response_header_hex_bytes = response_header_hex.read(BLOCK_HEADER_SIZE*2)
         assert_equal(response_bytes[:BLOCK_HEADER_SIZE].hex().encode(), response_header_hex_bytes)
 
+        self.log.info("Test caching of blocks")
+        etag = response.getheader('ETag')
+        assert_equal(etag, f'"{bb_hash}.bin"')
+        assert_equal(response.getheader('Cache-Control'), 'no-cache')
+        assert_equal(response.getheader('Accept-Ranges'), 'bytes')
+        assert_equal(response_hex.getheader('ETag'), f'"{bb_hash}.hex"')
+        response = self.test_rest_request(f"/block/{bb_hash}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=304, headers={'If-None-Match': etag})
+        assert_equal(response.getheader('ETag'), etag)
+        assert_equal(response.read(), b'')
+        self.test_rest_request(f"/block/{bb_hash}", req_type=ReqType.BIN, ret_type=RetType.BYTES, headers={'If-None-Match': '"other"'})
+        # The JSON contains the confirmations, so it is not cached
+        response = self.test_rest_request(f"/block/{bb_hash}", ret_type=RetType.OBJ, headers={'If-None-Match': '*'})
+        assert_equal(response.getheader('ETag'), None)
+
+        # Deeply confirmed blocks are immutable
+        deep_hash = self.nodes[0].getblockhash(1)
+        response = self.test_rest_request(f"/block/{deep_hash}", req_type=ReqType.BIN, ret_type=RetType.OBJ)
+        assert_equal(response.getheader('Cache-Control'), 'public, max-age=31536000, immutable')
+        deep_bytes = response.read()
+
+        self.log.info("Test range requests of binary blocks")
+        response = self.test_rest_request(f"/block/{deep_hash}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=206, headers={'Range': 'bytes=0-79'})
+        assert_equal(response.getheader('Content-Range'), f'bytes 0-79/{len(deep_bytes)}')
+        assert_equal(response.read(), deep_bytes[:80])
+        response = self.test_rest_request(f"/block/{deep_hash}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=206, headers={'Range': 'bytes=-10'})
+        assert_equal(response.read(), deep_bytes[-10:])
+        response = self.test_rest_request(f"/block/{deep_hash}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=416, headers={'Range': f'bytes={len(deep_bytes)}-'})
+        assert_equal(response.getheader('Content-Range'), f'bytes */{len(deep_bytes)}')
+        # A range is ignored for another version of the resource
+        response = self.test_rest_request(f"/block/{deep_hash}", req_type=ReqType.BIN, ret_type=RetType.BYTES, headers={'Range': 'bytes=0-79', 'If-Range': '"other"'})
+        assert_equal(response, deep_bytes)
+
         # Check json format
         block_json_obj = self.test_rest_request(f"/block/{bb_hash}")
         assert_equal(block_json_obj['hash'], bb_hash)
@@ -281,6 +337,19 @@ class RESTTest (BitcoinTestFramework):
         assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid height: -1")
         self.test_rest_request("/blockhashbyheight/", ret_type=RetType.OBJ, status=400)
 
+        # Check headers by height, which stop at the tip
+        height = block_json_obj['height']
+        resp_bytes = self.test_rest_request(f"/headersbyheight/{height - 1}", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"count": 10})
+        assert_equal(resp_bytes, bytes.fromhex(self.nodes[0].getblockheaders(height - 1, 10)))
+        assert_equal(resp_bytes[-80:], bytes.fromhex(self.nodes[0].getblockheader(bb_hash, False)))
+        resp_hex = self.test_rest_request(f"/headersbyheight/{height - 1}", req_type=ReqType.HEX, ret_type=RetType.OBJ, query_params={"count": 10})
+        assert_equal(resp_hex.read().decode('utf-8').rstrip(), resp_bytes.hex())
+        resp = self.test_rest_request(f"/headersbyheight/{height + 1}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request("/headersbyheight/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"count": 0})
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Header count is invalid or out of acceptable range (1-100000): 0")
+        self.test_rest_request("/headersbyheight/0", ret_type=RetType.OBJ, status=404)
+
         # Compare with json block header
         json_obj = self.test_rest_request(f"/headers/{bb_hash}", query_params={"count": 1})
         assert_equal(len(json_obj), 1)  # ensure that there is one header in the json response
@@ -371,12 +440,27 @@ class RESTTest (BitcoinTestFramework):
 
         assert_equal(json_obj, raw_mempool)
 
+        # Check the binary and hex mempool responses, which only contain the txids
+        txids_bin = ser_uint256_vector([int(txid, 16) for txid in raw_mempool])
+        assert_equal(self.test_rest_request("/mempool/contents", req_type=ReqType.BIN, ret_type=RetType.BYTES), txids_bin)
+        hex_response = self.test_rest_request("/mempool/contents", req_type=ReqType.HEX, ret_type=RetType.BYTES)
+        assert_equal(hex_response.decode().strip(), txids_bin.hex())
+        self.test_rest_request("/mempool/info", req_type=ReqType.BIN, status=404, ret_type=RetType.OBJ)
+
         # Check the mempool response for sequence
         json_obj = self.test_rest_request("/mempool/contents", query_params={"verbose": "false", "mempool_sequence": "true"})
         raw_mempool = self.nodes[0].getrawmempool(verbose=False, mempool_sequence=True)
 
         assert_equal(json_obj, raw_mempool)
 
+        # Check the mempool delta response since the first of the 3 txs
+        delta_sequence = raw_mempool["mempool_sequence"] - 3
+        json_obj = self.test_rest_request("/mempool/delta", query_params={"since": delta_sequence})
+        assert_equal(json_obj, self.nodes[0].getmempooldelta(delta_sequence))
+        assert_equal({change["txid"] for change in json_obj["changes"]}, set(txs))
+        resp = self.test_rest_request("/mempool/delta", ret_type=RetType.OBJ, status=400, query_params={"since": "abc"})
+        assert_equal(resp.read().decode('utf-8').strip(), 'The "since" query parameter must be a mempool sequence value.')
+
         # Check for error response if verbose=true and mempool_sequence=true
         resp = self.test_rest_request("/mempool/contents", ret_type=RetType.OBJ, status=400, query_params={"verbose": "true", "mempool_sequence": "true"})
         assert_equal(resp.read().decode('utf-8').strip(), 'Verbose results cannot contain mempool sequence values. (hint: set "verbose=false")')
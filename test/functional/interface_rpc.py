@@ -6,6 +6,7 @@
 
 import json
 import os
+import time
 from dataclasses import dataclass
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import assert_equal, assert_greater_than_or_equal
@@ -177,6 +178,19 @@ class RPCInterfaceTest(BitcoinTestFramework):
             request_fields={"jsonrpc": "2.1"},
             response_fields={"result": None, "error": {"code": RPC_INVALID_REQUEST, "message": "JSON-RPC version not supported"}}))
 
+    def test_parallel_batch(self):
+        self.log.info("Testing that the requests of a batch are executed in parallel...")
+        node = self.nodes[0]
+        tip = node.getbestblockhash()
+        # Each request blocks for a second, so 8 of them would take 8 seconds in sequence.
+        request = [{"jsonrpc": "2.0", "method": "waitfornewblock", "params": [1000], "id": idx} for idx in range(8)]
+        start = time.time()
+        rpc_response, http_status = send_json_rpc(node, request)
+        elapsed = time.time() - start
+        assert_equal(http_status, 200)
+        assert_equal(rpc_response, [{"jsonrpc": "2.0", "result": {"hash": tip, "height": 0}, "id": idx} for idx in range(8)])
+        assert elapsed < 6, f"batch took {elapsed:.1f}s"
+
     def test_http_status_codes(self):
         self.log.info("Testing HTTP status codes for JSON-RPC 1.1 requests...")
         # OK
@@ -238,11 +252,31 @@ class RPCInterfaceTest(BitcoinTestFramework):
         for t in threads:
             t.join()
 
+    def test_work_queue_wait(self):
+        self.log.info("Testing requests waiting for room in a full work queue...")
+        self.restart_node(0, ['-rpcworkqueue=1', '-rpcthreads=1', '-rpcworkqueuewait=60000', '-rpcserverthreads=2'])
+        errors = []
+
+        def call():
+            try:
+                self.nodes[0].cli("waitfornewblock", "500").send_cli()
+            except subprocess.CalledProcessError as e:
+                errors.append(e.output)
+
+        threads = [Thread(target=call) for _ in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert_equal(errors, [])
+
     def run_test(self):
         self.test_getrpcinfo()
         self.test_batch_requests()
+        self.test_parallel_batch()
         self.test_http_status_codes()
         self.test_work_queue_exceeded()
+        self.test_work_queue_wait()
 
 
 if __name__ == '__main__':
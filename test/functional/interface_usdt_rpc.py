@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+""" Tests the rpc:* and http:* tracepoint API interface.
+    See https://github.com/bitcoin/bitcoin/blob/master/doc/tracing.md#context-rpc
+"""
+
+import ctypes
+
+# Test will be skipped if we don't have bcc installed
+try:
+    from bcc import BPF, USDT # type: ignore[import]
+except ImportError:
+    pass
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+    bpf_cflags,
+)
+
+MAX_METHOD_LENGTH = 32
+
+rpc_tracepoints_program = """
+#include <uapi/linux/ptrace.h>
+
+#define MAX_METHOD_LENGTH """ + str(MAX_METHOD_LENGTH) + """
+
+struct rpc_request
+{
+    char    method[MAX_METHOD_LENGTH];
+    s64     duration;
+    bool    success;
+    bool    end;
+};
+
+struct http_request
+{
+    u64     depth;
+    u64     max_depth;
+    bool    added;
+};
+
+BPF_PERF_OUTPUT(rpc_requests);
+BPF_PERF_OUTPUT(http_requests);
+
+int trace_request_start(struct pt_regs *ctx) {
+    struct rpc_request request = {};
+    bpf_usdt_readarg_p(1, ctx, &request.method, MAX_METHOD_LENGTH);
+    rpc_requests.perf_submit(ctx, &request, sizeof(request));
+    return 0;
+}
+
+int trace_request_end(struct pt_regs *ctx) {
+    struct rpc_request request = {};
+    bpf_usdt_readarg_p(1, ctx, &request.method, MAX_METHOD_LENGTH);
+    bpf_usdt_readarg(3, ctx, &request.duration);
+    bpf_usdt_readarg(4, ctx, &request.success);
+    request.end = true;
+    rpc_requests.perf_submit(ctx, &request, sizeof(request));
+    return 0;
+}
+
+int trace_request_enqueued(struct pt_regs *ctx) {
+    struct http_request request = {};
+    bpf_usdt_readarg(1, ctx, &request.depth);
+    bpf_usdt_readarg(2, ctx, &request.max_depth);
+    bpf_usdt_readarg(3, ctx, &request.added);
+    http_requests.perf_submit(ctx, &request, sizeof(request));
+    return 0;
+}
+"""
+
+
+class RPCTracepointTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [["-rpcworkqueue=8"]]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_platform_not_linux()
+        self.skip_if_no_bitcoind_tracepoints()
+        self.skip_if_no_python_bcc()
+        self.skip_if_no_bpf_permissions()
+        self.skip_if_running_under_valgrind()
+
+    def run_test(self):
+        class RPCRequest(ctypes.Structure):
+            _fields_ = [
+                ("method", ctypes.c_char * MAX_METHOD_LENGTH),
+                ("duration", ctypes.c_int64),
+                ("success", ctypes.c_bool),
+                ("end", ctypes.c_bool),
+            ]
+
+        class HTTPRequest(ctypes.Structure):
+            _fields_ = [
+                ("depth", ctypes.c_uint64),
+                ("max_depth", ctypes.c_uint64),
+                ("added", ctypes.c_bool),
+            ]
+
+        self.log.info("hook into the rpc:request_start, rpc:request_end and http:request_enqueued tracepoints")
+        ctx = USDT(pid=self.nodes[0].process.pid)
+        ctx.enable_probe(probe="rpc:request_start", fn_name="trace_request_start")
+        ctx.enable_probe(probe="rpc:request_end", fn_name="trace_request_end")
+        ctx.enable_probe(probe="http:request_enqueued", fn_name="trace_request_enqueued")
+        bpf = BPF(text=rpc_tracepoints_program, usdt_contexts=[ctx], debug=0, cflags=bpf_cflags())
+
+        rpc_events = []
+        http_events = []
+        bpf["rpc_requests"].open_perf_buffer(lambda _, data, __: rpc_events.append(ctypes.cast(data, ctypes.POINTER(RPCRequest)).contents))
+        bpf["http_requests"].open_perf_buffer(lambda _, data, __: http_events.append(ctypes.cast(data, ctypes.POINTER(HTTPRequest)).contents))
+
+        self.log.info("send a successful and a failing request")
+        self.nodes[0].getblockcount()
+        assert_raises_rpc_error(-8, "Block height out of range", self.nodes[0].getblockhash, 1000)
+        bpf.perf_buffer_poll(timeout=200)
+
+        self.log.info("check that the requests were traced")
+        assert_equal([(e.method.decode(), e.end) for e in rpc_events], [
+            ("getblockcount", False),
+            ("getblockcount", True),
+            ("getblockhash", False),
+            ("getblockhash", True),
+        ])
+        assert_equal([e.success for e in rpc_events if e.end], [True, False])
+        for event in rpc_events:
+            if event.end:
+                assert event.duration > 0
+        assert_equal(len(http_events), 2)
+        for event in http_events:
+            assert event.added
+            assert_equal(event.max_depth, 8)
+            assert event.depth >= 1
+
+        bpf.cleanup()
+
+
+if __name__ == '__main__':
+    RPCTracepointTest(__file__).main()
@@ -20,6 +20,8 @@ from test_framework.blocktools import (
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.messages import (
     CBlock,
+    CTransaction,
+    deser_compact_size,
     hash256,
     tx_from_hex,
 )
@@ -125,6 +127,8 @@ class ZMQTest (BitcoinTestFramework):
                 self.test_basic(unix=True)
             else:
                 self.log.info("Skipping ipc test, because UNIX sockets are not supported.")
+            self.test_rawtxbatch()
+            self.test_mempool_snapshot()
             self.test_sequence()
             self.test_mempool_sync()
             self.test_reorg()
@@ -137,7 +141,7 @@ class ZMQTest (BitcoinTestFramework):
 
     # Restart node with the specified zmq notifications enabled, subscribe to
     # all of them and return the corresponding ZMQSubscriber objects.
-    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, ipv6=False):
+    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, ipv6=False, extra_args=()):
         subscribers = []
         for topic, address in services:
             socket = self.ctx.socket(zmq.SUB)
@@ -145,7 +149,7 @@ class ZMQTest (BitcoinTestFramework):
                 socket.setsockopt(zmq.IPV6, 1)
             subscribers.append(ZMQSubscriber(socket, topic.encode()))
 
-        self.restart_node(0, [f"-zmqpub{topic}={address.replace('ipc://', 'unix:')}" for topic, address in services])
+        self.restart_node(0, [f"-zmqpub{topic}={address.replace('ipc://', 'unix:')}" for topic, address in services] + list(extra_args))
 
         for i, sub in enumerate(subscribers):
             sub.socket.connect(services[i][1])
@@ -262,6 +266,84 @@ class ZMQTest (BitcoinTestFramework):
         if unix:
             os.unlink(socket_path)
 
+    def test_rawtxbatch(self):
+        self.log.info("Testing rawtxbatch publisher")
+        address = f"tcp://127.0.0.1:{self.zmq_port_base}"
+        [rawtxbatch] = self.setup_zmq_test([("rawtxbatch", address)])
+
+        def receive_batch():
+            body = BytesIO(rawtxbatch.receive())
+            txs = []
+            for _ in range(deser_compact_size(body)):
+                tx = CTransaction()
+                tx.deserialize(body)
+                txs.append(tx.txid_hex)
+            assert_equal(body.read(), b"")
+            return txs
+
+        self.log.info("Transactions are batched in the order rawtx would publish them")
+        txids = [self.wallet.send_self_transfer(from_node=self.nodes[0])["txid"] for _ in range(5)]
+        blockhash = self.generatetoaddress(self.nodes[0], 1, ADDRESS_BCRT1_UNSPENDABLE)[0]
+        # Mempool acceptances first, then the transactions of the block
+        expected = txids + self.nodes[0].getblock(blockhash)["tx"]
+        received = []
+        while len(received) < len(expected):
+            received += [txid for txid in receive_batch() if txid in expected]
+        assert_equal(received, expected)
+
+        assert_equal(self.nodes[0].getzmqnotifications(), [
+            {"type": "pubrawtxbatch", "address": address, "hwm": 1000},
+        ])
+
+    def test_mempool_snapshot(self):
+        self.log.info("Testing mempool snapshots served to bootstrap the sequence topic")
+        snapshot_address = f"tcp://127.0.0.1:{self.zmq_port_base + 1}"
+        [seq] = self.setup_zmq_test([("sequence", f"tcp://127.0.0.1:{self.zmq_port_base}")],
+                                    extra_args=[f"-zmqrepmempool={snapshot_address}"])
+        req = self.ctx.socket(zmq.REQ)
+        req.set(zmq.RCVTIMEO, 60000)
+        req.connect(snapshot_address)
+
+        def request_snapshot():
+            req.send(b"")
+            topic, body = req.recv_multipart()
+            assert_equal(topic, b"mempool")
+            body = BytesIO(body)
+            sequence = struct.unpack("<Q", body.read(8))[0]
+            txs = []
+            for _ in range(deser_compact_size(body)):
+                tx = CTransaction()
+                tx.deserialize(body)
+                txs.append(tx)
+            assert_equal(body.read(), b"")
+            return sequence, txs
+
+        sequence, txs = request_snapshot()
+        assert_equal(txs, [])
+        assert_equal(sequence, self.nodes[0].getrawmempool(mempool_sequence=True)["mempool_sequence"])
+
+        self.log.info("Parents come before their children")
+        chain = self.wallet.send_self_transfer_chain(from_node=self.nodes[0], chain_length=3)
+        sequence, txs = request_snapshot()
+        assert_equal([tx.txid_hex for tx in txs], [tx["txid"] for tx in chain])
+        mempool = self.nodes[0].getrawmempool(mempool_sequence=True)
+        assert_equal(sequence, mempool["mempool_sequence"])
+
+        self.log.info("The snapshot and the sequence messages from its sequence number on make up the mempool")
+        view = {tx.txid_hex for tx in txs}
+        new_txid = self.wallet.send_self_transfer(from_node=self.nodes[0])["txid"]
+        while True:
+            hash_str, label, mempool_seq = seq.receive_sequence()
+            if mempool_seq is None or mempool_seq < sequence:
+                continue
+            assert_equal((hash_str, label, mempool_seq), (new_txid, "A", sequence))
+            view.add(hash_str)
+            break
+        assert_equal(view, set(self.nodes[0].getrawmempool()))
+
+        req.close()
+        self.generate(self.nodes[0], 1)
+
     def test_reorg(self):
 
         address = f"tcp://127.0.0.1:{self.zmq_port_base}"
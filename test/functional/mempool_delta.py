@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test tracking the mempool with getmempooldelta.
+
+A client fetches the mempool once with getrawmempool and its mempool sequence,
+then applies the changes returned by getmempooldelta from that sequence on,
+until they are truncated because -mempoollogsize changes were made since.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+
+class MempoolDeltaTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def apply_delta(self, txids, delta):
+        for change in delta["changes"]:
+            if change["type"] == "added":
+                txids.add(change["txid"])
+            else:
+                txids.remove(change["txid"])
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+
+        self.log.info("Track additions to the mempool")
+        mempool = node.getrawmempool(mempool_sequence=True)
+        txids = set(mempool["txids"])
+        sequence = mempool["mempool_sequence"]
+        sent = [wallet.send_self_transfer(from_node=node)["txid"] for _ in range(3)]
+        delta = node.getmempooldelta(sequence)
+        assert_equal(delta["truncated"], False)
+        assert_equal([change["txid"] for change in delta["changes"]], sent)
+        assert_equal([change["sequence"] for change in delta["changes"]], list(range(sequence, sequence + 3)))
+        assert all(change["type"] == "added" and "reason" not in change for change in delta["changes"])
+        self.apply_delta(txids, delta)
+        assert_equal(txids, set(node.getrawmempool()))
+        sequence = delta["mempool_sequence"]
+        assert_equal(node.getmempooldelta(sequence)["changes"], [])
+
+        self.log.info("Track removals by a replacement and a block")
+        utxo = wallet.get_utxo()
+        replaced = wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo)["txid"]
+        replacement = wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo, fee_rate=0.01)["txid"]
+        self.generate(node, 1)
+        delta = node.getmempooldelta(sequence)
+        assert_equal(delta["truncated"], False)
+        assert_equal([(change["txid"], change["type"]) for change in delta["changes"][:3]], [
+            (replaced, "added"),
+            (replaced, "removed"),
+            (replacement, "added"),
+        ])
+        assert_equal(delta["changes"][1]["reason"], "replaced")
+        removed_by_block = {change["txid"] for change in delta["changes"][3:] if change["reason"] == "block"}
+        assert_equal(removed_by_block, set(sent) | {replacement})
+        self.apply_delta(txids, delta)
+        assert_equal(txids, set())
+        assert_equal(node.getrawmempool(), [])
+
+        self.log.info("Resync once the changes are no longer logged")
+        self.restart_node(0, extra_args=["-mempoollogsize=2"])
+        wallet.rescan_utxos()
+        sequence = node.getrawmempool(mempool_sequence=True)["mempool_sequence"]
+        for _ in range(3):
+            wallet.send_self_transfer(from_node=node)
+        delta = node.getmempooldelta(sequence)
+        assert_equal(delta["truncated"], True)
+        assert_equal(delta["changes"], [])
+        assert_equal(len(node.getmempooldelta(sequence + 1)["changes"]), 2)
+        assert_equal(node.getmempooldelta(delta["mempool_sequence"] + 1)["truncated"], True)
+
+
+if __name__ == '__main__':
+    MempoolDeltaTest(__file__).main()
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test that cached full-size HEADERS responses match the active chain, also after a reorg."""
+
+from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
+from test_framework.messages import (
+    CBlockHeader,
+    msg_getheaders,
+)
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+MAX_HEADERS_RESULTS = 2000
+
+
+class HeadersCollector(P2PInterface):
+    def __init__(self):
+        super().__init__()
+        self.headers = None
+
+    def on_headers(self, message):
+        self.headers = [CBlockHeader(h) for h in message.headers]
+        for h in self.headers:
+            h.rehash()
+
+
+class GetheadersCachingTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.setup_clean_chain = True
+
+    def get_headers(self, peer, start_hash):
+        msg = msg_getheaders()
+        msg.locator.vHave = [int(start_hash, 16)]
+        peer.headers = None
+        peer.send_and_ping(msg)
+        return [h.hash for h in peer.headers]
+
+    def expected_headers(self, start_height, count):
+        node = self.nodes[0]
+        return [node.getblockhash(height) for height in range(start_height, min(start_height + count, node.getblockcount() + 1))]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.generate(node, MAX_HEADERS_RESULTS + 100)
+        genesis = node.getblockhash(0)
+        peers = [node.add_p2p_connection(HeadersCollector()) for _ in range(2)]
+
+        self.log.info("Check that peers asking for the same full range get the same, correct response")
+        for peer in peers:
+            assert_equal(self.get_headers(peer, genesis), self.expected_headers(1, MAX_HEADERS_RESULTS))
+
+        self.log.info("Check that a partial response is not affected")
+        assert_equal(self.get_headers(peers[0], node.getblockhash(MAX_HEADERS_RESULTS)), self.expected_headers(MAX_HEADERS_RESULTS + 1, MAX_HEADERS_RESULTS))
+
+        self.log.info("Check that the response follows a reorg within the cached range")
+        node.invalidateblock(node.getblockhash(1500))
+        self.generatetoaddress(node, MAX_HEADERS_RESULTS + 200 - 1500, ADDRESS_BCRT1_UNSPENDABLE)
+        for peer in peers:
+            assert_equal(self.get_headers(peer, genesis), self.expected_headers(1, MAX_HEADERS_RESULTS))
+
+
+if __name__ == '__main__':
+    GetheadersCachingTest(__file__).main()
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test that a low-work headers sync ends once its headers are known.
+
+When several peers serve the same chain, which does not have enough work to
+be stored right away, each of them starts a low-work headers sync. Once one of
+them has synced the chain, the syncs of the other peers are no longer needed,
+and they end as soon as those peers send headers that are already known.
+"""
+
+from test_framework.blocktools import create_block
+from test_framework.messages import msg_headers
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+# Enough for 2048 regtest blocks: a chain of 2100 headers is stored after a
+# sync of a full and a partial headers message.
+MINIMUM_CHAIN_WORK = 0x1000
+NUM_HEADERS = 2100
+MAX_HEADERS_RESULTS = 2000
+
+
+class HeadersPresyncKnownTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [[f"-minimumchainwork={MINIMUM_CHAIN_WORK:#x}"]]
+
+    def run_test(self):
+        node = self.nodes[0]
+        genesis = node.getblock(node.getbestblockhash())
+
+        headers = []
+        prev_hash = int(genesis["hash"], 16)
+        for i in range(NUM_HEADERS):
+            block = create_block(hashprev=prev_hash, ntime=genesis["time"] + i + 1)
+            block.solve()
+            headers.append(block)
+            prev_hash = block.sha256
+        first_headers = msg_headers(headers=headers[:MAX_HEADERS_RESULTS])
+        last_headers = msg_headers(headers=headers[MAX_HEADERS_RESULTS:])
+
+        self.log.info("Start a low-work headers sync with two peers")
+        peer_a = node.add_p2p_connection(P2PInterface())
+        peer_b = node.add_p2p_connection(P2PInterface())
+        peer_a.send_and_ping(first_headers)
+        peer_b.send_and_ping(first_headers)
+        for info in node.getpeerinfo():
+            assert_equal(info["presynced_headers"], MAX_HEADERS_RESULTS)
+
+        self.log.info("Complete the sync with the first peer")
+        peer_a.send_and_ping(last_headers)
+        peer_a.send_and_ping(first_headers)
+        peer_a.send_and_ping(last_headers)
+        assert {
+            "height": NUM_HEADERS,
+            "hash": headers[-1].hash,
+            "branchlen": NUM_HEADERS,
+            "status": "headers-only",
+        } in node.getchaintips()
+
+        self.log.info("Check that the sync with the second peer ends when it sends known headers")
+        peer_b_id = node.getpeerinfo()[1]["id"]
+        with node.assert_debug_log(expected_msgs=[f"Ending low-work headers sync with peer={peer_b_id}, its headers are already known"]):
+            peer_b.send_and_ping(last_headers)
+        for info in node.getpeerinfo():
+            assert_equal(info["presynced_headers"], -1)
+
+
+if __name__ == '__main__':
+    HeadersPresyncKnownTest(__file__).main()
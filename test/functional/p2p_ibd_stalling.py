@@ -85,6 +85,9 @@ class P2PIBDStallingTest(BitcoinTestFramework):
         bytes_recv = 172761 if not self.options.v2transport else 169692
         self.wait_until(lambda: self.total_bytes_recv_for_blocks() == bytes_recv)
 
+        self.log.info("Check that the per-peer block download statistics count the delivered blocks")
+        assert_equal(sum(info["block_download"]["blocks_received"] for info in node.getpeerinfo()), NUM_BLOCKS - 2)
+
         self.all_sync_send_with_ping(peers)
         # If there was a peer marked for stalling, it would get disconnected
         self.mocktime += 3
@@ -92,9 +95,9 @@ class P2PIBDStallingTest(BitcoinTestFramework):
         self.all_sync_send_with_ping(peers)
         assert_equal(node.num_test_p2p_connections(), NUM_PEERS)
 
-        self.log.info("Check that increasing the window beyond 1024 blocks triggers stalling logic")
+        self.log.info("Check that increasing the window beyond 1024 blocks triggers stalling logic, and a second request for the stalled block")
         headers_message.headers = [CBlockHeader(b) for b in blocks]
-        with node.assert_debug_log(expected_msgs=['Stall started']):
+        with node.assert_debug_log(expected_msgs=['Stall started', f'Requesting block {stall_block:064x} (1) held back by peer=0']):
             for p in peers:
                 p.send_without_ping(headers_message)
             self.all_sync_send_with_ping(peers)
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction reconciliation rounds (BIP 330) with the node as responder.
+"""
+
+from test_framework.messages import (
+    MSG_WTX,
+    msg_reconcildiff,
+    msg_reqrecon,
+    msg_sendtxrcncl,
+    msg_verack,
+    msg_wtxidrelay,
+)
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+import time
+
+
+class ReconcilingPeer(P2PInterface):
+    """Inbound peer that negotiates reconciliations and records the announcements it gets."""
+    def __init__(self):
+        super().__init__()
+        self.announced = set()
+        self.sketches = []
+
+    def on_version(self, message):
+        self.send_version()
+        self.send_without_ping(msg_wtxidrelay())
+        sendtxrcncl = msg_sendtxrcncl()
+        sendtxrcncl.version = 1
+        sendtxrcncl.salt = 2
+        self.send_without_ping(sendtxrcncl)
+        self.send_without_ping(msg_verack())
+
+    def on_inv(self, message):
+        for inv in message.inv:
+            assert_equal(inv.type, MSG_WTX)
+            self.announced.add(inv.hash)
+
+    def on_sketch(self, message):
+        self.sketches.append(message.skdata)
+
+
+class TxReconciliationTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [['-txreconciliation']]
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        node.setmocktime(int(time.time()))
+
+        peer = node.add_p2p_connection(ReconcilingPeer(), send_version=False, wait_for_verack=True)
+
+        self.log.info('Transactions are held back for reconciliation, except for a fanout fraction')
+        wtxids = set()
+        for _ in range(20):
+            wtxids.add(wallet.send_self_transfer(from_node=node)["tx"].wtxid_int)
+        # Let the inbound trickle timer fire.
+        for _ in range(6):
+            node.bumpmocktime(10)
+            peer.sync_with_ping()
+        flooded = set(peer.announced)
+        assert flooded < wtxids
+
+        self.log.info('The node responds to a reconciliation request with a sketch')
+        reqrecon = msg_reqrecon()
+        reqrecon.set_size = 0
+        reqrecon.q = 8191
+        peer.send_and_ping(reqrecon)
+        peer.wait_until(lambda: len(peer.sketches) == 1)
+        # A sketch serializes 4 bytes per element of capacity, which covers at least the
+        # difference in set sizes.
+        assert_equal(len(peer.sketches[0]) % 4, 0)
+        assert len(peer.sketches[0]) // 4 > len(wtxids - flooded)
+
+        self.log.info('After a failed reconciliation the node announces its whole set')
+        reconcildiff = msg_reconcildiff()
+        reconcildiff.success = 0
+        peer.send_and_ping(reconcildiff)
+        peer.wait_until(lambda: peer.announced == wtxids)
+
+        self.log.info('An unexpected reconcildiff is a protocol violation')
+        peer.send_without_ping(reconcildiff)
+        peer.wait_for_disconnect()
+
+
+if __name__ == '__main__':
+    TxReconciliationTest(__file__).main()
@@ -10,6 +10,7 @@ Test the following RPCs:
     - getchaintxstats
     - gettxoutsetinfo
     - gettxout
+    - gettxoutsat
     - getblockheader
     - getdifficulty
     - getnetworkhashps
@@ -58,7 +59,10 @@ from test_framework.util import (
     assert_is_hex_string,
     assert_is_hash_string,
 )
-from test_framework.wallet import MiniWallet
+from test_framework.wallet import (
+    MiniWallet,
+    MiniWalletMode,
+)
 
 
 HEIGHT = 200  # blocks mined
@@ -94,6 +98,7 @@ class BlockchainTest(BitcoinTestFramework):
         self._test_gettxoutsetinfo()
         self._test_gettxout()
         self._test_getblockheader()
+        self._test_getblockheaders()
         self._test_getdifficulty()
         self._test_getnetworkhashps()
         self._test_stopatheight()
@@ -103,6 +108,9 @@ class BlockchainTest(BitcoinTestFramework):
         self._test_getdeploymentinfo()
         self._test_verificationprogress()
         self._test_y2106()
+        self._test_getblockconnectstats()
+        self._test_getsignaturecacheinfo()
+        self._test_gettxoutsat()
         assert self.nodes[0].verifychain(4, 0)
 
     def mine_chain(self):
@@ -303,6 +311,42 @@ class BlockchainTest(BitcoinTestFramework):
         last = self.generate(self.nodes[0], 6)[-1]
         assert_equal(self.nodes[0].getblockheader(last)["mediantime"], time_2106)
 
+    def _test_getblockconnectstats(self):
+        self.log.info("Test getblockconnectstats")
+        node = self.nodes[0]
+        assert_raises_rpc_error(-8, "Negative count", node.getblockconnectstats, -1)
+        blockhashes = self.generate(node, 3)
+        stats = node.getblockconnectstats()
+        assert_greater_than_or_equal(len(stats), 3)
+        assert_equal([entry["hash"] for entry in stats[-3:]], blockhashes)
+        assert_equal(stats[-1]["height"], node.getblockcount())
+        stages = ["read", "deserialize", "check", "inputs", "connect", "verify", "undo", "index", "flush", "chainstate"]
+        for entry in stats:
+            assert_greater_than_or_equal(entry["total"], sum(entry[stage] for stage in stages) - 0.001)
+        assert_equal(node.getblockconnectstats(2), stats[-2:])
+        assert_equal(node.getblockconnectstats(0), [])
+
+    def _test_getsignaturecacheinfo(self):
+        self.log.info("Test getsignaturecacheinfo")
+        node = self.nodes[0]
+        p2pk_wallet = MiniWallet(node, mode=MiniWalletMode.RAW_P2PK)
+        self.wallet.send_to(from_node=node, scriptPubKey=p2pk_wallet.get_output_script(), amount=100000)
+        self.generate(node, 1)
+        p2pk_wallet.rescan_utxos()
+        before = node.getsignaturecacheinfo()
+        assert_greater_than(before["max_entries"], 0)
+        assert_greater_than(before["max_bytes"], 0)
+
+        # Accepting the transaction to the mempool verifies its signature and caches it,
+        # which saves verifying it again in the checks against the consensus rules.
+        p2pk_wallet.send_self_transfer(from_node=node)
+        info = node.getsignaturecacheinfo()
+        assert_equal(info["misses"], before["misses"] + 1)
+        assert_equal(info["inserts"], before["inserts"] + 1)
+        assert_equal(info["hits"], before["hits"] + 1)
+        assert_equal(info["evictions"], 0)
+        self.generate(node, 1)
+
     def _test_getchaintxstats(self):
         self.log.info("Test getchaintxstats")
 
@@ -445,6 +489,41 @@ class BlockchainTest(BitcoinTestFramework):
         assert_equal(txout['scriptPubKey']['type'], decoded_script['type'])
         assert_equal(txout['coinbase'], True)
 
+    def _test_gettxoutsat(self):
+        self.log.info("Test gettxoutsat")
+        node = self.nodes[0]
+        self.wallet.rescan_utxos()
+        tx = self.wallet.send_self_transfer(from_node=node)
+        spent = tx["tx"].vin[0].prevout
+        spent = {"txid": f"{spent.hash:064x}", "vout": spent.n}
+        created = {"txid": tx["txid"], "vout": 0}
+        height = node.getblockcount()
+        self.generate(node, 2)
+
+        res = node.gettxoutsat([spent, created], height)
+        assert_equal(res["blockhash"], node.getblockhash(height))
+        assert_equal(res["height"], height)
+        assert_equal(res["bitmap"], "10")
+        assert_equal(res["txouts"][0]["txid"], spent["txid"])
+        assert_equal(res["txouts"][0]["value"], tx["fee"] + Decimal(tx["tx"].vout[0].nValue) / COIN)
+        res = node.gettxoutsat([spent, created], height + 1)
+        assert_equal(res["bitmap"], "01")
+        assert_equal(res["txouts"][0]["confirmations"], 1)
+        assert_equal(res["txouts"][0]["value"], Decimal(tx["tx"].vout[0].nValue) / COIN)
+        # At the tip, the result is that of gettxouts.
+        res = node.gettxoutsat([spent, created], height + 2)
+        tip = node.gettxouts([spent, created])
+        assert_equal(res["blockhash"], tip["bestblock"])
+        assert_equal(res["txouts"], tip["txouts"])
+
+        # The coinbase of a block does not exist before it.
+        coinbase = {"txid": node.getblock(node.getblockhash(height))["tx"][0], "vout": 0}
+        assert_equal(node.gettxoutsat([coinbase], height - 1)["bitmap"], "0")
+        assert_equal(node.gettxoutsat([coinbase], height)["txouts"][0]["coinbase"], True)
+
+        assert_raises_rpc_error(-1, "Height is above the tip", node.gettxoutsat, [spent], height + 3)
+        assert_raises_rpc_error(-8, "height cannot be negative", node.gettxoutsat, [spent], -1)
+
     def _test_getblockheader(self):
         self.log.info("Test getblockheader")
         node = self.nodes[0]
@@ -486,6 +565,27 @@ class BlockchainTest(BitcoinTestFramework):
         assert 'previousblockhash' not in node.getblockheader(node.getblockhash(0))
         assert 'nextblockhash' not in node.getblockheader(node.getbestblockhash())
 
+    def _test_getblockheaders(self):
+        self.log.info("Test getblockheaders")
+        node = self.nodes[0]
+        tip_height = node.getblockcount()
+
+        headers = bytes.fromhex(node.getblockheaders(tip_height - 9, 5))
+        assert_equal(len(headers), 5 * 80)
+        for i in range(5):
+            assert_equal(headers[i * 80:(i + 1) * 80].hex(), node.getblockheader(node.getblockhash(tip_height - 9 + i), False))
+
+        self.log.info("Test getblockheaders stops at the tip")
+        headers = bytes.fromhex(node.getblockheaders(tip_height - 2, 100))
+        assert_equal(len(headers), 3 * 80)
+        assert_equal(headers[-80:].hex(), node.getblockheader(node.getbestblockhash(), False))
+        assert_equal(len(bytes.fromhex(node.getblockheaders(0, 100_000))), (tip_height + 1) * 80)
+
+        assert_raises_rpc_error(-8, "Block height out of range", node.getblockheaders, tip_height + 1, 1)
+        assert_raises_rpc_error(-8, "Block height out of range", node.getblockheaders, -1, 1)
+        assert_raises_rpc_error(-8, "Count is out of range (1-100000)", node.getblockheaders, 0, 0)
+        assert_raises_rpc_error(-8, "Count is out of range (1-100000)", node.getblockheaders, 0, 100_001)
+
     def _test_getdifficulty(self):
         self.log.info("Test getdifficulty")
         difficulty = self.nodes[0].getdifficulty()
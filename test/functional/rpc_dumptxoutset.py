@@ -60,6 +60,14 @@ class DumptxoutsetTest(BitcoinTestFramework):
             out['txoutset_hash'], 'd4453995f4f20db7bb3a604afd10d7128e8ee11159cde56d5b2fd7f55be7c74c')
         assert_equal(out['nchaintx'], 101)
 
+        self.log.info("Test that a chunked dump holds the same coins")
+        chunked = node.dumptxoutset('txoutset_chunked.dat', "latest", chunked=True)
+        for key in ['coins_written', 'base_hash', 'base_height', 'txoutset_hash', 'nchaintx']:
+            assert_equal(chunked[key], out[key])
+        with open(chunked['path'], 'rb') as f:
+            # Snapshot magic bytes then version
+            assert_equal(f.read(7)[5:], (3).to_bytes(2, "little"))
+
         # Specifying a path to an existing or invalid file will fail.
         assert_raises_rpc_error(
             -8, '{} already exists'.format(FILENAME),  node.dumptxoutset, FILENAME, "latest")
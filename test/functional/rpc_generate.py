@@ -27,6 +27,15 @@ class RPCGenerateTest(BitcoinTestFramework):
         self.generatetoaddress(self.nodes[0], 1, 'mneYUmWYsuk7kySiURxCi3AGxrAqZxLgPZ')
         assert_raises_rpc_error(-5, "Invalid address", self.generatetoaddress, self.nodes[0], 1, '3J98t1WpEZ73CNmQviecrnyiWrnqRhWNLy')
 
+        self.log.info('Generate blocks with mempool transactions to address')
+        node = self.nodes[0]
+        miniwallet = MiniWallet(node)
+        txid = miniwallet.send_self_transfer(from_node=node)['txid']
+        hashes = self.generatetoaddress(node, 2, miniwallet.get_address())
+        assert txid in node.getblock(hashes[0])['tx']
+        assert_equal(node.getblock(hashes[1])['nTx'], 1)
+        assert_equal(node.getmempoolinfo()['size'], 0)
+
     def test_generateblock(self):
         node = self.nodes[0]
         miniwallet = MiniWallet(node)
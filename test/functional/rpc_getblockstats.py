@@ -192,6 +192,28 @@ class GetblockstatsTest(BitcoinTestFramework):
         assert_raises_rpc_error(-1, 'Block not found on disk', self.nodes[0].getblockstats, hash_or_height=1)
         (self.nodes[0].blocks_path / 'blk00000.dat.backup').rename(self.nodes[0].blocks_path / 'blk00000.dat')
 
+        self.log.info('Test getblockstatsrange')
+        all_stats = [self.nodes[0].getblockstats(height) for height in range(tip + 1)]
+        assert_equal(self.nodes[0].getblockstatsrange(0, tip), all_stats)
+        assert_equal(self.nodes[0].getblockstatsrange(self.start_height, self.start_height, ['minfee', 'height']),
+                     [{'height': self.start_height, 'minfee': self.expected_stats[0]['minfee']}])
+        assert_raises_rpc_error(-8, 'Invalid range of heights', self.nodes[0].getblockstatsrange, 2, 1)
+        assert_raises_rpc_error(-8, 'Invalid range of heights', self.nodes[0].getblockstatsrange, -1, 1)
+        assert_raises_rpc_error(-8, 'Target block height %d after current tip %d' % (tip + 1, tip),
+                                self.nodes[0].getblockstatsrange, 0, tip + 1)
+        assert_raises_rpc_error(-8, f"Invalid selected statistic '{inv_sel_stat}'",
+                                self.nodes[0].getblockstatsrange, 0, 1, [inv_sel_stat])
+
+        self.log.info('Test the blockstatsindex')
+        self.restart_node(0, extra_args=['-blockstatsindex'])
+        self.wait_until(lambda: self.nodes[0].getindexinfo('blockstatsindex')['blockstatsindex']['synced'])
+        assert_equal(self.nodes[0].getblockstatsrange(0, tip), all_stats)
+        # Indexed statistics do not need the block data anymore
+        (self.nodes[0].blocks_path / 'blk00000.dat').rename(self.nodes[0].blocks_path / 'blk00000.dat.backup')
+        assert_equal(self.nodes[0].getblockstats(hash_or_height=1), all_stats[1])
+        assert_equal(self.nodes[0].getblockstatsrange(0, tip), all_stats)
+        (self.nodes[0].blocks_path / 'blk00000.dat.backup').rename(self.nodes[0].blocks_path / 'blk00000.dat')
+
 
 if __name__ == '__main__':
     GetblockstatsTest(__file__).main()
@@ -15,6 +15,7 @@ class GetBlocksActivityTest(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 1
         self.setup_clean_chain = True
+        self.extra_args = [["-blockscanthreads=4"]]
 
     def run_test(self):
         node = self.nodes[0]
@@ -31,6 +32,7 @@ class GetBlocksActivityTest(BitcoinTestFramework):
         self.test_confirmed_and_unconfirmed(node, wallet)
         self.test_receive_then_spend(node, wallet)
         self.test_no_address(node, wallet)
+        self.test_parallel_block_scan(node, wallet)
 
     def test_no_activity(self, node):
         _, _, addr_1 = getnewdestination()
@@ -221,6 +223,15 @@ class GetBlocksActivityTest(BitcoinTestFramework):
         assert_equal(list(a2['output_spk'].keys()), ['asm', 'desc', 'hex', 'type'])
         assert a2['amount'] == Decimal(no_addr_tx["tx"].vout[0].nValue) / COIN
 
+    def test_parallel_block_scan(self, node, wallet):
+        """Blocks read by several threads give the same result as one by one, in order."""
+        blockhashes = [node.getblockhash(height) for height in range(node.getblockcount() - 60, node.getblockcount() + 1)]
+        result = node.getdescriptoractivity(blockhashes, [wallet.get_descriptor()], False)
+        heights = [event['height'] for event in result['activity']]
+        assert_equal(heights, sorted(heights))
+        self.restart_node(0, extra_args=["-blockscanthreads=1"])
+        assert_equal(node.getdescriptoractivity(blockhashes, [wallet.get_descriptor()], False), result)
+
 
 if __name__ == '__main__':
     GetBlocksActivityTest(__file__).main()
@@ -7,6 +7,7 @@
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
     assert_equal,
+    assert_greater_than_or_equal,
     assert_raises_rpc_error,
 )
 from test_framework.wallet import MiniWallet
@@ -76,6 +77,12 @@ class RPCMempoolInfoTest(BitcoinTestFramework):
         result = self.nodes[0].gettxspendingprevout([ {'txid' : txidB, 'vout' : 0}, {'txid' : txidG, 'vout' : 3} ])
         assert_equal(result, [ {'txid' : txidB, 'vout' : 0, 'spendingtxid' : txidD}, {'txid' : txidG, 'vout' : 3} ])
 
+        self.log.info("Only return spent outputs")
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidG, 'vout' : 3}, {'txid' : txidB, 'vout' : 0}, {'txid' : txidH, 'vout' : 0} ], spent_only=True)
+        assert_equal(result, [ {'txid' : txidB, 'vout' : 0, 'spendingtxid' : txidD} ])
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidH, 'vout' : n} for n in range(1000) ], {'spent_only' : True})
+        assert_equal(result, [])
+
         self.log.info("Unknown input fields")
         assert_raises_rpc_error(-3, "Unexpected key unknown", self.nodes[0].gettxspendingprevout, [{'txid' : txidC, 'vout' : 1, 'unknown' : 42}])
 
@@ -94,6 +101,33 @@ class RPCMempoolInfoTest(BitcoinTestFramework):
         self.log.info("Missing txid")
         assert_raises_rpc_error(-3, "Missing txid", self.nodes[0].gettxspendingprevout, [{'vout' : 3}])
 
+        self.log.info("Mempool acceptance latency histograms")
+        accepted = self.nodes[0].getmempoolacceptstats()["accepted"]
+        assert_greater_than_or_equal(accepted["count"], 8)
+        total = accepted["stages"]["total"]
+        assert_equal(total["count"], accepted["count"])
+        assert_equal(sum(total["histogram"]), total["count"])
+        assert_greater_than_or_equal(total["max"], total["p50"])
+        assert "replacement" not in accepted["stages"]
+
+        self.log.info("Confirmed spending transactions require -spenderindex")
+        assert_raises_rpc_error(-1, "requires -spenderindex", self.nodes[0].gettxspendingprevout, [{'txid' : txidA, 'vout' : 0}], {'mempool_only' : False})
+
+        self.log.info("Find confirmed transactions spending outputs with -spenderindex")
+        blockhash = self.generate(self.nodes[0], 1)[0]
+        height = self.nodes[0].getblockcount()
+        self.restart_node(0, extra_args=["-spenderindex"])
+        self.wait_until(lambda: self.nodes[0].getindexinfo('spenderindex')['spenderindex']['synced'])
+        txidI = self.wallet.send_self_transfer(from_node=self.nodes[0], utxo_to_spend=self.wallet.get_utxo(txid=txidH))['txid']
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidA, 'vout' : 0}, {'txid' : txidH, 'vout' : 0}, {'txid' : txidI, 'vout' : 0} ])
+        assert_equal(result, [
+            {'txid' : txidA, 'vout' : 0, 'spendingtxid' : txidB, 'blockhash' : blockhash, 'height' : height},
+            {'txid' : txidH, 'vout' : 0, 'spendingtxid' : txidI},
+            {'txid' : txidI, 'vout' : 0},
+        ])
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidA, 'vout' : 0} ], {'mempool_only' : True})
+        assert_equal(result, [ {'txid' : txidA, 'vout' : 0} ])
+
 
 if __name__ == '__main__':
     RPCMempoolInfoTest(__file__).main()
@@ -41,6 +41,14 @@ class RpcMiscTest(BitcoinTestFramework):
         assert_greater_than(memory['chunks_free'], 0)
         assert_equal(memory['used'] + memory['free'], memory['total'])
 
+        self.log.info("test getmemoryinfo usage")
+        usage = node.getmemoryinfo()['usage']
+        for key in ['coins_cache', 'coins_db', 'block_index', 'block_tree_db', 'signature_cache', 'script_cache', 'mempool', 'addrman']:
+            assert_greater_than(usage[key], 0)
+        for key in ['orphanage', 'peer_send_buffers', 'peer_receive_buffers', 'indexes', 'wallets']:
+            assert_greater_than_or_equal(usage[key], 0)
+        assert_equal(sum(usage.values()) - usage['total'], usage['total'])
+
         self.log.info("test mallocinfo")
         try:
             mallocinfo = node.getmemoryinfo(mode="mallocinfo")
@@ -53,6 +61,16 @@ class RpcMiscTest(BitcoinTestFramework):
 
         assert_raises_rpc_error(-8, "unknown mode foobar", node.getmemoryinfo, mode="foobar")
 
+        self.log.info("test getdbinfo")
+        dbinfo = node.getdbinfo()
+        assert_equal(sorted(dbinfo.keys()), ["blocks_index", "chainstate", "indexes"])
+        for stats in [dbinfo["chainstate"], dbinfo["blocks_index"]]:
+            assert_greater_than(stats["memory_usage"], 0)
+            assert_greater_than_or_equal(stats["write_time"], 0)
+            for level in stats["levels"]:
+                assert_greater_than_or_equal(level["files"], 0)
+        assert_equal(sorted(dbinfo["chainstate"]["missing_coins_cache"].keys()), ["entries", "hits"])
+
         self.log.info("test logging rpc and help")
 
         # Test toggling a logging category on/off/on with the logging RPC.
@@ -99,6 +117,37 @@ class RpcMiscTest(BitcoinTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test getlockstats")
+        lockstats = node.getlockstats()
+        assert_equal(lockstats["enabled"], False)
+        assert_equal(lockstats["locks"], {})
+        assert_equal(lockstats["sites"], [])
+
+        self.restart_node(0, ["-lockstats"])
+        node.getblockchaininfo()
+        lockstats = node.getlockstats(reset=True)
+        assert_equal(lockstats["enabled"], True)
+        assert_equal(len(lockstats["bucket_limits_us"]) + 1, len(lockstats["locks"]["cs_main"]["wait_histogram"]))
+        cs_main = lockstats["locks"]["cs_main"]
+        assert_greater_than(cs_main["acquisitions"], 0)
+        assert_greater_than_or_equal(cs_main["acquisitions"], cs_main["contended"])
+        cs_main_sites = [site for site in lockstats["sites"] if site["lock"] in ("cs_main", "::cs_main")]
+        assert_equal(sum(site["acquisitions"] for site in cs_main_sites), cs_main["acquisitions"])
+        hold_times = [site["hold_us"] for site in lockstats["sites"]]
+        assert_equal(hold_times, sorted(hold_times, reverse=True))
+
+        self.log.info("test getscopetimers")
+        self.generate(node, 1)
+        timers = node.getscopetimers()
+        scopes = timers["scopes"]
+        assert_equal(scopes["LoadBlockIndex"]["count"], 1)
+        connect_block = scopes["ActivateBestChain/ConnectTip/ConnectBlock"]
+        assert_greater_than_or_equal(scopes["ActivateBestChain/ConnectTip"]["count"], connect_block["count"])
+        assert_greater_than(connect_block["count"], 0)
+        for scope in scopes.values():
+            assert_equal(len(scope["histogram"]), len(timers["bucket_limits_us"]) + 1)
+            assert_equal(sum(scope["histogram"]), scope["count"])
+
 
 if __name__ == '__main__':
     RpcMiscTest(__file__).main()
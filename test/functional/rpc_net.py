@@ -62,7 +62,7 @@ def seed_addrman(node):
 class NetTest(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 2
-        self.extra_args = [["-minrelaytxfee=0.00001000"], ["-minrelaytxfee=0.00000500"]]
+        self.extra_args = [["-minrelaytxfee=0.00001000", "-msgprocstats"], ["-minrelaytxfee=0.00000500"]]
         # Specify a non-working proxy to make sure no actual connections to public IPs are attempted
         for args in self.extra_args:
             args.append("-proxy=127.0.0.1:1")
@@ -82,6 +82,7 @@ class NetTest(BitcoinTestFramework):
         self.test_connection_count()
         self.test_getpeerinfo()
         self.test_getnettotals()
+        self.test_getmsgprocstats()
         self.test_getnetworkinfo()
         self.test_addnode_getaddednodeinfo()
         self.test_service_flags()
@@ -150,6 +151,7 @@ class NetTest(BitcoinTestFramework):
                 "addr_relay_enabled": False,
                 "bip152_hb_from": False,
                 "bip152_hb_to": False,
+                "block_download": {"avg_interval": 0, "avg_latency": 0, "blocks_received": 0, "inflight_limit": 16},
                 "bytesrecv_per_msg": {},
                 "bytessent_per_msg": {},
                 "connection_type": "inbound",
@@ -166,6 +168,7 @@ class NetTest(BitcoinTestFramework):
                 "permissions": [],
                 "presynced_headers": -1,
                 "relaytxes": False,
+                "sendqueuebytes": 0,
                 "services": "0000000000000000",
                 "servicesnames": [],
                 "session_id": "" if not self.options.v2transport else no_version_peer.v2_state.peer['session_id'].hex(),
@@ -202,6 +205,20 @@ class NetTest(BitcoinTestFramework):
             self.wait_until(lambda: peer_after()['bytesrecv_per_msg'].get('pong', 0) >= peer_before['bytesrecv_per_msg'].get('pong', 0) + ping_size, timeout=1)
             self.wait_until(lambda: peer_after()['bytessent_per_msg'].get('ping', 0) >= peer_before['bytessent_per_msg'].get('ping', 0) + ping_size, timeout=1)
 
+    def test_getmsgprocstats(self):
+        self.log.info("Test getmsgprocstats")
+        stats = self.nodes[0].getmsgprocstats()
+        assert_equal(stats["enabled"], True)
+        for msg_type in ["version", "verack", "ping"]:
+            assert stats["msgtypes"][msg_type]["count"] > 0
+        assert_equal(sorted(stats["peers"].keys()), sorted(str(peer["id"]) for peer in self.nodes[0].getpeerinfo()))
+        for peer in stats["peers"].values():
+            assert peer["count"] > 0
+            assert peer["total"] >= peer["max"] >= 0
+
+        self.log.info("Test getmsgprocstats without -msgprocstats")
+        assert_equal(self.nodes[1].getmsgprocstats(), {"enabled": False, "msgtypes": {}, "peers": {}})
+
     def test_getnetworkinfo(self):
         self.log.info("Test getnetworkinfo")
         info = self.nodes[0].getnetworkinfo()
@@ -234,6 +251,10 @@ class NetTest(BitcoinTestFramework):
         for info in network_info:
             assert_net_servicesnames(int(info["localservices"], 0x10), info["localservicesnames"])
 
+        # Nodes supporting v2 keep their pool of keys for new v2 connections filled.
+        for node in self.nodes:
+            self.wait_until(lambda: node.getnetworkinfo()["v2_key_pool"]["size"] == node.getnetworkinfo()["v2_key_pool"]["target_size"])
+
         # Check dynamically generated networks list in getnetworkinfo help output.
         assert "(ipv4, ipv6, onion, i2p, cjdns)" in self.nodes[0].help("getnetworkinfo")
 
@@ -6,6 +6,7 @@
 
 Test the following RPCs:
    - getrawtransaction
+   - getrawtransactions
    - createrawtransaction
    - signrawtransactionwithwallet
    - sendrawtransaction
@@ -83,6 +84,7 @@ class RawTransactionsTest(BitcoinTestFramework):
         self.wallet = MiniWallet(self.nodes[0])
 
         self.getrawtransaction_tests()
+        self.getrawtransactions_tests()
         self.createrawtransaction_tests()
         self.sendrawtransaction_tests()
         self.sendrawtransaction_testmempoolaccept_tests()
@@ -176,6 +178,34 @@ class RawTransactionsTest(BitcoinTestFramework):
         block = self.nodes[0].getblock(self.nodes[0].getblockhash(0))
         assert_raises_rpc_error(-5, "The genesis block coinbase is not considered an ordinary transaction", self.nodes[0].getrawtransaction, block['merkleroot'])
 
+    def getrawtransactions_tests(self):
+        self.log.info("Test getrawtransactions")
+        confirmed = [self.wallet.send_self_transfer(from_node=self.nodes[0]) for _ in range(3)]
+        self.generate(self.nodes[0], 1)
+        unconfirmed = self.wallet.send_self_transfer(from_node=self.nodes[0])
+        sync_txindex(self, self.nodes[0])
+        unknown = "00" * 32
+        txids = [confirmed[2]["txid"], unknown, unconfirmed["txid"], confirmed[0]["txid"], confirmed[2]["txid"]]
+
+        # Transactions are returned in the order of the request, from the mempool or the index.
+        result = self.nodes[0].getrawtransactions(txids)
+        assert_equal(result, [confirmed[2]["hex"], None, unconfirmed["hex"], confirmed[0]["hex"], confirmed[2]["hex"]])
+        assert_equal(self.nodes[0].getrawtransactions(txids, False), result)
+        verbose = self.nodes[0].getrawtransactions(txids, 1)
+        assert_equal([tx["hex"] if tx else None for tx in verbose], result)
+        assert_equal(verbose[0]["confirmations"], 1)
+        assert "blockhash" not in verbose[2]
+        assert_equal(self.nodes[0].getrawtransactions([]), [])
+
+        # Without -txindex, only the mempool transactions are found.
+        self.sync_mempools(self.nodes[0:2])
+        assert_equal(self.nodes[1].getrawtransactions(txids), [None, None, unconfirmed["hex"], None, None])
+
+        assert_raises_rpc_error(-8, "txids[1] must be of length 64", self.nodes[0].getrawtransactions, [unknown, "abcd"])
+        assert_raises_rpc_error(-3, "not of expected type number", self.nodes[0].getrawtransactions, txids, "1")
+        assert_raises_rpc_error(-8, "Too many txids (max: 10000, tried: 10001)", self.nodes[0].getrawtransactions, [unknown] * 10001)
+        self.generate(self.nodes[0], 1)
+
     def getrawtransaction_verbosity_tests(self):
         tx = self.wallet.send_self_transfer(from_node=self.nodes[1])['txid']
         [block1] = self.generate(self.nodes[1], 1)
@@ -138,6 +138,18 @@ class ScantxoutsetTest(BitcoinTestFramework):
         # Check that invalid command give error
         assert_raises_rpc_error(-8, "Invalid action 'invalid_command'", self.nodes[0].scantxoutset, "invalid_command")
 
+        self.log.info("Test that scanning the UTXO set in parallel gives the same results as a single thread")
+        scanobjects = [self.wallet.get_descriptor(), "addr(mpQ8rokAhp1TAtJQR6F6TaUmjAWkAWYYBq)"]
+        results = []
+        for threads in [1, 4]:
+            self.restart_node(0, extra_args=[f"-utxoscanthreads={threads}"])
+            scan = self.nodes[0].scantxoutset("start", scanobjects)
+            stats = [self.nodes[0].gettxoutsetinfo(hash_type) for hash_type in ["muhash", "none"]]
+            for s in stats:
+                del s['disk_size']
+            results.append((scan, stats))
+        assert_equal(results[0], results[1])
+
 
 if __name__ == "__main__":
     ScantxoutsetTest(__file__).main()
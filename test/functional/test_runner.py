@@ -132,6 +132,7 @@ BASE_SCRIPTS = [
     'rpc_bind.py --ipv6',
     'rpc_bind.py --nonloopback',
     'p2p_headers_sync_with_minchainwork.py',
+    'p2p_headers_presync_known.py',
     'p2p_feefilter.py',
     'feature_csv_activation.py',
     'p2p_sendheaders.py',
@@ -188,10 +189,12 @@ BASE_SCRIPTS = [
     'wallet_reindex.py',
     'wallet_reorgsrestore.py',
     'interface_http.py',
+    'interface_metrics.py',
     'interface_rpc.py',
     'interface_usdt_coinselection.py',
     'interface_usdt_mempool.py',
     'interface_usdt_net.py',
+    'interface_usdt_rpc.py',
     'interface_usdt_utxocache.py',
     'interface_usdt_validation.py',
     'rpc_users.py',
@@ -217,6 +220,7 @@ BASE_SCRIPTS = [
     'p2p_addr_relay.py',
     'p2p_getaddr_caching.py',
     'p2p_getdata.py',
+    'p2p_getheaders_caching.py',
     'p2p_addrfetch.py',
     'rpc_net.py --v1transport',
     'rpc_net.py --v2transport',
@@ -325,6 +329,7 @@ BASE_SCRIPTS = [
     'mempool_unbroadcast.py',
     'mempool_compatibility.py',
     'mempool_accept_wtxid.py',
+    'mempool_delta.py',
     'mempool_dust.py',
     'mempool_sigoplimit.py',
     'rpc_deriveaddresses.py',
@@ -334,12 +339,14 @@ BASE_SCRIPTS = [
     'rpc_getdescriptoractivity.py',
     'rpc_scanblocks.py',
     'p2p_sendtxrcncl.py',
+    'p2p_txreconciliation.py',
     'rpc_scantxoutset.py',
     'feature_unsupported_utxo_db.py',
     'feature_logging.py',
     'feature_anchors.py',
     'mempool_datacarrier.py',
     'feature_coinstatsindex.py',
+    'feature_scripthashindex.py',
     'wallet_orphanedreward.py',
     'wallet_timelock.py',
     'p2p_permissions.py',
@@ -354,6 +361,7 @@ BASE_SCRIPTS = [
     'rpc_mempool_info.py',
     'rpc_help.py',
     'tool_rpcauth.py',
+    'tool_rpc_load.py',
     'p2p_handshake.py',
     'p2p_handshake.py --v2transport',
     'feature_dirsymlinks.py',
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the RPC and REST load generator in contrib/rpc-load."""
+import json
+import os
+import subprocess
+import sys
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    rpc_port,
+)
+from test_framework.wallet import MiniWallet
+
+
+class RpcLoadTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [["-rest"]]
+
+    def run_load(self, *args):
+        node = self.nodes[0]
+        rpc_load_path = os.path.join(self.config["environment"]["SRCDIR"], "contrib", "rpc-load", "rpc_load.py")
+        result = subprocess.run([sys.executable, rpc_load_path, "--chain=regtest", f"--datadir={node.datadir_path}",
+                                 f"--rpcport={rpc_port(node.index)}", "--duration=1", "--json", *args],
+                                check=True, capture_output=True, text=True)
+        return json.loads(result.stdout)
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        for _ in range(3):
+            wallet.send_self_transfer_multi(from_node=node, num_outputs=3)
+            self.generate(wallet, 1)
+        wallet.send_self_transfer(from_node=node)
+
+        self.log.info("Run a mix of all requests")
+        summary = self.run_load("--concurrency=2", "--mix=getblock,getrawtransaction,gettxout,getrawmempool,rest_block")
+        for kind in ["getblock", "getrawtransaction", "gettxout", "getrawmempool", "rest_block", "total"]:
+            assert_greater_than(summary[kind]["requests"], 0)
+            assert_equal(summary[kind]["errors"], 0)
+        assert_equal(summary["total"]["requests"], sum(summary[kind]["requests"] for kind in summary if kind != "total"))
+
+        self.log.info("Run batches of requests without keep-alive")
+        summary = self.run_load("--mix=getblock", "--batch=5", "--no-keepalive")
+        assert_greater_than(summary["getblock"]["requests"], 0)
+        assert_equal(summary["getblock"]["errors"], 0)
+
+
+if __name__ == '__main__':
+    RpcLoadTest(__file__).main()
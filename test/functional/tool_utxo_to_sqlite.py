@@ -112,6 +112,25 @@ class UtxoToSqliteTest(BitcoinTestFramework):
         muhash_compact_serialized = node.gettxoutsetinfo('muhash')['muhash']
         assert_equal(muhash_sqlite, muhash_compact_serialized)
 
+        if not self.is_bitcoin_util_compiled() or not self.is_wallet_compiled():
+            self.log.info('Skipping bitcoin-util utxotosqlite, which needs bitcoin-util and SQLite')
+            return
+
+        chunked_filename = os.path.join(self.options.tmpdir, "utxos_chunked.dat")
+        node.dumptxoutset(chunked_filename, "latest", chunked=True)
+        for snapshot_filename in (input_filename, chunked_filename):
+            self.log.info(f'Convert {os.path.basename(snapshot_filename)} with bitcoin-util utxotosqlite')
+            native_filename = snapshot_filename + ".sqlite"
+            subprocess.run(node.binaries.util_argv() + ["-regtest", "utxotosqlite", snapshot_filename, native_filename],
+                           check=True, stdout=subprocess.DEVNULL)
+            assert_equal(calculate_muhash_from_sqlite_utxos(native_filename), muhash_compact_serialized)
+
+        self.log.info('Check that bitcoin-util utxotosqlite does not overwrite the database')
+        result = subprocess.run(node.binaries.util_argv() + ["-regtest", "utxotosqlite", input_filename, output_filename],
+                                capture_output=True, text=True)
+        assert_equal(result.returncode, 1)
+        assert_equal(result.stderr.strip(), f"{output_filename} already exists")
+
 
 if __name__ == "__main__":
     UtxoToSqliteTest(__file__).main()
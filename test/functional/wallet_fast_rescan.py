@@ -85,12 +85,21 @@ class WalletFastRescanTest(BitcoinTestFramework):
             w.importdescriptors([{"desc": descriptor['desc'], "timestamp": 0} for descriptor in descriptors])
         txids_slow_nonactive = self.get_wallet_txids(node, 'rescan_slow_nonactive')
 
+        self.restart_node(0, [f'-keypool={KEYPOOL_SIZE}', '-blockfilterindex=1', '-rescanthreads=4'])
+        self.wait_until(lambda: all(i['synced'] for i in node.getindexinfo().values()))
+        self.log.info("Import wallet backup with block filter index, matching and reading blocks ahead on several threads")
+        with node.assert_debug_log(['fast variant using block filters']):
+            node.restorewallet('rescan_fast_parallel', WALLET_BACKUP_FILENAME)
+        txids_fast_parallel = self.get_wallet_txids(node, 'rescan_fast_parallel')
+
         self.log.info("Verify that all rescans found the same txs in slow and fast variants")
         assert_equal(len(txids_slow), NUM_DESCRIPTORS * NUM_BLOCKS)
         assert_equal(len(txids_fast), NUM_DESCRIPTORS * NUM_BLOCKS)
+        assert_equal(len(txids_fast_parallel), NUM_DESCRIPTORS * NUM_BLOCKS)
         assert_equal(len(txids_slow_nonactive), NUM_DESCRIPTORS * NUM_BLOCKS)
         assert_equal(len(txids_fast_nonactive), NUM_DESCRIPTORS * NUM_BLOCKS)
         assert_equal(sorted(txids_slow), sorted(txids_fast))
+        assert_equal(sorted(txids_slow), sorted(txids_fast_parallel))
         assert_equal(sorted(txids_slow_nonactive), sorted(txids_fast_nonactive))
 
 
@@ -97,6 +97,7 @@ class ListTransactionsTest(BitcoinTestFramework):
         self.run_coinjoin_test()
         self.run_invalid_parameters_test()
         self.test_op_return()
+        self.test_pagination()
 
     def run_rbf_opt_in_test(self):
         """Test the opt-in-rbf flag for sent and received transactions."""
@@ -311,6 +312,16 @@ class ListTransactionsTest(BitcoinTestFramework):
 
         assert 'address' not in op_ret_tx
 
+    def test_pagination(self):
+        """Test that pages match the full list, including when they start within the entries of a transaction."""
+        self.log.info("Test listtransactions pagination")
+        for node in self.nodes:
+            full = node.listtransactions("*", 1000)
+            for skip in range(len(full) + 2):
+                for count in [0, 1, 3]:
+                    expected = full[max(0, len(full) - skip - count):max(0, len(full) - skip)]
+                    assert_equal(node.listtransactions("*", count, skip), expected)
+
 
 if __name__ == '__main__':
     ListTransactionsTest(__file__).main()